@@ -0,0 +1,164 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.cpp
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/base/AsyncLogDestination.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+const unsigned int AsyncLogDestination::DEFAULT_MAX_QUEUED;
+
+AsyncLogDestination::AsyncLogDestination(LogDestination *destination,
+                                         unsigned int max_queued)
+    : m_destination(destination),
+      m_max_queued(max_queued),
+      m_queued(0),
+      m_dropped(0),
+      m_reported_dropped(0),
+      m_running(false),
+      m_stop(false) {
+}
+
+
+AsyncLogDestination::~AsyncLogDestination() {
+  Stop();
+}
+
+
+bool AsyncLogDestination::Start() {
+  if (m_running || !m_destination.get()) {
+    return false;
+  }
+
+  m_stop = false;
+  m_thread.reset(new WriterThread(this));
+  // Set this first, so lines logged by the thread itself are queued.
+  m_running = true;
+  if (!m_thread->Start()) {
+    m_running = false;
+    m_thread.reset();
+    return false;
+  }
+  return true;
+}
+
+
+void AsyncLogDestination::Stop() {
+  if (!m_thread.get()) {
+    return;
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    m_stop = true;
+    m_condition.Signal();
+  }
+  m_thread->Join();
+  m_thread.reset();
+  m_running = false;
+  // Anything queued after the thread exited.
+  WriteQueued();
+}
+
+
+void AsyncLogDestination::Write(log_level level, const string &log_line) {
+  if (!m_destination.get()) {
+    return;
+  }
+
+  if (!m_running || level == OLA_LOG_FATAL) {
+    m_destination->Write(level, log_line);
+    return;
+  }
+
+  if (__sync_add_and_fetch(&m_queued, 1) > m_max_queued) {
+    __sync_sub_and_fetch(&m_queued, 1);
+    __sync_fetch_and_add(&m_dropped, 1);
+    return;
+  }
+
+  if (m_queue.Push(QueuedLine(level, log_line))) {
+    MutexLocker lock(&m_mutex);
+    m_condition.Signal();
+  }
+}
+
+
+LogDestination *AsyncLogDestination::Release() {
+  Stop();
+  return m_destination.release();
+}
+
+
+void *AsyncLogDestination::RunWriter() {
+  while (true) {
+    bool stop;
+    {
+      MutexLocker lock(&m_mutex);
+      while (m_queue.Empty() && !m_stop) {
+        m_condition.Wait(&m_mutex);
+      }
+      stop = m_stop;
+    }
+    WriteQueued();
+    if (stop) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+
+/*
+ * Write everything that's in the queue. This is only called from one thread
+ * at a time.
+ */
+void AsyncLogDestination::WriteQueued() {
+  unsigned int count = m_queue.PopAll(&m_lines);
+  __sync_sub_and_fetch(&m_queued, count);
+  // Lines are only dropped when the queue is full, so any dropped so far are
+  // newer than the ones we just took.
+  const unsigned int dropped = m_dropped;
+
+  vector<QueuedLine>::const_iterator iter = m_lines.begin();
+  for (; iter != m_lines.end(); ++iter) {
+    m_destination->Write(iter->level, iter->line);
+  }
+  m_lines.clear();
+
+  if (dropped != m_reported_dropped) {
+    std::ostringstream str;
+    str << "Dropped " << dropped - m_reported_dropped
+        << " log lines, the log queue was full\n";
+    m_destination->Write(OLA_LOG_WARN, str.str());
+    m_reported_dropped = dropped;
+  }
+}
+}  // namespace ola
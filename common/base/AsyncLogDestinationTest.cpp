@@ -0,0 +1,181 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestinationTest.cpp
+ * Test fixture for the AsyncLogDestination class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/base/AsyncLogDestination.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+
+using ola::AsyncLogDestination;
+using ola::log_level;
+using ola::thread::ConditionVariable;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+/*
+ * Records the lines written, and can block the writer.
+ */
+class BlockingLogDestination: public ola::LogDestination {
+ public:
+  BlockingLogDestination() : m_blocked(false), m_writing(false) {}
+
+  void Write(log_level, const string &log_line) {
+    MutexLocker lock(&m_mutex);
+    m_lines.push_back(log_line);
+    m_writing = true;
+    m_condition.Broadcast();
+    while (m_blocked) {
+      m_condition.Wait(&m_mutex);
+    }
+    m_writing = false;
+  }
+
+  void Block() {
+    MutexLocker lock(&m_mutex);
+    m_blocked = true;
+  }
+
+  void Unblock() {
+    MutexLocker lock(&m_mutex);
+    m_blocked = false;
+    m_condition.Broadcast();
+  }
+
+  // Wait until a Write() call is blocked.
+  void WaitForWriter() {
+    MutexLocker lock(&m_mutex);
+    while (!m_writing) {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+
+  vector<string> Lines() {
+    MutexLocker lock(&m_mutex);
+    return m_lines;
+  }
+
+ private:
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  bool m_blocked;
+  bool m_writing;
+  vector<string> m_lines;
+};
+
+
+class AsyncLogDestinationTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(AsyncLogDestinationTest);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testNotRunning);
+  CPPUNIT_TEST(testDropped);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testWrite();
+  void testNotRunning();
+  void testDropped();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncLogDestinationTest);
+
+
+/*
+ * Check lines are written in order.
+ */
+void AsyncLogDestinationTest::testWrite() {
+  BlockingLogDestination *destination = new BlockingLogDestination();
+  AsyncLogDestination async(destination);
+  OLA_ASSERT_TRUE(async.Start());
+  OLA_ASSERT_FALSE(async.Start());
+
+  for (unsigned int i = 0; i < 100; i++) {
+    async.Write(ola::OLA_LOG_WARN, ola::IntToString(i));
+  }
+  async.Stop();
+
+  vector<string> lines = destination->Lines();
+  OLA_ASSERT_EQ(static_cast<size_t>(100), lines.size());
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    OLA_ASSERT_EQ(ola::IntToString(i), lines[i]);
+  }
+  OLA_ASSERT_EQ(0u, async.Dropped());
+}
+
+
+/*
+ * Check lines are written immediately if the thread isn't running, or the
+ * line is fatal.
+ */
+void AsyncLogDestinationTest::testNotRunning() {
+  BlockingLogDestination *destination = new BlockingLogDestination();
+  AsyncLogDestination async(destination);
+  async.Write(ola::OLA_LOG_WARN, "before");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), destination->Lines().size());
+
+  OLA_ASSERT_TRUE(async.Start());
+  async.Write(ola::OLA_LOG_FATAL, "fatal");
+  OLA_ASSERT_EQ(static_cast<size_t>(2), destination->Lines().size());
+  OLA_ASSERT_EQ(string("fatal"), destination->Lines()[1]);
+
+  ola::LogDestination *released = async.Release();
+  OLA_ASSERT_TRUE(released == destination);
+  async.Write(ola::OLA_LOG_WARN, "after");
+  OLA_ASSERT_EQ(static_cast<size_t>(2), destination->Lines().size());
+  delete released;
+}
+
+
+/*
+ * Check lines are dropped if the queue is full.
+ */
+void AsyncLogDestinationTest::testDropped() {
+  BlockingLogDestination *destination = new BlockingLogDestination();
+  AsyncLogDestination async(destination, 2);
+  OLA_ASSERT_TRUE(async.Start());
+
+  destination->Block();
+  async.Write(ola::OLA_LOG_WARN, "a");
+  destination->WaitForWriter();
+
+  async.Write(ola::OLA_LOG_WARN, "b");
+  async.Write(ola::OLA_LOG_WARN, "c");
+  async.Write(ola::OLA_LOG_WARN, "d");
+  async.Write(ola::OLA_LOG_WARN, "e");
+  OLA_ASSERT_EQ(2u, async.Dropped());
+
+  destination->Unblock();
+  async.Stop();
+
+  vector<string> lines = destination->Lines();
+  OLA_ASSERT_EQ(static_cast<size_t>(4), lines.size());
+  OLA_ASSERT_EQ(string("a"), lines[0]);
+  OLA_ASSERT_EQ(string("b"), lines[1]);
+  OLA_ASSERT_EQ(string("c"), lines[2]);
+  OLA_ASSERT_EQ(string("Dropped 2 log lines, the log queue was full\n"),
+                lines[3]);
+}
@@ -40,9 +40,14 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <map>
 #include <string>
+#include <utility>
+#include "ola/Clock.h"
 #include "ola/Logging.h"
+#include "ola/base/AsyncLogDestination.h"
 #include "ola/base/Flags.h"
+#include "ola/thread/Mutex.h"
 
 /**@private*/
 DEFINE_s_int8(log_level, l, ola::OLA_LOG_WARN, "Set the logging level 0 .. 4.");
@@ -51,7 +56,11 @@ DEFINE_default_bool(syslog, false, "Send to syslog rather than stderr.");
 
 namespace ola {
 
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::map;
 using std::ostringstream;
+using std::pair;
 using std::string;
 
 /**
@@ -61,6 +70,26 @@ using std::string;
 LogDestination *log_target = NULL;
 
 log_level logging_level = OLA_LOG_WARN;
+
+namespace {
+// The state of an OLA_LOG_LIMITED call site.
+struct RateLimitedSite {
+  RateLimitedSite() : count(0), suppressed(0) {}
+
+  TimeStamp window_start;
+  unsigned int count;
+  unsigned int suppressed;
+};
+
+typedef map<pair<const char*, int>, RateLimitedSite> RateLimitedSiteMap;
+
+Mutex rate_limit_mutex;
+RateLimitedSiteMap rate_limited_sites;
+unsigned int suppressed_lines = 0;
+
+// Set if StartAsyncLogging() wrapped log_target.
+AsyncLogDestination *async_target = NULL;
+}  // namespace
 /**@endcond*/
 
 /**
@@ -143,6 +172,48 @@ void InitLogging(log_level level, LogDestination *destination) {
     delete log_target;
   }
   log_target = destination;
+  async_target = NULL;
+}
+
+
+bool StartAsyncLogging() {
+  if (async_target) {
+    return true;
+  }
+  if (!log_target) {
+    return false;
+  }
+
+  AsyncLogDestination *destination = new AsyncLogDestination(log_target);
+  if (!destination->Start()) {
+    destination->Release();
+    delete destination;
+    return false;
+  }
+  log_target = destination;
+  async_target = destination;
+  return true;
+}
+
+
+void StopAsyncLogging() {
+  if (!async_target) {
+    return;
+  }
+  log_target = async_target->Release();
+  delete async_target;
+  async_target = NULL;
+}
+
+
+unsigned int SuppressedLogLines() {
+  MutexLocker lock(&rate_limit_mutex);
+  return suppressed_lines;
+}
+
+
+unsigned int DroppedLogLines() {
+  return async_target ? async_target->Dropped() : 0;
 }
 
 /**@}*/
@@ -160,6 +231,39 @@ LogLine::~LogLine() {
   Write();
 }
 
+bool AllowLogLine(const char *file, int line, log_level level) {
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+
+  unsigned int suppressed = 0;
+  {
+    MutexLocker lock(&rate_limit_mutex);
+    RateLimitedSite &site = rate_limited_sites[std::make_pair(file, line)];
+    // Start a new window each second, or if the clock went backwards.
+    if (!site.window_start.IsSet() || now < site.window_start ||
+        now - site.window_start >= TimeInterval(1, 0)) {
+      site.window_start = now;
+      site.count = 0;
+      suppressed = site.suppressed;
+      site.suppressed = 0;
+    }
+
+    if (site.count >= LOG_RATE_LIMIT) {
+      site.suppressed++;
+      suppressed_lines++;
+      return false;
+    }
+    site.count++;
+  }
+
+  if (suppressed) {
+    LogLine(file, line, level).stream()
+        << "Suppressed " << suppressed << " similar log lines";
+  }
+  return true;
+}
+
 void LogLine::Write() {
   if (m_stream.str().length() == m_prefix_length)
     return;
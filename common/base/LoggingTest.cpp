@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <deque>
 #include <string>
 #include <utility>
@@ -39,10 +40,12 @@ using ola::log_level;
 class LoggingTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(LoggingTest);
   CPPUNIT_TEST(testLogging);
+  CPPUNIT_TEST(testRateLimiting);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testLogging();
+    void testRateLimiting();
 };
 
 
@@ -125,3 +128,47 @@ void LoggingTest::testLogging() {
   OLA_FATAL << "fatal";
   OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
 }
+
+
+/*
+ * A single OLA_WARN_LIMITED call site.
+ */
+static void LogLimited() {
+  OLA_WARN_LIMITED << "limited";
+}
+
+
+/*
+ * Check that OLA_WARN_LIMITED limits the lines from each call site.
+ */
+void LoggingTest::testRateLimiting() {
+  MockLogDestination *destination = new MockLogDestination();
+  InitLogging(ola::OLA_LOG_WARN, destination);
+  unsigned int suppressed = ola::SuppressedLogLines();
+
+  for (unsigned int i = 0; i < ola::LOG_RATE_LIMIT; i++) {
+    destination->AddExpected(ola::OLA_LOG_WARN, " limited\n");
+  }
+  for (unsigned int i = 0; i < ola::LOG_RATE_LIMIT + 5; i++) {
+    LogLimited();
+  }
+  OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
+  OLA_ASSERT_EQ(suppressed + 5, ola::SuppressedLogLines());
+
+  // Lines below the log level aren't counted.
+  OLA_INFO_LIMITED << "info";
+  OLA_ASSERT_EQ(suppressed + 5, ola::SuppressedLogLines());
+
+  // Other call sites aren't affected.
+  destination->AddExpected(ola::OLA_LOG_WARN, " other\n");
+  OLA_WARN_LIMITED << "other";
+  OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
+
+  // Once the second is up, the count of suppressed lines is logged.
+  usleep(1100000);
+  destination->AddExpected(ola::OLA_LOG_WARN,
+                           " Suppressed 5 similar log lines\n");
+  destination->AddExpected(ola::OLA_LOG_WARN, " limited\n");
+  LogLimited();
+  OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
+}
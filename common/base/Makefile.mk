@@ -1,6 +1,7 @@
 # LIBRARIES
 ##################################################
 common_libolacommon_la_SOURCES += \
+    common/base/AsyncLogDestination.cpp \
     common/base/Credentials.cpp \
     common/base/Env.cpp \
     common/base/Flags.cpp \
@@ -24,6 +25,8 @@ common_base_FlagsTester_SOURCES = common/base/FlagsTest.cpp
 common_base_FlagsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_base_FlagsTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_base_LoggingTester_SOURCES = common/base/LoggingTest.cpp
+common_base_LoggingTester_SOURCES = \
+    common/base/AsyncLogDestinationTest.cpp \
+    common/base/LoggingTest.cpp
 common_base_LoggingTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_base_LoggingTester_LDADD = $(COMMON_TESTING_LIBS)
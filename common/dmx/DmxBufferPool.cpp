@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxBufferPool.cpp
+ * A free list of the memory blocks used by DmxBuffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/dmx/DmxBufferPool.h"
+
+#include "ola/ExportMap.h"
+
+namespace ola {
+namespace dmx {
+
+using ola::thread::MutexLocker;
+
+const char DmxBufferPool::K_POOL_HITS_VAR[] = "dmx-buffer-pool-hits";
+const char DmxBufferPool::K_POOL_MISSES_VAR[] = "dmx-buffer-pool-misses";
+
+DmxBufferPool::DmxBufferPool()
+    : m_enabled(false),
+      m_max_free_blocks(0),
+      m_free_count(0),
+      m_free_list(NULL),
+      m_hits(0),
+      m_misses(0),
+      m_hits_var(NULL),
+      m_misses_var(NULL) {
+}
+
+
+DmxBufferPool::~DmxBufferPool() {
+  FreeAll();
+}
+
+
+void DmxBufferPool::SetMaxFreeBlocks(unsigned int max_free_blocks) {
+  MutexLocker lock(&m_mutex);
+  m_max_free_blocks = max_free_blocks;
+  m_enabled = max_free_blocks > 0;
+  while (m_free_count > m_max_free_blocks) {
+    DmxBufferBlock *block = m_free_list;
+    m_free_list = block->next;
+    m_free_count--;
+    delete block;
+  }
+}
+
+
+void DmxBufferPool::SetExportMap(ExportMap *export_map) {
+  MutexLocker lock(&m_mutex);
+  if (export_map) {
+    m_hits_var = export_map->GetCounterVar(K_POOL_HITS_VAR);
+    m_misses_var = export_map->GetCounterVar(K_POOL_MISSES_VAR);
+  } else {
+    m_hits_var = NULL;
+    m_misses_var = NULL;
+  }
+}
+
+
+DmxBufferBlock *DmxBufferPool::Allocate() {
+  // m_enabled only changes before the other threads start, so we can skip
+  // the lock if there is no pool.
+  if (!m_enabled) {
+    return new DmxBufferBlock;
+  }
+
+  MutexLocker lock(&m_mutex);
+  if (m_free_list) {
+    DmxBufferBlock *block = m_free_list;
+    m_free_list = block->next;
+    m_free_count--;
+    m_hits++;
+    if (m_hits_var) {
+      (*m_hits_var)++;
+    }
+    return block;
+  }
+
+  m_misses++;
+  if (m_misses_var) {
+    (*m_misses_var)++;
+  }
+  return new DmxBufferBlock;
+}
+
+
+void DmxBufferPool::Release(DmxBufferBlock *block) {
+  if (m_enabled) {
+    MutexLocker lock(&m_mutex);
+    if (m_free_count < m_max_free_blocks) {
+      block->next = m_free_list;
+      m_free_list = block;
+      m_free_count++;
+      return;
+    }
+  }
+  delete block;
+}
+
+
+unsigned int DmxBufferPool::FreeBlocks() const {
+  MutexLocker lock(&m_mutex);
+  return m_free_count;
+}
+
+
+unsigned int DmxBufferPool::Hits() const {
+  MutexLocker lock(&m_mutex);
+  return m_hits;
+}
+
+
+unsigned int DmxBufferPool::Misses() const {
+  MutexLocker lock(&m_mutex);
+  return m_misses;
+}
+
+
+DmxBufferPool *DmxBufferPool::Global() {
+  static DmxBufferPool *pool = new DmxBufferPool();
+  return pool;
+}
+
+
+void DmxBufferPool::FreeAll() {
+  MutexLocker lock(&m_mutex);
+  while (m_free_list) {
+    DmxBufferBlock *block = m_free_list;
+    m_free_list = block->next;
+    delete block;
+  }
+  m_free_count = 0;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,145 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxBufferPool.h
+ * A free list of the memory blocks used by DmxBuffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_DMXBUFFERPOOL_H_
+#define COMMON_DMX_DMXBUFFERPOOL_H_
+
+#include <stdint.h>
+#include "ola/Constants.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+class CounterVariable;
+class ExportMap;
+
+namespace dmx {
+
+/**
+ * @brief The memory used to hold the data for a DmxBuffer.
+ *
+ * The reference count lives in the same block as the data, so each buffer
+ * only needs a single allocation.
+ */
+struct DmxBufferBlock {
+  unsigned int ref_count;  // must be first, see FromRefCount()
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  DmxBufferBlock *next;  // used while the block is in the free list
+
+  /**
+   * @brief Get the block that holds a reference count.
+   */
+  static DmxBufferBlock *FromRefCount(unsigned int *ref_count) {
+    return reinterpret_cast<DmxBufferBlock*>(ref_count);
+  }
+};
+
+
+/**
+ * @brief Keeps released DmxBuffer blocks around so they can be reused.
+ *
+ * By default the pool is disabled and blocks are allocated & freed with
+ * new / delete. Once enabled, up to max_free_blocks released blocks are kept
+ * on a free list, which saves a trip through malloc for the high rate paths
+ * that copy DmxBuffers.
+ *
+ * The pool is thread safe, since DmxBuffers are created in many threads.
+ */
+class DmxBufferPool {
+ public:
+  DmxBufferPool();
+
+  /**
+   * @brief Destructor, this frees the blocks in the free list.
+   */
+  ~DmxBufferPool();
+
+  /**
+   * @brief Set the maximum number of free blocks to hold on to.
+   * @param max_free_blocks the size of the free list, 0 disables the pool.
+   *
+   * This should be called before other threads are started.
+   */
+  void SetMaxFreeBlocks(unsigned int max_free_blocks);
+
+  /**
+   * @brief Export the hit & miss counters.
+   * @param export_map the ExportMap to use or NULL to stop exporting the
+   *   counters. The ExportMap must outlive the pool, or be removed first.
+   */
+  void SetExportMap(ExportMap *export_map);
+
+  /**
+   * @brief Allocate a block.
+   * @return a new block, the contents are uninitialized.
+   */
+  DmxBufferBlock *Allocate();
+
+  /**
+   * @brief Return a block to the pool.
+   * @param block the block to release.
+   */
+  void Release(DmxBufferBlock *block);
+
+  /**
+   * @brief The number of blocks in the free list.
+   */
+  unsigned int FreeBlocks() const;
+
+  /**
+   * @brief The number of allocations served from the free list.
+   */
+  unsigned int Hits() const;
+
+  /**
+   * @brief The number of allocations made while the free list was empty.
+   */
+  unsigned int Misses() const;
+
+  /**
+   * @brief The pool used by DmxBuffer.
+   *
+   * This is never deleted, so buffers with static storage duration can be
+   * released safely at exit.
+   */
+  static DmxBufferPool *Global();
+
+  static const char K_POOL_HITS_VAR[];
+  static const char K_POOL_MISSES_VAR[];
+
+ private:
+  mutable ola::thread::Mutex m_mutex;
+  bool m_enabled;
+  unsigned int m_max_free_blocks;
+  unsigned int m_free_count;
+  DmxBufferBlock *m_free_list;
+  unsigned int m_hits;
+  unsigned int m_misses;
+  CounterVariable *m_hits_var;
+  CounterVariable *m_misses_var;
+
+  void FreeAll();
+
+  DISALLOW_COPY_AND_ASSIGN(DmxBufferPool);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_DMXBUFFERPOOL_H_
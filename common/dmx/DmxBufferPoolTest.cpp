@@ -0,0 +1,154 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxBufferPoolTest.cpp
+ * Test fixture for the DmxBufferPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "common/dmx/DmxBufferPool.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::CounterVariable;
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::dmx::DmxBufferBlock;
+using ola::dmx::DmxBufferPool;
+
+class DmxBufferPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxBufferPoolTest);
+  CPPUNIT_TEST(testDisabled);
+  CPPUNIT_TEST(testFreeList);
+  CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST(testGlobalPool);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testDisabled();
+    void testFreeList();
+    void testExportMap();
+    void testGlobalPool();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxBufferPoolTest);
+
+
+/*
+ * Check a disabled pool doesn't hold on to blocks.
+ */
+void DmxBufferPoolTest::testDisabled() {
+  DmxBufferPool pool;
+  DmxBufferBlock *block = pool.Allocate();
+  OLA_ASSERT_NOT_NULL(block);
+  OLA_ASSERT_EQ(block, DmxBufferBlock::FromRefCount(&block->ref_count));
+  pool.Release(block);
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(0u, pool.Hits());
+  OLA_ASSERT_EQ(0u, pool.Misses());
+}
+
+
+/*
+ * Check blocks are reused, and the free list is bounded.
+ */
+void DmxBufferPoolTest::testFreeList() {
+  DmxBufferPool pool;
+  pool.SetMaxFreeBlocks(2);
+
+  DmxBufferBlock *block1 = pool.Allocate();
+  DmxBufferBlock *block2 = pool.Allocate();
+  DmxBufferBlock *block3 = pool.Allocate();
+  OLA_ASSERT_EQ(0u, pool.Hits());
+  OLA_ASSERT_EQ(3u, pool.Misses());
+
+  pool.Release(block1);
+  pool.Release(block2);
+  pool.Release(block3);
+  OLA_ASSERT_EQ(2u, pool.FreeBlocks());
+
+  OLA_ASSERT_EQ(block2, pool.Allocate());
+  OLA_ASSERT_EQ(block1, pool.Allocate());
+  OLA_ASSERT_EQ(2u, pool.Hits());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+
+  pool.Release(block1);
+  pool.Release(block2);
+  OLA_ASSERT_EQ(2u, pool.FreeBlocks());
+
+  // shrinking the pool frees the extra blocks
+  pool.SetMaxFreeBlocks(1);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  pool.SetMaxFreeBlocks(0);
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+}
+
+
+/*
+ * Check the counters are exported.
+ */
+void DmxBufferPoolTest::testExportMap() {
+  ExportMap export_map;
+  DmxBufferPool pool;
+  pool.SetMaxFreeBlocks(1);
+  pool.SetExportMap(&export_map);
+
+  CounterVariable *hits = export_map.GetCounterVar(
+      DmxBufferPool::K_POOL_HITS_VAR);
+  CounterVariable *misses = export_map.GetCounterVar(
+      DmxBufferPool::K_POOL_MISSES_VAR);
+
+  pool.Release(pool.Allocate());
+  pool.Release(pool.Allocate());
+  OLA_ASSERT_EQ(1u, hits->Get());
+  OLA_ASSERT_EQ(1u, misses->Get());
+
+  pool.SetExportMap(NULL);
+  pool.Release(pool.Allocate());
+  OLA_ASSERT_EQ(1u, hits->Get());
+  OLA_ASSERT_EQ(2u, pool.Hits());
+}
+
+
+/*
+ * Check DmxBuffer uses the global pool.
+ */
+void DmxBufferPoolTest::testGlobalPool() {
+  DmxBufferPool *pool = DmxBufferPool::Global();
+  OLA_ASSERT_EQ(pool, DmxBufferPool::Global());
+  pool->SetMaxFreeBlocks(4);
+
+  const uint8_t data[] = {1, 2, 3};
+  unsigned int misses = pool->Misses();
+  unsigned int hits = pool->Hits();
+  {
+    DmxBuffer buffer(data, sizeof(data));
+    DmxBuffer copy(buffer);
+    copy.SetChannel(0, 10);  // forces a copy
+    OLA_ASSERT_EQ(misses + hits + 2, pool->Misses() + pool->Hits());
+    OLA_ASSERT_EQ(1, static_cast<int>(buffer.Get(0)));
+    OLA_ASSERT_EQ(10, static_cast<int>(copy.Get(0)));
+  }
+  OLA_ASSERT_EQ(2u, pool->FreeBlocks());
+
+  hits = pool->Hits();
+  DmxBuffer buffer(data, sizeof(data));
+  OLA_ASSERT_EQ(hits + 1, pool->Hits());
+  OLA_ASSERT_EQ(1u, pool->FreeBlocks());
+  pool->SetMaxFreeBlocks(0);
+}
@@ -0,0 +1,215 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxOutputMultiplexer.cpp
+ * Drive several host generated DMX outputs from one thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
+
+namespace ola {
+namespace dmx {
+
+using ola::thread::MutexLocker;
+
+const unsigned int DmxOutputMultiplexer::DMX_BREAK;
+const unsigned int DmxOutputMultiplexer::DMX_MAB;
+const int64_t DmxOutputMultiplexer::MAX_SLEEP;
+
+namespace {
+const int64_t NSEC_IN_USEC = 1000;
+}  // namespace
+
+DmxOutputMultiplexer::OutputState::OutputState(Output *output,
+                                               const Timing &timing,
+                                               ExportMap *export_map)
+    : output(output),
+      timing(timing),
+      timer(new FrameTimer(timing.frame_rate, export_map,
+                           output->Description())),
+      step(BREAK),
+      deadline(FrameTimer::Now()),
+      frame_deadline(deadline) {
+}
+
+DmxOutputMultiplexer::OutputState::~OutputState() {
+  delete timer;
+}
+
+DmxOutputMultiplexer::DmxOutputMultiplexer(bool realtime,
+                                           ExportMap *export_map)
+    : ola::thread::Thread(ola::thread::Thread::Options("dmx-output")),
+      m_realtime(realtime),
+      m_export_map(export_map),
+      m_term(false) {
+}
+
+DmxOutputMultiplexer::~DmxOutputMultiplexer() {
+  Stop();
+  OutputList::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    delete *iter;
+  }
+}
+
+void DmxOutputMultiplexer::AddOutput(Output *output, const Timing &timing) {
+  OutputState *state = new OutputState(output, timing, m_export_map);
+  MutexLocker output_locker(&m_output_mutex);
+  MutexLocker frame_locker(&m_frame_mutex);
+  m_outputs.push_back(state);
+}
+
+void DmxOutputMultiplexer::RemoveOutput(Output *output) {
+  OutputState *state = NULL;
+  {
+    MutexLocker output_locker(&m_output_mutex);
+    MutexLocker frame_locker(&m_frame_mutex);
+    OutputList::iterator iter = m_outputs.begin();
+    for (; iter != m_outputs.end(); ++iter) {
+      if ((*iter)->output == output) {
+        state = *iter;
+        m_outputs.erase(iter);
+        break;
+      }
+    }
+  }
+  delete state;
+}
+
+unsigned int DmxOutputMultiplexer::OutputCount() {
+  MutexLocker locker(&m_frame_mutex);
+  return m_outputs.size();
+}
+
+bool DmxOutputMultiplexer::WriteDMX(Output *output, const DmxBuffer &buffer) {
+  SharedDmxFrame frame(buffer);
+  MutexLocker locker(&m_frame_mutex);
+  OutputList::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    if ((*iter)->output == output) {
+      (*iter)->pending.Swap(&frame);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DmxOutputMultiplexer::Stop() {
+  {
+    MutexLocker locker(&m_term_mutex);
+    m_term = true;
+  }
+  return Join();
+}
+
+void *DmxOutputMultiplexer::Run() {
+  if (m_realtime && !FrameTimer::UseRealtimeScheduling()) {
+    OLA_WARN << "Failed to enable real time scheduling for the DMX output "
+             << "thread";
+  }
+
+  while (true) {
+    {
+      MutexLocker locker(&m_term_mutex);
+      if (m_term) {
+        break;
+      }
+    }
+
+    int64_t wake_up = FrameTimer::Now() + MAX_SLEEP;
+    {
+      MutexLocker locker(&m_output_mutex);
+      OutputState *state = NextOutput();
+      if (state && state->deadline <= FrameTimer::Now()) {
+        RunStep(state);
+        continue;
+      }
+      if (state) {
+        wake_up = std::min(wake_up, state->deadline);
+      }
+    }
+    FrameTimer::SleepUntil(wake_up);
+  }
+  return NULL;
+}
+
+/*
+ * Return the output with the earliest deadline. This must be called with
+ * m_output_mutex held.
+ */
+DmxOutputMultiplexer::OutputState *DmxOutputMultiplexer::NextOutput() {
+  OutputState *next = NULL;
+  OutputList::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    if (!next || (*iter)->deadline < next->deadline) {
+      next = *iter;
+    }
+  }
+  return next;
+}
+
+/*
+ * Run the next step for an output. This must be called with m_output_mutex
+ * held.
+ */
+void DmxOutputMultiplexer::RunStep(OutputState *state) {
+  switch (state->step) {
+    case BREAK:
+      {
+        MutexLocker locker(&m_frame_mutex);
+        if (!state->pending.IsSameFrame(state->frame)) {
+          state->frame = state->pending;
+          state->frame.CopyTo(&state->buffer);
+        }
+      }
+      state->timer->RecordStart(state->frame_deadline);
+      state->timer->StartFrame();
+      if (!state->output->SetBreak(true)) {
+        EndFrame(state);
+        return;
+      }
+      state->step = MARK_AFTER_BREAK;
+      state->deadline = FrameTimer::Now() +
+                        state->timing.break_time * NSEC_IN_USEC;
+      break;
+    case MARK_AFTER_BREAK:
+      if (!state->output->SetBreak(false)) {
+        EndFrame(state);
+        return;
+      }
+      state->step = DATA;
+      state->deadline = FrameTimer::Now() +
+                        state->timing.mab_time * NSEC_IN_USEC;
+      break;
+    case DATA:
+      state->output->Write(state->buffer);
+      EndFrame(state);
+      break;
+  }
+}
+
+void DmxOutputMultiplexer::EndFrame(OutputState *state) {
+  state->step = BREAK;
+  state->frame_deadline = state->timer->NextFrameTime(
+      state->timing.mark_after_frame);
+  state->deadline = state->frame_deadline;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,164 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxOutputMultiplexerTest.cpp
+ * Test fixture for the DmxOutputMultiplexer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::dmx::DmxOutputMultiplexer;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Records the calls made by the multiplexer. Nothing is read until the
+ * output has been removed, so there's no locking.
+ */
+class MockOutput : public DmxOutputMultiplexer::Output {
+ public:
+  explicit MockOutput(const string &name)
+      : frames(0),
+        out_of_order(0),
+        m_name(name),
+        m_in_break(false),
+        m_marked(false) {
+  }
+
+  string Description() const { return m_name; }
+
+  bool SetBreak(bool on) {
+    if (on == m_in_break) {
+      out_of_order++;
+    }
+    m_in_break = on;
+    m_marked = !on;
+    return true;
+  }
+
+  bool Write(const DmxBuffer &data) {
+    if (!m_marked) {
+      out_of_order++;
+    }
+    m_marked = false;
+    last_frame = data;
+    frames++;
+    return true;
+  }
+
+  unsigned int frames;
+  unsigned int out_of_order;
+  DmxBuffer last_frame;
+
+ private:
+  const string m_name;
+  bool m_in_break;
+  bool m_marked;
+};
+}  // namespace
+
+class DmxOutputMultiplexerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxOutputMultiplexerTest);
+  CPPUNIT_TEST(testMultipleOutputs);
+  CPPUNIT_TEST(testRemoveOutput);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testMultipleOutputs();
+  void testRemoveOutput();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxOutputMultiplexerTest);
+
+/*
+ * Check all the outputs are driven, in the right order, at the right rate.
+ */
+void DmxOutputMultiplexerTest::testMultipleOutputs() {
+  const unsigned int OUTPUT_COUNT = 4;
+  DmxOutputMultiplexer multiplexer;
+  vector<MockOutput*> outputs;
+
+  DmxOutputMultiplexer::Timing timing;
+  timing.frame_rate = 100;
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+
+  for (unsigned int i = 0; i < OUTPUT_COUNT; i++) {
+    std::ostringstream name;
+    name << "output-" << i;
+    MockOutput *output = new MockOutput(name.str());
+    outputs.push_back(output);
+    multiplexer.AddOutput(output, timing);
+    OLA_ASSERT_TRUE(multiplexer.WriteDMX(output, buffer));
+  }
+  OLA_ASSERT_EQ(OUTPUT_COUNT, multiplexer.OutputCount());
+
+  MockOutput unknown("unknown");
+  OLA_ASSERT_FALSE(multiplexer.WriteDMX(&unknown, buffer));
+
+  OLA_ASSERT_TRUE(multiplexer.Start());
+  usleep(200000);
+  OLA_ASSERT_TRUE(multiplexer.Stop());
+
+  for (unsigned int i = 0; i < OUTPUT_COUNT; i++) {
+    // 20 frames at 100Hz, leave plenty of room for a loaded machine.
+    OLA_ASSERT_TRUE(outputs[i]->frames >= 5);
+    OLA_ASSERT_TRUE(outputs[i]->frames <= 21);
+    OLA_ASSERT_EQ(0u, outputs[i]->out_of_order);
+    OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(),
+                           outputs[i]->last_frame.GetRaw(),
+                           outputs[i]->last_frame.Size());
+    multiplexer.RemoveOutput(outputs[i]);
+    delete outputs[i];
+  }
+  OLA_ASSERT_EQ(0u, multiplexer.OutputCount());
+}
+
+/*
+ * Check outputs can be removed while the thread is running.
+ */
+void DmxOutputMultiplexerTest::testRemoveOutput() {
+  DmxOutputMultiplexer multiplexer;
+  MockOutput output1("output-1"), output2("output-2");
+  DmxOutputMultiplexer::Timing timing;
+
+  multiplexer.AddOutput(&output1, timing);
+  multiplexer.AddOutput(&output2, timing);
+  OLA_ASSERT_TRUE(multiplexer.Start());
+  usleep(20000);
+
+  multiplexer.RemoveOutput(&output1);
+  unsigned int frames = output1.frames;
+  OLA_ASSERT_TRUE(frames > 0);
+  OLA_ASSERT_EQ(1u, multiplexer.OutputCount());
+
+  usleep(20000);
+  OLA_ASSERT_EQ(frames, output1.frames);
+  OLA_ASSERT_TRUE(multiplexer.Stop());
+  OLA_ASSERT_TRUE(output2.frames > 0);
+}
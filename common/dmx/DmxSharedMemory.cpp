@@ -0,0 +1,248 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxSharedMemory.cpp
+ * DMX frames passed between processes through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/DmxSharedMemory.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+/*
+ * The layout of the segment. Both sides are on the same machine, so the
+ * fields are in host byte order.
+ */
+struct DmxSharedMemory::Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t slot_count;
+  volatile uint32_t doorbell;
+};
+
+struct DmxSharedMemory::Slot {
+  volatile uint32_t sequence;  // odd while the slot is being written
+  uint32_t universe;
+  uint16_t length;
+  uint8_t priority;
+  uint8_t reserved;
+  uint8_t data[DMX_UNIVERSE_SIZE];
+};
+
+const char DmxSharedMemory::NAME_PREFIX[] = "/ola-dmx-";
+const unsigned int DmxSharedMemory::MAX_SLOTS;
+
+namespace {
+const uint32_t SEGMENT_MAGIC = 0x4f4c4144;  // OLAD
+const uint16_t SEGMENT_VERSION = 1;
+}  // namespace
+
+DmxSharedMemory::~DmxSharedMemory() {
+  munmap(m_memory, m_size);
+}
+
+DmxSharedMemory *DmxSharedMemory::Create(const string &name,
+                                         unsigned int slot_count) {
+  if (slot_count == 0 || slot_count > MAX_SLOTS) {
+    OLA_WARN << "Invalid shared memory slot count " << slot_count;
+    return NULL;
+  }
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  const size_t size = SegmentSize(slot_count);
+  if (ftruncate(fd, size)) {
+    OLA_WARN << "ftruncate(" << name << "): " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate() zeros the segment, so the sequence numbers and doorbell
+  // start at 0.
+  Header *header = reinterpret_cast<Header*>(memory);
+  header->slot_count = slot_count;
+  header->version = SEGMENT_VERSION;
+  __sync_synchronize();
+  header->magic = SEGMENT_MAGIC;
+  return new DmxSharedMemory(name, memory, size, slot_count);
+}
+
+DmxSharedMemory *DmxSharedMemory::Open(const string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) ||
+      static_cast<size_t>(stat_buf.st_size) < SegmentSize(1)) {
+    OLA_WARN << "Shared memory segment " << name << " is too small";
+    close(fd);
+    return NULL;
+  }
+
+  // The writer owns the segment, so don't trust the header until the size
+  // has been checked against it.
+  const size_t size = stat_buf.st_size;
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  const Header *header = reinterpret_cast<Header*>(memory);
+  const unsigned int slot_count = header->slot_count;
+  if (header->magic != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+      slot_count == 0 || slot_count > MAX_SLOTS ||
+      SegmentSize(slot_count) > size) {
+    OLA_WARN << "Invalid shared memory segment " << name;
+    munmap(memory, size);
+    return NULL;
+  }
+  return new DmxSharedMemory(name, memory, size, slot_count);
+}
+
+void DmxSharedMemory::Unlink() {
+  shm_unlink(m_name.c_str());
+}
+
+bool DmxSharedMemory::Write(unsigned int slot_index, unsigned int universe,
+                            uint8_t priority, const DmxBuffer &data) {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+
+  Slot *slot = &m_slots[slot_index];
+  const uint32_t sequence = slot->sequence;
+  slot->sequence = sequence + 1;
+  __sync_synchronize();
+
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  data.Get(slot->data, &length);
+  slot->universe = universe;
+  slot->length = length;
+  slot->priority = priority;
+
+  __sync_synchronize();
+  slot->sequence = sequence + 2;
+  return true;
+}
+
+bool DmxSharedMemory::Read(unsigned int slot_index, unsigned int *universe,
+                           uint8_t *priority, DmxBuffer *data) {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+
+  const Slot *slot = &m_slots[slot_index];
+  const uint32_t sequence = slot->sequence;
+  if (sequence & 1 || sequence == m_last_read[slot_index]) {
+    return false;
+  }
+  __sync_synchronize();
+
+  uint8_t slot_data[DMX_UNIVERSE_SIZE];
+  const unsigned int slot_universe = slot->universe;
+  const unsigned int length = std::min(
+      static_cast<unsigned int>(slot->length),
+      static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+  const uint8_t slot_priority = slot->priority;
+  memcpy(slot_data, slot->data, length);
+
+  __sync_synchronize();
+  if (slot->sequence != sequence) {
+    // The writer updated the slot while we were copying it. It'll ring the
+    // doorbell once it's done.
+    return false;
+  }
+
+  m_last_read[slot_index] = sequence;
+  *universe = slot_universe;
+  *priority = slot_priority;
+  data->Set(slot_data, length);
+  return true;
+}
+
+bool DmxSharedMemory::RingDoorbell() {
+  return __sync_val_compare_and_swap(&m_header->doorbell, 0, 1) == 0;
+}
+
+void DmxSharedMemory::ClearDoorbell() {
+  __sync_val_compare_and_swap(&m_header->doorbell, 1, 0);
+}
+
+bool DmxSharedMemory::IsValidName(const string &name) {
+  if (!StringBeginsWith(name, NAME_PREFIX) ||
+      name.size() == sizeof(NAME_PREFIX) - 1) {
+    return false;
+  }
+  for (unsigned int i = sizeof(NAME_PREFIX) - 1; i < name.size(); i++) {
+    if (!isalnum(name[i]) && name[i] != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
+DmxSharedMemory::DmxSharedMemory(const string &name, void *memory,
+                                 size_t size, unsigned int slot_count)
+    : m_name(name),
+      m_memory(memory),
+      m_size(size),
+      m_slot_count(slot_count),
+      m_header(reinterpret_cast<Header*>(memory)),
+      m_slots(reinterpret_cast<Slot*>(
+            reinterpret_cast<uint8_t*>(memory) + sizeof(Header))),
+      m_last_read(slot_count, 0) {
+}
+
+size_t DmxSharedMemory::SegmentSize(unsigned int slot_count) {
+  return sizeof(Header) + slot_count * sizeof(Slot);
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,149 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxSharedMemoryTest.cpp
+ * Test fixture for the DmxSharedMemory class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/DmxSharedMemory.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::dmx::DmxSharedMemory;
+using std::auto_ptr;
+using std::string;
+
+class DmxSharedMemoryTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxSharedMemoryTest);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testDoorbell);
+  CPPUNIT_TEST(testInvalid);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testReadWrite();
+  void testDoorbell();
+  void testInvalid();
+
+ private:
+  string m_name;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxSharedMemoryTest);
+
+void DmxSharedMemoryTest::setUp() {
+  std::ostringstream str;
+  str << DmxSharedMemory::NAME_PREFIX << "test-" << getpid();
+  m_name = str.str();
+}
+
+void DmxSharedMemoryTest::tearDown() {
+  auto_ptr<DmxSharedMemory> memory(DmxSharedMemory::Open(m_name));
+  if (memory.get()) {
+    memory->Unlink();
+  }
+}
+
+/*
+ * Check frames written by one side can be read by the other.
+ */
+void DmxSharedMemoryTest::testReadWrite() {
+  auto_ptr<DmxSharedMemory> writer(DmxSharedMemory::Create(m_name, 4));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<DmxSharedMemory> reader(DmxSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  OLA_ASSERT_EQ(4u, reader->SlotCount());
+
+  unsigned int universe;
+  uint8_t priority;
+  DmxBuffer data;
+  for (unsigned int i = 0; i < reader->SlotCount(); i++) {
+    OLA_ASSERT_FALSE(reader->Read(i, &universe, &priority, &data));
+  }
+
+  DmxBuffer frame1, frame2;
+  frame1.SetFromString("1,2,3");
+  frame2.SetFromString("4,5,6,7");
+  OLA_ASSERT_TRUE(writer->Write(0, 10, 100, frame1));
+  OLA_ASSERT_TRUE(writer->Write(3, 11, 50, frame2));
+  OLA_ASSERT_FALSE(writer->Write(4, 12, 50, frame2));
+
+  OLA_ASSERT_TRUE(reader->Read(0, &universe, &priority, &data));
+  OLA_ASSERT_EQ(10u, universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), priority);
+  OLA_ASSERT_EQ(frame1, data);
+  OLA_ASSERT_FALSE(reader->Read(1, &universe, &priority, &data));
+  OLA_ASSERT_TRUE(reader->Read(3, &universe, &priority, &data));
+  OLA_ASSERT_EQ(11u, universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), priority);
+  OLA_ASSERT_EQ(frame2, data);
+
+  // Nothing has changed.
+  OLA_ASSERT_FALSE(reader->Read(0, &universe, &priority, &data));
+
+  OLA_ASSERT_TRUE(writer->Write(0, 10, 100, frame2));
+  OLA_ASSERT_TRUE(reader->Read(0, &universe, &priority, &data));
+  OLA_ASSERT_EQ(frame2, data);
+
+  // Once the name has been removed, the mappings still work.
+  writer->Unlink();
+  OLA_ASSERT_NULL(DmxSharedMemory::Open(m_name));
+  OLA_ASSERT_TRUE(writer->Write(0, 10, 100, frame1));
+  OLA_ASSERT_TRUE(reader->Read(0, &universe, &priority, &data));
+  OLA_ASSERT_EQ(frame1, data);
+}
+
+/*
+ * Check the doorbell.
+ */
+void DmxSharedMemoryTest::testDoorbell() {
+  auto_ptr<DmxSharedMemory> writer(DmxSharedMemory::Create(m_name, 1));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<DmxSharedMemory> reader(DmxSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  OLA_ASSERT_TRUE(writer->RingDoorbell());
+  OLA_ASSERT_FALSE(writer->RingDoorbell());
+  reader->ClearDoorbell();
+  OLA_ASSERT_TRUE(writer->RingDoorbell());
+}
+
+/*
+ * Check invalid names and sizes are rejected.
+ */
+void DmxSharedMemoryTest::testInvalid() {
+  OLA_ASSERT_NULL(DmxSharedMemory::Create(m_name, 0));
+  OLA_ASSERT_NULL(DmxSharedMemory::Create(m_name,
+                                          DmxSharedMemory::MAX_SLOTS + 1));
+  OLA_ASSERT_NULL(DmxSharedMemory::Open(m_name));
+
+  OLA_ASSERT_TRUE(DmxSharedMemory::IsValidName(m_name));
+  OLA_ASSERT_TRUE(DmxSharedMemory::IsValidName("/ola-dmx-1234-1"));
+  OLA_ASSERT_FALSE(DmxSharedMemory::IsValidName(""));
+  OLA_ASSERT_FALSE(DmxSharedMemory::IsValidName("/ola-dmx-"));
+  OLA_ASSERT_FALSE(DmxSharedMemory::IsValidName("/other"));
+  OLA_ASSERT_FALSE(DmxSharedMemory::IsValidName("/ola-dmx-../foo"));
+}
@@ -0,0 +1,156 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FixedDmxBufferTest.cpp
+ * Test fixture for the FixedDmxBuffer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/FixedDmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::dmx::FixedDmxBuffer;
+
+class FixedDmxBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FixedDmxBufferTest);
+  CPPUNIT_TEST(testGetSet);
+  CPPUNIT_TEST(testSetRange);
+  CPPUNIT_TEST(testDmxBuffer);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testGetSet();
+  void testSetRange();
+  void testDmxBuffer();
+
+ private:
+  static const uint8_t TEST_DATA[];
+};
+
+const uint8_t FixedDmxBufferTest::TEST_DATA[] = {1, 2, 3, 4, 5};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FixedDmxBufferTest);
+
+
+/*
+ * Check setting and getting the data.
+ */
+void FixedDmxBufferTest::testGetSet() {
+  FixedDmxBuffer<> buffer;
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_EQ((unsigned int) ola::DMX_UNIVERSE_SIZE, buffer.Capacity());
+  OLA_ASSERT_EQ((uint8_t) 0, buffer.Get(0));
+  OLA_ASSERT_FALSE(buffer.Set(NULL, 1));
+
+  OLA_ASSERT_TRUE(buffer.Set(TEST_DATA, sizeof(TEST_DATA)));
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA, sizeof(TEST_DATA), buffer.GetRaw(),
+                         buffer.Size());
+  OLA_ASSERT_EQ((uint8_t) 5, buffer.Get(4));
+  OLA_ASSERT_EQ((uint8_t) 0, buffer.Get(5));
+
+  FixedDmxBuffer<> copy(buffer);
+  OLA_ASSERT_TRUE(copy == buffer);
+  copy.SetChannel(0, 10);
+  OLA_ASSERT_TRUE(copy != buffer);
+  OLA_ASSERT_EQ((uint8_t) 1, buffer.Get(0));
+  copy = buffer;
+  OLA_ASSERT_TRUE(copy == buffer);
+
+  uint8_t result[3];
+  unsigned int length = sizeof(result);
+  buffer.GetRange(3, result, &length);
+  OLA_ASSERT_EQ(2u, length);
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA + 3, 2, result, length);
+  length = sizeof(result);
+  buffer.GetRange(5, result, &length);
+  OLA_ASSERT_EQ(0u, length);
+
+  // data is truncated to the capacity
+  FixedDmxBuffer<3> small(TEST_DATA, sizeof(TEST_DATA));
+  OLA_ASSERT_EQ(3u, small.Size());
+  small.SetChannel(3, 4);
+  OLA_ASSERT_EQ(3u, small.Size());
+  small.Blackout();
+  OLA_ASSERT_EQ(3u, small.Size());
+  OLA_ASSERT_EQ((uint8_t) 0, small.Get(0));
+  small.Reset();
+  OLA_ASSERT_EQ(0u, small.Size());
+}
+
+
+/*
+ * Check SetRange(), SetRangeToValue() and SetChannel().
+ */
+void FixedDmxBufferTest::testSetRange() {
+  FixedDmxBuffer<8> buffer;
+  // an empty buffer is blacked out first
+  OLA_ASSERT_TRUE(buffer.SetRange(6, TEST_DATA, sizeof(TEST_DATA)));
+  OLA_ASSERT_EQ(8u, buffer.Size());
+  OLA_ASSERT_EQ((uint8_t) 0, buffer.Get(5));
+  OLA_ASSERT_EQ((uint8_t) 2, buffer.Get(7));
+  OLA_ASSERT_FALSE(buffer.SetRange(8, TEST_DATA, 1));
+  OLA_ASSERT_FALSE(buffer.SetRange(0, NULL, 1));
+
+  OLA_ASSERT_TRUE(buffer.SetRangeToValue(1, 255, 2));
+  OLA_ASSERT_EQ((uint8_t) 0, buffer.Get(0));
+  OLA_ASSERT_EQ((uint8_t) 255, buffer.Get(2));
+  OLA_ASSERT_EQ((uint8_t) 0, buffer.Get(3));
+
+  buffer.Set(TEST_DATA, 2);
+  OLA_ASSERT_FALSE(buffer.SetRange(3, TEST_DATA, 1));
+  OLA_ASSERT_TRUE(buffer.SetRange(2, TEST_DATA, 1));
+  OLA_ASSERT_EQ(3u, buffer.Size());
+  buffer.SetChannel(5, 10);
+  OLA_ASSERT_EQ(3u, buffer.Size());
+  buffer.SetChannel(3, 10);
+  OLA_ASSERT_EQ(4u, buffer.Size());
+  OLA_ASSERT_EQ((uint8_t) 10, buffer.Get(3));
+}
+
+
+/*
+ * Check converting to and from DmxBuffer.
+ */
+void FixedDmxBufferTest::testDmxBuffer() {
+  DmxBuffer dmx(TEST_DATA, sizeof(TEST_DATA));
+  FixedDmxBuffer<> buffer(dmx);
+  OLA_ASSERT_TRUE(buffer == dmx);
+  OLA_ASSERT_TRUE(dmx == buffer);
+
+  buffer.SetChannel(0, 100);
+  OLA_ASSERT_TRUE(buffer != dmx);
+  OLA_ASSERT_TRUE(dmx != buffer);
+  OLA_ASSERT_TRUE(buffer.CopyTo(&dmx));
+  OLA_ASSERT_TRUE(buffer == dmx);
+  OLA_ASSERT_EQ((uint8_t) 100, dmx.Get(0));
+
+  // empty buffers
+  DmxBuffer empty;
+  buffer.Set(empty);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_TRUE(buffer == empty);
+  OLA_ASSERT_TRUE(buffer.CopyTo(&dmx));
+  OLA_ASSERT_EQ(0u, dmx.Size());
+
+  FixedDmxBuffer<2> small(DmxBuffer(TEST_DATA, sizeof(TEST_DATA)));
+  OLA_ASSERT_EQ(2u, small.Size());
+  OLA_ASSERT_EQ((uint8_t) 2, small.Get(1));
+}
@@ -0,0 +1,200 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.cpp
+ * Paces the output threads that generate the DMX signal themselves.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "ola/dmx/FrameTimer.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+const unsigned int FrameTimer::JITTER_BUCKETS;
+const char FrameTimer::FPS_VAR[] = "dmx-output-fps";
+const char FrameTimer::JITTER_VAR[] = "dmx-output-jitter-us";
+
+namespace {
+
+const int64_t NSEC_IN_USEC = 1000;
+const int64_t NSEC_IN_SECOND = 1000000000;
+
+// The upper limit of each jitter bucket, in microseconds.
+const unsigned int JITTER_LIMITS[] = {50, 100, 250, 500, 1000, 2500, 0};
+}  // namespace
+
+FrameTimer::FrameTimer(unsigned int frame_rate,
+                       ExportMap *export_map,
+                       const string &name)
+    : m_period(frame_rate ? NSEC_IN_SECOND / frame_rate : 0),
+      m_deadline(0),
+      m_rate_start(0),
+      m_frames(0),
+      m_frame_rate(0),
+      m_name(name),
+      m_fps_map(NULL),
+      m_jitter_map(NULL) {
+  memset(m_jitter, 0, sizeof(m_jitter));
+  if (export_map) {
+    m_fps_map = export_map->GetUIntMapVar(FPS_VAR, "port");
+    m_jitter_map = export_map->GetUIntMapVar(JITTER_VAR, "port");
+    (*m_fps_map)[m_name] = 0;
+  }
+}
+
+void FrameTimer::StartFrame() {
+  int64_t now = Now();
+  if (!m_rate_start) {
+    m_rate_start = now;
+  }
+  m_frames++;
+  UpdateStats(now);
+}
+
+void FrameTimer::Delay(unsigned int usec) {
+  SleepUntil(Now() + usec * NSEC_IN_USEC);
+}
+
+void FrameTimer::WaitForNextFrame(unsigned int min_usec) {
+  const int64_t target = NextFrameTime(min_usec);
+  SleepUntil(target);
+  RecordStart(target);
+}
+
+int64_t FrameTimer::NextFrameTime(unsigned int min_usec) {
+  int64_t earliest = Now() + min_usec * NSEC_IN_USEC;
+
+  if (m_deadline) {
+    m_deadline += m_period;
+  } else {
+    m_deadline = earliest;
+  }
+
+  if (m_deadline < earliest) {
+    // Either we're free running or we've fallen behind. Only restart the
+    // schedule if we're more than a frame late, so small overruns are made
+    // up.
+    if (!m_period || earliest - m_deadline > m_period) {
+      m_deadline = earliest;
+    }
+  }
+  return std::max(m_deadline, earliest);
+}
+
+void FrameTimer::RecordStart(int64_t deadline) {
+  int64_t late = (Now() - deadline) / NSEC_IN_USEC;
+  unsigned int bucket = 0;
+  while (bucket < JITTER_BUCKETS - 1 && late >= JITTER_LIMITS[bucket]) {
+    bucket++;
+  }
+  m_jitter[bucket]++;
+}
+
+unsigned int FrameTimer::JitterCount(unsigned int bucket) const {
+  return bucket < JITTER_BUCKETS ? m_jitter[bucket] : 0;
+}
+
+unsigned int FrameTimer::JitterLimit(unsigned int bucket) {
+  return bucket < JITTER_BUCKETS ? JITTER_LIMITS[bucket] : 0;
+}
+
+bool FrameTimer::UseRealtimeScheduling() {
+  int policy;
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  // Keep a real-time policy set by a thread role, it has a chosen priority.
+  if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 &&
+      (policy == SCHED_FIFO || policy == SCHED_RR)) {
+    return true;
+  }
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  return ola::thread::SetSchedParam(pthread_self(), SCHED_FIFO, param);
+}
+
+void FrameTimer::UpdateStats(int64_t now) {
+  int64_t elapsed = now - m_rate_start;
+  if (elapsed < NSEC_IN_SECOND) {
+    return;
+  }
+  m_frame_rate = static_cast<unsigned int>(
+      m_frames * NSEC_IN_SECOND / elapsed);
+  m_rate_start = now;
+  m_frames = 0;
+
+  if (!m_fps_map) {
+    return;
+  }
+  (*m_fps_map)[m_name] = m_frame_rate;
+  for (unsigned int i = 0; i < JITTER_BUCKETS; i++) {
+    std::ostringstream key;
+    key << m_name << "/";
+    if (JITTER_LIMITS[i]) {
+      key << JITTER_LIMITS[i];
+    } else {
+      key << "inf";
+    }
+    (*m_jitter_map)[key.str()] = m_jitter[i];
+  }
+}
+
+int64_t FrameTimer::Now() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+    return ts.tv_sec * NSEC_IN_SECOND + ts.tv_nsec;
+  }
+#endif  // CLOCK_MONOTONIC
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * NSEC_IN_SECOND + tv.tv_usec * NSEC_IN_USEC;
+}
+
+void FrameTimer::SleepUntil(int64_t deadline) {
+#if defined(HAVE_CLOCK_NANOSLEEP) && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(deadline / NSEC_IN_SECOND);
+  ts.tv_nsec = static_cast<long>(deadline % NSEC_IN_SECOND);  // NOLINT
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+#else
+  // Without clock_nanosleep() we can only sleep for a relative time.
+  int64_t remaining = deadline - Now();
+  if (remaining > 0) {
+    usleep(static_cast<useconds_t>(remaining / NSEC_IN_USEC));
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+}  // namespace dmx
+}  // namespace ola
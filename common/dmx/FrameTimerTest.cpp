@@ -0,0 +1,172 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimerTest.cpp
+ * Test fixture for the FrameTimer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <sstream>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameTimer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::Clock;
+using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::UIntMap;
+using ola::dmx::FrameTimer;
+using std::string;
+
+class FrameTimerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameTimerTest);
+  CPPUNIT_TEST(testFrameRate);
+  CPPUNIT_TEST(testFreeRunning);
+  CPPUNIT_TEST(testOverrun);
+  CPPUNIT_TEST(testStats);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFrameRate();
+  void testFreeRunning();
+  void testOverrun();
+  void testStats();
+
+ private:
+  Clock m_clock;
+
+  int64_t ElapsedUs(const TimeStamp &start) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    return (now - start).AsInt();
+  }
+
+  unsigned int JitterTotal(const FrameTimer &timer) {
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < FrameTimer::JITTER_BUCKETS; i++) {
+      total += timer.JitterCount(i);
+    }
+    return total;
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameTimerTest);
+
+/*
+ * Check frames are spaced by the frame period, regardless of the time spent
+ * in each frame.
+ */
+void FrameTimerTest::testFrameRate() {
+  FrameTimer timer(200);  // 5ms
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+
+  for (unsigned int i = 0; i < 11; i++) {
+    timer.StartFrame();
+    timer.Delay(100);
+    usleep(1000);
+    timer.WaitForNextFrame();
+  }
+  // The first wait sets the schedule, so that's 10 periods.
+  int64_t elapsed = ElapsedUs(start);
+  OLA_ASSERT_TRUE(elapsed >= 50000);
+  OLA_ASSERT_TRUE(elapsed < 500000);
+  OLA_ASSERT_EQ(11u, JitterTotal(timer));
+}
+
+/*
+ * Without a frame rate, only the minimum time is waited.
+ */
+void FrameTimerTest::testFreeRunning() {
+  FrameTimer timer;
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+
+  for (unsigned int i = 0; i < 10; i++) {
+    timer.StartFrame();
+    timer.WaitForNextFrame(1000);
+  }
+  int64_t elapsed = ElapsedUs(start);
+  OLA_ASSERT_TRUE(elapsed >= 10000);
+  OLA_ASSERT_TRUE(elapsed < 500000);
+}
+
+/*
+ * If a frame takes much longer than the period, the schedule restarts rather
+ * than sending a burst of frames.
+ */
+void FrameTimerTest::testOverrun() {
+  FrameTimer timer(1000);  // 1ms
+  timer.StartFrame();
+  timer.WaitForNextFrame();
+
+  timer.StartFrame();
+  usleep(20000);
+  timer.WaitForNextFrame();
+
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < 5; i++) {
+    timer.StartFrame();
+    timer.WaitForNextFrame();
+  }
+  // Were we trying to catch up, these would all return at once.
+  OLA_ASSERT_TRUE(ElapsedUs(start) >= 4000);
+}
+
+/*
+ * Check the stats are exported.
+ */
+void FrameTimerTest::testStats() {
+  ExportMap export_map;
+  const string name = "port";
+  FrameTimer timer(100, &export_map, name);
+
+  UIntMap *fps = export_map.GetUIntMapVar(FrameTimer::FPS_VAR);
+  OLA_ASSERT_EQ(0u, (*fps)[name]);
+
+  // Run for just over a second.
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+  while (ElapsedUs(start) < 1100000) {
+    timer.StartFrame();
+    timer.WaitForNextFrame();
+  }
+  timer.StartFrame();
+
+  OLA_ASSERT_TRUE(timer.FrameRate() > 50);
+  OLA_ASSERT_TRUE(timer.FrameRate() <= 101);
+  OLA_ASSERT_EQ(timer.FrameRate(), (*fps)[name]);
+
+  UIntMap *jitter = export_map.GetUIntMapVar(FrameTimer::JITTER_VAR);
+  unsigned int total = 0;
+  for (unsigned int i = 0; i < FrameTimer::JITTER_BUCKETS; i++) {
+    std::ostringstream key;
+    key << name << "/";
+    if (FrameTimer::JitterLimit(i)) {
+      key << FrameTimer::JitterLimit(i);
+    } else {
+      key << "inf";
+    }
+    total += (*jitter)[key.str()];
+  }
+  OLA_ASSERT_TRUE(total > 50);
+}
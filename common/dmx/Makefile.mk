@@ -1,11 +1,93 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/DmxBufferPool.cpp \
+    common/dmx/DmxBufferPool.h \
+    common/dmx/DmxOutputMultiplexer.cpp \
+    common/dmx/DmxSharedMemory.cpp \
+    common/dmx/FrameTimer.cpp \
+    common/dmx/MergeKernels.cpp \
+    common/dmx/MergeKernels.h \
+    common/dmx/OutputCurve.cpp \
+    common/dmx/PixelBuffer.cpp \
+    common/dmx/RunKernels.cpp \
+    common/dmx/RunKernels.h \
+    common/dmx/RunLengthEncoder.cpp \
+    common/dmx/SharedDmxFrame.cpp \
+    common/dmx/UniverseSharedMemory.cpp
+
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/dmx/merge_benchmark \
+                   common/dmx/rle_benchmark
+
+common_dmx_merge_benchmark_SOURCES = common/dmx/MergeBenchmark.cpp
+common_dmx_merge_benchmark_LDADD = common/libolacommon.la
+
+common_dmx_rle_benchmark_SOURCES = common/dmx/RunLengthBenchmark.cpp
+common_dmx_rle_benchmark_LDADD = common/libolacommon.la
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += common/dmx/DmxBufferPoolTester \
+                 common/dmx/DmxOutputMultiplexerTester \
+                 common/dmx/DmxSharedMemoryTester \
+                 common/dmx/FixedDmxBufferTester \
+                 common/dmx/FrameTimerTester \
+                 common/dmx/MergeKernelsTester \
+                 common/dmx/OutputCurveTester \
+                 common/dmx/PixelBufferTester \
+                 common/dmx/RunKernelsTester \
+                 common/dmx/RunLengthEncoderTester \
+                 common/dmx/SharedDmxFrameTester \
+                 common/dmx/UniverseSharedMemoryTester
+
+common_dmx_DmxBufferPoolTester_SOURCES = common/dmx/DmxBufferPoolTest.cpp
+common_dmx_DmxBufferPoolTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_DmxBufferPoolTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_DmxOutputMultiplexerTester_SOURCES = \
+    common/dmx/DmxOutputMultiplexerTest.cpp
+common_dmx_DmxOutputMultiplexerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_DmxOutputMultiplexerTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_DmxSharedMemoryTester_SOURCES = common/dmx/DmxSharedMemoryTest.cpp
+common_dmx_DmxSharedMemoryTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_DmxSharedMemoryTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_FixedDmxBufferTester_SOURCES = common/dmx/FixedDmxBufferTest.cpp
+common_dmx_FixedDmxBufferTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_FixedDmxBufferTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_FrameTimerTester_SOURCES = common/dmx/FrameTimerTest.cpp
+common_dmx_FrameTimerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_FrameTimerTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_MergeKernelsTester_SOURCES = common/dmx/MergeKernelsTest.cpp
+common_dmx_MergeKernelsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_MergeKernelsTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_OutputCurveTester_SOURCES = common/dmx/OutputCurveTest.cpp
+common_dmx_OutputCurveTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_OutputCurveTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_PixelBufferTester_SOURCES = common/dmx/PixelBufferTest.cpp
+common_dmx_PixelBufferTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_PixelBufferTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_RunKernelsTester_SOURCES = common/dmx/RunKernelsTest.cpp
+common_dmx_RunKernelsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_RunKernelsTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_dmx_RunLengthEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SharedDmxFrameTester_SOURCES = common/dmx/SharedDmxFrameTest.cpp
+common_dmx_SharedDmxFrameTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SharedDmxFrameTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_UniverseSharedMemoryTester_SOURCES = \
+    common/dmx/UniverseSharedMemoryTest.cpp
+common_dmx_UniverseSharedMemoryTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_UniverseSharedMemoryTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -0,0 +1,169 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MergeBenchmark.cpp
+ * Compare the HTP merge kernels against each other.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "common/dmx/MergeKernels.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/math/Random.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::MergeKernel;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 200000, "The number of merges to run");
+DEFINE_s_uint8(sources, s, 4, "The number of sources to merge [2 - 32]");
+
+namespace {
+
+const unsigned int MAX_SOURCES = 32;
+
+/*
+ * Print the throughput for a test.
+ */
+void Report(const char *test, const char *kernel, const TimeInterval &elapsed,
+            unsigned int merges) {
+  double seconds = elapsed.AsInt() / 1000000.0;
+  cout << std::left << std::setw(16) << test << std::setw(10) << kernel
+       << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+       << (seconds > 0 ? merges / seconds / 1000.0 : 0) << " k merges/s"
+       << endl;
+}
+
+/*
+ * Merge each source into the destination in turn, like Reset() & HTPMerge().
+ */
+void RunPairwise(const MergeKernel &kernel, const uint8_t *const *sources,
+                 unsigned int source_count, unsigned int iterations) {
+  Clock clock;
+  TimeStamp start, end;
+  uint8_t dst[ola::DMX_UNIVERSE_SIZE];
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      dst[j] = sources[0][j];
+    }
+    for (unsigned int s = 1; s < source_count; s++) {
+      kernel.max_merge(dst, sources[s], ola::DMX_UNIVERSE_SIZE);
+    }
+  }
+  clock.CurrentTime(&end);
+  Report("pairwise", kernel.name, end - start, iterations);
+}
+
+/*
+ * Merge all the sources in a single pass.
+ */
+void RunMany(const MergeKernel &kernel, const uint8_t *const *sources,
+             unsigned int source_count, unsigned int iterations) {
+  Clock clock;
+  TimeStamp start, end;
+  uint8_t dst[ola::DMX_UNIVERSE_SIZE];
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    kernel.max_merge_many(dst, sources, source_count,
+                          ola::DMX_UNIVERSE_SIZE);
+  }
+  clock.CurrentTime(&end);
+  Report("many", kernel.name, end - start, iterations);
+}
+
+/*
+ * Time the DmxBuffer API, which uses the best kernel.
+ */
+void RunBuffers(const vector<DmxBuffer> &buffers, unsigned int iterations) {
+  Clock clock;
+  TimeStamp start, end;
+  DmxBuffer output;
+
+  const DmxBuffer *sources[MAX_SOURCES];
+  for (unsigned int s = 0; s < buffers.size(); s++) {
+    sources[s] = &buffers[s];
+  }
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    output.Reset();
+    for (unsigned int s = 0; s < buffers.size(); s++) {
+      output.HTPMerge(buffers[s]);
+    }
+  }
+  clock.CurrentTime(&end);
+  Report("HTPMerge", ola::dmx::BestMergeKernel().name, end - start,
+         iterations);
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    output.HTPMergeMany(sources, buffers.size());
+  }
+  clock.CurrentTime(&end);
+  Report("HTPMergeMany", ola::dmx::BestMergeKernel().name, end - start,
+         iterations);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Benchmark the HTP merge implementations.");
+
+  unsigned int source_count = FLAGS_sources;
+  if (source_count < 2 || source_count > MAX_SOURCES) {
+    cout << "--sources must be between 2 and " << MAX_SOURCES << endl;
+    return 1;
+  }
+
+  ola::math::InitRandom();
+  vector<DmxBuffer> buffers(source_count);
+  const uint8_t *sources[MAX_SOURCES];
+  for (unsigned int s = 0; s < source_count; s++) {
+    buffers[s].Blackout();
+    for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+      buffers[s].SetChannel(i, ola::math::Random(0, 255));
+    }
+    sources[s] = buffers[s].GetRaw();
+  }
+
+  cout << "Merging " << source_count << " sources, " << FLAGS_iterations
+       << " iterations" << endl;
+
+  vector<const MergeKernel*> kernels;
+  ola::dmx::SupportedMergeKernels(&kernels);
+  vector<const MergeKernel*>::const_iterator iter = kernels.begin();
+  for (; iter != kernels.end(); ++iter) {
+    RunPairwise(**iter, sources, source_count, FLAGS_iterations);
+    RunMany(**iter, sources, source_count, FLAGS_iterations);
+  }
+  RunBuffers(buffers, FLAGS_iterations);
+  return 0;
+}
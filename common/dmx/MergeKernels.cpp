@@ -0,0 +1,436 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MergeKernels.cpp
+ * Vectorized max (HTP) merge kernels used by DmxBuffer.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The x86 kernels are compiled with function level target attributes so we
+ * don't need any special compiler flags, the CPU is probed at runtime before
+ * any of them are used. NEON is part of the base ARMv8 ISA so that kernel is
+ * selected at compile time.
+ */
+
+#include "common/dmx/MergeKernels.h"
+
+#include <algorithm>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || \
+     (defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OLA_MERGE_X86 1
+#include <immintrin.h>
+#endif  // x86 & compiler supports target attributes
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_MERGE_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace dmx {
+
+using std::max;
+using std::vector;
+
+namespace {
+
+/*
+ * Add [start, end) to the changed slots. The kernels walk the slots in order,
+ * so start is only set once.
+ */
+inline void ExtendRange(SlotRange *range, unsigned int start,
+                        unsigned int end) {
+  if (range->start == range->end) {
+    range->start = start;
+  }
+  range->end = end;
+}
+
+/*
+ * Add the slots from a block starting at offset to the changed slots. Bit n
+ * of changed_mask is set if slot offset + n changed.
+ */
+inline void ExtendRangeFromMask(SlotRange *range, unsigned int offset,
+                                unsigned int changed_mask) {
+  if (changed_mask) {
+    ExtendRange(range, offset + __builtin_ctz(changed_mask),
+                offset + 32 - __builtin_clz(changed_mask));
+  }
+}
+
+/*
+ * Finish off the slots in [offset, length) one at a time.
+ */
+inline void ScalarMergeFrom(uint8_t *dst, const uint8_t *src,
+                            unsigned int offset, unsigned int length,
+                            SlotRange *changed) {
+  for (unsigned int i = offset; i < length; i++) {
+    if (src[i] > dst[i]) {
+      dst[i] = src[i];
+      ExtendRange(changed, i, i + 1);
+    }
+  }
+}
+
+inline void ScalarMergeManyFrom(uint8_t *dst, const uint8_t *const *sources,
+                                unsigned int count, unsigned int offset,
+                                unsigned int length, SlotRange *changed) {
+  for (unsigned int i = offset; i < length; i++) {
+    uint8_t value = sources[0][i];
+    for (unsigned int s = 1; s < count; s++) {
+      value = max(value, sources[s][i]);
+    }
+    if (value != dst[i]) {
+      dst[i] = value;
+      ExtendRange(changed, i, i + 1);
+    }
+  }
+}
+
+SlotRange ScalarMaxMerge(uint8_t *dst, const uint8_t *src,
+                         unsigned int length) {
+  SlotRange changed = {0, 0};
+  ScalarMergeFrom(dst, src, 0, length, &changed);
+  return changed;
+}
+
+SlotRange ScalarMaxMergeMany(uint8_t *dst, const uint8_t *const *sources,
+                             unsigned int count, unsigned int length) {
+  SlotRange changed = {0, 0};
+  ScalarMergeManyFrom(dst, sources, count, 0, length, &changed);
+  return changed;
+}
+
+void ScalarPriorityMerge(uint8_t *dst, uint8_t *dst_priority,
+                         const uint8_t *src, const uint8_t *src_priority,
+                         unsigned int length) {
+  for (unsigned int i = 0; i < length; i++) {
+    if (src_priority[i] > dst_priority[i]) {
+      dst[i] = src[i];
+      dst_priority[i] = src_priority[i];
+    } else if (src_priority[i] && src_priority[i] == dst_priority[i]) {
+      dst[i] = max(dst[i], src[i]);
+    }
+  }
+}
+
+#ifdef OLA_MERGE_X86
+/*
+ * The vector max merges compare the new value of each block with the old one,
+ * and turn the result into a bit mask of the slots that changed.
+ */
+__attribute__((target("sse2")))
+SlotRange SSE2MaxMerge(uint8_t *dst, const uint8_t *src,
+                       unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i *d = reinterpret_cast<__m128i*>(dst + i);
+    __m128i old_value = _mm_loadu_si128(d);
+    __m128i value = _mm_max_epu8(
+        old_value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm_storeu_si128(d, value);
+    ExtendRangeFromMask(
+        &changed, i,
+        _mm_movemask_epi8(_mm_cmpeq_epi8(value, old_value)) ^ 0xffff);
+  }
+  ScalarMergeFrom(dst, src, i, length, &changed);
+  return changed;
+}
+
+__attribute__((target("sse2")))
+SlotRange SSE2MaxMergeMany(uint8_t *dst, const uint8_t *const *sources,
+                           unsigned int count, unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i value = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(sources[0] + i));
+    for (unsigned int s = 1; s < count; s++) {
+      value = _mm_max_epu8(
+          value,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[s] + i)));
+    }
+    __m128i *d = reinterpret_cast<__m128i*>(dst + i);
+    // dst may be a source, so read it before the store.
+    __m128i old_value = _mm_loadu_si128(d);
+    _mm_storeu_si128(d, value);
+    ExtendRangeFromMask(
+        &changed, i,
+        _mm_movemask_epi8(_mm_cmpeq_epi8(value, old_value)) ^ 0xffff);
+  }
+  ScalarMergeManyFrom(dst, sources, count, i, length, &changed);
+  return changed;
+}
+
+/*
+ * The vector versions of the priority merge work out two masks for each byte,
+ * one for when the source priority is higher and one for when it's equal
+ * (and non-0), and then blend the values.
+ */
+__attribute__((target("sse2")))
+void SSE2PriorityMerge(uint8_t *dst, uint8_t *dst_priority,
+                       const uint8_t *src, const uint8_t *src_priority,
+                       unsigned int length) {
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i *d = reinterpret_cast<__m128i*>(dst + i);
+    __m128i *dp = reinterpret_cast<__m128i*>(dst_priority + i);
+    __m128i value = _mm_loadu_si128(d);
+    __m128i priority = _mm_loadu_si128(dp);
+    __m128i src_value = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + i));
+    __m128i src_prio = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src_priority + i));
+
+    __m128i max_prio = _mm_max_epu8(src_prio, priority);
+    __m128i equal = _mm_cmpeq_epi8(src_prio, priority);
+    __m128i higher = _mm_andnot_si128(
+        equal, _mm_cmpeq_epi8(max_prio, src_prio));
+    equal = _mm_andnot_si128(_mm_cmpeq_epi8(src_prio, zero), equal);
+
+    __m128i merged = _mm_max_epu8(value, src_value);
+    value = _mm_or_si128(_mm_and_si128(equal, merged),
+                         _mm_andnot_si128(equal, value));
+    value = _mm_or_si128(_mm_and_si128(higher, src_value),
+                         _mm_andnot_si128(higher, value));
+    _mm_storeu_si128(d, value);
+    _mm_storeu_si128(dp, max_prio);
+  }
+  ScalarPriorityMerge(dst + i, dst_priority + i, src + i, src_priority + i,
+                      length - i);
+}
+
+__attribute__((target("avx2")))
+SlotRange AVX2MaxMerge(uint8_t *dst, const uint8_t *src,
+                       unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i *d = reinterpret_cast<__m256i*>(dst + i);
+    __m256i old_value = _mm256_loadu_si256(d);
+    __m256i value = _mm256_max_epu8(
+        old_value,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    _mm256_storeu_si256(d, value);
+    ExtendRangeFromMask(
+        &changed, i,
+        ~static_cast<unsigned int>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(value, old_value))));
+  }
+  ScalarMergeFrom(dst, src, i, length, &changed);
+  return changed;
+}
+
+__attribute__((target("avx2")))
+SlotRange AVX2MaxMergeMany(uint8_t *dst, const uint8_t *const *sources,
+                           unsigned int count, unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i value = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(sources[0] + i));
+    for (unsigned int s = 1; s < count; s++) {
+      value = _mm256_max_epu8(
+          value,
+          _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(sources[s] + i)));
+    }
+    __m256i *d = reinterpret_cast<__m256i*>(dst + i);
+    __m256i old_value = _mm256_loadu_si256(d);
+    _mm256_storeu_si256(d, value);
+    ExtendRangeFromMask(
+        &changed, i,
+        ~static_cast<unsigned int>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(value, old_value))));
+  }
+  ScalarMergeManyFrom(dst, sources, count, i, length, &changed);
+  return changed;
+}
+
+__attribute__((target("avx2")))
+void AVX2PriorityMerge(uint8_t *dst, uint8_t *dst_priority,
+                       const uint8_t *src, const uint8_t *src_priority,
+                       unsigned int length) {
+  const __m256i zero = _mm256_setzero_si256();
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i *d = reinterpret_cast<__m256i*>(dst + i);
+    __m256i *dp = reinterpret_cast<__m256i*>(dst_priority + i);
+    __m256i value = _mm256_loadu_si256(d);
+    __m256i priority = _mm256_loadu_si256(dp);
+    __m256i src_value = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src + i));
+    __m256i src_prio = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src_priority + i));
+
+    __m256i max_prio = _mm256_max_epu8(src_prio, priority);
+    __m256i equal = _mm256_cmpeq_epi8(src_prio, priority);
+    __m256i higher = _mm256_andnot_si256(
+        equal, _mm256_cmpeq_epi8(max_prio, src_prio));
+    equal = _mm256_andnot_si256(_mm256_cmpeq_epi8(src_prio, zero), equal);
+
+    value = _mm256_blendv_epi8(value, _mm256_max_epu8(value, src_value),
+                               equal);
+    value = _mm256_blendv_epi8(value, src_value, higher);
+    _mm256_storeu_si256(d, value);
+    _mm256_storeu_si256(dp, max_prio);
+  }
+  ScalarPriorityMerge(dst + i, dst_priority + i, src + i, src_priority + i,
+                      length - i);
+}
+#endif  // OLA_MERGE_X86
+
+#ifdef OLA_MERGE_NEON
+/*
+ * NEON has no movemask, so check if anything in the block changed and only
+ * then find the slots.
+ */
+inline void NEONExtendRange(SlotRange *range, unsigned int offset,
+                            uint8x16_t equal) {
+  uint64x2_t lanes = vreinterpretq_u64_u8(equal);
+  if ((vgetq_lane_u64(lanes, 0) & vgetq_lane_u64(lanes, 1)) ==
+      0xffffffffffffffffULL) {
+    return;
+  }
+  uint8_t flags[sizeof(uint8x16_t)];
+  vst1q_u8(flags, equal);
+  unsigned int first = 0;
+  while (flags[first]) {
+    first++;
+  }
+  unsigned int last = sizeof(flags);
+  while (flags[last - 1]) {
+    last--;
+  }
+  ExtendRange(range, offset + first, offset + last);
+}
+
+SlotRange NEONMaxMerge(uint8_t *dst, const uint8_t *src,
+                       unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    uint8x16_t old_value = vld1q_u8(dst + i);
+    uint8x16_t value = vmaxq_u8(old_value, vld1q_u8(src + i));
+    vst1q_u8(dst + i, value);
+    NEONExtendRange(&changed, i, vceqq_u8(value, old_value));
+  }
+  ScalarMergeFrom(dst, src, i, length, &changed);
+  return changed;
+}
+
+SlotRange NEONMaxMergeMany(uint8_t *dst, const uint8_t *const *sources,
+                           unsigned int count, unsigned int length) {
+  SlotRange changed = {0, 0};
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    uint8x16_t value = vld1q_u8(sources[0] + i);
+    for (unsigned int s = 1; s < count; s++) {
+      value = vmaxq_u8(value, vld1q_u8(sources[s] + i));
+    }
+    uint8x16_t old_value = vld1q_u8(dst + i);
+    vst1q_u8(dst + i, value);
+    NEONExtendRange(&changed, i, vceqq_u8(value, old_value));
+  }
+  ScalarMergeManyFrom(dst, sources, count, i, length, &changed);
+  return changed;
+}
+
+void NEONPriorityMerge(uint8_t *dst, uint8_t *dst_priority,
+                       const uint8_t *src, const uint8_t *src_priority,
+                       unsigned int length) {
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    uint8x16_t value = vld1q_u8(dst + i);
+    uint8x16_t priority = vld1q_u8(dst_priority + i);
+    uint8x16_t src_value = vld1q_u8(src + i);
+    uint8x16_t src_prio = vld1q_u8(src_priority + i);
+
+    uint8x16_t higher = vcgtq_u8(src_prio, priority);
+    uint8x16_t equal = vandq_u8(vceqq_u8(src_prio, priority),
+                                vtstq_u8(src_prio, src_prio));
+    value = vbslq_u8(equal, vmaxq_u8(value, src_value), value);
+    value = vbslq_u8(higher, src_value, value);
+    vst1q_u8(dst + i, value);
+    vst1q_u8(dst_priority + i, vmaxq_u8(src_prio, priority));
+  }
+  ScalarPriorityMerge(dst + i, dst_priority + i, src + i, src_priority + i,
+                      length - i);
+}
+#endif  // OLA_MERGE_NEON
+
+const MergeKernel kScalarKernel = {
+  "scalar", ScalarMaxMerge, ScalarMaxMergeMany, ScalarPriorityMerge
+};
+
+#ifdef OLA_MERGE_X86
+const MergeKernel kSSE2Kernel = {
+  "sse2", SSE2MaxMerge, SSE2MaxMergeMany, SSE2PriorityMerge
+};
+const MergeKernel kAVX2Kernel = {
+  "avx2", AVX2MaxMerge, AVX2MaxMergeMany, AVX2PriorityMerge
+};
+#endif  // OLA_MERGE_X86
+
+#ifdef OLA_MERGE_NEON
+const MergeKernel kNEONKernel = {
+  "neon", NEONMaxMerge, NEONMaxMergeMany, NEONPriorityMerge
+};
+#endif  // OLA_MERGE_NEON
+
+const MergeKernel *DetectBestKernel() {
+  vector<const MergeKernel*> kernels;
+  SupportedMergeKernels(&kernels);
+  return kernels.back();
+}
+}  // namespace
+
+
+const MergeKernel &ScalarMergeKernel() {
+  return kScalarKernel;
+}
+
+
+const MergeKernel &BestMergeKernel() {
+  static const MergeKernel *best_kernel = DetectBestKernel();
+  return *best_kernel;
+}
+
+
+void SupportedMergeKernels(vector<const MergeKernel*> *kernels) {
+  kernels->clear();
+  kernels->push_back(&kScalarKernel);
+
+#ifdef OLA_MERGE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    kernels->push_back(&kSSE2Kernel);
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    kernels->push_back(&kAVX2Kernel);
+  }
+#endif  // OLA_MERGE_X86
+
+#ifdef OLA_MERGE_NEON
+  kernels->push_back(&kNEONKernel);
+#endif  // OLA_MERGE_NEON
+}
+}  // namespace dmx
+}  // namespace ola
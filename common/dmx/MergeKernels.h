@@ -0,0 +1,129 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MergeKernels.h
+ * Vectorized max (HTP) merge kernels used by DmxBuffer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_MERGEKERNELS_H_
+#define COMMON_DMX_MERGEKERNELS_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The slots [start, end) changed by a merge, empty if start == end.
+ */
+struct SlotRange {
+  unsigned int start;
+  unsigned int end;
+};
+
+/**
+ * @brief A set of functions that implement an HTP merge.
+ *
+ * Each kernel provides a two-way and an N-way version. The N-way version reads
+ * every source once per block, which keeps the working set in registers
+ * rather than making a separate pass over the destination for each source.
+ */
+struct MergeKernel {
+  /**
+   * @brief The name of the kernel, e.g. "sse2".
+   */
+  const char *name;
+
+  /**
+   * @brief dst[i] = max(dst[i], src[i]) for i in [0, length).
+   * @returns the slots where dst changed.
+   */
+  SlotRange (*max_merge)(uint8_t *dst, const uint8_t *src,
+                         unsigned int length);
+
+  /**
+   * @brief dst[i] = max(sources[0][i], ..., sources[count - 1][i]).
+   * @pre count >= 1 and each source holds at least length bytes.
+   * @returns the slots where the new value of dst differs from the old one.
+   *
+   * dst may be one of the sources.
+   */
+  SlotRange (*max_merge_many)(uint8_t *dst, const uint8_t *const *sources,
+                              unsigned int count, unsigned int length);
+
+  /**
+   * @brief Merge a source with per-slot priorities into dst.
+   *
+   * For each slot in [0, length): if src_priority[i] > dst_priority[i] the
+   * source takes the slot, if they're equal the values are HTP merged. A
+   * priority of 0 means the source doesn't control the slot. Start with dst
+   * and dst_priority zeroed and call this once per source.
+   */
+  void (*priority_merge)(uint8_t *dst, uint8_t *dst_priority,
+                         const uint8_t *src, const uint8_t *src_priority,
+                         unsigned int length);
+};
+
+/**
+ * @brief Return the portable, byte-at-a-time kernel.
+ */
+const MergeKernel &ScalarMergeKernel();
+
+/**
+ * @brief Return the fastest kernel supported by the CPU we're running on.
+ *
+ * The CPU is probed on the first call, the result is cached.
+ */
+const MergeKernel &BestMergeKernel();
+
+/**
+ * @brief Get all the kernels that can run on this CPU.
+ * @param[out] kernels the list of kernels, the scalar kernel is always first.
+ *
+ * This is used by the tests and the benchmark to compare implementations.
+ */
+void SupportedMergeKernels(std::vector<const MergeKernel*> *kernels);
+
+/**
+ * @brief Max merge src into dst using the best available kernel.
+ */
+inline SlotRange MaxMerge(uint8_t *dst, const uint8_t *src,
+                          unsigned int length) {
+  return BestMergeKernel().max_merge(dst, src, length);
+}
+
+/**
+ * @brief Max merge count sources into dst using the best available kernel.
+ */
+inline SlotRange MaxMergeMany(uint8_t *dst, const uint8_t *const *sources,
+                              unsigned int count, unsigned int length) {
+  return BestMergeKernel().max_merge_many(dst, sources, count, length);
+}
+
+/**
+ * @brief Per-slot priority merge src into dst using the best available
+ *   kernel.
+ */
+inline void PriorityMerge(uint8_t *dst, uint8_t *dst_priority,
+                          const uint8_t *src, const uint8_t *src_priority,
+                          unsigned int length) {
+  BestMergeKernel().priority_merge(dst, dst_priority, src, src_priority,
+                                   length);
+}
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_MERGEKERNELS_H_
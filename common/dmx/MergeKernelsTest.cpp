@@ -0,0 +1,295 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MergeKernelsTest.cpp
+ * Test fixture for the HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <vector>
+
+#include "common/dmx/MergeKernels.h"
+#include "ola/Constants.h"
+#include "ola/math/Random.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::BestMergeKernel;
+using ola::dmx::MergeKernel;
+using ola::dmx::ScalarMergeKernel;
+using ola::dmx::SlotRange;
+using ola::dmx::SupportedMergeKernels;
+using std::vector;
+
+namespace {
+/*
+ * Check a kernel reported the first and last slots that differ.
+ */
+void CheckChangedRange(const uint8_t *old_data, const uint8_t *new_data,
+                       unsigned int length, const SlotRange &changed) {
+  unsigned int start = 0;
+  while (start < length && old_data[start] == new_data[start]) {
+    start++;
+  }
+  unsigned int end = length;
+  while (end > start && old_data[end - 1] == new_data[end - 1]) {
+    end--;
+  }
+  if (start == end) {
+    OLA_ASSERT_EQ(changed.start, changed.end);
+  } else {
+    OLA_ASSERT_EQ(start, changed.start);
+    OLA_ASSERT_EQ(end, changed.end);
+  }
+}
+}  // namespace
+
+class MergeKernelsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MergeKernelsTest);
+  CPPUNIT_TEST(testKernelList);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMergeMany);
+  CPPUNIT_TEST(testMergeManyInPlace);
+  CPPUNIT_TEST(testChangedSlots);
+  CPPUNIT_TEST(testPriorityMerge);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testKernelList();
+    void testMerge();
+    void testMergeMany();
+    void testMergeManyInPlace();
+    void testChangedSlots();
+    void testPriorityMerge();
+
+ private:
+    enum { SOURCE_COUNT = 6 };
+
+    uint8_t m_sources[SOURCE_COUNT][ola::DMX_UNIVERSE_SIZE];
+    vector<const MergeKernel*> m_kernels;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MergeKernelsTest);
+
+
+void MergeKernelsTest::setUp() {
+  ola::math::InitRandom();
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      m_sources[i][j] = ola::math::Random(0, 255);
+    }
+  }
+  SupportedMergeKernels(&m_kernels);
+}
+
+
+/*
+ * Check the scalar kernel is always available and the best kernel is one of
+ * the supported ones.
+ */
+void MergeKernelsTest::testKernelList() {
+  OLA_ASSERT_FALSE(m_kernels.empty());
+  OLA_ASSERT_EQ(&ScalarMergeKernel(), m_kernels[0]);
+  OLA_ASSERT_EQ(&BestMergeKernel(), m_kernels.back());
+}
+
+
+/*
+ * Check the two-way merge matches the scalar version for all lengths, so we
+ * cover the vector body and the scalar tail.
+ */
+void MergeKernelsTest::testMerge() {
+  vector<const MergeKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int length = 0; length <= ola::DMX_UNIVERSE_SIZE;
+         length++) {
+      uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+      uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+      memcpy(expected, m_sources[0], length);
+      memcpy(actual, m_sources[0], length);
+      for (unsigned int i = 0; i < length; i++) {
+        if (m_sources[1][i] > expected[i]) {
+          expected[i] = m_sources[1][i];
+        }
+      }
+
+      SlotRange changed = (*iter)->max_merge(actual, m_sources[1], length);
+      OLA_ASSERT_DATA_EQUALS(expected, length, actual, length);
+      CheckChangedRange(m_sources[0], expected, length, changed);
+    }
+  }
+}
+
+
+/*
+ * Check the N-way merge for each number of sources.
+ */
+void MergeKernelsTest::testMergeMany() {
+  const uint8_t *sources[SOURCE_COUNT];
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    sources[i] = m_sources[i];
+  }
+
+  vector<const MergeKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int count = 1; count <= SOURCE_COUNT; count++) {
+      unsigned int lengths[] = {0, 1, 15, 16, 17, 31, 33, 500,
+                                ola::DMX_UNIVERSE_SIZE};
+      for (unsigned int j = 0; j < sizeof(lengths) / sizeof(lengths[0]);
+           j++) {
+        unsigned int length = lengths[j];
+        uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+        uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+        memset(expected, 0, ola::DMX_UNIVERSE_SIZE);
+        memset(actual, 0, ola::DMX_UNIVERSE_SIZE);
+        for (unsigned int s = 0; s < count; s++) {
+          ScalarMergeKernel().max_merge(expected, sources[s], length);
+        }
+
+        SlotRange changed = (*iter)->max_merge_many(actual, sources, count,
+                                                    length);
+        OLA_ASSERT_DATA_EQUALS(expected, ola::DMX_UNIVERSE_SIZE, actual,
+                               ola::DMX_UNIVERSE_SIZE);
+        uint8_t zeros[ola::DMX_UNIVERSE_SIZE];
+        memset(zeros, 0, sizeof(zeros));
+        CheckChangedRange(zeros, expected, length, changed);
+      }
+    }
+  }
+}
+
+
+/*
+ * Check the destination can be one of the sources.
+ */
+void MergeKernelsTest::testMergeManyInPlace() {
+  vector<const MergeKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    uint8_t dst[ola::DMX_UNIVERSE_SIZE];
+    uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+    memcpy(dst, m_sources[0], ola::DMX_UNIVERSE_SIZE);
+    memcpy(expected, m_sources[0], ola::DMX_UNIVERSE_SIZE);
+    ScalarMergeKernel().max_merge(expected, m_sources[1],
+                                  ola::DMX_UNIVERSE_SIZE);
+    ScalarMergeKernel().max_merge(expected, m_sources[2],
+                                  ola::DMX_UNIVERSE_SIZE);
+
+    const uint8_t *sources[] = {m_sources[1], dst, m_sources[2]};
+    SlotRange changed = (*iter)->max_merge_many(dst, sources, 3,
+                                                ola::DMX_UNIVERSE_SIZE);
+    OLA_ASSERT_DATA_EQUALS(expected, ola::DMX_UNIVERSE_SIZE, dst,
+                           ola::DMX_UNIVERSE_SIZE);
+    CheckChangedRange(m_sources[0], expected, ola::DMX_UNIVERSE_SIZE,
+                      changed);
+
+    // Merging the same data again changes nothing.
+    changed = (*iter)->max_merge_many(dst, sources, 3,
+                                      ola::DMX_UNIVERSE_SIZE);
+    OLA_ASSERT_EQ(changed.start, changed.end);
+  }
+}
+
+
+/*
+ * Check the kernels report the changed slots when only a few change, in both
+ * the vector body and the scalar tail.
+ */
+void MergeKernelsTest::testChangedSlots() {
+  const unsigned int slots[] = {0, 5, 37, 300, 500, 511};
+  const unsigned int slot_count = sizeof(slots) / sizeof(slots[0]);
+
+  vector<const MergeKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int first = 0; first < slot_count; first++) {
+      for (unsigned int last = first; last < slot_count; last++) {
+        uint8_t dst[ola::DMX_UNIVERSE_SIZE];
+        uint8_t src[ola::DMX_UNIVERSE_SIZE];
+        memset(dst, 10, sizeof(dst));
+        memset(src, 10, sizeof(src));
+        src[slots[first]] = 20;
+        src[slots[last]] = 11;
+
+        SlotRange changed = (*iter)->max_merge(dst, src, sizeof(dst));
+        OLA_ASSERT_EQ(slots[first], changed.start);
+        OLA_ASSERT_EQ(slots[last] + 1, changed.end);
+
+        // Nothing changes the second time.
+        changed = (*iter)->max_merge(dst, src, sizeof(dst));
+        OLA_ASSERT_EQ(changed.start, changed.end);
+
+        memset(dst, 10, sizeof(dst));
+        const uint8_t *sources[] = {dst, src};
+        changed = (*iter)->max_merge_many(dst, sources, 2, sizeof(dst));
+        OLA_ASSERT_EQ(slots[first], changed.start);
+        OLA_ASSERT_EQ(slots[last] + 1, changed.end);
+        changed = (*iter)->max_merge_many(dst, sources, 2, sizeof(dst));
+        OLA_ASSERT_EQ(changed.start, changed.end);
+      }
+    }
+  }
+}
+
+
+/*
+ * Check the per-slot priority merge matches the scalar version.
+ */
+void MergeKernelsTest::testPriorityMerge() {
+  // Use a small range of priorities, so we get plenty of ties, and include 0.
+  uint8_t priorities[SOURCE_COUNT][ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      priorities[i][j] = ola::math::Random(0, 3) * 100;
+    }
+  }
+
+  vector<const MergeKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    unsigned int lengths[] = {0, 1, 15, 16, 17, 31, 33, 500,
+                              ola::DMX_UNIVERSE_SIZE};
+    for (unsigned int j = 0; j < sizeof(lengths) / sizeof(lengths[0]); j++) {
+      unsigned int length = lengths[j];
+      uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+      uint8_t expected_priority[ola::DMX_UNIVERSE_SIZE];
+      uint8_t actual[ola::DMX_UNIVERSE_SIZE];
+      uint8_t actual_priority[ola::DMX_UNIVERSE_SIZE];
+      memset(expected, 0, ola::DMX_UNIVERSE_SIZE);
+      memset(expected_priority, 0, ola::DMX_UNIVERSE_SIZE);
+      memset(actual, 0, ola::DMX_UNIVERSE_SIZE);
+      memset(actual_priority, 0, ola::DMX_UNIVERSE_SIZE);
+
+      for (unsigned int s = 0; s < SOURCE_COUNT; s++) {
+        for (unsigned int i = 0; i < length; i++) {
+          if (priorities[s][i] > expected_priority[i]) {
+            expected[i] = m_sources[s][i];
+            expected_priority[i] = priorities[s][i];
+          } else if (priorities[s][i] &&
+                     priorities[s][i] == expected_priority[i] &&
+                     m_sources[s][i] > expected[i]) {
+            expected[i] = m_sources[s][i];
+          }
+        }
+        (*iter)->priority_merge(actual, actual_priority, m_sources[s],
+                                priorities[s], length);
+      }
+
+      OLA_ASSERT_DATA_EQUALS(expected, ola::DMX_UNIVERSE_SIZE, actual,
+                             ola::DMX_UNIVERSE_SIZE);
+      OLA_ASSERT_DATA_EQUALS(expected_priority, ola::DMX_UNIVERSE_SIZE,
+                             actual_priority, ola::DMX_UNIVERSE_SIZE);
+    }
+  }
+}
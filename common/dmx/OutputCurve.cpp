@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OutputCurve.cpp
+ * Gamma and dimming curves for pixel outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/dmx/OutputCurve.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+const uint8_t OutputCurve::MAX_BRIGHTNESS;
+const double OutputCurve::MIN_GAMMA = 0.1;
+const double OutputCurve::MAX_GAMMA = 5.0;
+
+namespace {
+
+uint16_t Scale(double level, double full_scale) {
+  return static_cast<uint16_t>(floor(level * full_scale + 0.5));
+}
+}  // namespace
+
+OutputCurve::OutputCurve() {
+  Configure(Options());
+}
+
+OutputCurve::OutputCurve(const Options &options) {
+  Configure(options);
+}
+
+void OutputCurve::Configure(const Options &options) {
+  m_gamma = (options.gamma < MIN_GAMMA || options.gamma > MAX_GAMMA) ?
+      1.0 : options.gamma;
+  m_brightness = (
+      options.brightness < MAX_BRIGHTNESS ? options.brightness :
+      MAX_BRIGHTNESS) / static_cast<double>(MAX_BRIGHTNESS);
+
+  m_identity = true;
+  for (unsigned int i = 0; i < TABLE_SIZE; i++) {
+    const double level = m_brightness * pow(i / 255.0, m_gamma);
+    m_table[i] = static_cast<uint8_t>(Scale(level, 255));
+    // The largest fine value is 0xff00 so adding the error never overflows.
+    m_fine_table[i] = Scale(level, 0xff00);
+    m_wide_table[i] = Scale(level, 0xffff);
+    m_identity &= (m_fine_table[i] == (i << 8));
+  }
+
+  m_dither = options.dither && !m_identity;
+  m_error.clear();
+}
+
+uint16_t OutputCurve::Evaluate(double level) const {
+  if (level <= 0) {
+    return 0;
+  }
+  return Scale(m_brightness * pow(level < 1 ? level : 1, m_gamma), 0xffff);
+}
+
+void OutputCurve::Apply(const uint8_t *input, uint8_t *output,
+                        unsigned int length) {
+  if (!m_dither) {
+    for (unsigned int i = 0; i < length; i++) {
+      output[i] = m_table[input[i]];
+    }
+    return;
+  }
+
+  if (m_error.size() < length) {
+    m_error.resize(length, 0);
+  }
+  for (unsigned int i = 0; i < length; i++) {
+    const unsigned int value = m_fine_table[input[i]] + m_error[i];
+    output[i] = static_cast<uint8_t>(value >> 8);
+    m_error[i] = static_cast<uint8_t>(value);
+  }
+}
+
+void OutputCurve::Apply(const DmxBuffer &input, DmxBuffer *output) {
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  const unsigned int length = input.Size();
+  Apply(input.GetRaw(), data, length);
+  output->Set(data, length);
+}
+
+void OutputCurve::ApplyWide(const uint8_t *input, uint16_t *output,
+                            unsigned int length) const {
+  for (unsigned int i = 0; i < length; i++) {
+    output[i] = m_wide_table[input[i]];
+  }
+}
+
+bool OutputCurve::ParseGamma(const string &value, double *gamma) {
+  if (value.empty()) {
+    return false;
+  }
+  char *end = NULL;
+  double result = strtod(value.c_str(), &end);
+  if (*end != '\0' || result < MIN_GAMMA || result > MAX_GAMMA) {
+    return false;
+  }
+  *gamma = result;
+  return true;
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,175 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OutputCurveTest.cpp
+ * Test fixture for the OutputCurve class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/OutputCurve.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::dmx::OutputCurve;
+
+class OutputCurveTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OutputCurveTest);
+  CPPUNIT_TEST(testLinear);
+  CPPUNIT_TEST(testGamma);
+  CPPUNIT_TEST(testBrightness);
+  CPPUNIT_TEST(testDither);
+  CPPUNIT_TEST(testParseGamma);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testLinear();
+  void testGamma();
+  void testBrightness();
+  void testDither();
+  void testParseGamma();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OutputCurveTest);
+
+/*
+ * The default curve doesn't change the data.
+ */
+void OutputCurveTest::testLinear() {
+  OutputCurve curve;
+  OLA_ASSERT_TRUE(curve.IsIdentity());
+
+  uint8_t data[256];
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = i;
+  }
+  uint8_t output[256];
+  curve.Apply(data, output, sizeof(data));
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), output, sizeof(output));
+
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), curve.WideValue(0));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x8080), curve.WideValue(128));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0xffff), curve.WideValue(255));
+
+  // Dithering a linear curve does nothing.
+  OutputCurve::Options options;
+  options.dither = true;
+  curve.Configure(options);
+  OLA_ASSERT_TRUE(curve.IsIdentity());
+}
+
+/*
+ * Check the gamma curve.
+ */
+void OutputCurveTest::testGamma() {
+  OutputCurve::Options options;
+  options.gamma = 2.0;
+  OutputCurve curve(options);
+  OLA_ASSERT_FALSE(curve.IsIdentity());
+
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), curve.Value(0));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(64), curve.Value(128));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(255), curve.Value(255));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0xffff), curve.WideValue(255));
+
+  DmxBuffer input;
+  input.SetFromString("0,128,255");
+  DmxBuffer output;
+  curve.Apply(input, &output);
+  OLA_ASSERT_EQ(3u, output.Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), output.Get(0));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(64), output.Get(1));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(255), output.Get(2));
+
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x4000), curve.Evaluate(0.5));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0xffff), curve.Evaluate(2.0));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), curve.Evaluate(-1.0));
+
+  uint16_t wide[3];
+  curve.ApplyWide(input.GetRaw(), wide, input.Size());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), wide[0]);
+  OLA_ASSERT_EQ(curve.WideValue(128), wide[1]);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0xffff), wide[2]);
+}
+
+/*
+ * Check the brightness limits the output.
+ */
+void OutputCurveTest::testBrightness() {
+  OutputCurve::Options options;
+  options.brightness = 50;
+  OutputCurve curve(options);
+  OLA_ASSERT_FALSE(curve.IsIdentity());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(128), curve.Value(255));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), curve.Value(100));
+
+  // Values over 100% are clamped.
+  options.brightness = 200;
+  curve.Configure(options);
+  OLA_ASSERT_TRUE(curve.IsIdentity());
+}
+
+/*
+ * Over 256 frames the dithered output should add up to the 8.8 fixed point
+ * value of the curve.
+ */
+void OutputCurveTest::testDither() {
+  OutputCurve::Options options;
+  options.gamma = 2.2;
+  options.dither = true;
+  OutputCurve curve(options);
+
+  const uint8_t input[] = {0, 10, 40, 128, 255};
+  unsigned int totals[sizeof(input)] = {0, 0, 0, 0, 0};
+  for (unsigned int frame = 0; frame < 256; frame++) {
+    uint8_t output[sizeof(input)];
+    curve.Apply(input, output, sizeof(input));
+    for (unsigned int i = 0; i < sizeof(input); i++) {
+      totals[i] += output[i];
+    }
+  }
+
+  for (unsigned int i = 0; i < sizeof(input); i++) {
+    unsigned int expected = static_cast<unsigned int>(
+        floor(pow(input[i] / 255.0, 2.2) * 0xff00 + 0.5));
+    OLA_ASSERT_EQ(expected, totals[i]);
+  }
+
+  // Input 10 is 0 without dithering, but not with it.
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), curve.Value(10));
+  OLA_ASSERT_NE(0u, totals[1]);
+}
+
+/*
+ * Check ParseGamma().
+ */
+void OutputCurveTest::testParseGamma() {
+  double gamma = 0;
+  OLA_ASSERT_TRUE(OutputCurve::ParseGamma("2.2", &gamma));
+  OLA_ASSERT_EQ(2.2, gamma);
+  OLA_ASSERT_TRUE(OutputCurve::ParseGamma("1", &gamma));
+  OLA_ASSERT_EQ(1.0, gamma);
+
+  OLA_ASSERT_FALSE(OutputCurve::ParseGamma("", &gamma));
+  OLA_ASSERT_FALSE(OutputCurve::ParseGamma("foo", &gamma));
+  OLA_ASSERT_FALSE(OutputCurve::ParseGamma("2.2x", &gamma));
+  OLA_ASSERT_FALSE(OutputCurve::ParseGamma("0", &gamma));
+  OLA_ASSERT_FALSE(OutputCurve::ParseGamma("10", &gamma));
+  OLA_ASSERT_EQ(1.0, gamma);
+}
@@ -0,0 +1,109 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelBuffer.cpp
+ * Assemble a pixel frame from several universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+
+#include "ola/Constants.h"
+#include "ola/InlineCallback.h"
+#include "ola/dmx/PixelBuffer.h"
+
+namespace ola {
+namespace dmx {
+
+using std::max;
+using std::min;
+
+const unsigned int PixelBuffer::DEFAULT_SLOTS_PER_SEGMENT;
+const unsigned int PixelBuffer::DEFAULT_DEADLINE_US;
+
+PixelBuffer::PixelBuffer(ola::thread::SchedulerInterface *scheduler,
+                         const Options &options,
+                         FrameCallback *callback)
+    : m_scheduler(scheduler),
+      m_segment_count(max(options.segment_count, 1u)),
+      m_slots_per_segment(
+          min(options.slots_per_segment,
+              static_cast<unsigned int>(DMX_UNIVERSE_SIZE))),
+      m_deadline(options.deadline),
+      m_data(m_segment_count * m_slots_per_segment, 0),
+      m_updated(m_segment_count, false),
+      m_updated_count(0),
+      m_size(0),
+      m_partial_frames(0),
+      m_timeout(ola::thread::INVALID_TIMEOUT),
+      m_callback(callback) {
+}
+
+PixelBuffer::~PixelBuffer() {
+  if (m_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+}
+
+bool PixelBuffer::Update(unsigned int segment, const DmxBuffer &buffer) {
+  if (segment >= m_segment_count) {
+    return false;
+  }
+
+  const unsigned int offset = segment * m_slots_per_segment;
+  unsigned int length = min(buffer.Size(), m_slots_per_segment);
+  buffer.GetRange(0, &m_data[offset], &length);
+  m_size = max(m_size, offset + length);
+
+  if (!m_updated[segment]) {
+    m_updated[segment] = true;
+    m_updated_count++;
+  }
+
+  if (m_updated_count == m_segment_count) {
+    SendFrame();
+  } else if (m_timeout == ola::thread::INVALID_TIMEOUT && m_scheduler &&
+             m_deadline != TimeInterval(0, 0)) {
+    m_timeout = m_scheduler->RegisterSingleTimeout(
+        m_deadline, MakeInlineCallback(this, &PixelBuffer::DeadlineExpired));
+  }
+  return true;
+}
+
+void PixelBuffer::Flush() {
+  if (m_updated_count) {
+    SendFrame();
+  }
+}
+
+void PixelBuffer::DeadlineExpired() {
+  m_timeout = ola::thread::INVALID_TIMEOUT;
+  m_partial_frames++;
+  Flush();
+}
+
+void PixelBuffer::SendFrame() {
+  if (m_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+    m_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  std::fill(m_updated.begin(), m_updated.end(), false);
+  m_updated_count = 0;
+  if (m_callback.get() && m_size) {
+    m_callback->Run(&m_data[0], m_size);
+  }
+}
+}  // namespace dmx
+}  // namespace ola
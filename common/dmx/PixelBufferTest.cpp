@@ -0,0 +1,162 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelBufferTest.cpp
+ * Test fixture for the PixelBuffer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/PixelBuffer.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::dmx::PixelBuffer;
+using std::vector;
+
+class PixelBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PixelBufferTest);
+  CPPUNIT_TEST(testCompleteFrame);
+  CPPUNIT_TEST(testDeadline);
+  CPPUNIT_TEST(testNoDeadline);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  PixelBufferTest()
+      : m_ss(NULL),
+        m_frame_count(0) {
+  }
+
+  void testCompleteFrame();
+  void testDeadline();
+  void testNoDeadline();
+
+ private:
+  ola::io::SelectServer m_ss;
+  vector<uint8_t> m_frame;
+  unsigned int m_frame_count;
+
+  void NewFrame(const uint8_t *data, unsigned int length) {
+    m_frame.assign(data, data + length);
+    m_frame_count++;
+  }
+
+  PixelBuffer::FrameCallback *NewFrameCallback() {
+    return ola::NewCallback(this, &PixelBufferTest::NewFrame);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PixelBufferTest);
+
+
+/*
+ * Check a frame is sent once all segments have been updated.
+ */
+void PixelBufferTest::testCompleteFrame() {
+  PixelBuffer::Options options(3);
+  options.slots_per_segment = 3;
+  PixelBuffer buffer(&m_ss, options, NewFrameCallback());
+  OLA_ASSERT_EQ(3u, buffer.SegmentCount());
+  OLA_ASSERT_EQ(3u, buffer.SlotsPerSegment());
+  OLA_ASSERT_EQ(0u, buffer.Size());
+
+  DmxBuffer dmx;
+  dmx.SetFromString("1,2,3,4");  // the 4th slot is ignored
+  OLA_ASSERT_TRUE(buffer.Update(0, dmx));
+  dmx.SetFromString("7,8");
+  OLA_ASSERT_TRUE(buffer.Update(2, dmx));
+  OLA_ASSERT_EQ(0u, m_frame_count);
+  OLA_ASSERT_EQ(8u, buffer.Size());
+
+  // Updating a segment twice doesn't complete the frame.
+  OLA_ASSERT_TRUE(buffer.Update(0, dmx));
+  OLA_ASSERT_EQ(0u, m_frame_count);
+  OLA_ASSERT_FALSE(buffer.Update(3, dmx));
+
+  dmx.SetFromString("4,5,6");
+  OLA_ASSERT_TRUE(buffer.Update(1, dmx));
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  const uint8_t expected[] = {7, 8, 3, 4, 5, 6, 7, 8};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), &m_frame[0],
+                         m_frame.size());
+  OLA_ASSERT_EQ(0u, buffer.PartialFrames());
+
+  // Nothing is pending, so flush is a no-op.
+  buffer.Flush();
+  OLA_ASSERT_EQ(1u, m_frame_count);
+
+  // A single segment buffer sends every update.
+  PixelBuffer single(&m_ss, PixelBuffer::Options(), NewFrameCallback());
+  single.Update(0, dmx);
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(m_frame.size()));
+}
+
+
+/*
+ * Check a partial frame is sent once the deadline passes.
+ */
+void PixelBufferTest::testDeadline() {
+  PixelBuffer::Options options(2);
+  options.deadline = TimeInterval(0, 1000);
+  PixelBuffer buffer(&m_ss, options, NewFrameCallback());
+
+  DmxBuffer dmx;
+  dmx.SetFromString("1,2,3");
+  buffer.Update(1, dmx);
+  OLA_ASSERT_EQ(0u, m_frame_count);
+
+  for (unsigned int i = 0; i < 100 && !m_frame_count; i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  OLA_ASSERT_EQ(1u, buffer.PartialFrames());
+  OLA_ASSERT_EQ(PixelBuffer::DEFAULT_SLOTS_PER_SEGMENT + 3,
+                static_cast<unsigned int>(m_frame.size()));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), m_frame[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1),
+                m_frame[PixelBuffer::DEFAULT_SLOTS_PER_SEGMENT]);
+
+  // A complete frame cancels the deadline.
+  buffer.Update(0, dmx);
+  buffer.Update(1, dmx);
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  m_ss.RunOnce(TimeInterval(0, 5000));
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(1u, buffer.PartialFrames());
+}
+
+
+/*
+ * Without a scheduler, partial frames are only sent by Flush().
+ */
+void PixelBufferTest::testNoDeadline() {
+  PixelBuffer buffer(NULL, PixelBuffer::Options(2), NewFrameCallback());
+
+  DmxBuffer dmx;
+  dmx.SetFromString("1,2,3");
+  buffer.Update(0, dmx);
+  OLA_ASSERT_EQ(0u, m_frame_count);
+  buffer.Flush();
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(m_frame.size()));
+}
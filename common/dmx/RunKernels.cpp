@@ -0,0 +1,330 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RunKernels.cpp
+ * Vectorized run detection kernels used by the run length encoders.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Like the merge kernels, the x86 versions use function level target
+ * attributes and are only picked once the CPU has been probed. Each vector
+ * kernel compares a block of bytes at once and then uses the mask of matches
+ * to find the position within the block.
+ */
+
+#include "common/dmx/RunKernels.h"
+
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || \
+     (defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OLA_RUN_X86 1
+#include <immintrin.h>
+#endif  // x86 & compiler supports target attributes
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#define OLA_RUN_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace dmx {
+
+using std::vector;
+
+namespace {
+
+/*
+ * The scalar versions take the offset to start from, so the vector kernels
+ * can use them for the tail.
+ */
+inline unsigned int ScalarRunLengthFrom(const uint8_t *data,
+                                        unsigned int offset,
+                                        unsigned int length) {
+  unsigned int i = offset;
+  while (i < length && data[i] == data[0]) {
+    i++;
+  }
+  return i;
+}
+
+inline unsigned int ScalarFindRepeatFrom(const uint8_t *data,
+                                         unsigned int offset,
+                                         unsigned int length) {
+  for (unsigned int i = offset; i + 2 < length; i++) {
+    if (data[i] == data[i + 1] && data[i] == data[i + 2]) {
+      return i;
+    }
+  }
+  return length;
+}
+
+inline unsigned int ScalarFindEitherFrom(const uint8_t *data,
+                                         unsigned int offset,
+                                         unsigned int length,
+                                         uint8_t a, uint8_t b) {
+  for (unsigned int i = offset; i < length; i++) {
+    if (data[i] == a || data[i] == b) {
+      return i;
+    }
+  }
+  return length;
+}
+
+unsigned int ScalarRunLength(const uint8_t *data, unsigned int length) {
+  return length ? ScalarRunLengthFrom(data, 1, length) : 0;
+}
+
+unsigned int ScalarFindRepeat(const uint8_t *data, unsigned int length) {
+  return ScalarFindRepeatFrom(data, 0, length);
+}
+
+unsigned int ScalarFindEither(const uint8_t *data, unsigned int length,
+                              uint8_t a, uint8_t b) {
+  return ScalarFindEitherFrom(data, 0, length, a, b);
+}
+
+#ifdef OLA_RUN_X86
+__attribute__((target("sse2")))
+unsigned int SSE2RunLength(const uint8_t *data, unsigned int length) {
+  if (!length) {
+    return 0;
+  }
+  const __m128i value = _mm_set1_epi8(static_cast<char>(data[0]));
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    unsigned int matches = _mm_movemask_epi8(_mm_cmpeq_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), value));
+    if (matches != 0xffff) {
+      return i + __builtin_ctz(~matches);
+    }
+  }
+  return ScalarRunLengthFrom(data, i, length);
+}
+
+__attribute__((target("sse2")))
+unsigned int SSE2FindRepeat(const uint8_t *data, unsigned int length) {
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) + 2 <= length; i += sizeof(__m128i)) {
+    __m128i first = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i));
+    __m128i second = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i + 1));
+    __m128i third = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i + 2));
+    unsigned int matches = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, second),
+                      _mm_cmpeq_epi8(first, third)));
+    if (matches) {
+      return i + __builtin_ctz(matches);
+    }
+  }
+  return ScalarFindRepeatFrom(data, i, length);
+}
+
+__attribute__((target("sse2")))
+unsigned int SSE2FindEither(const uint8_t *data, unsigned int length,
+                            uint8_t a, uint8_t b) {
+  const __m128i first = _mm_set1_epi8(static_cast<char>(a));
+  const __m128i second = _mm_set1_epi8(static_cast<char>(b));
+  unsigned int i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i));
+    unsigned int matches = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(block, first),
+                     _mm_cmpeq_epi8(block, second)));
+    if (matches) {
+      return i + __builtin_ctz(matches);
+    }
+  }
+  return ScalarFindEitherFrom(data, i, length, a, b);
+}
+
+__attribute__((target("avx2")))
+unsigned int AVX2RunLength(const uint8_t *data, unsigned int length) {
+  if (!length) {
+    return 0;
+  }
+  const __m256i value = _mm256_set1_epi8(static_cast<char>(data[0]));
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    uint32_t matches = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            value)));
+    if (matches != 0xffffffff) {
+      return i + __builtin_ctz(~matches);
+    }
+  }
+  return ScalarRunLengthFrom(data, i, length);
+}
+
+__attribute__((target("avx2")))
+unsigned int AVX2FindRepeat(const uint8_t *data, unsigned int length) {
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) + 2 <= length; i += sizeof(__m256i)) {
+    __m256i first = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i));
+    __m256i second = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i + 1));
+    __m256i third = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i + 2));
+    uint32_t matches = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, second),
+                         _mm256_cmpeq_epi8(first, third))));
+    if (matches) {
+      return i + __builtin_ctz(matches);
+    }
+  }
+  return ScalarFindRepeatFrom(data, i, length);
+}
+
+__attribute__((target("avx2")))
+unsigned int AVX2FindEither(const uint8_t *data, unsigned int length,
+                            uint8_t a, uint8_t b) {
+  const __m256i first = _mm256_set1_epi8(static_cast<char>(a));
+  const __m256i second = _mm256_set1_epi8(static_cast<char>(b));
+  unsigned int i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    __m256i block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i));
+    uint32_t matches = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, first),
+                        _mm256_cmpeq_epi8(block, second))));
+    if (matches) {
+      return i + __builtin_ctz(matches);
+    }
+  }
+  return ScalarFindEitherFrom(data, i, length, a, b);
+}
+#endif  // OLA_RUN_X86
+
+#ifdef OLA_RUN_NEON
+/*
+ * NEON doesn't have a movemask, so narrow each byte of the comparison to 4
+ * bits of a 64 bit value instead.
+ */
+inline uint64_t NEONMatches(uint8x16_t matches) {
+  return vget_lane_u64(vreinterpret_u64_u8(
+      vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+
+unsigned int NEONRunLength(const uint8_t *data, unsigned int length) {
+  if (!length) {
+    return 0;
+  }
+  const uint8x16_t value = vdupq_n_u8(data[0]);
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    uint64_t differences = NEONMatches(
+        vmvnq_u8(vceqq_u8(vld1q_u8(data + i), value)));
+    if (differences) {
+      return i + __builtin_ctzll(differences) / 4;
+    }
+  }
+  return ScalarRunLengthFrom(data, i, length);
+}
+
+unsigned int NEONFindRepeat(const uint8_t *data, unsigned int length) {
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) + 2 <= length; i += sizeof(uint8x16_t)) {
+    uint8x16_t first = vld1q_u8(data + i);
+    uint64_t matches = NEONMatches(
+        vandq_u8(vceqq_u8(first, vld1q_u8(data + i + 1)),
+                 vceqq_u8(first, vld1q_u8(data + i + 2))));
+    if (matches) {
+      return i + __builtin_ctzll(matches) / 4;
+    }
+  }
+  return ScalarFindRepeatFrom(data, i, length);
+}
+
+unsigned int NEONFindEither(const uint8_t *data, unsigned int length,
+                            uint8_t a, uint8_t b) {
+  const uint8x16_t first = vdupq_n_u8(a);
+  const uint8x16_t second = vdupq_n_u8(b);
+  unsigned int i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    uint8x16_t block = vld1q_u8(data + i);
+    uint64_t matches = NEONMatches(
+        vorrq_u8(vceqq_u8(block, first), vceqq_u8(block, second)));
+    if (matches) {
+      return i + __builtin_ctzll(matches) / 4;
+    }
+  }
+  return ScalarFindEitherFrom(data, i, length, a, b);
+}
+#endif  // OLA_RUN_NEON
+
+const RunKernel kScalarKernel = {
+  "scalar", ScalarRunLength, ScalarFindRepeat, ScalarFindEither
+};
+
+#ifdef OLA_RUN_X86
+const RunKernel kSSE2Kernel = {
+  "sse2", SSE2RunLength, SSE2FindRepeat, SSE2FindEither
+};
+const RunKernel kAVX2Kernel = {
+  "avx2", AVX2RunLength, AVX2FindRepeat, AVX2FindEither
+};
+#endif  // OLA_RUN_X86
+
+#ifdef OLA_RUN_NEON
+const RunKernel kNEONKernel = {
+  "neon", NEONRunLength, NEONFindRepeat, NEONFindEither
+};
+#endif  // OLA_RUN_NEON
+
+const RunKernel *DetectBestKernel() {
+  vector<const RunKernel*> kernels;
+  SupportedRunKernels(&kernels);
+  return kernels.back();
+}
+}  // namespace
+
+
+const RunKernel &ScalarRunKernel() {
+  return kScalarKernel;
+}
+
+
+const RunKernel &BestRunKernel() {
+  static const RunKernel *best_kernel = DetectBestKernel();
+  return *best_kernel;
+}
+
+
+void SupportedRunKernels(vector<const RunKernel*> *kernels) {
+  kernels->clear();
+  kernels->push_back(&kScalarKernel);
+
+#ifdef OLA_RUN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    kernels->push_back(&kSSE2Kernel);
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    kernels->push_back(&kAVX2Kernel);
+  }
+#endif  // OLA_RUN_X86
+
+#ifdef OLA_RUN_NEON
+  kernels->push_back(&kNEONKernel);
+#endif  // OLA_RUN_NEON
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,86 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RunKernels.h
+ * Vectorized run detection kernels used by the run length encoders.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_DMX_RUNKERNELS_H_
+#define COMMON_DMX_RUNKERNELS_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A set of functions that find runs of equal bytes.
+ *
+ * The run length encoders spend most of their time looking for where the
+ * current run ends or where the next one starts. The vector kernels compare
+ * 16 or 32 bytes at a time.
+ */
+struct RunKernel {
+  /**
+   * @brief The name of the kernel, e.g. "sse2".
+   */
+  const char *name;
+
+  /**
+   * @brief The number of bytes at the start of data that are equal to
+   *   data[0].
+   * @returns a value in [1, length], or 0 if length is 0.
+   */
+  unsigned int (*run_length)(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Find the first run of three equal bytes.
+   * @returns the offset of the first byte of the run, or length if there
+   *   isn't one.
+   */
+  unsigned int (*find_repeat)(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Find the first byte which is either a or b.
+   * @returns the offset of the byte, or length if there isn't one.
+   */
+  unsigned int (*find_either)(const uint8_t *data, unsigned int length,
+                              uint8_t a, uint8_t b);
+};
+
+/**
+ * @brief Return the portable, byte-at-a-time kernel.
+ */
+const RunKernel &ScalarRunKernel();
+
+/**
+ * @brief Return the fastest kernel supported by the CPU we're running on.
+ *
+ * The CPU is probed on the first call, the result is cached.
+ */
+const RunKernel &BestRunKernel();
+
+/**
+ * @brief Get all the kernels that can run on this CPU.
+ * @param[out] kernels the list of kernels, the scalar kernel is always first.
+ *
+ * This is used by the tests and the benchmark to compare implementations.
+ */
+void SupportedRunKernels(std::vector<const RunKernel*> *kernels);
+}  // namespace dmx
+}  // namespace ola
+#endif  // COMMON_DMX_RUNKERNELS_H_
@@ -0,0 +1,170 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RunKernelsTest.cpp
+ * Test fixture for the run detection kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "common/dmx/RunKernels.h"
+#include "ola/Constants.h"
+#include "ola/math/Random.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::BestRunKernel;
+using ola::dmx::RunKernel;
+using ola::dmx::ScalarRunKernel;
+using ola::dmx::SupportedRunKernels;
+using std::vector;
+
+class RunKernelsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RunKernelsTest);
+  CPPUNIT_TEST(testKernelList);
+  CPPUNIT_TEST(testRunLength);
+  CPPUNIT_TEST(testFindRepeat);
+  CPPUNIT_TEST(testFindEither);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testKernelList();
+    void testRunLength();
+    void testFindRepeat();
+    void testFindEither();
+
+ private:
+    // A frame with runs of every length up to 40, and one with no runs.
+    uint8_t m_runs[ola::DMX_UNIVERSE_SIZE];
+    uint8_t m_noise[ola::DMX_UNIVERSE_SIZE];
+    vector<const RunKernel*> m_kernels;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RunKernelsTest);
+
+
+void RunKernelsTest::setUp() {
+  ola::math::InitRandom();
+  unsigned int i = 0;
+  uint8_t value = 0;
+  for (unsigned int run = 1; i < ola::DMX_UNIVERSE_SIZE; run = run % 40 + 1) {
+    for (unsigned int j = 0; j < run && i < ola::DMX_UNIVERSE_SIZE; j++) {
+      m_runs[i++] = value;
+    }
+    value += 0x35;
+  }
+  for (i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    m_noise[i] = static_cast<uint8_t>(i % 2 ? ola::math::Random(0, 127) :
+                                              ola::math::Random(128, 255));
+  }
+  SupportedRunKernels(&m_kernels);
+}
+
+
+/*
+ * Check the scalar kernel is always available and the best kernel is one of
+ * the supported ones.
+ */
+void RunKernelsTest::testKernelList() {
+  OLA_ASSERT_FALSE(m_kernels.empty());
+  OLA_ASSERT_EQ(&ScalarRunKernel(), m_kernels[0]);
+  OLA_ASSERT_EQ(&BestRunKernel(), m_kernels.back());
+}
+
+
+/*
+ * Check run_length matches the scalar version from every offset, so we cover
+ * the vector body and the scalar tail.
+ */
+void RunKernelsTest::testRunLength() {
+  const RunKernel &scalar = ScalarRunKernel();
+  OLA_ASSERT_EQ(0u, scalar.run_length(m_runs, 0));
+  OLA_ASSERT_EQ(1u, scalar.run_length(m_runs, 1));
+  OLA_ASSERT_EQ(1u, scalar.run_length(m_runs, ola::DMX_UNIVERSE_SIZE));
+  OLA_ASSERT_EQ(2u, scalar.run_length(m_runs + 1, ola::DMX_UNIVERSE_SIZE - 1));
+
+  uint8_t blackout[ola::DMX_UNIVERSE_SIZE] = {0};
+  vector<const RunKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int offset = 0; offset < ola::DMX_UNIVERSE_SIZE;
+         offset++) {
+      unsigned int length = ola::DMX_UNIVERSE_SIZE - offset;
+      OLA_ASSERT_EQ(scalar.run_length(m_runs + offset, length),
+                    (*iter)->run_length(m_runs + offset, length));
+      OLA_ASSERT_EQ(1u, (*iter)->run_length(m_noise + offset, length));
+      OLA_ASSERT_EQ(length, (*iter)->run_length(blackout + offset, length));
+    }
+  }
+}
+
+
+/*
+ * Check find_repeat matches the scalar version for every offset and length.
+ */
+void RunKernelsTest::testFindRepeat() {
+  const RunKernel &scalar = ScalarRunKernel();
+  const uint8_t data[] = {1, 2, 2, 3, 3, 3};
+  OLA_ASSERT_EQ(3u, scalar.find_repeat(data, sizeof(data)));
+  OLA_ASSERT_EQ(5u, scalar.find_repeat(data, sizeof(data) - 1));
+  OLA_ASSERT_EQ(0u, scalar.find_repeat(data, 0));
+
+  vector<const RunKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int offset = 0; offset < 80; offset++) {
+      for (unsigned int length = 0;
+           offset + length <= ola::DMX_UNIVERSE_SIZE; length += 7) {
+        OLA_ASSERT_EQ(scalar.find_repeat(m_runs + offset, length),
+                      (*iter)->find_repeat(m_runs + offset, length));
+        OLA_ASSERT_EQ(length, (*iter)->find_repeat(m_noise + offset, length));
+      }
+    }
+  }
+}
+
+
+/*
+ * Check find_either matches the scalar version.
+ */
+void RunKernelsTest::testFindEither() {
+  const RunKernel &scalar = ScalarRunKernel();
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    data[i] = static_cast<uint8_t>(ola::math::Random(0, 0xfc));
+  }
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE),
+                scalar.find_either(data, ola::DMX_UNIVERSE_SIZE, 0xfd, 0xfe));
+
+  vector<const RunKernel*>::const_iterator iter = m_kernels.begin();
+  for (; iter != m_kernels.end(); ++iter) {
+    for (unsigned int position = 0; position < ola::DMX_UNIVERSE_SIZE;
+         position += 5) {
+      uint8_t value = position % 2 ? 0xfd : 0xfe;
+      data[position] = value;
+      for (unsigned int offset = 0; offset <= position; offset += 3) {
+        unsigned int length = ola::DMX_UNIVERSE_SIZE - offset;
+        OLA_ASSERT_EQ(position - offset,
+                      (*iter)->find_either(data + offset, length, 0xfd,
+                                           0xfe));
+        // don't look past the end
+        OLA_ASSERT_EQ(position - offset,
+                      (*iter)->find_either(data + offset, position - offset,
+                                           0xfd, 0xfe));
+      }
+      data[position] = 0;
+    }
+  }
+}
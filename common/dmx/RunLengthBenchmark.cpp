@@ -0,0 +1,177 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RunLengthBenchmark.cpp
+ * Compare the run detection kernels and time the run length encoder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/dmx/RunKernels.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/dmx/RunLengthEncoder.h"
+#include "ola/math/Random.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::RunKernel;
+using ola::dmx::RunLengthEncoder;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 200000, "The number of frames to encode");
+
+namespace {
+
+struct Frame {
+  string name;
+  DmxBuffer buffer;
+};
+
+/*
+ * Print the throughput for a test.
+ */
+void Report(const string &test, const string &frame, const char *kernel,
+            const TimeInterval &elapsed, unsigned int frames) {
+  double seconds = elapsed.AsInt() / 1000000.0;
+  cout << std::left << std::setw(8) << test << std::setw(10) << frame
+       << std::setw(10) << kernel << std::right << std::setw(10)
+       << std::fixed << std::setprecision(1)
+       << (seconds > 0 ? frames / seconds / 1000.0 : 0) << " k frames/s"
+       << endl;
+}
+
+/*
+ * Split a frame into repeats and literal blocks the way the encoder does.
+ */
+unsigned int Scan(const RunKernel &kernel, const uint8_t *data,
+                  unsigned int length) {
+  unsigned int blocks = 0;
+  unsigned int i = 0;
+  while (i < length) {
+    unsigned int run = kernel.run_length(data + i, length - i);
+    if (run > 2) {
+      i += run;
+    } else {
+      i += 1 + kernel.find_repeat(data + i + 1, length - i - 1);
+    }
+    blocks++;
+  }
+  return blocks;
+}
+
+/*
+ * Time the scan for each kernel.
+ */
+void RunScan(const RunKernel &kernel, const Frame &frame,
+             unsigned int iterations) {
+  Clock clock;
+  TimeStamp start, end;
+  const uint8_t *data = frame.buffer.GetRaw();
+  unsigned int length = frame.buffer.Size();
+
+  unsigned int blocks = 0;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    blocks += Scan(kernel, data, length);
+  }
+  clock.CurrentTime(&end);
+  if (!blocks) {
+    cout << "No blocks found!" << endl;
+  }
+  Report("scan", frame.name, kernel.name, end - start, iterations);
+}
+
+/*
+ * Time the encoder and decoder, which use the best kernel.
+ */
+void RunEncoder(const Frame &frame, unsigned int iterations) {
+  Clock clock;
+  TimeStamp start, end;
+  RunLengthEncoder encoder;
+  uint8_t data[2 * ola::DMX_UNIVERSE_SIZE];
+  unsigned int size = 0;
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    size = sizeof(data);
+    encoder.Encode(frame.buffer, data, &size);
+  }
+  clock.CurrentTime(&end);
+  Report("encode", frame.name, ola::dmx::BestRunKernel().name, end - start,
+         iterations);
+
+  DmxBuffer output;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    encoder.Decode(0, data, size, &output);
+  }
+  clock.CurrentTime(&end);
+  Report("decode", frame.name, "-", end - start, iterations);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Benchmark the run length encoding implementations.");
+  ola::math::InitRandom();
+
+  vector<Frame> frames(3);
+  frames[0].name = "blackout";
+  frames[0].buffer.Blackout();
+
+  // 32 fixtures of 16 channels, with a few channels of each one in use.
+  frames[1].name = "sparse";
+  frames[1].buffer.Blackout();
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i += 16) {
+    frames[1].buffer.SetChannel(i, 255);
+    frames[1].buffer.SetChannel(i + 1, ola::math::Random(0, 255));
+    frames[1].buffer.SetChannel(i + 2, ola::math::Random(0, 255));
+  }
+
+  // RGB pixels, all different.
+  frames[2].name = "pixels";
+  frames[2].buffer.Blackout();
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    frames[2].buffer.SetChannel(i, ola::math::Random(0, 255));
+  }
+
+  cout << "Encoding " << FLAGS_iterations << " frames" << endl;
+
+  vector<const RunKernel*> kernels;
+  ola::dmx::SupportedRunKernels(&kernels);
+  vector<Frame>::const_iterator frame = frames.begin();
+  for (; frame != frames.end(); ++frame) {
+    vector<const RunKernel*>::const_iterator iter = kernels.begin();
+    for (; iter != kernels.end(); ++iter) {
+      RunScan(**iter, *frame, FLAGS_iterations);
+    }
+    RunEncoder(*frame, FLAGS_iterations);
+  }
+  return 0;
+}
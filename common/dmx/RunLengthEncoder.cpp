@@ -20,82 +20,77 @@
 
 #include <string.h>
 #include <ola/dmx/RunLengthEncoder.h>
+#include <algorithm>
+#include "common/dmx/RunKernels.h"
 
 namespace ola {
 namespace dmx {
 
+const unsigned int RunLengthEncoder::MAX_BLOCK_SIZE;
+
+/*
+ * Runs of three or more values are sent as a repeat, everything else is sent
+ * as a literal block. Finding where a run ends and where the next one starts
+ * is done by the best RunKernel for this CPU.
+ */
 bool RunLengthEncoder::Encode(const DmxBuffer &src,
                               uint8_t *data,
                               unsigned int *data_size) {
+  const RunKernel &kernel = BestRunKernel();
+  const uint8_t *src_data = src.GetRaw();
   unsigned int src_size = src.Size();
   unsigned int dst_size = *data_size;
   unsigned int &dst_index = *data_size;
   dst_index = 0;
 
-  unsigned int i;
-  for (i = 0; i < src_size && dst_index < dst_size;) {
-    // j points to the first non-repeating value
-    unsigned int j = i + 1;
-    while (j < src_size && src.Get(i) == src.Get(j) && j - i < 0x7f) {
-      j++;
-    }
+  unsigned int i = 0;
+  while (i < src_size && dst_index < dst_size) {
+    unsigned int remaining = src_size - i;
+    unsigned int run = std::min(
+        kernel.run_length(src_data + i, std::min(remaining, MAX_BLOCK_SIZE)),
+        MAX_BLOCK_SIZE);
 
-    // if the number of repeats is more than 2
-    // don't encode only two repeats,
-    if (j - i > 2) {
+    // don't encode only two repeats
+    if (run > 2) {
       // if room left in dst buffer
       if (dst_size - dst_index > 1) {
-        data[dst_index++] = (REPEAT_FLAG | (j - i));
-        data[dst_index++] = src.Get(i);
+        data[dst_index++] = static_cast<uint8_t>(REPEAT_FLAG | run);
+        data[dst_index++] = src_data[i];
       } else {
         // else return what we have done so far
         return false;
       }
-      i = j;
-
-    } else {
-      // this value doesn't repeat more than twice
-      // find out where the next repeat starts
-
-      // postcondition: j is one more than the last value we want to send
-      for (j = i + 1; j < src_size - 2 && j - i < 0x7f; j++) {
-        // at the end  of the array
-        if (j == src_size - 2) {
-          j = src_size;
-          break;
-        }
+      i += run;
+      continue;
+    }
 
-        // if we're found a repeat of 3 or more stop here
-        if (src.Get(j) == src.Get(j+1) && src.Get(j) == src.Get(j+2))
-          break;
-      }
-      if (j >= src_size - 2)
-        j = src_size;
+    // this value doesn't repeat more than twice, the literal block runs until
+    // the next repeat of 3 or more. We only need to look far enough ahead to
+    // fill one block.
+    unsigned int length = 1 + kernel.find_repeat(
+        src_data + i + 1, std::min(remaining - 1, MAX_BLOCK_SIZE + 1));
+    length = std::min(length, std::min(remaining, MAX_BLOCK_SIZE));
 
-      // if we have enough room left for all the values
-      if (dst_index + j - i < dst_size) {
-        data[dst_index++] = j - i;
-        memcpy(&data[dst_index], src.GetRaw() + i, j-i);
-        dst_index += j - i;
-        i = j;
+    // if we have enough room left for all the values
+    if (dst_index + length < dst_size) {
+      data[dst_index++] = static_cast<uint8_t>(length);
+      memcpy(&data[dst_index], src_data + i, length);
+      dst_index += length;
+      i += length;
 
-      // see how much data we can get in
-      } else if (dst_size - dst_index > 1) {
-        unsigned int l = dst_size - dst_index -1;
-        data[dst_index++] = l;
-        memcpy(&data[dst_index], src.GetRaw() + i, l);
-        dst_index += l;
-        return false;
-      } else {
-        return false;
-      }
+    // see how much data we can get in
+    } else if (dst_size - dst_index > 1) {
+      unsigned int l = dst_size - dst_index - 1;
+      data[dst_index++] = static_cast<uint8_t>(l);
+      memcpy(&data[dst_index], src_data + i, l);
+      dst_index += l;
+      return false;
+    } else {
+      return false;
     }
   }
 
-  if (i < src_size)
-    return false;
-  else
-    return true;
+  return i >= src_size;
 }
 
 bool RunLengthEncoder::Decode(unsigned int start_channel,
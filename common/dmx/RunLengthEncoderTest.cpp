@@ -35,12 +35,14 @@ class RunLengthEncoderTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RunLengthEncoderTest);
   CPPUNIT_TEST(testEncode);
   CPPUNIT_TEST(testEncode2);
+  CPPUNIT_TEST(testLongLiterals);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testEncode();
     void testEncode2();
     void testEncodeDecode();
+    void testLongLiterals();
     void setUp();
     void tearDown();
  private:
@@ -167,3 +169,30 @@ void RunLengthEncoderTest::testEncodeDecode() {
   checkEncodeDecode(TEST_DATA2, sizeof(TEST_DATA2));
   checkEncodeDecode(TEST_DATA3, sizeof(TEST_DATA3));
 }
+
+
+/*
+ * Check that literal blocks longer than 127 bytes are split, including ones
+ * at the end of the frame.
+ */
+void RunLengthEncoderTest::testLongLiterals() {
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  const unsigned int lengths[] = {127, 128, 129, 254, 255, 384};
+  for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    DmxBuffer src(data, lengths[i]);
+    DmxBuffer dst;
+    unsigned int dst_size = ola::DMX_UNIVERSE_SIZE;
+    OLA_ASSERT_TRUE(m_encoder.Encode(src, m_dst, &dst_size));
+    OLA_ASSERT_EQ(lengths[i] + (lengths[i] + 126) / 127, dst_size);
+    OLA_ASSERT_FALSE(m_dst[0] & 0x80);
+
+    // Decode() blacks out the rest of the buffer
+    OLA_ASSERT_TRUE(m_encoder.Decode(0, m_dst, dst_size, &dst));
+    OLA_ASSERT_DATA_EQUALS(src.GetRaw(), src.Size(), dst.GetRaw(),
+                           src.Size());
+  }
+}
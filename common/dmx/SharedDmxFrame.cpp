@@ -0,0 +1,129 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxFrame.cpp
+ * An immutable DMX frame that can be shared between threads.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The frames use the same blocks as DmxBuffer, so they come from the
+ * DmxBufferPool if it's enabled. The reference count is updated with the
+ * GCC atomic builtins, which are also supported by clang.
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include "common/dmx/DmxBufferPool.h"
+#include "ola/Constants.h"
+#include "ola/dmx/SharedDmxFrame.h"
+
+namespace ola {
+namespace dmx {
+
+using std::min;
+using std::swap;
+
+SharedDmxFrame::SharedDmxFrame()
+    : m_block(NULL),
+      m_length(0) {
+}
+
+
+SharedDmxFrame::SharedDmxFrame(const DmxBuffer &buffer)
+    : m_block(NULL),
+      m_length(0) {
+  Init(buffer.GetRaw(), buffer.Size());
+}
+
+
+SharedDmxFrame::SharedDmxFrame(const uint8_t *data, unsigned int length)
+    : m_block(NULL),
+      m_length(0) {
+  Init(data, length);
+}
+
+
+SharedDmxFrame::SharedDmxFrame(const SharedDmxFrame &other)
+    : m_block(other.m_block),
+      m_length(other.m_length) {
+  if (m_block) {
+    __sync_add_and_fetch(&m_block->ref_count, 1);
+  }
+}
+
+
+SharedDmxFrame::~SharedDmxFrame() {
+  Unref();
+}
+
+
+SharedDmxFrame& SharedDmxFrame::operator=(const SharedDmxFrame &other) {
+  if (m_block != other.m_block) {
+    if (other.m_block) {
+      __sync_add_and_fetch(&other.m_block->ref_count, 1);
+    }
+    Unref();
+    m_block = other.m_block;
+  }
+  m_length = other.m_length;
+  return *this;
+}
+
+
+void SharedDmxFrame::Swap(SharedDmxFrame *other) {
+  swap(m_block, other->m_block);
+  swap(m_length, other->m_length);
+}
+
+
+const uint8_t *SharedDmxFrame::Data() const {
+  return m_block ? m_block->data : NULL;
+}
+
+
+uint8_t SharedDmxFrame::Get(unsigned int slot) const {
+  return slot < m_length ? m_block->data[slot] : 0;
+}
+
+
+void SharedDmxFrame::CopyTo(DmxBuffer *buffer) const {
+  if (m_block) {
+    buffer->Set(m_block->data, m_length);
+  } else {
+    buffer->Reset();
+  }
+}
+
+
+void SharedDmxFrame::Init(const uint8_t *data, unsigned int length) {
+  if (!data || !length) {
+    return;
+  }
+  m_length = min(length, (unsigned int) DMX_UNIVERSE_SIZE);
+  m_block = DmxBufferPool::Global()->Allocate();
+  m_block->ref_count = 1;
+  memcpy(m_block->data, data, m_length);
+}
+
+
+void SharedDmxFrame::Unref() {
+  if (m_block && !__sync_sub_and_fetch(&m_block->ref_count, 1)) {
+    DmxBufferPool::Global()->Release(m_block);
+  }
+  m_block = NULL;
+  m_length = 0;
+}
+}  // namespace dmx
+}  // namespace ola
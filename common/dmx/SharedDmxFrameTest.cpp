@@ -0,0 +1,209 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxFrameTest.cpp
+ * Test fixture for the SharedDmxFrame class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "common/dmx/DmxBufferPool.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/SharedDmxFrame.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+
+using ola::DmxBuffer;
+using ola::dmx::DmxBufferPool;
+using ola::dmx::SharedDmxFrame;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using ola::thread::Thread;
+
+namespace {
+
+/*
+ * Repeatedly takes references to a shared frame.
+ */
+class ReaderThread: public Thread {
+ public:
+  ReaderThread(Mutex *mutex, const SharedDmxFrame *frame,
+               unsigned int iterations)
+      : Thread(Thread::Options("ReaderThread")),
+        m_mutex(mutex),
+        m_frame(frame),
+        m_iterations(iterations),
+        m_bad_frames(0) {
+  }
+
+  void *Run() {
+    for (unsigned int i = 0; i < m_iterations; i++) {
+      SharedDmxFrame frame;
+      {
+        MutexLocker locker(m_mutex);
+        frame = *m_frame;
+      }
+      // Each frame is filled with a single value.
+      if (frame.Size() && frame.Get(0) != frame.Get(frame.Size() - 1)) {
+        m_bad_frames++;
+      }
+    }
+    return NULL;
+  }
+
+  unsigned int BadFrames() const { return m_bad_frames; }
+
+ private:
+  Mutex *m_mutex;
+  const SharedDmxFrame *m_frame;
+  unsigned int m_iterations;
+  unsigned int m_bad_frames;
+};
+}  // namespace
+
+
+class SharedDmxFrameTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedDmxFrameTest);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testFromBuffer);
+  CPPUNIT_TEST(testCopy);
+  CPPUNIT_TEST(testSwap);
+  CPPUNIT_TEST(testThreads);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEmpty();
+    void testFromBuffer();
+    void testCopy();
+    void testSwap();
+    void testThreads();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedDmxFrameTest);
+
+
+void SharedDmxFrameTest::testEmpty() {
+  SharedDmxFrame frame;
+  OLA_ASSERT_EQ(0u, frame.Size());
+  OLA_ASSERT_NULL(frame.Data());
+  OLA_ASSERT_EQ(0, static_cast<int>(frame.Get(0)));
+
+  DmxBuffer empty_buffer;
+  SharedDmxFrame empty_frame(empty_buffer);
+  OLA_ASSERT_EQ(0u, empty_frame.Size());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  frame.CopyTo(&buffer);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+}
+
+
+void SharedDmxFrameTest::testFromBuffer() {
+  const uint8_t data[] = {1, 2, 3, 4};
+  DmxBuffer buffer(data, sizeof(data));
+  SharedDmxFrame frame(buffer);
+  OLA_ASSERT_EQ(4u, frame.Size());
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), frame.Data(), frame.Size());
+  OLA_ASSERT_EQ(4, static_cast<int>(frame.Get(3)));
+  OLA_ASSERT_EQ(0, static_cast<int>(frame.Get(4)));
+
+  // the frame doesn't change when the buffer does
+  buffer.SetChannel(0, 100);
+  OLA_ASSERT_EQ(1, static_cast<int>(frame.Get(0)));
+
+  DmxBuffer output;
+  frame.CopyTo(&output);
+  OLA_ASSERT(DmxBuffer(data, sizeof(data)) == output);
+
+  SharedDmxFrame raw_frame(data, 2);
+  OLA_ASSERT_EQ(2u, raw_frame.Size());
+  OLA_ASSERT_FALSE(raw_frame.IsSameFrame(frame));
+}
+
+
+void SharedDmxFrameTest::testCopy() {
+  DmxBufferPool *pool = DmxBufferPool::Global();
+  pool->SetMaxFreeBlocks(10);
+  unsigned int free_blocks = pool->FreeBlocks();
+
+  const uint8_t data[] = {1, 2, 3, 4};
+  SharedDmxFrame *frame = new SharedDmxFrame(data, sizeof(data));
+  SharedDmxFrame copy(*frame);
+  SharedDmxFrame assigned;
+  assigned = copy;
+  OLA_ASSERT_TRUE(frame->IsSameFrame(copy));
+  OLA_ASSERT_TRUE(frame->IsSameFrame(assigned));
+  OLA_ASSERT_EQ(frame->Data(), copy.Data());
+
+  // the block is released once all references have gone
+  delete frame;
+  assigned = SharedDmxFrame();
+  OLA_ASSERT_EQ(0u, assigned.Size());
+  OLA_ASSERT_EQ(free_blocks, pool->FreeBlocks());
+  OLA_ASSERT_EQ(4u, copy.Size());
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), copy.Data(), copy.Size());
+
+  copy = SharedDmxFrame();
+  OLA_ASSERT_EQ(free_blocks + 1, pool->FreeBlocks());
+  pool->SetMaxFreeBlocks(0);
+}
+
+
+void SharedDmxFrameTest::testSwap() {
+  const uint8_t data1[] = {1, 2, 3, 4};
+  const uint8_t data2[] = {5, 6};
+  SharedDmxFrame frame1(data1, sizeof(data1));
+  SharedDmxFrame frame2(data2, sizeof(data2));
+  const uint8_t *ptr1 = frame1.Data();
+
+  frame1.Swap(&frame2);
+  OLA_ASSERT_EQ(2u, frame1.Size());
+  OLA_ASSERT_EQ(4u, frame2.Size());
+  OLA_ASSERT_EQ(ptr1, frame2.Data());
+  OLA_ASSERT_DATA_EQUALS(data2, sizeof(data2), frame1.Data(), frame1.Size());
+}
+
+
+/*
+ * Hand frames to other threads while they take & drop references.
+ */
+void SharedDmxFrameTest::testThreads() {
+  const unsigned int iterations = 20000;
+  Mutex mutex;
+  SharedDmxFrame shared_frame;
+
+  ReaderThread reader1(&mutex, &shared_frame, iterations);
+  ReaderThread reader2(&mutex, &shared_frame, iterations);
+  OLA_ASSERT_TRUE(reader1.Start());
+  OLA_ASSERT_TRUE(reader2.Start());
+
+  DmxBuffer buffer;
+  for (unsigned int i = 0; i < iterations; i++) {
+    buffer.SetRangeToValue(0, i % 256, ola::DMX_UNIVERSE_SIZE);
+    SharedDmxFrame frame(buffer);
+    {
+      MutexLocker locker(&mutex);
+      shared_frame.Swap(&frame);
+    }
+  }
+
+  OLA_ASSERT_TRUE(reader1.Join());
+  OLA_ASSERT_TRUE(reader2.Join());
+  OLA_ASSERT_EQ(0u, reader1.BadFrames());
+  OLA_ASSERT_EQ(0u, reader2.BadFrames());
+}
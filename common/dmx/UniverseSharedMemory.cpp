@@ -0,0 +1,343 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UniverseSharedMemory.cpp
+ * The output of each universe, published through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef HAVE_LINUX_FUTEX_H
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif  // HAVE_LINUX_FUTEX_H
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/dmx/UniverseSharedMemory.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+/*
+ * The layout of the segment. Both sides are on the same machine, so the
+ * fields are in host byte order.
+ */
+struct UniverseSharedMemory::Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t slot_count;
+  volatile uint32_t used_slots;
+  volatile uint32_t change_count;  // the futex word
+  volatile uint32_t waiters;
+};
+
+struct UniverseSharedMemory::Slot {
+  volatile uint32_t sequence;  // odd while the slot is being written
+  uint32_t universe;
+  uint16_t length;
+  uint8_t priority;
+  uint8_t reserved;
+  uint8_t data[DMX_UNIVERSE_SIZE];
+};
+
+const char UniverseSharedMemory::DEFAULT_NAME[] = "/ola-universes";
+const unsigned int UniverseSharedMemory::MAX_SLOTS;
+
+namespace {
+const uint32_t SEGMENT_MAGIC = 0x4f4c5553;  // OLUS
+const uint16_t SEGMENT_VERSION = 1;
+// How many times Read() retries if the writer updates the slot under it.
+const unsigned int MAX_READ_ATTEMPTS = 4;
+// How often readers without a futex check the change count.
+const unsigned int POLL_INTERVAL_US = 1000;
+}  // namespace
+
+UniverseSharedMemory::~UniverseSharedMemory() {
+  munmap(m_memory, m_size);
+}
+
+UniverseSharedMemory *UniverseSharedMemory::Create(const string &name,
+                                                   unsigned int slot_count) {
+  if (slot_count == 0 || slot_count > MAX_SLOTS) {
+    OLA_WARN << "Invalid shared memory slot count " << slot_count;
+    return NULL;
+  }
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  const size_t size = SegmentSize(slot_count);
+  if (ftruncate(fd, size)) {
+    OLA_WARN << "ftruncate(" << name << "): " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate() zeros the segment, so the counters start at 0 and no slots
+  // are in use.
+  Header *header = reinterpret_cast<Header*>(memory);
+  header->slot_count = slot_count;
+  header->version = SEGMENT_VERSION;
+  __sync_synchronize();
+  header->magic = SEGMENT_MAGIC;
+  return new UniverseSharedMemory(name, memory, size, slot_count, true, true);
+}
+
+UniverseSharedMemory *UniverseSharedMemory::Open(const string &name) {
+  // Waiting needs write access to register as a waiter, without it the
+  // reader falls back to polling.
+  bool read_write = true;
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0 && errno == EACCES) {
+    read_write = false;
+    fd = shm_open(name.c_str(), O_RDONLY, 0);
+  }
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) ||
+      static_cast<size_t>(stat_buf.st_size) < SegmentSize(1)) {
+    OLA_WARN << "Shared memory segment " << name << " is too small";
+    close(fd);
+    return NULL;
+  }
+
+  // Don't trust the header until the size has been checked against it.
+  const size_t size = stat_buf.st_size;
+  void *memory = mmap(NULL, size,
+                      read_write ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  const Header *header = reinterpret_cast<Header*>(memory);
+  const unsigned int slot_count = header->slot_count;
+  if (header->magic != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+      slot_count == 0 || slot_count > MAX_SLOTS ||
+      SegmentSize(slot_count) > size) {
+    OLA_WARN << "Invalid shared memory segment " << name;
+    munmap(memory, size);
+    return NULL;
+  }
+  return new UniverseSharedMemory(name, memory, size, slot_count, false,
+                                  read_write);
+}
+
+void UniverseSharedMemory::Unlink() {
+  shm_unlink(m_name.c_str());
+}
+
+bool UniverseSharedMemory::Write(unsigned int universe, uint8_t priority,
+                                 const DmxBuffer &data) {
+  if (!m_writer) {
+    OLA_WARN << "Attempt to write to read only segment " << m_name;
+    return false;
+  }
+
+  unsigned int slot_index;
+  SlotMap::const_iterator iter = m_slot_map.find(universe);
+  if (iter != m_slot_map.end()) {
+    slot_index = iter->second;
+  } else if (m_slot_map.size() < m_slot_count) {
+    slot_index = m_slot_map.size();
+    m_slot_map[universe] = slot_index;
+  } else {
+    if (!m_full_logged) {
+      OLA_WARN << "No free slots in " << m_name << " for universe "
+               << universe;
+      m_full_logged = true;
+    }
+    return false;
+  }
+
+  Slot *slot = &m_slots[slot_index];
+  const uint32_t sequence = slot->sequence;
+  slot->sequence = sequence + 1;
+  __sync_synchronize();
+
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  data.Get(slot->data, &length);
+  slot->universe = universe;
+  slot->length = length;
+  slot->priority = priority;
+
+  __sync_synchronize();
+  slot->sequence = sequence + 2;
+  if (slot_index >= m_header->used_slots) {
+    m_header->used_slots = slot_index + 1;
+  }
+
+  // This is a full barrier, so either we see the waiter or it sees the new
+  // count.
+  __sync_add_and_fetch(&m_header->change_count, 1);
+#ifdef HAVE_LINUX_FUTEX_H
+  if (m_header->waiters) {
+    syscall(SYS_futex, &m_header->change_count, FUTEX_WAKE, INT_MAX, NULL,
+            NULL, 0);
+  }
+#endif  // HAVE_LINUX_FUTEX_H
+  return true;
+}
+
+int UniverseSharedMemory::FindSlot(unsigned int universe) const {
+  if (m_writer) {
+    SlotMap::const_iterator iter = m_slot_map.find(universe);
+    return iter == m_slot_map.end() ? -1 : static_cast<int>(iter->second);
+  }
+
+  const unsigned int used_slots = std::min(
+      static_cast<unsigned int>(m_header->used_slots), m_slot_count);
+  for (unsigned int i = 0; i < used_slots; i++) {
+    // A slot's universe is set before it's counted as used, and never
+    // changes.
+    if (m_slots[i].sequence && m_slots[i].universe == universe) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool UniverseSharedMemory::Read(unsigned int slot_index, Frame *frame) const {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+
+  const Slot *slot = &m_slots[slot_index];
+  for (unsigned int i = 0; i < MAX_READ_ATTEMPTS; i++) {
+    const uint32_t sequence = slot->sequence;
+    if (sequence == 0) {
+      return false;
+    }
+    if (sequence & 1) {
+      continue;
+    }
+    __sync_synchronize();
+
+    uint8_t slot_data[DMX_UNIVERSE_SIZE];
+    const unsigned int universe = slot->universe;
+    const unsigned int length = std::min(
+        static_cast<unsigned int>(slot->length),
+        static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+    const uint8_t priority = slot->priority;
+    memcpy(slot_data, slot->data, length);
+
+    __sync_synchronize();
+    if (slot->sequence != sequence) {
+      continue;
+    }
+
+    frame->universe = universe;
+    frame->priority = priority;
+    frame->sequence = sequence;
+    frame->data.Set(slot_data, length);
+    return true;
+  }
+  return false;
+}
+
+uint32_t UniverseSharedMemory::ChangeCount() const {
+  return m_header->change_count;
+}
+
+bool UniverseSharedMemory::WaitForChange(uint32_t change_count,
+                                         const TimeInterval &timeout) const {
+  if (ChangeCount() != change_count) {
+    return true;
+  }
+
+#ifdef HAVE_LINUX_FUTEX_H
+  if (m_can_wait) {
+    struct timespec wait_time;
+    wait_time.tv_sec = timeout.Seconds();
+    wait_time.tv_nsec = timeout.MicroSeconds() * ONE_THOUSAND;
+    __sync_add_and_fetch(&m_header->waiters, 1);
+    // This returns straight away if the count has already changed.
+    syscall(SYS_futex, &m_header->change_count, FUTEX_WAIT, change_count,
+            &wait_time, NULL, 0);
+    __sync_sub_and_fetch(&m_header->waiters, 1);
+    return ChangeCount() != change_count;
+  }
+#endif  // HAVE_LINUX_FUTEX_H
+
+  Clock clock;
+  TimeStamp now, deadline;
+  clock.CurrentTime(&now);
+  deadline = now + timeout;
+  while (ChangeCount() == change_count && now < deadline) {
+    usleep(POLL_INTERVAL_US);
+    clock.CurrentTime(&now);
+  }
+  return ChangeCount() != change_count;
+}
+
+UniverseSharedMemory::UniverseSharedMemory(const string &name, void *memory,
+                                           size_t size,
+                                           unsigned int slot_count,
+                                           bool writer, bool can_wait)
+    : m_name(name),
+      m_memory(memory),
+      m_size(size),
+      m_slot_count(slot_count),
+      m_writer(writer),
+      m_can_wait(can_wait),
+      m_header(reinterpret_cast<Header*>(memory)),
+      m_slots(reinterpret_cast<Slot*>(
+            reinterpret_cast<uint8_t*>(memory) + sizeof(Header))),
+      m_full_logged(false) {
+}
+
+size_t UniverseSharedMemory::SegmentSize(unsigned int slot_count) {
+  return sizeof(Header) + slot_count * sizeof(Slot);
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,161 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UniverseSharedMemoryTest.cpp
+ * Test fixture for the UniverseSharedMemory class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/dmx/UniverseSharedMemory.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::dmx::UniverseSharedMemory;
+using std::auto_ptr;
+using std::string;
+
+class UniverseSharedMemoryTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UniverseSharedMemoryTest);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testFull);
+  CPPUNIT_TEST(testWaitForChange);
+  CPPUNIT_TEST(testInvalid);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testReadWrite();
+  void testFull();
+  void testWaitForChange();
+  void testInvalid();
+
+ private:
+  string m_name;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UniverseSharedMemoryTest);
+
+void UniverseSharedMemoryTest::setUp() {
+  std::ostringstream str;
+  str << UniverseSharedMemory::DEFAULT_NAME << "-test-" << getpid();
+  m_name = str.str();
+}
+
+void UniverseSharedMemoryTest::tearDown() {
+  auto_ptr<UniverseSharedMemory> memory(UniverseSharedMemory::Open(m_name));
+  if (memory.get()) {
+    memory->Unlink();
+  }
+}
+
+/*
+ * Check the frames written by olad can be read by more than one reader.
+ */
+void UniverseSharedMemoryTest::testReadWrite() {
+  auto_ptr<UniverseSharedMemory> writer(UniverseSharedMemory::Create(m_name,
+                                                                     4));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<UniverseSharedMemory> reader1(UniverseSharedMemory::Open(m_name));
+  auto_ptr<UniverseSharedMemory> reader2(UniverseSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader1.get());
+  OLA_ASSERT_NOT_NULL(reader2.get());
+  OLA_ASSERT_EQ(4u, reader1->SlotCount());
+  OLA_ASSERT_EQ(0u, reader1->ChangeCount());
+  OLA_ASSERT_EQ(-1, reader1->FindSlot(1));
+
+  UniverseSharedMemory::Frame frame;
+  OLA_ASSERT_FALSE(reader1->Read(0, &frame));
+
+  OLA_ASSERT_TRUE(writer->Write(10, 100, DmxBuffer("abc")));
+  OLA_ASSERT_TRUE(writer->Write(20, 150, DmxBuffer("xyz")));
+  OLA_ASSERT_EQ(2u, reader1->ChangeCount());
+  OLA_ASSERT_EQ(0, reader1->FindSlot(10));
+  OLA_ASSERT_EQ(1, reader1->FindSlot(20));
+  OLA_ASSERT_EQ(1, writer->FindSlot(20));
+
+  OLA_ASSERT_TRUE(reader1->Read(1, &frame));
+  OLA_ASSERT_EQ(20u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), frame.priority);
+  OLA_ASSERT_EQ(DmxBuffer("xyz"), frame.data);
+  const uint32_t sequence = frame.sequence;
+
+  // The universe keeps its slot.
+  OLA_ASSERT_TRUE(writer->Write(20, 150, DmxBuffer("xyzzy")));
+  OLA_ASSERT_EQ(1, reader2->FindSlot(20));
+  OLA_ASSERT_TRUE(reader2->Read(1, &frame));
+  OLA_ASSERT_EQ(DmxBuffer("xyzzy"), frame.data);
+  OLA_ASSERT_NE(sequence, frame.sequence);
+
+  OLA_ASSERT_TRUE(reader1->Read(0, &frame));
+  OLA_ASSERT_EQ(10u, frame.universe);
+  OLA_ASSERT_EQ(DmxBuffer("abc"), frame.data);
+  OLA_ASSERT_FALSE(reader1->Read(4, &frame));
+
+  // Readers can't write
+  OLA_ASSERT_FALSE(reader1->Write(30, 100, DmxBuffer("abc")));
+}
+
+/*
+ * Check writes fail once all the slots are in use.
+ */
+void UniverseSharedMemoryTest::testFull() {
+  auto_ptr<UniverseSharedMemory> writer(UniverseSharedMemory::Create(m_name,
+                                                                     2));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  OLA_ASSERT_TRUE(writer->Write(1, 100, DmxBuffer("abc")));
+  OLA_ASSERT_TRUE(writer->Write(2, 100, DmxBuffer("abc")));
+  OLA_ASSERT_FALSE(writer->Write(3, 100, DmxBuffer("abc")));
+  OLA_ASSERT_TRUE(writer->Write(1, 100, DmxBuffer("def")));
+  OLA_ASSERT_EQ(3u, writer->ChangeCount());
+}
+
+/*
+ * Check WaitForChange() returns once the count has moved, or it times out.
+ */
+void UniverseSharedMemoryTest::testWaitForChange() {
+  auto_ptr<UniverseSharedMemory> writer(UniverseSharedMemory::Create(m_name,
+                                                                     2));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<UniverseSharedMemory> reader(UniverseSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  const uint32_t count = reader->ChangeCount();
+  OLA_ASSERT_FALSE(reader->WaitForChange(count, TimeInterval(10000)));
+  OLA_ASSERT_TRUE(writer->Write(1, 100, DmxBuffer("abc")));
+  OLA_ASSERT_TRUE(reader->WaitForChange(count, TimeInterval(10000)));
+  OLA_ASSERT_FALSE(reader->WaitForChange(reader->ChangeCount(),
+                                         TimeInterval(1000)));
+}
+
+/*
+ * Check invalid segments are rejected.
+ */
+void UniverseSharedMemoryTest::testInvalid() {
+  OLA_ASSERT_NULL(UniverseSharedMemory::Open(m_name));
+  OLA_ASSERT_NULL(UniverseSharedMemory::Create(m_name, 0));
+  OLA_ASSERT_NULL(UniverseSharedMemory::Create(
+      m_name, UniverseSharedMemory::MAX_SLOTS + 1));
+}
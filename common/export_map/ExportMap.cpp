@@ -30,10 +30,104 @@
 namespace ola {
 
 using std::map;
+using std::ostream;
 using std::ostringstream;
 using std::string;
 using std::vector;
 
+const unsigned int HistogramVariable::PERCENTILES[] = {50, 90, 99};
+const unsigned int HistogramVariable::PERCENTILE_COUNT;
+
+const char ExportMap::OPEN_METRICS_CONTENT_TYPE[] =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+namespace {
+
+/*
+ * Metric and label names are limited to [a-zA-Z_:][a-zA-Z0-9_:]*
+ */
+string MetricName(const string &name) {
+  string output = name;
+  for (unsigned int i = 0; i < output.size(); i++) {
+    char c = output[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+          (c >= '0' && c <= '9') || c == '_' || c == ':')) {
+      output[i] = '_';
+    }
+  }
+  if (output.empty() || (output[0] >= '0' && output[0] <= '9')) {
+    output.insert(0, "_");
+  }
+  return output;
+}
+
+string LabelValue(const string &value) {
+  string output;
+  output.reserve(value.size());
+  for (unsigned int i = 0; i < value.size(); i++) {
+    switch (value[i]) {
+      case '\\':
+        output.append("\\\\");
+        break;
+      case '"':
+        output.append("\\\"");
+        break;
+      case '\n':
+        output.append("\\n");
+        break;
+      default:
+        output.push_back(value[i]);
+    }
+  }
+  return output;
+}
+
+string LabelName(const string &label) {
+  return label.empty() ? "key" : MetricName(label);
+}
+
+void WriteType(const string &name, const char *type, ostream *output) {
+  *output << "# TYPE " << name << " " << type << "\n";
+}
+
+template<typename Type>
+void WriteGauges(const map<string, Type*> &variables, ostream *output) {
+  typename map<string, Type*>::const_iterator iter = variables.begin();
+  for (; iter != variables.end(); ++iter) {
+    const string name = MetricName(iter->first);
+    WriteType(name, "gauge", output);
+    *output << name << " " << iter->second->Get() << "\n";
+  }
+}
+
+template<typename Type>
+void WriteMapGauges(const map<string, Type*> &variables, ostream *output) {
+  typename map<string, Type*>::const_iterator iter = variables.begin();
+  for (; iter != variables.end(); ++iter) {
+    const string name = MetricName(iter->first);
+    const string label = LabelName(iter->second->Label());
+    WriteType(name, "gauge", output);
+    typename Type::const_iterator entry = iter->second->begin();
+    for (; entry != iter->second->end(); ++entry) {
+      *output << name << "{" << label << "=\"" << LabelValue(entry->first)
+              << "\"} " << entry->second << "\n";
+    }
+  }
+}
+}  // namespace
+
+
+const string HistogramVariable::Value() const {
+  ostringstream value;
+  value << "count:" << m_histogram.Count();
+  for (unsigned int i = 0; i < PERCENTILE_COUNT; i++) {
+    value << " p" << PERCENTILES[i] << ":"
+          << m_histogram.Percentile(PERCENTILES[i]);
+  }
+  value << " max:" << m_histogram.Max();
+  return value.str();
+}
+
 ExportMap::~ExportMap() {
   STLDeleteValues(&m_bool_variables);
   STLDeleteValues(&m_counter_variables);
@@ -42,6 +136,7 @@ ExportMap::~ExportMap() {
   STLDeleteValues(&m_str_map_variables);
   STLDeleteValues(&m_string_variables);
   STLDeleteValues(&m_uint_map_variables);
+  STLDeleteValues(&m_histogram_variables);
 }
 
 BoolVariable *ExportMap::GetBoolVar(const string &name) {
@@ -94,6 +189,11 @@ UIntMap *ExportMap::GetUIntMapVar(const string &name, const string &label) {
 }
 
 
+HistogramVariable *ExportMap::GetHistogramVar(const string &name) {
+  return GetVar(&m_histogram_variables, name);
+}
+
+
 /*
  * Return a list of all variables.
  * @return a vector of all variables.
@@ -107,12 +207,68 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
   STLValues(m_str_map_variables, &variables);
   STLValues(m_string_variables, &variables);
   STLValues(m_uint_map_variables, &variables);
+  STLValues(m_histogram_variables, &variables);
 
   sort(variables.begin(), variables.end(), VariableLessThan());
   return variables;
 }
 
 
+void ExportMap::ExportOpenMetrics(ostream *output) const {
+  WriteGauges(m_bool_variables, output);
+  WriteGauges(m_int_variables, output);
+  WriteMapGauges(m_int_map_variables, output);
+  WriteMapGauges(m_uint_map_variables, output);
+
+  map<string, CounterVariable*>::const_iterator counter_iter;
+  for (counter_iter = m_counter_variables.begin();
+       counter_iter != m_counter_variables.end(); ++counter_iter) {
+    const string name = MetricName(counter_iter->first);
+    WriteType(name, "counter", output);
+    *output << name << "_total " << counter_iter->second->Get() << "\n";
+  }
+
+  map<string, StringVariable*>::const_iterator string_iter;
+  for (string_iter = m_string_variables.begin();
+       string_iter != m_string_variables.end(); ++string_iter) {
+    const string name = MetricName(string_iter->first);
+    WriteType(name, "info", output);
+    *output << name << "_info{value=\""
+            << LabelValue(string_iter->second->Get()) << "\"} 1\n";
+  }
+
+  map<string, StringMap*>::const_iterator str_map_iter;
+  for (str_map_iter = m_str_map_variables.begin();
+       str_map_iter != m_str_map_variables.end(); ++str_map_iter) {
+    const string name = MetricName(str_map_iter->first);
+    const string label = LabelName(str_map_iter->second->Label());
+    WriteType(name, "info", output);
+    StringMap::const_iterator entry = str_map_iter->second->begin();
+    for (; entry != str_map_iter->second->end(); ++entry) {
+      *output << name << "_info{" << label << "=\""
+              << LabelValue(entry->first) << "\",value=\""
+              << LabelValue(entry->second) << "\"} 1\n";
+    }
+  }
+
+  map<string, HistogramVariable*>::const_iterator histogram_iter;
+  for (histogram_iter = m_histogram_variables.begin();
+       histogram_iter != m_histogram_variables.end(); ++histogram_iter) {
+    const string name = MetricName(histogram_iter->first);
+    const Histogram &histogram = histogram_iter->second->Get();
+    WriteType(name, "summary", output);
+    for (unsigned int i = 0; i < HistogramVariable::PERCENTILE_COUNT; i++) {
+      const unsigned int percentile = HistogramVariable::PERCENTILES[i];
+      *output << name << "{quantile=\"" << percentile / 100.0 << "\"} "
+              << histogram.Percentile(percentile) << "\n";
+    }
+    *output << name << "_sum " << histogram.Sum() << "\n";
+    *output << name << "_count " << histogram.Count() << "\n";
+  }
+  *output << "# EOF\n";
+}
+
+
 template<typename Type>
 Type *ExportMap::GetVar(map<string, Type*> *var_map, const string &name) {
   typename map<string, Type*>::iterator iter;
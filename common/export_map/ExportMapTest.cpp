@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -29,10 +30,13 @@ using ola::BaseVariable;
 using ola::BoolVariable;
 using ola::CounterVariable;
 using ola::ExportMap;
+using ola::HistogramVariable;
 using ola::IntMap;
 using ola::IntegerVariable;
 using ola::StringMap;
 using ola::StringVariable;
+using ola::UIntMap;
+using std::ostringstream;
 using std::string;
 using std::vector;
 
@@ -45,7 +49,10 @@ class ExportMapTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBoolVariable);
   CPPUNIT_TEST(testStringMapVariable);
   CPPUNIT_TEST(testIntMapVariable);
+  CPPUNIT_TEST(testUIntMapHandle);
+  CPPUNIT_TEST(testHistogramVariable);
   CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST(testOpenMetrics);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -55,7 +62,10 @@ class ExportMapTest: public CppUnit::TestFixture {
     void testBoolVariable();
     void testStringMapVariable();
     void testIntMapVariable();
+    void testUIntMapHandle();
+    void testHistogramVariable();
     void testExportMap();
+    void testOpenMetrics();
 };
 
 
@@ -211,8 +221,68 @@ void ExportMapTest::testIntMapVariable() {
   // check increments work
   var.Increment(key1);
   OLA_ASSERT_EQ(var.Value(), string("map:count key1:1"));
+
+  // check iteration
+  var[key2] = 5;
+  IntMap::const_iterator iter = var.begin();
+  OLA_ASSERT_EQ(key1, iter->first);
+  OLA_ASSERT_EQ(1, iter->second);
+  ++iter;
+  OLA_ASSERT_EQ(key2, iter->first);
+  OLA_ASSERT_EQ(5, iter->second);
+  ++iter;
+  OLA_ASSERT_TRUE(iter == var.end());
+}
+
+
+/*
+ * Check that UIntMap handles update the map.
+ */
+void ExportMapTest::testUIntMapHandle() {
+  UIntMap var("foo", "count");
+  UIntMap::Handle handle = var.GetHandle("1");
+  OLA_ASSERT_TRUE(handle.IsValid());
+  OLA_ASSERT_EQ(0u, var["1"]);
+
+  handle.Increment();
+  handle.Increment();
+  OLA_ASSERT_EQ(2u, var["1"]);
+  handle.Decrement();
+  OLA_ASSERT_EQ(1u, var["1"]);
+  handle.Set(10);
+  OLA_ASSERT_EQ(string("map:count 1:10"), var.Value());
+
+  // Handles stay valid as other entries are added
+  var.Increment("2");
+  handle.Increment();
+  OLA_ASSERT_EQ(string("map:count 1:11 2:1"), var.Value());
+
+  // A default handle ignores updates
+  UIntMap::Handle empty;
+  OLA_ASSERT_FALSE(empty.IsValid());
+  empty.Increment();
+  empty.Set(4);
+}
+
+
+/*
+ * Check that the HistogramVariable works correctly.
+ */
+void ExportMapTest::testHistogramVariable() {
+  HistogramVariable var("foo");
+  OLA_ASSERT_EQ(string("count:0 p50:0 p90:0 p99:0 max:0"), var.Value());
+
+  for (uint32_t i = 1; i <= 10; i++) {
+    var.Add(i);
+  }
+  OLA_ASSERT_EQ(string("count:10 p50:5 p90:9 p99:10 max:10"), var.Value());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(55), var.Get().Sum());
+
+  var.Reset();
+  OLA_ASSERT_EQ(string("count:0 p50:0 p90:0 p99:0 max:0"), var.Value());
 }
 
+
 /*
  * Check the export map works correctly.
  */
@@ -241,3 +311,50 @@ void ExportMapTest::testExportMap() {
   vector<BaseVariable*> variables = map.AllVariables();
   OLA_ASSERT_EQ(variables.size(), (size_t) 4);
 }
+
+
+/*
+ * Check the OpenMetrics output.
+ */
+void ExportMapTest::testOpenMetrics() {
+  ExportMap map;
+  map.GetBoolVar("bool-var")->Set(true);
+  map.GetIntegerVar("int_var")->Set(-4);
+  (*map.GetCounterVar("rpc-received"))++;
+  map.GetStringVar("version")->Set("0.10 \"beta\"");
+  map.GetStringMapVar("universe-name", "universe")->Set("1", "Stage");
+  UIntMap *uint_map = map.GetUIntMapVar("universe-dmx-frames", "universe");
+  uint_map->Set("1", 10);
+  uint_map->Set("2", 20);
+  map.GetIntMapVar("9lives")->Set("a", 1);
+  HistogramVariable *histogram = map.GetHistogramVar("latency");
+  histogram->Add(1);
+  histogram->Add(2);
+
+  ostringstream str;
+  map.ExportOpenMetrics(&str);
+  const string expected =
+      "# TYPE bool_var gauge\n"
+      "bool_var 1\n"
+      "# TYPE int_var gauge\n"
+      "int_var -4\n"
+      "# TYPE _9lives gauge\n"
+      "_9lives{key=\"a\"} 1\n"
+      "# TYPE universe_dmx_frames gauge\n"
+      "universe_dmx_frames{universe=\"1\"} 10\n"
+      "universe_dmx_frames{universe=\"2\"} 20\n"
+      "# TYPE rpc_received counter\n"
+      "rpc_received_total 1\n"
+      "# TYPE version info\n"
+      "version_info{value=\"0.10 \\\"beta\\\"\"} 1\n"
+      "# TYPE universe_name info\n"
+      "universe_name_info{universe=\"1\",value=\"Stage\"} 1\n"
+      "# TYPE latency summary\n"
+      "latency{quantile=\"0.5\"} 1\n"
+      "latency{quantile=\"0.9\"} 2\n"
+      "latency{quantile=\"0.99\"} 2\n"
+      "latency_sum 3\n"
+      "latency_count 2\n"
+      "# EOF\n";
+  OLA_ASSERT_EQ(expected, str.str());
+}
@@ -22,20 +22,37 @@
 #include <config.h>
 #endif  // HAVE_CONFIG_H
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/base/Array.h>
 #include <ola/base/Macro.h>
 #include <ola/file/Util.h>
 #include <ola/http/HTTPServer.h>
+#include <ola/http/WebSocket.h>
 #include <ola/io/Descriptor.h>
+#include <ola/network/TCPSocket.h>
+#include <ola/stl/STLUtils.h>
 #include <ola/web/Json.h>
 #include <ola/web/JsonWriter.h>
 
 #ifdef _WIN32
 #include <ola/win/CleanWinSock2.h>
+#else
+#include <unistd.h>
 #endif  // _WIN32
 
-#include <fstream>
+// We hand a dup() of the upgraded socket to the SelectServer, which doesn't
+// work on Windows.
+#if defined(HAVE_MHD_CREATE_RESPONSE_FOR_UPGRADE) && !defined(_WIN32)
+#define OLA_HAVE_WEBSOCKETS 1
+#endif
+
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <set>
@@ -61,7 +78,6 @@ class UnmanagedSocketDescriptor : public ola::io::UnmanagedFileDescriptor {
 };
 #endif  // _WIN32
 
-using std::ifstream;
 using std::map;
 using std::pair;
 using std::set;
@@ -82,6 +98,14 @@ const char HTTPServer::CONTENT_TYPE_OCT[] = "application/octet-stream";
 const char HTTPServer::CONTENT_TYPE_JSON[] = "application/json";
 const char HTTPServer::CONTENT_TYPE_XML[] = "application/xml";
 
+// The pre-compressed copies of static files we look for, in order of
+// preference.
+const HTTPServer::PrecompressedEncoding
+    HTTPServer::PRECOMPRESSED_ENCODINGS[] = {
+  {"br", ".br"},
+  {"gzip", ".gz"},
+};
+
 /**
  * @brief Called by MHD_get_connection_values to add headers to a request
  *     object.
@@ -183,6 +207,26 @@ static int HandleRequest(void *http_server_ptr,
 }
 
 
+#ifdef OLA_HAVE_WEBSOCKETS
+/**
+ * @brief Called once a WebSocket handshake has been sent.
+ *
+ * This passes the socket to HTTPServer::StartWebSocket.
+ */
+static void HandleUpgrade(void *http_server_ptr,
+                          struct MHD_Connection*,
+                          void *request_ptr,
+                          const char *extra_in,
+                          size_t extra_in_size,
+                          MHD_socket socket,
+                          struct MHD_UpgradeResponseHandle *handle) {
+  HTTPServer *http_server = static_cast<HTTPServer*>(http_server_ptr);
+  http_server->StartWebSocket(static_cast<HTTPRequest*>(request_ptr),
+                              socket, handle, extra_in, extra_in_size);
+}
+#endif  // OLA_HAVE_WEBSOCKETS
+
+
 /**
  * @brief Called when a request completes.
  *
@@ -227,11 +271,12 @@ bool HTTPRequest::Init() {
   MHD_get_connection_values(m_connection, MHD_HEADER_KIND, AddHeaders, this);
 
   if (m_method == MHD_HTTP_METHOD_POST) {
+    // This fails if the body isn't form encoded, in which case we keep the
+    // raw body instead.
     m_processor = MHD_create_post_processor(m_connection,
                                             K_POST_BUFFER_SIZE,
                                             IteratePost,
                                             static_cast<void*>(this));
-    return m_processor;
   }
   return true;
 }
@@ -281,7 +326,13 @@ void HTTPRequest::AddPostParameter(const string &key, const string &value) {
  * @brief Process post data
  */
 void HTTPRequest::ProcessPostData(const char *data, size_t *data_size) {
-  MHD_post_process(m_processor, data, *data_size);
+  if (m_processor) {
+    MHD_post_process(m_processor, data, *data_size);
+  } else if (m_body.size() < K_MAX_BODY_SIZE) {
+    m_body.append(data, std::min(*data_size,
+                                 static_cast<size_t>(K_MAX_BODY_SIZE -
+                                                     m_body.size())));
+  }
 }
 
 
@@ -466,6 +517,7 @@ HTTPServer::~HTTPServer() {
   }
 
   m_handlers.clear();
+  STLDeleteValues(&m_websocket_handlers);
 }
 
 
@@ -479,7 +531,12 @@ bool HTTPServer::Init() {
     return false;
   }
 
-  m_httpd = MHD_start_daemon(MHD_NO_FLAG,
+  unsigned int flags = MHD_NO_FLAG;
+#ifdef OLA_HAVE_WEBSOCKETS
+  flags |= MHD_USE_SUSPEND_RESUME | MHD_ALLOW_UPGRADE;
+#endif  // OLA_HAVE_WEBSOCKETS
+
+  m_httpd = MHD_start_daemon(flags,
                              m_port,
                              NULL,
                              NULL,
@@ -525,6 +582,20 @@ void *HTTPServer::Run() {
     FreeSocket(*iter);
   }
   m_sockets.clear();
+
+  // and any WebSockets, letting the handlers know they've gone.
+  m_closed_websockets.clear();
+  set<WebSocketState*>::iterator ws_iter = m_websockets.begin();
+  for (; ws_iter != m_websockets.end(); ++ws_iter) {
+    WebSocketState *state = *ws_iter;
+    if (state->on_close) {
+      ola::SingleUseCallback0<void> *on_close = state->on_close;
+      state->on_close = NULL;
+      on_close->Run();
+    }
+    FreeWebSocket(state);
+  }
+  m_websockets.clear();
   return NULL;
 }
 
@@ -548,6 +619,8 @@ void HTTPServer::Stop() {
  * SelectServer from MHD.
  */
 void HTTPServer::UpdateSockets() {
+  FreeClosedWebSockets();
+
   // We always call MHD_run so we send any queued responses. This isn't
   // inefficient because the only thing that can wake up the select server is
   // activity on a http socket or the client socket. The latter almost always
@@ -628,6 +701,10 @@ void HTTPServer::UpdateSockets() {
  */
 int HTTPServer::DispatchRequest(const HTTPRequest *request,
                                 HTTPResponse *response) {
+  if (STLContains(m_websocket_handlers, request->Url())) {
+    return UpgradeToWebSocket(request, response);
+  }
+
   map<string, BaseHTTPCallback*>::iterator iter =
     m_handlers.find(request->Url());
 
@@ -668,6 +745,80 @@ bool HTTPServer::RegisterHandler(const string &path,
 }
 
 
+/**
+ * @brief Register a WebSocket handler.
+ * @param path the url to accept WebSocket connections on.
+ * @param handler the callback to run for each new connection. These will be
+ * freed once the HTTPServer is destroyed.
+ * @returns false if the path is already registered. If WebSocketsSupported()
+ * is false, requests for the path are answered with a 501.
+ */
+bool HTTPServer::RegisterWebSocketHandler(const string &path,
+                                          WebSocketCallback *handler) {
+  return STLInsertIfNotPresent(&m_websocket_handlers, path, handler);
+}
+
+
+/**
+ * @brief Check if this build of the server can accept WebSockets.
+ */
+bool HTTPServer::WebSocketsSupported() {
+#ifdef OLA_HAVE_WEBSOCKETS
+  return true;
+#else
+  return false;
+#endif  // OLA_HAVE_WEBSOCKETS
+}
+
+
+/**
+ * @brief Take over a socket once the WebSocket handshake has been sent.
+ * @param request the request that asked for the upgrade.
+ * @param fd the socket.
+ * @param handle the handle to release the socket with.
+ * @param extra_data any data that arrived after the handshake.
+ * @param extra_data_size the size of the extra data.
+ *
+ * microhttpd closes the socket once we release the handle, so we use a copy
+ * of it, and release the handle once the connection has closed.
+ */
+void HTTPServer::StartWebSocket(const HTTPRequest *request,
+                                int fd,
+                                struct MHD_UpgradeResponseHandle *handle,
+                                const char *extra_data,
+                                size_t extra_data_size) {
+#ifdef OLA_HAVE_WEBSOCKETS
+  WebSocketCallback *handler = STLFindOrNull(m_websocket_handlers,
+                                             request->Url());
+  int our_fd = handler ? dup(fd) : -1;
+  if (our_fd < 0) {
+    OLA_WARN << "Failed to start WebSocket for " << request->Url();
+    MHD_upgrade_action(handle, MHD_UPGRADE_ACTION_CLOSE);
+    return;
+  }
+
+  ola::network::TCPSocket *socket = new ola::network::TCPSocket(our_fd);
+  socket->SetReadNonBlocking();
+  WebSocketState *state = new WebSocketState(
+      new WebSocketConnection(socket, m_select_server.get()), handle);
+  m_websockets.insert(state);
+
+  handler->Run(request, state->connection);
+  state->on_close = state->connection->TransferOnClose();
+  state->connection->SetOnClose(
+      NewSingleCallback(this, &HTTPServer::WebSocketClosed, state));
+  state->connection->Start(reinterpret_cast<const uint8_t*>(extra_data),
+                           extra_data_size);
+#else
+  (void) request;
+  (void) fd;
+  (void) handle;
+  (void) extra_data;
+  (void) extra_data_size;
+#endif  // OLA_HAVE_WEBSOCKETS
+}
+
+
 /**
  * @brief Register a static file. The root of the URL corresponds to the data dir.
  * @param path the URL path for the file e.g. '/foo.png'
@@ -734,8 +885,100 @@ void HTTPServer::Handlers(vector<string> *handlers) const {
        file_iter != m_static_content.end(); ++file_iter) {
     handlers->push_back(file_iter->first);
   }
+
+  map<string, WebSocketCallback*>::const_iterator ws_iter;
+  for (ws_iter = m_websocket_handlers.begin();
+       ws_iter != m_websocket_handlers.end(); ++ws_iter) {
+    handlers->push_back(ws_iter->first);
+  }
 }
 
+/**
+ * @brief Reply to a WebSocket handshake.
+ */
+int HTTPServer::UpgradeToWebSocket(const HTTPRequest *request,
+                                   HTTPResponse *response) {
+#ifdef OLA_HAVE_WEBSOCKETS
+  const char *upgrade = MHD_lookup_connection_value(
+      response->Connection(), MHD_HEADER_KIND, MHD_HTTP_HEADER_UPGRADE);
+  const char *key = MHD_lookup_connection_value(
+      response->Connection(), MHD_HEADER_KIND, "Sec-WebSocket-Key");
+  const char *version = MHD_lookup_connection_value(
+      response->Connection(), MHD_HEADER_KIND, "Sec-WebSocket-Version");
+
+  string upgrade_protocol = upgrade ? upgrade : "";
+  ToLower(&upgrade_protocol);
+  if (request->Method() != MHD_HTTP_METHOD_GET ||
+      upgrade_protocol != "websocket" || !key || !version ||
+      string(version) != "13") {
+    response->SetStatus(MHD_HTTP_BAD_REQUEST);
+    response->SetHeader("Sec-WebSocket-Version", "13");
+    response->SetContentType(CONTENT_TYPE_HTML);
+    response->Append("<b>400 Bad Request</b> Expected a WebSocket handshake");
+    int r = response->Send();
+    delete response;
+    return r;
+  }
+
+  struct MHD_Response *mhd_response = MHD_create_response_for_upgrade(
+      &HandleUpgrade, this);
+  MHD_add_response_header(mhd_response, MHD_HTTP_HEADER_UPGRADE, "websocket");
+  MHD_add_response_header(mhd_response, "Sec-WebSocket-Accept",
+                          WebSocketConnection::AcceptKey(key).c_str());
+  int ret = MHD_queue_response(response->Connection(),
+                               MHD_HTTP_SWITCHING_PROTOCOLS,
+                               mhd_response);
+  MHD_destroy_response(mhd_response);
+  delete response;
+  return ret;
+#else
+  (void) request;
+  response->SetStatus(MHD_HTTP_NOT_IMPLEMENTED);
+  response->SetContentType(CONTENT_TYPE_HTML);
+  response->Append("<b>501 Not Implemented</b> WebSockets aren't supported");
+  int r = response->Send();
+  delete response;
+  return r;
+#endif  // OLA_HAVE_WEBSOCKETS
+}
+
+
+/**
+ * @brief Called when a WebSocket closes.
+ *
+ * We're within the connection's callbacks here, so it's freed on the next
+ * loop iteration.
+ */
+void HTTPServer::WebSocketClosed(WebSocketState *state) {
+  if (state->on_close) {
+    ola::SingleUseCallback0<void> *on_close = state->on_close;
+    state->on_close = NULL;
+    on_close->Run();
+  }
+  m_closed_websockets.push_back(state);
+}
+
+
+void HTTPServer::FreeClosedWebSockets() {
+  vector<WebSocketState*>::iterator iter = m_closed_websockets.begin();
+  for (; iter != m_closed_websockets.end(); ++iter) {
+    m_websockets.erase(*iter);
+    FreeWebSocket(*iter);
+  }
+  m_closed_websockets.clear();
+}
+
+
+void HTTPServer::FreeWebSocket(WebSocketState *state) {
+  delete state->on_close;
+  delete state->connection;
+#ifdef OLA_HAVE_WEBSOCKETS
+  MHD_upgrade_action(state->handle, MHD_UPGRADE_ACTION_CLOSE);
+#endif  // OLA_HAVE_WEBSOCKETS
+  delete state;
+}
+
+
 /**
  * @brief Serve an error.
  * @param response the reponse to use.
@@ -796,42 +1039,112 @@ int HTTPServer::ServeStaticContent(const std::string &path,
 }
 
 
+/**
+ * @brief Check if an Accept-Encoding header allows an encoding.
+ * @param accept_encoding the value of the Accept-Encoding header.
+ * @param encoding the content-coding, e.g. gzip.
+ * @returns true if the encoding is listed, or matched by *, without a q value
+ *   of 0.
+ */
+bool HTTPServer::AcceptsEncoding(const string &accept_encoding,
+                                 const string &encoding) {
+  // An explicit entry for the encoding takes precedence over *.
+  bool wildcard = false;
+  vector<string> codings;
+  StringSplit(accept_encoding, &codings, ",");
+  vector<string>::iterator iter = codings.begin();
+  for (; iter != codings.end(); ++iter) {
+    vector<string> params;
+    StringSplit(*iter, &params, ";");
+    string coding = params[0];
+    StringTrim(&coding);
+    ToLower(&coding);
+    if (coding != encoding && coding != "*") {
+      continue;
+    }
+
+    bool allowed = true;
+    for (unsigned int i = 1; i < params.size(); i++) {
+      string param = params[i];
+      StringTrim(&param);
+      if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') &&
+          param[1] == '=') {
+        // q=0, q=0.0 etc. mean not acceptable.
+        allowed = param.find_first_not_of("0.", 2) != string::npos;
+      }
+    }
+    if (coding == encoding) {
+      return allowed;
+    }
+    wildcard = allowed;
+  }
+  return wildcard;
+}
+
+
 /**
  * @brief Serve static content.
  * @param file_info details on the file to server
  * @param response the response to use
+ *
+ * If the client accepts it, and there is a pre-compressed copy of the file
+ * (file.br or file.gz) that's at least as new as the file itself, the
+ * compressed copy is sent instead, see olad/www/Makefile.mk.
  */
 int HTTPServer::ServeStaticContent(static_file_info *file_info,
                                    HTTPResponse *response) {
-  char *data;
-  unsigned int length;
   string file_path = m_data_dir;
   file_path.push_back(ola::file::PATH_SEPARATOR);
   file_path.append(file_info->file_path);
-  ifstream i_stream(file_path.c_str(), ifstream::binary);
 
-  if (!i_stream.is_open()) {
+  StaticFile file;
+  if (!OpenStaticFile(file_path, &file)) {
     OLA_WARN << "Missing file: " << file_path;
     return ServeNotFound(response);
   }
 
-  i_stream.seekg(0, std::ios::end);
-  length = i_stream.tellg();
-  i_stream.seekg(0, std::ios::beg);
-
-  data = static_cast<char*>(malloc(length));
-
-  i_stream.read(data, length);
-  i_stream.close();
+  const char *accept_encoding = MHD_lookup_connection_value(
+      response->Connection(), MHD_HEADER_KIND,
+      MHD_HTTP_HEADER_ACCEPT_ENCODING);
+  const char *content_encoding = NULL;
+  if (accept_encoding) {
+    for (unsigned int i = 0; i < arraysize(PRECOMPRESSED_ENCODINGS); i++) {
+      const PrecompressedEncoding &encoding = PRECOMPRESSED_ENCODINGS[i];
+      if (!AcceptsEncoding(accept_encoding, encoding.name)) {
+        continue;
+      }
+      StaticFile compressed;
+      if (!OpenStaticFile(file_path + encoding.suffix, &compressed)) {
+        continue;
+      }
+      if (compressed.mtime < file.mtime) {
+        CloseStaticFile(&compressed);
+        continue;
+      }
+      CloseStaticFile(&file);
+      file = compressed;
+      content_encoding = encoding.name;
+      break;
+    }
+  }
 
-  struct MHD_Response *mhd_response = BuildResponse(static_cast<void*>(data),
-                                                    length);
+  struct MHD_Response *mhd_response = StaticFileResponse(&file);
+  if (!mhd_response) {
+    return ServeError(response, "Failed to read " + file_info->file_path);
+  }
 
   if (!file_info->content_type.empty()) {
     MHD_add_response_header(mhd_response,
                             MHD_HTTP_HEADER_CONTENT_TYPE,
                             file_info->content_type.c_str());
   }
+  if (content_encoding) {
+    MHD_add_response_header(mhd_response,
+                            MHD_HTTP_HEADER_CONTENT_ENCODING,
+                            content_encoding);
+  }
+  MHD_add_response_header(mhd_response, MHD_HTTP_HEADER_VARY,
+                          MHD_HTTP_HEADER_ACCEPT_ENCODING);
 
   int ret = MHD_queue_response(response->Connection(),
                                MHD_HTTP_OK,
@@ -841,6 +1154,79 @@ int HTTPServer::ServeStaticContent(static_file_info *file_info,
   return ret;
 }
 
+
+/**
+ * @brief Open a file to serve.
+ * @returns false if the file doesn't exist or isn't a regular file.
+ */
+bool HTTPServer::OpenStaticFile(const string &path, StaticFile *file) {
+#ifdef _WIN32
+  int fd = open(path.c_str(), O_RDONLY | O_BINARY);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+#endif  // _WIN32
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) || !S_ISREG(file_stat.st_mode)) {
+    close(fd);
+    return false;
+  }
+  file->fd = fd;
+  file->size = file_stat.st_size;
+  file->mtime = file_stat.st_mtime;
+  return true;
+}
+
+
+void HTTPServer::CloseStaticFile(StaticFile *file) {
+  if (file->fd >= 0) {
+    close(file->fd);
+    file->fd = -1;
+  }
+}
+
+
+/**
+ * @brief Build the response for a file opened with OpenStaticFile().
+ *
+ * Where we can, libmicrohttpd takes ownership of the fd and sends the file
+ * with sendfile(), so it's never copied into memory. Otherwise the file is read
+ * into a buffer and closed.
+ */
+struct MHD_Response *HTTPServer::StaticFileResponse(StaticFile *file) {
+#if defined(HAVE_MHD_CREATE_RESPONSE_FROM_FD_AT_OFFSET64) && !defined(_WIN32)
+  struct MHD_Response *response = MHD_create_response_from_fd_at_offset64(
+      file->size, file->fd, 0);
+  if (response) {
+    file->fd = -1;
+  } else {
+    CloseStaticFile(file);
+  }
+  return response;
+#else
+  char *data = static_cast<char*>(malloc(file->size));
+  size_t offset = 0;
+  while (data && offset < file->size) {
+    ssize_t r = read(file->fd, data + offset, file->size - offset);
+    if (r <= 0) {
+      OLA_WARN << "Failed to read static file: " << strerror(errno);
+      free(data);
+      data = NULL;
+    } else {
+      offset += r;
+    }
+  }
+  CloseStaticFile(file);
+  if (!data) {
+    return NULL;
+  }
+  return BuildResponse(static_cast<void*>(data), file->size);
+#endif  // HAVE_MHD_CREATE_RESPONSE_FROM_FD_AT_OFFSET64
+}
+
 void HTTPServer::InsertSocket(bool is_readable, bool is_writeable, int fd) {
 #ifdef _WIN32
   UnmanagedSocketDescriptor *socket = new UnmanagedSocketDescriptor(fd);
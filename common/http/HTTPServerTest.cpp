@@ -0,0 +1,66 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTTPServerTest.cpp
+ * Test fixture for the HTTPServer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/http/HTTPServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::http::HTTPServer;
+
+class HTTPServerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HTTPServerTest);
+  CPPUNIT_TEST(testAcceptsEncoding);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testAcceptsEncoding();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTTPServerTest);
+
+
+/*
+ * Check we parse Accept-Encoding headers correctly.
+ */
+void HTTPServerTest::testAcceptsEncoding() {
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("", "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("gzip", "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("GZip", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("gzip", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("xgzip", "gzip"));
+
+  const char header[] = "gzip, deflate, br";
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding(header, "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding(header, "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding(header, "zstd"));
+
+  // q values
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br;q=0.5, gzip", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br ; q=1", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("br;q=0, gzip", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("br;q=0.000", "br"));
+
+  // Wildcards
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("*", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("*;q=0", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("*, gzip;q=0", "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("gzip, *;q=0", "gzip"));
+}
@@ -4,6 +4,18 @@ if HAVE_LIBMICROHTTPD
 noinst_LTLIBRARIES += common/http/libolahttp.la
 common_http_libolahttp_la_SOURCES = \
     common/http/HTTPServer.cpp \
-    common/http/OlaHTTPServer.cpp
+    common/http/OlaHTTPServer.cpp \
+    common/http/WebSocket.cpp
 common_http_libolahttp_la_LIBADD = $(libmicrohttpd_LIBS)
+
+# TESTS
+##################################################
+test_programs += common/http/HTTPTester
+
+common_http_HTTPTester_SOURCES = \
+    common/http/HTTPServerTest.cpp \
+    common/http/WebSocketTest.cpp
+common_http_HTTPTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_http_HTTPTester_LDADD = $(COMMON_TESTING_LIBS) \
+                               common/http/libolahttp.la
 endif
@@ -48,6 +48,7 @@ OlaHTTPServer::OlaHTTPServer(const HTTPServer::HTTPServerOptions &options,
     : m_export_map(export_map),
       m_server(options) {
   RegisterHandler("/debug", &OlaHTTPServer::DisplayDebug);
+  RegisterHandler("/metrics", &OlaHTTPServer::DisplayMetrics);
   RegisterHandler("/help", &OlaHTTPServer::DisplayHandlers);
 
   StringVariable *data_dir_var = export_map->GetStringVar(K_DATA_DIR_VAR);
@@ -67,17 +68,25 @@ bool OlaHTTPServer::Init() {
 
 
 /**
- * Display the contents of the ExportMap
+ * Update the uptime variable
  */
-int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
-                                HTTPResponse *raw_response) {
-  auto_ptr<HTTPResponse> response(raw_response);
+void OlaHTTPServer::UpdateUptime() {
   ola::TimeStamp now;
   m_clock.CurrentTime(&now);
   ola::TimeInterval diff = now - m_start_time;
   ostringstream str;
   str << diff.InMilliSeconds();
   m_export_map->GetStringVar(K_UPTIME_VAR)->Set(str.str());
+}
+
+
+/**
+ * Display the contents of the ExportMap
+ */
+int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
+                                HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  UpdateUptime();
 
   vector<BaseVariable*> variables = m_export_map->AllVariables();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
@@ -93,6 +102,23 @@ int OlaHTTPServer::DisplayDebug(const HTTPRequest*,
 }
 
 
+/**
+ * Display the contents of the ExportMap in the OpenMetrics format, for
+ * Prometheus and other scrapers.
+ */
+int OlaHTTPServer::DisplayMetrics(const HTTPRequest*,
+                                  HTTPResponse *raw_response) {
+  auto_ptr<HTTPResponse> response(raw_response);
+  UpdateUptime();
+
+  ostringstream str;
+  m_export_map->ExportOpenMetrics(&str);
+  response->SetContentType(ExportMap::OPEN_METRICS_CONTENT_TYPE);
+  response->Append(str.str());
+  return response->Send();
+}
+
+
 /**
  * Display a list of registered handlers
  */
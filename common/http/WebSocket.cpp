@@ -0,0 +1,472 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WebSocket.cpp
+ * The server side of a WebSocket (RFC 6455) connection.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/http/WebSocket.h"
+
+namespace ola {
+namespace http {
+
+using ola::io::ConnectedDescriptor;
+using ola::io::SelectServerInterface;
+using std::string;
+
+const unsigned int WebSocketConnection::MAX_OUTPUT_BUFFER;
+const unsigned int WebSocketConnection::MAX_MESSAGE_SIZE;
+const unsigned int WebSocketConnection::CLOSE_TIMEOUT_MS;
+
+namespace {
+
+const char WEBSOCKET_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+const unsigned int SHA1_DIGEST_SIZE = 20;
+// Control frames can't be fragmented and are limited to 125 bytes.
+const unsigned int MAX_CONTROL_PAYLOAD = 125;
+
+inline uint32_t RotateLeft(uint32_t value, unsigned int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+/*
+ * SHA-1 is only used for the handshake, so this works on the whole input at
+ * once rather than being a general purpose, incremental implementation.
+ */
+void SHA1Digest(const string &input, uint8_t *digest) {
+  uint32_t h[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+                   0xc3d2e1f0};
+
+  // Pad to a multiple of 64 bytes, with the bit length at the end.
+  string message(input);
+  message.push_back(static_cast<char>(0x80));
+  while (message.size() % 64 != 56) {
+    message.push_back(0);
+  }
+  const uint64_t bit_length = static_cast<uint64_t>(input.size()) * 8;
+  for (int i = 7; i >= 0; i--) {
+    message.push_back(static_cast<char>((bit_length >> (i * 8)) & 0xff));
+  }
+
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(message.data());
+  for (unsigned int block = 0; block < message.size(); block += 64) {
+    uint32_t w[80];
+    for (unsigned int i = 0; i < 16; i++) {
+      const uint8_t *word = data + block + 4 * i;
+      w[i] = (static_cast<uint32_t>(word[0]) << 24) |
+             (static_cast<uint32_t>(word[1]) << 16) |
+             (static_cast<uint32_t>(word[2]) << 8) |
+             word[3];
+    }
+    for (unsigned int i = 16; i < 80; i++) {
+      w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (unsigned int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5a827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ed9eba1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8f1bbcdc;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xca62c1d6;
+      }
+      const uint32_t temp = RotateLeft(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = RotateLeft(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (unsigned int i = 0; i < 5; i++) {
+    digest[4 * i] = static_cast<uint8_t>(h[i] >> 24);
+    digest[4 * i + 1] = static_cast<uint8_t>(h[i] >> 16);
+    digest[4 * i + 2] = static_cast<uint8_t>(h[i] >> 8);
+    digest[4 * i + 3] = static_cast<uint8_t>(h[i]);
+  }
+}
+
+string Base64Encode(const uint8_t *data, unsigned int length) {
+  static const char ALPHABET[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  string output;
+  output.reserve((length + 2) / 3 * 4);
+  for (unsigned int i = 0; i < length; i += 3) {
+    uint32_t value = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < length) {
+      value |= static_cast<uint32_t>(data[i + 1]) << 8;
+    }
+    if (i + 2 < length) {
+      value |= data[i + 2];
+    }
+    output.push_back(ALPHABET[(value >> 18) & 0x3f]);
+    output.push_back(ALPHABET[(value >> 12) & 0x3f]);
+    output.push_back(i + 1 < length ? ALPHABET[(value >> 6) & 0x3f] : '=');
+    output.push_back(i + 2 < length ? ALPHABET[value & 0x3f] : '=');
+  }
+  return output;
+}
+}  // namespace
+
+
+WebSocketConnection::WebSocketConnection(ConnectedDescriptor *descriptor,
+                                         SelectServerInterface *ss)
+    : m_descriptor(descriptor),
+      m_ss(ss),
+      m_in_message(false),
+      m_state(OPEN),
+      m_reading(false),
+      m_writing(false),
+      m_close_timeout(ola::thread::INVALID_TIMEOUT),
+      m_on_close(NULL) {
+}
+
+WebSocketConnection::~WebSocketConnection() {
+  // Don't run the close callback from the destructor.
+  delete m_on_close;
+  m_on_close = NULL;
+  Shutdown();
+}
+
+void WebSocketConnection::Start(const uint8_t *data, unsigned int length) {
+  m_descriptor->SetOnData(
+      NewCallback(this, &WebSocketConnection::ReceiveData));
+  m_descriptor->SetOnClose(
+      NewSingleCallback(this, &WebSocketConnection::SocketClosed));
+  m_ss->AddReadDescriptor(m_descriptor.get());
+  m_reading = true;
+
+  if (data && length) {
+    m_input.append(reinterpret_cast<const char*>(data), length);
+    ProcessInput();
+  }
+}
+
+void WebSocketConnection::SetOnMessage(MessageCallback *callback) {
+  m_on_message.reset(callback);
+}
+
+void WebSocketConnection::SetOnClose(ola::SingleUseCallback0<void> *callback) {
+  delete m_on_close;
+  m_on_close = callback;
+}
+
+void WebSocketConnection::SetOnDrain(ola::Callback0<void> *callback) {
+  m_on_drain.reset(callback);
+}
+
+bool WebSocketConnection::SendText(const string &message) {
+  if (m_state != OPEN || SendQueueFull()) {
+    return false;
+  }
+  SendFrame(OP_TEXT, reinterpret_cast<const uint8_t*>(message.data()),
+            message.size());
+  return true;
+}
+
+bool WebSocketConnection::SendBinary(const uint8_t *data,
+                                     unsigned int length) {
+  if (m_state != OPEN || SendQueueFull()) {
+    return false;
+  }
+  SendFrame(OP_BINARY, data, length);
+  return true;
+}
+
+bool WebSocketConnection::SendQueueFull() const {
+  return m_output.Size() >= MAX_OUTPUT_BUFFER;
+}
+
+void WebSocketConnection::Close(CloseStatus status) {
+  if (m_state != OPEN) {
+    return;
+  }
+  const uint8_t payload[] = {
+    static_cast<uint8_t>(status >> 8),
+    static_cast<uint8_t>(status & 0xff)
+  };
+  SendFrame(OP_CLOSE, payload, sizeof(payload));
+  m_state = CLOSING;
+  m_close_timeout = m_ss->RegisterSingleTimeout(
+      CLOSE_TIMEOUT_MS,
+      NewSingleCallback(this, &WebSocketConnection::CloseTimeout));
+}
+
+string WebSocketConnection::AcceptKey(const string &client_key) {
+  uint8_t digest[SHA1_DIGEST_SIZE];
+  SHA1Digest(client_key + WEBSOCKET_GUID, digest);
+  return Base64Encode(digest, sizeof(digest));
+}
+
+void WebSocketConnection::ReceiveData() {
+  uint8_t buffer[1024];
+  unsigned int data_read = 0;
+  if (m_descriptor->Receive(buffer, sizeof(buffer), data_read) < 0) {
+    OLA_INFO << "WebSocket read failed";
+    Shutdown();
+    return;
+  }
+  m_input.append(reinterpret_cast<const char*>(buffer), data_read);
+  ProcessInput();
+}
+
+/*
+ * Split m_input into frames.
+ */
+void WebSocketConnection::ProcessInput() {
+  while (m_state != CLOSED && m_input.size() >= 2) {
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(m_input.data());
+    const bool fin = data[0] & 0x80;
+    const uint8_t opcode = data[0] & 0x0f;
+    const bool masked = data[1] & 0x80;
+    uint64_t length = data[1] & 0x7f;
+    unsigned int offset = 2;
+
+    if (length == 126) {
+      if (m_input.size() < 4) {
+        return;
+      }
+      length = (static_cast<uint64_t>(data[2]) << 8) | data[3];
+      offset = 4;
+    } else if (length == 127) {
+      if (m_input.size() < 10) {
+        return;
+      }
+      length = 0;
+      for (unsigned int i = 2; i < 10; i++) {
+        length = (length << 8) | data[i];
+      }
+      offset = 10;
+    }
+
+    // We don't negotiate any extensions, and clients must mask their frames.
+    if ((data[0] & 0x70) || !masked) {
+      OLA_INFO << "Invalid WebSocket frame header";
+      m_input.clear();
+      Close(CLOSE_PROTOCOL_ERROR);
+      return;
+    }
+    if (length > MAX_MESSAGE_SIZE) {
+      m_input.clear();
+      Close(CLOSE_TOO_BIG);
+      return;
+    }
+    if (m_input.size() < offset + 4 + length) {
+      return;
+    }
+
+    const uint8_t *mask = data + offset;
+    const uint8_t *masked_payload = mask + 4;
+    string payload(static_cast<size_t>(length), 0);
+    for (unsigned int i = 0; i < length; i++) {
+      payload[i] = static_cast<char>(masked_payload[i] ^ mask[i % 4]);
+    }
+    m_input.erase(0, offset + 4 + static_cast<size_t>(length));
+    HandleFrame(opcode, fin, payload);
+  }
+}
+
+void WebSocketConnection::HandleFrame(uint8_t opcode, bool fin,
+                                      const string &payload) {
+  if (opcode & 0x08) {
+    if (!fin || payload.size() > MAX_CONTROL_PAYLOAD) {
+      m_input.clear();
+      Close(CLOSE_PROTOCOL_ERROR);
+      return;
+    }
+
+    switch (opcode) {
+      case OP_CLOSE:
+        if (m_state == OPEN) {
+          // Echo the status code back.
+          SendFrame(OP_CLOSE, reinterpret_cast<const uint8_t*>(payload.data()),
+                    std::min(payload.size(), static_cast<size_t>(2)));
+        }
+        Shutdown();
+        return;
+      case OP_PING:
+        if (m_state == OPEN) {
+          SendFrame(OP_PONG, reinterpret_cast<const uint8_t*>(payload.data()),
+                    payload.size());
+        }
+        return;
+      case OP_PONG:
+        return;
+      default:
+        m_input.clear();
+        Close(CLOSE_PROTOCOL_ERROR);
+        return;
+    }
+  }
+
+  if (m_state != OPEN) {
+    // Data frames after a close frame are ignored.
+    return;
+  }
+
+  if (opcode == OP_CONTINUATION) {
+    if (!m_in_message) {
+      m_input.clear();
+      Close(CLOSE_PROTOCOL_ERROR);
+      return;
+    }
+  } else if (opcode == OP_TEXT || opcode == OP_BINARY) {
+    if (m_in_message) {
+      m_input.clear();
+      Close(CLOSE_PROTOCOL_ERROR);
+      return;
+    }
+    m_in_message = true;
+    m_message.clear();
+  } else {
+    m_input.clear();
+    Close(CLOSE_PROTOCOL_ERROR);
+    return;
+  }
+
+  if (m_message.size() + payload.size() > MAX_MESSAGE_SIZE) {
+    m_input.clear();
+    Close(CLOSE_TOO_BIG);
+    return;
+  }
+  m_message.append(payload);
+
+  if (fin) {
+    m_in_message = false;
+    if (m_on_message.get()) {
+      m_on_message->Run(m_message);
+    }
+    m_message.clear();
+  }
+}
+
+/*
+ * Queue a frame. If we're not already waiting for the socket to become
+ * writable, try to send it straight away.
+ */
+void WebSocketConnection::SendFrame(uint8_t opcode,
+                                    const uint8_t *data,
+                                    unsigned int length) {
+  uint8_t header[10];
+  unsigned int header_length = 2;
+  header[0] = static_cast<uint8_t>(0x80 | opcode);
+  if (length < 126) {
+    header[1] = static_cast<uint8_t>(length);
+  } else if (length <= 0xffff) {
+    header[1] = 126;
+    header[2] = static_cast<uint8_t>(length >> 8);
+    header[3] = static_cast<uint8_t>(length & 0xff);
+    header_length = 4;
+  } else {
+    header[1] = 127;
+    header[2] = header[3] = header[4] = header[5] = 0;
+    header[6] = static_cast<uint8_t>(length >> 24);
+    header[7] = static_cast<uint8_t>(length >> 16);
+    header[8] = static_cast<uint8_t>(length >> 8);
+    header[9] = static_cast<uint8_t>(length & 0xff);
+    header_length = 10;
+  }
+
+  m_output.Write(header, header_length);
+  m_output.Write(data, length);
+
+  if (!m_writing) {
+    m_descriptor->Send(&m_output);
+    if (!m_output.Empty()) {
+      m_descriptor->SetOnWritable(
+          NewCallback(this, &WebSocketConnection::PerformWrite));
+      m_ss->AddWriteDescriptor(m_descriptor.get());
+      m_writing = true;
+    }
+  }
+}
+
+void WebSocketConnection::PerformWrite() {
+  m_descriptor->Send(&m_output);
+  if (!m_output.Empty()) {
+    return;
+  }
+  m_ss->RemoveWriteDescriptor(m_descriptor.get());
+  m_writing = false;
+  if (m_state == OPEN && m_on_drain.get()) {
+    m_on_drain->Run();
+  }
+}
+
+/*
+ * Called by the SelectServer when the client closes the socket. The
+ * SelectServer has already stopped reading from it.
+ */
+void WebSocketConnection::SocketClosed() {
+  m_reading = false;
+  Shutdown();
+}
+
+void WebSocketConnection::CloseTimeout() {
+  m_close_timeout = ola::thread::INVALID_TIMEOUT;
+  Shutdown();
+}
+
+void WebSocketConnection::Shutdown() {
+  if (m_state == CLOSED) {
+    return;
+  }
+  m_state = CLOSED;
+
+  if (m_reading) {
+    m_ss->RemoveReadDescriptor(m_descriptor.get());
+    m_reading = false;
+  }
+  if (m_writing) {
+    // Give any final frame, usually the close reply, one last chance.
+    m_descriptor->Send(&m_output);
+    m_ss->RemoveWriteDescriptor(m_descriptor.get());
+    m_writing = false;
+  }
+  if (m_close_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_close_timeout);
+    m_close_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_descriptor->Close();
+
+  ola::SingleUseCallback0<void> *on_close = m_on_close;
+  m_on_close = NULL;
+  if (on_close) {
+    on_close->Run();
+  }
+}
+}  // namespace http
+}  // namespace ola
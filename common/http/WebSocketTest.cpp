@@ -0,0 +1,284 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WebSocketTest.cpp
+ * Test fixture for the WebSocketConnection class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/http/WebSocket.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::TimeInterval;
+using ola::http::WebSocketConnection;
+using ola::io::SelectServer;
+using ola::io::UnixSocket;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+class WebSocketTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WebSocketTest);
+  CPPUNIT_TEST(testAcceptKey);
+  CPPUNIT_TEST(testReceive);
+  CPPUNIT_TEST(testSend);
+  CPPUNIT_TEST(testPing);
+  CPPUNIT_TEST(testClientClose);
+  CPPUNIT_TEST(testServerClose);
+  CPPUNIT_TEST(testProtocolError);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testAcceptKey();
+  void testReceive();
+  void testSend();
+  void testPing();
+  void testClientClose();
+  void testServerClose();
+  void testProtocolError();
+
+  void MessageReceived(const string &message) {
+    m_messages.push_back(message);
+  }
+
+  void Closed() { m_closed = true; }
+
+ private:
+  SelectServer m_ss;
+  UnixSocket m_client;
+  auto_ptr<WebSocketConnection> m_connection;
+  vector<string> m_messages;
+  bool m_closed;
+
+  void ClientSend(const string &data);
+  string ClientReceive();
+  void RunLoop();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WebSocketTest);
+
+namespace {
+// From section 5.7 of RFC 6455.
+const uint8_t MASKED_HELLO[] = {
+  0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58
+};
+
+string FromBytes(const uint8_t *data, unsigned int length) {
+  return string(reinterpret_cast<const char*>(data), length);
+}
+
+/*
+ * Build a client frame, using a fixed mask.
+ */
+string ClientFrame(uint8_t first_byte, const string &payload) {
+  const uint8_t mask[] = {0x12, 0x34, 0x56, 0x78};
+  string frame;
+  frame.push_back(static_cast<char>(first_byte));
+  if (payload.size() < 126) {
+    frame.push_back(static_cast<char>(0x80 | payload.size()));
+  } else {
+    frame.push_back(static_cast<char>(0x80 | 126));
+    frame.push_back(static_cast<char>(payload.size() >> 8));
+    frame.push_back(static_cast<char>(payload.size() & 0xff));
+  }
+  frame.append(reinterpret_cast<const char*>(mask), sizeof(mask));
+  for (unsigned int i = 0; i < payload.size(); i++) {
+    frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+  }
+  return frame;
+}
+}  // namespace
+
+
+void WebSocketTest::setUp() {
+  m_closed = false;
+  m_messages.clear();
+  OLA_ASSERT_TRUE(m_client.Init());
+  m_connection.reset(new WebSocketConnection(m_client.OppositeEnd(), &m_ss));
+  m_connection->SetOnMessage(
+      ola::NewCallback(this, &WebSocketTest::MessageReceived));
+  m_connection->SetOnClose(
+      ola::NewSingleCallback(this, &WebSocketTest::Closed));
+}
+
+
+void WebSocketTest::tearDown() {
+  m_connection.reset();
+  m_client.Close();
+}
+
+
+void WebSocketTest::ClientSend(const string &data) {
+  m_client.Send(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  RunLoop();
+}
+
+
+/*
+ * Read everything the connection has sent to the client.
+ */
+string WebSocketTest::ClientReceive() {
+  RunLoop();
+  string output;
+  int remaining = m_client.DataRemaining();
+  while (remaining > 0) {
+    uint8_t buffer[1024];
+    unsigned int data_read = 0;
+    m_client.Receive(buffer, sizeof(buffer), data_read);
+    if (!data_read) {
+      break;
+    }
+    output.append(reinterpret_cast<const char*>(buffer), data_read);
+    remaining = m_client.DataRemaining();
+  }
+  return output;
+}
+
+
+void WebSocketTest::RunLoop() {
+  for (unsigned int i = 0; i < 3; i++) {
+    m_ss.RunOnce(TimeInterval(0, 1000));
+  }
+}
+
+
+/*
+ * Check the accept key matches the example in RFC 6455.
+ */
+void WebSocketTest::testAcceptKey() {
+  OLA_ASSERT_EQ(string("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="),
+                WebSocketConnection::AcceptKey("dGhlIHNhbXBsZSBub25jZQ=="));
+}
+
+
+/*
+ * Check we can receive messages, including ones that arrived with the
+ * handshake, fragmented messages and frames split across reads.
+ */
+void WebSocketTest::testReceive() {
+  m_connection->Start(MASKED_HELLO, sizeof(MASKED_HELLO));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_messages.size());
+  OLA_ASSERT_EQ(string("Hello"), m_messages[0]);
+
+  // Split across two reads
+  const string hello = FromBytes(MASKED_HELLO, sizeof(MASKED_HELLO));
+  ClientSend(hello.substr(0, 4));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_messages.size());
+  ClientSend(hello.substr(4));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_messages.size());
+  OLA_ASSERT_EQ(string("Hello"), m_messages[1]);
+
+  // A fragmented message: text then continuation.
+  ClientSend(ClientFrame(0x01, "Hel") + ClientFrame(0x80, "lo"));
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_messages.size());
+  OLA_ASSERT_EQ(string("Hello"), m_messages[2]);
+
+  // A message with a 16 bit length.
+  const string large(300, 'x');
+  ClientSend(ClientFrame(0x82, large));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_messages.size());
+  OLA_ASSERT_EQ(large, m_messages[3]);
+  OLA_ASSERT_FALSE(m_closed);
+}
+
+
+/*
+ * Check the framing of the messages we send.
+ */
+void WebSocketTest::testSend() {
+  m_connection->Start();
+  OLA_ASSERT_TRUE(m_connection->SendText("Hello"));
+  OLA_ASSERT_EQ(string("\x81\x05Hello"), ClientReceive());
+
+  vector<uint8_t> data(256, 0xaa);
+  OLA_ASSERT_TRUE(m_connection->SendBinary(&data[0], data.size()));
+  const string frame = ClientReceive();
+  OLA_ASSERT_EQ(static_cast<size_t>(260), frame.size());
+  OLA_ASSERT_EQ(string("\x82\x7e\x01\x00", 4), frame.substr(0, 4));
+  OLA_ASSERT_EQ(string(256, '\xaa'), frame.substr(4));
+  OLA_ASSERT_FALSE(m_connection->SendQueueFull());
+}
+
+
+/*
+ * Check pings are answered.
+ */
+void WebSocketTest::testPing() {
+  m_connection->Start();
+  ClientSend(ClientFrame(0x89, "ping"));
+  OLA_ASSERT_EQ(string("\x8a\x04ping"), ClientReceive());
+  OLA_ASSERT_TRUE(m_messages.empty());
+}
+
+
+/*
+ * Check the client can close the connection.
+ */
+void WebSocketTest::testClientClose() {
+  m_connection->Start();
+  ClientSend(ClientFrame(0x88, string("\x03\xe8", 2)));
+  OLA_ASSERT_TRUE(m_closed);
+  OLA_ASSERT_FALSE(m_connection->IsOpen());
+  OLA_ASSERT_EQ(string("\x88\x02\x03\xe8", 4), ClientReceive());
+  OLA_ASSERT_FALSE(m_connection->SendText("Hello"));
+}
+
+
+/*
+ * Check the server can close the connection.
+ */
+void WebSocketTest::testServerClose() {
+  m_connection->Start();
+  m_connection->Close(WebSocketConnection::CLOSE_GOING_AWAY);
+  OLA_ASSERT_FALSE(m_connection->IsOpen());
+  OLA_ASSERT_EQ(string("\x88\x02\x03\xe9", 4), ClientReceive());
+  OLA_ASSERT_FALSE(m_closed);
+
+  // Messages are ignored while we wait for the reply.
+  ClientSend(ClientFrame(0x81, "late"));
+  OLA_ASSERT_TRUE(m_messages.empty());
+
+  ClientSend(ClientFrame(0x88, string("\x03\xe9", 2)));
+  OLA_ASSERT_TRUE(m_closed);
+}
+
+
+/*
+ * Check unmasked frames are rejected.
+ */
+void WebSocketTest::testProtocolError() {
+  m_connection->Start();
+  ClientSend("\x81\x02hi");
+  OLA_ASSERT_TRUE(m_messages.empty());
+  OLA_ASSERT_EQ(string("\x88\x02\x03\xea", 4), ClientReceive());
+
+  // The socket closes once the client goes away.
+  m_client.Close();
+  RunLoop();
+  OLA_ASSERT_TRUE(m_closed);
+}
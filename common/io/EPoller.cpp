@@ -45,27 +45,42 @@ using std::pair;
  */
 class EPollData {
  public:
-  EPollData()
-      : events(0),
-        read_descriptor(NULL),
-        write_descriptor(NULL),
-        connected_descriptor(NULL),
-        delete_connected_on_close(false) {
+  EPollData() {
+    Reset();
   }
 
   void Reset() {
+    fd = INVALID_DESCRIPTOR;
     events = 0;
+    registered_events = 0;
     read_descriptor = NULL;
     write_descriptor = NULL;
     connected_descriptor = NULL;
     delete_connected_on_close = false;
+    changed = false;
+    orphaned = false;
+    write_registered = false;
+    writable = false;
+    write_queued = false;
   }
 
+  int fd;
+  // The events we want, and the events set with epoll_ctl().
   uint32_t events;
+  uint32_t registered_events;
   ReadFileDescriptor *read_descriptor;
   WriteFileDescriptor *write_descriptor;
   ConnectedDescriptor *connected_descriptor;
   bool delete_connected_on_close;
+  // True if this is in m_changed_descriptors.
+  bool changed;
+  // True once this has been removed from the descriptor map.
+  bool orphaned;
+  // Edge triggered mode only.
+  bool write_registered;
+  bool writable;
+  // True if this is in m_ready_writers.
+  bool write_queued;
 };
 
 namespace {
@@ -74,9 +89,9 @@ namespace {
  * Add the fd to the epoll_fd.
  * descriptor is the user data to associated with the event
  */
-bool AddEvent(int epoll_fd, int fd, EPollData *descriptor) {
+bool AddEvent(int epoll_fd, int fd, uint32_t events, EPollData *descriptor) {
   epoll_event event;
-  event.events = descriptor->events;
+  event.events = events;
   event.data.ptr = descriptor;
 
   OLA_DEBUG << "EPOLL_CTL_ADD " << fd << ", events " << std::hex
@@ -93,9 +108,10 @@ bool AddEvent(int epoll_fd, int fd, EPollData *descriptor) {
  * Update the fd in the epoll event set
  * descriptor is the user data to associated with the event
  */
-bool UpdateEvent(int epoll_fd, int fd, EPollData *descriptor) {
+bool UpdateEvent(int epoll_fd, int fd, uint32_t events,
+                 EPollData *descriptor) {
   epoll_event event;
-  event.events = descriptor->events;
+  event.events = events;
   event.data.ptr = descriptor;
 
   OLA_DEBUG << "EPOLL_CTL_MOD " << fd << ", events " << std::hex
@@ -144,6 +160,7 @@ EPoller::EPoller(ExportMap *export_map, Clock* clock)
       m_loop_iterations(NULL),
       m_loop_time(NULL),
       m_epoll_fd(INVALID_DESCRIPTOR),
+      m_write_epoll_fd(INVALID_DESCRIPTOR),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
@@ -160,6 +177,9 @@ EPoller::~EPoller() {
   if (m_epoll_fd != INVALID_DESCRIPTOR) {
     close(m_epoll_fd);
   }
+  if (m_write_epoll_fd != INVALID_DESCRIPTOR) {
+    close(m_write_epoll_fd);
+  }
 
   {
     DescriptorMap::iterator iter = m_descriptor_map.begin();
@@ -183,6 +203,32 @@ EPoller::~EPoller() {
   STLDeleteElements(&m_free_descriptors);
 }
 
+bool EPoller::EnableEdgeTriggeredWrites() {
+  if (m_write_epoll_fd != INVALID_DESCRIPTOR) {
+    return true;
+  }
+  if (m_epoll_fd == INVALID_DESCRIPTOR || !m_descriptor_map.empty()) {
+    return false;
+  }
+
+  m_write_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_write_epoll_fd < 0) {
+    OLA_WARN << "Failed to create the write epoll instance: "
+             << strerror(errno);
+    m_write_epoll_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+
+  // The write epoll fd is readable when it has events, it's the only entry
+  // without EPollData.
+  if (!AddEvent(m_epoll_fd, m_write_epoll_fd, EPOLLIN, NULL)) {
+    close(m_write_epoll_fd);
+    m_write_epoll_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+  return true;
+}
+
 bool EPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
   if (m_epoll_fd == INVALID_DESCRIPTOR) {
     return false;
@@ -203,12 +249,7 @@ bool EPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
 
   result.first->events |= READ_FLAGS;
   result.first->read_descriptor = descriptor;
-
-  if (result.second) {
-    return AddEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
-  } else {
-    return UpdateEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
-  }
+  return ApplyChange(result.first);
 }
 
 bool EPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
@@ -234,12 +275,7 @@ bool EPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
   result.first->events |= READ_FLAGS;
   result.first->connected_descriptor = descriptor;
   result.first->delete_connected_on_close = delete_on_close;
-
-  if (result.second) {
-    return AddEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
-  } else {
-    return UpdateEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
-  }
+  return ApplyChange(result.first);
 }
 
 bool EPoller::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
@@ -269,15 +305,30 @@ bool EPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
     return false;
   }
 
-  result.first->events |= EPOLLOUT;
-  result.first->write_descriptor = descriptor;
+  EPollData *epoll_data = result.first;
+  epoll_data->events |= EPOLLOUT;
+  epoll_data->write_descriptor = descriptor;
 
-  if (result.second) {
-    return AddEvent(m_epoll_fd, descriptor->WriteDescriptor(), result.first);
-  } else {
-    return UpdateEvent(m_epoll_fd, descriptor->WriteDescriptor(),
-                       result.first);
+  if (m_write_epoll_fd == INVALID_DESCRIPTOR) {
+    if (epoll_data->registered_events) {
+      QueueChange(epoll_data);
+      return true;
+    }
+    return ApplyChange(epoll_data);
+  }
+
+  if (!epoll_data->write_registered) {
+    // epoll reports an edge straight away if the descriptor is writable.
+    if (!AddEvent(m_write_epoll_fd, epoll_data->fd, EPOLLOUT | EPOLLET,
+                  epoll_data)) {
+      return false;
+    }
+    epoll_data->write_registered = true;
+  } else if (epoll_data->writable && !epoll_data->write_queued) {
+    epoll_data->write_queued = true;
+    m_ready_writers.push_back(epoll_data);
   }
+  return true;
 }
 
 bool EPoller::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
@@ -310,11 +361,13 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
       (*m_loop_iterations)++;
   }
 
-  int ms_to_sleep = sleep_interval.InMilliSeconds();
-  int ready = epoll_wait(m_epoll_fd, reinterpret_cast<epoll_event*>(&events),
-                         MAX_EVENTS, ms_to_sleep ? ms_to_sleep : 1);
+  FlushChanges();
+  // Don't block if there are writable descriptors waiting to be called.
+  int ready = m_ready_writers.empty() ?
+      Wait(events, sleep_interval) :
+      epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0);
 
-  if (ready == 0) {
+  if (ready == 0 && m_ready_writers.empty()) {
     m_clock->CurrentTime(&m_wake_up_time);
     timeout_manager->ExecuteTimeouts(&m_wake_up_time);
     return true;
@@ -327,14 +380,32 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
 
   m_clock->CurrentTime(&m_wake_up_time);
 
+  DispatchReadyWriters();
   for (int i = 0; i < ready; i++) {
     EPollData *descriptor = reinterpret_cast<EPollData*>(
         events[i].data.ptr);
-    CheckDescriptor(&events[i], descriptor);
+    if (descriptor) {
+      CheckDescriptor(&events[i], descriptor);
+    } else {
+      CheckWriteEvents();
+    }
+  }
+
+  // Now that we're out of the callback phase, apply the changes and clean up
+  // descriptors that were removed. Nothing may refer to the removed
+  // descriptors after this.
+  FlushChanges();
+  if (!m_orphaned_descriptors.empty() && !m_ready_writers.empty()) {
+    DescriptorList ready_writers;
+    DescriptorList::iterator iter = m_ready_writers.begin();
+    for (; iter != m_ready_writers.end(); ++iter) {
+      if (!(*iter)->orphaned) {
+        ready_writers.push_back(*iter);
+      }
+    }
+    m_ready_writers.swap(ready_writers);
   }
 
-  // Now that we're out of the callback phase, clean up descriptors that were
-  // removed.
   DescriptorList::iterator iter = m_orphaned_descriptors.begin();
   for (; iter != m_orphaned_descriptors.end(); ++iter) {
     if (m_free_descriptors.size() == MAX_FREE_DESCRIPTORS) {
@@ -352,6 +423,36 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
 }
 
 
+/*
+ * Wait for events, spinning for up to m_busy_poll_interval before blocking.
+ * @returns the value from epoll_wait().
+ */
+int EPoller::Wait(epoll_event *events, const TimeInterval &sleep_interval) {
+  TimeInterval block_interval = sleep_interval;
+  if (!m_busy_poll_interval.IsZero()) {
+    TimeStamp now, spin_until;
+    m_clock->CurrentTime(&now);
+    spin_until = now + std::min(m_busy_poll_interval, sleep_interval);
+    while (now < spin_until) {
+      int ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0);
+      if (ready != 0) {
+        return ready;
+      }
+      m_clock->CurrentTime(&now);
+    }
+    if (sleep_interval <= m_busy_poll_interval) {
+      return 0;
+    }
+    block_interval = TimeInterval(
+        sleep_interval.AsInt() - m_busy_poll_interval.AsInt());
+  }
+
+  int ms_to_sleep = block_interval.InMilliSeconds();
+  return epoll_wait(m_epoll_fd, events, MAX_EVENTS,
+                    ms_to_sleep ? ms_to_sleep : 1);
+}
+
+
 /*
  * Check all the registered descriptors:
  *  - Execute the callback for descriptors with data
@@ -361,14 +462,14 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
                               EPollData *epoll_data) {
   if (event->events & (EPOLLHUP | EPOLLRDHUP)) {
     if (epoll_data->read_descriptor) {
-      epoll_data->read_descriptor->PerformRead();
+      DispatchRead(epoll_data->read_descriptor);
     } else if (epoll_data->write_descriptor) {
-      epoll_data->write_descriptor->PerformWrite();
+      DispatchWrite(epoll_data->write_descriptor);
     } else if (epoll_data->connected_descriptor) {
       ConnectedDescriptor::OnCloseCallback *on_close =
           epoll_data->connected_descriptor->TransferOnClose();
       if (on_close)
-        on_close->Run();
+        DispatchClose(epoll_data->connected_descriptor, on_close);
 
       // At this point the descriptor may be sitting in the orphan list if the
       // OnClose handler called into RemoveReadDescriptor()
@@ -392,9 +493,9 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
 
   if (event->events & EPOLLIN) {
     if (epoll_data->read_descriptor) {
-      epoll_data->read_descriptor->PerformRead();
+      DispatchRead(epoll_data->read_descriptor);
     } else if (epoll_data->connected_descriptor) {
-      epoll_data->connected_descriptor->PerformRead();
+      DispatchRead(epoll_data->connected_descriptor);
     }
   }
 
@@ -402,11 +503,62 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
     // epoll_data->write_descriptor may be null here if this descriptor was
     // removed between when kevent returned and now.
     if (epoll_data->write_descriptor) {
-      epoll_data->write_descriptor->PerformWrite();
+      DispatchWrite(epoll_data->write_descriptor);
     }
   }
 }
 
+/*
+ * In edge triggered mode, run the on-write callbacks of the descriptors that
+ * were added to the write set while they were writable.
+ */
+void EPoller::DispatchReadyWriters() {
+  if (m_ready_writers.empty()) {
+    return;
+  }
+
+  DescriptorList ready_writers;
+  ready_writers.swap(m_ready_writers);
+  DescriptorList::iterator iter = ready_writers.begin();
+  for (; iter != ready_writers.end(); ++iter) {
+    (*iter)->write_queued = false;
+    if (!(*iter)->orphaned) {
+      DispatchEdgeWrite(*iter);
+    }
+  }
+}
+
+/*
+ * Read the edges from the write epoll fd.
+ */
+void EPoller::CheckWriteEvents() {
+  epoll_event events[MAX_EVENTS];
+  int ready = epoll_wait(m_write_epoll_fd, events, MAX_EVENTS, 0);
+  for (int i = 0; i < ready; i++) {
+    EPollData *epoll_data = reinterpret_cast<EPollData*>(events[i].data.ptr);
+    if (epoll_data->orphaned) {
+      continue;
+    }
+    epoll_data->writable = true;
+    // Descriptors in m_ready_writers are called on the next iteration.
+    if (!epoll_data->write_queued) {
+      DispatchEdgeWrite(epoll_data);
+    }
+  }
+}
+
+void EPoller::DispatchEdgeWrite(EPollData *epoll_data) {
+  if (!epoll_data->write_descriptor) {
+    return;
+  }
+  DispatchWrite(epoll_data->write_descriptor);
+  // If it's still in the write set it couldn't write everything, so wait for
+  // the next edge.
+  if (epoll_data->write_descriptor) {
+    epoll_data->writable = false;
+  }
+}
+
 std::pair<EPollData*, bool> EPoller::LookupOrCreateDescriptor(int fd) {
   pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
       DescriptorMap::value_type(fd, NULL));
@@ -419,6 +571,7 @@ std::pair<EPollData*, bool> EPoller::LookupOrCreateDescriptor(int fd) {
       result.first->second = m_free_descriptors.back();
       m_free_descriptors.pop_back();
     }
+    result.first->second->fd = fd;
   }
   return std::make_pair(result.first->second, new_descriptor);
 }
@@ -447,13 +600,74 @@ bool EPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
   }
 
   if (epoll_data->events == 0) {
-    RemoveEvent(m_epoll_fd, fd);
+    // This is applied straight away, since the descriptor may be closed
+    // once we return.
+    if (epoll_data->registered_events) {
+      RemoveEvent(m_epoll_fd, fd);
+    }
+    if (epoll_data->write_registered) {
+      RemoveEvent(m_write_epoll_fd, fd);
+    }
+    epoll_data->changed = false;
+    epoll_data->orphaned = true;
     m_orphaned_descriptors.push_back(
         STLLookupAndRemovePtr(&m_descriptor_map, fd));
+  } else if (event & EPOLLOUT) {
+    // In edge triggered mode the registered events don't change.
+    if (m_write_epoll_fd == INVALID_DESCRIPTOR) {
+      QueueChange(epoll_data);
+    }
   } else {
-    return UpdateEvent(m_epoll_fd, fd, epoll_data);
+    return ApplyChange(epoll_data);
   }
   return true;
 }
+
+/*
+ * Update the events registered with epoll to match the events we want.
+ */
+bool EPoller::ApplyChange(EPollData *epoll_data) {
+  uint32_t events = epoll_data->events;
+  if (m_write_epoll_fd != INVALID_DESCRIPTOR) {
+    events &= ~EPOLLOUT;
+  }
+  if (events == epoll_data->registered_events) {
+    return true;
+  }
+
+  bool ok;
+  if (!epoll_data->registered_events) {
+    ok = AddEvent(m_epoll_fd, epoll_data->fd, events, epoll_data);
+  } else if (!events) {
+    ok = RemoveEvent(m_epoll_fd, epoll_data->fd);
+  } else {
+    ok = UpdateEvent(m_epoll_fd, epoll_data->fd, events, epoll_data);
+  }
+  if (ok) {
+    epoll_data->registered_events = events;
+  }
+  return ok;
+}
+
+/*
+ * Apply the change before the next call to epoll_wait().
+ */
+void EPoller::QueueChange(EPollData *epoll_data) {
+  if (!epoll_data->changed) {
+    epoll_data->changed = true;
+    m_changed_descriptors.push_back(epoll_data);
+  }
+}
+
+void EPoller::FlushChanges() {
+  DescriptorList::iterator iter = m_changed_descriptors.begin();
+  for (; iter != m_changed_descriptors.end(); ++iter) {
+    if ((*iter)->changed) {
+      (*iter)->changed = false;
+      ApplyChange(*iter);
+    }
+  }
+  m_changed_descriptors.clear();
+}
 }  // namespace io
 }  // namespace ola
@@ -47,6 +47,15 @@ class EPollData;
  *
  * epoll() is more efficient than select() but only newer Linux systems support
  * it.
+ *
+ * Changes to the write interest of a descriptor that's already registered
+ * are applied just before the next epoll_wait(), so a descriptor that's added
+ * and removed within one iteration doesn't cost any epoll_ctl() calls.
+ *
+ * With EnableEdgeTriggeredWrites(), descriptors are registered for write
+ * events once, edge triggered, on a second epoll fd. Whether each descriptor
+ * is writable is then tracked in userspace, so adding and removing a write
+ * descriptor doesn't need a system call.
  */
 class EPoller : public PollerInterface {
  public :
@@ -70,6 +79,27 @@ class EPoller : public PollerInterface {
 
   const TimeStamp *WakeUpTime() const { return &m_wake_up_time; }
 
+  /**
+   * @brief Spin for up to this long waiting for events before blocking.
+   * @param interval the spin budget, zero disables spinning.
+   *
+   * Spinning avoids the cost of the thread being descheduled and woken up
+   * again, at the expense of CPU time.
+   */
+  void SetBusyPollInterval(const TimeInterval &interval) {
+    m_busy_poll_interval = interval;
+  }
+
+  /**
+   * @brief Track write readiness with edge triggered events.
+   * @returns true if edge triggered writes are enabled.
+   *
+   * This must be called before any descriptors are added. A write descriptor
+   * that's still registered after its on-write callback runs is assumed to
+   * have filled its buffer, and isn't called again until the next edge.
+   */
+  bool EnableEdgeTriggeredWrites();
+
   bool Poll(TimeoutManager *timeout_manager,
             const TimeInterval &poll_interval);
 
@@ -86,17 +116,32 @@ class EPoller : public PollerInterface {
   DescriptorList m_orphaned_descriptors;
   // A list of pre-allocated descriptors we can use.
   DescriptorList m_free_descriptors;
+  // Descriptors with a write interest change that hasn't been applied.
+  DescriptorList m_changed_descriptors;
+  // In edge triggered mode, the writable descriptors that were added to the
+  // write set since the last iteration.
+  DescriptorList m_ready_writers;
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
   int m_epoll_fd;
+  // The epoll fd for edge triggered write events, or INVALID_DESCRIPTOR.
+  int m_write_epoll_fd;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
+  TimeInterval m_busy_poll_interval;
 
   std::pair<EPollData*, bool> LookupOrCreateDescriptor(int fd);
 
   bool RemoveDescriptor(int fd, int event, bool warn_on_missing);
+  bool ApplyChange(EPollData *descriptor);
+  void QueueChange(EPollData *descriptor);
+  void FlushChanges();
   void CheckDescriptor(struct epoll_event *event, EPollData *descriptor);
+  void CheckWriteEvents();
+  void DispatchReadyWriters();
+  void DispatchEdgeWrite(EPollData *descriptor);
+  int Wait(struct epoll_event *events, const TimeInterval &sleep_interval);
 
   static const int MAX_EVENTS;
   static const int READ_FLAGS;
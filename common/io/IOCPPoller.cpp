@@ -0,0 +1,864 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOCPPoller.cpp
+ * A Poller which uses an I/O completion port on Windows.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/IOCPPoller.h"
+
+#include <string.h>
+
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <ola/win/CleanWinSock2.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+using std::pair;
+
+static const int FLAG_READ = 1;
+static const int FLAG_WRITE = 2;
+
+/*
+ * Represents a socket or pipe handle.
+ */
+class IOCPData {
+ public:
+  explicit IOCPData(const DescriptorHandle &descriptor_handle)
+      : handle(ToHandle(descriptor_handle)),
+        socket(INVALID_SOCKET),
+        type(descriptor_handle.m_type),
+        flags(0),
+        read_descriptor(NULL),
+        write_descriptor(NULL),
+        connected_descriptor(NULL),
+        delete_connected_on_close(false),
+        listening(false),
+        associated(false),
+        orphaned(false),
+        async_data(descriptor_handle.m_async_data),
+        async_data_size(descriptor_handle.m_async_data_size),
+        read_operation(NULL),
+        event(WSA_INVALID_EVENT),
+        event_mask(0),
+        wait(NULL),
+        token(0),
+        port(NULL) {
+    if (type == SOCKET_DESCRIPTOR) {
+      socket = static_cast<SOCKET>(ToFD(descriptor_handle));
+      handle = reinterpret_cast<HANDLE>(socket);
+
+      BOOL accepting = FALSE;
+      int length = sizeof(accepting);
+      listening = getsockopt(socket, SOL_SOCKET, SO_ACCEPTCONN,
+                             reinterpret_cast<char*>(&accepting),
+                             &length) == 0 && accepting;
+    }
+  }
+
+  ~IOCPData() {
+    if (event != WSA_INVALID_EVENT) {
+      WSACloseEvent(event);
+    }
+  }
+
+  HANDLE handle;
+  SOCKET socket;
+  DescriptorType type;
+  int flags;
+  ReadFileDescriptor *read_descriptor;
+  WriteFileDescriptor *write_descriptor;
+  ConnectedDescriptor *connected_descriptor;
+  bool delete_connected_on_close;
+  // Listening sockets can't have a receive outstanding, so they wait for
+  // FD_ACCEPT instead.
+  bool listening;
+  bool associated;
+  // True once the descriptor is in the orphan list.
+  bool orphaned;
+  // The async buffer of pipes, which ConnectedDescriptor::Receive() reads
+  // from.
+  uint8_t *async_data;
+  uint32_t *async_data_size;
+  // The outstanding receive, or NULL if there isn't one.
+  IOCPOperation *read_operation;
+
+  // The WSAEventSelect() state. The wait, and the token it posts, are
+  // replaced each time the events are re-armed.
+  WSAEVENT event;
+  long event_mask;  // NOLINT(runtime/int)
+  HANDLE wait;
+  ULONG_PTR token;
+  HANDLE port;
+};
+
+/*
+ * An overlapped receive. These are pooled, and the buffer is only allocated
+ * for pipes.
+ */
+class IOCPOperation {
+ public:
+  IOCPOperation()
+      : data(NULL),
+        buffer(NULL),
+        error(0) {
+    memset(&overlapped, 0, sizeof(overlapped));
+  }
+
+  ~IOCPOperation() {
+    delete[] buffer;
+  }
+
+  void Reset() {
+    memset(&overlapped, 0, sizeof(overlapped));
+    data = NULL;
+    error = 0;
+  }
+
+  // This must be first, so the OVERLAPPED in a completion can be converted
+  // back to the operation.
+  OVERLAPPED overlapped;
+  // NULL once the operation has been cancelled.
+  IOCPData *data;
+  uint8_t *buffer;
+  // Set if the operation failed straight away and the completion was posted
+  // by us.
+  DWORD error;
+};
+
+
+/**
+ * @brief The completion key used for the handles associated with the port.
+ *
+ * The waits post the token of the descriptor as the key, which is never 0.
+ */
+const ULONG_PTR IOCPPoller::OPERATION_KEY = 0;
+
+/**
+ * @brief The number of completions to dequeue at once.
+ */
+const unsigned int IOCPPoller::MAX_EVENTS = 64;
+
+/**
+ * @brief The number of unused operations to keep around.
+ */
+const unsigned int IOCPPoller::MAX_FREE_OPERATIONS = 256;
+
+IOCPPoller::IOCPPoller(ExportMap *export_map, Clock* clock)
+    : m_export_map(export_map),
+      m_loop_iterations(NULL),
+      m_loop_time(NULL),
+      m_port(NULL),
+      m_next_token(OPERATION_KEY + 1),
+      m_clock(clock) {
+  if (m_export_map) {
+    m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
+    m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+  }
+}
+
+IOCPPoller::~IOCPPoller() {
+  DescriptorMap::iterator iter = m_descriptor_map.begin();
+  for (; iter != m_descriptor_map.end(); ++iter) {
+    CancelRead(iter->second);
+    DisarmEvents(iter->second);
+  }
+
+  // The kernel owns the outstanding operations until their completion is
+  // dequeued.
+  OVERLAPPED_ENTRY entries[MAX_EVENTS];
+  while (m_port && !m_pending_operations.empty()) {
+    ULONG count = 0;
+    if (!GetQueuedCompletionStatusEx(m_port, entries, MAX_EVENTS, &count,
+                                     100, FALSE)) {
+      OLA_WARN << m_pending_operations.size()
+               << " IOCP operations didn't complete";
+      break;
+    }
+    for (ULONG i = 0; i < count; i++) {
+      IOCPOperation *operation = reinterpret_cast<IOCPOperation*>(
+          entries[i].lpOverlapped);
+      if (entries[i].lpCompletionKey == OPERATION_KEY &&
+          m_pending_operations.erase(operation)) {
+        delete operation;
+      }
+    }
+  }
+
+  for (iter = m_descriptor_map.begin(); iter != m_descriptor_map.end();
+       ++iter) {
+    if (iter->second->delete_connected_on_close) {
+      delete iter->second->connected_descriptor;
+    }
+    delete iter->second;
+  }
+
+  DescriptorList::iterator orphan_iter = m_orphaned_descriptors.begin();
+  for (; orphan_iter != m_orphaned_descriptors.end(); ++orphan_iter) {
+    if ((*orphan_iter)->delete_connected_on_close) {
+      delete (*orphan_iter)->connected_descriptor;
+    }
+    delete *orphan_iter;
+  }
+
+  STLDeleteElements(&m_free_operations);
+  if (m_port) {
+    CloseHandle(m_port);
+  }
+}
+
+bool IOCPPoller::Init() {
+  if (m_port) {
+    return true;
+  }
+
+  m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+  if (!m_port) {
+    OLA_WARN << "CreateIoCompletionPort failed with " << GetLastError();
+    return false;
+  }
+  return true;
+}
+
+bool IOCPPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
+  if (!m_port) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOCPData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (!result.first) {
+    return false;
+  }
+  if (result.first->flags & FLAG_READ) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->flags |= FLAG_READ;
+  result.first->read_descriptor = descriptor;
+  return ArmRead(result.first);
+}
+
+bool IOCPPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
+                                   bool delete_on_close) {
+  if (!m_port) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOCPData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (!result.first) {
+    return false;
+  }
+  if (result.first->flags & FLAG_READ) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->flags |= FLAG_READ;
+  result.first->connected_descriptor = descriptor;
+  result.first->delete_connected_on_close = delete_on_close;
+  return ArmRead(result.first);
+}
+
+bool IOCPPoller::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), FLAG_READ, true);
+}
+
+bool IOCPPoller::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), FLAG_READ, true);
+}
+
+bool IOCPPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
+  if (!m_port) {
+    return false;
+  }
+
+  if (!descriptor->ValidWriteDescriptor()) {
+    OLA_WARN << "AddWriteDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOCPData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->WriteDescriptor());
+  if (!result.first) {
+    return false;
+  }
+  if (result.first->flags & FLAG_WRITE) {
+    OLA_WARN << "Descriptor " << descriptor->WriteDescriptor()
+             << " already in write set";
+    return false;
+  }
+
+  result.first->flags |= FLAG_WRITE;
+  result.first->write_descriptor = descriptor;
+  // Pipes are always writable, see CheckPipes().
+  return result.first->type == PIPE_DESCRIPTOR || ArmEvents(result.first);
+}
+
+bool IOCPPoller::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->WriteDescriptor(), FLAG_WRITE, true);
+}
+
+bool IOCPPoller::Poll(TimeoutManager *timeout_manager,
+                      const TimeInterval &poll_interval) {
+  if (!m_port) {
+    return false;
+  }
+
+  TimeInterval sleep_interval = poll_interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  TimeInterval next_event_in = timeout_manager->ExecuteTimeouts(&now);
+  if (!next_event_in.IsZero()) {
+    sleep_interval = std::min(next_event_in, sleep_interval);
+  }
+
+  // take care of stats accounting
+  if (m_wake_up_time.IsSet()) {
+    TimeInterval loop_time = now - m_wake_up_time;
+    OLA_DEBUG << "ss process time was " << loop_time.ToString();
+    if (m_loop_time)
+      (*m_loop_time) += loop_time.AsInt();
+    if (m_loop_iterations)
+      (*m_loop_iterations)++;
+  }
+
+  CheckPipes();
+  DWORD ms_to_sleep = m_ready_pipes.empty() ?
+      sleep_interval.InMilliSeconds() : 0;
+
+  OVERLAPPED_ENTRY entries[MAX_EVENTS];
+  ULONG count = 0;
+  if (!GetQueuedCompletionStatusEx(m_port, entries, MAX_EVENTS, &count,
+                                   ms_to_sleep, FALSE)) {
+    if (GetLastError() != WAIT_TIMEOUT) {
+      OLA_WARN << "GetQueuedCompletionStatusEx failed with "
+               << GetLastError();
+      return false;
+    }
+    count = 0;
+  }
+
+  m_clock->CurrentTime(&m_wake_up_time);
+
+  DescriptorList::iterator iter = m_ready_pipes.begin();
+  for (; iter != m_ready_pipes.end(); ++iter) {
+    IOCPData *data = *iter;
+    // Earlier callbacks may have removed the descriptor.
+    if (!data->orphaned && (data->flags & FLAG_READ) &&
+        *data->async_data_size) {
+      if (data->connected_descriptor) {
+        DispatchRead(data->connected_descriptor);
+      } else if (data->read_descriptor) {
+        DispatchRead(data->read_descriptor);
+      }
+      // The receive isn't started while the buffer is full.
+      if (!data->orphaned && (data->flags & FLAG_READ)) {
+        ArmRead(data);
+      }
+    }
+    if (!data->orphaned && data->write_descriptor) {
+      DispatchWrite(data->write_descriptor);
+    }
+  }
+
+  for (ULONG i = 0; i < count; i++) {
+    HandleCompletion(entries[i]);
+  }
+
+  // Now that we're out of the callback phase, clean up descriptors that were
+  // removed.
+  STLDeleteElements(&m_orphaned_descriptors);
+
+  m_clock->CurrentTime(&m_wake_up_time);
+  timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+  return true;
+}
+
+std::pair<IOCPData*, bool> IOCPPoller::LookupOrCreateDescriptor(
+    const DescriptorHandle &handle) {
+  if (handle.m_type != SOCKET_DESCRIPTOR &&
+      handle.m_type != PIPE_DESCRIPTOR) {
+    OLA_WARN << "Descriptor type not implemented: " << handle.m_type;
+    return std::make_pair(static_cast<IOCPData*>(NULL), false);
+  }
+
+  pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
+      DescriptorMap::value_type(ToHandle(handle), NULL));
+  bool new_descriptor = result.second;
+
+  if (new_descriptor) {
+    result.first->second = new IOCPData(handle);
+    if (handle.m_type == PIPE_DESCRIPTOR) {
+      m_pipes.push_back(result.first->second);
+    }
+  }
+  return std::make_pair(result.first->second, new_descriptor);
+}
+
+/*
+ * Associate a handle with the port, this only needs to happen once.
+ */
+bool IOCPPoller::Associate(IOCPData *data) {
+  if (data->associated) {
+    return true;
+  }
+
+  if (!CreateIoCompletionPort(data->handle, m_port, OPERATION_KEY, 0)) {
+    // The association outlives the IOCPData, so a handle that was removed and
+    // added again is already associated.
+    if (GetLastError() != ERROR_INVALID_PARAMETER) {
+      OLA_WARN << "CreateIoCompletionPort failed for " << data->handle
+               << " with " << GetLastError();
+      return false;
+    }
+  }
+  data->associated = true;
+  return true;
+}
+
+/*
+ * Start an overlapped receive for a descriptor in the read set.
+ */
+bool IOCPPoller::ArmRead(IOCPData *data) {
+  if (data->read_operation) {
+    return true;
+  }
+
+  if (data->type == SOCKET_DESCRIPTOR && data->listening) {
+    return ArmEvents(data);
+  }
+
+  uint32_t space = 0;
+  if (data->type == PIPE_DESCRIPTOR) {
+    if (!data->async_data_size) {
+      OLA_WARN << "No async data buffer for " << data->handle;
+      return false;
+    }
+    space = ASYNC_DATA_BUFFER_SIZE - *data->async_data_size;
+    if (!space) {
+      // The buffer is emptied by the read callback in CheckPipes(), then the
+      // receive is started once it completes.
+      return true;
+    }
+  }
+
+  if (!Associate(data)) {
+    return false;
+  }
+
+  IOCPOperation *operation = NewOperation();
+  DWORD error = 0;
+  if (data->type == SOCKET_DESCRIPTOR) {
+    // A zero byte peek completes when there's data, without taking it off
+    // the socket.
+    WSABUF buffer;
+    buffer.len = 0;
+    buffer.buf = NULL;
+    DWORD flags = MSG_PEEK;
+    if (WSARecv(data->socket, &buffer, 1, NULL, &flags,
+                &operation->overlapped, NULL) == SOCKET_ERROR) {
+      error = WSAGetLastError();
+      if (error == WSA_IO_PENDING) {
+        error = 0;
+      } else if (error != WSAEMSGSIZE && error != WSAECONNRESET &&
+                 error != WSAECONNABORTED && error != WSAENETRESET) {
+        OLA_WARN << "WSARecv failed for " << data->socket << " with "
+                 << error;
+        ReleaseOperation(operation);
+        return false;
+      }
+    }
+  } else {
+    if (!operation->buffer) {
+      operation->buffer = new uint8_t[ASYNC_DATA_BUFFER_SIZE];
+    }
+    if (!ReadFile(data->handle, operation->buffer, space, NULL,
+                  &operation->overlapped)) {
+      error = GetLastError();
+      if (error == ERROR_IO_PENDING) {
+        error = 0;
+      } else if (error != ERROR_BROKEN_PIPE) {
+        OLA_WARN << "ReadFile failed for " << data->handle << " with "
+                 << error;
+        ReleaseOperation(operation);
+        return false;
+      }
+    }
+  }
+
+  if (error) {
+    // Nothing is queued for operations that fail straight away, so post the
+    // completion ourselves. The read callback, or the close handler, deals
+    // with the error.
+    operation->error = error;
+    if (!PostQueuedCompletionStatus(m_port, 0, OPERATION_KEY,
+                                    &operation->overlapped)) {
+      OLA_WARN << "PostQueuedCompletionStatus failed with "
+               << GetLastError();
+      ReleaseOperation(operation);
+      return false;
+    }
+  }
+
+  operation->data = data;
+  data->read_operation = operation;
+  m_pending_operations.insert(operation);
+  return true;
+}
+
+/*
+ * Cancel the outstanding receive. The operation is released when the
+ * completion arrives.
+ */
+void IOCPPoller::CancelRead(IOCPData *data) {
+  IOCPOperation *operation = data->read_operation;
+  if (!operation) {
+    return;
+  }
+  if (!operation->error) {
+    CancelIoEx(data->handle, &operation->overlapped);
+  }
+  operation->data = NULL;
+  data->read_operation = NULL;
+}
+
+/*
+ * Select the network events for a socket and wait for them. Calling
+ * WSAEventSelect() again records FD_WRITE straight away if the socket is
+ * writable, which gives the same level triggered behaviour as the other
+ * pollers.
+ */
+bool IOCPPoller::ArmEvents(IOCPData *data) {
+  DisarmEvents(data);
+
+  long mask = 0;  // NOLINT(runtime/int)
+  if (data->listening && (data->flags & FLAG_READ)) {
+    mask |= FD_ACCEPT;
+  }
+  if (data->flags & FLAG_WRITE) {
+    mask |= FD_WRITE | FD_CONNECT;
+  }
+
+  if (!mask) {
+    if (data->event_mask) {
+      WSAEventSelect(data->socket, NULL, 0);
+      data->event_mask = 0;
+    }
+    return true;
+  }
+
+  if (data->event == WSA_INVALID_EVENT) {
+    data->event = WSACreateEvent();
+    if (data->event == WSA_INVALID_EVENT) {
+      OLA_WARN << "WSACreateEvent failed with " << WSAGetLastError();
+      return false;
+    }
+  }
+
+  if (WSAEventSelect(data->socket, data->event, mask) != 0) {
+    OLA_WARN << "WSAEventSelect failed with " << WSAGetLastError();
+    return false;
+  }
+  data->event_mask = mask;
+
+  data->token = m_next_token++;
+  data->port = m_port;
+  if (!RegisterWaitForSingleObject(&data->wait, data->event,
+                                   &IOCPPoller::EventSignalled, data,
+                                   INFINITE,
+                                   WT_EXECUTEINWAITTHREAD |
+                                   WT_EXECUTEONLYONCE)) {
+    OLA_WARN << "RegisterWaitForSingleObject failed with " << GetLastError();
+    data->wait = NULL;
+    data->token = 0;
+    return false;
+  }
+  m_tokens[data->token] = data;
+  return true;
+}
+
+/*
+ * Remove the wait, this blocks until any running callback has finished.
+ */
+void IOCPPoller::DisarmEvents(IOCPData *data) {
+  if (data->wait) {
+    UnregisterWaitEx(data->wait, INVALID_HANDLE_VALUE);
+    data->wait = NULL;
+  }
+  if (data->token) {
+    m_tokens.erase(data->token);
+    data->token = 0;
+  }
+}
+
+bool IOCPPoller::RemoveDescriptor(const DescriptorHandle &handle,
+                                  int flag,
+                                  bool warn_on_missing) {
+  if (!handle.IsValid()) {
+    OLA_WARN << "Attempt to remove an invalid file descriptor";
+    return false;
+  }
+
+  IOCPData *data = STLFindOrNull(m_descriptor_map, ToHandle(handle));
+  if (!data) {
+    if (warn_on_missing) {
+      OLA_WARN << "Couldn't find IOCPData for " << handle;
+    }
+    return false;
+  }
+
+  data->flags &= ~flag;
+
+  if (flag & FLAG_READ) {
+    data->connected_descriptor = NULL;
+    data->read_descriptor = NULL;
+    CancelRead(data);
+  } else if (flag & FLAG_WRITE) {
+    data->write_descriptor = NULL;
+  }
+
+  if (data->type == SOCKET_DESCRIPTOR) {
+    ArmEvents(data);
+  }
+
+  if (data->flags == 0) {
+    data->orphaned = true;
+    if (data->type == PIPE_DESCRIPTOR) {
+      m_pipes.erase(std::find(m_pipes.begin(), m_pipes.end(), data));
+    }
+    m_orphaned_descriptors.push_back(
+        STLLookupAndRemovePtr(&m_descriptor_map, ToHandle(handle)));
+  }
+  return true;
+}
+
+/*
+ * Find the pipes with buffered data, or in the write set. These are
+ * dispatched without waiting.
+ */
+void IOCPPoller::CheckPipes() {
+  m_ready_pipes.clear();
+  DescriptorList::iterator iter = m_pipes.begin();
+  for (; iter != m_pipes.end(); ++iter) {
+    IOCPData *data = *iter;
+    if (((data->flags & FLAG_READ) && *data->async_data_size) ||
+        data->write_descriptor) {
+      m_ready_pipes.push_back(data);
+    }
+  }
+}
+
+void IOCPPoller::HandleCompletion(const OVERLAPPED_ENTRY &entry) {
+  if (entry.lpCompletionKey != OPERATION_KEY) {
+    TokenMap::iterator iter = m_tokens.find(entry.lpCompletionKey);
+    if (iter == m_tokens.end()) {
+      // A wait that was removed or replaced.
+      return;
+    }
+    IOCPData *data = iter->second;
+    m_tokens.erase(iter);
+    data->token = 0;
+
+    HandleEvents(data);
+    // The wait was one-shot, so re-arm it unless the descriptor was removed.
+    if (!data->orphaned && !data->token) {
+      ArmEvents(data);
+    }
+    return;
+  }
+
+  IOCPOperation *operation = reinterpret_cast<IOCPOperation*>(
+      entry.lpOverlapped);
+  if (!m_pending_operations.erase(operation)) {
+    // Not one of ours.
+    return;
+  }
+
+  IOCPData *data = operation->data;
+  if (data) {
+    data->read_operation = NULL;
+    HandleReadCompletion(data, operation);
+  }
+  ReleaseOperation(operation);
+
+  if (data && !data->orphaned && (data->flags & FLAG_READ) &&
+      !data->read_operation) {
+    ArmRead(data);
+  }
+}
+
+void IOCPPoller::HandleReadCompletion(IOCPData *data,
+                                      IOCPOperation *operation) {
+  DWORD bytes_transferred = 0;
+  DWORD error = operation->error;
+  if (!error && !GetOverlappedResult(data->handle, &operation->overlapped,
+                                     &bytes_transferred, FALSE)) {
+    error = GetLastError();
+  }
+
+  if (error == ERROR_OPERATION_ABORTED) {
+    return;
+  }
+
+  if (data->type == PIPE_DESCRIPTOR) {
+    if (error == ERROR_BROKEN_PIPE) {
+      OLA_DEBUG << "Broken pipe: " << data->handle;
+      HandleClose(data);
+      return;
+    } else if (error) {
+      OLA_WARN << "ReadFile failed for " << data->handle << " with "
+               << error;
+      return;
+    }
+
+    // The callbacks only take data out of the buffer, so there's still the
+    // space there was when the read started.
+    memcpy(data->async_data + *data->async_data_size, operation->buffer,
+           bytes_transferred);
+    *data->async_data_size += bytes_transferred;
+    if (data->connected_descriptor) {
+      DispatchRead(data->connected_descriptor);
+    } else if (data->read_descriptor) {
+      DispatchRead(data->read_descriptor);
+    }
+    return;
+  }
+
+  // Errors such as WSAEMSGSIZE and WSAECONNRESET are reported by the next
+  // receive, so treat them as readable.
+  if (data->read_descriptor) {
+    DispatchRead(data->read_descriptor);
+  } else if (data->connected_descriptor) {
+    if (data->connected_descriptor->IsClosed()) {
+      HandleClose(data);
+    } else {
+      DispatchRead(data->connected_descriptor);
+    }
+  }
+}
+
+void IOCPPoller::HandleEvents(IOCPData *data) {
+  WSANETWORKEVENTS events;
+  if (WSAEnumNetworkEvents(data->socket, data->event, &events) != 0) {
+    OLA_WARN << "WSAEnumNetworkEvents failed with " << WSAGetLastError();
+    return;
+  }
+
+  if (events.lNetworkEvents & FD_ACCEPT) {
+    if (data->read_descriptor) {
+      DispatchRead(data->read_descriptor);
+    } else if (data->connected_descriptor) {
+      DispatchRead(data->connected_descriptor);
+    }
+  }
+
+  // data->write_descriptor may be null here if this descriptor was
+  // removed by the read callback.
+  if ((events.lNetworkEvents & (FD_WRITE | FD_CONNECT)) &&
+      data->write_descriptor) {
+    DispatchWrite(data->write_descriptor);
+  }
+}
+
+/*
+ * Run the on close handler for a connected descriptor.
+ */
+void IOCPPoller::HandleClose(IOCPData *data) {
+  if (data->read_descriptor) {
+    DispatchRead(data->read_descriptor);
+    return;
+  }
+
+  if (!data->connected_descriptor) {
+    return;
+  }
+
+  ConnectedDescriptor::OnCloseCallback *on_close =
+      data->connected_descriptor->TransferOnClose();
+  if (on_close)
+    DispatchClose(data->connected_descriptor, on_close);
+
+  // At this point the descriptor may be sitting in the orphan list if the
+  // OnClose handler called into RemoveReadDescriptor()
+  if (data->delete_connected_on_close && data->connected_descriptor) {
+    bool removed = RemoveDescriptor(
+        data->connected_descriptor->ReadDescriptor(), FLAG_READ, false);
+    if (removed && m_export_map) {
+      (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+    }
+    delete data->connected_descriptor;
+    data->connected_descriptor = NULL;
+  }
+}
+
+IOCPOperation *IOCPPoller::NewOperation() {
+  if (m_free_operations.empty()) {
+    return new IOCPOperation();
+  }
+  IOCPOperation *operation = m_free_operations.back();
+  m_free_operations.pop_back();
+  operation->Reset();
+  return operation;
+}
+
+void IOCPPoller::ReleaseOperation(IOCPOperation *operation) {
+  if (m_free_operations.size() < MAX_FREE_OPERATIONS) {
+    m_free_operations.push_back(operation);
+  } else {
+    delete operation;
+  }
+}
+
+/*
+ * Called on a thread pool thread when a socket's event is signalled.
+ */
+void CALLBACK IOCPPoller::EventSignalled(void *context, BOOLEAN timed_out) {
+  IOCPData *data = static_cast<IOCPData*>(context);
+  PostQueuedCompletionStatus(data->port, 0, data->token, NULL);
+  (void) timed_out;
+}
+}  // namespace io
+}  // namespace ola
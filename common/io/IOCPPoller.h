@@ -0,0 +1,155 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOCPPoller.h
+ * A Poller which uses an I/O completion port on Windows.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_IOCPPOLLER_H_
+#define COMMON_IO_IOCPPOLLER_H_
+
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <ola/win/CleanWindows.h>
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/io/PollerInterface.h"
+#include "common/io/TimeoutManager.h"
+
+namespace ola {
+namespace io {
+
+class IOCPData;
+class IOCPOperation;
+
+/**
+ * @class IOCPPoller
+ * @brief An implementation of PollerInterface that uses an I/O completion
+ * port.
+ *
+ * Unlike the WindowsPoller, nothing is set up per loop iteration and there's
+ * no limit on the number of descriptors.
+ *
+ *  - Sockets have an overlapped, zero byte, MSG_PEEK receive outstanding
+ *    while they're in the read set. The completion means there's a datagram
+ *    or stream data waiting, which the read callback then receives as usual.
+ *  - Pipes have an overlapped ReadFile() outstanding, into a buffer from the
+ *    operation pool. The data is copied to the descriptor's async buffer.
+ *  - Write readiness, and accepts on listening sockets, use WSAEventSelect().
+ *    The event is waited on by the thread pool, which posts a packet to the
+ *    port when it's signalled.
+ *
+ * The operations are pooled, so a busy loop doesn't allocate. This needs
+ * Windows Vista or later. Call Init() to create the port.
+ */
+class IOCPPoller : public PollerInterface {
+ public :
+  /**
+   * @brief Create a new IOCPPoller.
+   * @param export_map the ExportMap to use
+   * @param clock the Clock to use
+   */
+  IOCPPoller(ExportMap *export_map, Clock *clock);
+
+  ~IOCPPoller();
+
+  /**
+   * @brief Create the completion port.
+   * @returns false if the port couldn't be created, in which case another
+   *   poller should be used.
+   */
+  bool Init();
+
+  bool AddReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool AddReadDescriptor(class ConnectedDescriptor *descriptor,
+                         bool delete_on_close);
+  bool RemoveReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool RemoveReadDescriptor(class ConnectedDescriptor *descriptor);
+
+  bool AddWriteDescriptor(class WriteFileDescriptor *descriptor);
+  bool RemoveWriteDescriptor(class WriteFileDescriptor *descriptor);
+
+  const TimeStamp *WakeUpTime() const { return &m_wake_up_time; }
+
+  bool Poll(TimeoutManager *timeout_manager,
+            const TimeInterval &poll_interval);
+
+ private:
+  typedef std::map<void*, IOCPData*> DescriptorMap;
+  typedef std::map<ULONG_PTR, IOCPData*> TokenMap;
+  typedef std::vector<IOCPData*> DescriptorList;
+  typedef std::vector<IOCPOperation*> OperationList;
+
+  DescriptorMap m_descriptor_map;
+  // Maps the completion key posted for each registered wait to the
+  // descriptor. Packets for waits that have since been removed aren't in
+  // here, and are dropped.
+  TokenMap m_tokens;
+  // The pipes, since these are checked on every iteration.
+  DescriptorList m_pipes;
+  // As with the other pollers, removed descriptors are moved here and
+  // cleaned up once we're out of the callback loop.
+  DescriptorList m_orphaned_descriptors;
+  DescriptorList m_ready_pipes;
+  // Operations the kernel still owns. Completions for anything else, such as
+  // an overlapped call made by the descriptor itself, are ignored.
+  std::set<IOCPOperation*> m_pending_operations;
+  OperationList m_free_operations;
+  ExportMap *m_export_map;
+  CounterVariable *m_loop_iterations;
+  CounterVariable *m_loop_time;
+  HANDLE m_port;
+  ULONG_PTR m_next_token;
+  Clock *m_clock;
+  TimeStamp m_wake_up_time;
+
+  std::pair<IOCPData*, bool> LookupOrCreateDescriptor(
+      const DescriptorHandle &handle);
+  bool Associate(IOCPData *data);
+  bool ArmRead(IOCPData *data);
+  void CancelRead(IOCPData *data);
+  bool ArmEvents(IOCPData *data);
+  void DisarmEvents(IOCPData *data);
+  bool RemoveDescriptor(const DescriptorHandle &handle, int flag,
+                        bool warn_on_missing);
+  void CheckPipes();
+  void HandleCompletion(const OVERLAPPED_ENTRY &entry);
+  void HandleReadCompletion(IOCPData *data, IOCPOperation *operation);
+  void HandleEvents(IOCPData *data);
+  void HandleClose(IOCPData *data);
+
+  IOCPOperation *NewOperation();
+  void ReleaseOperation(IOCPOperation *operation);
+
+  static void CALLBACK EventSignalled(void *context, BOOLEAN timed_out);
+
+  static const ULONG_PTR OPERATION_KEY;
+  static const unsigned int MAX_EVENTS;
+  static const unsigned int MAX_FREE_OPERATIONS;
+
+  DISALLOW_COPY_AND_ASSIGN(IOCPPoller);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_IOCPPOLLER_H_
@@ -228,8 +228,11 @@ void IOQueue::AppendMove(IOQueue *other) {
  */
 void IOQueue::Clear() {
   BlockVector::iterator iter = m_blocks.begin();
-  for (; iter != m_blocks.end(); ++iter)
+  for (; iter != m_blocks.end(); ++iter) {
+    // Empty the block so the data isn't seen by the block's next user.
+    (*iter)->PopFront((*iter)->Size());
     m_pool->Release(*iter);
+  }
   m_blocks.clear();
 }
 
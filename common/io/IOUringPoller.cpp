@@ -0,0 +1,661 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.cpp
+ * A Poller which uses io_uring()
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/IOUringPoller.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+using std::pair;
+
+/*
+ * Represents a FD
+ */
+class IOUringData {
+ public:
+  explicit IOUringData(int fd)
+      : fd(fd),
+        events(0),
+        token(0),
+        armed_events(0),
+        read_descriptor(NULL),
+        write_descriptor(NULL),
+        connected_descriptor(NULL),
+        delete_connected_on_close(false) {
+  }
+
+  int fd;
+  uint32_t events;
+  // The user_data of the armed poll, or 0 if there isn't one.
+  uint64_t token;
+  // The events the armed poll is waiting for.
+  uint32_t armed_events;
+  ReadFileDescriptor *read_descriptor;
+  WriteFileDescriptor *write_descriptor;
+  ConnectedDescriptor *connected_descriptor;
+  bool delete_connected_on_close;
+};
+
+/*
+ * The submission and completion rings. We use the system calls directly,
+ * rather than liburing, so there's no extra dependency.
+ */
+class IOUring {
+ public:
+  IOUring()
+      : m_fd(INVALID_DESCRIPTOR),
+        m_sq_ring(MAP_FAILED),
+        m_cq_ring(MAP_FAILED),
+        m_sq_ring_size(0),
+        m_cq_ring_size(0),
+        m_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+        m_sqes_size(0) {
+  }
+
+  ~IOUring();
+
+  bool Init(unsigned int entries);
+
+  /*
+   * Queue a one-shot poll for a descriptor.
+   */
+  bool PrepPoll(int fd, uint32_t events, uint64_t user_data) {
+    struct io_uring_sqe *sqe = GetSQE();
+    if (!sqe)
+      return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    // The kernel reads the events as two 16 bit halves.
+    events = (events << 16) | (events >> 16);
+#endif  // __BYTE_ORDER == __BIG_ENDIAN
+    sqe->poll32_events = events;
+    sqe->user_data = user_data;
+    Commit();
+    return true;
+  }
+
+  /*
+   * Queue the removal of a poll.
+   */
+  bool PrepPollRemove(uint64_t target) {
+    struct io_uring_sqe *sqe = GetSQE();
+    if (!sqe)
+      return false;
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = 0;
+    Commit();
+    return true;
+  }
+
+  /*
+   * Submit the queued entries and wait for a completion.
+   * Returns 0 or -errno.
+   */
+  int SubmitAndWait(const TimeInterval &timeout);
+
+  /*
+   * Pop the next completion, returns false if there are none.
+   */
+  bool NextCompletion(uint64_t *user_data, int32_t *result) {
+    unsigned int head = *m_cq_head;
+    if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+      return false;
+    const struct io_uring_cqe &cqe = m_cqes[head & *m_cq_mask];
+    *user_data = cqe.user_data;
+    *result = cqe.res;
+    __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+ private:
+  int m_fd;
+  void *m_sq_ring;
+  void *m_cq_ring;
+  size_t m_sq_ring_size;
+  size_t m_cq_ring_size;
+  struct io_uring_sqe *m_sqes;
+  size_t m_sqes_size;
+  unsigned int m_sq_entries;
+
+  unsigned int *m_sq_head;
+  unsigned int *m_sq_tail;
+  unsigned int *m_sq_mask;
+  unsigned int *m_sq_array;
+  unsigned int *m_cq_head;
+  unsigned int *m_cq_tail;
+  unsigned int *m_cq_mask;
+  struct io_uring_cqe *m_cqes;
+
+  unsigned int Pending() const {
+    return *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+  }
+
+  int Enter(unsigned int to_submit, unsigned int min_complete,
+            unsigned int flags, void *arg, size_t arg_size) {
+    int r = syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, flags,
+                    arg, arg_size);
+    return r < 0 ? -errno : r;
+  }
+
+  struct io_uring_sqe *GetSQE();
+
+  void Commit() {
+    __atomic_store_n(m_sq_tail, *m_sq_tail + 1, __ATOMIC_RELEASE);
+  }
+
+  template <typename T>
+  static T *Offset(void *base, unsigned int offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(IOUring);
+};
+
+
+IOUring::~IOUring() {
+  if (m_sqes != MAP_FAILED)
+    munmap(m_sqes, m_sqes_size);
+  if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+    munmap(m_cq_ring, m_cq_ring_size);
+  if (m_sq_ring != MAP_FAILED)
+    munmap(m_sq_ring, m_sq_ring_size);
+  if (m_fd != INVALID_DESCRIPTOR)
+    close(m_fd);
+}
+
+bool IOUring::Init(unsigned int entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  m_fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (m_fd < 0) {
+    OLA_WARN << "io_uring_setup failed: " << strerror(errno);
+    m_fd = INVALID_DESCRIPTOR;
+    return false;
+  }
+
+  if (!(params.features & IORING_FEAT_EXT_ARG)) {
+    OLA_WARN << "io_uring doesn't support IORING_ENTER_EXT_ARG";
+    return false;
+  }
+
+  m_sq_entries = params.sq_entries;
+  m_sq_ring_size = params.sq_off.array +
+                   params.sq_entries * sizeof(unsigned int);
+  m_cq_ring_size = params.cq_off.cqes +
+                   params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    m_sq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+  }
+
+  m_sq_ring = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring SQ: " << strerror(errno);
+    return false;
+  }
+
+  if (single_mmap) {
+    m_cq_ring = m_sq_ring;
+  } else {
+    m_cq_ring = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      OLA_WARN << "Failed to map the io_uring CQ: " << strerror(errno);
+      return false;
+    }
+  }
+
+  m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  m_sqes = static_cast<struct io_uring_sqe*>(
+      mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+  if (m_sqes == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring SQEs: " << strerror(errno);
+    return false;
+  }
+
+  m_sq_head = Offset<unsigned int>(m_sq_ring, params.sq_off.head);
+  m_sq_tail = Offset<unsigned int>(m_sq_ring, params.sq_off.tail);
+  m_sq_mask = Offset<unsigned int>(m_sq_ring, params.sq_off.ring_mask);
+  m_sq_array = Offset<unsigned int>(m_sq_ring, params.sq_off.array);
+  m_cq_head = Offset<unsigned int>(m_cq_ring, params.cq_off.head);
+  m_cq_tail = Offset<unsigned int>(m_cq_ring, params.cq_off.tail);
+  m_cq_mask = Offset<unsigned int>(m_cq_ring, params.cq_off.ring_mask);
+  m_cqes = Offset<struct io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+  return true;
+}
+
+int IOUring::SubmitAndWait(const TimeInterval &timeout) {
+  struct __kernel_timespec ts;
+  ts.tv_sec = timeout.Seconds();
+  ts.tv_nsec = timeout.MicroSeconds() * ONE_THOUSAND;
+
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = reinterpret_cast<uintptr_t>(&ts);
+
+  int r = Enter(Pending(), 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                &arg, sizeof(arg));
+  return r < 0 ? r : 0;
+}
+
+struct io_uring_sqe *IOUring::GetSQE() {
+  if (Pending() >= m_sq_entries) {
+    // The queue is full, hand what we have to the kernel.
+    int r = Enter(Pending(), 0, 0, NULL, 0);
+    if (r < 0) {
+      OLA_WARN << "io_uring_enter failed: " << strerror(-r);
+      return NULL;
+    }
+    if (Pending() >= m_sq_entries)
+      return NULL;
+  }
+
+  unsigned int index = *m_sq_tail & *m_sq_mask;
+  struct io_uring_sqe *sqe = &m_sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  m_sq_array[index] = index;
+  return sqe;
+}
+
+
+/**
+ * @brief The number of submission queue entries.
+ */
+const unsigned int IOUringPoller::RING_SIZE = 256;
+
+/**
+ * @brief The poll flags used for read descriptors.
+ */
+const int IOUringPoller::READ_FLAGS = POLLIN | POLLRDHUP;
+
+IOUringPoller::IOUringPoller(ExportMap *export_map, Clock* clock)
+    : m_export_map(export_map),
+      m_loop_iterations(NULL),
+      m_loop_time(NULL),
+      m_ring(NULL),
+      m_next_token(1),
+      m_clock(clock) {
+  if (m_export_map) {
+    m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
+    m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+  }
+}
+
+IOUringPoller::~IOUringPoller() {
+  delete m_ring;
+
+  {
+    DescriptorMap::iterator iter = m_descriptor_map.begin();
+    for (; iter != m_descriptor_map.end(); ++iter) {
+      if (iter->second->delete_connected_on_close) {
+        delete iter->second->connected_descriptor;
+      }
+      delete iter->second;
+    }
+  }
+
+  DescriptorList::iterator iter = m_orphaned_descriptors.begin();
+  for (; iter != m_orphaned_descriptors.end(); ++iter) {
+    if ((*iter)->delete_connected_on_close) {
+      delete (*iter)->connected_descriptor;
+    }
+    delete *iter;
+  }
+}
+
+bool IOUringPoller::Init() {
+  if (m_ring) {
+    return true;
+  }
+
+  IOUring *ring = new IOUring();
+  if (!ring->Init(RING_SIZE)) {
+    delete ring;
+    return false;
+  }
+  m_ring = ring;
+  return true;
+}
+
+bool IOUringPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (result.first->events & READ_FLAGS) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->events |= READ_FLAGS;
+  result.first->read_descriptor = descriptor;
+  return Arm(result.first);
+}
+
+bool IOUringPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
+                                      bool delete_on_close) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+
+  if (result.first->events & READ_FLAGS) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->events |= READ_FLAGS;
+  result.first->connected_descriptor = descriptor;
+  result.first->delete_connected_on_close = delete_on_close;
+  return Arm(result.first);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), READ_FLAGS, true);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), READ_FLAGS, true);
+}
+
+bool IOUringPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
+  if (!m_ring) {
+    return false;
+  }
+
+  if (!descriptor->ValidWriteDescriptor()) {
+    OLA_WARN << "AddWriteDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->WriteDescriptor());
+
+  if (result.first->events & POLLOUT) {
+    OLA_WARN << "Descriptor " << descriptor->WriteDescriptor()
+             << " already in write set";
+    return false;
+  }
+
+  result.first->events |= POLLOUT;
+  result.first->write_descriptor = descriptor;
+  return Arm(result.first);
+}
+
+bool IOUringPoller::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->WriteDescriptor(), POLLOUT, true);
+}
+
+bool IOUringPoller::Poll(TimeoutManager *timeout_manager,
+                         const TimeInterval &poll_interval) {
+  if (!m_ring) {
+    return false;
+  }
+
+  TimeInterval sleep_interval = poll_interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  TimeInterval next_event_in = timeout_manager->ExecuteTimeouts(&now);
+  if (!next_event_in.IsZero()) {
+    sleep_interval = std::min(next_event_in, sleep_interval);
+  }
+
+  // take care of stats accounting
+  if (m_wake_up_time.IsSet()) {
+    TimeInterval loop_time = now - m_wake_up_time;
+    OLA_DEBUG << "ss process time was " << loop_time.ToString();
+    if (m_loop_time)
+      (*m_loop_time) += loop_time.AsInt();
+    if (m_loop_iterations)
+      (*m_loop_iterations)++;
+  }
+
+  // This submits the polls queued since the last call, and then waits.
+  int r = m_ring->SubmitAndWait(sleep_interval);
+  if (r == -EINTR) {
+    return true;
+  } else if (r < 0 && r != -ETIME) {
+    OLA_WARN << "io_uring_enter() error, " << strerror(-r);
+    return false;
+  }
+
+  m_clock->CurrentTime(&m_wake_up_time);
+
+  // Take the completions off the ring before running any callbacks, since
+  // they may add & remove descriptors.
+  m_completions.clear();
+  Completion completion;
+  while (m_ring->NextCompletion(&completion.token, &completion.result)) {
+    m_completions.push_back(completion);
+  }
+
+  std::vector<Completion>::const_iterator c_iter = m_completions.begin();
+  for (; c_iter != m_completions.end(); ++c_iter) {
+    TokenMap::iterator token_iter = m_tokens.find(c_iter->token);
+    if (token_iter == m_tokens.end()) {
+      // A poll removal, or a poll that was removed or replaced.
+      continue;
+    }
+
+    IOUringData *data = token_iter->second;
+    m_tokens.erase(token_iter);
+    data->token = 0;
+
+    if (c_iter->result < 0) {
+      if (c_iter->result != -ECANCELED) {
+        OLA_WARN << "io_uring poll for " << data->fd << " failed: "
+                 << strerror(-c_iter->result);
+      }
+    } else {
+      CheckDescriptor(c_iter->result, data);
+    }
+
+    // The poll was one-shot, so re-arm it unless the callbacks already did,
+    // or removed the descriptor.
+    if (data->events && !data->token) {
+      Arm(data);
+    }
+  }
+
+  // Now that we're out of the callback phase, clean up descriptors that were
+  // removed.
+  STLDeleteElements(&m_orphaned_descriptors);
+
+  m_clock->CurrentTime(&m_wake_up_time);
+  timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+  return true;
+}
+
+
+/*
+ * Check a descriptor that's ready:
+ *  - Execute the callback for descriptors with data
+ *  - Excute OnClose if a remote end closed the connection
+ */
+void IOUringPoller::CheckDescriptor(uint32_t events, IOUringData *data) {
+  if (events & (POLLHUP | POLLRDHUP)) {
+    if (data->read_descriptor) {
+      DispatchRead(data->read_descriptor);
+    } else if (data->write_descriptor) {
+      DispatchWrite(data->write_descriptor);
+    } else if (data->connected_descriptor) {
+      ConnectedDescriptor::OnCloseCallback *on_close =
+          data->connected_descriptor->TransferOnClose();
+      if (on_close)
+        DispatchClose(data->connected_descriptor, on_close);
+
+      // At this point the descriptor may be sitting in the orphan list if the
+      // OnClose handler called into RemoveReadDescriptor()
+      if (data->delete_connected_on_close && data->connected_descriptor) {
+        bool removed = RemoveDescriptor(
+            data->connected_descriptor->ReadDescriptor(), READ_FLAGS, false);
+        if (removed && m_export_map) {
+          (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+        }
+        delete data->connected_descriptor;
+        data->connected_descriptor = NULL;
+      }
+    } else {
+      OLA_FATAL << "HUP event for " << data
+                << " but no write or connected descriptor found!";
+    }
+    return;
+  }
+
+  // A pending socket error is cleared by the next read, so treat it as
+  // readable, otherwise the re-armed poll would complete straight away.
+  if (events & (POLLIN | POLLERR)) {
+    if (data->read_descriptor) {
+      DispatchRead(data->read_descriptor);
+    } else if (data->connected_descriptor) {
+      DispatchRead(data->connected_descriptor);
+    }
+  }
+
+  if (events & (POLLOUT | POLLERR)) {
+    // data->write_descriptor may be null here if this descriptor was
+    // removed by the read callback.
+    if (data->write_descriptor) {
+      DispatchWrite(data->write_descriptor);
+    }
+  }
+}
+
+std::pair<IOUringData*, bool> IOUringPoller::LookupOrCreateDescriptor(
+    int fd) {
+  pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
+      DescriptorMap::value_type(fd, NULL));
+  bool new_descriptor = result.second;
+
+  if (new_descriptor) {
+    result.first->second = new IOUringData(fd);
+  }
+  return std::make_pair(result.first->second, new_descriptor);
+}
+
+/*
+ * Queue a poll for the descriptor's events, replacing any existing poll.
+ */
+bool IOUringPoller::Arm(IOUringData *data) {
+  if (data->token) {
+    if (data->armed_events == data->events) {
+      return true;
+    }
+    Disarm(data);
+  }
+
+  uint64_t token = m_next_token++;
+  if (!m_ring->PrepPoll(data->fd, data->events, token)) {
+    OLA_WARN << "Failed to queue io_uring poll for " << data->fd;
+    return false;
+  }
+  data->token = token;
+  data->armed_events = data->events;
+  m_tokens[token] = data;
+  return true;
+}
+
+void IOUringPoller::Disarm(IOUringData *data) {
+  if (!data->token) {
+    return;
+  }
+  // Even if the removal can't be queued, dropping the token means the
+  // completion is ignored.
+  m_ring->PrepPollRemove(data->token);
+  m_tokens.erase(data->token);
+  data->token = 0;
+}
+
+bool IOUringPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
+  if (fd == INVALID_DESCRIPTOR) {
+    OLA_WARN << "Attempt to remove an invalid file descriptor";
+    return false;
+  }
+
+  IOUringData *data = STLFindOrNull(m_descriptor_map, fd);
+  if (!data) {
+    if (warn_on_missing) {
+      OLA_WARN << "Couldn't find IOUringData for " << fd;
+    }
+    return false;
+  }
+
+  data->events &= (~event);
+
+  if (event & POLLOUT) {
+    data->write_descriptor = NULL;
+  } else if (event & POLLIN) {
+    data->read_descriptor = NULL;
+    data->connected_descriptor = NULL;
+  }
+
+  if (data->events == 0) {
+    Disarm(data);
+    m_orphaned_descriptors.push_back(
+        STLLookupAndRemovePtr(&m_descriptor_map, fd));
+  } else {
+    return Arm(data);
+  }
+  return true;
+}
+}  // namespace io
+}  // namespace ola
@@ -0,0 +1,131 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.h
+ * A Poller which uses io_uring()
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_IOURINGPOLLER_H_
+#define COMMON_IO_IOURINGPOLLER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/io/Descriptor.h>
+#include <stdint.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "common/io/PollerInterface.h"
+#include "common/io/TimeoutManager.h"
+
+namespace ola {
+namespace io {
+
+class IOUring;
+class IOUringData;
+
+/**
+ * @class IOUringPoller
+ * @brief An implementation of PollerInterface that uses io_uring.
+ *
+ * Each descriptor has a one-shot poll request in the submission queue. When
+ * it completes the descriptor's callbacks are run and the poll is re-armed.
+ * All the new and re-armed polls are submitted by the same io_uring_enter()
+ * call that waits for the next completions, so a busy loop iteration costs a
+ * single system call, rather than an epoll_wait() plus an epoll_ctl() for
+ * each change.
+ *
+ * One-shot polls check the descriptor state when they're armed, so this
+ * keeps the level-triggered behaviour of the other pollers.
+ *
+ * This needs Linux 5.11 or later. Call Init() to check the kernel supports
+ * it.
+ */
+class IOUringPoller : public PollerInterface {
+ public :
+  /**
+   * @brief Create a new IOUringPoller.
+   * @param export_map the ExportMap to use
+   * @param clock the Clock to use
+   */
+  IOUringPoller(ExportMap *export_map, Clock *clock);
+
+  ~IOUringPoller();
+
+  /**
+   * @brief Set up the ring.
+   * @returns false if io_uring isn't available, in which case another poller
+   *   should be used.
+   */
+  bool Init();
+
+  bool AddReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool AddReadDescriptor(class ConnectedDescriptor *descriptor,
+                         bool delete_on_close);
+  bool RemoveReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool RemoveReadDescriptor(class ConnectedDescriptor *descriptor);
+
+  bool AddWriteDescriptor(class WriteFileDescriptor *descriptor);
+  bool RemoveWriteDescriptor(class WriteFileDescriptor *descriptor);
+
+  const TimeStamp *WakeUpTime() const { return &m_wake_up_time; }
+
+  bool Poll(TimeoutManager *timeout_manager,
+            const TimeInterval &poll_interval);
+
+ private:
+  typedef std::map<int, IOUringData*> DescriptorMap;
+  typedef std::map<uint64_t, IOUringData*> TokenMap;
+  typedef std::vector<IOUringData*> DescriptorList;
+
+  struct Completion {
+    uint64_t token;
+    int32_t result;
+  };
+
+  DescriptorMap m_descriptor_map;
+  // Maps the user_data of each armed poll to the descriptor. Completions for
+  // polls that have been removed or replaced aren't in here, and are dropped.
+  TokenMap m_tokens;
+  // As with the EPoller, removed descriptors are moved here and cleaned up
+  // once we're out of the callback loop.
+  DescriptorList m_orphaned_descriptors;
+  std::vector<Completion> m_completions;
+  ExportMap *m_export_map;
+  CounterVariable *m_loop_iterations;
+  CounterVariable *m_loop_time;
+  IOUring *m_ring;
+  uint64_t m_next_token;
+  Clock *m_clock;
+  TimeStamp m_wake_up_time;
+
+  std::pair<IOUringData*, bool> LookupOrCreateDescriptor(int fd);
+  bool Arm(IOUringData *data);
+  void Disarm(IOUringData *data);
+  bool RemoveDescriptor(int fd, int event, bool warn_on_missing);
+  void CheckDescriptor(uint32_t events, IOUringData *data);
+
+  static const unsigned int RING_SIZE;
+  static const int READ_FLAGS;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUringPoller);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_IOURINGPOLLER_H_
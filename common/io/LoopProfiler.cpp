@@ -0,0 +1,138 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LoopProfiler.cpp
+ * Records how long the SelectServer's callbacks take.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/LoopProfiler.h"
+
+#include <stdint.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+using std::string;
+
+const unsigned int LoopProfiler::STALL_WARNING_USEC;
+const char LoopProfiler::K_ENABLED_VAR[] = "using-loop-profiler";
+const char LoopProfiler::K_CALLBACK_COUNT_VAR[] = "ss-callback-count";
+const char LoopProfiler::K_CALLBACK_TIME_VAR[] = "ss-callback-time-us";
+const char LoopProfiler::K_CALLBACK_MAX_TIME_VAR[] = "ss-callback-max-us";
+const char LoopProfiler::K_TIMEOUT_LAG_VAR[] = "ss-timeout-lag-us";
+const char LoopProfiler::K_LONGEST_STALL_VAR[] = "ss-longest-stall-us";
+const char LoopProfiler::K_LONGEST_STALL_SITE_VAR[] = "ss-longest-stall";
+
+namespace {
+const char CALLBACK_LABEL[] = "callback";
+const char UNLABELLED[] = "unlabelled";
+}  // namespace
+
+LoopProfiler::Site::Site(ExportMap *export_map, const string &name)
+    : m_name(name),
+      m_count(export_map->GetUIntMapVar(K_CALLBACK_COUNT_VAR,
+                                        CALLBACK_LABEL)->GetHandle(name)),
+      m_time(export_map->GetUIntMapVar(K_CALLBACK_TIME_VAR,
+                                       CALLBACK_LABEL)->GetHandle(name)),
+      m_max_time(export_map->GetUIntMapVar(K_CALLBACK_MAX_TIME_VAR,
+                                           CALLBACK_LABEL)->GetHandle(name)),
+      m_max(0) {
+}
+
+LoopProfiler::LoopProfiler(ExportMap *export_map, const Clock *clock)
+    : m_export_map(export_map),
+      m_clock(clock),
+      m_timeout_lag(export_map->GetHistogramVar(K_TIMEOUT_LAG_VAR)),
+      m_longest_stall(export_map->GetIntegerVar(K_LONGEST_STALL_VAR)),
+      m_longest_stall_site(export_map->GetStringVar(
+          K_LONGEST_STALL_SITE_VAR)) {
+  for (unsigned int i = 0; i < CALLBACK_TYPES; i++) {
+    CallbackType type = static_cast<CallbackType>(i);
+    m_unlabelled[i] = new Site(m_export_map,
+                               string(TypeName(type)) + ":" + UNLABELLED);
+  }
+}
+
+LoopProfiler::~LoopProfiler() {
+  for (unsigned int i = 0; i < CALLBACK_TYPES; i++) {
+    STLDeleteValues(&m_sites[i]);
+    delete m_unlabelled[i];
+  }
+}
+
+LoopProfiler::Site *LoopProfiler::GetSite(CallbackType type,
+                                          const string &label) {
+  if (label.empty()) {
+    return m_unlabelled[type];
+  }
+
+  SiteMap &sites = m_sites[type];
+  SiteMap::iterator iter = sites.find(label);
+  if (iter != sites.end()) {
+    return iter->second;
+  }
+  Site *site = new Site(m_export_map, string(TypeName(type)) + ":" + label);
+  sites.insert(SiteMap::value_type(label, site));
+  return site;
+}
+
+void LoopProfiler::RecordTimeoutLag(const TimeInterval &lag) {
+  int64_t usec = lag.AsInt();
+  m_timeout_lag->Add(usec > 0 ? static_cast<uint32_t>(usec) : 0);
+}
+
+void LoopProfiler::Stop(Site *site, const TimeStamp &start) {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  int64_t elapsed = (now - start).AsInt();
+  unsigned int usec = elapsed > 0 ? static_cast<unsigned int>(elapsed) : 0;
+
+  site->m_count.Increment();
+  site->m_time.Add(usec);
+  if (usec > site->m_max) {
+    site->m_max = usec;
+    site->m_max_time.Set(usec);
+  }
+
+  if (usec > static_cast<unsigned int>(m_longest_stall->Get())) {
+    m_longest_stall->Set(static_cast<int>(usec));
+    m_longest_stall_site->Set(site->Name());
+  }
+  if (usec >= STALL_WARNING_USEC) {
+    OLA_WARN_LIMITED << site->Name() << " blocked the event loop for "
+                     << usec / 1000 << "ms";
+  }
+}
+
+const char *LoopProfiler::TypeName(CallbackType type) {
+  switch (type) {
+    case READ_CALLBACK:
+      return "read";
+    case WRITE_CALLBACK:
+      return "write";
+    case TIMEOUT_CALLBACK:
+      return "timeout";
+  }
+  return "unknown";
+}
+}  // namespace io
+}  // namespace ola
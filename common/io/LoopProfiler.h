@@ -0,0 +1,179 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * LoopProfiler.h
+ * Records how long the SelectServer's callbacks take.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_LOOPPROFILER_H_
+#define COMMON_IO_LOOPPROFILER_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief Records the duration of the callbacks run by the SelectServer.
+ *
+ * Callbacks are grouped into sites by type and the label set when the
+ * descriptor or timeout was registered, e.g. "read:artnet". For each site we
+ * export the number of calls, the total time and the longest call. We also
+ * track how late timeouts run, and the longest callback seen.
+ *
+ * The cost is two clock reads and a few counter updates per callback. Sites
+ * are never removed, so labels should name a component rather than an
+ * instance.
+ */
+class LoopProfiler {
+ public:
+  enum CallbackType {
+    READ_CALLBACK,
+    WRITE_CALLBACK,
+    TIMEOUT_CALLBACK
+  };
+
+  /**
+   * @brief The stats for a group of callbacks.
+   */
+  class Site {
+   public:
+    Site(ExportMap *export_map, const std::string &name);
+
+    const std::string &Name() const { return m_name; }
+
+   private:
+    const std::string m_name;
+    UIntMap::Handle m_count;
+    UIntMap::Handle m_time;
+    UIntMap::Handle m_max_time;
+    unsigned int m_max;
+
+    friend class LoopProfiler;
+
+    DISALLOW_COPY_AND_ASSIGN(Site);
+  };
+
+  /**
+   * @brief Times a callback, from construction until it goes out of scope.
+   *
+   * This does nothing if the profiler is NULL.
+   */
+  class ScopedTimer {
+   public:
+    ScopedTimer(LoopProfiler *profiler, CallbackType type,
+                const std::string &label)
+        : m_profiler(profiler),
+          m_site(NULL) {
+      if (m_profiler) {
+        Start(m_profiler->GetSite(type, label));
+      }
+    }
+
+    ScopedTimer(LoopProfiler *profiler, Site *site)
+        : m_profiler(profiler),
+          m_site(NULL) {
+      if (m_profiler) {
+        Start(site);
+      }
+    }
+
+    ~ScopedTimer() {
+      if (m_profiler) {
+        m_profiler->Stop(m_site, m_start);
+      }
+    }
+
+   private:
+    LoopProfiler *m_profiler;
+    Site *m_site;
+    TimeStamp m_start;
+
+    void Start(Site *site) {
+      m_site = site;
+      m_profiler->m_clock->CurrentTime(&m_start);
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedTimer);
+  };
+
+  /**
+   * @brief Create a new LoopProfiler.
+   * @param export_map the ExportMap to store the stats in.
+   * @param clock the Clock used to time callbacks.
+   */
+  LoopProfiler(ExportMap *export_map, const Clock *clock);
+  ~LoopProfiler();
+
+  /**
+   * @brief Find or create the site for a label.
+   * @param type the type of callback.
+   * @param label the label, if empty the site for unlabelled callbacks of
+   *   this type is returned.
+   * @returns the Site, which is valid for the lifetime of the LoopProfiler.
+   */
+  Site *GetSite(CallbackType type, const std::string &label);
+
+  /**
+   * @brief Record how late a timeout ran.
+   * @param lag the difference between the time the timeout was due and the
+   *   time it ran.
+   */
+  void RecordTimeoutLag(const TimeInterval &lag);
+
+  /**
+   * @brief Callbacks that take longer than this are logged.
+   */
+  static const unsigned int STALL_WARNING_USEC = 100000;
+
+  static const char K_ENABLED_VAR[];
+  static const char K_CALLBACK_COUNT_VAR[];
+  static const char K_CALLBACK_TIME_VAR[];
+  static const char K_CALLBACK_MAX_TIME_VAR[];
+  static const char K_TIMEOUT_LAG_VAR[];
+  static const char K_LONGEST_STALL_VAR[];
+  static const char K_LONGEST_STALL_SITE_VAR[];
+
+ private:
+  typedef std::map<std::string, Site*> SiteMap;
+
+  static const unsigned int CALLBACK_TYPES = TIMEOUT_CALLBACK + 1;
+
+  ExportMap *m_export_map;
+  const Clock *m_clock;
+  SiteMap m_sites[CALLBACK_TYPES];
+  Site *m_unlabelled[CALLBACK_TYPES];
+  HistogramVariable *m_timeout_lag;
+  IntegerVariable *m_longest_stall;
+  StringVariable *m_longest_stall_site;
+
+  void Stop(Site *site, const TimeStamp &start);
+
+  static const char *TypeName(CallbackType type);
+
+  friend class ScopedTimer;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopProfiler);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_LOOPPROFILER_H_
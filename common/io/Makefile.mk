@@ -7,17 +7,26 @@ common_libolacommon_la_SOURCES += \
     common/io/IOQueue.cpp \
     common/io/IOStack.cpp \
     common/io/IOUtils.cpp \
+    common/io/LoopProfiler.cpp \
+    common/io/LoopProfiler.h \
     common/io/NonBlockingSender.cpp \
+    common/io/PeriodicTaskScheduler.cpp \
+    common/io/PeriodicTaskScheduler.h \
     common/io/PollerInterface.cpp \
     common/io/PollerInterface.h \
     common/io/SelectServer.cpp \
     common/io/Serial.cpp \
+    common/io/SharedMemoryBlockPool.cpp \
     common/io/StdinHandler.cpp \
     common/io/TimeoutManager.cpp \
-    common/io/TimeoutManager.h
+    common/io/TimeoutManager.h \
+    common/io/TimingWheel.cpp \
+    common/io/TimingWheel.h
 
 if USING_WIN32
 common_libolacommon_la_SOURCES += \
+    common/io/IOCPPoller.cpp \
+    common/io/IOCPPoller.h \
     common/io/WindowsPoller.cpp \
     common/io/WindowsPoller.h
 else
@@ -38,6 +47,19 @@ common_libolacommon_la_SOURCES += \
     common/io/KQueuePoller.cpp
 endif
 
+if HAVE_IO_URING
+common_libolacommon_la_SOURCES += \
+    common/io/IOUringPoller.h \
+    common/io/IOUringPoller.cpp
+endif
+
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/io/timeout_benchmark
+
+common_io_timeout_benchmark_SOURCES = common/io/TimeoutBenchmark.cpp
+common_io_timeout_benchmark_LDADD = common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += \
@@ -57,11 +79,13 @@ common_io_IOStackTester_SOURCES = common/io/IOStackTest.cpp
 common_io_IOStackTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_IOStackTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_DescriptorTester_SOURCES = common/io/DescriptorTest.cpp
+common_io_DescriptorTester_SOURCES = common/io/DescriptorTest.cpp \
+                                    common/io/NonBlockingSenderTest.cpp
 common_io_DescriptorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_DescriptorTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockTest.cpp
+common_io_MemoryBlockTester_SOURCES = common/io/MemoryBlockTest.cpp \
+                                      common/io/SharedMemoryBlockPoolTest.cpp
 common_io_MemoryBlockTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_MemoryBlockTester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -70,7 +94,10 @@ common_io_SelectServerTester_SOURCES = common/io/SelectServerTest.cpp \
 common_io_SelectServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_SelectServerTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_io_TimeoutManagerTester_SOURCES = common/io/TimeoutManagerTest.cpp
+common_io_TimeoutManagerTester_SOURCES = \
+    common/io/PeriodicTaskSchedulerTest.cpp \
+    common/io/TimeoutManagerTest.cpp \
+    common/io/TimingWheelTest.cpp
 common_io_TimeoutManagerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_TimeoutManagerTester_LDADD = $(COMMON_TESTING_LIBS)
 
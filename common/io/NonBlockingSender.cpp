@@ -34,8 +34,14 @@ NonBlockingSender::NonBlockingSender(ola::io::ConnectedDescriptor *descriptor,
   : m_descriptor(descriptor),
     m_ss(ss),
     m_output_buffer(memory_pool),
+    m_queued_size(0),
     m_associated(false),
-    m_max_buffer_size(max_buffer_size) {
+    m_max_buffer_size(max_buffer_size),
+    m_policy(REJECT_NEW),
+    m_dropped_messages(0) {
+  for (unsigned int i = 0; i < PRIORITY_COUNT; i++) {
+    m_queues[i] = new MessageQueue(memory_pool);
+  }
   m_descriptor->SetOnWritable(
       ola::NewCallback(this, &NonBlockingSender::PerformWrite));
 }
@@ -45,38 +51,92 @@ NonBlockingSender::~NonBlockingSender() {
     m_ss->RemoveWriteDescriptor(m_descriptor);
   }
   m_descriptor->SetOnWritable(NULL);
+  for (unsigned int i = 0; i < PRIORITY_COUNT; i++) {
+    delete m_queues[i];
+  }
 }
 
 bool NonBlockingSender::LimitReached() const {
-  return m_output_buffer.Size() >= m_max_buffer_size;
+  return m_output_buffer.Size() + m_queued_size >= m_max_buffer_size;
 }
 
-bool NonBlockingSender::SendMessage(ola::io::IOStack *stack) {
-  if (LimitReached()) {
+bool NonBlockingSender::SendMessage(ola::io::IOStack *stack,
+                                    Priority priority) {
+  if (!CanQueue()) {
     return false;
   }
 
-  stack->MoveToIOQueue(&m_output_buffer);
-  AssociateIfRequired();
+  unsigned int size = stack->Size();
+  stack->MoveToIOQueue(&m_queues[priority]->data);
+  QueueMessage(priority, size);
   return true;
 }
 
-bool NonBlockingSender::SendMessage(IOQueue *queue) {
-  if (LimitReached()) {
+bool NonBlockingSender::SendMessage(IOQueue *queue, Priority priority) {
+  if (!CanQueue()) {
     return false;
   }
 
-  m_output_buffer.AppendMove(queue);
-  AssociateIfRequired();
+  unsigned int size = queue->Size();
+  m_queues[priority]->data.AppendMove(queue);
+  QueueMessage(priority, size);
   return true;
 }
 
+bool NonBlockingSender::CanQueue() const {
+  return m_policy == DROP_OLDEST || !LimitReached();
+}
+
+/*
+ * Record a message that was added to the queue for a priority.
+ */
+void NonBlockingSender::QueueMessage(Priority priority, unsigned int size) {
+  m_queues[priority]->sizes.push_back(size);
+  m_queued_size += size;
+  if (m_policy == DROP_OLDEST) {
+    DropOldest(priority);
+  }
+  AssociateIfRequired();
+}
+
+/*
+ * Discard queued messages until we're within the limit, starting with the
+ * oldest of the lowest priority. The message that was just queued is kept.
+ */
+void NonBlockingSender::DropOldest(Priority new_priority) {
+  const unsigned int in_flight = m_output_buffer.Size();
+  for (int i = PRIORITY_COUNT - 1;
+       i >= 0 && in_flight + m_queued_size > m_max_buffer_size; i--) {
+    MessageQueue *queue = m_queues[i];
+    const unsigned int keep = i == new_priority ? 1 : 0;
+    while (queue->sizes.size() > keep &&
+           in_flight + m_queued_size > m_max_buffer_size) {
+      queue->data.Pop(queue->sizes.front());
+      m_queued_size -= queue->sizes.front();
+      queue->sizes.pop_front();
+      m_dropped_messages++;
+    }
+  }
+}
+
 /*
  * Called when the descriptor is writeable, this does the actual write() call.
  */
 void NonBlockingSender::PerformWrite() {
+  // Once the previous messages have been written, move the queued ones to the
+  // output buffer in priority order. This means the whole lot is sent with a
+  // single writev() but a partially written message is always completed
+  // before the next one starts.
+  if (m_output_buffer.Empty()) {
+    for (unsigned int i = 0; i < PRIORITY_COUNT; i++) {
+      m_output_buffer.AppendMove(&m_queues[i]->data);
+      m_queues[i]->sizes.clear();
+    }
+    m_queued_size = 0;
+  }
+
   m_descriptor->Send(&m_output_buffer);
-  if (m_output_buffer.Empty() && m_associated) {
+  if (m_output_buffer.Empty() && !m_queued_size && m_associated) {
     m_ss->RemoveWriteDescriptor(m_descriptor);
     m_associated = false;
   }
@@ -86,7 +146,7 @@ void NonBlockingSender::PerformWrite() {
  * Associate our descriptor with the SelectServer if we have data to send.
  */
 void NonBlockingSender::AssociateIfRequired() {
-  if (m_output_buffer.Empty()) {
+  if (m_output_buffer.Empty() && !m_queued_size) {
     return;
   }
   m_ss->AddWriteDescriptor(m_descriptor);
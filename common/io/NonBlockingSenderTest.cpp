@@ -0,0 +1,148 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * NonBlockingSenderTest.cpp
+ * Test fixture for the NonBlockingSender class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/io/NonBlockingSender.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::TimeInterval;
+using ola::io::IOQueue;
+using ola::io::LoopbackDescriptor;
+using ola::io::MemoryBlockPool;
+using ola::io::NonBlockingSender;
+using ola::io::SelectServer;
+using std::string;
+
+class NonBlockingSenderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(NonBlockingSenderTest);
+  CPPUNIT_TEST(testPriority);
+  CPPUNIT_TEST(testRejectNew);
+  CPPUNIT_TEST(testDropOldest);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testPriority();
+    void testRejectNew();
+    void testDropOldest();
+
+ private:
+    SelectServer m_ss;
+    MemoryBlockPool m_pool;
+    LoopbackDescriptor m_loopback;
+
+    bool Send(NonBlockingSender *sender, const string &data,
+              NonBlockingSender::Priority priority =
+                NonBlockingSender::PRIORITY_NORMAL);
+    string Flush();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NonBlockingSenderTest);
+
+void NonBlockingSenderTest::setUp() {
+  OLA_ASSERT_TRUE(m_loopback.Init());
+}
+
+bool NonBlockingSenderTest::Send(NonBlockingSender *sender,
+                                 const string &data,
+                                 NonBlockingSender::Priority priority) {
+  IOQueue queue(&m_pool);
+  queue.Write(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  return sender->SendMessage(&queue, priority);
+}
+
+/*
+ * Run the SelectServer so the sender writes, and return what was received.
+ */
+string NonBlockingSenderTest::Flush() {
+  m_ss.RunOnce(TimeInterval(0, 10000));
+  uint8_t buffer[100];
+  unsigned int data_read = 0;
+  m_loopback.Receive(buffer, sizeof(buffer), data_read);
+  return string(reinterpret_cast<char*>(buffer), data_read);
+}
+
+/*
+ * Check high priority messages are sent first.
+ */
+void NonBlockingSenderTest::testPriority() {
+  NonBlockingSender sender(&m_loopback, &m_ss, &m_pool);
+  OLA_ASSERT_TRUE(Send(&sender, "abc"));
+  OLA_ASSERT_TRUE(Send(&sender, "def"));
+  OLA_ASSERT_TRUE(Send(&sender, "HB", NonBlockingSender::PRIORITY_HIGH));
+  OLA_ASSERT_EQ(string("HBabcdef"), Flush());
+
+  OLA_ASSERT_TRUE(Send(&sender, "ghi"));
+  OLA_ASSERT_EQ(string("ghi"), Flush());
+  OLA_ASSERT_EQ(string(""), Flush());
+}
+
+/*
+ * Check messages are rejected once the limit is reached.
+ */
+void NonBlockingSenderTest::testRejectNew() {
+  NonBlockingSender sender(&m_loopback, &m_ss, &m_pool, 8);
+  OLA_ASSERT_TRUE(Send(&sender, "abcdef"));
+  OLA_ASSERT_FALSE(sender.LimitReached());
+  // The limit is a soft limit.
+  OLA_ASSERT_TRUE(Send(&sender, "ghij"));
+  OLA_ASSERT_TRUE(sender.LimitReached());
+  OLA_ASSERT_FALSE(Send(&sender, "klm"));
+  OLA_ASSERT_FALSE(Send(&sender, "HB", NonBlockingSender::PRIORITY_HIGH));
+  OLA_ASSERT_EQ(string("abcdefghij"), Flush());
+
+  OLA_ASSERT_FALSE(sender.LimitReached());
+  OLA_ASSERT_TRUE(Send(&sender, "klm"));
+  OLA_ASSERT_EQ(string("klm"), Flush());
+  OLA_ASSERT_EQ(0u, sender.DroppedMessages());
+}
+
+/*
+ * Check the oldest, lowest priority, messages are dropped once the limit is
+ * reached.
+ */
+void NonBlockingSenderTest::testDropOldest() {
+  NonBlockingSender sender(&m_loopback, &m_ss, &m_pool, 8);
+  sender.SetOverflowPolicy(NonBlockingSender::DROP_OLDEST);
+  OLA_ASSERT_TRUE(Send(&sender, "abc"));
+  OLA_ASSERT_TRUE(Send(&sender, "HB", NonBlockingSender::PRIORITY_HIGH));
+  OLA_ASSERT_TRUE(Send(&sender, "def"));
+  OLA_ASSERT_EQ(0u, sender.DroppedMessages());
+
+  // this pushes out abc, but not the heartbeat
+  OLA_ASSERT_TRUE(Send(&sender, "ghi"));
+  OLA_ASSERT_EQ(1u, sender.DroppedMessages());
+
+  // high priority messages push out all the normal ones, then the oldest
+  // high priority one
+  OLA_ASSERT_TRUE(Send(&sender, "XYZ", NonBlockingSender::PRIORITY_HIGH));
+  OLA_ASSERT_TRUE(Send(&sender, "JKLM", NonBlockingSender::PRIORITY_HIGH));
+  OLA_ASSERT_EQ(4u, sender.DroppedMessages());
+  OLA_ASSERT_EQ(string("XYZJKLM"), Flush());
+}
@@ -0,0 +1,182 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PeriodicTaskScheduler.cpp
+ * Runs periodic housekeeping tasks from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <limits.h>
+#include <algorithm>
+#include <vector>
+
+#include "common/io/PeriodicTaskScheduler.h"
+#include "ola/InlineCallback.h"
+#include "ola/math/Random.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::timeout_id;
+using std::vector;
+
+PeriodicTaskScheduler::PeriodicTaskScheduler(TimeoutManager *timeout_manager,
+                                             const Clock *clock)
+    : m_timeout_manager(timeout_manager),
+      m_clock(clock),
+      m_timeout(INVALID_TIMEOUT),
+      m_running(false) {
+}
+
+PeriodicTaskScheduler::~PeriodicTaskScheduler() {
+  if (m_timeout != INVALID_TIMEOUT) {
+    m_timeout_manager->CancelTimeout(m_timeout);
+  }
+  vector<Task*>::iterator iter = m_tasks.begin();
+  for (; iter != m_tasks.end(); ++iter) {
+    delete (*iter)->callback;
+    delete *iter;
+  }
+}
+
+timeout_id PeriodicTaskScheduler::AddTask(const TimeInterval &period,
+                                          Callback0<bool> *callback) {
+  if (!callback) {
+    return INVALID_TIMEOUT;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  const int64_t period_usec = std::max(period.AsInt(),
+                                       static_cast<int64_t>(1));
+  const int phase = ola::math::Random(
+      0, static_cast<int>(std::min(period_usec,
+                                   static_cast<int64_t>(INT_MAX))));
+
+  Task *task = new Task();
+  task->period = TimeInterval(period_usec);
+  task->slack = TimeInterval(period_usec / SLACK_DIVISOR);
+  task->due = now + TimeInterval(static_cast<int64_t>(phase));
+  task->callback = callback;
+  task->removed = false;
+  m_tasks.push_back(task);
+
+  if (!m_running) {
+    ScheduleWakeup();
+  }
+  return task;
+}
+
+void PeriodicTaskScheduler::RemoveTask(timeout_id id) {
+  vector<Task*>::iterator iter = std::find(m_tasks.begin(), m_tasks.end(),
+                                           static_cast<Task*>(id));
+  if (iter == m_tasks.end()) {
+    return;
+  }
+  // The task may be running, so it's deleted once RunTasks() completes.
+  (*iter)->removed = true;
+  if (!m_running) {
+    RemoveDeletedTasks();
+    ScheduleWakeup();
+  }
+}
+
+/*
+ * Run all the tasks that are due, then schedule the next wakeup.
+ */
+void PeriodicTaskScheduler::RunTasks() {
+  m_timeout = INVALID_TIMEOUT;
+  m_running = true;
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  // Tasks added by a task are appended, and run in this pass if they're due.
+  for (unsigned int i = 0; i < m_tasks.size(); i++) {
+    Task *task = m_tasks[i];
+    if (task->removed || now < task->due) {
+      continue;
+    }
+
+    if (!task->callback->Run()) {
+      task->removed = true;
+      continue;
+    }
+
+    // Keep the phase, unless we've fallen behind, in which case skip the
+    // runs we missed rather than running them back to back.
+    task->due += task->period;
+    if (task->due <= now) {
+      task->due = now + task->period;
+    }
+  }
+
+  m_running = false;
+  RemoveDeletedTasks();
+  ScheduleWakeup();
+}
+
+/*
+ * Make sure we wake up before the deadline of the most urgent task.
+ */
+void PeriodicTaskScheduler::ScheduleWakeup() {
+  if (m_tasks.empty()) {
+    if (m_timeout != INVALID_TIMEOUT) {
+      m_timeout_manager->CancelTimeout(m_timeout);
+      m_timeout = INVALID_TIMEOUT;
+    }
+    return;
+  }
+
+  vector<Task*>::const_iterator iter = m_tasks.begin();
+  TimeStamp deadline = (*iter)->due + (*iter)->slack;
+  for (++iter; iter != m_tasks.end(); ++iter) {
+    deadline = std::min(deadline, (*iter)->due + (*iter)->slack);
+  }
+
+  if (m_timeout != INVALID_TIMEOUT) {
+    if (m_wakeup <= deadline) {
+      return;
+    }
+    m_timeout_manager->CancelTimeout(m_timeout);
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  TimeInterval delay;
+  if (now < deadline) {
+    delay = deadline - now;
+  }
+  m_wakeup = deadline;
+  m_timeout = m_timeout_manager->RegisterSingleTimeout(
+      delay,
+      MakeInlineCallback(this, &PeriodicTaskScheduler::RunTasks),
+      "periodic-tasks");
+}
+
+void PeriodicTaskScheduler::RemoveDeletedTasks() {
+  vector<Task*>::iterator iter = m_tasks.begin();
+  while (iter != m_tasks.end()) {
+    if ((*iter)->removed) {
+      delete (*iter)->callback;
+      delete *iter;
+      iter = m_tasks.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+}  // namespace io
+}  // namespace ola
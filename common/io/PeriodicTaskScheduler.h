@@ -0,0 +1,114 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PeriodicTaskScheduler.h
+ * Runs periodic housekeeping tasks from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_PERIODICTASKSCHEDULER_H_
+#define COMMON_IO_PERIODICTASKSCHEDULER_H_
+
+#include <vector>
+
+#include "common/io/TimeoutManager.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief Runs periodic tasks that don't need exact timing.
+ *
+ * Each task runs once per period, but may run up to period / SLACK_DIVISOR
+ * late. All the tasks share one timeout, which is set for the earliest time a
+ * task must run. When it fires, every task that's due runs in the same
+ * wakeup, so tasks with overlapping windows are batched together.
+ *
+ * The first run of each task is at a random point in its first period. This
+ * stops tasks with the same period, say one per device, from all landing on
+ * the same wakeup.
+ *
+ * Tasks must run in the thread that calls TimeoutManager::ExecuteTimeouts().
+ */
+class PeriodicTaskScheduler {
+ public:
+  /**
+   * @brief Create a new PeriodicTaskScheduler.
+   * @param timeout_manager the TimeoutManager to schedule the wakeups with.
+   * @param clock the Clock to use, this should be the TimeoutManager's Clock.
+   */
+  PeriodicTaskScheduler(TimeoutManager *timeout_manager, const Clock *clock);
+
+  /**
+   * @brief Destructor, this deletes any remaining tasks.
+   */
+  ~PeriodicTaskScheduler();
+
+  /**
+   * @brief Add a periodic task.
+   * @param period the time between each run of the task.
+   * @param callback the task to run, ownership is transferred. Returning
+   *   false from the callback removes the task.
+   * @returns an id that can be passed to RemoveTask(), or INVALID_TIMEOUT if
+   *   the callback was NULL.
+   */
+  ola::thread::timeout_id AddTask(const TimeInterval &period,
+                                  Callback0<bool> *callback);
+
+  /**
+   * @brief Remove a task. This is safe to call from a task.
+   * @param id the id returned by AddTask().
+   */
+  void RemoveTask(ola::thread::timeout_id id);
+
+  /**
+   * @brief The number of tasks.
+   */
+  unsigned int TaskCount() const { return m_tasks.size(); }
+
+  /**
+   * @brief Tasks may run up to period / SLACK_DIVISOR late.
+   */
+  enum { SLACK_DIVISOR = 10 };
+
+ private:
+  struct Task {
+    TimeInterval period;
+    TimeInterval slack;
+    TimeStamp due;
+    Callback0<bool> *callback;
+    bool removed;
+  };
+
+  TimeoutManager *m_timeout_manager;
+  const Clock *m_clock;
+  std::vector<Task*> m_tasks;
+  ola::thread::timeout_id m_timeout;
+  TimeStamp m_wakeup;  // when m_timeout fires.
+  bool m_running;
+
+  void RunTasks();
+  void ScheduleWakeup();
+  void RemoveDeletedTasks();
+
+  DISALLOW_COPY_AND_ASSIGN(PeriodicTaskScheduler);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_PERIODICTASKSCHEDULER_H_
@@ -0,0 +1,228 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PeriodicTaskSchedulerTest.cpp
+ * Test fixture for the PeriodicTaskScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "common/io/PeriodicTaskScheduler.h"
+#include "common/io/TimeoutManager.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::PeriodicTaskScheduler;
+using ola::io::TimeoutManager;
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::timeout_id;
+using std::map;
+using std::set;
+using std::vector;
+
+class PeriodicTaskSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PeriodicTaskSchedulerTest);
+  CPPUNIT_TEST(testPeriod);
+  CPPUNIT_TEST(testBatching);
+  CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    PeriodicTaskSchedulerTest() : m_scheduler(NULL), m_step(0) {}
+
+    void setUp() {
+      m_runs.clear();
+      m_wakeups.clear();
+    }
+
+    void testPeriod();
+    void testBatching();
+    void testRemove();
+
+    bool RecordRun(unsigned int task) {
+      TimeStamp now;
+      m_clock.CurrentTime(&now);
+      m_runs[task].push_back(now);
+      m_wakeups.insert(m_step);
+      return true;
+    }
+
+    bool RunTwice(unsigned int task) {
+      RecordRun(task);
+      return m_runs[task].size() < 2;
+    }
+
+    bool RemoveTask(unsigned int task, timeout_id *id) {
+      RecordRun(task);
+      m_scheduler->RemoveTask(*id);
+      return true;
+    }
+
+ private:
+    ExportMap m_map;
+    MockClock m_clock;
+    PeriodicTaskScheduler *m_scheduler;
+    map<unsigned int, vector<TimeStamp> > m_runs;
+    unsigned int m_step;
+    // MockClock includes the real elapsed time, so wakeups are counted by
+    // clock step rather than by time.
+    set<unsigned int> m_wakeups;
+
+    void RunFor(TimeoutManager *timeout_manager, const TimeInterval &duration);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PeriodicTaskSchedulerTest);
+
+/*
+ * Advance the clock in 10ms steps, running the timeouts after each step.
+ */
+void PeriodicTaskSchedulerTest::RunFor(TimeoutManager *timeout_manager,
+                                       const TimeInterval &duration) {
+  const TimeInterval step(0, 10000);
+  for (int64_t elapsed = 0; elapsed < duration.AsInt();
+       elapsed += step.AsInt()) {
+    m_clock.AdvanceTime(step);
+    m_step++;
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    timeout_manager->ExecuteTimeouts(&now);
+  }
+}
+
+
+/*
+ * Check each task runs once per period, and never more than the slack late.
+ */
+void PeriodicTaskSchedulerTest::testPeriod() {
+  TimeoutManager timeout_manager(&m_map, &m_clock, true);
+  PeriodicTaskScheduler scheduler(&timeout_manager, &m_clock);
+
+  OLA_ASSERT_EQ(INVALID_TIMEOUT,
+                scheduler.AddTask(TimeInterval(1, 0), NULL));
+
+  TimeStamp start;
+  m_clock.CurrentTime(&start);
+  OLA_ASSERT_NE(INVALID_TIMEOUT, scheduler.AddTask(
+      TimeInterval(1, 0),
+      NewCallback(this, &PeriodicTaskSchedulerTest::RecordRun, 1u)));
+  OLA_ASSERT_EQ(1u, scheduler.TaskCount());
+
+  RunFor(&timeout_manager, TimeInterval(20, 0));
+
+  // The slack plus the 10ms steps of the clock.
+  const int64_t tolerance = 100000 + 20000;
+  const vector<TimeStamp> &runs = m_runs[1];
+  OLA_ASSERT_GTE(runs.size(), static_cast<size_t>(19));
+  OLA_ASSERT_LTE(runs.size(), static_cast<size_t>(21));
+  OLA_ASSERT_LTE((runs[0] - start).AsInt(), 1000000 + tolerance);
+  for (unsigned int i = 1; i < runs.size(); i++) {
+    int64_t gap = (runs[i] - runs[i - 1]).AsInt();
+    OLA_ASSERT_GTE(gap, 1000000 - tolerance);
+    OLA_ASSERT_LTE(gap, 1000000 + tolerance);
+  }
+}
+
+
+/*
+ * Check tasks with the same period start at different times, but share
+ * wakeups.
+ */
+void PeriodicTaskSchedulerTest::testBatching() {
+  TimeoutManager timeout_manager(&m_map, &m_clock, true);
+  PeriodicTaskScheduler scheduler(&timeout_manager, &m_clock);
+
+  const unsigned int TASKS = 40;
+  for (unsigned int i = 0; i < TASKS; i++) {
+    scheduler.AddTask(
+        TimeInterval(1, 0),
+        NewCallback(this, &PeriodicTaskSchedulerTest::RecordRun, i));
+  }
+
+  RunFor(&timeout_manager, TimeInterval(1, 200000));
+  set<TimeStamp> first_runs;
+  for (unsigned int i = 0; i < TASKS; i++) {
+    OLA_ASSERT_FALSE(m_runs[i].empty());
+    first_runs.insert(m_runs[i][0]);
+  }
+  OLA_ASSERT_GT(first_runs.size(), static_cast<size_t>(1));
+
+  RunFor(&timeout_manager, TimeInterval(10, 0));
+  unsigned int total_runs = 0;
+  for (unsigned int i = 0; i < TASKS; i++) {
+    total_runs += m_runs[i].size();
+  }
+  OLA_ASSERT_GTE(total_runs, TASKS * 10);
+
+  // Each wakeup covers a slack window, so there are at most 11 wakeups per
+  // period no matter how many tasks there are.
+  OLA_ASSERT_LTE(m_wakeups.size(), static_cast<size_t>(11 * 12));
+}
+
+
+/*
+ * Check tasks can be removed, including from a task.
+ */
+void PeriodicTaskSchedulerTest::testRemove() {
+  TimeoutManager timeout_manager(&m_map, &m_clock, true);
+  PeriodicTaskScheduler scheduler(&timeout_manager, &m_clock);
+  m_scheduler = &scheduler;
+
+  timeout_id removed = scheduler.AddTask(
+      TimeInterval(1, 0),
+      NewCallback(this, &PeriodicTaskSchedulerTest::RecordRun, 0u));
+  scheduler.AddTask(
+      TimeInterval(0, 500000),
+      NewCallback(this, &PeriodicTaskSchedulerTest::RunTwice, 1u));
+  timeout_id self = scheduler.AddTask(
+      TimeInterval(0, 500000),
+      NewCallback(this, &PeriodicTaskSchedulerTest::RemoveTask, 2u, &self));
+  timeout_id last = scheduler.AddTask(
+      TimeInterval(1, 0),
+      NewCallback(this, &PeriodicTaskSchedulerTest::RecordRun, 3u));
+  OLA_ASSERT_EQ(4u, scheduler.TaskCount());
+
+  scheduler.RemoveTask(removed);
+  OLA_ASSERT_EQ(3u, scheduler.TaskCount());
+  // Removing an unknown task is a no-op.
+  scheduler.RemoveTask(removed);
+  OLA_ASSERT_EQ(3u, scheduler.TaskCount());
+
+  RunFor(&timeout_manager, TimeInterval(5, 0));
+  OLA_ASSERT_EQ(static_cast<size_t>(0), m_runs[0].size());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_runs[1].size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_runs[2].size());
+  OLA_ASSERT_GTE(m_runs[3].size(), static_cast<size_t>(4));
+  OLA_ASSERT_EQ(1u, scheduler.TaskCount());
+  OLA_ASSERT_TRUE(timeout_manager.EventsPending());
+
+  // Once the last task is removed, the timeout is cancelled.
+  scheduler.RemoveTask(last);
+  OLA_ASSERT_EQ(0u, scheduler.TaskCount());
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+  m_scheduler = NULL;
+}
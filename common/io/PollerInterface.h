@@ -24,6 +24,7 @@
 #include <ola/Clock.h>
 #include <ola/io/Descriptor.h>
 
+#include "common/io/LoopProfiler.h"
 #include "common/io/TimeoutManager.h"
 
 namespace ola {
@@ -69,11 +70,20 @@ namespace io {
  */
 class PollerInterface {
  public :
+  PollerInterface() : m_profiler(NULL) {}
+
   /**
    * @brief Destructor
    */
   virtual ~PollerInterface() {}
 
+  /**
+   * @brief Time the descriptor callbacks.
+   * @param profiler the LoopProfiler to use, or NULL to stop profiling.
+   *   Ownership is not transferred.
+   */
+  void SetProfiler(LoopProfiler *profiler) { m_profiler = profiler; }
+
   /**
    * @brief Register a ReadFileDescriptor for read events.
    * @param descriptor the ReadFileDescriptor to register. The OnData() method
@@ -145,6 +155,41 @@ class PollerInterface {
   static const char K_CONNECTED_DESCRIPTORS_VAR[];
 
  protected:
+  LoopProfiler *m_profiler;
+
+  /**
+   * @brief Call PerformRead() on a descriptor, timing it if profiling is
+   * enabled.
+   */
+  void DispatchRead(ReadFileDescriptor *descriptor) {
+    LoopProfiler::ScopedTimer timer(m_profiler, LoopProfiler::READ_CALLBACK,
+                                    descriptor->ReadLabel());
+    descriptor->PerformRead();
+  }
+
+  /**
+   * @brief Call PerformWrite() on a descriptor, timing it if profiling is
+   * enabled.
+   */
+  void DispatchWrite(WriteFileDescriptor *descriptor) {
+    LoopProfiler::ScopedTimer timer(m_profiler, LoopProfiler::WRITE_CALLBACK,
+                                    descriptor->WriteLabel());
+    descriptor->PerformWrite();
+  }
+
+  /**
+   * @brief Run the on close handler for a descriptor. This is counted as a
+   * read callback.
+   * @param descriptor the descriptor which was closed.
+   * @param on_close the handler returned by TransferOnClose().
+   */
+  void DispatchClose(ConnectedDescriptor *descriptor,
+                     ConnectedDescriptor::OnCloseCallback *on_close) {
+    LoopProfiler::ScopedTimer timer(m_profiler, LoopProfiler::READ_CALLBACK,
+                                    descriptor->ReadLabel());
+    on_close->Run();
+  }
+
   static const char K_LOOP_TIME[];
   static const char K_LOOP_COUNT[];
 };
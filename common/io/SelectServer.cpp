@@ -24,6 +24,7 @@
 #include <ola/win/CleanWinSock2.h>
 #else
 #include <sys/select.h>
+#include <sys/socket.h>
 #endif  // _WIN32
 
 #if HAVE_CONFIG_H
@@ -39,25 +40,52 @@
 #include <vector>
 
 #ifdef _WIN32
+#include "common/io/IOCPPoller.h"
 #include "common/io/WindowsPoller.h"
 #else
-#include "ola/base/Flags.h"
-
-
 #include "common/io/SelectPoller.h"
 #endif  // _WIN32
 
+#include "common/io/LoopProfiler.h"
+#include "common/io/PeriodicTaskScheduler.h"
+#include "ola/base/Flags.h"
 #include "ola/io/Descriptor.h"
 #include "ola/Logging.h"
 #include "ola/network/Socket.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/Utils.h"
+
+DEFINE_default_bool(use_timing_wheel, false,
+                    "Use a timing wheel rather than a heap for timeouts");
+DEFINE_default_bool(use_coarse_clock, false,
+                    "Use a coarse monotonic clock for the event loop, this is "
+                    "cheaper to read but less precise");
+DEFINE_uint32(busy_poll_usec, 0,
+              "Busy poll for this many microseconds before blocking, 0 "
+              "disables busy polling");
+DEFINE_default_bool(profile_loop, false,
+                    "Record how long each event loop callback takes");
+
+#ifdef _WIN32
+DEFINE_default_bool(use_iocp, true,
+                    "Disable the use of I/O completion ports, revert to "
+                    "WaitForMultipleObjects()");
+#endif  // _WIN32
 
 #ifdef HAVE_EPOLL
 #include "common/io/EPoller.h"
 DEFINE_default_bool(use_epoll, true,
                     "Disable the use of epoll(), revert to select()");
+DEFINE_default_bool(epoll_edge_triggered_writes, false,
+                    "Track write readiness with edge triggered epoll events");
 #endif  // HAVE_EPOLL
 
+#ifdef HAVE_IO_URING
+#include "common/io/IOUringPoller.h"
+DEFINE_default_bool(use_io_uring, false,
+                    "Use io_uring rather than epoll(), if available");
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_KQUEUE
 #include "common/io/KQueuePoller.h"
 DEFINE_default_bool(use_kqueue, false,
@@ -71,8 +99,42 @@ using ola::Callback0;
 using ola::ExportMap;
 using ola::thread::timeout_id;
 using std::max;
+using std::string;
 
 const TimeStamp SelectServer::empty_time;
+const char SelectServer::K_EXECUTE_COUNT_VAR[] = "ss-execute-callbacks";
+const char SelectServer::K_EXECUTE_WAKE_UP_VAR[] = "ss-execute-wake-ups";
+const char SelectServer::K_EXECUTE_LATENCY_VAR[] = "ss-execute-latency-us";
+const char SelectServer::K_EXECUTE_MAX_LATENCY_VAR[] =
+    "ss-execute-max-latency-us";
+const char SelectServer::K_EXECUTE_MAX_DEPTH_VAR[] =
+    "ss-execute-max-queue-depth";
+
+namespace {
+
+/*
+ * Ask the kernel to busy poll the device queue when a read on this socket
+ * would block. Descriptors that aren't sockets are skipped.
+ */
+void EnableSocketBusyPoll(DescriptorHandle descriptor, unsigned int usec) {
+#ifdef SO_BUSY_POLL
+  if (descriptor == INVALID_DESCRIPTOR) {
+    return;
+  }
+  int value = static_cast<int>(usec);
+  if (setsockopt(descriptor, SOL_SOCKET, SO_BUSY_POLL,
+                 reinterpret_cast<char*>(&value), sizeof(value)) < 0 &&
+      errno != ENOTSOCK) {
+    // Values larger than net.core.busy_read require CAP_NET_ADMIN.
+    OLA_INFO << "Failed to set SO_BUSY_POLL on " << descriptor << ": "
+             << strerror(errno);
+  }
+#else
+  (void) descriptor;
+  (void) usec;
+#endif  // SO_BUSY_POLL
+}
+}  // namespace
 
 SelectServer::SelectServer(ExportMap *export_map,
                            Clock *clock)
@@ -81,7 +143,14 @@ SelectServer::SelectServer(ExportMap *export_map,
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
       m_clock(clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_busy_poll_usec(0),
+      m_loop_cpu(-1),
+      m_execute_count(NULL),
+      m_execute_wake_ups(NULL),
+      m_execute_latency(NULL),
+      m_execute_max_latency(NULL),
+      m_execute_max_depth(NULL) {
   Options options;
   Init(options);
 }
@@ -92,7 +161,14 @@ SelectServer::SelectServer(const Options &options)
       m_is_running(false),
       m_poll_interval(POLL_INTERVAL_SECOND, POLL_INTERVAL_USECOND),
       m_clock(options.clock),
-      m_free_clock(false) {
+      m_free_clock(false),
+      m_busy_poll_usec(0),
+      m_loop_cpu(-1),
+      m_execute_count(NULL),
+      m_execute_wake_ups(NULL),
+      m_execute_latency(NULL),
+      m_execute_max_latency(NULL),
+      m_execute_max_depth(NULL) {
   Init(options);
 }
 
@@ -115,7 +191,7 @@ const TimeStamp *SelectServer::WakeUpTime() const {
 
 void SelectServer::Terminate() {
   if (m_is_running) {
-    Execute(NewSingleCallback(this, &SelectServer::SetTerminate));
+    Execute(MakeInlineCallback(this, &SelectServer::SetTerminate));
   }
 }
 
@@ -129,6 +205,12 @@ void SelectServer::Run() {
     return;
   }
 
+  if (m_loop_cpu >= 0) {
+    if (ola::thread::SetCPUAffinity(m_loop_cpu)) {
+      OLA_INFO << "SelectServer pinned to CPU " << m_loop_cpu;
+    }
+  }
+
   m_is_running = true;
   m_terminate = false;
   while (!m_terminate) {
@@ -152,6 +234,9 @@ void SelectServer::RunOnce(const TimeInterval &block_interval) {
 
 bool SelectServer::AddReadDescriptor(ReadFileDescriptor *descriptor) {
   bool added =  m_poller->AddReadDescriptor(descriptor);
+  if (added && m_busy_poll_usec) {
+    EnableSocketBusyPoll(descriptor->ReadDescriptor(), m_busy_poll_usec);
+  }
   if (added && m_export_map) {
     (*m_export_map->GetIntegerVar(PollerInterface::K_READ_DESCRIPTOR_VAR))++;
   }
@@ -161,6 +246,9 @@ bool SelectServer::AddReadDescriptor(ReadFileDescriptor *descriptor) {
 bool SelectServer::AddReadDescriptor(ConnectedDescriptor *descriptor,
                                      bool delete_on_close) {
   bool added =  m_poller->AddReadDescriptor(descriptor, delete_on_close);
+  if (added && m_busy_poll_usec) {
+    EnableSocketBusyPoll(descriptor->ReadDescriptor(), m_busy_poll_usec);
+  }
   if (added && m_export_map) {
     (*m_export_map->GetIntegerVar(
         PollerInterface::K_CONNECTED_DESCRIPTORS_VAR))++;
@@ -242,67 +330,187 @@ timeout_id SelectServer::RegisterSingleTimeout(
   return m_timeout_manager->RegisterSingleTimeout(interval, callback);
 }
 
+timeout_id SelectServer::RegisterRepeatingTimeout(
+    const TimeInterval &interval,
+    ola::Callback0<bool> *callback,
+    const string &label) {
+  return m_timeout_manager->RegisterRepeatingTimeout(interval, callback,
+                                                     label);
+}
+
+timeout_id SelectServer::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    ola::SingleUseCallback0<void> *callback,
+    const string &label) {
+  return m_timeout_manager->RegisterSingleTimeout(interval, callback, label);
+}
+
+timeout_id SelectServer::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    const ola::InlineCallback0<void> &callback) {
+  return m_timeout_manager->RegisterSingleTimeout(interval, callback);
+}
+
+timeout_id SelectServer::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    const ola::InlineCallback0<void> &callback,
+    const string &label) {
+  return m_timeout_manager->RegisterSingleTimeout(interval, callback, label);
+}
+
 void SelectServer::RemoveTimeout(timeout_id id) {
   return m_timeout_manager->CancelTimeout(id);
 }
 
+timeout_id SelectServer::RegisterPeriodicTask(
+    const TimeInterval &period,
+    ola::Callback0<bool> *callback) {
+  return m_periodic_tasks->AddTask(period, callback);
+}
+
+void SelectServer::RemovePeriodicTask(timeout_id id) {
+  m_periodic_tasks->RemoveTask(id);
+}
+
 void SelectServer::RunInLoop(Callback0<void> *callback) {
   m_loop_callbacks.insert(callback);
 }
 
 void SelectServer::Execute(ola::BaseCallback0<void> *callback) {
-  {
-    ola::thread::MutexLocker locker(&m_incoming_mutex);
-    m_incoming_callbacks.push_back(callback);
+  QueuedCallback queued_callback;
+  queued_callback.callback = callback;
+  QueueCallback(&queued_callback);
+}
+
+void SelectServer::Execute(const ola::InlineCallback0<void> &callback) {
+  QueuedCallback queued_callback;
+  queued_callback.inline_callback = callback;
+  QueueCallback(&queued_callback);
+}
+
+void SelectServer::QueueCallback(QueuedCallback *queued_callback) {
+  if (m_execute_count) {
+    m_clock->CurrentTime(&queued_callback->queued);
   }
 
   // kick select(), we do this even if we're in the same thread as select() is
   // called. If we don't do this there is a race condition because a callback
   // may be added just prior to select(). Without this kick, select() will
   // sleep for the poll_interval before executing the callback.
-  uint8_t wake_up = 'a';
-  m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  //
+  // The kick is only required if the queue was empty, otherwise whoever added
+  // the first callback is responsible for it. DrainAndExecute() empties the
+  // queue after it reads the descriptor, so no callbacks are missed.
+  if (m_incoming_callbacks.Push(*queued_callback)) {
+    uint8_t wake_up = 'a';
+    m_incoming_descriptor.Send(&wake_up, sizeof(wake_up));
+  }
 }
 
 
 void SelectServer::DrainCallbacks() {
   Callbacks callbacks_to_run;
-  while (true) {
-    {
-      ola::thread::MutexLocker locker(&m_incoming_mutex);
-      if (m_incoming_callbacks.empty()) {
-        return;
-      }
-      callbacks_to_run.swap(m_incoming_callbacks);
-    }
+  while (m_incoming_callbacks.PopAll(&callbacks_to_run)) {
     RunCallbacks(&callbacks_to_run);
   }
 }
 
 void SelectServer::Init(const Options &options) {
   if (!m_clock) {
-    m_clock = new Clock;
+    if (FLAGS_use_coarse_clock || options.use_coarse_clock) {
+      m_clock = new MonotonicClock(true);
+    } else {
+      m_clock = new Clock;
+    }
     m_free_clock = true;
   }
 
+  m_busy_poll_usec = options.busy_poll_usec ? options.busy_poll_usec :
+                                              FLAGS_busy_poll_usec;
+  m_loop_cpu = options.loop_cpu;
+
   if (m_export_map) {
+    m_execute_count = m_export_map->GetCounterVar(K_EXECUTE_COUNT_VAR);
+    m_execute_wake_ups = m_export_map->GetCounterVar(K_EXECUTE_WAKE_UP_VAR);
+    m_execute_latency = m_export_map->GetCounterVar(K_EXECUTE_LATENCY_VAR);
+    m_execute_max_latency = m_export_map->GetIntegerVar(
+        K_EXECUTE_MAX_LATENCY_VAR);
+    m_execute_max_depth = m_export_map->GetIntegerVar(
+        K_EXECUTE_MAX_DEPTH_VAR);
     m_export_map->GetIntegerVar(PollerInterface::K_READ_DESCRIPTOR_VAR);
     m_export_map->GetIntegerVar(PollerInterface::K_WRITE_DESCRIPTOR_VAR);
     m_export_map->GetIntegerVar(PollerInterface::K_CONNECTED_DESCRIPTORS_VAR);
   }
 
-  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock));
+  if (m_export_map && (FLAGS_profile_loop || options.profile_loop)) {
+    m_profiler.reset(new LoopProfiler(m_export_map, m_clock));
+  }
+  if (m_export_map) {
+    m_export_map->GetBoolVar(LoopProfiler::K_ENABLED_VAR)->Set(
+        m_profiler.get() != NULL);
+  }
+
+  bool use_timing_wheel = FLAGS_use_timing_wheel || options.use_timing_wheel;
+  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock,
+                                             use_timing_wheel,
+                                             m_profiler.get()));
+  m_periodic_tasks.reset(new PeriodicTaskScheduler(m_timeout_manager.get(),
+                                                   m_clock));
+  if (m_export_map) {
+    m_export_map->GetBoolVar("using-timing-wheel")->Set(use_timing_wheel);
+  }
 #ifdef _WIN32
-  m_poller.reset(new WindowsPoller(m_export_map, m_clock));
-  (void) options;
+  bool using_iocp = false;
+  if (FLAGS_use_iocp && !options.force_select) {
+    std::auto_ptr<IOCPPoller> poller(new IOCPPoller(m_export_map, m_clock));
+    if (poller->Init()) {
+      m_poller.reset(poller.release());
+      using_iocp = true;
+    } else {
+      OLA_WARN << "Failed to create an I/O completion port, falling back to "
+               << "the WindowsPoller";
+    }
+  }
+  if (!m_poller.get()) {
+    m_poller.reset(new WindowsPoller(m_export_map, m_clock));
+  }
+  if (m_export_map) {
+    m_export_map->GetBoolVar("using-iocp")->Set(using_iocp);
+  }
 #else
 
+#ifdef HAVE_IO_URING
+  bool using_io_uring = false;
+  if ((FLAGS_use_io_uring || options.use_io_uring) && !options.force_select) {
+    std::auto_ptr<IOUringPoller> poller(
+        new IOUringPoller(m_export_map, m_clock));
+    if (poller->Init()) {
+      m_poller.reset(poller.release());
+      using_io_uring = true;
+    } else {
+      OLA_WARN << "io_uring isn't available, falling back to another poller";
+    }
+  }
+  if (m_export_map) {
+    m_export_map->GetBoolVar("using-io-uring")->Set(using_io_uring);
+  }
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_EPOLL
-  if (FLAGS_use_epoll && !options.force_select) {
-    m_poller.reset(new EPoller(m_export_map, m_clock));
+  bool using_epoll = false;
+  if (FLAGS_use_epoll && !m_poller.get() && !options.force_select) {
+    EPoller *poller = new EPoller(m_export_map, m_clock);
+    poller->SetBusyPollInterval(
+        TimeInterval(static_cast<int64_t>(m_busy_poll_usec)));
+    if ((FLAGS_epoll_edge_triggered_writes || options.edge_triggered_writes) &&
+        !poller->EnableEdgeTriggeredWrites()) {
+      OLA_WARN << "Failed to enable edge triggered writes";
+    }
+    m_poller.reset(poller);
+    using_epoll = true;
   }
   if (m_export_map) {
-    m_export_map->GetBoolVar("using-epoll")->Set(FLAGS_use_epoll);
+    m_export_map->GetBoolVar("using-epoll")->Set(using_epoll);
   }
 #endif  // HAVE_EPOLL
 
@@ -321,8 +529,17 @@ void SelectServer::Init(const Options &options) {
   if (!m_poller.get()) {
     m_poller.reset(new SelectPoller(m_export_map, m_clock));
   }
+
+#ifdef HAVE_EPOLL
+  if (m_busy_poll_usec && !using_epoll) {
+    OLA_INFO << "Spinning before blocking is only supported with epoll";
+  }
+#endif  // HAVE_EPOLL
 #endif  // _WIN32
 
+  m_poller->SetProfiler(m_profiler.get());
+  m_loop_clock.reset(new CachedClock(m_poller->WakeUpTime(), m_clock));
+
   // TODO(simon): this should really be in an Init() method that returns a
   // bool.
   if (!m_incoming_descriptor.Init()) {
@@ -330,6 +547,7 @@ void SelectServer::Init(const Options &options) {
   }
   m_incoming_descriptor.SetOnData(
       ola::NewCallback(this, &SelectServer::DrainAndExecute));
+  m_incoming_descriptor.SetReadLabel("execute");
   AddReadDescriptor(&m_incoming_descriptor);
 }
 
@@ -363,23 +581,41 @@ void SelectServer::DrainAndExecute() {
                                   sizeof(message), size);
   }
 
-  // We can't hold the mutex while we execute the callback, so instead we swap
-  // out the vector under a lock, release the lock and then run all the
-  // callbacks.
+  // Take everything that's queued and then run the callbacks, new callbacks
+  // added while we're running these will be picked up on the next wake up.
   Callbacks callbacks_to_run;
-  {
-    thread::MutexLocker lock(&m_incoming_mutex);
-    callbacks_to_run.swap(m_incoming_callbacks);
-  }
+  unsigned int count = m_incoming_callbacks.PopAll(&callbacks_to_run);
 
+  if (m_execute_count) {
+    (*m_execute_wake_ups)++;
+    if (static_cast<int>(count) > m_execute_max_depth->Get()) {
+      m_execute_max_depth->Set(count);
+    }
+  }
   RunCallbacks(&callbacks_to_run);
 }
 
 void SelectServer::RunCallbacks(Callbacks *callbacks) {
+  if (m_execute_count && !callbacks->empty()) {
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    Callbacks::const_iterator iter = callbacks->begin();
+    for (; iter != callbacks->end(); ++iter) {
+      int64_t latency = (now - iter->queued).AsInt();
+      (*m_execute_count)++;
+      (*m_execute_latency) += static_cast<unsigned int>(latency);
+      if (latency > m_execute_max_latency->Get()) {
+        m_execute_max_latency->Set(static_cast<int>(latency));
+      }
+    }
+  }
+
   Callbacks::iterator iter = callbacks->begin();
   for (; iter != callbacks->end(); ++iter) {
-    if (*iter) {
-      (*iter)->Run();
+    if (iter->callback) {
+      iter->callback->Run();
+    } else if (!iter->inline_callback.Empty()) {
+      iter->inline_callback.Run();
     }
   }
   callbacks->clear();
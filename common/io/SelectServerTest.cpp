@@ -30,23 +30,32 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <set>
 #include <sstream>
+#include <string>
 
+#include "common/io/LoopProfiler.h"
 #include "common/io/PollerInterface.h"
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/ExportMap.h"
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
 #include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
 #include "ola/testing/TestUtils.h"
 
 using ola::ExportMap;
 using ola::IntegerVariable;
+using ola::MakeInlineCallback;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
+using ola::UIntMap;
 using ola::io::ConnectedDescriptor;
+using ola::io::LoopProfiler;
 using ola::io::LoopbackDescriptor;
 using ola::io::PollerInterface;
 using ola::io::SelectServer;
@@ -55,6 +64,7 @@ using ola::io::WriteFileDescriptor;
 using ola::network::UDPSocket;
 using std::auto_ptr;
 using std::set;
+using std::string;
 
 /*
  * For some of the tests we need precise control over the timing.
@@ -94,7 +104,12 @@ class SelectServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testShutdownWithActiveDescriptors);
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testOffByOneTimeout);
+  CPPUNIT_TEST(testInlineCallbacks);
+  CPPUNIT_TEST(testExecuteReusesNodes);
   CPPUNIT_TEST(testLoopCallbacks);
+  CPPUNIT_TEST(testBusyPoll);
+  CPPUNIT_TEST(testLoopProfiler);
+  CPPUNIT_TEST(testEdgeTriggeredWrites);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -114,7 +129,12 @@ class SelectServerTest: public CppUnit::TestFixture {
   void testShutdownWithActiveDescriptors();
   void testTimeout();
   void testOffByOneTimeout();
+  void testInlineCallbacks();
+  void testExecuteReusesNodes();
   void testLoopCallbacks();
+  void testBusyPoll();
+  void testLoopProfiler();
+  void testEdgeTriggeredWrites();
 
   void FatalTimeout() {
     OLA_FAIL("Fatal Timeout");
@@ -146,6 +166,11 @@ class SelectServerTest: public CppUnit::TestFixture {
 
   void NullHandler() {}
 
+  void WriteAndRemove(SelectServer *ss, ConnectedDescriptor *descriptor) {
+    m_write_counter++;
+    ss->RemoveWriteDescriptor(descriptor);
+  }
+
   bool IncrementTimeout() {
     if (m_ss && m_ss->IsRunning())
       m_timeout_counter++;
@@ -187,9 +212,30 @@ class SelectServerTest: public CppUnit::TestFixture {
 
   void IncrementLoopCounter() { m_loop_counter++; }
 
+  void SlowRead(LoopbackDescriptor *descriptor, TimeStamp *now) {
+    uint8_t data[10];
+    unsigned int size;
+    descriptor->Receive(data, arraysize(data), size);
+    *now += TimeInterval(0, 5000);
+  }
+
+  void SlowTimeout(TimeStamp *now) {
+    *now += TimeInterval(0, 20000);
+  }
+
+  void ReceiveDatagram(UDPSocket *socket) {
+    uint8_t data[10];
+    ssize_t size = arraysize(data);
+    if (socket->RecvFrom(data, &size)) {
+      m_datagram_counter++;
+    }
+  }
+
  private:
   unsigned int m_timeout_counter;
   unsigned int m_loop_counter;
+  unsigned int m_datagram_counter;
+  unsigned int m_write_counter;
   ExportMap m_map;
   IntegerVariable *connected_read_descriptor_count;
   IntegerVariable *read_descriptor_count;
@@ -211,6 +257,8 @@ void SelectServerTest::setUp() {
   m_ss = new SelectServer(&m_map);
   m_timeout_counter = 0;
   m_loop_counter = 0;
+  m_datagram_counter = 0;
+  m_write_counter = 0;
 
 #if _WIN32
   WSADATA wsa_data;
@@ -660,3 +708,182 @@ void SelectServerTest::testLoopCallbacks() {
   // we should have at least 5 calls to IncrementLoopCounter
   OLA_ASSERT_TRUE(m_loop_counter >= 5);
 }
+
+/*
+ * Check callbacks stored by value can be passed to Execute() and used as
+ * timeouts.
+ */
+void SelectServerTest::testInlineCallbacks() {
+  m_ss->Execute(
+      MakeInlineCallback(this, &SelectServerTest::SingleIncrementTimeout));
+  ola::thread::timeout_id cancelled = m_ss->RegisterSingleTimeout(
+      TimeInterval(0, 10000),
+      MakeInlineCallback(this, &SelectServerTest::FatalTimeout));
+  m_ss->RegisterSingleTimeout(
+      TimeInterval(0, 10000),
+      MakeInlineCallback(this, &SelectServerTest::SingleIncrementTimeout));
+  m_ss->RegisterSingleTimeout(
+      TimeInterval(0, 20000),
+      MakeInlineCallback(this, &SelectServerTest::Terminate));
+  m_ss->RemoveTimeout(cancelled);
+  m_ss->Run();
+  OLA_ASSERT_EQ(2u, m_timeout_counter);
+}
+
+/*
+ * Check that Execute() reuses the queue nodes once the callbacks have run.
+ */
+void SelectServerTest::testExecuteReusesNodes() {
+  m_ss->Execute(
+      MakeInlineCallback(this, &SelectServerTest::SingleIncrementTimeout));
+  m_ss->DrainCallbacks();
+  unsigned int node_count = m_ss->m_incoming_callbacks.NodeCount();
+
+  for (unsigned int i = 0; i < 100; i++) {
+    m_ss->Execute(
+        MakeInlineCallback(this, &SelectServerTest::SingleIncrementTimeout));
+    m_ss->Execute(
+        ola::NewSingleCallback(this,
+                               &SelectServerTest::SingleIncrementTimeout));
+    m_ss->DrainCallbacks();
+  }
+  OLA_ASSERT_EQ(201u, m_timeout_counter);
+  OLA_ASSERT_TRUE(m_ss->m_incoming_callbacks.NodeCount() <= node_count + 1);
+}
+
+/*
+ * Check that descriptors and timeouts still work when busy polling.
+ */
+void SelectServerTest::testBusyPoll() {
+  SelectServer::Options options;
+  options.busy_poll_usec = 1000;
+  options.loop_cpu = 0;
+  SelectServer ss(options);
+
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(ola::network::IPV4SocketAddress(
+      ola::network::IPV4Address::Loopback(), 0)));
+  ola::network::IPV4SocketAddress address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&address));
+  socket.SetOnData(
+      ola::NewCallback(this, &SelectServerTest::ReceiveDatagram, &socket));
+  OLA_ASSERT_TRUE(ss.AddReadDescriptor(&socket));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  const uint8_t data[] = {1, 2, 3};
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                client_socket.SendTo(data, sizeof(data), address));
+
+  ss.RegisterSingleTimeout(
+      10,
+      ola::NewSingleCallback(this, &SelectServerTest::SingleIncrementTimeout));
+  ss.RegisterSingleTimeout(
+      50, ola::NewSingleCallback(&ss, &SelectServer::Terminate));
+  ss.Run();
+  ss.RemoveReadDescriptor(&socket);
+
+  OLA_ASSERT_EQ(1u, m_datagram_counter);
+  OLA_ASSERT_EQ(1u, m_timeout_counter);
+}
+
+/*
+ * Check the loop profiler records the time taken by each callback.
+ */
+void SelectServerTest::testLoopProfiler() {
+  TimeStamp now;
+  ola::Clock actual_clock;
+  actual_clock.CurrentTime(&now);
+  CustomMockClock clock(&now);
+
+  ExportMap export_map;
+  SelectServer::Options options;
+  options.profile_loop = true;
+  options.export_map = &export_map;
+  options.clock = &clock;
+  SelectServer ss(options);
+
+  LoopbackDescriptor loopback;
+  OLA_ASSERT_TRUE(loopback.Init());
+  loopback.SetReadLabel("loopback");
+  loopback.SetOnData(
+      NewCallback(this, &SelectServerTest::SlowRead, &loopback, &now));
+  OLA_ASSERT_TRUE(ss.AddReadDescriptor(&loopback));
+  const uint8_t data = 'a';
+  loopback.Send(&data, sizeof(data));
+
+  ss.RegisterSingleTimeout(
+      TimeInterval(0, 10000),
+      NewSingleCallback(this, &SelectServerTest::SlowTimeout, &now),
+      "slow");
+  // This runs 2ms late.
+  now += TimeInterval(0, 12000);
+  ss.RunOnce();
+  ss.RemoveReadDescriptor(&loopback);
+
+  UIntMap *count = export_map.GetUIntMapVar(
+      LoopProfiler::K_CALLBACK_COUNT_VAR);
+  UIntMap *time = export_map.GetUIntMapVar(LoopProfiler::K_CALLBACK_TIME_VAR);
+  UIntMap *max_time = export_map.GetUIntMapVar(
+      LoopProfiler::K_CALLBACK_MAX_TIME_VAR);
+  OLA_ASSERT_EQ(1u, (*count)["read:loopback"]);
+  OLA_ASSERT_EQ(5000u, (*time)["read:loopback"]);
+  OLA_ASSERT_EQ(5000u, (*max_time)["read:loopback"]);
+  OLA_ASSERT_EQ(1u, (*count)["timeout:slow"]);
+  OLA_ASSERT_EQ(20000u, (*time)["timeout:slow"]);
+  OLA_ASSERT_EQ(0u, (*count)["read:execute"]);
+
+  OLA_ASSERT_EQ(20000,
+                export_map.GetIntegerVar(
+                    LoopProfiler::K_LONGEST_STALL_VAR)->Get());
+  OLA_ASSERT_EQ(string("timeout:slow"),
+                export_map.GetStringVar(
+                    LoopProfiler::K_LONGEST_STALL_SITE_VAR)->Get());
+
+  const ola::Histogram &lag = export_map.GetHistogramVar(
+      LoopProfiler::K_TIMEOUT_LAG_VAR)->Get();
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), lag.Count());
+  OLA_ASSERT_EQ(static_cast<uint32_t>(2000), lag.Max());
+}
+
+/*
+ * Check write descriptors are called when edge triggered writes are enabled,
+ * including when they're added again while still writable.
+ */
+void SelectServerTest::testEdgeTriggeredWrites() {
+  SelectServer::Options options;
+  options.edge_triggered_writes = true;
+  SelectServer ss(options);
+
+  LoopbackDescriptor loopback;
+  OLA_ASSERT_TRUE(loopback.Init());
+  loopback.SetOnData(NewCallback(this, &SelectServerTest::NullHandler));
+  loopback.SetOnWritable(
+      NewCallback(this, &SelectServerTest::WriteAndRemove, &ss,
+                  static_cast<ConnectedDescriptor*>(&loopback)));
+  OLA_ASSERT_TRUE(ss.AddReadDescriptor(&loopback));
+
+  OLA_ASSERT_TRUE(ss.AddWriteDescriptor(&loopback));
+  ss.RunOnce(TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(1u, m_write_counter);
+  ss.RunOnce(TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(1u, m_write_counter);
+
+  for (unsigned int i = 2; i < 5; i++) {
+    OLA_ASSERT_TRUE(ss.AddWriteDescriptor(&loopback));
+    ss.RunOnce(TimeInterval(0, 10000));
+    OLA_ASSERT_EQ(i, m_write_counter);
+  }
+
+  // Removing the write descriptor before the loop runs means it isn't called.
+  OLA_ASSERT_TRUE(ss.AddWriteDescriptor(&loopback));
+  ss.RemoveWriteDescriptor(&loopback);
+  ss.RunOnce(TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(4u, m_write_counter);
+
+  ss.RemoveReadDescriptor(&loopback);
+  OLA_ASSERT_TRUE(ss.AddWriteDescriptor(&loopback));
+  ss.RunOnce(TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(5u, m_write_counter);
+}
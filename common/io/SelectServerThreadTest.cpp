@@ -24,11 +24,13 @@
 #include "ola/testing/TestUtils.h"
 
 #include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/thread/Thread.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
 
+using ola::ExportMap;
 using ola::io::SelectServer;
 using ola::network::UDPSocket;
 using ola::thread::ThreadId;
@@ -57,6 +59,12 @@ class TestThread: public ola::thread::Thread {
 
     bool CallbackRun() const { return m_callback_executed; }
 
+    void CountCallback(unsigned int *counter, unsigned int total) {
+      if (++(*counter) == total) {
+        m_ss->Terminate();
+      }
+    }
+
  private:
     SelectServer *m_ss;
     ThreadId m_ss_thread_id;
@@ -68,11 +76,13 @@ class SelectServerThreadTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SelectServerThreadTest);
   CPPUNIT_TEST(testSameThreadCallback);
   CPPUNIT_TEST(testDifferentThreadCallback);
+  CPPUNIT_TEST(testBatchedCallbacks);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testSameThreadCallback();
   void testDifferentThreadCallback();
+  void testBatchedCallbacks();
 
  private:
   SelectServer m_ss;
@@ -106,3 +116,30 @@ void SelectServerThreadTest::testDifferentThreadCallback() {
   test_thread.Join();
   OLA_ASSERT_TRUE(test_thread.CallbackRun());
 }
+
+
+/*
+ * Check that callbacks queued together only wake the SelectServer once.
+ */
+void SelectServerThreadTest::testBatchedCallbacks() {
+  const unsigned int CALLBACKS = 100;
+  ExportMap export_map;
+  SelectServer ss(&export_map);
+  TestThread test_thread(&ss, ola::thread::Thread::Self());
+
+  unsigned int counter = 0;
+  for (unsigned int i = 0; i < CALLBACKS; i++) {
+    ss.Execute(ola::NewSingleCallback(&test_thread,
+                                      &TestThread::CountCallback,
+                                      &counter, CALLBACKS));
+  }
+  ss.Run();
+  OLA_ASSERT_EQ(CALLBACKS, counter);
+
+  // The extra callback and wake up are from Terminate().
+  OLA_ASSERT_EQ(CALLBACKS + 1,
+                export_map.GetCounterVar("ss-execute-callbacks")->Get());
+  OLA_ASSERT_EQ(2u, export_map.GetCounterVar("ss-execute-wake-ups")->Get());
+  OLA_ASSERT_EQ(static_cast<int>(CALLBACKS),
+                export_map.GetIntegerVar("ss-execute-max-queue-depth")->Get());
+}
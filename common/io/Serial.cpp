@@ -35,6 +35,11 @@
 #include <config.h>
 #endif  // HAVE_CONFIG_H
 
+#ifdef HAVE_LINUX_SERIAL_H
+#include <linux/serial.h>
+#endif  // HAVE_LINUX_SERIAL_H
+
+#include <fstream>
 #include <iomanip>
 #include <string>
 #include <sstream>
@@ -112,6 +117,22 @@ bool RemoveLockFile(const string &lock_file) {
   return true;
 }
 
+/*
+ * The ftdi_sio driver exports the latency timer of each port in sysfs.
+ */
+string FtdiLatencyTimerFile(int fd) {
+#ifdef _WIN32
+  (void) fd;
+  return "";
+#else
+  char tty[256];
+  if (ttyname_r(fd, tty, sizeof(tty))) {
+    return "";
+  }
+  return "/sys/class/tty/" + ola::file::FilenameFromPath(tty) +
+         "/device/latency_timer";
+#endif  // _WIN32
+}
 }  // namespace
 
 bool UIntToSpeedT(uint32_t value, speed_t *output) {
@@ -246,5 +267,66 @@ void ReleaseUUCPLock(const std::string &path) {
     }
   }
 }
+
+bool SetLowLatency(int fd) {
+#if defined(HAVE_LINUX_SERIAL_H) && defined(TIOCGSERIAL)
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) < 0) {
+    return false;
+  }
+  serial.flags |= ASYNC_LOW_LATENCY;
+  if (ioctl(fd, TIOCSSERIAL, &serial) < 0) {
+    OLA_INFO << "Failed to set ASYNC_LOW_LATENCY: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  (void) fd;
+  return false;
+#endif  // defined(HAVE_LINUX_SERIAL_H) && defined(TIOCGSERIAL)
+}
+
+bool IsLowLatency(int fd) {
+#if defined(HAVE_LINUX_SERIAL_H) && defined(TIOCGSERIAL)
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) < 0) {
+    return false;
+  }
+  return (serial.flags & ASYNC_LOW_LATENCY) != 0;
+#else
+  (void) fd;
+  return false;
+#endif  // defined(HAVE_LINUX_SERIAL_H) && defined(TIOCGSERIAL)
+}
+
+bool SetFtdiLatencyTimer(int fd, unsigned int latency_ms) {
+  const string file_name = FtdiLatencyTimerFile(fd);
+  unsigned int current;
+  if (file_name.empty() || !GetFtdiLatencyTimer(fd, &current)) {
+    return false;
+  }
+  if (current == latency_ms) {
+    return true;
+  }
+
+  std::ofstream file(file_name.c_str());
+  file << latency_ms << std::endl;
+  if (!file.good()) {
+    OLA_INFO << "Failed to set the latency timer in " << file_name
+             << ", it remains at " << current << "ms";
+    return false;
+  }
+  return GetFtdiLatencyTimer(fd, &current) && current == latency_ms;
+}
+
+bool GetFtdiLatencyTimer(int fd, unsigned int *latency_ms) {
+  const string file_name = FtdiLatencyTimerFile(fd);
+  if (file_name.empty()) {
+    return false;
+  }
+  std::ifstream file(file_name.c_str());
+  file >> *latency_ms;
+  return !file.fail();
+}
 }  // namespace io
 }  // namespace ola
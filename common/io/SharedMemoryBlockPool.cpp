@@ -0,0 +1,285 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryBlockPool.cpp
+ * A thread safe MemoryBlockPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/io/SharedMemoryBlockPool.h"
+
+#include <stdint.h>
+#include <algorithm>
+
+#include "ola/Logging.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::MutexLocker;
+
+const char SharedMemoryBlockPool::BLOCKS_VAR[] = "memory-pool-blocks";
+const char SharedMemoryBlockPool::FREE_BLOCKS_VAR[] =
+    "memory-pool-free-blocks";
+const char SharedMemoryBlockPool::MISSES_VAR[] =
+    "memory-pool-allocation-misses";
+const char SharedMemoryBlockPool::POOL_KEY[] = "pool";
+
+SharedMemoryBlockPool::SharedMemoryBlockPool(const Options &options)
+    : MemoryBlockPool(options.block_size),
+      m_block_size(options.block_size),
+      m_max_free_blocks(options.max_free_blocks),
+      m_thread_cache_size(options.thread_cache_size),
+      m_name(options.name),
+      m_blocks_allocated(0),
+      m_misses(0),
+      m_low_water(0),
+      m_blocks_var(NULL),
+      m_free_blocks_var(NULL),
+      m_misses_var(NULL) {
+  if (pthread_key_create(&m_cache_key, ReleaseCache)) {
+    OLA_WARN << "Failed to create the thread cache key, caching is disabled";
+    m_thread_cache_size = 0;
+  }
+
+  if (options.export_map) {
+    m_blocks_var = options.export_map->GetUIntMapVar(BLOCKS_VAR, POOL_KEY);
+    m_free_blocks_var = options.export_map->GetUIntMapVar(FREE_BLOCKS_VAR,
+                                                          POOL_KEY);
+    m_misses_var = options.export_map->GetUIntMapVar(MISSES_VAR, POOL_KEY);
+    PurgeIdle();
+  }
+}
+
+SharedMemoryBlockPool::~SharedMemoryBlockPool() {
+  if (m_thread_cache_size) {
+    // Once the key is deleted the per-thread destructors no longer run, so
+    // it's safe to delete the caches here.
+    pthread_key_delete(m_cache_key);
+  }
+
+  MutexLocker lock(&m_mutex);
+  ThreadCaches::iterator iter = m_caches.begin();
+  for (; iter != m_caches.end(); ++iter) {
+    m_free_blocks.insert(m_free_blocks.end(), (*iter)->blocks.begin(),
+                         (*iter)->blocks.end());
+    delete *iter;
+  }
+  m_caches.clear();
+  TrimFreeBlocks(0);
+}
+
+MemoryBlock *SharedMemoryBlockPool::Allocate() {
+  if (!m_thread_cache_size) {
+    MutexLocker lock(&m_mutex);
+    return AllocateBlock();
+  }
+
+  ThreadCache *cache = CurrentCache();
+  if (!cache) {
+    cache = NewCache();
+  }
+
+  if (cache->blocks.empty()) {
+    Refill(cache);
+  }
+  if (cache->blocks.empty()) {
+    return NULL;
+  }
+  MemoryBlock *block = cache->blocks.back();
+  cache->blocks.pop_back();
+  return block;
+}
+
+void SharedMemoryBlockPool::Release(MemoryBlock *block) {
+  if (!m_thread_cache_size) {
+    MutexLocker lock(&m_mutex);
+    AddFreeBlock(block);
+    return;
+  }
+
+  ThreadCache *cache = CurrentCache();
+  if (!cache) {
+    cache = NewCache();
+  }
+
+  cache->blocks.push_back(block);
+  if (cache->blocks.size() > m_thread_cache_size) {
+    Drain(cache, m_thread_cache_size / 2);
+  }
+}
+
+unsigned int SharedMemoryBlockPool::FreeBlocks() const {
+  ThreadCache *cache = CurrentCache();
+  MutexLocker lock(&m_mutex);
+  size_t free_blocks = m_free_blocks.size();
+  if (cache) {
+    free_blocks += cache->blocks.size();
+  }
+  return static_cast<unsigned int>(free_blocks);
+}
+
+void SharedMemoryBlockPool::Purge(unsigned int remaining) {
+  ThreadCache *cache = CurrentCache();
+  if (cache) {
+    Drain(cache, 0);
+  }
+  MutexLocker lock(&m_mutex);
+  TrimFreeBlocks(remaining);
+}
+
+unsigned int SharedMemoryBlockPool::BlocksAllocated() const {
+  MutexLocker lock(&m_mutex);
+  return m_blocks_allocated;
+}
+
+unsigned int SharedMemoryBlockPool::PurgeIdle() {
+  MutexLocker lock(&m_mutex);
+  // The blocks below the low water mark weren't used at all since the last
+  // call.
+  unsigned int idle = std::min(
+      m_low_water, static_cast<unsigned int>(m_free_blocks.size()));
+  TrimFreeBlocks(static_cast<unsigned int>(m_free_blocks.size()) - idle);
+  m_low_water = static_cast<unsigned int>(m_free_blocks.size());
+
+  if (m_blocks_var) {
+    (*m_blocks_var)[m_name] = m_blocks_allocated;
+    (*m_free_blocks_var)[m_name] =
+        static_cast<unsigned int>(m_free_blocks.size());
+    (*m_misses_var)[m_name] = m_misses;
+  }
+  return idle;
+}
+
+unsigned int SharedMemoryBlockPool::AllocationMisses() const {
+  MutexLocker lock(&m_mutex);
+  return m_misses;
+}
+
+SharedMemoryBlockPool::ThreadCache *SharedMemoryBlockPool::CurrentCache()
+    const {
+  if (!m_thread_cache_size) {
+    return NULL;
+  }
+  return reinterpret_cast<ThreadCache*>(pthread_getspecific(m_cache_key));
+}
+
+SharedMemoryBlockPool::ThreadCache *SharedMemoryBlockPool::NewCache() {
+  ThreadCache *cache = new ThreadCache();
+  cache->pool = this;
+  cache->blocks.reserve(m_thread_cache_size + 1);
+  pthread_setspecific(m_cache_key, cache);
+
+  MutexLocker lock(&m_mutex);
+  m_caches.insert(cache);
+  return cache;
+}
+
+/*
+ * Take a block from the shared list, or allocate a new one.
+ * This must be called with the mutex held.
+ */
+MemoryBlock *SharedMemoryBlockPool::AllocateBlock() {
+  if (!m_free_blocks.empty()) {
+    MemoryBlock *block = m_free_blocks.back();
+    m_free_blocks.pop_back();
+    m_low_water = std::min(m_low_water,
+                           static_cast<unsigned int>(m_free_blocks.size()));
+    return block;
+  }
+
+  m_misses++;
+  uint8_t *data = new uint8_t[m_block_size];
+  if (!data) {
+    return NULL;
+  }
+  m_blocks_allocated++;
+  return new MemoryBlock(data, m_block_size);
+}
+
+/*
+ * Move half a cache worth of blocks from the shared list to a thread's cache.
+ */
+void SharedMemoryBlockPool::Refill(ThreadCache *cache) {
+  unsigned int wanted = std::max(1u, m_thread_cache_size / 2);
+  MutexLocker lock(&m_mutex);
+  for (unsigned int i = 0; i < wanted; i++) {
+    bool was_empty = m_free_blocks.empty();
+    MemoryBlock *block = AllocateBlock();
+    if (block) {
+      cache->blocks.push_back(block);
+    }
+    // Only allocate new blocks for the one we need right now.
+    if (was_empty) {
+      break;
+    }
+  }
+}
+
+/*
+ * Move all but remaining blocks from a thread's cache to the shared list.
+ */
+void SharedMemoryBlockPool::Drain(ThreadCache *cache, unsigned int remaining) {
+  MutexLocker lock(&m_mutex);
+  while (cache->blocks.size() > remaining) {
+    AddFreeBlock(cache->blocks.back());
+    cache->blocks.pop_back();
+  }
+}
+
+/*
+ * Add a block to the shared list, or delete it if the list is at the cap.
+ * This must be called with the mutex held.
+ */
+void SharedMemoryBlockPool::AddFreeBlock(MemoryBlock *block) {
+  if (m_max_free_blocks && m_free_blocks.size() >= m_max_free_blocks) {
+    m_blocks_allocated--;
+    delete block;
+  } else {
+    m_free_blocks.push_back(block);
+  }
+}
+
+/*
+ * Delete all but remaining blocks from the shared list.
+ * This must be called with the mutex held.
+ */
+void SharedMemoryBlockPool::TrimFreeBlocks(unsigned int remaining) {
+  while (m_free_blocks.size() > remaining) {
+    delete m_free_blocks.back();
+    m_free_blocks.pop_back();
+    m_blocks_allocated--;
+  }
+  m_low_water = std::min(m_low_water,
+                         static_cast<unsigned int>(m_free_blocks.size()));
+}
+
+/*
+ * Called when a thread exits, this returns the thread's blocks to the shared
+ * list.
+ */
+void SharedMemoryBlockPool::ReleaseCache(void *data) {
+  ThreadCache *cache = reinterpret_cast<ThreadCache*>(data);
+  SharedMemoryBlockPool *pool = cache->pool;
+  MutexLocker lock(&pool->m_mutex);
+  BlockVector::iterator iter = cache->blocks.begin();
+  for (; iter != cache->blocks.end(); ++iter) {
+    pool->AddFreeBlock(*iter);
+  }
+  pool->m_caches.erase(cache);
+  delete cache;
+}
+}  // namespace io
+}  // namespace ola
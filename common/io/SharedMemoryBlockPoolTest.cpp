@@ -0,0 +1,233 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryBlockPoolTest.cpp
+ * Test fixture for the SharedMemoryBlockPool class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/SharedMemoryBlockPool.h"
+#include "ola/thread/Thread.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::io::MemoryBlock;
+using ola::io::SharedMemoryBlockPool;
+using std::vector;
+
+namespace {
+
+/*
+ * Allocates and releases blocks from a pool.
+ */
+class PoolThread: public ola::thread::Thread {
+ public:
+  PoolThread(SharedMemoryBlockPool *pool, unsigned int iterations)
+      : m_pool(pool),
+        m_iterations(iterations) {
+  }
+
+  void *Run() {
+    vector<MemoryBlock*> blocks;
+    for (unsigned int i = 0; i < m_iterations; i++) {
+      for (unsigned int j = 0; j < 10; j++) {
+        blocks.push_back(m_pool->Allocate());
+      }
+      vector<MemoryBlock*>::iterator iter = blocks.begin();
+      for (; iter != blocks.end(); ++iter) {
+        m_pool->Release(*iter);
+      }
+      blocks.clear();
+    }
+    return NULL;
+  }
+
+ private:
+  SharedMemoryBlockPool *m_pool;
+  const unsigned int m_iterations;
+
+  DISALLOW_COPY_AND_ASSIGN(PoolThread);
+};
+}  // namespace
+
+
+class SharedMemoryBlockPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedMemoryBlockPoolTest);
+  CPPUNIT_TEST(testAllocate);
+  CPPUNIT_TEST(testMaxFreeBlocks);
+  CPPUNIT_TEST(testPurgeIdle);
+  CPPUNIT_TEST(testThreads);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testAllocate();
+  void testMaxFreeBlocks();
+  void testPurgeIdle();
+  void testThreads();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedMemoryBlockPoolTest);
+
+
+/*
+ * Check blocks are reused.
+ */
+void SharedMemoryBlockPoolTest::testAllocate() {
+  SharedMemoryBlockPool::Options options;
+  options.block_size = 64;
+  SharedMemoryBlockPool pool(options);
+
+  MemoryBlock *block1 = pool.Allocate();
+  OLA_ASSERT_NOT_NULL(block1);
+  OLA_ASSERT_EQ(64u, block1->Capacity());
+  MemoryBlock *block2 = pool.Allocate();
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(2u, pool.AllocationMisses());
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+
+  pool.Release(block1);
+  pool.Release(block2);
+  OLA_ASSERT_EQ(2u, pool.FreeBlocks());
+
+  OLA_ASSERT_EQ(block2, pool.Allocate());
+  OLA_ASSERT_EQ(block1, pool.Allocate());
+  OLA_ASSERT_EQ(2u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(2u, pool.AllocationMisses());
+
+  pool.Release(block1);
+  pool.Release(block2);
+  pool.Purge(1);
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+  pool.Purge();
+  OLA_ASSERT_EQ(0u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+
+  // and without the per-thread caches
+  options.thread_cache_size = 0;
+  SharedMemoryBlockPool uncached_pool(options);
+  block1 = uncached_pool.Allocate();
+  uncached_pool.Release(block1);
+  OLA_ASSERT_EQ(1u, uncached_pool.FreeBlocks());
+  OLA_ASSERT_EQ(block1, uncached_pool.Allocate());
+  uncached_pool.Release(block1);
+}
+
+
+/*
+ * Check the shared free list is capped.
+ */
+void SharedMemoryBlockPoolTest::testMaxFreeBlocks() {
+  SharedMemoryBlockPool::Options options;
+  options.max_free_blocks = 4;
+  options.thread_cache_size = 2;
+  SharedMemoryBlockPool pool(options);
+
+  vector<MemoryBlock*> blocks;
+  for (unsigned int i = 0; i < 10; i++) {
+    blocks.push_back(pool.Allocate());
+  }
+  OLA_ASSERT_EQ(10u, pool.BlocksAllocated());
+
+  vector<MemoryBlock*>::iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    pool.Release(*iter);
+  }
+  // up to 4 in the shared list, and up to 2 in the cache
+  OLA_ASSERT_TRUE(pool.FreeBlocks() <= 6);
+  OLA_ASSERT_EQ(pool.FreeBlocks(), pool.BlocksAllocated());
+}
+
+
+/*
+ * Check that PurgeIdle() only removes the blocks that weren't used.
+ */
+void SharedMemoryBlockPoolTest::testPurgeIdle() {
+  ExportMap export_map;
+  SharedMemoryBlockPool::Options options;
+  options.thread_cache_size = 0;
+  options.export_map = &export_map;
+  options.name = "test";
+  SharedMemoryBlockPool pool(options);
+
+  vector<MemoryBlock*> blocks;
+  for (unsigned int i = 0; i < 4; i++) {
+    blocks.push_back(pool.Allocate());
+  }
+  vector<MemoryBlock*>::iterator iter = blocks.begin();
+  for (; iter != blocks.end(); ++iter) {
+    pool.Release(*iter);
+  }
+
+  // The first call sets the baseline.
+  OLA_ASSERT_EQ(0u, pool.PurgeIdle());
+  OLA_ASSERT_EQ(4u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(
+      4u,
+      (*export_map.GetUIntMapVar(SharedMemoryBlockPool::BLOCKS_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      4u,
+      (*export_map.GetUIntMapVar(
+          SharedMemoryBlockPool::FREE_BLOCKS_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      4u,
+      (*export_map.GetUIntMapVar(SharedMemoryBlockPool::MISSES_VAR))["test"]);
+
+  // Use one block, the other three are idle.
+  pool.Release(pool.Allocate());
+  OLA_ASSERT_EQ(3u, pool.PurgeIdle());
+  OLA_ASSERT_EQ(1u, pool.FreeBlocks());
+  OLA_ASSERT_EQ(1u, pool.BlocksAllocated());
+  OLA_ASSERT_EQ(
+      1u,
+      (*export_map.GetUIntMapVar(
+          SharedMemoryBlockPool::FREE_BLOCKS_VAR))["test"]);
+
+  OLA_ASSERT_EQ(1u, pool.PurgeIdle());
+  OLA_ASSERT_EQ(0u, pool.BlocksAllocated());
+}
+
+
+/*
+ * Check the pool can be used from many threads.
+ */
+void SharedMemoryBlockPoolTest::testThreads() {
+  const unsigned int THREADS = 4;
+  SharedMemoryBlockPool::Options options;
+  options.thread_cache_size = 4;
+  SharedMemoryBlockPool pool(options);
+
+  vector<PoolThread*> threads;
+  for (unsigned int i = 0; i < THREADS; i++) {
+    threads.push_back(new PoolThread(&pool, 1000));
+  }
+  for (unsigned int i = 0; i < THREADS; i++) {
+    OLA_ASSERT_TRUE(threads[i]->Start());
+  }
+  for (unsigned int i = 0; i < THREADS; i++) {
+    OLA_ASSERT_TRUE(threads[i]->Join());
+    delete threads[i];
+  }
+
+  // Each thread's cache is returned when it exits.
+  OLA_ASSERT_TRUE(pool.BlocksAllocated() <= THREADS * 10);
+  OLA_ASSERT_EQ(pool.BlocksAllocated(), pool.FreeBlocks());
+}
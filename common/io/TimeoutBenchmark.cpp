@@ -0,0 +1,153 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimeoutBenchmark.cpp
+ * Compare the heap and timing wheel TimeoutManager implementations.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "common/io/TimeoutManager.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/math/Random.h"
+
+using ola::Clock;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::TimeoutManager;
+using ola::thread::timeout_id;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(timers, t, 10000, "The number of timers to use");
+DEFINE_s_uint32(seconds, s, 10, "The number of seconds to simulate");
+
+namespace {
+
+unsigned int event_count = 0;
+
+void SingleEvent() {
+  event_count++;
+}
+
+bool RepeatingEvent() {
+  event_count++;
+  return true;
+}
+
+/*
+ * Print the rate for a test.
+ */
+void Report(const char *test, bool use_timing_wheel,
+            const TimeInterval &elapsed, unsigned int operations) {
+  double seconds = elapsed.AsInt() / 1000000.0;
+  cout << std::left << std::setw(24) << test << std::setw(8)
+       << (use_timing_wheel ? "wheel" : "heap") << std::right
+       << std::setw(12) << std::fixed << std::setprecision(1)
+       << (seconds > 0 ? operations / seconds / 1000.0 : 0) << " k ops/s"
+       << endl;
+}
+
+/*
+ * Register timeouts and then cancel them all, like the request timers that
+ * are cleared when the response arrives.
+ */
+void RunRegisterCancel(bool use_timing_wheel,
+                       const vector<TimeInterval> &intervals) {
+  MockClock mock_clock;
+  TimeoutManager manager(NULL, &mock_clock, use_timing_wheel);
+  vector<timeout_id> ids;
+  ids.reserve(intervals.size());
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < intervals.size(); i++) {
+    ids.push_back(manager.RegisterSingleTimeout(
+          intervals[i], NewSingleCallback(SingleEvent)));
+  }
+  for (unsigned int i = 0; i < ids.size(); i++) {
+    manager.CancelTimeout(ids[i]);
+  }
+  // The heap removes cancelled events lazily, so include the cleanup.
+  TimeStamp now;
+  mock_clock.AdvanceTime(1000, 0);
+  mock_clock.CurrentTime(&now);
+  manager.ExecuteTimeouts(&now);
+  clock.CurrentTime(&end);
+  Report("register & cancel", use_timing_wheel, end - start,
+         intervals.size() * 2);
+}
+
+/*
+ * Run repeating timers, waking up when the manager asks us to. Like the
+ * EPoller, we sleep for whole milliseconds, and at least 1ms.
+ */
+void RunRepeating(bool use_timing_wheel,
+                  const vector<TimeInterval> &intervals) {
+  MockClock mock_clock;
+  TimeoutManager manager(NULL, &mock_clock, use_timing_wheel);
+  for (unsigned int i = 0; i < intervals.size(); i++) {
+    manager.RegisterRepeatingTimeout(intervals[i],
+                                     NewCallback(RepeatingEvent));
+  }
+
+  Clock clock;
+  TimeStamp start, end, now, stop;
+  mock_clock.CurrentTime(&now);
+  stop = now + TimeInterval(FLAGS_seconds, 0);
+  event_count = 0;
+
+  clock.CurrentTime(&start);
+  while (now < stop) {
+    TimeInterval next = manager.ExecuteTimeouts(&now);
+    int ms_to_sleep = next.InMilliSeconds();
+    mock_clock.AdvanceTime(0, (ms_to_sleep ? ms_to_sleep : 1) * 1000);
+    mock_clock.CurrentTime(&now);
+  }
+  clock.CurrentTime(&end);
+  Report("repeating", use_timing_wheel, end - start, event_count);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Benchmark the TimeoutManager implementations.");
+
+  ola::math::InitRandom();
+  vector<TimeInterval> intervals;
+  for (unsigned int i = 0; i < FLAGS_timers; i++) {
+    intervals.push_back(TimeInterval(ola::math::Random(1000, 1000000)));
+  }
+
+  cout << FLAGS_timers << " timers" << endl;
+  for (unsigned int i = 0; i < 2; i++) {
+    RunRegisterCancel(i == 1, intervals);
+  }
+  for (unsigned int i = 0; i < 2; i++) {
+    RunRepeating(i == 1, intervals);
+  }
+  return 0;
+}
@@ -20,10 +20,12 @@
 
 #include <queue>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "ola/Logging.h"
 #include "common/io/TimeoutManager.h"
+#include "common/io/TimingWheel.h"
 
 namespace ola {
 namespace io {
@@ -33,15 +35,24 @@ const char TimeoutManager::K_TIMER_VAR[] = "ss-timers";
 
 using ola::Callback0;
 using ola::ExportMap;
+using ola::IntegerVariable;
 using ola::thread::INVALID_TIMEOUT;
 using ola::thread::timeout_id;
+using std::string;
 
 TimeoutManager::TimeoutManager(ExportMap *export_map,
-                               Clock *clock)
+                               Clock *clock,
+                               bool use_timing_wheel,
+                               LoopProfiler *profiler)
     : m_export_map(export_map),
-      m_clock(clock) {
+      m_clock(clock),
+      m_profiler(profiler) {
+  IntegerVariable *timer_count = NULL;
   if (m_export_map) {
-    m_export_map->GetIntegerVar(K_TIMER_VAR);
+    timer_count = m_export_map->GetIntegerVar(K_TIMER_VAR);
+  }
+  if (use_timing_wheel) {
+    m_wheel.reset(new TimingWheel(m_clock, timer_count, m_profiler));
   }
 }
 
@@ -56,28 +67,66 @@ TimeoutManager::~TimeoutManager() {
 
 timeout_id TimeoutManager::RegisterRepeatingTimeout(
     const TimeInterval &interval,
-    ola::Callback0<bool> *closure) {
+    ola::Callback0<bool> *closure,
+    const string &label) {
+  LoopProfiler::Site *site = NULL;
+  if (m_profiler)
+    site = m_profiler->GetSite(LoopProfiler::TIMEOUT_CALLBACK, label);
+
+  if (m_wheel.get())
+    return m_wheel->RegisterRepeatingTimeout(interval, closure, site);
+
   if (!closure)
     return INVALID_TIMEOUT;
 
   if (m_export_map)
     (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
 
-  Event *event = new RepeatingEvent(interval, m_clock, closure);
+  Event *event = new RepeatingEvent(interval, m_clock, site, closure);
   m_events.push(event);
   return event;
 }
 
 timeout_id TimeoutManager::RegisterSingleTimeout(
     const TimeInterval &interval,
-    ola::SingleUseCallback0<void> *closure) {
+    ola::SingleUseCallback0<void> *closure,
+    const string &label) {
+  LoopProfiler::Site *site = NULL;
+  if (m_profiler)
+    site = m_profiler->GetSite(LoopProfiler::TIMEOUT_CALLBACK, label);
+
+  if (m_wheel.get())
+    return m_wheel->RegisterSingleTimeout(interval, closure, site);
+
   if (!closure)
     return INVALID_TIMEOUT;
 
   if (m_export_map)
     (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
 
-  Event *event = new SingleEvent(interval, m_clock, closure);
+  Event *event = new SingleEvent(interval, m_clock, site, closure);
+  m_events.push(event);
+  return event;
+}
+
+timeout_id TimeoutManager::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    const ola::InlineCallback0<void> &closure,
+    const string &label) {
+  LoopProfiler::Site *site = NULL;
+  if (m_profiler)
+    site = m_profiler->GetSite(LoopProfiler::TIMEOUT_CALLBACK, label);
+
+  if (m_wheel.get())
+    return m_wheel->RegisterSingleTimeout(interval, closure, site);
+
+  if (closure.Empty())
+    return INVALID_TIMEOUT;
+
+  if (m_export_map)
+    (*m_export_map->GetIntegerVar(K_TIMER_VAR))++;
+
+  Event *event = new SingleEvent(interval, m_clock, site, closure);
   m_events.push(event);
   return event;
 }
@@ -88,11 +137,19 @@ void TimeoutManager::CancelTimeout(timeout_id id) {
   if (id == INVALID_TIMEOUT)
     return;
 
+  if (m_wheel.get()) {
+    m_wheel->CancelTimeout(id);
+    return;
+  }
+
   if (!m_removed_timeouts.insert(id).second)
     OLA_WARN << "timeout " << id << " already in remove set";
 }
 
 TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
+  if (m_wheel.get())
+    return m_wheel->ExecuteTimeouts(now);
+
   Event *e;
   if (m_events.empty())
     return TimeInterval();
@@ -109,7 +166,16 @@ TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
       continue;
     }
 
-    if (e->Trigger()) {
+    bool repeat;
+    if (m_profiler) {
+      m_profiler->RecordTimeoutLag(*now - e->NextTime());
+      LoopProfiler::ScopedTimer timer(m_profiler, e->Site());
+      repeat = e->Trigger();
+    } else {
+      repeat = e->Trigger();
+    }
+
+    if (repeat) {
       // true implies we need to run this again
       e->UpdateTime(*now);
       m_events.push(e);
@@ -21,13 +21,18 @@
 #ifndef COMMON_IO_TIMEOUTMANAGER_H_
 #define COMMON_IO_TIMEOUTMANAGER_H_
 
+#include <memory>
 #include <queue>
 #include <set>
+#include <string>
 #include <vector>
 
+#include "common/io/LoopProfiler.h"
+#include "common/io/TimingWheel.h"
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/ExportMap.h"
+#include "ola/InlineCallback.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/SchedulerInterface.h"
 
@@ -41,6 +46,10 @@ namespace io {
  *
  * The TimeoutManager allows Callbacks to trigger at some point in the future.
  * Callbacks can be invoked once, or periodically.
+ *
+ * By default the events are kept in a heap. Passing use_timing_wheel to the
+ * constructor switches to a TimingWheel, which has O(1) add & cancel at the
+ * cost of rounding to 1ms ticks internally.
  */
 class TimeoutManager {
  public :
@@ -48,8 +57,12 @@ class TimeoutManager {
    * @brief Create a new TimeoutManager.
    * @param export_map an ExportMap to update
    * @param clock the Clock to use.
+   * @param use_timing_wheel use a TimingWheel rather than a heap.
+   * @param profiler the LoopProfiler to time the callbacks with, may be NULL.
    */
-  TimeoutManager(ola::ExportMap *export_map, Clock *clock);
+  TimeoutManager(ola::ExportMap *export_map, Clock *clock,
+                 bool use_timing_wheel = false,
+                 LoopProfiler *profiler = NULL);
 
   ~TimeoutManager();
 
@@ -59,23 +72,44 @@ class TimeoutManager {
    * @param interval the delay before the closure will be run.
    * @param closure the closure to invoke when the event triggers. Ownership is
    * given up to the select server - make sure nothing else uses this Callback.
+   * @param label the name the LoopProfiler uses for this timeout.
    * @returns the identifier for this timeout, this can be used to remove it
    * later.
    */
   ola::thread::timeout_id RegisterRepeatingTimeout(
       const ola::TimeInterval &interval,
-      ola::Callback0<bool> *closure);
+      ola::Callback0<bool> *closure,
+      const std::string &label = "");
 
   /**
    * @brief Register a single use timeout function.
    * @param interval the delay between function calls
    * @param closure the Callback to invoke when the event triggers
+   * @param label the name the LoopProfiler uses for this timeout.
+   * @returns the identifier for this timeout, this can be used to remove it
+   * later.
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      ola::SingleUseCallback0<void> *closure,
+      const std::string &label = "");
+
+  /**
+   * @brief Register a single use timeout that's stored by value.
+   * @param interval the delay before the callback is run.
+   * @param closure the callback to invoke when the event triggers, this is
+   *   copied.
+   * @param label the name the LoopProfiler uses for this timeout.
    * @returns the identifier for this timeout, this can be used to remove it
    * later.
+   *
+   * With the timing wheel, this doesn't allocate once the wheel has grown to
+   * the number of outstanding timeouts.
    */
   ola::thread::timeout_id RegisterSingleTimeout(
       const ola::TimeInterval &interval,
-      ola::SingleUseCallback0<void> *closure);
+      const ola::InlineCallback0<void> &closure,
+      const std::string &label = "");
 
   /**
    * @brief Cancel a timeout.
@@ -85,10 +119,13 @@ class TimeoutManager {
 
   /**
    * @brief Check if there are any events in the queue.
-   * Events remain in the queue even if they have been cancelled.
+   * With the heap, events remain in the queue even if they have been
+   * cancelled.
    * @returns true if there are events pending, false otherwise.
    */
   bool EventsPending() const {
+    if (m_wheel.get())
+      return m_wheel->EventsPending();
     return !m_events.empty();
   }
 
@@ -105,8 +142,10 @@ class TimeoutManager {
  private :
   class Event {
    public:
-    explicit Event(const TimeInterval &interval, const Clock *clock)
-        : m_interval(interval) {
+    Event(const TimeInterval &interval, const Clock *clock,
+          LoopProfiler::Site *site)
+        : m_interval(interval),
+          m_site(site) {
       TimeStamp now;
       clock->CurrentTime(&now);
       m_next = now + m_interval;
@@ -119,10 +158,12 @@ class TimeoutManager {
     }
 
     TimeStamp NextTime() const { return m_next; }
+    LoopProfiler::Site *Site() const { return m_site; }
 
    private:
     TimeInterval m_interval;
     TimeStamp m_next;
+    LoopProfiler::Site *m_site;
   };
 
   // An event that only happens once
@@ -130,11 +171,21 @@ class TimeoutManager {
    public:
     SingleEvent(const TimeInterval &interval,
                 const Clock *clock,
+                LoopProfiler::Site *site,
                 ola::BaseCallback0<void> *closure):
-      Event(interval, clock),
+      Event(interval, clock, site),
       m_closure(closure) {
     }
 
+    SingleEvent(const TimeInterval &interval,
+                const Clock *clock,
+                LoopProfiler::Site *site,
+                const ola::InlineCallback0<void> &closure):
+      Event(interval, clock, site),
+      m_closure(NULL),
+      m_inline_closure(closure) {
+    }
+
     virtual ~SingleEvent() {
       if (m_closure)
         delete m_closure;
@@ -145,12 +196,16 @@ class TimeoutManager {
         m_closure->Run();
         // it's deleted itself at this point
         m_closure = NULL;
+      } else if (!m_inline_closure.Empty()) {
+        m_inline_closure.Run();
+        m_inline_closure.Reset();
       }
       return false;
     }
 
    private:
      ola::BaseCallback0<void> *m_closure;
+     ola::InlineCallback0<void> m_inline_closure;
   };
 
   /*
@@ -161,8 +216,9 @@ class TimeoutManager {
    public:
     RepeatingEvent(const TimeInterval &interval,
                    const Clock *clock,
+                   LoopProfiler::Site *site,
                    ola::BaseCallback0<bool> *closure):
-      Event(interval, clock),
+      Event(interval, clock, site),
       m_closure(closure) {
     }
     ~RepeatingEvent() {
@@ -189,9 +245,11 @@ class TimeoutManager {
 
   ola::ExportMap *m_export_map;
   Clock *m_clock;
+  LoopProfiler *m_profiler;
 
   event_queue_t m_events;
   std::set<ola::thread::timeout_id> m_removed_timeouts;
+  std::auto_ptr<TimingWheel> m_wheel;
 
   DISALLOW_COPY_AND_ASSIGN(TimeoutManager);
 };
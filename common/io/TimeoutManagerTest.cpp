@@ -52,6 +52,11 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
     void testAbortedRepeatingTimeouts();
     void testPendingEventShutdown();
 
+    void CheckSingleTimeouts(bool use_timing_wheel);
+    void CheckRepeatingTimeouts(bool use_timing_wheel);
+    void CheckAbortedRepeatingTimeouts(bool use_timing_wheel);
+    void CheckPendingEventShutdown(bool use_timing_wheel);
+
     void HandleEvent(unsigned int event_id) {
       m_event_counters[event_id]++;
     }
@@ -80,11 +85,38 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeoutManagerTest);
 
 /*
- * Check RegisterSingleTimeout works.
+ * Each test is run against both the heap and the timing wheel.
  */
 void TimeoutManagerTest::testSingleTimeouts() {
+  CheckSingleTimeouts(false);
+  m_event_counters.clear();
+  CheckSingleTimeouts(true);
+}
+
+void TimeoutManagerTest::testRepeatingTimeouts() {
+  CheckRepeatingTimeouts(false);
+  m_event_counters.clear();
+  CheckRepeatingTimeouts(true);
+}
+
+void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
+  CheckAbortedRepeatingTimeouts(false);
+  m_event_counters.clear();
+  CheckAbortedRepeatingTimeouts(true);
+}
+
+void TimeoutManagerTest::testPendingEventShutdown() {
+  CheckPendingEventShutdown(false);
+  m_event_counters.clear();
+  CheckPendingEventShutdown(true);
+}
+
+/*
+ * Check RegisterSingleTimeout works.
+ */
+void TimeoutManagerTest::CheckSingleTimeouts(bool use_timing_wheel) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timing_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -136,9 +168,9 @@ void TimeoutManagerTest::testSingleTimeouts() {
 /*
  * Check RegisterRepeatingTimeout works.
  */
-void TimeoutManagerTest::testRepeatingTimeouts() {
+void TimeoutManagerTest::CheckRepeatingTimeouts(bool use_timing_wheel) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timing_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -190,9 +222,10 @@ void TimeoutManagerTest::testRepeatingTimeouts() {
 /*
  * Check returning false from a repeating timeout cancels the timeout.
  */
-void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
+void TimeoutManagerTest::CheckAbortedRepeatingTimeouts(
+    bool use_timing_wheel) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timing_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -222,9 +255,9 @@ void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
  * Check we don't leak if there are events pending when the manager is
  * destroyed.
  */
-void TimeoutManagerTest::testPendingEventShutdown() {
+void TimeoutManagerTest::CheckPendingEventShutdown(bool use_timing_wheel) {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, use_timing_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -0,0 +1,455 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimingWheel.cpp
+ * A hierarchical timing wheel for timeout events.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/io/TimingWheel.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace io {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::timeout_id;
+
+namespace {
+
+/*
+ * A timeout_id holds the index of the event + 1 in the low bits and the
+ * generation of the event in the high bits. The generation is bumped each
+ * time an event is freed, so cancelling a timeout that has already run
+ * doesn't cancel whatever re-used the event.
+ */
+const unsigned int ID_INDEX_BITS = sizeof(uintptr_t) > 4 ? 32 : 20;
+const uintptr_t ID_INDEX_MASK = (static_cast<uintptr_t>(1) << ID_INDEX_BITS) -
+                                1;
+const uintptr_t ID_GENERATION_MASK =
+    (static_cast<uintptr_t>(1) << (sizeof(uintptr_t) * 8 - ID_INDEX_BITS)) - 1;
+
+timeout_id MakeId(uint32_t index, uint32_t generation) {
+  uintptr_t id = (static_cast<uintptr_t>(generation) & ID_GENERATION_MASK);
+  id = (id << ID_INDEX_BITS) | (index + 1);
+  return reinterpret_cast<timeout_id>(id);
+}
+}  // namespace
+
+TimingWheel::TimingWheel(const Clock *clock, IntegerVariable *timer_count,
+                         LoopProfiler *profiler)
+    : m_clock(clock),
+      m_timer_count(timer_count),
+      m_profiler(profiler),
+      m_current_tick(0),
+      m_in_tick(false),
+      m_event_count(0),
+      m_free_events(NIL),
+      m_running(NIL),
+      m_running_cancelled(false) {
+  m_clock->CurrentTime(&m_start);
+  for (unsigned int i = 0; i < LEVELS; i++) {
+    m_level_count[i] = 0;
+    for (unsigned int j = 0; j < WORDS_PER_LEVEL; j++) {
+      m_occupied[i][j] = 0;
+    }
+  }
+  for (unsigned int i = 0; i < LIST_COUNT; i++) {
+    m_lists[i] = NIL;
+  }
+}
+
+TimingWheel::~TimingWheel() {
+  EventVector::iterator iter = m_events.begin();
+  for (; iter != m_events.end(); ++iter) {
+    if (iter->list != FREE_LIST) {
+      delete iter->single_closure;
+      delete iter->repeating_closure;
+    }
+  }
+}
+
+timeout_id TimingWheel::RegisterRepeatingTimeout(
+    const TimeInterval &interval,
+    ola::Callback0<bool> *closure,
+    LoopProfiler::Site *site) {
+  if (!closure)
+    return INVALID_TIMEOUT;
+  return AddEvent(interval, NULL, closure, site, NULL);
+}
+
+timeout_id TimingWheel::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    ola::SingleUseCallback0<void> *closure,
+    LoopProfiler::Site *site) {
+  if (!closure)
+    return INVALID_TIMEOUT;
+  return AddEvent(interval, closure, NULL, site, NULL);
+}
+
+timeout_id TimingWheel::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    const InlineCallback0<void> &closure,
+    LoopProfiler::Site *site) {
+  if (closure.Empty())
+    return INVALID_TIMEOUT;
+  return AddEvent(interval, NULL, NULL, site, &closure);
+}
+
+void TimingWheel::CancelTimeout(timeout_id id) {
+  uint32_t index;
+  if (!DecodeId(id, &index))
+    return;
+
+  if (index == m_running) {
+    // Freed once the callback returns.
+    m_running_cancelled = true;
+    return;
+  }
+  Unlink(index);
+  FreeEvent(index);
+}
+
+TimeInterval TimingWheel::ExecuteTimeouts(TimeStamp *now) {
+  uint64_t next_tick;
+  while (NextEventTick(&next_tick) && next_tick <= TickFor(*now)) {
+    m_current_tick = next_tick;
+    ProcessTick(now);
+    if (m_lists[m_current_tick & SLOT_MASK] != NIL) {
+      // There are events due later in this tick.
+      break;
+    }
+    m_current_tick++;
+  }
+
+  // Nothing is due before next_tick, so we can skip over the empty slots.
+  // This keeps the wheel in step with the clock, so new events are placed
+  // relative to the current time.
+  uint64_t now_tick = TickFor(*now);
+  if (!m_event_count) {
+    if (m_current_tick < now_tick)
+      m_current_tick = now_tick;
+    return TimeInterval();
+  }
+
+  if (next_tick > now_tick && m_current_tick < now_tick)
+    m_current_tick = now_tick;
+  return TimeUntil(next_tick, *now);
+}
+
+timeout_id TimingWheel::AddEvent(const TimeInterval &interval,
+                                 ola::BaseCallback0<void> *single_closure,
+                                 ola::BaseCallback0<bool> *repeating_closure,
+                                 LoopProfiler::Site *site,
+                                 const InlineCallback0<void> *inline_closure) {
+  uint32_t index;
+  if (m_free_events != NIL) {
+    index = m_free_events;
+    m_free_events = m_events[index].next;
+  } else {
+    if (m_events.size() >= ID_INDEX_MASK) {
+      OLA_WARN << "Too many timeouts registered";
+      delete single_closure;
+      delete repeating_closure;
+      return INVALID_TIMEOUT;
+    }
+    index = m_events.size();
+    Event event;
+    event.generation = 0;
+    event.list = FREE_LIST;
+    m_events.push_back(event);
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  Event &event = m_events[index];
+  event.single_closure = single_closure;
+  event.repeating_closure = repeating_closure;
+  if (inline_closure)
+    event.inline_closure = *inline_closure;
+  event.site = site;
+  event.interval = interval;
+  event.expiry = now + interval;
+  event.tick = TickFor(event.expiry);
+  event.list = NO_LIST;
+  Schedule(index);
+
+  m_event_count++;
+  if (m_timer_count)
+    (*m_timer_count)++;
+  return MakeId(index, event.generation);
+}
+
+void TimingWheel::FreeEvent(uint32_t index) {
+  Event &event = m_events[index];
+  delete event.single_closure;
+  delete event.repeating_closure;
+  event.single_closure = NULL;
+  event.repeating_closure = NULL;
+  event.inline_closure.Reset();
+  event.generation++;
+  event.list = FREE_LIST;
+  event.next = m_free_events;
+  m_free_events = index;
+
+  m_event_count--;
+  if (m_timer_count)
+    (*m_timer_count)--;
+}
+
+bool TimingWheel::DecodeId(timeout_id id, uint32_t *index) const {
+  uintptr_t value = reinterpret_cast<uintptr_t>(id);
+  if (!(value & ID_INDEX_MASK))
+    return false;
+
+  *index = (value & ID_INDEX_MASK) - 1;
+  if (*index >= m_events.size())
+    return false;
+
+  const Event &event = m_events[*index];
+  return (event.list != FREE_LIST &&
+          (event.generation & ID_GENERATION_MASK) ==
+            (value >> ID_INDEX_BITS));
+}
+
+uint64_t TimingWheel::TickFor(const TimeStamp &time) const {
+  if (time <= m_start)
+    return 0;
+  return (time - m_start).AsInt() / TICK_USEC;
+}
+
+/*
+ * Put an event in the lowest level that covers its tick.
+ */
+void TimingWheel::Schedule(uint32_t index) {
+  // Events added while a tick is running go in a later tick, otherwise a
+  // repeating event with a short interval would never let us finish the tick.
+  uint64_t min_tick = m_in_tick ? m_current_tick + 1 : m_current_tick;
+  uint64_t tick = m_events[index].tick;
+  if (tick < min_tick)
+    tick = min_tick;
+
+  uint64_t delta = tick - m_current_tick;
+  unsigned int level = 0;
+  while (level < LEVELS - 1 && (delta >> ((level + 1) * SLOT_BITS))) {
+    level++;
+  }
+  if (delta >> (LEVELS * SLOT_BITS)) {
+    // Beyond the range of the wheel, it'll be re-scheduled each time the top
+    // level wraps.
+    tick = m_current_tick + (static_cast<uint64_t>(1) <<
+                             (LEVELS * SLOT_BITS)) - 1;
+  }
+  unsigned int slot = (tick >> (level * SLOT_BITS)) & SLOT_MASK;
+  PushFront(level * SLOTS + slot, index);
+}
+
+void TimingWheel::PushFront(int32_t list, uint32_t index) {
+  Event &event = m_events[index];
+  event.list = list;
+  event.prev = NIL;
+  event.next = m_lists[list];
+  if (event.next != NIL)
+    m_events[event.next].prev = index;
+  m_lists[list] = index;
+  if (list < EXPIRING_LIST) {
+    m_level_count[list / SLOTS]++;
+    m_occupied[list / SLOTS][(list % SLOTS) / 32] |= 1u << (list % 32);
+  }
+}
+
+void TimingWheel::Unlink(uint32_t index) {
+  Event &event = m_events[index];
+  if (event.prev != NIL) {
+    m_events[event.prev].next = event.next;
+  } else {
+    m_lists[event.list] = event.next;
+  }
+  if (event.next != NIL)
+    m_events[event.next].prev = event.prev;
+  if (event.list < EXPIRING_LIST) {
+    m_level_count[event.list / SLOTS]--;
+    if (m_lists[event.list] == NIL) {
+      m_occupied[event.list / SLOTS][(event.list % SLOTS) / 32] &=
+          ~(1u << (event.list % 32));
+    }
+  }
+  event.list = NO_LIST;
+}
+
+/*
+ * Move the events in a slot down to the lower levels.
+ */
+void TimingWheel::Cascade(unsigned int level, unsigned int slot) {
+  uint32_t *head = &m_lists[level * SLOTS + slot];
+  while (*head != NIL) {
+    uint32_t index = *head;
+    Unlink(index);
+    Schedule(index);
+  }
+}
+
+/*
+ * Find the first tick at which something happens, either a level 0 slot with
+ * events in it, or a higher level slot that needs to be cascaded.
+ */
+bool TimingWheel::NextEventTick(uint64_t *tick) const {
+  bool found = false;
+  for (unsigned int level = 0; level < LEVELS; level++) {
+    if (!m_level_count[level])
+      continue;
+
+    unsigned int shift = level * SLOT_BITS;
+    uint64_t base = m_current_tick >> shift;
+    // If the slot for the current position has already been cascaded, any
+    // events in it are for the next time around.
+    unsigned int start =
+        (m_current_tick & ((static_cast<uint64_t>(1) << shift) - 1)) ? 1 : 0;
+    unsigned int offset = NextOccupiedSlot(level, (base + start) & SLOT_MASK);
+    uint64_t candidate = (base + start + offset) << shift;
+    if (!found || candidate < *tick)
+      *tick = candidate;
+    found = true;
+  }
+  return found;
+}
+
+/*
+ * Return the distance from the from slot to the next occupied slot in a
+ * level, wrapping around. The level must have at least one event.
+ */
+unsigned int TimingWheel::NextOccupiedSlot(unsigned int level,
+                                           unsigned int from) const {
+  const uint32_t *words = m_occupied[level];
+  unsigned int word = from / 32;
+  // Mask off the slots before from in the first word.
+  uint32_t bits = words[word] & (~0u << (from % 32));
+  for (unsigned int i = 0; i <= WORDS_PER_LEVEL; i++) {
+    if (bits) {
+      unsigned int slot = word * 32 + __builtin_ctz(bits);
+      return (slot - from) & SLOT_MASK;
+    }
+    word = (word + 1) % WORDS_PER_LEVEL;
+    bits = words[word];
+  }
+  return 0;
+}
+
+/*
+ * Return the time until a tick starts, or, if we're part way through the
+ * tick, until the first event within it.
+ */
+TimeInterval TimingWheel::TimeUntil(uint64_t tick, const TimeStamp &now) const {
+  TimeStamp next = m_start + TimeInterval(tick * TICK_USEC);
+  if (next <= now) {
+    uint32_t index = m_lists[tick & SLOT_MASK];
+    if (index != NIL)
+      next = m_events[index].expiry;
+    for (; index != NIL; index = m_events[index].next) {
+      if (m_events[index].expiry < next)
+        next = m_events[index].expiry;
+    }
+  }
+  // Zero means no events, so always return at least 1us.
+  if (next <= now)
+    return TimeInterval(1);
+  return next - now;
+}
+
+/*
+ * Run the events that have expired in the current tick.
+ */
+void TimingWheel::ProcessTick(TimeStamp *now) {
+  if ((m_current_tick & SLOT_MASK) == 0) {
+    for (unsigned int level = 1; level < LEVELS; level++) {
+      unsigned int slot = (m_current_tick >> (level * SLOT_BITS)) & SLOT_MASK;
+      Cascade(level, slot);
+      if (slot)
+        break;
+    }
+  }
+
+  // Move the expired events onto their own list, so cancelling events from
+  // the callbacks doesn't disturb the slot we're iterating over.
+  int32_t list = m_current_tick & SLOT_MASK;
+  uint32_t index = m_lists[list];
+  while (index != NIL) {
+    uint32_t next = m_events[index].next;
+    if (m_events[index].expiry <= *now) {
+      Unlink(index);
+      PushFront(EXPIRING_LIST, index);
+    }
+    index = next;
+  }
+
+  m_in_tick = true;
+  while (m_lists[EXPIRING_LIST] != NIL) {
+    index = m_lists[EXPIRING_LIST];
+    Unlink(index);
+    RunEvent(index, now);
+  }
+  m_in_tick = false;
+}
+
+void TimingWheel::RunEvent(uint32_t index, TimeStamp *now) {
+  m_running = index;
+  m_running_cancelled = false;
+
+  bool repeat = false;
+  Event &event = m_events[index];
+  if (m_profiler) {
+    m_profiler->RecordTimeoutLag(*now - event.expiry);
+  }
+  LoopProfiler::Site *site = event.site;
+  if (m_profiler && !site) {
+    site = m_profiler->GetSite(LoopProfiler::TIMEOUT_CALLBACK, "");
+  }
+
+  if (event.single_closure) {
+    ola::BaseCallback0<void> *closure = event.single_closure;
+    // it deletes itself
+    event.single_closure = NULL;
+    LoopProfiler::ScopedTimer timer(m_profiler, site);
+    closure->Run();
+  } else if (!event.inline_closure.Empty()) {
+    // Run a copy, since the event may move if the callback adds timeouts.
+    InlineCallback0<void> closure = event.inline_closure;
+    event.inline_closure.Reset();
+    LoopProfiler::ScopedTimer timer(m_profiler, site);
+    closure.Run();
+  } else {
+    LoopProfiler::ScopedTimer timer(m_profiler, site);
+    repeat = event.repeating_closure->Run();
+  }
+  // The callback may have registered timeouts, which invalidates references
+  // into m_events.
+  m_running = NIL;
+  m_clock->CurrentTime(now);
+
+  if (repeat && !m_running_cancelled) {
+    Event &repeating_event = m_events[index];
+    repeating_event.expiry = *now + repeating_event.interval;
+    repeating_event.tick = TickFor(repeating_event.expiry);
+    Schedule(index);
+  } else {
+    FreeEvent(index);
+  }
+}
+}  // namespace io
+}  // namespace ola
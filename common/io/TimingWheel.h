@@ -0,0 +1,190 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimingWheel.h
+ * A hierarchical timing wheel for timeout events.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_TIMINGWHEEL_H_
+#define COMMON_IO_TIMINGWHEEL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/io/LoopProfiler.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/InlineCallback.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @class TimingWheel
+ * @brief A hierarchical timing wheel, used by the TimeoutManager.
+ *
+ * Time is divided into 1ms ticks. There are four levels of 256 slots, each
+ * level covering 256 times the range of the one below. An event is placed in
+ * the lowest level that can hold it and moved down a level each time the
+ * level below wraps around. This makes adding and cancelling a timeout O(1),
+ * rather than O(log n) for a heap, which matters when there are thousands of
+ * timers that are mostly cancelled before they fire.
+ *
+ * Events never run early. An event that is due part way through the current
+ * tick stays in its slot until its expiry time has passed. Events are stored
+ * in a vector and linked together by index, so registering a timeout doesn't
+ * allocate once the vector has grown to the peak number of timers.
+ */
+class TimingWheel {
+ public :
+  /**
+   * @brief Create a new TimingWheel.
+   * @param clock the Clock to use.
+   * @param timer_count a variable to track the number of timers, may be NULL.
+   * @param profiler the LoopProfiler to time the callbacks with, may be NULL.
+   */
+  TimingWheel(const Clock *clock, IntegerVariable *timer_count,
+              LoopProfiler *profiler = NULL);
+
+  ~TimingWheel();
+
+  /**
+   * @brief Register a repeating timeout.
+   * @see TimeoutManager::RegisterRepeatingTimeout
+   */
+  ola::thread::timeout_id RegisterRepeatingTimeout(
+      const ola::TimeInterval &interval,
+      ola::Callback0<bool> *closure,
+      LoopProfiler::Site *site = NULL);
+
+  /**
+   * @brief Register a single use timeout.
+   * @see TimeoutManager::RegisterSingleTimeout
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      ola::SingleUseCallback0<void> *closure,
+      LoopProfiler::Site *site = NULL);
+
+  /**
+   * @brief Register a single use timeout that's stored by value.
+   * @see TimeoutManager::RegisterSingleTimeout
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      const ola::InlineCallback0<void> &closure,
+      LoopProfiler::Site *site = NULL);
+
+  /**
+   * @brief Cancel a timeout.
+   * @param id the id of the timeout. Ids of timeouts that have already run
+   *   are ignored.
+   */
+  void CancelTimeout(ola::thread::timeout_id id);
+
+  /**
+   * @brief Check if there are any events pending.
+   *
+   * Unlike the heap, cancelled events are removed immediately.
+   */
+  bool EventsPending() const { return m_event_count != 0; }
+
+  /**
+   * @brief Execute any expired timeouts.
+   * @param[in,out] now the current time, set to the last time events were
+   * checked.
+   * @returns the time until the next event, or 0 if there are no events.
+   */
+  TimeInterval ExecuteTimeouts(TimeStamp *now);
+
+ private :
+  enum {
+    SLOT_BITS = 8,
+    SLOTS = 1 << SLOT_BITS,
+    SLOT_MASK = SLOTS - 1,
+    LEVELS = 4,
+    // The list an event is on: 0 - (LEVELS * SLOTS - 1) are the wheel slots.
+    EXPIRING_LIST = LEVELS * SLOTS,
+    LIST_COUNT = EXPIRING_LIST + 1,
+    WORDS_PER_LEVEL = SLOTS / 32
+  };
+
+  static const int32_t NO_LIST = -1;  // The event is running.
+  static const int32_t FREE_LIST = -2;  // The event is unused.
+  static const uint32_t NIL = 0xffffffff;
+  static const int64_t TICK_USEC = 1000;
+
+  struct Event {
+    ola::BaseCallback0<void> *single_closure;
+    ola::BaseCallback0<bool> *repeating_closure;
+    ola::InlineCallback0<void> inline_closure;
+    LoopProfiler::Site *site;
+    TimeInterval interval;
+    TimeStamp expiry;
+    uint64_t tick;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t generation;
+    int32_t list;
+  };
+
+  typedef std::vector<Event> EventVector;
+
+  const Clock *m_clock;
+  IntegerVariable *m_timer_count;
+  LoopProfiler *m_profiler;
+  TimeStamp m_start;
+  // The next tick to be processed.
+  uint64_t m_current_tick;
+  // True while the events for m_current_tick are running.
+  bool m_in_tick;
+  unsigned int m_event_count;
+  unsigned int m_level_count[LEVELS];
+  uint32_t m_lists[LIST_COUNT];
+  // A bit per slot, set if the slot has events in it.
+  uint32_t m_occupied[LEVELS][WORDS_PER_LEVEL];
+  EventVector m_events;
+  uint32_t m_free_events;
+  uint32_t m_running;
+  bool m_running_cancelled;
+
+  ola::thread::timeout_id AddEvent(const TimeInterval &interval,
+                                   ola::BaseCallback0<void> *single_closure,
+                                   ola::BaseCallback0<bool> *repeating_closure,
+                                   LoopProfiler::Site *site,
+                                   const ola::InlineCallback0<void>
+                                       *inline_closure);
+  void FreeEvent(uint32_t index);
+  bool DecodeId(ola::thread::timeout_id id, uint32_t *index) const;
+  uint64_t TickFor(const TimeStamp &time) const;
+  void Schedule(uint32_t index);
+  void PushFront(int32_t list, uint32_t index);
+  void Unlink(uint32_t index);
+  void Cascade(unsigned int level, unsigned int slot);
+  unsigned int NextOccupiedSlot(unsigned int level, unsigned int from) const;
+  bool NextEventTick(uint64_t *tick) const;
+  TimeInterval TimeUntil(uint64_t tick, const TimeStamp &now) const;
+  void ProcessTick(TimeStamp *now);
+  void RunEvent(uint32_t index, TimeStamp *now);
+
+  DISALLOW_COPY_AND_ASSIGN(TimingWheel);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_TIMINGWHEEL_H_
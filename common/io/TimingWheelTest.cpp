@@ -0,0 +1,344 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimingWheelTest.cpp
+ * Test fixture for the TimingWheel class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <map>
+#include <vector>
+
+#include "common/io/TimingWheel.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/InlineCallback.h"
+#include "ola/math/Random.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::IntegerVariable;
+using ola::MakeInlineCallback;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::TimingWheel;
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::timeout_id;
+using std::vector;
+
+class TimingWheelTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TimingWheelTest);
+  CPPUNIT_TEST(testNeverEarly);
+  CPPUNIT_TEST(testCancelFromCallback);
+  CPPUNIT_TEST(testStaleIds);
+  CPPUNIT_TEST(testRegisterFromCallback);
+  CPPUNIT_TEST(testInlineTimeouts);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    TimingWheelTest() : m_timer_count("timers") {}
+
+    void setUp();
+    void testNeverEarly();
+    void testCancelFromCallback();
+    void testStaleIds();
+    void testRegisterFromCallback();
+    void testInlineTimeouts();
+
+    void RecordEvent(unsigned int event_id) {
+      TimeStamp now;
+      m_clock.CurrentTime(&now);
+      m_fired[event_id] = now;
+    }
+
+    void CountEvent(unsigned int event_id) {
+      m_counters[event_id]++;
+    }
+
+    bool CancelEvents(timeout_id *first, timeout_id *second) {
+      m_counters[0]++;
+      m_wheel->CancelTimeout(*first);
+      m_wheel->CancelTimeout(*second);
+      return true;
+    }
+
+    void RegisterEvent(unsigned int event_id) {
+      m_counters[event_id]++;
+      m_wheel->RegisterSingleTimeout(
+          TimeInterval(0, 500),
+          NewSingleCallback(this, &TimingWheelTest::CountEvent, event_id + 1));
+    }
+
+    void RegisterInlineEvents(unsigned int event_id) {
+      m_counters[event_id]++;
+      // Enough events that the wheel has to grow its pool of events.
+      for (unsigned int i = 0; i < 100; i++) {
+        m_wheel->RegisterSingleTimeout(
+            TimeInterval(0, 500),
+            MakeInlineCallback(this, &TimingWheelTest::CountEvent,
+                               event_id + 1));
+      }
+    }
+
+ private:
+    MockClock m_clock;
+    IntegerVariable m_timer_count;
+    TimingWheel *m_wheel;
+    std::map<unsigned int, TimeStamp> m_fired;
+    std::map<unsigned int, unsigned int> m_counters;
+
+    TimeStamp Execute(TimeInterval *next);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimingWheelTest);
+
+void TimingWheelTest::setUp() {
+  ola::math::InitRandom();
+  m_timer_count.Reset();
+  m_fired.clear();
+  m_counters.clear();
+}
+
+/*
+ * Run the expired events, returns the time the events were last checked.
+ */
+TimeStamp TimingWheelTest::Execute(TimeInterval *next) {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  *next = m_wheel->ExecuteTimeouts(&now);
+  return now;
+}
+
+
+/*
+ * Check events spread over all the levels of the wheel run after, and soon
+ * after, they're due. Also check the returned interval never sleeps past the
+ * next event.
+ */
+void TimingWheelTest::testNeverEarly() {
+  TimingWheel wheel(&m_clock, &m_timer_count);
+  m_wheel = &wheel;
+
+  const unsigned int EVENT_COUNT = 500;
+  vector<TimeStamp> earliest, latest;
+  vector<bool> cancelled;
+  TimeStamp now;
+  unsigned int pending = 0;
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    // From 0 up to ~18 hours, so we cover all four levels.
+    int64_t usec;
+    switch (i % 4) {
+      case 0:
+        usec = ola::math::Random(0, 250000);
+        break;
+      case 1:
+        usec = ola::math::Random(0, 65000) * 1000;
+        break;
+      case 2:
+        usec = static_cast<int64_t>(ola::math::Random(0, 16000)) * 1000000;
+        break;
+      default:
+        usec = static_cast<int64_t>(ola::math::Random(16000, 64000)) *
+               1000000;
+    }
+    // The wheel reads the clock itself, so the expiry time is somewhere
+    // between these two.
+    m_clock.CurrentTime(&now);
+    earliest.push_back(now + TimeInterval(usec));
+    timeout_id id = wheel.RegisterSingleTimeout(
+        TimeInterval(usec),
+        NewSingleCallback(this, &TimingWheelTest::RecordEvent, i));
+    OLA_ASSERT_NE(INVALID_TIMEOUT, id);
+    m_clock.CurrentTime(&now);
+    latest.push_back(now + TimeInterval(usec));
+
+    // Cancel some, to check they're removed from the middle of the lists.
+    cancelled.push_back(i % 7 == 3);
+    if (cancelled.back()) {
+      wheel.CancelTimeout(id);
+    } else {
+      pending++;
+    }
+  }
+  OLA_ASSERT_EQ(static_cast<int>(pending), m_timer_count.Get());
+
+  TimeInterval next;
+  now = Execute(&next);
+  while (wheel.EventsPending()) {
+    OLA_ASSERT_FALSE(next.IsZero());
+    TimeStamp wake_up = now + next;
+    for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+      if (!cancelled[i] && m_fired.find(i) == m_fired.end()) {
+        OLA_ASSERT_TRUE(wake_up <= latest[i] + TimeInterval(1));
+      }
+    }
+    // Either wake up when asked to, or a little earlier.
+    if (ola::math::Random(0, 3) == 0 && next.AsInt() > 1) {
+      m_clock.AdvanceTime(TimeInterval(next.AsInt() / 2));
+    } else {
+      m_clock.AdvanceTime(next);
+    }
+    now = Execute(&next);
+  }
+
+  OLA_ASSERT_EQ(static_cast<size_t>(pending), m_fired.size());
+  for (unsigned int i = 0; i < EVENT_COUNT; i++) {
+    if (cancelled[i]) {
+      OLA_ASSERT_TRUE(m_fired.find(i) == m_fired.end());
+    } else {
+      OLA_ASSERT_TRUE(earliest[i] <= m_fired[i]);
+    }
+  }
+  OLA_ASSERT_EQ(0, m_timer_count.Get());
+  OLA_ASSERT_TRUE(next.IsZero());
+}
+
+
+/*
+ * Check a running event can cancel itself and an event due in the same tick.
+ */
+void TimingWheelTest::testCancelFromCallback() {
+  TimingWheel wheel(&m_clock, &m_timer_count);
+  m_wheel = &wheel;
+
+  timeout_id first = INVALID_TIMEOUT;
+  timeout_id second = INVALID_TIMEOUT;
+  first = wheel.RegisterRepeatingTimeout(
+      TimeInterval(0, 10000),
+      NewCallback(this, &TimingWheelTest::CancelEvents, &first, &second));
+  second = wheel.RegisterSingleTimeout(
+      TimeInterval(0, 10000),
+      NewSingleCallback(this, &TimingWheelTest::CountEvent, 1u));
+  OLA_ASSERT_EQ(2, m_timer_count.Get());
+
+  m_clock.AdvanceTime(0, 20000);
+  TimeInterval next;
+  Execute(&next);
+
+  // The repeating event was registered first, so it runs first.
+  OLA_ASSERT_EQ(1u, m_counters[0]);
+  OLA_ASSERT_EQ(0u, m_counters[1]);
+  OLA_ASSERT_FALSE(wheel.EventsPending());
+  OLA_ASSERT_EQ(0, m_timer_count.Get());
+  OLA_ASSERT_TRUE(next.IsZero());
+}
+
+
+/*
+ * Check cancelling the id of an event that already ran doesn't touch the
+ * event that re-used its storage.
+ */
+void TimingWheelTest::testStaleIds() {
+  TimingWheel wheel(&m_clock, &m_timer_count);
+  m_wheel = &wheel;
+
+  timeout_id old_id = wheel.RegisterSingleTimeout(
+      TimeInterval(0, 1000),
+      NewSingleCallback(this, &TimingWheelTest::CountEvent, 1u));
+  m_clock.AdvanceTime(0, 2000);
+  TimeInterval next;
+  Execute(&next);
+  OLA_ASSERT_EQ(1u, m_counters[1]);
+
+  timeout_id new_id = wheel.RegisterSingleTimeout(
+      TimeInterval(0, 1000),
+      NewSingleCallback(this, &TimingWheelTest::CountEvent, 2u));
+  OLA_ASSERT_NE(old_id, new_id);
+  wheel.CancelTimeout(old_id);
+  OLA_ASSERT_TRUE(wheel.EventsPending());
+
+  m_clock.AdvanceTime(0, 2000);
+  Execute(&next);
+  OLA_ASSERT_EQ(1u, m_counters[2]);
+
+  // Cancelling twice is harmless.
+  wheel.CancelTimeout(new_id);
+  wheel.CancelTimeout(new_id);
+  OLA_ASSERT_EQ(0, m_timer_count.Get());
+}
+
+
+/*
+ * Check events registered from a callback run on a later call.
+ */
+void TimingWheelTest::testRegisterFromCallback() {
+  TimingWheel wheel(&m_clock, &m_timer_count);
+  m_wheel = &wheel;
+
+  wheel.RegisterSingleTimeout(
+      TimeInterval(0, 1000),
+      NewSingleCallback(this, &TimingWheelTest::RegisterEvent, 1u));
+  m_clock.AdvanceTime(0, 1000);
+  TimeInterval next;
+  Execute(&next);
+  OLA_ASSERT_EQ(1u, m_counters[1]);
+  OLA_ASSERT_EQ(0u, m_counters[2]);
+  OLA_ASSERT_TRUE(wheel.EventsPending());
+  OLA_ASSERT_FALSE(next.IsZero());
+  OLA_ASSERT_LTE(next, TimeInterval(0, 1000));
+
+  // The new event may be in the next tick, so this can take a couple of
+  // calls.
+  for (unsigned int i = 0; i < 3 && wheel.EventsPending(); i++) {
+    m_clock.AdvanceTime(next);
+    Execute(&next);
+  }
+  OLA_ASSERT_EQ(1u, m_counters[2]);
+  OLA_ASSERT_FALSE(wheel.EventsPending());
+}
+
+
+/*
+ * Check timeouts stored by value run once, and can register more timeouts.
+ */
+void TimingWheelTest::testInlineTimeouts() {
+  TimingWheel wheel(&m_clock, &m_timer_count);
+  m_wheel = &wheel;
+
+  OLA_ASSERT_EQ(INVALID_TIMEOUT,
+                wheel.RegisterSingleTimeout(TimeInterval(0, 1000),
+                                            ola::InlineCallback0<void>()));
+
+  timeout_id cancelled = wheel.RegisterSingleTimeout(
+      TimeInterval(0, 1000),
+      MakeInlineCallback(this, &TimingWheelTest::CountEvent, 0u));
+  wheel.RegisterSingleTimeout(
+      TimeInterval(0, 1000),
+      MakeInlineCallback(this, &TimingWheelTest::RegisterInlineEvents, 1u));
+  OLA_ASSERT_EQ(2, m_timer_count.Get());
+  wheel.CancelTimeout(cancelled);
+  OLA_ASSERT_EQ(1, m_timer_count.Get());
+
+  m_clock.AdvanceTime(0, 1000);
+  TimeInterval next;
+  Execute(&next);
+  OLA_ASSERT_EQ(0u, m_counters[0]);
+  OLA_ASSERT_EQ(1u, m_counters[1]);
+  OLA_ASSERT_EQ(100, m_timer_count.Get());
+
+  for (unsigned int i = 0; i < 3 && wheel.EventsPending(); i++) {
+    m_clock.AdvanceTime(next);
+    Execute(&next);
+  }
+  OLA_ASSERT_EQ(100u, m_counters[2]);
+  OLA_ASSERT_FALSE(wheel.EventsPending());
+  OLA_ASSERT_EQ(0, m_timer_count.Get());
+}
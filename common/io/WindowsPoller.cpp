@@ -347,7 +347,7 @@ bool WindowsPoller::Poll(TimeoutManager *timeout_manager,
               ConnectedDescriptor::OnCloseCallback *on_close =
                 descriptor->connected_descriptor->TransferOnClose();
               if (on_close)
-                on_close->Run();
+                DispatchClose(descriptor->connected_descriptor, on_close);
               if (descriptor->connected_descriptor) {
                 if (descriptor->delete_connected_on_close) {
                   if (RemoveReadDescriptor(descriptor->connected_descriptor) &&
@@ -519,7 +519,7 @@ bool WindowsPoller::Poll(TimeoutManager *timeout_manager,
     DescriptorHandle handle =
         descriptor->connected_descriptor->ReadDescriptor();
     if (*handle.m_async_data_size > 0) {
-      descriptor->connected_descriptor->PerformRead();
+      DispatchRead(descriptor->connected_descriptor);
     }
   }
 
@@ -628,7 +628,7 @@ void WindowsPoller::HandleWakeup(PollData* data) {
               data->buffer, to_copy);
           *handle.m_async_data_size += to_copy;
           if (*handle.m_async_data_size > 0) {
-            descriptor->connected_descriptor->PerformRead();
+            DispatchRead(descriptor->connected_descriptor);
           }
         } else if (!data->read && descriptor->write_descriptor) {
           OLA_WARN << "Write wakeup";
@@ -639,7 +639,7 @@ void WindowsPoller::HandleWakeup(PollData* data) {
             return;
           }
 
-          descriptor->write_descriptor->PerformWrite();
+          DispatchWrite(descriptor->write_descriptor);
         } else {
           OLA_WARN << "Overlapped wakeup with data mismatch";
         }
@@ -655,9 +655,9 @@ void WindowsPoller::HandleWakeup(PollData* data) {
         } else {
           if (events.lNetworkEvents & (FD_READ | FD_ACCEPT)) {
             if (descriptor->connected_descriptor) {
-              descriptor->connected_descriptor->PerformRead();
+              DispatchRead(descriptor->connected_descriptor);
             } else if (descriptor->read_descriptor) {
-              descriptor->read_descriptor->PerformRead();
+              DispatchRead(descriptor->read_descriptor);
             } else {
               OLA_WARN << "No read descriptor for socket with read event";
             }
@@ -665,7 +665,7 @@ void WindowsPoller::HandleWakeup(PollData* data) {
 
           if (events.lNetworkEvents & (FD_WRITE | FD_CONNECT)) {
             if (descriptor->write_descriptor) {
-              descriptor->write_descriptor->PerformWrite();
+              DispatchWrite(descriptor->write_descriptor);
             } else {
               OLA_WARN << "No write descriptor for socket with write event";
             }
@@ -676,7 +676,7 @@ void WindowsPoller::HandleWakeup(PollData* data) {
               ConnectedDescriptor::OnCloseCallback *on_close =
                   descriptor->connected_descriptor->TransferOnClose();
               if (on_close)
-                on_close->Run();
+                DispatchClose(descriptor->connected_descriptor, on_close);
               if (descriptor->delete_connected_on_close) {
                 if (RemoveReadDescriptor(descriptor->connected_descriptor) &&
                     m_export_map) {
@@ -738,7 +738,7 @@ void WindowsPoller::FinalCheckIOs(vector<PollData*> data) {
       memcpy(&(handle.m_async_data[*handle.m_async_data_size]),
           poll_data->buffer, to_copy);
       *handle.m_async_data_size += to_copy;
-      descriptor->connected_descriptor->PerformRead();
+      DispatchRead(descriptor->connected_descriptor);
     }
   }
 }
@@ -17,6 +17,7 @@
  * Copyright (C) 2012 Simon Newton
  */
 
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/network/HealthCheckedConnection.h"
 #include "ola/thread/SchedulerInterface.h"
@@ -105,7 +106,7 @@ void HealthCheckedConnection::UpdateReceiveTimer() {
         2.5 * m_heartbeat_interval.AsInt()));
   m_receive_timeout_id = m_scheduler->RegisterSingleTimeout(
     timeout_interval,
-    NewSingleCallback(
+    MakeInlineCallback(
       this, &HealthCheckedConnection::InternalHeartbeatTimeout));
 }
 
@@ -117,7 +117,7 @@ Interface& Interface::operator=(const Interface &other) {
 }
 
 
-bool Interface::operator==(const Interface &other) {
+bool Interface::operator==(const Interface &other) const {
   return (name == other.name &&
           ip_address == other.ip_address &&
           subnet_mask == other.subnet_mask &&
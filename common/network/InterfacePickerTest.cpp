@@ -46,12 +46,14 @@ class InterfacePickerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(InterfacePickerTest);
   CPPUNIT_TEST(testGetInterfaces);
   CPPUNIT_TEST(testGetLoopbackInterfaces);
+  CPPUNIT_TEST(testCachedInterfaces);
   CPPUNIT_TEST(testChooseInterface);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testGetInterfaces();
     void testGetLoopbackInterfaces();
+    void testCachedInterfaces();
     void testChooseInterface();
 };
 
@@ -102,6 +104,32 @@ void InterfacePickerTest::testGetLoopbackInterfaces() {
 }
 
 
+/*
+ * Check that repeated calls, which are served from the cache, return the same
+ * interfaces, and that the loopback filter still applies.
+ */
+void InterfacePickerTest::testCachedInterfaces() {
+  auto_ptr<InterfacePicker> picker(InterfacePicker::NewPicker());
+  vector<Interface> interfaces = picker->GetInterfaces(true);
+  vector<Interface> cached_interfaces = picker->GetInterfaces(true);
+  OLA_ASSERT_EQ(interfaces.size(), cached_interfaces.size());
+  for (unsigned int i = 0; i < interfaces.size(); i++) {
+    OLA_ASSERT_TRUE(interfaces[i] == cached_interfaces[i]);
+  }
+
+  auto_ptr<InterfacePicker> other_picker(InterfacePicker::NewPicker());
+  OLA_ASSERT_EQ(interfaces.size(),
+                other_picker->GetInterfaces(true).size());
+
+  vector<Interface> filtered = picker->GetInterfaces(false);
+  OLA_ASSERT_TRUE(filtered.size() <= interfaces.size());
+  vector<Interface>::const_iterator iter = filtered.begin();
+  for (; iter != filtered.end(); ++iter) {
+    OLA_ASSERT_FALSE(iter->loopback);
+  }
+}
+
+
 void InterfacePickerTest::testChooseInterface() {
   vector<Interface> interfaces;
   FakeInterfacePicker picker(interfaces);
@@ -0,0 +1,100 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceWatcher.cpp
+ * Run a callback when the network interfaces change.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <unistd.h>
+#include <vector>
+
+#include "common/network/NetworkUtilsInternal.h"
+#include "ola/Logging.h"
+#include "ola/network/InterfaceWatcher.h"
+
+namespace ola {
+namespace network {
+
+using ola::io::ToFD;
+using ola::io::UnmanagedFileDescriptor;
+using std::vector;
+
+InterfaceWatcher::InterfaceWatcher(ola::io::SelectServerInterface *ss,
+                                   Callback0<void> *on_change)
+    : m_ss(ss),
+      m_on_change(on_change),
+      m_picker(InterfacePicker::NewPicker()),
+      m_settle_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+InterfaceWatcher::~InterfaceWatcher() {
+  Stop();
+}
+
+bool InterfaceWatcher::Start() {
+  if (m_descriptor.get()) {
+    return true;
+  }
+
+  int sd = OpenInterfaceChangeSocket();
+  if (sd < 0) {
+    return false;
+  }
+
+  m_interfaces = m_picker->GetInterfaces(true);
+  m_descriptor.reset(new UnmanagedFileDescriptor(sd));
+  m_descriptor->SetOnData(NewCallback(this, &InterfaceWatcher::SocketReady));
+  m_descriptor->SetReadLabel("interface-watcher");
+  m_ss->AddReadDescriptor(m_descriptor.get());
+  return true;
+}
+
+void InterfaceWatcher::Stop() {
+  if (m_settle_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_settle_timeout);
+    m_settle_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_descriptor.get()) {
+    m_ss->RemoveReadDescriptor(m_descriptor.get());
+    close(ToFD(m_descriptor->ReadDescriptor()));
+    m_descriptor.reset();
+  }
+}
+
+void InterfaceWatcher::SocketReady() {
+  if (ReadInterfaceChanges(ToFD(m_descriptor->ReadDescriptor())) &&
+      m_settle_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_settle_timeout = m_ss->RegisterSingleTimeout(
+        SETTLE_DELAY_MS, NewSingleCallback(this, &InterfaceWatcher::Settled));
+  }
+}
+
+void InterfaceWatcher::Settled() {
+  m_settle_timeout = ola::thread::INVALID_TIMEOUT;
+
+  vector<Interface> interfaces = m_picker->GetInterfaces(true);
+  if (interfaces == m_interfaces) {
+    return;
+  }
+
+  OLA_INFO << "Network interfaces changed, " << interfaces.size()
+           << " now configured";
+  m_interfaces.swap(interfaces);
+  m_on_change->Run();
+}
+}  // namespace network
+}  // namespace ola
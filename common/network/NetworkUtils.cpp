@@ -59,6 +59,9 @@ typedef uint32_t in_addr_t;
 #include <endian.h>
 #endif  // HAVE_ENDIAN_H
 #include <errno.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif  // _WIN32
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
@@ -630,5 +633,103 @@ bool DefaultRoute(int32_t *if_index, IPV4Address *default_gateway) {
   return false;
 #endif  // USE_SYSCTL_FOR_DEFAULT_ROUTE
 }
+
+int OpenInterfaceChangeSocket() {
+#if defined(USE_NETLINK_FOR_DEFAULT_ROUTE)
+  int sd = socket(PF_ROUTE, SOCK_DGRAM, NETLINK_ROUTE);
+  if (sd < 0) {
+    OLA_WARN << "Could not create Netlink socket " << strerror(errno);
+    return -1;
+  }
+
+  struct sockaddr_nl address;
+  memset(&address, 0, sizeof(address));
+  address.nl_family = AF_NETLINK;
+  address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+  if (bind(sd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) < 0) {
+    OLA_WARN << "Failed to bind the Netlink socket " << strerror(errno);
+    close(sd);
+    return -1;
+  }
+#elif defined(USE_SYSCTL_FOR_DEFAULT_ROUTE)
+  int sd = socket(PF_ROUTE, SOCK_RAW, AF_UNSPEC);
+  if (sd < 0) {
+    OLA_WARN << "Could not create routing socket " << strerror(errno);
+    return -1;
+  }
+#else
+  return -1;
+#endif  // defined(USE_NETLINK_FOR_DEFAULT_ROUTE)
+
+#if defined(USE_NETLINK_FOR_DEFAULT_ROUTE) || \
+    defined(USE_SYSCTL_FOR_DEFAULT_ROUTE)
+  int flags = fcntl(sd, F_GETFL, 0);
+  if (flags < 0 || fcntl(sd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    OLA_WARN << "Failed to make the interface change socket non-blocking "
+             << strerror(errno);
+    close(sd);
+    return -1;
+  }
+  return sd;
+#endif  // defined(USE_NETLINK_FOR_DEFAULT_ROUTE) || ...
+}
+
+bool ReadInterfaceChanges(int sd) {
+  bool changed = false;
+#if defined(USE_NETLINK_FOR_DEFAULT_ROUTE) || \
+    defined(USE_SYSCTL_FOR_DEFAULT_ROUTE)
+  uint8_t buffer[8192];
+  while (true) {
+    int len = recv(sd, buffer, sizeof(buffer), 0);
+    if (len < 0) {
+      if (errno == ENOBUFS) {
+        // The socket overflowed, so we don't know what changed.
+        changed = true;
+        continue;
+      } else if (errno == EINTR) {
+        continue;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "Failed to read interface changes " << strerror(errno);
+      }
+      return changed;
+    } else if (len == 0) {
+      return changed;
+    }
+
+#if defined(USE_NETLINK_FOR_DEFAULT_ROUTE)
+    for (struct nlmsghdr *nl_hdr = reinterpret_cast<struct nlmsghdr*>(buffer);
+         NLMSG_OK(nl_hdr, static_cast<unsigned int>(len));
+         nl_hdr = NLMSG_NEXT(nl_hdr, len)) {
+      switch (nl_hdr->nlmsg_type) {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+          changed = true;
+          break;
+      }
+    }
+#else
+    // Each read returns a single message.
+    const struct rt_msghdr *rt_hdr =
+        reinterpret_cast<const struct rt_msghdr*>(buffer);
+    switch (rt_hdr->rtm_type) {
+      case RTM_NEWADDR:
+      case RTM_DELADDR:
+      case RTM_IFINFO:
+#ifdef RTM_IFANNOUNCE
+      case RTM_IFANNOUNCE:
+#endif  // RTM_IFANNOUNCE
+        changed = true;
+        break;
+    }
+#endif  // defined(USE_NETLINK_FOR_DEFAULT_ROUTE)
+  }
+#else
+  (void) sd;
+#endif  // defined(USE_NETLINK_FOR_DEFAULT_ROUTE) || ...
+  return changed;
+}
 }  // namespace network
 }  // namespace ola
@@ -44,6 +44,22 @@ namespace network {
  */
 unsigned int SockAddrLen(const struct sockaddr &sa);
 
+/**
+ * Open a non-blocking socket that becomes readable when an interface or
+ * address changes. This is a netlink socket on Linux and a routing socket on
+ * the BSDs.
+ * @returns the socket, or -1 if change notifications aren't supported.
+ */
+int OpenInterfaceChangeSocket();
+
+/**
+ * Read the pending notifications from a socket returned by
+ * OpenInterfaceChangeSocket().
+ * @returns true if any of them were for an interface or address, or if
+ *   notifications were lost.
+ */
+bool ReadInterfaceChanges(int sd);
+
 }  // namespace network
 }  // namespace ola
 #endif  // COMMON_NETWORK_NETWORKUTILSINTERNAL_H_
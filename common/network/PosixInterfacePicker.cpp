@@ -59,18 +59,62 @@
 #include "ola/network/MACAddress.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/SocketCloser.h"
+#include "ola/thread/Mutex.h"
 
 namespace ola {
 namespace network {
 
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
 using std::string;
 using std::vector;
 
+namespace {
+// The interfaces are shared by all the pickers in the process. They're only
+// enumerated again once the change socket reports a change, or on every call
+// if change notifications aren't supported. The socket stays open for the
+// life of the process.
+Mutex cache_mutex;
+bool change_socket_opened = false;
+int change_socket = -1;
+bool cache_valid = false;
+vector<Interface> cached_interfaces;
+}  // namespace
+
 /*
  * Return a vector of interfaces on the system.
  */
 vector<Interface> PosixInterfacePicker::GetInterfaces(
     bool include_loopback) const {
+  MutexLocker lock(&cache_mutex);
+  if (!change_socket_opened) {
+    change_socket = OpenInterfaceChangeSocket();
+    change_socket_opened = true;
+  }
+
+  // The notifications are read before enumerating, so a change made while
+  // we're enumerating is picked up by the next call.
+  bool changed = change_socket < 0 || ReadInterfaceChanges(change_socket);
+  if (changed || !cache_valid) {
+    cached_interfaces = EnumerateInterfaces();
+    cache_valid = true;
+  }
+
+  vector<Interface> interfaces;
+  vector<Interface>::const_iterator iter = cached_interfaces.begin();
+  for (; iter != cached_interfaces.end(); ++iter) {
+    if (include_loopback || !iter->loopback) {
+      interfaces.push_back(*iter);
+    }
+  }
+  return interfaces;
+}
+
+/*
+ * Enumerate the interfaces with ioctls, this includes the loopback
+ * interfaces.
+ */
+vector<Interface> PosixInterfacePicker::EnumerateInterfaces() const {
   vector<Interface> interfaces;
 
 #ifdef HAVE_SOCKADDR_DL_STRUCT
@@ -155,13 +199,7 @@ vector<Interface> PosixInterfacePicker::GetInterfaces(
     interface.name = iface->ifr_name;
 
     if (ifrcopy.ifr_flags & IFF_LOOPBACK) {
-      if (include_loopback) {
-        interface.loopback = true;
-      } else {
-        OLA_DEBUG << "Skipping " << iface->ifr_name
-                  << " because it's a loopback";
-        continue;
-      }
+      interface.loopback = true;
     }
 
 #ifdef HAVE_SOCKADDR_DL_STRUCT
@@ -28,13 +28,15 @@ namespace network {
 
 
 /*
- * The InterfacePicker for posix systems
+ * The InterfacePicker for posix systems. The interfaces are cached for the
+ * whole process, and enumerated again when the kernel reports a change.
  */
 class PosixInterfacePicker: public InterfacePicker {
  public:
     std::vector<Interface> GetInterfaces(bool include_loopback) const;
 
  private:
+    std::vector<Interface> EnumerateInterfaces() const;
     static const unsigned int INITIAL_IFACE_COUNT = 10;
     static const unsigned int IFACE_COUNT_INC = 5;
     unsigned int GetIfReqSize(const char *data) const;
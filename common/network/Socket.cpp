@@ -48,9 +48,15 @@
 #include <netinet/in.h>
 #endif  // HAVE_NETINET_IN_H
 
+#ifdef HAVE_UDP_SEGMENT
+#include <netinet/udp.h>
+#endif  // HAVE_UDP_SEGMENT
+
+#include <algorithm>
 #include <string>
 
 #include "common/network/SocketHelper.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/TCPSocketFactory.h"
@@ -58,6 +64,8 @@
 namespace ola {
 namespace network {
 
+using std::string;
+
 namespace {
 
 bool ReceiveFrom(int fd, uint8_t *buffer, ssize_t *data_read,
@@ -76,6 +84,69 @@ bool ReceiveFrom(int fd, uint8_t *buffer, ssize_t *data_read,
   return true;
 }
 
+#ifndef HAVE_RECVMMSG
+/*
+ * Read a single datagram, returns false if there was nothing to read or an
+ * error occurred.
+ */
+bool ReceiveDatagram(int fd, UDPDatagram *datagram, int flags) {
+  struct sockaddr_in src_sockaddr;
+  socklen_t src_size = sizeof(src_sockaddr);
+  ssize_t size = recvfrom(
+      fd, reinterpret_cast<char*>(datagram->data), datagram->capacity, flags,
+      reinterpret_cast<struct sockaddr*>(&src_sockaddr), &src_size);
+  if (size < 0) {
+#ifdef _WIN32
+    OLA_WARN << "recvfrom fd: " << fd << " failed: " << WSAGetLastError();
+#else
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "recvfrom fd: " << fd << " failed: " << strerror(errno);
+    }
+#endif  // _WIN32
+    return false;
+  }
+  datagram->size = static_cast<unsigned int>(size);
+  datagram->source = IPV4SocketAddress(
+      IPV4Address(src_sockaddr.sin_addr.s_addr),
+      NetworkToHost(src_sockaddr.sin_port));
+  return true;
+}
+#endif  // !HAVE_RECVMMSG
+
+#ifdef HAVE_UDP_SEGMENT
+/*
+ * Return the number of datagrams, starting from the first, that can be
+ * combined into a single message with UDP_SEGMENT. All but the last must be
+ * the same size and they must all have the same destination.
+ */
+unsigned int SegmentCount(const UDPOutgoingDatagram *datagrams,
+                          unsigned int count) {
+  // The kernel limits the number of segments, and the total still has to fit
+  // in a single UDP datagram.
+  static const unsigned int MAX_SEGMENTS = 64;
+  static const unsigned int MAX_PAYLOAD = 65507;
+
+  const UDPOutgoingDatagram &first = datagrams[0];
+  unsigned int segments = 1;
+  unsigned int total = first.size;
+  count = std::min(count, MAX_SEGMENTS);
+  while (segments < count) {
+    const UDPOutgoingDatagram &next = datagrams[segments];
+    if (next.destination != first.destination || next.size > first.size ||
+        next.size == 0 || total + next.size > MAX_PAYLOAD) {
+      break;
+    }
+    total += next.size;
+    segments++;
+    if (next.size < first.size) {
+      // A short segment has to be the last one.
+      break;
+    }
+  }
+  return segments;
+}
+#endif  // HAVE_UDP_SEGMENT
+
 }  // namespace
 
 // UDPSocket
@@ -279,6 +350,105 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   return bytes_sent;
 }
 
+unsigned int UDPSocket::SendMany(const UDPOutgoingDatagram *datagrams,
+                                 unsigned int count) const {
+#ifdef HAVE_SENDMMSG
+  static const unsigned int MAX_BATCH = 64;
+  struct mmsghdr headers[MAX_BATCH];
+  struct iovec iovs[MAX_BATCH];
+  struct sockaddr_in destinations[MAX_BATCH];
+  // The number of datagrams in each message
+  unsigned int segments[MAX_BATCH];
+#ifdef HAVE_UDP_SEGMENT
+  union {
+    char buffer[CMSG_SPACE(sizeof(uint16_t))];
+    struct cmsghdr align;
+  } control[MAX_BATCH];
+#endif  // HAVE_UDP_SEGMENT
+
+  unsigned int sent = 0;
+  unsigned int offset = 0;
+  while (offset < count) {
+    // Each datagram uses one iovec, so we can have at most MAX_BATCH
+    // datagrams in flight.
+    unsigned int end = offset + std::min(count - offset, MAX_BATCH);
+    unsigned int messages = 0;
+    memset(headers, 0, sizeof(headers));
+    for (unsigned int i = offset; i < end; messages++) {
+      const UDPOutgoingDatagram &datagram = datagrams[i];
+#ifdef HAVE_UDP_SEGMENT
+      unsigned int segment_count = m_use_gso ?
+          SegmentCount(datagrams + i, end - i) : 1;
+#else
+      unsigned int segment_count = 1;
+#endif  // HAVE_UDP_SEGMENT
+      struct msghdr *header = &headers[messages].msg_hdr;
+
+      memset(&destinations[messages], 0, sizeof(destinations[messages]));
+      datagram.destination.ToSockAddr(
+          reinterpret_cast<struct sockaddr*>(&destinations[messages]),
+          sizeof(destinations[messages]));
+      header->msg_name = &destinations[messages];
+      header->msg_namelen = sizeof(destinations[messages]);
+      header->msg_iov = &iovs[i - offset];
+      header->msg_iovlen = segment_count;
+      for (unsigned int j = 0; j < segment_count; j++) {
+        iovs[i - offset + j].iov_base = const_cast<uint8_t*>(
+            datagrams[i + j].data);
+        iovs[i - offset + j].iov_len = datagrams[i + j].size;
+      }
+
+#ifdef HAVE_UDP_SEGMENT
+      if (segment_count > 1) {
+        header->msg_control = control[messages].buffer;
+        header->msg_controllen = sizeof(control[messages].buffer);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(header);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t segment_size = datagram.size;
+        memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+      }
+#endif  // HAVE_UDP_SEGMENT
+      segments[messages] = segment_count;
+      i += segment_count;
+    }
+
+    int result = sendmmsg(m_handle, headers, messages, 0);
+    if (result <= 0) {
+      if (segments[0] > 1 &&
+          (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)) {
+        OLA_INFO << "UDP segmentation offload failed on " << m_handle << ": "
+                 << strerror(errno) << ", disabling";
+        m_use_gso = false;
+        continue;
+      }
+      OLA_INFO << "Failed to send on " << m_handle << ": to "
+               << datagrams[offset].destination << " : " << strerror(errno);
+      // Skip the message that failed and carry on with the rest.
+      offset += segments[0];
+      continue;
+    }
+
+    for (int j = 0; j < result; j++) {
+      sent += segments[j];
+      offset += segments[j];
+    }
+  }
+  return sent;
+#else
+  unsigned int sent = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    ssize_t bytes_sent = SendTo(datagrams[i].data, datagrams[i].size,
+                                datagrams[i].destination);
+    if (bytes_sent == static_cast<ssize_t>(datagrams[i].size)) {
+      sent++;
+    }
+  }
+  return sent;
+#endif  // HAVE_SENDMMSG
+}
+
 bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
   socklen_t length = 0;
 #ifdef _WIN32
@@ -342,6 +512,102 @@ bool UDPSocket::RecvFrom(uint8_t *buffer,
   return ok;
 }
 
+unsigned int UDPSocket::RecvMany(UDPDatagram *datagrams, unsigned int count) {
+#ifdef HAVE_RECVMMSG
+  static const unsigned int MAX_BATCH = 64;
+  struct mmsghdr headers[MAX_BATCH];
+  struct iovec iovs[MAX_BATCH];
+  struct sockaddr_in sources[MAX_BATCH];
+
+  count = std::min(count, MAX_BATCH);
+  memset(headers, 0, sizeof(headers[0]) * count);
+  for (unsigned int i = 0; i < count; i++) {
+    iovs[i].iov_base = datagrams[i].data;
+    iovs[i].iov_len = datagrams[i].capacity;
+    headers[i].msg_hdr.msg_name = &sources[i];
+    headers[i].msg_hdr.msg_namelen = sizeof(sources[i]);
+    headers[i].msg_hdr.msg_iov = &iovs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // Only the last datagram's drop count matters, since it's cumulative, but
+  // the kernel attaches it to each one. The timestamps are per datagram.
+  static const unsigned int CONTROL_SIZE = (
+#ifdef SO_RXQ_OVFL
+      CMSG_SPACE(sizeof(uint32_t)) +
+#endif  // SO_RXQ_OVFL
+#ifdef SO_TIMESTAMPNS
+      CMSG_SPACE(sizeof(struct timespec)) +
+#endif  // SO_TIMESTAMPNS
+      0);
+  bool want_control = m_count_drops || m_timestamps;
+  char control[MAX_BATCH][CONTROL_SIZE ? CONTROL_SIZE : 1];
+  if (want_control && CONTROL_SIZE) {
+    for (unsigned int i = 0; i < count; i++) {
+      headers[i].msg_hdr.msg_control = control[i];
+      headers[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+  }
+
+  int received = recvmmsg(m_handle, headers, count, MSG_DONTWAIT, NULL);
+  if (received < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "recvmmsg fd: " << m_handle << " failed: "
+               << strerror(errno);
+    }
+    return 0;
+  }
+
+  for (int i = 0; want_control && i < received; i++) {
+    struct msghdr *header = &headers[i].msg_hdr;
+    datagrams[i].arrival = TimeStamp();
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(header); cmsg;
+         cmsg = CMSG_NXTHDR(header, cmsg)) {
+      if (cmsg->cmsg_level != SOL_SOCKET) {
+        continue;
+      }
+#ifdef SO_RXQ_OVFL
+      if (cmsg->cmsg_type == SO_RXQ_OVFL && i == received - 1) {
+        memcpy(&m_dropped, CMSG_DATA(cmsg), sizeof(m_dropped));
+      }
+#endif  // SO_RXQ_OVFL
+#ifdef SO_TIMESTAMPNS
+      if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+        struct timespec ts;
+        memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+        struct timeval tv;
+        tv.tv_sec = ts.tv_sec;
+        tv.tv_usec = ts.tv_nsec / 1000;
+        datagrams[i].arrival = tv;
+      }
+#endif  // SO_TIMESTAMPNS
+    }
+  }
+
+  for (int i = 0; i < received; i++) {
+    datagrams[i].size = headers[i].msg_len;
+    datagrams[i].source = IPV4SocketAddress(
+        IPV4Address(sources[i].sin_addr.s_addr),
+        NetworkToHost(sources[i].sin_port));
+  }
+  return received;
+#else
+#ifdef _WIN32
+  // There is no MSG_DONTWAIT, so we can only rely on a single datagram being
+  // available.
+  int fd = m_handle.m_handle.m_fd;
+  return count && ReceiveDatagram(fd, &datagrams[0], 0) ? 1 : 0;
+#else
+  unsigned int received = 0;
+  while (received < count &&
+         ReceiveDatagram(m_handle, &datagrams[received], MSG_DONTWAIT)) {
+    received++;
+  }
+  return received;
+#endif  // _WIN32
+#endif  // HAVE_RECVMMSG
+}
+
 bool UDPSocket::EnableBroadcast() {
   if (m_handle == ola::io::INVALID_DESCRIPTOR)
     return false;
@@ -447,6 +713,20 @@ bool UDPSocket::LeaveMulticast(const IPV4Address &iface,
   return true;
 }
 
+bool UDPSocket::SetMulticastAll(OLA_UNUSED bool enable) {
+#ifdef IP_MULTICAST_ALL
+  int value = enable;
+  int ok = setsockopt(m_handle, IPPROTO_IP, IP_MULTICAST_ALL,
+                      reinterpret_cast<char*>(&value), sizeof(value));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set IP_MULTICAST_ALL for " << m_handle << ", "
+             << strerror(errno);
+    return false;
+  }
+#endif  // IP_MULTICAST_ALL
+  return true;
+}
+
 bool UDPSocket::SetTos(uint8_t tos) {
   unsigned int value = tos & 0xFC;  // zero the ECN fields
 #ifdef _WIN32
@@ -464,5 +744,127 @@ bool UDPSocket::SetTos(uint8_t tos) {
   }
   return true;
 }
+
+bool UDPSocket::SetReceiveBufferSize(unsigned int size) {
+  return SetBufferSize(SO_RCVBUF, "SO_RCVBUF", size);
+}
+
+bool UDPSocket::SetSendBufferSize(unsigned int size) {
+  return SetBufferSize(SO_SNDBUF, "SO_SNDBUF", size);
+}
+
+bool UDPSocket::EnableDropCounting() {
+  // The count is only read by recvmmsg().
+#if defined(SO_RXQ_OVFL) && defined(HAVE_RECVMMSG)
+  int value = 1;
+  int ok = setsockopt(m_handle, SOL_SOCKET, SO_RXQ_OVFL,
+                      reinterpret_cast<char*>(&value), sizeof(value));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set SO_RXQ_OVFL for " << m_handle << ", "
+             << strerror(errno);
+    return false;
+  }
+  m_count_drops = true;
+  return true;
+#else
+  return false;
+#endif  // SO_RXQ_OVFL && HAVE_RECVMMSG
+}
+
+bool UDPSocket::EnableReceiveTimestamps() {
+  // The timestamps are only read by recvmmsg().
+#if defined(SO_TIMESTAMPNS) && defined(HAVE_RECVMMSG)
+  int value = 1;
+  int ok = setsockopt(m_handle, SOL_SOCKET, SO_TIMESTAMPNS,
+                      reinterpret_cast<char*>(&value), sizeof(value));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set SO_TIMESTAMPNS for " << m_handle << ", "
+             << strerror(errno);
+    return false;
+  }
+  m_timestamps = true;
+  return true;
+#else
+  return false;
+#endif  // SO_TIMESTAMPNS && HAVE_RECVMMSG
+}
+
+bool UDPSocket::SetBufferSize(int option, const char *name,
+                              unsigned int size) {
+  int value = static_cast<int>(size);
+#ifdef _WIN32
+  int fd = m_handle.m_handle.m_fd;
+#else
+  int fd = m_handle;
+#endif  // _WIN32
+  if (setsockopt(fd, SOL_SOCKET, option, reinterpret_cast<char*>(&value),
+                 sizeof(value)) < 0) {
+    OLA_WARN << "Failed to set " << name << " to " << size << " for " << fd
+             << ", " << strerror(errno);
+    return false;
+  }
+
+  // Linux silently caps the size at rmem_max / wmem_max, and then doubles
+  // it, so check what we actually got.
+  int actual = 0;
+  socklen_t length = sizeof(actual);
+  if (getsockopt(fd, SOL_SOCKET, option, reinterpret_cast<char*>(&actual),
+                 &length) == 0 && actual < value) {
+    OLA_WARN << name << " for " << fd << " is " << actual << ", not " << size
+             << ", check the system limit";
+  }
+  return true;
+}
+
+
+// UDPReceiveRing
+// ------------------------------------------------
+
+const char UDPReceiveRing::DROPS_VAR[] = "udp-rx-kernel-drops";
+
+UDPReceiveRing::UDPReceiveRing(unsigned int depth,
+                               unsigned int datagram_size)
+    : m_depth(depth),
+      m_datagram_size(datagram_size),
+      m_buffer(NULL),
+      m_datagrams(NULL),
+      m_drop_var(NULL),
+      m_last_dropped(0) {
+}
+
+UDPReceiveRing::~UDPReceiveRing() {
+  delete[] m_datagrams;
+  delete[] m_buffer;
+}
+
+unsigned int UDPReceiveRing::Receive(UDPSocketInterface *socket) {
+  if (!m_buffer) {
+    m_buffer = new uint8_t[m_depth * m_datagram_size];
+    m_datagrams = new UDPDatagram[m_depth];
+    for (unsigned int i = 0; i < m_depth; i++) {
+      m_datagrams[i].data = m_buffer + i * m_datagram_size;
+      m_datagrams[i].capacity = m_datagram_size;
+      m_datagrams[i].size = 0;
+    }
+  }
+  unsigned int count = socket->RecvMany(m_datagrams, m_depth);
+  if (m_drop_var) {
+    uint32_t dropped = socket->DroppedDatagrams();
+    if (dropped != m_last_dropped) {
+      (*m_drop_var)[m_drop_key] = dropped;
+      m_last_dropped = dropped;
+    }
+  }
+  return count;
+}
+
+void UDPReceiveRing::ExportDrops(ExportMap *export_map, const string &name) {
+  if (!export_map) {
+    return;
+  }
+  m_drop_key = name;
+  m_drop_var = export_map->GetUIntMapVar(DROPS_VAR, "socket");
+  (*m_drop_var)[m_drop_key] = m_last_dropped;
+}
 }  // namespace network
 }  // namespace ola
@@ -24,6 +24,8 @@
 #include <string>
 
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/IOQueue.h"
@@ -35,6 +37,8 @@
 #include "ola/testing/TestUtils.h"
 
 
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::io::ConnectedDescriptor;
 using ola::io::IOQueue;
 using ola::io::SelectServer;
@@ -43,12 +47,15 @@ using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
+using ola::network::UDPDatagram;
+using ola::network::UDPReceiveRing;
 using ola::network::UDPSocket;
 using std::string;
 
 static const unsigned char test_cstring[] = "Foo";
 // used to set a timeout which aborts the tests
 static const int ABORT_TIMEOUT_IN_MS = 1000;
+static const unsigned int DATAGRAM_COUNT = 6;
 
 class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SocketTest);
@@ -56,6 +63,9 @@ class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTCPSocketServerClose);
   CPPUNIT_TEST(testUDPSocket);
   CPPUNIT_TEST(testIOQueueUDPSend);
+  CPPUNIT_TEST(testUDPRecvMany);
+  CPPUNIT_TEST(testUDPKernelDrops);
+  CPPUNIT_TEST(testUDPReceiveTimestamps);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +75,9 @@ class SocketTest: public CppUnit::TestFixture {
     void testTCPSocketServerClose();
     void testUDPSocket();
     void testIOQueueUDPSend();
+    void testUDPRecvMany();
+    void testUDPKernelDrops();
+    void testUDPReceiveTimestamps();
 
     // timing out indicates something went wrong
     void Timeout() {
@@ -82,6 +95,7 @@ class SocketTest: public CppUnit::TestFixture {
     void NewConnectionSendAndClose(TCPSocket *socket);
     void UDPReceiveAndTerminate(UDPSocket *socket);
     void UDPReceiveAndSend(UDPSocket *socket);
+    void UDPReceiveMany(UDPSocket *socket, UDPReceiveRing *ring);
 
     // Socket close actions
     void TerminateOnClose() {
@@ -91,6 +105,7 @@ class SocketTest: public CppUnit::TestFixture {
  private:
     SelectServer *m_ss;
     ola::SingleUseCallback0<void> *m_timeout_closure;
+    unsigned int m_datagrams_received;
 
     void SocketClientClose(ConnectedDescriptor *socket,
                            ConnectedDescriptor *socket2);
@@ -107,6 +122,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION(SocketTest);
 void SocketTest::setUp() {
   m_ss = new SelectServer();
   m_timeout_closure = ola::NewSingleCallback(this, &SocketTest::Timeout);
+  m_datagrams_received = 0;
   OLA_ASSERT_TRUE(m_ss->RegisterSingleTimeout(ABORT_TIMEOUT_IN_MS,
                                               m_timeout_closure));
 
@@ -279,6 +295,122 @@ void SocketTest::testIOQueueUDPSend() {
 }
 
 
+/*
+ * Test that RecvMany() drains multiple datagrams, including more than fit in
+ * the ring at once.
+ */
+void SocketTest::testUDPRecvMany() {
+  IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(socket_address));
+
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  UDPReceiveRing ring(4, sizeof(test_cstring) + 10);
+  socket.SetOnData(
+      ola::NewCallback(this, &SocketTest::UDPReceiveMany, &socket, &ring));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&socket));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  for (unsigned int i = 0; i < DATAGRAM_COUNT; i++) {
+    ssize_t bytes_sent = client_socket.SendTo(
+        static_cast<const uint8_t*>(test_cstring),
+        sizeof(test_cstring),
+        IPV4SocketAddress(IPV4Address::Loopback(), local_address.Port()));
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring)), bytes_sent);
+  }
+  m_ss->Run();
+  m_ss->RemoveReadDescriptor(&socket);
+  OLA_ASSERT_EQ(DATAGRAM_COUNT, m_datagrams_received);
+}
+
+
+/*
+ * Test the datagrams dropped by the kernel are counted and exported.
+ */
+void SocketTest::testUDPKernelDrops() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+  // The kernel rounds this up to its minimum.
+  OLA_ASSERT_TRUE(socket.SetReceiveBufferSize(1));
+  OLA_ASSERT_TRUE(socket.SetSendBufferSize(65536));
+  if (!socket.EnableDropCounting()) {
+    OLA_INFO << "Drop counting isn't supported, skipping the test";
+    return;
+  }
+
+  ola::ExportMap export_map;
+  UDPReceiveRing ring(4, sizeof(test_cstring) + 10);
+  ring.ExportDrops(&export_map, "test");
+  ola::UIntMap *drops = export_map.GetUIntMapVar(UDPReceiveRing::DROPS_VAR);
+  OLA_ASSERT_EQ(0u, (*drops)["test"]);
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  const IPV4SocketAddress destination(IPV4Address::Loopback(),
+                                      local_address.Port());
+  for (unsigned int i = 0; i < 1000; i++) {
+    client_socket.SendTo(static_cast<const uint8_t*>(test_cstring),
+                         sizeof(test_cstring), destination);
+  }
+  while (ring.Receive(&socket)) {}
+
+  // The count arrives with the first datagram queued after the drops.
+  client_socket.SendTo(static_cast<const uint8_t*>(test_cstring),
+                       sizeof(test_cstring), destination);
+  OLA_ASSERT_EQ(1u, ring.Receive(&socket));
+  OLA_ASSERT_TRUE(socket.DroppedDatagrams() > 0);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(socket.DroppedDatagrams()),
+                (*drops)["test"]);
+}
+
+
+/*
+ * Test the kernel's arrival time is attached to each datagram.
+ */
+void SocketTest::testUDPReceiveTimestamps() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+  if (!socket.EnableReceiveTimestamps()) {
+    OLA_INFO << "Receive timestamps aren't supported, skipping the test";
+    return;
+  }
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  const IPV4SocketAddress destination(IPV4Address::Loopback(),
+                                      local_address.Port());
+  ola::Clock clock;
+  TimeStamp before, after;
+  clock.CurrentTime(&before);
+  for (unsigned int i = 0; i < 2; i++) {
+    client_socket.SendTo(static_cast<const uint8_t*>(test_cstring),
+                         sizeof(test_cstring), destination);
+  }
+  clock.CurrentTime(&after);
+
+  UDPReceiveRing ring(4, sizeof(test_cstring) + 10);
+  OLA_ASSERT_EQ(2u, ring.Receive(&socket));
+  for (unsigned int i = 0; i < 2; i++) {
+    const TimeStamp &arrival = ring.Get(i).arrival;
+    OLA_ASSERT_TRUE(arrival.IsSet());
+    // The kernel's clock may have a coarser resolution.
+    OLA_ASSERT_TRUE(arrival >= before - TimeInterval(0, 1000));
+    OLA_ASSERT_TRUE(arrival <= after + TimeInterval(0, 1000));
+  }
+}
+
+
 /*
  * Receive some data and close the socket
  */
@@ -409,6 +541,26 @@ void SocketTest::UDPReceiveAndSend(UDPSocket *socket) {
 }
 
 
+/*
+ * Drain the datagrams from the socket and check each one.
+ */
+void SocketTest::UDPReceiveMany(UDPSocket *socket, UDPReceiveRing *ring) {
+  unsigned int count = ring->Receive(socket);
+  OLA_ASSERT_TRUE(count > 0);
+  OLA_ASSERT_TRUE(count <= 4);
+  for (unsigned int i = 0; i < count; i++) {
+    const UDPDatagram &datagram = ring->Get(i);
+    OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring),
+                           datagram.data, datagram.size);
+    OLA_ASSERT_EQ(IPV4Address::Loopback(), datagram.source.Host());
+  }
+  m_datagrams_received += count;
+  if (m_datagrams_received == DATAGRAM_COUNT) {
+    m_ss->Terminate();
+  }
+}
+
+
 /**
  * Generic method to test client initiated close
  */
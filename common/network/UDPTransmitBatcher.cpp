@@ -0,0 +1,234 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPTransmitBatcher.cpp
+ * Collects outgoing datagrams and sends them with a single SendMany() call.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/network/UDPTransmitBatcher.h"
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/InlineCallback.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace network {
+
+using std::string;
+
+const char UDPTransmitBatcher::BATCH_VAR[] = "udp-tx-batches";
+const char UDPTransmitBatcher::DATAGRAM_VAR[] = "udp-tx-batched-datagrams";
+const char UDPTransmitBatcher::MAX_BATCH_VAR[] = "udp-tx-max-batch";
+const char UDPTransmitBatcher::PACER_DEPTH_VAR[] = "udp-tx-pacer-queue-depth";
+const char UDPTransmitBatcher::PACER_MAX_DEPTH_VAR[] =
+    "udp-tx-pacer-max-queue-depth";
+const char UDPTransmitBatcher::SOCKET_KEY[] = "socket";
+
+UDPTransmitBatcher::UDPTransmitBatcher(
+    ola::thread::SchedulerInterface *scheduler,
+    UDPSocketInterface *socket,
+    ExportMap *export_map,
+    const string &name)
+    : m_scheduler(scheduler),
+      m_socket(socket),
+      m_export_map(export_map),
+      m_name(name),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT),
+      m_next(0),
+      m_pacing_slices(0),
+      m_slices_left(0),
+      m_batch_var(NULL),
+      m_datagram_var(NULL),
+      m_max_batch_var(NULL),
+      m_depth_var(NULL),
+      m_max_depth_var(NULL) {
+  if (export_map) {
+    m_batch_var = export_map->GetUIntMapVar(BATCH_VAR, SOCKET_KEY);
+    (*m_batch_var)[m_name] = 0;
+    m_datagram_var = export_map->GetUIntMapVar(DATAGRAM_VAR, SOCKET_KEY);
+    (*m_datagram_var)[m_name] = 0;
+    m_max_batch_var = export_map->GetUIntMapVar(MAX_BATCH_VAR, SOCKET_KEY);
+    (*m_max_batch_var)[m_name] = 0;
+  }
+}
+
+UDPTransmitBatcher::~UDPTransmitBatcher() {
+  Flush();
+}
+
+void UDPTransmitBatcher::SetPacing(const TimeInterval &window) {
+  Flush();
+  const int64_t usec = window.AsInt();
+  if (usec <= 0) {
+    m_pacing_slices = 0;
+    return;
+  }
+  m_pacing_slices = std::max(
+      static_cast<unsigned int>(usec / PACING_INTERVAL_USEC), 1u);
+
+  if (m_export_map && !m_depth_var) {
+    m_depth_var = m_export_map->GetUIntMapVar(PACER_DEPTH_VAR, SOCKET_KEY);
+    (*m_depth_var)[m_name] = 0;
+    m_max_depth_var = m_export_map->GetUIntMapVar(PACER_MAX_DEPTH_VAR,
+                                                  SOCKET_KEY);
+    (*m_max_depth_var)[m_name] = 0;
+  }
+}
+
+ssize_t UDPTransmitBatcher::SendTo(const uint8_t *data,
+                                   unsigned int size,
+                                   const IPV4SocketAddress &destination) {
+  unsigned int offset = static_cast<unsigned int>(m_buffer.size());
+  m_buffer.insert(m_buffer.end(), data, data + size);
+  Queue(offset, size, destination);
+  return size;
+}
+
+ssize_t UDPTransmitBatcher::SendTo(ola::io::IOVecInterface *data,
+                                   const IPV4SocketAddress &destination) {
+  int io_count;
+  const ola::io::IOVec *iov = data->AsIOVec(&io_count);
+  unsigned int offset = static_cast<unsigned int>(m_buffer.size());
+  for (int i = 0; i < io_count; i++) {
+    const uint8_t *base = static_cast<const uint8_t*>(iov[i].iov_base);
+    m_buffer.insert(m_buffer.end(), base, base + iov[i].iov_len);
+  }
+  ola::io::IOVecInterface::FreeIOVec(iov);
+
+  unsigned int size = static_cast<unsigned int>(m_buffer.size()) - offset;
+  data->Pop(size);
+  Queue(offset, size, destination);
+  return size;
+}
+
+void UDPTransmitBatcher::Queue(unsigned int offset, unsigned int size,
+                               const IPV4SocketAddress &destination) {
+  PendingDatagram pending = {offset, size, destination};
+  m_pending.push_back(pending);
+
+  if (!m_pacing_slices) {
+    if (m_pending.size() >= MAX_PENDING) {
+      Flush();
+    } else if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+      m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+          TimeInterval(0, 0),
+          MakeInlineCallback(this, &UDPTransmitBatcher::ScheduledFlush));
+    }
+    return;
+  }
+
+  UpdateDepth();
+  if (Pending() >= MAX_PACED_PENDING) {
+    Flush();
+  } else if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    // The timeout is always registered while there are datagrams waiting, so
+    // this starts a new window. The first slice goes at the end of this loop
+    // iteration.
+    m_slices_left = m_pacing_slices;
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        TimeInterval(0, 0),
+        MakeInlineCallback(this, &UDPTransmitBatcher::ScheduledSlice));
+  }
+}
+
+unsigned int UDPTransmitBatcher::Flush() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  return Send(Pending());
+}
+
+/*
+ * Send the next count datagrams.
+ */
+unsigned int UDPTransmitBatcher::Send(unsigned int count) {
+  if (!count) {
+    return 0;
+  }
+
+  // The buffer may have moved as it grew, so the pointers are only resolved
+  // now.
+  const uint8_t *buffer = m_buffer.empty() ? NULL : &m_buffer[0];
+  m_datagrams.resize(count);
+  for (unsigned int i = 0; i < count; i++) {
+    const PendingDatagram &pending = m_pending[m_next + i];
+    m_datagrams[i].data = buffer + pending.offset;
+    m_datagrams[i].size = pending.size;
+    m_datagrams[i].destination = pending.destination;
+  }
+
+  unsigned int sent = m_socket->SendMany(&m_datagrams[0], count);
+  if (sent != count) {
+    OLA_INFO << "Only sent " << sent << " of " << count << " datagrams";
+  }
+
+  if (m_batch_var) {
+    (*m_batch_var)[m_name]++;
+    (*m_datagram_var)[m_name] += count;
+    unsigned int &max_batch = (*m_max_batch_var)[m_name];
+    max_batch = std::max(max_batch, count);
+  }
+
+  m_next += count;
+  if (m_next == m_pending.size()) {
+    // clear() keeps the capacity, so there's no allocation once we've
+    // reached a steady state.
+    m_pending.clear();
+    m_buffer.clear();
+    m_next = 0;
+  }
+  UpdateDepth();
+  return sent;
+}
+
+void UDPTransmitBatcher::UpdateDepth() {
+  if (!m_depth_var) {
+    return;
+  }
+  const unsigned int depth = Pending();
+  (*m_depth_var)[m_name] = depth;
+  unsigned int &max_depth = (*m_max_depth_var)[m_name];
+  max_depth = std::max(max_depth, depth);
+}
+
+void UDPTransmitBatcher::ScheduledFlush() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  Flush();
+}
+
+/*
+ * Send an even share of what's waiting across the slices left in the window,
+ * the last slice sends everything.
+ */
+void UDPTransmitBatcher::ScheduledSlice() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  const unsigned int slices = std::max(m_slices_left, 1u);
+  Send((Pending() + slices - 1) / slices);
+  m_slices_left = slices - 1;
+
+  if (Pending()) {
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        TimeInterval(static_cast<int64_t>(PACING_INTERVAL_USEC)),
+        MakeInlineCallback(this, &UDPTransmitBatcher::ScheduledSlice));
+  }
+}
+}  // namespace network
+}  // namespace ola
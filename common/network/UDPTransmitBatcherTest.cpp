@@ -0,0 +1,278 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPTransmitBatcherTest.cpp
+ * Test fixture for the UDPTransmitBatcher class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPTransmitBatcher.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::MockClock;
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPDatagram;
+using ola::network::UDPOutgoingDatagram;
+using ola::network::UDPReceiveRing;
+using ola::network::UDPSocket;
+using ola::network::UDPTransmitBatcher;
+using ola::testing::MockUDPSocket;
+using ola::testing::SocketVerifier;
+
+class UDPTransmitBatcherTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UDPTransmitBatcherTest);
+  CPPUNIT_TEST(testBatching);
+  CPPUNIT_TEST(testFlushOnDestruction);
+  CPPUNIT_TEST(testPacing);
+  CPPUNIT_TEST(testSendMany);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  UDPTransmitBatcherTest()
+      : m_ss(&m_export_map),
+        m_packets_received(0) {
+  }
+
+  void setUp();
+  void testBatching();
+  void testFlushOnDestruction();
+  void testPacing();
+  void testSendMany();
+
+ private:
+  ExportMap m_export_map;
+  SelectServer m_ss;
+  MockUDPSocket m_socket;
+  IPV4Address m_target;
+  unsigned int m_packets_received;
+
+  void Terminate() { m_ss.Terminate(); }
+  void ReceiveDatagrams(UDPSocket *socket, UDPReceiveRing *ring);
+
+  static const uint8_t DATA1[];
+  static const uint8_t DATA2[];
+  static const uint16_t PORT = 6454;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UDPTransmitBatcherTest);
+
+const uint8_t UDPTransmitBatcherTest::DATA1[] = {1, 2, 3, 4};
+const uint8_t UDPTransmitBatcherTest::DATA2[] = {5, 6};
+
+void UDPTransmitBatcherTest::setUp() {
+  OLA_ASSERT_TRUE(IPV4Address::FromString("10.0.0.10", &m_target));
+  OLA_ASSERT_TRUE(m_socket.Init());
+}
+
+
+/*
+ * Check that datagrams are held until the end of the loop iteration.
+ */
+void UDPTransmitBatcherTest::testBatching() {
+  UDPTransmitBatcher batcher(&m_ss, &m_socket, &m_export_map, "test");
+  IPV4SocketAddress destination(m_target, PORT);
+
+  {
+    SocketVerifier verifier(&m_socket);
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(DATA1)),
+                  batcher.SendTo(DATA1, sizeof(DATA1), destination));
+    OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(DATA2)),
+                  batcher.SendTo(DATA2, sizeof(DATA2), destination));
+    OLA_ASSERT_EQ(2u, batcher.Pending());
+  }
+
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  m_socket.AddExpectedData(DATA2, sizeof(DATA2), m_target, PORT);
+  m_ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(0u, batcher.Pending());
+
+  // and a second batch
+  m_socket.AddExpectedData(DATA2, sizeof(DATA2), m_target, PORT);
+  batcher.SendTo(DATA2, sizeof(DATA2), destination);
+  OLA_ASSERT_EQ(1u, batcher.Flush());
+  m_socket.Verify();
+
+  OLA_ASSERT_EQ(
+      2u,
+      (*m_export_map.GetUIntMapVar(UDPTransmitBatcher::BATCH_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      3u,
+      (*m_export_map.GetUIntMapVar(
+          UDPTransmitBatcher::DATAGRAM_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      2u,
+      (*m_export_map.GetUIntMapVar(
+          UDPTransmitBatcher::MAX_BATCH_VAR))["test"]);
+}
+
+
+/*
+ * Check that pending datagrams are sent when the batcher is destroyed.
+ */
+void UDPTransmitBatcherTest::testFlushOnDestruction() {
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  {
+    UDPTransmitBatcher batcher(&m_ss, &m_socket);
+    batcher.SendTo(DATA1, sizeof(DATA1), IPV4SocketAddress(m_target, PORT));
+  }
+  m_socket.Verify();
+
+  // The flush timeout should have been cancelled.
+  m_ss.RunOnce(ola::TimeInterval(0, 0));
+}
+
+
+/*
+ * Check that pacing spreads the datagrams across the window.
+ */
+void UDPTransmitBatcherTest::testPacing() {
+  MockClock clock;
+  SelectServer ss(&m_export_map, &clock);
+  UDPTransmitBatcher batcher(&ss, &m_socket, &m_export_map, "paced");
+  batcher.SetPacing(ola::TimeInterval(0, 3000));
+  IPV4SocketAddress destination(m_target, PORT);
+
+  {
+    SocketVerifier verifier(&m_socket);
+    for (unsigned int i = 0; i < 5; i++) {
+      batcher.SendTo(DATA1, sizeof(DATA1), destination);
+    }
+    OLA_ASSERT_EQ(5u, batcher.Pending());
+  }
+
+  // Three slices, the first goes at the end of the loop iteration.
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(3u, batcher.Pending());
+
+  // Nothing more is sent until the next slice is due.
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(3u, batcher.Pending());
+
+  // A datagram queued during the window joins the remaining slices.
+  batcher.SendTo(DATA2, sizeof(DATA2), destination);
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  clock.AdvanceTime(0, 1000);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(2u, batcher.Pending());
+
+  // The last slice sends everything that's left.
+  m_socket.AddExpectedData(DATA1, sizeof(DATA1), m_target, PORT);
+  m_socket.AddExpectedData(DATA2, sizeof(DATA2), m_target, PORT);
+  clock.AdvanceTime(0, 1000);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(0u, batcher.Pending());
+
+  OLA_ASSERT_EQ(
+      3u,
+      (*m_export_map.GetUIntMapVar(UDPTransmitBatcher::BATCH_VAR))["paced"]);
+  OLA_ASSERT_EQ(
+      0u,
+      (*m_export_map.GetUIntMapVar(
+          UDPTransmitBatcher::PACER_DEPTH_VAR))["paced"]);
+  OLA_ASSERT_EQ(
+      5u,
+      (*m_export_map.GetUIntMapVar(
+          UDPTransmitBatcher::PACER_MAX_DEPTH_VAR))["paced"]);
+
+  // A new window starts with the next datagram.
+  m_socket.AddExpectedData(DATA2, sizeof(DATA2), m_target, PORT);
+  batcher.SendTo(DATA2, sizeof(DATA2), destination);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket.Verify();
+  OLA_ASSERT_EQ(0u, batcher.Pending());
+}
+
+
+/*
+ * Check SendMany() on a real socket keeps the datagram boundaries, including
+ * those which are candidates for segmentation offload.
+ */
+void UDPTransmitBatcherTest::testSendMany() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+  IPV4SocketAddress destination(IPV4Address::Loopback(),
+                                local_address.Port());
+
+  UDPReceiveRing ring(8, 16);
+  socket.SetOnData(ola::NewCallback(
+      this, &UDPTransmitBatcherTest::ReceiveDatagrams, &socket, &ring));
+  OLA_ASSERT_TRUE(m_ss.AddReadDescriptor(&socket));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  // Three of the same size followed by a short one, all to the same
+  // destination.
+  UDPOutgoingDatagram datagrams[] = {
+    {DATA1, sizeof(DATA1), destination},
+    {DATA1, sizeof(DATA1), destination},
+    {DATA1, sizeof(DATA1), destination},
+    {DATA2, sizeof(DATA2), destination},
+    {DATA1, sizeof(DATA1), destination},
+  };
+  OLA_ASSERT_EQ(5u, client_socket.SendMany(datagrams, 5));
+
+  m_ss.RegisterSingleTimeout(
+      1000, ola::NewSingleCallback(this, &UDPTransmitBatcherTest::Terminate));
+  m_ss.Run();
+  m_ss.RemoveReadDescriptor(&socket);
+  OLA_ASSERT_EQ(5u, m_packets_received);
+}
+
+
+void UDPTransmitBatcherTest::ReceiveDatagrams(UDPSocket *socket,
+                                              UDPReceiveRing *ring) {
+  unsigned int count = ring->Receive(socket);
+  for (unsigned int i = 0; i < count; i++) {
+    const UDPDatagram &datagram = ring->Get(i);
+    if (m_packets_received == 3) {
+      OLA_ASSERT_DATA_EQUALS(DATA2, sizeof(DATA2), datagram.data,
+                             datagram.size);
+    } else {
+      OLA_ASSERT_DATA_EQUALS(DATA1, sizeof(DATA1), datagram.data,
+                             datagram.size);
+    }
+    m_packets_received++;
+  }
+  if (m_packets_received == 5) {
+    m_ss.Terminate();
+  }
+}
@@ -31,7 +31,6 @@
 namespace ola {
 namespace rdm {
 
-using ola::messaging::Descriptor;
 using ola::messaging::Message;
 using ola::network::NetworkToHost;
 using std::auto_ptr;
@@ -394,18 +393,18 @@ void CommandPrinter::DisplayParamData(
 
   *m_output << "  Param data:" << endl;
   if (unpack_param_data && pid_descriptor) {
-    const Descriptor *descriptor = NULL;
+    const MessagePlan *plan = NULL;
     if (is_request) {
-      descriptor = (is_get ?
-          pid_descriptor->GetRequest() : pid_descriptor->SetRequest());
+      plan = (is_get ?
+          pid_descriptor->GetRequestPlan() : pid_descriptor->SetRequestPlan());
     } else {
-      descriptor = (is_get ?
-         pid_descriptor->GetResponse() : pid_descriptor->SetResponse());
+      plan = (is_get ?
+         pid_descriptor->GetResponsePlan() : pid_descriptor->SetResponsePlan());
     }
 
-    if (descriptor) {
+    if (plan) {
       auto_ptr<const Message> message(
-        m_pid_helper->DeserializeMessage(descriptor, param_data, data_length));
+        m_pid_helper->DeserializeMessage(plan, param_data, data_length));
 
       if (message.get()) {
         *m_output << m_pid_helper->MessageToString(message.get());
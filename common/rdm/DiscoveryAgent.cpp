@@ -77,6 +77,14 @@ void DiscoveryAgent::StartIncrementalDiscovery(
   InitDiscovery(on_complete, true);
 }
 
+void DiscoveryAgent::SetKnownUIDs(const UIDSet &uids) {
+  if (m_on_complete) {
+    OLA_WARN << "Discovery procedure running, not setting known UIDs";
+    return;
+  }
+  m_uids = uids;
+}
+
 /*
  * Start the discovery process
  * @param on_complete the callback to run when discovery completes
@@ -174,37 +182,64 @@ void DiscoveryAgent::IncrementalMuteComplete(bool status) {
  * Send a Discovery Unique Branch request.
  */
 void DiscoveryAgent::SendDiscovery() {
-  if (m_uid_ranges.empty()) {
-    // we're hit the end of the stack, now we're done
-    if (m_on_complete) {
-      m_on_complete->Run(!m_tree_corrupt, m_uids);
-      m_on_complete = NULL;
-    } else {
-      OLA_WARN << "Discovery complete but no callback";
+  while (!m_uid_ranges.empty()) {
+    UIDRange *range = m_uid_ranges.top();
+    if (range->split && range->parent && !range->branch_corrupt &&
+        range->uids_discovered >= 2) {
+      // The two halves cover this range and each of them ended with a
+      // timeout, so a DUB here would time out too. We found enough
+      // responders to explain the collision; if we hadn't, the DUB is needed
+      // to catch responders with broken range handling. Responders that only
+      // appear once another is muted (proxies) are picked up when the root
+      // range is DUBed again.
+      FreeCurrentRange();
+      continue;
+    }
+
+    if (range->uids_discovered == 0) {
+      range->attempt++;
+    }
+
+    if (range->failures == MAX_BRANCH_FAILURES ||
+        range->attempt == MAX_EMPTY_BRANCH_ATTEMPTS ||
+        range->branch_corrupt) {
+      // limit reached, move on to the next branch
+      OLA_DEBUG << "Hit failure limit for (" << range->lower << ", "
+                << range->upper << ")";
+      if (range->parent)
+        range->parent->branch_corrupt = true;
+      FreeCurrentRange();
+      continue;
+    }
+
+    const UIDRange *parent = range->parent;
+    if (range->attempt == 1 && !range->split && parent &&
+        parent->empty_children &&
+        range->lower != range->upper &&
+        range->inferred_splits < MAX_INFERRED_SPLITS) {
+      // The parent collided and the other half was empty, so this half
+      // would collide as well. Skip the DUB and split it straight away.
+      OLA_DEBUG << "Inferred collision for " << range->lower << " - "
+                << range->upper;
+      SplitRange(range, true);
+      continue;
     }
-    return;
-  }
-  UIDRange *range = m_uid_ranges.top();
-  if (range->uids_discovered == 0) {
-    range->attempt++;
-  }
 
-  if (range->failures == MAX_BRANCH_FAILURES ||
-      range->attempt == MAX_EMPTY_BRANCH_ATTEMPTS ||
-      range->branch_corrupt) {
-    // limit reached, move on to the next branch
-    OLA_DEBUG << "Hit failure limit for (" << range->lower << ", "
-              << range->upper << ")";
-    if (range->parent)
-      range->parent->branch_corrupt = true;
-    FreeCurrentRange();
-    SendDiscovery();
-  } else {
     OLA_DEBUG << "DUB " << range->lower << " - " << range->upper
               << ", attempt " << range->attempt << ", uids found: "
               << range->uids_discovered << ", failures " << range->failures
               << ", corrupted " << range->branch_corrupt;
     m_target->Branch(range->lower, range->upper, m_branch_callback.get());
+    return;
+  }
+
+  // we're hit the end of the stack, now we're done
+  if (m_on_complete) {
+    DiscoveryCompleteCallback *on_complete = m_on_complete;
+    m_on_complete = NULL;
+    on_complete->Run(!m_tree_corrupt, m_uids);
+  } else {
+    OLA_WARN << "Discovery complete but no callback";
   }
 }
 
@@ -218,6 +253,11 @@ void DiscoveryAgent::BranchComplete(const uint8_t *data, unsigned int length) {
   if (length == 0) {
     // timeout
     if (!m_uid_ranges.empty()) {
+      UIDRange *range = m_uid_ranges.top();
+      if (range->parent && !range->split && !range->uids_discovered &&
+          !range->failures) {
+        range->parent->empty_children++;
+      }
       FreeCurrentRange();
     }
     SendDiscovery();
@@ -362,6 +402,19 @@ void DiscoveryAgent::HandleCollision() {
     return;
   }
 
+  SplitRange(range, false);
+  SendDiscovery();
+}
+
+/*
+ * Split a range in two and push the halves on to the stack.
+ * @param range the range to split, this must be the top of the stack.
+ * @param inferred true if the range is being split without sending a DUB.
+ */
+void DiscoveryAgent::SplitRange(UIDRange *range, bool inferred) {
+  UID lower_uid = range->lower;
+  UID upper_uid = range->upper;
+
   // work out the mid point
   uint64_t lower = ((static_cast<uint64_t>(lower_uid.ManufacturerId()) << 32) +
                     lower_uid.DeviceId());
@@ -375,10 +428,17 @@ void DiscoveryAgent::HandleCollision() {
            << " , " << mid_plus_one_uid << " - " << upper_uid;
 
   range->uids_discovered = 0;
-  // add both ranges to the stack
-  m_uid_ranges.push(new UIDRange(lower_uid, mid_uid, range));
-  m_uid_ranges.push(new UIDRange(mid_plus_one_uid, upper_uid, range));
-  SendDiscovery();
+  range->split = true;
+  range->empty_children = 0;
+  const unsigned int inferred_splits = (
+      inferred ? range->inferred_splits + 1 : 0);
+
+  UIDRange *lower_range = new UIDRange(lower_uid, mid_uid, range);
+  UIDRange *upper_range = new UIDRange(mid_plus_one_uid, upper_uid, range);
+  lower_range->inferred_splits = inferred_splits;
+  upper_range->inferred_splits = inferred_splits;
+  m_uid_ranges.push(lower_range);
+  m_uid_ranges.push(upper_range);
 }
 
 /*
@@ -0,0 +1,167 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DiscoveryAgentBenchmark.cpp
+ * Count the transactions the DiscoveryAgent needs for a simulated line.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdlib.h>
+#include <iomanip>
+#include <iostream>
+
+#include "common/rdm/DiscoveryAgentTestHelper.h"
+#include "ola/Callback.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+
+using ola::rdm::DiscoveryAgent;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::cout;
+using std::endl;
+
+DEFINE_s_uint32(responders, r, 400, "The number of responders on the line");
+DEFINE_s_uint32(manufacturers, m, 4, "The number of manufacturer ids the "
+                "responders are spread across");
+DEFINE_uint32(new_responders, 10, "The number of responders added before "
+              "the incremental discovery");
+DEFINE_uint32(seed, 1, "The random seed");
+
+namespace {
+
+// Rough line times for each transaction, in microseconds. A DUB that nobody
+// answers has to wait out the full response window.
+const unsigned int DUB_RESPONSE_US = 3000;
+const unsigned int DUB_TIMEOUT_US = 7000;
+const unsigned int MUTE_US = 3000;
+const unsigned int UNMUTE_US = 1500;
+
+/*
+ * A MockDiscoveryTarget that counts the transactions.
+ */
+class CountingTarget: public MockDiscoveryTarget {
+ public:
+  explicit CountingTarget(const ResponderList &responders)
+      : MockDiscoveryTarget(responders) {
+    Reset();
+  }
+
+  void Reset() {
+    dubs = timeouts = mutes = unmutes = 0;
+    m_branch_callback = NULL;
+  }
+
+  void MuteDevice(const UID &target, MuteDeviceCallback *mute_complete) {
+    mutes++;
+    MockDiscoveryTarget::MuteDevice(target, mute_complete);
+  }
+
+  void UnMuteAll(UnMuteDeviceCallback *unmute_complete) {
+    unmutes++;
+    MockDiscoveryTarget::UnMuteAll(unmute_complete);
+  }
+
+  void Branch(const UID &lower, const UID &upper, BranchCallback *callback) {
+    dubs++;
+    m_branch_callback = callback;
+    MockDiscoveryTarget::Branch(
+        lower, upper, ola::NewSingleCallback(this, &CountingTarget::Branched));
+  }
+
+  unsigned int dubs;
+  unsigned int timeouts;
+  unsigned int mutes;
+  unsigned int unmutes;
+
+ private:
+  BranchCallback *m_branch_callback;
+
+  void Branched(const uint8_t *data, unsigned int length) {
+    if (!length) {
+      timeouts++;
+    }
+    m_branch_callback->Run(data, length);
+  }
+};
+
+UID RandomUID() {
+  const uint16_t manufacturer_id = 0x4000 + random() % FLAGS_manufacturers;
+  return UID(manufacturer_id, random());
+}
+
+void DiscoveryComplete(unsigned int expected, bool ok, const UIDSet &uids) {
+  if (!ok || uids.Size() != expected) {
+    cout << "Discovery failed, found " << uids.Size() << " of " << expected
+         << " responders" << endl;
+  }
+}
+
+void Report(const char *name, const CountingTarget &target) {
+  const uint64_t line_time =
+      static_cast<uint64_t>(target.dubs - target.timeouts) * DUB_RESPONSE_US +
+      static_cast<uint64_t>(target.timeouts) * DUB_TIMEOUT_US +
+      static_cast<uint64_t>(target.mutes) * MUTE_US +
+      static_cast<uint64_t>(target.unmutes) * UNMUTE_US;
+  cout << std::left << std::setw(12) << name << std::right
+       << std::setw(7) << target.dubs << " DUBs ("
+       << target.timeouts << " timeouts), "
+       << target.mutes << " mutes, ~" << std::fixed << std::setprecision(2)
+       << line_time / 1000000.0 << "s on the line" << endl;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Simulate RDM discovery and count the transactions.");
+  srandom(FLAGS_seed);
+  if (!FLAGS_manufacturers) {
+    FLAGS_manufacturers = 1;
+  }
+
+  UIDSet uids;
+  while (uids.Size() < FLAGS_responders) {
+    uids.AddUID(RandomUID());
+  }
+
+  ResponderList responders;
+  for (UIDSet::Iterator iter = uids.Begin(); iter != uids.End(); ++iter) {
+    responders.push_back(new MockResponder(*iter));
+  }
+  CountingTarget target(responders);
+  DiscoveryAgent agent(&target);
+
+  cout << uids.Size() << " responders across " << FLAGS_manufacturers
+       << " manufacturers" << endl;
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(DiscoveryComplete, uids.Size()));
+  Report("full", target);
+
+  while (uids.Size() < FLAGS_responders + FLAGS_new_responders) {
+    UID uid = RandomUID();
+    if (!uids.Contains(uid)) {
+      uids.AddUID(uid);
+      target.AddResponder(new MockResponder(uid));
+    }
+  }
+  target.Reset();
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(DiscoveryComplete, uids.Size()));
+  Report("incremental", target);
+  return 0;
+}
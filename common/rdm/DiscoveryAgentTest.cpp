@@ -44,6 +44,8 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testSingleResponder);
   CPPUNIT_TEST(testResponderWithBroadcastUID);
   CPPUNIT_TEST(testMultipleResponders);
+  CPPUNIT_TEST(testManyResponders);
+  CPPUNIT_TEST(testKnownUIDs);
   CPPUNIT_TEST(testObnoxiousResponder);
   CPPUNIT_TEST(testRamblingResponder);
   CPPUNIT_TEST(testBipolarResponder);
@@ -62,6 +64,8 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
     void testSingleResponder();
     void testResponderWithBroadcastUID();
     void testMultipleResponders();
+    void testManyResponders();
+    void testKnownUIDs();
     void testObnoxiousResponder();
     void testRamblingResponder();
     void testBriefResponder();
@@ -248,6 +252,76 @@ void DiscoveryAgentTest::testMultipleResponders() {
 }
 
 
+/**
+ * Test a large number of responders, both clustered and spread out.
+ */
+void DiscoveryAgentTest::testManyResponders() {
+  UIDSet uids;
+  ResponderList responders;
+  for (unsigned int i = 0; i < 64; i++) {
+    uids.AddUID(UID(0x7a70, 0x00002000 + i));
+    uids.AddUID(UID(0x7a71, 0x01000000 * i + 0x1234));
+  }
+  uids.AddUID(UID(0x0001, 0x00000001));
+  uids.AddUID(UID(0xfff0, 0xfffffffe));
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+
+  DiscoveryAgent agent(&target);
+  OLA_INFO << "starting discovery with " << uids.Size() << " responders";
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  m_callback_run = false;
+
+  // now try incremental, adding some uids and removing others
+  for (unsigned int i = 0; i < 8; i++) {
+    UID uid_to_remove(0x7a70, 0x00002000 + i * 8);
+    uids.RemoveUID(uid_to_remove);
+    target.RemoveResponder(uid_to_remove);
+    UID uid_to_add(0x7a70, 0x00003000 + i);
+    uids.AddUID(uid_to_add);
+    target.AddResponder(new MockResponder(uid_to_add));
+  }
+
+  OLA_INFO << "starting incremental discovery with modified responder list";
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+}
+
+/**
+ * Test incremental discovery starting from a set of known UIDs.
+ */
+void DiscoveryAgentTest::testKnownUIDs() {
+  UIDSet uids;
+  ResponderList responders;
+  uids.AddUID(UID(0x7a70, 0x00002001));
+  uids.AddUID(UID(0x7a70, 0x00002002));
+  uids.AddUID(UID(0x8080, 0x00103456));
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+
+  // one of the known UIDs has gone, and one responder is new
+  UIDSet known_uids;
+  known_uids.AddUID(UID(0x7a70, 0x00002001));
+  known_uids.AddUID(UID(0x7a70, 0x00002002));
+  known_uids.AddUID(UID(0x7a77, 0x00002002));
+
+  DiscoveryAgent agent(&target);
+  agent.SetKnownUIDs(known_uids);
+  OLA_INFO << "starting incremental discovery with known UIDs";
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+}
+
 /**
  * Test a responder that continues to responder when muted.
  */
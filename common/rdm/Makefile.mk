@@ -21,6 +21,7 @@ common_libolacommon_la_SOURCES += \
     common/rdm/GroupSizeCalculator.cpp \
     common/rdm/GroupSizeCalculator.h \
     common/rdm/MessageDeserializer.cpp \
+    common/rdm/MessagePlan.cpp \
     common/rdm/MessageSerializer.cpp \
     common/rdm/MovingLightResponder.cpp \
     common/rdm/NetworkManager.cpp \
@@ -36,8 +37,11 @@ common_libolacommon_la_SOURCES += \
     common/rdm/RDMCommand.cpp \
     common/rdm/RDMCommandSerializer.cpp \
     common/rdm/RDMFrame.cpp \
+    common/rdm/RDMFrameView.cpp \
+    common/rdm/RDMParameterSweeper.cpp \
     common/rdm/RDMHelper.cpp \
     common/rdm/RDMReply.cpp \
+    common/rdm/RDMTimingStats.cpp \
     common/rdm/ResponderHelper.cpp \
     common/rdm/ResponderLoadSensor.cpp \
     common/rdm/ResponderPersonality.cpp \
@@ -58,6 +62,20 @@ EXTRA_DIST += common/rdm/Pids.proto
 common/rdm/Pids.pb.cc common/rdm/Pids.pb.h: common/rdm/Makefile.mk common/rdm/Pids.proto
 	$(PROTOC) --cpp_out common/rdm --proto_path $(srcdir)/common/rdm $(srcdir)/common/rdm/Pids.proto
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/rdm/discovery_benchmark
+
+common_rdm_discovery_benchmark_SOURCES = common/rdm/DiscoveryAgentBenchmark.cpp
+common_rdm_discovery_benchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_rdm_discovery_benchmark_LDADD = common/libolacommon.la \
+                                       $(CPPUNIT_LIBS)
+
+noinst_PROGRAMS += common/rdm/pid_store_compiler
+
+common_rdm_pid_store_compiler_SOURCES = common/rdm/PidStoreCompiler.cpp
+common_rdm_pid_store_compiler_LDADD = common/libolacommon.la
+
 # TESTS_DATA
 ##################################################
 
@@ -98,7 +116,9 @@ common_rdm_PidStoreTester_SOURCES = \
 common_rdm_PidStoreTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_PidStoreTester_LDADD = $(COMMON_TESTING_LIBS)
 
-common_rdm_RDMHelperTester_SOURCES = common/rdm/RDMHelperTest.cpp
+common_rdm_RDMHelperTester_SOURCES = \
+    common/rdm/RDMHelperTest.cpp \
+    common/rdm/ResponderOpsTest.cpp
 common_rdm_RDMHelperTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMHelperTester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -106,6 +126,7 @@ common_rdm_RDMMessageTester_SOURCES = \
     common/rdm/GroupSizeCalculatorTest.cpp \
     common/rdm/MessageSerializerTest.cpp \
     common/rdm/MessageDeserializerTest.cpp \
+    common/rdm/MessagePlanTest.cpp \
     common/rdm/RDMMessageInterationTest.cpp \
     common/rdm/StringMessageBuilderTest.cpp \
     common/rdm/VariableFieldSizeCalculatorTest.cpp
@@ -113,7 +134,8 @@ common_rdm_RDMMessageTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMMessageTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_rdm_RDMAPITester_SOURCES = \
-    common/rdm/RDMAPITest.cpp
+    common/rdm/RDMAPITest.cpp \
+    common/rdm/RDMParameterSweeperTest.cpp
 common_rdm_RDMAPITester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMAPITester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -125,6 +147,7 @@ common_rdm_RDMCommandTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_rdm_RDMFrameTester_SOURCES = \
     common/rdm/RDMFrameTest.cpp \
+    common/rdm/RDMFrameViewTest.cpp \
     common/rdm/TestHelper.h
 common_rdm_RDMFrameTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMFrameTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -143,6 +166,7 @@ common_rdm_RDMCommandSerializerTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_rdm_QueueingRDMControllerTester_SOURCES = \
     common/rdm/QueueingRDMControllerTest.cpp \
+    common/rdm/RDMTimingStatsTest.cpp \
     common/rdm/TestHelper.h
 common_rdm_QueueingRDMControllerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_QueueingRDMControllerTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -22,11 +22,11 @@
 #include <ola/messaging/Message.h>
 #include <ola/network/NetworkUtils.h>
 #include <ola/rdm/MessageDeserializer.h>
+#include <ola/rdm/MessagePlan.h>
 #include <ola/rdm/UID.h>
 #include <string.h>
 #include <string>
 #include <vector>
-#include "common/rdm/VariableFieldSizeCalculator.h"
 
 namespace ola {
 namespace rdm {
@@ -56,6 +56,18 @@ const ola::messaging::Message *MessageDeserializer::InflateMessage(
     const ola::messaging::Descriptor *descriptor,
     const uint8_t *data,
     unsigned int length) {
+  const MessagePlan plan(descriptor);
+  return InflateMessage(&plan, data, length);
+}
+
+
+/**
+ * @brief Deserialize a memory location using a precompiled plan.
+ */
+const ola::messaging::Message *MessageDeserializer::InflateMessage(
+    const MessagePlan *plan,
+    const uint8_t *data,
+    unsigned int length) {
 
   if (!data && length) {
     return NULL;
@@ -68,34 +80,16 @@ const ola::messaging::Message *MessageDeserializer::InflateMessage(
 
   CleanUpVector();
 
-  VariableFieldSizeCalculator calculator;
-  VariableFieldSizeCalculator::calculator_state state =
-    calculator.CalculateFieldSize(
-        length,
-        descriptor,
-        &m_variable_field_size);
-
-  switch (state) {
-      case VariableFieldSizeCalculator::TOO_SMALL:
-      case VariableFieldSizeCalculator::TOO_LARGE:
-        return NULL;
-      case VariableFieldSizeCalculator::FIXED_SIZE:
-      case VariableFieldSizeCalculator::VARIABLE_STRING:
-      case VariableFieldSizeCalculator::VARIABLE_GROUP:
-        break;
-      case VariableFieldSizeCalculator::MULTIPLE_VARIABLE_FIELDS:
-      case VariableFieldSizeCalculator::NESTED_VARIABLE_GROUPS:
-      case VariableFieldSizeCalculator::MISMATCHED_SIZE:
-        return NULL;
+  if (!plan->CheckLength(length, &m_variable_field_size)) {
+    return NULL;
   }
 
   message_vector root_messages;
   m_message_stack.push(root_messages);
 
-  descriptor->Accept(this);
+  plan->GetDescriptor()->Accept(this);
 
-  // this should never trigger because we check the length in the
-  // VariableFieldSizeCalculator
+  // this should never trigger because the plan checks the length
   if (m_insufficient_data) {
     return NULL;
   }
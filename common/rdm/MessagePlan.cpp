@@ -0,0 +1,343 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MessagePlan.cpp
+ * A flat layout of the fields in a message descriptor.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/StringUtils.h>
+#include <ola/messaging/Descriptor.h>
+#include <ola/messaging/DescriptorVisitor.h>
+#include <ola/network/NetworkUtils.h>
+#include <ola/rdm/MessagePlan.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+using ola::messaging::FieldDescriptor;
+using ola::messaging::FieldDescriptorGroup;
+using ola::messaging::IntegerFieldDescriptor;
+using ola::messaging::StringFieldDescriptor;
+using std::string;
+
+/**
+ * Walks a descriptor and fills in a MessagePlan.
+ */
+class PlanBuilder: public ola::messaging::FieldDescriptorVisitor {
+ public:
+  explicit PlanBuilder(MessagePlan *plan)
+      : m_plan(plan),
+        m_offset(0) {
+  }
+
+  // Fixed size groups are unrolled in Visit().
+  bool Descend() const { return false; }
+
+  void Visit(const ola::messaging::BoolFieldDescriptor *descriptor) {
+    AddField(descriptor, MessagePlan::BOOL_FIELD, false);
+  }
+
+  void Visit(const ola::messaging::IPV4FieldDescriptor *descriptor) {
+    AddField(descriptor, MessagePlan::IPV4_FIELD, false);
+  }
+
+  void Visit(const ola::messaging::MACFieldDescriptor *descriptor) {
+    AddField(descriptor, MessagePlan::MAC_FIELD, false);
+  }
+
+  void Visit(const ola::messaging::UIDFieldDescriptor *descriptor) {
+    AddField(descriptor, MessagePlan::UID_FIELD, false);
+  }
+
+  void Visit(const StringFieldDescriptor *descriptor) {
+    if (descriptor->FixedSize()) {
+      AddField(descriptor, MessagePlan::STRING_FIELD, false);
+    } else {
+      m_plan->m_variable_field_count++;
+      m_plan->m_variable_string = descriptor;
+    }
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint8_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::UINT8_FIELD);
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint16_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::UINT16_FIELD);
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint32_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::UINT32_FIELD);
+  }
+
+  void Visit(const IntegerFieldDescriptor<int8_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::INT8_FIELD);
+  }
+
+  void Visit(const IntegerFieldDescriptor<int16_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::INT16_FIELD);
+  }
+
+  void Visit(const IntegerFieldDescriptor<int32_t> *descriptor) {
+    AddInt(descriptor, MessagePlan::INT32_FIELD);
+  }
+
+  void Visit(const FieldDescriptorGroup *descriptor) {
+    if (!descriptor->FixedSize()) {
+      m_plan->m_variable_field_count++;
+      m_plan->m_variable_group = descriptor;
+      return;
+    }
+
+    for (unsigned int i = 0; i < descriptor->MinBlocks(); i++) {
+      for (unsigned int j = 0; j < descriptor->FieldCount(); j++) {
+        descriptor->GetField(j)->Accept(this);
+      }
+    }
+  }
+
+  void PostVisit(const FieldDescriptorGroup*) {}
+
+ private:
+  MessagePlan *m_plan;
+  unsigned int m_offset;
+
+  template <typename int_type>
+  void AddInt(const IntegerFieldDescriptor<int_type> *descriptor,
+              MessagePlan::FieldType type) {
+    AddField(descriptor, type, descriptor->IsLittleEndian());
+  }
+
+  void AddField(const FieldDescriptor *descriptor,
+                MessagePlan::FieldType type,
+                bool little_endian) {
+    MessagePlan::Field field;
+    field.descriptor = descriptor;
+    field.type = type;
+    field.offset = m_offset;
+    field.size = descriptor->MaxSize();
+    field.little_endian = little_endian;
+    m_plan->m_fields.push_back(field);
+    m_plan->m_fixed_size += field.size;
+    m_offset += field.size;
+  }
+};
+
+
+MessagePlan::MessagePlan(const ola::messaging::Descriptor *descriptor)
+    : m_descriptor(descriptor),
+      m_fixed_size(0),
+      m_variable_field_count(0),
+      m_variable_string(NULL),
+      m_variable_group(NULL) {
+  PlanBuilder builder(this);
+  for (unsigned int i = 0; i < descriptor->FieldCount(); ++i) {
+    descriptor->GetField(i)->Accept(&builder);
+  }
+
+  // The offsets after a variable sized field depend on the message.
+  if (m_variable_field_count) {
+    m_fields.clear();
+  }
+}
+
+
+/*
+ * This matches the checks in the VariableFieldSizeCalculator.
+ */
+bool MessagePlan::CheckLength(unsigned int length,
+                              unsigned int *variable_field_size) const {
+  if (length < m_fixed_size || m_variable_field_count > 1) {
+    return false;
+  }
+
+  if (!m_variable_field_count) {
+    return length == m_fixed_size;
+  }
+
+  const unsigned int bytes_remaining = length - m_fixed_size;
+  if (m_variable_string) {
+    if (bytes_remaining < m_variable_string->MinSize() ||
+        bytes_remaining > m_variable_string->MaxSize()) {
+      return false;
+    }
+    *variable_field_size = bytes_remaining;
+    return true;
+  }
+
+  if (!m_variable_group->FixedBlockSize()) {
+    return false;
+  }
+  const unsigned int block_size = m_variable_group->BlockSize();
+  if (m_variable_group->LimitedSize() &&
+      bytes_remaining > block_size * m_variable_group->MaxBlocks()) {
+    return false;
+  }
+  if (bytes_remaining % block_size) {
+    return false;
+  }
+
+  const unsigned int block_count = bytes_remaining / block_size;
+  if (block_count < m_variable_group->MinBlocks()) {
+    return false;
+  }
+  if (m_variable_group->MaxBlocks() != FieldDescriptorGroup::UNLIMITED_BLOCKS &&
+      block_count > static_cast<unsigned int>(m_variable_group->MaxBlocks())) {
+    return false;
+  }
+  *variable_field_size = block_count;
+  return true;
+}
+
+
+MessageView::MessageView(const MessagePlan *plan,
+                         const uint8_t *data,
+                         unsigned int length)
+    : m_plan(plan),
+      m_data(data),
+      m_valid(plan->IsFixedSize() && length == plan->FixedSize() &&
+              (data || !length)) {
+}
+
+
+unsigned int MessageView::FieldCount() const {
+  return m_valid ? m_plan->FieldCount() : 0;
+}
+
+
+bool MessageView::GetBool(unsigned int index, bool *value) const {
+  const MessagePlan::Field *field = GetField(index, MessagePlan::BOOL_FIELD);
+  if (!field) {
+    return false;
+  }
+  *value = m_data[field->offset];
+  return true;
+}
+
+
+bool MessageView::GetIPV4(unsigned int index,
+                          ola::network::IPV4Address *value) const {
+  const MessagePlan::Field *field = GetField(index, MessagePlan::IPV4_FIELD);
+  if (!field) {
+    return false;
+  }
+  uint32_t address;
+  memcpy(&address, m_data + field->offset, sizeof(address));
+  *value = ola::network::IPV4Address(address);
+  return true;
+}
+
+
+bool MessageView::GetMAC(unsigned int index,
+                         ola::network::MACAddress *value) const {
+  const MessagePlan::Field *field = GetField(index, MessagePlan::MAC_FIELD);
+  if (!field) {
+    return false;
+  }
+  *value = ola::network::MACAddress(m_data + field->offset);
+  return true;
+}
+
+
+bool MessageView::GetUID(unsigned int index, UID *value) const {
+  const MessagePlan::Field *field = GetField(index, MessagePlan::UID_FIELD);
+  if (!field) {
+    return false;
+  }
+  *value = UID(m_data + field->offset);
+  return true;
+}
+
+
+bool MessageView::GetString(unsigned int index, string *value) const {
+  const MessagePlan::Field *field = GetField(index, MessagePlan::STRING_FIELD);
+  if (!field) {
+    return false;
+  }
+  value->assign(reinterpret_cast<const char*>(m_data + field->offset),
+                field->size);
+  ShortenString(value);
+  return true;
+}
+
+
+bool MessageView::GetUInt(unsigned int index, uint32_t *value) const {
+  if (!m_valid || index >= m_plan->FieldCount()) {
+    return false;
+  }
+
+  const MessagePlan::Field &field = m_plan->GetField(index);
+  switch (field.type) {
+    case MessagePlan::UINT8_FIELD:
+      *value = ReadInt<uint8_t>(field);
+      return true;
+    case MessagePlan::UINT16_FIELD:
+      *value = ReadInt<uint16_t>(field);
+      return true;
+    case MessagePlan::UINT32_FIELD:
+      *value = ReadInt<uint32_t>(field);
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+bool MessageView::GetInt(unsigned int index, int32_t *value) const {
+  if (!m_valid || index >= m_plan->FieldCount()) {
+    return false;
+  }
+
+  const MessagePlan::Field &field = m_plan->GetField(index);
+  switch (field.type) {
+    case MessagePlan::INT8_FIELD:
+      *value = ReadInt<int8_t>(field);
+      return true;
+    case MessagePlan::INT16_FIELD:
+      *value = ReadInt<int16_t>(field);
+      return true;
+    case MessagePlan::INT32_FIELD:
+      *value = ReadInt<int32_t>(field);
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+const MessagePlan::Field *MessageView::GetField(
+    unsigned int index,
+    MessagePlan::FieldType type) const {
+  if (!m_valid || index >= m_plan->FieldCount()) {
+    return NULL;
+  }
+  const MessagePlan::Field &field = m_plan->GetField(index);
+  return field.type == type ? &field : NULL;
+}
+
+
+template <typename int_type>
+int_type MessageView::ReadInt(const MessagePlan::Field &field) const {
+  int_type value;
+  memcpy(&value, m_data + field.offset, sizeof(value));
+  return field.little_endian ? ola::network::LittleEndianToHost(value) :
+                               ola::network::NetworkToHost(value);
+}
+}  // namespace rdm
+}  // namespace ola
@@ -0,0 +1,258 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MessagePlanTest.cpp
+ * Test fixture for the MessagePlan and MessageView classes
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/messaging/Descriptor.h"
+#include "ola/messaging/Message.h"
+#include "ola/messaging/MessagePrinter.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/MACAddress.h"
+#include "ola/rdm/MessageDeserializer.h"
+#include "ola/rdm/MessagePlan.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::messaging::BoolFieldDescriptor;
+using ola::messaging::Descriptor;
+using ola::messaging::FieldDescriptor;
+using ola::messaging::FieldDescriptorGroup;
+using ola::messaging::GenericMessagePrinter;
+using ola::messaging::Int16FieldDescriptor;
+using ola::messaging::Int8FieldDescriptor;
+using ola::messaging::IPV4FieldDescriptor;
+using ola::messaging::MACFieldDescriptor;
+using ola::messaging::Message;
+using ola::messaging::StringFieldDescriptor;
+using ola::messaging::UInt16FieldDescriptor;
+using ola::messaging::UInt32FieldDescriptor;
+using ola::messaging::UInt8FieldDescriptor;
+using ola::messaging::UIDFieldDescriptor;
+using ola::network::IPV4Address;
+using ola::network::MACAddress;
+using ola::rdm::MessageDeserializer;
+using ola::rdm::MessagePlan;
+using ola::rdm::MessageView;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+
+class MessagePlanTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MessagePlanTest);
+  CPPUNIT_TEST(testFixedLayout);
+  CPPUNIT_TEST(testVariableString);
+  CPPUNIT_TEST(testVariableGroup);
+  CPPUNIT_TEST(testView);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testFixedLayout();
+    void testVariableString();
+    void testVariableGroup();
+    void testView();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MessagePlanTest);
+
+
+/**
+ * Check the offsets of a fixed size descriptor, with the groups unrolled.
+ */
+void MessagePlanTest::testFixedLayout() {
+  vector<const FieldDescriptor*> group_fields;
+  group_fields.push_back(new UInt8FieldDescriptor("uint8"));
+  group_fields.push_back(new UInt16FieldDescriptor("uint16", true));
+
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new BoolFieldDescriptor("bool"));
+  fields.push_back(new FieldDescriptorGroup("group", group_fields, 2, 2));
+  fields.push_back(new UInt32FieldDescriptor("uint32"));
+  Descriptor descriptor("Test Descriptor", fields);
+
+  MessagePlan plan(&descriptor);
+  OLA_ASSERT_TRUE(&descriptor == plan.GetDescriptor());
+  OLA_ASSERT_TRUE(plan.IsFixedSize());
+  OLA_ASSERT_EQ(11u, plan.FixedSize());
+  OLA_ASSERT_EQ(6u, plan.FieldCount());
+
+  const unsigned int offsets[] = {0, 1, 2, 4, 5, 7};
+  const MessagePlan::FieldType types[] = {
+    MessagePlan::BOOL_FIELD, MessagePlan::UINT8_FIELD,
+    MessagePlan::UINT16_FIELD, MessagePlan::UINT8_FIELD,
+    MessagePlan::UINT16_FIELD, MessagePlan::UINT32_FIELD};
+  for (unsigned int i = 0; i < plan.FieldCount(); i++) {
+    OLA_ASSERT_EQ(offsets[i], plan.GetField(i).offset);
+    OLA_ASSERT_EQ(types[i], plan.GetField(i).type);
+  }
+  OLA_ASSERT_TRUE(plan.GetField(2).little_endian);
+  OLA_ASSERT_FALSE(plan.GetField(5).little_endian);
+
+  unsigned int variable_field_size = 0;
+  OLA_ASSERT_TRUE(plan.CheckLength(11, &variable_field_size));
+  OLA_ASSERT_FALSE(plan.CheckLength(10, &variable_field_size));
+  OLA_ASSERT_FALSE(plan.CheckLength(12, &variable_field_size));
+}
+
+
+/**
+ * Check a descriptor with a variable sized string.
+ */
+void MessagePlanTest::testVariableString() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new UInt8FieldDescriptor("uint8"));
+  fields.push_back(new StringFieldDescriptor("string", 2, 8));
+  Descriptor descriptor("Test Descriptor", fields);
+
+  MessagePlan plan(&descriptor);
+  OLA_ASSERT_FALSE(plan.IsFixedSize());
+  OLA_ASSERT_EQ(1u, plan.FixedSize());
+  OLA_ASSERT_EQ(0u, plan.FieldCount());
+
+  unsigned int variable_field_size = 0;
+  OLA_ASSERT_FALSE(plan.CheckLength(2, &variable_field_size));
+  OLA_ASSERT_TRUE(plan.CheckLength(3, &variable_field_size));
+  OLA_ASSERT_EQ(2u, variable_field_size);
+  OLA_ASSERT_TRUE(plan.CheckLength(9, &variable_field_size));
+  OLA_ASSERT_EQ(8u, variable_field_size);
+  OLA_ASSERT_FALSE(plan.CheckLength(10, &variable_field_size));
+
+  // A view needs a fixed size plan.
+  const uint8_t data[] = {1, 'a', 'b'};
+  MessageView view(&plan, data, sizeof(data));
+  OLA_ASSERT_FALSE(view.IsValid());
+  OLA_ASSERT_EQ(0u, view.FieldCount());
+}
+
+
+/**
+ * Check a descriptor with a variable sized group, and that the deserializer
+ * gives the same result with the plan as with the descriptor.
+ */
+void MessagePlanTest::testVariableGroup() {
+  vector<const FieldDescriptor*> group_fields;
+  group_fields.push_back(new UInt8FieldDescriptor("uint8"));
+  group_fields.push_back(new Int16FieldDescriptor("int16"));
+
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new UInt16FieldDescriptor("uint16"));
+  fields.push_back(new FieldDescriptorGroup("group", group_fields, 1, 3));
+  Descriptor descriptor("Test Descriptor", fields);
+
+  MessagePlan plan(&descriptor);
+  OLA_ASSERT_FALSE(plan.IsFixedSize());
+  OLA_ASSERT_EQ(2u, plan.FixedSize());
+
+  unsigned int variable_field_size = 0;
+  OLA_ASSERT_FALSE(plan.CheckLength(2, &variable_field_size));
+  OLA_ASSERT_FALSE(plan.CheckLength(4, &variable_field_size));
+  OLA_ASSERT_TRUE(plan.CheckLength(8, &variable_field_size));
+  OLA_ASSERT_EQ(2u, variable_field_size);
+  OLA_ASSERT_FALSE(plan.CheckLength(14, &variable_field_size));
+
+  const uint8_t data[] = {1, 2, 10, 0xff, 0xfe, 20, 0, 5};
+  MessageDeserializer deserializer;
+  auto_ptr<const Message> message(
+      deserializer.InflateMessage(&plan, data, sizeof(data)));
+  OLA_ASSERT_NOT_NULL(message.get());
+  auto_ptr<const Message> expected_message(
+      deserializer.InflateMessage(&descriptor, data, sizeof(data)));
+  OLA_ASSERT_NOT_NULL(expected_message.get());
+
+  GenericMessagePrinter printer;
+  const string expected = (
+      "uint16: 258\ngroup {\n  uint8: 10\n  int16: -2\n}\n"
+      "group {\n  uint8: 20\n  int16: 5\n}\n");
+  OLA_ASSERT_EQ(expected, printer.AsString(message.get()));
+  OLA_ASSERT_EQ(expected, printer.AsString(expected_message.get()));
+
+  OLA_ASSERT_NULL(deserializer.InflateMessage(&plan, data, 4));
+}
+
+
+/**
+ * Check a view reads each field in place.
+ */
+void MessagePlanTest::testView() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new BoolFieldDescriptor("bool"));
+  fields.push_back(new Int8FieldDescriptor("int8"));
+  fields.push_back(new UInt16FieldDescriptor("uint16"));
+  fields.push_back(new Int16FieldDescriptor("int16", true));
+  fields.push_back(new IPV4FieldDescriptor("ip"));
+  fields.push_back(new MACFieldDescriptor("mac"));
+  fields.push_back(new UIDFieldDescriptor("uid"));
+  fields.push_back(new StringFieldDescriptor("string", 4, 4));
+  Descriptor descriptor("Test Descriptor", fields);
+  MessagePlan plan(&descriptor);
+
+  const uint8_t data[] = {
+    1, 0xf6, 1, 0x2c, 0x0a, 0xfe,
+    10, 0, 0, 1,
+    1, 35, 69, 103, 137, 171,
+    0x7a, 0x70, 0, 0, 0, 1,
+    'a', 'b', 0, 0};
+
+  OLA_ASSERT_FALSE(MessageView(&plan, data, sizeof(data) - 1).IsValid());
+  MessageView view(&plan, data, sizeof(data));
+  OLA_ASSERT_TRUE(view.IsValid());
+  OLA_ASSERT_EQ(8u, view.FieldCount());
+
+  bool bool_value = false;
+  OLA_ASSERT_TRUE(view.GetBool(0, &bool_value));
+  OLA_ASSERT_TRUE(bool_value);
+
+  int32_t int_value;
+  OLA_ASSERT_TRUE(view.GetInt(1, &int_value));
+  OLA_ASSERT_EQ(-10, int_value);
+  OLA_ASSERT_TRUE(view.GetInt(3, &int_value));
+  OLA_ASSERT_EQ(-502, int_value);
+
+  uint32_t uint_value;
+  OLA_ASSERT_TRUE(view.GetUInt(2, &uint_value));
+  OLA_ASSERT_EQ(300u, uint_value);
+
+  IPV4Address ip;
+  OLA_ASSERT_TRUE(view.GetIPV4(4, &ip));
+  OLA_ASSERT_EQ(string("10.0.0.1"), ip.ToString());
+
+  MACAddress mac;
+  OLA_ASSERT_TRUE(view.GetMAC(5, &mac));
+  OLA_ASSERT_EQ(string("01:23:45:67:89:ab"), mac.ToString());
+
+  UID uid(0, 0);
+  OLA_ASSERT_TRUE(view.GetUID(6, &uid));
+  OLA_ASSERT_EQ(UID(0x7a70, 1), uid);
+
+  string str;
+  OLA_ASSERT_TRUE(view.GetString(7, &str));
+  OLA_ASSERT_EQ(string("ab"), str);
+
+  // The wrong type, or a field that doesn't exist.
+  OLA_ASSERT_FALSE(view.GetUInt(1, &uint_value));
+  OLA_ASSERT_FALSE(view.GetInt(2, &int_value));
+  OLA_ASSERT_FALSE(view.GetBool(1, &bool_value));
+  OLA_ASSERT_FALSE(view.GetString(8, &str));
+}
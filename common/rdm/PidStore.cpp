@@ -18,11 +18,13 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "common/rdm/PidStoreLoader.h"
 #include "ola/StringUtils.h"
+#include "ola/base/Array.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/stl/STLUtils.h"
@@ -128,26 +130,39 @@ const string RootPidStore::DataLocation() {
   return PID_DATA_DIR;
 }
 
-PidStore::PidStore(const vector<const PidDescriptor*> &pids) {
-  vector<const PidDescriptor*>::const_iterator iter = pids.begin();
-  for (; iter != pids.end(); ++iter) {
-    m_pid_by_value[(*iter)->Value()] = *iter;
-    m_pid_by_name[(*iter)->Name()] = *iter;
+const unsigned int PidStore::PAGE_SIZE;
+
+namespace {
+bool PidValueLessThan(const PidDescriptor *left, const PidDescriptor *right) {
+  return left->Value() < right->Value();
+}
+}  // namespace
+
+PidStore::PidStore(const vector<const PidDescriptor*> &pids)
+    : m_pids(pids),
+      m_pid_index(PAGE_SIZE, 0) {
+  std::sort(m_pids.begin(), m_pids.end(), PidValueLessThan);
+  std::fill(m_page_table, m_page_table + arraysize(m_page_table), 0);
+
+  for (unsigned int i = 0; i < m_pids.size(); ++i) {
+    const uint16_t pid_value = m_pids[i]->Value();
+    uint16_t *page = &m_page_table[pid_value >> 8];
+    if (!*page) {
+      *page = m_pid_index.size() / PAGE_SIZE;
+      m_pid_index.resize(m_pid_index.size() + PAGE_SIZE, 0);
+    }
+    m_pid_index[*page * PAGE_SIZE + (pid_value & 0xff)] = i + 1;
+    m_pid_by_name[m_pids[i]->Name()] = m_pids[i];
   }
 }
 
 PidStore::~PidStore() {
-  STLDeleteValues(&m_pid_by_value);
+  STLDeleteElements(&m_pids);
   m_pid_by_name.clear();
 }
 
 void PidStore::AllPids(vector<const PidDescriptor*> *pids) const {
-  pids->reserve(pids->size() + m_pid_by_value.size());
-
-  PidMap::const_iterator iter = m_pid_by_value.begin();
-  for (; iter != m_pid_by_value.end(); ++iter) {
-    pids->push_back(iter->second);
-  }
+  pids->insert(pids->end(), m_pids.begin(), m_pids.end());
 }
 
 
@@ -155,6 +170,10 @@ void PidStore::AllPids(vector<const PidDescriptor*> *pids) const {
  * Clean up
  */
 PidDescriptor::~PidDescriptor() {
+  delete m_get_request_plan;
+  delete m_get_response_plan;
+  delete m_set_request_plan;
+  delete m_set_response_plan;
   delete m_get_request;
   delete m_get_response;
   delete m_set_request;
@@ -167,11 +186,9 @@ PidDescriptor::~PidDescriptor() {
  * @param pid_value the 16 bit pid value.
  */
 const PidDescriptor *PidStore::LookupPID(uint16_t pid_value) const {
-  PidMap::const_iterator iter = m_pid_by_value.find(pid_value);
-  if (iter == m_pid_by_value.end())
-    return NULL;
-  else
-    return iter->second;
+  const uint16_t index = m_pid_index[
+      m_page_table[pid_value >> 8] * PAGE_SIZE + (pid_value & 0xff)];
+  return index ? m_pids[index - 1] : NULL;
 }
 
 
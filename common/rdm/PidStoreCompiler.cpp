@@ -0,0 +1,66 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PidStoreCompiler.cpp
+ * Convert the text PID files into the binary form the PidStoreLoader reads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/rdm/PidStoreLoader.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
+
+using ola::rdm::PidStoreLoader;
+using std::string;
+using std::vector;
+
+DEFINE_s_string(output, o, "", "The file to write the binary PID data to.");
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options] <pid_file> ...",
+               "Compile the PID files into a single binary file.");
+
+  if (FLAGS_output.str().empty() || argc < 2) {
+    ola::DisplayUsageAndExit();
+  }
+
+  vector<string> files(argv + 1, argv + argc);
+  const string output_file = FLAGS_output.str();
+  std::ofstream output(output_file.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    OLA_FATAL << "Failed to open " << output_file;
+    exit(ola::EXIT_CANTCREAT);
+  }
+
+  PidStoreLoader loader;
+  bool ok = loader.CompileFiles(files, &output);
+  output.close();
+  if (!ok || output.fail()) {
+    OLA_FATAL << "Failed to compile the PID files";
+    // Don't leave a partial file behind for make to think is up to date.
+    remove(output_file.c_str());
+    exit(ola::EXIT_DATAERR);
+  }
+  return ola::EXIT_OK;
+}
@@ -140,6 +140,17 @@ const ola::messaging::Message *PidStoreHelper::DeserializeMessage(
 }
 
 
+/**
+ * @brief DeSerialize a message using the plan from a PidDescriptor
+ */
+const ola::messaging::Message *PidStoreHelper::DeserializeMessage(
+    const MessagePlan *plan,
+    const uint8_t *data,
+    unsigned int data_length) {
+  return m_deserializer.InflateMessage(plan, data, data_length);
+}
+
+
 /**
  * @brief Convert a message to a string
  * @param message the Message object to print
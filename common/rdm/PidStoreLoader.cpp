@@ -19,6 +19,8 @@
  */
 
 #include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
 #include <fstream>
@@ -49,6 +51,7 @@ using std::set;
 using std::string;
 using std::vector;
 
+const char PidStoreLoader::BINARY_FILE_NAME[] = "pids.pb";
 const char PidStoreLoader::OVERRIDE_FILE_NAME[] = "overrides.proto";
 const uint16_t PidStoreLoader::ESTA_MANUFACTURER_ID = 0;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MIN = 0x8000;
@@ -74,34 +77,40 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
   vector<string> files;
 
   string override_file;
+  string binary_file;
   vector<string> all_files;
   ola::file::ListDirectory(directory, &all_files);
   vector<string>::const_iterator file_iter = all_files.begin();
   for (; file_iter != all_files.end(); ++file_iter) {
-    if (ola::file::FilenameFromPath(*file_iter) == OVERRIDE_FILE_NAME) {
+    const string file_name = ola::file::FilenameFromPath(*file_iter);
+    if (file_name == OVERRIDE_FILE_NAME) {
       override_file = *file_iter;
+    } else if (file_name == BINARY_FILE_NAME) {
+      binary_file = *file_iter;
     } else if (StringEndsWith(*file_iter, ".proto")) {
       files.push_back(*file_iter);
     }
   }
 
   ola::rdm::pid::PidStore pid_store_pb;
-  vector<string>::const_iterator iter = files.begin();
-  for (; iter != files.end(); ++iter) {
-    std::ifstream proto_file(iter->data());
-    if (!proto_file.is_open()) {
-      OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
-      return NULL;
+  bool store_validated = false;
+  if (!binary_file.empty()) {
+    // Don't let a stale binary file hide changes to the .proto files.
+    if (!IsNewerThan(binary_file, files)) {
+      OLA_INFO << binary_file << " is out of date, loading the .proto files";
+    } else if (ReadBinaryFile(binary_file, &pid_store_pb)) {
+      store_validated = true;
+    } else {
+      pid_store_pb.Clear();
     }
+  }
 
-    google::protobuf::io::IstreamInputStream input_stream(&proto_file);
-    bool ok = google::protobuf::TextFormat::Merge(&input_stream,
-                                                  &pid_store_pb);
-    proto_file.close();
-
-    if (!ok) {
-      OLA_WARN << "Failed to load " << *iter;
-      return NULL;
+  if (!store_validated) {
+    vector<string>::const_iterator iter = files.begin();
+    for (; iter != files.end(); ++iter) {
+      if (!ReadFile(*iter, &pid_store_pb)) {
+        return NULL;
+      }
     }
   }
 
@@ -112,7 +121,7 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
     }
   }
 
-  return BuildStore(pid_store_pb, override_pb, validate);
+  return BuildStore(pid_store_pb, override_pb, validate, store_validated);
 }
 
 const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
@@ -128,6 +137,37 @@ const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
   return BuildStore(pid_store_pb, override_pb, validate);
 }
 
+const RootPidStore *PidStoreLoader::LoadFromBinaryStream(std::istream *data) {
+  ola::rdm::pid::PidStore pid_store_pb;
+  if (!pid_store_pb.ParseFromIstream(data)) {
+    return NULL;
+  }
+
+  ola::rdm::pid::PidStore override_pb;
+  return BuildStore(pid_store_pb, override_pb, false, true);
+}
+
+bool PidStoreLoader::CompileFiles(const vector<string> &files,
+                                  std::ostream *output) {
+  ola::rdm::pid::PidStore pid_store_pb;
+  vector<string>::const_iterator iter = files.begin();
+  for (; iter != files.end(); ++iter) {
+    if (!ReadFile(*iter, &pid_store_pb)) {
+      return false;
+    }
+  }
+
+  // Check the data is valid now, so that it doesn't need to be checked when
+  // it's loaded.
+  ola::rdm::pid::PidStore override_pb;
+  auto_ptr<const RootPidStore> store(
+      BuildStore(pid_store_pb, override_pb, true));
+  if (!store.get()) {
+    return false;
+  }
+  return pid_store_pb.SerializeToOstream(output);
+}
+
 bool PidStoreLoader::ReadFile(const std::string &file_path,
                               ola::rdm::pid::PidStore *proto) {
   std::ifstream proto_file(file_path.c_str());
@@ -146,13 +186,55 @@ bool PidStoreLoader::ReadFile(const std::string &file_path,
   return ok;
 }
 
+bool PidStoreLoader::ReadBinaryFile(const std::string &file_path,
+                                    ola::rdm::pid::PidStore *proto) {
+  std::ifstream binary_file(file_path.c_str(),
+                            std::ios::in | std::ios::binary);
+  if (!binary_file.is_open()) {
+    OLA_WARN << "Failed to open " << file_path << ": " << strerror(errno);
+    return false;
+  }
+
+  bool ok = proto->ParseFromIstream(&binary_file);
+  binary_file.close();
+
+  if (!ok) {
+    OLA_WARN << "Failed to load " << file_path;
+  }
+  return ok;
+}
+
+/*
+ * Check if a file was modified after all of the others.
+ */
+bool PidStoreLoader::IsNewerThan(const std::string &file_path,
+                                 const vector<string> &files) {
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat)) {
+    return false;
+  }
+
+  vector<string>::const_iterator iter = files.begin();
+  for (; iter != files.end(); ++iter) {
+    struct stat other_stat;
+    if (stat(iter->c_str(), &other_stat) ||
+        other_stat.st_mtime > file_stat.st_mtime) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * Build the RootPidStore from a protocol buffer.
+ * @param store_validated true if store_pb was validated by CompileFiles(), in
+ *   which case only the overrides are validated.
  */
 const RootPidStore *PidStoreLoader::BuildStore(
     const ola::rdm::pid::PidStore &store_pb,
     const ola::rdm::pid::PidStore &override_pb,
-    bool validate) {
+    bool validate,
+    bool store_validated) {
   ManufacturerMap pid_data;
   // Load the overrides first so they get first dibs on each PID.
   if (!LoadFromProto(&pid_data, override_pb, validate)) {
@@ -161,7 +243,7 @@ const RootPidStore *PidStoreLoader::BuildStore(
   }
 
   // Load the main data
-  if (!LoadFromProto(&pid_data, store_pb, validate)) {
+  if (!LoadFromProto(&pid_data, store_pb, validate && !store_validated)) {
     FreeManufacturerMap(&pid_data);
     return NULL;
   }
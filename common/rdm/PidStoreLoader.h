@@ -27,6 +27,7 @@
 #include <ola/rdm/PidStore.h>
 #include <map>
 #include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
 #include "common/rdm/DescriptorConsistencyChecker.h"
@@ -60,6 +61,10 @@ class PidStoreLoader {
    * @returns A pointer to a new RootPidStore or NULL if loading failed.
    *
    * This is an all-or-nothing load. Any error with cause us to abort the load.
+   *
+   * If the directory contains a file produced by CompileFiles(), named
+   * BINARY_FILE_NAME, and it's newer than all the .proto files, it's loaded
+   * instead of the .proto files. The overrides file is always loaded.
    */
   const RootPidStore *LoadFromDirectory(const std::string &directory,
                                         bool validate = true);
@@ -74,6 +79,30 @@ class PidStoreLoader {
   const RootPidStore *LoadFromStream(std::istream *data,
                                      bool validate = true);
 
+  /**
+   * @brief Load PID information from a stream written by CompileFiles().
+   * @param data the input stream.
+   * @returns A pointer to a new RootPidStore or NULL if loading failed.
+   *
+   * The data was validated when it was compiled, so it isn't validated again.
+   */
+  const RootPidStore *LoadFromBinaryStream(std::istream *data);
+
+  /**
+   * @brief Merge a set of PID files and write them out in binary form.
+   * @param files the text format files to merge.
+   * @param output the stream to write the binary data to.
+   * @returns true if the files were valid and the data was written, false
+   *   otherwise.
+   *
+   * Parsing the binary form is much faster than parsing the text files, which
+   * matters on slow machines.
+   */
+  bool CompileFiles(const std::vector<std::string> &files,
+                    std::ostream *output);
+
+  static const char BINARY_FILE_NAME[];
+
  private:
   typedef std::map<uint16_t, const PidDescriptor*> PidMap;
   typedef std::map<uint16_t, PidMap*> ManufacturerMap;
@@ -82,10 +111,15 @@ class PidStoreLoader {
 
   bool ReadFile(const std::string &file_path,
                 ola::rdm::pid::PidStore *proto);
+  bool ReadBinaryFile(const std::string &file_path,
+                      ola::rdm::pid::PidStore *proto);
+  bool IsNewerThan(const std::string &file_path,
+                   const std::vector<std::string> &files);
 
   const RootPidStore *BuildStore(const ola::rdm::pid::PidStore &store_pb,
                                  const ola::rdm::pid::PidStore &override_pb,
-                                 bool validate);
+                                 bool validate,
+                                 bool store_validated = false);
 
   bool LoadFromProto(ManufacturerMap *pid_data,
                      const ola::rdm::pid::PidStore &proto,
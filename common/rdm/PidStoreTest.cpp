@@ -53,9 +53,11 @@ class PidStoreTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PidStoreTest);
   CPPUNIT_TEST(testPidDescriptor);
   CPPUNIT_TEST(testPidStore);
+  CPPUNIT_TEST(testPidStoreLookupPages);
   CPPUNIT_TEST(testPidStoreLoad);
   CPPUNIT_TEST(testPidStoreFileLoad);
   CPPUNIT_TEST(testPidStoreDirectoryLoad);
+  CPPUNIT_TEST(testPidStoreBinaryLoad);
   CPPUNIT_TEST(testPidStoreLoadMissingFile);
   CPPUNIT_TEST(testPidStoreLoadDuplicateManufacturer);
   CPPUNIT_TEST(testPidStoreLoadDuplicateValue);
@@ -67,9 +69,11 @@ class PidStoreTest: public CppUnit::TestFixture {
  public:
   void testPidDescriptor();
   void testPidStore();
+  void testPidStoreLookupPages();
   void testPidStoreLoad();
   void testPidStoreFileLoad();
   void testPidStoreDirectoryLoad();
+  void testPidStoreBinaryLoad();
   void testPidStoreLoadMissingFile();
   void testPidStoreLoadDuplicateManufacturer();
   void testPidStoreLoadDuplicateValue();
@@ -180,6 +184,46 @@ void PidStoreTest::testPidStore() {
 }
 
 
+/**
+ * Check PID lookups either side of the index page boundaries.
+ */
+void PidStoreTest::testPidStoreLookupPages() {
+  const uint16_t values[] = {0x8000, 0x00ff, 0xffff, 0x0100, 0x0001};
+  vector<const PidDescriptor*> pids;
+  for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    std::ostringstream name;
+    name << "pid" << i;
+    pids.push_back(new PidDescriptor(
+        name.str(), values[i], NULL, NULL, NULL, NULL,
+        PidDescriptor::ANY_SUB_DEVICE,
+        PidDescriptor::ANY_SUB_DEVICE));
+  }
+  PidStore store(pids);
+  OLA_ASSERT_EQ(5u, store.PidCount());
+
+  for (unsigned int i = 0; i < pids.size(); ++i) {
+    OLA_ASSERT_EQ(pids[i], store.LookupPID(values[i]));
+  }
+
+  const uint16_t missing_values[] = {0x0000, 0x0002, 0x00fe, 0x0101, 0x01ff,
+                                     0x7fff, 0x8001, 0xfeff, 0xfffe};
+  for (unsigned int i = 0;
+       i < sizeof(missing_values) / sizeof(missing_values[0]); ++i) {
+    OLA_ASSERT_NULL(store.LookupPID(missing_values[i]));
+  }
+
+  // AllPids() is ordered by value
+  vector<const PidDescriptor*> all_pids;
+  store.AllPids(&all_pids);
+  OLA_ASSERT_EQ(static_cast<size_t>(5), all_pids.size());
+  OLA_ASSERT_EQ(pids[4], all_pids[0]);
+  OLA_ASSERT_EQ(pids[1], all_pids[1]);
+  OLA_ASSERT_EQ(pids[3], all_pids[2]);
+  OLA_ASSERT_EQ(pids[0], all_pids[3]);
+  OLA_ASSERT_EQ(pids[2], all_pids[4]);
+}
+
+
 /**
  * Check we can load a PidStore from a string
  */
@@ -443,6 +487,49 @@ void PidStoreTest::testPidStoreDirectoryLoad() {
 }
 
 
+/**
+ * Check we can compile PID files to the binary form and load them back.
+ */
+void PidStoreTest::testPidStoreBinaryLoad() {
+  PidStoreLoader loader;
+
+  vector<string> files;
+  files.push_back(GetTestDataFile("pids/pids1.proto"));
+  files.push_back(GetTestDataFile("pids/pids2.proto"));
+  stringstream str;
+  OLA_ASSERT_TRUE(loader.CompileFiles(files, &str));
+
+  auto_ptr<const RootPidStore> root_store(loader.LoadFromBinaryStream(&str));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), root_store->Version());
+
+  const PidStore *esta_store = root_store->EstaStore();
+  OLA_ASSERT_NOT_NULL(esta_store);
+  OLA_ASSERT_EQ(4u, esta_store->PidCount());
+  const PidDescriptor *queued_message = esta_store->LookupPID(32);
+  OLA_ASSERT_NOT_NULL(queued_message);
+  OLA_ASSERT_EQ(string("QUEUED_MESSAGE"), queued_message->Name());
+  OLA_ASSERT_TRUE(queued_message->GetRequest());
+
+  // there are no overrides
+  const PidStore *open_lighting_store =
+    root_store->ManufacturerStore(ola::OPEN_LIGHTING_ESTA_CODE);
+  OLA_ASSERT_NOT_NULL(open_lighting_store);
+  OLA_ASSERT_NOT_NULL(open_lighting_store->LookupPID("SERIAL_NUMBER"));
+  OLA_ASSERT_NOT_NULL(root_store->ManufacturerStore(161));
+
+  // invalid files don't compile
+  files.push_back(GetTestDataFile("duplicate_pid_name.proto"));
+  stringstream invalid_str;
+  OLA_ASSERT_FALSE(loader.CompileFiles(files, &invalid_str));
+  OLA_ASSERT_TRUE(invalid_str.str().empty());
+
+  // nor does garbage load
+  stringstream garbage("this isn't a binary pid store");
+  OLA_ASSERT_NULL(loader.LoadFromBinaryStream(&garbage));
+}
+
+
 /**
  * Check that loading a missing file fails.
  */
@@ -19,14 +19,19 @@
  */
 
 #include <string.h>
+#include <algorithm>
+#include <map>
+#include <queue>
 #include <string>
 #include <utility>
 #include <vector>
+#include "ola/Clock.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMTimingStats.h"
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
 
@@ -45,58 +50,55 @@ using std::vector;
  * A new QueueingRDMController. This takes another controller as a argument,
  * and ensures that we only send one request at a time.
  */
+const unsigned int QueueingRDMController::INTERACTIVE_BURST;
+
 QueueingRDMController::QueueingRDMController(
     RDMControllerInterface *controller,
-    unsigned int max_queue_size)
+    unsigned int max_queue_size,
+    const ola::Clock *clock)
   : m_controller(controller),
     m_max_queue_size(max_queue_size),
+    m_interactive_run(0),
     m_rdm_request_pending(false),
     m_active(true),
     m_callback(ola::NewCallback(this,
-                                &QueueingRDMController::HandleRDMResponse)) {
+                                &QueueingRDMController::HandleRDMResponse)),
+    m_clock(clock ? clock : &m_real_clock) {
+  m_current.request = NULL;
+  m_current.on_complete = NULL;
 }
 
 
-/*
- * Shutdown
- */
 QueueingRDMController::~QueueingRDMController() {
   // delete all outstanding requests
-  while (!m_pending_requests.empty()) {
-    outstanding_rdm_request outstanding_request = m_pending_requests.front();
-    if (outstanding_request.on_complete) {
-      RunRDMCallback(outstanding_request.on_complete, RDM_FAILED_TO_SEND);
+  if (m_current.request) {
+    if (m_current.on_complete) {
+      RunRDMCallback(m_current.on_complete, RDM_FAILED_TO_SEND);
     }
-    delete outstanding_request.request;
-    m_pending_requests.pop();
+    delete m_current.request;
   }
+  FailAll(&m_interactive);
+  FailAll(&m_bulk);
 }
 
 
-/**
- * Pause the sending of RDM messages. This won't cancel any message in-flight.
- */
 void QueueingRDMController::Pause() {
   m_active = false;
 }
 
 
-/**
- * Resume the sending of RDM requests.
- */
 void QueueingRDMController::Resume() {
   m_active = true;
   MaybeSendRDMRequest();
 }
 
 
-/**
- * Queue an RDM request for sending.
- */
 void QueueingRDMController::SendRDMRequest(RDMRequest *request,
                                            RDMCallback *on_complete) {
-  if (m_pending_requests.size() >= m_max_queue_size) {
+  unsigned int queued = m_interactive.size + m_bulk.size;
+  if (queued + (m_current.request ? 1 : 0) >= m_max_queue_size) {
     OLA_WARN << "RDM Queue is full, dropping request";
+    m_stats.dropped++;
     if (on_complete) {
       RunRDMCallback(on_complete, RDM_FAILED_TO_SEND);
     }
@@ -107,14 +109,13 @@ void QueueingRDMController::SendRDMRequest(RDMRequest *request,
   outstanding_rdm_request outstanding_request;
   outstanding_request.request = request;
   outstanding_request.on_complete = on_complete;
-  m_pending_requests.push(outstanding_request);
+  Push(request->GetScheduling().bulk ? &m_bulk : &m_interactive,
+       outstanding_request);
+  m_stats.max_queue_depth = std::max(m_stats.max_queue_depth, queued + 1);
   TakeNextAction();
 }
 
 
-/**
- * Do the next action.
- */
 void QueueingRDMController::TakeNextAction() {
   if (CheckForBlockingCondition())
     return;
@@ -123,54 +124,56 @@ void QueueingRDMController::TakeNextAction() {
 }
 
 
-/**
- * This method runs before we decide to send another request and allows sub
- * classes (like the DiscoverableQueueingRDMController) to insert other actions
- * into the queue.
- * @returns true if some other action is running, false otherwise.
- */
 bool QueueingRDMController::CheckForBlockingCondition() {
   return !m_active || m_rdm_request_pending;
 }
 
 
-/*
- * If we're not paused, send the next request.
- */
 void QueueingRDMController::MaybeSendRDMRequest() {
-  if (m_pending_requests.empty())
+  if (m_current.request || (!m_interactive.size && !m_bulk.size))
     return;
 
+  if (m_interactive.size &&
+      (!m_bulk.size || m_interactive_run < INTERACTIVE_BURST)) {
+    m_current = Pop(&m_interactive);
+    m_stats.interactive_sent++;
+    m_interactive_run = m_bulk.size ? m_interactive_run + 1 : 0;
+  } else {
+    m_current = Pop(&m_bulk);
+    m_stats.bulk_sent++;
+    m_interactive_run = 0;
+  }
+
   m_rdm_request_pending = true;
   DispatchNextRequest();
 }
 
 
-/*
- * Send the next RDM request.
- */
 void QueueingRDMController::DispatchNextRequest() {
-  outstanding_rdm_request outstanding_request = m_pending_requests.front();
   // We have to make a copy here because we pass ownership of the request to
   // the underlying controller.
   // We need to have the original request because we use it if we receive an
   // ACK_OVERFLOW.
-  m_controller->SendRDMRequest(outstanding_request.request->Duplicate(),
+  m_timing.RecordRequest(*m_current.request);
+  m_clock->CurrentTime(&m_sent_time);
+  m_controller->SendRDMRequest(m_current.request->Duplicate(),
                                m_callback.get());
 }
 
 
-/*
- * Handle the response to a RemoteGet command
- */
 void QueueingRDMController::HandleRDMResponse(RDMReply *reply) {
   m_rdm_request_pending = false;
 
-  if (m_pending_requests.empty()) {
-    OLA_FATAL << "Received a response but the queue was empty!";
+  if (!m_current.request) {
+    OLA_FATAL << "Received a response but there was no request in progress!";
     return;
   }
 
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  m_timing.RecordReply(m_current.request->DestinationUID(),
+                       now - m_sent_time, *reply);
+
   bool was_ack_overflow = reply->StatusCode() == RDM_COMPLETED_OK &&
                           reply->Response() &&
                           reply->Response()->ResponseType() == ACK_OVERFLOW;
@@ -224,8 +227,9 @@ void QueueingRDMController::HandleRDMResponse(RDMReply *reply) {
 }
 
 void QueueingRDMController::RunCallback(RDMReply *reply) {
-  outstanding_rdm_request outstanding_request = m_pending_requests.front();
-  m_pending_requests.pop();
+  outstanding_rdm_request outstanding_request = m_current;
+  m_current.request = NULL;
+  m_current.on_complete = NULL;
   if (outstanding_request.on_complete) {
     outstanding_request.on_complete->Run(reply);
   }
@@ -233,13 +237,60 @@ void QueueingRDMController::RunCallback(RDMReply *reply) {
 }
 
 
+void QueueingRDMController::Push(Lane *lane,
+                                 const outstanding_rdm_request &request) {
+  const unsigned int originator = request.request->GetScheduling().originator;
+  std::queue<outstanding_rdm_request> &queue = lane->queues[originator];
+  if (queue.empty()) {
+    lane->turns.push_back(originator);
+  }
+  queue.push(request);
+  lane->size++;
+}
+
+
+/*
+ * Take the next request from the originator whose turn it is.
+ * @pre the lane isn't empty.
+ */
+QueueingRDMController::outstanding_rdm_request QueueingRDMController::Pop(
+    Lane *lane) {
+  const unsigned int originator = lane->turns.front();
+  lane->turns.pop_front();
+
+  std::map<unsigned int, std::queue<outstanding_rdm_request> >::iterator iter =
+      lane->queues.find(originator);
+  outstanding_rdm_request request = iter->second.front();
+  iter->second.pop();
+  if (iter->second.empty()) {
+    lane->queues.erase(iter);
+  } else {
+    lane->turns.push_back(originator);
+  }
+  lane->size--;
+  return request;
+}
+
+
+void QueueingRDMController::FailAll(Lane *lane) {
+  while (lane->size) {
+    outstanding_rdm_request outstanding_request = Pop(lane);
+    if (outstanding_request.on_complete) {
+      RunRDMCallback(outstanding_request.on_complete, RDM_FAILED_TO_SEND);
+    }
+    delete outstanding_request.request;
+  }
+}
+
+
 /**
  * Constructor for the DiscoverableQueueingRDMController
  */
 DiscoverableQueueingRDMController::DiscoverableQueueingRDMController(
         DiscoverableRDMControllerInterface *controller,
-        unsigned int max_queue_size)
-    : QueueingRDMController(controller, max_queue_size),
+        unsigned int max_queue_size,
+        const ola::Clock *clock)
+    : QueueingRDMController(controller, max_queue_size, clock),
       m_discoverable_controller(controller) {
 }
 
@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/Callback.h"
@@ -61,6 +62,16 @@ RDMRequest *NewGetRequest(const UID &source, const UID &destination) {
                                      0);  // data length
 }
 
+RDMRequest *NewScheduledRequest(const UID &source, const UID &destination,
+                                bool bulk, unsigned int originator) {
+  RDMRequest *request = NewGetRequest(source, destination);
+  RDMRequest::Scheduling scheduling;
+  scheduling.bulk = bulk;
+  scheduling.originator = originator;
+  request->SetScheduling(scheduling);
+  return request;
+}
+
 RDMResponse *NewGetResponse(const UID &source, const UID &destination) {
   return new RDMGetResponse(source,
                             destination,
@@ -80,6 +91,8 @@ class QueueingRDMControllerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testAckOverflows);
   CPPUNIT_TEST(testPauseAndResume);
   CPPUNIT_TEST(testQueueOverflow);
+  CPPUNIT_TEST(testScheduling);
+  CPPUNIT_TEST(testTiming);
   CPPUNIT_TEST(testDiscovery);
   CPPUNIT_TEST(testMultipleDiscovery);
   CPPUNIT_TEST(testReentrantDiscovery);
@@ -98,6 +111,8 @@ class QueueingRDMControllerTest: public CppUnit::TestFixture {
   void testAckOverflows();
   void testPauseAndResume();
   void testQueueOverflow();
+  void testScheduling();
+  void testTiming();
   void testDiscovery();
   void testMultipleDiscovery();
   void testReentrantDiscovery();
@@ -616,6 +631,102 @@ void QueueingRDMControllerTest::testQueueOverflow() {
   // goes out of scope
 }
 
+/*
+ * Verify interactive requests go ahead of bulk ones, and that originators
+ * take turns.
+ */
+void QueueingRDMControllerTest::testScheduling() {
+  MockRDMController mock_controller;
+  ola::rdm::QueueingRDMController controller(&mock_controller, 20);
+  controller.Pause();
+
+  vector<RDMRequest*> bulk;
+  for (unsigned int i = 0; i < 2; i++) {
+    bulk.push_back(NewScheduledRequest(m_source, UID(3, 100 + i), true, 1));
+  }
+  // Originator 1 sends four requests, originator 2 sends two.
+  vector<RDMRequest*> interactive;
+  for (unsigned int i = 0; i < 6; i++) {
+    interactive.push_back(
+        NewScheduledRequest(m_source, UID(3, i), false, i < 4 ? 1 : 2));
+  }
+
+  vector<RDMRequest*>::iterator iter = bulk.begin();
+  for (; iter != bulk.end(); ++iter) {
+    controller.SendRDMRequest(*iter, NULL);
+  }
+  for (iter = interactive.begin(); iter != interactive.end(); ++iter) {
+    controller.SendRDMRequest(*iter, NULL);
+  }
+  OLA_ASSERT_EQ(6u, controller.InteractiveQueueDepth());
+  OLA_ASSERT_EQ(2u, controller.BulkQueueDepth());
+
+  // The originators alternate, and a bulk request gets through after
+  // INTERACTIVE_BURST interactive ones.
+  mock_controller.ExpectCallAndCapture(interactive[0]);
+  mock_controller.ExpectCallAndCapture(interactive[4]);
+  mock_controller.ExpectCallAndCapture(interactive[1]);
+  mock_controller.ExpectCallAndCapture(interactive[5]);
+  mock_controller.ExpectCallAndCapture(bulk[0]);
+  mock_controller.ExpectCallAndCapture(interactive[2]);
+  mock_controller.ExpectCallAndCapture(interactive[3]);
+  mock_controller.ExpectCallAndCapture(bulk[1]);
+
+  controller.Resume();
+  RDMReply timeout_reply(ola::rdm::RDM_TIMEOUT);
+  for (unsigned int i = 0; i < 8; i++) {
+    mock_controller.RunRDMCallback(&timeout_reply);
+  }
+  mock_controller.Verify();
+
+  OLA_ASSERT_EQ(0u, controller.InteractiveQueueDepth());
+  OLA_ASSERT_EQ(0u, controller.BulkQueueDepth());
+  const ola::rdm::QueueingRDMController::Stats &stats = controller.GetStats();
+  OLA_ASSERT_EQ(6u, stats.interactive_sent);
+  OLA_ASSERT_EQ(2u, stats.bulk_sent);
+  OLA_ASSERT_EQ(0u, stats.dropped);
+  OLA_ASSERT_EQ(8u, stats.max_queue_depth);
+}
+
+/*
+ * Verify the latency and outcome of each request are recorded.
+ */
+void QueueingRDMControllerTest::testTiming() {
+  MockRDMController mock_controller;
+  ola::MockClock clock;
+  ola::rdm::QueueingRDMController controller(&mock_controller, 10, &clock);
+
+  // A request that times out, and is then sent again.
+  RDMRequest *get_request = NewGetRequest(m_source, m_destination);
+  mock_controller.ExpectCallAndCapture(get_request);
+  controller.SendRDMRequest(get_request, NULL);
+  clock.AdvanceTime(0, 3000);
+  RDMReply timeout_reply(ola::rdm::RDM_TIMEOUT);
+  mock_controller.RunRDMCallback(&timeout_reply);
+
+  get_request = NewGetRequest(m_source, m_destination);
+  mock_controller.ExpectCallAndCapture(get_request);
+  controller.SendRDMRequest(get_request, NULL);
+  clock.AdvanceTime(0, 2000);
+  RDMReply ack_reply(ola::rdm::RDM_COMPLETED_OK,
+                     NewGetResponse(m_destination, m_source));
+  mock_controller.RunRDMCallback(&ack_reply);
+  mock_controller.Verify();
+
+  const ola::rdm::RDMTimingStats &timing = controller.GetTimingStats();
+  OLA_ASSERT_EQ(2u, timing.Totals().requests);
+  OLA_ASSERT_EQ(1u, timing.Totals().timeouts);
+  OLA_ASSERT_EQ(1u, timing.Totals().retransmits);
+  OLA_ASSERT_EQ(0u, timing.Totals().ack_timers);
+
+  const ola::rdm::RDMTimingStats::Timing *responder = timing.Responder(
+      m_destination);
+  OLA_ASSERT_NOT_NULL(responder);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), responder->latency.Count());
+  OLA_ASSERT_EQ(2000u, responder->latency.Max());
+  OLA_ASSERT_NULL(timing.Responder(m_source));
+}
+
 /*
  * Verify discovery works
  */
@@ -0,0 +1,166 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMFrameView.cpp
+ * A read only view of a RDM message held in someone else's memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMFrameView.h"
+#include "ola/rdm/RDMPacket.h"
+#include "ola/rdm/UID.h"
+#include "ola/util/Utils.h"
+
+namespace ola {
+namespace rdm {
+
+using ola::io::IOVec;
+using ola::utils::JoinUInt8;
+using ola::utils::SplitUInt16;
+
+RDMStatusCode RDMFrameView::Parse(const uint8_t *data, unsigned int length) {
+  m_data = NULL;
+  m_length = 0;
+
+  if (!data || length < sizeof(RDMCommandHeader) + CHECKSUM_LENGTH) {
+    return RDM_PACKET_TOO_SHORT;
+  }
+
+  const RDMCommandHeader *header =
+      reinterpret_cast<const RDMCommandHeader*>(data);
+  if (header->sub_start_code != SUB_START_CODE) {
+    return RDM_WRONG_SUB_START_CODE;
+  }
+
+  // The message length includes the start code but not the checksum.
+  const unsigned int message_length = header->message_length;
+  if (length < message_length + 1) {
+    return RDM_PACKET_LENGTH_MISMATCH;
+  }
+  if (message_length !=
+      sizeof(RDMCommandHeader) + header->param_data_length + 1) {
+    return RDM_PARAM_LENGTH_MISMATCH;
+  }
+
+  const uint16_t checksum = RDMCommand::CalculateChecksum(
+      data, message_length - 1);
+  if (checksum != JoinUInt8(data[message_length - 1], data[message_length])) {
+    return RDM_CHECKSUM_INCORRECT;
+  }
+
+  m_data = data;
+  m_length = message_length + 1;
+  return RDM_COMPLETED_OK;
+}
+
+RDMStatusCode RDMFrameView::Parse(const RDMFrame &frame) {
+  if (frame.data.empty()) {
+    m_data = NULL;
+    m_length = 0;
+    return RDM_PACKET_TOO_SHORT;
+  }
+  if (frame.data[0] != START_CODE) {
+    m_data = NULL;
+    m_length = 0;
+    return RDM_INVALID_RESPONSE;
+  }
+  return Parse(frame.data.data() + 1, frame.data.size() - 1);
+}
+
+IOVec RDMFrameView::AsIOVec() const {
+  IOVec iov;
+  iov.iov_base = const_cast<uint8_t*>(m_data);
+  iov.iov_len = m_length;
+  return iov;
+}
+
+bool RDMFrameView::Pack(const UID &source,
+                        const UID &destination,
+                        uint8_t transaction_number,
+                        uint8_t port_id_response_type,
+                        uint8_t message_count,
+                        uint16_t sub_device,
+                        RDMCommand::RDMCommandClass command_class,
+                        uint16_t param_id,
+                        const uint8_t *param_data,
+                        unsigned int param_data_length,
+                        uint8_t *buffer,
+                        unsigned int *size) {
+  const unsigned int message_length =
+      sizeof(RDMCommandHeader) + param_data_length + CHECKSUM_LENGTH;
+  if (message_length > MAX_MESSAGE_SIZE || *size < message_length ||
+      (param_data_length && !param_data)) {
+    return false;
+  }
+
+  // RDMCommandHeader only contains uint8_t so the buffer needn't be aligned.
+  RDMCommandHeader *header = reinterpret_cast<RDMCommandHeader*>(buffer);
+  header->sub_start_code = SUB_START_CODE;
+  header->message_length = message_length - 1;
+  destination.Pack(header->destination_uid, UID::UID_SIZE);
+  source.Pack(header->source_uid, UID::UID_SIZE);
+  header->transaction_number = transaction_number;
+  header->port_id = port_id_response_type;
+  header->message_count = message_count;
+  SplitUInt16(sub_device, &header->sub_device[0], &header->sub_device[1]);
+  header->command_class = command_class;
+  SplitUInt16(param_id, &header->param_id[0], &header->param_id[1]);
+  header->param_data_length = param_data_length;
+  if (param_data_length) {
+    memcpy(buffer + sizeof(RDMCommandHeader), param_data, param_data_length);
+  }
+
+  const uint16_t checksum = RDMCommand::CalculateChecksum(
+      buffer, message_length - CHECKSUM_LENGTH);
+  SplitUInt16(checksum, &buffer[message_length - CHECKSUM_LENGTH],
+              &buffer[message_length - CHECKSUM_LENGTH + 1]);
+  *size = message_length;
+  return true;
+}
+
+bool RDMFrameView::PackResponse(const RDMFrameView &request,
+                                rdm_response_type response_type,
+                                const uint8_t *param_data,
+                                unsigned int param_data_length,
+                                uint8_t *buffer,
+                                unsigned int *size,
+                                uint8_t outstanding_messages) {
+  if (!request.IsValid()) {
+    return false;
+  }
+
+  RDMCommand::RDMCommandClass command_class;
+  switch (request.CommandClass()) {
+    case RDMCommand::GET_COMMAND:
+      command_class = RDMCommand::GET_COMMAND_RESPONSE;
+      break;
+    case RDMCommand::SET_COMMAND:
+      command_class = RDMCommand::SET_COMMAND_RESPONSE;
+      break;
+    default:
+      return false;
+  }
+
+  return Pack(request.DestinationUID(), request.SourceUID(),
+              request.TransactionNumber(), response_type,
+              outstanding_messages, request.SubDevice(), command_class,
+              request.ParamId(), param_data, param_data_length, buffer, size);
+}
+}  // namespace rdm
+}  // namespace ola
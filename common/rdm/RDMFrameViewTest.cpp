@@ -0,0 +1,286 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMFrameViewTest.cpp
+ * Test fixture for the RDMFrameView class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <memory>
+
+#include "ola/base/Array.h"
+#include "ola/io/ByteString.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMCommandSerializer.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMFrame.h"
+#include "ola/rdm/RDMFrameView.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::ByteString;
+using ola::rdm::GetResponseFromData;
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMCommandSerializer;
+using ola::rdm::RDMFrame;
+using ola::rdm::RDMFrameView;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using std::auto_ptr;
+
+class RDMFrameViewTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMFrameViewTest);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST(testParseErrors);
+  CPPUNIT_TEST(testParseFrame);
+  CPPUNIT_TEST(testPack);
+  CPPUNIT_TEST(testPackResponse);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMFrameViewTest()
+      : m_source(1, 2),
+        m_destination(3, 4) {
+  }
+
+  void testParse();
+  void testParseErrors();
+  void testParseFrame();
+  void testPack();
+  void testPackResponse();
+
+ private:
+  UID m_source;
+  UID m_destination;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMFrameViewTest);
+
+namespace {
+const uint8_t PARAM_DATA[] = {0x5a, 0xa5, 0x00, 0xff};
+}  // namespace
+
+
+/*
+ * Check a serialized RDMCommand can be viewed.
+ */
+void RDMFrameViewTest::testParse() {
+  RDMSetRequest request(m_source, m_destination, 7, 1, 10, 0x1234,
+                        PARAM_DATA, arraysize(PARAM_DATA));
+  ByteString data;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, &data));
+
+  RDMFrameView view;
+  OLA_ASSERT_FALSE(view.IsValid());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                view.Parse(data.data(), data.size()));
+  OLA_ASSERT_TRUE(view.IsValid());
+  OLA_ASSERT_EQ(m_source, view.SourceUID());
+  OLA_ASSERT_EQ(m_destination, view.DestinationUID());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(7), view.TransactionNumber());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), view.PortIdResponseType());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), view.MessageCount());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(10), view.SubDevice());
+  OLA_ASSERT_EQ(RDMCommand::SET_COMMAND, view.CommandClass());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x1234), view.ParamId());
+  OLA_ASSERT_EQ(request.MessageLength(), view.MessageLength());
+  OLA_ASSERT_DATA_EQUALS(PARAM_DATA, arraysize(PARAM_DATA),
+                         view.ParamData(), view.ParamDataSize());
+
+  // the view points at the data, rather than copying it
+  OLA_ASSERT_EQ(data.data(), view.Data());
+  OLA_ASSERT_EQ(data.data() + sizeof(ola::rdm::RDMCommandHeader),
+                view.ParamData());
+  OLA_ASSERT_EQ(static_cast<unsigned int>(data.size()), view.Size());
+
+  struct ola::io::IOVec iov = view.AsIOVec();
+  OLA_ASSERT_EQ(static_cast<void*>(const_cast<uint8_t*>(data.data())),
+                iov.iov_base);
+  OLA_ASSERT_EQ(data.size(), iov.iov_len);
+
+  // trailing bytes aren't part of the message
+  data.push_back(0);
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                view.Parse(data.data(), data.size()));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(data.size() - 1), view.Size());
+
+  // no param data
+  RDMGetRequest get_request(m_source, m_destination, 0, 1, 0, 0x0060,
+                            NULL, 0);
+  data.clear();
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(get_request, &data));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                view.Parse(data.data(), data.size()));
+  OLA_ASSERT_EQ(RDMCommand::GET_COMMAND, view.CommandClass());
+  OLA_ASSERT_EQ(0u, view.ParamDataSize());
+  OLA_ASSERT_NULL(view.ParamData());
+}
+
+
+/*
+ * Check invalid messages are rejected.
+ */
+void RDMFrameViewTest::testParseErrors() {
+  RDMSetRequest request(m_source, m_destination, 7, 1, 10, 0x1234,
+                        PARAM_DATA, arraysize(PARAM_DATA));
+  ByteString data;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, &data));
+
+  RDMFrameView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_PACKET_TOO_SHORT, view.Parse(NULL, 0));
+  OLA_ASSERT_EQ(ola::rdm::RDM_PACKET_TOO_SHORT, view.Parse(data.data(), 10));
+  OLA_ASSERT_EQ(ola::rdm::RDM_PACKET_LENGTH_MISMATCH,
+                view.Parse(data.data(), data.size() - 1));
+
+  ByteString bad_data(data);
+  bad_data[0] = 0x02;
+  OLA_ASSERT_EQ(ola::rdm::RDM_WRONG_SUB_START_CODE,
+                view.Parse(bad_data.data(), bad_data.size()));
+
+  bad_data = data;
+  bad_data[bad_data.size() - 1]++;
+  OLA_ASSERT_EQ(ola::rdm::RDM_CHECKSUM_INCORRECT,
+                view.Parse(bad_data.data(), bad_data.size()));
+
+  // the param data length doesn't match the message length
+  bad_data = data;
+  bad_data[sizeof(ola::rdm::RDMCommandHeader) - 1]--;
+  OLA_ASSERT_EQ(ola::rdm::RDM_PARAM_LENGTH_MISMATCH,
+                view.Parse(bad_data.data(), bad_data.size()));
+
+  // a message length too small to hold the checksum
+  bad_data = data;
+  bad_data[1] = 0;
+  OLA_ASSERT_EQ(ola::rdm::RDM_PARAM_LENGTH_MISMATCH,
+                view.Parse(bad_data.data(), bad_data.size()));
+
+  // a failed parse resets the view
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                view.Parse(data.data(), data.size()));
+  OLA_ASSERT_TRUE(view.IsValid());
+  OLA_ASSERT_EQ(ola::rdm::RDM_PARAM_LENGTH_MISMATCH,
+                view.Parse(bad_data.data(), bad_data.size()));
+  OLA_ASSERT_FALSE(view.IsValid());
+}
+
+
+/*
+ * Check we can view the message in a RDMFrame.
+ */
+void RDMFrameViewTest::testParseFrame() {
+  RDMGetRequest request(m_source, m_destination, 0, 1, 0, 0x0060, NULL, 0);
+  ByteString data;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::PackWithStartCode(request, &data));
+  RDMFrame frame(data);
+
+  RDMFrameView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, view.Parse(frame));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x0060), view.ParamId());
+  OLA_ASSERT_EQ(frame.data.data() + 1, view.Data());
+
+  frame.data[0] = 0xfe;
+  OLA_ASSERT_EQ(ola::rdm::RDM_INVALID_RESPONSE, view.Parse(frame));
+  OLA_ASSERT_FALSE(view.IsValid());
+
+  frame.data.clear();
+  OLA_ASSERT_EQ(ola::rdm::RDM_PACKET_TOO_SHORT, view.Parse(frame));
+}
+
+
+/*
+ * Check Pack() matches the RDMCommandSerializer.
+ */
+void RDMFrameViewTest::testPack() {
+  RDMSetRequest request(m_source, m_destination, 7, 1, 10, 0x1234,
+                        PARAM_DATA, arraysize(PARAM_DATA));
+  ByteString expected;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, &expected));
+
+  uint8_t buffer[RDMFrameView::MAX_MESSAGE_SIZE];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMFrameView::Pack(
+      m_source, m_destination, 7, 1, 0, 10, RDMCommand::SET_COMMAND, 0x1234,
+      PARAM_DATA, arraysize(PARAM_DATA), buffer, &size));
+  OLA_ASSERT_DATA_EQUALS(expected.data(), expected.size(), buffer, size);
+
+  auto_ptr<RDMCommand> command(RDMCommand::Inflate(buffer, size));
+  OLA_ASSERT_NOT_NULL(command.get());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x1234), command->ParamId());
+
+  // the buffer is too small
+  size = expected.size() - 1;
+  OLA_ASSERT_FALSE(RDMFrameView::Pack(
+      m_source, m_destination, 7, 1, 0, 10, RDMCommand::SET_COMMAND, 0x1234,
+      PARAM_DATA, arraysize(PARAM_DATA), buffer, &size));
+
+  // the largest message
+  uint8_t param_data[RDMCommandSerializer::MAX_PARAM_DATA_LENGTH + 1];
+  memset(param_data, 0xff, sizeof(param_data));
+  size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMFrameView::Pack(
+      m_source, m_destination, 7, 1, 0, 10, RDMCommand::SET_COMMAND, 0x1234,
+      param_data, RDMCommandSerializer::MAX_PARAM_DATA_LENGTH, buffer, &size));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(RDMFrameView::MAX_MESSAGE_SIZE),
+                size);
+  RDMFrameView view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, view.Parse(buffer, size));
+
+  size = sizeof(buffer);
+  OLA_ASSERT_FALSE(RDMFrameView::Pack(
+      m_source, m_destination, 7, 1, 0, 10, RDMCommand::SET_COMMAND, 0x1234,
+      param_data, sizeof(param_data), buffer, &size));
+}
+
+
+/*
+ * Check PackResponse() matches GetResponseFromData().
+ */
+void RDMFrameViewTest::testPackResponse() {
+  RDMGetRequest request(m_source, m_destination, 7, 1, 10, 0x1234, NULL, 0);
+  ByteString request_data;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(request, &request_data));
+  RDMFrameView request_view;
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                request_view.Parse(request_data.data(), request_data.size()));
+
+  auto_ptr<RDMResponse> response(GetResponseFromData(
+      &request, PARAM_DATA, arraysize(PARAM_DATA), ola::rdm::RDM_ACK, 2));
+  ByteString expected;
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(*response, &expected));
+
+  uint8_t buffer[RDMFrameView::MAX_MESSAGE_SIZE];
+  unsigned int size = sizeof(buffer);
+  OLA_ASSERT_TRUE(RDMFrameView::PackResponse(
+      request_view, ola::rdm::RDM_ACK, PARAM_DATA, arraysize(PARAM_DATA),
+      buffer, &size, 2));
+  OLA_ASSERT_DATA_EQUALS(expected.data(), expected.size(), buffer, size);
+
+  // DISCOVERY requests and empty views can't be responded to
+  ola::rdm::RDMDiscoveryRequest discovery(
+      m_source, m_destination, 7, 1, 0, ola::rdm::PID_DISC_MUTE, NULL, 0);
+  request_data.clear();
+  OLA_ASSERT_TRUE(RDMCommandSerializer::Pack(discovery, &request_data));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK,
+                request_view.Parse(request_data.data(), request_data.size()));
+  size = sizeof(buffer);
+  OLA_ASSERT_FALSE(RDMFrameView::PackResponse(
+      request_view, ola::rdm::RDM_ACK, NULL, 0, buffer, &size));
+  OLA_ASSERT_FALSE(RDMFrameView::PackResponse(
+      RDMFrameView(), ola::rdm::RDM_ACK, NULL, 0, buffer, &size));
+}
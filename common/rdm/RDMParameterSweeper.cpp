@@ -0,0 +1,375 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMParameterSweeper.cpp
+ * Fetch a set of PIDs from a set of devices.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMParameterSweeper.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+
+namespace ola {
+namespace rdm {
+
+using std::string;
+using std::vector;
+
+const unsigned int RDMParameterSweeper::DEFAULT_MAX_IN_FLIGHT;
+const char RDMParameterSweeper::SWEEP_CANCELLED[] = "Sweep cancelled";
+// How many times we'll ask for a queued message, while waiting for the
+// response to a GET that was ACK_TIMER'ed.
+const unsigned int RDMParameterSweeper::MAX_QUEUED_MESSAGE_FETCHES = 10;
+
+SweepResult::SweepResult(const UID &uid, uint16_t pid)
+    : uid(uid),
+      pid(pid) {
+  status.response_code = RDM_FAILED_TO_SEND;
+  status.response_type = RDM_ACK;
+  status.message_count = 0;
+  status.m_param = 0;
+  status.set_command = false;
+  status.pid_value = pid;
+}
+
+RDMParameterSweeper::RDMParameterSweeper(
+    RDMAPIImplInterface *impl,
+    ola::thread::SchedulerInterface *scheduler,
+    unsigned int max_in_flight)
+    : m_impl(impl),
+      m_scheduler(scheduler),
+      m_max_in_flight(max_in_flight ? max_in_flight : 1),
+      m_next_sweep_id(0) {
+}
+
+RDMParameterSweeper::~RDMParameterSweeper() {
+  TimeoutMap::iterator timeout_iter = m_timeouts.begin();
+  for (; timeout_iter != m_timeouts.end(); ++timeout_iter) {
+    m_scheduler->RemoveTimeout(timeout_iter->second);
+    delete timeout_iter->first;
+  }
+  m_timeouts.clear();
+
+  UniverseMap::iterator universe_iter = m_universes.begin();
+  for (; universe_iter != m_universes.end(); ++universe_iter) {
+    STLDeleteElements(&universe_iter->second.pending);
+  }
+
+  SweepMap::iterator sweep_iter = m_sweeps.begin();
+  for (; sweep_iter != m_sweeps.end(); ++sweep_iter) {
+    delete sweep_iter->second->callback;
+    delete sweep_iter->second;
+  }
+}
+
+RDMParameterSweeper::SweepId RDMParameterSweeper::Sweep(
+    unsigned int universe,
+    const UIDSet &uids,
+    const vector<uint16_t> &pids,
+    SweepCallback *callback) {
+  const SweepId id = ++m_next_sweep_id;
+  if (uids.Empty() || pids.empty()) {
+    callback->Run(SweepResults());
+    return id;
+  }
+
+  SweepState *sweep = new SweepState();
+  sweep->id = id;
+  sweep->universe = universe;
+  sweep->cancelled = false;
+  sweep->callback = callback;
+  sweep->results.reserve(uids.Size() * pids.size());
+  for (UIDSet::Iterator iter = uids.Begin(); iter != uids.End(); ++iter) {
+    vector<uint16_t>::const_iterator pid_iter = pids.begin();
+    for (; pid_iter != pids.end(); ++pid_iter) {
+      sweep->results.push_back(SweepResult(*iter, *pid_iter));
+    }
+  }
+  sweep->done.assign(sweep->results.size(), false);
+  sweep->outstanding = sweep->results.size();
+  sweep->live_requests = sweep->results.size();
+  m_sweeps[id] = sweep;
+
+  UniverseQueue &queue = m_universes[universe];
+  for (unsigned int i = 0; i < sweep->results.size(); i++) {
+    Request *request = new Request();
+    request->sweep = sweep;
+    request->index = i;
+    request->queued_message = false;
+    request->queued_message_fetches = 0;
+    queue.pending.push_back(request);
+  }
+  Dispatch(universe);
+  return id;
+}
+
+bool RDMParameterSweeper::Cancel(SweepId id) {
+  SweepState *sweep = STLFindOrNull(m_sweeps, id);
+  if (!sweep || sweep->cancelled || !sweep->callback) {
+    return false;
+  }
+  sweep->cancelled = true;
+  // Hold a reference, so the sweep isn't deleted as the requests go.
+  sweep->live_requests++;
+
+  std::deque<Request*> &pending = m_universes[sweep->universe].pending;
+  std::deque<Request*>::iterator iter = pending.begin();
+  while (iter != pending.end()) {
+    if ((*iter)->sweep == sweep) {
+      FinishRequest(*iter);
+      iter = pending.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  TimeoutMap::iterator timeout_iter = m_timeouts.begin();
+  while (timeout_iter != m_timeouts.end()) {
+    if (timeout_iter->first->sweep == sweep) {
+      m_scheduler->RemoveTimeout(timeout_iter->second);
+      FinishRequest(timeout_iter->first);
+      m_timeouts.erase(timeout_iter++);
+    } else {
+      ++timeout_iter;
+    }
+  }
+
+  // The GETs in flight see the sweep is cancelled when they complete.
+  for (unsigned int i = 0; i < sweep->results.size(); i++) {
+    if (!sweep->done[i]) {
+      ResponseStatus status = sweep->results[i].status;
+      status.error = SWEEP_CANCELLED;
+      status.response_code = RDM_FAILED_TO_SEND;
+      FillResult(sweep, i, status, "");
+    }
+  }
+  ReleaseSweep(sweep);
+  return true;
+}
+
+unsigned int RDMParameterSweeper::QueuedRequests(unsigned int universe) const {
+  UniverseMap::const_iterator iter = m_universes.find(universe);
+  if (iter == m_universes.end()) {
+    return 0;
+  }
+  return iter->second.pending.size() + iter->second.in_flight;
+}
+
+/*
+ * Send requests until we hit the in-flight limit.
+ */
+void RDMParameterSweeper::Dispatch(unsigned int universe) {
+  UniverseQueue &queue = m_universes[universe];
+  // Responses can arrive before RDMGet() returns, don't recurse.
+  if (queue.dispatching) {
+    return;
+  }
+
+  queue.dispatching = true;
+  while (queue.in_flight < m_max_in_flight && !queue.pending.empty()) {
+    Request *request = queue.pending.front();
+    queue.pending.pop_front();
+    if (request->sweep->done[request->index]) {
+      // The response arrived as a queued message for another request.
+      FinishRequest(request);
+    } else {
+      SendRequest(&queue, request);
+    }
+  }
+  queue.dispatching = false;
+}
+
+void RDMParameterSweeper::SendRequest(UniverseQueue *queue,
+                                      Request *request) {
+  SweepState *sweep = request->sweep;
+  const SweepResult &result = sweep->results[request->index];
+  RDMAPIImplInterface::rdm_pid_callback *callback = NewSingleCallback(
+      this, &RDMParameterSweeper::HandleResponse, request);
+
+  queue->in_flight++;
+  bool ok;
+  if (request->queued_message) {
+    uint8_t status_type = STATUS_ERROR;
+    ok = m_impl->RDMGet(callback, sweep->universe, result.uid,
+                        ROOT_RDM_DEVICE, PID_QUEUED_MESSAGE, &status_type,
+                        sizeof(status_type));
+  } else {
+    ok = m_impl->RDMGet(callback, sweep->universe, result.uid,
+                        ROOT_RDM_DEVICE, result.pid);
+  }
+
+  if (!ok) {
+    delete callback;
+    queue->in_flight--;
+    ResponseStatus status = result.status;
+    status.error = "Failed to send RDM request";
+    status.response_code = RDM_FAILED_TO_SEND;
+    FillResult(sweep, request->index, status, "");
+    FinishRequest(request);
+  }
+}
+
+void RDMParameterSweeper::HandleResponse(Request *request,
+                                         const ResponseStatus &status,
+                                         uint16_t pid,
+                                         const string &data) {
+  const unsigned int universe = request->sweep->universe;
+  m_universes[universe].in_flight--;
+
+  if (request->sweep->cancelled) {
+    FinishRequest(request);
+  } else if (request->queued_message) {
+    HandleQueuedMessage(request, status, pid, data);
+  } else if (status.error.empty() &&
+             status.response_code == RDM_COMPLETED_OK &&
+             status.response_type == RDM_ACK_TIMER) {
+    WaitForAckTimer(request, status);
+  } else {
+    FillResult(request->sweep, request->index, status, data);
+    FinishRequest(request);
+  }
+  Dispatch(universe);
+}
+
+/*
+ * Handle the response to a GET QUEUED_MESSAGE.
+ */
+void RDMParameterSweeper::HandleQueuedMessage(Request *request,
+                                              const ResponseStatus &status,
+                                              uint16_t pid,
+                                              const string &data) {
+  SweepState *sweep = request->sweep;
+  const SweepResult &result = sweep->results[request->index];
+
+  if (!status.error.empty() || status.response_code != RDM_COMPLETED_OK ||
+      (pid == PID_QUEUED_MESSAGE && status.response_type == RDM_NACK_REASON)) {
+    // Either the transport failed, or the device doesn't do queued messages.
+    FillResult(sweep, request->index, status, data);
+    FinishRequest(request);
+    return;
+  }
+
+  if (status.response_type == RDM_ACK_TIMER) {
+    if (++request->queued_message_fetches < MAX_QUEUED_MESSAGE_FETCHES) {
+      WaitForAckTimer(request, status);
+    } else {
+      FillResult(sweep, request->index, status, data);
+      FinishRequest(request);
+    }
+    return;
+  }
+
+  if (pid == result.pid) {
+    FillResult(sweep, request->index, status, data);
+    FinishRequest(request);
+    return;
+  }
+
+  // This may be the deferred response to another GET to the same device.
+  for (unsigned int i = 0; i < sweep->results.size(); i++) {
+    const SweepResult &other = sweep->results[i];
+    if (!sweep->done[i] && other.uid == result.uid && other.pid == pid &&
+        other.status.response_type == RDM_ACK_TIMER) {
+      FillResult(sweep, i, status, data);
+      break;
+    }
+  }
+
+  // An empty STATUS_MESSAGES means there is nothing left in the queue.
+  bool queue_empty = pid == PID_STATUS_MESSAGES && data.empty();
+  if (queue_empty ||
+      ++request->queued_message_fetches >= MAX_QUEUED_MESSAGE_FETCHES) {
+    OLA_INFO << "Gave up waiting for the queued response to PID "
+             << strings::ToHex(result.pid) << " from " << result.uid;
+    // Report the ACK_TIMER.
+    ResponseStatus ack_timer_status = result.status;
+    FillResult(sweep, request->index, ack_timer_status, "");
+    FinishRequest(request);
+    return;
+  }
+  m_universes[sweep->universe].pending.push_front(request);
+}
+
+void RDMParameterSweeper::WaitForAckTimer(Request *request,
+                                          const ResponseStatus &status) {
+  // Keep the ACK_TIMER status, in case we never get the real response.
+  request->sweep->results[request->index].status = status;
+  request->queued_message = true;
+  m_timeouts[request] = m_scheduler->RegisterSingleTimeout(
+      status.AckTimer(),
+      NewSingleCallback(this, &RDMParameterSweeper::AckTimerExpired,
+                        request));
+}
+
+void RDMParameterSweeper::AckTimerExpired(Request *request) {
+  m_timeouts.erase(request);
+  if (request->sweep->done[request->index]) {
+    FinishRequest(request);
+    return;
+  }
+
+  const unsigned int universe = request->sweep->universe;
+  // The device is ready, so skip ahead of the GETs which haven't been sent.
+  m_universes[universe].pending.push_front(request);
+  Dispatch(universe);
+}
+
+/*
+ * Store the result of a GET, and run the callback if that was the last one.
+ * @returns false if the result was already stored.
+ */
+bool RDMParameterSweeper::FillResult(SweepState *sweep,
+                                     unsigned int index,
+                                     const ResponseStatus &status,
+                                     const string &data) {
+  if (sweep->done[index]) {
+    return false;
+  }
+
+  SweepResult &result = sweep->results[index];
+  result.status = status;
+  result.data = data;
+  sweep->done[index] = true;
+  if (--sweep->outstanding == 0) {
+    SweepCallback *callback = sweep->callback;
+    sweep->callback = NULL;
+    callback->Run(sweep->results);
+  }
+  return true;
+}
+
+void RDMParameterSweeper::FinishRequest(Request *request) {
+  SweepState *sweep = request->sweep;
+  delete request;
+  ReleaseSweep(sweep);
+}
+
+void RDMParameterSweeper::ReleaseSweep(SweepState *sweep) {
+  if (--sweep->live_requests == 0) {
+    m_sweeps.erase(sweep->id);
+    delete sweep;
+  }
+}
+}  // namespace rdm
+}  // namespace ola
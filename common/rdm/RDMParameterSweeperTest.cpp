@@ -0,0 +1,497 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMParameterSweeperTest.cpp
+ * Test fixture for the RDMParameterSweeper class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/rdm/RDMAPIImplInterface.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMParameterSweeper.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/SchedulerInterface.h"
+
+using ola::NewSingleCallback;
+using ola::rdm::RDMAPIImplInterface;
+using ola::rdm::RDMParameterSweeper;
+using ola::rdm::ResponseStatus;
+using ola::rdm::SweepResult;
+using ola::rdm::SweepResults;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using ola::thread::timeout_id;
+using std::deque;
+using std::string;
+using std::vector;
+
+namespace {
+
+const unsigned int UNIVERSE = 1;
+const uint16_t DEVICE_LABEL = ola::rdm::PID_DEVICE_LABEL;
+const uint16_t DEVICE_INFO = ola::rdm::PID_DEVICE_INFO;
+const uint16_t QUEUED_MESSAGE = ola::rdm::PID_QUEUED_MESSAGE;
+
+/*
+ * Holds on to the GETs until the test responds to them.
+ */
+class MockRDMAPIImpl: public RDMAPIImplInterface {
+ public:
+  struct Request {
+    rdm_pid_callback *callback;
+    UID uid;
+    uint16_t pid;
+    string data;
+  };
+
+  ~MockRDMAPIImpl() {
+    deque<Request>::iterator iter = requests.begin();
+    for (; iter != requests.end(); ++iter) {
+      delete iter->callback;
+    }
+  }
+
+  bool RDMGet(rdm_callback*, unsigned int, const UID&, uint16_t, uint16_t,
+              const uint8_t*, unsigned int) {
+    CPPUNIT_FAIL("Unexpected RDMGet() call");
+    return false;
+  }
+
+  bool RDMGet(rdm_pid_callback *callback,
+              unsigned int universe,
+              const UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data,
+              unsigned int data_length) {
+    OLA_ASSERT_EQ(UNIVERSE, universe);
+    OLA_ASSERT_EQ(ola::rdm::ROOT_RDM_DEVICE, sub_device);
+    Request request = {
+      callback, uid, pid,
+      string(reinterpret_cast<const char*>(data), data_length)
+    };
+    requests.push_back(request);
+    return true;
+  }
+
+  bool RDMSet(rdm_callback*, unsigned int, const UID&, uint16_t, uint16_t,
+              const uint8_t*, unsigned int) {
+    CPPUNIT_FAIL("Unexpected RDMSet() call");
+    return false;
+  }
+
+  Request Pop() {
+    OLA_ASSERT_FALSE(requests.empty());
+    Request request = requests.front();
+    requests.pop_front();
+    return request;
+  }
+
+  /*
+   * Respond to the oldest request.
+   */
+  void Respond(uint8_t response_type, uint16_t pid, const string &data,
+               uint16_t param = 0) {
+    Request request = Pop();
+    ResponseStatus status;
+    status.response_code = ola::rdm::RDM_COMPLETED_OK;
+    status.response_type = response_type;
+    status.message_count = 0;
+    status.m_param = param;
+    status.set_command = false;
+    status.pid_value = pid;
+    request.callback->Run(status, pid, data);
+  }
+
+  deque<Request> requests;
+};
+
+
+/*
+ * Records single timeouts, so the test can run them.
+ */
+class MockScheduler: public ola::thread::SchedulerInterface {
+ public:
+  struct Timeout {
+    unsigned int delay;
+    ola::SingleUseCallback0<void> *callback;
+  };
+
+  ~MockScheduler() {
+    deque<Timeout*>::iterator iter = timeouts.begin();
+    for (; iter != timeouts.end(); ++iter) {
+      delete (*iter)->callback;
+    }
+    ola::STLDeleteElements(&timeouts);
+  }
+
+  timeout_id RegisterRepeatingTimeout(unsigned int,
+                                      ola::Callback0<bool>*) {
+    CPPUNIT_FAIL("Unexpected RegisterRepeatingTimeout() call");
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterRepeatingTimeout(const ola::TimeInterval&,
+                                      ola::Callback0<bool>*) {
+    CPPUNIT_FAIL("Unexpected RegisterRepeatingTimeout() call");
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterSingleTimeout(unsigned int delay,
+                                   ola::SingleUseCallback0<void> *callback) {
+    Timeout *timeout = new Timeout();
+    timeout->delay = delay;
+    timeout->callback = callback;
+    timeouts.push_back(timeout);
+    return timeout;
+  }
+
+  timeout_id RegisterSingleTimeout(const ola::TimeInterval &delay,
+                                   ola::SingleUseCallback0<void> *callback) {
+    return RegisterSingleTimeout(delay.InMilliSeconds(), callback);
+  }
+
+  void RemoveTimeout(timeout_id id) {
+    deque<Timeout*>::iterator iter = timeouts.begin();
+    for (; iter != timeouts.end(); ++iter) {
+      if (*iter == id) {
+        delete (*iter)->callback;
+        delete *iter;
+        timeouts.erase(iter);
+        return;
+      }
+    }
+  }
+
+  /*
+   * Run the oldest timeout, and return its delay.
+   */
+  unsigned int RunNext() {
+    OLA_ASSERT_FALSE(timeouts.empty());
+    Timeout *timeout = timeouts.front();
+    timeouts.pop_front();
+    unsigned int delay = timeout->delay;
+    timeout->callback->Run();
+    delete timeout;
+    return delay;
+  }
+
+  deque<Timeout*> timeouts;
+};
+}  // namespace
+
+
+class RDMParameterSweeperTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMParameterSweeperTest);
+  CPPUNIT_TEST(testEmptySweep);
+  CPPUNIT_TEST(testSweep);
+  CPPUNIT_TEST(testAckTimer);
+  CPPUNIT_TEST(testQueuedMessageForAnotherPid);
+  CPPUNIT_TEST(testQueuedMessageNotAvailable);
+  CPPUNIT_TEST(testAbandonedSweep);
+  CPPUNIT_TEST(testCancel);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMParameterSweeperTest()
+      : m_uid1(0x7a70, 1),
+        m_uid2(0x7a70, 2),
+        m_uid3(0x7a70, 3),
+        m_callback_count(0) {
+  }
+
+  void setUp() {
+    m_callback_count = 0;
+    m_results.clear();
+    m_pids.clear();
+    m_pids.push_back(DEVICE_INFO);
+    m_pids.push_back(DEVICE_LABEL);
+  }
+
+  void testEmptySweep();
+  void testSweep();
+  void testAckTimer();
+  void testQueuedMessageForAnotherPid();
+  void testQueuedMessageNotAvailable();
+  void testAbandonedSweep();
+  void testCancel();
+
+  void SweepComplete(const SweepResults &results) {
+    m_callback_count++;
+    m_results = results;
+  }
+
+ private:
+  UID m_uid1, m_uid2, m_uid3;
+  vector<uint16_t> m_pids;
+  unsigned int m_callback_count;
+  SweepResults m_results;
+
+  RDMParameterSweeper::SweepCallback *NewCallback() {
+    return NewSingleCallback(this, &RDMParameterSweeperTest::SweepComplete);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMParameterSweeperTest);
+
+
+/*
+ * Check a sweep with nothing to do completes straight away.
+ */
+void RDMParameterSweeperTest::testEmptySweep() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler);
+
+  RDMParameterSweeper::SweepId id = sweeper.Sweep(UNIVERSE, UIDSet(), m_pids,
+                                                  NewCallback());
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_TRUE(m_results.empty());
+  OLA_ASSERT_TRUE(impl.requests.empty());
+  OLA_ASSERT_FALSE(sweeper.Cancel(id));
+}
+
+
+/*
+ * Check the GETs are limited to max_in_flight, and the results are in order.
+ */
+void RDMParameterSweeperTest::testSweep() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler, 2);
+
+  UIDSet uids;
+  uids.AddUID(m_uid3);
+  uids.AddUID(m_uid1);
+  uids.AddUID(m_uid2);
+  sweeper.Sweep(UNIVERSE, uids, m_pids, NewCallback());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), impl.requests.size());
+  OLA_ASSERT_EQ(6u, sweeper.QueuedRequests(UNIVERSE));
+  OLA_ASSERT_EQ(0u, sweeper.QueuedRequests(UNIVERSE + 1));
+
+  // responses can arrive in any order
+  MockRDMAPIImpl::Request request = impl.Pop();
+  impl.requests.push_back(request);
+  OLA_ASSERT_EQ(m_uid1, impl.requests[0].uid);
+  OLA_ASSERT_EQ(DEVICE_LABEL, impl.requests[0].pid);
+
+  for (unsigned int i = 0; i < 6; i++) {
+    OLA_ASSERT_EQ(0u, m_callback_count);
+    OLA_ASSERT_TRUE(impl.requests.size() <= 2);
+    const MockRDMAPIImpl::Request &next = impl.requests.front();
+    if (next.uid == m_uid2 && next.pid == DEVICE_LABEL) {
+      impl.Respond(ola::rdm::RDM_NACK_REASON, next.pid, "",
+                   ola::rdm::NR_UNKNOWN_PID);
+    } else {
+      impl.Respond(ola::rdm::RDM_ACK, next.pid, next.uid.ToString());
+    }
+  }
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_TRUE(impl.requests.empty());
+  OLA_ASSERT_EQ(0u, sweeper.QueuedRequests(UNIVERSE));
+
+  OLA_ASSERT_EQ(static_cast<size_t>(6), m_results.size());
+  const UID expected_uids[] = {m_uid1, m_uid1, m_uid2, m_uid2, m_uid3, m_uid3};
+  for (unsigned int i = 0; i < m_results.size(); i++) {
+    const SweepResult &result = m_results[i];
+    OLA_ASSERT_EQ(expected_uids[i], result.uid);
+    OLA_ASSERT_EQ(m_pids[i % 2], result.pid);
+    if (i == 3) {
+      OLA_ASSERT_TRUE(result.status.WasNacked());
+      OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::NR_UNKNOWN_PID),
+                    result.status.NackReason());
+    } else {
+      OLA_ASSERT_TRUE(result.status.WasAcked());
+      OLA_ASSERT_EQ(result.uid.ToString(), result.data);
+    }
+  }
+}
+
+
+/*
+ * Check an ACK_TIMER is followed by GET QUEUED_MESSAGE.
+ */
+void RDMParameterSweeperTest::testAckTimer() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler, 1);
+
+  UIDSet uids;
+  uids.AddUID(m_uid1);
+  sweeper.Sweep(UNIVERSE, uids, m_pids, NewCallback());
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_INFO, "", 5);
+
+  // the slot is free while we wait
+  OLA_ASSERT_EQ(static_cast<size_t>(1), impl.requests.size());
+  OLA_ASSERT_EQ(DEVICE_LABEL, impl.requests.front().pid);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), scheduler.timeouts.size());
+  OLA_ASSERT_EQ(500u, scheduler.RunNext());
+
+  // the queued message waits for the in-flight GET
+  OLA_ASSERT_EQ(static_cast<size_t>(1), impl.requests.size());
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_LABEL, "label");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), impl.requests.size());
+  OLA_ASSERT_EQ(QUEUED_MESSAGE, impl.requests.front().pid);
+  OLA_ASSERT_EQ(string(1, ola::rdm::STATUS_ERROR),
+                impl.requests.front().data);
+
+  // the device is still busy
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, ola::rdm::PID_QUEUED_MESSAGE, "", 1);
+  OLA_ASSERT_EQ(100u, scheduler.RunNext());
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_INFO, "info");
+
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+  OLA_ASSERT_TRUE(m_results[0].status.WasAcked());
+  OLA_ASSERT_EQ(string("info"), m_results[0].data);
+  OLA_ASSERT_TRUE(m_results[1].status.WasAcked());
+  OLA_ASSERT_EQ(string("label"), m_results[1].data);
+}
+
+
+/*
+ * Check a queued message for a different PID from the sweep is used.
+ */
+void RDMParameterSweeperTest::testQueuedMessageForAnotherPid() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler);
+
+  UIDSet uids;
+  uids.AddUID(m_uid1);
+  sweeper.Sweep(UNIVERSE, uids, m_pids, NewCallback());
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_INFO, "", 1);
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_LABEL, "", 2);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), scheduler.timeouts.size());
+
+  // The DEVICE_INFO timer fires, but the device returns the DEVICE_LABEL
+  // response first.
+  scheduler.RunNext();
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_LABEL, "label");
+  OLA_ASSERT_EQ(QUEUED_MESSAGE, impl.requests.front().pid);
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_INFO, "info");
+
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_EQ(string("info"), m_results[0].data);
+  OLA_ASSERT_EQ(string("label"), m_results[1].data);
+
+  // when the DEVICE_LABEL timer fires there's nothing to send
+  scheduler.RunNext();
+  OLA_ASSERT_TRUE(impl.requests.empty());
+  OLA_ASSERT_EQ(1u, m_callback_count);
+}
+
+
+/*
+ * Check we give up if the device has nothing queued.
+ */
+void RDMParameterSweeperTest::testQueuedMessageNotAvailable() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler);
+
+  UIDSet uids;
+  uids.AddUID(m_uid1);
+  m_pids.pop_back();
+  sweeper.Sweep(UNIVERSE, uids, m_pids, NewCallback());
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_INFO, "", 1);
+  scheduler.RunNext();
+  impl.Respond(ola::rdm::RDM_ACK, ola::rdm::PID_STATUS_MESSAGES, "");
+
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  OLA_ASSERT_FALSE(m_results[0].status.WasAcked());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK_TIMER),
+                m_results[0].status.response_type);
+  OLA_ASSERT_TRUE(impl.requests.empty());
+}
+
+
+/*
+ * Check destroying the sweeper mid-sweep cleans up.
+ */
+void RDMParameterSweeperTest::testAbandonedSweep() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+
+  {
+    RDMParameterSweeper sweeper(&impl, &scheduler, 1);
+    UIDSet uids;
+    uids.AddUID(m_uid1);
+    sweeper.Sweep(UNIVERSE, uids, m_pids, NewCallback());
+    impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_INFO, "", 1);
+    impl.Respond(ola::rdm::RDM_ACK, DEVICE_LABEL, "label");
+    OLA_ASSERT_EQ(static_cast<size_t>(1), scheduler.timeouts.size());
+    OLA_ASSERT_EQ(0u, sweeper.QueuedRequests(UNIVERSE));
+  }
+  OLA_ASSERT_TRUE(scheduler.timeouts.empty());
+  OLA_ASSERT_EQ(0u, m_callback_count);
+}
+
+
+/*
+ * Check cancelling a sweep returns the partial results and stops the GETs.
+ */
+void RDMParameterSweeperTest::testCancel() {
+  MockRDMAPIImpl impl;
+  MockScheduler scheduler;
+  RDMParameterSweeper sweeper(&impl, &scheduler, 2);
+
+  UIDSet uids;
+  uids.AddUID(m_uid1);
+  uids.AddUID(m_uid2);
+  uids.AddUID(m_uid3);
+  RDMParameterSweeper::SweepId id = sweeper.Sweep(UNIVERSE, uids, m_pids,
+                                                  NewCallback());
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_INFO, "info");
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_LABEL, "", 1);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), scheduler.timeouts.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), impl.requests.size());
+  OLA_ASSERT_EQ(4u, sweeper.QueuedRequests(UNIVERSE));
+
+  OLA_ASSERT_TRUE(sweeper.Cancel(id));
+  OLA_ASSERT_FALSE(sweeper.Cancel(id));
+  OLA_ASSERT_EQ(1u, m_callback_count);
+  OLA_ASSERT_TRUE(scheduler.timeouts.empty());
+  // Only the GETs in flight remain.
+  OLA_ASSERT_EQ(2u, sweeper.QueuedRequests(UNIVERSE));
+
+  OLA_ASSERT_EQ(static_cast<size_t>(6), m_results.size());
+  OLA_ASSERT_TRUE(m_results[0].status.WasAcked());
+  OLA_ASSERT_EQ(string("info"), m_results[0].data);
+  for (unsigned int i = 1; i < m_results.size(); i++) {
+    OLA_ASSERT_EQ(ola::rdm::RDM_FAILED_TO_SEND,
+                  m_results[i].status.response_code);
+    OLA_ASSERT_EQ(string(RDMParameterSweeper::SWEEP_CANCELLED),
+                  m_results[i].status.error);
+  }
+
+  // The late responses are dropped, and nothing else is sent.
+  impl.Respond(ola::rdm::RDM_ACK, DEVICE_INFO, "info");
+  impl.Respond(ola::rdm::RDM_ACK_TIMER, DEVICE_LABEL, "", 1);
+  OLA_ASSERT_TRUE(impl.requests.empty());
+  OLA_ASSERT_TRUE(scheduler.timeouts.empty());
+  OLA_ASSERT_EQ(0u, sweeper.QueuedRequests(UNIVERSE));
+  OLA_ASSERT_EQ(1u, m_callback_count);
+}
@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMTimingStats.cpp
+ * Latency and outcome counters for RDM transactions.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <limits>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/RDMTimingStats.h"
+#include "ola/rdm/UID.h"
+
+namespace ola {
+namespace rdm {
+
+using std::string;
+
+namespace {
+uint32_t ClampToUInt(int64_t value) {
+  if (value < 0) {
+    return 0;
+  }
+  const uint32_t max = std::numeric_limits<uint32_t>::max();
+  return value > max ? max : static_cast<uint32_t>(value);
+}
+}  // namespace
+
+bool RDMTimingStats::RecordRequest(const RDMRequest &request) {
+  const UID &uid = request.DestinationUID();
+  if (uid.IsBroadcast() || request.IsDUB()) {
+    return false;
+  }
+
+  const string param_data(reinterpret_cast<const char*>(request.ParamData()),
+                          request.ParamDataSize());
+  Timing &timing = m_responders[uid];
+  LastRequest &last = m_last_requests[uid];
+  if (last.timed_out &&
+      last.command_class == request.CommandClass() &&
+      last.sub_device == request.SubDevice() &&
+      last.param_id == request.ParamId() &&
+      last.param_data == param_data) {
+    timing.retransmits++;
+    m_totals.retransmits++;
+  }
+
+  last.command_class = request.CommandClass();
+  last.sub_device = request.SubDevice();
+  last.param_id = request.ParamId();
+  last.param_data = param_data;
+  last.timed_out = false;
+  timing.requests++;
+  m_totals.requests++;
+  return true;
+}
+
+void RDMTimingStats::RecordReply(const UID &uid, const TimeInterval &latency,
+                                 const RDMReply &reply) {
+  ResponderMap::iterator iter = m_responders.find(uid);
+  if (iter == m_responders.end()) {
+    return;
+  }
+  AddReply(&iter->second, latency, reply);
+  AddReply(&m_totals, latency, reply);
+  m_last_requests[uid].timed_out = reply.StatusCode() == RDM_TIMEOUT;
+}
+
+const RDMTimingStats::Timing *RDMTimingStats::Responder(
+    const UID &uid) const {
+  ResponderMap::const_iterator iter = m_responders.find(uid);
+  return iter == m_responders.end() ? NULL : &iter->second;
+}
+
+void RDMTimingStats::Reset() {
+  m_totals = Timing();
+  m_responders.clear();
+  m_last_requests.clear();
+}
+
+void RDMTimingStats::AddReply(Timing *timing, const TimeInterval &latency,
+                              const RDMReply &reply) {
+  switch (reply.StatusCode()) {
+    case RDM_TIMEOUT:
+      timing->timeouts++;
+      return;
+    case RDM_FAILED_TO_SEND:
+    case RDM_UNKNOWN_UID:
+      // Nothing reached the responder.
+      return;
+    default:
+      break;
+  }
+
+  timing->latency.Add(ClampToUInt(latency.AsInt()));
+  if (reply.Response() && reply.Response()->ResponseType() == RDM_ACK_TIMER) {
+    timing->ack_timers++;
+  }
+
+  // The response time is in nanoseconds.
+  RDMFrames::const_iterator frame = reply.Frames().begin();
+  for (; frame != reply.Frames().end(); ++frame) {
+    if (frame->timing.response_time) {
+      timing->turnaround.Add(frame->timing.response_time / 1000);
+    }
+  }
+}
+}  // namespace rdm
+}  // namespace ola
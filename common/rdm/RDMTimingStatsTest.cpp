@@ -0,0 +1,170 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMTimingStatsTest.cpp
+ * Test fixture for the RDMTimingStats class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/Clock.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMFrame.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/RDMTimingStats.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::TimeInterval;
+using ola::rdm::RDMFrame;
+using ola::rdm::RDMFrames;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMGetResponse;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMTimingStats;
+using ola::rdm::UID;
+
+class RDMTimingStatsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMTimingStatsTest);
+  CPPUNIT_TEST(testOutcomes);
+  CPPUNIT_TEST(testRetransmits);
+  CPPUNIT_TEST(testUntracked);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMTimingStatsTest()
+      : m_source(1, 2),
+        m_destination(3, 4) {
+  }
+
+  void testOutcomes();
+  void testRetransmits();
+  void testUntracked();
+
+ private:
+  UID m_source;
+  UID m_destination;
+
+  bool Send(RDMTimingStats *stats, const UID &destination,
+            uint16_t pid) const {
+    RDMGetRequest request(m_source, destination, 0, 1, 0, pid, NULL, 0);
+    return stats->RecordRequest(request);
+  }
+
+  RDMGetResponse *Response(uint8_t response_type) const {
+    return new RDMGetResponse(m_destination, m_source, 0, response_type, 0, 0,
+                              0x60, NULL, 0);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMTimingStatsTest);
+
+
+/*
+ * Check ACKs, ACK_TIMERs and timeouts are counted.
+ */
+void RDMTimingStatsTest::testOutcomes() {
+  RDMTimingStats stats;
+  UID other(3, 5);
+
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x60));
+  RDMFrame frame(NULL, 0);
+  frame.timing.response_time = 176000;
+  RDMFrames frames;
+  frames.push_back(frame);
+  RDMReply ack(ola::rdm::RDM_COMPLETED_OK, Response(ola::rdm::RDM_ACK),
+               frames);
+  stats.RecordReply(m_destination, TimeInterval(0, 1500), ack);
+
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x60));
+  RDMReply ack_timer(ola::rdm::RDM_COMPLETED_OK,
+                     Response(ola::rdm::RDM_ACK_TIMER));
+  stats.RecordReply(m_destination, TimeInterval(0, 2500), ack_timer);
+
+  OLA_ASSERT_TRUE(Send(&stats, other, 0x60));
+  RDMReply timeout(ola::rdm::RDM_TIMEOUT);
+  stats.RecordReply(other, TimeInterval(0, 30000), timeout);
+
+  const RDMTimingStats::Timing *timing = stats.Responder(m_destination);
+  OLA_ASSERT_NOT_NULL(timing);
+  OLA_ASSERT_EQ(2u, timing->requests);
+  OLA_ASSERT_EQ(0u, timing->timeouts);
+  OLA_ASSERT_EQ(1u, timing->ack_timers);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), timing->latency.Count());
+  OLA_ASSERT_EQ(2500u, timing->latency.Max());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), timing->turnaround.Count());
+  OLA_ASSERT_EQ(176u, timing->turnaround.Max());
+
+  // Timeouts don't contribute to the latency.
+  timing = stats.Responder(other);
+  OLA_ASSERT_NOT_NULL(timing);
+  OLA_ASSERT_EQ(1u, timing->requests);
+  OLA_ASSERT_EQ(1u, timing->timeouts);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), timing->latency.Count());
+
+  OLA_ASSERT_EQ(3u, stats.Totals().requests);
+  OLA_ASSERT_EQ(1u, stats.Totals().timeouts);
+  OLA_ASSERT_EQ(1u, stats.Totals().ack_timers);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), stats.Totals().latency.Count());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), stats.Responders().size());
+
+  stats.Reset();
+  OLA_ASSERT_EQ(0u, stats.Totals().requests);
+  OLA_ASSERT_TRUE(stats.Responders().empty());
+}
+
+
+/*
+ * Check only repeats of a request that timed out count as retransmits.
+ */
+void RDMTimingStatsTest::testRetransmits() {
+  RDMTimingStats stats;
+  RDMReply timeout(ola::rdm::RDM_TIMEOUT);
+
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x60));
+  stats.RecordReply(m_destination, TimeInterval(0, 100), timeout);
+  // a different PID isn't a retransmit
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x80));
+  stats.RecordReply(m_destination, TimeInterval(0, 100), timeout);
+  OLA_ASSERT_EQ(0u, stats.Totals().retransmits);
+
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x80));
+  OLA_ASSERT_EQ(1u, stats.Totals().retransmits);
+  RDMReply ack(ola::rdm::RDM_COMPLETED_OK, Response(ola::rdm::RDM_ACK));
+  stats.RecordReply(m_destination, TimeInterval(0, 100), ack);
+
+  // the last request was answered
+  OLA_ASSERT_TRUE(Send(&stats, m_destination, 0x80));
+  OLA_ASSERT_EQ(1u, stats.Totals().retransmits);
+  OLA_ASSERT_EQ(1u, stats.Responder(m_destination)->retransmits);
+}
+
+
+/*
+ * Check broadcasts aren't tracked.
+ */
+void RDMTimingStatsTest::testUntracked() {
+  RDMTimingStats stats;
+  OLA_ASSERT_FALSE(Send(&stats, UID::AllDevices(), 0x60));
+  OLA_ASSERT_FALSE(Send(&stats, UID::VendorcastAddress(3), 0x60));
+  RDMReply reply(ola::rdm::RDM_WAS_BROADCAST);
+  stats.RecordReply(UID::AllDevices(), TimeInterval(0, 100), reply);
+  stats.RecordReply(m_destination, TimeInterval(0, 100), reply);
+  OLA_ASSERT_EQ(0u, stats.Totals().requests);
+  OLA_ASSERT_TRUE(stats.Responders().empty());
+}
@@ -0,0 +1,217 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ResponderOpsTest.cpp
+ * Test fixture for the ResponderOps dispatcher.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <memory>
+
+#include "ola/Callback.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/ResponderHelper.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::ResponderHelper;
+using ola::rdm::ResponderOps;
+using ola::rdm::UID;
+using std::auto_ptr;
+
+namespace {
+
+class TestTarget {
+ public:
+  TestTarget() : m_value(0), m_calls(0) {}
+
+  RDMResponse *GetValue(const RDMRequest *request) {
+    m_calls++;
+    return ResponderHelper::GetUInt8Value(request, m_value);
+  }
+
+  RDMResponse *SetValue(const RDMRequest *request) {
+    m_calls++;
+    return ResponderHelper::SetUInt8Value(request, &m_value);
+  }
+
+  RDMResponse *GetOther(const RDMRequest *request) {
+    m_calls++;
+    return ResponderHelper::GetUInt8Value(request, 42);
+  }
+
+  uint8_t m_value;
+  unsigned int m_calls;
+};
+
+// Deliberately out of order, with DEVICE_LABEL registered twice.
+const ResponderOps<TestTarget>::ParamHandler PARAM_HANDLERS[] = {
+  { ola::rdm::PID_IDENTIFY_DEVICE, &TestTarget::GetValue, NULL},
+  { 0x8001, &TestTarget::GetOther, NULL},
+  { ola::rdm::PID_DEVICE_LABEL, &TestTarget::GetValue, NULL},
+  { ola::rdm::PID_DEVICE_INFO, &TestTarget::GetOther, NULL},
+  { ola::rdm::PID_DEVICE_LABEL, &TestTarget::GetOther,
+    &TestTarget::SetValue},
+  { 0, NULL, NULL},
+};
+}  // namespace
+
+class ResponderOpsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ResponderOpsTest);
+  CPPUNIT_TEST(testDispatch);
+  CPPUNIT_TEST(testUnknownPid);
+  CPPUNIT_TEST(testSupportedParams);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ResponderOpsTest()
+      : m_uid(0x7a70, 1),
+        m_source(1, 2),
+        m_ops(PARAM_HANDLERS) {
+  }
+
+  void testDispatch();
+  void testUnknownPid();
+  void testSupportedParams();
+
+ private:
+  UID m_uid;
+  UID m_source;
+  ResponderOps<TestTarget> m_ops;
+  TestTarget m_target;
+  auto_ptr<RDMResponse> m_response;
+
+  void HandleReply(RDMReply *reply) {
+    OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode());
+    OLA_ASSERT_NOT_NULL(reply->Response());
+    m_response.reset(reply->Response()->Duplicate());
+  }
+
+  void Send(RDMRequest *request) {
+    m_response.reset();
+    m_ops.HandleRDMRequest(
+        &m_target, m_uid, ola::rdm::ROOT_RDM_DEVICE, request,
+        ola::NewSingleCallback(this, &ResponderOpsTest::HandleReply));
+    OLA_ASSERT_NOT_NULL(m_response.get());
+  }
+
+  void CheckNack(ola::rdm::rdm_nack_reason reason) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_NACK_REASON),
+                  m_response->ResponseType());
+    const uint8_t expected[] = {0, static_cast<uint8_t>(reason)};
+    OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                           m_response->ParamData(),
+                           m_response->ParamDataSize());
+  }
+
+  void Get(uint16_t pid) {
+    Send(new RDMGetRequest(m_source, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                           pid, NULL, 0));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponderOpsTest);
+
+
+/*
+ * Check requests are dispatched to the right handler.
+ */
+void ResponderOpsTest::testDispatch() {
+  Get(0x8001);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_response->ResponseType());
+  OLA_ASSERT_EQ(1u, m_response->ParamDataSize());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(42), m_response->ParamData()[0]);
+
+  // The later DEVICE_LABEL entry wins.
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(42), m_response->ParamData()[0]);
+
+  uint8_t value = 7;
+  Send(new RDMSetRequest(m_source, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                         ola::rdm::PID_DEVICE_LABEL, &value, sizeof(value)));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_response->ResponseType());
+  OLA_ASSERT_EQ(value, m_target.m_value);
+
+  Get(ola::rdm::PID_IDENTIFY_DEVICE);
+  OLA_ASSERT_EQ(value, m_response->ParamData()[0]);
+  OLA_ASSERT_EQ(4u, m_target.m_calls);
+
+  // No SET handler for IDENTIFY_DEVICE.
+  Send(new RDMSetRequest(m_source, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                         ola::rdm::PID_IDENTIFY_DEVICE, &value,
+                         sizeof(value)));
+  CheckNack(ola::rdm::NR_UNSUPPORTED_COMMAND_CLASS);
+  OLA_ASSERT_EQ(4u, m_target.m_calls);
+}
+
+
+/*
+ * Check PIDs without a handler are NACKed.
+ */
+void ResponderOpsTest::testUnknownPid() {
+  // Either side of, and between, the registered PIDs.
+  const uint16_t pids[] = {
+    0x0001, ola::rdm::PID_DEVICE_INFO + 1, 0x8000, 0x8002, 0xffff
+  };
+  for (unsigned int i = 0; i < sizeof(pids) / sizeof(pids[0]); i++) {
+    Get(pids[i]);
+    CheckNack(ola::rdm::NR_UNKNOWN_PID);
+  }
+  OLA_ASSERT_EQ(0u, m_target.m_calls);
+}
+
+
+/*
+ * Check SUPPORTED_PARAMETERS lists the handlers in order.
+ */
+void ResponderOpsTest::testSupportedParams() {
+  Get(ola::rdm::PID_SUPPORTED_PARAMETERS);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_response->ResponseType());
+
+  // DEVICE_INFO and IDENTIFY_DEVICE are required, and so not included.
+  const uint8_t expected[] = {0x00, 0x82, 0x80, 0x01};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                         m_response->ParamData(),
+                         m_response->ParamDataSize());
+
+  // With include_required_pids, everything is listed.
+  ResponderOps<TestTarget> ops(PARAM_HANDLERS, true);
+  m_response.reset();
+  ops.HandleRDMRequest(
+      &m_target, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+      new RDMGetRequest(m_source, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                        ola::rdm::PID_SUPPORTED_PARAMETERS, NULL, 0),
+      ola::NewSingleCallback(this, &ResponderOpsTest::HandleReply));
+  OLA_ASSERT_NOT_NULL(m_response.get());
+  const uint8_t expected_all[] = {
+    0x00, 0x50, 0x00, 0x60, 0x00, 0x82, 0x10, 0x00, 0x80, 0x01
+  };
+  OLA_ASSERT_DATA_EQUALS(expected_all, sizeof(expected_all),
+                         m_response->ParamData(),
+                         m_response->ParamDataSize());
+}
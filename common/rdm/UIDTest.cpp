@@ -38,6 +38,7 @@ class UIDTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUIDInequalities);
   CPPUNIT_TEST(testUIDSet);
   CPPUNIT_TEST(testUIDSetUnion);
+  CPPUNIT_TEST(testUIDSetAddUIDs);
   CPPUNIT_TEST(testUIDParse);
   CPPUNIT_TEST(testDirectedToUID);
   CPPUNIT_TEST_SUITE_END();
@@ -47,6 +48,7 @@ class UIDTest: public CppUnit::TestFixture {
     void testUIDInequalities();
     void testUIDSet();
     void testUIDSetUnion();
+    void testUIDSetAddUIDs();
     void testUIDParse();
     void testDirectedToUID();
 };
@@ -252,6 +254,47 @@ void UIDTest::testUIDSetUnion() {
 }
 
 
+/*
+ * Test adding UIDs out of order, and merging sets in place.
+ */
+void UIDTest::testUIDSetAddUIDs() {
+  UID uid(1, 2);
+  UID uid2(2, 10);
+  UID uid3(3, 10);
+  UID uid4(4, 10);
+
+  UIDSet set1;
+  set1.AddUID(uid3);
+  set1.AddUID(uid);
+  set1.AddUID(uid3);
+  OLA_ASSERT_EQ(2u, set1.Size());
+  OLA_ASSERT_EQ(string("0001:00000002,0003:0000000a"), set1.ToString());
+
+  UIDSet set2;
+  set2.AddUID(uid4);
+  set2.AddUID(uid2);
+  set2.AddUID(uid);
+  set1.AddUIDs(set2);
+  OLA_ASSERT_EQ(4u, set1.Size());
+  OLA_ASSERT_EQ(
+      string("0001:00000002,0002:0000000a,0003:0000000a,0004:0000000a"),
+      set1.ToString());
+  OLA_ASSERT_EQ(set1, set1.Union(set2));
+
+  set1.RemoveUID(uid2);
+  set1.RemoveUID(uid2);
+  OLA_ASSERT_EQ(3u, set1.Size());
+  OLA_ASSERT_FALSE(set1.Contains(uid2));
+
+  UIDSet set3;
+  set3.Swap(set1);
+  OLA_ASSERT_TRUE(set1.Empty());
+  OLA_ASSERT_EQ(3u, set3.Size());
+  set1.AddUIDs(set3);
+  OLA_ASSERT_EQ(set3, set1);
+}
+
+
 /*
  * Test UID parsing
  */
@@ -35,6 +35,18 @@ common/rpc/TestService.pb.cc common/rpc/TestService.pb.h: common/rpc/Makefile.mk
 common/rpc/TestServiceService.pb.cpp common/rpc/TestServiceService.pb.h: common/rpc/Makefile.mk common/rpc/TestService.proto protoc/ola_protoc_plugin$(EXEEXT)
 	$(OLA_PROTOC) --cppservice_out common/rpc --proto_path $(srcdir)/common/rpc $(srcdir)/common/rpc/TestService.proto
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/rpc/rpc_benchmark
+
+common_rpc_rpc_benchmark_SOURCES = common/rpc/RpcBenchmark.cpp
+nodist_common_rpc_rpc_benchmark_SOURCES = \
+    common/rpc/TestService.pb.cc \
+    common/rpc/TestServiceService.pb.cpp
+common_rpc_rpc_benchmark_CXXFLAGS = $(COMMON_CXXFLAGS_ONLY_WARNINGS)
+common_rpc_rpc_benchmark_LDADD = common/libolacommon.la \
+                                 $(libprotobuf_LIBS)
+
 # TESTS
 ##################################################
 test_programs += common/rpc/RpcTester common/rpc/RpcServerTester
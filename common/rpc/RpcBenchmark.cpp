@@ -0,0 +1,226 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RpcBenchmark.cpp
+ * Measure the RpcChannel message rate with many channels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
+#include "common/rpc/TestServiceService.pb.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/stl/STLUtils.h"
+
+using ola::Clock;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::SelectServer;
+using ola::io::UnixSocket;
+using ola::rpc::EchoReply;
+using ola::rpc::EchoRequest;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using ola::rpc::STREAMING_NO_RESPONSE;
+using ola::rpc::TestService_Stub;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(channels, c, 100, "The number of channels to use");
+DEFINE_s_uint32(messages, m, 10000, "The number of messages per channel");
+DEFINE_uint32(burst, 10, "The number of streaming messages to send on each "
+              "channel before running the event loop");
+
+namespace {
+
+// A DMX frame worth of data.
+const string PAYLOAD(512, 'x');
+
+/*
+ * Counts the requests, without any checks.
+ */
+class CountingService : public ola::rpc::TestService {
+ public:
+  CountingService() : requests(0) {}
+
+  void Echo(RpcController*, const EchoRequest *request, EchoReply *response,
+            CompletionCallback *done) {
+    requests++;
+    response->set_data(request->data());
+    done->Run();
+  }
+
+  void FailedEcho(RpcController *controller, const EchoRequest*, EchoReply*,
+                  CompletionCallback *done) {
+    controller->SetFailed("Error");
+    done->Run();
+  }
+
+  void Stream(RpcController*, const EchoRequest*, STREAMING_NO_RESPONSE*,
+              CompletionCallback*) {
+    requests++;
+  }
+
+  unsigned int requests;
+};
+
+/*
+ * The client and server ends of a channel.
+ */
+class ChannelPair {
+ public:
+  ChannelPair(SelectServer *ss, CountingService *service)
+      : m_ss(ss),
+        m_server_socket(NULL),
+        m_outstanding(false) {
+    m_client_socket.Init();
+    m_server_socket.reset(m_client_socket.OppositeEnd());
+    m_client_channel.reset(new RpcChannel(NULL, &m_client_socket));
+    m_server_channel.reset(new RpcChannel(service, m_server_socket.get()));
+    m_stub.reset(new TestService_Stub(m_client_channel.get()));
+    m_ss->AddReadDescriptor(&m_client_socket);
+    m_ss->AddReadDescriptor(m_server_socket.get());
+    m_request.set_data(PAYLOAD);
+  }
+
+  ~ChannelPair() {
+    m_ss->RemoveReadDescriptor(&m_client_socket);
+    m_ss->RemoveReadDescriptor(m_server_socket.get());
+  }
+
+  void Stream() {
+    m_stub->Stream(NULL, &m_request, NULL, NULL);
+  }
+
+  // Send an Echo request, if there isn't one outstanding.
+  void Echo() {
+    if (m_outstanding) {
+      return;
+    }
+    m_outstanding = true;
+    m_controller.Reset();
+    m_stub->Echo(&m_controller, &m_request, &m_reply,
+                 NewSingleCallback(this, &ChannelPair::EchoComplete));
+  }
+
+ private:
+  SelectServer *m_ss;
+  UnixSocket m_client_socket;
+  std::auto_ptr<UnixSocket> m_server_socket;
+  std::auto_ptr<RpcChannel> m_client_channel;
+  std::auto_ptr<RpcChannel> m_server_channel;
+  std::auto_ptr<TestService_Stub> m_stub;
+  EchoRequest m_request;
+  EchoReply m_reply;
+  RpcController m_controller;
+  bool m_outstanding;
+
+  void EchoComplete() {
+    m_outstanding = false;
+  }
+};
+
+void Report(const char *test, const TimeInterval &elapsed,
+            unsigned int messages) {
+  double seconds = elapsed.AsInt() / 1000000.0;
+  cout << std::left << std::setw(12) << test << std::right << std::setw(12)
+       << std::fixed << std::setprecision(1)
+       << (seconds > 0 ? messages / seconds / 1000.0 : 0) << " k msgs/s"
+       << endl;
+}
+
+/*
+ * Send bursts of streaming requests on every channel.
+ */
+void RunStream(SelectServer *ss, CountingService *service,
+               const vector<ChannelPair*> &channels) {
+  const unsigned int total = channels.size() * FLAGS_messages;
+  const unsigned int burst = FLAGS_burst ? FLAGS_burst : 1;
+  service->requests = 0;
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  unsigned int sent = 0;
+  while (sent < total) {
+    for (unsigned int i = 0; i < burst && sent < total; i++) {
+      vector<ChannelPair*>::const_iterator iter = channels.begin();
+      for (; iter != channels.end() && sent < total; ++iter, ++sent) {
+        (*iter)->Stream();
+      }
+    }
+    while (service->requests < sent) {
+      ss->RunOnce();
+    }
+  }
+  clock.CurrentTime(&end);
+  Report("stream", end - start, total);
+}
+
+/*
+ * Keep an Echo request outstanding on every channel.
+ */
+void RunEcho(SelectServer *ss, CountingService *service,
+             const vector<ChannelPair*> &channels) {
+  const unsigned int total = channels.size() * FLAGS_messages;
+  service->requests = 0;
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  while (service->requests < total) {
+    vector<ChannelPair*>::const_iterator iter = channels.begin();
+    for (; iter != channels.end(); ++iter) {
+      (*iter)->Echo();
+    }
+    ss->RunOnce();
+  }
+  clock.CurrentTime(&end);
+  Report("echo", end - start, total);
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Benchmark the RpcChannel with many channels.");
+
+  SelectServer ss;
+  CountingService service;
+  vector<ChannelPair*> channels;
+  for (unsigned int i = 0; i < FLAGS_channels; i++) {
+    channels.push_back(new ChannelPair(&ss, &service));
+  }
+
+  cout << FLAGS_channels << " channels, " << FLAGS_messages
+       << " messages per channel" << endl;
+  RunStream(&ss, &service, channels);
+  RunEcho(&ss, &service, channels);
+  ola::STLDeleteElements(&channels);
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <algorithm>
 #include <string>
 
 #include "common/rpc/Rpc.pb.h"
@@ -50,14 +51,21 @@ const char RpcChannel::K_RPC_RECEIVED_TYPE_VAR[] = "rpc-received-type";
 const char RpcChannel::K_RPC_RECEIVED_VAR[] = "rpc-received";
 const char RpcChannel::K_RPC_SENT_ERROR_VAR[] = "rpc-send-errors";
 const char RpcChannel::K_RPC_SENT_VAR[] = "rpc-sent";
+const char RpcChannel::K_RPC_DROPPED_VAR[] = "rpc-dropped";
+const char RpcChannel::K_RPC_QUEUED_BYTES_VAR[] = "rpc-queued-bytes";
 const char RpcChannel::STREAMING_NO_RESPONSE[] = "STREAMING_NO_RESPONSE";
 
 const char *RpcChannel::K_RPC_VARIABLES[] = {
+  K_RPC_DROPPED_VAR,
   K_RPC_RECEIVED_VAR,
   K_RPC_SENT_ERROR_VAR,
   K_RPC_SENT_VAR,
 };
 
+const unsigned int RpcChannel::DEFAULT_HIGH_WATERMARK;
+const unsigned int RpcChannel::DEFAULT_LOW_WATERMARK;
+const unsigned int RpcChannel::DEFAULT_MAX_QUEUE_SIZE;
+
 class OutstandingRequest {
   /*
    * These are requests on the server end that haven't completed yet.
@@ -118,7 +126,18 @@ RpcChannel::RpcChannel(
       m_expected_size(0),
       m_current_size(0),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_recv_type_map(NULL),
+      m_incoming_msg(new RpcMessage()),
+      m_outgoing_msg(new RpcMessage()),
+      m_dispatch_depth(0),
+      m_ss(NULL),
+      m_queued_bytes(0),
+      m_high_watermark(DEFAULT_HIGH_WATERMARK),
+      m_low_watermark(DEFAULT_LOW_WATERMARK),
+      m_max_queue_size(DEFAULT_MAX_QUEUE_SIZE),
+      m_congested(false),
+      m_write_registered(false),
+      m_dropped_messages(0) {
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -132,10 +151,16 @@ RpcChannel::RpcChannel(
     }
     m_recv_type_map = m_export_map->GetUIntMapVar(K_RPC_RECEIVED_TYPE_VAR,
                                                   "type");
+    m_export_map->GetIntegerVar(K_RPC_QUEUED_BYTES_VAR);
   }
 }
 
 RpcChannel::~RpcChannel() {
+  ClearWriteQueue();
+  if (m_ss && m_descriptor) {
+    m_descriptor->SetOnWritable(NULL);
+  }
+  STLDeleteValues(&m_request_cache);
   free(m_buffer);
 }
 
@@ -202,14 +227,71 @@ void RpcChannel::SetChannelCloseHandler(CloseCallback *callback) {
   m_on_close.reset(callback);
 }
 
+void RpcChannel::EnableWriteQueue(ola::io::SelectServerInterface *ss,
+                                  unsigned int high_watermark,
+                                  unsigned int low_watermark,
+                                  unsigned int max_queue_size) {
+  if (!m_descriptor) {
+    return;
+  }
+  m_ss = ss;
+  m_high_watermark = high_watermark;
+  m_low_watermark = std::min(low_watermark, high_watermark);
+  m_max_queue_size = std::max(max_queue_size, high_watermark);
+  m_descriptor->SetOnWritable(
+      ola::NewCallback(this, &RpcChannel::PerformWrite));
+}
+
 void RpcChannel::CallMethod(const MethodDescriptor *method,
                             RpcController *controller,
                             const Message *request,
                             Message *reply,
                             SingleUseCallback0<void> *done) {
-  // TODO(simonn): reduce the number of copies here
+  request->SerializeToString(m_outgoing_msg->mutable_buffer());
+  SendRequest(method, controller, reply, done);
+}
+
+void RpcChannel::CallMethod(const MethodDescriptor *method,
+                            RpcController *controller,
+                            const string &request,
+                            Message *reply,
+                            SingleUseCallback0<void> *done) {
+  m_outgoing_msg->set_buffer(request);
+  SendRequest(method, controller, reply, done);
+}
+
+void RpcChannel::RequestComplete(OutstandingRequest *request) {
   string output;
   RpcMessage message;
+
+  if (request->controller->Failed()) {
+    SendRequestFailed(request);
+    return;
+  }
+
+  message.set_type(RESPONSE);
+  message.set_id(request->id);
+  request->response->SerializeToString(&output);
+  message.set_buffer(output);
+  SendMsg(&message);
+  DeleteOutstandingRequest(request);
+}
+
+RpcSession *RpcChannel::Session() {
+  return m_session.get();
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+/*
+ * Send the request in m_outgoing_msg.
+ */
+void RpcChannel::SendRequest(const MethodDescriptor *method,
+                             RpcController *controller,
+                             Message *reply,
+                             SingleUseCallback0<void> *done) {
+  RpcMessage *message = m_outgoing_msg.get();
   bool is_streaming = false;
 
   // Streaming methods are those with a reply set to STREAMING_NO_RESPONSE and
@@ -223,13 +305,24 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
     is_streaming = true;
   }
 
-  message.set_type(is_streaming ? STREAM_REQUEST : REQUEST);
-  message.set_id(m_sequence.Next());
-  message.set_name(method->name());
+  if (m_congested && controller && controller->Droppable()) {
+    // The remote end isn't keeping up, don't make it worse.
+    m_dropped_messages++;
+    if (m_export_map) {
+      (*m_export_map->GetCounterVar(K_RPC_DROPPED_VAR))++;
+    }
+    controller->SetFailed("RPC channel congested, request dropped");
+    done->Run();
+    return;
+  }
 
-  request->SerializeToString(&output);
-  message.set_buffer(output);
-  bool r = SendMsg(&message);
+  // SendMsg() may run the close handler, so don't touch the message once
+  // it's been sent.
+  const int id = m_sequence.Next();
+  message->set_type(is_streaming ? STREAM_REQUEST : REQUEST);
+  message->set_id(id);
+  message->set_name(method->name());
+  bool r = SendMsg(message);
 
   if (is_streaming)
     return;
@@ -242,10 +335,10 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   }
 
   OutstandingResponse *response = new OutstandingResponse(
-      message.id(), controller, done, reply);
+      id, controller, done, reply);
 
   auto_ptr<OutstandingResponse> old_response(
-      STLReplacePtr(&m_responses, message.id(), response));
+      STLReplacePtr(&m_responses, id, response));
 
   if (old_response.get()) {
     // fail any outstanding response with the same id
@@ -256,30 +349,6 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   }
 }
 
-void RpcChannel::RequestComplete(OutstandingRequest *request) {
-  string output;
-  RpcMessage message;
-
-  if (request->controller->Failed()) {
-    SendRequestFailed(request);
-    return;
-  }
-
-  message.set_type(RESPONSE);
-  message.set_id(request->id);
-  request->response->SerializeToString(&output);
-  message.set_buffer(output);
-  SendMsg(&message);
-  DeleteOutstandingRequest(request);
-}
-
-RpcSession *RpcChannel::Session() {
-  return m_session.get();
-}
-
-// private
-//-----------------------------------------------------------------------------
-
 /*
  * Write an RpcMessage to the write descriptor.
  */
@@ -290,43 +359,152 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
   }
 
   uint32_t header;
-  // reserve the first 4 bytes for the header
-  string output(sizeof(header), 0);
-  msg->AppendToString(&output);
-  int length = output.size();
+  // reserve the first 4 bytes for the header. The buffer keeps its capacity
+  // between calls.
+  m_send_buffer.assign(sizeof(header), 0);
+  msg->AppendToString(&m_send_buffer);
+  int length = m_send_buffer.size();
 
   RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
                                 length - sizeof(header));
-  output.replace(
+  m_send_buffer.replace(
       0, sizeof(header),
       reinterpret_cast<const char*>(&header), sizeof(header));
 
-  ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
-
-  if (ret != length) {
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(
+      m_send_buffer.data());
+  if (m_ss) {
+    if (!WriteOrQueue(data, length)) {
+      return false;
+    }
+  } else if (m_descriptor->Send(data, length) != length) {
     OLA_WARN << "Failed to send full RPC message, closing channel";
+    SendFailed();
+    return false;
+  }
 
-    if (m_export_map) {
-      (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
-    }
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+  }
+  return true;
+}
 
-    // At this point there is no point using the descriptor since framing has
-    // probably been messed up.
-    // TODO(simon): consider if it's worth leaving the descriptor open for
-    // reading.
-    m_descriptor = NULL;
+/*
+ * Write data to the descriptor, queuing whatever it won't take now.
+ * @returns false if the channel was closed.
+ */
+bool RpcChannel::WriteOrQueue(const uint8_t *data, unsigned int length) {
+  unsigned int sent = 0;
+  if (m_write_queue.Empty()) {
+    ssize_t ret = m_descriptor->Send(data, length);
+    if (ret < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "Failed to send RPC message, closing channel";
+        SendFailed();
+        return false;
+      }
+    } else {
+      sent = ret;
+    }
+    if (sent == length) {
+      return true;
+    }
+  }
 
-    HandleChannelClose();
+  const unsigned int remaining = length - sent;
+  if (m_queued_bytes + remaining > m_max_queue_size) {
+    OLA_WARN << "RPC write queue reached " << m_max_queue_size
+             << " bytes, closing channel";
+    SendFailed();
     return false;
   }
 
-  if (m_export_map) {
-    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+  // Messages are written in order, so the rest of this one goes on the end
+  // of the queue.
+  m_write_queue.Write(data + sent, remaining);
+  SetQueuedBytes(m_queued_bytes + remaining);
+  if (!m_write_registered) {
+    m_ss->AddWriteDescriptor(m_descriptor);
+    m_write_registered = true;
   }
   return true;
 }
 
+/*
+ * Called when the descriptor is writable.
+ */
+void RpcChannel::PerformWrite() {
+  if (!m_descriptor) {
+    return;
+  }
+
+  ssize_t ret = m_descriptor->Send(&m_write_queue);
+  if (ret < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "Failed to send queued RPC data, closing channel";
+      SendFailed();
+    }
+    return;
+  }
+
+  SetQueuedBytes(m_queued_bytes - std::min(m_queued_bytes,
+                                           static_cast<unsigned int>(ret)));
+  if (m_write_queue.Empty() && m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+/*
+ * Update the size of the write queue.
+ */
+void RpcChannel::SetQueuedBytes(unsigned int queued_bytes) {
+  if (m_export_map && queued_bytes != m_queued_bytes) {
+    IntegerVariable *var = m_export_map->GetIntegerVar(K_RPC_QUEUED_BYTES_VAR);
+    var->Set(var->Get() + static_cast<int>(queued_bytes) -
+             static_cast<int>(m_queued_bytes));
+  }
+  m_queued_bytes = queued_bytes;
+
+  if (!m_congested && m_queued_bytes >= m_high_watermark) {
+    OLA_INFO << "RPC write queue is over " << m_high_watermark
+             << " bytes, dropping stale requests";
+    m_congested = true;
+  } else if (m_congested && m_queued_bytes <= m_low_watermark) {
+    m_congested = false;
+  }
+}
+
+/*
+ * Discard any queued data.
+ */
+void RpcChannel::ClearWriteQueue() {
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+  m_write_queue.Clear();
+  SetQueuedBytes(0);
+}
+
+/*
+ * Called when a write fails, this closes the channel.
+ */
+void RpcChannel::SendFailed() {
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
+  }
+
+  // At this point there is no point using the descriptor since framing has
+  // probably been messed up.
+  // TODO(simon): consider if it's worth leaving the descriptor open for
+  // reading.
+  ClearWriteQueue();
+  m_descriptor = NULL;
+
+  HandleChannelClose();
+}
+
 
 /*
  * Allocate an incoming message buffer
@@ -387,8 +565,16 @@ int RpcChannel::ReadHeader(unsigned int *version,
  * Parse a new message and handle it.
  */
 bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
-  RpcMessage msg;
-  if (!msg.ParseFromArray(data, size)) {
+  // If a handler runs the event loop we can end up back here, in which case
+  // the shared message is still in use.
+  auto_ptr<RpcMessage> nested_msg;
+  RpcMessage *msg = m_incoming_msg.get();
+  if (m_dispatch_depth) {
+    nested_msg.reset(new RpcMessage());
+    msg = nested_msg.get();
+  }
+
+  if (!msg->ParseFromArray(data, size)) {
     OLA_WARN << "Failed to parse RPC";
     return false;
   }
@@ -396,41 +582,43 @@ bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
   if (m_export_map)
     (*m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR))++;
 
-  switch (msg.type()) {
+  m_dispatch_depth++;
+  switch (msg->type()) {
     case REQUEST:
       if (m_recv_type_map)
         (*m_recv_type_map)["request"]++;
-      HandleRequest(&msg);
+      HandleRequest(msg);
       break;
     case RESPONSE:
       if (m_recv_type_map)
         (*m_recv_type_map)["response"]++;
-      HandleResponse(&msg);
+      HandleResponse(msg);
       break;
     case RESPONSE_CANCEL:
       if (m_recv_type_map)
         (*m_recv_type_map)["cancelled"]++;
-      HandleCanceledResponse(&msg);
+      HandleCanceledResponse(msg);
       break;
     case RESPONSE_FAILED:
       if (m_recv_type_map)
         (*m_recv_type_map)["failed"]++;
-      HandleFailedResponse(&msg);
+      HandleFailedResponse(msg);
       break;
     case RESPONSE_NOT_IMPLEMENTED:
       if (m_recv_type_map)
         (*m_recv_type_map)["not-implemented"]++;
-      HandleNotImplemented(&msg);
+      HandleNotImplemented(msg);
       break;
     case STREAM_REQUEST:
       if (m_recv_type_map)
         (*m_recv_type_map)["stream_request"]++;
-      HandleStreamRequest(&msg);
+      HandleStreamRequest(msg);
       break;
     default:
-      OLA_WARN << "not sure of msg type " << msg.type();
+      OLA_WARN << "not sure of msg type " << msg->type();
       break;
   }
+  m_dispatch_depth--;
   return true;
 }
 
@@ -456,19 +644,16 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
-  Message* response_pb = m_service->GetResponsePrototype(method).New();
-
-  if (!request_pb || !response_pb) {
-    OLA_WARN << "failed to get request or response objects";
-    return;
-  }
-
+  auto_ptr<Message> nested_request;
+  Message* request_pb = GetRequestMessage(method, &nested_request);
   if (!request_pb->ParseFromString(msg->buffer())) {
     OLA_WARN << "parsing of request pb failed";
     return;
   }
 
+  // The response outlives this call, so it can't be shared.
+  Message* response_pb = m_service->GetResponsePrototype(method).New();
+
   OutstandingRequest *request = new OutstandingRequest(
       msg->id(), m_session.get(), response_pb);
 
@@ -482,7 +667,6 @@ void RpcChannel::HandleRequest(RpcMessage *msg) {
       this, &RpcChannel::RequestComplete, request);
   m_service->CallMethod(method, request->controller, request_pb, response_pb,
                         callback);
-  delete request_pb;
 }
 
 
@@ -513,13 +697,8 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
-
-  if (!request_pb) {
-    OLA_WARN << "failed to get request or response objects";
-    return;
-  }
-
+  auto_ptr<Message> nested_request;
+  Message* request_pb = GetRequestMessage(method, &nested_request);
   if (!request_pb->ParseFromString(msg->buffer())) {
     OLA_WARN << "parsing of request pb failed";
     return;
@@ -527,7 +706,29 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
 
   RpcController controller(m_session.get());
   m_service->CallMethod(method, &controller, request_pb, NULL, NULL);
-  delete request_pb;
+}
+
+
+/*
+ * Get a request object for a method. Services only use the request for the
+ * duration of CallMethod(), so one object per method is reused, unless we've
+ * been called recursively.
+ * @param method the method to get the request for.
+ * @param nested_request holds the request if the shared object is in use.
+ */
+Message *RpcChannel::GetRequestMessage(const MethodDescriptor *method,
+                                       auto_ptr<Message> *nested_request) {
+  if (m_dispatch_depth > 1) {
+    nested_request->reset(m_service->GetRequestPrototype(method).New());
+    return nested_request->get();
+  }
+
+  Message *request = STLFindOrNull(m_request_cache, method);
+  if (!request) {
+    request = m_service->GetRequestPrototype(method).New();
+    m_request_cache[method] = request;
+  }
+  return request;
 }
 
 
@@ -625,6 +826,7 @@ void RpcChannel::HandleNotImplemented(RpcMessage *msg) {
  * Invoke the Channel close handler/
  */
 void RpcChannel::HandleChannelClose() {
+  ClearWriteQueue();
   if (m_on_close.get()) {
     m_on_close.release()->Run(m_session.get());
   }
@@ -29,8 +29,12 @@
 #include <google/protobuf/service.h>
 #include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/IOQueue.h>
+#include <ola/io/SelectServerInterface.h>
 #include <ola/util/SequenceNumber.h>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "ola/ExportMap.h"
 
@@ -108,6 +112,43 @@ class RpcChannel {
      */
     void SetChannelCloseHandler(CloseCallback *callback);
 
+    /**
+     * @brief Queue data that the descriptor can't accept straight away,
+     * rather than closing the channel.
+     * @param ss the SelectServer to use to wait for the descriptor to become
+     *   writable. Ownership is not transferred.
+     * @param high_watermark once this many bytes are queued, requests marked
+     *   with RpcController::SetDroppable() are failed rather than sent, until
+     *   the queue drains to low_watermark.
+     * @param low_watermark see high_watermark.
+     * @param max_queue_size if the queue would grow larger than this, the
+     *   remote end isn't reading and the channel is closed.
+     *
+     * This should be called before any data is sent.
+     */
+    void EnableWriteQueue(
+        ola::io::SelectServerInterface *ss,
+        unsigned int high_watermark = DEFAULT_HIGH_WATERMARK,
+        unsigned int low_watermark = DEFAULT_LOW_WATERMARK,
+        unsigned int max_queue_size = DEFAULT_MAX_QUEUE_SIZE);
+
+    /**
+     * @brief The number of bytes waiting to be written to the descriptor.
+     */
+    unsigned int QueuedBytes() const { return m_queued_bytes; }
+
+    /**
+     * @brief The number of droppable requests that weren't sent because the
+     * write queue was over the high watermark.
+     */
+    unsigned int DroppedMessages() const { return m_dropped_messages; }
+
+    /**
+     * @brief True if the write queue has passed the high watermark and not yet
+     * drained to the low watermark.
+     */
+    bool Congested() const { return m_congested; }
+
     /**
      * @brief Invoke an RPC method on this channel.
      */
@@ -117,6 +158,19 @@ class RpcChannel {
                     google::protobuf::Message *response,
                     SingleUseCallback0<void> *done);
 
+    /**
+     * @brief Invoke an RPC method with a request that's already been
+     * serialized.
+     *
+     * This allows the same request to be sent on many channels while only
+     * serializing it once.
+     */
+    void CallMethod(const google::protobuf::MethodDescriptor *method,
+                    class RpcController *controller,
+                    const std::string &request,
+                    google::protobuf::Message *response,
+                    SingleUseCallback0<void> *done);
+
     /**
      * @brief Invoked by the RPC completion handler when the server side
      * response is ready.
@@ -135,9 +189,15 @@ class RpcChannel {
      */
     static const unsigned int PROTOCOL_VERSION = 1;
 
+    static const unsigned int DEFAULT_HIGH_WATERMARK = 1 << 16;  // 64k
+    static const unsigned int DEFAULT_LOW_WATERMARK = 1 << 14;  // 16k
+    static const unsigned int DEFAULT_MAX_QUEUE_SIZE = 1 << 22;  // 4M
+
  private:
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingResponse*>
       ResponseMap;
+    typedef std::map<const google::protobuf::MethodDescriptor*,
+                     google::protobuf::Message*> RequestCache;
 
     std::auto_ptr<RpcSession> m_session;
     RpcService *m_service;  // service to dispatch requests to
@@ -154,12 +214,43 @@ class RpcChannel {
     ExportMap *m_export_map;
     UIntMap *m_recv_type_map;
 
+    // The messages are reused so that the common cases, and in particular
+    // streaming requests, don't allocate memory.
+    std::auto_ptr<RpcMessage> m_incoming_msg;
+    std::auto_ptr<RpcMessage> m_outgoing_msg;
+    std::string m_send_buffer;
+    RequestCache m_request_cache;  // a request object for each method
+    unsigned int m_dispatch_depth;
+
+    // The write queue, only used if m_ss is set.
+    ola::io::SelectServerInterface *m_ss;
+    ola::io::IOQueue m_write_queue;
+    unsigned int m_queued_bytes;
+    unsigned int m_high_watermark;
+    unsigned int m_low_watermark;
+    unsigned int m_max_queue_size;
+    bool m_congested;  // true between the high and low watermarks
+    bool m_write_registered;
+    unsigned int m_dropped_messages;
+
+    void SendRequest(const google::protobuf::MethodDescriptor *method,
+                     class RpcController *controller,
+                     google::protobuf::Message *reply,
+                     SingleUseCallback0<void> *done);
     bool SendMsg(RpcMessage *msg);
+    bool WriteOrQueue(const uint8_t *data, unsigned int length);
+    void PerformWrite();
+    void SetQueuedBytes(unsigned int queued_bytes);
+    void ClearWriteQueue();
+    void SendFailed();
     int AllocateMsgBuffer(unsigned int size);
     int ReadHeader(unsigned int *version, unsigned int *size) const;
     bool HandleNewMsg(uint8_t *buffer, unsigned int size);
     void HandleRequest(RpcMessage *msg);
     void HandleStreamRequest(RpcMessage *msg);
+    google::protobuf::Message *GetRequestMessage(
+        const google::protobuf::MethodDescriptor *method,
+        std::auto_ptr<google::protobuf::Message> *nested_request);
 
     // server end
     void SendRequestFailed(class OutstandingRequest *request);
@@ -178,6 +269,8 @@ class RpcChannel {
     static const char K_RPC_RECEIVED_VAR[];
     static const char K_RPC_SENT_ERROR_VAR[];
     static const char K_RPC_SENT_VAR[];
+    static const char K_RPC_DROPPED_VAR[];
+    static const char K_RPC_QUEUED_BYTES_VAR[];
     static const char *K_RPC_VARIABLES[];
     static const char STREAMING_NO_RESPONSE[];
     static const unsigned int INITIAL_BUFFER_SIZE = 1 << 11;  // 2k
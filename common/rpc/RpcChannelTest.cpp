@@ -25,18 +25,23 @@
 
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
+#include "common/rpc/RpcSession.h"
 #include "common/rpc/TestService.h"
 #include "common/rpc/TestService.pb.h"
 #include "common/rpc/TestServiceService.pb.h"
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/io/Descriptor.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
 
 
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::io::LoopbackDescriptor;
 using ola::io::SelectServer;
+using ola::io::UnixSocket;
 using ola::rpc::EchoReply;
 using ola::rpc::EchoRequest;
 using ola::rpc::RpcChannel;
@@ -53,6 +58,9 @@ class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testRepeatedRequests);
+  CPPUNIT_TEST(testWriteQueue);
+  CPPUNIT_TEST(testWriteQueueOverflow);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -61,6 +69,9 @@ class RpcChannelTest: public CppUnit::TestFixture {
   void testEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testRepeatedRequests();
+  void testWriteQueue();
+  void testWriteQueueOverflow();
   void EchoComplete();
   void FailedEchoComplete();
 
@@ -79,6 +90,44 @@ class RpcChannelTest: public CppUnit::TestFixture {
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RpcChannelTest);
 
+namespace {
+/*
+ * Counts the requests, without terminating the SelectServer.
+ */
+class CountingService : public TestService {
+ public:
+  CountingService() : requests(0) {}
+
+  void Echo(RpcController*, const EchoRequest *request, EchoReply *response,
+            CompletionCallback *done) {
+    requests++;
+    response->set_data(request->data());
+    done->Run();
+  }
+
+  void FailedEcho(RpcController *controller, const EchoRequest*, EchoReply*,
+                  CompletionCallback *done) {
+    controller->SetFailed("Error");
+    done->Run();
+  }
+
+  void Stream(RpcController*, const EchoRequest*, STREAMING_NO_RESPONSE*,
+              CompletionCallback*) {
+    requests++;
+  }
+
+  unsigned int requests;
+};
+
+void SetFlag(bool *flag) {
+  *flag = true;
+}
+
+void ChannelClosed(bool *closed, ola::rpc::RpcSession*) {
+  *closed = true;
+}
+}  // namespace
+
 void RpcChannelTest::setUp() {
   m_socket.reset(new LoopbackDescriptor());
   m_socket->Init();
@@ -139,3 +188,119 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+/*
+ * Check that the request objects, which are reused, don't keep data from the
+ * previous request.
+ */
+void RpcChannelTest::testRepeatedRequests() {
+  const string long_data(1000, 'x');
+  m_request.set_session_ptr(0);
+  m_request.set_data(long_data);
+  m_stub->Echo(&m_controller,
+               &m_request,
+               &m_reply,
+               NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+  m_ss.Run();
+  OLA_ASSERT_EQ(long_data, m_reply.data());
+
+  m_request.set_data("bar");
+  m_stub->Echo(&m_controller,
+               &m_request,
+               &m_reply,
+               NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+  m_ss.Run();
+  OLA_ASSERT_EQ(string("bar"), m_reply.data());
+
+  // The stream handler checks the data is "foo"
+  m_request.set_data(TestClient::kTestData);
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+}
+
+/*
+ * Check that data the socket won't take is queued, and that droppable
+ * requests are dropped once the queue passes the high watermark.
+ */
+void RpcChannelTest::testWriteQueue() {
+  UnixSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  auto_ptr<UnixSocket> server_socket(client_socket.OppositeEnd());
+  CountingService service;
+  RpcChannel client_channel(NULL, &client_socket);
+  client_channel.EnableWriteQueue(&m_ss, 4096, 1024);
+  RpcChannel server_channel(&service, server_socket.get());
+  TestService_Stub stub(&client_channel);
+  m_ss.AddReadDescriptor(&client_socket);
+  m_ss.AddReadDescriptor(server_socket.get());
+
+  // Fill the socket buffer, without running the event loop.
+  m_request.set_data(string(512, 'x'));
+  unsigned int sent = 0;
+  while (client_channel.QueuedBytes() < 4096 && sent < 100000) {
+    stub.Stream(NULL, &m_request, NULL, NULL);
+    sent++;
+  }
+  OLA_ASSERT_TRUE(client_channel.QueuedBytes() >= 4096);
+
+  // Droppable requests fail straight away
+  bool done = false;
+  m_controller.SetDroppable(true);
+  stub.Echo(&m_controller, &m_request, &m_reply,
+            NewSingleCallback(SetFlag, &done));
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_TRUE(m_controller.Failed());
+  OLA_ASSERT_EQ(1u, client_channel.DroppedMessages());
+
+  // Other requests are still queued
+  stub.Stream(NULL, &m_request, NULL, NULL);
+  sent++;
+
+  for (unsigned int i = 0; i < 100000 && service.requests < sent; i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_EQ(sent, service.requests);
+  OLA_ASSERT_EQ(0u, client_channel.QueuedBytes());
+
+  // Once the queue has drained, droppable requests are sent
+  done = false;
+  m_controller.Reset();
+  m_controller.SetDroppable(true);
+  stub.Echo(&m_controller, &m_request, &m_reply,
+            NewSingleCallback(SetFlag, &done));
+  for (unsigned int i = 0; i < 100 && !done; i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_FALSE(m_controller.Failed());
+  OLA_ASSERT_EQ(m_request.data(), m_reply.data());
+
+  m_ss.RemoveReadDescriptor(&client_socket);
+  m_ss.RemoveReadDescriptor(server_socket.get());
+}
+
+/*
+ * Check that the channel is closed if the write queue grows too large.
+ */
+void RpcChannelTest::testWriteQueueOverflow() {
+  UnixSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+  auto_ptr<UnixSocket> server_socket(client_socket.OppositeEnd());
+  RpcChannel client_channel(NULL, &client_socket);
+  client_channel.EnableWriteQueue(&m_ss, 4096, 1024, 8192);
+  bool closed = false;
+  client_channel.SetChannelCloseHandler(
+      NewSingleCallback(ChannelClosed, &closed));
+  TestService_Stub stub(&client_channel);
+
+  // The other end never reads.
+  m_request.set_data(string(512, 'x'));
+  for (unsigned int i = 0; i < 100000 && !closed; i++) {
+    stub.Stream(NULL, &m_request, NULL, NULL);
+    OLA_ASSERT_TRUE(client_channel.QueuedBytes() <= 8192);
+  }
+  OLA_ASSERT_TRUE(closed);
+  OLA_ASSERT_EQ(0u, client_channel.QueuedBytes());
+}
@@ -29,11 +29,13 @@ namespace rpc {
 RpcController::RpcController(RpcSession *session)
     : m_session(session),
       m_failed(false),
+      m_droppable(false),
       m_error_text("") {
 }
 
 void RpcController::Reset() {
   m_failed = false;
+  m_droppable = false;
   m_error_text = "";
 }
 
@@ -71,6 +71,22 @@ class RpcController {
    */
   void SetFailed(const std::string &reason);
 
+  /**
+   * @brief Mark this RPC as one that can be dropped if the channel is
+   * congested.
+   *
+   * This is used for updates that will soon be replaced by newer data. A
+   * dropped RPC fails straight away.
+   * @param droppable true if the RPC can be dropped.
+   */
+  void SetDroppable(bool droppable) { m_droppable = droppable; }
+
+  /**
+   * @brief Check if this RPC can be dropped.
+   * @returns true if the RPC can be dropped if the channel is congested.
+   */
+  bool Droppable() const { return m_droppable; }
+
   /**
    * @brief Get the session infomation for this RPC.
    *
@@ -82,6 +98,7 @@ class RpcController {
  private:
   RpcSession *m_session;
   bool m_failed;
+  bool m_droppable;
   std::string m_error_text;
 };
 }  // namespace rpc
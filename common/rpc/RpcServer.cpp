@@ -21,6 +21,7 @@
 #include "common/rpc/RpcServer.h"
 
 #include <ola/ExportMap.h>
+#include <ola/InlineCallback.h>
 #include <ola/Logging.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
@@ -109,6 +110,7 @@ bool RpcServer::Init() {
     }
   }
 
+  accepting_socket->SetReadLabel("rpc-listen");
   if (!m_ss->AddReadDescriptor(accepting_socket.get())) {
     OLA_WARN << "Failed to add RPC socket to SelectServer";
     return false;
@@ -130,6 +132,8 @@ bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
   // ownership of the socket here.
   RpcChannel *channel = new RpcChannel(m_service, descriptor,
                                        m_options.export_map);
+  // Don't let a client that stops reading block or bloat the server.
+  channel->EnableWriteQueue(m_ss);
 
   if (m_session_handler) {
     m_session_handler->NewClient(channel->Session());
@@ -142,6 +146,7 @@ bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
     (*m_options.export_map->GetIntegerVar(K_CLIENT_VAR))++;
   }
 
+  descriptor->SetLabel("rpc-client");
   m_ss->AddReadDescriptor(descriptor);
   m_connected_sockets.insert(descriptor);
 
@@ -173,7 +178,7 @@ void RpcServer::ChannelClosed(ConnectedDescriptor *descriptor,
   // We schedule deletion during the next run of the event loop to break out of
   // the stack.
   m_ss->Execute(
-      NewSingleCallback(CleanupChannel, session->Channel(), descriptor));
+      MakeInlineCallback(CleanupChannel, session->Channel(), descriptor));
 }
 }  // namespace rpc
 }  // namespace ola
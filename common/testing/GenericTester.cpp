@@ -43,6 +43,10 @@ DECLARE_bool(use_epoll);
 DECLARE_bool(use_kqueue);
 #endif  // HAVE_KQUEUE
 
+#ifdef HAVE_IO_URING
+DECLARE_bool(use_io_uring);
+#endif  // HAVE_IO_URING
+
 DECLARE_uint8(log_level);
 
 bool GetBoolEnvVar(const string &var_name) {
@@ -64,6 +68,10 @@ int main(int argc, char* argv[]) {
   FLAGS_use_kqueue = GetBoolEnvVar("OLA_USE_KQUEUE");
 #endif  // HAVE_KQUEUE
 
+#ifdef HAVE_IO_URING
+  FLAGS_use_io_uring = GetBoolEnvVar("OLA_USE_IO_URING");
+#endif  // HAVE_IO_URING
+
   ola::AppInit(&argc, argv, "[options]", "");
 
   CppUnit::Test *suite = CppUnit::TestFactoryRegistry::getRegistry().makeTest();
@@ -43,6 +43,8 @@ using ola::io::IOVecInterface;
 using ola::network::HostToNetwork;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::network::UDPDatagram;
+using ola::network::UDPOutgoingDatagram;
 
 MockUDPSocket::MockUDPSocket()
     : ola::network::UDPSocketInterface(),
@@ -52,6 +54,11 @@ MockUDPSocket::MockUDPSocket()
       m_broadcast_set(false),
       m_port(0),
       m_tos(0),
+      m_receive_buffer_size(0),
+      m_send_buffer_size(0),
+      m_count_drops(false),
+      m_dropped(0),
+      m_timestamps(false),
       m_discard_mode(false) {
 }
 
@@ -152,6 +159,19 @@ ssize_t MockUDPSocket::SendTo(IOVecInterface *data,
   return data_sent;
 }
 
+unsigned int MockUDPSocket::SendMany(const UDPOutgoingDatagram *datagrams,
+                                     unsigned int count) const {
+  unsigned int sent = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    ssize_t bytes_sent = SendTo(datagrams[i].data, datagrams[i].size,
+                                datagrams[i].destination);
+    if (bytes_sent == static_cast<ssize_t>(datagrams[i].size)) {
+      sent++;
+    }
+  }
+  return sent;
+}
+
 bool MockUDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
   IPV4Address address;
   uint16_t port;
@@ -206,6 +226,24 @@ bool MockUDPSocket::RecvFrom(
 }
 
 
+unsigned int MockUDPSocket::RecvMany(UDPDatagram *datagrams,
+                                     unsigned int count) {
+  OLA_ASSERT_FALSE(m_received_data.empty());
+  unsigned int received = 0;
+  while (received < count && !m_received_data.empty()) {
+    UDPDatagram *datagram = &datagrams[received];
+    ssize_t size = datagram->capacity;
+    if (!RecvFrom(datagram->data, &size, &datagram->source)) {
+      break;
+    }
+    datagram->size = static_cast<unsigned int>(size);
+    datagram->arrival = m_timestamps ? m_arrival : TimeStamp();
+    received++;
+  }
+  return received;
+}
+
+
 bool MockUDPSocket::EnableBroadcast() {
   m_broadcast_set = true;
   return true;
@@ -233,12 +271,41 @@ bool MockUDPSocket::LeaveMulticast(const IPV4Address &iface,
 }
 
 
+bool MockUDPSocket::SetMulticastAll(OLA_UNUSED bool enable) {
+  return true;
+}
+
+
 bool MockUDPSocket::SetTos(uint8_t tos) {
   m_tos = tos;
   return true;
 }
 
 
+bool MockUDPSocket::SetReceiveBufferSize(unsigned int size) {
+  m_receive_buffer_size = size;
+  return true;
+}
+
+
+bool MockUDPSocket::SetSendBufferSize(unsigned int size) {
+  m_send_buffer_size = size;
+  return true;
+}
+
+
+bool MockUDPSocket::EnableDropCounting() {
+  m_count_drops = true;
+  return true;
+}
+
+
+bool MockUDPSocket::EnableReceiveTimestamps() {
+  m_timestamps = true;
+  return true;
+}
+
+
 void MockUDPSocket::AddExpectedData(const uint8_t *data,
                                     unsigned int size,
                                     const IPV4Address &ip,
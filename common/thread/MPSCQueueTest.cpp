@@ -0,0 +1,188 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MPSCQueueTest.cpp
+ * Test fixture for the MPSCQueue class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/thread/MPSCQueue.h"
+#include "ola/thread/Thread.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::thread::MPSCQueue;
+using std::vector;
+
+namespace {
+
+/*
+ * Pushes (producer id, sequence number) pairs onto a queue.
+ */
+class ProducerThread: public ola::thread::Thread {
+ public:
+  ProducerThread(MPSCQueue<unsigned int> *queue,
+                 unsigned int id,
+                 unsigned int count)
+      : m_queue(queue),
+        m_id(id),
+        m_count(count) {
+  }
+
+  void *Run() {
+    for (unsigned int i = 0; i < m_count; i++) {
+      m_queue->Push((m_id << 16) | i);
+    }
+    return NULL;
+  }
+
+ private:
+  MPSCQueue<unsigned int> *m_queue;
+  const unsigned int m_id;
+  const unsigned int m_count;
+
+  DISALLOW_COPY_AND_ASSIGN(ProducerThread);
+};
+}  // namespace
+
+
+class MPSCQueueTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MPSCQueueTest);
+  CPPUNIT_TEST(testOrdering);
+  CPPUNIT_TEST(testNodeReuse);
+  CPPUNIT_TEST(testMultipleProducers);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testOrdering();
+  void testNodeReuse();
+  void testMultipleProducers();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MPSCQueueTest);
+
+
+/*
+ * Check items come out in the order they went in, and that Push() reports
+ * when the queue was empty.
+ */
+void MPSCQueueTest::testOrdering() {
+  MPSCQueue<int> queue;
+  OLA_ASSERT_TRUE(queue.Empty());
+
+  OLA_ASSERT_TRUE(queue.Push(1));
+  OLA_ASSERT_FALSE(queue.Empty());
+  OLA_ASSERT_FALSE(queue.Push(2));
+  OLA_ASSERT_FALSE(queue.Push(3));
+
+  vector<int> output;
+  OLA_ASSERT_EQ(3u, queue.PopAll(&output));
+  OLA_ASSERT_TRUE(queue.Empty());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), output.size());
+  OLA_ASSERT_EQ(1, output[0]);
+  OLA_ASSERT_EQ(2, output[1]);
+  OLA_ASSERT_EQ(3, output[2]);
+
+  OLA_ASSERT_EQ(0u, queue.PopAll(&output));
+  OLA_ASSERT_EQ(static_cast<size_t>(3), output.size());
+
+  // The next push should report the queue was empty again.
+  OLA_ASSERT_TRUE(queue.Push(4));
+  OLA_ASSERT_EQ(1u, queue.PopAll(&output));
+  OLA_ASSERT_EQ(4, output[3]);
+
+  // Items left in the queue are cleaned up by the destructor.
+  queue.Push(5);
+}
+
+
+/*
+ * Check the nodes are recycled once the items have been popped.
+ */
+void MPSCQueueTest::testNodeReuse() {
+  MPSCQueue<int> queue;
+  vector<int> output;
+  queue.Push(1);
+  queue.Push(2);
+  queue.Push(3);
+  OLA_ASSERT_EQ(3u, queue.PopAll(&output));
+  OLA_ASSERT_EQ(3u, queue.NodeCount());
+
+  for (int i = 0; i < 100; i++) {
+    output.clear();
+    queue.Push(i);
+    queue.Push(i + 1);
+    OLA_ASSERT_EQ(2u, queue.PopAll(&output));
+    OLA_ASSERT_EQ(i, output[0]);
+    OLA_ASSERT_EQ(i + 1, output[1]);
+  }
+  OLA_ASSERT_EQ(3u, queue.NodeCount());
+
+  // More items than there are free nodes.
+  for (int i = 0; i < 5; i++) {
+    queue.Push(i);
+  }
+  OLA_ASSERT_EQ(5u, queue.NodeCount());
+  output.clear();
+  OLA_ASSERT_EQ(5u, queue.PopAll(&output));
+  for (int i = 0; i < 5; i++) {
+    OLA_ASSERT_EQ(i, output[i]);
+  }
+}
+
+
+/*
+ * Check that nothing is lost, and each producer's items stay in order, with
+ * many producers.
+ */
+void MPSCQueueTest::testMultipleProducers() {
+  const unsigned int PRODUCERS = 4;
+  const unsigned int ITEMS = 10000;
+  MPSCQueue<unsigned int> queue;
+
+  vector<ProducerThread*> threads;
+  for (unsigned int i = 0; i < PRODUCERS; i++) {
+    threads.push_back(new ProducerThread(&queue, i, ITEMS));
+  }
+  for (unsigned int i = 0; i < PRODUCERS; i++) {
+    OLA_ASSERT_TRUE(threads[i]->Start());
+  }
+
+  vector<unsigned int> next_expected(PRODUCERS, 0);
+  unsigned int received = 0;
+  vector<unsigned int> output;
+  while (received < PRODUCERS * ITEMS) {
+    output.clear();
+    received += queue.PopAll(&output);
+    vector<unsigned int>::const_iterator iter = output.begin();
+    for (; iter != output.end(); ++iter) {
+      unsigned int producer = *iter >> 16;
+      OLA_ASSERT_TRUE(producer < PRODUCERS);
+      OLA_ASSERT_EQ(next_expected[producer], *iter & 0xffff);
+      next_expected[producer]++;
+    }
+  }
+
+  for (unsigned int i = 0; i < PRODUCERS; i++) {
+    OLA_ASSERT_TRUE(threads[i]->Join());
+    delete threads[i];
+    OLA_ASSERT_EQ(ITEMS, next_expected[i]);
+  }
+  OLA_ASSERT_TRUE(queue.Empty());
+}
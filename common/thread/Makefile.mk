@@ -8,7 +8,9 @@ common_libolacommon_la_SOURCES += \
     common/thread/SignalThread.cpp \
     common/thread/Thread.cpp \
     common/thread/ThreadPool.cpp \
-    common/thread/Utils.cpp
+    common/thread/ThreadRoles.cpp \
+    common/thread/Utils.cpp \
+    common/thread/WorkStealingThreadPool.cpp
 
 # TESTS
 ##################################################
@@ -17,8 +19,12 @@ test_programs += common/thread/ExecutorThreadTester \
                  common/thread/FutureTester
 
 common_thread_ThreadTester_SOURCES = \
+    common/thread/MPSCQueueTest.cpp \
     common/thread/ThreadPoolTest.cpp \
-    common/thread/ThreadTest.cpp
+    common/thread/ThreadRolesTest.cpp \
+    common/thread/ThreadTest.cpp \
+    common/thread/TripleBufferTest.cpp \
+    common/thread/WorkStealingThreadPoolTest.cpp
 common_thread_ThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_thread_ThreadTester_LDADD = $(COMMON_TESTING_LIBS)
 
@@ -35,6 +35,7 @@
 
 #include "ola/Logging.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/ThreadRoles.h"
 #include "ola/thread/Utils.h"
 
 namespace  {
@@ -187,6 +188,9 @@ void *Thread::_InternalRun() {
   pthread_setname_np(pthread_self(), truncated_name.c_str(), NULL);
 #endif  // HAVE_PTHREAD_SETNAME_NP_3
 
+  ApplyThreadRole(Name());
+  RegisterThread(Name());
+
   int policy;
   struct sched_param param;
   pthread_getschedparam(pthread_self(), &policy, &param);
@@ -198,7 +202,9 @@ void *Thread::_InternalRun() {
     m_running = true;
   }
   m_condition.Signal();
-  return Run();
+  void *result = Run();
+  UnregisterThread();
+  return result;
 }
 }  // namespace thread
 }  // namespace ola
@@ -0,0 +1,286 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadRoles.cpp
+ * CPU placement and scheduling for threads, chosen by name.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/ThreadRoles.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace thread {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct RegisteredThread {
+  pthread_t id;
+  string name;
+};
+
+// Set before any threads start, so it isn't locked.
+ThreadRoleMap thread_roles;
+Mutex registry_mutex;
+vector<RegisteredThread> registered_threads;  // protected by registry_mutex
+
+bool ParsePriority(const string &role, int policy, const string &value,
+                   int *priority) {
+  if (!StringToInt(value, priority, true)) {
+    OLA_WARN << "Invalid priority " << value << " for thread role " << role;
+    return false;
+  }
+#ifdef _POSIX_PRIORITY_SCHEDULING
+  int min = sched_get_priority_min(policy);
+  int max = sched_get_priority_max(policy);
+  if (*priority < min || *priority > max) {
+    OLA_WARN << "The priority for thread role " << role << " must be between "
+             << min << " and " << max;
+    return false;
+  }
+#else
+  (void) policy;
+#endif  // _POSIX_PRIORITY_SCHEDULING
+  return true;
+}
+
+bool ParseRole(const string &input, ThreadRoleMap *roles) {
+  vector<string> tokens;
+  StringSplit(input, &tokens, ":");
+  const string &name = tokens[0];
+  if (name.empty() || name == "*") {
+    OLA_WARN << "Missing thread name in role " << input;
+    return false;
+  }
+
+  ThreadRole role;
+  vector<string>::const_iterator iter = tokens.begin() + 1;
+  for (; iter != tokens.end(); ++iter) {
+    string key = *iter;
+    string value;
+    string::size_type separator = key.find('=');
+    if (separator != string::npos) {
+      value = key.substr(separator + 1);
+      key.erase(separator);
+    }
+
+    vector<unsigned int> cpus;
+    if (key == "cpus") {
+      if (!ParseCPUList(value, &cpus)) {
+        OLA_WARN << "Invalid CPU list " << value << " for thread role "
+                 << name;
+        return false;
+      }
+    } else if (key == "node") {
+      unsigned int node;
+      if (!StringToInt(value, &node, true) || !NumaNodeCPUs(node, &cpus)) {
+        OLA_WARN << "Unknown NUMA node " << value << " for thread role "
+                 << name;
+        return false;
+      }
+    } else if (key == "fifo" || key == "rr") {
+      role.policy = key == "fifo" ? SCHED_FIFO : SCHED_RR;
+      if (!ParsePriority(name, role.policy, value, &role.priority)) {
+        return false;
+      }
+      role.set_scheduling = true;
+    } else if (key == "other" && value.empty()) {
+      role.policy = SCHED_OTHER;
+      role.priority = 0;
+      role.set_scheduling = true;
+    } else {
+      OLA_WARN << "Unknown setting " << *iter << " for thread role " << name;
+      return false;
+    }
+
+    // cpus and node may be combined.
+    role.cpus.insert(role.cpus.end(), cpus.begin(), cpus.end());
+    std::sort(role.cpus.begin(), role.cpus.end());
+    role.cpus.erase(std::unique(role.cpus.begin(), role.cpus.end()),
+                    role.cpus.end());
+  }
+  (*roles)[name] = role;
+  return true;
+}
+}  // namespace
+
+bool ParseThreadRoles(const string &input, ThreadRoleMap *roles) {
+  vector<string> tokens;
+  StringSplit(input, &tokens, ";");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    string role = *iter;
+    StringTrim(&role);
+    if (!role.empty() && !ParseRole(role, roles)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseCPUList(const string &input, vector<unsigned int> *cpus) {
+  vector<string> ranges;
+  StringSplit(input, &ranges, ",");
+  vector<unsigned int> output;
+  vector<string>::const_iterator iter = ranges.begin();
+  for (; iter != ranges.end(); ++iter) {
+    vector<string> ends;
+    StringSplit(*iter, &ends, "-");
+    unsigned int first, last;
+    if (ends.size() > 2 || !StringToInt(ends[0], &first, true)) {
+      return false;
+    }
+    last = first;
+    if (ends.size() == 2 && (!StringToInt(ends[1], &last, true) ||
+                             last < first)) {
+      return false;
+    }
+    for (unsigned int cpu = first; cpu <= last; cpu++) {
+      output.push_back(cpu);
+    }
+  }
+  std::sort(output.begin(), output.end());
+  output.erase(std::unique(output.begin(), output.end()), output.end());
+  cpus->swap(output);
+  return !cpus->empty();
+}
+
+bool NumaNodeCPUs(unsigned int node, vector<unsigned int> *cpus) {
+  std::ostringstream path;
+  path << "/sys/devices/system/node/node" << node << "/cpulist";
+  std::ifstream file(path.str().c_str());
+  string line;
+  if (!std::getline(file, line)) {
+    return false;
+  }
+  StringTrim(&line);
+  return ParseCPUList(line, cpus);
+}
+
+void SetThreadRoles(const ThreadRoleMap &roles) {
+  thread_roles = roles;
+}
+
+bool FindThreadRole(const string &name, ThreadRole *role) {
+  ThreadRoleMap::const_iterator iter = thread_roles.find(name);
+  if (iter != thread_roles.end()) {
+    *role = iter->second;
+    return true;
+  }
+
+  string::size_type longest_prefix = 0;
+  bool found = false;
+  for (iter = thread_roles.begin(); iter != thread_roles.end(); ++iter) {
+    string prefix = iter->first;
+    if (!StripSuffix(&prefix, "*")) {
+      continue;
+    }
+    if (name.compare(0, prefix.size(), prefix) == 0 &&
+        (!found || prefix.size() > longest_prefix)) {
+      *role = iter->second;
+      longest_prefix = prefix.size();
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool ApplyThreadRole(const string &name) {
+  ThreadRole role;
+  if (!FindThreadRole(name, &role)) {
+    return true;
+  }
+
+  bool ok = true;
+  if (!role.cpus.empty()) {
+    ok &= SetCPUAffinity(role.cpus);
+  }
+  if (role.set_scheduling) {
+    struct sched_param param;
+    param.sched_priority = role.priority;
+    ok &= SetSchedParam(pthread_self(), role.policy, param);
+  }
+  if (!ok) {
+    OLA_WARN << "Failed to apply the thread role for " << name;
+  }
+  return ok;
+}
+
+void RegisterThread(const string &name) {
+  RegisteredThread thread;
+  thread.id = pthread_self();
+  thread.name = name;
+  MutexLocker locker(&registry_mutex);
+  registered_threads.push_back(thread);
+}
+
+void UnregisterThread() {
+  const pthread_t self = pthread_self();
+  MutexLocker locker(&registry_mutex);
+  vector<RegisteredThread>::iterator iter = registered_threads.begin();
+  for (; iter != registered_threads.end(); ++iter) {
+    if (pthread_equal(iter->id, self)) {
+      registered_threads.erase(iter);
+      return;
+    }
+  }
+}
+
+bool GetThreadCPUTimes(map<string, uint64_t> *times) {
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+  // The lock stops a thread exiting while we read its clock.
+  MutexLocker locker(&registry_mutex);
+  vector<RegisteredThread>::const_iterator iter = registered_threads.begin();
+  for (; iter != registered_threads.end(); ++iter) {
+    clockid_t clock;
+    struct timespec now;
+    if (pthread_getcpuclockid(iter->id, &clock) ||
+        clock_gettime(clock, &now)) {
+      continue;
+    }
+    (*times)[iter->name] += static_cast<uint64_t>(now.tv_sec) * 1000000 +
+                            now.tv_nsec / 1000;
+  }
+  return true;
+#else
+  (void) times;
+  return false;
+#endif  // _POSIX_THREAD_CPUTIME
+}
+}  // namespace thread
+}  // namespace ola
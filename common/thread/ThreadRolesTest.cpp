@@ -0,0 +1,219 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadRolesTest.cpp
+ * Test fixture for the thread roles.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sched.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+#include "ola/thread/ThreadRoles.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::thread::ConditionVariable;
+using ola::thread::FindThreadRole;
+using ola::thread::GetThreadCPUTimes;
+using ola::thread::MutexLocker;
+using ola::thread::ParseCPUList;
+using ola::thread::ParseThreadRoles;
+using ola::thread::SetThreadRoles;
+using ola::thread::ThreadRole;
+using ola::thread::ThreadRoleMap;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Waits until it's told to exit.
+ */
+class IdleThread: public ola::thread::Thread {
+ public:
+  IdleThread()
+      : ola::thread::Thread(ola::thread::Thread::Options("idle")),
+        m_exit(false) {
+  }
+
+  void *Run() {
+    MutexLocker locker(&m_mutex);
+    while (!m_exit) {
+      m_condition.Wait(&m_mutex);
+    }
+    return NULL;
+  }
+
+  void Exit() {
+    {
+      MutexLocker locker(&m_mutex);
+      m_exit = true;
+    }
+    m_condition.Signal();
+  }
+
+ private:
+  ola::thread::Mutex m_mutex;
+  ConditionVariable m_condition;
+  bool m_exit;
+
+  DISALLOW_COPY_AND_ASSIGN(IdleThread);
+};
+}  // namespace
+
+
+class ThreadRolesTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ThreadRolesTest);
+  CPPUNIT_TEST(testParseCPUList);
+  CPPUNIT_TEST(testParseThreadRoles);
+  CPPUNIT_TEST(testFindThreadRole);
+  CPPUNIT_TEST(testCPUTimes);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void tearDown() {
+    SetThreadRoles(ThreadRoleMap());
+  }
+
+  void testParseCPUList();
+  void testParseThreadRoles();
+  void testFindThreadRole();
+  void testCPUTimes();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadRolesTest);
+
+void ThreadRolesTest::testParseCPUList() {
+  vector<unsigned int> cpus;
+  OLA_ASSERT_TRUE(ParseCPUList("3", &cpus));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), cpus.size());
+  OLA_ASSERT_EQ(3u, cpus[0]);
+
+  OLA_ASSERT_TRUE(ParseCPUList("6,0-2,1", &cpus));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), cpus.size());
+  OLA_ASSERT_EQ(0u, cpus[0]);
+  OLA_ASSERT_EQ(1u, cpus[1]);
+  OLA_ASSERT_EQ(2u, cpus[2]);
+  OLA_ASSERT_EQ(6u, cpus[3]);
+
+  OLA_ASSERT_FALSE(ParseCPUList("", &cpus));
+  OLA_ASSERT_FALSE(ParseCPUList("a", &cpus));
+  OLA_ASSERT_FALSE(ParseCPUList("1,", &cpus));
+  OLA_ASSERT_FALSE(ParseCPUList("3-1", &cpus));
+  OLA_ASSERT_FALSE(ParseCPUList("1-2-3", &cpus));
+  OLA_ASSERT_FALSE(ParseCPUList("-1", &cpus));
+}
+
+void ThreadRolesTest::testParseThreadRoles() {
+  ThreadRoleMap roles;
+  OLA_ASSERT_TRUE(ParseThreadRoles("", &roles));
+  OLA_ASSERT_TRUE(roles.empty());
+
+  OLA_ASSERT_TRUE(ParseThreadRoles(
+      "main:cpus=1:fifo=40; usb-*:cpus=2-3:rr=30;pref-saver:other;http",
+      &roles));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), roles.size());
+
+  const ThreadRole &main_role = roles["main"];
+  OLA_ASSERT_EQ(static_cast<size_t>(1), main_role.cpus.size());
+  OLA_ASSERT_EQ(1u, main_role.cpus[0]);
+  OLA_ASSERT_TRUE(main_role.set_scheduling);
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_FIFO), main_role.policy);
+  OLA_ASSERT_EQ(40, main_role.priority);
+
+  const ThreadRole &usb_role = roles["usb-*"];
+  OLA_ASSERT_EQ(static_cast<size_t>(2), usb_role.cpus.size());
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_RR), usb_role.policy);
+  OLA_ASSERT_EQ(30, usb_role.priority);
+
+  const ThreadRole &pref_role = roles["pref-saver"];
+  OLA_ASSERT_TRUE(pref_role.cpus.empty());
+  OLA_ASSERT_TRUE(pref_role.set_scheduling);
+  OLA_ASSERT_EQ(static_cast<int>(SCHED_OTHER), pref_role.policy);
+
+  OLA_ASSERT_FALSE(roles["http"].set_scheduling);
+  OLA_ASSERT_TRUE(roles["http"].cpus.empty());
+
+  OLA_ASSERT_FALSE(ParseThreadRoles(":cpus=1", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("*:cpus=1", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:cpus=", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:fifo=foo", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:fifo=1000", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:nice=1", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:other=1", &roles));
+  OLA_ASSERT_FALSE(ParseThreadRoles("main:node=100000", &roles));
+}
+
+void ThreadRolesTest::testFindThreadRole() {
+  ThreadRoleMap roles;
+  OLA_ASSERT_TRUE(ParseThreadRoles(
+      "usb-*:cpus=1;usb-sender*:cpus=2;usb-sender:cpus=3;main:cpus=4",
+      &roles));
+  SetThreadRoles(roles);
+
+  ThreadRole role;
+  OLA_ASSERT_TRUE(FindThreadRole("usb-sender", &role));
+  OLA_ASSERT_EQ(3u, role.cpus[0]);
+  OLA_ASSERT_TRUE(FindThreadRole("usb-sender-2", &role));
+  OLA_ASSERT_EQ(2u, role.cpus[0]);
+  OLA_ASSERT_TRUE(FindThreadRole("usb-receiver", &role));
+  OLA_ASSERT_EQ(1u, role.cpus[0]);
+  OLA_ASSERT_TRUE(FindThreadRole("main", &role));
+  OLA_ASSERT_EQ(4u, role.cpus[0]);
+  OLA_ASSERT_FALSE(FindThreadRole("main-2", &role));
+  OLA_ASSERT_FALSE(FindThreadRole("usb", &role));
+
+  // Threads without a role are left alone.
+  OLA_ASSERT_TRUE(ola::thread::ApplyThreadRole("http"));
+}
+
+void ThreadRolesTest::testCPUTimes() {
+  map<string, uint64_t> times;
+  if (!GetThreadCPUTimes(&times)) {
+    return;  // not supported on this platform
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(0), times.count("idle"));
+
+  IdleThread thread;
+  OLA_ASSERT_TRUE(thread.Start());
+  times.clear();
+  OLA_ASSERT_TRUE(GetThreadCPUTimes(&times));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), times.count("idle"));
+
+  thread.Exit();
+  thread.Join();
+  times.clear();
+  OLA_ASSERT_TRUE(GetThreadCPUTimes(&times));
+  OLA_ASSERT_EQ(static_cast<size_t>(0), times.count("idle"));
+
+  // The calling thread can register itself.
+  ola::thread::RegisterThread("test-main");
+  volatile uint64_t total = 0;
+  for (unsigned int i = 0; i < 10000000; i++) {
+    total += i;
+  }
+  times.clear();
+  OLA_ASSERT_TRUE(GetThreadCPUTimes(&times));
+  OLA_ASSERT_TRUE(times["test-main"] > 0);
+  ola::thread::UnregisterThread();
+}
@@ -0,0 +1,181 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TripleBufferTest.cpp
+ * Test fixture for the TripleBuffer class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::thread::TripleBuffer;
+
+namespace {
+
+struct Frame {
+  Frame() : sequence(0) {
+    memset(data, 0, sizeof(data));
+  }
+
+  unsigned int sequence;
+  uint8_t data[ola::DMX_UNIVERSE_SIZE];
+};
+
+/*
+ * Publishes frames where every slot is set to the sequence number.
+ */
+class ProducerThread: public ola::thread::Thread {
+ public:
+  ProducerThread(TripleBuffer<Frame> *mailbox, unsigned int count)
+      : m_mailbox(mailbox),
+        m_count(count) {
+  }
+
+  void *Run() {
+    for (unsigned int i = 1; i <= m_count; i++) {
+      Frame *frame = m_mailbox->WriteSlot();
+      frame->sequence = i;
+      memset(frame->data, i & 0xff, sizeof(frame->data));
+      m_mailbox->Publish();
+    }
+    return NULL;
+  }
+
+ private:
+  TripleBuffer<Frame> *m_mailbox;
+  const unsigned int m_count;
+
+  DISALLOW_COPY_AND_ASSIGN(ProducerThread);
+};
+}  // namespace
+
+
+class TripleBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TripleBufferTest);
+  CPPUNIT_TEST(testLatestValue);
+  CPPUNIT_TEST(testDmxBuffer);
+  CPPUNIT_TEST(testConcurrent);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testLatestValue();
+  void testDmxBuffer();
+  void testConcurrent();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TripleBufferTest);
+
+
+/*
+ * Check the consumer only sees the newest value, and that Publish() reports
+ * overwritten values.
+ */
+void TripleBufferTest::testLatestValue() {
+  TripleBuffer<unsigned int> mailbox;
+  OLA_ASSERT_FALSE(mailbox.HasNewValue());
+  OLA_ASSERT_FALSE(mailbox.Fetch());
+  OLA_ASSERT_EQ(0u, *mailbox.ReadSlot());
+
+  OLA_ASSERT_FALSE(mailbox.Write(1));
+  OLA_ASSERT_TRUE(mailbox.HasNewValue());
+  OLA_ASSERT_TRUE(mailbox.Fetch());
+  OLA_ASSERT_FALSE(mailbox.HasNewValue());
+  OLA_ASSERT_EQ(1u, *mailbox.ReadSlot());
+
+  // Nothing new, the read slot is unchanged.
+  OLA_ASSERT_FALSE(mailbox.Fetch());
+  OLA_ASSERT_EQ(1u, *mailbox.ReadSlot());
+
+  // The producer gets ahead.
+  OLA_ASSERT_FALSE(mailbox.Write(2));
+  OLA_ASSERT_TRUE(mailbox.Write(3));
+  OLA_ASSERT_TRUE(mailbox.Write(4));
+  OLA_ASSERT_EQ(1u, *mailbox.ReadSlot());
+  OLA_ASSERT_TRUE(mailbox.Fetch());
+  OLA_ASSERT_EQ(4u, *mailbox.ReadSlot());
+  OLA_ASSERT_FALSE(mailbox.Fetch());
+
+  // The slot the producer fills is never the one the consumer holds.
+  for (unsigned int i = 5; i < 20; i++) {
+    OLA_ASSERT_TRUE(mailbox.WriteSlot() != mailbox.ReadSlot());
+    mailbox.Write(i);
+    if (i % 3 == 0) {
+      OLA_ASSERT_TRUE(mailbox.Fetch());
+      OLA_ASSERT_EQ(i, *mailbox.ReadSlot());
+    }
+  }
+}
+
+
+/*
+ * Check DmxBuffers can be filled in place.
+ */
+void TripleBufferTest::testDmxBuffer() {
+  TripleBuffer<DmxBuffer> mailbox;
+  OLA_ASSERT_EQ(0u, mailbox.ReadSlot()->Size());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  mailbox.WriteSlot()->Set(buffer);
+  mailbox.Publish();
+  OLA_ASSERT_TRUE(mailbox.Fetch());
+  OLA_ASSERT_EQ(buffer, *mailbox.ReadSlot());
+
+  // The slot isn't shared with the source buffer.
+  buffer.SetChannel(0, 10);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), mailbox.ReadSlot()->Get(0));
+}
+
+
+/*
+ * Check the consumer never sees a partially written frame, and that the
+ * frames it sees are in order.
+ */
+void TripleBufferTest::testConcurrent() {
+  const unsigned int FRAMES = 50000;
+  TripleBuffer<Frame> mailbox;
+  ProducerThread producer(&mailbox, FRAMES);
+  OLA_ASSERT_TRUE(producer.Start());
+
+  unsigned int last_sequence = 0;
+  unsigned int fetched = 0;
+  while (last_sequence != FRAMES) {
+    if (!mailbox.Fetch()) {
+      continue;
+    }
+    const Frame *frame = mailbox.ReadSlot();
+    OLA_ASSERT_GT(frame->sequence, last_sequence);
+    last_sequence = frame->sequence;
+    fetched++;
+
+    const uint8_t expected = frame->sequence & 0xff;
+    for (unsigned int i = 0; i < sizeof(frame->data); i++) {
+      OLA_ASSERT_EQ(expected, frame->data[i]);
+    }
+  }
+  OLA_ASSERT_TRUE(producer.Join());
+  OLA_ASSERT_FALSE(mailbox.Fetch());
+  OLA_ASSERT_GT(fetched, 0u);
+}
@@ -20,9 +20,18 @@
 
 #include "ola/thread/Utils.h"
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
 #include <pthread.h>
+#ifdef HAVE_SCHED_SETAFFINITY
+#include <sched.h>
+#endif  // HAVE_SCHED_SETAFFINITY
 #include <string.h>
 #include <string>
+#include <vector>
 #include "ola/Logging.h"
 #include "ola/thread/Thread.h"
 
@@ -56,5 +65,48 @@ bool SetSchedParam(pthread_t thread, int policy,
   }
   return true;
 }
+
+bool SetCPUAffinity(int cpu) {
+#ifdef HAVE_SCHED_SETAFFINITY
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) < 0) {
+    OLA_WARN << "Failed to pin thread to CPU " << cpu << ": "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  OLA_WARN << "Unable to pin thread to CPU " << cpu
+           << ", sched_setaffinity() isn't available";
+  return false;
+#endif  // HAVE_SCHED_SETAFFINITY
+}
+
+bool SetCPUAffinity(const std::vector<unsigned int> &cpus) {
+#ifdef HAVE_SCHED_SETAFFINITY
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  std::vector<unsigned int>::const_iterator iter = cpus.begin();
+  for (; iter != cpus.end(); ++iter) {
+    if (*iter >= CPU_SETSIZE) {
+      OLA_WARN << "CPU " << *iter << " is out of range";
+      return false;
+    }
+    CPU_SET(*iter, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) < 0) {
+    OLA_WARN << "Failed to set the CPU affinity: " << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  (void) cpus;
+  OLA_WARN << "Unable to set the CPU affinity, sched_setaffinity() isn't "
+           << "available";
+  return false;
+#endif  // HAVE_SCHED_SETAFFINITY
+}
 }  // namespace thread
 }  // namespace ola
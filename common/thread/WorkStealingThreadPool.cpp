@@ -0,0 +1,361 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingThreadPool.cpp
+ * A thread pool with a deque per worker.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/thread/WorkStealingThreadPool.h"
+
+#include <pthread.h>
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/Thread.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace thread {
+
+using std::vector;
+
+namespace {
+/*
+ * Read a counter that's updated with the atomic builtins. This is a full
+ * barrier, which the sleep / wake protocol below relies on.
+ */
+inline int AtomicLoad(int *value) {
+  return __sync_fetch_and_add(value, 0);
+}
+}  // namespace
+
+/**
+ * A worker, this just hands off to WorkerLoop().
+ */
+class WorkStealingThreadPool::Worker : public Thread {
+ public:
+  Worker(WorkStealingThreadPool *pool, unsigned int index,
+         const Thread::Options &options)
+      : Thread(options),
+        m_pool(pool),
+        m_index(index) {
+  }
+
+  unsigned int Index() const { return m_index; }
+
+ protected:
+  void *Run() {
+    m_pool->WorkerLoop(this);
+    return NULL;
+  }
+
+ private:
+  WorkStealingThreadPool *m_pool;
+  const unsigned int m_index;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+
+WorkStealingThreadPool::WorkStealingThreadPool(const Options &options)
+    : m_options(options),
+      m_queued(0),
+      m_outstanding(0),
+      m_sleepers(0),
+      m_waiters(0),
+      m_next_queue(0),
+      m_shutdown(false) {
+  const unsigned int queues = std::max(1u, options.thread_count);
+  for (unsigned int i = 0; i < queues; i++) {
+    m_queues.push_back(new WorkQueue());
+  }
+  pthread_key_create(&m_worker_key, NULL);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  JoinAllThreads();
+  RunRemaining();
+  STLDeleteElements(&m_queues);
+  pthread_key_delete(m_worker_key);
+}
+
+bool WorkStealingThreadPool::Init() {
+  if (!m_workers.empty()) {
+    OLA_WARN << "Thread pool already started";
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_queues.size(); i++) {
+    std::ostringstream name;
+    name << m_options.name << "-" << i;
+    Worker *worker = new Worker(this, i, Thread::Options(name.str()));
+    if (!worker->Start()) {
+      OLA_WARN << "Failed to start worker " << i
+               << ", aborting WorkStealingThreadPool::Init()";
+      delete worker;
+      JoinAllThreads();
+      return false;
+    }
+    m_workers.push_back(worker);
+  }
+  return true;
+}
+
+void WorkStealingThreadPool::JoinAll() {
+  JoinAllThreads();
+  RunRemaining();
+}
+
+int WorkStealingThreadPool::CurrentWorker() const {
+  const Worker *worker = reinterpret_cast<const Worker*>(
+      pthread_getspecific(m_worker_key));
+  return worker ? static_cast<int>(worker->Index()) : -1;
+}
+
+void WorkStealingThreadPool::Execute(ola::BaseCallback0<void> *task) {
+  int worker = CurrentWorker();
+  WorkQueue *queue;
+  if (worker >= 0) {
+    queue = m_queues[worker];
+  } else {
+    queue = m_queues[__sync_fetch_and_add(&m_next_queue, 1) %
+                     m_queues.size()];
+  }
+  PushTask(queue, task, false);
+}
+
+void WorkStealingThreadPool::ExecuteOn(unsigned int worker,
+                                       ola::BaseCallback0<void> *task) {
+  PushTask(m_queues[worker % m_queues.size()], task, true);
+}
+
+void WorkStealingThreadPool::DrainCallbacks() {
+  WaitUntil(NewCallback(this, &WorkStealingThreadPool::AllTasksComplete));
+}
+
+Future<void> WorkStealingThreadPool::Submit(
+    SingleUseCallback0<void> *task) {
+  Future<void> future;
+  Execute(NewSingleCallback(&WorkStealingThreadPool::RunAndSetVoid, task,
+                            future));
+  return future;
+}
+
+/*
+ * The main loop for each worker.
+ *
+ * A thread that's about to sleep increments m_sleepers and then checks for
+ * work, and PushTask() increments the task count and then checks
+ * m_sleepers. Both use full barriers, so either the sleeper sees the new
+ * task or PushTask() sees the sleeper and signals it.
+ */
+void WorkStealingThreadPool::WorkerLoop(Worker *worker) {
+  const unsigned int index = worker->Index();
+  pthread_setspecific(m_worker_key, worker);
+  if (!m_options.cpus.empty()) {
+    SetCPUAffinity(m_options.cpus[index % m_options.cpus.size()]);
+  }
+
+  while (true) {
+    if (RunOneTask(index)) {
+      continue;
+    }
+
+    MutexLocker locker(&m_mutex);
+    __sync_fetch_and_add(&m_sleepers, 1);
+    while (!m_shutdown && !HasWork(index)) {
+      m_condition.Wait(&m_mutex);
+    }
+    __sync_fetch_and_sub(&m_sleepers, 1);
+    if (m_shutdown && !HasWork(index)) {
+      break;
+    }
+  }
+}
+
+/*
+ * Run one task, either from this worker's deque or stolen from another
+ * worker.
+ * @param worker the index of the worker, or -1 if this isn't a worker.
+ * @returns true if a task was run, false if there was nothing to do.
+ */
+bool WorkStealingThreadPool::RunOneTask(int worker) {
+  Action task;
+  if ((worker >= 0 && PopOwnTask(worker, &task)) ||
+      StealTask(worker, &task)) {
+    RunTask(task);
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Pinned tasks run first, in the order they were queued. Otherwise take the
+ * newest task, it's the one most likely to be in cache.
+ */
+bool WorkStealingThreadPool::PopOwnTask(unsigned int worker, Action *task) {
+  WorkQueue *queue = m_queues[worker];
+  MutexLocker locker(&queue->mutex);
+  if (!queue->pinned.empty()) {
+    *task = queue->pinned.front();
+    queue->pinned.pop_front();
+    __sync_fetch_and_sub(&queue->pinned_count, 1);
+    return true;
+  }
+  if (!queue->tasks.empty()) {
+    *task = queue->tasks.back();
+    queue->tasks.pop_back();
+    __sync_fetch_and_sub(&m_queued, 1);
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Steal the oldest task from another worker, starting with the next one
+ * along so the thieves spread out.
+ */
+bool WorkStealingThreadPool::StealTask(int thief, Action *task) {
+  const unsigned int queue_count = m_queues.size();
+  const unsigned int start = thief >= 0 ?
+      thief + 1 : __sync_fetch_and_add(&m_next_queue, 1);
+
+  for (unsigned int i = 0; i < queue_count; i++) {
+    if (AtomicLoad(&m_queued) == 0) {
+      return false;
+    }
+    unsigned int index = (start + i) % queue_count;
+    if (static_cast<int>(index) == thief) {
+      continue;
+    }
+    WorkQueue *queue = m_queues[index];
+    MutexLocker locker(&queue->mutex);
+    if (!queue->tasks.empty()) {
+      *task = queue->tasks.front();
+      queue->tasks.pop_front();
+      __sync_fetch_and_sub(&m_queued, 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::RunTask(Action task) {
+  task->Run();
+  __sync_fetch_and_sub(&m_outstanding, 1);
+  if (AtomicLoad(&m_waiters) > 0) {
+    // Someone in WaitUntil() may be waiting on this task.
+    MutexLocker locker(&m_mutex);
+    m_condition.Broadcast();
+  }
+}
+
+/*
+ * Run tasks until is_complete returns true.
+ */
+void WorkStealingThreadPool::WaitUntil(BaseCallback0<bool> *is_complete) {
+  const int worker = CurrentWorker();
+  __sync_fetch_and_add(&m_waiters, 1);
+  while (!is_complete->Run()) {
+    if (RunOneTask(worker)) {
+      continue;
+    }
+
+    MutexLocker locker(&m_mutex);
+    __sync_fetch_and_add(&m_sleepers, 1);
+    while (!HasWork(worker) && !is_complete->Run()) {
+      m_condition.Wait(&m_mutex);
+    }
+    __sync_fetch_and_sub(&m_sleepers, 1);
+  }
+  __sync_fetch_and_sub(&m_waiters, 1);
+  delete is_complete;
+}
+
+bool WorkStealingThreadPool::AllTasksComplete() {
+  return AtomicLoad(&m_outstanding) == 0;
+}
+
+void WorkStealingThreadPool::PushTask(WorkQueue *queue, Action task,
+                                      bool pinned) {
+  __sync_fetch_and_add(&m_outstanding, 1);
+  {
+    MutexLocker locker(&queue->mutex);
+    if (pinned) {
+      queue->pinned.push_back(task);
+      __sync_fetch_and_add(&queue->pinned_count, 1);
+    } else {
+      queue->tasks.push_back(task);
+      __sync_fetch_and_add(&m_queued, 1);
+    }
+  }
+
+  if (AtomicLoad(&m_sleepers) > 0) {
+    MutexLocker locker(&m_mutex);
+    // Only the owner can run a pinned task, so wake everyone.
+    if (pinned) {
+      m_condition.Broadcast();
+    } else {
+      m_condition.Signal();
+    }
+  }
+}
+
+void WorkStealingThreadPool::JoinAllThreads() {
+  if (m_workers.empty()) {
+    return;
+  }
+
+  {
+    MutexLocker locker(&m_mutex);
+    m_shutdown = true;
+    m_condition.Broadcast();
+  }
+
+  vector<Worker*>::iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    (*iter)->Join();
+  }
+  STLDeleteElements(&m_workers);
+}
+
+/*
+ * Run anything left behind once the workers have stopped, including tasks
+ * pinned to a worker.
+ */
+void WorkStealingThreadPool::RunRemaining() {
+  for (unsigned int i = 0; i < m_queues.size(); i++) {
+    while (RunOneTask(i)) {}
+  }
+}
+
+bool WorkStealingThreadPool::HasWork(int worker) {
+  return AtomicLoad(&m_queued) > 0 ||
+      (worker >= 0 && AtomicLoad(&m_queues[worker]->pinned_count) > 0);
+}
+
+void WorkStealingThreadPool::RunAndSetVoid(SingleUseCallback0<void> *task,
+                                           Future<void> future) {
+  task->Run();
+  future.Set();
+}
+}  // namespace thread
+}  // namespace ola
@@ -0,0 +1,212 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingThreadPoolTest.cpp
+ * Test fixture for the WorkStealingThreadPool class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/WorkStealingThreadPool.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::NewSingleCallback;
+using ola::thread::Future;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using ola::thread::WorkStealingThreadPool;
+using std::vector;
+
+class WorkStealingThreadPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WorkStealingThreadPoolTest);
+  CPPUNIT_TEST(testExecute);
+  CPPUNIT_TEST(testSubmit);
+  CPPUNIT_TEST(testFanOut);
+  CPPUNIT_TEST(testExecuteOn);
+  CPPUNIT_TEST(testRunRemaining);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testExecute();
+    void testSubmit();
+    void testFanOut();
+    void testExecuteOn();
+    void testRunRemaining();
+
+    void setUp() {
+      m_counter = 0;
+    }
+
+ private:
+    unsigned int m_counter;
+    Mutex m_mutex;
+    vector<unsigned int> m_order;
+    vector<int> m_workers;
+
+    void IncrementCounter() {
+      MutexLocker locker(&m_mutex);
+      m_counter++;
+    }
+
+    void RecordTask(WorkStealingThreadPool *pool, unsigned int task) {
+      MutexLocker locker(&m_mutex);
+      m_order.push_back(task);
+      m_workers.push_back(pool->CurrentWorker());
+    }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkStealingThreadPoolTest);
+
+namespace {
+int Square(int i) {
+  return i * i;
+}
+
+/*
+ * Sum the integers in [start, end) by splitting the range in two and
+ * submitting each half to the pool.
+ */
+unsigned int ParallelSum(WorkStealingThreadPool *pool, unsigned int start,
+                         unsigned int end) {
+  if (end - start <= 4) {
+    unsigned int total = 0;
+    for (unsigned int i = start; i < end; i++) {
+      total += i;
+    }
+    return total;
+  }
+  unsigned int middle = start + (end - start) / 2;
+  Future<unsigned int> left = pool->Submit(
+      NewSingleCallback(&ParallelSum, pool, start, middle));
+  Future<unsigned int> right = pool->Submit(
+      NewSingleCallback(&ParallelSum, pool, middle, end));
+  pool->Wait(&left);
+  pool->Wait(&right);
+  return left.Get() + right.Get();
+}
+}  // namespace
+
+
+/*
+ * Check that each task runs exactly once.
+ */
+void WorkStealingThreadPoolTest::testExecute() {
+  WorkStealingThreadPool::Options options;
+  options.thread_count = 4;
+  options.cpus.push_back(0);
+  WorkStealingThreadPool pool(options);
+  OLA_ASSERT_TRUE(pool.Init());
+  OLA_ASSERT_EQ(4u, pool.WorkerCount());
+  OLA_ASSERT_EQ(-1, pool.CurrentWorker());
+
+  for (unsigned int i = 0; i < 1000; i++) {
+    pool.Execute(NewSingleCallback(
+        this, &WorkStealingThreadPoolTest::IncrementCounter));
+  }
+  pool.DrainCallbacks();
+  OLA_ASSERT_EQ(1000u, m_counter);
+  pool.JoinAll();
+}
+
+
+/*
+ * Check the results of Submit() are returned through the futures.
+ */
+void WorkStealingThreadPoolTest::testSubmit() {
+  WorkStealingThreadPool pool;
+  OLA_ASSERT_TRUE(pool.Init());
+
+  vector<Future<int> > results;
+  for (int i = 0; i < 100; i++) {
+    results.push_back(pool.Submit(NewSingleCallback(&Square, i)));
+  }
+
+  Future<void> done = pool.Submit(NewSingleCallback(
+      this, &WorkStealingThreadPoolTest::IncrementCounter));
+
+  for (int i = 0; i < 100; i++) {
+    pool.Wait(&results[i]);
+    OLA_ASSERT_EQ(i * i, results[i].Get());
+  }
+  pool.Wait(&done);
+  OLA_ASSERT_EQ(1u, m_counter);
+}
+
+
+/*
+ * Check tasks can wait on the tasks they submit. With a single worker this
+ * would deadlock if Wait() blocked the worker.
+ */
+void WorkStealingThreadPoolTest::testFanOut() {
+  for (unsigned int threads = 1; threads <= 4; threads += 3) {
+    WorkStealingThreadPool::Options options;
+    options.thread_count = threads;
+    WorkStealingThreadPool pool(options);
+    OLA_ASSERT_TRUE(pool.Init());
+
+    Future<unsigned int> result = pool.Submit(
+        NewSingleCallback(&ParallelSum, &pool, 0u, 1000u));
+    pool.Wait(&result);
+    OLA_ASSERT_EQ(499500u, result.Get());
+  }
+}
+
+
+/*
+ * Check pinned tasks run on the right worker, in order.
+ */
+void WorkStealingThreadPoolTest::testExecuteOn() {
+  WorkStealingThreadPool::Options options;
+  options.thread_count = 3;
+  WorkStealingThreadPool pool(options);
+  OLA_ASSERT_TRUE(pool.Init());
+
+  for (unsigned int i = 0; i < 100; i++) {
+    pool.ExecuteOn(4, NewSingleCallback(
+        this, &WorkStealingThreadPoolTest::RecordTask, &pool, i));
+  }
+  pool.DrainCallbacks();
+
+  OLA_ASSERT_EQ(static_cast<size_t>(100), m_order.size());
+  for (unsigned int i = 0; i < m_order.size(); i++) {
+    OLA_ASSERT_EQ(i, m_order[i]);
+    OLA_ASSERT_EQ(1, m_workers[i]);
+  }
+}
+
+
+/*
+ * Check tasks queued without any workers run when the pool is destroyed.
+ */
+void WorkStealingThreadPoolTest::testRunRemaining() {
+  {
+    WorkStealingThreadPool pool;
+    for (unsigned int i = 0; i < 10; i++) {
+      pool.Execute(NewSingleCallback(
+          this, &WorkStealingThreadPoolTest::IncrementCounter));
+      pool.ExecuteOn(i, NewSingleCallback(
+          this, &WorkStealingThreadPoolTest::IncrementCounter));
+    }
+    OLA_ASSERT_EQ(0u, m_counter);
+  }
+  OLA_ASSERT_EQ(20u, m_counter);
+}
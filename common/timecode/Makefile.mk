@@ -1,13 +1,19 @@
 # LIBRARIES
 ##################################################
 common_libolacommon_la_SOURCES += \
-    common/timecode/TimeCode.cpp
+    common/timecode/TimeCode.cpp \
+    common/timecode/TimeCodeSharedMemory.cpp
 
 # TESTS
 ##################################################
-test_programs += common/timecode/TimeCodeTester
+test_programs += common/timecode/TimeCodeTester \
+                 common/timecode/TimeCodeSharedMemoryTester
 
 common_timecode_TimeCodeTester_SOURCES = common/timecode/TimeCodeTest.cpp
 common_timecode_TimeCodeTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_timecode_TimeCodeTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_timecode_TimeCodeSharedMemoryTester_SOURCES = \
+    common/timecode/TimeCodeSharedMemoryTest.cpp
+common_timecode_TimeCodeSharedMemoryTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_timecode_TimeCodeSharedMemoryTester_LDADD = $(COMMON_TESTING_LIBS)
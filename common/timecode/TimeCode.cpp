@@ -33,6 +33,14 @@ using std::setw;
 using std::setfill;
 using std::string;
 
+namespace {
+// Drop frame timecode skips frames 0 & 1 at the start of each minute, except
+// for every tenth minute.
+const unsigned int DROPPED_FRAMES = 2;
+const uint32_t DF_FRAMES_PER_MINUTE = 30 * 60 - DROPPED_FRAMES;
+const uint32_t DF_FRAMES_PER_TEN_MINUTES = 10 * DF_FRAMES_PER_MINUTE +
+                                           DROPPED_FRAMES;
+}  // namespace
 
 TimeCode::TimeCode(const TimeCode &other)
     : m_type(other.m_type),
@@ -73,6 +81,59 @@ bool TimeCode::IsValid() const {
   return false;
 }
 
+uint32_t TimeCode::FrameNumber() const {
+  const uint32_t minutes = 60 * m_hours + m_minutes;
+  uint32_t frame_number = (minutes * 60 + m_seconds) * FramesPerSecond(m_type) +
+                          m_frames;
+  if (m_type == TIMECODE_DF) {
+    frame_number -= DROPPED_FRAMES * (minutes - minutes / 10);
+  }
+  return frame_number;
+}
+
+TimeCode TimeCode::FromFrameNumber(TimeCodeType type, uint32_t frame_number) {
+  frame_number %= FramesPerDay(type);
+  if (type == TIMECODE_DF) {
+    // Add back the frame numbers that were skipped.
+    const uint32_t ten_minutes = frame_number / DF_FRAMES_PER_TEN_MINUTES;
+    const uint32_t remainder = frame_number % DF_FRAMES_PER_TEN_MINUTES;
+    frame_number += 9 * DROPPED_FRAMES * ten_minutes;
+    if (remainder >= DROPPED_FRAMES) {
+      frame_number += DROPPED_FRAMES *
+          ((remainder - DROPPED_FRAMES) / DF_FRAMES_PER_MINUTE);
+    }
+  }
+
+  const unsigned int fps = FramesPerSecond(type);
+  const uint8_t frames = frame_number % fps;
+  frame_number /= fps;
+  const uint8_t seconds = frame_number % 60;
+  frame_number /= 60;
+  const uint8_t minutes = frame_number % 60;
+  return TimeCode(type, static_cast<uint8_t>(frame_number / 60), minutes,
+                  seconds, frames);
+}
+
+uint32_t TimeCode::FramesPerDay(TimeCodeType type) {
+  if (type == TIMECODE_DF) {
+    return 24 * 6 * DF_FRAMES_PER_TEN_MINUTES;
+  }
+  return 24 * 60 * 60 * FramesPerSecond(type);
+}
+
+unsigned int TimeCode::FramesPerSecond(TimeCodeType type) {
+  switch (type) {
+    case TIMECODE_FILM:
+      return 24;
+    case TIMECODE_EBU:
+      return 25;
+    case TIMECODE_DF:
+    case TIMECODE_SMPTE:
+      return 30;
+  }
+  return 30;
+}
+
 string TimeCode::AsString() const {
   std::ostringstream str;
   str << setw(2) << setfill('0') << static_cast<int>(m_hours) << ":"
@@ -0,0 +1,206 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimeCodeSharedMemory.cpp
+ * The current timecode, published through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/timecode/TimeCodeSharedMemory.h"
+
+namespace ola {
+namespace timecode {
+
+using std::string;
+
+/*
+ * The layout of the segment. Both sides are on the same machine, so the
+ * fields are in host byte order.
+ */
+struct TimeCodeSharedMemory::Segment {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  volatile uint32_t sequence;  // odd while the frame is being written
+  uint8_t type;
+  uint8_t hours;
+  uint8_t minutes;
+  uint8_t seconds;
+  uint8_t frames;
+  uint8_t running;
+  uint16_t reserved2;
+  uint32_t frame_number;
+  int64_t frame_time_sec;
+  int32_t frame_time_usec;
+  uint32_t reserved3;
+};
+
+const char TimeCodeSharedMemory::DEFAULT_NAME[] = "/ola-timecode";
+
+namespace {
+const uint32_t SEGMENT_MAGIC = 0x4f4c5443;  // OLTC
+const uint16_t SEGMENT_VERSION = 1;
+// How many times Read() retries if the writer updates the frame under it.
+const unsigned int MAX_READ_ATTEMPTS = 4;
+}  // namespace
+
+TimeCodeSharedMemory::~TimeCodeSharedMemory() {
+  munmap(m_memory, sizeof(Segment));
+}
+
+TimeCodeSharedMemory *TimeCodeSharedMemory::Create(const string &name) {
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  if (ftruncate(fd, sizeof(Segment))) {
+    OLA_WARN << "ftruncate(" << name << "): " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, sizeof(Segment), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate() zeros the segment, so the sequence number starts at 0, which
+  // means no frame has been written.
+  Segment *segment = reinterpret_cast<Segment*>(memory);
+  segment->version = SEGMENT_VERSION;
+  __sync_synchronize();
+  segment->magic = SEGMENT_MAGIC;
+  return new TimeCodeSharedMemory(name, memory, true);
+}
+
+TimeCodeSharedMemory *TimeCodeSharedMemory::Open(const string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) ||
+      static_cast<size_t>(stat_buf.st_size) < sizeof(Segment)) {
+    OLA_WARN << "Shared memory segment " << name << " is too small";
+    close(fd);
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << name << "): " << strerror(errno);
+    return NULL;
+  }
+
+  const Segment *segment = reinterpret_cast<Segment*>(memory);
+  if (segment->magic != SEGMENT_MAGIC ||
+      segment->version != SEGMENT_VERSION) {
+    OLA_WARN << "Invalid shared memory segment " << name;
+    munmap(memory, sizeof(Segment));
+    return NULL;
+  }
+  return new TimeCodeSharedMemory(name, memory, false);
+}
+
+void TimeCodeSharedMemory::Unlink() {
+  shm_unlink(m_name.c_str());
+}
+
+void TimeCodeSharedMemory::Write(const Frame &frame) {
+  if (!m_writable) {
+    OLA_WARN << "Attempt to write to read only segment " << m_name;
+    return;
+  }
+
+  const uint32_t sequence = m_segment->sequence;
+  m_segment->sequence = sequence + 1;
+  __sync_synchronize();
+
+  m_segment->type = static_cast<uint8_t>(frame.timecode.Type());
+  m_segment->hours = frame.timecode.Hours();
+  m_segment->minutes = frame.timecode.Minutes();
+  m_segment->seconds = frame.timecode.Seconds();
+  m_segment->frames = frame.timecode.Frames();
+  m_segment->running = frame.running;
+  m_segment->frame_number = frame.frame_number;
+  m_segment->frame_time_sec = frame.frame_time.Seconds();
+  m_segment->frame_time_usec = frame.frame_time.MicroSeconds();
+
+  __sync_synchronize();
+  m_segment->sequence = sequence + 2;
+}
+
+bool TimeCodeSharedMemory::Read(Frame *frame) const {
+  for (unsigned int i = 0; i < MAX_READ_ATTEMPTS; i++) {
+    const uint32_t sequence = m_segment->sequence;
+    if (sequence == 0) {
+      return false;
+    }
+    if (sequence & 1) {
+      continue;
+    }
+    __sync_synchronize();
+
+    Segment copy = *m_segment;
+
+    __sync_synchronize();
+    if (m_segment->sequence != sequence) {
+      continue;
+    }
+
+    struct timeval tv;
+    tv.tv_sec = copy.frame_time_sec;
+    tv.tv_usec = copy.frame_time_usec;
+    frame->timecode = TimeCode(static_cast<TimeCodeType>(copy.type),
+                               copy.hours, copy.minutes, copy.seconds,
+                               copy.frames);
+    frame->frame_number = copy.frame_number;
+    frame->frame_time = TimeStamp(tv);
+    frame->running = copy.running;
+    return true;
+  }
+  return false;
+}
+
+TimeCodeSharedMemory::TimeCodeSharedMemory(const string &name, void *memory,
+                                           bool writable)
+    : m_name(name),
+      m_memory(memory),
+      m_writable(writable),
+      m_segment(reinterpret_cast<Segment*>(memory)) {
+}
+}  // namespace timecode
+}  // namespace ola
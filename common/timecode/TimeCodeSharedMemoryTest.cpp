@@ -0,0 +1,144 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimeCodeSharedMemoryTest.cpp
+ * Test fixture for the TimeCodeSharedMemory class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeSharedMemory.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::Clock;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeSharedMemory;
+using std::auto_ptr;
+using std::string;
+
+class TimeCodeSharedMemoryTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TimeCodeSharedMemoryTest);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testReplace);
+  CPPUNIT_TEST(testInvalid);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testReadWrite();
+  void testReplace();
+  void testInvalid();
+
+ private:
+  string m_name;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeSharedMemoryTest);
+
+void TimeCodeSharedMemoryTest::setUp() {
+  std::ostringstream str;
+  str << TimeCodeSharedMemory::DEFAULT_NAME << "-test-" << getpid();
+  m_name = str.str();
+}
+
+void TimeCodeSharedMemoryTest::tearDown() {
+  auto_ptr<TimeCodeSharedMemory> memory(TimeCodeSharedMemory::Open(m_name));
+  if (memory.get()) {
+    memory->Unlink();
+  }
+}
+
+/*
+ * Check frames written by olad can be read by the readers.
+ */
+void TimeCodeSharedMemoryTest::testReadWrite() {
+  auto_ptr<TimeCodeSharedMemory> writer(TimeCodeSharedMemory::Create(m_name));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<TimeCodeSharedMemory> reader1(TimeCodeSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader1.get());
+  auto_ptr<TimeCodeSharedMemory> reader2(TimeCodeSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader2.get());
+
+  // nothing written yet
+  TimeCodeSharedMemory::Frame frame;
+  OLA_ASSERT_FALSE(reader1->Read(&frame));
+
+  Clock clock;
+  TimeCodeSharedMemory::Frame written;
+  written.timecode = TimeCode(ola::timecode::TIMECODE_EBU, 1, 2, 3, 4);
+  written.frame_number = written.timecode.FrameNumber();
+  clock.CurrentTime(&written.frame_time);
+  written.running = true;
+  writer->Write(written);
+
+  OLA_ASSERT_TRUE(reader1->Read(&frame));
+  OLA_ASSERT_EQ(written.timecode, frame.timecode);
+  OLA_ASSERT_EQ(written.frame_number, frame.frame_number);
+  OLA_ASSERT_EQ(written.frame_time, frame.frame_time);
+  OLA_ASSERT_TRUE(frame.running);
+
+  // Reads don't consume the frame
+  OLA_ASSERT_TRUE(reader1->Read(&frame));
+  OLA_ASSERT_TRUE(reader2->Read(&frame));
+  OLA_ASSERT_EQ(written.timecode, frame.timecode);
+
+  written.timecode = TimeCode(ola::timecode::TIMECODE_EBU, 1, 2, 3, 5);
+  written.frame_number++;
+  written.running = false;
+  writer->Write(written);
+  OLA_ASSERT_TRUE(reader2->Read(&frame));
+  OLA_ASSERT_EQ(written.timecode, frame.timecode);
+  OLA_ASSERT_EQ(written.frame_number, frame.frame_number);
+  OLA_ASSERT_FALSE(frame.running);
+
+  // Readers can't write
+  reader1->Write(TimeCodeSharedMemory::Frame());
+  OLA_ASSERT_TRUE(reader1->Read(&frame));
+  OLA_ASSERT_EQ(written.timecode, frame.timecode);
+}
+
+/*
+ * Check a new writer replaces a segment that was left behind.
+ */
+void TimeCodeSharedMemoryTest::testReplace() {
+  auto_ptr<TimeCodeSharedMemory> writer(TimeCodeSharedMemory::Create(m_name));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  TimeCodeSharedMemory::Frame written;
+  written.running = true;
+  writer->Write(written);
+
+  writer.reset(TimeCodeSharedMemory::Create(m_name));
+  OLA_ASSERT_NOT_NULL(writer.get());
+  auto_ptr<TimeCodeSharedMemory> reader(TimeCodeSharedMemory::Open(m_name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+  TimeCodeSharedMemory::Frame frame;
+  OLA_ASSERT_FALSE(reader->Read(&frame));
+}
+
+/*
+ * Check segments that don't exist aren't opened.
+ */
+void TimeCodeSharedMemoryTest::testInvalid() {
+  OLA_ASSERT_NULL(TimeCodeSharedMemory::Open(m_name));
+}
@@ -39,11 +39,15 @@ class TimeCodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(TimeCodeTest);
   CPPUNIT_TEST(testTimeCode);
   CPPUNIT_TEST(testIsValid);
+  CPPUNIT_TEST(testFrameNumber);
+  CPPUNIT_TEST(testDropFrame);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testTimeCode();
     void testIsValid();
+    void testFrameNumber();
+    void testDropFrame();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeTest);
@@ -97,3 +101,66 @@ void TimeCodeTest::testIsValid() {
   TimeCode t4(TIMECODE_SMPTE, 0, 0, 0, 30);
   OLA_ASSERT_FALSE(t4.IsValid());
 }
+
+
+/**
+ * Test converting to and from frame numbers.
+ */
+void TimeCodeTest::testFrameNumber() {
+  TimeCode t1(TIMECODE_EBU, 0, 0, 0, 0);
+  OLA_ASSERT_EQ(0u, t1.FrameNumber());
+  OLA_ASSERT_EQ(t1, TimeCode::FromFrameNumber(TIMECODE_EBU, 0));
+
+  TimeCode t2(TIMECODE_EBU, 1, 2, 3, 4);
+  OLA_ASSERT_EQ(93079u, t2.FrameNumber());
+  OLA_ASSERT_EQ(t2, TimeCode::FromFrameNumber(TIMECODE_EBU, 93079));
+
+  TimeCode t3(TIMECODE_FILM, 23, 59, 59, 23);
+  OLA_ASSERT_EQ(TimeCode::FramesPerDay(TIMECODE_FILM) - 1, t3.FrameNumber());
+  OLA_ASSERT_EQ(t3, TimeCode::FromFrameNumber(TIMECODE_FILM,
+                                              t3.FrameNumber()));
+
+  // Frame numbers wrap at midnight
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_SMPTE, 0, 0, 0, 1),
+                TimeCode::FromFrameNumber(
+                    TIMECODE_SMPTE,
+                    TimeCode::FramesPerDay(TIMECODE_SMPTE) + 1));
+  OLA_ASSERT_EQ(2592000u, TimeCode::FramesPerDay(TIMECODE_SMPTE));
+}
+
+/**
+ * Test drop frame timecode skips the right frames.
+ */
+void TimeCodeTest::testDropFrame() {
+  OLA_ASSERT_EQ(2589408u, TimeCode::FramesPerDay(TIMECODE_DF));
+
+  TimeCode last_frame(TIMECODE_DF, 0, 0, 59, 29);
+  OLA_ASSERT_EQ(1799u, last_frame.FrameNumber());
+  OLA_ASSERT_EQ(last_frame, TimeCode::FromFrameNumber(TIMECODE_DF, 1799));
+
+  // 00:01:00;00 and 00:01:00;01 are skipped
+  TimeCode first_frame(TIMECODE_DF, 0, 1, 0, 2);
+  OLA_ASSERT_EQ(1800u, first_frame.FrameNumber());
+  OLA_ASSERT_EQ(first_frame, TimeCode::FromFrameNumber(TIMECODE_DF, 1800));
+
+  // but not on the tenth minute
+  TimeCode tenth_minute(TIMECODE_DF, 0, 10, 0, 0);
+  OLA_ASSERT_EQ(17982u, tenth_minute.FrameNumber());
+  OLA_ASSERT_EQ(tenth_minute, TimeCode::FromFrameNumber(TIMECODE_DF, 17982));
+
+  // Every frame number round trips, and the frames are consecutive.
+  TimeCode previous = TimeCode::FromFrameNumber(TIMECODE_DF, 0);
+  for (uint32_t i = 1; i < 2 * 17982; i++) {
+    TimeCode timecode = TimeCode::FromFrameNumber(TIMECODE_DF, i);
+    OLA_ASSERT_EQ(i, timecode.FrameNumber());
+    OLA_ASSERT_TRUE(timecode.IsValid());
+    if (timecode.Seconds() == previous.Seconds()) {
+      OLA_ASSERT_EQ(previous.Frames() + 1, static_cast<int>(timecode.Frames()));
+    } else if (timecode.Seconds() == 0 && timecode.Minutes() % 10) {
+      OLA_ASSERT_EQ(static_cast<uint8_t>(2), timecode.Frames());
+    } else {
+      OLA_ASSERT_EQ(static_cast<uint8_t>(0), timecode.Frames());
+    }
+    previous = timecode;
+  }
+}
@@ -29,6 +29,7 @@
 #include <ola/Clock.h>
 #include <stdint.h>
 #include <sys/time.h>
+#include <time.h>
 
 #if HAVE_CONFIG_H
 #include <config.h>
@@ -257,6 +258,52 @@ void Clock::CurrentTime(TimeStamp *timestamp) const {
   *timestamp = tv;
 }
 
+MonotonicClock::MonotonicClock(bool coarse)
+    : Clock(),
+      m_clock_id(0),
+      m_use_monotonic(false) {
+#ifdef CLOCK_MONOTONIC
+  m_clock_id = CLOCK_MONOTONIC;
+#ifdef CLOCK_MONOTONIC_COARSE
+  if (coarse) {
+    m_clock_id = CLOCK_MONOTONIC_COARSE;
+  }
+#endif  // CLOCK_MONOTONIC_COARSE
+  struct timespec ts;
+  m_use_monotonic = clock_gettime(m_clock_id, &ts) == 0;
+#endif  // CLOCK_MONOTONIC
+  (void) coarse;
+
+  if (m_use_monotonic) {
+    TimeStamp wall_time, monotonic_time;
+    Clock::CurrentTime(&wall_time);
+    MonotonicTime(&monotonic_time);
+    m_offset = wall_time - monotonic_time;
+  }
+}
+
+void MonotonicClock::CurrentTime(TimeStamp *timestamp) const {
+  if (m_use_monotonic) {
+    MonotonicTime(timestamp);
+    *timestamp += m_offset;
+  } else {
+    Clock::CurrentTime(timestamp);
+  }
+}
+
+void MonotonicClock::MonotonicTime(TimeStamp *timestamp) const {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  clock_gettime(m_clock_id, &ts);
+  struct timeval tv;
+  tv.tv_sec = ts.tv_sec;
+  tv.tv_usec = ts.tv_nsec / 1000;
+  *timestamp = tv;
+#else
+  Clock::CurrentTime(timestamp);
+#endif  // CLOCK_MONOTONIC
+}
+
 void MockClock::AdvanceTime(const TimeInterval &interval) {
   m_offset += interval;
 }
@@ -38,6 +38,8 @@ class ClockTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTimeIntervalMutliplication);
   CPPUNIT_TEST(testClock);
   CPPUNIT_TEST(testMockClock);
+  CPPUNIT_TEST(testMonotonicClock);
+  CPPUNIT_TEST(testCachedClock);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -46,13 +48,17 @@ class ClockTest: public CppUnit::TestFixture {
     void testTimeIntervalMutliplication();
     void testClock();
     void testMockClock();
+    void testMonotonicClock();
+    void testCachedClock();
 };
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ClockTest);
 
+using ola::CachedClock;
 using ola::Clock;
 using ola::MockClock;
+using ola::MonotonicClock;
 using ola::TimeStamp;
 using ola::TimeInterval;
 using std::string;
@@ -188,3 +194,51 @@ void ClockTest::testMockClock() {
   OLA_ASSERT_LT(second, third);
   OLA_ASSERT_TRUE(ten_point_five_seconds <= (third - second));
 }
+
+
+/**
+ * Test the MonotonicClock tracks the wall clock.
+ */
+void ClockTest::testMonotonicClock() {
+  Clock clock;
+  MonotonicClock monotonic_clock;
+  MonotonicClock coarse_clock(true);
+
+  TimeStamp wall_time, monotonic_time, coarse_time;
+  clock.CurrentTime(&wall_time);
+  monotonic_clock.CurrentTime(&monotonic_time);
+  coarse_clock.CurrentTime(&coarse_time);
+
+  // The coarse clock can lag by a tick, allow a generous margin either way.
+  TimeInterval margin(1, 0);
+  OLA_ASSERT_TRUE(wall_time - margin < monotonic_time);
+  OLA_ASSERT_TRUE(monotonic_time < wall_time + margin);
+  OLA_ASSERT_TRUE(wall_time - margin < coarse_time);
+  OLA_ASSERT_TRUE(coarse_time < wall_time + margin);
+
+  TimeStamp later;
+  monotonic_clock.CurrentTime(&later);
+  OLA_ASSERT_TRUE(monotonic_time <= later);
+}
+
+
+/**
+ * Test the CachedClock.
+ */
+void ClockTest::testCachedClock() {
+  MockClock mock_clock;
+  TimeStamp cached_time;
+  CachedClock clock(&cached_time, &mock_clock);
+
+  // Not set, so this uses the fallback clock.
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  OLA_ASSERT_TRUE(now.IsSet());
+
+  mock_clock.CurrentTime(&cached_time);
+  mock_clock.AdvanceTime(10, 0);
+
+  TimeStamp cached;
+  clock.CurrentTime(&cached);
+  OLA_ASSERT_EQ(cached_time, cached);
+}
@@ -27,28 +27,71 @@
  * @file DmxBuffer.cpp
  */
 
+#include <ctype.h>
 #include <string.h>
 #include <algorithm>
 #include <iostream>
 #include <string>
-#include <vector>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "common/dmx/DmxBufferPool.h"
+#include "common/dmx/MergeKernels.h"
 
 namespace ola {
 
+using ola::dmx::DmxBufferBlock;
+using ola::dmx::DmxBufferPool;
+using ola::dmx::SlotRange;
 using std::min;
 using std::max;
 using std::string;
-using std::vector;
+
+namespace {
+/*
+ * Convert a token to a slot value in the same way as atoi(). Leading
+ * whitespace and a sign are allowed, parsing stops at the first non-digit and
+ * the result is truncated to 8 bits. Invalid tokens are 0.
+ */
+uint8_t ParseSlotValue(const char *start, const char *end) {
+  while (start != end && isspace(*start)) {
+    start++;
+  }
+  bool negative = false;
+  if (start != end && (*start == '-' || *start == '+')) {
+    negative = *start == '-';
+    start++;
+  }
+  // Unsigned arithmetic wraps, which leaves the low 8 bits correct.
+  unsigned int value = 0;
+  for (; start != end && *start >= '0' && *start <= '9'; start++) {
+    value = value * 10 + (*start - '0');
+  }
+  return static_cast<uint8_t>(negative ? 0u - value : value);
+}
+
+/*
+ * Return the smallest range that covers both ranges.
+ */
+SlotRange MergeRanges(const SlotRange &a, const SlotRange &b) {
+  if (a.start == a.end) {
+    return b;
+  } else if (b.start == b.end) {
+    return a;
+  }
+  SlotRange range = {min(a.start, b.start), max(a.end, b.end)};
+  return range;
+}
+}  // namespace
 
 DmxBuffer::DmxBuffer()
     : m_ref_count(NULL),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changed_start(0),
+      m_changed_end(0) {
 }
 
 
@@ -56,10 +99,13 @@ DmxBuffer::DmxBuffer(const DmxBuffer &other)
     : m_ref_count(NULL),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changed_start(0),
+      m_changed_end(0) {
 
   if (other.m_data && other.m_ref_count) {
     CopyFromOther(other);
+    MarkChanged(0, m_length);
   }
 }
 
@@ -68,7 +114,9 @@ DmxBuffer::DmxBuffer(const uint8_t *data, unsigned int length)
     : m_ref_count(0),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changed_start(0),
+      m_changed_end(0) {
   Set(data, length);
 }
 
@@ -77,7 +125,9 @@ DmxBuffer::DmxBuffer(const string &data)
     : m_ref_count(0),
       m_copy_on_write(false),
       m_data(NULL),
-      m_length(0) {
+      m_length(0),
+      m_changed_start(0),
+      m_changed_end(0) {
     Set(data);
 }
 
@@ -89,6 +139,8 @@ DmxBuffer::~DmxBuffer() {
 
 DmxBuffer& DmxBuffer::operator=(const DmxBuffer &other) {
   if (this != &other) {
+    RecordChanges(0, m_data, m_length, other.m_data,
+                  other.m_data ? other.m_length : 0);
     CleanupMemory();
     if (other.m_data) {
       CopyFromOther(other);
@@ -98,6 +150,22 @@ DmxBuffer& DmxBuffer::operator=(const DmxBuffer &other) {
 }
 
 
+void DmxBuffer::Swap(DmxBuffer *other) {
+  if (this == other) {
+    return;
+  }
+  const unsigned int length = m_data ? m_length : 0;
+  const unsigned int other_length = other->m_data ? other->m_length : 0;
+  RecordChanges(0, m_data, length, other->m_data, other_length);
+  other->RecordChanges(0, other->m_data, other_length, m_data, length);
+
+  std::swap(m_ref_count, other->m_ref_count);
+  std::swap(m_copy_on_write, other->m_copy_on_write);
+  std::swap(m_data, other->m_data);
+  std::swap(m_length, other->m_length);
+}
+
+
 bool DmxBuffer::operator==(const DmxBuffer &other) const {
   return (m_length == other.m_length &&
           (m_data == other.m_data ||
@@ -121,30 +189,164 @@ bool DmxBuffer::HTPMerge(const DmxBuffer &other) {
                                   other.m_length);
   unsigned int merge_length = min(m_length, other.m_length);
 
-  for (unsigned int i = 0; i < merge_length; i++) {
-    m_data[i] = max(m_data[i], other.m_data[i]);
-  }
+  unsigned int old_length = m_length;
+  SlotRange changed = ola::dmx::MaxMerge(m_data, other.m_data, merge_length);
+  MarkChanged(changed.start, changed.end);
 
   if (other_length > m_length) {
     memcpy(m_data + merge_length, other.m_data + merge_length,
            other_length - merge_length);
     m_length = other_length;
   }
+  MarkChanged(old_length, m_length);
   return true;
 }
 
 
+bool DmxBuffer::HTPMergeMany(const DmxBuffer *const *sources,
+                             unsigned int count) {
+  unsigned int min_length = DMX_UNIVERSE_SIZE;
+  unsigned int max_length = 0;
+  bool merging_into_self = false;
+  for (unsigned int i = 0; i < count; i++) {
+    if (!sources[i]->m_data || !sources[i]->m_length) {
+      continue;
+    }
+    min_length = min(min_length, sources[i]->m_length);
+    max_length = max(max_length, sources[i]->m_length);
+    if (sources[i] == this) {
+      merging_into_self = true;
+    }
+  }
+
+  if (!max_length) {
+    Reset();
+    return true;
+  }
+
+  unsigned int old_length = m_data ? m_length : 0;
+
+  // If we're not one of the sources all of our data is about to be
+  // overwritten, so there is no need to copy it first. The shared data is
+  // kept until the merge is done so we can work out what changed.
+  unsigned int *shared_ref_count = NULL;
+  const uint8_t *shared_data = NULL;
+  if (m_copy_on_write && !merging_into_self && *m_ref_count > 1) {
+    shared_ref_count = m_ref_count;
+    shared_data = m_data;
+    m_copy_on_write = false;
+    Init();
+  }
+  if (!m_data) {
+    if (!Init())
+      return false;
+  }
+  DuplicateIfNeeded();
+  unsigned int own_length = merging_into_self ? m_length : 0;
+  SlotRange changed = {0, 0};
+
+  // Merge the region covered by all sources. The kernels take a fixed number
+  // of sources at a time so we avoid allocating; after the first group our
+  // own data is used as the starting point for the next one. The kernels
+  // report the slots they changed, so with more than one group a slot which
+  // changed and then changed back is still counted.
+  const uint8_t *group[MERGE_GROUP_SIZE];
+  unsigned int group_size = 0;
+  bool first_group = true;
+  for (unsigned int i = 0; i < count; i++) {
+    if (!sources[i]->m_data || !sources[i]->m_length) {
+      continue;
+    }
+    if (group_size == MERGE_GROUP_SIZE) {
+      changed = MergeRanges(
+          changed, ola::dmx::MaxMergeMany(m_data, group, group_size,
+                                          min_length));
+      first_group = false;
+      group_size = 0;
+    }
+    if (!first_group && group_size == 0) {
+      group[group_size++] = m_data;
+    }
+    group[group_size++] = sources[i]->m_data;
+  }
+  changed = MergeRanges(
+      changed, ola::dmx::MaxMergeMany(m_data, group, group_size, min_length));
+
+  // Now handle the slots that only some of the sources cover. This is rare,
+  // so it's done a slot at a time.
+  for (unsigned int slot = min_length; slot < max_length; slot++) {
+    uint8_t value = slot < own_length ? m_data[slot] : DMX_MIN_SLOT_VALUE;
+    for (unsigned int i = 0; i < count; i++) {
+      const DmxBuffer *source = sources[i];
+      if (source != this && source->m_data && slot < source->m_length) {
+        value = max(value, source->m_data[slot]);
+      }
+    }
+    if (value != m_data[slot]) {
+      m_data[slot] = value;
+      SlotRange slot_range = {slot, slot + 1};
+      changed = MergeRanges(changed, slot_range);
+    }
+  }
+  m_length = max_length;
+
+  if (shared_data) {
+    // We merged into new memory, so compare with the data we shared.
+    RecordChanges(0, shared_data, old_length, m_data, m_length);
+    (*shared_ref_count)--;
+  } else {
+    MarkChanged(changed.start, changed.end);
+    // Slots we didn't hold before, or no longer hold, always count.
+    MarkChanged(min(old_length, max_length), max(old_length, max_length));
+  }
+  return true;
+}
+
+
+bool DmxBuffer::PriorityMergeMany(const DmxBuffer *const *sources,
+                                  const uint8_t *const *priorities,
+                                  unsigned int count,
+                                  uint8_t *slot_priorities) {
+  // Merge into local storage since we may be one of the sources.
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  uint8_t local_priorities[DMX_UNIVERSE_SIZE];
+  uint8_t *winning_priorities = (
+      slot_priorities ? slot_priorities : local_priorities);
+  memset(data, DMX_MIN_SLOT_VALUE, DMX_UNIVERSE_SIZE);
+  memset(winning_priorities, 0, DMX_UNIVERSE_SIZE);
+
+  unsigned int max_length = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    if (!sources[i]->m_data || !sources[i]->m_length) {
+      continue;
+    }
+    ola::dmx::PriorityMerge(data, winning_priorities, sources[i]->m_data,
+                            priorities[i], sources[i]->m_length);
+    max_length = max(max_length, sources[i]->m_length);
+  }
+
+  if (!max_length) {
+    Reset();
+    return true;
+  }
+  return Set(data, max_length);
+}
+
+
 bool DmxBuffer::Set(const uint8_t *data, unsigned int length) {
   if (!data)
     return false;
 
+  length = min(length, (unsigned int) DMX_UNIVERSE_SIZE);
+  RecordChanges(0, m_data, m_length, data, length);
+
   if (m_copy_on_write)
     CleanupMemory();
   if (!m_data) {
     if (!Init())
       return false;
   }
-  m_length = min(length, (unsigned int) DMX_UNIVERSE_SIZE);
+  m_length = length;
   memcpy(m_data, data, m_length);
   return true;
 }
@@ -161,27 +363,22 @@ bool DmxBuffer::Set(const DmxBuffer &other) {
 
 
 bool DmxBuffer::SetFromString(const string &input) {
-  unsigned int i = 0;
-  vector<string> dmx_values;
-  vector<string>::const_iterator iter;
-
-  if (m_copy_on_write)
-    CleanupMemory();
-  if (!m_data)
-    if (!Init())
-      return false;
-
-  if (input.empty()) {
-    m_length = 0;
-    return true;
-  }
-  StringSplit(input, &dmx_values, ",");
-  for (iter = dmx_values.begin();
-      iter != dmx_values.end() && i < DMX_UNIVERSE_SIZE; ++iter, ++i) {
-    m_data[i] = atoi(iter->data());
+  // Parse in place, this is called for every frame sent over HTTP.
+  uint8_t values[DMX_UNIVERSE_SIZE];
+  unsigned int length = 0;
+  if (!input.empty()) {
+    const char *token = input.data();
+    const char *end = token + input.size();
+    while (length < DMX_UNIVERSE_SIZE) {
+      const char *comma = std::find(token, end, ',');
+      values[length++] = ParseSlotValue(token, comma);
+      if (comma == end) {
+        break;
+      }
+      token = comma + 1;
+    }
   }
-  m_length = i;
-  return true;
+  return Set(values, length);
 }
 
 
@@ -201,6 +398,7 @@ bool DmxBuffer::SetRangeToValue(unsigned int offset,
   DuplicateIfNeeded();
 
   unsigned int copy_length = min(length, DMX_UNIVERSE_SIZE - offset);
+  RecordValueChanges(offset, value, copy_length);
   memset(m_data + offset, value, copy_length);
   m_length = max(m_length, offset + copy_length);
   return true;
@@ -223,6 +421,8 @@ bool DmxBuffer::SetRange(unsigned int offset,
   DuplicateIfNeeded();
 
   unsigned int copy_length = min(length, DMX_UNIVERSE_SIZE - offset);
+  RecordChanges(offset, m_data + offset, min(copy_length, m_length - offset),
+                data, copy_length);
   memcpy(m_data + offset, data, copy_length);
   m_length = max(m_length, offset + copy_length);
   return true;
@@ -244,6 +444,9 @@ void DmxBuffer::SetChannel(unsigned int channel, uint8_t data) {
   }
 
   DuplicateIfNeeded();
+  if (channel == m_length || m_data[channel] != data) {
+    MarkChanged(channel, channel + 1);
+  }
   m_data[channel] = data;
   m_length = max(channel+1, m_length);
 }
@@ -292,6 +495,7 @@ string DmxBuffer::Get() const {
 
 
 bool DmxBuffer::Blackout() {
+  RecordValueChanges(0, DMX_MIN_SLOT_VALUE, DMX_UNIVERSE_SIZE);
   if (m_copy_on_write) {
     CleanupMemory();
   }
@@ -308,6 +512,7 @@ bool DmxBuffer::Blackout() {
 
 void DmxBuffer::Reset() {
   if (m_data) {
+    MarkChanged(0, m_length);
     m_length = 0;
   }
 }
@@ -335,10 +540,11 @@ string DmxBuffer::ToString() const {
  * @return true on success, otherwise raises an exception
  */
 bool DmxBuffer::Init() {
-  m_data = new uint8_t[DMX_UNIVERSE_SIZE];
-  m_ref_count = new unsigned int;
+  DmxBufferBlock *block = DmxBufferPool::Global()->Allocate();
+  block->ref_count = 1;
+  m_ref_count = &block->ref_count;
+  m_data = block->data;
   m_length = 0;
-  *m_ref_count = 1;
   return true;
 }
 
@@ -358,7 +564,8 @@ bool DmxBuffer::DuplicateIfNeeded() {
     unsigned int length = m_length;
     m_copy_on_write = false;
     if (Init()) {
-      Set(original_data, length);
+      memcpy(m_data, original_data, length);
+      m_length = length;
       (*old_ref_count)--;
       return true;
     }
@@ -390,8 +597,8 @@ void DmxBuffer::CleanupMemory() {
   if (m_ref_count && m_data) {
     (*m_ref_count)--;
     if (!*m_ref_count) {
-      delete[] m_data;
-      delete m_ref_count;
+      DmxBufferPool::Global()->Release(
+          DmxBufferBlock::FromRefCount(m_ref_count));
     }
     m_data = NULL;
     m_ref_count = NULL;
@@ -399,6 +606,90 @@ void DmxBuffer::CleanupMemory() {
   }
 }
 
+
+/*
+ * Extend the changed range to include [start, end).
+ */
+void DmxBuffer::MarkChanged(unsigned int start, unsigned int end) {
+  if (start >= end) {
+    return;
+  }
+  if (HasChanges()) {
+    m_changed_start = min(m_changed_start, start);
+    m_changed_end = max(m_changed_end, end);
+  } else {
+    m_changed_start = start;
+    m_changed_end = end;
+  }
+}
+
+
+/*
+ * Compare the data for a region of the buffer before and after a change, and
+ * mark any slots that differ as changed. Slots past the end of the shorter
+ * version are always counted as changed.
+ * @param offset the offset of the region within the buffer
+ * @param old_data the old contents of the region
+ * @param old_length the old length of the region
+ * @param new_data the new contents of the region
+ * @param new_length the new length of the region
+ */
+void DmxBuffer::RecordChanges(unsigned int offset,
+                              const uint8_t *old_data,
+                              unsigned int old_length,
+                              const uint8_t *new_data,
+                              unsigned int new_length) {
+  unsigned int common_length = min(old_length, new_length);
+  unsigned int end = max(old_length, new_length);
+
+  unsigned int first = 0;
+  if (old_data == new_data) {
+    first = common_length;
+  } else {
+    while (first < common_length && old_data[first] == new_data[first]) {
+      first++;
+    }
+  }
+  if (first == end) {
+    return;
+  }
+
+  unsigned int last = end;
+  if (last == common_length) {
+    while (last > first && old_data[last - 1] == new_data[last - 1]) {
+      last--;
+    }
+  }
+  MarkChanged(offset + first, offset + last);
+}
+
+
+/*
+ * Mark the slots in [offset, offset + length) that don't already hold value
+ * as changed. This must be called before the data is modified.
+ */
+void DmxBuffer::RecordValueChanges(unsigned int offset, uint8_t value,
+                                   unsigned int length) {
+  unsigned int end = offset + length;
+  unsigned int first = offset;
+  unsigned int data_end = m_data ? min(end, m_length) : offset;
+  while (first < data_end && m_data[first] == value) {
+    first++;
+  }
+  if (first == end) {
+    return;
+  }
+
+  unsigned int last = end;
+  if (data_end == end) {
+    while (last > first && m_data[last - 1] == value) {
+      last--;
+    }
+  }
+  MarkChanged(first, last);
+}
+
+
 std::ostream& operator<<(std::ostream &out, const DmxBuffer &data) {
   return out << data.ToString();
 }
@@ -37,13 +37,17 @@ class DmxBufferTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testStringGetSet);
   CPPUNIT_TEST(testAssign);
   CPPUNIT_TEST(testCopy);
+  CPPUNIT_TEST(testSwap);
   CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMergeMany);
+  CPPUNIT_TEST(testPriorityMergeMany);
   CPPUNIT_TEST(testStringToDmx);
   CPPUNIT_TEST(testCopyOnWrite);
   CPPUNIT_TEST(testSetRange);
   CPPUNIT_TEST(testSetRangeToValue);
   CPPUNIT_TEST(testSetChannel);
   CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testChangeTracking);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -52,13 +56,17 @@ class DmxBufferTest: public CppUnit::TestFixture {
     void testAssign();
     void testStringGetSet();
     void testCopy();
+    void testSwap();
     void testMerge();
+    void testMergeMany();
+    void testPriorityMergeMany();
     void testStringToDmx();
     void testCopyOnWrite();
     void testSetRange();
     void testSetRangeToValue();
     void testSetChannel();
     void testToString();
+    void testChangeTracking();
 
  private:
     static const uint8_t TEST_DATA[];
@@ -254,6 +262,47 @@ void DmxBufferTest::testCopy() {
 }
 
 
+/*
+ * Check that Swap() exchanges the data and records the changes.
+ */
+void DmxBufferTest::testSwap() {
+  DmxBuffer buffer(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer other(TEST_DATA2, sizeof(TEST_DATA2));
+  DmxBuffer copy(buffer);
+  const uint8_t *data = buffer.GetRaw();
+  buffer.ClearChanges();
+  other.ClearChanges();
+
+  buffer.Swap(&other);
+  OLA_ASSERT_EQ((unsigned int) sizeof(TEST_DATA2), buffer.Size());
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA2, sizeof(TEST_DATA2), buffer.GetRaw(),
+                         buffer.Size());
+  OLA_ASSERT_TRUE(other == copy);
+  // the memory moved with the data
+  OLA_ASSERT_EQ(data, other.GetRaw());
+
+  unsigned int offset, length;
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ((unsigned int) sizeof(TEST_DATA2), length);
+  OLA_ASSERT_TRUE(other.HasChanges());
+
+  // the shared data is still copy-on-write
+  other.SetChannel(0, 100);
+  OLA_ASSERT_EQ((uint8_t) 1, copy.Get(0));
+  OLA_ASSERT_EQ((uint8_t) 100, other.Get(0));
+
+  // swapping with an empty buffer
+  DmxBuffer empty;
+  empty.Swap(&buffer);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_NULL(buffer.GetRaw());
+  OLA_ASSERT_EQ((unsigned int) sizeof(TEST_DATA2), empty.Size());
+  buffer.Swap(&buffer);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+}
+
+
 /*
  * Check that HTP Merging works
  */
@@ -286,6 +335,109 @@ void DmxBufferTest::testMerge() {
 }
 
 
+/*
+ * Check that merging many buffers at once works
+ */
+void DmxBufferTest::testMergeMany() {
+  DmxBuffer buffer1(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer buffer2(TEST_DATA2, sizeof(TEST_DATA2));
+  DmxBuffer buffer3(TEST_DATA3, sizeof(TEST_DATA3));
+  DmxBuffer uninitialized_buffer;
+  DmxBuffer merge_result(MERGE_RESULT2, sizeof(MERGE_RESULT2));
+
+  // no sources resets the buffer
+  DmxBuffer result(TEST_DATA, sizeof(TEST_DATA));
+  OLA_ASSERT_TRUE(result.HTPMergeMany(NULL, 0));
+  OLA_ASSERT_EQ(0u, result.Size());
+
+  // empty sources are skipped
+  const DmxBuffer *empty_sources[] = {&uninitialized_buffer};
+  OLA_ASSERT_TRUE(result.HTPMergeMany(empty_sources, 1));
+  OLA_ASSERT_EQ(0u, result.Size());
+
+  // sources of different lengths
+  const DmxBuffer *sources[] = {&buffer1, &uninitialized_buffer, &buffer2,
+                                &buffer3};
+  DmxBuffer uninitialized_result;
+  OLA_ASSERT_TRUE(uninitialized_result.HTPMergeMany(sources, 4));
+  OLA_ASSERT_TRUE(merge_result == uninitialized_result);
+
+  // the result matches a Reset() & HTPMerge() sequence
+  DmxBuffer expected;
+  expected.HTPMerge(buffer1);
+  expected.HTPMerge(buffer2);
+  expected.HTPMerge(buffer3);
+  OLA_ASSERT_TRUE(expected == uninitialized_result);
+
+  // merge into a buffer that shares data with one of the sources
+  DmxBuffer copy_on_write(buffer2);
+  OLA_ASSERT_TRUE(copy_on_write.HTPMergeMany(sources, 4));
+  OLA_ASSERT_TRUE(merge_result == copy_on_write);
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA2, sizeof(TEST_DATA2), buffer2.GetRaw(),
+                         buffer2.Size());
+
+  // merge into one of the sources, this one is shorter than the result
+  DmxBuffer self(TEST_DATA3, sizeof(TEST_DATA3));
+  const DmxBuffer *self_sources[] = {&buffer2, &self, &buffer1};
+  OLA_ASSERT_TRUE(self.HTPMergeMany(self_sources, 3));
+  OLA_ASSERT_TRUE(merge_result == self);
+
+  // more sources than are merged in a single pass
+  DmxBuffer buffers[20];
+  const DmxBuffer *many_sources[20];
+  for (unsigned int i = 0; i < 20; i++) {
+    buffers[i].Blackout();
+    buffers[i].SetChannel(i, i + 1);
+    many_sources[i] = &buffers[i];
+  }
+  OLA_ASSERT_TRUE(result.HTPMergeMany(many_sources, 20));
+  OLA_ASSERT_EQ((unsigned int) ola::DMX_UNIVERSE_SIZE, result.Size());
+  for (unsigned int i = 0; i < 20; i++) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(i + 1), result.Get(i));
+  }
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), result.Get(20));
+}
+
+
+/*
+ * Check the per-slot priority merge.
+ */
+void DmxBufferTest::testPriorityMergeMany() {
+  const uint8_t data1[] = {10, 20, 30, 40};
+  const uint8_t priorities1[] = {100, 100, 0, 50};
+  const uint8_t data2[] = {50, 5, 60, 30, 90, 80};
+  const uint8_t priorities2[] = {100, 50, 0, 100, 20, 0};
+  DmxBuffer buffer1(data1, sizeof(data1));
+  DmxBuffer buffer2(data2, sizeof(data2));
+  DmxBuffer uninitialized_buffer;
+
+  // no sources resets the buffer
+  DmxBuffer result(data1, sizeof(data1));
+  OLA_ASSERT_TRUE(result.PriorityMergeMany(NULL, NULL, 0));
+  OLA_ASSERT_EQ(0u, result.Size());
+
+  const DmxBuffer *sources[] = {&buffer1, &uninitialized_buffer, &buffer2};
+  const uint8_t *priorities[] = {priorities1, NULL, priorities2};
+  uint8_t slot_priorities[ola::DMX_UNIVERSE_SIZE];
+  OLA_ASSERT_TRUE(result.PriorityMergeMany(sources, priorities, 3,
+                                           slot_priorities));
+
+  // slot 0 is HTP, slot 1 is the higher priority, slot 2 isn't controlled
+  // and slot 5 is priority 0.
+  const uint8_t expected[] = {50, 20, 0, 30, 90, 0};
+  const uint8_t expected_priorities[] = {100, 100, 0, 100, 20, 0};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), result.GetRaw(),
+                         result.Size());
+  OLA_ASSERT_DATA_EQUALS(expected_priorities, sizeof(expected_priorities),
+                         slot_priorities, sizeof(expected_priorities));
+  OLA_ASSERT_EQ(0, static_cast<int>(slot_priorities[sizeof(data2)]));
+
+  // merge into one of the sources
+  OLA_ASSERT_TRUE(buffer2.PriorityMergeMany(sources, priorities, 3));
+  OLA_ASSERT_TRUE(result == buffer2);
+}
+
+
 /*
  * Run the StringToDmxTest
  * @param input the string to parse
@@ -330,6 +482,23 @@ void DmxBufferTest::testStringToDmx() {
   input = "";
   uint8_t expected7[] = {};
   runStringToDmx(input, DmxBuffer(expected7, sizeof(expected7)));
+
+  input = "+1, -1,12x,\t7";
+  uint8_t expected8[] = {1, 255, 12, 7};
+  runStringToDmx(input, DmxBuffer(expected8, sizeof(expected8)));
+
+  input = ",";
+  uint8_t expected9[] = {0, 0};
+  runStringToDmx(input, DmxBuffer(expected9, sizeof(expected9)));
+
+  // values past the end of the universe are dropped
+  input = "1";
+  for (unsigned int i = 1; i < ola::DMX_UNIVERSE_SIZE + 10; i++) {
+    input.append(",1");
+  }
+  DmxBuffer expected10;
+  expected10.SetRangeToValue(0, 1, ola::DMX_UNIVERSE_SIZE);
+  runStringToDmx(input, expected10);
 }
 
 
@@ -524,3 +693,137 @@ void DmxBufferTest::testToString() {
   str << buffer;
   OLA_ASSERT_EQ(string("1,2,3,4"), str.str());
 }
+
+
+/*
+ * Check that we record which slots have changed.
+ */
+void DmxBufferTest::testChangeTracking() {
+  unsigned int offset, length;
+  DmxBuffer buffer;
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, length);
+
+  // new data is a change
+  OLA_ASSERT_TRUE(buffer.Set(TEST_DATA2, sizeof(TEST_DATA2)));
+  OLA_ASSERT_TRUE(buffer.HasChanges());
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ((unsigned int) sizeof(TEST_DATA2), length);
+  buffer.ClearChanges();
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+
+  // setting the same data isn't
+  OLA_ASSERT_TRUE(buffer.Set(TEST_DATA2, sizeof(TEST_DATA2)));
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  buffer.SetChannel(3, TEST_DATA2[3]);
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  OLA_ASSERT_TRUE(buffer.SetRange(2, TEST_DATA2 + 2, 4));
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+
+  // single slots
+  buffer.SetChannel(3, 100);
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(3u, offset);
+  OLA_ASSERT_EQ(1u, length);
+  buffer.SetChannel(6, 100);
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(3u, offset);
+  OLA_ASSERT_EQ(4u, length);
+  buffer.ClearChanges();
+
+  // Set only records the slots that differ
+  uint8_t data[sizeof(TEST_DATA2)];
+  memcpy(data, TEST_DATA2, sizeof(data));
+  data[3] = 100;
+  data[6] = 100;
+  data[5] = 0;
+  OLA_ASSERT_TRUE(buffer.Set(data, sizeof(data)));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(5u, offset);
+  OLA_ASSERT_EQ(1u, length);
+  buffer.ClearChanges();
+
+  // SetRange & SetRangeToValue
+  const uint8_t range[] = {data[1], 50, data[3]};
+  OLA_ASSERT_TRUE(buffer.SetRange(1, range, sizeof(range)));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(2u, offset);
+  OLA_ASSERT_EQ(1u, length);
+  buffer.ClearChanges();
+  OLA_ASSERT_TRUE(buffer.SetRangeToValue(7, 100, 4));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(7u, offset);
+  OLA_ASSERT_EQ(4u, length);
+  OLA_ASSERT_EQ(11u, buffer.Size());
+  buffer.ClearChanges();
+
+  // shrinking the buffer changes the slots at the end
+  OLA_ASSERT_TRUE(buffer.SetRange(0, data, 4));
+  buffer.ClearChanges();
+  OLA_ASSERT_TRUE(buffer.Set(data, 4));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(4u, offset);
+  OLA_ASSERT_EQ(7u, length);
+  buffer.ClearChanges();
+
+  buffer.Reset();
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(4u, length);
+  buffer.ClearChanges();
+
+  // Blackout only changes the non-zero slots
+  OLA_ASSERT_TRUE(buffer.SetFromString("0,0,5,0"));
+  buffer.ClearChanges();
+  OLA_ASSERT_TRUE(buffer.Blackout());
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(2u, offset);
+  OLA_ASSERT_EQ((unsigned int) ola::DMX_UNIVERSE_SIZE - 2, length);
+  buffer.ClearChanges();
+
+  // HTP merges
+  DmxBuffer source(TEST_DATA3, sizeof(TEST_DATA3));
+  OLA_ASSERT_TRUE(buffer.SetFromString("10,20,12"));
+  buffer.ClearChanges();
+  OLA_ASSERT_TRUE(buffer.HTPMerge(source));
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  source.SetChannel(1, 30);
+  OLA_ASSERT_TRUE(buffer.HTPMerge(source));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(1u, offset);
+  OLA_ASSERT_EQ(1u, length);
+  buffer.ClearChanges();
+
+  source.SetChannel(2, 200);
+  DmxBuffer other(TEST_DATA2, sizeof(TEST_DATA2));
+  const DmxBuffer *sources[] = {&source, &other};
+  OLA_ASSERT_TRUE(buffer.HTPMergeMany(sources, 2));
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(2u, offset);
+  OLA_ASSERT_EQ((unsigned int) sizeof(TEST_DATA2) - 2, length);
+  buffer.ClearChanges();
+
+  // Changes are tracked per object. Copies start with everything changed,
+  // and assignment records the difference.
+  DmxBuffer copy(buffer);
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  copy.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(buffer.Size(), length);
+  copy.ClearChanges();
+  copy = buffer;
+  OLA_ASSERT_FALSE(copy.HasChanges());
+
+  // a copy-on-write duplication isn't a change
+  copy.SetChannel(0, 255);
+  copy.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(1u, length);
+  OLA_ASSERT_FALSE(buffer.HasChanges());
+  buffer = copy;
+  buffer.GetChangedRange(&offset, &length);
+  OLA_ASSERT_EQ(0u, offset);
+  OLA_ASSERT_EQ(1u, length);
+}
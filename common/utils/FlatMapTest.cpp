@@ -0,0 +1,105 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FlatMapTest.cpp
+ * Test fixture for the FlatMap class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/stl/FlatMap.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::FlatMap;
+using std::string;
+
+class FlatMapTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FlatMapTest);
+  CPPUNIT_TEST(testFlatMap);
+  CPPUNIT_TEST(testErase);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFlatMap();
+  void testErase();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlatMapTest);
+
+/*
+ * Check entries can be added, found and removed.
+ */
+void FlatMapTest::testFlatMap() {
+  FlatMap<int, string> map;
+  OLA_ASSERT_TRUE(map.Empty());
+  OLA_ASSERT_NULL(map.Find(1));
+  OLA_ASSERT_FALSE(map.Contains(1));
+  OLA_ASSERT_FALSE(map.Remove(1));
+
+  OLA_ASSERT_FALSE(map.Replace(2, "two"));
+  OLA_ASSERT_FALSE(map.Replace(1, "one"));
+  OLA_ASSERT_TRUE(map.Replace(2, "deux"));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), map.Size());
+  OLA_ASSERT_TRUE(map.Contains(1));
+  OLA_ASSERT_NOT_NULL(map.Find(2));
+  OLA_ASSERT_EQ(string("deux"), *map.Find(2));
+
+  // Values can be changed through Find()
+  *map.Find(1) = "un";
+  OLA_ASSERT_EQ(string("un"), *map.Find(1));
+
+  // The entries are kept in key order
+  FlatMap<int, string>::const_iterator iter = map.begin();
+  OLA_ASSERT_EQ(1, iter->first);
+  ++iter;
+  OLA_ASSERT_EQ(2, iter->first);
+  ++iter;
+  OLA_ASSERT_TRUE(iter == map.end());
+
+  OLA_ASSERT_TRUE(map.Remove(1));
+  OLA_ASSERT_FALSE(map.Contains(1));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), map.Size());
+
+  map.Clear();
+  OLA_ASSERT_TRUE(map.Empty());
+}
+
+/*
+ * Check entries can be removed while iterating.
+ */
+void FlatMapTest::testErase() {
+  FlatMap<int, bool> map;
+  for (int i = 0; i < 6; i++) {
+    map.Replace(i, i % 2);
+  }
+
+  FlatMap<int, bool>::iterator iter = map.begin();
+  while (iter != map.end()) {
+    if (iter->second) {
+      iter = map.Erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  OLA_ASSERT_EQ(static_cast<size_t>(3), map.Size());
+  OLA_ASSERT_TRUE(map.Contains(0));
+  OLA_ASSERT_FALSE(map.Contains(1));
+  OLA_ASSERT_TRUE(map.Contains(2));
+  OLA_ASSERT_FALSE(map.Contains(3));
+  OLA_ASSERT_TRUE(map.Contains(4));
+}
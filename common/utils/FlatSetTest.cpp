@@ -0,0 +1,75 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FlatSetTest.cpp
+ * Test fixture for the FlatSet class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/stl/FlatSet.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::FlatSet;
+using std::vector;
+
+class FlatSetTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FlatSetTest);
+  CPPUNIT_TEST(testFlatSet);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFlatSet();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlatSetTest);
+
+/*
+ * Check members can be added, found and removed.
+ */
+void FlatSetTest::testFlatSet() {
+  FlatSet<int> set;
+  OLA_ASSERT_TRUE(set.Empty());
+  OLA_ASSERT_FALSE(set.Contains(1));
+  OLA_ASSERT_FALSE(set.Remove(1));
+
+  OLA_ASSERT_TRUE(set.Insert(5));
+  OLA_ASSERT_TRUE(set.Insert(1));
+  OLA_ASSERT_TRUE(set.Insert(3));
+  OLA_ASSERT_FALSE(set.Insert(3));
+  OLA_ASSERT_EQ(static_cast<size_t>(3), set.Size());
+  OLA_ASSERT_TRUE(set.Contains(1));
+  OLA_ASSERT_TRUE(set.Contains(3));
+  OLA_ASSERT_TRUE(set.Contains(5));
+  OLA_ASSERT_FALSE(set.Contains(4));
+
+  // The members are kept in order
+  vector<int> members(set.begin(), set.end());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), members.size());
+  OLA_ASSERT_EQ(1, members[0]);
+  OLA_ASSERT_EQ(3, members[1]);
+  OLA_ASSERT_EQ(5, members[2]);
+
+  OLA_ASSERT_TRUE(set.Remove(3));
+  OLA_ASSERT_FALSE(set.Remove(3));
+  OLA_ASSERT_FALSE(set.Contains(3));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), set.Size());
+
+  set.Clear();
+  OLA_ASSERT_TRUE(set.Empty());
+  OLA_ASSERT_FALSE(set.Contains(1));
+}
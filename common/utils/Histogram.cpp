@@ -0,0 +1,95 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Histogram.cpp
+ * A fixed size histogram for latency measurements.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/util/Histogram.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace ola {
+
+Histogram::Histogram()
+    : m_count(0),
+      m_sum(0),
+      m_max(0) {
+  memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+
+void Histogram::Add(uint32_t value) {
+  m_buckets[BucketFor(value)]++;
+  m_count++;
+  m_sum += value;
+  m_max = std::max(m_max, value);
+}
+
+
+void Histogram::Reset() {
+  memset(m_buckets, 0, sizeof(m_buckets));
+  m_count = 0;
+  m_sum = 0;
+  m_max = 0;
+}
+
+
+uint32_t Histogram::Percentile(unsigned int percentile) const {
+  if (!m_count) {
+    return 0;
+  }
+
+  percentile = std::min(percentile, 100u);
+  // The rank of the value we want, rounded up
+  uint64_t rank = (m_count * percentile + 99) / 100;
+  rank = std::max(rank, static_cast<uint64_t>(1));
+
+  uint64_t seen = 0;
+  for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), m_max);
+    }
+  }
+  return m_max;
+}
+
+
+unsigned int Histogram::BucketFor(uint32_t value) {
+  if (value < LINEAR_LIMIT) {
+    return value;
+  }
+  // The position of the most significant bit, this is at least 4.
+  unsigned int msb = 31 - __builtin_clz(value);
+  unsigned int shift = msb - SUB_BUCKET_BITS;
+  unsigned int sub_bucket = (value >> shift) & (SUB_BUCKETS - 1);
+  return LINEAR_LIMIT + (msb - SUB_BUCKET_BITS - 1) * SUB_BUCKETS +
+         sub_bucket;
+}
+
+
+uint32_t Histogram::BucketUpperBound(unsigned int bucket) {
+  if (bucket < LINEAR_LIMIT) {
+    return bucket;
+  }
+  unsigned int offset = bucket - LINEAR_LIMIT;
+  unsigned int shift = offset / SUB_BUCKETS + 1;
+  uint32_t lower = (SUB_BUCKETS + offset % SUB_BUCKETS) << shift;
+  return lower + ((1u << shift) - 1);
+}
+}  // namespace ola
@@ -0,0 +1,108 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HistogramTest.cpp
+ * Test fixture for the Histogram class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/util/Histogram.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::Histogram;
+
+class HistogramTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HistogramTest);
+
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testSmallValues);
+  CPPUNIT_TEST(testLargeValues);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEmpty();
+    void testSmallValues();
+    void testLargeValues();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HistogramTest);
+
+
+/**
+ * Check an empty histogram.
+ */
+void HistogramTest::testEmpty() {
+  Histogram histogram;
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Count());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Sum());
+  OLA_ASSERT_EQ(0u, histogram.Max());
+  OLA_ASSERT_EQ(0u, histogram.Percentile(50));
+  OLA_ASSERT_EQ(0u, histogram.Percentile(100));
+}
+
+
+/**
+ * Values below 16 are exact.
+ */
+void HistogramTest::testSmallValues() {
+  Histogram histogram;
+  for (uint32_t i = 1; i <= 10; i++) {
+    histogram.Add(i);
+  }
+  OLA_ASSERT_EQ(static_cast<uint64_t>(10), histogram.Count());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(55), histogram.Sum());
+  OLA_ASSERT_EQ(10u, histogram.Max());
+  OLA_ASSERT_EQ(1u, histogram.Percentile(0));
+  OLA_ASSERT_EQ(5u, histogram.Percentile(50));
+  OLA_ASSERT_EQ(9u, histogram.Percentile(90));
+  OLA_ASSERT_EQ(10u, histogram.Percentile(99));
+  OLA_ASSERT_EQ(10u, histogram.Percentile(100));
+  OLA_ASSERT_EQ(10u, histogram.Percentile(200));
+
+  histogram.Reset();
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Count());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), histogram.Sum());
+  OLA_ASSERT_EQ(0u, histogram.Max());
+  OLA_ASSERT_EQ(0u, histogram.Percentile(50));
+}
+
+
+/**
+ * Larger values are accurate to within 12.5%.
+ */
+void HistogramTest::testLargeValues() {
+  Histogram histogram;
+  for (uint32_t i = 1; i <= 1000; i++) {
+    histogram.Add(i * 100);
+  }
+  OLA_ASSERT_EQ(100000u, histogram.Max());
+
+  uint32_t p50 = histogram.Percentile(50);
+  OLA_ASSERT_TRUE(p50 >= 50000);
+  OLA_ASSERT_TRUE(p50 <= 50000 + 50000 / 8);
+
+  uint32_t p99 = histogram.Percentile(99);
+  OLA_ASSERT_TRUE(p99 >= 99000);
+  OLA_ASSERT_TRUE(p99 <= 100000);
+
+  // The extremes of the range.
+  histogram.Add(0xffffffff);
+  OLA_ASSERT_EQ(0xffffffffu, histogram.Max());
+  OLA_ASSERT_EQ(0xffffffffu, histogram.Percentile(100));
+}
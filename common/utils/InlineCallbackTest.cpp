@@ -0,0 +1,248 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InlineCallbackTest.cpp
+ * Unittest for the InlineCallback0 class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/InlineCallback.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::InlineCallback0;
+using ola::MakeInlineCallback;
+using ola::SingleUseCallback0;
+using std::string;
+
+namespace {
+int live_payloads = 0;
+
+/*
+ * An argument that's too large to store inline, which counts the number of
+ * copies that are alive.
+ */
+struct LargePayload {
+  LargePayload() : value(0) {
+    memset(padding, 0, sizeof(padding));
+    live_payloads++;
+  }
+  LargePayload(const LargePayload &other) : value(other.value) {
+    memcpy(padding, other.padding, sizeof(padding));
+    live_payloads++;
+  }
+  ~LargePayload() { live_payloads--; }
+
+  int value;
+  char padding[128];
+
+ private:
+  LargePayload& operator=(const LargePayload&);
+};
+
+int Seven() {
+  return 7;
+}
+
+int Add(int a, int b) {
+  return a + b;
+}
+}  // namespace
+
+
+class InlineCallbackTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(InlineCallbackTest);
+  CPPUNIT_TEST(testFunctionCallbacks);
+  CPPUNIT_TEST(testMethodCallbacks);
+  CPPUNIT_TEST(testCopy);
+  CPPUNIT_TEST(testHeapFallback);
+  CPPUNIT_TEST(testSingleUse);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testFunctionCallbacks();
+    void testMethodCallbacks();
+    void testCopy();
+    void testHeapFallback();
+    void testSingleUse();
+
+    void setUp() {
+      m_callback_count = 0;
+      m_total = 0;
+    }
+
+    void Method() { m_callback_count++; }
+    bool BoolMethod() { m_callback_count++; return true; }
+    void AddOne(unsigned int a) { m_total += a; }
+    void AddTwo(unsigned int a, unsigned int b) { m_total += a + b; }
+    void AddThree(unsigned int a, unsigned int b, string *c) {
+      m_total += a + b + c->size();
+    }
+    void AddPayload(LargePayload payload) { m_total += payload.value; }
+
+ private:
+    unsigned int m_callback_count;
+    unsigned int m_total;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InlineCallbackTest);
+
+
+/*
+ * Test function callbacks.
+ */
+void InlineCallbackTest::testFunctionCallbacks() {
+  InlineCallback0<int> callback;
+  OLA_ASSERT_TRUE(callback.Empty());
+  OLA_ASSERT_FALSE(callback.IsInline());
+
+  callback = MakeInlineCallback(&Seven);
+  OLA_ASSERT_FALSE(callback.Empty());
+  OLA_ASSERT_TRUE(callback.IsInline());
+  OLA_ASSERT_EQ(7, callback.Run());
+  // Running the callback doesn't reset it.
+  OLA_ASSERT_EQ(7, callback.Run());
+
+  callback = MakeInlineCallback(&Add, 1, 2);
+  OLA_ASSERT_TRUE(callback.IsInline());
+  OLA_ASSERT_EQ(3, callback.Run());
+
+  callback.Reset();
+  OLA_ASSERT_TRUE(callback.Empty());
+}
+
+
+/*
+ * Test method callbacks, with up to three arguments these should all be
+ * stored inline.
+ */
+void InlineCallbackTest::testMethodCallbacks() {
+  InlineCallback0<void> callback = MakeInlineCallback(
+      this, &InlineCallbackTest::Method);
+  OLA_ASSERT_TRUE(callback.IsInline());
+  callback.Run();
+  OLA_ASSERT_EQ(1u, m_callback_count);
+
+  InlineCallback0<bool> bool_callback = MakeInlineCallback(
+      this, &InlineCallbackTest::BoolMethod);
+  OLA_ASSERT_TRUE(bool_callback.IsInline());
+  OLA_ASSERT_TRUE(bool_callback.Run());
+  OLA_ASSERT_EQ(2u, m_callback_count);
+
+  callback = MakeInlineCallback(this, &InlineCallbackTest::AddOne, 1u);
+  OLA_ASSERT_TRUE(callback.IsInline());
+  callback.Run();
+  OLA_ASSERT_EQ(1u, m_total);
+
+  callback = MakeInlineCallback(this, &InlineCallbackTest::AddTwo, 2u, 3u);
+  OLA_ASSERT_TRUE(callback.IsInline());
+  callback.Run();
+  OLA_ASSERT_EQ(6u, m_total);
+
+  string name("foo");
+  callback = MakeInlineCallback(this, &InlineCallbackTest::AddThree, 4u, 5u,
+                                &name);
+  OLA_ASSERT_TRUE(callback.IsInline());
+  callback.Run();
+  OLA_ASSERT_EQ(18u, m_total);
+}
+
+
+/*
+ * Check copies are independent of the original.
+ */
+void InlineCallbackTest::testCopy() {
+  InlineCallback0<void> callback = MakeInlineCallback(
+      this, &InlineCallbackTest::AddOne, 1u);
+  InlineCallback0<void> copy(callback);
+  callback.Reset();
+  OLA_ASSERT_TRUE(callback.Empty());
+  OLA_ASSERT_TRUE(copy.IsInline());
+  copy.Run();
+  OLA_ASSERT_EQ(1u, m_total);
+
+  InlineCallback0<void> other = MakeInlineCallback(
+      this, &InlineCallbackTest::AddOne, 10u);
+  copy = other;
+  other.Run();
+  copy.Run();
+  OLA_ASSERT_EQ(21u, m_total);
+
+  // Self assignment
+  InlineCallback0<void> &alias = copy;
+  copy = alias;
+  copy.Run();
+  OLA_ASSERT_EQ(31u, m_total);
+
+  // Copying an empty callback
+  copy = InlineCallback0<void>();
+  OLA_ASSERT_TRUE(copy.Empty());
+}
+
+
+/*
+ * Check callbacks which don't fit inline are stored on the heap, and freed.
+ */
+void InlineCallbackTest::testHeapFallback() {
+  {
+    LargePayload payload;
+    payload.value = 5;
+    InlineCallback0<void> callback = MakeInlineCallback(
+        this, &InlineCallbackTest::AddPayload, payload);
+    OLA_ASSERT_FALSE(callback.Empty());
+    OLA_ASSERT_FALSE(callback.IsInline());
+    OLA_ASSERT_EQ(2, live_payloads);
+
+    InlineCallback0<void> copy(callback);
+    OLA_ASSERT_FALSE(copy.IsInline());
+    OLA_ASSERT_EQ(3, live_payloads);
+
+    callback.Run();
+    copy.Run();
+    OLA_ASSERT_EQ(10u, m_total);
+    OLA_ASSERT_EQ(3, live_payloads);
+
+    copy = MakeInlineCallback(this, &InlineCallbackTest::Method);
+    OLA_ASSERT_TRUE(copy.IsInline());
+    OLA_ASSERT_EQ(2, live_payloads);
+  }
+  OLA_ASSERT_EQ(0, live_payloads);
+}
+
+
+/*
+ * Check ToSingleUseCallback().
+ */
+void InlineCallbackTest::testSingleUse() {
+  InlineCallback0<void> callback = MakeInlineCallback(
+      this, &InlineCallbackTest::AddOne, 2u);
+  SingleUseCallback0<void> *single_use = ola::ToSingleUseCallback(callback);
+  callback.Reset();
+  single_use->Run();
+  OLA_ASSERT_EQ(2u, m_total);
+
+  LargePayload payload;
+  payload.value = 3;
+  single_use = ola::ToSingleUseCallback(MakeInlineCallback(
+      this, &InlineCallbackTest::AddPayload, payload));
+  OLA_ASSERT_EQ(2, live_payloads);
+  single_use->Run();
+  OLA_ASSERT_EQ(5u, m_total);
+  OLA_ASSERT_EQ(1, live_payloads);
+}
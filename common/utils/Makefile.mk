@@ -4,8 +4,10 @@ common_libolacommon_la_SOURCES += \
     common/utils/ActionQueue.cpp \
     common/utils/Clock.cpp \
     common/utils/DmxBuffer.cpp \
+    common/utils/Histogram.cpp \
     common/utils/StringUtils.cpp \
     common/utils/TokenBucket.cpp \
+    common/utils/Trace.cpp \
     common/utils/Watchdog.cpp
 
 # TESTS
@@ -18,9 +20,14 @@ common_utils_UtilsTester_SOURCES = \
     common/utils/CallbackTest.cpp \
     common/utils/ClockTest.cpp \
     common/utils/DmxBufferTest.cpp \
+    common/utils/FlatMapTest.cpp \
+    common/utils/FlatSetTest.cpp \
+    common/utils/HistogramTest.cpp \
+    common/utils/InlineCallbackTest.cpp \
     common/utils/MultiCallbackTest.cpp \
     common/utils/StringUtilsTest.cpp \
     common/utils/TokenBucketTest.cpp \
+    common/utils/TraceTest.cpp \
     common/utils/UtilsTest.cpp \
     common/utils/WatchdogTest.cpp
 common_utils_UtilsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
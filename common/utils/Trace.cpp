@@ -0,0 +1,243 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Trace.cpp
+ * Records trace events in per-thread ring buffers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/util/Trace.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::vector;
+
+namespace {
+
+struct TraceEvent {
+  const char *name;
+  const char *arg_name;  // NULL if there's no argument
+  int64_t arg;  // the id for async events
+  int64_t start;
+  int64_t duration;
+  char phase;
+};
+
+/*
+ * The events for one thread. Only the owning thread adds events, the lock is
+ * so the buffer can be read and reset from other threads.
+ */
+class ThreadBuffer {
+ public:
+  ThreadBuffer(unsigned int thread_id, unsigned int capacity)
+      : m_thread_id(thread_id),
+        m_events(capacity),
+        m_next(0),
+        m_wrapped(false) {
+  }
+
+  unsigned int ThreadId() const { return m_thread_id; }
+
+  void Add(const TraceEvent &event) {
+    MutexLocker lock(&m_mutex);
+    m_events[m_next] = event;
+    if (++m_next == m_events.size()) {
+      m_next = 0;
+      m_wrapped = true;
+    }
+  }
+
+  void Reset(unsigned int thread_id, unsigned int capacity) {
+    MutexLocker lock(&m_mutex);
+    m_thread_id = thread_id;
+    m_events.resize(capacity);
+    m_next = 0;
+    m_wrapped = false;
+  }
+
+  // Copy the events, oldest first.
+  void Copy(vector<TraceEvent> *events) {
+    MutexLocker lock(&m_mutex);
+    events->clear();
+    if (m_wrapped) {
+      events->insert(events->end(), m_events.begin() + m_next,
+                     m_events.end());
+    }
+    events->insert(events->end(), m_events.begin(),
+                   m_events.begin() + m_next);
+  }
+
+ private:
+  Mutex m_mutex;
+  unsigned int m_thread_id;
+  vector<TraceEvent> m_events;
+  unsigned int m_next;
+  bool m_wrapped;
+};
+
+/*
+ * Buffers are never deleted, since a thread may still be writing to one.
+ * When a thread exits its buffer is kept, so the events can be written, until
+ * a new thread reuses it.
+ */
+Mutex buffer_mutex;
+vector<ThreadBuffer*> buffers;
+vector<ThreadBuffer*> free_buffers;
+unsigned int buffer_capacity = DEFAULT_TRACE_EVENTS;
+unsigned int next_thread_id = 1;
+volatile bool tracing_enabled = false;
+
+pthread_once_t key_once = PTHREAD_ONCE_INIT;
+pthread_key_t buffer_key;
+MonotonicClock trace_clock;
+
+void ReleaseBuffer(void *buffer) {
+  MutexLocker lock(&buffer_mutex);
+  free_buffers.push_back(static_cast<ThreadBuffer*>(buffer));
+}
+
+void CreateKey() {
+  pthread_key_create(&buffer_key, ReleaseBuffer);
+}
+
+ThreadBuffer *CurrentBuffer() {
+  pthread_once(&key_once, CreateKey);
+  ThreadBuffer *buffer = static_cast<ThreadBuffer*>(
+      pthread_getspecific(buffer_key));
+  if (buffer) {
+    return buffer;
+  }
+
+  MutexLocker lock(&buffer_mutex);
+  if (free_buffers.empty()) {
+    buffer = new ThreadBuffer(next_thread_id++, buffer_capacity);
+    buffers.push_back(buffer);
+  } else {
+    buffer = free_buffers.back();
+    free_buffers.pop_back();
+    buffer->Reset(next_thread_id++, buffer_capacity);
+  }
+  pthread_setspecific(buffer_key, buffer);
+  return buffer;
+}
+
+int64_t Now() {
+  TimeStamp now;
+  trace_clock.CurrentTime(&now);
+  return static_cast<int64_t>(now.Seconds()) * USEC_IN_SECONDS +
+         now.MicroSeconds();
+}
+
+void AddEvent(char phase, const char *name, const char *arg_name,
+              int64_t arg, int64_t start, int64_t duration) {
+  TraceEvent event;
+  event.name = name;
+  event.arg_name = arg_name;
+  event.arg = arg;
+  event.start = start;
+  event.duration = duration;
+  event.phase = phase;
+  CurrentBuffer()->Add(event);
+}
+
+void WriteEvent(std::ostream *output, unsigned int thread_id,
+                const TraceEvent &event) {
+  *output << "{\"name\": \"" << event.name << "\", \"ph\": \""
+          << event.phase << "\", \"pid\": 1, \"tid\": " << thread_id
+          << ", \"ts\": " << event.start;
+  if (event.phase == 'X') {
+    *output << ", \"dur\": " << event.duration;
+    if (event.arg_name) {
+      *output << ", \"args\": {\"" << event.arg_name << "\": " << event.arg
+              << "}";
+    }
+  } else {
+    *output << ", \"cat\": \"ola\", \"id\": \"0x" << std::hex
+            << static_cast<uint64_t>(event.arg) << std::dec << "\"";
+  }
+  *output << "}";
+}
+}  // namespace
+
+void StartTracing(unsigned int events_per_thread) {
+  MutexLocker lock(&buffer_mutex);
+  buffer_capacity = std::max(events_per_thread, 1u);
+  vector<ThreadBuffer*>::iterator iter = buffers.begin();
+  for (; iter != buffers.end(); ++iter) {
+    (*iter)->Reset((*iter)->ThreadId(), buffer_capacity);
+  }
+  tracing_enabled = true;
+}
+
+void StopTracing() {
+  tracing_enabled = false;
+}
+
+bool TracingEnabled() {
+  return tracing_enabled;
+}
+
+void WriteChromeTrace(std::ostream *output) {
+  MutexLocker lock(&buffer_mutex);
+  *output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  vector<TraceEvent> events;
+  vector<ThreadBuffer*>::iterator iter = buffers.begin();
+  for (; iter != buffers.end(); ++iter) {
+    (*iter)->Copy(&events);
+    vector<TraceEvent>::const_iterator event = events.begin();
+    for (; event != events.end(); ++event) {
+      *output << (first ? "\n" : ",\n");
+      first = false;
+      WriteEvent(output, (*iter)->ThreadId(), *event);
+    }
+  }
+  *output << "\n]}\n";
+}
+
+void TraceAsyncBegin(const char *name, uint64_t id) {
+  if (tracing_enabled) {
+    AddEvent('b', name, NULL, static_cast<int64_t>(id), Now(), 0);
+  }
+}
+
+void TraceAsyncEnd(const char *name, uint64_t id) {
+  if (tracing_enabled) {
+    AddEvent('e', name, NULL, static_cast<int64_t>(id), Now(), 0);
+  }
+}
+
+void TraceSpan::Begin(const char *name, const char *arg_name, int64_t arg) {
+  m_name = name;
+  m_arg_name = arg_name;
+  m_arg = arg;
+  m_start = Now();
+}
+
+void TraceSpan::End() {
+  AddEvent('X', m_name, m_arg_name, m_arg, m_start, Now() - m_start);
+}
+}  // namespace ola
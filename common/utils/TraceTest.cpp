@@ -0,0 +1,172 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TraceTest.cpp
+ * Test fixture for the trace functions.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+#include <string>
+
+#include "ola/thread/Thread.h"
+#include "ola/util/Trace.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::StartTracing;
+using ola::StopTracing;
+using ola::TraceSpan;
+using ola::TracingEnabled;
+using std::string;
+
+class TraceTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TraceTest);
+
+  CPPUNIT_TEST(testDisabled);
+  CPPUNIT_TEST(testEvents);
+  CPPUNIT_TEST(testRingBuffer);
+  CPPUNIT_TEST(testThreads);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void tearDown() { StopTracing(); }
+
+    void testDisabled();
+    void testEvents();
+    void testRingBuffer();
+    void testThreads();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TraceTest);
+
+namespace {
+string Trace() {
+  std::ostringstream str;
+  ola::WriteChromeTrace(&str);
+  return str.str();
+}
+
+unsigned int Count(const string &haystack, const string &needle) {
+  unsigned int count = 0;
+  string::size_type pos = haystack.find(needle);
+  while (pos != string::npos) {
+    count++;
+    pos = haystack.find(needle, pos + 1);
+  }
+  return count;
+}
+
+class TracingThread: public ola::thread::Thread {
+ public:
+  TracingThread() : Thread(Options("trace-test")) {}
+
+  void *Run() {
+    TraceSpan span("thread.span");
+    return NULL;
+  }
+};
+}  // namespace
+
+
+/**
+ * Check nothing is recorded until tracing is started.
+ */
+void TraceTest::testDisabled() {
+  StartTracing();
+  StopTracing();
+  OLA_ASSERT_FALSE(TracingEnabled());
+  {
+    TraceSpan span("disabled.span");
+  }
+  ola::TraceAsyncBegin("disabled.async", 1);
+  OLA_ASSERT_EQ(string("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+                       "]}\n"),
+                Trace());
+}
+
+
+/**
+ * Check spans and async events are written.
+ */
+void TraceTest::testEvents() {
+  StartTracing();
+  OLA_ASSERT_TRUE(TracingEnabled());
+  {
+    TraceSpan span("test.span");
+    TraceSpan nested("test.nested", "universe", 42);
+  }
+  ola::TraceAsyncBegin("test.async", 0x1234);
+  ola::TraceAsyncEnd("test.async", 0x1234);
+  StopTracing();
+
+  const string trace = Trace();
+  // The nested span ends first.
+  string::size_type nested = trace.find(
+      "{\"name\": \"test.nested\", \"ph\": \"X\", \"pid\": 1, \"tid\": ");
+  string::size_type outer = trace.find(
+      "{\"name\": \"test.span\", \"ph\": \"X\"");
+  OLA_ASSERT_NE(string::npos, nested);
+  OLA_ASSERT_NE(string::npos, outer);
+  OLA_ASSERT_TRUE(nested < outer);
+  OLA_ASSERT_EQ(1u, Count(trace, "\"args\": {\"universe\": 42}"));
+  OLA_ASSERT_EQ(1u, Count(trace, "\"ph\": \"b\""));
+  OLA_ASSERT_EQ(1u, Count(trace, "\"ph\": \"e\""));
+  OLA_ASSERT_EQ(2u, Count(trace, "\"cat\": \"ola\", \"id\": \"0x1234\""));
+
+  // Starting again discards the old events.
+  StartTracing();
+  OLA_ASSERT_EQ(0u, Count(Trace(), "test.span"));
+}
+
+
+/**
+ * Check only the most recent events are kept.
+ */
+void TraceTest::testRingBuffer() {
+  StartTracing(2);
+  { TraceSpan span("ring.first"); }
+  { TraceSpan span("ring.second"); }
+  { TraceSpan span("ring.third"); }
+
+  const string trace = Trace();
+  OLA_ASSERT_EQ(0u, Count(trace, "ring.first"));
+  OLA_ASSERT_EQ(1u, Count(trace, "ring.second"));
+  OLA_ASSERT_EQ(1u, Count(trace, "ring.third"));
+  OLA_ASSERT_TRUE(trace.find("ring.second") < trace.find("ring.third"));
+}
+
+
+/**
+ * Check each thread gets its own buffer.
+ */
+void TraceTest::testThreads() {
+  StartTracing();
+  { TraceSpan span("main.span"); }
+  TracingThread thread;
+  OLA_ASSERT_TRUE(thread.Start());
+  thread.Join();
+
+  const string trace = Trace();
+  string::size_type main_span = trace.find("main.span");
+  string::size_type thread_span = trace.find("thread.span");
+  OLA_ASSERT_NE(string::npos, main_span);
+  OLA_ASSERT_NE(string::npos, thread_span);
+  const string tid_key = "\"tid\": ";
+  string main_tid = trace.substr(trace.find(tid_key, main_span), 10);
+  string thread_tid = trace.substr(trace.find(tid_key, thread_span), 10);
+  OLA_ASSERT_NE(main_tid, thread_tid);
+}
@@ -20,6 +20,7 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include <string>
 #include <limits>
 #include "ola/stl/STLUtils.h"
@@ -652,6 +653,16 @@ bool JsonObject::ReplaceValue(const string &key, JsonValue *value) {
   }
 }
 
+JsonValue* JsonObject::ReleaseValue(const string &key) {
+  MemberMap::iterator iter = m_members.find(key);
+  if (iter == m_members.end()) {
+    return NULL;
+  }
+  JsonValue *value = iter->second;
+  m_members.erase(iter);
+  return value;
+}
+
 JsonObject* JsonObject::AddObject(const string &key) {
   JsonObject *obj = new JsonObject();
   STLReplaceAndDelete(&m_members, key, obj);
@@ -760,6 +771,26 @@ bool JsonArray::InsertElementAt(uint32_t index, JsonValue *value) {
   return false;
 }
 
+JsonValue* JsonArray::ReleaseElementAt(uint32_t index) {
+  if (index < m_values.size()) {
+    ValuesVector::iterator iter = m_values.begin() + index;
+    JsonValue *value = *iter;
+    m_values.erase(iter);
+    return value;
+  }
+  return NULL;
+}
+
+JsonValue* JsonArray::SwapElementAt(uint32_t index, JsonValue *value) {
+  if (index < m_values.size()) {
+    std::swap(m_values[index], value);
+    return value;
+  }
+  // Ownership is transferred, so it's up to us to delete it.
+  delete value;
+  return NULL;
+}
+
 JsonValue* JsonArray::Clone() const {
   JsonArray *array = new JsonArray();
   ValuesVector::const_iterator iter = m_values.begin();
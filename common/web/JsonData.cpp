@@ -39,18 +39,15 @@ bool JsonData::SetValue(JsonValue *value) {
 }
 
 bool JsonData::Apply(const JsonPatchSet &patch) {
-  JsonValue *new_value = NULL;
-  if (m_value.get()) {
-    new_value = m_value->Clone();
-  }
-
-  // now apply the patch
-  bool ok = patch.Apply(&new_value) && IsValid(new_value);
-  if (ok) {
-    m_value.reset(new_value);
-  } else {
-    delete new_value;
+  // We own the value, so the patch can be applied in place rather than to a
+  // copy. The undo log holds whatever the patch replaced.
+  JsonPatchUndoLog undo_log;
+  JsonValue *value = const_cast<JsonValue*>(m_value.release());
+  bool ok = patch.Apply(&value, &undo_log) && IsValid(value);
+  if (!ok) {
+    undo_log.Rollback(&value);
   }
+  m_value.reset(value);
   return ok;
 }
 
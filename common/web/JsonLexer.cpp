@@ -39,8 +39,53 @@ using std::auto_ptr;
 using std::string;
 
 static bool ParseTrimmedInput(const char **input,
+                              string *buffer,
                               JsonParserInterface *parser);
 
+/*
+ * Character classes, so the hot loops below need a single table lookup per
+ * character rather than a chain of comparisons. The generic strcspn() builds
+ * a table like this on every call, which dominated string parsing on
+ * platforms without an optimized version.
+ */
+enum {
+  CHAR_OTHER = 0,
+  CHAR_WHITESPACE = 1,
+  // The characters that end the unescaped run within a string: ", \ and the
+  // terminating NULL.
+  CHAR_STRING_BREAK = 2
+};
+
+static const uint8_t CHARACTER_CLASS[256] = {
+  2, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0,  // 0x00
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x10
+  1, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x20
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x30
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x40
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0,  // 0x50
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x60
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x70
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x80
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x90
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xa0
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xb0
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xc0
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xd0
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xe0
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xf0
+};
+
+static inline uint8_t CharacterClass(char c) {
+  return CHARACTER_CLASS[static_cast<uint8_t>(c)];
+}
+
+/*
+ * isdigit() is locale dependent, JSON digits are not.
+ */
+static inline bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
 /**
  * @brief Trim leading whitespace from a string.
  * @param input A pointer to a pointer with the data. This is updated to point
@@ -51,9 +96,7 @@ static bool ParseTrimmedInput(const char **input,
  * because I think we'll need a wchar on Windows.
  */
 static bool TrimWhitespace(const char **input) {
-  while (**input != 0 &&
-         (**input == ' ' || **input == '\t' || **input == '\r' ||
-          **input == '\n')) {
+  while (CharacterClass(**input) == CHAR_WHITESPACE) {
     (*input)++;
   }
   return **input != 0;
@@ -63,23 +106,28 @@ static bool TrimWhitespace(const char **input) {
  * @brief Extract a string token from the input.
  * @param input A pointer to a pointer with the data. This should point to the
  * first character after the quote (") character.
- * @param str A string object to store the extracted string.
+ * @param str A string object to store the extracted string. Any existing
+ * contents are replaced.
  * @param parser the JsonParserInterface to pass tokens to.
  * @returns true if the string was extracted correctly, false otherwise.
  */
 static bool ParseString(const char **input, string* str,
                         JsonParserInterface *parser) {
+  str->clear();
   while (true) {
-    size_t size = strcspn(*input, "\"\\");
-    char c = (*input)[size];
+    const char *end = *input;
+    while (CharacterClass(*end) != CHAR_STRING_BREAK) {
+      end++;
+    }
+    char c = *end;
     if (c == 0) {
       parser->SetError("Unterminated string");
       str->clear();
       return false;
     }
 
-    str->append(*input, size);
-    *input += size + 1;
+    str->append(*input, end - *input);
+    *input = end + 1;
 
     if (c == '"') {
       return true;
@@ -131,7 +179,7 @@ bool ExtractDigits(const char **input, uint64_t *i,
   *i = 0;
   bool at_start = true;
   unsigned int zeros = 0;
-  while (isdigit(**input)) {
+  while (IsDigit(**input)) {
     if (at_start && **input == '0') {
       zeros++;
     } else if (at_start) {
@@ -175,7 +223,7 @@ static bool ParseNumber(const char **input, JsonParserInterface *parser) {
 
   if (**input == '0') {
     (*input)++;
-  } else if (isdigit(**input)) {
+  } else if (IsDigit(**input)) {
     ExtractDigits(input, &full);
   } else {
     return false;
@@ -208,7 +256,7 @@ static bool ParseNumber(const char **input, JsonParserInterface *parser) {
     }
 
     uint64_t exponent;
-    if (isdigit(**input)) {
+    if (IsDigit(**input)) {
       ExtractDigits(input, &exponent);
     } else {
       return false;
@@ -249,7 +297,8 @@ static bool ParseNumber(const char **input, JsonParserInterface *parser) {
 /**
  * Starts from the first character after the  '['.
  */
-static bool ParseArray(const char **input, JsonParserInterface *parser) {
+static bool ParseArray(const char **input, string *buffer,
+                       JsonParserInterface *parser) {
   if (!TrimWhitespace(input)) {
     parser->SetError("Unterminated array");
     return false;
@@ -269,7 +318,7 @@ static bool ParseArray(const char **input, JsonParserInterface *parser) {
       return false;
     }
 
-    bool result = ParseTrimmedInput(input, parser);
+    bool result = ParseTrimmedInput(input, buffer, parser);
     if (!result) {
       OLA_INFO << "Invalid input";
       return false;
@@ -298,7 +347,8 @@ static bool ParseArray(const char **input, JsonParserInterface *parser) {
 /**
  * Starts from the first character after the  '{'.
  */
-static bool ParseObject(const char **input, JsonParserInterface *parser) {
+static bool ParseObject(const char **input, string *buffer,
+                        JsonParserInterface *parser) {
   if (!TrimWhitespace(input)) {
     parser->SetError("Unterminated object");
     return false;
@@ -325,11 +375,10 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
     }
     (*input)++;
 
-    string key;
-    if (!ParseString(input, &key, parser)) {
+    if (!ParseString(input, buffer, parser)) {
       return false;
     }
-    parser->ObjectKey(key);
+    parser->ObjectKey(*buffer);
 
     if (!TrimWhitespace(input)) {
       parser->SetError("Missing : after key");
@@ -347,7 +396,7 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
       return false;
     }
 
-    bool result = ParseTrimmedInput(input, parser);
+    bool result = ParseTrimmedInput(input, buffer, parser);
     if (!result) {
       return false;
     }
@@ -372,17 +421,22 @@ static bool ParseObject(const char **input, JsonParserInterface *parser) {
   }
 }
 
+/*
+ * The buffer is used to hold string tokens while they're passed to the
+ * parser. Sharing one buffer across the whole document means we only
+ * allocate when a string is longer than any before it.
+ */
 static bool ParseTrimmedInput(const char **input,
-                             JsonParserInterface *parser) {
+                              string *buffer,
+                              JsonParserInterface *parser) {
   static const char TRUE_STR[] = "true";
   static const char FALSE_STR[] = "false";
   static const char NULL_STR[] = "null";
 
   if (**input == '"') {
     (*input)++;
-    string str;
-    if (ParseString(input, &str, parser)) {
-      parser->String(str);
+    if (ParseString(input, buffer, parser)) {
+      parser->String(*buffer);
       return true;
     }
     return false;
@@ -398,14 +452,14 @@ static bool ParseTrimmedInput(const char **input,
     *input += sizeof(NULL_STR) - 1;
     parser->Null();
     return true;
-  } else if (**input == '-' || isdigit(**input)) {
+  } else if (**input == '-' || IsDigit(**input)) {
     return ParseNumber(input, parser);
   } else if (**input == '[') {
     (*input)++;
-    return ParseArray(input, parser);
+    return ParseArray(input, buffer, parser);
   } else if (**input == '{') {
     (*input)++;
-    return ParseObject(input, parser);
+    return ParseObject(input, buffer, parser);
   }
   parser->SetError("Invalid JSON value");
   return false;
@@ -419,7 +473,8 @@ bool ParseRaw(const char *input, JsonParserInterface *parser) {
   }
 
   parser->Begin();
-  bool result = ParseTrimmedInput(&input, parser);
+  string buffer;
+  bool result = ParseTrimmedInput(&input, &buffer, parser);
   if (!result) {
     return false;
   }
@@ -431,13 +486,9 @@ bool JsonLexer::Parse(const string &input,
                       JsonParserInterface *parser) {
   // TODO(simon): Do we need to convert to unicode here? I think this may be
   // an issue on Windows. Consider mbstowcs.
-  // Copying the input sucks though, so we should use input.c_str() if we can.
-  char* input_data = new char[input.size() + 1];
-  strncpy(input_data, input.c_str(), input.size() + 1);
-
-  bool result = ParseRaw(input_data, parser);
-  delete[] input_data;
-  return result;
+  // c_str() is NULL terminated, so there's no need to copy the input. As
+  // before, parsing stops at the first NULL.
+  return ParseRaw(input.c_str(), parser);
 }
 }  // namespace web
 }  // namespace ola
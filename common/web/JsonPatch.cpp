@@ -92,35 +92,40 @@ bool ObjectOrArrayAction::TakeActionOn(JsonValue *value,
 
 class AddAction : public ObjectOrArrayAction {
  public:
-  explicit AddAction(const JsonValue *value_to_clone)
-      : m_value(value_to_clone) {}
+  AddAction(const JsonValue *value_to_clone, JsonPatchUndoLog *undo_log)
+      : m_value(value_to_clone),
+        m_undo_log(undo_log) {
+  }
 
   bool Object(JsonObject *object, const string &key) {
-    object->AddValue(key, m_value->Clone());
+    m_undo_log->SetMember(object, key, m_value->Clone());
     return true;
   }
 
   bool ArrayIndex(JsonArray *array, uint32_t index) {
-    return array->InsertElementAt(index, m_value->Clone());
+    return m_undo_log->InsertElement(array, index, m_value->Clone());
   }
 
   bool ArrayLast(JsonArray *array) {
-    array->AppendValue(m_value->Clone());
+    m_undo_log->AppendElement(array, m_value->Clone());
     return true;
   }
 
  private:
   const JsonValue *m_value;
+  JsonPatchUndoLog *m_undo_log;
 };
 
 class RemoveAction : public ObjectOrArrayAction {
  public:
+  explicit RemoveAction(JsonPatchUndoLog *undo_log) : m_undo_log(undo_log) {}
+
   bool Object(JsonObject *object, const string &key) {
-    return object->Remove(key);
+    return m_undo_log->RemoveMember(object, key);
   }
 
   bool ArrayIndex(JsonArray *array, uint32_t index) {
-    return array->RemoveElementAt(index);
+    return m_undo_log->RemoveElement(array, index);
   }
 
   bool ArrayLast(JsonArray *array) {
@@ -128,21 +133,26 @@ class RemoveAction : public ObjectOrArrayAction {
       return false;
     }
 
-    array->RemoveElementAt(array->Size() - 1);
-    return true;
+    return m_undo_log->RemoveElement(array, array->Size() - 1);
   }
+
+ private:
+  JsonPatchUndoLog *m_undo_log;
 };
 
 class ReplaceAction : public ObjectOrArrayAction {
  public:
-  explicit ReplaceAction(const JsonValue *value) : m_value(value) {}
+  ReplaceAction(const JsonValue *value, JsonPatchUndoLog *undo_log)
+      : m_value(value),
+        m_undo_log(undo_log) {
+  }
 
   bool Object(JsonObject *object, const string &key) {
-    return object->ReplaceValue(key, m_value->Clone());
+    return m_undo_log->ReplaceMember(object, key, m_value->Clone());
   }
 
   bool ArrayIndex(JsonArray *array, uint32_t index) {
-    return array->ReplaceElementAt(index, m_value->Clone());
+    return m_undo_log->ReplaceElement(array, index, m_value->Clone());
   }
 
   bool ArrayLast(JsonArray *array) {
@@ -150,28 +160,26 @@ class ReplaceAction : public ObjectOrArrayAction {
       return false;
     }
 
-    array->ReplaceElementAt(array->Size() - 1, m_value->Clone());
-    return true;
+    return m_undo_log->ReplaceElement(array, array->Size() - 1,
+                                      m_value->Clone());
   }
  private:
   const JsonValue *m_value;
+  JsonPatchUndoLog *m_undo_log;
 };
 
 bool AddOp(const JsonPointer &target, JsonValue **root,
-           const JsonValue *value_to_clone) {
+           const JsonValue *value_to_clone, JsonPatchUndoLog *undo_log) {
   if (!target.IsValid()) {
     return false;
   }
 
   if (target.TokenCount() == 1) {
     // Add also operates as replace as per the spec.
-    // Make a copy before we delete, since the value_to_clone may be within the
-    // root.
-    JsonValue *new_value = value_to_clone ? value_to_clone->Clone() : NULL;
-    if (*root) {
-      delete *root;
-    }
-    *root = new_value;
+    // Make a copy before we replace it, since the value_to_clone may be
+    // within the root.
+    undo_log->ReplaceRoot(root,
+                          value_to_clone ? value_to_clone->Clone() : NULL);
     return true;
   }
 
@@ -180,24 +188,143 @@ bool AddOp(const JsonPointer &target, JsonValue **root,
     return false;
   }
 
-  AddAction action(value_to_clone);
+  AddAction action(value_to_clone, undo_log);
   return action.TakeActionOn(*root, target);
 }
 
 }  // namespace
 
-bool JsonPatchAddOp::Apply(JsonValue **value) const {
-  return AddOp(m_pointer, value, m_value.get());
+JsonPatchUndoLog::~JsonPatchUndoLog() {
+  Changes::iterator iter = m_changes.begin();
+  for (; iter != m_changes.end(); ++iter) {
+    delete iter->old_value;
+  }
+}
+
+void JsonPatchUndoLog::Rollback(JsonValue **root) {
+  // The containers are still valid, since every change after the one being
+  // undone has been undone already, and nothing the log holds is deleted.
+  while (!m_changes.empty()) {
+    Change &change = m_changes.back();
+    JsonObject *object = change.object;
+    JsonArray *array = change.array;
+    switch (change.type) {
+      case ROOT_REPLACED:
+        delete *root;
+        *root = change.old_value;
+        break;
+      case MEMBER_SET:
+        if (change.old_value) {
+          object->AddValue(change.key, change.old_value);
+        } else {
+          object->Remove(change.key);
+        }
+        break;
+      case MEMBER_REMOVED:
+        object->AddValue(change.key, change.old_value);
+        break;
+      case ELEMENT_INSERTED:
+        array->RemoveElementAt(change.index);
+        break;
+      case ELEMENT_REPLACED:
+        delete array->SwapElementAt(change.index, change.old_value);
+        break;
+      case ELEMENT_REMOVED:
+        if (change.index == array->Size()) {
+          array->AppendValue(change.old_value);
+        } else {
+          array->InsertElementAt(change.index, change.old_value);
+        }
+        break;
+    }
+    m_changes.pop_back();
+  }
+}
+
+void JsonPatchUndoLog::ReplaceRoot(JsonValue **root, JsonValue *value) {
+  m_changes.push_back(Change(ROOT_REPLACED, NULL, NULL, "", 0, *root));
+  *root = value;
+}
+
+void JsonPatchUndoLog::SetMember(JsonObject *object, const string &key,
+                                 JsonValue *value) {
+  m_changes.push_back(
+      Change(MEMBER_SET, object, NULL, key, 0, object->ReleaseValue(key)));
+  object->AddValue(key, value);
 }
 
-bool JsonPatchRemoveOp::Apply(JsonValue **value) const {
+bool JsonPatchUndoLog::ReplaceMember(JsonObject *object, const string &key,
+                                     JsonValue *value) {
+  JsonValue *old_value = object->ReleaseValue(key);
+  if (!old_value) {
+    delete value;
+    return false;
+  }
+  m_changes.push_back(Change(MEMBER_SET, object, NULL, key, 0, old_value));
+  object->AddValue(key, value);
+  return true;
+}
+
+bool JsonPatchUndoLog::RemoveMember(JsonObject *object, const string &key) {
+  JsonValue *old_value = object->ReleaseValue(key);
+  if (!old_value) {
+    return false;
+  }
+  m_changes.push_back(
+      Change(MEMBER_REMOVED, object, NULL, key, 0, old_value));
+  return true;
+}
+
+bool JsonPatchUndoLog::InsertElement(JsonArray *array, uint32_t index,
+                                     JsonValue *value) {
+  if (!array->InsertElementAt(index, value)) {
+    return false;
+  }
+  m_changes.push_back(
+      Change(ELEMENT_INSERTED, NULL, array, "", index, NULL));
+  return true;
+}
+
+void JsonPatchUndoLog::AppendElement(JsonArray *array, JsonValue *value) {
+  m_changes.push_back(
+      Change(ELEMENT_INSERTED, NULL, array, "", array->Size(), NULL));
+  array->AppendValue(value);
+}
+
+bool JsonPatchUndoLog::ReplaceElement(JsonArray *array, uint32_t index,
+                                      JsonValue *value) {
+  JsonValue *old_value = array->SwapElementAt(index, value);
+  if (!old_value) {
+    return false;
+  }
+  m_changes.push_back(
+      Change(ELEMENT_REPLACED, NULL, array, "", index, old_value));
+  return true;
+}
+
+bool JsonPatchUndoLog::RemoveElement(JsonArray *array, uint32_t index) {
+  JsonValue *old_value = array->ReleaseElementAt(index);
+  if (!old_value) {
+    return false;
+  }
+  m_changes.push_back(
+      Change(ELEMENT_REMOVED, NULL, array, "", index, old_value));
+  return true;
+}
+
+bool JsonPatchAddOp::Apply(JsonValue **value,
+                           JsonPatchUndoLog *undo_log) const {
+  return AddOp(m_pointer, value, m_value.get(), undo_log);
+}
+
+bool JsonPatchRemoveOp::Apply(JsonValue **value,
+                              JsonPatchUndoLog *undo_log) const {
   if (!m_pointer.IsValid()) {
     return false;
   }
 
   if (m_pointer.TokenCount() == 1) {
-    delete *value;
-    *value = NULL;
+    undo_log->ReplaceRoot(value, NULL);
     return true;
   }
 
@@ -205,18 +332,18 @@ bool JsonPatchRemoveOp::Apply(JsonValue **value) const {
     return false;
   }
 
-  RemoveAction action;
+  RemoveAction action(undo_log);
   return action.TakeActionOn(*value, m_pointer);
 }
 
-bool JsonPatchReplaceOp::Apply(JsonValue **value) const {
+bool JsonPatchReplaceOp::Apply(JsonValue **value,
+                               JsonPatchUndoLog *undo_log) const {
   if (!m_pointer.IsValid()) {
     return false;
   }
 
   if (m_pointer.TokenCount() == 1) {
-    delete *value;
-    *value = m_value.get() ? m_value->Clone() : NULL;
+    undo_log->ReplaceRoot(value, m_value.get() ? m_value->Clone() : NULL);
     return true;
   }
 
@@ -225,11 +352,12 @@ bool JsonPatchReplaceOp::Apply(JsonValue **value) const {
     return false;
   }
 
-  ReplaceAction action(m_value.get());
+  ReplaceAction action(m_value.get(), undo_log);
   return action.TakeActionOn(*value, m_pointer);
 }
 
-bool JsonPatchMoveOp::Apply(JsonValue **value) const {
+bool JsonPatchMoveOp::Apply(JsonValue **value,
+                            JsonPatchUndoLog *undo_log) const {
   if (!m_to.IsValid() || !m_from.IsValid()) {
     return false;
   }
@@ -254,23 +382,24 @@ bool JsonPatchMoveOp::Apply(JsonValue **value) const {
     return false;
   }
 
-  if (!AddOp(m_to, value, source)) {
+  if (!AddOp(m_to, value, source, undo_log)) {
     return false;
   }
 
   if (m_to.IsPrefixOf(m_from)) {
-    // At this point the original has already been destroyed during the Add
+    // At this point the original has already been replaced during the Add
     return true;
   }
 
-  RemoveAction action;
+  RemoveAction action(undo_log);
   if (!action.TakeActionOn(src_parent, child_ptr)) {
     OLA_WARN << "Remove-after-move returned false!";
   }
   return true;
 }
 
-bool JsonPatchCopyOp::Apply(JsonValue **value) const {
+bool JsonPatchCopyOp::Apply(JsonValue **value,
+                            JsonPatchUndoLog *undo_log) const {
   if (!m_to.IsValid() || !m_from.IsValid()) {
     return false;
   }
@@ -295,10 +424,10 @@ bool JsonPatchCopyOp::Apply(JsonValue **value) const {
     return false;
   }
 
-  return AddOp(m_to, value, source);
+  return AddOp(m_to, value, source, undo_log);
 }
 
-bool JsonPatchTestOp::Apply(JsonValue **value) const {
+bool JsonPatchTestOp::Apply(JsonValue **value, JsonPatchUndoLog*) const {
   if (!m_pointer.IsValid()) {
     return false;
   }
@@ -323,9 +452,19 @@ void JsonPatchSet::AddOp(JsonPatchOp *op) {
 }
 
 bool JsonPatchSet::Apply(JsonValue **value) const {
+  JsonPatchUndoLog undo_log;
+  if (!Apply(value, &undo_log)) {
+    undo_log.Rollback(value);
+    return false;
+  }
+  return true;
+}
+
+bool JsonPatchSet::Apply(JsonValue **value,
+                         JsonPatchUndoLog *undo_log) const {
   PatchOps::const_iterator iter = m_patch_ops.begin();
   for (; iter != m_patch_ops.end(); ++iter) {
-    if (!(*iter)->Apply(value)) {
+    if (!(*iter)->Apply(value, undo_log)) {
       return false;
     }
   }
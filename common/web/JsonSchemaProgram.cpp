@@ -0,0 +1,1164 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonSchemaProgram.cpp
+ * A JSON Schema compiled into a flat program, for streaming validation.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonLexer.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonSchema.h"
+#include "ola/web/JsonSchemaProgram.h"
+#include "ola/web/JsonTypes.h"
+#include "ola/web/JsonWriter.h"
+
+namespace ola {
+namespace web {
+
+using std::auto_ptr;
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Records what a JsonValue is, without needing RTTI.
+ */
+class ValueInspector : public JsonValueConstVisitorInterface {
+ public:
+  explicit ValueInspector(const JsonValue *value)
+      : type(JSON_UNDEFINED),
+        object(NULL),
+        array(NULL),
+        str(NULL),
+        number(NULL),
+        bool_value(false),
+        has_uint(false),
+        uint_value(0) {
+    if (value) {
+      value->Accept(this);
+    }
+  }
+
+  void Visit(const JsonString &value) {
+    type = JSON_STRING;
+    str = &value;
+  }
+
+  void Visit(const JsonBool &value) {
+    type = JSON_BOOLEAN;
+    bool_value = value.Value();
+  }
+
+  void Visit(const JsonNull&) { type = JSON_NULL; }
+  void Visit(const JsonRawValue&) {}
+
+  void Visit(const JsonObject &value) {
+    type = JSON_OBJECT;
+    object = &value;
+  }
+
+  void Visit(const JsonArray &value) {
+    type = JSON_ARRAY;
+    array = &value;
+  }
+
+  void Visit(const JsonUInt &value) {
+    SetNumber(value);
+    has_uint = true;
+    uint_value = value.Value();
+  }
+
+  void Visit(const JsonUInt64 &value) { SetNumber(value); }
+
+  void Visit(const JsonInt &value) {
+    SetNumber(value);
+    if (value.Value() >= 0) {
+      has_uint = true;
+      uint_value = value.Value();
+    }
+  }
+
+  void Visit(const JsonInt64 &value) { SetNumber(value); }
+  void Visit(const JsonDouble &value) { SetNumber(value); }
+
+  JsonType type;
+  const JsonObject *object;
+  const JsonArray *array;
+  const JsonString *str;
+  const JsonNumber *number;
+  bool bool_value;
+  bool has_uint;
+  unsigned int uint_value;
+
+ private:
+  void SetNumber(const JsonNumber &value) {
+    type = JSON_NUMBER;
+    number = &value;
+  }
+};
+
+/*
+ * Indexes the properties of a JsonObject.
+ */
+class PropertyMap : public JsonObjectPropertyVisitor {
+ public:
+  typedef map<string, const JsonValue*> ValueMap;
+
+  explicit PropertyMap(const JsonObject *object) {
+    if (object) {
+      object->VisitProperties(this);
+    }
+  }
+
+  void VisitProperty(const string &property, const JsonValue &value) {
+    m_values[property] = &value;
+  }
+
+  const JsonValue *Get(const string &key) const {
+    return STLFindOrNull(m_values, key);
+  }
+
+  const ValueMap &Values() const { return m_values; }
+
+ private:
+  ValueMap m_values;
+};
+
+bool CompareName(const pair<string, unsigned int> &entry, const string &name) {
+  return entry.first < name;
+}
+
+bool MatchesEnum(const vector<const JsonValue*> &enums,
+                 const JsonValue &value) {
+  if (enums.empty()) {
+    return true;
+  }
+  vector<const JsonValue*>::const_iterator iter = enums.begin();
+  for (; iter != enums.end(); ++iter) {
+    if (**iter == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HasDuplicates(const vector<const JsonValue*> &values) {
+  for (unsigned int i = 0; i < values.size(); i++) {
+    for (unsigned int j = 0; j < i; j++) {
+      if (values[i] && values[j] && *values[i] == *values[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Schemas can loop back on themselves without consuming any input, e.g.
+// {"allOf": [{"$ref": "#"}]}.
+const unsigned int MAX_CHECKS_PER_VALUE = 10000;
+const char DEFINITIONS_PREFIX[] = "#/definitions/";
+}  // namespace
+
+
+/*
+ * Builds the instructions for a JsonSchemaProgram from the JSON form of the
+ * schema.
+ */
+class SchemaCompiler {
+ public:
+  typedef JsonSchemaProgram::Instruction Instruction;
+
+  explicit SchemaCompiler(JsonSchemaProgram *program)
+      : m_program(program) {
+  }
+
+  void Compile() {
+    vector<Instruction> &instructions = m_program->m_instructions;
+    instructions.clear();
+    instructions.push_back(Instruction());  // WILDCARD_INDEX
+    instructions.push_back(Instruction());
+    instructions.back().op = JsonSchemaProgram::OP_REJECT;
+
+    const JsonObject *root = m_program->m_schema_json.get();
+    PropertyMap root_properties(root);
+    ValueInspector definitions(root_properties.Get("definitions"));
+    PropertyMap definition_map(definitions.object);
+    PropertyMap::ValueMap::const_iterator iter =
+        definition_map.Values().begin();
+    for (; iter != definition_map.Values().end(); ++iter) {
+      m_definitions[iter->first] = CompileSchema(iter->second);
+    }
+    m_program->m_root = CompileSchema(root);
+    ResolveReferences();
+  }
+
+ private:
+  JsonSchemaProgram *m_program;
+  map<string, unsigned int> m_definitions;
+
+  unsigned int CompileSchema(const JsonValue *schema);
+  void CompileString(const PropertyMap &properties, Instruction *ins);
+  void CompileNumber(const PropertyMap &properties, Instruction *ins);
+  void CompileObject(const PropertyMap &properties, Instruction *ins);
+  void CompileArray(const PropertyMap &properties, Instruction *ins);
+  unsigned int CompileAdditional(const JsonValue *value);
+  void ResolveReferences();
+  unsigned int Resolve(unsigned int index);
+  void Resolve(vector<unsigned int> *indices);
+
+  static unsigned int TrackProperty(const string &name,
+                                    const vector<string> &tracked);
+};
+
+unsigned int SchemaCompiler::CompileSchema(const JsonValue *schema) {
+  ValueInspector inspector(schema);
+  if (!inspector.object) {
+    return JsonSchemaProgram::REJECT_INDEX;
+  }
+
+  PropertyMap properties(inspector.object);
+  Instruction ins;
+
+  ValueInspector ref(properties.Get("$ref"));
+  ValueInspector type(properties.Get("type"));
+  if (ref.str) {
+    ins.op = JsonSchemaProgram::OP_REF;
+    ins.ref = ref.str->Value();
+  } else if (type.str) {
+    ins.op = JsonSchemaProgram::OP_TYPED;
+    ins.type = StringToJsonType(type.str->Value());
+  } else if (properties.Get("allOf")) {
+    ins.op = JsonSchemaProgram::OP_ALL_OF;
+  } else if (properties.Get("anyOf")) {
+    ins.op = JsonSchemaProgram::OP_ANY_OF;
+  } else if (properties.Get("oneOf")) {
+    ins.op = JsonSchemaProgram::OP_ONE_OF;
+  } else if (properties.Get("not")) {
+    ins.op = JsonSchemaProgram::OP_NOT;
+  } else {
+    // The WildcardValidator ignores any other keywords, including enum.
+    return JsonSchemaProgram::WILDCARD_INDEX;
+  }
+
+  // Reserve our slot before compiling the children.
+  const unsigned int index = m_program->m_instructions.size();
+  m_program->m_instructions.push_back(Instruction());
+
+  switch (ins.op) {
+    case JsonSchemaProgram::OP_TYPED:
+      {
+        ValueInspector enums(properties.Get("enum"));
+        if (enums.array) {
+          for (unsigned int i = 0; i < enums.array->Size(); i++) {
+            ins.enums.push_back(enums.array->ElementAt(i));
+          }
+        }
+      }
+      switch (ins.type) {
+        case JSON_STRING:
+          CompileString(properties, &ins);
+          break;
+        case JSON_INTEGER:
+        case JSON_NUMBER:
+          CompileNumber(properties, &ins);
+          break;
+        case JSON_OBJECT:
+          CompileObject(properties, &ins);
+          break;
+        case JSON_ARRAY:
+          CompileArray(properties, &ins);
+          break;
+        case JSON_BOOLEAN:
+        case JSON_NULL:
+          break;
+        default:
+          ins.op = JsonSchemaProgram::OP_REJECT;
+      }
+      break;
+    case JsonSchemaProgram::OP_ALL_OF:
+    case JsonSchemaProgram::OP_ANY_OF:
+    case JsonSchemaProgram::OP_ONE_OF:
+      {
+        const char *keyword = (
+            ins.op == JsonSchemaProgram::OP_ALL_OF ? "allOf" :
+            (ins.op == JsonSchemaProgram::OP_ANY_OF ? "anyOf" : "oneOf"));
+        ValueInspector branches(properties.Get(keyword));
+        if (branches.array) {
+          for (unsigned int i = 0; i < branches.array->Size(); i++) {
+            ins.branches.push_back(
+                CompileSchema(branches.array->ElementAt(i)));
+          }
+        }
+      }
+      break;
+    case JsonSchemaProgram::OP_NOT:
+      ins.branches.push_back(CompileSchema(properties.Get("not")));
+      break;
+    default:
+      break;
+  }
+  m_program->m_instructions[index] = ins;
+  return index;
+}
+
+void SchemaCompiler::CompileString(const PropertyMap &properties,
+                                   Instruction *ins) {
+  ValueInspector min_length(properties.Get("minLength"));
+  if (min_length.has_uint) {
+    ins->min_length = min_length.uint_value;
+  }
+  ValueInspector max_length(properties.Get("maxLength"));
+  if (max_length.has_uint) {
+    ins->max_length = max_length.uint_value;
+  }
+}
+
+void SchemaCompiler::CompileNumber(const PropertyMap &properties,
+                                   Instruction *ins) {
+  ins->minimum = ValueInspector(properties.Get("minimum")).number;
+  ins->exclusive_minimum = ValueInspector(
+      properties.Get("exclusiveMinimum")).bool_value;
+  ins->maximum = ValueInspector(properties.Get("maximum")).number;
+  ins->exclusive_maximum = ValueInspector(
+      properties.Get("exclusiveMaximum")).bool_value;
+  ins->multiple_of = ValueInspector(properties.Get("multipleOf")).number;
+}
+
+void SchemaCompiler::CompileObject(const PropertyMap &properties,
+                                   Instruction *ins) {
+  ValueInspector min_properties(properties.Get("minProperties"));
+  if (min_properties.has_uint) {
+    ins->min_properties = min_properties.uint_value;
+  }
+  ValueInspector max_properties(properties.Get("maxProperties"));
+  if (max_properties.has_uint) {
+    ins->max_properties = max_properties.uint_value;
+  }
+
+  // Collect the names we need to track, so each can be given an index.
+  set<string> tracked;
+  ValueInspector required(properties.Get("required"));
+  if (required.array) {
+    for (unsigned int i = 0; i < required.array->Size(); i++) {
+      ValueInspector name(required.array->ElementAt(i));
+      if (name.str) {
+        tracked.insert(name.str->Value());
+      }
+    }
+  }
+
+  ValueInspector dependencies(properties.Get("dependencies"));
+  PropertyMap dependency_map(dependencies.object);
+  PropertyMap::ValueMap::const_iterator iter =
+      dependency_map.Values().begin();
+  for (; iter != dependency_map.Values().end(); ++iter) {
+    tracked.insert(iter->first);
+    ValueInspector dependency(iter->second);
+    if (dependency.array) {
+      for (unsigned int i = 0; i < dependency.array->Size(); i++) {
+        ValueInspector name(dependency.array->ElementAt(i));
+        if (name.str) {
+          tracked.insert(name.str->Value());
+        }
+      }
+    }
+  }
+  ins->tracked_properties.assign(tracked.begin(), tracked.end());
+
+  if (required.array) {
+    set<unsigned int> required_indices;
+    for (unsigned int i = 0; i < required.array->Size(); i++) {
+      ValueInspector name(required.array->ElementAt(i));
+      if (name.str) {
+        required_indices.insert(
+            TrackProperty(name.str->Value(), ins->tracked_properties));
+      }
+    }
+    ins->required.assign(required_indices.begin(), required_indices.end());
+  }
+
+  for (iter = dependency_map.Values().begin();
+       iter != dependency_map.Values().end(); ++iter) {
+    unsigned int property = TrackProperty(iter->first,
+                                          ins->tracked_properties);
+    ValueInspector dependency(iter->second);
+    if (dependency.array) {
+      JsonSchemaProgram::PropertyDependency property_dependency;
+      property_dependency.first = property;
+      for (unsigned int i = 0; i < dependency.array->Size(); i++) {
+        ValueInspector name(dependency.array->ElementAt(i));
+        if (name.str) {
+          property_dependency.second.push_back(
+              TrackProperty(name.str->Value(), ins->tracked_properties));
+        }
+      }
+      ins->property_dependencies.push_back(property_dependency);
+    } else {
+      ins->schema_dependencies.push_back(
+          std::make_pair(property, CompileSchema(iter->second)));
+    }
+  }
+
+  ValueInspector property_schemas(properties.Get("properties"));
+  PropertyMap property_map(property_schemas.object);
+  // ValueMap is sorted, so properties will be too.
+  for (iter = property_map.Values().begin();
+       iter != property_map.Values().end(); ++iter) {
+    ins->properties.push_back(
+        std::make_pair(iter->first, CompileSchema(iter->second)));
+  }
+
+  ins->additional_properties = CompileAdditional(
+      properties.Get("additionalProperties"));
+}
+
+void SchemaCompiler::CompileArray(const PropertyMap &properties,
+                                  Instruction *ins) {
+  ValueInspector min_items(properties.Get("minItems"));
+  if (min_items.has_uint) {
+    ins->min_items = min_items.uint_value;
+  }
+  ValueInspector max_items(properties.Get("maxItems"));
+  if (max_items.has_uint) {
+    ins->max_items = max_items.uint_value;
+  }
+  ins->unique_items = ValueInspector(
+      properties.Get("uniqueItems")).bool_value;
+
+  const JsonValue *items_value = properties.Get("items");
+  ValueInspector items(items_value);
+  if (items.array) {
+    // 8.2.3.3, items is an array.
+    ins->items_is_list = true;
+    for (unsigned int i = 0; i < items.array->Size(); i++) {
+      ins->items.push_back(CompileSchema(items.array->ElementAt(i)));
+    }
+    ins->additional_items = CompileAdditional(
+        properties.Get("additionalItems"));
+  } else if (items_value) {
+    // 8.2.3.1, items is an object, additionalItems is ignored.
+    ins->additional_items = CompileSchema(items_value);
+  }
+}
+
+/*
+ * Compile additionalItems or additionalProperties, which can be a bool or a
+ * schema, and default to the empty schema.
+ */
+unsigned int SchemaCompiler::CompileAdditional(const JsonValue *value) {
+  ValueInspector additional(value);
+  if (additional.type == JSON_BOOLEAN) {
+    return additional.bool_value ? JsonSchemaProgram::WILDCARD_INDEX :
+        JsonSchemaProgram::REJECT_INDEX;
+  } else if (additional.object) {
+    return CompileSchema(value);
+  }
+  return JsonSchemaProgram::WILDCARD_INDEX;
+}
+
+/*
+ * Point everything that refers to a $ref instruction at its target instead.
+ */
+void SchemaCompiler::ResolveReferences() {
+  vector<Instruction> &instructions = m_program->m_instructions;
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    Instruction &ins = instructions[i];
+    JsonSchemaProgram::NamedIndexList::iterator prop_iter =
+        ins.properties.begin();
+    for (; prop_iter != ins.properties.end(); ++prop_iter) {
+      prop_iter->second = Resolve(prop_iter->second);
+    }
+    ins.additional_properties = Resolve(ins.additional_properties);
+    for (unsigned int j = 0; j < ins.schema_dependencies.size(); j++) {
+      ins.schema_dependencies[j].second = Resolve(
+          ins.schema_dependencies[j].second);
+    }
+    Resolve(&ins.items);
+    ins.additional_items = Resolve(ins.additional_items);
+    Resolve(&ins.branches);
+  }
+  m_program->m_root = Resolve(m_program->m_root);
+}
+
+unsigned int SchemaCompiler::Resolve(unsigned int index) {
+  const vector<Instruction> &instructions = m_program->m_instructions;
+  // A chain of references can't be longer than the program, unless it
+  // loops.
+  for (unsigned int hops = 0; hops < instructions.size(); hops++) {
+    const Instruction &ins = instructions[index];
+    if (ins.op != JsonSchemaProgram::OP_REF) {
+      return index;
+    }
+
+    const string &ref = ins.ref;
+    if (ref == "#") {
+      index = m_program->m_root;
+      continue;
+    }
+
+    string name = ref;
+    if (ref.compare(0, sizeof(DEFINITIONS_PREFIX) - 1,
+                    DEFINITIONS_PREFIX) == 0) {
+      name = ref.substr(sizeof(DEFINITIONS_PREFIX) - 1);
+    }
+    map<string, unsigned int>::const_iterator iter = m_definitions.find(name);
+    if (iter == m_definitions.end()) {
+      iter = m_definitions.find(ref);
+    }
+    if (iter == m_definitions.end()) {
+      OLA_INFO << "Unable to resolve $ref " << ref;
+      return JsonSchemaProgram::REJECT_INDEX;
+    }
+    index = iter->second;
+  }
+  OLA_WARN << "$ref loop detected";
+  return JsonSchemaProgram::REJECT_INDEX;
+}
+
+void SchemaCompiler::Resolve(vector<unsigned int> *indices) {
+  vector<unsigned int>::iterator iter = indices->begin();
+  for (; iter != indices->end(); ++iter) {
+    *iter = Resolve(*iter);
+  }
+}
+
+unsigned int SchemaCompiler::TrackProperty(const string &name,
+                                           const vector<string> &tracked) {
+  return std::lower_bound(tracked.begin(), tracked.end(), name) -
+      tracked.begin();
+}
+
+
+// JsonSchemaProgram
+// -----------------------------------------------------------------------------
+const unsigned int JsonSchemaProgram::WILDCARD_INDEX;
+const unsigned int JsonSchemaProgram::REJECT_INDEX;
+
+JsonSchemaProgram::Instruction::Instruction()
+    : op(OP_WILDCARD),
+      type(JSON_UNDEFINED),
+      min_length(0),
+      max_length(-1),
+      minimum(NULL),
+      exclusive_minimum(false),
+      maximum(NULL),
+      exclusive_maximum(false),
+      multiple_of(NULL),
+      min_properties(0),
+      max_properties(-1),
+      additional_properties(WILDCARD_INDEX),
+      min_items(0),
+      max_items(-1),
+      unique_items(false),
+      items_is_list(false),
+      additional_items(WILDCARD_INDEX) {
+}
+
+JsonSchemaProgram::JsonSchemaProgram(const JsonObject *schema_json)
+    : m_schema_json(schema_json),
+      m_root(WILDCARD_INDEX) {
+}
+
+JsonSchemaProgram::~JsonSchemaProgram() {}
+
+bool JsonSchemaProgram::IsValid(const string &input) const {
+  StreamingSchemaValidator validator(this);
+  return JsonLexer::Parse(input, &validator) && validator.IsValid();
+}
+
+JsonSchemaProgram* JsonSchemaProgram::Compile(const JsonSchema &schema) {
+  JsonSchemaProgram *program = new JsonSchemaProgram(schema.AsJson());
+  SchemaCompiler compiler(program);
+  compiler.Compile();
+  return program;
+}
+
+JsonSchemaProgram* JsonSchemaProgram::FromString(const string& schema_string,
+                                                 string *error) {
+  auto_ptr<JsonSchema> schema(JsonSchema::FromString(schema_string, error));
+  if (!schema.get()) {
+    return NULL;
+  }
+  return Compile(*schema);
+}
+
+
+// StreamingSchemaValidator
+// -----------------------------------------------------------------------------
+StreamingSchemaValidator::StreamingSchemaValidator(
+    const JsonSchemaProgram *program)
+    : m_program(program),
+      m_root(program->m_root),
+      m_captures(0),
+      m_started(false),
+      m_complete(false),
+      m_is_valid(false) {
+}
+
+StreamingSchemaValidator::StreamingSchemaValidator(
+    const JsonSchemaProgram *program,
+    unsigned int root)
+    : m_program(program),
+      m_root(root),
+      m_captures(0),
+      m_started(false),
+      m_complete(false),
+      m_is_valid(false) {
+}
+
+StreamingSchemaValidator::~StreamingSchemaValidator() {
+  Reset();
+}
+
+void StreamingSchemaValidator::Begin() {
+  Reset();
+  m_error.clear();
+  m_started = false;
+  m_complete = false;
+  m_is_valid = false;
+}
+
+void StreamingSchemaValidator::End() {
+  if (!m_levels.empty()) {
+    SetError("Document ended inside a container");
+  }
+}
+
+void StreamingSchemaValidator::String(const string &value) {
+  if (!StartValue(false)) {
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->String(value);
+    }
+  }
+
+  // Only build a JsonString if there's an enum to compare against.
+  auto_ptr<JsonString> json_value;
+  const Level &level = m_levels.back();
+  for (unsigned int i = level.first_check; i < level.end_check; i++) {
+    Check &check = m_checks[i];
+    const Instruction &ins = m_program->GetInstruction(check.instruction);
+    if (!check.is_valid || ins.op != JsonSchemaProgram::OP_TYPED) {
+      continue;
+    }
+    if (ins.type != JSON_STRING ||
+        value.size() < ins.min_length ||
+        (ins.max_length >= 0 &&
+         value.size() > static_cast<size_t>(ins.max_length))) {
+      check.is_valid = false;
+      continue;
+    }
+    if (!ins.enums.empty()) {
+      if (!json_value.get()) {
+        json_value.reset(new JsonString(value));
+      }
+      check.is_valid = MatchesEnum(ins.enums, *json_value);
+    }
+  }
+  FinishValue();
+}
+
+void StreamingSchemaValidator::Number(uint32_t value) {
+  CheckNumber(value, JsonUInt(value), true);
+}
+
+void StreamingSchemaValidator::Number(int32_t value) {
+  CheckNumber(value, JsonInt(value), true);
+}
+
+void StreamingSchemaValidator::Number(uint64_t value) {
+  CheckNumber(value, JsonUInt64(value), true);
+}
+
+void StreamingSchemaValidator::Number(int64_t value) {
+  CheckNumber(value, JsonInt64(value), true);
+}
+
+void StreamingSchemaValidator::Number(
+    const JsonDouble::DoubleRepresentation &rep) {
+  CheckNumber(rep, JsonDouble(rep), false);
+}
+
+void StreamingSchemaValidator::Number(double value) {
+  CheckNumber(value, JsonDouble(value), false);
+}
+
+void StreamingSchemaValidator::Bool(bool value) {
+  if (!StartValue(false)) {
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->Bool(value);
+    }
+  }
+  CheckScalar(JSON_BOOLEAN, JsonBool(value));
+  FinishValue();
+}
+
+void StreamingSchemaValidator::Null() {
+  if (!StartValue(false)) {
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->Null();
+    }
+  }
+  CheckScalar(JSON_NULL, JsonNull());
+  FinishValue();
+}
+
+void StreamingSchemaValidator::OpenArray() {
+  if (!StartValue(false)) {
+    return;
+  }
+  CheckContainer(JSON_ARRAY);
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->OpenArray();
+    }
+  }
+}
+
+void StreamingSchemaValidator::CloseArray() {
+  if (m_levels.empty() || m_levels.back().is_object) {
+    SetError("Mismatched CloseArray()");
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->CloseArray();
+    }
+  }
+  CloseContainer();
+  FinishValue();
+}
+
+void StreamingSchemaValidator::OpenObject() {
+  if (!StartValue(true)) {
+    return;
+  }
+  CheckContainer(JSON_OBJECT);
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->OpenObject();
+    }
+  }
+}
+
+void StreamingSchemaValidator::ObjectKey(const string &key) {
+  m_key = key;
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->ObjectKey(key);
+    }
+  }
+}
+
+void StreamingSchemaValidator::CloseObject() {
+  if (m_levels.empty() || !m_levels.back().is_object) {
+    SetError("Mismatched CloseObject()");
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->CloseObject();
+    }
+  }
+  CloseContainer();
+  FinishValue();
+}
+
+void StreamingSchemaValidator::SetError(const string &error) {
+  if (m_error.empty()) {
+    m_error = error;
+  }
+}
+
+bool StreamingSchemaValidator::IsValid() const {
+  return m_error.empty() && m_complete && m_is_valid;
+}
+
+/*
+ * Called as each value starts. This creates the checks for the new value
+ * from the checks on the enclosing container, then expands any allOf,
+ * anyOf, oneOf or not checks into checks for their branches.
+ */
+bool StreamingSchemaValidator::StartValue(bool is_object) {
+  if (!m_error.empty()) {
+    return false;
+  }
+
+  const unsigned int first_check = m_checks.size();
+  bool capture = false;
+  if (m_levels.empty()) {
+    if (m_started) {
+      SetError("Multiple top level values");
+      return false;
+    }
+    m_started = true;
+    PushCheck(m_root, -1, false);
+  } else {
+    const Level &parent = m_levels.back();
+    capture = parent.collect_items;
+    for (unsigned int i = parent.first_check; i < parent.end_check; i++) {
+      if (!m_checks[i].is_valid) {
+        continue;
+      }
+      const Instruction &ins = m_program->GetInstruction(
+          m_checks[i].instruction);
+      if (ins.op != JsonSchemaProgram::OP_TYPED ||
+          ins.type != (parent.is_object ? JSON_OBJECT : JSON_ARRAY)) {
+        continue;
+      }
+
+      unsigned int child = ChildInstruction(&m_checks[i]);
+      if (child == JsonSchemaProgram::REJECT_INDEX) {
+        m_checks[i].is_valid = false;
+      } else if (child != JsonSchemaProgram::WILDCARD_INDEX) {
+        PushCheck(child, i, false);
+      }
+    }
+  }
+
+  // Expanding appends to m_checks, so this loop picks up nested branches.
+  for (unsigned int i = first_check; i < m_checks.size(); i++) {
+    if (m_checks.size() - first_check > MAX_CHECKS_PER_VALUE) {
+      SetError("Schema recursion limit reached");
+      return false;
+    }
+    const Instruction &ins = m_program->GetInstruction(
+        m_checks[i].instruction);
+    switch (ins.op) {
+      case JsonSchemaProgram::OP_REJECT:
+        m_checks[i].is_valid = false;
+        break;
+      case JsonSchemaProgram::OP_ALL_OF:
+      case JsonSchemaProgram::OP_ANY_OF:
+      case JsonSchemaProgram::OP_ONE_OF:
+      case JsonSchemaProgram::OP_NOT:
+        for (unsigned int j = 0; j < ins.branches.size(); j++) {
+          PushCheck(ins.branches[j], i,
+                    ins.op != JsonSchemaProgram::OP_ALL_OF);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  Level level(first_check, is_object);
+  level.end_check = m_checks.size();
+  if (capture) {
+    level.capture = new JsonParser();
+    level.capture->Begin();
+    m_captures++;
+  }
+  m_levels.push_back(level);
+  return true;
+}
+
+/*
+ * Called once a value is complete. This combines the results of the checks,
+ * from the innermost branches outwards, and passes them to the enclosing
+ * checks.
+ */
+void StreamingSchemaValidator::FinishValue() {
+  Level level = m_levels.back();
+  m_levels.pop_back();
+
+  for (unsigned int i = level.end_check; i-- > level.first_check;) {
+    const Check &check = m_checks[i];
+    bool is_valid = check.is_valid;
+    switch (m_program->GetInstruction(check.instruction).op) {
+      case JsonSchemaProgram::OP_ANY_OF:
+        is_valid &= check.passed > 0;
+        break;
+      case JsonSchemaProgram::OP_ONE_OF:
+        is_valid &= check.passed == 1;
+        break;
+      case JsonSchemaProgram::OP_NOT:
+        is_valid &= check.passed == 0;
+        break;
+      default:
+        break;
+    }
+
+    if (check.parent < 0) {
+      m_is_valid = is_valid;
+    } else if (check.is_branch) {
+      if (is_valid) {
+        m_checks[check.parent].passed++;
+      }
+    } else if (!is_valid) {
+      m_checks[check.parent].is_valid = false;
+    }
+  }
+  m_checks.erase(m_checks.begin() + level.first_check, m_checks.end());
+
+  if (level.capture) {
+    level.capture->End();
+    m_captures--;
+    if (!m_levels.empty() && m_levels.back().collect_items) {
+      m_items.back().push_back(level.capture->ClaimRoot());
+    }
+    delete level.capture;
+  }
+  if (level.collect_items) {
+    STLDeleteElements(&m_items.back());
+    m_items.pop_back();
+  }
+
+  if (m_levels.empty()) {
+    m_complete = true;
+  }
+}
+
+void StreamingSchemaValidator::CheckScalar(JsonType type,
+                                           const JsonValue &value) {
+  const Level &level = m_levels.back();
+  for (unsigned int i = level.first_check; i < level.end_check; i++) {
+    Check &check = m_checks[i];
+    const Instruction &ins = m_program->GetInstruction(check.instruction);
+    if (!check.is_valid || ins.op != JsonSchemaProgram::OP_TYPED) {
+      continue;
+    }
+    check.is_valid = ins.type == type && MatchesEnum(ins.enums, value);
+  }
+}
+
+template <typename T>
+void StreamingSchemaValidator::CheckNumber(const T &raw_value,
+                                           const JsonNumber &value,
+                                           bool is_integer) {
+  if (!StartValue(false)) {
+    return;
+  }
+  for (unsigned int i = 0; m_captures && i < m_levels.size(); i++) {
+    if (m_levels[i].capture) {
+      m_levels[i].capture->Number(raw_value);
+    }
+  }
+
+  const Level &level = m_levels.back();
+  for (unsigned int i = level.first_check; i < level.end_check; i++) {
+    Check &check = m_checks[i];
+    const Instruction &ins = m_program->GetInstruction(check.instruction);
+    if (!check.is_valid || ins.op != JsonSchemaProgram::OP_TYPED) {
+      continue;
+    }
+    if (!(ins.type == JSON_NUMBER ||
+          (ins.type == JSON_INTEGER && is_integer))) {
+      check.is_valid = false;
+      continue;
+    }
+    if (ins.multiple_of && !value.MultipleOf(*ins.multiple_of)) {
+      check.is_valid = false;
+    } else if (ins.maximum && !(ins.exclusive_maximum ?
+                                value < *ins.maximum :
+                                value <= *ins.maximum)) {
+      check.is_valid = false;
+    } else if (ins.minimum && !(ins.exclusive_minimum ?
+                                value > *ins.minimum :
+                                value >= *ins.minimum)) {
+      check.is_valid = false;
+    } else {
+      check.is_valid = MatchesEnum(ins.enums, value);
+    }
+  }
+  FinishValue();
+}
+
+/*
+ * Type check an object or array, and work out if we'll need to keep the
+ * value, or its elements, for later.
+ */
+void StreamingSchemaValidator::CheckContainer(JsonType type) {
+  Level &level = m_levels.back();
+  bool capture = false;
+  for (unsigned int i = level.first_check; i < level.end_check; i++) {
+    Check &check = m_checks[i];
+    const Instruction &ins = m_program->GetInstruction(check.instruction);
+    if (!check.is_valid || ins.op != JsonSchemaProgram::OP_TYPED) {
+      continue;
+    }
+    if (ins.type != type) {
+      check.is_valid = false;
+      continue;
+    }
+    check.seen.assign(ins.tracked_properties.size(), false);
+    level.collect_items |= ins.unique_items;
+    capture |= !ins.schema_dependencies.empty();
+  }
+
+  if (level.collect_items) {
+    m_items.push_back(vector<const JsonValue*>());
+  }
+  if (capture && !level.capture) {
+    level.capture = new JsonParser();
+    level.capture->Begin();
+    m_captures++;
+  }
+}
+
+/*
+ * Apply the checks that need the whole object or array.
+ */
+void StreamingSchemaValidator::CloseContainer() {
+  const Level &level = m_levels.back();
+  const bool has_duplicates = level.collect_items &&
+      HasDuplicates(m_items.back());
+
+  for (unsigned int i = level.first_check; i < level.end_check; i++) {
+    Check &check = m_checks[i];
+    const Instruction &ins = m_program->GetInstruction(check.instruction);
+    if (!check.is_valid || ins.op != JsonSchemaProgram::OP_TYPED) {
+      continue;
+    }
+
+    if (!level.is_object) {
+      // As with the ArrayValidator, a maxItems of 0 isn't enforced.
+      check.is_valid = !(
+          check.count < ins.min_items ||
+          (ins.max_items > 0 &&
+           check.count > static_cast<unsigned int>(ins.max_items)) ||
+          (ins.unique_items && has_duplicates));
+      continue;
+    }
+
+    // As with the ObjectValidator, a maxProperties of 0 isn't enforced.
+    if (check.count < ins.min_properties ||
+        (ins.max_properties > 0 &&
+         check.count > static_cast<unsigned int>(ins.max_properties))) {
+      check.is_valid = false;
+      continue;
+    }
+
+    for (unsigned int j = 0; j < ins.required.size(); j++) {
+      if (!check.seen[ins.required[j]]) {
+        check.is_valid = false;
+      }
+    }
+
+    for (unsigned int j = 0;
+         j < ins.property_dependencies.size() && check.is_valid; j++) {
+      const JsonSchemaProgram::PropertyDependency &dependency =
+          ins.property_dependencies[j];
+      if (!check.seen[dependency.first]) {
+        continue;
+      }
+      for (unsigned int k = 0; k < dependency.second.size(); k++) {
+        if (!check.seen[dependency.second[k]]) {
+          check.is_valid = false;
+        }
+      }
+    }
+
+    for (unsigned int j = 0;
+         j < ins.schema_dependencies.size() && check.is_valid; j++) {
+      if (check.seen[ins.schema_dependencies[j].first] &&
+          !MatchesInstruction(ins.schema_dependencies[j].second,
+                              *level.capture->GetRoot())) {
+        check.is_valid = false;
+      }
+    }
+  }
+}
+
+/*
+ * Returns the instruction to apply to the next property or element of a
+ * container.
+ */
+unsigned int StreamingSchemaValidator::ChildInstruction(Check *check) {
+  const Instruction &ins = m_program->GetInstruction(check->instruction);
+  const unsigned int index = check->count++;
+
+  if (ins.type == JSON_ARRAY) {
+    if (ins.items_is_list && index < ins.items.size()) {
+      return ins.items[index];
+    }
+    return ins.additional_items;
+  }
+
+  const vector<string> &tracked = ins.tracked_properties;
+  vector<string>::const_iterator tracked_iter = std::lower_bound(
+      tracked.begin(), tracked.end(), m_key);
+  if (tracked_iter != tracked.end() && *tracked_iter == m_key) {
+    check->seen[tracked_iter - tracked.begin()] = true;
+  }
+
+  JsonSchemaProgram::NamedIndexList::const_iterator iter = std::lower_bound(
+      ins.properties.begin(), ins.properties.end(), m_key, CompareName);
+  if (iter != ins.properties.end() && iter->first == m_key) {
+    return iter->second;
+  }
+  return ins.additional_properties;
+}
+
+void StreamingSchemaValidator::PushCheck(unsigned int instruction,
+                                         int parent,
+                                         bool is_branch) {
+  m_checks.push_back(Check(instruction, parent, is_branch));
+}
+
+/*
+ * Run a complete value through another instruction. This is only used for
+ * schema dependencies, where we don't know which schemas apply to the
+ * object until we've seen all of it.
+ */
+bool StreamingSchemaValidator::MatchesInstruction(
+    unsigned int instruction,
+    const JsonValue &value) const {
+  StreamingSchemaValidator validator(m_program, instruction);
+  return (JsonLexer::Parse(JsonWriter::AsString(value), &validator) &&
+          validator.IsValid());
+}
+
+void StreamingSchemaValidator::Reset() {
+  vector<Level>::iterator iter = m_levels.begin();
+  for (; iter != m_levels.end(); ++iter) {
+    delete iter->capture;
+  }
+  m_levels.clear();
+  m_checks.clear();
+  vector<vector<const JsonValue*> >::iterator items_iter = m_items.begin();
+  for (; items_iter != m_items.end(); ++items_iter) {
+    STLDeleteElements(&(*items_iter));
+  }
+  m_items.clear();
+  m_captures = 0;
+  m_key.clear();
+}
+}  // namespace web
+}  // namespace ola
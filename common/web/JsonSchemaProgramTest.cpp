@@ -0,0 +1,276 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonSchemaProgramTest.cpp
+ * Unittest for the JsonSchemaProgram and StreamingSchemaValidator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonLexer.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonSchema.h"
+#include "ola/web/JsonSchemaProgram.h"
+
+using ola::web::JsonLexer;
+using ola::web::JsonParser;
+using ola::web::JsonSchema;
+using ola::web::JsonSchemaProgram;
+using ola::web::JsonValue;
+using ola::web::StreamingSchemaValidator;
+using std::auto_ptr;
+using std::string;
+
+class JsonSchemaProgramTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(JsonSchemaProgramTest);
+  CPPUNIT_TEST(testMatchesSchema);
+  CPPUNIT_TEST(testReferences);
+  CPPUNIT_TEST(testMalformedInput);
+  CPPUNIT_TEST(testReuse);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testMatchesSchema();
+  void testReferences();
+  void testMalformedInput();
+  void testReuse();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JsonSchemaProgramTest);
+
+namespace {
+
+struct TestCase {
+  const char *schema;
+  const char *document;
+  bool expected;
+};
+
+const TestCase TEST_CASES[] = {
+  {"{}", "[1, {\"a\": null}]", true},
+  {"{\"type\": \"string\"}", "\"foo\"", true},
+  {"{\"type\": \"string\"}", "1", false},
+  {"{\"type\": \"string\", \"minLength\": 2, \"maxLength\": 3}", "\"f\"",
+   false},
+  {"{\"type\": \"string\", \"minLength\": 2, \"maxLength\": 3}", "\"foo\"",
+   true},
+  {"{\"type\": \"string\", \"minLength\": 2, \"maxLength\": 3}", "\"food\"",
+   false},
+  {"{\"type\": \"string\", \"enum\": [\"a\", \"b\"]}", "\"b\"", true},
+  {"{\"type\": \"string\", \"enum\": [\"a\", \"b\"]}", "\"c\"", false},
+  {"{\"type\": \"boolean\"}", "false", true},
+  {"{\"type\": \"boolean\"}", "null", false},
+  {"{\"type\": \"null\"}", "null", true},
+  {"{\"type\": \"integer\"}", "-5", true},
+  {"{\"type\": \"integer\"}", "1.5", false},
+  {"{\"type\": \"integer\", \"minimum\": 2, \"maximum\": 4}", "4", true},
+  {"{\"type\": \"integer\", \"minimum\": 2, \"maximum\": 4,"
+   " \"exclusiveMaximum\": true}", "4", false},
+  {"{\"type\": \"integer\", \"minimum\": 2, \"exclusiveMinimum\": true}",
+   "2", false},
+  {"{\"type\": \"integer\", \"multipleOf\": 3}", "9", true},
+  {"{\"type\": \"integer\", \"multipleOf\": 3}", "10", false},
+  {"{\"type\": \"number\", \"maximum\": 2.5}", "2.25", true},
+  {"{\"type\": \"number\", \"maximum\": 2.5}", "3", false},
+  {"{\"type\": \"number\", \"enum\": [1, 2.5]}", "2.5", true},
+  {"{\"type\": \"object\"}", "[]", false},
+  {"{\"type\": \"object\", \"minProperties\": 1, \"maxProperties\": 2}",
+   "{}", false},
+  {"{\"type\": \"object\", \"minProperties\": 1, \"maxProperties\": 2}",
+   "{\"a\": 1, \"b\": 2, \"c\": 3}", false},
+  {"{\"type\": \"object\", \"required\": [\"a\", \"b\"]}",
+   "{\"b\": 1, \"a\": 2}", true},
+  {"{\"type\": \"object\", \"required\": [\"a\", \"b\"]}",
+   "{\"b\": 1, \"c\": 2}", false},
+  {"{\"type\": \"object\", \"properties\": {\"a\": {\"type\": \"integer\"}}}",
+   "{\"a\": 1, \"b\": \"x\"}", true},
+  {"{\"type\": \"object\", \"properties\": {\"a\": {\"type\": \"integer\"}}}",
+   "{\"a\": \"x\"}", false},
+  {"{\"type\": \"object\", \"properties\": {\"a\": {}},"
+   " \"additionalProperties\": false}", "{\"a\": 1, \"b\": 2}", false},
+  {"{\"type\": \"object\", \"additionalProperties\": {\"type\": \"string\"}}",
+   "{\"a\": \"x\", \"b\": \"y\"}", true},
+  {"{\"type\": \"object\", \"additionalProperties\": {\"type\": \"string\"}}",
+   "{\"a\": \"x\", \"b\": {}}", false},
+  {"{\"type\": \"object\", \"dependencies\": {\"a\": [\"b\"]}}",
+   "{\"a\": 1}", false},
+  {"{\"type\": \"object\", \"dependencies\": {\"a\": [\"b\"]}}",
+   "{\"a\": 1, \"b\": 2}", true},
+  {"{\"type\": \"object\", \"dependencies\": {\"a\": [\"b\"]}}",
+   "{\"c\": 1}", true},
+  {"{\"type\": \"object\", \"dependencies\": {\"a\": {\"type\": \"object\","
+   " \"required\": [\"c\"]}}}", "{\"a\": 1, \"c\": [1, {}]}", true},
+  {"{\"type\": \"object\", \"dependencies\": {\"a\": {\"type\": \"object\","
+   " \"required\": [\"c\"]}}}", "{\"a\": 1}", false},
+  {"{\"type\": \"array\", \"minItems\": 1, \"maxItems\": 2}", "[]", false},
+  {"{\"type\": \"array\", \"minItems\": 1, \"maxItems\": 2}", "[1, 2, 3]",
+   false},
+  {"{\"type\": \"array\", \"items\": {\"type\": \"integer\"}}", "[1, 2, 3]",
+   true},
+  {"{\"type\": \"array\", \"items\": {\"type\": \"integer\"}}",
+   "[1, \"2\", 3]", false},
+  {"{\"type\": \"array\", \"items\": [{\"type\": \"integer\"},"
+   " {\"type\": \"string\"}]}", "[1, \"2\", null]", true},
+  {"{\"type\": \"array\", \"items\": [{\"type\": \"integer\"},"
+   " {\"type\": \"string\"}], \"additionalItems\": false}",
+   "[1, \"2\", null]", false},
+  {"{\"type\": \"array\", \"items\": [{\"type\": \"integer\"}],"
+   " \"additionalItems\": {\"type\": \"null\"}}", "[1, null, null]", true},
+  {"{\"type\": \"array\", \"uniqueItems\": true}",
+   "[1, \"1\", {\"a\": [1]}, {\"a\": [2]}]", true},
+  {"{\"type\": \"array\", \"uniqueItems\": true}",
+   "[1, {\"a\": [1]}, {\"a\": [1]}]", false},
+  {"{\"type\": \"array\", \"items\": {\"type\": \"array\","
+   " \"uniqueItems\": true}}", "[[1, 2], [1, 2], [3, 3]]", false},
+  {"{\"allOf\": [{\"type\": \"integer\"}, {\"type\": \"integer\","
+   " \"minimum\": 3}]}", "4", true},
+  {"{\"allOf\": [{\"type\": \"integer\"}, {\"type\": \"integer\","
+   " \"minimum\": 3}]}", "2", false},
+  {"{\"anyOf\": [{\"type\": \"string\"}, {\"type\": \"integer\"}]}", "2",
+   true},
+  {"{\"anyOf\": [{\"type\": \"string\"}, {\"type\": \"integer\"}]}", "null",
+   false},
+  {"{\"oneOf\": [{\"type\": \"integer\"}, {\"type\": \"number\"}]}", "2",
+   false},
+  {"{\"oneOf\": [{\"type\": \"integer\"}, {\"type\": \"number\"}]}", "2.5",
+   true},
+  {"{\"not\": {\"type\": \"string\"}}", "\"foo\"", false},
+  {"{\"not\": {\"type\": \"string\"}}", "[\"foo\"]", true},
+  {"{\"type\": \"object\", \"properties\": {\"a\": {\"anyOf\": ["
+   "{\"type\": \"object\", \"required\": [\"x\"]},"
+   " {\"type\": \"array\", \"minItems\": 2}]}}}",
+   "{\"a\": {\"y\": {\"x\": 1}}}", false},
+  {"{\"type\": \"object\", \"properties\": {\"a\": {\"anyOf\": ["
+   "{\"type\": \"object\", \"required\": [\"x\"]},"
+   " {\"type\": \"array\", \"minItems\": 2}]}}}",
+   "{\"a\": [{\"x\": 1}, 2]}", true},
+};
+}  // namespace
+
+
+/*
+ * Check the program gives the same answers as JsonSchema::IsValid().
+ */
+void JsonSchemaProgramTest::testMatchesSchema() {
+  for (unsigned int i = 0; i < sizeof(TEST_CASES) / sizeof(TEST_CASES[0]);
+       i++) {
+    const TestCase &test = TEST_CASES[i];
+    string error;
+    auto_ptr<JsonSchema> schema(JsonSchema::FromString(test.schema, &error));
+    OLA_ASSERT_NOT_NULL(schema.get());
+    auto_ptr<JsonValue> document(JsonParser::Parse(test.document, &error));
+    OLA_ASSERT_NOT_NULL(document.get());
+
+    auto_ptr<JsonSchemaProgram> program(JsonSchemaProgram::Compile(*schema));
+    OLA_ASSERT_EQ_MSG(test.expected, schema->IsValid(*document),
+                      string(test.schema) + " : " + test.document);
+    OLA_ASSERT_EQ_MSG(test.expected, program->IsValid(test.document),
+                      string(test.schema) + " : " + test.document);
+  }
+}
+
+
+/*
+ * Check $refs are resolved.
+ */
+void JsonSchemaProgramTest::testReferences() {
+  const string schema_text =
+      "{\"type\": \"array\","
+      " \"items\": {\"$ref\": \"#/definitions/positive\"},"
+      " \"definitions\": {"
+      "  \"positive\": {\"type\": \"integer\", \"minimum\": 0},"
+      "  \"tree\": {\"type\": \"object\","
+      "    \"properties\": {\"children\": {\"type\": \"array\","
+      "      \"items\": {\"$ref\": \"#/definitions/tree\"}}}},"
+      "  \"loop\": {\"$ref\": \"#/definitions/loop\"}"
+      " }"
+      "}";
+  string error;
+  auto_ptr<JsonSchemaProgram> program(
+      JsonSchemaProgram::FromString(schema_text, &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+  OLA_ASSERT_TRUE(program->IsValid("[1, 2, 3]"));
+  OLA_ASSERT_FALSE(program->IsValid("[1, -2, 3]"));
+
+  // The root schema
+  program.reset(JsonSchemaProgram::FromString(
+      "{\"type\": \"array\", \"items\": {\"$ref\": \"#\"}}", &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+  OLA_ASSERT_TRUE(program->IsValid("[[], [[]]]"));
+  OLA_ASSERT_FALSE(program->IsValid("[[], [1]]"));
+
+  // Missing and looping references match nothing.
+  program.reset(JsonSchemaProgram::FromString(
+      "{\"anyOf\": [{\"$ref\": \"#/definitions/missing\"},"
+      " {\"$ref\": \"#/definitions/loop\"}],"
+      " \"definitions\": {\"loop\": {\"$ref\": \"#/definitions/loop\"}}}",
+      &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+  OLA_ASSERT_FALSE(program->IsValid("1"));
+
+  // A schema that recurses without consuming input.
+  program.reset(JsonSchemaProgram::FromString(
+      "{\"allOf\": [{\"$ref\": \"#\"}]}", &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+  StreamingSchemaValidator validator(program.get());
+  JsonLexer::Parse("1", &validator);
+  OLA_ASSERT_FALSE(validator.IsValid());
+  OLA_ASSERT_FALSE(validator.Error().empty());
+}
+
+
+/*
+ * Check malformed documents are rejected.
+ */
+void JsonSchemaProgramTest::testMalformedInput() {
+  string error;
+  auto_ptr<JsonSchemaProgram> program(
+      JsonSchemaProgram::FromString("{}", &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+  OLA_ASSERT_TRUE(program->IsValid("{\"a\": [1, 2]}"));
+  OLA_ASSERT_FALSE(program->IsValid("{\"a\": [1, 2}"));
+  OLA_ASSERT_FALSE(program->IsValid("[1, 2"));
+  OLA_ASSERT_FALSE(program->IsValid(""));
+
+  // Bad schemas are reported.
+  OLA_ASSERT_NULL(JsonSchemaProgram::FromString("{\"type\": 1}", &error));
+  OLA_ASSERT_FALSE(error.empty());
+}
+
+
+/*
+ * Check a validator can be used for more than one document.
+ */
+void JsonSchemaProgramTest::testReuse() {
+  string error;
+  auto_ptr<JsonSchemaProgram> program(JsonSchemaProgram::FromString(
+      "{\"type\": \"array\", \"uniqueItems\": true}", &error));
+  OLA_ASSERT_NOT_NULL(program.get());
+
+  StreamingSchemaValidator validator(program.get());
+  OLA_ASSERT_FALSE(JsonLexer::Parse("[[1], [1", &validator));
+  OLA_ASSERT_FALSE(validator.IsValid());
+
+  OLA_ASSERT_TRUE(JsonLexer::Parse("[[1], [2]]", &validator));
+  OLA_ASSERT_TRUE(validator.IsValid());
+
+  OLA_ASSERT_TRUE(JsonLexer::Parse("[[1], [1]]", &validator));
+  OLA_ASSERT_FALSE(validator.IsValid());
+}
@@ -0,0 +1,263 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.cpp
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <sstream>
+#include <string>
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/web/JsonStreamWriter.h"
+
+namespace ola {
+namespace web {
+
+using std::ostringstream;
+using std::string;
+
+namespace {
+/*
+ * Append the decimal representation of an integer, without the temporary
+ * string IntToString() would create.
+ */
+void AppendUInt(string *output, unsigned int i, bool negative) {
+  char buffer[12];
+  char *ptr = buffer + sizeof(buffer);
+  do {
+    *(--ptr) = static_cast<char>('0' + (i % 10));
+    i /= 10;
+  } while (i);
+  if (negative) {
+    *(--ptr) = '-';
+  }
+  output->append(ptr, buffer + sizeof(buffer) - ptr);
+}
+
+void AppendInt(string *output, int i) {
+  if (i < 0) {
+    // Avoid overflow when negating INT_MIN.
+    AppendUInt(output, static_cast<unsigned int>(-(i + 1)) + 1, true);
+  } else {
+    AppendUInt(output, static_cast<unsigned int>(i), false);
+  }
+}
+
+void AppendDouble(string *output, double d) {
+  // Matches JsonDouble.
+  ostringstream str;
+  str << d;
+  output->append(str.str());
+}
+}  // namespace
+
+JsonStreamWriter::JsonStreamWriter(string *output)
+    : m_output(output),
+      m_indent(0),
+      m_started(false) {
+}
+
+void JsonStreamWriter::End() {
+  if (m_scopes.empty()) {
+    OLA_WARN << "JsonStreamWriter::End() called with nothing to close";
+    return;
+  }
+
+  const Scope scope = m_scopes.back();
+  m_scopes.pop_back();
+  if (scope.is_object) {
+    m_indent -= DEFAULT_INDENT;
+    if (scope.has_items) {
+      m_output->push_back('\n');
+      WriteIndent();
+    }
+    m_output->push_back('}');
+  } else {
+    if (scope.multi_line) {
+      m_output->push_back('\n');
+      m_indent -= DEFAULT_INDENT;
+      WriteIndent();
+    }
+    m_output->push_back(']');
+  }
+}
+
+void JsonStreamWriter::Add(const string &key, const string &value) {
+  WriteKey(key);
+  WriteString(value);
+}
+
+void JsonStreamWriter::Add(const string &key, const char *value) {
+  WriteKey(key);
+  WriteString(value);
+}
+
+void JsonStreamWriter::Add(const string &key, unsigned int i) {
+  WriteKey(key);
+  AppendUInt(m_output, i, false);
+}
+
+void JsonStreamWriter::Add(const string &key, int i) {
+  WriteKey(key);
+  AppendInt(m_output, i);
+}
+
+void JsonStreamWriter::Add(const string &key, double d) {
+  WriteKey(key);
+  AppendDouble(m_output, d);
+}
+
+void JsonStreamWriter::Add(const string &key, bool value) {
+  WriteKey(key);
+  m_output->append(value ? "true" : "false");
+}
+
+void JsonStreamWriter::Add(const string &key) {
+  WriteKey(key);
+  m_output->append("null");
+}
+
+void JsonStreamWriter::AddRaw(const string &key, const string &value) {
+  WriteKey(key);
+  m_output->append(value);
+}
+
+void JsonStreamWriter::AddObject(const string &key) {
+  WriteKey(key);
+  StartScope(true);
+}
+
+void JsonStreamWriter::AddArray(const string &key) {
+  WriteKey(key);
+  StartScope(false);
+}
+
+void JsonStreamWriter::Append(const string &value) {
+  StartElement(false);
+  WriteString(value);
+}
+
+void JsonStreamWriter::Append(const char *value) {
+  StartElement(false);
+  WriteString(value);
+}
+
+void JsonStreamWriter::Append(unsigned int i) {
+  StartElement(false);
+  AppendUInt(m_output, i, false);
+}
+
+void JsonStreamWriter::Append(int i) {
+  StartElement(false);
+  AppendInt(m_output, i);
+}
+
+void JsonStreamWriter::Append(bool value) {
+  StartElement(false);
+  m_output->append(value ? "true" : "false");
+}
+
+void JsonStreamWriter::Append() {
+  StartElement(false);
+  m_output->append("null");
+}
+
+void JsonStreamWriter::AppendRaw(const string &value) {
+  StartElement(false);
+  m_output->append(value);
+}
+
+void JsonStreamWriter::AppendObject() {
+  StartElement(true);
+  StartScope(true);
+}
+
+void JsonStreamWriter::AppendArray() {
+  StartElement(true);
+  StartScope(false);
+}
+
+void JsonStreamWriter::WriteKey(const string &key) {
+  if (m_scopes.empty() || !m_scopes.back().is_object) {
+    OLA_WARN << "JsonStreamWriter: " << key << " added outside an object";
+    return;
+  }
+  Scope &scope = m_scopes.back();
+  m_output->append(scope.has_items ? ",\n" : "\n");
+  scope.has_items = true;
+  WriteIndent();
+  m_output->push_back('"');
+  m_output->append(EscapeString(key));
+  m_output->append("\": ");
+}
+
+/*
+ * Write the separator before an element. Only arrays and the top level
+ * have elements; in an object the key does this.
+ */
+void JsonStreamWriter::StartElement(bool is_complex) {
+  if (m_scopes.empty()) {
+    if (m_started) {
+      OLA_WARN << "JsonStreamWriter: more than one top level value";
+    }
+    m_started = true;
+    return;
+  }
+
+  Scope &scope = m_scopes.back();
+  if (scope.is_object) {
+    OLA_WARN << "JsonStreamWriter: value appended to an object";
+    return;
+  }
+
+  if (!scope.has_items) {
+    scope.has_items = true;
+    if (is_complex) {
+      scope.multi_line = true;
+      m_indent += DEFAULT_INDENT;
+      m_output->push_back('\n');
+      WriteIndent();
+    }
+  } else if (scope.multi_line) {
+    m_output->append(",\n");
+    WriteIndent();
+  } else {
+    m_output->append(", ");
+  }
+}
+
+void JsonStreamWriter::StartScope(bool is_object) {
+  m_scopes.push_back(Scope(is_object));
+  if (is_object) {
+    m_indent += DEFAULT_INDENT;
+    m_output->push_back('{');
+  } else {
+    m_output->push_back('[');
+  }
+}
+
+void JsonStreamWriter::WriteString(const string &value) {
+  m_output->push_back('"');
+  m_output->append(EscapeString(EncodeString(value)));
+  m_output->push_back('"');
+}
+
+void JsonStreamWriter::WriteIndent() {
+  m_output->append(m_indent, ' ');
+}
+}  // namespace web
+}  // namespace ola
@@ -0,0 +1,198 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriterTest.cpp
+ * Unittest for the JsonStreamWriter.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <limits.h>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
+#include "ola/web/JsonWriter.h"
+
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using ola::web::JsonStreamWriter;
+using ola::web::JsonWriter;
+using std::string;
+
+class JsonStreamWriterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(JsonStreamWriterTest);
+  CPPUNIT_TEST(testScalars);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testSimpleArray);
+  CPPUNIT_TEST(testObject);
+  CPPUNIT_TEST(testNested);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testScalars();
+  void testEmpty();
+  void testSimpleArray();
+  void testObject();
+  void testNested();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JsonStreamWriterTest);
+
+
+/*
+ * Test scalar values in an array.
+ */
+void JsonStreamWriterTest::testScalars() {
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartArray();
+  writer.Append("foo\"bar");
+  writer.Append(string("\n"));
+  writer.Append(42u);
+  writer.Append(-1);
+  writer.Append(INT_MIN);
+  writer.Append(UINT_MAX);
+  writer.Append(true);
+  writer.Append(false);
+  writer.Append();
+  writer.AppendRaw("1.5e2");
+  OLA_ASSERT_FALSE(writer.IsComplete());
+  writer.End();
+  OLA_ASSERT_TRUE(writer.IsComplete());
+
+  OLA_ASSERT_EQ(string("[\"foo\\\"bar\", \"\\\\x0a\", 42, -1, -2147483648, "
+                       "4294967295, true, false, null, 1.5e2]"),
+                output);
+}
+
+
+/*
+ * Test empty containers match the JsonWriter.
+ */
+void JsonStreamWriterTest::testEmpty() {
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartObject();
+  writer.End();
+  OLA_ASSERT_EQ(JsonWriter::AsString(JsonObject()), output);
+
+  output.clear();
+  JsonStreamWriter array_writer(&output);
+  array_writer.StartArray();
+  array_writer.End();
+  OLA_ASSERT_EQ(JsonWriter::AsString(JsonArray()), output);
+}
+
+
+/*
+ * Test a simple array matches the JsonWriter.
+ */
+void JsonStreamWriterTest::testSimpleArray() {
+  JsonArray array;
+  array.Append(1);
+  array.Append("two");
+  array.Append(true);
+
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartArray();
+  writer.Append(1);
+  writer.Append("two");
+  writer.Append(true);
+  writer.End();
+  OLA_ASSERT_EQ(JsonWriter::AsString(array), output);
+}
+
+
+/*
+ * Test an object matches the JsonWriter.
+ */
+void JsonStreamWriterTest::testObject() {
+  JsonObject object;
+  object.Add("bool", false);
+  object.Add("double", 1.5);
+  object.Add("int", -4);
+  object.Add("null");
+  object.Add("string", "foo");
+  object.Add("uint", 10u);
+
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartObject();
+  // JsonObject sorts the keys, so add them in order.
+  writer.Add("bool", false);
+  writer.Add("double", 1.5);
+  writer.Add("int", -4);
+  writer.Add("null");
+  writer.Add("string", "foo");
+  writer.Add("uint", 10u);
+  writer.End();
+  OLA_ASSERT_EQ(JsonWriter::AsString(object), output);
+}
+
+
+/*
+ * Test nested objects and arrays match the JsonWriter.
+ */
+void JsonStreamWriterTest::testNested() {
+  JsonObject object;
+  object.Add("id", 1);
+  object.AddObject("empty");
+  JsonArray *ports = object.AddArray("ports");
+  for (unsigned int i = 0; i < 3; i++) {
+    JsonObject *port = ports->AppendObject();
+    port->Add("id", i);
+    JsonArray *values = port->AddArray("values");
+    values->Append(i);
+    values->Append(i + 1);
+    port->AddObject("priority")->Add("value", 100);
+  }
+  JsonArray *nested = object.AddArray("z_nested");
+  nested->AppendArray()->Append(1);
+  nested->AppendArray();
+
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartObject();
+  writer.AddObject("empty");
+  writer.End();
+  writer.Add("id", 1);
+  writer.AddArray("ports");
+  for (unsigned int i = 0; i < 3; i++) {
+    writer.AppendObject();
+    writer.Add("id", i);
+    writer.AddObject("priority");
+    writer.Add("value", 100);
+    writer.End();
+    writer.AddArray("values");
+    writer.Append(i);
+    writer.Append(i + 1);
+    writer.End();
+    writer.End();
+  }
+  writer.End();
+  writer.AddArray("z_nested");
+  writer.AppendArray();
+  writer.Append(1);
+  writer.End();
+  writer.AppendArray();
+  writer.End();
+  writer.End();
+  writer.End();
+  OLA_ASSERT_TRUE(writer.IsComplete());
+  OLA_ASSERT_EQ(JsonWriter::AsString(object), output);
+}
@@ -25,7 +25,9 @@ common_web_libolaweb_la_SOURCES = \
     common/web/JsonPatchParser.cpp \
     common/web/JsonPointer.cpp \
     common/web/JsonSchema.cpp \
+    common/web/JsonSchemaProgram.cpp \
     common/web/JsonSections.cpp \
+    common/web/JsonStreamWriter.cpp \
     common/web/JsonTypes.cpp \
     common/web/JsonWriter.cpp \
     common/web/PointerTracker.cpp \
@@ -61,7 +63,9 @@ test_programs += \
 COMMON_WEB_TEST_LDADD = $(COMMON_TESTING_LIBS) \
                         common/web/libolaweb.la
 
-common_web_JsonTester_SOURCES = common/web/JsonTest.cpp
+common_web_JsonTester_SOURCES = \
+    common/web/JsonStreamWriterTest.cpp \
+    common/web/JsonTest.cpp
 common_web_JsonTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_JsonTester_LDADD = $(COMMON_WEB_TEST_LDADD)
 
@@ -89,7 +93,9 @@ common_web_SchemaParserTester_SOURCES = common/web/SchemaParserTest.cpp
 common_web_SchemaParserTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_SchemaParserTester_LDADD = $(COMMON_WEB_TEST_LDADD)
 
-common_web_SchemaTester_SOURCES = common/web/SchemaTest.cpp
+common_web_SchemaTester_SOURCES = \
+    common/web/JsonSchemaProgramTest.cpp \
+    common/web/SchemaTest.cpp
 common_web_SchemaTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_web_SchemaTester_LDADD = $(COMMON_WEB_TEST_LDADD)
 
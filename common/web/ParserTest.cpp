@@ -47,6 +47,7 @@ class JsonParserTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testParseBool);
   CPPUNIT_TEST(testParseNull);
   CPPUNIT_TEST(testParseString);
+  CPPUNIT_TEST(testStringSequence);
   CPPUNIT_TEST(testParseNumber);
   CPPUNIT_TEST(testArray);
   CPPUNIT_TEST(testObject);
@@ -58,6 +59,7 @@ class JsonParserTest: public CppUnit::TestFixture {
     void testParseBool();
     void testParseNull();
     void testParseString();
+    void testStringSequence();
     void testParseNumber();
     void testArray();
     void testObject();
@@ -121,6 +123,29 @@ void JsonParserTest::testParseString() {
   */
 }
 
+/*
+ * Check strings of differing lengths, with and without escapes, don't leak
+ * into each other.
+ */
+void JsonParserTest::testStringSequence() {
+  string error;
+  auto_ptr<const JsonValue> value(JsonParser::Parse(
+      "{\"a long key that needs an allocation\": "
+      "[\"a much longer value string that also needs an allocation\", "
+      "\"x\", \"\", \"tab\\there\", \"\\\"\\\\\\/\"], "
+      "\"b\": \"short\"}",
+      &error));
+  OLA_ASSERT_NOT_NULL(value.get());
+  OLA_ASSERT_EQ(
+      string("{\n"
+             "  \"a long key that needs an allocation\": "
+             "[\"a much longer value string that also needs an allocation\", "
+             "\"x\", \"\", \"tab\\\\x09here\", \"\\\"\\\\\\/\"],\n"
+             "  \"b\": \"short\"\n"
+             "}"),
+      JsonWriter::AsString(*value.get()));
+}
+
 void JsonParserTest::testParseNumber() {
   string error;
   auto_ptr<const JsonValue> value(JsonParser::Parse(" 0", &error));
@@ -951,4 +951,33 @@ void JsonPatchTest::testAtomicUpdates() {
       " \"object\": {\"bat\": 1}, \"array\": [1,2,3] }",
       text.Value());
   }
+
+  // Every kind of change is undone if a later op fails.
+  {
+    JsonPatchSet patch;
+    patch.AddOp(new JsonPatchRemoveOp(JsonPointer("/foo")));
+    patch.AddOp(new JsonPatchAddOp(
+          JsonPointer("/object/bat"), new JsonInt(2)));
+    patch.AddOp(new JsonPatchAddOp(
+          JsonPointer("/object/new"), new JsonNull()));
+    patch.AddOp(new JsonPatchAddOp(
+          JsonPointer("/array/0"), new JsonInt(0)));
+    patch.AddOp(new JsonPatchAddOp(
+          JsonPointer("/array/-"), new JsonInt(4)));
+    patch.AddOp(new JsonPatchReplaceOp(
+          JsonPointer("/array/1"), new JsonInt(10)));
+    patch.AddOp(new JsonPatchRemoveOp(JsonPointer("/array/-")));
+    patch.AddOp(new JsonPatchRemoveOp(JsonPointer("/array/-")));
+    patch.AddOp(new JsonPatchMoveOp(
+          JsonPointer("/object"), JsonPointer("/moved")));
+    patch.AddOp(new JsonPatchReplaceOp(JsonPointer(""), new JsonObject()));
+    patch.AddOp(new JsonPatchTestOp(
+          JsonPointer("/foo"), new JsonString("bar")));
+    OLA_ASSERT_FALSE(text.Apply(patch));
+
+    CheckValuesMatch(
+      "{\"foo\": \"bar\", \"baz\": true, "
+      " \"object\": {\"bat\": 1}, \"array\": [1,2,3] }",
+      text.Value());
+  }
 }
@@ -5,6 +5,17 @@ dist_piddata_DATA = \
     data/rdm/pids.proto \
     data/rdm/manufacturer_pids.proto
 
+# The binary form of the files above, which is much faster to load.
+nodist_piddata_DATA = data/rdm/pids.pb
+
+data/rdm/pids.pb: $(dist_piddata_DATA) common/rdm/pid_store_compiler$(EXEEXT)
+	common/rdm/pid_store_compiler$(EXEEXT) --output $@ \
+	    $(srcdir)/data/rdm/draft_pids.proto \
+	    $(srcdir)/data/rdm/pids.proto \
+	    $(srcdir)/data/rdm/manufacturer_pids.proto
+
+CLEANFILES += data/rdm/pids.pb
+
 # SCRIPTS
 ################################################
 dist_noinst_SCRIPTS += \
@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShowFormat.h
+ * The layout of binary show files.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+
+#ifndef EXAMPLES_BINARYSHOWFORMAT_H_
+#define EXAMPLES_BINARYSHOWFORMAT_H_
+
+/**
+ * @file BinaryShowFormat.h
+ * @brief The binary show format.
+ *
+ * A binary show is a header, a sequence of frame records, an index and a
+ * footer. All values are big endian.
+ *
+ * Header:
+ *   - 8 byte magic, BINARY_SHOW_MAGIC
+ *   - uint16 version, BINARY_SHOW_VERSION
+ *   - 6 reserved bytes
+ *
+ * Frame record:
+ *   - uint64 time in us since the start of the show
+ *   - uint32 universe
+ *   - uint8 flags, see RecordFlags
+ *   - uint8 reserved
+ *   - uint16 the number of slots in the frame
+ *   - uint16 the length of the payload
+ *   - the payload
+ *
+ * The payload is the raw slot data, the RLE encoded slot data, or the RLE
+ * encoded XOR of the frame with the previous frame for the universe. Since
+ * frames rarely change much from one to the next, the XOR is mostly zeros
+ * and encodes to a few bytes.
+ *
+ * Index entry:
+ *   - uint64 time in us since the start of the show
+ *   - uint64 offset of the first record at or after this time
+ *
+ * Footer:
+ *   - uint64 offset of the index
+ *   - uint64 the end of the show in us, which may be after the last frame
+ *   - uint32 the number of index entries
+ *   - 4 byte magic, BINARY_SHOW_INDEX_MAGIC
+ *
+ * An index entry is written at least every BINARY_SHOW_INDEX_INTERVAL. Each
+ * entry points at a snapshot, a run of full frames for every universe seen
+ * so far, so playback can start from any entry without reading the frames
+ * before it. The snapshot records are skipped during normal playback.
+ */
+
+static const char BINARY_SHOW_MAGIC[] = "\x89OLAShow";
+static const char BINARY_SHOW_INDEX_MAGIC[] = "OIDX";
+
+enum {
+  BINARY_SHOW_VERSION = 1,
+  BINARY_SHOW_MAGIC_SIZE = 8,
+  BINARY_SHOW_HEADER_SIZE = 16,
+  BINARY_SHOW_RECORD_HEADER_SIZE = 18,
+  BINARY_SHOW_INDEX_ENTRY_SIZE = 16,
+  BINARY_SHOW_FOOTER_SIZE = 24,
+  // One second, in us.
+  BINARY_SHOW_INDEX_INTERVAL = 1000000
+};
+
+/**
+ * @brief The flags in each frame record.
+ */
+enum RecordFlags {
+  RECORD_RLE = 0x01,  // the payload is RLE encoded
+  RECORD_DELTA = 0x02,  // the payload is the XOR with the previous frame
+  RECORD_SNAPSHOT = 0x04  // the record is part of a snapshot
+};
+
+/**
+ * @brief Write a value to a buffer in big endian order.
+ */
+template <typename T>
+inline uint8_t *WriteBigEndian(T value, uint8_t *output) {
+  for (int i = sizeof(T) - 1; i >= 0; i--) {
+    output[i] = static_cast<uint8_t>(value & 0xff);
+    value >>= 8;
+  }
+  return output + sizeof(T);
+}
+
+/**
+ * @brief Read a big endian value from a buffer.
+ */
+template <typename T>
+inline const uint8_t *ReadBigEndian(const uint8_t *input, T *value) {
+  T result = 0;
+  for (unsigned int i = 0; i < sizeof(T); i++) {
+    result = static_cast<T>((result << 8) | input[i]);
+  }
+  *value = result;
+  return input + sizeof(T);
+}
+#endif  // EXAMPLES_BINARYSHOWFORMAT_H_
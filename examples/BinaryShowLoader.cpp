@@ -0,0 +1,392 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShowLoader.cpp
+ * Loads show data from a binary show file.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // _WIN32
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShowFormat.h"
+#include "examples/BinaryShowLoader.h"
+
+using ola::DmxBuffer;
+using std::string;
+using std::vector;
+
+
+BinaryShowLoader::BinaryShowLoader(const string &filename)
+    : m_filename(filename),
+      m_data(NULL),
+      m_size(0),
+      m_index(NULL),
+      m_index_count(0),
+      m_records_end(0),
+      m_end_time(0),
+      m_offset(0),
+      m_current_time(0) {
+}
+
+
+BinaryShowLoader::~BinaryShowLoader() {
+  UnmapFile();
+}
+
+
+bool BinaryShowLoader::Load() {
+  if (!MapFile()) {
+    return false;
+  }
+  if (!CheckLayout()) {
+    OLA_WARN << m_filename << " isn't a valid binary show, it may not have "
+             << "been closed properly";
+    UnmapFile();
+    return false;
+  }
+  Reset();
+  return true;
+}
+
+
+void BinaryShowLoader::Reset() {
+  m_offset = BINARY_SHOW_HEADER_SIZE;
+  m_current_time = 0;
+  m_universes.clear();
+  m_pending.clear();
+}
+
+
+/*
+ * Find the last index entry at or before offset, then apply the frames
+ * between the entry and offset.
+ */
+bool BinaryShowLoader::Seek(unsigned int offset) {
+  if (!m_data) {
+    return false;
+  }
+
+  Reset();
+  const uint64_t target = static_cast<uint64_t>(offset) * 1000;
+  unsigned int low = 0;
+  unsigned int high = m_index_count;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    if (EntryTime(middle) <= target) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low) {
+    ReadBigEndian(m_index + (low - 1) * BINARY_SHOW_INDEX_ENTRY_SIZE +
+                  sizeof(uint64_t),
+                  &m_offset);
+    if (m_offset < BINARY_SHOW_HEADER_SIZE) {
+      OLA_WARN << "Invalid index entry in " << m_filename;
+      Reset();
+      return false;
+    }
+  }
+
+  // Snapshot records are always applied, even at the target time, since
+  // NextFrame() skips them.
+  Record record;
+  State state;
+  while ((state = ReadRecord(m_offset, &record)) == OK &&
+         ((record.flags & RECORD_SNAPSHOT) || record.time < target)) {
+    if (!ApplyRecord(record)) {
+      state = INVALID_LINE;
+      break;
+    }
+    m_offset = record.payload - m_data + record.payload_size;
+  }
+  if (state == INVALID_LINE) {
+    OLA_WARN << "Invalid record at offset " << m_offset << " in "
+             << m_filename;
+    Reset();
+    return false;
+  }
+
+  m_current_time = target;
+  UniverseMap::const_reverse_iterator iter = m_universes.rbegin();
+  for (; iter != m_universes.rend(); ++iter) {
+    m_pending.push_back(iter->first);
+  }
+  return true;
+}
+
+
+BinaryShowLoader::State BinaryShowLoader::NextTimeout(unsigned int *timeout) {
+  if (!m_pending.empty()) {
+    *timeout = 0;
+    return OK;
+  }
+
+  uint64_t offset = m_offset;
+  uint64_t next_time = m_end_time;
+  Record record;
+  State state;
+  while ((state = ReadRecord(offset, &record)) == OK) {
+    if (!(record.flags & RECORD_SNAPSHOT)) {
+      next_time = record.time;
+      break;
+    }
+    offset = record.payload - m_data + record.payload_size;
+  }
+
+  if (state == INVALID_LINE) {
+    OLA_WARN << "Invalid record at offset " << offset << " in " << m_filename;
+    return INVALID_LINE;
+  }
+  if (state == END_OF_FILE && next_time <= m_current_time) {
+    return END_OF_FILE;
+  }
+  // Round the absolute times, so the rounding doesn't accumulate.
+  *timeout = static_cast<unsigned int>(next_time / 1000 -
+                                       m_current_time / 1000);
+  return OK;
+}
+
+
+BinaryShowLoader::State BinaryShowLoader::NextFrame(unsigned int *universe,
+                                                    DmxBuffer *data) {
+  if (!m_pending.empty()) {
+    *universe = m_pending.back();
+    m_pending.pop_back();
+    data->Set(m_universes[*universe]);
+    return OK;
+  }
+
+  // Snapshots repeat the frames we've already sent, so skip over them.
+  Record record;
+  State state;
+  do {
+    state = ReadRecord(m_offset, &record);
+    if (state != OK) {
+      if (state == INVALID_LINE) {
+        OLA_WARN << "Invalid record at offset " << m_offset << " in "
+                 << m_filename;
+      }
+      return state;
+    }
+    m_offset = record.payload - m_data + record.payload_size;
+  } while (record.flags & RECORD_SNAPSHOT);
+
+  if (!ApplyRecord(record)) {
+    OLA_WARN << "Failed to decode frame at " << record.time << "us in "
+             << m_filename;
+    return INVALID_LINE;
+  }
+  m_current_time = record.time;
+  *universe = record.universe;
+  data->Set(m_universes[record.universe]);
+  return OK;
+}
+
+
+bool BinaryShowLoader::IsBinaryShow(const string &filename) {
+  std::ifstream show_file(filename.data(), std::ios::in | std::ios::binary);
+  char magic[BINARY_SHOW_MAGIC_SIZE];
+  show_file.read(magic, sizeof(magic));
+  return show_file.good() &&
+      memcmp(magic, BINARY_SHOW_MAGIC, BINARY_SHOW_MAGIC_SIZE) == 0;
+}
+
+
+bool BinaryShowLoader::MapFile() {
+  UnmapFile();
+#ifdef _WIN32
+  std::ifstream show_file(m_filename.data(), std::ios::in | std::ios::binary);
+  if (!show_file.is_open()) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  m_file_data.assign(std::istreambuf_iterator<char>(show_file),
+                     std::istreambuf_iterator<char>());
+  if (m_file_data.empty()) {
+    OLA_WARN << m_filename << " is empty";
+    return false;
+  }
+  m_data = &m_file_data[0];
+  m_size = m_file_data.size();
+  return true;
+#else
+  int fd = open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) || stat_buf.st_size == 0) {
+    OLA_WARN << "Can't read the size of " << m_filename;
+    close(fd);
+    return false;
+  }
+
+  void *memory = mmap(NULL, stat_buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "mmap(" << m_filename << "): " << strerror(errno);
+    return false;
+  }
+  m_data = reinterpret_cast<const uint8_t*>(memory);
+  m_size = stat_buf.st_size;
+  return true;
+#endif  // _WIN32
+}
+
+
+void BinaryShowLoader::UnmapFile() {
+#ifdef _WIN32
+  m_file_data.clear();
+#else
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+#endif  // _WIN32
+  m_data = NULL;
+  m_size = 0;
+  m_index = NULL;
+  m_index_count = 0;
+}
+
+
+/*
+ * Check the header and footer, and that the index fits between the frames
+ * and the footer.
+ */
+bool BinaryShowLoader::CheckLayout() {
+  if (m_size < BINARY_SHOW_HEADER_SIZE + BINARY_SHOW_FOOTER_SIZE ||
+      memcmp(m_data, BINARY_SHOW_MAGIC, BINARY_SHOW_MAGIC_SIZE) != 0) {
+    return false;
+  }
+
+  uint16_t version;
+  ReadBigEndian(m_data + BINARY_SHOW_MAGIC_SIZE, &version);
+  if (version != BINARY_SHOW_VERSION) {
+    OLA_WARN << "Unknown binary show version " << version;
+    return false;
+  }
+
+  const uint8_t *footer = m_data + m_size - BINARY_SHOW_FOOTER_SIZE;
+  uint64_t index_offset;
+  uint32_t index_count;
+  const uint8_t *ptr = ReadBigEndian(footer, &index_offset);
+  ptr = ReadBigEndian(ptr, &m_end_time);
+  ptr = ReadBigEndian(ptr, &index_count);
+  if (memcmp(ptr, BINARY_SHOW_INDEX_MAGIC,
+             sizeof(BINARY_SHOW_INDEX_MAGIC) - 1) != 0) {
+    return false;
+  }
+
+  const uint64_t index_end = m_size - BINARY_SHOW_FOOTER_SIZE;
+  if (index_offset < BINARY_SHOW_HEADER_SIZE || index_offset > index_end ||
+      (index_end - index_offset) !=
+      static_cast<uint64_t>(index_count) * BINARY_SHOW_INDEX_ENTRY_SIZE) {
+    return false;
+  }
+
+  m_index = m_data + index_offset;
+  m_index_count = index_count;
+  m_records_end = index_offset;
+  return true;
+}
+
+
+uint64_t BinaryShowLoader::EntryTime(unsigned int entry) const {
+  uint64_t time;
+  ReadBigEndian(m_index + entry * BINARY_SHOW_INDEX_ENTRY_SIZE, &time);
+  return time;
+}
+
+
+BinaryShowLoader::State BinaryShowLoader::ReadRecord(uint64_t offset,
+                                                     Record *record) const {
+  if (offset >= m_records_end) {
+    return END_OF_FILE;
+  }
+  if (m_records_end - offset < BINARY_SHOW_RECORD_HEADER_SIZE) {
+    return INVALID_LINE;
+  }
+
+  uint32_t universe;
+  uint8_t reserved;
+  uint16_t slots, payload_size;
+  const uint8_t *ptr = ReadBigEndian(m_data + offset, &record->time);
+  ptr = ReadBigEndian(ptr, &universe);
+  ptr = ReadBigEndian(ptr, &record->flags);
+  ptr = ReadBigEndian(ptr, &reserved);
+  ptr = ReadBigEndian(ptr, &slots);
+  ptr = ReadBigEndian(ptr, &payload_size);
+
+  if (slots > ola::DMX_UNIVERSE_SIZE ||
+      m_records_end - offset - BINARY_SHOW_RECORD_HEADER_SIZE <
+      payload_size ||
+      (!(record->flags & RECORD_RLE) && payload_size != slots)) {
+    return INVALID_LINE;
+  }
+  record->universe = universe;
+  record->slots = slots;
+  record->payload_size = payload_size;
+  record->payload = ptr;
+  return OK;
+}
+
+
+bool BinaryShowLoader::ApplyRecord(const Record &record) {
+  uint8_t frame[ola::DMX_UNIVERSE_SIZE];
+  if (record.flags & RECORD_RLE) {
+    DmxBuffer decoded;
+    m_encoder.Decode(0, record.payload, record.payload_size, &decoded);
+    unsigned int length = record.slots;
+    decoded.GetRange(0, frame, &length);
+    if (length != record.slots) {
+      return false;
+    }
+  } else {
+    memcpy(frame, record.payload, record.slots);
+  }
+
+  DmxBuffer &buffer = m_universes[record.universe];
+  if (record.flags & RECORD_DELTA) {
+    if (buffer.Size() != record.slots) {
+      return false;
+    }
+    const uint8_t *last = buffer.GetRaw();
+    for (unsigned int i = 0; i < record.slots; i++) {
+      frame[i] ^= last[i];
+    }
+  }
+  return buffer.Set(frame, record.slots);
+}
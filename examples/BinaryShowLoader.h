@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShowLoader.h
+ * Loads show data from a binary show file.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/DmxBuffer.h>
+#include <ola/dmx/RunLengthEncoder.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "examples/ShowLoaderInterface.h"
+
+#ifndef EXAMPLES_BINARYSHOWLOADER_H_
+#define EXAMPLES_BINARYSHOWLOADER_H_
+
+/**
+ * @brief Reads shows in the format described in BinaryShowFormat.h.
+ *
+ * The file is mapped into memory, so opening a large show is cheap and
+ * Seek() only touches the index and the frames after the index entry.
+ */
+class BinaryShowLoader: public ShowLoaderInterface {
+ public:
+  explicit BinaryShowLoader(const std::string &filename);
+  ~BinaryShowLoader();
+
+  bool Load();
+  void Reset();
+  bool Seek(unsigned int offset);
+
+  State NextTimeout(unsigned int *timeout);
+  State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
+
+  /**
+   * @brief The length of the show in ms.
+   */
+  unsigned int Duration() const {
+    return static_cast<unsigned int>(m_end_time / 1000);
+  }
+
+  /**
+   * @brief Check if a file is a binary show.
+   */
+  static bool IsBinaryShow(const std::string &filename);
+
+ private:
+  struct Record {
+    uint64_t time;
+    unsigned int universe;
+    uint8_t flags;
+    unsigned int slots;
+    unsigned int payload_size;
+    const uint8_t *payload;
+  };
+
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseMap;
+
+  const std::string m_filename;
+  const uint8_t *m_data;
+  size_t m_size;
+#ifdef _WIN32
+  std::vector<uint8_t> m_file_data;
+#endif  // _WIN32
+  const uint8_t *m_index;
+  unsigned int m_index_count;
+  uint64_t m_records_end;
+  uint64_t m_end_time;
+  uint64_t m_offset;
+  uint64_t m_current_time;
+  UniverseMap m_universes;
+  // Universes to send before the next record, after a Seek().
+  std::vector<unsigned int> m_pending;
+  ola::dmx::RunLengthEncoder m_encoder;
+
+  bool MapFile();
+  void UnmapFile();
+  bool CheckLayout();
+  uint64_t EntryTime(unsigned int entry) const;
+  State ReadRecord(uint64_t offset, Record *record) const;
+  bool ApplyRecord(const Record &record);
+};
+#endif  // EXAMPLES_BINARYSHOWLOADER_H_
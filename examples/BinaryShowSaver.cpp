@@ -0,0 +1,207 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShowSaver.cpp
+ * Writes show data to a binary show file.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/dmx/RunLengthEncoder.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShowFormat.h"
+#include "examples/BinaryShowSaver.h"
+
+using ola::DmxBuffer;
+using ola::dmx::RunLengthEncoder;
+using std::string;
+using std::vector;
+
+
+BinaryShowSaver::BinaryShowSaver(const string &filename)
+    : m_filename(filename),
+      m_offset(0),
+      m_last_time(0),
+      m_end_time(0) {
+}
+
+
+BinaryShowSaver::~BinaryShowSaver() {
+  Close();
+}
+
+
+bool BinaryShowSaver::Open() {
+  m_show_file.open(m_filename.data(),
+                   std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_show_file.is_open()) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  uint8_t header[BINARY_SHOW_HEADER_SIZE];
+  memset(header, 0, sizeof(header));
+  memcpy(header, BINARY_SHOW_MAGIC, BINARY_SHOW_MAGIC_SIZE);
+  WriteBigEndian<uint16_t>(BINARY_SHOW_VERSION,
+                           header + BINARY_SHOW_MAGIC_SIZE);
+  Write(header, sizeof(header));
+  return m_show_file.good();
+}
+
+
+/*
+ * Write the index and footer.
+ */
+void BinaryShowSaver::Close() {
+  if (!m_show_file.is_open()) {
+    return;
+  }
+
+  const uint64_t index_offset = m_offset;
+  vector<IndexEntry>::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    uint8_t entry[BINARY_SHOW_INDEX_ENTRY_SIZE];
+    uint8_t *ptr = WriteBigEndian(iter->time, entry);
+    WriteBigEndian(iter->offset, ptr);
+    Write(entry, sizeof(entry));
+  }
+
+  uint8_t footer[BINARY_SHOW_FOOTER_SIZE];
+  uint8_t *ptr = WriteBigEndian(index_offset, footer);
+  ptr = WriteBigEndian(std::max(m_end_time, m_last_time), ptr);
+  ptr = WriteBigEndian(static_cast<uint32_t>(m_index.size()), ptr);
+  memcpy(ptr, BINARY_SHOW_INDEX_MAGIC, sizeof(BINARY_SHOW_INDEX_MAGIC) - 1);
+  Write(footer, sizeof(footer));
+
+  if (!m_show_file.good()) {
+    OLA_WARN << "Failed to write " << m_filename;
+  }
+  m_show_file.close();
+}
+
+
+bool BinaryShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
+                               unsigned int universe,
+                               const DmxBuffer &data) {
+  if (!m_start.IsSet()) {
+    m_start = arrival_time;
+  }
+
+  // The index relies on the records being in order, so if the clock goes
+  // backwards this frame is recorded at the same time as the last one.
+  uint64_t time = m_last_time;
+  if (m_start < arrival_time) {
+    time = std::max(
+        time, static_cast<uint64_t>((arrival_time - m_start).AsInt()));
+  }
+
+  if (m_index.empty() ||
+      time - m_index.back().time >= BINARY_SHOW_INDEX_INTERVAL) {
+    AddIndexEntry(time);
+  }
+
+  UniverseMap::iterator iter = m_universes.find(universe);
+  const DmxBuffer *last = iter == m_universes.end() ? NULL : &iter->second;
+  bool ok = WriteRecord(time, universe, data, last, 0);
+  m_universes[universe] = data;
+  m_last_time = time;
+  return ok;
+}
+
+
+void BinaryShowSaver::SetEndTime(const ola::TimeStamp &end_time) {
+  if (m_start.IsSet() && m_start < end_time) {
+    m_end_time = (end_time - m_start).AsInt();
+  }
+}
+
+
+/*
+ * Add an index entry, followed by a snapshot of every universe.
+ */
+void BinaryShowSaver::AddIndexEntry(uint64_t time) {
+  IndexEntry entry = {time, m_offset};
+  m_index.push_back(entry);
+
+  UniverseMap::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    WriteRecord(time, iter->first, iter->second, NULL, RECORD_SNAPSHOT);
+  }
+}
+
+
+/*
+ * Write a frame using whichever of the raw data, RLE data or RLE delta from
+ * the last frame is the smallest.
+ */
+bool BinaryShowSaver::WriteRecord(uint64_t time,
+                                  unsigned int universe,
+                                  const DmxBuffer &data,
+                                  const DmxBuffer *last,
+                                  uint8_t flags) {
+  const unsigned int slots = data.Size();
+  const uint8_t *raw = data.GetRaw();
+  const uint8_t *payload = raw;
+  unsigned int payload_size = slots;
+
+  uint8_t rle[ola::DMX_UNIVERSE_SIZE];
+  unsigned int rle_size = RunLengthEncoder::MaxUsefulSize(slots);
+  if (slots && m_encoder.Encode(data, rle, &rle_size)) {
+    payload = rle;
+    payload_size = rle_size;
+    flags |= RECORD_RLE;
+  }
+
+  uint8_t delta_rle[ola::DMX_UNIVERSE_SIZE];
+  if (slots && last && last->Size() == slots) {
+    uint8_t delta[ola::DMX_UNIVERSE_SIZE];
+    const uint8_t *last_data = last->GetRaw();
+    for (unsigned int i = 0; i < slots; i++) {
+      delta[i] = raw[i] ^ last_data[i];
+    }
+    unsigned int delta_size = RunLengthEncoder::MaxUsefulSize(payload_size);
+    if (delta_size &&
+        m_encoder.Encode(DmxBuffer(delta, slots), delta_rle, &delta_size)) {
+      payload = delta_rle;
+      payload_size = delta_size;
+      flags |= RECORD_RLE | RECORD_DELTA;
+    }
+  }
+
+  uint8_t header[BINARY_SHOW_RECORD_HEADER_SIZE];
+  uint8_t *ptr = WriteBigEndian(time, header);
+  ptr = WriteBigEndian(static_cast<uint32_t>(universe), ptr);
+  ptr = WriteBigEndian(flags, ptr);
+  ptr = WriteBigEndian<uint8_t>(0, ptr);
+  ptr = WriteBigEndian(static_cast<uint16_t>(slots), ptr);
+  WriteBigEndian(static_cast<uint16_t>(payload_size), ptr);
+  Write(header, sizeof(header));
+  Write(payload, payload_size);
+  return m_show_file.good();
+}
+
+
+void BinaryShowSaver::Write(const uint8_t *data, unsigned int length) {
+  m_show_file.write(reinterpret_cast<const char*>(data), length);
+  m_offset += length;
+}
@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShowSaver.h
+ * Writes show data to a binary show file.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/dmx/RunLengthEncoder.h>
+#include <stdint.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "examples/ShowSaverInterface.h"
+
+#ifndef EXAMPLES_BINARYSHOWSAVER_H_
+#define EXAMPLES_BINARYSHOWSAVER_H_
+
+/**
+ * @brief Writes shows in the format described in BinaryShowFormat.h.
+ */
+class BinaryShowSaver: public ShowSaverInterface {
+ public:
+  explicit BinaryShowSaver(const std::string &filename);
+  ~BinaryShowSaver();
+
+  bool Open();
+  void Close();
+
+  bool NewFrame(const ola::TimeStamp &arrival_time,
+                unsigned int universe,
+                const ola::DmxBuffer &data);
+  void SetEndTime(const ola::TimeStamp &end_time);
+
+ private:
+  struct IndexEntry {
+    uint64_t time;
+    uint64_t offset;
+  };
+
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseMap;
+
+  const std::string m_filename;
+  std::ofstream m_show_file;
+  ola::TimeStamp m_start;
+  uint64_t m_offset;
+  uint64_t m_last_time;
+  uint64_t m_end_time;
+  UniverseMap m_universes;
+  std::vector<IndexEntry> m_index;
+  ola::dmx::RunLengthEncoder m_encoder;
+
+  void AddIndexEntry(uint64_t time);
+  bool WriteRecord(uint64_t time, unsigned int universe,
+                   const ola::DmxBuffer &data, const ola::DmxBuffer *last,
+                   uint8_t flags);
+  void Write(const uint8_t *data, unsigned int length);
+};
+#endif  // EXAMPLES_BINARYSHOWSAVER_H_
@@ -69,14 +69,21 @@ examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_recorder_SOURCES = \
     examples/ola-recorder.cpp \
+    examples/BinaryShowFormat.h \
+    examples/BinaryShowLoader.h \
+    examples/BinaryShowLoader.cpp \
+    examples/BinaryShowSaver.h \
+    examples/BinaryShowSaver.cpp \
     examples/ShowLoader.h \
     examples/ShowLoader.cpp \
+    examples/ShowLoaderInterface.h \
     examples/ShowPlayer.h \
     examples/ShowPlayer.cpp \
     examples/ShowRecorder.h \
     examples/ShowRecorder.cpp \
     examples/ShowSaver.h \
-    examples/ShowSaver.cpp
+    examples/ShowSaver.cpp \
+    examples/ShowSaverInterface.h
 examples_ola_recorder_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_timecode_SOURCES = examples/ola-timecode.cpp
@@ -138,5 +145,12 @@ examples/RecorderVerifyTest.sh: examples/Makefile.mk
 	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
 	chmod +x examples/RecorderVerifyTest.sh
 
-CLEANFILES += examples/RecorderVerifyTest.sh
+test_scripts += examples/RecorderConvertTest.sh
+
+examples/RecorderConvertTest.sh: examples/Makefile.mk
+	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Converting \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$FILE --output examples/convert_test.bin && ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE > examples/convert_test.text_summary && ${top_builddir}/examples/ola_recorder${EXEEXT} --verify examples/convert_test.bin > examples/convert_test.binary_summary && cmp examples/convert_test.text_summary examples/convert_test.binary_summary && ${top_builddir}/examples/ola_recorder${EXEEXT} --convert examples/convert_test.bin --output examples/convert_test.txt; STATUS=\$$?; rm -f examples/convert_test.*; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: converting \$$FILE failed with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderConvertTest.sh
+	chmod +x examples/RecorderConvertTest.sh
+
+CLEANFILES += examples/RecorderVerifyTest.sh \
+              examples/RecorderConvertTest.sh
 endif
@@ -95,6 +95,13 @@ void ShowLoader::Reset() {
  * Get the next time offset
  * @param timeout a pointer to the timeout in ms
  */
+bool ShowLoader::Seek(unsigned int) {
+  OLA_WARN << "Seeking isn't supported for text shows, convert " << m_filename
+           << " to a binary show first";
+  return false;
+}
+
+
 ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
   string line;
   ReadLine(&line);
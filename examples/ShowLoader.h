@@ -23,25 +23,22 @@
 #include <string>
 #include <fstream>
 
+#include "examples/ShowLoaderInterface.h"
+
 #ifndef EXAMPLES_SHOWLOADER_H_
 #define EXAMPLES_SHOWLOADER_H_
 
 /**
  * Loads a show file and reads the DMX data.
  */
-class ShowLoader {
+class ShowLoader: public ShowLoaderInterface {
  public:
   explicit ShowLoader(const std::string &filename);
   ~ShowLoader();
 
-  typedef enum {
-    OK,
-    INVALID_LINE,
-    END_OF_FILE,
-  } State;
-
   bool Load();
   void Reset();
+  bool Seek(unsigned int offset);
 
   State NextTimeout(unsigned int *timeout);
   State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
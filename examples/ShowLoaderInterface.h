@@ -0,0 +1,75 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLoaderInterface.h
+ * The interface for reading show files.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/DmxBuffer.h>
+
+#ifndef EXAMPLES_SHOWLOADERINTERFACE_H_
+#define EXAMPLES_SHOWLOADERINTERFACE_H_
+
+/**
+ * @brief Reads frames from a show file.
+ *
+ * A show is a sequence of frames, with a timeout between each one. Callers
+ * alternate between NextFrame() and NextTimeout(); a timeout after the last
+ * frame is the time to hold the last frame for.
+ */
+class ShowLoaderInterface {
+ public:
+  virtual ~ShowLoaderInterface() {}
+
+  typedef enum {
+    OK,
+    INVALID_LINE,
+    END_OF_FILE,
+  } State;
+
+  /**
+   * @brief Open the show file and check it's valid.
+   * @returns true if the show can be played, false otherwise.
+   */
+  virtual bool Load() = 0;
+
+  /**
+   * @brief Go back to the start of the show.
+   */
+  virtual void Reset() = 0;
+
+  /**
+   * @brief Skip to a point in the show.
+   * @param offset the number of ms from the start of the show.
+   * @returns true if the show was moved to offset, false if this loader
+   *   can't seek.
+   *
+   * The frames after a seek are the state of every universe at offset, with
+   * no timeout between them.
+   */
+  virtual bool Seek(unsigned int offset) = 0;
+
+  /**
+   * @brief Read the time in ms until the next frame.
+   */
+  virtual State NextTimeout(unsigned int *timeout) = 0;
+
+  /**
+   * @brief Read the next frame.
+   */
+  virtual State NextFrame(unsigned int *universe, ola::DmxBuffer *data) = 0;
+};
+#endif  // EXAMPLES_SHOWLOADERINTERFACE_H_
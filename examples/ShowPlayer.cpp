@@ -26,29 +26,35 @@
 #include <errno.h>
 #include <string.h>
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
 #include <ola/base/SysExits.h>
 #include <ola/client/ClientWrapper.h>
 #include <ola/client/OlaClient.h>
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "examples/ShowPlayer.h"
 
-using std::vector;
-using std::string;
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXBatchEntry;
+using std::map;
+using std::string;
+using std::vector;
 
 
-ShowPlayer::ShowPlayer(const string &filename)
-    : m_loader(filename),
+ShowPlayer::ShowPlayer(ShowLoaderInterface *loader)
+    : m_loader(loader),
       m_infinite_loop(false),
       m_iteration_remaining(0),
-      m_loop_delay(0) {
+      m_loop_delay(0),
+      m_show_time(0) {
 }
 
 ShowPlayer::~ShowPlayer() {}
@@ -59,7 +65,7 @@ int ShowPlayer::Init() {
     return ola::EXIT_UNAVAILABLE;
   }
 
-  if (!m_loader.Load()) {
+  if (!m_loader->Load()) {
     return ola::EXIT_NOINPUT;
   }
 
@@ -68,11 +74,19 @@ int ShowPlayer::Init() {
 
 int ShowPlayer::Playback(unsigned int iterations,
                          unsigned int duration,
-                         unsigned int delay) {
+                         unsigned int delay,
+                         unsigned int start) {
+  if (start && !m_loader->Seek(start)) {
+    return ola::EXIT_USAGE;
+  }
+
   m_infinite_loop = iterations == 0 || duration != 0;
   m_iteration_remaining = iterations;
   m_loop_delay = delay;
-  SendNextFrame();
+  m_stats = Stats();
+  m_show_time = 0;
+  m_clock.CurrentTime(&m_start);
+  SendNextBatch();
 
   ola::io::SelectServer *ss = m_client.GetSelectServer();
 
@@ -85,71 +99,112 @@ int ShowPlayer::Playback(unsigned int iterations,
   return ola::EXIT_OK;
 }
 
-void ShowPlayer::SendNextFrame() {
-  DmxBuffer buffer;
-  unsigned int universe;
-  ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
-      m_client.GetSelectServer()->Terminate();
-      return;
-    default:
-      {}
+/*
+ * Send the batch that's due now, then schedule the next one.
+ */
+void ShowPlayer::SendNextBatch() {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  const TimeStamp deadline = Deadline();
+  const uint64_t lateness = deadline < now ? (now - deadline).AsInt() : 0;
+
+  m_batch.clear();
+  m_batch_index.clear();
+  ShowLoaderInterface::State state = ReadBatch(now);
+
+  if (!m_batch.empty()) {
+    OLA_INFO << "Sending " << m_batch.size() << " universes, "
+             << lateness << "us late";
+    m_client.GetClient()->SendDMXBatch(m_batch);
+    m_stats.frames += m_batch.size();
+    m_stats.batches++;
+    m_stats.max_lateness_us = std::max(m_stats.max_lateness_us, lateness);
+    m_stats.total_lateness_us += lateness;
+    if (lateness > LATE_THRESHOLD_US) {
+      m_stats.late_batches++;
+    }
   }
 
-  state = RegisterNextTimeout();
-
-  OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
-  ola::client::SendDMXArgs args;
-  m_client.GetClient()->SendDMX(universe, buffer, args);
-
   switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
+    case ShowLoaderInterface::END_OF_FILE:
+      if (!StartNextIteration()) {
+        m_client.GetSelectServer()->Terminate();
+        return;
+      }
+      break;
+    case ShowLoaderInterface::INVALID_LINE:
       m_client.GetSelectServer()->Terminate();
       return;
     default:
       {}
   }
+  ScheduleNextBatch();
 }
 
-
-/**
- * Get the next time offset
+/*
+ * Read frames into the batch until we reach one that's due in the future.
  */
-ShowLoader::State ShowPlayer::RegisterNextTimeout() {
+ShowLoaderInterface::State ShowPlayer::ReadBatch(const TimeStamp &now) {
+  DmxBuffer buffer;
+  unsigned int universe;
   unsigned int timeout;
-  ShowLoader::State state = m_loader.NextTimeout(&timeout);
-  if (state != ShowLoader::OK) {
-    return state;
+  while (true) {
+    ShowLoaderInterface::State state = m_loader->NextFrame(&universe,
+                                                           &buffer);
+    if (state != ShowLoaderInterface::OK) {
+      return state;
+    }
+    AddToBatch(universe, buffer);
+
+    state = m_loader->NextTimeout(&timeout);
+    if (state != ShowLoaderInterface::OK) {
+      return state;
+    }
+    m_show_time += timeout;
+    if (timeout && now < Deadline()) {
+      return ShowLoaderInterface::OK;
+    }
   }
+}
 
-  OLA_INFO << "Registering timeout for " << timeout << "ms";
-  m_client.GetSelectServer()->RegisterSingleTimeout(
-      timeout,
-      ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
-  return state;
+void ShowPlayer::AddToBatch(unsigned int universe, const DmxBuffer &data) {
+  map<unsigned int, unsigned int>::const_iterator iter =
+      m_batch_index.find(universe);
+  if (iter == m_batch_index.end()) {
+    m_batch_index[universe] = m_batch.size();
+    m_batch.push_back(DMXBatchEntry(universe, data));
+  } else {
+    m_batch[iter->second].data = data;
+    m_stats.skipped_frames++;
+  }
 }
 
+void ShowPlayer::ScheduleNextBatch() {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  const TimeStamp deadline = Deadline();
+  TimeInterval delay;
+  if (now < deadline) {
+    delay = deadline - now;
+  }
+  m_client.GetSelectServer()->RegisterSingleTimeout(
+      delay,
+      ola::NewSingleCallback(this, &ShowPlayer::SendNextBatch));
+}
 
-/**
- * Handle the case where we reach the end of file
+/*
+ * Go back to the start of the show, if there are iterations left.
  */
-void ShowPlayer::HandleEndOfFile() {
+bool ShowPlayer::StartNextIteration() {
   m_iteration_remaining--;
   if (m_infinite_loop || m_iteration_remaining > 0) {
-    m_loader.Reset();
-    m_client.GetSelectServer()->RegisterSingleTimeout(
-        m_loop_delay,
-        ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
-    return;
-  } else {
-    // stop the show
-    m_client.GetSelectServer()->Terminate();
+    m_loader->Reset();
+    m_show_time += m_loop_delay;
+    return true;
   }
+  return false;
+}
+
+TimeStamp ShowPlayer::Deadline() const {
+  return m_start + TimeInterval(static_cast<int64_t>(m_show_time) * 1000);
 }
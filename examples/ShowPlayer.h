@@ -18,27 +18,65 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
+#include <stdint.h>
 
+#include <map>
+#include <memory>
 #include <string>
-#include <fstream>
+#include <vector>
 
-#include "examples/ShowLoader.h"
+#include "examples/ShowLoaderInterface.h"
 
 #ifndef EXAMPLES_SHOWPLAYER_H_
 #define EXAMPLES_SHOWPLAYER_H_
 
 /**
- * @brief A class which plays back recorded show files.
+ * @brief Plays a show back to olad.
+ *
+ * Each frame is due at a fixed offset from the start of playback, measured
+ * with a monotonic clock, rather than a delay after the previous frame was
+ * sent. That way time spent reading and sending frames doesn't add up over
+ * the show. Frames that are due at the same time are sent in one batch. If
+ * playback falls behind, the frames that are already overdue are merged
+ * into one batch, keeping only the latest frame for each universe, so the
+ * show catches up rather than running late.
  */
 class ShowPlayer {
  public:
+  /**
+   * @brief The playback counters.
+   */
+  class Stats {
+   public:
+    Stats()
+        : frames(0),
+          batches(0),
+          late_batches(0),
+          skipped_frames(0),
+          max_lateness_us(0),
+          total_lateness_us(0) {
+    }
+
+    uint64_t frames;  ///< the frames sent
+    uint64_t batches;  ///< the batches sent
+    /// the batches sent more than LATE_THRESHOLD_US after they were due
+    uint64_t late_batches;
+    /// overdue frames replaced by a later frame for the same universe
+    uint64_t skipped_frames;
+    /// the most a batch was sent after it was due
+    uint64_t max_lateness_us;
+    /// the sum of the time each batch was sent after it was due
+    uint64_t total_lateness_us;
+  };
+
   /**
    * @brief Create a new ShowPlayer
-   * @param filename the show file to play
+   * @param loader the loader for the show to play, ownership is transferred.
    */
-  explicit ShowPlayer(const std::string &filename);
+  explicit ShowPlayer(ShowLoaderInterface *loader);
   ~ShowPlayer();
 
   /**
@@ -53,21 +91,44 @@ class ShowPlayer {
    * @param duration the duration in seconds after which playback is stopped.
    * @param delay the hold time at the end of a show before playback starts
    * from the beginning again.
+   * @param start the offset in ms to start the first iteration from.
    */
   int Playback(unsigned int iterations,
                unsigned int duration,
-               unsigned int delay);
+               unsigned int delay,
+               unsigned int start = 0);
+
+  /**
+   * @brief The counters for the last call to Playback().
+   */
+  const Stats &GetStats() const { return m_stats; }
+
+  /**
+   * @brief A batch is counted as late if it's sent this long after it was
+   * due.
+   */
+  enum { LATE_THRESHOLD_US = 5000 };
 
  private:
   ola::client::OlaClientWrapper m_client;
-  ShowLoader m_loader;
+  std::auto_ptr<ShowLoaderInterface> m_loader;
   bool m_infinite_loop;
   unsigned int m_iteration_remaining;
   unsigned int m_loop_delay;
+  ola::MonotonicClock m_clock;
+  ola::TimeStamp m_start;
+  // The offset in ms from m_start that the next batch is due.
+  uint64_t m_show_time;
+  std::vector<ola::client::DMXBatchEntry> m_batch;
+  // Maps universes to their entry in m_batch.
+  std::map<unsigned int, unsigned int> m_batch_index;
+  Stats m_stats;
 
-  void SendNextFrame();
-  ShowLoader::State RegisterNextTimeout();
-  bool ReadNextFrame(unsigned int *universe, ola::DmxBuffer *data);
-  void HandleEndOfFile();
+  void SendNextBatch();
+  ShowLoaderInterface::State ReadBatch(const ola::TimeStamp &now);
+  void AddToBatch(unsigned int universe, const ola::DmxBuffer &data);
+  void ScheduleNextBatch();
+  bool StartNextIteration();
+  ola::TimeStamp Deadline() const;
 };
 #endif  // EXAMPLES_SHOWPLAYER_H_
@@ -22,11 +22,11 @@
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
 #include <stdint.h>
+#include <memory>
 #include <string>
-#include <fstream>
 #include <vector>
 
-#include "examples/ShowSaver.h"
+#include "examples/ShowSaverInterface.h"
 
 #ifndef EXAMPLES_SHOWRECORDER_H_
 #define EXAMPLES_SHOWRECORDER_H_
@@ -36,7 +36,12 @@
  */
 class ShowRecorder {
  public:
-  ShowRecorder(const std::string &filename,
+  /**
+   * @brief Create a new ShowRecorder.
+   * @param saver the saver to write the show with, ownership is transferred.
+   * @param universes the universes to record.
+   */
+  ShowRecorder(ShowSaverInterface *saver,
                const std::vector<unsigned int> &universes);
   ~ShowRecorder();
 
@@ -48,7 +53,7 @@ class ShowRecorder {
 
  private:
   ola::client::OlaClientWrapper m_client;
-  ShowSaver m_saver;
+  std::auto_ptr<ShowSaverInterface> m_saver;
   std::vector<unsigned int> m_universes;
   ola::Clock m_clock;
   uint64_t m_frame_count;
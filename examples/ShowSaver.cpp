@@ -86,11 +86,30 @@ bool ShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
   // TODO(simon): add much better error handling here
   if (m_last_frame.IsSet()) {
     // this is not the first frame so write the delay in ms
-    const ola::TimeInterval delta = arrival_time - m_last_frame;
-
-    m_show_file << delta.InMilliSeconds() << endl;
+    WriteDelay(arrival_time);
+  } else {
+    m_last_frame = arrival_time;
   }
-  m_last_frame = arrival_time;
   m_show_file << universe << " " << data.ToString() << endl;
   return true;
 }
+
+
+void ShowSaver::SetEndTime(const ola::TimeStamp &end_time) {
+  if (m_last_frame.IsSet() && m_last_frame < end_time) {
+    WriteDelay(end_time);
+  }
+}
+
+
+/*
+ * Write the delay in ms until time. The time of the last frame is advanced by
+ * the delay we wrote, rather than set to time, so the rounding doesn't
+ * accumulate over a long show.
+ */
+void ShowSaver::WriteDelay(const ola::TimeStamp &time) {
+  const ola::TimeInterval delta = time - m_last_frame;
+  const int64_t delay = delta.InMilliSeconds();
+  m_show_file << delay << endl;
+  m_last_frame += ola::TimeInterval(delay * ola::ONE_THOUSAND);
+}
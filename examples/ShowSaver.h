@@ -24,13 +24,15 @@
 #include <string>
 #include <fstream>
 
+#include "examples/ShowSaverInterface.h"
+
 #ifndef EXAMPLES_SHOWSAVER_H_
 #define EXAMPLES_SHOWSAVER_H_
 
 /**
  * Write show data to a file.
  */
-class ShowSaver {
+class ShowSaver: public ShowSaverInterface {
  public:
   explicit ShowSaver(const std::string &filename);
   ~ShowSaver();
@@ -41,6 +43,7 @@ class ShowSaver {
   bool NewFrame(const ola::TimeStamp &arrival_time,
                 unsigned int universe,
                 const ola::DmxBuffer &data);
+  void SetEndTime(const ola::TimeStamp &end_time);
 
  private:
   const std::string m_filename;
@@ -48,5 +51,7 @@ class ShowSaver {
   ola::TimeStamp m_last_frame;
 
   static const char OLA_SHOW_HEADER[];
+
+  void WriteDelay(const ola::TimeStamp &time);
 };
 #endif  // EXAMPLES_SHOWSAVER_H_
@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowSaverInterface.h
+ * The interface for writing show files.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+
+#ifndef EXAMPLES_SHOWSAVERINTERFACE_H_
+#define EXAMPLES_SHOWSAVERINTERFACE_H_
+
+/**
+ * @brief Writes frames to a show file.
+ */
+class ShowSaverInterface {
+ public:
+  virtual ~ShowSaverInterface() {}
+
+  /**
+   * @brief Create the show file.
+   * @returns true if the file was created, false otherwise.
+   */
+  virtual bool Open() = 0;
+
+  /**
+   * @brief Finish writing the show file.
+   */
+  virtual void Close() = 0;
+
+  /**
+   * @brief Add a frame to the show.
+   * @param arrival_time the time the frame was received.
+   * @param universe the universe the frame is for.
+   * @param data the DMX data.
+   */
+  virtual bool NewFrame(const ola::TimeStamp &arrival_time,
+                        unsigned int universe,
+                        const ola::DmxBuffer &data) = 0;
+
+  /**
+   * @brief Set the time the show ends, i.e. how long to hold the last frame.
+   *
+   * This must be called after the last frame is added and before Close().
+   * If it's not called the show ends at the last frame.
+   */
+  virtual void SetEndTime(const ola::TimeStamp &end_time) = 0;
+};
+#endif  // EXAMPLES_SHOWSAVERINTERFACE_H_
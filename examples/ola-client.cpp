@@ -127,6 +127,11 @@ void ListPorts(const vector<PortClass> &ports, bool input) {
         break;
     }
 
+    if (port_iter->MaxFrameRate()) {
+      cout << ", max " << port_iter->MaxFrameRate() << " fps ("
+           << port_iter->SkippedFrames() << " skipped)";
+    }
+
     if (port_iter->IsActive()) {
       cout << ", patched to universe " << port_iter->Universe();
     }
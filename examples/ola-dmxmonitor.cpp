@@ -69,6 +69,8 @@ using std::string;
 static const unsigned int DEFAULT_UNIVERSE = 0;
 static const unsigned char CHANNEL_DISPLAY_WIDTH = 4;
 static const unsigned char ROWS_PER_CHANNEL_ROW = 2;
+// The most screen updates per second.
+static const unsigned int MAX_UPDATE_RATE = 25;
 
 /* color names used */
 enum {
@@ -171,9 +173,12 @@ bool DmxMonitor::Init() {
 
   OlaClient *client = m_client.GetClient();
   client->SetDMXCallback(ola::NewCallback(this, &DmxMonitor::NewDmx));
+  ola::client::RegisterArgs args;
+  args.max_rate = MAX_UPDATE_RATE;
   client->RegisterUniverse(
       m_universe,
       ola::client::REGISTER,
+      args,
       ola::NewSingleCallback(this, &DmxMonitor::RegisterComplete));
 
   /* init curses */
@@ -15,41 +15,71 @@
  *
  * ola-latency.cpp
  * Call FetchDmx and track the latency for each call.
+ *
+ * To compare the effect of busy polling, run this (and olad) once as normal
+ * and once with --busy-poll-usec, optionally pinning olad with --loop-cpu.
+ *
+ * With --artnet the frames are sent to olad's ArtNet input port instead, and
+ * timed until they reach the universe, so this includes the time the packets
+ * wait in the kernel. An ArtNet input port must be patched to the universe.
  * Copyright (C) 2005 Simon Newton
  */
 
 #include <stdlib.h>
 #include <ola/Callback.h>
 #include <ola/Clock.h>
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/OlaClientWrapper.h>
 #include <ola/base/Flags.h>
 #include <ola/base/Init.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
 #include <ola/thread/SignalThread.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using ola::DmxBuffer;
 using ola::NewSingleCallback;
 using ola::OlaCallbackClientWrapper;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
 using ola::TimeStamp;
 using ola::TimeInterval;
 using std::cout;
 using std::endl;
 using std::string;
+using std::vector;
 
 DEFINE_s_uint32(universe, u, 1, "The universe to receive data for");
 DEFINE_default_bool(send_dmx, false, "Use SendDmx messages, default is GetDmx");
 DEFINE_s_uint32(count, c, 0,
     "Exit after this many RPCs, default: infinite (0)");
+DEFINE_default_bool(artnet, false,
+                    "Send ArtDmx packets to olad and time how long the data "
+                    "takes to reach the universe, rather than timing RPCs");
+DEFINE_string(artnet_ip, "127.0.0.1",
+              "The IP address olad's ArtNet plugin is listening on");
+DEFINE_uint16(artnet_address, 0,
+              "The ArtNet port address to send the ArtDmx packets to");
 
 class Tracker {
  public:
     Tracker()
         : m_count(0),
-          m_sum(0) {
+          m_sum(0),
+          m_lost(0),
+          m_artnet_sequence(0),
+          m_waiting(false),
+          m_timeout(ola::thread::INVALID_TIMEOUT) {
+      if (FLAGS_count) {
+        m_latencies.reserve(FLAGS_count);
+      }
       m_buffer.Blackout();
     }
 
@@ -58,24 +88,60 @@ class Tracker {
 
     void GotDmx(const DmxBuffer &data, const string &error);
     void SendComplete(const string &error);
+    void GotUniverseDmx(unsigned int universe, const DmxBuffer &data,
+                        const string &error);
+    void Registered(const string &error);
 
  private:
     uint32_t m_count;
     uint64_t m_sum;
     TimeInterval m_max;
+    vector<int64_t> m_latencies;
     ola::DmxBuffer m_buffer;
     OlaCallbackClientWrapper m_wrapper;
     ola::Clock m_clock;
     ola::thread::SignalThread m_signal_thread;
     TimeStamp m_send_time;
+    // Used with --artnet
+    ola::network::UDPSocket m_socket;
+    IPV4SocketAddress m_artnet_destination;
+    uint32_t m_lost;
+    uint8_t m_artnet_sequence;
+    bool m_waiting;
+    ola::thread::timeout_id m_timeout;
 
     void SendRequest();
+    void SendArtDmx();
+    void ArtDmxTimeout();
+
+    static const uint16_t ARTNET_PORT = 6454;
+    static const unsigned int ARTDMX_HEADER_SIZE = 18;
+    static const unsigned int ARTDMX_TIMEOUT_MS = 1000;
     void LogTime();
+    void PrintStats();
     void StartSignalThread();
 };
 
 bool Tracker::Setup() {
-  return m_wrapper.Setup();
+  if (!m_wrapper.Setup()) {
+    return false;
+  }
+  if (!FLAGS_artnet) {
+    return true;
+  }
+
+  IPV4Address artnet_ip;
+  if (!IPV4Address::FromString(FLAGS_artnet_ip.str(), &artnet_ip)) {
+    OLA_WARN << "Invalid IP address " << FLAGS_artnet_ip.str();
+    return false;
+  }
+  m_artnet_destination = IPV4SocketAddress(artnet_ip, ARTNET_PORT);
+  if (!m_socket.Init()) {
+    return false;
+  }
+  m_wrapper.GetClient()->SetDmxCallback(
+      ola::NewCallback(this, &Tracker::GotUniverseDmx));
+  return true;
 }
 
 void Tracker::Start() {
@@ -86,18 +152,19 @@ void Tracker::Start() {
   m_signal_thread.InstallSignalHandler(
       SIGTERM,
       ola::NewCallback(ss, &ola::io::SelectServer::Terminate));
-  SendRequest();
+  if (FLAGS_artnet) {
+    // The first frame is sent once we're registered for the universe.
+    m_wrapper.GetClient()->RegisterUniverse(
+        FLAGS_universe, ola::REGISTER,
+        NewSingleCallback(this, &Tracker::Registered));
+  } else {
+    SendRequest();
+  }
 
   ss->Execute(ola::NewSingleCallback(this, &Tracker::StartSignalThread));
   ss->Run();
 
-  // Print this via cout to ensure we actually get some output by default
-  // It also means you can just see the stats and not each individual request
-  // if you want.
-  cout << "--------------" << endl;
-  cout << "Sent " << m_count << " RPCs" << endl;
-  cout << "Max was " << m_max.MicroSeconds() << " microseconds" << endl;
-  cout << "Mean " << m_sum / m_count << " microseconds" << endl;
+  PrintStats();
 }
 
 void Tracker::GotDmx(const DmxBuffer &, const string &) {
@@ -108,7 +175,35 @@ void Tracker::SendComplete(const string &) {
   LogTime();
 }
 
+void Tracker::GotUniverseDmx(unsigned int universe, const DmxBuffer &data,
+                             const string &) {
+  // Only the frame we're waiting for counts, olad may resend older frames.
+  if (!m_waiting || universe != FLAGS_universe ||
+      data.Get(0) != m_buffer.Get(0)) {
+    return;
+  }
+  m_waiting = false;
+  m_wrapper.GetSelectServer()->RemoveTimeout(m_timeout);
+  m_timeout = ola::thread::INVALID_TIMEOUT;
+  LogTime();
+}
+
+void Tracker::Registered(const string &error) {
+  if (!error.empty()) {
+    OLA_WARN << "Failed to register for universe " << FLAGS_universe << ": "
+             << error;
+    m_wrapper.GetSelectServer()->Terminate();
+    return;
+  }
+  SendRequest();
+}
+
 void Tracker::SendRequest() {
+  if (FLAGS_artnet) {
+    SendArtDmx();
+    return;
+  }
+
   m_clock.CurrentTime(&m_send_time);
   if (FLAGS_send_dmx) {
     m_wrapper.GetClient()->SendDmx(
@@ -123,6 +218,43 @@ void Tracker::SendRequest() {
   }
 }
 
+/*
+ * Send the next frame as an ArtDmx packet. The first slot changes each time,
+ * so the frame isn't treated as a refresh.
+ */
+void Tracker::SendArtDmx() {
+  m_buffer.SetChannel(0, static_cast<uint8_t>(m_buffer.Get(0) + 1));
+
+  uint8_t packet[ARTDMX_HEADER_SIZE + ola::DMX_UNIVERSE_SIZE] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,  // OpDmx, little endian
+    0x00, 14,  // protocol version
+    m_artnet_sequence++,
+    0,  // physical port
+    static_cast<uint8_t>(FLAGS_artnet_address & 0xff),
+    static_cast<uint8_t>((FLAGS_artnet_address >> 8) & 0x7f),
+    ola::DMX_UNIVERSE_SIZE >> 8,
+    ola::DMX_UNIVERSE_SIZE & 0xff,
+  };
+  unsigned int length = ola::DMX_UNIVERSE_SIZE;
+  m_buffer.Get(packet + ARTDMX_HEADER_SIZE, &length);
+
+  m_clock.CurrentTime(&m_send_time);
+  m_waiting = true;
+  m_socket.SendTo(packet, sizeof(packet), m_artnet_destination);
+  m_timeout = m_wrapper.GetSelectServer()->RegisterSingleTimeout(
+      ARTDMX_TIMEOUT_MS,
+      NewSingleCallback(this, &Tracker::ArtDmxTimeout));
+}
+
+void Tracker::ArtDmxTimeout() {
+  m_timeout = ola::thread::INVALID_TIMEOUT;
+  m_waiting = false;
+  m_lost++;
+  OLA_INFO << "Frame " << static_cast<int>(m_buffer.Get(0)) << " was lost";
+  SendArtDmx();
+}
+
 void Tracker::LogTime() {
   TimeStamp now;
   m_clock.CurrentTime(&now);
@@ -130,9 +262,10 @@ void Tracker::LogTime() {
   if (delta > m_max) {
     m_max = delta;
   }
-  m_sum += delta.MicroSeconds();
+  m_sum += delta.AsInt();
+  m_latencies.push_back(delta.AsInt());
 
-  OLA_INFO << "RPC took " << delta;
+  OLA_INFO << (FLAGS_artnet ? "Frame" : "RPC") << " took " << delta;
   if (FLAGS_count == ++m_count) {
     m_wrapper.GetSelectServer()->Terminate();
   } else {
@@ -140,6 +273,31 @@ void Tracker::LogTime() {
   }
 }
 
+void Tracker::PrintStats() {
+  // Print this via cout to ensure we actually get some output by default
+  // It also means you can just see the stats and not each individual request
+  // if you want.
+  cout << "--------------" << endl;
+  if (FLAGS_artnet) {
+    cout << "Sent " << m_count + m_lost << " ArtDmx packets, " << m_lost
+         << " were lost" << endl;
+  } else {
+    cout << "Sent " << m_count << " RPCs" << endl;
+  }
+  if (m_latencies.empty()) {
+    return;
+  }
+
+  // Busy polling mostly affects the tail, so show the percentiles as well.
+  std::sort(m_latencies.begin(), m_latencies.end());
+  cout << "Max was " << m_max.AsInt() << " microseconds" << endl;
+  cout << "Mean " << m_sum / m_latencies.size() << " microseconds" << endl;
+  cout << "Min " << m_latencies.front() << ", median "
+       << m_latencies[m_latencies.size() / 2] << ", 99th percentile "
+       << m_latencies[(m_latencies.size() * 99) / 100] << " microseconds"
+       << endl;
+}
+
 void Tracker::StartSignalThread() {
   if (!m_signal_thread.Start()) {
     m_wrapper.GetSelectServer()->Terminate();
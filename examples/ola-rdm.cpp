@@ -541,20 +541,20 @@ void RDMController::HandleAckResponse(uint16_t manufacturer_id,
     return;
   }
 
-  const ola::messaging::Descriptor *descriptor = NULL;
+  const ola::rdm::MessagePlan *plan = NULL;
   if (is_set)
-    descriptor = pid_descriptor->SetResponse();
+    plan = pid_descriptor->SetResponsePlan();
   else
-    descriptor = pid_descriptor->GetResponse();
+    plan = pid_descriptor->GetResponsePlan();
 
-  if (!descriptor) {
+  if (!plan) {
     OLA_WARN << "Unknown response message: " << (is_set ? "SET" : "GET") <<
         " " << pid_descriptor->Name();
     return;
   }
 
   auto_ptr<const ola::messaging::Message> message(
-      m_pid_helper.DeserializeMessage(descriptor, data, length));
+      m_pid_helper.DeserializeMessage(plan, data, length));
 
   if (!message.get()) {
     OLA_WARN << "Unable to inflate RDM response";
@@ -19,6 +19,7 @@
  */
 
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
@@ -27,15 +28,19 @@
 #include <ola/base/SysExits.h>
 #include <ola/thread/SignalThread.h>
 #include <signal.h>
+#include <stdint.h>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "examples/BinaryShowLoader.h"
+#include "examples/BinaryShowSaver.h"
 #include "examples/ShowPlayer.h"
 #include "examples/ShowLoader.h"
 #include "examples/ShowRecorder.h"
+#include "examples/ShowSaver.h"
 
 using std::auto_ptr;
 using std::cout;
@@ -47,6 +52,12 @@ using std::string;
 DEFINE_s_string(playback, p, "", "The show file to playback.");
 DEFINE_s_string(record, r, "", "The show file to record data to.");
 DEFINE_string(verify, "", "The show file to verify.");
+DEFINE_string(convert, "",
+              "The show file to convert, text shows are converted to binary "
+              "and binary shows to text.");
+DEFINE_string(output, "", "The file to write the converted show to.");
+DEFINE_bool(binary, false,
+            "Record in the compressed binary format, which supports seeking.");
 DEFINE_s_string(universes, u, "",
                 "A comma separated list of universes to record");
 DEFINE_s_uint32(delay, d, 0, "The delay in ms between successive iterations.");
@@ -54,11 +65,23 @@ DEFINE_uint32(duration, 0, "The length of time (seconds) to run for.");
 // 0 means infinite looping
 DEFINE_s_uint32(iterations, i, 1,
                 "The number of times to repeat the show, 0 means unlimited.");
+DEFINE_uint32(start, 0,
+              "The offset in ms to start playback from, binary shows only.");
 
 void TerminateRecorder(ShowRecorder *recorder) {
   recorder->Stop();
 }
 
+/**
+ * Create a loader for a show file, based on the format of the file.
+ */
+ShowLoaderInterface *NewShowLoader(const string &filename) {
+  if (BinaryShowLoader::IsBinaryShow(filename)) {
+    return new BinaryShowLoader(filename);
+  }
+  return new ShowLoader(filename);
+}
+
 /**
  * Record a show
  */
@@ -81,7 +104,13 @@ int RecordShow() {
     universes.push_back(universe);
   }
 
-  ShowRecorder show_recorder(FLAGS_record.str(), universes);
+  ShowSaverInterface *saver;
+  if (FLAGS_binary) {
+    saver = new BinaryShowSaver(FLAGS_record.str());
+  } else {
+    saver = new ShowSaver(FLAGS_record.str());
+  }
+  ShowRecorder show_recorder(saver, universes);
   int status = show_recorder.Init();
   if (status)
     return status;
@@ -107,8 +136,8 @@ int RecordShow() {
  * Verify a show file is valid
  */
 int VerifyShow(const string &filename) {
-  ShowLoader loader(filename);
-  if (!loader.Load())
+  auto_ptr<ShowLoaderInterface> loader(NewShowLoader(filename));
+  if (!loader->Load())
     return ola::EXIT_NOINPUT;
 
   map<unsigned int, unsigned int> frames_by_universe;
@@ -117,15 +146,15 @@ int VerifyShow(const string &filename) {
   unsigned int universe;
   ola::DmxBuffer buffer;
   unsigned int timeout;
-  ShowLoader::State state;
+  ShowLoaderInterface::State state;
   while (true) {
-    state = loader.NextFrame(&universe, &buffer);
-    if (state != ShowLoader::OK)
+    state = loader->NextFrame(&universe, &buffer);
+    if (state != ShowLoaderInterface::OK)
       break;
     frames_by_universe[universe]++;
 
-    state = loader.NextTimeout(&timeout);
-    if (state != ShowLoader::OK)
+    state = loader->NextTimeout(&timeout);
+    if (state != ShowLoaderInterface::OK)
       break;
     total_time += timeout;
   }
@@ -143,7 +172,8 @@ int VerifyShow(const string &filename) {
   cout << "Playback time: " << total_time / 1000 << "." << total_time % 10 <<
     " seconds" << endl;
 
-  if ((state == ShowLoader::OK) || (state == ShowLoader::END_OF_FILE)) {
+  if ((state == ShowLoaderInterface::OK) ||
+      (state == ShowLoaderInterface::END_OF_FILE)) {
     return ola::EXIT_OK;
   } else {
     OLA_FATAL << "Error loading show, got state " << state;
@@ -151,28 +181,109 @@ int VerifyShow(const string &filename) {
   }
 }
 
+/**
+ * Convert a text show to a binary show, or a binary show to a text show.
+ */
+int ConvertShow(const string &filename, const string &output) {
+  if (output.empty()) {
+    OLA_FATAL << "No output file specified, use --output";
+    return ola::EXIT_USAGE;
+  }
+
+  auto_ptr<ShowLoaderInterface> loader;
+  auto_ptr<ShowSaverInterface> saver;
+  if (BinaryShowLoader::IsBinaryShow(filename)) {
+    loader.reset(new BinaryShowLoader(filename));
+    saver.reset(new ShowSaver(output));
+  } else {
+    loader.reset(new ShowLoader(filename));
+    saver.reset(new BinaryShowSaver(output));
+  }
+
+  if (!loader->Load())
+    return ola::EXIT_NOINPUT;
+  if (!saver->Open())
+    return ola::EXIT_CANTCREAT;
+
+  // The frame times are rebuilt from the timeouts, starting from an
+  // arbitrary point.
+  ola::TimeStamp time = ola::TimeStamp() + ola::TimeInterval(1, 0);
+  uint64_t frames = 0;
+  unsigned int universe;
+  ola::DmxBuffer buffer;
+  unsigned int timeout;
+  ShowLoaderInterface::State state;
+  while (true) {
+    state = loader->NextFrame(&universe, &buffer);
+    if (state != ShowLoaderInterface::OK)
+      break;
+    if (!saver->NewFrame(time, universe, buffer)) {
+      OLA_FATAL << "Failed to write to " << output;
+      return ola::EXIT_IOERR;
+    }
+    frames++;
+
+    state = loader->NextTimeout(&timeout);
+    if (state != ShowLoaderInterface::OK)
+      break;
+    time += ola::TimeInterval(static_cast<int64_t>(timeout) * 1000);
+  }
+
+  if (state != ShowLoaderInterface::END_OF_FILE) {
+    OLA_FATAL << "Error loading show, got state " << state;
+    return ola::EXIT_DATAERR;
+  }
+  saver->SetEndTime(time);
+  saver->Close();
+  cout << "Converted " << frames << " frames" << endl;
+  return ola::EXIT_OK;
+}
+
+/*
+ * Print how closely playback kept to the show's timing.
+ */
+void PrintPlaybackStats(const ShowPlayer::Stats &stats) {
+  cout << "Frames sent: " << stats.frames << endl;
+  cout << "Batches sent: " << stats.batches << endl;
+  cout << "Batches more than " << ShowPlayer::LATE_THRESHOLD_US / 1000
+       << "ms late: " << stats.late_batches << endl;
+  cout << "Frames skipped: " << stats.skipped_frames << endl;
+  if (stats.batches) {
+    cout << "Mean lateness: "
+         << stats.total_lateness_us / stats.batches / 1000.0 << "ms" << endl;
+  }
+  cout << "Max lateness: " << stats.max_lateness_us / 1000.0 << "ms" << endl;
+}
+
+
 /*
  * Main
  */
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv,
                "[--record <file> --universes <universe_list>] [--playback "
-               "<file>] [--verify <file>]",
+               "<file>] [--verify <file>] [--convert <file> --output <file>]",
                "Record a series of universes, or playback a previously "
                "recorded show.");
 
   if (!FLAGS_playback.str().empty()) {
-    ShowPlayer player(FLAGS_playback.str());
+    ShowPlayer player(NewShowLoader(FLAGS_playback.str()));
     int status = player.Init();
-    if (!status)
-      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay);
+    if (!status) {
+      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay,
+                               FLAGS_start);
+      PrintPlaybackStats(player.GetStats());
+    }
     return status;
   } else if (!FLAGS_record.str().empty()) {
     return RecordShow();
   } else if (!FLAGS_verify.str().empty()) {
     return VerifyShow(FLAGS_verify.str());
+  } else if (!FLAGS_convert.str().empty()) {
+    return ConvertShow(FLAGS_convert.str(), FLAGS_output.str());
   } else {
-    OLA_FATAL << "One of --record or --playback or --verify must be provided";
+    OLA_FATAL << "One of --record, --playback, --verify or --convert must be "
+              << "provided";
     ola::DisplayUsage();
   }
   return ola::EXIT_OK;
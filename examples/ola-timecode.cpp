@@ -44,6 +44,10 @@ using std::string;
 using std::vector;
 
 DEFINE_s_string(format, f, "SMPTE", "One of FILM, EBU, DF, SMPTE (default).");
+DEFINE_default_bool(run, false,
+                    "Start olad's timecode generator from time_code, rather "
+                    "than sending a single frame.");
+DEFINE_default_bool(stop, false, "Stop olad's timecode generator.");
 
 /**
  * Called on when we return from sending timecode data.
@@ -68,6 +72,19 @@ int main(int argc, char *argv[]) {
           "Hours:Minutes:Seconds:Frames");
   ola::client::OlaClientWrapper ola_client;
 
+  if (FLAGS_stop) {
+    if (argc != 1)
+      ola::DisplayUsageAndExit();
+    if (!ola_client.Setup()) {
+      OLA_FATAL << "Setup failed";
+      exit(ola::EXIT_UNAVAILABLE);
+    }
+    ola_client.GetClient()->StopTimeCode(
+        ola::NewSingleCallback(&TimeCodeDone, ola_client.GetSelectServer()));
+    ola_client.GetSelectServer()->Run();
+    return ola::EXIT_OK;
+  }
+
   if (argc != 2)
     ola::DisplayUsageAndExit();
 
@@ -125,9 +142,13 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_UNAVAILABLE);
   }
 
-  ola_client.GetClient()->SendTimeCode(
-      timecode,
-      ola::NewSingleCallback(&TimeCodeDone, ola_client.GetSelectServer()));
+  ola::client::SetCallback *callback = ola::NewSingleCallback(
+      &TimeCodeDone, ola_client.GetSelectServer());
+  if (FLAGS_run) {
+    ola_client.GetClient()->RunTimeCode(timecode, callback);
+  } else {
+    ola_client.GetClient()->SendTimeCode(timecode, callback);
+  }
 
   ola_client.GetSelectServer()->Run();
   return ola::EXIT_OK;
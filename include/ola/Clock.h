@@ -241,6 +241,74 @@ class Clock {
 };
 
 
+/**
+ * @brief A Clock that can't go backwards.
+ *
+ * The time is aligned with the wall clock when the MonotonicClock is created,
+ * so the TimeStamps can be compared with those from a Clock, but it isn't
+ * affected if the system time is changed later.
+ *
+ * A coarse MonotonicClock is cheaper to read but only has the resolution of
+ * the kernel tick, usually 1 - 4ms. Where the platform doesn't provide a
+ * monotonic clock this behaves the same as Clock.
+ */
+class MonotonicClock: public Clock {
+ public:
+  /**
+   * @brief Create a new MonotonicClock.
+   * @param coarse use CLOCK_MONOTONIC_COARSE, if it's available.
+   */
+  explicit MonotonicClock(bool coarse = false);
+
+  void CurrentTime(TimeStamp *timestamp) const;
+
+ private:
+  int m_clock_id;
+  bool m_use_monotonic;
+  TimeInterval m_offset;
+
+  void MonotonicTime(TimeStamp *timestamp) const;
+};
+
+
+/**
+ * @brief A Clock that returns a time someone else keeps up to date.
+ *
+ * This is used to share the time a SelectServer woke up with the code that
+ * runs in its callbacks, so they don't each need to read the clock. If the
+ * cached time isn't set, the time comes from the fallback Clock instead.
+ *
+ * This should only be used from the thread that updates the cached time.
+ */
+class CachedClock: public Clock {
+ public:
+  /**
+   * @brief Create a new CachedClock.
+   * @param cached_time the time to return, may be NULL. Ownership is not
+   *   transferred.
+   * @param clock the Clock to use if cached_time isn't set, ownership is not
+   *   transferred.
+   */
+  CachedClock(const TimeStamp *cached_time, const Clock *clock)
+      : Clock(),
+        m_cached_time(cached_time),
+        m_clock(clock) {
+  }
+
+  void CurrentTime(TimeStamp *timestamp) const {
+    if (m_cached_time && m_cached_time->IsSet()) {
+      *timestamp = *m_cached_time;
+    } else {
+      m_clock->CurrentTime(timestamp);
+    }
+  }
+
+ private:
+  const TimeStamp *m_cached_time;
+  const Clock *m_clock;
+};
+
+
 /**
  * A Mock Clock used for testing.
  */
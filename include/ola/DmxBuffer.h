@@ -90,6 +90,46 @@ class DmxBuffer {
      */
     DmxBuffer& operator=(const DmxBuffer &other);
 
+#if __cplusplus >= 201103L
+    /**
+     * @brief Move constructor.
+     * This takes the data from other without touching the reference count.
+     * @param other the DmxBuffer to move from, it's left empty.
+     */
+    DmxBuffer(DmxBuffer &&other) noexcept
+        : m_ref_count(NULL),
+          m_copy_on_write(false),
+          m_data(NULL),
+          m_length(0),
+          m_changed_start(0),
+          m_changed_end(0) {
+      Swap(&other);
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other the DmxBuffer to move from, it's left empty.
+     */
+    DmxBuffer& operator=(DmxBuffer &&other) noexcept {
+      if (this != &other) {
+        DmxBuffer old;
+        old.Swap(&other);
+        Swap(&old);
+      }
+      return *this;
+    }
+#endif  // __cplusplus >= 201103L
+
+    /**
+     * @brief Exchange the data held by two buffers.
+     * @param other the DmxBuffer to swap with.
+     *
+     * This doesn't change any reference counts or allocate memory, so it's
+     * the cheap way to hand a buffer on when the source is no longer needed.
+     * The slots that differ are recorded as changes in both buffers.
+     */
+    void Swap(DmxBuffer *other);
+
     /**
      * @brief Equality operator used to check if two DmxBuffers are equal.
      * @param other is the other DmxBuffer to check against
@@ -117,6 +157,42 @@ class DmxBuffer {
      */
     bool HTPMerge(const DmxBuffer &other);
 
+    /**
+     * @brief Set this buffer to the HTP merge of a number of other buffers.
+     *
+     * This is equivalent to calling Reset() followed by HTPMerge() for each
+     * source, but makes a single pass over the data. Empty sources are
+     * ignored and this buffer may be one of the sources.
+     * @param sources an array of pointers to the DmxBuffers to merge
+     * @param count the number of entries in sources
+     * @return false if the merge failed, and true if merge was successful
+     * @post Size() is the size of the largest source
+     */
+    bool HTPMergeMany(const DmxBuffer *const *sources, unsigned int count);
+
+    /**
+     * @brief Set this buffer to the per-slot priority merge of a number of
+     *   other buffers.
+     *
+     * Each slot takes the value from the source with the highest priority for
+     * that slot, sources with the same priority are HTP merged. A priority of
+     * 0 means the source doesn't control the slot, slots that no source
+     * controls are set to 0. This buffer may be one of the sources.
+     * @param sources an array of pointers to the DmxBuffers to merge
+     * @param priorities an array of pointers to the slot priorities for each
+     *   source, each must hold at least as many entries as the source has
+     *   slots.
+     * @param count the number of entries in sources and priorities
+     * @param[out] slot_priorities if not NULL, this is set to the winning
+     *   priority for each slot. Must hold DMX_UNIVERSE_SIZE entries.
+     * @return false if the merge failed, and true if merge was successful
+     * @post Size() is the size of the largest source
+     */
+    bool PriorityMergeMany(const DmxBuffer *const *sources,
+                           const uint8_t *const *priorities,
+                           unsigned int count,
+                           uint8_t *slot_priorities = NULL);
+
     /**
      * @brief Set the contents of this DmxBuffer
      * @param data is a pointer to an array of uint8_t values
@@ -252,6 +328,42 @@ class DmxBuffer {
      */
     void Reset();
 
+    /**
+     * @brief Check if any slots have changed since the last call to
+     * ClearChanges().
+     * @return true if the data in this buffer has changed.
+     *
+     * Changes are tracked per DmxBuffer object, so a copy has its own record
+     * of what has changed. Setting a slot to the value it already has isn't
+     * counted as a change.
+     */
+    bool HasChanges() const { return m_changed_end > m_changed_start; }
+
+    /**
+     * @brief Get the range of slots that have changed since the last call to
+     * ClearChanges().
+     * @param[out] offset the first slot that changed.
+     * @param[out] length the number of slots in the range, or 0 if nothing has
+     *   changed.
+     *
+     * The range covers every changed slot, it may include some unchanged
+     * slots in the middle. If the buffer shrank, the range extends past
+     * Size().
+     */
+    void GetChangedRange(unsigned int *offset, unsigned int *length) const {
+      *offset = m_changed_start;
+      *length = m_changed_end - m_changed_start;
+    }
+
+    /**
+     * @brief Acknowledge the changes to this buffer.
+     * @post HasChanges() == false
+     */
+    void ClearChanges() {
+      m_changed_start = 0;
+      m_changed_end = 0;
+    }
+
     /**
      * @brief Convert the DmxBuffer to a human readable representation.
      * @return a string in a human readable form
@@ -265,14 +377,25 @@ class DmxBuffer {
     std::string ToString() const;
 
  private:
+    enum { MERGE_GROUP_SIZE = 8 };
+
     bool Init();
     bool DuplicateIfNeeded();
     void CopyFromOther(const DmxBuffer &other);
     void CleanupMemory();
+    void MarkChanged(unsigned int start, unsigned int end);
+    void RecordChanges(unsigned int offset,
+                       const uint8_t *old_data, unsigned int old_length,
+                       const uint8_t *new_data, unsigned int new_length);
+    void RecordValueChanges(unsigned int offset, uint8_t value,
+                            unsigned int length);
     unsigned int *m_ref_count;
     mutable bool m_copy_on_write;
     uint8_t *m_data;
     unsigned int m_length;
+    // The slots in [m_changed_start, m_changed_end) have changed.
+    unsigned int m_changed_start;
+    unsigned int m_changed_end;
 };
 
 /**
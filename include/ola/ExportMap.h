@@ -32,10 +32,13 @@
 
 #include <ola/base/Macro.h>
 #include <ola/StringUtils.h>
+#include <ola/util/Histogram.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <functional>
 #include <map>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -171,7 +174,8 @@ class IntegerVariable: public BaseVariable {
 
 
 /*
- * Represents a counter which can only be added to.
+ * Represents a counter which can only be added to. Updates are atomic, so the
+ * counter can be updated from any thread.
  */
 class CounterVariable: public BaseVariable {
  public:
@@ -180,8 +184,10 @@ class CounterVariable: public BaseVariable {
         m_value(0) {}
   ~CounterVariable() {}
 
-  void operator++(int) { m_value++; }
-  void operator+=(unsigned int value) { m_value += value; }
+  void operator++(int) { __sync_fetch_and_add(&m_value, 1); }
+  void operator+=(unsigned int value) {
+    __sync_fetch_and_add(&m_value, value);
+  }
   void Reset() { m_value = 0; }
   unsigned int Get() const { return m_value; }
   const std::string Value() const {
@@ -201,6 +207,8 @@ class CounterVariable: public BaseVariable {
 template<typename Type>
 class MapVariable: public BaseVariable {
  public:
+  typedef typename std::map<std::string, Type>::const_iterator const_iterator;
+
   MapVariable(const std::string &name, const std::string &label)
       : BaseVariable(name),
         m_label(label) {}
@@ -212,6 +220,12 @@ class MapVariable: public BaseVariable {
   const std::string Value() const;
   const std::string Label() const { return m_label; }
 
+  /**
+   * @brief Iterate over the entries in the map.
+   */
+  const_iterator begin() const { return m_variables.begin(); }
+  const_iterator end() const { return m_variables.end(); }
+
  protected:
   std::map<std::string, Type> m_variables;
 
@@ -241,12 +255,93 @@ class IntMap: public MapVariable<int> {
  */
 class UIntMap: public MapVariable<unsigned int> {
  public:
+  /**
+   * @brief A handle to a single entry in a UIntMap.
+   *
+   * Looking up the entry once and keeping the handle avoids a string keyed
+   * map lookup on every update. Updates are atomic, so they can be made from
+   * any thread. A default constructed handle ignores updates, which saves
+   * checking if there is an ExportMap.
+   *
+   * The handle is invalidated if the entry is removed from the map.
+   */
+  class Handle {
+   public:
+    Handle() : m_value(NULL) {}
+    explicit Handle(unsigned int *value) : m_value(value) {}
+
+    void Increment() {
+      if (m_value) {
+        __sync_fetch_and_add(m_value, 1);
+      }
+    }
+
+    void Decrement() {
+      if (m_value) {
+        __sync_fetch_and_sub(m_value, 1);
+      }
+    }
+
+    void Add(unsigned int value) {
+      if (m_value) {
+        __sync_fetch_and_add(m_value, value);
+      }
+    }
+
+    void Set(unsigned int value) {
+      if (m_value) {
+        *m_value = value;
+      }
+    }
+
+    bool IsValid() const { return m_value != NULL; }
+
+   private:
+    unsigned int *m_value;
+  };
+
   UIntMap(const std::string &name, const std::string &label)
       : MapVariable<unsigned int>(name, label) {}
 
   void Increment(const std::string &key) {
     m_variables[key]++;
   }
+
+  /**
+   * @brief Return a handle to an entry, creating it if it doesn't exist.
+   */
+  Handle GetHandle(const std::string &key) {
+    return Handle(&m_variables[key]);
+  }
+};
+
+
+/**
+ * @brief A distribution of values, see ola::Histogram.
+ *
+ * The /debug page shows the count, the 50th, 90th & 99th percentiles and the
+ * maximum. Like the other variables, this isn't thread safe; values must be
+ * added from the thread that owns the ExportMap.
+ */
+class HistogramVariable: public BaseVariable {
+ public:
+  explicit HistogramVariable(const std::string &name)
+      : BaseVariable(name) {}
+  ~HistogramVariable() {}
+
+  void Add(uint32_t value) { m_histogram.Add(value); }
+  void Reset() { m_histogram.Reset(); }
+  const Histogram &Get() const { return m_histogram; }
+  const std::string Value() const;
+
+  /**
+   * @brief The percentiles we report.
+   */
+  static const unsigned int PERCENTILES[];
+  static const unsigned int PERCENTILE_COUNT = 3;
+
+ private:
+  Histogram m_histogram;
 };
 
 
@@ -372,12 +467,35 @@ class ExportMap {
   UIntMap *GetUIntMapVar(const std::string &name,
                          const std::string &label = "");
 
+  /**
+   * @brief Lookup or create a HistogramVariable.
+   * @param name the name of this variable.
+   * @return a HistogramVariable.
+   *
+   * The variable is created if it doesn't already exist. The pointer is
+   * valid for the lifetime of the ExportMap.
+   */
+  HistogramVariable *GetHistogramVar(const std::string &name);
+
   /**
    * @brief Fetch a list of all known variables.
    * @returns a vector of all variables.
    */
   std::vector<BaseVariable*> AllVariables() const;
 
+  /**
+   * @brief Write all variables in the OpenMetrics text format.
+   * @param output the stream to write to.
+   *
+   * Names and labels are converted to valid metric names, e.g. rpc-received
+   * becomes rpc_received. Counters are exported as counters, integers and
+   * integer maps as gauges, strings as info metrics and histograms as
+   * summaries.
+   */
+  void ExportOpenMetrics(std::ostream *output) const;
+
+  static const char OPEN_METRICS_CONTENT_TYPE[];
+
  private :
   template<typename Type>
   Type *GetVar(std::map<std::string, Type*> *var_map,
@@ -396,6 +514,7 @@ class ExportMap {
   std::map<std::string, StringMap*> m_str_map_variables;
   std::map<std::string, IntMap*> m_int_map_variables;
   std::map<std::string, UIntMap*> m_uint_map_variables;
+  std::map<std::string, HistogramVariable*> m_histogram_variables;
 
   DISALLOW_COPY_AND_ASSIGN(ExportMap);
 };
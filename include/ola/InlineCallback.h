@@ -0,0 +1,341 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InlineCallback.h
+ * A callback that's stored by value.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup callback_helpers
+ * @{
+ * @file InlineCallback.h
+ * @brief A callback that's stored by value, rather than on the heap.
+ *
+ * NewCallback() and NewSingleCallback() allocate each callback on the heap,
+ * which adds up for callbacks created every frame. An InlineCallback0 holds
+ * the same callback objects in a small buffer inside itself, and only falls
+ * back to the heap if the bound arguments don't fit.
+ *
+ * @examplepara
+ *   @code
+ *   // Run SendSync() once the current event has been handled, without
+ *   // allocating.
+ *   m_ss->RegisterSingleTimeout(
+ *       TimeInterval(0, 0),
+ *       MakeInlineCallback(this, &Node::SendSync));
+ *   @endcode
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_INLINECALLBACK_H_
+#define INCLUDE_OLA_INLINECALLBACK_H_
+
+#include <ola/Callback.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+namespace ola {
+
+/**
+ * @addtogroup callbacks
+ * @{
+ */
+
+/**
+ * @brief A 0 argument callback that's stored by value.
+ *
+ * Copying an InlineCallback0 copies the bound arguments, so the bound
+ * arguments must be cheap to copy. Unlike SingleUseCallback0, running the
+ * callback doesn't reset it; the owner decides when it's done with it.
+ */
+template <typename ReturnType>
+class InlineCallback0 {
+ public:
+  InlineCallback0() : m_callback(NULL), m_clone(NULL) {}
+
+  InlineCallback0(const InlineCallback0 &other)
+      : m_callback(NULL),
+        m_clone(NULL) {
+    CopyFrom(other);
+  }
+
+  ~InlineCallback0() { Reset(); }
+
+  InlineCallback0& operator=(const InlineCallback0 &other) {
+    if (this != &other) {
+      Reset();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Store a callback.
+   * @tparam Impl a copyable subclass of Callback0<ReturnType>, usually one of
+   *   the FunctionCallback or MethodCallback classes.
+   * @param impl the callback to copy.
+   */
+  template <typename Impl>
+  void Set(const Impl &impl) {
+    Reset();
+    m_callback = Clone<Impl>(impl, &m_storage);
+    m_clone = &Clone<Impl>;
+  }
+
+  /**
+   * @brief Run the callback. This must not be called if Empty() is true.
+   */
+  ReturnType Run() { return m_callback->Run(); }
+
+  /**
+   * @brief Returns true if no callback has been stored.
+   */
+  bool Empty() const { return m_callback == NULL; }
+
+  /**
+   * @brief Returns true if the callback fit in the inline buffer.
+   */
+  bool IsInline() const {
+    return m_callback &&
+        static_cast<const void*>(m_callback) ==
+        static_cast<const void*>(&m_storage);
+  }
+
+  /**
+   * @brief Discard the callback.
+   */
+  void Reset() {
+    if (!m_callback) {
+      return;
+    }
+    if (IsInline()) {
+      m_callback->~Callback();
+    } else {
+      delete m_callback;
+    }
+    m_callback = NULL;
+    m_clone = NULL;
+  }
+
+  /**
+   * @brief The number of bytes available for the callback object.
+   *
+   * This fits a method callback with up to three pointer sized arguments on
+   * most platforms.
+   */
+  enum { INLINE_SIZE = 6 * sizeof(void*) };
+
+ private:
+  typedef Callback0<ReturnType> Callback;
+  typedef Callback* (*CloneFunction)(const Callback &from, void *storage);
+
+  union Storage {
+    void *pointer;
+    double floating;
+    uint64_t integer;
+    char bytes[INLINE_SIZE];
+  };
+
+  Callback *m_callback;
+  CloneFunction m_clone;
+  Storage m_storage;
+
+  void CopyFrom(const InlineCallback0 &other) {
+    if (other.m_callback) {
+      m_callback = other.m_clone(*other.m_callback, &m_storage);
+      m_clone = other.m_clone;
+    }
+  }
+
+  template <typename Impl>
+  static Callback *Clone(const Callback &from, void *storage) {
+    const Impl &impl = static_cast<const Impl&>(from);
+    if (sizeof(Impl) <= sizeof(Storage)) {
+      return new(storage) Impl(impl);
+    }
+    return new Impl(impl);
+  }
+};
+
+
+/**
+ * @brief Runs an InlineCallback0 from a SingleUseCallback0.
+ *
+ * This is used to pass an InlineCallback0 to code that expects a heap
+ * allocated callback.
+ */
+template <typename ReturnType>
+class InlineCallbackRunner0: public SingleUseCallback0<ReturnType> {
+ public:
+  explicit InlineCallbackRunner0(const InlineCallback0<ReturnType> &callback)
+      : SingleUseCallback0<ReturnType>(),
+        m_callback(callback) {
+  }
+
+  ReturnType DoRun() { return m_callback.Run(); }
+
+ private:
+  InlineCallback0<ReturnType> m_callback;
+};
+
+
+/**
+ * @brief Copy an InlineCallback0 to a new SingleUseCallback0.
+ * @param callback the callback to copy.
+ * @returns a SingleUseCallback0 which runs a copy of callback.
+ */
+template <typename ReturnType>
+inline SingleUseCallback0<ReturnType>* ToSingleUseCallback(
+    const InlineCallback0<ReturnType> &callback) {
+  return new InlineCallbackRunner0<ReturnType>(callback);
+}
+
+
+/**
+ * @brief Create an InlineCallback0 from a function with no arguments.
+ * @param callback the function to call.
+ */
+template <typename ReturnType>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    ReturnType (*callback)()) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      FunctionCallback0_0<Callback0<ReturnType>, ReturnType>(callback));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a function with one create-time
+ *   argument.
+ * @param callback the function to call.
+ * @param a0 a create-time argument.
+ */
+template <typename ReturnType, typename A0>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    ReturnType (*callback)(A0),
+    A0 a0) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      FunctionCallback1_0<Callback0<ReturnType>, ReturnType, A0>(
+          callback, a0));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a function with two create-time
+ *   arguments.
+ * @param callback the function to call.
+ * @param a0 a create-time argument.
+ * @param a1 a create-time argument.
+ */
+template <typename ReturnType, typename A0, typename A1>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    ReturnType (*callback)(A0, A1),
+    A0 a0,
+    A1 a1) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      FunctionCallback2_0<Callback0<ReturnType>, ReturnType, A0, A1>(
+          callback, a0, a1));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a member function with no
+ *   arguments.
+ * @param object the object to call the member function on.
+ * @param method the member function to call.
+ */
+template <typename Class, typename ReturnType>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    Class *object,
+    ReturnType (Class::*method)()) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      MethodCallback0_0<Class, Callback0<ReturnType>, ReturnType>(
+          object, method));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a member function with one
+ *   create-time argument.
+ * @param object the object to call the member function on.
+ * @param method the member function to call.
+ * @param a0 a create-time argument.
+ */
+template <typename Class, typename ReturnType, typename A0>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    Class *object,
+    ReturnType (Class::*method)(A0),
+    A0 a0) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      MethodCallback1_0<Class, Callback0<ReturnType>, ReturnType, A0>(
+          object, method, a0));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a member function with two
+ *   create-time arguments.
+ * @param object the object to call the member function on.
+ * @param method the member function to call.
+ * @param a0 a create-time argument.
+ * @param a1 a create-time argument.
+ */
+template <typename Class, typename ReturnType, typename A0, typename A1>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    Class *object,
+    ReturnType (Class::*method)(A0, A1),
+    A0 a0,
+    A1 a1) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      MethodCallback2_0<Class, Callback0<ReturnType>, ReturnType, A0, A1>(
+          object, method, a0, a1));
+  return inline_callback;
+}
+
+/**
+ * @brief Create an InlineCallback0 from a member function with three
+ *   create-time arguments.
+ * @param object the object to call the member function on.
+ * @param method the member function to call.
+ * @param a0 a create-time argument.
+ * @param a1 a create-time argument.
+ * @param a2 a create-time argument.
+ */
+template <typename Class, typename ReturnType, typename A0, typename A1,
+          typename A2>
+inline InlineCallback0<ReturnType> MakeInlineCallback(
+    Class *object,
+    ReturnType (Class::*method)(A0, A1, A2),
+    A0 a0,
+    A1 a1,
+    A2 a2) {
+  InlineCallback0<ReturnType> inline_callback;
+  inline_callback.Set(
+      MethodCallback3_0<Class, Callback0<ReturnType>, ReturnType, A0, A1,
+                        A2>(object, method, a0, a1, a2));
+  return inline_callback;
+}
+/**
+ * @}
+ */
+}  // namespace ola
+#endif  // INCLUDE_OLA_INLINECALLBACK_H_
@@ -90,6 +90,33 @@
  */
 #define OLA_DEBUG OLA_LOG(ola::OLA_LOG_DEBUG)
 
+/**
+ * @brief Like OLA_LOG, but each call site is limited to
+ * ola::LOG_RATE_LIMIT lines per second.
+ *
+ * Use this for messages that can be triggered by every frame or packet, such
+ * as malformed network data. The message isn't formatted if it's suppressed.
+ * Once the second is up, the next line is preceded by a count of the lines
+ * that were suppressed.
+ * @param level the log_level to log at.
+ */
+#define OLA_LOG_LIMITED(level) (level <= ola::LogLevel()) && \
+    ola::AllowLogLine(__FILE__, __LINE__, level) && \
+    ola::LogLine(__FILE__, __LINE__, level).stream()
+
+/**
+ * Provide a rate limited stream to log a warning message.
+ * @code
+ *     OLA_WARN_LIMITED << "Invalid packet from " << ip_address;
+ * @endcode
+ */
+#define OLA_WARN_LIMITED OLA_LOG_LIMITED(ola::OLA_LOG_WARN)
+
+/**
+ * Provide a rate limited stream to log an informational message.
+ */
+#define OLA_INFO_LIMITED OLA_LOG_LIMITED(ola::OLA_LOG_INFO)
+
 namespace ola {
 
 /**
@@ -229,6 +256,12 @@ class LogLine {
   std::ostringstream m_stream;
   unsigned int m_prefix_length;
 };
+
+/*
+ * Check if a rate limited log line should be written, used by
+ * OLA_LOG_LIMITED.
+ */
+bool AllowLogLine(const char *file, int line, log_level level);
 /**@endcond*/
 
 /**
@@ -236,6 +269,11 @@ class LogLine {
  * @{
  */
 
+/**
+ * @brief The number of lines per second a OLA_LOG_LIMITED call site may log.
+ */
+static const unsigned int LOG_RATE_LIMIT = 10;
+
 /**
  * @brief Set the logging level.
  * @param level the new log_level to use.
@@ -274,6 +312,34 @@ bool InitLogging(log_level level, log_output output);
  * @param destination the LogDestination to use.
  */
 void InitLogging(log_level level, LogDestination *destination);
+
+/**
+ * @brief Write log lines from a background thread.
+ * @returns true if the thread was started, false otherwise.
+ *
+ * The current destination is wrapped in an AsyncLogDestination, so logging
+ * doesn't block on a slow stderr or syslog. This starts a thread, so call it
+ * after blocking signals and after forking.
+ */
+bool StartAsyncLogging();
+
+/**
+ * @brief Write any queued log lines and return to logging synchronously.
+ *
+ * No other threads should be logging when this is called.
+ */
+void StopAsyncLogging();
+
+/**
+ * @brief The number of lines suppressed by OLA_LOG_LIMITED.
+ */
+unsigned int SuppressedLogLines();
+
+/**
+ * @brief The number of lines dropped because the async logging queue was
+ * full.
+ */
+unsigned int DroppedLogLines();
 /***/
 }  // namespace ola
 /**@}*/
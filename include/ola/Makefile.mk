@@ -34,6 +34,7 @@ pkginclude_HEADERS += \
     include/ola/Constants.h \
     include/ola/DmxBuffer.h \
     include/ola/ExportMap.h \
+    include/ola/InlineCallback.h \
     include/ola/Logging.h \
     include/ola/MultiCallback.h \
     include/ola/StringUtils.h
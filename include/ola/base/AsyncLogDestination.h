@@ -0,0 +1,132 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.h
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+#define INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+
+#include <ola/Logging.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/MPSCQueue.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ola {
+
+/**
+ * @brief A LogDestination that hands lines to a background thread, which
+ * writes them to another LogDestination.
+ *
+ * Write() pushes the line onto a lock-free queue, and only takes a lock to
+ * wake the writer thread when the queue was empty. If more than max_queued
+ * lines are waiting, new lines are dropped and counted; the writer thread
+ * logs the number dropped once it catches up.
+ *
+ * Fatal lines, and any lines logged before Start() or after Stop(), are
+ * written immediately.
+ */
+class AsyncLogDestination: public LogDestination {
+ public:
+  /**
+   * @brief Create a new AsyncLogDestination.
+   * @param destination the LogDestination to write to, ownership is
+   *   transferred.
+   * @param max_queued the maximum number of lines waiting to be written.
+   */
+  explicit AsyncLogDestination(LogDestination *destination,
+                               unsigned int max_queued = DEFAULT_MAX_QUEUED);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~AsyncLogDestination();
+
+  /**
+   * @brief Start the writer thread.
+   * @returns true if the thread started.
+   */
+  bool Start();
+
+  /**
+   * @brief Write the queued lines and stop the writer thread.
+   */
+  void Stop();
+
+  void Write(log_level level, const std::string &log_line);
+
+  /**
+   * @brief Stop and return the wrapped LogDestination.
+   * @returns the LogDestination, ownership is transferred to the caller.
+   */
+  LogDestination *Release();
+
+  /**
+   * @brief The number of lines dropped because the queue was full.
+   */
+  unsigned int Dropped() const { return m_dropped; }
+
+  static const unsigned int DEFAULT_MAX_QUEUED = 1000;
+
+ private:
+  struct QueuedLine {
+    QueuedLine() : level(OLA_LOG_NONE) {}
+    QueuedLine(log_level _level, const std::string &_line)
+        : level(_level), line(_line) {}
+
+    log_level level;
+    std::string line;
+  };
+
+  class WriterThread: public ola::thread::Thread {
+   public:
+    explicit WriterThread(AsyncLogDestination *parent)
+        : ola::thread::Thread(ola::thread::Thread::Options("log")),
+          m_parent(parent) {}
+
+   protected:
+    void *Run() { return m_parent->RunWriter(); }
+
+   private:
+    AsyncLogDestination *m_parent;
+  };
+
+  std::auto_ptr<LogDestination> m_destination;
+  const unsigned int m_max_queued;
+  ola::thread::MPSCQueue<QueuedLine> m_queue;
+  volatile unsigned int m_queued;
+  volatile unsigned int m_dropped;
+  unsigned int m_reported_dropped;
+  volatile bool m_running;
+  bool m_stop;
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  std::auto_ptr<WriterThread> m_thread;
+  std::vector<QueuedLine> m_lines;
+
+  void *RunWriter();
+  void WriteQueued();
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogDestination);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
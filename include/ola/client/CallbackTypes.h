@@ -32,6 +32,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/UIDSet.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -133,6 +134,22 @@ typedef SingleUseCallback2<void, const Result&, const ola::rdm::UIDSet&>
 typedef SingleUseCallback3<void, const Result&, const DMXMetadata&,
                            const DmxBuffer&> DMXCallback;
 
+/**
+ * @brief Called once when OlaClient::FetchDMXBatch() completes.
+ * @param result the Result of the API call.
+ * @param data a map of universe id to the DMX data. Universes that don't
+ * exist are left out.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::map<unsigned int, DmxBuffer>&>
+    DMXBatchCallback;
+
+/**
+ * @brief Called when olad pushes a change to the universes.
+ * @param update the UniverseInfoUpdate.
+ */
+typedef Callback1<void, const UniverseInfoUpdate&> UniverseInfoUpdateCallback;
+
 /**
  * @brief Called when new DMX data arrives.
  * @param metadata the DMXMetadata associated with the frame.
@@ -21,8 +21,12 @@
 #ifndef INCLUDE_OLA_CLIENT_CLIENTARGS_H_
 #define INCLUDE_OLA_CLIENT_CLIENTARGS_H_
 
+#include <ola/DmxBuffer.h>
 #include <ola/client/CallbackTypes.h>
 #include <ola/dmx/SourcePriorities.h>
+#include <ola/rdm/UID.h>
+#include <stdint.h>
+#include <string>
 
 /**
  * @file
@@ -96,6 +100,44 @@ struct SendDMXArgs {
   }
 };
 
+/**
+ * @brief Arguments passed to the RegisterUniverse() method.
+ *
+ * These let a client that doesn't need every update, like a monitoring tool,
+ * reduce the data olad sends it.
+ */
+struct RegisterArgs {
+  /**
+   * @brief The most updates per second to receive, 0 means no limit. Defaults
+   * to 0.
+   */
+  unsigned int max_rate;
+  /**
+   * @brief Only receive updates when the data changes. Defaults to false.
+   */
+  bool changes_only;
+  /**
+   * @brief The first slot to receive. The data passed to the DMX callback
+   * starts at this slot. Defaults to 0.
+   */
+  unsigned int start_slot;
+  /**
+   * @brief The number of slots to receive, 0 means all slots from start_slot.
+   * Defaults to 0.
+   */
+  unsigned int slot_count;
+
+  /**
+   * @brief Create a new RegisterArgs object
+   */
+  RegisterArgs()
+      : max_rate(0),
+        changes_only(false),
+        start_slot(0),
+        slot_count(0) {
+  }
+};
+
 /**
  * @brief Arguments used with OlaClient::RDMGet() and OlaClient::RDMSet()
  * methods.
@@ -111,9 +153,84 @@ struct SendRDMArgs {
    */
   bool include_raw_frames;
 
+  /**
+   * @brief Set to true if the request is part of a bulk operation, like a
+   * scan of every responder. olad sends interactive requests first. Requests
+   * sent with OlaClient::RDMBatch() are always treated as bulk.
+   */
+  bool bulk;
+
   explicit SendRDMArgs(RDMCallback *_callback)
     : callback(_callback),
-      include_raw_frames(false) {
+      include_raw_frames(false),
+      bulk(false) {
+  }
+};
+
+/**
+ * @brief The data for one universe sent with OlaClient::SendDMXBatch().
+ */
+struct DMXBatchEntry {
+  unsigned int universe;  /**< The universe to send to. */
+  uint8_t priority;  /**< The priority of the data. */
+  DmxBuffer data;  /**< The DMX512 data. */
+
+  DMXBatchEntry(unsigned int _universe,
+                const DmxBuffer &_data,
+                uint8_t _priority = ola::dmx::SOURCE_PRIORITY_DEFAULT)
+    : universe(_universe),
+      priority(_priority),
+      data(_data) {
+  }
+};
+
+/**
+ * @brief A port change sent with OlaClient::PatchBatch().
+ */
+struct PatchBatchEntry {
+  unsigned int device_alias;  /**< The device containing the port. */
+  unsigned int port;  /**< The port id. */
+  PortDirection port_direction;  /**< The direction of the port. */
+  PatchAction action;  /**< PATCH or UNPATCH. */
+  unsigned int universe;  /**< The universe to patch the port to. */
+
+  PatchBatchEntry(unsigned int _device_alias,
+                  unsigned int _port,
+                  PortDirection _port_direction,
+                  PatchAction _action,
+                  unsigned int _universe)
+    : device_alias(_device_alias),
+      port(_port),
+      port_direction(_port_direction),
+      action(_action),
+      universe(_universe) {
+  }
+};
+
+/**
+ * @brief A request sent with OlaClient::RDMBatch().
+ */
+struct RDMBatchEntry {
+  unsigned int universe;  /**< The universe to send the request on. */
+  ola::rdm::UID uid;  /**< The UID of the responder. */
+  uint16_t sub_device;  /**< The sub device. */
+  uint16_t pid;  /**< The PID. */
+  bool is_set;  /**< True for a SET, false for a GET. */
+  std::string data;  /**< The param data. */
+  SendRDMArgs args;  /**< Includes the callback to run for this request. */
+
+  RDMBatchEntry(unsigned int _universe,
+                const ola::rdm::UID &_uid,
+                uint16_t _sub_device,
+                uint16_t _pid,
+                bool _is_set,
+                RDMCallback *_callback)
+    : universe(_universe),
+      uid(_uid),
+      sub_device(_sub_device),
+      pid(_pid),
+      is_set(_is_set),
+      args(_callback) {
   }
 };
 }  // namespace client
@@ -27,6 +27,7 @@
 
 #include <olad/PortConstants.h>
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -125,7 +126,9 @@ class OlaPort {
           port_priority_capability capability,
           port_priority_mode mode,
           uint8_t priority,
-          bool supports_rdm):
+          bool supports_rdm,
+          unsigned int max_frame_rate = 0,
+          unsigned int skipped_frames = 0):
     m_id(port_id),
     m_universe(universe),
     m_active(active),
@@ -133,7 +136,9 @@ class OlaPort {
     m_priority_capability(capability),
     m_priority_mode(mode),
     m_priority(priority),
-    m_supports_rdm(supports_rdm) {}
+    m_supports_rdm(supports_rdm),
+    m_max_frame_rate(max_frame_rate),
+    m_skipped_frames(skipped_frames) {}
   virtual ~OlaPort() {}
 
   unsigned int Id() const { return m_id; }
@@ -165,6 +170,18 @@ class OlaPort {
    */
   bool SupportsRDM() const { return m_supports_rdm; }
 
+  /**
+   * @brief The maximum rate that DMX is written to this port.
+   * @returns the rate in frames per second, 0 means there is no limit. This
+   *   is always 0 for input ports.
+   */
+  unsigned int MaxFrameRate() const { return m_max_frame_rate; }
+
+  /**
+   * @brief The number of frames that the rate limit stopped being written.
+   */
+  unsigned int SkippedFrames() const { return m_skipped_frames; }
+
  private:
   unsigned int m_id;  // id of this port
   unsigned int m_universe;  // universe
@@ -174,6 +191,8 @@ class OlaPort {
   port_priority_mode m_priority_mode;
   uint8_t m_priority;
   bool m_supports_rdm;
+  unsigned int m_max_frame_rate;
+  unsigned int m_skipped_frames;
 };
 
 /**
@@ -206,9 +225,12 @@ class OlaOutputPort: public OlaPort {
                 port_priority_capability capability,
                 port_priority_mode mode,
                 uint8_t priority,
-                bool supports_rdm):
+                bool supports_rdm,
+                unsigned int max_frame_rate = 0,
+                unsigned int skipped_frames = 0):
       OlaPort(port_id, universe, active, description,
-              capability, mode, priority, supports_rdm) {
+              capability, mode, priority, supports_rdm, max_frame_rate,
+              skipped_frames) {
   }
 };
 
@@ -305,6 +327,33 @@ class OlaUniverse {
   unsigned int m_rdm_device_count;
 };
 
+/**
+ * @brief Changes to the universes, pushed by olad once a client has called
+ * OlaClient::RegisterForUniverseInfo().
+ */
+struct UniverseInfoUpdate {
+  UniverseInfoUpdate() : version(0), full(false) {}
+
+  /**
+   * @brief The version of the universe info this update brings the client
+   * up to.
+   */
+  uint64_t version;
+  /**
+   * @brief True if universes lists every universe, rather than just the
+   * ones that changed.
+   */
+  bool full;
+  /**
+   * @brief The universes that were added or changed.
+   */
+  std::vector<OlaUniverse> universes;
+  /**
+   * @brief The ids of the universes that were removed.
+   */
+  std::vector<unsigned int> removed;
+};
+
 /**
  * @brief Metadata that accompanies DMX packets
  */
@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace client {
@@ -73,6 +74,15 @@ class OlaClient {
    */
   void SetDMXCallback(RepeatableDMXCallback *callback);
 
+  /**
+   * @brief Set the callback to be run when olad pushes a change to the
+   * universes.
+   * @param callback the callback to run, ownership is transferred.
+   *
+   * Call RegisterForUniverseInfo() to start receiving changes.
+   */
+  void SetUniverseInfoCallback(UniverseInfoUpdateCallback *callback);
+
   /**
    * @brief Trigger a plugin reload.
    * @param callback the SetCallback to invoke upon completion.
@@ -175,6 +185,19 @@ class OlaClient {
                                uint8_t value,
                                SetCallback *callback);
 
+  /**
+   * @brief Limit the rate that DMX is written to an output port.
+   * @param device_alias the device containing the port to change
+   * @param port the port id of the output port to change.
+   * @param max_frame_rate the maximum rate in frames per second, or 0 to
+   *   remove the limit.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetPortMaxFrameRate(unsigned int device_alias,
+                           unsigned int port,
+                           unsigned int max_frame_rate,
+                           SetCallback *callback);
+
   /**
    * @brief Request a list of universes.
    * @param callback the UniverseListCallback to invoke upon completion.
@@ -225,6 +248,17 @@ class OlaClient {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Patch or unpatch a list of ports in one request.
+   * @param patches the changes to make, in order.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * The changes are made as a single transaction: if any of them fail, olad
+   * puts back the ports it's already changed and the callback gets an error.
+   */
+  void PatchBatch(const std::vector<PatchBatchEntry> &patches,
+                  SetCallback *callback);
+
   /**
    * @brief Register our interest in a universe.
    *
@@ -238,6 +272,19 @@ class OlaClient {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Register our interest in a universe, with options to limit the
+   * updates sent.
+   * @param universe the id of the universe to register for.
+   * @param register_action the action (register or unregister)
+   * @param args the RegisterArgs to use for this call.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void RegisterUniverse(unsigned int universe,
+                        RegisterAction register_action,
+                        const RegisterArgs &args,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -248,6 +295,16 @@ class OlaClient {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes at once.
+   * @param batch the universes to send.
+   *
+   * The data is streamed to olad in as few messages as possible, without
+   * waiting for an acknowledgement. Versions of olad that predate this method
+   * ignore the data.
+   */
+  void SendDMXBatch(const std::vector<DMXBatchEntry> &batch);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -255,6 +312,25 @@ class OlaClient {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for several universes in one request.
+   * @param universes the universe ids to get data for.
+   * @param callback the DMXBatchCallback to invoke upon completion.
+   */
+  void FetchDMXBatch(const std::vector<unsigned int> &universes,
+                     DMXBatchCallback *callback);
+
+  /**
+   * @brief Register to have changes to the universes pushed to the
+   * UniverseInfoUpdateCallback.
+   * @param register_action the action (register or unregister)
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * The first update after registering lists every universe.
+   */
+  void RegisterForUniverseInfo(RegisterAction register_action,
+                               SetCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
@@ -308,6 +384,17 @@ class OlaClient {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send a list of RDM Get and Set Commands.
+   * @param requests the requests to send. The callback for each request is
+   *   run once it completes.
+   *
+   * This avoids waiting a full round trip between each request. The requests
+   * are sent to olad in batches; the callbacks for a batch are run once all
+   * of the requests in it have completed.
+   */
+  void RDMBatch(const std::vector<RDMBatchEntry> &requests);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
@@ -316,6 +403,24 @@ class OlaClient {
   void SendTimeCode(const ola::timecode::TimeCode &timecode,
                     SetCallback *callback);
 
+  /**
+   * @brief Start olad's timecode generator.
+   * @param start The first frame, olad counts the frames from this until
+   *   StopTimeCode() is called.
+   * @param callback the SetCallback to invoke when the request completes.
+   *
+   * This avoids sending a request for each frame, and the frames are timed
+   * inside olad.
+   */
+  void RunTimeCode(const ola::timecode::TimeCode &start,
+                   SetCallback *callback);
+
+  /**
+   * @brief Stop olad's timecode generator.
+   * @param callback the SetCallback to invoke when the request completes.
+   */
+  void StopTimeCode(SetCallback *callback);
+
  private:
   std::auto_ptr<class OlaClientCore> m_core;
 
@@ -25,13 +25,19 @@
 #ifndef INCLUDE_OLA_CLIENT_STREAMINGCLIENT_H_
 #define INCLUDE_OLA_CLIENT_STREAMINGCLIENT_H_
 
+#include <stdint.h>
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
 #include <ola/dmx/SourcePriorities.h>
+#include <ola/thread/Mutex.h>
+#include <map>
+#include <vector>
 
 namespace ola {
 
+namespace dmx { class DmxSharedMemory; }
 namespace io { class SelectServer; }
 namespace network { class TCPSocket; }
 namespace proto { class OlaServerService_Stub; }
@@ -39,6 +45,7 @@ namespace rpc {
 class RpcChannel;
 class RpcSession;
 }
+namespace thread { class Thread; }
 
 namespace client {
 
@@ -88,6 +95,61 @@ class StreamingClientInterface {
  */
 class StreamingClient : public StreamingClientInterface {
  public:
+  /**
+   * @brief The data for one universe in a batch.
+   */
+  class BatchEntry {
+   public:
+    BatchEntry()
+        : universe(0),
+          priority(ola::dmx::SOURCE_PRIORITY_DEFAULT) {
+    }
+
+    BatchEntry(unsigned int universe, const DmxBuffer &data,
+               uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT)
+        : universe(universe),
+          priority(priority),
+          data(data) {
+    }
+
+    unsigned int universe;  ///< the universe to send to
+    uint8_t priority;  ///< the priority of the data
+    DmxBuffer data;  ///< the DMX512 data
+  };
+
+  typedef std::vector<BatchEntry> DmxBatch;
+
+  /**
+   * @brief What to do in async mode when a frame arrives for a universe that
+   * already has a frame waiting to be sent.
+   */
+  enum DropPolicy {
+    DROP_OLDEST,  ///< the new frame replaces the waiting one
+    DROP_NEWEST  ///< the new frame is discarded
+  };
+
+  /**
+   * @brief The counters for async mode.
+   */
+  class AsyncStats {
+   public:
+    AsyncStats()
+        : frames_queued(0),
+          frames_sent(0),
+          frames_dropped(0),
+          max_send_latency_us(0),
+          total_send_latency_us(0) {
+    }
+
+    uint64_t frames_queued;  ///< frames passed to the SendDmx methods
+    uint64_t frames_sent;  ///< frames written to olad
+    uint64_t frames_dropped;  ///< frames discarded by the DropPolicy
+    /// the longest time between a frame being queued and being written
+    uint64_t max_send_latency_us;
+    /// the sum of the latencies of all the frames sent
+    uint64_t total_send_latency_us;
+  };
+
   /**
    * Controls the options for the StreamingClient class.
    */
@@ -97,7 +159,13 @@ class StreamingClient : public StreamingClientInterface {
      * Create a new options structure with the default options. This
      * includes automatically starting olad if it's not already running.
      */
-    Options() : auto_start(true), server_port(OLA_DEFAULT_PORT) {}
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT),
+          shared_memory_slots(0),
+          async(false),
+          drop_policy(DROP_OLDEST) {
+    }
 
     /**
      * If true, the client will automatically start olad if it's not
@@ -109,6 +177,29 @@ class StreamingClient : public StreamingClientInterface {
      * The RPC port olad is listening on.
      */
     uint16_t server_port;
+
+    /**
+     * If non-zero, DMX data for up to this many universes is passed to olad
+     * through shared memory rather than as a message per frame. This only
+     * works when olad is on the same host and running as the same user, if
+     * it can't be used the client falls back to sending messages. The
+     * default, 0, disables shared memory.
+     */
+    unsigned int shared_memory_slots;
+
+    /**
+     * If true, frames are written to olad by a separate thread and the
+     * SendDmx methods never block. Each universe holds at most one frame
+     * waiting to be sent, if olad falls behind frames are dropped according
+     * to drop_policy. The SendDmx methods then only return false once the
+     * I/O thread has seen the connection close.
+     */
+    bool async;
+
+    /**
+     * Which frame to drop in async mode, see DropPolicy.
+     */
+    DropPolicy drop_policy;
   };
 
   /**
@@ -164,9 +255,35 @@ class StreamingClient : public StreamingClientInterface {
                const DmxBuffer &data,
                const SendArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes at once.
+   * @param batch the universes to send.
+   * @returns true if sent sucessfully, false if the connection to the server
+   *   has been closed.
+   *
+   * This is cheaper than calling SendDMX() for each universe, since the data
+   * is sent to olad in as few messages as possible. Versions of olad that
+   * predate this method ignore the data.
+   */
+  bool SendDmxBatch(const DmxBatch &batch);
+
+  /**
+   * @brief The counters for async mode.
+   * @returns a copy of the counters, they're reset by Setup().
+   */
+  AsyncStats GetAsyncStats() const;
+
   void ChannelClosed(ola::rpc::RpcSession *session);
 
  private:
+  struct PendingFrame {
+    uint8_t priority;
+    DmxBuffer data;
+    ola::TimeStamp queued;
+  };
+
+  typedef std::map<unsigned int, PendingFrame> Mailbox;
+
   bool m_auto_start;
   uint16_t m_server_port;
   ola::network::TCPSocket *m_socket;
@@ -174,8 +291,42 @@ class StreamingClient : public StreamingClientInterface {
   class ola::rpc::RpcChannel *m_channel;
   class ola::proto::OlaServerService_Stub *m_stub;
   bool m_socket_closed;
+  unsigned int m_shared_memory_slots;
+  ola::dmx::DmxSharedMemory *m_shared_memory;
+  std::map<unsigned int, unsigned int> m_universe_slots;
+
+  // Async mode. m_mutex protects everything the caller and the I/O thread
+  // share: the mailbox, the stats and m_socket_closed.
+  const bool m_async;
+  const DropPolicy m_drop_policy;
+  ola::thread::Thread *m_send_thread;
+  ola::Clock m_clock;
+  mutable ola::thread::Mutex m_mutex;
+  Mailbox m_mailbox;
+  bool m_drain_scheduled;
+  AsyncStats m_async_stats;
 
+  bool CheckConnection();
+  void SetupSharedMemory();
+  bool SendSharedMemory(unsigned int universe, uint8_t priority,
+                        const DmxBuffer &data);
   bool Send(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+  void SendFrame(unsigned int universe, uint8_t priority,
+                 const DmxBuffer &data);
+  bool IsClosed();
+  void QueueFrame(unsigned int universe, uint8_t priority,
+                  const DmxBuffer &data);
+  void ScheduleDrain();
+  void DrainMailbox();
+  void StopSendThread();
+
+  // The most universes sent in one StreamDmxDataBatch message, this keeps
+  // the message well below RpcChannel::MAX_BUFFER_SIZE.
+  static const unsigned int MAX_BATCH_SIZE = 1024;
+
+  // How long the I/O thread waits before retrying once the RPC channel is
+  // congested.
+  static const unsigned int CONGESTED_RETRY_MS = 5;
 
   DISALLOW_COPY_AND_ASSIGN(StreamingClient);
 };
@@ -0,0 +1,275 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadedClient.h
+ * An OLA client that can be used from many threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file
+ * @brief An OLA client that can be used from many threads.
+ */
+
+#ifndef INCLUDE_OLA_CLIENT_THREADEDCLIENT_H_
+#define INCLUDE_OLA_CLIENT_THREADEDCLIENT_H_
+
+#include <stdint.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/client/CallbackTypes.h>
+#include <ola/client/ClientArgs.h>
+#include <ola/client/Result.h>
+#include <ola/dmx/SourcePriorities.h>
+#include <ola/rdm/UID.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/MPSCQueue.h>
+#include <ola/thread/TripleBuffer.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ola {
+
+namespace io { class SelectServer; }
+namespace network { class TCPSocket; }
+namespace thread { class Thread; }
+
+namespace client {
+
+class OlaClient;
+
+/**
+ * @class ThreadedClient ola/client/ThreadedClient.h
+ * @brief Send DMX512 data and RDM requests to olad from any thread.
+ *
+ * OlaClient must only be used from the thread running its SelectServer.
+ * ThreadedClient runs an OlaClient in its own I/O thread and accepts DMX and
+ * RDM requests from any other thread, without locks:
+ *  - Each universe has a mailbox holding the latest frame. SendDmx() copies
+ *    the frame into the mailbox and, if the universe wasn't already waiting,
+ *    adds it to a lock-free queue for the I/O thread. Frames that arrive
+ *    faster than olad accepts them replace the waiting frame. All the
+ *    universes that changed are sent together with OlaClient::SendDMXBatch().
+ *  - RDM requests are pushed onto a second lock-free queue and sent with
+ *    OlaClient::RDMBatch().
+ *
+ * The mailboxes are created by the constructor, from Options::universes, so
+ * finding one never changes the map. Threads sending to different universes
+ * never touch the same memory, apart from the queue head when a universe
+ * first changes.
+ *
+ * @code
+ *   ThreadedClient::Options options;
+ *   options.universes.push_back(1);
+ *   options.universes.push_back(2);
+ *   ThreadedClient client(options);
+ *   client.Setup();
+ *
+ *   // From any thread
+ *   client.SendDmx(1, buffer);
+ * @endcode
+ */
+class ThreadedClient {
+ public:
+  /**
+   * The options for the ThreadedClient class.
+   */
+  class Options {
+   public:
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT),
+          executor(NULL) {
+    }
+
+    /**
+     * If true, the client will automatically start olad if it's not
+     * already running.
+     */
+    bool auto_start;
+
+    /**
+     * The RPC port olad is listening on.
+     */
+    uint16_t server_port;
+
+    /**
+     * The universes that SendDmx() can be used with.
+     */
+    std::vector<unsigned int> universes;
+
+    /**
+     * The executor to run the RDM callbacks on. Its Execute() method is
+     * called from the I/O thread, so it must be thread safe, like
+     * SelectServer::Execute(). If NULL the callbacks are run in the I/O
+     * thread, where they must not block.
+     */
+    ola::thread::ExecutorInterface *executor;
+  };
+
+  /**
+   * @brief Create a new ThreadedClient.
+   * @param options an Options structure.
+   */
+  explicit ThreadedClient(const Options &options);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~ThreadedClient();
+
+  /**
+   * @brief Connect to olad and start the I/O thread.
+   * @returns true if the client started, false if there was a failure.
+   *
+   * This, Stop() and the destructor must be called from the same thread.
+   */
+  bool Setup();
+
+  /**
+   * @brief Stop the I/O thread and close the connection to olad.
+   *
+   * Any RDM requests that haven't been sent have their callbacks run, with a
+   * failed Result and RDM_FAILED_TO_SEND. Other threads must have stopped
+   * using the client before this is called.
+   */
+  void Stop();
+
+  /**
+   * @brief Send DMX512 data. This may be called from any thread.
+   * @param universe the universe to send to, this must be one of the
+   *   universes in Options::universes.
+   * @param data the DMX512 data.
+   * @param priority the priority of the data.
+   * @returns true if the frame was queued, false if the universe is unknown,
+   *   the client isn't running or another thread is sending to the same
+   *   universe at this moment.
+   *
+   * Each universe should be written by one thread at a time. A second
+   * thread that writes the same universe concurrently has its frame
+   * discarded rather than waiting.
+   */
+  bool SendDmx(unsigned int universe,
+               const DmxBuffer &data,
+               uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT);
+
+  /**
+   * @brief Send an RDM Get Command. This may be called from any thread.
+   * @param universe the universe to send the command on.
+   * @param uid the UID to send the command to.
+   * @param sub_device the sub device index.
+   * @param pid the PID to address.
+   * @param data the optional data to send, this is copied.
+   * @param data_length the length of the data.
+   * @param callback the callback to run when the request completes. It's run
+   *   on Options::executor.
+   */
+  void RDMGet(unsigned int universe,
+              const ola::rdm::UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data,
+              unsigned int data_length,
+              RDMCallback *callback);
+
+  /**
+   * @brief Send an RDM Set Command. This may be called from any thread.
+   * @param universe the universe to send the command on.
+   * @param uid the UID to send the command to.
+   * @param sub_device the sub device index.
+   * @param pid the PID to address.
+   * @param data the optional data to send, this is copied.
+   * @param data_length the length of the data.
+   * @param callback the callback to run when the request completes. It's run
+   *   on Options::executor.
+   */
+  void RDMSet(unsigned int universe,
+              const ola::rdm::UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data,
+              unsigned int data_length,
+              RDMCallback *callback);
+
+  /**
+   * @brief Check if the connection to olad is open. This may be called from
+   *   any thread.
+   */
+  bool IsConnected() const;
+
+  /**
+   * @brief The number of frames that replaced one that was waiting to be
+   *   sent. This may be called from any thread.
+   */
+  uint64_t FramesDropped() const;
+
+ private:
+  struct Frame {
+    Frame() : priority(ola::dmx::SOURCE_PRIORITY_DEFAULT) {}
+
+    DmxBuffer data;
+    uint8_t priority;
+  };
+
+  struct Mailbox {
+    explicit Mailbox(unsigned int universe)
+        : universe(universe),
+          writing(0),
+          queued(0) {
+    }
+
+    const unsigned int universe;
+    ola::thread::TripleBuffer<Frame> frames;
+    int writing;  // set while a thread is filling the write slot, atomic
+    int queued;  // set while the mailbox is in m_dirty, atomic
+  };
+
+  typedef std::map<unsigned int, Mailbox*> MailboxMap;
+
+  const Options m_options;
+  MailboxMap m_mailboxes;
+  std::auto_ptr<ola::io::SelectServer> m_ss;
+  std::auto_ptr<ola::network::TCPSocket> m_socket;
+  std::auto_ptr<OlaClient> m_client;
+  ola::thread::Thread *m_thread;
+  ola::thread::MPSCQueue<Mailbox*> m_dirty;
+  ola::thread::MPSCQueue<RDMBatchEntry*> m_rdm_requests;
+  int m_connected;  // atomic
+  uint64_t m_frames_dropped;  // atomic
+
+  void QueueRDM(unsigned int universe, const ola::rdm::UID &uid,
+                uint16_t sub_device, uint16_t pid, bool is_set,
+                const uint8_t *data, unsigned int data_length,
+                RDMCallback *callback);
+  void Wake();
+  void Flush();
+  void SendPendingDmx();
+  void SendPendingRDM();
+  void Closed();
+  void Cleanup();
+  void RDMComplete(RDMCallback *callback,
+                   const Result &result,
+                   const RDMMetadata &metadata,
+                   const ola::rdm::RDMResponse *response);
+
+  static const char NOT_CONNECTED[];
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadedClient);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // INCLUDE_OLA_CLIENT_THREADEDCLIENT_H_
@@ -0,0 +1,192 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxOutputMultiplexer.h
+ * Drive several host generated DMX outputs from one thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file DmxOutputMultiplexer.h
+ * @brief Drive several host generated DMX outputs from one thread.
+ */
+
+#ifndef INCLUDE_OLA_DMX_DMXOUTPUTMULTIPLEXER_H_
+#define INCLUDE_OLA_DMX_DMXOUTPUTMULTIPLEXER_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/dmx/FrameTimer.h>
+#include <ola/dmx/SharedDmxFrame.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Runs the break, MAB and data of many DMX outputs on one thread.
+ *
+ * Outputs like the FTDI and UART plugins normally have a thread each, which
+ * spends almost all of its time asleep. This runs the same sequence for any
+ * number of outputs, always stepping the output with the earliest deadline.
+ * While one output is in its break, the others can send data.
+ *
+ * Each output has its own FrameTimer, so the refresh rate and jitter of each
+ * one is still measured and exported.
+ */
+class DmxOutputMultiplexer : public ola::thread::Thread {
+ public:
+  /**
+   * @brief The interface to a line the host generates DMX on.
+   */
+  class Output {
+   public:
+    virtual ~Output() {}
+
+    /**
+     * @brief The name to use for the stats.
+     */
+    virtual std::string Description() const = 0;
+
+    /**
+     * @brief Turn the break condition on or off.
+     * @returns true if it succeeded, false otherwise.
+     */
+    virtual bool SetBreak(bool on) = 0;
+
+    /**
+     * @brief Send the start code and slots.
+     * @returns true if it succeeded, false otherwise.
+     */
+    virtual bool Write(const DmxBuffer &data) = 0;
+  };
+
+  /**
+   * @brief The timing to use for an output.
+   */
+  struct Timing {
+    Timing()
+        : break_time(DMX_BREAK),
+          mab_time(DMX_MAB),
+          mark_after_frame(0),
+          frame_rate(0) {
+    }
+
+    unsigned int break_time;  // in us
+    unsigned int mab_time;  // in us
+    unsigned int mark_after_frame;  // the minimum time between frames, in us
+    unsigned int frame_rate;  // frames per second, 0 for as fast as possible
+  };
+
+  /**
+   * @brief Create a new DmxOutputMultiplexer.
+   * @param realtime true to run the thread with real time scheduling.
+   * @param export_map the ExportMap to use for the stats, may be NULL.
+   *   Ownership is not transferred.
+   */
+  explicit DmxOutputMultiplexer(bool realtime = false,
+                                ExportMap *export_map = NULL);
+  ~DmxOutputMultiplexer();
+
+  /**
+   * @brief Start driving an output.
+   * @param output the Output to add, ownership is not transferred.
+   * @param timing the timing to use for this output.
+   */
+  void AddOutput(Output *output, const Timing &timing);
+
+  /**
+   * @brief Stop driving an output.
+   *
+   * Once this returns the Output is no longer used and may be deleted.
+   * @param output the Output to remove.
+   */
+  void RemoveOutput(Output *output);
+
+  /**
+   * @brief The number of outputs being driven.
+   */
+  unsigned int OutputCount();
+
+  /**
+   * @brief Set the data for an output.
+   * @param output the Output to update.
+   * @param buffer the new data.
+   * @returns true if the output exists, false otherwise.
+   */
+  bool WriteDMX(Output *output, const DmxBuffer &buffer);
+
+  bool Stop();
+  void *Run();
+
+  /**
+   * @brief The default break time, in microseconds.
+   */
+  static const unsigned int DMX_BREAK = 110;
+
+  /**
+   * @brief The default mark after break time, in microseconds.
+   */
+  static const unsigned int DMX_MAB = 16;
+
+ private:
+  enum Step { BREAK, MARK_AFTER_BREAK, DATA };
+
+  struct OutputState {
+    OutputState(Output *output, const Timing &timing,
+                ExportMap *export_map);
+    ~OutputState();
+
+    Output *output;
+    const Timing timing;
+    FrameTimer *timer;
+    Step step;
+    int64_t deadline;  // when the next step is due, from FrameTimer::Now()
+    int64_t frame_deadline;  // when the current frame was due
+    SharedDmxFrame pending;  // protected by m_frame_mutex
+    SharedDmxFrame frame;
+    DmxBuffer buffer;
+  };
+
+  typedef std::vector<OutputState*> OutputList;
+
+  const bool m_realtime;
+  ExportMap *m_export_map;
+  bool m_term;
+  // Adding or removing an output needs both locks. The thread holds
+  // m_output_mutex while it's stepping an output, WriteDMX() only needs
+  // m_frame_mutex.
+  OutputList m_outputs;
+  ola::thread::Mutex m_term_mutex;
+  ola::thread::Mutex m_output_mutex;
+  ola::thread::Mutex m_frame_mutex;
+
+  OutputState *NextOutput();
+  void RunStep(OutputState *state);
+  void EndFrame(OutputState *state);
+
+  // The longest we sleep before checking for new outputs or Stop().
+  static const int64_t MAX_SLEEP = 100000000;  // in ns
+
+  DISALLOW_COPY_AND_ASSIGN(DmxOutputMultiplexer);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_DMXOUTPUTMULTIPLEXER_H_
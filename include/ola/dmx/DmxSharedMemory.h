@@ -0,0 +1,164 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxSharedMemory.h
+ * DMX frames passed between processes through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file DmxSharedMemory.h
+ * @brief DMX frames passed between processes through shared memory.
+ */
+
+#ifndef INCLUDE_OLA_DMX_DMXSHAREDMEMORY_H_
+#define INCLUDE_OLA_DMX_DMXSHAREDMEMORY_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A POSIX shared memory segment holding the latest frame for a number
+ * of universes.
+ *
+ * The segment has a slot per universe. Each slot is protected by a sequence
+ * counter, which is odd while the writer is updating it, so the reader can
+ * detect both new and half written frames without any locks. There's a
+ * single writer (the client) and a single reader (olad).
+ *
+ * The segment also holds a doorbell flag. The writer sets it after updating
+ * one or more slots, and only needs to notify the reader if it wasn't
+ * already set. The reader clears the doorbell before it scans the slots, so
+ * no updates are missed.
+ */
+class DmxSharedMemory {
+ public:
+  ~DmxSharedMemory();
+
+  /**
+   * @brief Create a new segment, for the writer.
+   * @param name the name of the segment, this should start with a /.
+   * @param slot_count the number of universes the segment can hold.
+   * @returns a new DmxSharedMemory or NULL if the segment couldn't be created.
+   *
+   * The segment can be unlinked with Unlink() once the reader has opened it.
+   */
+  static DmxSharedMemory *Create(const std::string &name,
+                                 unsigned int slot_count);
+
+  /**
+   * @brief Open an existing segment, for the reader.
+   * @param name the name of the segment.
+   * @returns a new DmxSharedMemory or NULL if the segment couldn't be opened
+   *   or isn't valid.
+   */
+  static DmxSharedMemory *Open(const std::string &name);
+
+  /**
+   * @brief The name of the segment.
+   */
+  const std::string &Name() const { return m_name; }
+
+  /**
+   * @brief The number of slots in the segment.
+   */
+  unsigned int SlotCount() const { return m_slot_count; }
+
+  /**
+   * @brief Remove the name of the segment, the memory remains valid until
+   * both sides have unmapped it.
+   */
+  void Unlink();
+
+  /**
+   * @brief Write a frame to a slot.
+   * @param slot the slot to write to.
+   * @param universe the universe the frame is for.
+   * @param priority the priority of the frame.
+   * @param data the frame.
+   * @returns false if the slot is out of range.
+   */
+  bool Write(unsigned int slot, unsigned int universe, uint8_t priority,
+             const DmxBuffer &data);
+
+  /**
+   * @brief Read a slot, if it's changed since the last call to Read().
+   * @param slot the slot to read.
+   * @param[out] universe the universe the frame is for.
+   * @param[out] priority the priority of the frame.
+   * @param[out] data the frame.
+   * @returns true if a new frame was read, false if the slot hasn't changed or
+   *   the writer was in the middle of updating it.
+   */
+  bool Read(unsigned int slot, unsigned int *universe, uint8_t *priority,
+            DmxBuffer *data);
+
+  /**
+   * @brief Set the doorbell.
+   * @returns true if the doorbell wasn't already set, in which case the
+   *   reader needs to be notified.
+   */
+  bool RingDoorbell();
+
+  /**
+   * @brief Clear the doorbell, this should be called before the slots are
+   * read.
+   */
+  void ClearDoorbell();
+
+  /**
+   * @brief Returns true if the name is one we'd create. Readers use this to
+   * avoid opening arbitrary segments.
+   */
+  static bool IsValidName(const std::string &name);
+
+  /**
+   * @brief The prefix used for segment names.
+   */
+  static const char NAME_PREFIX[];
+
+  /**
+   * @brief The largest number of slots a segment can have.
+   */
+  static const unsigned int MAX_SLOTS = 4096;
+
+ private:
+  struct Header;
+  struct Slot;
+
+  const std::string m_name;
+  void *m_memory;
+  const size_t m_size;
+  const unsigned int m_slot_count;
+  Header *m_header;
+  Slot *m_slots;
+  std::vector<uint32_t> m_last_read;
+
+  DmxSharedMemory(const std::string &name, void *memory, size_t size,
+                  unsigned int slot_count);
+
+  static size_t SegmentSize(unsigned int slot_count);
+
+  DISALLOW_COPY_AND_ASSIGN(DmxSharedMemory);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_DMXSHAREDMEMORY_H_
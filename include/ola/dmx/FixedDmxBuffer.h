@@ -0,0 +1,302 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FixedDmxBuffer.h
+ * A DMX buffer with inline storage.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file FixedDmxBuffer.h
+ * @brief A DMX buffer with inline storage for a fixed number of slots.
+ */
+
+#ifndef INCLUDE_OLA_DMX_FIXEDDMXBUFFER_H_
+#define INCLUDE_OLA_DMX_FIXEDDMXBUFFER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <algorithm>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Holds up to N slots of DMX data, without allocating.
+ *
+ * DmxBuffer allocates its data from the heap and shares it between copies.
+ * That's the right choice for buffers that are passed around, but for a
+ * buffer that lives on the stack or inside another object, such as a
+ * scratch frame in an output thread, FixedDmxBuffer avoids the allocation
+ * and the reference count altogether. Copies always copy the data.
+ *
+ * The methods behave like the DmxBuffer methods with the same names, with N
+ * in place of DMX_UNIVERSE_SIZE. Use Set(const DmxBuffer&) and CopyTo() to
+ * move data between the two. Unlike DmxBuffer, changes aren't tracked.
+ *
+ * @tparam N the capacity in slots, between 1 and DMX_UNIVERSE_SIZE.
+ */
+template <unsigned int N = DMX_UNIVERSE_SIZE>
+class FixedDmxBuffer {
+ public:
+  enum { CAPACITY = N };
+
+  /**
+   * @brief Create an empty buffer, Size() == 0.
+   */
+  FixedDmxBuffer() : m_length(0) {}
+
+  /**
+   * @brief Create a buffer from raw data.
+   * @param data the slot data.
+   * @param length the number of slots in data, it's truncated to N.
+   */
+  FixedDmxBuffer(const uint8_t *data, unsigned int length)
+      : m_length(0) {
+    Set(data, length);
+  }
+
+  /**
+   * @brief Create a buffer from a DmxBuffer.
+   * @param buffer the DmxBuffer to copy, it's truncated to N slots.
+   */
+  explicit FixedDmxBuffer(const DmxBuffer &buffer)
+      : m_length(0) {
+    Set(buffer);
+  }
+
+  FixedDmxBuffer(const FixedDmxBuffer &other)
+      : m_length(other.m_length) {
+    memcpy(m_data, other.m_data, m_length);
+  }
+
+  FixedDmxBuffer& operator=(const FixedDmxBuffer &other) {
+    if (this != &other) {
+      m_length = other.m_length;
+      memcpy(m_data, other.m_data, m_length);
+    }
+    return *this;
+  }
+
+  bool operator==(const FixedDmxBuffer &other) const {
+    return Equals(other.m_data, other.m_length);
+  }
+
+  bool operator!=(const FixedDmxBuffer &other) const {
+    return !(*this == other);
+  }
+
+  bool operator==(const DmxBuffer &other) const {
+    return Equals(other.GetRaw(), other.Size());
+  }
+
+  bool operator!=(const DmxBuffer &other) const {
+    return !(*this == other);
+  }
+
+  /**
+   * @brief The number of slots in the buffer.
+   */
+  unsigned int Size() const { return m_length; }
+
+  /**
+   * @brief The maximum number of slots the buffer can hold.
+   */
+  static unsigned int Capacity() { return N; }
+
+  /**
+   * @brief Set the contents of the buffer.
+   * @param data the slot data.
+   * @param length the number of slots in data, it's truncated to N.
+   * @return true if the set was successful, false if data was NULL.
+   */
+  bool Set(const uint8_t *data, unsigned int length) {
+    if (!data) {
+      return false;
+    }
+    m_length = std::min(length, N);
+    memcpy(m_data, data, m_length);
+    return true;
+  }
+
+  /**
+   * @brief Set the contents of the buffer from a DmxBuffer.
+   * @param buffer the DmxBuffer to copy, it's truncated to N slots.
+   */
+  void Set(const DmxBuffer &buffer) {
+    m_length = std::min(buffer.Size(), N);
+    if (m_length) {
+      memcpy(m_data, buffer.GetRaw(), m_length);
+    }
+  }
+
+  /**
+   * @brief Copy the contents of this buffer to a DmxBuffer.
+   * @param buffer the DmxBuffer to set.
+   * @return the result of DmxBuffer::Set().
+   *
+   * An empty FixedDmxBuffer resets the DmxBuffer.
+   */
+  bool CopyTo(DmxBuffer *buffer) const {
+    if (!m_length) {
+      buffer->Reset();
+      return true;
+    }
+    return buffer->Set(m_data, m_length);
+  }
+
+  /**
+   * @brief Set a range of slots, see DmxBuffer::SetRange().
+   * @param offset the first slot to set, this must be <= Size().
+   * @param data the slot data.
+   * @param length the number of slots to set, it's truncated to fit.
+   * @return true if the call was successful, false if it failed.
+   */
+  bool SetRange(unsigned int offset, const uint8_t *data,
+                unsigned int length) {
+    if (!data || offset >= N) {
+      return false;
+    }
+    if (!m_length) {
+      Blackout();
+    }
+    if (offset > m_length) {
+      return false;
+    }
+    unsigned int copy_length = std::min(length, N - offset);
+    memcpy(m_data + offset, data, copy_length);
+    m_length = std::max(m_length, offset + copy_length);
+    return true;
+  }
+
+  /**
+   * @brief Set a range of slots to a single value, see
+   *   DmxBuffer::SetRangeToValue().
+   * @param offset the first slot to set, this must be <= Size().
+   * @param value the value to set the slots to.
+   * @param length the number of slots to set, it's truncated to fit.
+   * @return true if the call was successful, false if it failed.
+   */
+  bool SetRangeToValue(unsigned int offset, uint8_t value,
+                       unsigned int length) {
+    if (offset >= N) {
+      return false;
+    }
+    if (!m_length) {
+      Blackout();
+    }
+    if (offset > m_length) {
+      return false;
+    }
+    unsigned int copy_length = std::min(length, N - offset);
+    memset(m_data + offset, value, copy_length);
+    m_length = std::max(m_length, offset + copy_length);
+    return true;
+  }
+
+  /**
+   * @brief Set a single slot, see DmxBuffer::SetChannel().
+   * @param channel the slot to set, this must be <= Size().
+   * @param value the value to set.
+   */
+  void SetChannel(unsigned int channel, uint8_t value) {
+    if (channel >= N) {
+      return;
+    }
+    if (!m_length) {
+      Blackout();
+    }
+    if (channel > m_length) {
+      return;
+    }
+    m_data[channel] = value;
+    m_length = std::max(channel + 1, m_length);
+  }
+
+  /**
+   * @brief Get the value of a slot.
+   * @return the value, or 0 if the slot is past the end of the data.
+   */
+  uint8_t Get(unsigned int channel) const {
+    return channel < m_length ? m_data[channel] : 0;
+  }
+
+  /**
+   * @brief Copy a range of slots, see DmxBuffer::GetRange().
+   * @param slot the first slot to copy.
+   * @param data where to copy the slots to.
+   * @param[in,out] length the size of data, set to the number of slots
+   *   copied.
+   */
+  void GetRange(unsigned int slot, uint8_t *data,
+                unsigned int *length) const {
+    if (slot >= m_length) {
+      *length = 0;
+      return;
+    }
+    *length = std::min(*length, m_length - slot);
+    memcpy(data, m_data + slot, *length);
+  }
+
+  /**
+   * @brief A pointer to the slot data.
+   */
+  const uint8_t *GetRaw() const { return m_data; }
+
+  /**
+   * @brief Set all N slots to 0.
+   * @post Size() == N
+   */
+  void Blackout() {
+    memset(m_data, 0, N);
+    m_length = N;
+  }
+
+  /**
+   * @brief Empty the buffer.
+   * @post Size() == 0
+   */
+  void Reset() { m_length = 0; }
+
+ private:
+  STATIC_ASSERT(N > 0 && N <= DMX_UNIVERSE_SIZE);
+
+  uint8_t m_data[N];
+  unsigned int m_length;
+
+  bool Equals(const uint8_t *data, unsigned int length) const {
+    return m_length == length &&
+           (!m_length || 0 == memcmp(m_data, data, m_length));
+  }
+};
+
+/**
+ * @brief Compare a DmxBuffer with a FixedDmxBuffer.
+ */
+template <unsigned int N>
+bool operator==(const DmxBuffer &buffer, const FixedDmxBuffer<N> &fixed) {
+  return fixed == buffer;
+}
+
+template <unsigned int N>
+bool operator!=(const DmxBuffer &buffer, const FixedDmxBuffer<N> &fixed) {
+  return fixed != buffer;
+}
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_FIXEDDMXBUFFER_H_
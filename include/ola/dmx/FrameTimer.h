@@ -0,0 +1,181 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.h
+ * Paces the output threads that generate the DMX signal themselves.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file FrameTimer.h
+ * @brief Timing for outputs where the host generates the DMX signal.
+ */
+
+#ifndef INCLUDE_OLA_DMX_FRAMETIMER_H_
+#define INCLUDE_OLA_DMX_FRAMETIMER_H_
+
+#include <stdint.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <string>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Times the break, mark after break and frames of a DMX output.
+ *
+ * This is used by outputs like the FTDI and UART plugins, where there is no
+ * microcontroller and the host has to produce the DMX timing itself.
+ *
+ * All sleeps are to an absolute deadline on the monotonic clock, using
+ * clock_nanosleep() where it's available. Frame deadlines are a fixed period
+ * apart, so the time spent sending a frame doesn't change the refresh rate. If
+ * we fall more than a frame behind, the schedule restarts from the current
+ * time rather than sending a burst of frames to catch up.
+ *
+ * The timer measures the refresh rate, and how late each frame started
+ * compared to its deadline. If an ExportMap is provided these are exported
+ * once a second.
+ *
+ * A FrameTimer should only be used from one thread.
+ */
+class FrameTimer {
+ public:
+  /**
+   * @brief Create a new FrameTimer.
+   * @param frame_rate the frames per second, or 0 to start each frame as
+   *   soon as the previous one is done.
+   * @param export_map the ExportMap to use for the stats, may be NULL.
+   *   Ownership is not transferred.
+   * @param name the key to use for the stats, usually the port description.
+   */
+  explicit FrameTimer(unsigned int frame_rate = 0,
+                      ExportMap *export_map = NULL,
+                      const std::string &name = "");
+
+  /**
+   * @brief Mark the start of a frame.
+   *
+   * This should be called once per frame, before the break.
+   */
+  void StartFrame();
+
+  /**
+   * @brief Sleep for a period, e.g. the break or mark after break.
+   * @param usec the time to sleep in microseconds.
+   */
+  void Delay(unsigned int usec);
+
+  /**
+   * @brief Sleep until it's time for the next frame.
+   * @param min_usec the minimum time to sleep for, e.g. the mark after the
+   *   last slot.
+   */
+  void WaitForNextFrame(unsigned int min_usec = 0);
+
+  /**
+   * @brief Work out when the next frame is due, without sleeping.
+   *
+   * This is for callers which interleave several outputs on one thread.
+   * WaitForNextFrame() is the same as calling this, sleeping until the
+   * returned time and then calling RecordStart().
+   * @param min_usec the minimum time until the next frame, e.g. the mark
+   *   after the last slot.
+   * @returns the time the next frame is due, from Now().
+   */
+  int64_t NextFrameTime(unsigned int min_usec = 0);
+
+  /**
+   * @brief Record how late a frame was.
+   * @param deadline the time the frame was due, from NextFrameTime().
+   */
+  void RecordStart(int64_t deadline);
+
+  /**
+   * @brief The measured refresh rate.
+   * @returns the number of frames started in the last full second.
+   */
+  unsigned int FrameRate() const { return m_frame_rate; }
+
+  /**
+   * @brief The number of frames that started within a jitter bucket.
+   * @param bucket the bucket, less than JITTER_BUCKETS.
+   * @returns the number of frames in the bucket.
+   */
+  unsigned int JitterCount(unsigned int bucket) const;
+
+  /**
+   * @brief The upper limit of a jitter bucket.
+   * @param bucket the bucket, less than JITTER_BUCKETS.
+   * @returns the limit in microseconds, or 0 for the last bucket which has no
+   *   limit.
+   */
+  static unsigned int JitterLimit(unsigned int bucket);
+
+  /**
+   * @brief Switch the calling thread to real time (SCHED_FIFO) scheduling.
+   * @returns true if the policy was changed, false otherwise. This usually
+   *   needs extra privileges. A thread which already has a real time policy,
+   *   e.g. from its thread role, keeps it.
+   */
+  static bool UseRealtimeScheduling();
+
+  /**
+   * @brief The current time.
+   * @returns the monotonic time in nanoseconds.
+   */
+  static int64_t Now();
+
+  /**
+   * @brief Sleep until an absolute time.
+   * @param deadline the time to sleep until, from Now().
+   */
+  static void SleepUntil(int64_t deadline);
+
+  /**
+   * @brief The number of jitter buckets.
+   */
+  static const unsigned int JITTER_BUCKETS = 7;
+
+  /**
+   * @brief The name of the exported refresh rate variable.
+   */
+  static const char FPS_VAR[];
+
+  /**
+   * @brief The name of the exported jitter histogram, the keys are
+   *   name/limit.
+   */
+  static const char JITTER_VAR[];
+
+ private:
+  const int64_t m_period;  // in ns
+  int64_t m_deadline;
+  int64_t m_rate_start;
+  unsigned int m_frames;
+  unsigned int m_frame_rate;
+  unsigned int m_jitter[JITTER_BUCKETS];
+  const std::string m_name;
+  UIntMap *m_fps_map;
+  UIntMap *m_jitter_map;
+
+  void UpdateStats(int64_t now);
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTimer);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_FRAMETIMER_H_
@@ -1,4 +1,12 @@
 oladmxincludedir = $(pkgincludedir)/dmx/
 oladmxinclude_HEADERS = \
+    include/ola/dmx/DmxOutputMultiplexer.h \
+    include/ola/dmx/DmxSharedMemory.h \
+    include/ola/dmx/FixedDmxBuffer.h \
+    include/ola/dmx/FrameTimer.h \
+    include/ola/dmx/OutputCurve.h \
+    include/ola/dmx/PixelBuffer.h \
     include/ola/dmx/RunLengthEncoder.h \
-    include/ola/dmx/SourcePriorities.h
+    include/ola/dmx/SharedDmxFrame.h \
+    include/ola/dmx/SourcePriorities.h \
+    include/ola/dmx/UniverseSharedMemory.h
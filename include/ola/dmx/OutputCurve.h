@@ -0,0 +1,201 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OutputCurve.h
+ * Gamma and dimming curves for pixel outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file OutputCurve.h
+ * @brief Apply a gamma / dimming curve, with optional temporal dithering, to
+ * DMX data on its way out.
+ */
+
+#ifndef INCLUDE_OLA_DMX_OUTPUTCURVE_H_
+#define INCLUDE_OLA_DMX_OUTPUTCURVE_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A per-output gamma / dimming curve.
+ *
+ * LEDs respond linearly to the PWM duty cycle but the eye doesn't, so pixel
+ * outputs usually want a gamma curve applied. The curve is computed once,
+ * when the OutputCurve is configured, into 256 entry lookup tables with
+ * both 8 bit and 16 bit results. Applying it is then one table read per
+ * slot.
+ *
+ * With a steep curve many of the low inputs collapse onto the same 8 bit
+ * output. Temporal dithering recovers some of that resolution: the 16 bit
+ * result is truncated to 8 bits and the remainder is carried over to the
+ * same slot in the next frame, so over a few frames the output averages to
+ * the true value. This needs a steady stream of frames to be useful.
+ *
+ * Each output should have its own OutputCurve since the dithering state is
+ * per slot.
+ *
+ * @code
+ *   OutputCurve::Options options;
+ *   options.gamma = 2.2;
+ *   options.dither = true;
+ *   OutputCurve curve(options);
+ *   ...
+ *   curve.Apply(input, &output);
+ * @endcode
+ */
+class OutputCurve {
+ public:
+  struct Options {
+   public:
+    /**
+     * @brief The gamma exponent, 1.0 is linear.
+     */
+    double gamma;
+
+    /**
+     * @brief The maximum output level, as a percentage of full scale.
+     */
+    uint8_t brightness;
+
+    /**
+     * @brief Enable temporal dithering of the 8 bit output.
+     */
+    bool dither;
+
+    Options()
+        : gamma(1.0),
+          brightness(MAX_BRIGHTNESS),
+          dither(false) {
+    }
+  };
+
+  /**
+   * @brief Create a linear OutputCurve.
+   */
+  OutputCurve();
+
+  /**
+   * @brief Create a new OutputCurve.
+   * @param options the Options for the curve.
+   */
+  explicit OutputCurve(const Options &options);
+
+  /**
+   * @brief Rebuild the lookup tables.
+   * @param options the new Options for the curve.
+   *
+   * This resets the dithering state.
+   */
+  void Configure(const Options &options);
+
+  /**
+   * @brief Check if the curve leaves the data unchanged.
+   *
+   * Outputs can use this to skip the transform altogether.
+   */
+  bool IsIdentity() const { return m_identity; }
+
+  /**
+   * @brief The 8 bit output for an input level, without dithering.
+   */
+  uint8_t Value(uint8_t input) const { return m_table[input]; }
+
+  /**
+   * @brief The 16 bit output for an input level.
+   */
+  uint16_t WideValue(uint8_t input) const { return m_wide_table[input]; }
+
+  /**
+   * @brief Evaluate the curve at an arbitrary point.
+   * @param level the input level, from 0.0 to 1.0.
+   * @returns the 16 bit output.
+   *
+   * This is for devices which take a lookup table of their own.
+   */
+  uint16_t Evaluate(double level) const;
+
+  /**
+   * @brief Check if temporal dithering is enabled.
+   */
+  bool Dither() const { return m_dither; }
+
+  /**
+   * @brief Apply the curve to a block of 8 bit data.
+   * @param input the input data.
+   * @param output where to write the result, this may be the same as input.
+   * @param length the number of slots.
+   *
+   * If dithering is enabled each call advances the dithering state, so call
+   * this once per frame.
+   */
+  void Apply(const uint8_t *input, uint8_t *output, unsigned int length);
+
+  /**
+   * @brief Apply the curve to a DmxBuffer.
+   * @param input the input data.
+   * @param output the DmxBuffer to store the result in.
+   */
+  void Apply(const DmxBuffer &input, DmxBuffer *output);
+
+  /**
+   * @brief Apply the curve to a block of data, producing 16 bit values.
+   * @param input the input data.
+   * @param output where to write the result, this must have room for length
+   *   values.
+   * @param length the number of slots.
+   */
+  void ApplyWide(const uint8_t *input, uint16_t *output,
+                 unsigned int length) const;
+
+  /**
+   * @brief Parse a gamma value.
+   * @param value the string to parse, e.g. "2.2".
+   * @param[out] gamma the gamma value.
+   * @returns true if the value was valid, false otherwise.
+   */
+  static bool ParseGamma(const std::string &value, double *gamma);
+
+  static const uint8_t MAX_BRIGHTNESS = 100;
+
+ private:
+  enum { TABLE_SIZE = 256 };
+
+  uint8_t m_table[TABLE_SIZE];
+  // 8.8 fixed point, used for dithering.
+  uint16_t m_fine_table[TABLE_SIZE];
+  uint16_t m_wide_table[TABLE_SIZE];
+  double m_gamma;
+  double m_brightness;
+  bool m_identity;
+  bool m_dither;
+  // The fraction carried forward for each slot.
+  std::vector<uint8_t> m_error;
+
+  static const double MIN_GAMMA;
+  static const double MAX_GAMMA;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputCurve);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_OUTPUTCURVE_H_
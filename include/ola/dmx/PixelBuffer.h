@@ -0,0 +1,188 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PixelBuffer.h
+ * Assemble a pixel frame from several universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file PixelBuffer.h
+ * @brief Assemble the data for a pixel strip which spans several universes.
+ */
+
+#ifndef INCLUDE_OLA_DMX_PIXELBUFFER_H_
+#define INCLUDE_OLA_DMX_PIXELBUFFER_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Assemble a frame for a pixel strip which spans several universes.
+ *
+ * A universe can only hold 170 RGB pixels, so longer strips have to be
+ * driven from a number of consecutive universes. The PixelBuffer divides the
+ * strip into segments, one per universe, and copies each universe's data
+ * into its segment as it arrives.
+ *
+ * Once every segment has been updated the frame is complete and the
+ * callback is run with the data for the entire strip, so it can be sent as
+ * a single transfer. If the remaining universes don't arrive before the
+ * deadline, the frame is sent anyway using the last data for the missing
+ * segments.
+ *
+ * @code
+ *   PixelBuffer::Options options(6);  // 1020 pixels
+ *   PixelBuffer buffer(ss, options, NewCallback(this, &Output::SendFrame));
+ *   ...
+ *   buffer.Update(universe_index, dmx_data);
+ * @endcode
+ */
+class PixelBuffer {
+ public:
+  /**
+   * @brief Called with the assembled frame.
+   * @param data the frame data.
+   * @param length the length of the frame.
+   */
+  typedef ola::Callback2<void, const uint8_t*, unsigned int> FrameCallback;
+
+  struct Options {
+   public:
+    /**
+     * @brief The number of universes that make up the strip.
+     */
+    unsigned int segment_count;
+
+    /**
+     * @brief The number of slots to take from each universe.
+     *
+     * This defaults to 510 so that RGB pixels aren't split across
+     * universes.
+     */
+    unsigned int slots_per_segment;
+
+    /**
+     * @brief How long to wait for the rest of the universes once a frame
+     *   has started.
+     *
+     * Setting this to 0 disables the deadline, so partial frames are never
+     * sent.
+     */
+    TimeInterval deadline;
+
+    explicit Options(unsigned int segment_count = 1)
+        : segment_count(segment_count),
+          slots_per_segment(DEFAULT_SLOTS_PER_SEGMENT),
+          deadline(0, DEFAULT_DEADLINE_US) {
+    }
+  };
+
+  /**
+   * @brief Create a new PixelBuffer.
+   * @param scheduler the scheduler to use for the deadline, may be NULL in
+   *   which case partial frames are never sent.
+   * @param options the Options for the buffer.
+   * @param callback the callback to run when a frame is ready. Ownership is
+   *   transferred.
+   */
+  PixelBuffer(ola::thread::SchedulerInterface *scheduler,
+              const Options &options,
+              FrameCallback *callback);
+
+  /**
+   * @brief Destructor.
+   */
+  ~PixelBuffer();
+
+  /**
+   * @brief Update one segment of the frame.
+   * @param segment the index of the segment, starting from 0.
+   * @param buffer the DMX data for the segment. Data beyond
+   *   slots_per_segment is ignored.
+   * @returns false if the segment index is out of range, true otherwise.
+   *
+   * If this completes the frame, the callback is run before Update()
+   * returns.
+   */
+  bool Update(unsigned int segment, const DmxBuffer &buffer);
+
+  /**
+   * @brief Send the current frame, even if it's incomplete.
+   *
+   * This does nothing if no segments have been updated since the last
+   * frame was sent.
+   */
+  void Flush();
+
+  /**
+   * @brief The number of segments in the frame.
+   */
+  unsigned int SegmentCount() const { return m_segment_count; }
+
+  /**
+   * @brief The number of slots in each segment.
+   */
+  unsigned int SlotsPerSegment() const { return m_slots_per_segment; }
+
+  /**
+   * @brief The size of the frame, this only covers the slots which have
+   *   been set.
+   */
+  unsigned int Size() const { return m_size; }
+
+  /**
+   * @brief The frame data.
+   */
+  const uint8_t *Data() const { return m_size ? &m_data[0] : NULL; }
+
+  /**
+   * @brief The number of frames sent because the deadline expired.
+   */
+  unsigned int PartialFrames() const { return m_partial_frames; }
+
+  static const unsigned int DEFAULT_SLOTS_PER_SEGMENT = 510;
+  static const unsigned int DEFAULT_DEADLINE_US = 25000;
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+  const unsigned int m_segment_count;
+  const unsigned int m_slots_per_segment;
+  const TimeInterval m_deadline;
+  std::vector<uint8_t> m_data;
+  std::vector<bool> m_updated;
+  unsigned int m_updated_count;
+  unsigned int m_size;
+  unsigned int m_partial_frames;
+  ola::thread::timeout_id m_timeout;
+  std::auto_ptr<FrameCallback> m_callback;
+
+  void DeadlineExpired();
+  void SendFrame();
+
+  DISALLOW_COPY_AND_ASSIGN(PixelBuffer);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_PIXELBUFFER_H_
@@ -66,8 +66,23 @@ class RunLengthEncoder {
               unsigned int length,
               DmxBuffer *output);
 
+  /**
+   * @brief The largest encoded size that is worth sending.
+   *
+   * Encoding only helps if the result is smaller than the raw data. Passing
+   * this as the size of the output to Encode() means the encoder gives up as
+   * soon as it can't beat the raw data, in which case the raw data should be
+   * sent instead. This is shared by all the nodes which can send RLE data.
+   * @param raw_size the size of the unencoded data.
+   * @returns the maximum useful size of the encoded data.
+   */
+  static unsigned int MaxUsefulSize(unsigned int raw_size) {
+    return raw_size ? raw_size - 1 : 0;
+  }
+
  private:
   static const uint8_t REPEAT_FLAG = 0x80;
+  static const unsigned int MAX_BLOCK_SIZE = 0x7f;
 };
 }  // namespace dmx
 }  // namespace ola
@@ -0,0 +1,148 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxFrame.h
+ * An immutable DMX frame that can be shared between threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file SharedDmxFrame.h
+ * @brief An immutable, reference counted DMX frame.
+ */
+
+#ifndef INCLUDE_OLA_DMX_SHAREDDMXFRAME_H_
+#define INCLUDE_OLA_DMX_SHAREDDMXFRAME_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+
+namespace ola {
+namespace dmx {
+
+struct DmxBufferBlock;
+
+/**
+ * @brief An immutable DMX frame with an atomic reference count.
+ *
+ * Unlike DmxBuffer, copies of a SharedDmxFrame can be used and destroyed in
+ * different threads. This allows a frame to be handed to an output thread
+ * by taking a reference, rather than copying the data while holding a lock.
+ *
+ * A single SharedDmxFrame object must still not be modified in one thread
+ * while another thread is reading it, the usual pattern is:
+ * @code
+ *   // In the main thread
+ *   SharedDmxFrame frame(buffer);  // copies the data, outside the lock
+ *   {
+ *     MutexLocker locker(&m_mutex);
+ *     m_frame.Swap(&frame);
+ *   }
+ *
+ *   // In the output thread
+ *   SharedDmxFrame frame;
+ *   {
+ *     MutexLocker locker(&m_mutex);
+ *     frame = m_frame;  // takes a reference
+ *   }
+ *   Send(frame.Data(), frame.Size());
+ * @endcode
+ */
+class SharedDmxFrame {
+ public:
+  /**
+   * @brief Create an empty frame, Size() == 0.
+   */
+  SharedDmxFrame();
+
+  /**
+   * @brief Create a frame from the contents of a DmxBuffer.
+   * @param buffer the data to copy.
+   */
+  explicit SharedDmxFrame(const DmxBuffer &buffer);
+
+  /**
+   * @brief Create a frame from raw data.
+   * @param data the data to copy.
+   * @param length the length of the data, this is truncated to
+   *   DMX_UNIVERSE_SIZE.
+   */
+  SharedDmxFrame(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Copy constructor, this takes a reference to the other frame.
+   */
+  SharedDmxFrame(const SharedDmxFrame &other);
+
+  ~SharedDmxFrame();
+
+  /**
+   * @brief Assignment, this takes a reference to the other frame.
+   */
+  SharedDmxFrame& operator=(const SharedDmxFrame &other);
+
+  /**
+   * @brief Exchange the frames held by two objects.
+   * @param other the object to swap with.
+   *
+   * This doesn't change any reference counts, so it's cheap enough to do
+   * while holding a lock.
+   */
+  void Swap(SharedDmxFrame *other);
+
+  /**
+   * @brief The number of slots in the frame.
+   */
+  unsigned int Size() const { return m_length; }
+
+  /**
+   * @brief A pointer to the slot data, or NULL if the frame is empty.
+   */
+  const uint8_t *Data() const;
+
+  /**
+   * @brief Get the value of a slot.
+   * @param slot the slot to return.
+   * @returns the slot value, or 0 if the slot is out of range.
+   */
+  uint8_t Get(unsigned int slot) const;
+
+  /**
+   * @brief Check if two objects refer to the same frame.
+   * @param other the frame to compare with.
+   * @returns true if both objects share the same frame, which means the data
+   *   is identical.
+   */
+  bool IsSameFrame(const SharedDmxFrame &other) const {
+    return m_block == other.m_block;
+  }
+
+  /**
+   * @brief Copy the frame into a DmxBuffer.
+   * @param buffer the DmxBuffer to update. If the frame is empty the buffer
+   *   is Reset().
+   */
+  void CopyTo(DmxBuffer *buffer) const;
+
+ private:
+  DmxBufferBlock *m_block;
+  unsigned int m_length;
+
+  void Init(const uint8_t *data, unsigned int length);
+  void Unref();
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_SHAREDDMXFRAME_H_
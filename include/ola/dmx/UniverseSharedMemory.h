@@ -0,0 +1,192 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UniverseSharedMemory.h
+ * The output of each universe, published through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file UniverseSharedMemory.h
+ * @brief The output of each universe, published through shared memory.
+ */
+
+#ifndef INCLUDE_OLA_DMX_UNIVERSESHAREDMEMORY_H_
+#define INCLUDE_OLA_DMX_UNIVERSESHAREDMEMORY_H_
+
+#include <stdint.h>
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <map>
+#include <string>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A POSIX shared memory segment holding the last frame olad sent for
+ * each universe.
+ *
+ * This lets visualizers and loggers on the same machine follow the output
+ * without registering as a sink client. There's a single writer (olad) and
+ * any number of readers, and the readers never block the writer.
+ *
+ * Each universe has a slot, assigned the first time the universe is written.
+ * Each slot is protected by a sequence counter, which is odd while the
+ * writer is updating it. The segment also has a change counter which is
+ * incremented after every write, so readers can check if anything changed
+ * without scanning the slots. WaitForChange() blocks until the counter
+ * moves, the writer only wakes readers if one is waiting.
+ */
+class UniverseSharedMemory {
+ public:
+  /**
+   * @brief A frame read from a slot.
+   */
+  struct Frame {
+    Frame() : universe(0), priority(0), sequence(0) {}
+
+    /** @brief The universe the frame is for. */
+    unsigned int universe;
+    /** @brief The priority of the frame. */
+    uint8_t priority;
+    /** @brief The sequence number of the slot, this changes with each
+     *    frame. */
+    uint32_t sequence;
+    /** @brief The frame. */
+    DmxBuffer data;
+  };
+
+  ~UniverseSharedMemory();
+
+  /**
+   * @brief Create a new segment, for the writer.
+   * @param name the name of the segment, this should start with a /.
+   * @param slot_count the number of universes the segment can hold.
+   * @returns a new UniverseSharedMemory or NULL if the segment couldn't be
+   *   created.
+   *
+   * Any existing segment with the same name is replaced, since it was left
+   * behind by a writer that didn't exit cleanly.
+   */
+  static UniverseSharedMemory *Create(const std::string &name,
+                                      unsigned int slot_count);
+
+  /**
+   * @brief Open an existing segment, for a reader.
+   * @param name the name of the segment.
+   * @returns a new UniverseSharedMemory or NULL if the segment couldn't be
+   *   opened or isn't valid.
+   */
+  static UniverseSharedMemory *Open(const std::string &name);
+
+  /**
+   * @brief The name of the segment.
+   */
+  const std::string &Name() const { return m_name; }
+
+  /**
+   * @brief The number of slots in the segment.
+   */
+  unsigned int SlotCount() const { return m_slot_count; }
+
+  /**
+   * @brief Remove the name of the segment, the memory remains valid until
+   * all processes have unmapped it.
+   */
+  void Unlink();
+
+  /**
+   * @brief Publish the frame for a universe. This must only be called by the
+   *   writer.
+   * @param universe the universe the frame is for.
+   * @param priority the priority of the frame.
+   * @param data the frame.
+   * @returns false if the universe doesn't have a slot and they're all in
+   *   use.
+   */
+  bool Write(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+
+  /**
+   * @brief Find the slot for a universe.
+   * @param universe the universe to look for.
+   * @returns the slot index, or -1 if the universe hasn't been written.
+   */
+  int FindSlot(unsigned int universe) const;
+
+  /**
+   * @brief Read a slot.
+   * @param slot the slot to read.
+   * @param[out] frame the last frame written to the slot.
+   * @returns true if a frame was read, false if the slot is out of range, is
+   *   unused, or the writer kept updating it while it was being read.
+   */
+  bool Read(unsigned int slot, Frame *frame) const;
+
+  /**
+   * @brief The number of writes to the segment.
+   */
+  uint32_t ChangeCount() const;
+
+  /**
+   * @brief Block until something is written.
+   * @param change_count the value of ChangeCount() the caller has seen.
+   * @param timeout the longest to wait for.
+   * @returns true if ChangeCount() no longer matches change_count.
+   */
+  bool WaitForChange(uint32_t change_count,
+                     const TimeInterval &timeout) const;
+
+  /**
+   * @brief The name olad uses for the segment.
+   */
+  static const char DEFAULT_NAME[];
+
+  /**
+   * @brief The largest number of slots a segment can have.
+   */
+  static const unsigned int MAX_SLOTS = 65536;
+
+ private:
+  struct Header;
+  struct Slot;
+
+  typedef std::map<unsigned int, unsigned int> SlotMap;
+
+  const std::string m_name;
+  void *m_memory;
+  const size_t m_size;
+  const unsigned int m_slot_count;
+  // True for the writer.
+  const bool m_writer;
+  // Readers that could only map the segment read only poll for changes.
+  const bool m_can_wait;
+  Header *m_header;
+  Slot *m_slots;
+  // Only used by the writer.
+  SlotMap m_slot_map;
+  bool m_full_logged;
+
+  UniverseSharedMemory(const std::string &name, void *memory, size_t size,
+                       unsigned int slot_count, bool writer, bool can_wait);
+
+  static size_t SegmentSize(unsigned int slot_count);
+
+  DISALLOW_COPY_AND_ASSIGN(UniverseSharedMemory);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_UNIVERSESHAREDMEMORY_H_
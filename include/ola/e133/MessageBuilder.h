@@ -27,9 +27,19 @@
 #include <ola/e133/E133Enums.h>
 #include <ola/io/IOStack.h>
 #include <ola/io/MemoryBlockPool.h>
+#include <memory>
 #include <string>
 
 namespace ola {
+
+namespace acn {
+class E133HeaderTemplate;
+}  // namespace acn
+
+namespace rdm {
+class RDMCommand;
+}  // namespace rdm
+
 namespace e133 {
 
 using ola::acn::CID;
@@ -38,11 +48,16 @@ using std::string;
 
 /**
  * Provides helper methods for common E1.33 packet construction operations.
+ *
+ * The root layer and E1.33 headers are serialized once when the
+ * MessageBuilder is created, so building a message only copies the headers
+ * and patches the lengths, sequence number and endpoint. The IOStacks should
+ * use pool() so the memory blocks are reused from one message to the next.
  */
 class MessageBuilder {
  public:
     MessageBuilder(const CID &cid, const string &source_name);
-    ~MessageBuilder() {}
+    ~MessageBuilder();
 
     void PrependRDMHeader(IOStack *packet);
 
@@ -62,12 +77,19 @@ class MessageBuilder {
     void BuildUDPRootE133(IOStack *packet, uint32_t vector,
                           uint32_t sequence_number, uint16_t endpoint_id);
 
+    void BuildTCPRDMCommand(IOStack *packet,
+                            const ola::rdm::RDMCommand &command,
+                            uint32_t sequence_number, uint16_t endpoint_id);
+    void BuildUDPRDMCommand(IOStack *packet,
+                            const ola::rdm::RDMCommand &command,
+                            uint32_t sequence_number, uint16_t endpoint_id);
+
     ola::io::MemoryBlockPool *pool() { return &m_memory_pool; }
 
  private:
     const CID m_cid;
-    const string m_source_name;
     ola::io::MemoryBlockPool m_memory_pool;
+    std::auto_ptr<ola::acn::E133HeaderTemplate> m_header_template;
 
     DISALLOW_COPY_AND_ASSIGN(MessageBuilder);
 };
@@ -27,11 +27,13 @@
 #include <ola/io/Descriptor.h>
 #include <ola/io/SelectServer.h>
 #include <ola/thread/Thread.h>
+#include <ola/http/WebSocket.h>
 #include <ola/web/Json.h>
 // 0.4.6 of microhttp doesn't include stdarg so we do it here.
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <ola/win/CleanWinSock2.h>
@@ -45,6 +47,9 @@
 #include <string>
 #include <vector>
 
+// Only declared by versions of microhttpd that support upgrades.
+struct MHD_UpgradeResponseHandle;
+
 namespace ola {
 namespace http {
 
@@ -73,6 +78,15 @@ class HTTPRequest {
   const std::string GetParameter(const std::string &key) const;
   const std::string GetPostParameter(const std::string &key) const;
 
+  /**
+   * @brief The body of a POST that isn't form encoded, e.g.
+   *   application/octet-stream.
+   *
+   * Form encoded bodies are available from GetPostParameter() instead. At
+   * most K_MAX_BODY_SIZE bytes are kept.
+   */
+  const std::string &Body() const { return m_body; }
+
   bool InFlight() const { return m_in_flight; }
   void SetInFlight() { m_in_flight = true; }
 
@@ -84,9 +98,11 @@ class HTTPRequest {
   std::map<std::string, std::string> m_headers;
   std::map<std::string, std::string> m_post_params;
   struct MHD_PostProcessor *m_processor;
+  std::string m_body;
   bool m_in_flight;
 
   static const unsigned int K_POST_BUFFER_SIZE = 1024;
+  static const unsigned int K_MAX_BODY_SIZE = 4096;
 
   DISALLOW_COPY_AND_ASSIGN(HTTPRequest);
 };
@@ -102,6 +118,10 @@ class HTTPResponse {
     m_status_code(MHD_HTTP_OK) {}
 
   void Append(const std::string &data) { m_data.append(data); }
+  /**
+   * @brief The body of the response, so it can be written in place.
+   */
+  std::string *MutableBody() { return &m_data; }
   void SetContentType(const std::string &type);
   void SetHeader(const std::string &key, const std::string &value);
   void SetStatus(unsigned int status) { m_status_code = status; }
@@ -145,6 +165,13 @@ class HTTPServer: public ola::thread::Thread {
  public:
   typedef ola::Callback2<int, const HTTPRequest*, HTTPResponse*>
     BaseHTTPCallback;
+  /**
+   * Run when a WebSocket connection is established. The connection is owned
+   * by the HTTPServer and is valid until its on_close callback runs; the
+   * on_close callback must be set from within this callback.
+   */
+  typedef ola::Callback2<void, const HTTPRequest*, WebSocketConnection*>
+    WebSocketCallback;
 
   struct HTTPServerOptions {
    public:
@@ -177,6 +204,16 @@ class HTTPServer: public ola::thread::Thread {
   // Register a callback handler.
   bool RegisterHandler(const std::string &path, BaseHTTPCallback *handler);
 
+  // Register a WebSocket handler.
+  bool RegisterWebSocketHandler(const std::string &path,
+                                WebSocketCallback *handler);
+  static bool WebSocketsSupported();
+  void StartWebSocket(const HTTPRequest *request,
+                      int fd,
+                      struct MHD_UpgradeResponseHandle *handle,
+                      const char *extra_data,
+                      size_t extra_data_size);
+
   // Register a file handler.
   bool RegisterFile(const std::string &path,
                     const std::string &content_type);
@@ -215,12 +252,31 @@ class HTTPServer: public ola::thread::Thread {
 
   static struct MHD_Response *BuildResponse(void *data, size_t size);
 
+  static bool AcceptsEncoding(const std::string &accept_encoding,
+                              const std::string &encoding);
+
  private :
   typedef struct {
     std::string file_path;
     std::string content_type;
   } static_file_info;
 
+  struct StaticFile {
+   public:
+    StaticFile() : fd(-1), size(0), mtime(0) {}
+
+    int fd;
+    size_t size;
+    time_t mtime;
+  };
+
+  struct PrecompressedEncoding {
+    const char *name;  // The content-coding
+    const char *suffix;  // Appended to the file name
+  };
+
+  static const PrecompressedEncoding PRECOMPRESSED_ENCODINGS[];
+
   struct DescriptorState {
    public:
     explicit DescriptorState(ola::io::UnmanagedFileDescriptor *_descriptor)
@@ -242,22 +298,45 @@ class HTTPServer: public ola::thread::Thread {
 
   typedef std::set<DescriptorState*, Descriptor_lt> SocketSet;
 
+  struct WebSocketState {
+   public:
+    WebSocketState(WebSocketConnection *_connection,
+                   struct MHD_UpgradeResponseHandle *_handle)
+        : connection(_connection), handle(_handle), on_close(NULL) {}
+
+    WebSocketConnection *connection;
+    struct MHD_UpgradeResponseHandle *handle;
+    // The on_close callback set by the WebSocketCallback.
+    ola::SingleUseCallback0<void> *on_close;
+  };
+
   struct MHD_Daemon *m_httpd;
   std::auto_ptr<ola::io::SelectServer> m_select_server;
   SocketSet m_sockets;
 
   std::map<std::string, BaseHTTPCallback*> m_handlers;
   std::map<std::string, static_file_info> m_static_content;
+  std::map<std::string, WebSocketCallback*> m_websocket_handlers;
+  std::set<WebSocketState*> m_websockets;
+  std::vector<WebSocketState*> m_closed_websockets;
   BaseHTTPCallback *m_default_handler;
   unsigned int m_port;
   std::string m_data_dir;
 
   int ServeStaticContent(static_file_info *file_info,
                          HTTPResponse *response);
+  static bool OpenStaticFile(const std::string &path, StaticFile *file);
+  static void CloseStaticFile(StaticFile *file);
+  static struct MHD_Response *StaticFileResponse(StaticFile *file);
 
   void InsertSocket(bool is_readable, bool is_writeable, int fd);
   void FreeSocket(DescriptorState *state);
 
+  int UpgradeToWebSocket(const HTTPRequest *request, HTTPResponse *response);
+  void WebSocketClosed(WebSocketState *state);
+  void FreeClosedWebSockets();
+  void FreeWebSocket(WebSocketState *state);
+
   DISALLOW_COPY_AND_ASSIGN(HTTPServer);
 };
 }  // namespace http
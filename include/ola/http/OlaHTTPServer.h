@@ -76,7 +76,9 @@ class OlaHTTPServer {
                                method));
     }
 
+    void UpdateUptime();
     int DisplayDebug(const HTTPRequest *request, HTTPResponse *response);
+    int DisplayMetrics(const HTTPRequest *request, HTTPResponse *response);
     int DisplayHandlers(const HTTPRequest *request, HTTPResponse *response);
 
     DISALLOW_COPY_AND_ASSIGN(OlaHTTPServer);
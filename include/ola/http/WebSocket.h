@@ -0,0 +1,190 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WebSocket.h
+ * The server side of a WebSocket (RFC 6455) connection.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_HTTP_WEBSOCKET_H_
+#define INCLUDE_OLA_HTTP_WEBSOCKET_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/IOQueue.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+namespace ola {
+namespace http {
+
+/**
+ * @addtogroup http_server
+ * @{
+ * @class WebSocketConnection
+ * @brief The server end of a WebSocket connection.
+ *
+ * This takes over a socket once the HTTP upgrade handshake has completed and
+ * handles the framing from then on. Outgoing messages are queued and written
+ * as the socket becomes writable; once MAX_OUTPUT_BUFFER bytes are queued,
+ * SendQueueFull() returns true and the SetOnDrain() callback is run when the
+ * queue empties, so producers can skip updates for slow clients.
+ * @}
+ */
+class WebSocketConnection {
+ public:
+  typedef ola::Callback1<void, const std::string&> MessageCallback;
+
+  enum CloseStatus {
+    CLOSE_NORMAL = 1000,
+    CLOSE_GOING_AWAY = 1001,
+    CLOSE_PROTOCOL_ERROR = 1002,
+    CLOSE_TOO_BIG = 1009
+  };
+
+  /**
+   * @brief Create a new WebSocketConnection.
+   * @param descriptor the socket, ownership is transferred.
+   * @param ss the SelectServer to use.
+   */
+  WebSocketConnection(ola::io::ConnectedDescriptor *descriptor,
+                      ola::io::SelectServerInterface *ss);
+  ~WebSocketConnection();
+
+  /**
+   * @brief Start reading from the socket.
+   * @param data bytes that were read along with the handshake, may be NULL.
+   * @param length the number of bytes in data.
+   */
+  void Start(const uint8_t *data = NULL, unsigned int length = 0);
+
+  /**
+   * @brief Set the callback run when a text or binary message arrives.
+   * @param callback the callback to run, ownership is transferred.
+   */
+  void SetOnMessage(MessageCallback *callback);
+
+  /**
+   * @brief Set the callback run once the connection has closed.
+   * @param callback the callback to run, ownership is transferred.
+   */
+  void SetOnClose(ola::SingleUseCallback0<void> *callback);
+
+  /**
+   * @brief Take ownership of the on_close callback.
+   */
+  ola::SingleUseCallback0<void> *TransferOnClose() {
+    ola::SingleUseCallback0<void> *on_close = m_on_close;
+    m_on_close = NULL;
+    return on_close;
+  }
+
+  /**
+   * @brief Set the callback run when the output queue empties.
+   * @param callback the callback to run, ownership is transferred.
+   */
+  void SetOnDrain(ola::Callback0<void> *callback);
+
+  bool SendText(const std::string &message);
+  bool SendBinary(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Check if the output queue has reached its limit.
+   */
+  bool SendQueueFull() const;
+
+  /**
+   * @brief Check if the connection is open for sending.
+   */
+  bool IsOpen() const { return m_state == OPEN; }
+
+  /**
+   * @brief Start the closing handshake.
+   * @param status the status code to send to the client.
+   *
+   * The socket is closed once the client replies, or after CLOSE_TIMEOUT_MS.
+   */
+  void Close(CloseStatus status = CLOSE_NORMAL);
+
+  /**
+   * @brief Compute the Sec-WebSocket-Accept value for a handshake.
+   * @param client_key the value of the client's Sec-WebSocket-Key header.
+   * @returns the base64 encoded SHA-1 of the key and the RFC 6455 GUID.
+   */
+  static std::string AcceptKey(const std::string &client_key);
+
+  /**
+   * @brief The most data to queue for a client.
+   */
+  static const unsigned int MAX_OUTPUT_BUFFER = 32768;
+
+  /**
+   * @brief The largest message we'll accept from a client.
+   */
+  static const unsigned int MAX_MESSAGE_SIZE = 65536;
+
+  /**
+   * @brief How long to wait for the client to complete the closing handshake.
+   */
+  static const unsigned int CLOSE_TIMEOUT_MS = 1000;
+
+ private:
+  enum Opcode {
+    OP_CONTINUATION = 0x0,
+    OP_TEXT = 0x1,
+    OP_BINARY = 0x2,
+    OP_CLOSE = 0x8,
+    OP_PING = 0x9,
+    OP_PONG = 0xa
+  };
+
+  enum State {
+    OPEN,
+    CLOSING,  // We've sent a close frame.
+    CLOSED
+  };
+
+  std::auto_ptr<ola::io::ConnectedDescriptor> m_descriptor;
+  ola::io::SelectServerInterface *m_ss;
+  ola::io::IOQueue m_output;
+  std::string m_input;
+  std::string m_message;  // The fragments of the message we're receiving.
+  bool m_in_message;
+  State m_state;
+  bool m_reading;
+  bool m_writing;
+  ola::thread::timeout_id m_close_timeout;
+  std::auto_ptr<MessageCallback> m_on_message;
+  std::auto_ptr<ola::Callback0<void> > m_on_drain;
+  ola::SingleUseCallback0<void> *m_on_close;
+
+  void ReceiveData();
+  void ProcessInput();
+  void HandleFrame(uint8_t opcode, bool fin, const std::string &payload);
+  void SendFrame(uint8_t opcode, const uint8_t *data, unsigned int length);
+  void PerformWrite();
+  void SocketClosed();
+  void CloseTimeout();
+  void Shutdown();
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketConnection);
+};
+}  // namespace http
+}  // namespace ola
+#endif  // INCLUDE_OLA_HTTP_WEBSOCKET_H_
@@ -161,6 +161,22 @@ class ReadFileDescriptor {
    * This is usually called by the SelectServer.
    */
   virtual void PerformRead() = 0;
+
+  /**
+   * @brief Set the name the SelectServer's loop profiler uses for this
+   * descriptor's read callbacks.
+   * @param label the name, this should be set before the descriptor is added
+   *   to the SelectServer.
+   */
+  void SetReadLabel(const std::string &label) { m_read_label = label; }
+
+  /**
+   * @brief The loop profiler name for read callbacks, may be empty.
+   */
+  const std::string &ReadLabel() const { return m_read_label; }
+
+ private:
+  std::string m_read_label;
 };
 
 
@@ -191,6 +207,22 @@ class WriteFileDescriptor {
    * This is usually called by the SelectServer.
    */
   virtual void PerformWrite() = 0;
+
+  /**
+   * @brief Set the name the SelectServer's loop profiler uses for this
+   * descriptor's write callbacks.
+   * @param label the name, this should be set before the descriptor is added
+   *   to the SelectServer.
+   */
+  void SetWriteLabel(const std::string &label) { m_write_label = label; }
+
+  /**
+   * @brief The loop profiler name for write callbacks, may be empty.
+   */
+  const std::string &WriteLabel() const { return m_write_label; }
+
+ private:
+  std::string m_write_label;
 };
 
 
@@ -232,6 +264,15 @@ class BidirectionalFileDescriptor: public ReadFileDescriptor,
     m_on_write = on_write;
   }
 
+  /**
+   * @brief Set the loop profiler name for both read and write callbacks.
+   * @param label the name to use.
+   */
+  void SetLabel(const std::string &label) {
+    SetReadLabel(label);
+    SetWriteLabel(label);
+  }
+
   void PerformRead();
   void PerformWrite();
 
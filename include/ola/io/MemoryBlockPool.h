@@ -22,6 +22,7 @@
 #define INCLUDE_OLA_IO_MEMORYBLOCKPOOL_H_
 
 #include <ola/Logging.h>
+#include <ola/base/Macro.h>
 #include <ola/io/MemoryBlock.h>
 #include <queue>
 
@@ -29,7 +30,8 @@ namespace ola {
 namespace io {
 
 /**
- * @brief MemoryBlockPool. This class is not thread safe.
+ * @brief MemoryBlockPool. This class is not thread safe, see
+ * SharedMemoryBlockPool for one that is.
  * @param block_size the size of blocks to use.
  */
 class MemoryBlockPool {
@@ -38,16 +40,15 @@ class MemoryBlockPool {
         : m_block_size(block_size),
           m_blocks_allocated(0) {
     }
-    ~MemoryBlockPool() {
+    virtual ~MemoryBlockPool() {
       Purge();
     }
 
     // Allocate a new MemoryBlock from the pool. May return NULL if allocation
     // fails.
-    MemoryBlock *Allocate() {
+    virtual MemoryBlock *Allocate() {
       if (m_free_blocks.empty()) {
         uint8_t* data = new uint8_t[m_block_size];
-        OLA_DEBUG << "new block allocated at @" << reinterpret_cast<int*>(data);
         if (data) {
           m_blocks_allocated++;
           return new MemoryBlock(data, m_block_size);
@@ -62,12 +63,12 @@ class MemoryBlockPool {
     }
 
     // Release a MemoryBlock back to the pool.
-    void Release(MemoryBlock *block) {
+    virtual void Release(MemoryBlock *block) {
       m_free_blocks.push(block);
     }
 
     // Returns the number of free blocks in the pool.
-    unsigned int FreeBlocks() const {
+    virtual unsigned int FreeBlocks() const {
       return static_cast<unsigned int>(m_free_blocks.size());
     }
 
@@ -77,7 +78,7 @@ class MemoryBlockPool {
     }
 
     // Delete all but remaining free blocks.
-    void Purge(unsigned int remaining) {
+    virtual void Purge(unsigned int remaining) {
       while (m_free_blocks.size() != remaining) {
         MemoryBlock *block = m_free_blocks.front();
         m_blocks_allocated--;
@@ -86,7 +87,9 @@ class MemoryBlockPool {
       }
     }
 
-    unsigned int BlocksAllocated() const { return m_blocks_allocated; }
+    virtual unsigned int BlocksAllocated() const {
+      return m_blocks_allocated;
+    }
 
     // default to 1k blocks
     static const unsigned int DEFAULT_BLOCK_SIZE = 1024;
@@ -95,6 +98,8 @@ class MemoryBlockPool {
     std::queue<MemoryBlock*> m_free_blocks;
     const unsigned int m_block_size;
     unsigned int m_blocks_allocated;
+
+    DISALLOW_COPY_AND_ASSIGN(MemoryBlockPool);
 };
 }  // namespace io
 }  // namespace ola
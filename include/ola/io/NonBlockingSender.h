@@ -30,6 +30,9 @@
 #ifndef INCLUDE_OLA_IO_NONBLOCKINGSENDER_H_
 #define INCLUDE_OLA_IO_NONBLOCKINGSENDER_H_
 
+#include <deque>
+
+#include <ola/base/Macro.h>
 #include <ola/io/Descriptor.h>
 #include <ola/io/IOQueue.h>
 #include <ola/io/MemoryBlockPool.h>
@@ -52,10 +55,33 @@ namespace io {
  * The internal buffer has a limit on the size. Once the limit is
  * exceeded, calls to SendMessage() will return false. The limit is a soft
  * limit however, a call to SendMessage() may cause the buffer to exceed the
- * internal limit, provided the limit has not already been reached.
+ * internal limit, provided the limit has not already been reached. With the
+ * DROP_OLDEST policy, the oldest unsent messages are discarded instead, so the
+ * latency on a slow connection stays bounded.
+ *
+ * Messages are sent in priority order, so PRIORITY_HIGH messages, like
+ * heartbeats, skip ahead of queued PRIORITY_NORMAL messages. A message is
+ * never interleaved with another one, once the write of a message has started
+ * it's always completed.
  */
 class NonBlockingSender {
  public:
+  /**
+   * @brief The priority of a message.
+   */
+  enum Priority {
+    PRIORITY_HIGH,  /**< Sent before any normal priority messages. */
+    PRIORITY_NORMAL  /**< The default priority. */
+  };
+
+  /**
+   * @brief What to do with new messages once the limit has been reached.
+   */
+  enum OverflowPolicy {
+    REJECT_NEW,  /**< SendMessage() returns false. */
+    DROP_OLDEST  /**< Discard the oldest unsent messages to make space. */
+  };
+
   /**
    * @brief Create a new NonBlockingSender.
    * @param descriptor the ConnectedDescriptor to send on, ownership is not
@@ -83,23 +109,36 @@ class NonBlockingSender {
    */
   bool LimitReached() const;
 
+  /**
+   * @brief Set what happens to messages once the limit has been reached.
+   * @param policy the OverflowPolicy, the default is REJECT_NEW.
+   */
+  void SetOverflowPolicy(OverflowPolicy policy) { m_policy = policy; }
+
+  /**
+   * @brief The number of messages discarded by the DROP_OLDEST policy.
+   */
+  unsigned int DroppedMessages() const { return m_dropped_messages; }
+
   /**
    * @brief Send the contents of an IOStack on the ConnectedDescriptor.
    * @param stack the IOStack to send. All data in this stack will be sent and
    *   the stack will be emptied.
+   * @param priority the priority of the message.
    * @returns true if the contents of the stack were buffered for transmit,
    *   false the limit for this NonBlockingSender had already been reached.
    */
-  bool SendMessage(class IOStack *stack);
+  bool SendMessage(class IOStack *stack, Priority priority = PRIORITY_NORMAL);
 
   /**
    * @brief Send the contents of an IOQueue on the ConnectedDescriptor.
    * @param queue the IOQueue to send. All data in this queue will be sent and
    *   the queue will be emptied.
+   * @param priority the priority of the message.
    * @returns true if the contents of the stack were buffered for transmit,
    *   false the limit for this NonBlockingSender had already been reached.
    */
-  bool SendMessage(IOQueue *queue);
+  bool SendMessage(IOQueue *queue, Priority priority = PRIORITY_NORMAL);
 
   /**
    * @brief The default max internal buffer size.
@@ -113,12 +152,31 @@ class NonBlockingSender {
   static const unsigned int DEFAULT_MAX_BUFFER_SIZE;
 
  private:
+  // The messages of one priority that haven't been passed to the descriptor.
+  struct MessageQueue {
+    explicit MessageQueue(MemoryBlockPool *memory_pool) : data(memory_pool) {}
+
+    IOQueue data;
+    std::deque<unsigned int> sizes;
+  };
+
+  enum { PRIORITY_COUNT = PRIORITY_NORMAL + 1 };
+
   ola::io::ConnectedDescriptor *m_descriptor;
   ola::io::SelectServerInterface *m_ss;
+  // The data being written, messages can't be reordered or dropped once
+  // they're here.
   ola::io::IOQueue m_output_buffer;
+  MessageQueue *m_queues[PRIORITY_COUNT];
+  unsigned int m_queued_size;
   bool m_associated;
   unsigned int m_max_buffer_size;
+  OverflowPolicy m_policy;
+  unsigned int m_dropped_messages;
 
+  bool CanQueue() const;
+  void QueueMessage(Priority priority, unsigned int size);
+  void DropOldest(Priority new_priority);
   void PerformWrite();
   void AssociateIfRequired();
 
@@ -24,13 +24,16 @@
 #include <ola/Callback.h>
 #include <ola/Clock.h>
 #include <ola/ExportMap.h>
+#include <ola/InlineCallback.h>
 #include <ola/io/Descriptor.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/Socket.h>
+#include <ola/thread/MPSCQueue.h>
 #include <ola/thread/Thread.h>
 
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 class SelectServerTest;
@@ -66,6 +69,13 @@ class SelectServer: public SelectServerInterface {
    public:
     Options()
         : force_select(false),
+          use_io_uring(false),
+          use_timing_wheel(false),
+          use_coarse_clock(false),
+          busy_poll_usec(0),
+          edge_triggered_writes(false),
+          loop_cpu(-1),
+          profile_loop(false),
           export_map(NULL),
           clock(NULL) {
     }
@@ -76,6 +86,67 @@ class SelectServer: public SelectServerInterface {
      */
     bool force_select;
 
+    /**
+     * @brief Use io_uring rather than epoll, if the kernel supports it.
+     *
+     * The --use-io-uring flag has the same effect. This is ignored if
+     * force_select is set.
+     */
+    bool use_io_uring;
+
+    /**
+     * @brief Keep timeouts in a hierarchical timing wheel rather than a heap.
+     *
+     * This makes registering and cancelling timeouts O(1), which helps when
+     * there are many timers. The --use-timing-wheel flag has the same effect.
+     */
+    bool use_timing_wheel;
+
+    /**
+     * @brief Use a coarse monotonic clock if a clock isn't provided.
+     *
+     * This is cheaper to read than the default Clock but only has the
+     * resolution of the kernel tick. The --use-coarse-clock flag has the same
+     * effect.
+     */
+    bool use_coarse_clock;
+
+    /**
+     * @brief Trade CPU for latency by busy polling, 0 disables this.
+     *
+     * When non-zero, SO_BUSY_POLL is set to this value on each socket that's
+     * added, and the epoll poller spins for up to this many microseconds
+     * before blocking. Spinning isn't supported by the other pollers. The
+     * --busy-poll-usec flag is used if this is 0.
+     */
+    unsigned int busy_poll_usec;
+
+    /**
+     * @brief Use edge triggered write events with the epoll poller.
+     *
+     * This saves the system calls otherwise made each time a descriptor is
+     * added to or removed from the write set. The --epoll-edge-triggered-writes
+     * flag has the same effect.
+     */
+    bool edge_triggered_writes;
+
+    /**
+     * @brief The CPU to pin the thread calling Run() to, or -1 to leave the
+     * scheduler to decide.
+     */
+    int loop_cpu;
+
+    /**
+     * @brief Time each descriptor and timeout callback.
+     *
+     * The stats are stored in the export map, grouped by the labels set with
+     * ReadFileDescriptor::SetReadLabel(), WriteFileDescriptor::SetWriteLabel()
+     * and the label arguments of RegisterRepeatingTimeout() and
+     * RegisterSingleTimeout(). The --profile-loop flag has the same effect.
+     * This is ignored if there is no export map.
+     */
+    bool profile_loop;
+
     /**
      * @brief The export map to use.
      */
@@ -116,6 +187,15 @@ class SelectServer: public SelectServerInterface {
 
   const TimeStamp *WakeUpTime() const;
 
+  /**
+   * @brief A Clock that returns the time the SelectServer last woke up.
+   *
+   * Within a callback this avoids reading the system clock, at the cost of
+   * the time being slightly stale. Outside of Run() it reads the underlying
+   * Clock. It should only be used from the SelectServer thread.
+   */
+  const Clock *LoopClock() const { return m_loop_clock.get(); }
+
   /**
    * @brief Exit from the Run() loop.
    *
@@ -173,8 +253,55 @@ class SelectServer: public SelectServerInterface {
   ola::thread::timeout_id RegisterSingleTimeout(
       const ola::TimeInterval &interval,
       ola::SingleUseCallback0<void> *callback);
+
+  /**
+   * @brief Register a repeating timeout with a name for the loop profiler.
+   * @param interval the delay between calls.
+   * @param callback the Callback to run, ownership is transferred.
+   * @param label the name used to group the timing stats.
+   * @returns the identifier for this timeout.
+   */
+  ola::thread::timeout_id RegisterRepeatingTimeout(
+      const ola::TimeInterval &interval,
+      ola::Callback0<bool> *callback,
+      const std::string &label);
+
+  /**
+   * @brief Register a single use timeout with a name for the loop profiler.
+   * @param interval the delay before the callback is run.
+   * @param callback the Callback to run, ownership is transferred.
+   * @param label the name used to group the timing stats.
+   * @returns the identifier for this timeout.
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      ola::SingleUseCallback0<void> *callback,
+      const std::string &label);
+
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      const ola::InlineCallback0<void> &callback);
+
+  /**
+   * @brief Register a single use timeout that's stored by value, with a name
+   *   for the loop profiler.
+   * @param interval the delay before the callback is run.
+   * @param callback the callback to run, this is copied.
+   * @param label the name used to group the timing stats.
+   * @returns the identifier for this timeout.
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      const ola::InlineCallback0<void> &callback,
+      const std::string &label);
+
   void RemoveTimeout(ola::thread::timeout_id id);
 
+  ola::thread::timeout_id RegisterPeriodicTask(
+      const ola::TimeInterval &period,
+      ola::Callback0<bool> *callback);
+  void RemovePeriodicTask(ola::thread::timeout_id id);
+
   /**
    * @brief Execute a callback on every event loop.
    * @param callback the Callback to execute. Ownership is transferrred to the
@@ -188,28 +315,48 @@ class SelectServer: public SelectServerInterface {
   void RunInLoop(ola::Callback0<void> *callback);
 
   void Execute(ola::BaseCallback0<void> *callback);
+  void Execute(const ola::InlineCallback0<void> &callback);
 
   void DrainCallbacks();
 
  private:
-  typedef std::vector<ola::BaseCallback0<void>*> Callbacks;
+  struct QueuedCallback {
+    QueuedCallback() : callback(NULL) {}
+
+    // Only one of these is set.
+    ola::BaseCallback0<void> *callback;
+    ola::InlineCallback0<void> inline_callback;
+    TimeStamp queued;  // only set if we have an ExportMap
+  };
+
+  typedef std::vector<QueuedCallback> Callbacks;
   typedef std::set<ola::Callback0<void>*> LoopClosureSet;
 
   ExportMap *m_export_map;
   bool m_terminate, m_is_running;
   TimeInterval m_poll_interval;
+  std::auto_ptr<class LoopProfiler> m_profiler;
   std::auto_ptr<class TimeoutManager> m_timeout_manager;
+  std::auto_ptr<class PeriodicTaskScheduler> m_periodic_tasks;
   std::auto_ptr<class PollerInterface> m_poller;
 
   Clock *m_clock;
   bool m_free_clock;
+  std::auto_ptr<CachedClock> m_loop_clock;
+  unsigned int m_busy_poll_usec;
+  int m_loop_cpu;
   LoopClosureSet m_loop_callbacks;
-  Callbacks m_incoming_callbacks;
-  ola::thread::Mutex m_incoming_mutex;
+  ola::thread::MPSCQueue<QueuedCallback> m_incoming_callbacks;
   LoopbackDescriptor m_incoming_descriptor;
+  CounterVariable *m_execute_count;
+  CounterVariable *m_execute_wake_ups;
+  CounterVariable *m_execute_latency;
+  IntegerVariable *m_execute_max_latency;
+  IntegerVariable *m_execute_max_depth;
 
   void Init(const Options &options);
   bool CheckForEvents(const TimeInterval &poll_interval);
+  void QueueCallback(QueuedCallback *queued_callback);
   void DrainAndExecute();
   void RunCallbacks(Callbacks *callbacks);
   void SetTerminate() { m_terminate = true; }
@@ -219,6 +366,11 @@ class SelectServer: public SelectServerInterface {
   static const unsigned int POLL_INTERVAL_USECOND = 0;
 
   static const TimeStamp empty_time;
+  static const char K_EXECUTE_COUNT_VAR[];
+  static const char K_EXECUTE_WAKE_UP_VAR[];
+  static const char K_EXECUTE_LATENCY_VAR[];
+  static const char K_EXECUTE_MAX_LATENCY_VAR[];
+  static const char K_EXECUTE_MAX_DEPTH_VAR[];
 
   friend class ::SelectServerTest;
 
@@ -114,6 +114,7 @@ class SelectServerInterface: public ola::thread::SchedulingExecutorInterface {
       const ola::TimeInterval &interval,
       ola::Callback0<bool> *closure) = 0;
 
+  using ola::thread::SchedulerInterface::RegisterSingleTimeout;
   virtual ola::thread::timeout_id RegisterSingleTimeout(
       unsigned int ms,
       SingleUseCallback0<void> *closure) = 0;
@@ -77,6 +77,42 @@ bool AcquireUUCPLockAndOpen(const std::string &path, int oflag, int *fd);
  * The lock is only removed if the PID matches.
  */
 void ReleaseUUCPLock(const std::string &path);
+
+/**
+ * @brief Ask the kernel to pass on received data without delay.
+ * @param fd the serial port.
+ * @returns true if ASYNC_LOW_LATENCY was set, false if it isn't supported.
+ *
+ * With the ftdi_sio driver this also drops the latency timer to 1ms.
+ */
+bool SetLowLatency(int fd);
+
+/**
+ * @brief Check if ASYNC_LOW_LATENCY is set on a serial port.
+ * @param fd the serial port.
+ */
+bool IsLowLatency(int fd);
+
+/**
+ * @brief Set the latency timer of an FTDI USB serial adaptor.
+ * @param fd the serial port.
+ * @param latency_ms the latency in ms, from 1 to 255.
+ * @returns true if the timer was set, false if the port isn't an FTDI
+ *   adaptor or the timer couldn't be changed.
+ *
+ * The adaptor holds received data until it has a full USB packet or the
+ * timer expires. The default of 16ms puts a floor under RDM round trips.
+ * The timer is set through sysfs, which is usually only writable by root.
+ */
+bool SetFtdiLatencyTimer(int fd, unsigned int latency_ms);
+
+/**
+ * @brief Get the latency timer of an FTDI USB serial adaptor.
+ * @param fd the serial port.
+ * @param[out] latency_ms the latency in ms.
+ * @returns false if the port isn't an FTDI adaptor.
+ */
+bool GetFtdiLatencyTimer(int fd, unsigned int *latency_ms);
 }  // namespace io
 }  // namespace ola
 #endif  // INCLUDE_OLA_IO_SERIAL_H_
@@ -0,0 +1,184 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryBlockPool.h
+ * A thread safe MemoryBlockPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_IO_SHAREDMEMORYBLOCKPOOL_H_
+#define INCLUDE_OLA_IO_SHAREDMEMORYBLOCKPOOL_H_
+
+#include <pthread.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/io/MemoryBlock.h>
+#include <ola/io/MemoryBlockPool.h>
+#include <ola/thread/Mutex.h>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief A MemoryBlockPool that can be shared between threads.
+ *
+ * Each thread that uses the pool gets its own cache of free blocks, so most
+ * calls to Allocate() and Release() don't take a lock. When a cache is empty
+ * or full, half a cache worth of blocks is moved from or to the shared free
+ * list, which is protected by a mutex.
+ *
+ * The shared free list is capped at max_free_blocks; any blocks released
+ * beyond that are deleted. PurgeIdle() should be called periodically, it
+ * deletes the free blocks that weren't needed since the last call.
+ *
+ * If an ExportMap is provided, the number of blocks allocated, the number of
+ * free blocks and the number of allocations that required a new block are
+ * exported, keyed by name. These are only updated by PurgeIdle(), so it
+ * should be called from the thread that owns the ExportMap.
+ *
+ * The pool must outlive all the threads that use it, or at least their use
+ * of it. The blocks in the caches of other threads are deleted when the pool
+ * is destroyed.
+ */
+class SharedMemoryBlockPool: public MemoryBlockPool {
+ public:
+  struct Options {
+   public:
+    /**
+     * @brief The size of the blocks.
+     */
+    unsigned int block_size;
+
+    /**
+     * @brief The maximum number of blocks in the shared free list, 0 means
+     *   no limit.
+     */
+    unsigned int max_free_blocks;
+
+    /**
+     * @brief The maximum number of free blocks cached by each thread, 0
+     *   disables the per-thread caches.
+     */
+    unsigned int thread_cache_size;
+
+    /**
+     * @brief The ExportMap to use for the stats, may be NULL.
+     */
+    ExportMap *export_map;
+
+    /**
+     * @brief The key to use for the stats.
+     */
+    std::string name;
+
+    Options()
+        : block_size(DEFAULT_BLOCK_SIZE),
+          max_free_blocks(DEFAULT_MAX_FREE_BLOCKS),
+          thread_cache_size(DEFAULT_THREAD_CACHE_SIZE),
+          export_map(NULL) {
+    }
+  };
+
+  explicit SharedMemoryBlockPool(const Options &options = Options());
+  ~SharedMemoryBlockPool();
+
+  MemoryBlock *Allocate();
+  void Release(MemoryBlock *block);
+
+  /**
+   * @brief The number of free blocks in the shared list and the calling
+   *   thread's cache.
+   */
+  unsigned int FreeBlocks() const;
+
+  using MemoryBlockPool::Purge;
+
+  /**
+   * @brief Delete all but remaining blocks from the shared free list.
+   *
+   * The calling thread's cache is returned to the shared list first. The
+   * caches of other threads aren't affected.
+   */
+  void Purge(unsigned int remaining);
+
+  unsigned int BlocksAllocated() const;
+
+  /**
+   * @brief Delete the free blocks that haven't been used since the last call
+   *   and update the exported variables.
+   * @returns the number of blocks deleted.
+   */
+  unsigned int PurgeIdle();
+
+  /**
+   * @brief The number of times a new block had to be allocated.
+   */
+  unsigned int AllocationMisses() const;
+
+  static const unsigned int DEFAULT_MAX_FREE_BLOCKS = 1024;
+  static const unsigned int DEFAULT_THREAD_CACHE_SIZE = 16;
+
+  static const char BLOCKS_VAR[];
+  static const char FREE_BLOCKS_VAR[];
+  static const char MISSES_VAR[];
+
+ private:
+  struct ThreadCache {
+    SharedMemoryBlockPool *pool;
+    std::vector<MemoryBlock*> blocks;
+  };
+
+  typedef std::vector<MemoryBlock*> BlockVector;
+  typedef std::set<ThreadCache*> ThreadCaches;
+
+  const unsigned int m_block_size;
+  const unsigned int m_max_free_blocks;
+  unsigned int m_thread_cache_size;
+  const std::string m_name;
+  pthread_key_t m_cache_key;
+
+  mutable ola::thread::Mutex m_mutex;
+  // These are protected by m_mutex.
+  BlockVector m_free_blocks;
+  ThreadCaches m_caches;
+  unsigned int m_blocks_allocated;
+  unsigned int m_misses;
+  // The smallest size of m_free_blocks since the last PurgeIdle().
+  unsigned int m_low_water;
+
+  UIntMap *m_blocks_var;
+  UIntMap *m_free_blocks_var;
+  UIntMap *m_misses_var;
+
+  ThreadCache *CurrentCache() const;
+  ThreadCache *NewCache();
+  MemoryBlock *AllocateBlock();
+  void Refill(ThreadCache *cache);
+  void Drain(ThreadCache *cache, unsigned int remaining);
+  void AddFreeBlock(MemoryBlock *block);
+  void TrimFreeBlocks(unsigned int remaining);
+
+  static void ReleaseCache(void *cache);
+
+  static const char POOL_KEY[];
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryBlockPool);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // INCLUDE_OLA_IO_SHAREDMEMORYBLOCKPOOL_H_
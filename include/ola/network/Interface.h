@@ -47,7 +47,7 @@ class Interface {
             uint16_t type = ARP_VOID_TYPE);
   Interface(const Interface &other);
   Interface& operator=(const Interface &other);
-  bool operator==(const Interface &other);
+  bool operator==(const Interface &other) const;
 
   std::string name;
   IPV4Address ip_address;
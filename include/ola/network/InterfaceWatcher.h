@@ -0,0 +1,107 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * InterfaceWatcher.h
+ * Run a callback when the network interfaces change.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup network
+ * @{
+ * @file InterfaceWatcher.h
+ * @brief Run a callback when the network interfaces change.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_INTERFACEWATCHER_H_
+#define INCLUDE_OLA_NETWORK_INTERFACEWATCHER_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/network/Interface.h>
+#include <ola/network/InterfacePicker.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Watches for interfaces, or their addresses, changing.
+ *
+ * This listens for netlink, or routing socket, notifications. Changes often
+ * arrive in bursts, so the interfaces are compared once the notifications
+ * have stopped for a short while, and the callback is only run if the list
+ * returned by the InterfacePicker is different.
+ */
+class InterfaceWatcher {
+ public:
+  /**
+   * @brief Create a new InterfaceWatcher.
+   * @param ss the SelectServer to use.
+   * @param on_change the callback to run when the interfaces change,
+   *   ownership is transferred.
+   */
+  InterfaceWatcher(ola::io::SelectServerInterface *ss,
+                   ola::Callback0<void> *on_change);
+  ~InterfaceWatcher();
+
+  /**
+   * @brief Start watching.
+   * @returns false if change notifications aren't supported on this
+   *   platform.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop watching.
+   */
+  void Stop();
+
+  /**
+   * @brief The interfaces, including loopback, as of the last change.
+   */
+  const std::vector<Interface> &Interfaces() const { return m_interfaces; }
+
+ private:
+  ola::io::SelectServerInterface *m_ss;
+  std::auto_ptr<ola::Callback0<void> > m_on_change;
+  std::auto_ptr<InterfacePicker> m_picker;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_descriptor;
+  ola::thread::timeout_id m_settle_timeout;
+  std::vector<Interface> m_interfaces;
+
+  void SocketReady();
+  void Settled();
+
+  static const unsigned int SETTLE_DELAY_MS = 500;
+
+  DISALLOW_COPY_AND_ASSIGN(InterfaceWatcher);
+};
+/**
+ * @}
+ */
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_INTERFACEWATCHER_H_
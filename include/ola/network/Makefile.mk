@@ -5,6 +5,7 @@ olanetworkinclude_HEADERS = \
     include/ola/network/IPV4Address.h \
     include/ola/network/Interface.h \
     include/ola/network/InterfacePicker.h \
+    include/ola/network/InterfaceWatcher.h \
     include/ola/network/MACAddress.h \
     include/ola/network/NetworkUtils.h \
     include/ola/network/Socket.h \
@@ -12,4 +13,5 @@ olanetworkinclude_HEADERS = \
     include/ola/network/SocketCloser.h \
     include/ola/network/TCPConnector.h \
     include/ola/network/TCPSocket.h \
-    include/ola/network/TCPSocketFactory.h
+    include/ola/network/TCPSocketFactory.h \
+    include/ola/network/UDPTransmitBatcher.h
@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/base/Macro.h>
 #include <ola/io/Descriptor.h>
 #include <ola/io/IOQueue.h>
@@ -34,8 +35,43 @@
 #include <string>
 
 namespace ola {
+
+class ExportMap;
+class UIntMap;
+
 namespace network {
 
+/**
+ * @brief A buffer for one datagram received by UDPSocketInterface::RecvMany().
+ */
+struct UDPDatagram {
+  /** @brief The buffer to store the data in. */
+  uint8_t *data;
+  /** @brief The size of the buffer. */
+  unsigned int capacity;
+  /** @brief The number of bytes read, set by RecvMany(). */
+  unsigned int size;
+  /** @brief The source of the datagram, set by RecvMany(). */
+  IPV4SocketAddress source;
+  /**
+   * @brief The wall clock time the kernel received the datagram, set by
+   *   RecvMany(). This isn't set unless receive timestamps are enabled.
+   */
+  TimeStamp arrival;
+};
+
+/**
+ * @brief A datagram to be sent by UDPSocketInterface::SendMany().
+ */
+struct UDPOutgoingDatagram {
+  /** @brief The data to send. */
+  const uint8_t *data;
+  /** @brief The size of the data. */
+  unsigned int size;
+  /** @brief Where to send the datagram. */
+  IPV4SocketAddress destination;
+};
+
 /**
  * @brief The interface for UDPSockets.
  *
@@ -132,6 +168,21 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
   virtual ssize_t SendTo(ola::io::IOVecInterface *data,
                          const IPV4SocketAddress &dest) const = 0;
 
+  /**
+   * @brief Send multiple datagrams.
+   * @param datagrams an array of count datagrams.
+   * @param count the number of entries in datagrams.
+   * @returns the number of datagrams that were sent in full.
+   *
+   * Where sendmmsg() is available the datagrams are sent with as few system
+   * calls as possible, and consecutive datagrams of the same size to the same
+   * destination are combined using UDP segmentation offload if the kernel
+   * supports it. A datagram which fails to send doesn't prevent the
+   * following ones being sent.
+   */
+  virtual unsigned int SendMany(const UDPOutgoingDatagram *datagrams,
+                                unsigned int count) const = 0;
+
   /**
    * @brief Receive data
    * @param buffer the buffer to store the data
@@ -185,6 +236,20 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
                         ssize_t *data_read,
                         IPV4SocketAddress *source) = 0;
 
+  /**
+   * @brief Receive up to count datagrams without blocking.
+   * @param datagrams an array of count datagram buffers. The data and capacity
+   *   of each must be set by the caller.
+   * @param count the number of entries in datagrams.
+   * @returns the number of datagrams received, which may be less than count
+   *   if no more were queued on the socket.
+   *
+   * This should be called once the socket is readable. Where recvmmsg() is
+   * available all the datagrams are read with a single system call.
+   */
+  virtual unsigned int RecvMany(UDPDatagram *datagrams,
+                                unsigned int count) = 0;
+
   /**
    * @brief Enable broadcasting for this socket.
    * @return true if it worked, false otherwise
@@ -217,6 +282,18 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
   virtual bool LeaveMulticast(const IPV4Address &iface,
                               const IPV4Address &group) = 0;
 
+  /**
+   * @brief Control if this socket receives data for groups it hasn't joined.
+   * @param enable true to receive the data for any group joined by a socket
+   *   bound to the same port, false to only receive data for the groups this
+   *   socket has joined.
+   * @return true if it worked, false otherwise
+   *
+   * Only Linux delivers data for groups joined by other sockets, on other
+   * platforms this does nothing.
+   */
+  virtual bool SetMulticastAll(bool enable) = 0;
+
   /**
    * @brief Set the tos field for a socket
    * @param tos the tos field
@@ -224,6 +301,49 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
    */
   virtual bool SetTos(uint8_t tos) = 0;
 
+  /**
+   * @brief Set the size of the kernel's receive buffer for this socket.
+   * @param size the size in bytes. The kernel may round this, or cap it at
+   *   the system maximum.
+   * @return true if it worked, false otherwise
+   */
+  virtual bool SetReceiveBufferSize(unsigned int size) = 0;
+
+  /**
+   * @brief Set the size of the kernel's send buffer for this socket.
+   * @param size the size in bytes. The kernel may round this, or cap it at
+   *   the system maximum.
+   * @return true if it worked, false otherwise
+   */
+  virtual bool SetSendBufferSize(unsigned int size) = 0;
+
+  /**
+   * @brief Ask the kernel to report the datagrams it drops because the
+   *   receive buffer is full.
+   * @return true if it worked, false if the platform doesn't support it.
+   *
+   * On Linux this uses SO_RXQ_OVFL. The count is updated by RecvMany().
+   */
+  virtual bool EnableDropCounting() = 0;
+
+  /**
+   * @brief The number of datagrams the kernel has dropped on this socket.
+   *
+   * This is only updated if EnableDropCounting() succeeded, and only when
+   * datagrams are read with RecvMany().
+   */
+  virtual uint32_t DroppedDatagrams() const = 0;
+
+  /**
+   * @brief Ask the kernel to record when each datagram arrives.
+   * @return true if it worked, false if the platform doesn't support it.
+   *
+   * On Linux this uses SO_TIMESTAMPNS. The time is stored in
+   * UDPDatagram::arrival by RecvMany(), so it includes the time the datagram
+   * spent in the receive buffer, which a time taken after the wakeup misses.
+   */
+  virtual bool EnableReceiveTimestamps() = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(UDPSocketInterface);
 };
@@ -237,7 +357,11 @@ class UDPSocket: public UDPSocketInterface {
   UDPSocket()
       : UDPSocketInterface(),
         m_handle(ola::io::INVALID_DESCRIPTOR),
-        m_bound_to_port(false) {}
+        m_bound_to_port(false),
+        m_use_gso(true),
+        m_count_drops(false),
+        m_dropped(0),
+        m_timestamps(false) {}
   ~UDPSocket() { Close(); }
   bool Init();
   bool Bind(const IPV4SocketAddress &endpoint);
@@ -260,6 +384,9 @@ class UDPSocket: public UDPSocketInterface {
   ssize_t SendTo(ola::io::IOVecInterface *data,
                  const IPV4SocketAddress &dest) const;
 
+  unsigned int SendMany(const UDPOutgoingDatagram *datagrams,
+                        unsigned int count) const;
+
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
@@ -273,6 +400,8 @@ class UDPSocket: public UDPSocketInterface {
                 ssize_t *data_read,
                 IPV4SocketAddress *source);
 
+  unsigned int RecvMany(UDPDatagram *datagrams, unsigned int count);
+
   bool EnableBroadcast();
   bool SetMulticastInterface(const IPV4Address &iface);
   bool JoinMulticast(const IPV4Address &iface,
@@ -280,15 +409,103 @@ class UDPSocket: public UDPSocketInterface {
                      bool multicast_loop = false);
   bool LeaveMulticast(const IPV4Address &iface,
                       const IPV4Address &group);
+  bool SetMulticastAll(bool enable);
 
   bool SetTos(uint8_t tos);
 
+  bool SetReceiveBufferSize(unsigned int size);
+  bool SetSendBufferSize(unsigned int size);
+  bool EnableDropCounting();
+  uint32_t DroppedDatagrams() const { return m_dropped; }
+  bool EnableReceiveTimestamps();
+
  private:
   ola::io::DescriptorHandle m_handle;
   bool m_bound_to_port;
+  // Cleared if the kernel rejects UDP_SEGMENT.
+  mutable bool m_use_gso;
+  bool m_count_drops;
+  uint32_t m_dropped;
+  bool m_timestamps;
+
+  bool SetBufferSize(int option, const char *name, unsigned int size);
 
   DISALLOW_COPY_AND_ASSIGN(UDPSocket);
 };
+
+
+/**
+ * @brief A set of receive buffers that are reused for each call to
+ * UDPSocketInterface::RecvMany().
+ *
+ * This lets the socket's on_data callback drain everything that's queued,
+ * rather than handling a single datagram per wakeup.
+ *
+ * @code
+ *   void Node::SocketReady() {
+ *     unsigned int count = m_ring.Receive(m_socket);
+ *     for (unsigned int i = 0; i < count; i++) {
+ *       const UDPDatagram &datagram = m_ring.Get(i);
+ *       HandlePacket(datagram.source, datagram.data, datagram.size);
+ *     }
+ *   }
+ * @endcode
+ */
+class UDPReceiveRing {
+ public:
+  /**
+   * @brief Create a new UDPReceiveRing.
+   * @param depth the maximum number of datagrams to read at once.
+   * @param datagram_size the size of each buffer.
+   *
+   * The buffers are allocated on the first call to Receive().
+   */
+  UDPReceiveRing(unsigned int depth, unsigned int datagram_size);
+  ~UDPReceiveRing();
+
+  /**
+   * @brief Read the queued datagrams from a socket.
+   * @param socket the socket to read from.
+   * @returns the number of datagrams read. These remain valid until the next
+   *   call to Receive().
+   */
+  unsigned int Receive(UDPSocketInterface *socket);
+
+  /**
+   * @brief Export the number of datagrams the kernel dropped on the socket.
+   * @param export_map the ExportMap to use, may be NULL.
+   * @param name the key to use for the socket.
+   *
+   * The count is taken from UDPSocketInterface::DroppedDatagrams() after
+   * each Receive(), so drop counting should be enabled on the socket.
+   */
+  void ExportDrops(ExportMap *export_map, const std::string &name);
+
+  /**
+   * @brief Get one of the datagrams read by the last call to Receive().
+   * @param i the index of the datagram, must be less than the value returned
+   *   by Receive().
+   */
+  const UDPDatagram &Get(unsigned int i) const { return m_datagrams[i]; }
+
+  /**
+   * @brief The default number of datagrams to read per wakeup.
+   */
+  static const unsigned int DEFAULT_DEPTH = 16;
+
+  static const char DROPS_VAR[];
+
+ private:
+  const unsigned int m_depth;
+  const unsigned int m_datagram_size;
+  uint8_t *m_buffer;
+  UDPDatagram *m_datagrams;
+  UIntMap *m_drop_var;
+  std::string m_drop_key;
+  uint32_t m_last_dropped;
+
+  DISALLOW_COPY_AND_ASSIGN(UDPReceiveRing);
+};
 }  // namespace network
 }  // namespace ola
 #endif  // INCLUDE_OLA_NETWORK_SOCKET_H_
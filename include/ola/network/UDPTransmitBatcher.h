@@ -0,0 +1,181 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPTransmitBatcher.h
+ * Collects outgoing datagrams and sends them with a single SendMany() call.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_UDPTRANSMITBATCHER_H_
+#define INCLUDE_OLA_NETWORK_UDPTRANSMITBATCHER_H_
+
+#include <stdint.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/io/IOVecInterface.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @brief Batches the datagrams sent on a UDP socket.
+ *
+ * Rather than calling sendto() for each datagram, SendTo() copies the data
+ * and schedules a flush for the end of the current event loop iteration. All
+ * the datagrams sent in the meantime, for example the DMX for each universe
+ * when they refresh together, are then passed to
+ * UDPSocketInterface::SendMany().
+ *
+ * If an ExportMap is provided the number of flushes, the number of datagrams
+ * and the largest batch are exported, keyed by name.
+ *
+ * Optionally the datagrams can be paced, see SetPacing().
+ */
+class UDPTransmitBatcher {
+ public:
+  /**
+   * @brief Create a new UDPTransmitBatcher.
+   * @param scheduler the scheduler used to run the flush.
+   * @param socket the socket to send on. Ownership is not transferred.
+   * @param export_map the ExportMap to use for the stats, may be NULL.
+   * @param name the key to use for the stats.
+   */
+  UDPTransmitBatcher(ola::thread::SchedulerInterface *scheduler,
+                     UDPSocketInterface *socket,
+                     ExportMap *export_map = NULL,
+                     const std::string &name = "");
+
+  /**
+   * @brief Destructor, this sends any pending datagrams.
+   */
+  ~UDPTransmitBatcher();
+
+  /**
+   * @brief Queue a datagram to be sent.
+   * @param data the data to send, this is copied.
+   * @param size the size of the data.
+   * @param destination where to send the datagram.
+   * @returns size, for compatibility with UDPSocketInterface::SendTo().
+   */
+  ssize_t SendTo(const uint8_t *data,
+                 unsigned int size,
+                 const IPV4SocketAddress &destination);
+
+  /**
+   * @brief Queue a datagram to be sent.
+   * @param data the data to send, this is gathered into a single datagram and
+   *   then popped.
+   * @param destination where to send the datagram.
+   * @returns the size of the datagram.
+   */
+  ssize_t SendTo(ola::io::IOVecInterface *data,
+                 const IPV4SocketAddress &destination);
+
+  /**
+   * @brief Spread the datagrams over a window rather than sending them in one
+   *   burst.
+   * @param window the longest time a datagram is held for, 0 disables
+   *   pacing.
+   *
+   * When many universes refresh together a single burst can overrun the
+   * buffers in a switch or a receiver. With pacing the queue is sent in
+   * slices, one every PACING_INTERVAL_USEC, each sized so the queue drains
+   * by the end of the window. Datagrams queued during the window join the
+   * current slices, so none is held for longer than the window. The window
+   * should be shorter than the refresh interval.
+   *
+   * If an ExportMap was provided, the queue depth after each slice and the
+   * largest queue depth are exported as well.
+   */
+  void SetPacing(const ola::TimeInterval &window);
+
+  /**
+   * @brief Send all pending datagrams now.
+   * @returns the number of datagrams that were sent.
+   */
+  unsigned int Flush();
+
+  /**
+   * @brief The number of datagrams waiting to be sent.
+   */
+  unsigned int Pending() const {
+    return static_cast<unsigned int>(m_pending.size()) - m_next;
+  }
+
+  /**
+   * @brief The number of datagrams that triggers an immediate flush.
+   */
+  static const unsigned int MAX_PENDING = 256;
+
+  /**
+   * @brief The number of datagrams that triggers an immediate flush when
+   *   pacing.
+   */
+  static const unsigned int MAX_PACED_PENDING = 4096;
+
+  /**
+   * @brief The time between the slices when pacing.
+   */
+  static const unsigned int PACING_INTERVAL_USEC = 1000;
+
+  static const char BATCH_VAR[];
+  static const char DATAGRAM_VAR[];
+  static const char MAX_BATCH_VAR[];
+  static const char PACER_DEPTH_VAR[];
+  static const char PACER_MAX_DEPTH_VAR[];
+
+ private:
+  struct PendingDatagram {
+    unsigned int offset;
+    unsigned int size;
+    IPV4SocketAddress destination;
+  };
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  UDPSocketInterface *m_socket;
+  ExportMap *m_export_map;
+  const std::string m_name;
+  ola::thread::timeout_id m_flush_timeout;
+  std::vector<uint8_t> m_buffer;
+  std::vector<PendingDatagram> m_pending;
+  unsigned int m_next;  // the first entry in m_pending that hasn't been sent
+  std::vector<UDPOutgoingDatagram> m_datagrams;
+  unsigned int m_pacing_slices;  // 0 if pacing is disabled
+  unsigned int m_slices_left;
+  UIntMap *m_batch_var;
+  UIntMap *m_datagram_var;
+  UIntMap *m_max_batch_var;
+  UIntMap *m_depth_var;
+  UIntMap *m_max_depth_var;
+
+  void Queue(unsigned int offset, unsigned int size,
+             const IPV4SocketAddress &destination);
+  unsigned int Send(unsigned int count);
+  void UpdateDepth();
+  void ScheduledFlush();
+  void ScheduledSlice();
+
+  static const char SOCKET_KEY[];
+
+  DISALLOW_COPY_AND_ASSIGN(UDPTransmitBatcher);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_UDPTRANSMITBATCHER_H_
@@ -167,6 +167,17 @@ class DiscoveryAgent {
    */
   void StartIncrementalDiscovery(DiscoveryCompleteCallback *on_complete);
 
+  /**
+   * @brief Set the UIDs that the next incremental discovery starts from.
+   * @param uids the UIDs that are expected to be present.
+   *
+   * This is used to restore the UIDs found by an earlier instance, so the
+   * first discovery can mute the known responders rather than searching the
+   * whole tree for them. Any that fail to mute are dropped. This has no
+   * effect if discovery is running.
+   */
+  void SetKnownUIDs(const UIDSet &uids);
+
  private:
   /**
    * @brief Represents a range of UIDs (a branch of the UID tree)
@@ -179,7 +190,10 @@ class DiscoveryAgent {
           attempt(0),
           failures(0),
           uids_discovered(0),
-          branch_corrupt(false) {
+          branch_corrupt(false),
+          split(false),
+          empty_children(0),
+          inferred_splits(0) {
     }
     UID lower;
     UID upper;
@@ -188,6 +202,11 @@ class DiscoveryAgent {
     unsigned int failures;
     unsigned int uids_discovered;
     bool branch_corrupt;  // true if this branch contains a bad device
+    bool split;  // true once this range has been split in two
+    unsigned int empty_children;  // halves that timed out without a response
+    // the number of splits in a row leading to this range that were made
+    // without sending a DUB, see SendDiscovery()
+    unsigned int inferred_splits;
   };
 
   typedef std::stack<UIDRange*> UIDRanges;
@@ -226,6 +245,7 @@ class DiscoveryAgent {
   void BranchComplete(const uint8_t *data, unsigned int length);
   void BranchMuteComplete(bool status);
   void HandleCollision();
+  void SplitRange(UIDRange *range, bool inferred);
   void FreeCurrentRange();
 
   static const unsigned int PREAMBLE_SIZE = 8;
@@ -243,6 +263,12 @@ class DiscoveryAgent {
    */
   static const unsigned int MAX_BRANCH_FAILURES = 5;
 
+  /*
+   * The most splits in a row we'll make without sending a DUB. This limits
+   * the cost of acting on a collision that was really line noise.
+   */
+  static const unsigned int MAX_INFERRED_SPLITS = 8;
+
   // The number of times we'll attempt to mute a UID
   static const unsigned int MAX_MUTE_ATTEMPTS = 5;
   // The number of times we'll send a broadcast unmute command
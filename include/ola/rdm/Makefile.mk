@@ -12,6 +12,7 @@ olardminclude_HEADERS = \
     include/ola/rdm/DiscoveryAgent.h \
     include/ola/rdm/DummyResponder.h \
     include/ola/rdm/MessageDeserializer.h \
+    include/ola/rdm/MessagePlan.h \
     include/ola/rdm/MessageSerializer.h \
     include/ola/rdm/MovingLightResponder.h \
     include/ola/rdm/NetworkManagerInterface.h \
@@ -28,10 +29,13 @@ olardminclude_HEADERS = \
     include/ola/rdm/RDMControllerInterface.h \
     include/ola/rdm/RDMEnums.h \
     include/ola/rdm/RDMFrame.h \
+    include/ola/rdm/RDMFrameView.h \
     include/ola/rdm/RDMHelper.h \
     include/ola/rdm/RDMMessagePrinters.h \
     include/ola/rdm/RDMPacket.h \
+    include/ola/rdm/RDMParameterSweeper.h \
     include/ola/rdm/RDMReply.h \
+    include/ola/rdm/RDMTimingStats.h \
     include/ola/rdm/ResponderHelper.h \
     include/ola/rdm/ResponderLoadSensor.h \
     include/ola/rdm/ResponderOps.h \
@@ -38,6 +38,7 @@
 namespace ola {
 namespace rdm {
 
+class MessagePlan;
 
 /**
  * This visitor inflates the message from raw data.
@@ -52,6 +53,18 @@ class MessageDeserializer: public ola::messaging::FieldDescriptorVisitor {
         const uint8_t *data,
         unsigned int length);
 
+    /**
+     * @brief Inflate a message using a precompiled plan.
+     *
+     * This skips walking the descriptor to check the length, use it when
+     * the same descriptor is used for many messages.
+     * @sa PidDescriptor::GetResponsePlan()
+     */
+    const ola::messaging::Message *InflateMessage(
+        const MessagePlan *plan,
+        const uint8_t *data,
+        unsigned int length);
+
     // we handle decending into groups ourself
     bool Descend() const { return false; }
 
@@ -0,0 +1,192 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MessagePlan.h
+ * A flat layout of the fields in a message descriptor.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_command
+ * @{
+ * @file MessagePlan.h
+ * @brief A flat layout of the fields in a message descriptor.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_MESSAGEPLAN_H_
+#define INCLUDE_OLA_RDM_MESSAGEPLAN_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/messaging/Descriptor.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/MACAddress.h>
+#include <ola/rdm/UID.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief The layout of a message descriptor, worked out once.
+ *
+ * Walking a descriptor to find the size of its variable field, or the
+ * offset of each field, is the same work for every message. A MessagePlan
+ * does that walk when it's created, so checking the length of a message is
+ * constant time.
+ *
+ * If the descriptor doesn't have any variable sized fields, the plan also
+ * holds the offset of every field, with fixed size groups unrolled. A
+ * MessageView uses this to read the fields straight from the data.
+ */
+class MessagePlan {
+ public:
+  enum FieldType {
+    BOOL_FIELD,
+    IPV4_FIELD,
+    MAC_FIELD,
+    UID_FIELD,
+    STRING_FIELD,
+    UINT8_FIELD,
+    UINT16_FIELD,
+    UINT32_FIELD,
+    INT8_FIELD,
+    INT16_FIELD,
+    INT32_FIELD
+  };
+
+  struct Field {
+    const ola::messaging::FieldDescriptor *descriptor;
+    FieldType type;
+    unsigned int offset;
+    unsigned int size;
+    bool little_endian;
+  };
+
+  /**
+   * @brief Compile the layout of a descriptor.
+   * @param descriptor the descriptor, ownership is not transferred. It must
+   *   outlive the plan.
+   */
+  explicit MessagePlan(const ola::messaging::Descriptor *descriptor);
+
+  const ola::messaging::Descriptor *GetDescriptor() const {
+    return m_descriptor;
+  }
+
+  /**
+   * @brief True if the descriptor doesn't have any variable sized fields.
+   */
+  bool IsFixedSize() const { return m_variable_field_count == 0; }
+
+  /**
+   * @brief The number of bytes taken by the fixed sized fields.
+   */
+  unsigned int FixedSize() const { return m_fixed_size; }
+
+  /**
+   * @brief Check a message of the given length matches the descriptor.
+   * @param length the length of the message.
+   * @param[out] variable_field_size set to the length of the variable sized
+   *   string, or the number of blocks in the variable sized group. This isn't
+   *   changed if the descriptor is fixed size.
+   * @returns true if the length is valid.
+   */
+  bool CheckLength(unsigned int length,
+                   unsigned int *variable_field_size) const;
+
+  /**
+   * @brief The number of fields in the flat layout.
+   * @returns the number of fields, or 0 if the descriptor isn't fixed size.
+   */
+  unsigned int FieldCount() const { return m_fields.size(); }
+
+  /**
+   * @brief Return a field from the flat layout.
+   * @pre index < FieldCount()
+   */
+  const Field &GetField(unsigned int index) const { return m_fields[index]; }
+
+ private:
+  const ola::messaging::Descriptor *m_descriptor;
+  unsigned int m_fixed_size;
+  unsigned int m_variable_field_count;
+  const ola::messaging::StringFieldDescriptor *m_variable_string;
+  const ola::messaging::FieldDescriptorGroup *m_variable_group;
+  std::vector<Field> m_fields;
+
+  friend class PlanBuilder;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePlan);
+};
+
+
+/**
+ * @brief Reads the fields of a fixed size message in place.
+ *
+ * Unlike the MessageDeserializer, no Message is built. The plan and data
+ * must outlive the view.
+ */
+class MessageView {
+ public:
+  MessageView(const MessagePlan *plan, const uint8_t *data,
+              unsigned int length);
+
+  /**
+   * @brief True if the plan is fixed size and the data is the right length.
+   */
+  bool IsValid() const { return m_valid; }
+
+  unsigned int FieldCount() const;
+
+  /**
+   * @brief Read a field.
+   * @param index the index of the field in the flat layout.
+   * @param[out] value the value of the field.
+   * @returns false if the view isn't valid, the index is out of range or the
+   *   field isn't of the requested type.
+   */
+  bool GetBool(unsigned int index, bool *value) const;
+  bool GetIPV4(unsigned int index, ola::network::IPV4Address *value) const;
+  bool GetMAC(unsigned int index, ola::network::MACAddress *value) const;
+  bool GetUID(unsigned int index, UID *value) const;
+  bool GetString(unsigned int index, std::string *value) const;
+
+  /**
+   * @brief Read an unsigned integer field of any size.
+   */
+  bool GetUInt(unsigned int index, uint32_t *value) const;
+
+  /**
+   * @brief Read a signed integer field of any size.
+   */
+  bool GetInt(unsigned int index, int32_t *value) const;
+
+ private:
+  const MessagePlan *m_plan;
+  const uint8_t *m_data;
+  bool m_valid;
+
+  const MessagePlan::Field *GetField(unsigned int index,
+                                     MessagePlan::FieldType type) const;
+
+  template <typename int_type>
+  int_type ReadInt(const MessagePlan::Field &field) const;
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_MESSAGEPLAN_H_
@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <ola/messaging/Descriptor.h>
 #include <ola/base/Macro.h>
+#include <ola/rdm/MessagePlan.h>
 #include <istream>
 #include <map>
 #include <memory>
@@ -204,7 +205,7 @@ class PidStore {
    * @brief The number of PidDescriptors in this store.
    * @returns the number of PidDescriptors in this store.
    */
-  unsigned int PidCount() const { return m_pid_by_value.size(); }
+  unsigned int PidCount() const { return m_pids.size(); }
 
   /**
    * @brief Return a list of all PidDescriptors.
@@ -219,6 +220,8 @@ class PidStore {
    * @brief Lookup a PidDescriptor by PID.
    * @param pid_value the PID to lookup.
    * @return a PidDescriptor or NULL if the parameter wasn't found.
+   *
+   * This is a constant time lookup.
    */
   const PidDescriptor *LookupPID(uint16_t pid_value) const;
 
@@ -230,11 +233,20 @@ class PidStore {
   const PidDescriptor *LookupPID(const std::string &pid_name) const;
 
  private:
-  typedef std::map<uint16_t, const PidDescriptor*> PidMap;
   typedef std::map<std::string, const PidDescriptor*> PidNameMap;
-  PidMap m_pid_by_value;
+
+  // The descriptors, ordered by PID.
+  std::vector<const PidDescriptor*> m_pids;
+  // A two level index into m_pids. The high byte of the PID selects a page of
+  // m_pid_index, and the low byte the entry within the page. Entries are the
+  // offset into m_pids plus one, or 0 if the PID doesn't exist. Page 0 is
+  // always empty, so high bytes without any PIDs use that.
+  uint16_t m_page_table[256];
+  std::vector<uint16_t> m_pid_index;
   PidNameMap m_pid_by_name;
 
+  static const unsigned int PAGE_SIZE = 256;
+
   DISALLOW_COPY_AND_ASSIGN(PidStore);
 };
 
@@ -268,6 +280,10 @@ class PidDescriptor {
         m_get_response(get_response),
         m_set_request(set_request),
         m_set_response(set_response),
+        m_get_request_plan(NewPlan(get_request)),
+        m_get_response_plan(NewPlan(get_response)),
+        m_set_request_plan(NewPlan(set_request)),
+        m_set_response_plan(NewPlan(set_response)),
         m_get_subdevice_range(get_sub_device_range),
         m_set_subdevice_range(set_sub_device_range) {
   }
@@ -284,6 +300,20 @@ class PidDescriptor {
     return m_set_response;
   }
 
+  /**
+   * @name Message Plans
+   * @brief The layout of each message, compiled when the PID is loaded.
+   * @returns the plan, or NULL if the message doesn't exist.
+   * @{
+   */
+  const MessagePlan *GetRequestPlan() const { return m_get_request_plan; }
+  const MessagePlan *GetResponsePlan() const { return m_get_response_plan; }
+  const MessagePlan *SetRequestPlan() const { return m_set_request_plan; }
+  const MessagePlan *SetResponsePlan() const { return m_set_response_plan; }
+  /**
+   * @}
+   */
+
   bool IsGetValid(uint16_t sub_device) const;
   bool IsSetValid(uint16_t sub_device) const;
 
@@ -294,12 +324,21 @@ class PidDescriptor {
   const ola::messaging::Descriptor *m_get_response;
   const ola::messaging::Descriptor *m_set_request;
   const ola::messaging::Descriptor *m_set_response;
+  const MessagePlan *m_get_request_plan;
+  const MessagePlan *m_get_response_plan;
+  const MessagePlan *m_set_request_plan;
+  const MessagePlan *m_set_response_plan;
   sub_device_validator m_get_subdevice_range;
   sub_device_validator m_set_subdevice_range;
 
   bool RequestValid(uint16_t sub_device,
                     const sub_device_validator &validator) const;
 
+  static const MessagePlan *NewPlan(
+      const ola::messaging::Descriptor *descriptor) {
+    return descriptor ? new MessagePlan(descriptor) : NULL;
+  }
+
   DISALLOW_COPY_AND_ASSIGN(PidDescriptor);
 };
 }  // namespace rdm
@@ -73,6 +73,10 @@ class PidStoreHelper {
         const ola::messaging::Descriptor *descriptor,
         const uint8_t *data,
         unsigned int data_length);
+    const ola::messaging::Message *DeserializeMessage(
+        const MessagePlan *plan,
+        const uint8_t *data,
+        unsigned int data_length);
 
     const std::string MessageToString(const ola::messaging::Message *message);
 
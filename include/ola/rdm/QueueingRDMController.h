@@ -29,7 +29,12 @@
 #ifndef INCLUDE_OLA_RDM_QUEUEINGRDMCONTROLLER_H_
 #define INCLUDE_OLA_RDM_QUEUEINGRDMCONTROLLER_H_
 
+#include <ola/Clock.h>
 #include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/RDMTimingStats.h>
+#include <deque>
+#include <map>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
@@ -41,11 +46,42 @@ namespace rdm {
 /*
  * A RDM controller that only sends a single request at a time. This also
  * handles timing out messages that we don't get a response for.
+ *
+ * Requests are queued in two lanes, using RDMRequest::GetScheduling().
+ * Interactive requests are sent ahead of bulk ones, although a bulk request
+ * is let through after every INTERACTIVE_BURST interactive requests so bulk
+ * scans still make progress. Within a lane, each originator has its own
+ * queue and the originators take turns.
+ *
+ * The latency and outcome of each request sent to the underlying controller
+ * are collected in an RDMTimingStats, see GetTimingStats(). Each part of an
+ * ACK_OVERFLOW response counts as a separate request.
  */
 class QueueingRDMController: public RDMControllerInterface {
  public:
+    struct Stats {
+      Stats()
+          : interactive_sent(0),
+            bulk_sent(0),
+            dropped(0),
+            max_queue_depth(0) {
+      }
+
+      unsigned int interactive_sent;
+      unsigned int bulk_sent;
+      unsigned int dropped;  // requests rejected because the queue was full
+      unsigned int max_queue_depth;
+    };
+
+    /**
+     * @param controller the controller to send requests with.
+     * @param max_queue_size the maximum number of requests to queue.
+     * @param clock the clock used to time requests, ownership is not
+     *   transferred. If NULL a real clock is used.
+     */
     QueueingRDMController(RDMControllerInterface *controller,
-                          unsigned int max_queue_size);
+                          unsigned int max_queue_size,
+                          const ola::Clock *clock = NULL);
     ~QueueingRDMController();
 
     void Pause();
@@ -54,20 +90,47 @@ class QueueingRDMController: public RDMControllerInterface {
     // This can be called multiple times and the requests will be queued.
     void SendRDMRequest(RDMRequest *request, RDMCallback *on_complete);
 
+    // The number of requests waiting to be sent, not including the one in
+    // progress.
+    unsigned int InteractiveQueueDepth() const { return m_interactive.size; }
+    unsigned int BulkQueueDepth() const { return m_bulk.size; }
+
+    const Stats &GetStats() const { return m_stats; }
+    const RDMTimingStats &GetTimingStats() const { return m_timing; }
+
+    static const unsigned int INTERACTIVE_BURST = 4;
+
  protected:
     typedef struct {
       const RDMRequest *request;
       RDMCallback *on_complete;
     } outstanding_rdm_request;
 
+    // The queues for one lane.
+    struct Lane {
+      Lane() : size(0) {}
+
+      std::map<unsigned int, std::queue<outstanding_rdm_request> > queues;
+      std::deque<unsigned int> turns;  // the originators with queued requests
+      unsigned int size;
+    };
+
     RDMControllerInterface *m_controller;
     unsigned int m_max_queue_size;
-    std::queue<outstanding_rdm_request> m_pending_requests;
+    Lane m_interactive;
+    Lane m_bulk;
+    outstanding_rdm_request m_current;  // request is NULL if there isn't one
+    unsigned int m_interactive_run;  // sent in a row while bulk was waiting
     bool m_rdm_request_pending;  // true if a request is in progress
     bool m_active;  // true if the controller is active
     std::auto_ptr<RDMCallback> m_callback;
     std::auto_ptr<ola::rdm::RDMResponse> m_response;
     std::vector<RDMFrame> m_frames;
+    Stats m_stats;
+    ola::Clock m_real_clock;
+    const ola::Clock *m_clock;
+    TimeStamp m_sent_time;  // when the current request was dispatched
+    RDMTimingStats m_timing;
 
     virtual void TakeNextAction();
     virtual bool CheckForBlockingCondition();
@@ -76,6 +139,11 @@ class QueueingRDMController: public RDMControllerInterface {
 
     void HandleRDMResponse(RDMReply *reply);
     void RunCallback(RDMReply *reply);
+
+ private:
+    static void Push(Lane *lane, const outstanding_rdm_request &request);
+    static outstanding_rdm_request Pop(Lane *lane);
+    static void FailAll(Lane *lane);
 };
 
 
@@ -89,7 +157,8 @@ class DiscoverableQueueingRDMController: public QueueingRDMController {
  public:
     DiscoverableQueueingRDMController(
         DiscoverableRDMControllerInterface *controller,
-        unsigned int max_queue_size);
+        unsigned int max_queue_size,
+        const ola::Clock *clock = NULL);
 
     ~DiscoverableQueueingRDMController() {}
 
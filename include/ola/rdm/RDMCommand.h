@@ -223,6 +223,8 @@ class RDMCommand {
   static uint16_t CalculateChecksum(const uint8_t *data,
                                     unsigned int packet_length);
 
+  friend class RDMFrameView;
+
   DISALLOW_COPY_AND_ASSIGN(RDMCommand);
 };
 
@@ -266,6 +268,27 @@ class RDMRequest: public RDMCommand {
     uint16_t checksum;
   };
 
+  /**
+   * @brief Controls how a QueueingRDMController orders the request. This isn't
+   * part of the RDM message.
+   */
+  struct Scheduling {
+   public:
+    Scheduling() : bulk(false), originator(0) {}
+
+    /**
+     * @brief True if the request is part of a bulk operation, like a scan of
+     * every responder. Interactive requests are sent ahead of bulk ones.
+     */
+    bool bulk;
+
+    /**
+     * @brief Who sent the request, requests from different originators take
+     * turns. 0 if unknown.
+     */
+    unsigned int originator;
+  };
+
   /**
    * @brief Create a new request.
    * @param source The source UID.
@@ -303,7 +326,7 @@ class RDMRequest: public RDMCommand {
    * @returns A new RDMRequest that is identical to this one.
    */
   virtual RDMRequest *Duplicate() const {
-    return new RDMRequest(
+    RDMRequest *request = new RDMRequest(
       SourceUID(),
       DestinationUID(),
       TransactionNumber(),
@@ -314,6 +337,8 @@ class RDMRequest: public RDMCommand {
       ParamData(),
       ParamDataSize(),
       m_override_options);
+    request->SetScheduling(m_scheduling);
+    return request;
   }
 
   virtual void Print(CommandPrinter *printer,
@@ -361,8 +386,21 @@ class RDMRequest: public RDMCommand {
     m_port_id = port_id;
   }
 
+  /**
+   * @brief Set how the request is scheduled.
+   * @param scheduling the new Scheduling.
+   */
+  void SetScheduling(const Scheduling &scheduling) {
+    m_scheduling = scheduling;
+  }
+
   /** @} */
 
+  /**
+   * @brief How the request is scheduled.
+   */
+  const Scheduling &GetScheduling() const { return m_scheduling; }
+
   /**
    * @brief Inflate a request from some data.
    * @param data The raw data.
@@ -374,6 +412,7 @@ class RDMRequest: public RDMCommand {
 
  protected:
   OverrideOptions m_override_options;
+  Scheduling m_scheduling;
 
  private:
   RDMCommandClass m_command_class;
@@ -432,7 +471,7 @@ class BaseRDMRequest: public RDMGetSetRequest {
   }
 
   BaseRDMRequest<command_class> *Duplicate() const {
-    return new BaseRDMRequest<command_class>(
+    BaseRDMRequest<command_class> *request = new BaseRDMRequest<command_class>(
       SourceUID(),
       DestinationUID(),
       TransactionNumber(),
@@ -442,6 +481,8 @@ class BaseRDMRequest: public RDMGetSetRequest {
       ParamData(),
       ParamDataSize(),
       m_override_options);
+    request->SetScheduling(m_scheduling);
+    return request;
   }
 };
 
@@ -0,0 +1,215 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMFrameView.h
+ * A read only view of a RDM message held in someone else's memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_command
+ * @{
+ * @file RDMFrameView.h
+ * @brief Parse and build RDM messages without allocating.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_RDMFRAMEVIEW_H_
+#define INCLUDE_OLA_RDM_RDMFRAMEVIEW_H_
+
+#include <stdint.h>
+#include <ola/io/IOVecInterface.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMFrame.h>
+#include <ola/rdm/RDMPacket.h>
+#include <ola/rdm/RDMResponseCodes.h>
+#include <ola/rdm/UID.h>
+#include <ola/util/Utils.h>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief A view of a RDM message.
+ *
+ * Unlike RDMCommand::Inflate(), a RDMFrameView doesn't copy or allocate; the
+ * fields are read straight from the data, which must outlive the view. This
+ * is for code that handles lots of messages, most of which are discarded or
+ * passed along, where the cost of building a RDMCommand for each one adds up.
+ *
+ * The data does not include the RDM start code, which matches
+ * RDMCommand::Inflate() and what RDMCommandSerializer::Pack() produces.
+ */
+class RDMFrameView {
+ public:
+  /**
+   * @brief Create an empty view, IsValid() is false until Parse() succeeds.
+   */
+  RDMFrameView() : m_data(NULL), m_length(0) {}
+
+  /**
+   * @brief Validate a RDM message and point the view at it.
+   * @param data the message data, starting at the sub start code.
+   * @param length the length of the data.
+   * @returns RDM_COMPLETED_OK if the message is valid, or the reason it isn't.
+   *
+   * This performs the checks RDMCommand::VerifyData() does, in a single pass
+   * over the data, and also requires the message length to match the
+   * parameter data length. A failed Parse() leaves the view empty.
+   */
+  RDMStatusCode Parse(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief Validate the message in a RDMFrame, which includes the start code.
+   * @param frame the RDMFrame, which must outlive the view.
+   * @returns RDM_COMPLETED_OK if the message is valid, or the reason it isn't.
+   */
+  RDMStatusCode Parse(const RDMFrame &frame);
+
+  /**
+   * @brief True if the view points at a valid message.
+   */
+  bool IsValid() const { return m_data != NULL; }
+
+  /**
+   * @name Accessors
+   * @brief These must only be called if IsValid() is true.
+   * @{
+   */
+  uint8_t MessageLength() const { return Header()->message_length; }
+  UID SourceUID() const { return UID(Header()->source_uid); }
+  UID DestinationUID() const { return UID(Header()->destination_uid); }
+  uint8_t TransactionNumber() const { return Header()->transaction_number; }
+
+  /**
+   * @brief The port id for requests, or the response type for responses.
+   */
+  uint8_t PortIdResponseType() const { return Header()->port_id; }
+  uint8_t MessageCount() const { return Header()->message_count; }
+  uint16_t SubDevice() const {
+    return ola::utils::JoinUInt8(Header()->sub_device[0],
+                                 Header()->sub_device[1]);
+  }
+  RDMCommand::RDMCommandClass CommandClass() const {
+    return RDMCommand::ConvertCommandClass(Header()->command_class);
+  }
+  uint16_t ParamId() const {
+    return ola::utils::JoinUInt8(Header()->param_id[0], Header()->param_id[1]);
+  }
+
+  /**
+   * @brief The parameter data, this points into the viewed data.
+   */
+  const uint8_t *ParamData() const {
+    return ParamDataSize() ? m_data + sizeof(RDMCommandHeader) : NULL;
+  }
+  unsigned int ParamDataSize() const { return Header()->param_data_length; }
+  /** @} */
+
+  /**
+   * @brief The message data, starting at the sub start code and including the
+   *   checksum.
+   */
+  const uint8_t *Data() const { return m_data; }
+
+  /**
+   * @brief The size of the message, this may be less than the length passed
+   *   to Parse() if there were trailing bytes.
+   */
+  unsigned int Size() const { return m_length; }
+
+  /**
+   * @brief Get an IOVec which refers to the message, for scatter / gather IO.
+   */
+  struct ola::io::IOVec AsIOVec() const;
+
+  /**
+   * @brief Build a RDM message in a caller provided buffer.
+   * @param source the source UID.
+   * @param destination the destination UID.
+   * @param transaction_number the transaction number.
+   * @param port_id_response_type the port id for requests, or the response
+   *   type for responses.
+   * @param message_count the message count.
+   * @param sub_device the sub device.
+   * @param command_class the command class.
+   * @param param_id the PID.
+   * @param param_data the parameter data, may be NULL if param_data_length is
+   *   0.
+   * @param param_data_length the length of the parameter data.
+   * @param buffer the memory to write the message to.
+   * @param[in,out] size the size of the buffer, set to the length of the
+   *   message on return.
+   * @returns true if the message was written, false if the buffer was too
+   *   small or there was too much parameter data.
+   *
+   * Like RDMCommandSerializer::Pack(), the message doesn't include the start
+   * code.
+   */
+  static bool Pack(const UID &source,
+                   const UID &destination,
+                   uint8_t transaction_number,
+                   uint8_t port_id_response_type,
+                   uint8_t message_count,
+                   uint16_t sub_device,
+                   RDMCommand::RDMCommandClass command_class,
+                   uint16_t param_id,
+                   const uint8_t *param_data,
+                   unsigned int param_data_length,
+                   uint8_t *buffer,
+                   unsigned int *size);
+
+  /**
+   * @brief Build the response to a request in a caller provided buffer.
+   * @param request the view of the request.
+   * @param response_type the response type.
+   * @param param_data the parameter data, may be NULL if param_data_length is
+   *   0.
+   * @param param_data_length the length of the parameter data.
+   * @param buffer the memory to write the message to.
+   * @param[in,out] size the size of the buffer, set to the length of the
+   *   message on return.
+   * @param outstanding_messages the message count.
+   * @returns true if the message was written, false if the request wasn't a
+   *   GET or SET, the buffer was too small or there was too much parameter
+   *   data.
+   *
+   * This is the equivalent of GetResponseFromData().
+   */
+  static bool PackResponse(const RDMFrameView &request,
+                           rdm_response_type response_type,
+                           const uint8_t *param_data,
+                           unsigned int param_data_length,
+                           uint8_t *buffer,
+                           unsigned int *size,
+                           uint8_t outstanding_messages = 0);
+
+  /**
+   * @brief The maximum size of a message, excluding the start code. This is
+   *   the header, 231 bytes of parameter data and the checksum.
+   */
+  enum { MAX_MESSAGE_SIZE = 256 };
+
+ private:
+  const uint8_t *m_data;
+  unsigned int m_length;
+
+  const RDMCommandHeader *Header() const {
+    return reinterpret_cast<const RDMCommandHeader*>(m_data);
+  }
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_RDMFRAMEVIEW_H_
@@ -0,0 +1,206 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMParameterSweeper.h
+ * Fetch a set of PIDs from a set of devices.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_api
+ * @{
+ * @file RDMParameterSweeper.h
+ * @brief GET a list of PIDs from many devices at once.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_RDMPARAMETERSWEEPER_H_
+#define INCLUDE_OLA_RDM_RDMPARAMETERSWEEPER_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/rdm/RDMAPIImplInterface.h>
+#include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief The outcome of one GET in a sweep.
+ */
+struct SweepResult {
+  SweepResult(const UID &uid, uint16_t pid);
+
+  UID uid;
+  uint16_t pid;
+  /**
+   * @brief The status of the GET. If the device responded with an ACK_TIMER
+   *   and the queued response couldn't be fetched, the response_type is
+   *   RDM_ACK_TIMER.
+   */
+  ResponseStatus status;
+  std::string data;  //!< The parameter data, if the GET was ACKed.
+};
+
+/**
+ * @brief The results of a sweep, ordered by UID and then by PID, in the order
+ *   the PIDs were passed to Sweep().
+ */
+typedef std::vector<SweepResult> SweepResults;
+
+/**
+ * @brief GET a list of PIDs from a set of devices.
+ *
+ * RDMAPI sends one request at a time and leaves ACK_TIMER handling to the
+ * caller. The RDMParameterSweeper takes the full UID x PID table, keeps a
+ * bounded number of GETs in flight for each universe and follows ACK_TIMER
+ * responses with GET QUEUED_MESSAGE until the deferred response arrives.
+ *
+ * Multiple sweeps can run at once; sweeps on the same universe share the
+ * in-flight limit. A sweep can be cancelled with the id Sweep() returns. The
+ * sweeper must outlive any sweeps it's running.
+ */
+class RDMParameterSweeper {
+ public:
+  typedef ola::SingleUseCallback1<void, const SweepResults&> SweepCallback;
+  typedef unsigned int SweepId;
+
+  /**
+   * @brief Create a new RDMParameterSweeper.
+   * @param impl the RDMAPIImplInterface to send requests with. Ownership is
+   *   not transferred.
+   * @param scheduler the scheduler to use for ACK_TIMER delays. Ownership is
+   *   not transferred.
+   * @param max_in_flight the maximum number of outstanding GETs per universe.
+   */
+  RDMParameterSweeper(RDMAPIImplInterface *impl,
+                      ola::thread::SchedulerInterface *scheduler,
+                      unsigned int max_in_flight = DEFAULT_MAX_IN_FLIGHT);
+
+  /**
+   * @brief Destructor. Sweeps that haven't completed are abandoned, their
+   *   callbacks aren't run.
+   */
+  ~RDMParameterSweeper();
+
+  /**
+   * @brief GET each PID from each device.
+   * @param universe the universe the devices are on.
+   * @param uids the devices to query.
+   * @param pids the PIDs to GET from each device.
+   * @param callback run with the results once every GET has completed.
+   *   Ownership is transferred.
+   * @returns an id which can be passed to Cancel().
+   *
+   * The callback may be run before Sweep() returns.
+   */
+  SweepId Sweep(unsigned int universe,
+                const UIDSet &uids,
+                const std::vector<uint16_t> &pids,
+                SweepCallback *callback);
+
+  /**
+   * @brief Stop a sweep that's still running.
+   * @param id the id returned by Sweep().
+   * @returns true if the sweep was cancelled, false if it had already
+   *   completed.
+   *
+   * The GETs that haven't been sent are dropped and the callback is run
+   * straight away, with the results received so far. The other results have
+   * a response_code of RDM_FAILED_TO_SEND and an error of SWEEP_CANCELLED.
+   * Responses to the GETs which are in flight are discarded.
+   */
+  bool Cancel(SweepId id);
+
+  /**
+   * @brief The number of GETs waiting to be sent, or in flight, for a
+   *   universe. This doesn't include requests waiting for an ACK_TIMER to
+   *   expire.
+   */
+  unsigned int QueuedRequests(unsigned int universe) const;
+
+  static const unsigned int DEFAULT_MAX_IN_FLIGHT = 4;
+  static const char SWEEP_CANCELLED[];
+
+ private:
+  struct SweepState {
+    SweepId id;
+    unsigned int universe;
+    bool cancelled;
+    SweepResults results;
+    std::vector<bool> done;
+    unsigned int outstanding;  // the number of results not done
+    unsigned int live_requests;
+    SweepCallback *callback;
+  };
+
+  struct Request {
+    SweepState *sweep;
+    unsigned int index;
+    bool queued_message;
+    unsigned int queued_message_fetches;
+  };
+
+  struct UniverseQueue {
+    UniverseQueue() : in_flight(0), dispatching(false) {}
+
+    unsigned int in_flight;
+    bool dispatching;
+    std::deque<Request*> pending;
+  };
+
+  typedef std::map<unsigned int, UniverseQueue> UniverseMap;
+  typedef std::map<Request*, ola::thread::timeout_id> TimeoutMap;
+  typedef std::map<SweepId, SweepState*> SweepMap;
+
+  RDMAPIImplInterface *m_impl;
+  ola::thread::SchedulerInterface *m_scheduler;
+  const unsigned int m_max_in_flight;
+  UniverseMap m_universes;
+  TimeoutMap m_timeouts;
+  SweepMap m_sweeps;
+  SweepId m_next_sweep_id;
+
+  void Dispatch(unsigned int universe);
+  void SendRequest(UniverseQueue *queue, Request *request);
+  void HandleResponse(Request *request,
+                      const ResponseStatus &status,
+                      uint16_t pid,
+                      const std::string &data);
+  void HandleQueuedMessage(Request *request,
+                           const ResponseStatus &status,
+                           uint16_t pid,
+                           const std::string &data);
+  void WaitForAckTimer(Request *request, const ResponseStatus &status);
+  void AckTimerExpired(Request *request);
+  bool FillResult(SweepState *sweep, unsigned int index,
+                  const ResponseStatus &status, const std::string &data);
+  void FinishRequest(Request *request);
+  void ReleaseSweep(SweepState *sweep);
+
+  static const unsigned int MAX_QUEUED_MESSAGE_FETCHES;
+
+  DISALLOW_COPY_AND_ASSIGN(RDMParameterSweeper);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_RDMPARAMETERSWEEPER_H_
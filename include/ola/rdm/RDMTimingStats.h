@@ -0,0 +1,155 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMTimingStats.h
+ * Latency and outcome counters for RDM transactions.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_controller
+ * @{
+ * @file RDMTimingStats.h
+ * @brief Latency and outcome counters for RDM transactions, per responder.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_RDMTIMINGSTATS_H_
+#define INCLUDE_OLA_RDM_RDMTIMINGSTATS_H_
+
+#include <stdint.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/rdm/RDMReply.h>
+#include <ola/rdm/UID.h>
+#include <ola/util/Histogram.h>
+#include <map>
+#include <string>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief Collects the timing of RDM transactions, per responder.
+ *
+ * The caller calls RecordRequest() as each request is sent and RecordReply()
+ * once it completes. The latency is the time between the two, so it includes
+ * the time spent in the widget or node. Where the widget reports the
+ * responder's turnaround time in the RDMFrame timing, that's collected
+ * separately.
+ *
+ * A request is counted as a retransmit if it's identical to the last request
+ * sent to that responder and the last request timed out.
+ *
+ * Broadcast and DUB requests aren't tracked. This class isn't thread safe.
+ */
+class RDMTimingStats {
+ public:
+  /**
+   * @brief The counters for a single responder, or for all of them.
+   */
+  struct Timing {
+    Timing()
+        : requests(0),
+          timeouts(0),
+          ack_timers(0),
+          retransmits(0) {
+    }
+
+    /**
+     * @brief Request to response time, in microseconds, for the requests that
+     *   received a response.
+     */
+    Histogram latency;
+    /**
+     * @brief The response time from the RDMFrame timing, in microseconds.
+     *   This is only available from some widgets.
+     */
+    Histogram turnaround;
+    unsigned int requests;
+    unsigned int timeouts;
+    unsigned int ack_timers;
+    unsigned int retransmits;
+  };
+
+  typedef std::map<UID, Timing> ResponderMap;
+
+  RDMTimingStats() {}
+
+  /**
+   * @brief Record that a request was sent.
+   * @returns true if the request was recorded, false if it's not tracked.
+   */
+  bool RecordRequest(const RDMRequest &request);
+
+  /**
+   * @brief Record the outcome of a request.
+   * @param uid the responder the request was sent to.
+   * @param latency the time between the request being sent and the reply.
+   * @param reply the RDMReply.
+   */
+  void RecordReply(const UID &uid, const TimeInterval &latency,
+                   const RDMReply &reply);
+
+  /**
+   * @brief The counters for all responders.
+   */
+  const Timing &Totals() const { return m_totals; }
+
+  /**
+   * @brief The counters for each responder.
+   */
+  const ResponderMap &Responders() const { return m_responders; }
+
+  /**
+   * @brief The counters for a responder.
+   * @returns the Timing or NULL if nothing has been sent to the responder.
+   */
+  const Timing *Responder(const UID &uid) const;
+
+  void Reset();
+
+ private:
+  // Enough of the last request to a responder to spot a retransmit.
+  struct LastRequest {
+    LastRequest()
+        : command_class(0),
+          sub_device(0),
+          param_id(0),
+          timed_out(false) {
+    }
+
+    uint8_t command_class;
+    uint16_t sub_device;
+    uint16_t param_id;
+    std::string param_data;
+    bool timed_out;
+  };
+
+  typedef std::map<UID, LastRequest> LastRequestMap;
+
+  Timing m_totals;
+  ResponderMap m_responders;
+  LastRequestMap m_last_requests;
+
+  static void AddReply(Timing *timing, const TimeInterval &latency,
+                       const RDMReply &reply);
+
+  DISALLOW_COPY_AND_ASSIGN(RDMTimingStats);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_RDMTIMINGSTATS_H_
@@ -33,7 +33,8 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/RDMResponseCodes.h>
 
-#include <map>
+#include <string>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -51,6 +52,11 @@ namespace rdm {
  * object can handle requests for all responders of the same type. This
  * conserves memory when large numbers of responders are active.
  *
+ * The handlers are copied into a table sorted by PID when the ResponderOps is
+ * constructed, so dispatching a request is a binary search over a contiguous
+ * array, and the SUPPORTED_PARAMETERS response is built once rather than on
+ * every request.
+ *
  * ResponderOps handles SUPPORTED_PARAMETERS internally, however this can be
  * overridden by registering a handler for SUPPORTED_PARAMETERS.
  *
@@ -106,14 +112,26 @@ class ResponderOps {
 
  private:
     struct InternalParamHandler {
+      uint16_t pid;
       RDMHandler get_handler;
       RDMHandler set_handler;
     };
-    typedef std::map<uint16_t, InternalParamHandler> RDMHandlers;
+    // Sorted by PID.
+    typedef std::vector<InternalParamHandler> RDMHandlers;
+
+    struct PidLessThan {
+      bool operator()(const InternalParamHandler &handler,
+                      uint16_t pid) const {
+        return handler.pid < pid;
+      }
+    };
 
-    bool m_include_required_pids;
     RDMHandlers m_handlers;
+    // The SUPPORTED_PARAMETERS param data, in network byte order.
+    std::string m_supported_params;
 
+    void BuildSupportedParams(bool include_required_pids);
+    const InternalParamHandler *FindHandler(uint16_t pid) const;
     RDMResponse *HandleSupportedParams(const RDMRequest *request);
 };
 
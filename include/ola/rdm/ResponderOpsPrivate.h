@@ -47,21 +47,34 @@ namespace rdm {
 
 template <class Target>
 ResponderOps<Target>::ResponderOps(const ParamHandler param_handlers[],
-                                   bool include_required_pids)
-    : m_include_required_pids(include_required_pids) {
-  // We install placeholders for any pids which are handled internally.
-  struct InternalParamHandler placeholder = {NULL, NULL};
-  STLReplace(&m_handlers, PID_SUPPORTED_PARAMETERS, placeholder);
+                                   bool include_required_pids) {
+  // Later handlers for the same PID replace earlier ones, so collect them in a
+  // map first. We install placeholders for any pids which are handled
+  // internally.
+  std::map<uint16_t, InternalParamHandler> handlers;
+  struct InternalParamHandler placeholder = {
+    PID_SUPPORTED_PARAMETERS, NULL, NULL
+  };
+  STLReplace(&handlers, PID_SUPPORTED_PARAMETERS, placeholder);
 
   const ParamHandler *handler = param_handlers;
   while (handler->pid && (handler->get_handler || handler->set_handler)) {
     struct InternalParamHandler pid_handler = {
+      handler->pid,
       handler->get_handler,
       handler->set_handler
     };
-    STLReplace(&m_handlers, handler->pid, pid_handler);
+    STLReplace(&handlers, handler->pid, pid_handler);
     handler++;
   }
+
+  m_handlers.reserve(handlers.size());
+  typename std::map<uint16_t, InternalParamHandler>::const_iterator iter =
+      handlers.begin();
+  for (; iter != handlers.end(); ++iter) {
+    m_handlers.push_back(iter->second);
+  }
+  BuildSupportedParams(include_required_pids);
 }
 
 template <class Target>
@@ -136,7 +149,7 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
     return;
   }
 
-  InternalParamHandler *handler = STLFind(&m_handlers, request->ParamId());
+  const InternalParamHandler *handler = FindHandler(request->ParamId());
   if (!handler) {
     if (request->DestinationUID().IsBroadcast()) {
       RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
@@ -186,38 +199,46 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
 }
 
 template <class Target>
-RDMResponse *ResponderOps<Target>::HandleSupportedParams(
-    const RDMRequest *request) {
-  if (request->ParamDataSize())
-    return NackWithReason(request, NR_FORMAT_ERROR);
-
-  std::vector<uint16_t> params;
-  params.reserve(m_handlers.size());
+void ResponderOps<Target>::BuildSupportedParams(bool include_required_pids) {
+  // m_handlers is sorted, so the PIDs are too.
   typename RDMHandlers::const_iterator iter = m_handlers.begin();
   for (; iter != m_handlers.end(); ++iter) {
-    uint16_t pid = iter->first;
+    uint16_t pid = iter->pid;
     // some pids never appear in supported_parameters.
-    if (m_include_required_pids || (
+    if (include_required_pids || (
         pid != PID_SUPPORTED_PARAMETERS &&
         pid != PID_PARAMETER_DESCRIPTION &&
         pid != PID_DEVICE_INFO &&
         pid != PID_SOFTWARE_VERSION_LABEL &&
         pid != PID_DMX_START_ADDRESS &&
         pid != PID_IDENTIFY_DEVICE)) {
-      params.push_back(iter->first);
+      m_supported_params.push_back(static_cast<char>(pid >> 8));
+      m_supported_params.push_back(static_cast<char>(pid & 0xff));
     }
   }
-  sort(params.begin(), params.end());
+}
 
-  std::vector<uint16_t>::iterator param_iter = params.begin();
-  for (; param_iter != params.end(); ++param_iter) {
-    *param_iter = ola::network::HostToNetwork(*param_iter);
+template <class Target>
+const typename ResponderOps<Target>::InternalParamHandler*
+    ResponderOps<Target>::FindHandler(uint16_t pid) const {
+  typename RDMHandlers::const_iterator iter = std::lower_bound(
+      m_handlers.begin(), m_handlers.end(), pid, PidLessThan());
+  if (iter == m_handlers.end() || iter->pid != pid) {
+    return NULL;
   }
+  return &(*iter);
+}
+
+template <class Target>
+RDMResponse *ResponderOps<Target>::HandleSupportedParams(
+    const RDMRequest *request) {
+  if (request->ParamDataSize())
+    return NackWithReason(request, NR_FORMAT_ERROR);
 
   return GetResponseFromData(
       request,
-      reinterpret_cast<uint8_t*>(&params[0]),
-      params.size() * sizeof(uint16_t));
+      reinterpret_cast<const uint8_t*>(m_supported_params.data()),
+      m_supported_params.size());
 }
 }  // namespace rdm
 }  // namespace ola
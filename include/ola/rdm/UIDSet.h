@@ -32,8 +32,10 @@
 #include <ola/rdm/UID.h>
 #include <algorithm>
 #include <iomanip>
-#include <set>
+#include <iterator>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -43,6 +45,9 @@ namespace rdm {
  * @{
  * @class UIDSet
  * @brief Represents a set of RDM UIDs.
+ *
+ * The UIDs are held in a sorted vector, so iterating, comparing and merging
+ * sets touches contiguous memory, and the set operations are linear merges.
  * @}
  */
 class UIDSet {
@@ -50,7 +55,7 @@ class UIDSet {
     /**
      * @brief the Iterator for a UIDSets
      */
-    typedef std::set<UID>::const_iterator Iterator;
+    typedef std::vector<UID>::const_iterator Iterator;
 
     /**
      * @brief Construct an empty set
@@ -75,6 +80,15 @@ class UIDSet {
       return *this;
     }
 
+    /**
+     * @brief Exchange the members of this set with another, without copying
+     *   them.
+     * @param other the UIDSet to swap with.
+     */
+    void Swap(UIDSet &other) {
+      m_uids.swap(other.m_uids);
+    }
+
     /**
      * @brief Remove all members from the set.
      */
@@ -82,6 +96,14 @@ class UIDSet {
       m_uids.clear();
     }
 
+    /**
+     * @brief Allocate space for a number of UIDs up front.
+     * @param size the number of UIDs the set is expected to hold.
+     */
+    void Reserve(unsigned int size) {
+      m_uids.reserve(size);
+    }
+
     /**
      * @brief Return the number of UIDs in the set.
      * @return the number of UIDs in the set.
@@ -101,9 +123,35 @@ class UIDSet {
     /**
      * @brief Add a UID to the set.
      * @param uid the UID to add.
+     *
+     * Adding the UIDs in ascending order is the fastest way to build a set.
      */
     void AddUID(const UID &uid) {
-      m_uids.insert(uid);
+      if (m_uids.empty() || m_uids.back() < uid) {
+        m_uids.push_back(uid);
+        return;
+      }
+      std::vector<UID>::iterator iter = std::lower_bound(
+          m_uids.begin(), m_uids.end(), uid);
+      if (*iter != uid) {
+        m_uids.insert(iter, uid);
+      }
+    }
+
+    /**
+     * @brief Add all the UIDs from another set to this one.
+     * @param other the UIDSet to add.
+     */
+    void AddUIDs(const UIDSet &other) {
+      if (other.m_uids.empty()) {
+        return;
+      }
+      if (m_uids.empty() || m_uids.back() < other.m_uids.front()) {
+        m_uids.insert(m_uids.end(), other.m_uids.begin(), other.m_uids.end());
+        return;
+      }
+      UIDSet result = Union(other);
+      Swap(result);
     }
 
     /**
@@ -111,7 +159,11 @@ class UIDSet {
      * @param uid the UID to remove.
      */
     void RemoveUID(const UID &uid) {
-      m_uids.erase(uid);
+      std::vector<UID>::iterator iter = std::lower_bound(
+          m_uids.begin(), m_uids.end(), uid);
+      if (iter != m_uids.end() && *iter == uid) {
+        m_uids.erase(iter);
+      }
     }
 
     /**
@@ -120,7 +172,7 @@ class UIDSet {
      * @return true if the set contains this UID.
      */
     bool Contains(const UID &uid) const {
-      return m_uids.find(uid) != m_uids.end();
+      return std::binary_search(m_uids.begin(), m_uids.end(), uid);
     }
 
     /**
@@ -128,14 +180,15 @@ class UIDSet {
      * @param other the UIDSet to perform the union with.
      * @return the union of the two UIDSets.
      */
-    UIDSet Union(const UIDSet &other) {
-      std::set<UID> result;
-      set_union(m_uids.begin(),
-                m_uids.end(),
-                other.Begin(),
-                other.End(),
-                inserter(result, result.begin()));
-      return UIDSet(result);
+    UIDSet Union(const UIDSet &other) const {
+      UIDSet result;
+      result.m_uids.reserve(m_uids.size() + other.m_uids.size());
+      std::set_union(m_uids.begin(),
+                     m_uids.end(),
+                     other.m_uids.begin(),
+                     other.m_uids.end(),
+                     std::back_inserter(result.m_uids));
+      return result;
     }
 
     /**
@@ -157,14 +210,15 @@ class UIDSet {
      * @param other the UIDSet to subtract from this set.
      * @return the difference between this UIDSet and other.
      */
-    UIDSet SetDifference(const UIDSet &other) {
-      std::set<UID> difference;
+    UIDSet SetDifference(const UIDSet &other) const {
+      UIDSet difference;
+      difference.m_uids.reserve(m_uids.size());
       std::set_difference(m_uids.begin(),
                           m_uids.end(),
                           other.m_uids.begin(),
                           other.m_uids.end(),
-                          std::inserter(difference, difference.begin()));
-      return UIDSet(difference);
+                          std::back_inserter(difference.m_uids));
+      return difference;
     }
 
     /**
@@ -189,7 +243,7 @@ class UIDSet {
      */
     std::string ToString() const {
       std::ostringstream str;
-      std::set<UID>::const_iterator iter;
+      std::vector<UID>::const_iterator iter;
       for (iter = m_uids.begin(); iter != m_uids.end(); ++iter) {
         if (iter != m_uids.begin())
           str << ",";
@@ -208,11 +262,8 @@ class UIDSet {
     }
 
  private:
-    std::set<UID> m_uids;
-
-    explicit UIDSet(const std::set<UID> uids) {
-      m_uids = uids;
-    }
+    // Sorted, without duplicates.
+    std::vector<UID> m_uids;
 };
 }  // namespace rdm
 }  // namespace ola
@@ -0,0 +1,138 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FlatMap.h
+ * A map stored in a sorted vector.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_STL_FLATMAP_H_
+#define INCLUDE_OLA_STL_FLATMAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ola {
+
+/**
+ * @addtogroup stl
+ * @{
+ */
+
+/**
+ * @brief A map stored in a vector of (key, value) pairs, sorted by key.
+ * @tparam Key the key type, this must be less-than comparable.
+ * @tparam Value the value type.
+ *
+ * The entries are contiguous in memory, so iterating over the map is a
+ * linear scan rather than a walk over tree nodes. Lookups are a binary
+ * search. Inserting and removing entries moves the entries after them, so
+ * this suits small maps that are read far more often than they change.
+ */
+template <typename Key, typename Value>
+class FlatMap {
+ public:
+  typedef std::pair<Key, Value> Entry;
+  typedef typename std::vector<Entry>::iterator iterator;
+  typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+  /**
+   * @brief Set the value for a key, adding the key if it's not in the map.
+   * @returns true if the key was already in the map, false if it was added.
+   */
+  bool Replace(const Key &key, const Value &value) {
+    iterator iter = LowerBound(key);
+    if (iter != m_entries.end() && !(key < iter->first)) {
+      iter->second = value;
+      return true;
+    }
+    m_entries.insert(iter, Entry(key, value));
+    return false;
+  }
+
+  /**
+   * @brief Lookup the value for a key.
+   * @returns a pointer to the value, or NULL if the key isn't in the map. The
+   *   pointer is invalidated if the map is changed.
+   */
+  Value *Find(const Key &key) {
+    iterator iter = LowerBound(key);
+    if (iter == m_entries.end() || key < iter->first) {
+      return NULL;
+    }
+    return &iter->second;
+  }
+
+  /**
+   * @brief Remove a key from the map.
+   * @returns true if it was removed, false if it wasn't in the map.
+   */
+  bool Remove(const Key &key) {
+    iterator iter = LowerBound(key);
+    if (iter == m_entries.end() || key < iter->first) {
+      return false;
+    }
+    m_entries.erase(iter);
+    return true;
+  }
+
+  /**
+   * @brief Remove an entry while iterating over the map.
+   * @returns an iterator to the entry after the one removed.
+   */
+  iterator Erase(iterator iter) { return m_entries.erase(iter); }
+
+  /**
+   * @brief Check if a key is in the map.
+   */
+  bool Contains(const Key &key) const {
+    const_iterator iter = std::lower_bound(m_entries.begin(), m_entries.end(),
+                                           key, KeyLess());
+    return iter != m_entries.end() && !(key < iter->first);
+  }
+
+  size_t Size() const { return m_entries.size(); }
+  bool Empty() const { return m_entries.empty(); }
+  void Clear() { m_entries.clear(); }
+
+  /**
+   * @brief Iterate over the entries in key order.
+   */
+  iterator begin() { return m_entries.begin(); }
+  iterator end() { return m_entries.end(); }
+  const_iterator begin() const { return m_entries.begin(); }
+  const_iterator end() const { return m_entries.end(); }
+
+ private:
+  struct KeyLess {
+    bool operator()(const Entry &entry, const Key &key) const {
+      return entry.first < key;
+    }
+  };
+
+  std::vector<Entry> m_entries;
+
+  iterator LowerBound(const Key &key) {
+    return std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                            KeyLess());
+  }
+};
+/**
+ * @}
+ */
+}  // namespace ola
+#endif  // INCLUDE_OLA_STL_FLATMAP_H_
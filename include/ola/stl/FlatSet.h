@@ -0,0 +1,103 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FlatSet.h
+ * A set stored in a sorted vector.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_STL_FLATSET_H_
+#define INCLUDE_OLA_STL_FLATSET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace ola {
+
+/**
+ * @addtogroup stl
+ * @{
+ */
+
+/**
+ * @brief A set stored in a sorted vector.
+ * @tparam T the type of the members, this must be less-than comparable.
+ *
+ * The members are contiguous in memory, so iterating over the set is a linear
+ * scan rather than a walk over tree nodes. Lookups are a binary search.
+ * Inserting and removing members moves the members after them, so this suits
+ * small sets that are read far more often than they change.
+ */
+template <typename T>
+class FlatSet {
+ public:
+  typedef typename std::vector<T>::const_iterator const_iterator;
+
+  /**
+   * @brief Add a member to the set.
+   * @param value the member to add.
+   * @returns true if it was added, false if it was already in the set.
+   */
+  bool Insert(const T &value) {
+    typename std::vector<T>::iterator iter = std::lower_bound(
+        m_values.begin(), m_values.end(), value);
+    if (iter != m_values.end() && !(value < *iter)) {
+      return false;
+    }
+    m_values.insert(iter, value);
+    return true;
+  }
+
+  /**
+   * @brief Remove a member from the set.
+   * @param value the member to remove.
+   * @returns true if it was removed, false if it wasn't in the set.
+   */
+  bool Remove(const T &value) {
+    typename std::vector<T>::iterator iter = std::lower_bound(
+        m_values.begin(), m_values.end(), value);
+    if (iter == m_values.end() || value < *iter) {
+      return false;
+    }
+    m_values.erase(iter);
+    return true;
+  }
+
+  /**
+   * @brief Check if a value is in the set.
+   */
+  bool Contains(const T &value) const {
+    return std::binary_search(m_values.begin(), m_values.end(), value);
+  }
+
+  size_t Size() const { return m_values.size(); }
+  bool Empty() const { return m_values.empty(); }
+  void Clear() { m_values.clear(); }
+
+  /**
+   * @brief Iterate over the members in order.
+   */
+  const_iterator begin() const { return m_values.begin(); }
+  const_iterator end() const { return m_values.end(); }
+
+ private:
+  std::vector<T> m_values;
+};
+/**
+ * @}
+ */
+}  // namespace ola
+#endif  // INCLUDE_OLA_STL_FLATSET_H_
@@ -1,2 +1,5 @@
 olastlincludedir = $(pkgincludedir)/stl/
-olastlinclude_HEADERS = include/ola/stl/STLUtils.h
+olastlinclude_HEADERS = \
+    include/ola/stl/FlatMap.h \
+    include/ola/stl/FlatSet.h \
+    include/ola/stl/STLUtils.h
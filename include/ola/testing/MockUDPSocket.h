@@ -23,6 +23,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <ola/Clock.h>
 #include <ola/base/Macro.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/Socket.h>
@@ -79,6 +80,8 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
                  const ola::network::IPV4SocketAddress &dest) const {
     return SendTo(data, dest.Host(), dest.Port());
   }
+  unsigned int SendMany(const ola::network::UDPOutgoingDatagram *datagrams,
+                        unsigned int count) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(
@@ -93,6 +96,8 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
                 ola::network::IPV4SocketAddress *source);
+  unsigned int RecvMany(ola::network::UDPDatagram *datagrams,
+                        unsigned int count);
   bool EnableBroadcast();
   bool SetMulticastInterface(const ola::network::IPV4Address &iface);
   bool JoinMulticast(const ola::network::IPV4Address &iface,
@@ -100,9 +105,16 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
                      bool multicast_loop = false);
   bool LeaveMulticast(const ola::network::IPV4Address &iface,
                       const ola::network::IPV4Address &group);
+  bool SetMulticastAll(bool enable);
 
   bool SetTos(uint8_t tos);
 
+  bool SetReceiveBufferSize(unsigned int size);
+  bool SetSendBufferSize(unsigned int size);
+  bool EnableDropCounting();
+  uint32_t DroppedDatagrams() const { return m_dropped; }
+  bool EnableReceiveTimestamps();
+
   void SetDiscardMode(bool discard_mode) { m_discard_mode = discard_mode; }
 
   // these are methods used for verification
@@ -133,6 +145,15 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
 
   void SetInterface(const ola::network::IPV4Address &iface);
 
+  unsigned int ReceiveBufferSize() const { return m_receive_buffer_size; }
+  unsigned int SendBufferSize() const { return m_send_buffer_size; }
+  bool DropCountingEnabled() const { return m_count_drops; }
+  // Simulate the kernel dropping datagrams.
+  void SetDroppedDatagrams(uint32_t dropped) { m_dropped = dropped; }
+  bool ReceiveTimestampsEnabled() const { return m_timestamps; }
+  // The arrival time given to the datagrams, if timestamps are enabled.
+  void SetArrivalTime(const TimeStamp &arrival) { m_arrival = arrival; }
+
  private:
   typedef struct {
     const uint8_t *data;
@@ -152,6 +173,12 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool m_broadcast_set;
   uint16_t m_port;
   uint8_t m_tos;
+  unsigned int m_receive_buffer_size;
+  unsigned int m_send_buffer_size;
+  bool m_count_drops;
+  uint32_t m_dropped;
+  bool m_timestamps;
+  TimeStamp m_arrival;
   mutable std::queue<expected_call> m_expected_calls;
   mutable std::queue<received_data> m_received_data;
   ola::network::IPV4Address m_interface;
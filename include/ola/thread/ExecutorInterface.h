@@ -21,6 +21,7 @@
 #define INCLUDE_OLA_THREAD_EXECUTORINTERFACE_H_
 
 #include <ola/Callback.h>
+#include <ola/InlineCallback.h>
 
 namespace ola {
 namespace thread {
@@ -59,6 +60,18 @@ class ExecutorInterface {
    */
   virtual void Execute(ola::BaseCallback0<void> *callback) = 0;
 
+  /**
+   * @brief Execute a callback that's stored by value.
+   * @param callback the callback to run, this is copied.
+   *
+   * This provides the same guarantees as the version above. The default
+   * implementation copies the callback to the heap, implementations that can
+   * queue it by value should override this.
+   */
+  virtual void Execute(const ola::InlineCallback0<void> &callback) {
+    Execute(ola::ToSingleUseCallback(callback));
+  }
+
   /**
    * @brief Run all callbacks until there are none left.
    */
@@ -65,6 +65,7 @@ class ExecutorThread : public ola::thread::ExecutorInterface {
 
   ~ExecutorThread();
 
+  using ExecutorInterface::Execute;
   void Execute(ola::BaseCallback0<void> *callback);
 
   /**
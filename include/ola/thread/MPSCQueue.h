@@ -0,0 +1,206 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * MPSCQueue.h
+ * A lock-free multi-producer, single-consumer queue.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_MPSCQUEUE_H_
+#define INCLUDE_OLA_THREAD_MPSCQUEUE_H_
+
+#include <ola/base/Macro.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief A lock-free queue with many producers and a single consumer.
+ *
+ * Producers push onto a linked list with a compare-and-swap. The consumer
+ * takes the entire list in one atomic exchange and reverses it, so items are
+ * returned in the order they were pushed. Since the consumer never removes
+ * individual nodes there's no ABA problem.
+ *
+ * Push() returns true if the queue was empty, which lets the producer signal
+ * the consumer only once for each batch.
+ *
+ * The consumer returns the nodes to a free list, so once the queue has warmed
+ * up Push() doesn't allocate. Producers take the whole free list with an
+ * atomic exchange and put back what they don't use, so they never read the
+ * next pointer of a node another thread may own, which again avoids ABA. A
+ * recycled node holds on to its last value until it's reused.
+ *
+ * This uses the GCC atomic builtins, which are also supported by clang.
+ */
+template <typename T>
+class MPSCQueue {
+ public:
+  MPSCQueue() : m_head(NULL), m_free(NULL), m_node_count(0) {}
+
+  /**
+   * @brief Destructor, this discards any items that haven't been popped.
+   */
+  ~MPSCQueue() {
+    DeleteNodes(m_head);
+    DeleteNodes(m_free);
+  }
+
+  /**
+   * @brief Add an item to the queue. This may be called from any thread.
+   * @param value the item to add.
+   * @returns true if the queue was empty before this item was added.
+   */
+  bool Push(const T &value) {
+    Node *node = TakeFreeNode();
+    if (node) {
+      node->value = value;
+    } else {
+      node = new Node(value);
+      __sync_fetch_and_add(&m_node_count, 1);
+    }
+
+    Node *head = m_head;
+    while (true) {
+      node->next = head;
+      Node *previous = __sync_val_compare_and_swap(&m_head, head, node);
+      if (previous == head) {
+        break;
+      }
+      head = previous;
+    }
+    return head == NULL;
+  }
+
+  /**
+   * @brief Remove all items from the queue. This must only be called from the
+   *   consumer thread.
+   * @param[out] output the vector to append the items to, oldest first.
+   * @returns the number of items removed.
+   */
+  unsigned int PopAll(std::vector<T> *output) {
+    Node *node = __sync_lock_test_and_set(&m_head, static_cast<Node*>(NULL));
+
+    Node *reversed = NULL;
+    while (node) {
+      Node *next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+
+    unsigned int count = 0;
+    Node *last = NULL;
+    for (node = reversed; node; node = node->next) {
+      output->push_back(node->value);
+      last = node;
+      count++;
+    }
+    if (reversed) {
+      ReturnNodes(reversed, last);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Check if the queue is empty.
+   *
+   * This is only a snapshot, another thread may push an item immediately
+   * afterwards.
+   */
+  bool Empty() const { return m_head == NULL; }
+
+  /**
+   * @brief Return the number of nodes that have been allocated.
+   *
+   * This stops growing once there are enough nodes for the most items ever
+   * queued at once, plus a few if producers race for the free list.
+   */
+  unsigned int NodeCount() const { return m_node_count; }
+
+ private:
+  struct Node {
+    explicit Node(const T &value) : value(value), next(NULL) {}
+
+    T value;
+    Node *next;
+  };
+
+  Node *volatile m_head;
+  Node *volatile m_free;
+  unsigned int m_node_count;
+
+  /*
+   * Take a node from the free list, or return NULL if it's empty.
+   */
+  Node *TakeFreeNode() {
+    if (!m_free) {
+      return NULL;
+    }
+    Node *node = __sync_lock_test_and_set(&m_free, static_cast<Node*>(NULL));
+    if (!node) {
+      return NULL;
+    }
+
+    // Put the rest back. Usually nothing else has been freed in the meantime,
+    // otherwise take those as well and join them to the front.
+    Node *rest = node->next;
+    while (rest && !__sync_bool_compare_and_swap(&m_free,
+                                                 static_cast<Node*>(NULL),
+                                                 rest)) {
+      Node *freed = __sync_lock_test_and_set(&m_free,
+                                             static_cast<Node*>(NULL));
+      if (freed) {
+        Node *last = freed;
+        while (last->next) {
+          last = last->next;
+        }
+        last->next = rest;
+        rest = freed;
+      }
+    }
+    return node;
+  }
+
+  /*
+   * Add the list of nodes from first to last to the free list.
+   */
+  void ReturnNodes(Node *first, Node *last) {
+    Node *head = m_free;
+    while (true) {
+      last->next = head;
+      Node *previous = __sync_val_compare_and_swap(&m_free, head, first);
+      if (previous == head) {
+        return;
+      }
+      head = previous;
+    }
+  }
+
+  static void DeleteNodes(Node *node) {
+    while (node) {
+      Node *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(MPSCQueue);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_MPSCQUEUE_H_
@@ -6,6 +6,7 @@ olathreadinclude_HEADERS = \
     include/ola/thread/ExecutorThread.h \
     include/ola/thread/Future.h \
     include/ola/thread/FuturePrivate.h \
+    include/ola/thread/MPSCQueue.h \
     include/ola/thread/Mutex.h \
     include/ola/thread/PeriodicThread.h \
     include/ola/thread/SchedulerInterface.h \
@@ -13,4 +14,7 @@ olathreadinclude_HEADERS = \
     include/ola/thread/SignalThread.h \
     include/ola/thread/Thread.h \
     include/ola/thread/ThreadPool.h \
-    include/ola/thread/Utils.h
+    include/ola/thread/ThreadRoles.h \
+    include/ola/thread/TripleBuffer.h \
+    include/ola/thread/Utils.h \
+    include/ola/thread/WorkStealingThreadPool.h
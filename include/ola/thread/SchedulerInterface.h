@@ -24,6 +24,7 @@
 
 #include <ola/Callback.h>
 #include <ola/Clock.h>
+#include <ola/InlineCallback.h>
 
 namespace ola {
 namespace thread {
@@ -95,6 +96,50 @@ class SchedulerInterface {
       const ola::TimeInterval &delay,
       SingleUseCallback0<void> *callback) = 0;
 
+  /**
+   * @brief Execute a callback that's stored by value after a certain time
+   *   interval.
+   * @param delay the time interval to wait before the callback is executed.
+   * @param callback the callback to run, this is copied.
+   * @returns a timeout_id which can be used later to cancel the timeout.
+   *
+   * The default implementation copies the callback to the heap,
+   * implementations that can store it by value should override this.
+   */
+  virtual timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &delay,
+      const InlineCallback0<void> &callback) {
+    return RegisterSingleTimeout(delay, ToSingleUseCallback(callback));
+  }
+
+  /**
+   * @brief Run a housekeeping task periodically.
+   * @param period the time interval between each run of the task.
+   * @param callback the task to run. Ownership is transferred.
+   * @returns a timeout_id which can be passed to RemovePeriodicTask().
+   *
+   * Unlike RegisterRepeatingTimeout(), the task may run up to a tenth of the
+   * period late, and the first run is at a random point in the first period.
+   * This lets the scheduler batch periodic work from many components into
+   * fewer wakeups. Returning false from the callback will cause it to be
+   * cancelled.
+   *
+   * The default implementation uses RegisterRepeatingTimeout().
+   */
+  virtual timeout_id RegisterPeriodicTask(
+      const ola::TimeInterval &period,
+      Callback0<bool> *callback) {
+    return RegisterRepeatingTimeout(period, callback);
+  }
+
+  /**
+   * @brief Cancel a task added with RegisterPeriodicTask().
+   * @param id the timeout_id returned by RegisterPeriodicTask().
+   */
+  virtual void RemovePeriodicTask(timeout_id id) {
+    RemoveTimeout(id);
+  }
+
   /**
    * @brief Cancel an existing timeout
    * @param id the timeout_id returned by a call to RegisterRepeatingTimeout or
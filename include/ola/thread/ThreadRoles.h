@@ -0,0 +1,145 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadRoles.h
+ * CPU placement and scheduling for threads, chosen by name.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file
+ * @brief CPU placement and scheduling for threads, chosen by name.
+ *
+ * Each Thread applies the role matching its name when it starts, and is
+ * registered so its CPU time can be read from other threads. A process sets
+ * the roles once, before it starts any threads, e.g. olad's --thread-roles.
+ */
+
+#ifndef INCLUDE_OLA_THREAD_THREADROLES_H_
+#define INCLUDE_OLA_THREAD_THREADROLES_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief Where and how the threads with a role run.
+ */
+struct ThreadRole {
+  ThreadRole() : set_scheduling(false), policy(SCHED_OTHER), priority(0) {}
+
+  /**
+   * @brief The CPUs the threads may run on. If empty the affinity isn't
+   *   changed.
+   */
+  std::vector<unsigned int> cpus;
+
+  /**
+   * @brief If true, the policy and priority are applied.
+   */
+  bool set_scheduling;
+  int policy;
+  int priority;
+};
+
+/**
+ * @brief Roles by thread name. A name ending in '*' matches the threads
+ *   whose names start with the rest of it.
+ */
+typedef std::map<std::string, ThreadRole> ThreadRoleMap;
+
+/**
+ * @brief Parse a list of roles.
+ * @param input roles separated by ';', each of the form
+ *   `name[:setting]...`. The settings are:
+ *    - `cpus=LIST`, the CPUs to run on, e.g. `2-3,6`.
+ *    - `node=N`, run on the CPUs of NUMA node N. Memory the threads touch
+ *      first is then allocated on that node.
+ *    - `fifo=PRIORITY` or `rr=PRIORITY`, use SCHED_FIFO or SCHED_RR.
+ *    - `other`, use SCHED_OTHER.
+ * @param[out] roles the roles.
+ * @returns false if the input was invalid, the reason is logged.
+ *
+ * e.g. `main:cpus=1:fifo=40;usb-*:node=0:fifo=30;pref-saver:cpus=0`
+ */
+bool ParseThreadRoles(const std::string &input, ThreadRoleMap *roles);
+
+/**
+ * @brief Parse a list of CPUs, in the format of the Linux cpulist files.
+ * @param input comma separated CPUs and ranges of CPUs, e.g. `0-3,8`.
+ * @param[out] cpus the CPUs, in ascending order without duplicates.
+ * @returns false if the input was invalid.
+ */
+bool ParseCPUList(const std::string &input, std::vector<unsigned int> *cpus);
+
+/**
+ * @brief Get the CPUs of a NUMA node.
+ * @returns false if the node doesn't exist or the platform doesn't describe
+ *   NUMA nodes.
+ */
+bool NumaNodeCPUs(unsigned int node, std::vector<unsigned int> *cpus);
+
+/**
+ * @brief Set the roles used by ApplyThreadRole().
+ *
+ * This must be called before any threads are started.
+ */
+void SetThreadRoles(const ThreadRoleMap &roles);
+
+/**
+ * @brief Find the role for a thread.
+ * @returns false if no role matches. An exact match is used before the
+ *   longest matching prefix.
+ */
+bool FindThreadRole(const std::string &name, ThreadRole *role);
+
+/**
+ * @brief Apply the role for a name to the calling thread.
+ * @returns false if a role matched but couldn't be applied, true otherwise.
+ *
+ * Thread::Start() calls this in the new thread. Threads which aren't a
+ * Thread, like a program's main thread, can call it themselves.
+ */
+bool ApplyThreadRole(const std::string &name);
+
+/**
+ * @brief Register the calling thread, so its CPU time is reported by
+ *   GetThreadCPUTimes().
+ *
+ * Every thread must call UnregisterThread() before it exits.
+ */
+void RegisterThread(const std::string &name);
+
+/**
+ * @brief Unregister the calling thread.
+ */
+void UnregisterThread();
+
+/**
+ * @brief Get the CPU time used by the registered threads.
+ * @param[out] times the CPU time in microseconds, by thread name. The times
+ *   of threads with the same name are added together.
+ * @returns false if the platform can't read the CPU time of other threads.
+ */
+bool GetThreadCPUTimes(std::map<std::string, uint64_t> *times);
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_THREADROLES_H_
@@ -0,0 +1,170 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TripleBuffer.h
+ * A lock-free mailbox that holds the latest value.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
+#define INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
+
+#include <ola/base/Macro.h>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief A wait-free mailbox that passes the latest value from one producer
+ *   thread to one consumer thread.
+ *
+ * There are three slots. The producer owns one, which it fills in place with
+ * WriteSlot() and then hands over with Publish(). The consumer owns another,
+ * which it reads with ReadSlot(), and Fetch() swaps it for the most recently
+ * published one. The third slot is the one in the middle, it's exchanged
+ * with a single compare-and-swap so neither side ever waits for the other.
+ *
+ * Values that are published faster than they're fetched are overwritten,
+ * Publish() returns true when that happens so the producer can count the
+ * dropped frames.
+ *
+ * The slots are reused, so for types like DmxBuffer that own their storage,
+ * filling a slot with Set() doesn't allocate once it has grown to full size.
+ * Don't use DmxBuffer's assignment operator to fill a slot, that shares the
+ * data with the source buffer, which isn't safe between threads.
+ *
+ * @code
+ *   // Producer
+ *   mailbox.WriteSlot()->Set(buffer);
+ *   mailbox.Publish();
+ *
+ *   // Consumer
+ *   mailbox.Fetch();
+ *   Send(*mailbox.ReadSlot());
+ * @endcode
+ *
+ * This uses the GCC atomic builtins, which are also supported by clang.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer()
+      : m_slots(),
+        m_write_index(0),
+        m_state(1),
+        m_read_index(2) {
+  }
+
+  /**
+   * @brief The slot to fill. This must only be called from the producer
+   *   thread.
+   */
+  T *WriteSlot() { return &m_slots[m_write_index]; }
+
+  /**
+   * @brief Make the contents of WriteSlot() available to the consumer. This
+   *   must only be called from the producer thread.
+   * @returns true if the previously published value was overwritten before
+   *   the consumer fetched it.
+   *
+   * Afterwards WriteSlot() returns a different slot, which holds an older
+   * value.
+   */
+  bool Publish() {
+    unsigned int state = m_state;
+    while (true) {
+      unsigned int previous = __sync_val_compare_and_swap(
+          &m_state, state, m_write_index | NEW_VALUE);
+      if (previous == state) {
+        break;
+      }
+      state = previous;
+    }
+    m_write_index = state & INDEX_MASK;
+    return (state & NEW_VALUE) != 0;
+  }
+
+  /**
+   * @brief Copy a value into WriteSlot() and publish it.
+   * @param value the value to publish, T's assignment operator must make a
+   *   deep copy.
+   * @returns true if the previously published value was overwritten before
+   *   the consumer fetched it.
+   */
+  bool Write(const T &value) {
+    *WriteSlot() = value;
+    return Publish();
+  }
+
+  /**
+   * @brief Check if there is a value the consumer hasn't fetched yet.
+   *
+   * This is only a snapshot, the producer may publish a value immediately
+   * afterwards.
+   */
+  bool HasNewValue() const {
+    return (__sync_fetch_and_add(&m_state, 0) & NEW_VALUE) != 0;
+  }
+
+  /**
+   * @brief Swap ReadSlot() for the latest published value. This must only be
+   *   called from the consumer thread.
+   * @returns true if ReadSlot() now holds a new value, false if nothing has
+   *   been published since the last call, in which case ReadSlot() is
+   *   unchanged.
+   */
+  bool Fetch() {
+    unsigned int state = m_state;
+    while (state & NEW_VALUE) {
+      unsigned int previous = __sync_val_compare_and_swap(&m_state, state,
+                                                          m_read_index);
+      if (previous == state) {
+        m_read_index = state & INDEX_MASK;
+        return true;
+      }
+      state = previous;
+    }
+    return false;
+  }
+
+  /**
+   * @brief The latest value the consumer has fetched. This must only be
+   *   called from the consumer thread.
+   *
+   * Until the first value is fetched this is a value-initialized T.
+   */
+  T *ReadSlot() { return &m_slots[m_read_index]; }
+
+ private:
+  enum {
+    INDEX_MASK = 0x3,
+    NEW_VALUE = 0x4
+  };
+
+  // Each slot is only touched by one thread at a time, so the slots don't
+  // need padding. Keep the state on its own cache line though, since both
+  // threads update it for every frame.
+  T m_slots[3];
+  unsigned int m_write_index;  // owned by the producer
+  char m_producer_padding[64];
+  mutable unsigned int m_state;  // the middle slot | NEW_VALUE, atomic
+  char m_consumer_padding[64];
+  unsigned int m_read_index;  // owned by the consumer
+
+  DISALLOW_COPY_AND_ASSIGN(TripleBuffer);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_TRIPLEBUFFER_H_
@@ -23,6 +23,7 @@
 
 #include <pthread.h>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace thread {
@@ -44,6 +45,22 @@ std::string PolicyToString(int policy);
 bool SetSchedParam(pthread_t thread, int policy,
                    const struct sched_param &param);
 
+/**
+ * @brief Pin the calling thread to a CPU.
+ * @param cpu the CPU to run on.
+ * @returns True if the thread was pinned, false if it failed or the platform
+ *   doesn't support sched_setaffinity().
+ */
+bool SetCPUAffinity(int cpu);
+
+/**
+ * @brief Restrict the calling thread to a set of CPUs.
+ * @param cpus the CPUs to run on.
+ * @returns True if the affinity was set, false if it failed or the platform
+ *   doesn't support sched_setaffinity().
+ */
+bool SetCPUAffinity(const std::vector<unsigned int> &cpus);
+
 }  // namespace thread
 }  // namespace ola
 #endif  // INCLUDE_OLA_THREAD_UTILS_H_
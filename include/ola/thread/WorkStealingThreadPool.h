@@ -0,0 +1,238 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * WorkStealingThreadPool.h
+ * A thread pool with a deque per worker.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_THREAD_WORKSTEALINGTHREADPOOL_H_
+#define INCLUDE_OLA_THREAD_WORKSTEALINGTHREADPOOL_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/Future.h>
+#include <ola/thread/Mutex.h>
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace thread {
+
+/**
+ * @brief A thread pool where each worker has its own deque of tasks.
+ *
+ * Tasks queued from a worker go onto that worker's deque, tasks queued from
+ * any other thread are spread across the workers round robin. A worker runs
+ * the newest task on its own deque first, since that's the one most likely
+ * to be in cache, and once its deque is empty it steals the oldest task from
+ * one of the other workers.
+ *
+ * Submit() returns a Future for the task's result. A task can fan out by
+ * submitting more tasks and then calling Wait() on the futures, which runs
+ * other queued tasks in the meantime rather than blocking the worker.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~
+  WorkStealingThreadPool pool;
+  pool.Init();
+  Future<int> result = pool.Submit(NewSingleCallback(&ExpensiveFunction));
+  // do something else
+  pool.Wait(&result);
+  int value = result.Get();
+ * ~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Since the tasks run in parallel, the only ordering guarantee
+ * ExecutorInterface provides for this class is that tasks passed to
+ * ExecuteOn() for the same worker run in the order they were queued.
+ */
+class WorkStealingThreadPool : public ExecutorInterface {
+ public:
+  typedef ola::BaseCallback0<void>* Action;
+
+  struct Options {
+   public:
+    Options()
+        : thread_count(2),
+          name("ola-pool") {
+    }
+
+    /**
+     * @brief The number of worker threads.
+     */
+    unsigned int thread_count;
+
+    /**
+     * @brief The CPUs to pin the workers to.
+     *
+     * Worker N is pinned to cpus[N % cpus.size()]. If empty, the workers
+     * aren't pinned.
+     */
+    std::vector<int> cpus;
+
+    /**
+     * @brief The prefix for the names of the worker threads.
+     */
+    std::string name;
+  };
+
+  explicit WorkStealingThreadPool(const Options &options = Options());
+
+  /**
+   * @brief Destructor. This stops the workers and runs any remaining tasks.
+   */
+  ~WorkStealingThreadPool();
+
+  /**
+   * @brief Start the worker threads.
+   * @returns true if all the workers started, false otherwise.
+   */
+  bool Init();
+
+  /**
+   * @brief Stop the workers.
+   *
+   * Tasks still queued once the workers have stopped are run in the calling
+   * thread.
+   */
+  void JoinAll();
+
+  /**
+   * @brief The number of workers.
+   */
+  unsigned int WorkerCount() const { return m_queues.size(); }
+
+  /**
+   * @brief Return the index of the worker the calling thread is, or -1 if
+   *   it isn't one of this pool's workers.
+   */
+  int CurrentWorker() const;
+
+  /**
+   * @brief Queue a task, which may be run by any of the workers.
+   */
+  void Execute(ola::BaseCallback0<void> *task);
+  using ExecutorInterface::Execute;
+
+  /**
+   * @brief Queue a task that must run on a particular worker.
+   * @param worker the index of the worker, modulo WorkerCount().
+   * @param task the task to run.
+   *
+   * This is useful for tasks that need to stay on the same CPU, or that
+   * touch state owned by one worker. These tasks are never stolen.
+   */
+  void ExecuteOn(unsigned int worker, ola::BaseCallback0<void> *task);
+
+  /**
+   * @brief Block until all queued and running tasks have completed.
+   *
+   * The calling thread runs queued tasks while it waits.
+   */
+  void DrainCallbacks();
+
+  /**
+   * @brief Queue a task and return a Future for its result.
+   * @param task the task to run.
+   * @returns A Future which is set once the task has run.
+   */
+  template <typename T>
+  Future<T> Submit(SingleUseCallback0<T> *task) {
+    Future<T> future;
+    Execute(NewSingleCallback(&WorkStealingThreadPool::RunAndSet<T>,
+                              task, future));
+    return future;
+  }
+
+  /**
+   * @brief Queue a task and return a Future that is set once it has run.
+   * @param task the task to run.
+   * @returns A Future which is set once the task has run.
+   */
+  Future<void> Submit(SingleUseCallback0<void> *task);
+
+  /**
+   * @brief Wait for a Future from Submit(), running other tasks meanwhile.
+   * @param future the Future to wait for.
+   *
+   * This is safe to call from a task, even with a single worker. The Future
+   * must be set by one of this pool's tasks, use Future::Get() to wait for
+   * Futures set elsewhere.
+   */
+  template <typename T>
+  void Wait(Future<T> *future) {
+    WaitUntil(NewCallback(&WorkStealingThreadPool::IsComplete<T>, future));
+  }
+
+ private:
+  struct WorkQueue {
+    WorkQueue() : pinned_count(0) {}
+
+    Mutex mutex;  // protects tasks & pinned
+    std::deque<Action> tasks;
+    std::deque<Action> pinned;
+    int pinned_count;  // atomic, the size of pinned
+  };
+
+  class Worker;
+
+  const Options m_options;
+  std::vector<WorkQueue*> m_queues;
+  std::vector<Worker*> m_workers;
+  pthread_key_t m_worker_key;
+
+  // These are updated with the atomic builtins.
+  int m_queued;  // the number of tasks in the stealable deques.
+  int m_outstanding;  // the number of tasks not yet completed.
+  int m_sleepers;  // the number of threads waiting on m_condition.
+  int m_waiters;  // the number of threads in Wait() or DrainCallbacks().
+  unsigned int m_next_queue;
+
+  Mutex m_mutex;  // protects m_shutdown
+  ConditionVariable m_condition;
+  bool m_shutdown;
+
+  void WorkerLoop(Worker *worker);
+  bool RunOneTask(int worker);
+  bool PopOwnTask(unsigned int worker, Action *task);
+  bool StealTask(int thief, Action *task);
+  void RunTask(Action task);
+  void WaitUntil(BaseCallback0<bool> *is_complete);
+  bool AllTasksComplete();
+  void PushTask(WorkQueue *queue, Action task, bool pinned);
+  void JoinAllThreads();
+  void RunRemaining();
+  bool HasWork(int worker);
+
+  template <typename T>
+  static void RunAndSet(SingleUseCallback0<T> *task, Future<T> future) {
+    future.Set(task->Run());
+  }
+
+  static void RunAndSetVoid(SingleUseCallback0<void> *task,
+                            Future<void> future);
+
+  template <typename T>
+  static bool IsComplete(Future<T> *future) {
+    return future->IsComplete();
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+}  // namespace thread
+}  // namespace ola
+#endif  // INCLUDE_OLA_THREAD_WORKSTEALINGTHREADPOOL_H_
@@ -1,6 +1,8 @@
 olatimecodeincludedir = $(pkgincludedir)/timecode/
 
-olatimecodeinclude_HEADERS = include/ola/timecode/TimeCode.h
+olatimecodeinclude_HEADERS = \
+    include/ola/timecode/TimeCode.h \
+    include/ola/timecode/TimeCodeSharedMemory.h
 nodist_olatimecodeinclude_HEADERS = include/ola/timecode/TimeCodeEnums.h
 
 dist_noinst_SCRIPTS += include/ola/timecode/make_timecode.sh
@@ -46,6 +46,26 @@ class TimeCode {
 
     bool IsValid() const;
 
+    /**
+     * @brief The number of frames since 00:00:00:00.
+     *
+     * For drop frame timecode this skips the frame numbers that aren't used,
+     * so consecutive frames always have consecutive frame numbers.
+     */
+    uint32_t FrameNumber() const;
+
+    /**
+     * @brief Build a timecode from the number of frames since 00:00:00:00.
+     * @param type the type of timecode.
+     * @param frame_number the frame number, this wraps at midnight.
+     */
+    static TimeCode FromFrameNumber(TimeCodeType type, uint32_t frame_number);
+
+    /**
+     * @brief The number of frames in a day.
+     */
+    static uint32_t FramesPerDay(TimeCodeType type);
+
     TimeCodeType Type() const { return m_type; }
     uint8_t Hours() const { return m_hours; }
     uint8_t Minutes() const { return m_minutes; }
@@ -68,6 +88,8 @@ class TimeCode {
     static const uint8_t MAX_HOURS = 23;
     static const uint8_t MAX_MINUTES = 59;
     static const uint8_t MAX_SECONDS = 59;
+
+    static unsigned int FramesPerSecond(TimeCodeType type);
 };
 }  // namespace timecode
 }  // namespace ola
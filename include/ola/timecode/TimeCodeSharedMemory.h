@@ -0,0 +1,134 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimeCodeSharedMemory.h
+ * The current timecode, published through shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file TimeCodeSharedMemory.h
+ * @brief The current timecode, published through shared memory.
+ */
+
+#ifndef INCLUDE_OLA_TIMECODE_TIMECODESHAREDMEMORY_H_
+#define INCLUDE_OLA_TIMECODE_TIMECODESHAREDMEMORY_H_
+
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/timecode/TimeCode.h>
+#include <stdint.h>
+#include <string>
+
+namespace ola {
+namespace timecode {
+
+/**
+ * @brief A POSIX shared memory segment holding the last timecode frame olad
+ * sent.
+ *
+ * This lets other processes on the same machine follow the timecode without
+ * an RPC per frame. The frame is protected by a sequence counter, which is
+ * odd while the writer is updating it, so readers never see a half written
+ * frame and never block the writer. There's a single writer (olad) and any
+ * number of readers.
+ */
+class TimeCodeSharedMemory {
+ public:
+  /**
+   * @brief A timecode frame.
+   */
+  struct Frame {
+    Frame()
+        : timecode(TIMECODE_FILM, 0, 0, 0, 0),
+          frame_number(0),
+          running(false) {
+    }
+
+    /** @brief The timecode. */
+    TimeCode timecode;
+    /** @brief The frame number, see TimeCode::FrameNumber(). */
+    uint32_t frame_number;
+    /** @brief When the frame started, from the writer's clock. */
+    TimeStamp frame_time;
+    /** @brief False once the timecode has stopped. */
+    bool running;
+  };
+
+  ~TimeCodeSharedMemory();
+
+  /**
+   * @brief Create a new segment, for the writer.
+   * @param name the name of the segment, this should start with a /.
+   * @returns a new TimeCodeSharedMemory or NULL if the segment couldn't be
+   *   created.
+   *
+   * Any existing segment with the same name is replaced, since it was left
+   * behind by a writer that didn't exit cleanly.
+   */
+  static TimeCodeSharedMemory *Create(const std::string &name);
+
+  /**
+   * @brief Open an existing segment, for a reader.
+   * @param name the name of the segment.
+   * @returns a new TimeCodeSharedMemory or NULL if the segment couldn't be
+   *   opened or isn't valid.
+   */
+  static TimeCodeSharedMemory *Open(const std::string &name);
+
+  /**
+   * @brief The name of the segment.
+   */
+  const std::string &Name() const { return m_name; }
+
+  /**
+   * @brief Remove the name of the segment, the memory remains valid until
+   * all processes have unmapped it.
+   */
+  void Unlink();
+
+  /**
+   * @brief Publish a frame. This must only be called by the writer.
+   */
+  void Write(const Frame &frame);
+
+  /**
+   * @brief Read the last frame.
+   * @param[out] frame the last frame written.
+   * @returns true if a frame was read, false if no frame has been written or
+   *   the writer kept updating the frame while it was being read.
+   */
+  bool Read(Frame *frame) const;
+
+  /**
+   * @brief The name olad uses for the segment.
+   */
+  static const char DEFAULT_NAME[];
+
+ private:
+  struct Segment;
+
+  const std::string m_name;
+  void *m_memory;
+  const bool m_writable;
+  Segment *m_segment;
+
+  TimeCodeSharedMemory(const std::string &name, void *memory, bool writable);
+
+  DISALLOW_COPY_AND_ASSIGN(TimeCodeSharedMemory);
+};
+}  // namespace timecode
+}  // namespace ola
+#endif  // INCLUDE_OLA_TIMECODE_TIMECODESHAREDMEMORY_H_
@@ -0,0 +1,93 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Histogram.h
+ * A fixed size histogram for latency measurements.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLA_UTIL_HISTOGRAM_H_
+#define INCLUDE_OLA_UTIL_HISTOGRAM_H_
+
+#include <stdint.h>
+
+namespace ola {
+
+/**
+ * @brief A histogram with log-linear buckets.
+ *
+ * Values below 16 are counted exactly, above that each power of two is split
+ * into 8 buckets, so percentiles are accurate to within 12.5%. The maximum is
+ * tracked exactly. Adding a value is constant time and the histogram doesn't
+ * allocate memory, which makes it suitable for per-frame measurements.
+ *
+ * This class isn't thread safe.
+ */
+class Histogram {
+ public:
+  Histogram();
+
+  /**
+   * @brief Add a value to the histogram.
+   */
+  void Add(uint32_t value);
+
+  /**
+   * @brief Remove all values.
+   */
+  void Reset();
+
+  /**
+   * @brief The number of values added.
+   */
+  uint64_t Count() const { return m_count; }
+
+  /**
+   * @brief The sum of the values added.
+   */
+  uint64_t Sum() const { return m_sum; }
+
+  /**
+   * @brief The largest value added, or 0 if the histogram is empty.
+   */
+  uint32_t Max() const { return m_max; }
+
+  /**
+   * @brief Return a percentile.
+   * @param percentile the percentile, between 0 and 100.
+   * @returns the upper bound of the bucket that holds the percentile, capped
+   *   to Max(). Returns 0 if the histogram is empty.
+   */
+  uint32_t Percentile(unsigned int percentile) const;
+
+ private:
+  enum {
+    SUB_BUCKET_BITS = 3,
+    SUB_BUCKETS = 1 << SUB_BUCKET_BITS,
+    // values less than this are counted exactly
+    LINEAR_LIMIT = 2 * SUB_BUCKETS,
+    BUCKET_COUNT = LINEAR_LIMIT + (32 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS,
+  };
+
+  uint32_t m_buckets[BUCKET_COUNT];
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint32_t m_max;
+
+  static unsigned int BucketFor(uint32_t value);
+  static uint32_t BucketUpperBound(unsigned int bucket);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_UTIL_HISTOGRAM_H_
@@ -2,6 +2,8 @@ olautilincludedir = $(pkgincludedir)/util/
 olautilinclude_HEADERS = \
     include/ola/util/Backoff.h \
     include/ola/util/Deleter.h \
+    include/ola/util/Histogram.h \
     include/ola/util/SequenceNumber.h \
+    include/ola/util/Trace.h \
     include/ola/util/Utils.h \
     include/ola/util/Watchdog.h
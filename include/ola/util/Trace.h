@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Trace.h
+ * Records trace events in per-thread ring buffers.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file Trace.h
+ * @brief Trace events which can be viewed in Perfetto or chrome://tracing.
+ *
+ * Tracing is off by default, when it's off recording an event costs a
+ * function call. Once StartTracing() has been called each thread records
+ * events into its own ring buffer, so the most recent events are kept. Call
+ * WriteChromeTrace() to dump the buffers in the Chrome trace event format.
+ *
+ * @examplepara
+ * @code
+ *   void Universe::MergeAll() {
+ *     ola::TraceSpan span("universe.merge", "universe", m_universe_id);
+ *     ...
+ *   }
+ * @endcode
+ *
+ * Event and argument names must be string literals, since only the pointers
+ * are stored. They're written to the trace without escaping.
+ */
+
+#ifndef INCLUDE_OLA_UTIL_TRACE_H_
+#define INCLUDE_OLA_UTIL_TRACE_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ostream>
+
+namespace ola {
+
+/**
+ * @brief The default number of events kept for each thread.
+ */
+static const unsigned int DEFAULT_TRACE_EVENTS = 16384;
+
+/**
+ * @brief Start recording trace events.
+ * @param events_per_thread the number of events to keep for each thread.
+ *
+ * Any events already recorded are discarded.
+ */
+void StartTracing(unsigned int events_per_thread = DEFAULT_TRACE_EVENTS);
+
+/**
+ * @brief Stop recording trace events.
+ *
+ * The events recorded so far are kept, so they can still be written.
+ */
+void StopTracing();
+
+/**
+ * @brief Check if trace events are being recorded.
+ */
+bool TracingEnabled();
+
+/**
+ * @brief Write the recorded events in the Chrome trace event format.
+ * @param output the stream to write the JSON to.
+ */
+void WriteChromeTrace(std::ostream *output);
+
+/**
+ * @brief Mark the start of an operation that may finish on another thread.
+ * @param name the name of the operation.
+ * @param id an id to match the start and the end, the address of the object
+ *   involved is usually a good choice.
+ */
+void TraceAsyncBegin(const char *name, uint64_t id);
+
+/**
+ * @brief Mark the end of an operation started with TraceAsyncBegin().
+ * @param name the name used with TraceAsyncBegin().
+ * @param id the id used with TraceAsyncBegin().
+ */
+void TraceAsyncEnd(const char *name, uint64_t id);
+
+/**
+ * @brief Records an event covering the lifetime of the object.
+ */
+class TraceSpan {
+ public:
+  /**
+   * @brief Start a span.
+   * @param name the name of the event.
+   */
+  explicit TraceSpan(const char *name)
+      : m_name(NULL),
+        m_arg_name(NULL),
+        m_arg(0),
+        m_start(0) {
+    if (TracingEnabled()) {
+      Begin(name, NULL, 0);
+    }
+  }
+
+  /**
+   * @brief Start a span with an argument.
+   * @param name the name of the event.
+   * @param arg_name the name of the argument, e.g. "universe".
+   * @param arg the value of the argument.
+   */
+  TraceSpan(const char *name, const char *arg_name, int64_t arg)
+      : m_name(NULL),
+        m_arg_name(NULL),
+        m_arg(0),
+        m_start(0) {
+    if (TracingEnabled()) {
+      Begin(name, arg_name, arg);
+    }
+  }
+
+  ~TraceSpan() {
+    if (m_name) {
+      End();
+    }
+  }
+
+ private:
+  const char *m_name;
+  const char *m_arg_name;
+  int64_t m_arg;
+  int64_t m_start;
+
+  void Begin(const char *name, const char *arg_name, int64_t arg);
+  void End();
+
+  DISALLOW_COPY_AND_ASSIGN(TraceSpan);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_UTIL_TRACE_H_
@@ -996,6 +996,14 @@ class JsonObject: public JsonValue {
    */
   bool ReplaceValue(const std::string &key, JsonValue *value);
 
+  /**
+   * @brief Remove the JsonValue with the specified key, without deleting it.
+   * @param key the key to remove
+   * @returns the JsonValue, ownership is transferred, or NULL if the key
+   *   didn't exist.
+   */
+  JsonValue* ReleaseValue(const std::string &key);
+
   void Accept(JsonValueVisitorInterface *visitor) { visitor->Visit(this); }
   void Accept(JsonValueConstVisitorInterface *visitor) const {
     visitor->Visit(*this);
@@ -1169,6 +1177,24 @@ class JsonArray: public JsonValue {
    */
   bool InsertElementAt(uint32_t index, JsonValue *value);
 
+  /**
+   * @brief Remove the JsonValue at the specified index, without deleting it.
+   * @param index the index of the value to remove
+   * @returns the JsonValue, ownership is transferred, or NULL if the index
+   *   is outside the array.
+   */
+  JsonValue* ReleaseElementAt(uint32_t index);
+
+  /**
+   * @brief Replace the JsonValue at the specified index, without deleting
+   *   the old one.
+   * @param index the index of the value to replace.
+   * @param value the new JsonValue. Ownership is transferred.
+   * @returns the previous JsonValue, ownership is transferred, or NULL if
+   *   the index is outside the array, in which case value is deleted.
+   */
+  JsonValue* SwapElementAt(uint32_t index, JsonValue *value);
+
   void Accept(JsonValueVisitorInterface *visitor) { visitor->Visit(this); }
   void Accept(JsonValueConstVisitorInterface *visitor) const {
     visitor->Visit(*this);
@@ -67,6 +67,9 @@ class JsonLexer {
  * @brief The interface used to handle tokens during JSON parsing.
  *
  * As the JsonLexer traverses the input string, it calls the methods below.
+ *
+ * The strings passed to String() and ObjectKey() are only valid for the
+ * duration of the call, the lexer reuses the storage for later tokens.
  */
 class JsonParserInterface {
  public:
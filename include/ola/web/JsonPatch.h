@@ -46,6 +46,118 @@ namespace web {
 
 class JsonPatchSet;
 
+/**
+ * @brief Records the changes made by patch operations, so they can be
+ * undone.
+ *
+ * The patch operations modify the value in place. Rather than deleting
+ * the values they remove or replace, they hand them to the undo log, which
+ * can put them back with Rollback(). This means applying a patch set only
+ * copies the values it adds, rather than the entire document.
+ *
+ * The values held by the log are deleted when it's destroyed.
+ */
+class JsonPatchUndoLog {
+ public:
+  JsonPatchUndoLog() {}
+  ~JsonPatchUndoLog();
+
+  /**
+   * @brief Undo all the recorded changes, newest first.
+   * @param root the root of the value the changes were made to.
+   */
+  void Rollback(JsonValue **root);
+
+  /**
+   * @brief Replace the root value.
+   * @param root the root to replace.
+   * @param value the new root, ownership is transferred.
+   */
+  void ReplaceRoot(JsonValue **root, JsonValue *value);
+
+  /**
+   * @brief Set a member of an object, replacing any existing value.
+   * @param object the object to modify.
+   * @param key the key to set.
+   * @param value the new value, ownership is transferred.
+   */
+  void SetMember(JsonObject *object, const std::string &key,
+                 JsonValue *value);
+
+  /**
+   * @brief Replace an existing member of an object.
+   * @returns false if the key didn't exist, in which case value is deleted.
+   */
+  bool ReplaceMember(JsonObject *object, const std::string &key,
+                     JsonValue *value);
+
+  /**
+   * @brief Remove a member of an object.
+   * @returns false if the key didn't exist.
+   */
+  bool RemoveMember(JsonObject *object, const std::string &key);
+
+  /**
+   * @brief Insert an element into an array.
+   * @returns false if the index is outside the array, in which case value is
+   *   deleted.
+   */
+  bool InsertElement(JsonArray *array, uint32_t index, JsonValue *value);
+
+  /**
+   * @brief Append an element to an array.
+   */
+  void AppendElement(JsonArray *array, JsonValue *value);
+
+  /**
+   * @brief Replace an element of an array.
+   * @returns false if the index is outside the array, in which case value is
+   *   deleted.
+   */
+  bool ReplaceElement(JsonArray *array, uint32_t index, JsonValue *value);
+
+  /**
+   * @brief Remove an element from an array.
+   * @returns false if the index is outside the array.
+   */
+  bool RemoveElement(JsonArray *array, uint32_t index);
+
+ private:
+  enum ChangeType {
+    ROOT_REPLACED,
+    MEMBER_SET,  // old_value is NULL if the key didn't exist
+    MEMBER_REMOVED,
+    ELEMENT_INSERTED,
+    ELEMENT_REPLACED,
+    ELEMENT_REMOVED,
+  };
+
+  struct Change {
+    Change(ChangeType type, JsonObject *object, JsonArray *array,
+           const std::string &key, uint32_t index, JsonValue *old_value)
+        : type(type),
+          object(object),
+          array(array),
+          key(key),
+          index(index),
+          old_value(old_value) {
+    }
+
+    ChangeType type;
+    JsonObject *object;  // set for the MEMBER_ changes
+    JsonArray *array;  // set for the ELEMENT_ changes
+    std::string key;
+    uint32_t index;
+    JsonValue *old_value;  // owned by the log
+  };
+
+  typedef std::vector<Change> Changes;
+
+  Changes m_changes;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonPatchUndoLog);
+};
+
 /**
  * @brief A class to serialize a JSONValue to text.
  */
@@ -57,9 +169,10 @@ class JsonPatchOp {
    * @brief Apply the patch operation to the value.
    * @param value A pointer to a JsonValue object. This may be modified,
    * replaced or deleted entirely by the patch operation.
+   * @param undo_log the log to record the changes in.
    * @returns True if the patch was sucessfully applied, false otherwise.
    */
-  virtual bool Apply(JsonValue **value) const = 0;
+  virtual bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const = 0;
 };
 
 /**
@@ -77,7 +190,7 @@ class JsonPatchAddOp : public JsonPatchOp {
         m_value(value) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   JsonPointer m_pointer;
@@ -99,7 +212,7 @@ class JsonPatchRemoveOp : public JsonPatchOp {
       : m_pointer(path) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   const JsonPointer m_pointer;
@@ -122,7 +235,7 @@ class JsonPatchReplaceOp : public JsonPatchOp {
         m_value(value) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   const JsonPointer m_pointer;
@@ -146,7 +259,7 @@ class JsonPatchMoveOp : public JsonPatchOp {
         m_to(to) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   JsonPointer m_from;
@@ -170,7 +283,7 @@ class JsonPatchCopyOp : public JsonPatchOp {
       m_to(to) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   JsonPointer m_from;
@@ -189,7 +302,7 @@ class JsonPatchTestOp : public JsonPatchOp {
         m_value(value) {
   }
 
-  bool Apply(JsonValue **value) const;
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
 
  private:
   JsonPointer m_pointer;
@@ -216,10 +329,19 @@ class JsonPatchSet {
   /**
    * @brief Apply this patch set to a value.
    *
+   * If any of the operations fail, the value is left unchanged.
    * Don't call this directly, instead use JsonData::Apply().
    */
   bool Apply(JsonValue **value) const;
 
+  /**
+   * @brief Apply this patch set to a value, recording the changes.
+   * @param value the value to patch.
+   * @param undo_log the log to record the changes in. If this returns false
+   *   the caller should use it to roll back the changes.
+   */
+  bool Apply(JsonValue **value, JsonPatchUndoLog *undo_log) const;
+
   bool Empty() const { return m_patch_ops.empty(); }
 
  private:
@@ -0,0 +1,313 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonSchemaProgram.h
+ * A JSON Schema compiled into a flat program, for streaming validation.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup json
+ * @{
+ * @file JsonSchemaProgram.h
+ * @brief A JSON Schema compiled into a flat program, for streaming
+ * validation.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_WEB_JSONSCHEMAPROGRAM_H_
+#define INCLUDE_OLA_WEB_JSONSCHEMAPROGRAM_H_
+
+#include <ola/base/Macro.h>
+#include <ola/web/Json.h>
+#include <ola/web/JsonLexer.h>
+#include <ola/web/JsonParser.h>
+#include <ola/web/JsonSchema.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ola {
+namespace web {
+
+/**
+ * @addtogroup json
+ * @{
+ */
+
+/**
+ * @brief A JsonSchema flattened into a vector of instructions.
+ *
+ * Each sub-schema becomes one instruction, and instructions refer to each
+ * other by index. $ref links are resolved at compile time. The program is
+ * immutable once built, so a single JsonSchemaProgram can be shared between
+ * any number of StreamingSchemaValidators.
+ *
+ * The program accepts the same documents as JsonSchema::IsValid(), with one
+ * exception: "#/definitions/..." references are resolved, whereas the
+ * ReferenceValidator fails to find them and rejects every value.
+ *
+ * @code
+ *   string error;
+ *   auto_ptr<JsonSchemaProgram> program(
+ *       JsonSchemaProgram::FromString(schema_text, &error));
+ *   if (program.get() && program->IsValid(document_text)) {
+ *     ...
+ *   }
+ * @endcode
+ */
+class JsonSchemaProgram {
+ public:
+  ~JsonSchemaProgram();
+
+  /**
+   * @brief Lex a document and validate it against the program.
+   * @param input the JSON text.
+   * @returns true if the input is well-formed and valid.
+   */
+  bool IsValid(const std::string &input) const;
+
+  /**
+   * @brief The number of instructions in the program.
+   */
+  unsigned int InstructionCount() const { return m_instructions.size(); }
+
+  /**
+   * @brief Compile a schema.
+   * @param schema the schema to compile.
+   * @returns A new JsonSchemaProgram. Ownership is transferred.
+   */
+  static JsonSchemaProgram* Compile(const JsonSchema &schema);
+
+  /**
+   * @brief Parse and compile a schema.
+   * @param schema_string the schema as JSON text.
+   * @param error set to the parse error if the schema was invalid.
+   * @returns A new JsonSchemaProgram, or NULL if the schema was invalid.
+   */
+  static JsonSchemaProgram* FromString(const std::string& schema_string,
+                                       std::string *error);
+
+ private:
+  enum Opcode {
+    OP_WILDCARD,  // Matches anything.
+    OP_REJECT,  // Matches nothing, e.g. additionalProperties: false.
+    OP_TYPED,  // Checks the type and the keywords for that type.
+    OP_ALL_OF,
+    OP_ANY_OF,
+    OP_ONE_OF,
+    OP_NOT,
+    OP_REF  // Only exists during compilation.
+  };
+
+  typedef std::pair<std::string, unsigned int> NamedIndex;
+  typedef std::vector<NamedIndex> NamedIndexList;
+  typedef std::pair<unsigned int, std::vector<unsigned int> >
+      PropertyDependency;
+
+  struct Instruction {
+    Instruction();
+
+    Opcode op;
+    JsonType type;
+
+    // Scalars. These point into m_schema_json.
+    std::vector<const JsonValue*> enums;
+
+    // Strings
+    unsigned int min_length;
+    int max_length;
+
+    // Numbers, these point into m_schema_json.
+    const JsonNumber *minimum;
+    bool exclusive_minimum;
+    const JsonNumber *maximum;
+    bool exclusive_maximum;
+    const JsonNumber *multiple_of;
+
+    // Objects
+    unsigned int min_properties;
+    int max_properties;
+    NamedIndexList properties;  // Sorted by name.
+    unsigned int additional_properties;
+    // Property names we need to record the presence of: the required
+    // properties and those named in dependencies. Sorted.
+    std::vector<std::string> tracked_properties;
+    // Indices into tracked_properties.
+    std::vector<unsigned int> required;
+    std::vector<PropertyDependency> property_dependencies;
+    std::vector<std::pair<unsigned int, unsigned int> > schema_dependencies;
+
+    // Arrays
+    unsigned int min_items;
+    int max_items;
+    bool unique_items;
+    bool items_is_list;
+    std::vector<unsigned int> items;
+    unsigned int additional_items;
+
+    // allOf, anyOf, oneOf & not.
+    std::vector<unsigned int> branches;
+
+    // $ref
+    std::string ref;
+  };
+
+  static const unsigned int WILDCARD_INDEX = 0;
+  static const unsigned int REJECT_INDEX = 1;
+
+  std::auto_ptr<const JsonObject> m_schema_json;
+  std::vector<Instruction> m_instructions;
+  unsigned int m_root;
+
+  explicit JsonSchemaProgram(const JsonObject *schema_json);
+
+  const Instruction &GetInstruction(unsigned int index) const {
+    return m_instructions[index];
+  }
+
+  friend class SchemaCompiler;
+  friend class StreamingSchemaValidator;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonSchemaProgram);
+};
+
+
+/**
+ * @brief Validate a document against a JsonSchemaProgram as it's lexed.
+ *
+ * Pass this to JsonLexer::Parse(). The document is checked as each token
+ * arrives, so no JsonValue tree is built. The exceptions are uniqueItems,
+ * where the array elements are kept for comparison, and schema
+ * dependencies, where the object is kept until we know which properties it
+ * has.
+ */
+class StreamingSchemaValidator : public JsonParserInterface {
+ public:
+  /**
+   * @brief Create a new validator.
+   * @param program the program to validate against, ownership is not
+   *   transferred.
+   */
+  explicit StreamingSchemaValidator(const JsonSchemaProgram *program);
+  ~StreamingSchemaValidator();
+
+  void Begin();
+  void End();
+  void String(const std::string &value);
+  void Number(uint32_t value);
+  void Number(int32_t value);
+  void Number(uint64_t value);
+  void Number(int64_t value);
+  void Number(const JsonDouble::DoubleRepresentation &rep);
+  void Number(double value);
+  void Bool(bool value);
+  void Null();
+  void OpenArray();
+  void CloseArray();
+  void OpenObject();
+  void ObjectKey(const std::string &key);
+  void CloseObject();
+  void SetError(const std::string &error);
+
+  /**
+   * @brief Returns true if a complete, valid document was seen.
+   */
+  bool IsValid() const;
+
+  /**
+   * @brief The error from the lexer, if the document wasn't well-formed.
+   */
+  const std::string& Error() const { return m_error; }
+
+ private:
+  typedef JsonSchemaProgram::Instruction Instruction;
+
+  // A check is one instruction being applied to one value.
+  struct Check {
+    Check(unsigned int instruction, int parent, bool is_branch)
+        : instruction(instruction),
+          parent(parent),
+          is_branch(is_branch),
+          is_valid(true),
+          passed(0),
+          count(0) {
+    }
+
+    unsigned int instruction;
+    int parent;  // The index of the parent check, or -1.
+    bool is_branch;  // True if this is an anyOf, oneOf or not branch.
+    bool is_valid;
+    unsigned int passed;  // The number of branches that passed.
+    unsigned int count;  // The number of properties or items seen.
+    std::vector<bool> seen;  // Indexed like tracked_properties.
+  };
+
+  // A level is a value that is being checked. Scalars only exist for the
+  // duration of the token, objects and arrays until they're closed.
+  struct Level {
+    Level(unsigned int first_check, bool is_object)
+        : first_check(first_check),
+          end_check(first_check),
+          is_object(is_object),
+          collect_items(false),
+          capture(NULL) {
+    }
+
+    unsigned int first_check;
+    unsigned int end_check;
+    bool is_object;
+    bool collect_items;  // True if the elements are needed for uniqueItems.
+    JsonParser *capture;  // Non-NULL if this value is being built as a tree.
+  };
+
+  const JsonSchemaProgram *m_program;
+  const unsigned int m_root;
+  std::vector<Check> m_checks;
+  std::vector<Level> m_levels;
+  // Elements of the arrays that have collect_items set, innermost last.
+  std::vector<std::vector<const JsonValue*> > m_items;
+  unsigned int m_captures;
+  std::string m_key;
+  std::string m_error;
+  bool m_started;
+  bool m_complete;
+  bool m_is_valid;
+
+  StreamingSchemaValidator(const JsonSchemaProgram *program,
+                           unsigned int root);
+
+  bool StartValue(bool is_object);
+  void FinishValue();
+  void CheckScalar(JsonType type, const JsonValue &value);
+  void CheckContainer(JsonType type);
+  void CloseContainer();
+  unsigned int ChildInstruction(Check *check);
+  void PushCheck(unsigned int instruction, int parent, bool is_branch);
+  bool MatchesInstruction(unsigned int instruction,
+                          const JsonValue &value) const;
+  void Reset();
+
+  template <typename T>
+  void CheckNumber(const T &raw_value, const JsonNumber &value,
+                   bool is_integer);
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingSchemaValidator);
+};
+/**@}*/
+}  // namespace web
+}  // namespace ola
+#endif  // INCLUDE_OLA_WEB_JSONSCHEMAPROGRAM_H_
@@ -0,0 +1,197 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.h
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup json
+ * @{
+ * @file JsonStreamWriter.h
+ * @brief Write JSON text without building a tree of JsonValues.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+#define INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+
+#include <ola/base/Macro.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace web {
+
+/**
+ * @addtogroup json
+ * @{
+ */
+
+/**
+ * @brief Write JSON text directly to a string as values are added.
+ *
+ * JsonWriter serializes a tree of JsonValues, which means allocating a node
+ * for every value. When the data is only needed as text, the
+ * JsonStreamWriter can be used instead. The methods mirror those of
+ * JsonObject and JsonArray: Add() sets a property of the current object and
+ * Append() adds an element to the current array.
+ *
+ * The output is formatted the same way as JsonWriter's, with one exception:
+ * an array is laid out one element per line if its first element is an
+ * object or array, whereas JsonWriter does so if any element is.
+ *
+ * Properties are written in the order they're added, unlike JsonObject which
+ * sorts them, and no check is made for duplicate keys.
+ *
+ * @code
+ *   string output;
+ *   JsonStreamWriter writer(&output);
+ *   writer.StartObject();
+ *   writer.Add("name", "foo");
+ *   writer.AddArray("ports");
+ *   writer.Append(1);
+ *   writer.End();  // ports
+ *   writer.End();  // the top level object
+ * @endcode
+ */
+class JsonStreamWriter {
+ public:
+  /**
+   * @brief Create a new JsonStreamWriter.
+   * @param output the string to append the JSON text to. Ownership is not
+   *   transferred.
+   */
+  explicit JsonStreamWriter(std::string *output);
+
+  /**
+   * @brief Start the top level object.
+   */
+  void StartObject() { AppendObject(); }
+
+  /**
+   * @brief Start the top level array.
+   */
+  void StartArray() { AppendArray(); }
+
+  /**
+   * @brief Close the innermost object or array.
+   */
+  void End();
+
+  /**
+   * @brief Returns true once every object and array has been closed.
+   */
+  bool IsComplete() const { return m_started && m_scopes.empty(); }
+
+  /**
+   * @name Object methods
+   * @brief These can only be called when the innermost scope is an object.
+   * @{
+   */
+  void Add(const std::string &key, const std::string &value);
+  void Add(const std::string &key, const char *value);
+  void Add(const std::string &key, unsigned int i);
+  void Add(const std::string &key, int i);
+  void Add(const std::string &key, double d);
+  void Add(const std::string &key, bool value);
+
+  /**
+   * @brief Set the given key to a null value.
+   */
+  void Add(const std::string &key);
+
+  /**
+   * @brief Set the given key to raw JSON text, which isn't escaped.
+   */
+  void AddRaw(const std::string &key, const std::string &value);
+
+  /**
+   * @brief Start an object as the value of the given key.
+   */
+  void AddObject(const std::string &key);
+
+  /**
+   * @brief Start an array as the value of the given key.
+   */
+  void AddArray(const std::string &key);
+  /** @} */
+
+  /**
+   * @name Array methods
+   * @brief These can only be called when the innermost scope is an array.
+   * @{
+   */
+  void Append(const std::string &value);
+  void Append(const char *value);
+  void Append(unsigned int i);
+  void Append(int i);
+  void Append(bool value);
+
+  /**
+   * @brief Append a null value.
+   */
+  void Append();
+
+  /**
+   * @brief Append raw JSON text, which isn't escaped.
+   */
+  void AppendRaw(const std::string &value);
+
+  /**
+   * @brief Start an object as the next element.
+   */
+  void AppendObject();
+
+  /**
+   * @brief Start an array as the next element.
+   */
+  void AppendArray();
+  /** @} */
+
+ private:
+  struct Scope {
+    Scope(bool is_object)  // NOLINT(runtime/explicit)
+        : is_object(is_object),
+          has_items(false),
+          multi_line(false) {
+    }
+
+    bool is_object;
+    bool has_items;
+    // Only used for arrays, true if each element is on its own line.
+    bool multi_line;
+  };
+
+  std::string *m_output;
+  std::vector<Scope> m_scopes;
+  unsigned int m_indent;
+  bool m_started;
+
+  void WriteKey(const std::string &key);
+  void StartElement(bool is_complex);
+  void StartScope(bool is_object);
+  void WriteString(const std::string &value);
+  void WriteIndent();
+
+  static const unsigned int DEFAULT_INDENT = 2;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonStreamWriter);
+};
+/**@}*/
+}  // namespace web
+}  // namespace ola
+#endif  // INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
@@ -21,7 +21,9 @@
 #ifndef INCLUDE_OLAD_DEVICE_H_
 #define INCLUDE_OLAD_DEVICE_H_
 
+#include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <olad/Port.h>
 #include <stdint.h>
 #include <map>
@@ -75,6 +77,11 @@ class AbstractDevice {
   virtual InputPort *GetInputPort(unsigned int port_id) const = 0;
   virtual OutputPort *GetOutputPort(unsigned int port_id) const = 0;
 
+  // Called before and after a set of ports are patched together, so the
+  // device can apply the changes as one, rather than announcing each one.
+  virtual void EnterConfigurationMode() = 0;
+  virtual void ExitConfigurationMode() = 0;
+
   // configure this device
   virtual void Configure(ola::rpc::RpcController *controller,
                          const std::string &request,
@@ -111,6 +118,8 @@ class Device: public AbstractDevice {
   // sane defaults
   bool AllowLooping() const { return false; }
   bool AllowMultiPortPatching() const { return false; }
+  void EnterConfigurationMode() {}
+  void ExitConfigurationMode() {}
 
   bool AddPort(InputPort *port);
   bool AddPort(OutputPort *port);
@@ -129,7 +138,56 @@ class Device: public AbstractDevice {
                          std::string *response,
                          ConfigureCallback *done);
 
+  /**
+   * @brief A frame staged by one of the device's output ports.
+   */
+  struct StagedFrame {
+    StagedFrame(OutputPort *port, const DmxBuffer &buffer, uint8_t priority)
+        : port(port),
+          buffer(buffer),
+          priority(priority) {
+    }
+
+    OutputPort *port;
+    DmxBuffer buffer;
+    uint8_t priority;
+  };
+
+  /**
+   * @brief Stage a frame to be sent by FlushFrames().
+   * @param port the port the frame is for.
+   * @param buffer the DMX data.
+   * @param priority the priority of the data.
+   * @returns true if the frame was staged, false if batched output isn't
+   *   enabled, in which case the port should send the frame itself.
+   *
+   * Ports call this from WriteDMX(). A second frame for the same port,
+   * before the flush, replaces the first.
+   */
+  bool StageFrame(OutputPort *port, const DmxBuffer &buffer,
+                  uint8_t priority);
+
  protected:
+  /**
+   * @brief Collect the frames written to the output ports and pass them to
+   *   FlushFrames() once per event loop iteration.
+   * @param scheduler the scheduler to use, ownership is not transferred.
+   *
+   * This is intended to be called from StartHook(), by devices that can send
+   * many universes at once, e.g. with sendmmsg(), a sync packet or a single
+   * USB or SPI transfer. Staged frames are discarded when the device stops.
+   */
+  void EnableBatchedOutput(ola::thread::SchedulerInterface *scheduler);
+
+  /**
+   * @brief Send the frames staged since the last flush.
+   * @param frames the frames, at most one for each port, in the order the
+   *   ports were first written.
+   */
+  virtual void FlushFrames(const std::vector<StagedFrame> &frames) {
+    (void) frames;
+  }
+
   /**
    * @brief Called during Start().
    *
@@ -149,6 +207,12 @@ class Device: public AbstractDevice {
   mutable std::string m_unique_id;  // device id
   input_port_map m_input_ports;
   output_port_map m_output_ports;
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::thread::timeout_id m_flush_timeout;
+  std::vector<StagedFrame> m_staged_frames;
+
+  void Flush();
+  void DiscardStagedFrames();
 
   template<class PortClass>
   bool GenericAddPort(PortClass *port,
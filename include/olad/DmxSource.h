@@ -49,10 +49,25 @@ class DmxSource {
         m_priority(priority) {
     }
 
+    /*
+     * Create a source with per-slot priorities, see UpdateData().
+     */
+    DmxSource(const DmxBuffer &buffer,
+              const TimeStamp &timestamp,
+              uint8_t priority,
+              const DmxBuffer &slot_priorities):
+        m_buffer(buffer),
+        m_timestamp(timestamp),
+        m_priority(priority),
+        m_slot_priorities(slot_priorities) {
+    }
+
     DmxSource(const DmxSource &other) {
       m_buffer = other.m_buffer;
       m_timestamp = other.m_timestamp;
       m_priority = other.m_priority;
+      m_slot_priorities = other.m_slot_priorities;
+      m_arrival = other.m_arrival;
     }
 
 
@@ -64,6 +79,8 @@ class DmxSource {
         m_buffer = other.m_buffer;
         m_timestamp = other.m_timestamp;
         m_priority = other.m_priority;
+        m_slot_priorities = other.m_slot_priorities;
+        m_arrival = other.m_arrival;
       }
       return *this;
     }
@@ -74,7 +91,9 @@ class DmxSource {
     bool operator==(const DmxSource &other) const {
       return (m_buffer == other.m_buffer &&
               m_timestamp == other.m_timestamp &&
-              m_priority == other.m_priority);
+              m_priority == other.m_priority &&
+              m_slot_priorities == other.m_slot_priorities &&
+              m_arrival == other.m_arrival);
     }
 
 
@@ -86,6 +105,24 @@ class DmxSource {
       m_buffer = buffer;
       m_timestamp = timestamp;
       m_priority = priority;
+      m_slot_priorities.Reset();
+      m_arrival = TimeStamp();
+    }
+
+
+    /*
+     * Update the DmxSource with new data and a priority for each slot. This
+     * is how E1.31 uses the 0xDD start code. A slot priority of 0 means the
+     * source doesn't control the slot, slots beyond the end of
+     * slot_priorities are treated as priority 0.
+     */
+    void UpdateData(const DmxBuffer &buffer, const TimeStamp &timestamp,
+                    uint8_t priority, const DmxBuffer &slot_priorities) {
+      m_buffer = buffer;
+      m_timestamp = timestamp;
+      m_priority = priority;
+      m_slot_priorities = slot_priorities;
+      m_arrival = TimeStamp();
     }
 
 
@@ -105,8 +142,15 @@ class DmxSource {
      * Check if this source has timed out
      */
     bool IsActive(const TimeStamp &now) const {
-      TimeStamp timeout = m_timestamp + TIMEOUT_INTERVAL;
-      return now < timeout;
+      return now < ExpiryTime();
+    }
+
+
+    /*
+     * Get the time this source times out, unless it gets new data
+     */
+    TimeStamp ExpiryTime() const {
+      return m_timestamp + TIMEOUT_INTERVAL;
     }
 
 
@@ -123,10 +167,39 @@ class DmxSource {
      */
     uint8_t Priority() const { return m_priority; }
 
+
+    /*
+     * Check if this source has per-slot priorities
+     */
+    bool HasSlotPriorities() const { return m_slot_priorities.Size() > 0; }
+
+
+    /*
+     * Get the per-slot priorities, this is empty if the source only has a
+     * single priority.
+     */
+    const DmxBuffer &SlotPriorities() const { return m_slot_priorities; }
+
+
+    /*
+     * Set the wall clock time the kernel received the data, this is cleared
+     * by UpdateData(). Unlike Timestamp() this includes the time the packet
+     * waited before it was read, it's only used to measure latency.
+     */
+    void SetArrivalTime(const TimeStamp &arrival) { m_arrival = arrival; }
+
+
+    /*
+     * Get the time the kernel received the data, this may not be set.
+     */
+    const TimeStamp &ArrivalTime() const { return m_arrival; }
+
  private:
     DmxBuffer m_buffer;
     TimeStamp m_timestamp;
     uint8_t m_priority;
+    DmxBuffer m_slot_priorities;
+    TimeStamp m_arrival;
 
     static const TimeInterval TIMEOUT_INTERVAL;
 };
@@ -3,6 +3,7 @@ oladinclude_HEADERS = \
     include/olad/DmxSource.h \
     include/olad/Plugin.h \
     include/olad/PluginAdaptor.h \
+    include/olad/PluginLoop.h \
     include/olad/Port.h \
     include/olad/PortBroker.h \
     include/olad/PortConstants.h \
@@ -34,10 +34,13 @@
 #include <ola/io/SelectServerInterface.h>
 #include <olad/OlaServer.h>
 
+#include <map>
 #include <string>
 
 namespace ola {
 
+class PluginLoop;
+
 class PluginAdaptor: public ola::io::SelectServerInterface {
  public:
   /**
@@ -55,6 +58,7 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
                 class PreferencesFactory *preferences_factory,
                 class PortBrokerInterface *port_broker,
                 const std::string *instance_name);
+  ~PluginAdaptor();
 
   // The following methods are part of the SelectServerInterface
   bool AddReadDescriptor(ola::io::ReadFileDescriptor *descriptor);
@@ -85,12 +89,32 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
       const TimeInterval &interval,
       SingleUseCallback0<void> *closure);
 
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const TimeInterval &interval,
+      const InlineCallback0<void> &closure);
+
   void RemoveTimeout(ola::thread::timeout_id id);
 
+  ola::thread::timeout_id RegisterPeriodicTask(const TimeInterval &period,
+                                               Callback0<bool> *closure);
+
+  void RemovePeriodicTask(ola::thread::timeout_id id);
+
   void Execute(ola::BaseCallback0<void> *closure);
 
+  void Execute(const ola::InlineCallback0<void> &closure);
+
   const TimeStamp *WakeUpTime() const;
 
+  /**
+   * @brief A Clock that returns the time the event loop last woke up.
+   *
+   * This saves reading the system clock in code that only runs in the main
+   * thread, such as the packet handlers for network protocols.
+   * @see ola::io::SelectServer::LoopClock()
+   */
+  const Clock *LoopClock() const { return &m_loop_clock; }
+
   // These are the extra bits for the plugins
   /**
    * @brief Return the instance name for the OLA server
@@ -125,8 +149,39 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
     return m_port_broker;
   }
 
+  /**
+   * @brief Set the UniverseStore, so plugins can hold the outputs.
+   * @param universe_store the UniverseStore, ownership is not transferred.
+   */
+  void SetUniverseStore(class UniverseStore *universe_store) {
+    m_universe_store = universe_store;
+  }
+
+  /**
+   * @brief Hold, or release, the output ports of every universe.
+   * @param held true to stop writing to the output ports.
+   *
+   * This lets a standby olad keep its universes up to date, without driving
+   * the outputs while another olad has them.
+   * @sa UniverseStore::SetOutputsHeld()
+   */
+  void SetOutputsHeld(bool held);
+
   void DrainCallbacks();
 
+  /**
+   * @brief Get an event loop which runs in its own thread.
+   * @param name the name of the loop, usually the plugin name. Plugins which
+   *   ask for the same name share a loop.
+   * @returns the loop, or NULL if its thread couldn't be started. The loop is
+   *   owned by the PluginAdaptor and runs until the PluginAdaptor is deleted,
+   *   after the plugins have stopped.
+   *
+   * Plugins with slow or blocking work can opt into this, so the work
+   * doesn't delay the DMX for other plugins. See PluginLoop for the rules.
+   */
+  PluginLoop *DedicatedLoop(const std::string &name);
+
  private:
   DeviceManager *m_device_manager;
   ola::io::SelectServerInterface *m_ss;
@@ -134,6 +189,10 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
   class PreferencesFactory *m_preferences_factory;
   class PortBrokerInterface *m_port_broker;
   const std::string *m_instance_name;
+  class UniverseStore *m_universe_store;
+  Clock m_clock;
+  CachedClock m_loop_clock;
+  std::map<std::string, PluginLoop*> m_loops;
 
   DISALLOW_COPY_AND_ASSIGN(PluginAdaptor);
 };
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginLoop.h
+ * An event loop in its own thread, for plugins with slow or blocking work.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef INCLUDE_OLAD_PLUGINLOOP_H_
+#define INCLUDE_OLAD_PLUGINLOOP_H_
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/io/SelectServer.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <ola/thread/Thread.h>
+
+#include <string>
+
+namespace ola {
+
+/**
+ * @brief An event loop that runs in its own thread.
+ *
+ * A plugin that does slow or blocking work on the main event loop delays the
+ * DMX for every universe. Such a plugin can ask the PluginAdaptor for a
+ * PluginLoop and move its descriptors and timeouts there, see
+ * PluginAdaptor::DedicatedLoop(). This is the same arrangement the USB Pro
+ * plugin has used for widget detection all along.
+ *
+ * The rules are the same as for any other SelectServer:
+ *  - Only Execute() may be called from other threads. Descriptors and
+ *    timeouts must be added and removed from within the loop, e.g. with
+ *    ExecuteAndWait() from the plugin's StartHook() and PrePortStop().
+ *  - Anything that touches ports, devices or universes has to be passed back
+ *    to the main loop with PluginAdaptor::Execute(). Both queues are
+ *    lock-free.
+ *  - DmxBuffers share their data without locking, so frames that cross
+ *    threads must be copied with DmxBuffer::Set().
+ *
+ * The lateness of a timer in the loop is measured every LAG_PROBE_INTERVAL_MS
+ * and exported, by loop name, in LAG_VAR and MAX_LAG_VAR. A loop which is
+ * often late is doing too much work in one callback.
+ */
+class PluginLoop {
+ public:
+  /**
+   * @brief Create a new PluginLoop.
+   * @param name the name of the loop, this is used for the thread name and
+   *   the lag variables.
+   * @param export_map the ExportMap to publish the lag in. May be NULL.
+   */
+  PluginLoop(const std::string &name, ExportMap *export_map);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~PluginLoop();
+
+  /**
+   * @brief Start the thread.
+   * @returns true if the thread started.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop the thread, once the queued callbacks have run.
+   *
+   * Anything still registered with the loop is left in place but is never
+   * run again.
+   */
+  void Stop();
+
+  /**
+   * @brief Check if the thread is running.
+   */
+  bool IsRunning() const { return m_thread != NULL; }
+
+  const std::string &Name() const { return m_name; }
+
+  /**
+   * @brief The loop, to register descriptors and timeouts with.
+   *
+   * Only Execute() may be called from outside the loop.
+   */
+  ola::io::SelectServerInterface *GetSelectServer() { return &m_ss; }
+
+  /**
+   * @brief Run a callback in the loop and wait for it to complete.
+   * @param callback the callback to run, ownership is transferred.
+   *
+   * This must not be called from within the loop. If the loop isn't
+   * running, the callback is run in the calling thread.
+   */
+  void ExecuteAndWait(BaseCallback0<void> *callback);
+
+  static const char LAG_VAR[];
+  static const char MAX_LAG_VAR[];
+  static const unsigned int LAG_PROBE_INTERVAL_MS = 100;
+
+ private:
+  const std::string m_name;
+  UIntMap::Handle m_lag;
+  UIntMap::Handle m_max_lag_var;
+  ola::io::SelectServer m_ss;
+  ola::thread::Thread *m_thread;
+  ola::thread::timeout_id m_probe_timeout;
+  TimeStamp m_probe_due;
+  unsigned int m_max_lag;  // only used in the loop
+
+  void StartProbe();
+  void StopProbe();
+  void Probe();
+  void RegisterProbe();
+
+  DISALLOW_COPY_AND_ASSIGN(PluginLoop);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLAD_PLUGINLOOP_H_
@@ -21,6 +21,7 @@
 #ifndef INCLUDE_OLAD_PORT_H_
 #define INCLUDE_OLAD_PORT_H_
 
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/base/Macro.h>
 #include <ola/rdm/RDMCommand.h>
@@ -29,8 +30,10 @@
 #include <olad/DmxSource.h>
 #include <olad/PluginAdaptor.h>
 #include <olad/PortConstants.h>
+#include <olad/TokenBucket.h>
 #include <olad/Universe.h>
 
+#include <memory>
 #include <string>
 
 namespace ola {
@@ -172,6 +175,46 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
    */
   virtual bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) = 0;
 
+  /**
+   * @brief Get the maximum rate that DMX data is written to this port.
+   * @returns the rate in frames per second, or 0 if the port isn't limited.
+   */
+  virtual unsigned int MaxFrameRate() const = 0;
+
+  /**
+   * @brief Limit the rate that DMX data is written to this port.
+   * @param frames_per_second the maximum rate, or 0 to remove the limit.
+   * @returns false if the rate is out of range.
+   */
+  virtual bool SetMaxFrameRate(unsigned int frames_per_second) = 0;
+
+  /**
+   * @brief Check if a new frame can be written to this port.
+   * @param now the current time.
+   * @returns true if the frame should be written. If the rate limit has been
+   *   reached this returns false and the frame is held, replacing any frame
+   *   that was already held.
+   */
+  virtual bool AdmitFrame(const TimeStamp &now) = 0;
+
+  /**
+   * @brief Check if the held frame can now be written to this port.
+   * @param now the current time.
+   * @returns true if there is a held frame and it should be written.
+   */
+  virtual bool AdmitPendingFrame(const TimeStamp &now) = 0;
+
+  /**
+   * @brief Check if a frame is being held because of the rate limit.
+   */
+  virtual bool FramePending() const = 0;
+
+  /**
+   * @brief The number of held frames that were replaced by a later frame
+   *   before they could be written.
+   */
+  virtual unsigned int SkippedFrames() const = 0;
+
   /**
    * @brief Called if the universe name changes
    */
@@ -186,6 +229,12 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete) = 0;
 
+  /**
+   * @brief Set the UIDs the next incremental discovery should start from.
+   * @param uids the UIDs that were last seen on the universe.
+   */
+  virtual void SeedUIDs(const ola::rdm::UIDSet &uids) = 0;
+
   // timecode support
   virtual bool SupportsTimeCode() const = 0;
   virtual bool SendTimeCode(const ola::timecode::TimeCode &timecode) = 0;
@@ -218,6 +267,10 @@ class BasicInputPort: public InputPort {
 
   /**
    * @brief Called when there is new data for this port
+   *
+   * If the data, priority and slot priorities are the same as the last
+   * call, the source is refreshed but the universe isn't merged again. LTP
+   * universes with more than one source are always merged.
    */
   void DmxChanged();
   const DmxSource &SourceData() const { return m_dmx_source; }
@@ -250,6 +303,14 @@ class BasicInputPort: public InputPort {
     return ola::dmx::SOURCE_PRIORITY_MIN;
   }
 
+  // Get the inherited per-slot priorities, or NULL if the port only has a
+  // single priority. These are only used in inherit mode.
+  virtual const DmxBuffer *InheritedSlotPriorities() const { return NULL; }
+
+  // Get the wall clock time the kernel received the data, if the port knows
+  // it. This is only used for the latency stats.
+  virtual TimeStamp ArrivalTime() const { return TimeStamp(); }
+
   // override this to cancel the SetUniverse operation.
   virtual bool PreSetUniverse(Universe *, Universe *) { return true; }
 
@@ -307,6 +368,14 @@ class BasicOutputPort: public OutputPort {
     return SupportsPriorities() ? CAPABILITY_FULL : CAPABILITY_NONE;
   }
 
+  // Rate limiting, latest frame wins
+  unsigned int MaxFrameRate() const { return m_max_frame_rate; }
+  bool SetMaxFrameRate(unsigned int frames_per_second);
+  bool AdmitFrame(const TimeStamp &now);
+  bool AdmitPendingFrame(const TimeStamp &now);
+  bool FramePending() const { return m_frame_pending; }
+  unsigned int SkippedFrames() const { return m_skipped_frames; }
+
   // DiscoverableRDMControllerInterface methods
   /**
    * @brief Handle an RDMRequest, subclasses can implement this to support RDM
@@ -324,6 +393,11 @@ class BasicOutputPort: public OutputPort {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete);
 
+  /**
+   * @brief This is a noop for ports that don't run their own discovery
+   */
+  virtual void SeedUIDs(const ola::rdm::UIDSet &) {}
+
   // TimeCode
   virtual bool SupportsTimeCode() const { return false; }
 
@@ -340,6 +414,9 @@ class BasicOutputPort: public OutputPort {
 
   virtual bool SupportsRDM() const { return m_supports_rdm; }
 
+  // The highest rate that can be set with SetMaxFrameRate()
+  static const unsigned int MAX_FRAME_RATE;
+
  protected:
   // indicates whether this port supports priorities, default to no
   virtual bool SupportsPriorities() const { return false; }
@@ -350,6 +427,8 @@ class BasicOutputPort: public OutputPort {
   void UpdateUIDs(const ola::rdm::UIDSet &uids);
 
  private:
+  bool TakeFrameToken(const TimeStamp &now);
+
   const unsigned int m_port_id;
   const bool m_discover_on_patch;
   uint8_t m_priority;
@@ -358,6 +437,11 @@ class BasicOutputPort: public OutputPort {
   Universe *m_universe;  // the universe this port belongs to
   AbstractDevice *m_device;
   bool m_supports_rdm;
+  unsigned int m_max_frame_rate;
+  unsigned int m_skipped_frames;
+  bool m_frame_pending;
+  // created when the first frame is admitted
+  std::auto_ptr<TokenBucket> m_frame_bucket;
 
   DISALLOW_COPY_AND_ASSIGN(BasicOutputPort);
 };
@@ -24,6 +24,8 @@
 
 #include <ola/base/Macro.h>
 #include <ola/Logging.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/thread/Thread.h>
 #include <ola/io/SelectServer.h>
 
@@ -435,12 +437,23 @@ class MemoryPreferencesFactory: public PreferencesFactory {
 
 
 /**
- * The thread that saves preferences
+ * The thread that saves preferences.
+ *
+ * Saves are coalesced: the preferences to be written are held until the save
+ * delay has passed, and if a file is saved again in the meantime only the
+ * latest version is written. Each file is written to a temporary file which is
+ * then renamed over the original, so a crash never leaves a partial file.
  */
 class FilePreferenceSaverThread: public ola::thread::Thread {
  public:
   typedef std::multimap<std::string, std::string> PreferencesMap;
-  FilePreferenceSaverThread();
+
+  /**
+   * @brief Create a new FilePreferenceSaverThread.
+   * @param save_delay how long to wait for more changes before writing.
+   */
+  explicit FilePreferenceSaverThread(
+      const TimeInterval &save_delay = TimeInterval(1, 0));
 
   void SavePreferences(const std::string &filename,
                        const PreferencesMap &preferences);
@@ -451,7 +464,7 @@ class FilePreferenceSaverThread: public ola::thread::Thread {
   void *Run();
 
   /**
-   * Stop the saving thread
+   * Stop the saving thread. Any pending saves are written first.
    */
   bool Join(void *ptr = NULL);
 
@@ -463,7 +476,19 @@ class FilePreferenceSaverThread: public ola::thread::Thread {
   void Syncronize();
 
  private:
+  typedef std::map<std::string, PreferencesMap> PendingSaves;
+
   ola::io::SelectServer m_ss;
+  const TimeInterval m_save_delay;
+  ola::thread::Mutex m_mutex;
+  PendingSaves m_pending_saves;  // protected by m_mutex
+  bool m_save_scheduled;  // protected by m_mutex
+  // Only used by the saver thread.
+  ola::thread::timeout_id m_save_timeout;
+
+  void ScheduleSave();
+  void SaveTimeout();
+  void SavePending();
 
   /**
    * Notify the blocked thread we're done
@@ -496,6 +521,24 @@ class FileBackedPreferences: public MemoryPreferences {
 
   std::string ConfigLocation() const { return FileName(); }
 
+  /**
+   * @brief Parse a preferences file.
+   * @param filename the file to read.
+   * @param preferences the map to replace with the contents of the file.
+   * @returns false if the file couldn't be opened, in which case preferences
+   *   is unchanged.
+   */
+  static bool ParseFile(const std::string &filename,
+                        PreferencesMap *preferences);
+
+  /**
+   * @brief The name of the file used for a set of preferences.
+   * @param directory the config directory.
+   * @param name the name of the preferences.
+   */
+  static std::string FileName(const std::string &directory,
+                              const std::string &name);
+
  private:
   const std::string m_directory;
   FilePreferenceSaverThread *m_saver_thread;
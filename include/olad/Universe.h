@@ -27,12 +27,17 @@
 #include <ola/base/Macro.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/RDMTimingStats.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/stl/FlatMap.h>
+#include <ola/stl/FlatSet.h>
+#include <ola/util/Histogram.h>
 #include <olad/DmxSource.h>
 
 #include <set>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -51,7 +56,8 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
-             Clock *clock);
+             Clock *clock,
+             const Clock *loop_clock = NULL);
     ~Universe();
 
     // Properties for this universe
@@ -88,10 +94,59 @@ class Universe: public ola::rdm::RDMControllerInterface {
       m_rdm_discovery_interval = discovery_interval;
     }
 
+    /**
+     * @brief Return the maximum rate at which data is written to the outputs.
+     * @return the rate in frames per second, 0 means there is no limit.
+     */
+    unsigned int MaxFrameRate() const { return m_max_frame_rate; }
+
+    /**
+     * @brief Limit the rate at which data is written to the outputs.
+     * @param frames_per_second the maximum rate, or 0 for no limit.
+     *
+     * If the UniverseStore has an OutputScheduler, updates for a rate limited
+     * universe are collapsed and written on the scheduler's tick.
+     */
+    void SetMaxFrameRate(unsigned int frames_per_second);
+
+    /**
+     * @brief Called by the OutputScheduler on each tick.
+     * @return true if the universe still has output waiting to be written.
+     */
+    bool RunScheduledOutput();
+
     // Each universe has a DMXBuffer
     bool SetDMX(const DmxBuffer &buffer);
     const DmxBuffer &GetDMX() const { return m_buffer; }
 
+    /**
+     * @brief Restore the data the universe had before a restart.
+     * @param buffer the saved data.
+     *
+     * Unlike SetDMX() nothing is written, the data is sent to each output
+     * port as it's added to the universe.
+     */
+    void RestoreDMX(const DmxBuffer &buffer);
+
+    /**
+     * @brief Write the current data to the outputs again, if nothing has been
+     *   written for K_OUTPUT_REFRESH_INTERVAL_MS.
+     * @param now the current time.
+     *
+     * The universe holds the last frame when its sources stop sending, this
+     * keeps the receivers from timing out when a source only sends on change.
+     */
+    void RefreshOutputs(const TimeStamp &now);
+
+    /**
+     * @brief Write the current data to the outputs now, even if it hasn't
+     *   changed.
+     *
+     * This is called when the outputs are released after being held.
+     * @sa UniverseStore::SetOutputsHeld()
+     */
+    void FlushOutputs();
+
     // These are the ports we need to nofity when data changes
     bool AddPort(InputPort *port);
     bool AddPort(OutputPort *port);
@@ -108,13 +163,13 @@ class Universe: public ola::rdm::RDMControllerInterface {
     bool AddSourceClient(Client *client);
     bool RemoveSourceClient(Client *client);
     bool ContainsSourceClient(Client *client) const;
-    unsigned int SourceClientCount() const { return m_source_clients.size(); }
+    unsigned int SourceClientCount() const { return m_source_clients.Size(); }
 
     // Sink clients are those that we need to send data
     bool AddSinkClient(Client *client);
     bool RemoveSinkClient(Client *client);
     bool ContainsSinkClient(Client *client) const;
-    unsigned int SinkClientCount() const { return m_sink_clients.size(); }
+    unsigned int SinkClientCount() const { return m_sink_clients.Size(); }
 
     // These are called when new data arrives on a port/client
     bool PortDataChanged(InputPort *port);
@@ -124,6 +179,33 @@ class Universe: public ola::rdm::RDMControllerInterface {
     //    stale == client that has not sent data
     void CleanStaleSourceClients();
 
+    /**
+     * @brief Called by the SourceExpiryScheduler when a source may have
+     *   timed out.
+     *
+     * Source clients that have timed out are removed, and the remaining
+     * sources are merged again.
+     */
+    void ExpireSources();
+
+    /**
+     * @brief Free the memory used by the merge state and the timing stats.
+     *
+     * This is called once the universe has no active sources. The state is
+     * rebuilt when data next arrives.
+     */
+    void Compact();
+
+    /**
+     * @brief An estimate of the memory used by this universe, in bytes.
+     */
+    unsigned int MemoryUsage() const;
+
+    /**
+     * @brief Update the exported memory usage.
+     */
+    void ExportMemoryUsage();
+
     // RDM methods
     void SendRDMRequest(ola::rdm::RDMRequest *request,
                         ola::rdm::RDMCallback *callback);
@@ -133,6 +215,38 @@ class Universe: public ola::rdm::RDMControllerInterface {
     void GetUIDs(ola::rdm::UIDSet *uids) const;
     unsigned int UIDCount() const;
 
+    /**
+     * @brief Set the UIDs that were seen on this universe before a restart.
+     * @param uids the UIDs to restore.
+     *
+     * The restored UIDs are returned by GetUIDs() and used to seed discovery
+     * on ports patched to this universe, until discovery has run on all the
+     * ports.
+     */
+    void SetCachedUIDs(const ola::rdm::UIDSet &uids);
+    const ola::rdm::UIDSet &CachedUIDs() const { return m_cached_uids; }
+
+    /**
+     * @brief The timing of the RDM requests sent to a port.
+     * @returns the RDMTimingStats, or NULL if no requests have been sent.
+     */
+    const ola::rdm::RDMTimingStats *PortRDMTiming(
+        const OutputPort *port) const;
+
+    /**
+     * @brief Note that the name, merge mode, ports or RDM devices changed.
+     *
+     * This is called by the universe itself. It's public so that changes
+     * made to the patched ports, such as the priority, are also picked up.
+     */
+    void InfoChanged();
+
+    /**
+     * @brief The UniverseStore info version of the last change to this
+     *   universe.
+     */
+    uint64_t InfoVersion() const { return m_info_version; }
+
     bool operator==(const Universe &other) {
       return m_universe_id == other.UniverseId();
     }
@@ -148,6 +262,40 @@ class Universe: public ola::rdm::RDMControllerInterface {
     static const char K_UNIVERSE_SINK_CLIENTS_VAR[];
     static const char K_UNIVERSE_SOURCE_CLIENTS_VAR[];
     static const char K_UNIVERSE_UID_COUNT_VAR[];
+    static const char K_UNIVERSE_UNCHANGED_FRAMES_VAR[];
+    static const char K_UNIVERSE_COALESCED_FRAMES_VAR[];
+    static const char K_UNIVERSE_PORT_SKIPPED_FRAMES_VAR[];
+    static const char K_UNIVERSE_MERGES_SKIPPED_VAR[];
+    static const char K_UNIVERSE_LATENCY_P50_VAR[];
+    static const char K_UNIVERSE_LATENCY_P99_VAR[];
+    static const char K_UNIVERSE_LATENCY_MAX_VAR[];
+    static const char K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR[];
+    static const char K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR[];
+    static const char K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR[];
+    static const char K_UNIVERSE_MERGE_TIME_P50_VAR[];
+    static const char K_UNIVERSE_MERGE_TIME_P99_VAR[];
+    static const char K_UNIVERSE_MERGE_TIME_MAX_VAR[];
+    static const char K_UNIVERSE_MEMORY_VAR[];
+    // RDM timing, keyed by the port's unique id.
+    static const char K_RDM_PORT_REQUESTS_VAR[];
+    static const char K_RDM_PORT_TIMEOUTS_VAR[];
+    static const char K_RDM_PORT_ACK_TIMERS_VAR[];
+    static const char K_RDM_PORT_RETRANSMITS_VAR[];
+    static const char K_RDM_PORT_LATENCY_P50_VAR[];
+    static const char K_RDM_PORT_LATENCY_P99_VAR[];
+    static const char K_RDM_PORT_LATENCY_MAX_VAR[];
+    // RDM timing, keyed by the responder's UID.
+    static const char K_RDM_RESPONDER_REQUESTS_VAR[];
+    static const char K_RDM_RESPONDER_TIMEOUTS_VAR[];
+    static const char K_RDM_RESPONDER_ACK_TIMERS_VAR[];
+    static const char K_RDM_RESPONDER_RETRANSMITS_VAR[];
+    static const char K_RDM_RESPONDER_LATENCY_P50_VAR[];
+    static const char K_RDM_RESPONDER_LATENCY_P99_VAR[];
+    static const char K_RDM_RESPONDER_LATENCY_MAX_VAR[];
+    // How often to resend the data to the outputs if it hasn't changed
+    static const unsigned int K_OUTPUT_REFRESH_INTERVAL_MS = 1000;
+    // How many timing samples between updates of the exported percentiles
+    static const unsigned int K_TIMING_EXPORT_INTERVAL = 16;
 
  private:
     typedef struct {
@@ -158,16 +306,38 @@ class Universe: public ola::rdm::RDMControllerInterface {
       std::vector<rdm::RDMFrame> frames;
     } broadcast_request_tracker;
 
-    typedef std::map<Client*, bool> SourceClientMap;
+    // A unicast request whose timing is being recorded.
+    struct timed_request_tracker {
+      timed_request_tracker(const std::string &port_id,
+                            const ola::rdm::UID &uid,
+                            ola::rdm::RDMCallback *callback)
+          : port_id(port_id),
+            uid(uid),
+            callback(callback) {
+      }
+
+      std::string port_id;
+      ola::rdm::UID uid;
+      TimeStamp sent;
+      ola::rdm::RDMCallback *callback;
+    };
+
+    typedef std::map<std::string, ola::rdm::RDMTimingStats*> RDMTimingMap;
+
+    typedef FlatMap<Client*, bool> SourceClientMap;
 
     std::string m_universe_name;
     unsigned int m_universe_id;
     std::string m_universe_id_str;
     uint8_t m_active_priority;
     enum merge_mode m_merge_mode;  // merge mode
+    uint64_t m_info_version;
+    // The ports in the order they were added, the index sets are for lookups.
     std::vector<InputPort*> m_input_ports;
     std::vector<OutputPort*> m_output_ports;
-    std::set<Client*> m_sink_clients;  // clients that require updates
+    FlatSet<InputPort*> m_input_port_index;
+    FlatSet<OutputPort*> m_output_port_index;
+    FlatSet<Client*> m_sink_clients;  // clients that require updates
     /**
      * Tracks current source clients and whether or not they are stale.
      * true == stale and can be removed, false == active is to be kept
@@ -176,41 +346,134 @@ class Universe: public ola::rdm::RDMControllerInterface {
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
     ExportMap *m_export_map;
+    // Handles for the variables updated on every frame. These ignore updates
+    // if there's no ExportMap.
+    UIntMap::Handle m_frames_var;
+    UIntMap::Handle m_coalesced_frames_var;
+    UIntMap::Handle m_unchanged_frames_var;
+    UIntMap::Handle m_port_skipped_frames_var;
+    UIntMap::Handle m_merges_skipped_var;
+    UIntMap::Handle m_memory_var;
     std::map<ola::rdm::UID, OutputPort*> m_output_uids;
+    // UIDs restored from the last run that discovery hasn't found yet.
+    ola::rdm::UIDSet m_cached_uids;
     Clock *m_clock;
+    // Used for the current time when the precise time isn't needed.
+    const Clock *m_loop_clock;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
 
+    /*
+     * Merge state. m_merge_sources holds the sources at the active priority
+     * that produced m_buffer, and m_merge_keys holds the port or client each
+     * one came from. The scan vectors are filled on each update and swapped
+     * with the merge vectors once the merge is complete, so we don't allocate
+     * memory for each frame.
+     */
+    std::vector<DmxSource> m_merge_sources;
+    std::vector<const void*> m_merge_keys;
+    std::vector<DmxSource> m_scan_sources;
+    std::vector<const void*> m_scan_keys;
+    // True if m_buffer is the HTP merge of m_merge_sources
+    bool m_htp_merge_valid;
+    // For each slot, the index into m_merge_sources of the source that
+    // provides the value. Built on demand.
+    std::vector<uint16_t> m_slot_owners;
+    bool m_slot_owners_valid;
+    // Slot priorities for sources that don't have their own, used when one
+    // or more sources has per-slot priorities.
+    std::vector<uint8_t> m_priority_scratch;
+    // The port or client if it's the only source of the universe, otherwise
+    // NULL. Its data is passed through without building the merge state.
+    const void *m_cut_through_key;
+
+    // State of the last update sent to the output ports & sink clients.
+    TimeStamp m_last_output_time;
+    uint8_t m_last_output_priority;
+    // True if a new output has been added since the last update
+    bool m_outputs_stale;
+
+    unsigned int m_max_frame_rate;
+    // True if we're waiting for the OutputScheduler
+    bool m_output_pending;
+    // True if one or more rate limited output ports is holding a frame
+    bool m_ports_pending;
+
+    // The deadline registered with the SourceExpiryScheduler, if any.
+    TimeStamp m_source_expiry;
+    // The last time ExpireSources() ran. Sources that timed out before then
+    // have already been dealt with.
+    TimeStamp m_last_expiry_check;
+
+    // Timing stats. m_input_time is when the oldest input that hasn't been
+    // written to the outputs yet arrived. m_arrival_time is when the kernel
+    // received the same input, if the port knows, from m_wall_clock.
+    TimeStamp m_input_time;
+    TimeStamp m_arrival_time;
+    Clock m_wall_clock;
+    // These are only allocated once there are samples.
+    std::auto_ptr<Histogram> m_latency;
+    std::auto_ptr<Histogram> m_arrival_latency;
+    std::auto_ptr<Histogram> m_merge_time;
+    // The RDM timing for each output port, keyed by the port's unique id.
+    RDMTimingMap m_rdm_timing;
+
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
+    void HandleTimedRDMReply(timed_request_tracker *tracker,
+                             ola::rdm::RDMReply *reply);
+    void ExportRDMTiming(const char *const vars[], const std::string &key,
+                         const ola::rdm::RDMTimingStats::Timing &timing);
+    void RemoveRDMTiming(const std::string &port_id);
     bool UpdateDependants();
+    bool WriteToDependants(const TimeStamp &now);
+    void WritePendingPorts(const TimeStamp &now);
+    void SchedulePendingPorts();
+    void MergeComplete(const TimeStamp &start, const TimeStamp &input_time,
+                       const TimeStamp &arrival_time);
+    void AddTimingSample(std::auto_ptr<Histogram> *histogram,
+                         const TimeInterval &interval,
+                         const char *p50_var, const char *p99_var,
+                         const char *max_var);
     void UpdateName();
     void UpdateMode();
     void HTPMergeSources(const std::vector<DmxSource> &sources);
+    void CollectActiveSources(const TimeStamp &now,
+                              std::vector<DmxSource> *sources) const;
+    void PriorityMergeSources(const std::vector<DmxSource> &sources);
+    bool CanMergeIncrementally(unsigned int changed_index) const;
+    void IncrementalHTPMerge(unsigned int changed_index);
+    void BuildSlotOwners();
+    void MergeSlot(unsigned int slot, const std::vector<DmxSource> &sources);
+    void AddActiveSource(const DmxSource &source, const void *key,
+                         const void *changed_key, int *changed_index);
     bool MergeAll(const InputPort *port, const Client *client);
+    bool CutThroughMerge(const InputPort *port, const Client *client);
+    void UpdateCutThrough();
+    void ScheduleSourceExpiry(const TimeStamp &expiry);
+    bool SourceExpired(const DmxSource &source, const TimeStamp &now) const;
     void PortDiscoveryComplete(BaseCallback0<void> *on_complete,
                                OutputPort *output_port,
                                const ola::rdm::UIDSet &uids);
     void DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *on_complete);
 
+    UIntMap::Handle UniverseVarHandle(const std::string &name);
     void SafeIncrement(const std::string &name);
     void SafeDecrement(const std::string &name);
 
     template<class PortClass>
     bool GenericAddPort(PortClass *port,
-                        std::vector<PortClass*> *ports);
+                        std::vector<PortClass*> *ports,
+                        FlatSet<PortClass*> *index);
 
     template<class PortClass>
     bool GenericRemovePort(PortClass *port,
                           std::vector<PortClass*> *ports,
+                          FlatSet<PortClass*> *index,
                           std::map<ola::rdm::UID, PortClass*> *uid_map = NULL);
 
-    template<class PortClass>
-    bool GenericContainsPort(PortClass *port,
-                             const std::vector<PortClass*> &ports) const;
-
     DISALLOW_COPY_AND_ASSIGN(Universe);
 };
 }  // namespace ola
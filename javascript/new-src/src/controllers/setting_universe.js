@@ -72,6 +72,12 @@ ola.controller('settingUniverseCtrl',
                 modified.push(port.id);
               }
             }
+            if (port.is_output && typeof port.max_frame_rate === 'number') {
+              a[port.id + '_max_frame_rate'] = port.max_frame_rate;
+              if (modified.indexOf(port.id) === -1) {
+                modified.push(port.id);
+              }
+            }
           }
         });
         a.modify_ports = $.grep(modified, Boolean).join(',');
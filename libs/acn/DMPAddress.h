@@ -25,6 +25,7 @@
 #include <string.h>
 #include "ola/io/OutputStream.h"
 #include "ola/network/NetworkUtils.h"
+#include "libs/acn/IOVecBuilder.h"
 
 namespace ola {
 namespace acn {
@@ -277,6 +278,23 @@ class DMPAddressData {
       stream->Write(m_data, m_length);
     }
 
+    // Add the address and data to an IOVecBuilder, the data isn't copied.
+    bool PackIOVec(IOVecBuilder *output) const {
+      if (!m_data)
+        return false;
+
+      unsigned int address_size = m_address->Size();
+      uint8_t *address = output->Reserve(address_size);
+      if (!address)
+        return false;
+      unsigned int length = address_size;
+      if (!m_address->Pack(address, &length))
+        return false;
+      output->Unreserve(address_size - length);
+      output->AddData(m_data, m_length);
+      return true;
+    }
+
  private:
     const type *m_address;
     const uint8_t *m_data;
@@ -18,12 +18,15 @@
  * Copyright (C) 2007 Simon Newton
  */
 
+#include <string.h>
 #include <sys/time.h>
 #include <algorithm>
-#include <map>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/DMPHeader.h"
 #include "libs/acn/DMPPDU.h"
@@ -34,19 +37,38 @@ namespace acn {
 using ola::Callback0;
 using ola::acn::CID;
 using ola::io::OutputStream;
-using std::map;
-using std::pair;
+using std::string;
 using std::vector;
 
 const TimeInterval DMPE131Inflator::EXPIRY_INTERVAL(2500000);
+const TimeInterval DMPE131Inflator::STATS_EXPORT_INTERVAL(1000000);
+
+const char DMPE131Inflator::SOURCE_VAR_PREFIX[] = "e131-source-";
+const char DMPE131Inflator::SOURCE_PACKETS_VAR[] = "e131-source-packets";
+const char DMPE131Inflator::SOURCE_SEQUENCE_GAPS_VAR[] =
+    "e131-source-sequence-gaps";
+const char DMPE131Inflator::SOURCE_OUT_OF_ORDER_VAR[] =
+    "e131-source-out-of-order";
+const char DMPE131Inflator::SOURCE_PRIORITY_VAR[] = "e131-source-priority";
+const char DMPE131Inflator::SOURCE_JITTER_P50_VAR[] =
+    "e131-source-jitter-p50-us";
+const char DMPE131Inflator::SOURCE_JITTER_P99_VAR[] =
+    "e131-source-jitter-p99-us";
+const char DMPE131Inflator::SOURCE_JITTER_MAX_VAR[] =
+    "e131-source-jitter-max-us";
 
 
 DMPE131Inflator::~DMPE131Inflator() {
-  UniverseHandlers::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    delete iter->second.closure;
+  vector<handler_slot>::iterator iter = m_handler_slots.begin();
+  for (; iter != m_handler_slots.end(); ++iter) {
+    if (iter->handler) {
+      ClearSources(iter->handler);
+      ClearStats(iter->handler);
+      delete iter->handler->closure;
+      delete iter->handler;
+    }
   }
-  m_handlers.clear();
+  m_handler_slots.clear();
 }
 
 
@@ -62,18 +84,19 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     return true;
   }
 
-  E131Header e131_header = headers.GetE131Header();
-  UniverseHandlers::iterator universe_iter =
-      m_handlers.find(e131_header.Universe());
-
+  const E131Header &e131_header = headers.GetE131Header();
   if (e131_header.PreviewData() && m_ignore_preview) {
     OLA_DEBUG << "Ignoring preview data";
     return true;
   }
 
-  if (universe_iter == m_handlers.end())
+  universe_handler *universe_data = FindHandler(e131_header.Universe());
+  if (!universe_data)
     return true;
 
+  if (m_packets_var)
+    UpdateStats(universe_data, headers);
+
   DMPHeader dmp_header = headers.GetDMPHeader();
 
   if (!dmp_header.IsVirtual() || dmp_header.IsRelative() ||
@@ -116,50 +139,65 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     start_code = *(data + available_length);
 
   // The only time we want to continue processing a non-0 start code is if it
-  // contains a Terminate message.
-  if (start_code && !e131_header.StreamTerminated()) {
+  // contains per-slot priorities or a Terminate message.
+  bool slot_priorities = (!e131_header.UsingRev2() &&
+                          start_code == PRIORITY_START_CODE);
+  if (start_code && !slot_priorities && !e131_header.StreamTerminated()) {
     OLA_INFO << "Skipping packet with non-0 start code: " << start_code;
     return true;
   }
 
   DmxBuffer *target_buffer;
-  if (!TrackSourceIfRequired(&universe_iter->second, headers,
-                             &target_buffer)) {
+  if (!TrackSourceIfRequired(universe_data, headers, &target_buffer)) {
     // no need to continue processing
     return true;
   }
 
+  // With a single source there's nothing to merge, so the data is copied
+  // straight into the universe buffer. The source's own buffer is only filled
+  // in if another source appears.
+  bool direct = (target_buffer && universe_data->source_count == 1 &&
+                 target_buffer == &universe_data->sources[0].buffer);
+  if (!direct) {
+    RestoreSourceBuffers(universe_data);
+  }
+
+  // The slot priorities are kept with the source, they're used from the next
+  // merge onwards.
+  if (target_buffer && slot_priorities) {
+    for (unsigned int i = 0; i < universe_data->source_count; i++) {
+      dmx_source *source = &universe_data->sources[i];
+      if (&source->buffer == target_buffer) {
+        unsigned int slots = std::min(length_remaining, address->Number());
+        source->slot_priorities.Set(data + available_length + 1, slots - 1);
+        m_clock->CurrentTime(&source->slot_priorities_heard);
+        break;
+      }
+    }
+  }
+
   // Reaching here means that we actually have new data and we should merge.
   if (target_buffer && start_code == 0) {
+    DmxBuffer *output = direct ? universe_data->buffer : target_buffer;
     unsigned int channels = std::min(length_remaining, address->Number());
     if (e131_header.UsingRev2())
-      target_buffer->Set(data + available_length, channels);
+      output->Set(data + available_length, channels);
     else
-     target_buffer->Set(data + available_length + 1, channels - 1);
+     output->Set(data + available_length + 1, channels - 1);
+    if (direct) {
+      universe_data->sources[0].in_universe_buffer = true;
+    }
+    if (universe_data->arrival) {
+      *universe_data->arrival = headers.GetTransportHeader().Arrival();
+    }
   }
 
-  if (universe_iter->second.priority)
-    *universe_iter->second.priority = universe_iter->second.active_priority;
+  if (universe_data->priority)
+    *universe_data->priority = universe_data->active_priority;
 
-  // merge the sources
-  switch (universe_iter->second.sources.size()) {
-    case 0:
-      universe_iter->second.buffer->Reset();
-      break;
-    case 1:
-      universe_iter->second.buffer->Set(
-          universe_iter->second.sources[0].buffer);
-      universe_iter->second.closure->Run();
-      break;
-    default:
-      // HTP Merge
-      universe_iter->second.buffer->Reset();
-      std::vector<dmx_source>::const_iterator source_iter =
-        universe_iter->second.sources.begin();
-      for (; source_iter != universe_iter->second.sources.end(); ++source_iter)
-        universe_iter->second.buffer->HTPMerge(source_iter->buffer);
-      universe_iter->second.closure->Run();
-  }
+  MergeSources(universe_data);
+  if (universe_data->source_count)
+    RunOrHoldHandler(universe_data, e131_header);
   return true;
 }
 
@@ -170,28 +208,43 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
  * @param buffer the DmxBuffer to update with the data
  * @param handler the Callback0 to call when there is data for this universe.
  * Ownership of the closure is transferred to the node.
+ * @param arrival if not NULL, this is set to the time the kernel received the
+ *   data.
+ * @param slot_priorities if not NULL, this is set to the per-slot priorities
+ *   of the merged data. It's empty unless a source sends 0xDD packets.
  */
 bool DMPE131Inflator::SetHandler(uint16_t universe,
                                  ola::DmxBuffer *buffer,
                                  uint8_t *priority,
-                                 ola::Callback0<void> *closure) {
+                                 ola::Callback0<void> *closure,
+                                 TimeStamp *arrival,
+                                 ola::DmxBuffer *slot_priorities) {
   if (!closure || !buffer)
     return false;
 
-  UniverseHandlers::iterator iter = m_handlers.find(universe);
-
-  if (iter == m_handlers.end()) {
-    universe_handler handler;
-    handler.buffer = buffer;
-    handler.closure = closure;
-    handler.active_priority = 0;
-    handler.priority = priority;
-    m_handlers[universe] = handler;
+  universe_handler *handler = FindHandler(universe);
+
+  if (!handler) {
+    handler = new universe_handler;
+    handler->buffer = buffer;
+    handler->closure = closure;
+    handler->active_priority = 0;
+    handler->priority = priority;
+    handler->arrival = arrival;
+    handler->slot_priorities = slot_priorities;
+    handler->sync_address = 0;
+    handler->sync_pending = false;
+    handler->source_count = 0;
+    InsertHandler(universe, handler);
   } else {
-    Callback0<void> *old_closure = iter->second.closure;
-    iter->second.closure = closure;
-    iter->second.buffer = buffer;
-    iter->second.priority = priority;
+    // The data for a single source may be held in the old buffer.
+    RestoreSourceBuffers(handler);
+    Callback0<void> *old_closure = handler->closure;
+    handler->closure = closure;
+    handler->buffer = buffer;
+    handler->priority = priority;
+    handler->arrival = arrival;
+    handler->slot_priorities = slot_priorities;
     delete old_closure;
   }
   return true;
@@ -204,18 +257,527 @@ bool DMPE131Inflator::SetHandler(uint16_t universe,
  * @param true if removed, false if it didn't exist
  */
 bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
-  UniverseHandlers::iterator iter = m_handlers.find(universe);
+  universe_handler *handler = EraseHandler(universe);
 
-  if (iter != m_handlers.end()) {
-    Callback0<void> *old_closure = iter->second.closure;
-    m_handlers.erase(iter);
-    delete old_closure;
+  if (handler) {
+    ClearSources(handler);
+    ClearStats(handler);
+    delete handler->closure;
+    delete handler;
     return true;
   }
   return false;
 }
 
 
+void DMPE131Inflator::SetExportMap(ola::ExportMap *export_map) {
+  if (!export_map) {
+    m_packets_var = NULL;
+    return;
+  }
+  const string label("source");
+  m_packets_var = export_map->GetUIntMapVar(SOURCE_PACKETS_VAR, label);
+  m_sequence_gaps_var = export_map->GetUIntMapVar(SOURCE_SEQUENCE_GAPS_VAR,
+                                                  label);
+  m_out_of_order_var = export_map->GetUIntMapVar(SOURCE_OUT_OF_ORDER_VAR,
+                                                 label);
+  m_priority_var = export_map->GetUIntMapVar(SOURCE_PRIORITY_VAR, label);
+  m_jitter_p50_var = export_map->GetUIntMapVar(SOURCE_JITTER_P50_VAR, label);
+  m_jitter_p99_var = export_map->GetUIntMapVar(SOURCE_JITTER_P99_VAR, label);
+  m_jitter_max_var = export_map->GetUIntMapVar(SOURCE_JITTER_MAX_VAR, label);
+}
+
+
+/*
+ * Run the handlers for all universes that are waiting for this sync address.
+ */
+void DMPE131Inflator::HandleSync(uint16_t sync_address) {
+  if (!sync_address)
+    return;
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  vector<handler_slot>::iterator iter = m_handler_slots.begin();
+  for (; iter != m_handler_slots.end(); ++iter) {
+    universe_handler *handler = iter->handler;
+    if (handler && handler->sync_address == sync_address) {
+      handler->last_sync = now;
+      if (handler->sync_pending) {
+        handler->sync_pending = false;
+        handler->closure->Run();
+      }
+    }
+  }
+}
+
+
+/*
+ * Find the handler for a universe.
+ * @param universe the universe to look up
+ * @returns the universe_handler or NULL if there isn't one.
+ */
+DMPE131Inflator::universe_handler *DMPE131Inflator::FindHandler(
+    uint16_t universe) const {
+  const unsigned int mask = (1u << m_table_bits) - 1;
+  unsigned int index = SlotIndex(universe);
+  while (m_handler_slots[index].handler) {
+    if (m_handler_slots[index].universe == universe)
+      return m_handler_slots[index].handler;
+    index = (index + 1) & mask;
+  }
+  return NULL;
+}
+
+
+/*
+ * Add a handler to the table, the universe must not already be present.
+ */
+void DMPE131Inflator::InsertHandler(uint16_t universe,
+                                    universe_handler *handler) {
+  // Keep the load factor at or below 1/2.
+  if (2 * (m_handler_count + 1) > m_handler_slots.size())
+    GrowTable();
+
+  const unsigned int mask = (1u << m_table_bits) - 1;
+  unsigned int index = SlotIndex(universe);
+  while (m_handler_slots[index].handler)
+    index = (index + 1) & mask;
+  m_handler_slots[index].universe = universe;
+  m_handler_slots[index].handler = handler;
+  m_handler_count++;
+}
+
+
+/*
+ * Remove a universe from the table.
+ * @returns the universe_handler that was removed, or NULL if there wasn't one.
+ */
+DMPE131Inflator::universe_handler *DMPE131Inflator::EraseHandler(
+    uint16_t universe) {
+  const unsigned int mask = (1u << m_table_bits) - 1;
+  unsigned int index = SlotIndex(universe);
+  while (m_handler_slots[index].handler &&
+         m_handler_slots[index].universe != universe) {
+    index = (index + 1) & mask;
+  }
+
+  universe_handler *handler = m_handler_slots[index].handler;
+  if (!handler)
+    return NULL;
+
+  // Shift back any entries in the same run that can move into the hole, this
+  // avoids the need for tombstones.
+  unsigned int hole = index;
+  unsigned int next = (hole + 1) & mask;
+  while (m_handler_slots[next].handler) {
+    unsigned int home = SlotIndex(m_handler_slots[next].universe);
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      m_handler_slots[hole] = m_handler_slots[next];
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+  m_handler_slots[hole].handler = NULL;
+  m_handler_count--;
+  return handler;
+}
+
+
+/*
+ * Return the preferred slot for a universe, using Fibonacci hashing so that
+ * runs of consecutive universes are spread across the table.
+ */
+unsigned int DMPE131Inflator::SlotIndex(uint16_t universe) const {
+  return (universe * 2654435769u) >> (32 - m_table_bits);
+}
+
+
+/*
+ * Double the size of the universe table.
+ */
+void DMPE131Inflator::GrowTable() {
+  vector<handler_slot> old_slots(2 * m_handler_slots.size());
+  old_slots.swap(m_handler_slots);
+  m_table_bits++;
+  m_handler_count = 0;
+
+  vector<handler_slot>::const_iterator iter = old_slots.begin();
+  for (; iter != old_slots.end(); ++iter) {
+    if (iter->handler)
+      InsertHandler(iter->universe, iter->handler);
+  }
+}
+
+
+/*
+ * Start tracking a new source for a universe, there must be a free slot.
+ */
+DMPE131Inflator::dmx_source *DMPE131Inflator::AddSource(
+    uint16_t universe,
+    universe_handler *universe_data,
+    const CID &cid,
+    const TimeStamp &now) {
+  dmx_source *source = &universe_data->sources[universe_data->source_count++];
+  source->cid = cid;
+  cid.Pack(source->cid_data);
+  source->last_heard_from = now;
+  source->in_universe_buffer = false;
+  // The slot may have been used by an earlier source.
+  source->buffer.Reset();
+  source->slot_priorities.Reset();
+  source->slot_priorities_heard = TimeStamp();
+  source->expiry_timeout = ola::thread::INVALID_TIMEOUT;
+  ScheduleExpiry(universe, source, EXPIRY_INTERVAL);
+  return source;
+}
+
+
+/*
+ * Stop tracking a source, this keeps the remaining sources in order.
+ */
+void DMPE131Inflator::EraseSource(universe_handler *universe_data,
+                                  unsigned int index) {
+  dmx_source *source = &universe_data->sources[index];
+  if (source->expiry_timeout != ola::thread::INVALID_TIMEOUT)
+    m_scheduler->RemoveTimeout(source->expiry_timeout);
+  for (unsigned int i = index + 1; i < universe_data->source_count; i++)
+    universe_data->sources[i - 1] = universe_data->sources[i];
+  universe_data->source_count--;
+}
+
+
+/*
+ * Stop tracking all the sources from first onwards.
+ */
+void DMPE131Inflator::ClearSources(universe_handler *universe_data,
+                                   unsigned int first) {
+  for (unsigned int i = first; i < universe_data->source_count; i++) {
+    dmx_source *source = &universe_data->sources[i];
+    if (source->expiry_timeout != ola::thread::INVALID_TIMEOUT)
+      m_scheduler->RemoveTimeout(source->expiry_timeout);
+  }
+  if (universe_data->source_count > first)
+    universe_data->source_count = static_cast<uint8_t>(first);
+}
+
+
+/*
+ * Schedule the check for a source that's gone quiet. Packets only update
+ * last_heard_from, the timeout is re-armed when it fires if the source is
+ * still active.
+ */
+void DMPE131Inflator::ScheduleExpiry(uint16_t universe,
+                                     dmx_source *source,
+                                     const TimeInterval &delay) {
+  if (!m_scheduler)
+    return;
+
+  source->expiry_timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &DMPE131Inflator::ExpireSource, universe,
+                        source->cid));
+}
+
+
+/*
+ * Called when the expiry timeout for a source fires.
+ */
+void DMPE131Inflator::ExpireSource(uint16_t universe, CID cid) {
+  universe_handler *universe_data = FindHandler(universe);
+  if (!universe_data)
+    return;
+
+  unsigned int index = 0;
+  while (index < universe_data->source_count &&
+         universe_data->sources[index].cid != cid) {
+    index++;
+  }
+  if (index == universe_data->source_count)
+    return;
+
+  dmx_source *source = &universe_data->sources[index];
+  source->expiry_timeout = ola::thread::INVALID_TIMEOUT;
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  TimeStamp expiry = source->last_heard_from + EXPIRY_INTERVAL;
+  if (now < expiry) {
+    ScheduleExpiry(universe, source, expiry - now);
+    return;
+  }
+
+  OLA_INFO << "source " << cid.ToString() << " has expired";
+  EraseSource(universe_data, index);
+  if (universe_data->source_count == 0) {
+    // Hold the last look until another source takes over.
+    universe_data->active_priority = 0;
+    return;
+  }
+
+  // Drop to the remaining sources now, rather than on the next packet.
+  MergeSources(universe_data);
+  if (universe_data->priority)
+    *universe_data->priority = universe_data->active_priority;
+  universe_data->sync_pending = false;
+  universe_data->closure->Run();
+}
+
+
+/*
+ * Merge the data from the tracked sources into the universe buffer.
+ */
+void DMPE131Inflator::MergeSources(universe_handler *universe_data) {
+  TimeStamp now;
+  bool slot_priorities = false;
+  for (unsigned int i = 0; i < universe_data->source_count; i++) {
+    const dmx_source &source = universe_data->sources[i];
+    if (source.slot_priorities.Size()) {
+      // Only read the clock if a source has sent slot priorities.
+      if (!now.IsSet())
+        m_clock->CurrentTime(&now);
+      slot_priorities |= HasSlotPriorities(source, now);
+    }
+  }
+
+  if (slot_priorities) {
+    PriorityMergeSources(universe_data, now);
+    return;
+  }
+
+  if (universe_data->slot_priorities)
+    universe_data->slot_priorities->Reset();
+
+  switch (universe_data->source_count) {
+    case 0:
+      universe_data->buffer->Reset();
+      break;
+    case 1:
+      if (!universe_data->sources[0].in_universe_buffer) {
+        universe_data->buffer->Set(universe_data->sources[0].buffer);
+      }
+      break;
+    default:
+      // HTP Merge
+      const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+      unsigned int buffer_count = universe_data->source_count;
+      for (unsigned int i = 0; i < buffer_count; i++)
+        buffers[i] = &universe_data->sources[i].buffer;
+      universe_data->buffer->HTPMergeMany(buffers, buffer_count);
+  }
+}
+
+
+/*
+ * Merge the sources slot by slot, using the 0xDD priorities if the source has
+ * them, or the active priority if it doesn't.
+ */
+void DMPE131Inflator::PriorityMergeSources(universe_handler *universe_data,
+                                           const TimeStamp &now) {
+  // The merge may zero slots in the universe buffer, so a single source
+  // can't keep its data there.
+  RestoreSourceBuffers(universe_data);
+
+  const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+  const uint8_t *priorities[MAX_MERGE_SOURCES];
+  unsigned int buffer_count = universe_data->source_count;
+  for (unsigned int i = 0; i < buffer_count; i++) {
+    const dmx_source &source = universe_data->sources[i];
+    buffers[i] = &source.buffer;
+
+    const DmxBuffer &slot_priorities = source.slot_priorities;
+    bool has_slot_priorities = HasSlotPriorities(source, now);
+    if (has_slot_priorities &&
+        slot_priorities.Size() >= buffers[i]->Size()) {
+      priorities[i] = slot_priorities.GetRaw();
+      continue;
+    }
+
+    uint8_t *scratch = m_priority_scratch[i];
+    if (has_slot_priorities) {
+      // The remaining slots aren't controlled by this source.
+      unsigned int length = DMX_UNIVERSE_SIZE;
+      slot_priorities.Get(scratch, &length);
+      memset(scratch + length, 0, DMX_UNIVERSE_SIZE - length);
+    } else {
+      // A slot priority of 0 means 'not controlled', so a source at priority
+      // 0 is bumped up one.
+      memset(scratch,
+             std::max(universe_data->active_priority, static_cast<uint8_t>(1)),
+             DMX_UNIVERSE_SIZE);
+    }
+    priorities[i] = scratch;
+  }
+
+  uint8_t merged_priorities[DMX_UNIVERSE_SIZE];
+  universe_data->buffer->PriorityMergeMany(buffers, priorities, buffer_count,
+                                           merged_priorities);
+  if (universe_data->slot_priorities) {
+    universe_data->slot_priorities->Set(merged_priorities,
+                                        universe_data->buffer->Size());
+  }
+}
+
+
+/*
+ * Check if a source has sent slot priorities recently. They're dropped if
+ * the 0xDD packets stop for as long as it takes a source to expire.
+ */
+bool DMPE131Inflator::HasSlotPriorities(const dmx_source &source,
+                                        const TimeStamp &now) const {
+  return (source.slot_priorities.Size() &&
+          now < source.slot_priorities_heard + EXPIRY_INTERVAL);
+}
+
+
+/*
+ * Copy the data back into the buffer of any source that's been writing
+ * straight into the universe buffer.
+ * @param universe_data the universe_handler struct for this universe.
+ */
+void DMPE131Inflator::RestoreSourceBuffers(universe_handler *universe_data) {
+  for (unsigned int i = 0; i < universe_data->source_count; i++) {
+    dmx_source *source = &universe_data->sources[i];
+    if (source->in_universe_buffer) {
+      source->buffer.Set(*universe_data->buffer);
+      source->in_universe_buffer = false;
+    }
+  }
+}
+
+
+/*
+ * Run the handler for a universe. If the data is synchronized, and we're
+ * receiving the sync packets, the handler is run when the next sync packet
+ * arrives instead.
+ */
+void DMPE131Inflator::RunOrHoldHandler(universe_handler *universe_data,
+                                       const E131Header &e131_header) {
+  uint16_t sync_address = e131_header.SyncAddress();
+  if (sync_address != universe_data->sync_address) {
+    universe_data->sync_address = sync_address;
+    universe_data->last_sync = TimeStamp();
+    if (sync_address && m_sync_address_callback.get())
+      m_sync_address_callback->Run(sync_address);
+  }
+
+  if (sync_address && universe_data->last_sync.IsSet()) {
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    // If the sync packets stop, fall back to processing the data as it
+    // arrives.
+    if (now < universe_data->last_sync + EXPIRY_INTERVAL) {
+      universe_data->sync_pending = true;
+      return;
+    }
+  }
+  universe_data->sync_pending = false;
+  universe_data->closure->Run();
+}
+
+
+/*
+ * Update the receive statistics for the source of this packet. This sees
+ * every packet, including those from sources we're not merging.
+ */
+void DMPE131Inflator::UpdateStats(universe_handler *universe_data,
+                                  const HeaderSet &headers) {
+  const E131Header &e131_header = headers.GetE131Header();
+  const RootHeader &root_header = headers.GetRootHeader();
+
+  source_stats *stats = NULL;
+  vector<source_stats*>::iterator iter = universe_data->stats.begin();
+  for (; iter != universe_data->stats.end(); ++iter) {
+    if (!memcmp((*iter)->cid_data, root_header.CidData(),
+                sizeof((*iter)->cid_data))) {
+      stats = *iter;
+      break;
+    }
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  if (!stats) {
+    if (universe_data->stats.size() == MAX_STATS_SOURCES)
+      return;
+    stats = new source_stats;
+    memcpy(stats->cid_data, root_header.CidData(), sizeof(stats->cid_data));
+    std::ostringstream key;
+    key << e131_header.Universe() << ":" << root_header.GetCid().ToString();
+    stats->key = key.str();
+    stats->packets = 0;
+    stats->sequence_gaps = 0;
+    stats->out_of_order = 0;
+    stats->sequence = e131_header.Sequence();
+    stats->last_interval = -1;
+    universe_data->stats.push_back(stats);
+  } else {
+    // Use the same test as TrackSourceIfRequired().
+    int8_t seq_diff = static_cast<int8_t>(e131_header.Sequence() -
+                                          stats->sequence);
+    if (seq_diff <= 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
+      stats->out_of_order++;
+    } else {
+      if (seq_diff > 1)
+        stats->sequence_gaps += seq_diff - 1;
+      stats->sequence = e131_header.Sequence();
+    }
+
+    int64_t interval = (now - stats->last_arrival).AsInt();
+    if (stats->last_interval >= 0) {
+      int64_t jitter = interval - stats->last_interval;
+      stats->jitter.Add(static_cast<uint32_t>(jitter < 0 ? -jitter : jitter));
+    }
+    stats->last_interval = interval;
+  }
+
+  stats->packets++;
+  stats->priority = e131_header.Priority();
+  stats->last_arrival = now;
+
+  if (stats->packets == 1 ||
+      now >= stats->last_export + STATS_EXPORT_INTERVAL) {
+    stats->last_export = now;
+    ExportStats(*stats);
+  }
+}
+
+
+/*
+ * Copy the statistics for a source to the ExportMap.
+ */
+void DMPE131Inflator::ExportStats(const source_stats &stats) {
+  (*m_packets_var)[stats.key] = stats.packets;
+  (*m_sequence_gaps_var)[stats.key] = stats.sequence_gaps;
+  (*m_out_of_order_var)[stats.key] = stats.out_of_order;
+  (*m_priority_var)[stats.key] = stats.priority;
+  (*m_jitter_p50_var)[stats.key] = stats.jitter.Percentile(50);
+  (*m_jitter_p99_var)[stats.key] = stats.jitter.Percentile(99);
+  (*m_jitter_max_var)[stats.key] = stats.jitter.Max();
+}
+
+
+/*
+ * Remove the statistics for a universe from the ExportMap.
+ */
+void DMPE131Inflator::ClearStats(universe_handler *universe_data) {
+  vector<source_stats*>::const_iterator iter = universe_data->stats.begin();
+  for (; iter != universe_data->stats.end(); ++iter) {
+    if (m_packets_var) {
+      const string &key = (*iter)->key;
+      m_packets_var->Remove(key);
+      m_sequence_gaps_var->Remove(key);
+      m_out_of_order_var->Remove(key);
+      m_priority_var->Remove(key);
+      m_jitter_p50_var->Remove(key);
+      m_jitter_p99_var->Remove(key);
+      m_jitter_max_var->Remove(key);
+    }
+  }
+  STLDeleteElements(&universe_data->stats);
+}
+
+
 /**
  * Get the list of registered universes
  * @param universes a pointer to a vector which is populated with the list of
@@ -223,10 +785,12 @@ bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
  */
 void DMPE131Inflator::RegisteredUniverses(vector<uint16_t> *universes) {
   universes->clear();
-  UniverseHandlers::iterator iter;
-  for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
-    universes->push_back(iter->first);
+  vector<handler_slot>::const_iterator iter = m_handler_slots.begin();
+  for (; iter != m_handler_slots.end(); ++iter) {
+    if (iter->handler)
+      universes->push_back(iter->universe);
   }
+  std::sort(universes->begin(), universes->end());
 }
 
 
@@ -247,33 +811,35 @@ bool DMPE131Inflator::TrackSourceIfRequired(
 
   *buffer = NULL;  // default the buffer to NULL
   ola::TimeStamp now;
-  m_clock.CurrentTime(&now);
+  m_clock->CurrentTime(&now);
   const E131Header &e131_header = headers.GetE131Header();
+  const RootHeader &root_header = headers.GetRootHeader();
   uint8_t priority = e131_header.Priority();
-  vector<dmx_source> &sources = universe_data->sources;
-  vector<dmx_source>::iterator iter = sources.begin();
-
-  while (iter != sources.end()) {
-    if (iter->cid != headers.GetRootHeader().GetCid()) {
-      TimeStamp expiry_time = iter->last_heard_from + EXPIRY_INTERVAL;
-      if (now > expiry_time) {
-        OLA_INFO << "source " << iter->cid.ToString() << " has expired";
-        iter = sources.erase(iter);
-        continue;
-      }
+  dmx_source *sources = universe_data->sources;
+
+  // Expire the other sources and look for this one in a single pass. If we
+  // have a scheduler the sources are expired by timeouts instead.
+  dmx_source *source = NULL;
+  unsigned int i = 0;
+  while (i < universe_data->source_count) {
+    if (!memcmp(sources[i].cid_data, root_header.CidData(),
+                sizeof(sources[i].cid_data))) {
+      source = &sources[i];
+    } else if (!m_scheduler &&
+               now > sources[i].last_heard_from + EXPIRY_INTERVAL) {
+      OLA_INFO << "source " << sources[i].cid.ToString() << " has expired";
+      // Any source we've already found is earlier in the array, so it
+      // doesn't move.
+      EraseSource(universe_data, i);
+      continue;
     }
-    iter++;
+    i++;
   }
 
-  if (sources.empty())
+  if (universe_data->source_count == 0)
     universe_data->active_priority = 0;
 
-  for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    if (iter->cid == headers.GetRootHeader().GetCid())
-      break;
-  }
-
-  if (iter == sources.end()) {
+  if (!source) {
     // This is an untracked source
     if (e131_header.StreamTerminated() ||
         priority < universe_data->active_priority)
@@ -284,70 +850,69 @@ bool DMPE131Inflator::TrackSourceIfRequired(
         e131_header.Universe() << " from " <<
         static_cast<int>(universe_data->active_priority) << " to " <<
         static_cast<int>(priority);
-      sources.clear();
+      ClearSources(universe_data);
       universe_data->active_priority = priority;
     }
 
-    if (sources.size() == MAX_MERGE_SOURCES) {
+    if (universe_data->source_count == MAX_MERGE_SOURCES) {
       // TODO(simon): flag this in the export map
       OLA_WARN << "Max merge sources reached for universe " <<
-        e131_header.Universe() << ", " <<
-        headers.GetRootHeader().GetCid().ToString() << " won't be tracked";
+        e131_header.Universe() << ", " << root_header.GetCid().ToString() <<
+        " won't be tracked";
         return false;
     } else {
-      OLA_INFO << "Added new E1.31 source: " <<
-        headers.GetRootHeader().GetCid().ToString();
-      dmx_source new_source;
-      new_source.cid = headers.GetRootHeader().GetCid();
-      new_source.sequence = e131_header.Sequence();
-      new_source.last_heard_from = now;
-      iter = sources.insert(sources.end(), new_source);
-      *buffer = &iter->buffer;
+      const CID cid = root_header.GetCid();
+      OLA_INFO << "Added new E1.31 source: " << cid.ToString();
+      source = AddSource(e131_header.Universe(), universe_data, cid, now);
+      source->sequence = e131_header.Sequence();
+      *buffer = &source->buffer;
       return true;
     }
 
   } else {
     // We already know about this one, check the seq #
     int8_t seq_diff = static_cast<int8_t>(e131_header.Sequence() -
-                                          iter->sequence);
+                                          source->sequence);
     if (seq_diff <= 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
-      OLA_INFO << "Old packet received, ignoring, this # " <<
+      OLA_INFO_LIMITED << "Old packet received, ignoring, this # " <<
         static_cast<int>(e131_header.Sequence()) << ", last " <<
-        static_cast<int>(iter->sequence);
+        static_cast<int>(source->sequence);
       return false;
     }
-    iter->sequence = e131_header.Sequence();
+    source->sequence = e131_header.Sequence();
+    unsigned int index = static_cast<unsigned int>(source - sources);
 
     if (e131_header.StreamTerminated()) {
-      OLA_INFO << "CID " << headers.GetRootHeader().GetCid().ToString() <<
+      OLA_INFO << "CID " << source->cid.ToString() <<
         " sent a termination for universe " << e131_header.Universe();
-      sources.erase(iter);
-      if (sources.empty())
+      EraseSource(universe_data, index);
+      if (universe_data->source_count == 0)
         universe_data->active_priority = 0;
       // We need to trigger a merge here else the buffer will be stale, we keep
       // the buffer as NULL though so we don't use the data.
       return true;
     }
 
-    iter->last_heard_from = now;
+    source->last_heard_from = now;
     if (priority < universe_data->active_priority) {
-      if (sources.size() == 1) {
+      if (universe_data->source_count == 1) {
         universe_data->active_priority = priority;
       } else {
-        sources.erase(iter);
+        EraseSource(universe_data, index);
         return true;
       }
     } else if (priority > universe_data->active_priority) {
       // new active priority
       universe_data->active_priority = priority;
-      if (sources.size() != 1) {
+      if (universe_data->source_count != 1) {
         // clear all sources other than this one
-        dmx_source this_source = *iter;
-        sources.clear();
-        iter = sources.insert(sources.end(), this_source);
+        if (index)
+          std::swap(sources[0], sources[index]);
+        ClearSources(universe_data, 1);
+        source = &sources[0];
       }
     }
-    *buffer = &iter->buffer;
+    *buffer = &source->buffer;
     return true;
   }
 }
@@ -22,11 +22,16 @@
 #ifndef LIBS_ACN_DMPE131INFLATOR_H_
 #define LIBS_ACN_DMPE131INFLATOR_H_
 
-#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include "ola/Clock.h"
 #include "ola/Callback.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/util/Histogram.h"
 #include "libs/acn/DMPInflator.h"
 
 namespace ola {
@@ -36,18 +41,82 @@ class DMPE131Inflator: public DMPInflator {
   friend class DMPE131InflatorTest;
 
  public:
-    explicit DMPE131Inflator(bool ignore_preview):
+    typedef ola::Callback1<void, uint16_t> SyncAddressCallback;
+
+    /**
+     * @param ignore_preview drop preview data.
+     * @param clock the Clock to use, may be NULL. Ownership is not
+     *   transferred.
+     * @param scheduler the SchedulerInterface used to expire sources, may be
+     *   NULL. If NULL the sources for a universe are only expired when a
+     *   packet arrives for it. Ownership is not transferred.
+     */
+    explicit DMPE131Inflator(bool ignore_preview,
+                             const ola::Clock *clock = NULL,
+                             ola::thread::SchedulerInterface *scheduler = NULL):
       DMPInflator(),
-      m_ignore_preview(ignore_preview) {
+      m_handler_slots(INITIAL_TABLE_SIZE),
+      m_handler_count(0),
+      m_table_bits(INITIAL_TABLE_BITS),
+      m_ignore_preview(ignore_preview),
+      m_clock(clock ? clock : &m_system_clock),
+      m_scheduler(scheduler),
+      m_packets_var(NULL),
+      m_sequence_gaps_var(NULL),
+      m_out_of_order_var(NULL),
+      m_priority_var(NULL),
+      m_jitter_p50_var(NULL),
+      m_jitter_p99_var(NULL),
+      m_jitter_max_var(NULL) {
     }
     ~DMPE131Inflator();
 
     bool SetHandler(uint16_t universe, ola::DmxBuffer *buffer,
-                    uint8_t *priority, ola::Callback0<void> *handler);
+                    uint8_t *priority, ola::Callback0<void> *handler,
+                    TimeStamp *arrival = NULL,
+                    ola::DmxBuffer *slot_priorities = NULL);
     bool RemoveHandler(uint16_t universe);
 
     void RegisteredUniverses(std::vector<uint16_t> *universes);
 
+    /**
+     * @brief Run the handlers for the universes synchronized on this address.
+     * @param sync_address the universe the sync packet was received on.
+     */
+    void HandleSync(uint16_t sync_address);
+
+    /**
+     * @brief Set the callback run when a universe starts using a sync address.
+     * @param callback the callback to run, ownership is transferred.
+     *
+     * The sync packets are sent to the multicast group for the sync address,
+     * so this can be used to join the group.
+     */
+    void SetSyncAddressCallback(SyncAddressCallback *callback) {
+      m_sync_address_callback.reset(callback);
+    }
+
+    /**
+     * @brief Export receive statistics for each source of each universe.
+     * @param export_map the ExportMap to use, may be NULL. Ownership is not
+     *   transferred, the ExportMap must outlive the inflator.
+     *
+     * The variables are keyed by universe:cid, and updated about once a
+     * second while packets are arriving. Nothing is tracked until this is
+     * called.
+     */
+    void SetExportMap(ola::ExportMap *export_map);
+
+    // The names of the per-source variables, they share this prefix.
+    static const char SOURCE_VAR_PREFIX[];
+    static const char SOURCE_PACKETS_VAR[];
+    static const char SOURCE_SEQUENCE_GAPS_VAR[];
+    static const char SOURCE_OUT_OF_ORDER_VAR[];
+    static const char SOURCE_PRIORITY_VAR[];
+    static const char SOURCE_JITTER_P50_VAR[];
+    static const char SOURCE_JITTER_P99_VAR[];
+    static const char SOURCE_JITTER_MAX_VAR[];
+
  protected:
     virtual bool HandlePDUData(uint32_t vector,
                                const HeaderSet &headers,
@@ -55,39 +124,140 @@ class DMPE131Inflator: public DMPInflator {
                                unsigned int pdu_len);
 
  private:
+    // The max number of sources we'll track per universe.
+    static const uint8_t MAX_MERGE_SOURCES = 6;
+
     typedef struct {
       ola::acn::CID cid;
+      // The packed CID, compared against the root header of each packet.
+      uint8_t cid_data[ola::acn::CID::CID_LENGTH];
       uint8_t sequence;
       TimeStamp last_heard_from;
       DmxBuffer buffer;
+      // The per-slot priorities from the last 0xDD packet, may be empty.
+      DmxBuffer slot_priorities;
+      TimeStamp slot_priorities_heard;
+      // true if this source's data is in the universe buffer, not buffer.
+      bool in_universe_buffer;
+      // Only used if there is a scheduler.
+      ola::thread::timeout_id expiry_timeout;
     } dmx_source;
 
+    // The receive statistics for a source, including sources that aren't
+    // being merged.
+    typedef struct {
+      uint8_t cid_data[ola::acn::CID::CID_LENGTH];
+      // The key for the ExportMap, universe:cid
+      std::string key;
+      unsigned int packets;
+      // The number of packets missing from the sequence.
+      unsigned int sequence_gaps;
+      // Packets that arrived after a later packet, these are dropped.
+      unsigned int out_of_order;
+      uint8_t sequence;
+      uint8_t priority;
+      TimeStamp last_arrival;
+      // The last inter-arrival time in microseconds, -1 if there isn't one.
+      int64_t last_interval;
+      TimeStamp last_export;
+      // The change in inter-arrival time between packets, in microseconds.
+      ola::Histogram jitter;
+    } source_stats;
+
     typedef struct {
       DmxBuffer *buffer;
       Callback0<void> *closure;
       uint8_t active_priority;
       uint8_t *priority;
-      std::vector<dmx_source> sources;
+      // Set to the kernel's arrival time of the last data packet, may be NULL.
+      TimeStamp *arrival;
+      // Set to the merged per-slot priorities, may be NULL. This is empty
+      // unless a source is sending 0xDD packets.
+      DmxBuffer *slot_priorities;
+      // The sync address from the last packet, 0 if there isn't one.
+      uint16_t sync_address;
+      // True if there is data waiting for a sync packet.
+      bool sync_pending;
+      TimeStamp last_sync;
+      // The sources at the active priority are kept inline, so a packet only
+      // touches the memory for its own universe.
+      uint8_t source_count;
+      dmx_source sources[MAX_MERGE_SOURCES];
+      // Only used if there is an ExportMap.
+      std::vector<source_stats*> stats;
     } universe_handler;
 
-    typedef std::map<uint16_t, universe_handler> UniverseHandlers;
+    // A slot in the open addressing table of universes. The handlers are
+    // allocated separately so that they don't move when the table grows.
+    typedef struct {
+      uint16_t universe;
+      universe_handler *handler;  // NULL if the slot is empty
+    } handler_slot;
 
-    UniverseHandlers m_handlers;
+    std::vector<handler_slot> m_handler_slots;
+    unsigned int m_handler_count;
+    unsigned int m_table_bits;
     bool m_ignore_preview;
-    ola::Clock m_clock;
+    ola::Clock m_system_clock;
+    const ola::Clock *m_clock;
+    ola::thread::SchedulerInterface *m_scheduler;
+    std::auto_ptr<SyncAddressCallback> m_sync_address_callback;
+    // The slot priorities for the sources that don't send 0xDD packets.
+    uint8_t m_priority_scratch[MAX_MERGE_SOURCES][DMX_UNIVERSE_SIZE];
 
+    UIntMap *m_packets_var;
+    UIntMap *m_sequence_gaps_var;
+    UIntMap *m_out_of_order_var;
+    UIntMap *m_priority_var;
+    UIntMap *m_jitter_p50_var;
+    UIntMap *m_jitter_p99_var;
+    UIntMap *m_jitter_max_var;
+
+    universe_handler *FindHandler(uint16_t universe) const;
+    void InsertHandler(uint16_t universe, universe_handler *handler);
+    universe_handler *EraseHandler(uint16_t universe);
+    unsigned int SlotIndex(uint16_t universe) const;
+    void GrowTable();
+
+    dmx_source *AddSource(uint16_t universe, universe_handler *universe_data,
+                          const CID &cid, const TimeStamp &now);
+    void EraseSource(universe_handler *universe_data, unsigned int index);
+    void ClearSources(universe_handler *universe_data,
+                      unsigned int first = 0);
+    void ScheduleExpiry(uint16_t universe, dmx_source *source,
+                        const TimeInterval &delay);
+    void ExpireSource(uint16_t universe, CID cid);
+    void MergeSources(universe_handler *universe_data);
+    void PriorityMergeSources(universe_handler *universe_data,
+                              const TimeStamp &now);
+    bool HasSlotPriorities(const dmx_source &source,
+                           const TimeStamp &now) const;
+    void RestoreSourceBuffers(universe_handler *universe_data);
+    void RunOrHoldHandler(universe_handler *universe_data,
+                          const E131Header &e131_header);
     bool TrackSourceIfRequired(universe_handler *universe_data,
                                const HeaderSet &headers,
                                DmxBuffer **buffer);
+    void UpdateStats(universe_handler *universe_data,
+                     const HeaderSet &headers);
+    void ExportStats(const source_stats &stats);
+    void ClearStats(universe_handler *universe_data);
 
-    // The max number of sources we'll track per universe.
-    static const uint8_t MAX_MERGE_SOURCES = 6;
+    // The initial size of the universe table, as a power of 2.
+    static const unsigned int INITIAL_TABLE_BITS = 4;
+    static const unsigned int INITIAL_TABLE_SIZE = 1 << INITIAL_TABLE_BITS;
     // The max merge priority.
     static const uint8_t MAX_E131_PRIORITY = 200;
+    // The start code for per-slot priorities.
+    static const uint8_t PRIORITY_START_CODE = 0xdd;
     // ignore packets that differ by less than this amount from the last one
     static const int8_t SEQUENCE_DIFF_THRESHOLD = -20;
     // expire sources after 2.5s
     static const TimeInterval EXPIRY_INTERVAL;
+    // The max number of sources we'll keep statistics for, per universe.
+    static const unsigned int MAX_STATS_SOURCES = 16;
+    // How often the statistics for a source are copied to the ExportMap.
+    static const TimeInterval STATS_EXPORT_INTERVAL;
 };
 }  // namespace acn
 }  // namespace ola
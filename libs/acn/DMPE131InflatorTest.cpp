@@ -0,0 +1,423 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMPE131InflatorTest.cpp
+ * Test fixture for the DMPE131Inflator class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "ola/io/SelectServer.h"
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/HeaderSet.h"
+#include "ola/testing/TestUtils.h"
+
+
+namespace ola {
+namespace acn {
+
+using ola::DmxBuffer;
+using ola::network::IPV4SocketAddress;
+using std::string;
+using std::vector;
+
+class DMPE131InflatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DMPE131InflatorTest);
+  CPPUNIT_TEST(testSingleSource);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testSlotPriorities);
+  CPPUNIT_TEST(testManyUniverses);
+  CPPUNIT_TEST(testSync);
+  CPPUNIT_TEST(testScheduledExpiry);
+  CPPUNIT_TEST(testStats);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    DMPE131InflatorTest()
+        : m_inflator(false, &m_clock),
+          m_calls(0),
+          m_sync_address_calls(0) {
+    }
+
+    void setUp();
+    void testSingleSource();
+    void testMerge();
+    void testSlotPriorities();
+    void testManyUniverses();
+    void testSync();
+    void testScheduledExpiry();
+    void testStats();
+
+ private:
+    ola::MockClock m_clock;
+    DMPE131Inflator m_inflator;
+    DmxBuffer m_buffer;
+    DmxBuffer m_slot_priorities;
+    uint8_t m_priority;
+    TimeStamp m_arrival;
+    // The kernel's arrival time given to the packets from SendData().
+    TimeStamp m_packet_arrival;
+    unsigned int m_calls;
+    unsigned int m_sync_address_calls;
+    CID m_cid1;
+    CID m_cid2;
+
+    void NewData() { m_calls++; }
+    void NewSyncAddress(uint16_t sync_address) {
+      OLA_ASSERT_EQ(SYNC_ADDRESS, sync_address);
+      m_sync_address_calls++;
+    }
+    void SendData(const CID &cid, uint8_t sequence, const string &dmx,
+                  bool terminated = false, uint16_t universe = UNIVERSE,
+                  uint16_t sync_address = 0) {
+      SendData(&m_inflator, cid, sequence, dmx, terminated, universe,
+               sync_address);
+    }
+    void SendData(DMPE131Inflator *inflator, const CID &cid,
+                  uint8_t sequence, const string &dmx, bool terminated,
+                  uint16_t universe, uint16_t sync_address,
+                  uint8_t start_code = DMX512_START_CODE);
+    void SendSlotPriorities(const CID &cid, uint8_t sequence,
+                            const string &priorities) {
+      SendData(&m_inflator, cid, sequence, priorities, false, UNIVERSE, 0,
+               DMPE131Inflator::PRIORITY_START_CODE);
+    }
+
+    static const uint16_t UNIVERSE = 1;
+    static const uint16_t SYNC_ADDRESS = 100;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DMPE131InflatorTest);
+
+const uint16_t DMPE131InflatorTest::SYNC_ADDRESS;
+
+
+void DMPE131InflatorTest::setUp() {
+  m_cid1 = CID::Generate();
+  m_cid2 = CID::Generate();
+  OLA_ASSERT_TRUE(m_inflator.SetHandler(
+      UNIVERSE, &m_buffer, &m_priority,
+      NewCallback(this, &DMPE131InflatorTest::NewData), &m_arrival,
+      &m_slot_priorities));
+}
+
+
+/*
+ * Pass a set property message with the given slot data to the inflator.
+ */
+void DMPE131InflatorTest::SendData(DMPE131Inflator *inflator,
+                                   const CID &cid, uint8_t sequence,
+                                   const string &dmx, bool terminated,
+                                   uint16_t universe, uint16_t sync_address,
+                                   uint8_t start_code) {
+  DmxBuffer buffer;
+  OLA_ASSERT_TRUE(buffer.SetFromString(dmx));
+
+  HeaderSet headers;
+  RootHeader root_header;
+  root_header.SetCid(cid);
+  headers.SetRootHeader(root_header);
+  headers.SetTransportHeader(TransportHeader(
+      IPV4SocketAddress(), TransportHeader::UDP, m_packet_arrival));
+  headers.SetE131Header(E131Header("test", 100, sequence, universe, false,
+                                   terminated, false, sync_address));
+  headers.SetDMPHeader(DMPHeader(true, false, RANGE_EQUAL, TWO_BYTES));
+
+  // start, increment & count, followed by the start code and the data.
+  uint16_t count = static_cast<uint16_t>(buffer.Size() + 1);
+  uint8_t data[7 + DMX_UNIVERSE_SIZE];
+  const uint8_t address[] = {0, 0, 0, 1, static_cast<uint8_t>(count >> 8),
+                             static_cast<uint8_t>(count & 0xff), start_code};
+  memcpy(data, address, sizeof(address));
+  memcpy(data + sizeof(address), buffer.GetRaw(), buffer.Size());
+  OLA_ASSERT_TRUE(inflator->HandlePDUData(
+      DMP_SET_PROPERTY_VECTOR, headers, data,
+      static_cast<unsigned int>(sizeof(address) + buffer.Size())));
+}
+
+
+/*
+ * Check the data from a single source ends up in the universe buffer.
+ */
+void DMPE131InflatorTest::testSingleSource() {
+  m_clock.CurrentTime(&m_packet_arrival);
+  SendData(m_cid1, 1, "1,2,3");
+  OLA_ASSERT_EQ(1u, m_calls);
+  OLA_ASSERT_EQ(string("1,2,3"), m_buffer.ToString());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), m_priority);
+  OLA_ASSERT_EQ(m_packet_arrival, m_arrival);
+  m_packet_arrival = TimeStamp();
+
+  SendData(m_cid1, 2, "4,5");
+  OLA_ASSERT_EQ(2u, m_calls);
+  OLA_ASSERT_EQ(string("4,5"), m_buffer.ToString());
+
+  // an old packet is ignored
+  SendData(m_cid1, 1, "9,9,9");
+  OLA_ASSERT_EQ(2u, m_calls);
+  OLA_ASSERT_EQ(string("4,5"), m_buffer.ToString());
+
+  // terminating the stream resets the buffer
+  SendData(m_cid1, 3, "", true);
+  OLA_ASSERT_EQ(0u, m_buffer.Size());
+}
+
+
+/*
+ * Check that the data from the first source isn't lost when a second source
+ * appears, since it's only been written to the universe buffer.
+ */
+void DMPE131InflatorTest::testMerge() {
+  SendData(m_cid1, 1, "10,0,30");
+  SendData(m_cid1, 2, "10,20,30");
+  OLA_ASSERT_EQ(string("10,20,30"), m_buffer.ToString());
+
+  SendData(m_cid2, 1, "5,25,5,40");
+  OLA_ASSERT_EQ(3u, m_calls);
+  OLA_ASSERT_EQ(string("10,25,30,40"), m_buffer.ToString());
+
+  SendData(m_cid1, 3, "50,0,0");
+  OLA_ASSERT_EQ(string("50,25,5,40"), m_buffer.ToString());
+
+  // Once the second source leaves, the first one's data is used directly
+  // again.
+  SendData(m_cid2, 2, "", true);
+  OLA_ASSERT_EQ(string("50,0,0"), m_buffer.ToString());
+  SendData(m_cid1, 4, "1,2");
+  OLA_ASSERT_EQ(string("1,2"), m_buffer.ToString());
+
+  // And then a new source.
+  SendData(m_cid2, 3, "0,0,3");
+  OLA_ASSERT_EQ(string("1,2,3"), m_buffer.ToString());
+}
+
+
+/*
+ * Check the 0xDD packets change the merge, and are passed on to the port.
+ */
+void DMPE131InflatorTest::testSlotPriorities() {
+  SendData(m_cid1, 1, "10,10,10");
+  SendData(m_cid2, 1, "20,20,20");
+  OLA_ASSERT_EQ(string("20,20,20"), m_buffer.ToString());
+  OLA_ASSERT_EQ(0u, m_slot_priorities.Size());
+
+  // The first source takes slot 0, gives up slot 1 and ties on slot 2.
+  SendSlotPriorities(m_cid1, 2, "150,0,100");
+  OLA_ASSERT_EQ(3u, m_calls);
+  OLA_ASSERT_EQ(string("10,20,20"), m_buffer.ToString());
+  OLA_ASSERT_EQ(string("150,100,100"), m_slot_priorities.ToString());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), m_priority);
+
+  SendData(m_cid1, 3, "5,50,50");
+  OLA_ASSERT_EQ(string("5,20,50"), m_buffer.ToString());
+
+  // A single source doesn't control slot 1.
+  SendData(m_cid2, 2, "", true);
+  OLA_ASSERT_EQ(string("5,0,50"), m_buffer.ToString());
+  OLA_ASSERT_EQ(string("150,0,100"), m_slot_priorities.ToString());
+
+  // The slot priorities are dropped once the 0xDD packets stop.
+  m_clock.AdvanceTime(3, 0);
+  SendData(m_cid1, 4, "5,50,50");
+  OLA_ASSERT_EQ(string("5,50,50"), m_buffer.ToString());
+  OLA_ASSERT_EQ(0u, m_slot_priorities.Size());
+}
+
+
+/*
+ * Check that the universe table copes with many universes, including removing
+ * them.
+ */
+void DMPE131InflatorTest::testManyUniverses() {
+  const uint16_t UNIVERSE_COUNT = 1000;
+  vector<DmxBuffer> buffers(UNIVERSE_COUNT + 1);
+  for (uint16_t universe = 2; universe <= UNIVERSE_COUNT; universe++) {
+    OLA_ASSERT_TRUE(m_inflator.SetHandler(
+        universe, &buffers[universe], NULL,
+        NewCallback(this, &DMPE131InflatorTest::NewData)));
+  }
+
+  // remove every third universe
+  for (uint16_t universe = 3; universe <= UNIVERSE_COUNT; universe += 3) {
+    OLA_ASSERT_TRUE(m_inflator.RemoveHandler(universe));
+  }
+  OLA_ASSERT_FALSE(m_inflator.RemoveHandler(3));
+  OLA_ASSERT_FALSE(m_inflator.RemoveHandler(UNIVERSE_COUNT + 1));
+
+  vector<uint16_t> universes;
+  m_inflator.RegisteredUniverses(&universes);
+  OLA_ASSERT_EQ(static_cast<size_t>(667), universes.size());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(1), universes[0]);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(2), universes[1]);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(4), universes[2]);
+  OLA_ASSERT_EQ(UNIVERSE_COUNT, universes.back());
+
+  for (uint16_t universe = 1; universe <= UNIVERSE_COUNT; universe++) {
+    SendData(m_cid1, 1, "1,2,3", false, universe);
+  }
+  OLA_ASSERT_EQ(667u, m_calls);
+  OLA_ASSERT_EQ(string("1,2,3"), m_buffer.ToString());
+  OLA_ASSERT_EQ(string("1,2,3"), buffers[500].ToString());
+  OLA_ASSERT_EQ(0u, buffers[501].Size());
+  OLA_ASSERT_EQ(string("1,2,3"), buffers[UNIVERSE_COUNT].ToString());
+}
+
+
+/*
+ * Check synchronized data is held until the sync packet arrives.
+ */
+void DMPE131InflatorTest::testSync() {
+  m_inflator.SetSyncAddressCallback(
+      NewCallback(this, &DMPE131InflatorTest::NewSyncAddress));
+
+  // Until a sync packet is received the data is processed immediately.
+  SendData(m_cid1, 1, "1,2", false, UNIVERSE, SYNC_ADDRESS);
+  OLA_ASSERT_EQ(1u, m_calls);
+  OLA_ASSERT_EQ(1u, m_sync_address_calls);
+  m_inflator.HandleSync(SYNC_ADDRESS);
+  OLA_ASSERT_EQ(1u, m_calls);
+
+  SendData(m_cid1, 2, "3,4", false, UNIVERSE, SYNC_ADDRESS);
+  OLA_ASSERT_EQ(1u, m_calls);
+  m_inflator.HandleSync(SYNC_ADDRESS + 1);
+  OLA_ASSERT_EQ(1u, m_calls);
+  m_inflator.HandleSync(SYNC_ADDRESS);
+  OLA_ASSERT_EQ(2u, m_calls);
+  OLA_ASSERT_EQ(string("3,4"), m_buffer.ToString());
+
+  // A second sync doesn't run the handler again.
+  m_inflator.HandleSync(SYNC_ADDRESS);
+  OLA_ASSERT_EQ(2u, m_calls);
+  OLA_ASSERT_EQ(1u, m_sync_address_calls);
+
+  // If the sync packets stop, the data is processed as it arrives.
+  m_clock.AdvanceTime(3, 0);
+  SendData(m_cid1, 3, "5,6", false, UNIVERSE, SYNC_ADDRESS);
+  OLA_ASSERT_EQ(3u, m_calls);
+
+  // Unsynchronized data is always processed immediately.
+  m_inflator.HandleSync(SYNC_ADDRESS);
+  SendData(m_cid1, 4, "7,8");
+  OLA_ASSERT_EQ(4u, m_calls);
+  OLA_ASSERT_EQ(string("7,8"), m_buffer.ToString());
+}
+
+
+/*
+ * Check that sources are expired by timeouts when there is a scheduler.
+ */
+void DMPE131InflatorTest::testScheduledExpiry() {
+  ola::io::SelectServer ss(NULL, &m_clock);
+  DMPE131Inflator inflator(false, &m_clock, &ss);
+  DmxBuffer buffer;
+  OLA_ASSERT_TRUE(inflator.SetHandler(
+      UNIVERSE, &buffer, NULL,
+      NewCallback(this, &DMPE131InflatorTest::NewData)));
+
+  SendData(&inflator, m_cid1, 1, "10,20", false, UNIVERSE, 0);
+  SendData(&inflator, m_cid2, 1, "30,0,5", false, UNIVERSE, 0);
+  OLA_ASSERT_EQ(2u, m_calls);
+  OLA_ASSERT_EQ(string("30,20,5"), buffer.ToString());
+
+  // The first source keeps sending, the second goes quiet.
+  m_clock.AdvanceTime(2, 0);
+  SendData(&inflator, m_cid1, 2, "10,20", false, UNIVERSE, 0);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(3u, m_calls);
+
+  // The second source is dropped without waiting for another packet.
+  m_clock.AdvanceTime(1, 0);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(4u, m_calls);
+  OLA_ASSERT_EQ(string("10,20"), buffer.ToString());
+
+  // The first source was heard from 1s ago, so it's still active.
+  m_clock.AdvanceTime(1, 0);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(4u, m_calls);
+
+  // Once it expires the last data is held until another source appears.
+  m_clock.AdvanceTime(1, 0);
+  ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(4u, m_calls);
+  OLA_ASSERT_EQ(string("10,20"), buffer.ToString());
+
+  SendData(&inflator, m_cid2, 2, "1,2,3", false, UNIVERSE, 0);
+  OLA_ASSERT_EQ(5u, m_calls);
+  OLA_ASSERT_EQ(string("1,2,3"), buffer.ToString());
+}
+
+
+/*
+ * Check the per-source statistics.
+ */
+void DMPE131InflatorTest::testStats() {
+  ExportMap export_map;
+  m_inflator.SetExportMap(&export_map);
+  const string key = "1:" + m_cid1.ToString();
+  UIntMap *packets = export_map.GetUIntMapVar(
+      DMPE131Inflator::SOURCE_PACKETS_VAR);
+  UIntMap *gaps = export_map.GetUIntMapVar(
+      DMPE131Inflator::SOURCE_SEQUENCE_GAPS_VAR);
+  UIntMap *out_of_order = export_map.GetUIntMapVar(
+      DMPE131Inflator::SOURCE_OUT_OF_ORDER_VAR);
+  UIntMap *priority = export_map.GetUIntMapVar(
+      DMPE131Inflator::SOURCE_PRIORITY_VAR);
+  UIntMap *jitter_max = export_map.GetUIntMapVar(
+      DMPE131Inflator::SOURCE_JITTER_MAX_VAR);
+
+  // The first packet is exported straight away.
+  SendData(m_cid1, 10, "1,2,3");
+  OLA_ASSERT_EQ(1u, (*packets)[key]);
+  OLA_ASSERT_EQ(100u, (*priority)[key]);
+
+  // Then one packet is lost, and another arrives late.
+  m_clock.AdvanceTime(0, 25000);
+  SendData(m_cid1, 11, "1,2,3");
+  m_clock.AdvanceTime(0, 25000);
+  SendData(m_cid1, 13, "1,2,3");
+  m_clock.AdvanceTime(0, 5000);
+  SendData(m_cid1, 12, "4,5,6");
+  OLA_ASSERT_EQ(1u, (*packets)[key]);
+  OLA_ASSERT_EQ(string("1,2,3"), m_buffer.ToString());
+
+  m_clock.AdvanceTime(1, 0);
+  SendData(m_cid1, 14, "1,2,3");
+  OLA_ASSERT_EQ(5u, (*packets)[key]);
+  OLA_ASSERT_EQ(1u, (*gaps)[key]);
+  OLA_ASSERT_EQ(1u, (*out_of_order)[key]);
+  // The intervals were 25ms, 25ms, 5ms and 1s, the MockClock also moves with
+  // the system clock.
+  OLA_ASSERT_TRUE((*jitter_max)[key] >= 995000u);
+  OLA_ASSERT_TRUE((*jitter_max)[key] < 1000000u);
+
+  // Removing the universe removes its statistics.
+  OLA_ASSERT_TRUE(m_inflator.RemoveHandler(UNIVERSE));
+  OLA_ASSERT_TRUE(packets->begin() == packets->end());
+  OLA_ASSERT_TRUE(jitter_max->begin() == jitter_max->end());
+}
+}  // namespace acn
+}  // namespace ola
@@ -235,6 +235,15 @@ class DMPSetProperty: public DMPPDU {
         iter->Write(stream);
     }
 
+    bool PackDataIOVec(IOVecBuilder *output) const {
+      typename AddressDataChunks::const_iterator iter;
+      for (iter = m_chunks.begin(); iter != m_chunks.end(); ++iter) {
+        if (!iter->PackIOVec(output))
+          return false;
+      }
+      return true;
+    }
+
  private:
     AddressDataChunks m_chunks;
 };
@@ -24,13 +24,15 @@
 #include <ola/base/Macro.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <string>
 
 namespace ola {
 namespace acn {
 
 /*
- * Header for the E131 layer
+ * Header for the E131 layer. The source name is held in a fixed length
+ * buffer, so decoding a packet doesn't allocate a string.
  */
 class E131Header {
  public:
@@ -40,7 +42,9 @@ class E131Header {
           m_universe(0),
           m_is_preview(false),
           m_has_terminated(false),
-          m_is_rev2(false) {
+          m_is_rev2(false),
+          m_sync_address(0) {
+      m_source[0] = 0;
     }
     E131Header(const std::string &source,
                uint8_t priority,
@@ -48,18 +52,40 @@ class E131Header {
                uint16_t universe,
                bool is_preview = false,
                bool has_terminated = false,
-               bool is_rev2 = false)
-        : m_source(source),
-          m_priority(priority),
+               bool is_rev2 = false,
+               uint16_t sync_address = 0)
+        : m_priority(priority),
           m_sequence(sequence),
           m_universe(universe),
           m_is_preview(is_preview),
           m_has_terminated(has_terminated),
-          m_is_rev2(is_rev2) {
+          m_is_rev2(is_rev2),
+          m_sync_address(sync_address) {
+      SetSource(source.c_str());
+    }
+    // source must be NULL terminated.
+    E131Header(const char *source,
+               uint8_t priority,
+               uint8_t sequence,
+               uint16_t universe,
+               bool is_preview = false,
+               bool has_terminated = false,
+               bool is_rev2 = false,
+               uint16_t sync_address = 0)
+        : m_priority(priority),
+          m_sequence(sequence),
+          m_universe(universe),
+          m_is_preview(is_preview),
+          m_has_terminated(has_terminated),
+          m_is_rev2(is_rev2),
+          m_sync_address(sync_address) {
+      SetSource(source);
     }
     ~E131Header() {}
 
+    // Names longer than SOURCE_NAME_LEN are truncated.
     const std::string Source() const { return m_source; }
+    const char *SourceName() const { return m_source; }
     uint8_t Priority() const { return m_priority; }
     uint8_t Sequence() const { return m_sequence; }
     uint16_t Universe() const { return m_universe; }
@@ -68,14 +94,19 @@ class E131Header {
 
     bool UsingRev2() const { return m_is_rev2; }
 
+    // The universe the sync packets for this data are sent on, 0 if the data
+    // isn't synchronized.
+    uint16_t SyncAddress() const { return m_sync_address; }
+
     bool operator==(const E131Header &other) const {
-      return m_source == other.m_source &&
+      return strcmp(m_source, other.m_source) == 0 &&
         m_priority == other.m_priority &&
         m_sequence == other.m_sequence &&
         m_universe == other.m_universe &&
         m_is_preview == other.m_is_preview &&
         m_has_terminated == other.m_has_terminated &&
-        m_is_rev2 == other.m_is_rev2;
+        m_is_rev2 == other.m_is_rev2 &&
+        m_sync_address == other.m_sync_address;
     }
 
     enum { SOURCE_NAME_LEN = 64 };
@@ -84,7 +115,7 @@ class E131Header {
     struct e131_pdu_header_s {
       char source[SOURCE_NAME_LEN];
       uint8_t priority;
-      uint16_t reserved;
+      uint16_t sync_address;
       uint8_t sequence;
       uint8_t options;
       uint16_t universe;
@@ -95,13 +126,19 @@ class E131Header {
     static const uint8_t STREAM_TERMINATED_MASK = 0x40;
 
  private:
-    std::string m_source;
+    char m_source[SOURCE_NAME_LEN + 1];
     uint8_t m_priority;
     uint8_t m_sequence;
     uint16_t m_universe;
     bool m_is_preview;
     bool m_has_terminated;
     bool m_is_rev2;
+    uint16_t m_sync_address;
+
+    void SetSource(const char *source) {
+      strncpy(m_source, source, SOURCE_NAME_LEN);
+      m_source[SOURCE_NAME_LEN] = 0;
+    }
 };
 
 
@@ -116,6 +153,15 @@ class E131Rev2Header: public E131Header {
         : E131Header(source, priority, sequence, universe, is_preview,
                      has_terminated, true) {
     }
+    E131Rev2Header(const char *source,
+                   uint8_t priority,
+                   uint8_t sequence,
+                   uint16_t universe,
+                   bool is_preview = false,
+                   bool has_terminated = false)
+        : E131Header(source, priority, sequence, universe, is_preview,
+                     has_terminated, true) {
+    }
 
     enum { REV2_SOURCE_NAME_LEN = 32 };
 
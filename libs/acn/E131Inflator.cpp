@@ -46,16 +46,17 @@ bool E131Inflator::DecodeHeader(HeaderSet *headers,
       E131Header::e131_pdu_header raw_header;
       memcpy(&raw_header, data, sizeof(E131Header::e131_pdu_header));
       raw_header.source[E131Header::SOURCE_NAME_LEN - 1] = 0x00;
-      E131Header header(
+      m_last_header = E131Header(
           raw_header.source,
           raw_header.priority,
           raw_header.sequence,
           NetworkToHost(raw_header.universe),
           raw_header.options & E131Header::PREVIEW_DATA_MASK,
-          raw_header.options & E131Header::STREAM_TERMINATED_MASK);
-      m_last_header = header;
+          raw_header.options & E131Header::STREAM_TERMINATED_MASK,
+          false,
+          NetworkToHost(raw_header.sync_address));
       m_last_header_valid = true;
-      headers->SetE131Header(header);
+      headers->SetE131Header(m_last_header);
       *bytes_used = sizeof(E131Header::e131_pdu_header);
       return true;
     }
@@ -66,7 +67,7 @@ bool E131Inflator::DecodeHeader(HeaderSet *headers,
   // use the last header if it exists
   *bytes_used = 0;
   if (!m_last_header_valid) {
-    OLA_WARN << "Missing E131 Header data";
+    OLA_WARN_LIMITED << "Missing E131 Header data";
     return false;
   }
   headers->SetE131Header(m_last_header);
@@ -92,13 +93,12 @@ bool E131InflatorRev2::DecodeHeader(HeaderSet *headers,
       E131Rev2Header::e131_rev2_pdu_header raw_header;
       memcpy(&raw_header, data, sizeof(E131Rev2Header::e131_rev2_pdu_header));
       raw_header.source[E131Rev2Header::REV2_SOURCE_NAME_LEN - 1] = 0x00;
-      E131Rev2Header header(raw_header.source,
-                            raw_header.priority,
-                            raw_header.sequence,
-                            NetworkToHost(raw_header.universe));
-      m_last_header = header;
+      m_last_header = E131Rev2Header(raw_header.source,
+                                     raw_header.priority,
+                                     raw_header.sequence,
+                                     NetworkToHost(raw_header.universe));
       m_last_header_valid = true;
-      headers->SetE131Header(header);
+      headers->SetE131Header(m_last_header);
       *bytes_used = sizeof(E131Rev2Header::e131_rev2_pdu_header);
       return true;
     }
@@ -109,7 +109,7 @@ bool E131InflatorRev2::DecodeHeader(HeaderSet *headers,
   // use the last header if it exists
   *bytes_used = 0;
   if (!m_last_header_valid) {
-    OLA_WARN << "Missing E131 Header data";
+    OLA_WARN_LIMITED << "Missing E131 Header data";
     return false;
   }
   headers->SetE131Header(m_last_header);
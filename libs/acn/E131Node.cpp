@@ -26,10 +26,15 @@
 #include <utility>
 #include <vector>
 #include "ola/Constants.h"
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/stl/STLUtils.h"
 #include "libs/acn/E131Node.h"
+#include "libs/acn/E131PDU.h"
+#include "libs/acn/IOVecBuilder.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootPDU.h"
 
 namespace ola {
 namespace acn {
@@ -100,7 +105,10 @@ void TrackedSource::NewPage(uint8_t page_number, uint8_t last_page,
   }
 
   if (expected_page == total_pages + 1) {
-    universes = new_universes;
+    // The set is usually the same as last time, so avoid touching it.
+    if (universes != new_universes) {
+      universes.swap(new_universes);
+    }
     received_pages.clear();
     new_universes.clear();
     total_pages = 0;
@@ -117,11 +125,14 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
       m_cid(cid),
       m_root_sender(m_cid),
       m_e131_sender(&m_socket, &m_root_sender),
-      m_dmp_inflator(options.ignore_preview),
+      m_dmp_inflator(options.ignore_preview, options.clock, ss),
       m_discovery_inflator(NewCallback(this, &E131Node::NewDiscoveryPage)),
+      m_sync_inflator(NewCallback(this, &E131Node::NewSync)),
       m_incoming_udp_transport(&m_socket, &m_root_inflator),
       m_send_buffer(NULL),
-      m_discovery_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_sync_timeout(ola::thread::INVALID_TIMEOUT),
+      m_discovery_timeout(ola::thread::INVALID_TIMEOUT),
+      m_discovery_packets_valid(false) {
 
 
   if (!m_options.use_rev2) {
@@ -133,9 +144,13 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
   // setup all the inflators
   m_root_inflator.AddInflator(&m_e131_inflator);
   m_root_inflator.AddInflator(&m_e131_rev2_inflator);
+  m_root_inflator.AddInflator(&m_sync_inflator);
   m_e131_inflator.AddInflator(&m_dmp_inflator);
   m_e131_inflator.AddInflator(&m_discovery_inflator);
   m_e131_rev2_inflator.AddInflator(&m_dmp_inflator);
+  m_dmp_inflator.SetSyncAddressCallback(
+      NewCallback(this, &E131Node::JoinSyncGroup));
+  m_dmp_inflator.SetExportMap(m_options.export_map);
 }
 
 
@@ -155,6 +170,12 @@ E131Node::~E131Node() {
   if (m_send_buffer)
     delete[] m_send_buffer;
 
+  ActiveTxUniverses::iterator tx_iter = m_tx_universes.begin();
+  for (; tx_iter != m_tx_universes.end(); ++tx_iter) {
+    delete tx_iter->second.packet;
+  }
+  m_tx_universes.clear();
+
   STLDeleteValues(&m_discovered_sources);
 }
 
@@ -180,28 +201,63 @@ bool E131Node::Start() {
 
   m_socket.SetTos(m_options.dscp);
   m_socket.SetMulticastInterface(m_interface.ip_address);
+  if (m_options.receive_buffer_size) {
+    m_socket.SetReceiveBufferSize(m_options.receive_buffer_size);
+  }
+  if (m_options.send_buffer_size) {
+    m_socket.SetSendBufferSize(m_options.send_buffer_size);
+  }
+  m_socket.EnableDropCounting();
+  m_socket.EnableReceiveTimestamps();
 
   m_socket.SetOnData(NewCallback(&m_incoming_udp_transport,
                                  &IncomingUDPTransport::Receive));
 
+  const string name = "e131:" + m_interface.ip_address.ToString();
+  m_incoming_udp_transport.ExportDrops(m_options.export_map, name);
+  if (m_options.batch_transmit) {
+    m_tx_batcher.reset(new ola::network::UDPTransmitBatcher(
+        m_ss, &m_socket, m_options.export_map, name));
+    m_tx_batcher->SetPacing(TimeInterval(
+        static_cast<int64_t>(m_options.transmit_pacing_ms) * ONE_THOUSAND));
+    m_e131_sender.SetBatcher(m_tx_batcher.get());
+  }
+
+  MulticastMembershipManager::Options membership_options;
+  membership_options.max_groups_per_socket = m_options.max_groups_per_socket;
+  membership_options.receive_buffer_size = m_options.receive_buffer_size;
+  membership_options.export_map = m_options.export_map;
+  membership_options.name = name;
+  m_membership.reset(new MulticastMembershipManager(
+      m_ss, m_options.select_server, &m_socket, m_interface.ip_address,
+      m_options.port, &m_root_inflator, membership_options));
+
   if (m_options.enable_draft_discovery) {
     IPV4Address addr;
     m_e131_sender.UniverseIP(DISCOVERY_UNIVERSE_ID, &addr);
+    m_membership->Join(addr);
 
-    if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-      OLA_WARN << "Failed to join multicast group " << addr;
-    }
-
-    m_discovery_timeout = m_ss->RegisterRepeatingTimeout(
-        UNIVERSE_DISCOVERY_INTERVAL,
+    m_discovery_timeout = m_ss->RegisterPeriodicTask(
+        TimeInterval(UNIVERSE_DISCOVERY_INTERVAL * ONE_THOUSAND),
         ola::NewCallback(this, &E131Node::PerformDiscoveryHousekeeping));
   }
   return true;
 }
 
 bool E131Node::Stop() {
-  m_ss->RemoveTimeout(m_discovery_timeout);
+  m_ss->RemovePeriodicTask(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_pending_syncs.clear();
+  // This sends anything that's still queued.
+  m_e131_sender.SetBatcher(NULL);
+  m_tx_batcher.reset();
+  // This leaves the multicast groups and closes any extra sockets.
+  m_membership.reset();
+  m_sync_groups.clear();
   return true;
 }
 
@@ -213,6 +269,27 @@ bool E131Node::SetSourceName(uint16_t universe, const string &source) {
     settings->source = source;
   } else {
     iter->second.source = source;
+    // The template will be rebuilt with the new name.
+    delete iter->second.packet;
+    iter->second.packet = NULL;
+  }
+  return true;
+}
+
+bool E131Node::SetSyncAddress(uint16_t universe, uint16_t sync_address) {
+  ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
+  tx_universe *settings;
+
+  if (iter == m_tx_universes.end()) {
+    settings = SetupOutgoingSettings(universe);
+  } else {
+    settings = &iter->second;
+  }
+
+  if (settings->sync_address != sync_address) {
+    settings->sync_address = sync_address;
+    delete settings->packet;
+    settings->packet = NULL;
   }
   return true;
 }
@@ -235,7 +312,7 @@ bool E131Node::TerminateStream(uint16_t universe, uint8_t priority) {
   for (unsigned int i = 0; i < 3; i++) {
     SendStreamTerminated(universe, DmxBuffer(), priority);
   }
-  STLRemove(&m_tx_universes, universe);
+  RemoveOutgoingSettings(universe);
   return true;
 }
 
@@ -261,41 +338,53 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
     settings = &iter->second;
   }
 
-  const uint8_t *dmp_data;
-  unsigned int dmp_data_length;
-
-  if (m_options.use_rev2) {
-    dmp_data = buffer.GetRaw();
-    dmp_data_length = buffer.Size();
-  } else {
-    unsigned int data_size = DMX_UNIVERSE_SIZE;
-    buffer.Get(m_send_buffer + 1, &data_size);
-    dmp_data = m_send_buffer;
-    dmp_data_length = data_size + 1;
+  IPV4Address destination;
+  if (!E131Sender::UniverseIP(universe, &destination)) {
+    return false;
   }
 
-  TwoByteRangeDMPAddress range_addr(0, 1, (uint16_t) dmp_data_length);
-  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
-                                                     dmp_data,
-                                                     dmp_data_length);
-  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
-  ranged_chunks.push_back(range_chunk);
-  const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true,
-                                                       false,
-                                                       ranged_chunks);
-
-  E131Header header(settings->source,
-                    priority,
-                    static_cast<uint8_t>(settings->sequence + sequence_offset),
-                    universe,
-                    preview,  // preview
-                    false,  // terminated
-                    m_options.use_rev2);
+  // The packet is only built once per universe, after that the frame is
+  // patched in.
+  if (!settings->packet) {
+    settings->packet = new E131PacketTemplate();
+    if (!settings->packet->Init(m_cid, settings->source, universe,
+                                m_options.use_rev2, settings->sync_address)) {
+      delete settings->packet;
+      settings->packet = NULL;
+      return false;
+    }
+  }
 
-  bool result = m_e131_sender.SendDMP(header, pdu);
+  E131PacketTemplate *packet = settings->packet;
+  packet->Update(buffer,
+                 static_cast<uint8_t>(settings->sequence + sequence_offset),
+                 priority, preview);
+
+  bool result;
+  const vector<IPV4Address> *receivers = UnicastDestinationsFor(universe);
+  if (receivers) {
+    // The same bytes go to every receiver, the frame counts as sent if any
+    // of them got it.
+    result = false;
+    vector<IPV4Address>::const_iterator receiver_iter = receivers->begin();
+    for (; receiver_iter != receivers->end(); ++receiver_iter) {
+      result |= SendDatagram(packet->Data(), packet->Size(), *receiver_iter);
+    }
+  } else {
+    result = SendDatagram(packet->Data(), packet->Size(), destination);
+  }
   if (result && !sequence_offset)
     settings->sequence++;
-  delete pdu;
+
+  // The sync packet is sent once all the universes have been sent.
+  if (result && settings->sync_address && !m_options.use_rev2) {
+    m_pending_syncs.insert(settings->sync_address);
+    if (m_sync_timeout == ola::thread::INVALID_TIMEOUT) {
+      m_sync_timeout = m_ss->RegisterSingleTimeout(
+          TimeInterval(0, 0),
+          MakeInlineCallback(this, &E131Node::SendPendingSyncs));
+    }
+  }
   return result;
 }
 
@@ -335,7 +424,17 @@ bool E131Node::SendStreamTerminated(uint16_t universe,
                     true,  // terminated
                     false);
 
-  bool result = m_e131_sender.SendDMP(header, pdu);
+  bool result;
+  const vector<IPV4Address> *receivers = UnicastDestinationsFor(universe);
+  if (receivers) {
+    result = false;
+    vector<IPV4Address>::const_iterator receiver_iter = receivers->begin();
+    for (; receiver_iter != receivers->end(); ++receiver_iter) {
+      result |= m_e131_sender.SendDMP(header, pdu, *receiver_iter);
+    }
+  } else {
+    result = m_e131_sender.SendDMP(header, pdu);
+  }
   // only update if we were previously tracking this universe
   if (result && iter != m_tx_universes.end())
     iter->second.sequence++;
@@ -343,23 +442,38 @@ bool E131Node::SendStreamTerminated(uint16_t universe,
   return result;
 }
 
+bool E131Node::SendSync(uint16_t sync_address) {
+  uint8_t &sequence = m_sync_sequences[sync_address];
+  bool result = m_e131_sender.SendSync(sequence, sync_address);
+  if (result)
+    sequence++;
+  return result;
+}
+
 bool E131Node::SetHandler(uint16_t universe,
                           DmxBuffer *buffer,
                           uint8_t *priority,
-                          Callback0<void> *closure) {
+                          Callback0<void> *closure,
+                          TimeStamp *arrival,
+                          DmxBuffer *slot_priorities) {
+  if (!m_membership.get()) {
+    OLA_WARN << "E1.31 node not started, can't listen on universe "
+             << universe;
+    delete closure;
+    return false;
+  }
+
   IPV4Address addr;
   if (!m_e131_sender.UniverseIP(universe, &addr)) {
     OLA_WARN << "Unable to determine multicast group for universe " <<
       universe;
+    delete closure;
     return false;
   }
 
-  if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-    OLA_WARN << "Failed to join multicast group " << addr;
-    return false;
-  }
-
-  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure);
+  m_membership->Join(addr);
+  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure,
+                                   arrival, slot_priorities);
 }
 
 bool E131Node::RemoveHandler(uint16_t universe) {
@@ -370,9 +484,9 @@ bool E131Node::RemoveHandler(uint16_t universe) {
     return false;
   }
 
-  if (!m_socket.LeaveMulticast(m_interface.ip_address, addr)) {
-    OLA_WARN << "Failed to leave multicast group " << addr;
-    return false;
+  // Stay in the group if sync packets are sent to it.
+  if (m_membership.get() && !STLContains(m_sync_groups, universe)) {
+    m_membership->Leave(addr);
   }
 
   return m_dmp_inflator.RemoveHandler(universe);
@@ -399,22 +513,77 @@ E131Node::tx_universe *E131Node::SetupOutgoingSettings(uint16_t universe) {
   tx_universe settings;
   settings.source = m_options.source_name;
   settings.sequence = 0;
+  settings.sync_address = 0;
+  settings.packet = NULL;
   ActiveTxUniverses::iterator iter =
       m_tx_universes.insert(std::make_pair(universe, settings)).first;
+  m_discovery_packets_valid = false;
   return &iter->second;
 }
 
 
+/*
+ * Remove the settings for an outgoing universe
+ */
+void E131Node::RemoveOutgoingSettings(uint16_t universe) {
+  ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
+  if (iter != m_tx_universes.end()) {
+    delete iter->second.packet;
+    m_tx_universes.erase(iter);
+    m_discovery_packets_valid = false;
+  }
+}
+
+
+void E131Node::SendPendingSyncs() {
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  set<uint16_t>::const_iterator iter = m_pending_syncs.begin();
+  for (; iter != m_pending_syncs.end(); ++iter) {
+    SendSync(*iter);
+  }
+  m_pending_syncs.clear();
+}
+
+
+void E131Node::NewSync(OLA_UNUSED const HeaderSet &headers,
+                       OLA_UNUSED uint8_t sequence,
+                       uint16_t sync_address) {
+  m_dmp_inflator.HandleSync(sync_address);
+}
+
+
+/*
+ * Join the multicast group for a sync address, the first time one of the
+ * universes we're receiving uses it.
+ */
+void E131Node::JoinSyncGroup(uint16_t sync_address) {
+  if (!m_membership.get() || STLContains(m_sync_groups, sync_address))
+    return;
+
+  IPV4Address addr;
+  if (!m_e131_sender.UniverseIP(sync_address, &addr))
+    return;
+
+  m_membership->Join(addr);
+  m_sync_groups.insert(sync_address);
+}
+
+
 bool E131Node::PerformDiscoveryHousekeeping() {
-  // Send the Universe Discovery packets.
-  vector<uint16_t> universes;
-  STLKeys(m_tx_universes, &universes);
+  // Send the Universe Discovery packets, these are only rebuilt if the
+  // universes have changed.
+  if (!m_discovery_packets_valid) {
+    BuildDiscoveryPackets();
+  }
 
-  uint8_t last_page = static_cast<uint8_t>(
-    universes.size() / DISCOVERY_PAGE_SIZE);
-  uint32_t sequence_number = 0;
-  for (uint8_t i = 0; i <= last_page; i++) {
-    SendDiscoveryPage(universes, i, last_page, sequence_number);
+  IPV4Address destination;
+  E131Sender::UniverseIP(DISCOVERY_UNIVERSE_ID, &destination);
+  vector<vector<uint8_t> >::const_iterator packet_iter =
+      m_discovery_packets.begin();
+  for (; packet_iter != m_discovery_packets.end(); ++packet_iter) {
+    SendDatagram(&(*packet_iter)[0],
+                 static_cast<unsigned int>(packet_iter->size()),
+                 destination);
   }
 
   // Delete any sources that we haven't heard from in 2 x
@@ -457,19 +626,38 @@ void E131Node::NewDiscoveryPage(
              << headers.GetTransportHeader().Source().Host();
     source->ip_address = headers.GetTransportHeader().Source().Host();
   }
-  source->source_name = headers.GetE131Header().Source();
+  const char *source_name = headers.GetE131Header().SourceName();
+  if (source->source_name != source_name) {
+    source->source_name = source_name;
+  }
   source->NewPage(page.page_number, page.last_page, page.page_sequence,
                   page.universes);
 }
 
-void E131Node::SendDiscoveryPage(const std::vector<uint16_t> &universes,
+/*
+ * Serialize the Universe Discovery packets for the universes we're sending.
+ */
+void E131Node::BuildDiscoveryPackets() {
+  vector<uint16_t> universes;
+  STLKeys(m_tx_universes, &universes);
+
+  uint8_t last_page = static_cast<uint8_t>(
+    universes.size() / DISCOVERY_PAGE_SIZE);
+  m_discovery_packets.resize(last_page + 1);
+  for (uint8_t i = 0; i <= last_page; i++) {
+    PackDiscoveryPage(universes, i, last_page, &m_discovery_packets[i]);
+  }
+  m_discovery_packets_valid = true;
+}
+
+void E131Node::PackDiscoveryPage(const std::vector<uint16_t> &universes,
                                  uint8_t this_page,
                                  uint8_t last_page,
-                                 OLA_UNUSED uint32_t sequence_number) {
+                                 vector<uint8_t> *packet) {
   uint16_t in_this_page = static_cast<uint16_t>(this_page == last_page ?
       universes.size() % DISCOVERY_PAGE_SIZE : DISCOVERY_PAGE_SIZE);
 
-  uint16_t *page_data = new uint16_t[in_this_page + 1];
+  uint16_t page_data[DISCOVERY_PAGE_SIZE + 1];
   page_data[0] = HostToNetwork(
       static_cast<uint16_t>(this_page << 8 | last_page));
 
@@ -479,9 +667,55 @@ void E131Node::SendDiscoveryPage(const std::vector<uint16_t> &universes,
   }
 
   E131Header header(m_options.source_name, 0, 0, DISCOVERY_UNIVERSE_ID);
-  m_e131_sender.SendDiscoveryData(
-      header, reinterpret_cast<uint8_t*>(page_data), (in_this_page + 1) * 2);
-  delete[] page_data;
+  E131PDU e131_pdu(ola::acn::VECTOR_E131_DISCOVERY, header,
+                   reinterpret_cast<uint8_t*>(page_data),
+                   (in_this_page + 1) * 2);
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+  RootPDU root_pdu(ola::acn::VECTOR_ROOT_E131, m_cid, &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  IOVecBuilder output;
+  unsigned int size = PreamblePacker::MAX_DATAGRAM_SIZE;
+  packet->resize(size);
+  if (!PreamblePacker::PackIOVec(root_block, &output) ||
+      !output.Flatten(&(*packet)[0], &size)) {
+    OLA_WARN << "Failed to pack discovery page " << static_cast<int>(this_page);
+    packet->clear();
+    return;
+  }
+  packet->resize(size);
+}
+
+/*
+ * Send a serialized datagram, using the batcher if there is one.
+ */
+bool E131Node::SendDatagram(const uint8_t *data, unsigned int size,
+                            const IPV4Address &destination) {
+  if (!size) {
+    return false;
+  }
+
+  IPV4SocketAddress target(destination, ola::acn::ACN_PORT);
+  if (m_tx_batcher.get()) {
+    return m_tx_batcher->SendTo(data, size, target) > 0;
+  }
+  return m_socket.SendTo(data, size, target) > 0;
+}
+
+/*
+ * Return the unicast receivers for a universe, or NULL if the universe is
+ * sent to its multicast group.
+ */
+const vector<IPV4Address> *E131Node::UnicastDestinationsFor(
+    uint16_t universe) const {
+  UnicastDestinations::const_iterator iter =
+      m_options.unicast_destinations.find(universe);
+  if (iter == m_options.unicast_destinations.end() || iter->second.empty()) {
+    return NULL;
+  }
+  return &iter->second;
 }
 }  // namespace acn
 }  // namespace ola
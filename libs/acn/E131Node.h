@@ -23,23 +23,30 @@
 #define LIBS_ACN_E131NODE_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 #include "ola/Callback.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/acn/ACNPort.h"
 #include "ola/acn/CID.h"
 #include "ola/base/Macro.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/thread/SchedulerInterface.h"
+#include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPTransmitBatcher.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
 #include "libs/acn/E131Inflator.h"
+#include "libs/acn/E131PacketTemplate.h"
 #include "libs/acn/E131Sender.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/MulticastMembershipManager.h"
 #include "libs/acn/RootInflator.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
@@ -52,6 +59,12 @@ class E131Node {
   /**
    * @brief Options for the E131Node.
    */
+  /**
+   * @brief The unicast receivers for each universe.
+   */
+  typedef std::map<uint16_t, std::vector<ola::network::IPV4Address> >
+      UnicastDestinations;
+
   struct Options {
    public:
     Options()
@@ -60,7 +73,16 @@ class E131Node {
          enable_draft_discovery(false),
          dscp(0),
          port(ola::acn::ACN_PORT),
-         source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
+         source_name(ola::OLA_DEFAULT_INSTANCE_NAME),
+         batch_transmit(false),
+         transmit_pacing_ms(0),
+         receive_buffer_size(0),
+         send_buffer_size(0),
+         export_map(NULL),
+         clock(NULL),
+         select_server(NULL),
+         max_groups_per_socket(
+             MulticastMembershipManager::DEFAULT_MAX_GROUPS_PER_SOCKET) {
     }
 
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
@@ -69,6 +91,42 @@ class E131Node {
     uint8_t dscp;  /**< The DSCP value to tag packets with */
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
     std::string source_name; /**< The source name to use */
+    /** Send the packets from each loop iteration together */
+    bool batch_transmit;
+    /**
+     * Spread each batch over this many milliseconds, see
+     * UDPTransmitBatcher::SetPacing(). 0 sends each batch at once.
+     */
+    unsigned int transmit_pacing_ms;
+    /** The kernel receive buffer size for each socket, 0 for the default */
+    unsigned int receive_buffer_size;
+    /** The kernel send buffer size, 0 for the default */
+    unsigned int send_buffer_size;
+    /**
+     * The ExportMap for the transmit batch, pacer, multicast, kernel drop and
+     * per-source receive stats, may be NULL
+     */
+    ola::ExportMap *export_map;
+    /**
+     * The Clock used to expire sources, may return a cached time. If NULL
+     * the system clock is read for each packet.
+     */
+    const ola::Clock *clock;
+    /**
+     * The SelectServerInterface used to register extra sockets once the
+     * node's socket has joined max_groups_per_socket multicast groups. If
+     * NULL only the node's socket is used.
+     */
+    ola::io::SelectServerInterface *select_server;
+    /** The number of multicast groups to join on each socket */
+    unsigned int max_groups_per_socket;
+    /**
+     * Universes listed here are sent to each of their unicast receivers
+     * instead of the multicast group. The packet is built once and the same
+     * bytes are sent to every receiver, through the batcher if
+     * batch_transmit is set.
+     */
+    UnicastDestinations unicast_destinations;
   };
 
   struct KnownController {
@@ -108,6 +166,18 @@ class E131Node {
    */
   bool SetSourceName(uint16_t universe, const std::string &source);
 
+  /**
+   * @brief Set the synchronization address for a universe.
+   * @param universe the id of the universe to send
+   * @param sync_address the universe to send the sync packets on, or 0 to
+   *   disable synchronization.
+   *
+   * Once set, a sync packet is sent at the end of each event loop iteration
+   * in which DMX data was sent for one of the universes using this address.
+   * Synchronization isn't supported by revision 0.2.
+   */
+  bool SetSyncAddress(uint16_t universe, uint16_t sync_address);
+
   /**
    * @brief Signal that we will start sending on this particular universe.
    *   Without sending any DMX data.
@@ -171,6 +241,13 @@ class E131Node {
                             const ola::DmxBuffer &buffer = DmxBuffer(),
                             uint8_t priority = DEFAULT_PRIORITY);
 
+  /**
+   * @brief Send a synchronization packet now.
+   * @param sync_address the universe to send the sync packet on.
+   * @return true if it was sent successfully, false otherwise
+   */
+  bool SendSync(uint16_t sync_address);
+
   /**
    * @brief Set the Callback to be run when we receive data for this universe.
    * @param universe the universe to register the handler for
@@ -178,9 +255,19 @@ class E131Node {
    * @param priority the priority to set.
    * @param handler the Callback to call when there is data for this universe.
    *   Ownership is transferred.
+   * @param arrival if not NULL, this is set to the time the kernel received
+   *   the data. It's unset if the time isn't known.
+   * @param slot_priorities if not NULL, this is set to the per-slot
+   *   priorities from the 0xDD packets. It's empty if no source sends them.
+   *
+   * If the data is synchronized, the handler is run when the sync packet
+   * arrives. The multicast group for the universe is joined at the end of
+   * the current event loop iteration. The node must have been started.
    */
   bool SetHandler(uint16_t universe, ola::DmxBuffer *buffer,
-                  uint8_t *priority, ola::Callback0<void> *handler);
+                  uint8_t *priority, ola::Callback0<void> *handler,
+                  TimeStamp *arrival = NULL,
+                  ola::DmxBuffer *slot_priorities = NULL);
 
   /**
    * @brief Remove the handler for a particular universe.
@@ -211,6 +298,9 @@ class E131Node {
   struct tx_universe {
     std::string source;
     uint8_t sequence;
+    uint16_t sync_address;
+    // Built on the first SendDMX(), owned by the node.
+    E131PacketTemplate *packet;
   };
 
   typedef std::map<uint16_t, tx_universe> ActiveTxUniverses;
@@ -223,6 +313,7 @@ class E131Node {
 
   ola::network::Interface m_interface;
   ola::network::UDPSocket m_socket;
+  std::auto_ptr<ola::network::UDPTransmitBatcher> m_tx_batcher;
   // senders
   RootSender m_root_sender;
   E131Sender m_e131_sender;
@@ -232,22 +323,44 @@ class E131Node {
   E131InflatorRev2 m_e131_rev2_inflator;
   DMPE131Inflator m_dmp_inflator;
   E131DiscoveryInflator m_discovery_inflator;
+  E131SyncInflator m_sync_inflator;
 
   IncomingUDPTransport m_incoming_udp_transport;
+  std::auto_ptr<MulticastMembershipManager> m_membership;
   ActiveTxUniverses m_tx_universes;
   uint8_t *m_send_buffer;
 
+  // Sync members
+  std::map<uint16_t, uint8_t> m_sync_sequences;
+  std::set<uint16_t> m_pending_syncs;
+  std::set<uint16_t> m_sync_groups;
+  ola::thread::timeout_id m_sync_timeout;
+
   // Discovery members
   ola::thread::timeout_id m_discovery_timeout;
   TrackedSources m_discovered_sources;
+  // The serialized discovery pages, rebuilt when the tx universes change.
+  std::vector<std::vector<uint8_t> > m_discovery_packets;
+  bool m_discovery_packets_valid;
 
   tx_universe *SetupOutgoingSettings(uint16_t universe);
+  void RemoveOutgoingSettings(uint16_t universe);
+
+  void SendPendingSyncs();
+  void NewSync(const HeaderSet &headers, uint8_t sequence,
+               uint16_t sync_address);
+  void JoinSyncGroup(uint16_t sync_address);
 
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
                         const E131DiscoveryInflator::DiscoveryPage &page);
-  void SendDiscoveryPage(const std::vector<uint16_t> &universes, uint8_t page,
-                         uint8_t last_page, uint32_t sequence_number);
+  void BuildDiscoveryPackets();
+  void PackDiscoveryPage(const std::vector<uint16_t> &universes, uint8_t page,
+                         uint8_t last_page, std::vector<uint8_t> *packet);
+  bool SendDatagram(const uint8_t *data, unsigned int size,
+                    const ola::network::IPV4Address &destination);
+  const std::vector<ola::network::IPV4Address> *UnicastDestinationsFor(
+      uint16_t universe) const;
 
   static const uint16_t DEFAULT_PRIORITY = 100;
   static const uint16_t UNIVERSE_DISCOVERY_INTERVAL = 10000;  // milliseconds
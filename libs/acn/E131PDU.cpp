@@ -22,7 +22,6 @@
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/network/NetworkUtils.h"
-#include "ola/strings/Utils.h"
 #include "libs/acn/DMPPDU.h"
 #include "libs/acn/E131PDU.h"
 
@@ -70,8 +69,8 @@ bool E131PDU::PackHeader(uint8_t *data, unsigned int *length) const {
 
   if (m_header.UsingRev2()) {
     E131Rev2Header::e131_rev2_pdu_header header;
-    strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
-                                     arraysize(header.source));
+    // header.source may not be NULL terminated.
+    strncpy(header.source, m_header.SourceName(), arraysize(header.source));
     header.priority = m_header.Priority();
     header.sequence = m_header.Sequence();
     header.universe = HostToNetwork(m_header.Universe());
@@ -79,10 +78,10 @@ bool E131PDU::PackHeader(uint8_t *data, unsigned int *length) const {
     memcpy(data, &header, *length);
   } else {
     E131Header::e131_pdu_header header;
-    strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
-                                     arraysize(header.source));
+    // header.source may not be NULL terminated.
+    strncpy(header.source, m_header.SourceName(), arraysize(header.source));
     header.priority = m_header.Priority();
-    header.reserved = 0;
+    header.sync_address = HostToNetwork(m_header.SyncAddress());
     header.sequence = m_header.Sequence();
     header.options = static_cast<uint8_t>(
         (m_header.PreviewData() ? E131Header::PREVIEW_DATA_MASK : 0) |
@@ -111,14 +110,26 @@ bool E131PDU::PackData(uint8_t *data, unsigned int *length) const {
 }
 
 
+/*
+ * Add the data to an IOVecBuilder, the slot data is referenced in place.
+ */
+bool E131PDU::PackDataIOVec(IOVecBuilder *output) const {
+  if (m_dmp_pdu)
+    return m_dmp_pdu->PackIOVec(output);
+  if (m_data)
+    output->AddData(m_data, m_data_size);
+  return true;
+}
+
+
 /*
  * Pack the header into a buffer.
  */
 void E131PDU::PackHeader(OutputStream *stream) const {
   if (m_header.UsingRev2()) {
     E131Rev2Header::e131_rev2_pdu_header header;
-    strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
-                                     arraysize(header.source));
+    // header.source may not be NULL terminated.
+    strncpy(header.source, m_header.SourceName(), arraysize(header.source));
     header.priority = m_header.Priority();
     header.sequence = m_header.Sequence();
     header.universe = HostToNetwork(m_header.Universe());
@@ -126,10 +137,10 @@ void E131PDU::PackHeader(OutputStream *stream) const {
                   sizeof(E131Rev2Header::e131_rev2_pdu_header));
   } else {
     E131Header::e131_pdu_header header;
-    strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
-                                     arraysize(header.source));
+    // header.source may not be NULL terminated.
+    strncpy(header.source, m_header.SourceName(), arraysize(header.source));
     header.priority = m_header.Priority();
-    header.reserved = 0;
+    header.sync_address = HostToNetwork(m_header.SyncAddress());
     header.sequence = m_header.Sequence();
     header.options = static_cast<uint8_t>(
         (m_header.PreviewData() ? E131Header::PREVIEW_DATA_MASK : 0) |
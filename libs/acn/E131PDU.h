@@ -60,6 +60,8 @@ class E131PDU: public PDU {
   void PackHeader(ola::io::OutputStream *stream) const;
   void PackData(ola::io::OutputStream *stream) const;
 
+  bool PackDataIOVec(IOVecBuilder *output) const;
+
  private:
   E131Header m_header;
   const DMPPDU *m_dmp_pdu;
@@ -21,10 +21,18 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
 #include <string>
+#include <vector>
 
+#include "ola/Constants.h"
+#include "ola/acn/CID.h"
 #include "ola/network/NetworkUtils.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/IOVecBuilder.h"
 #include "libs/acn/PDUTestCommon.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootPDU.h"
 #include "ola/testing/TestUtils.h"
 
 namespace ola {
@@ -32,18 +40,21 @@ namespace acn {
 
 using ola::network::HostToNetwork;
 using std::string;
+using std::vector;
 
 class E131PDUTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(E131PDUTest);
   CPPUNIT_TEST(testSimpleRev2E131PDU);
   CPPUNIT_TEST(testSimpleE131PDU);
   CPPUNIT_TEST(testNestedE131PDU);
+  CPPUNIT_TEST(testPackIOVec);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testSimpleRev2E131PDU();
     void testSimpleE131PDU();
     void testNestedE131PDU();
+    void testPackIOVec();
  private:
     static const unsigned int TEST_VECTOR;
 };
@@ -157,5 +168,65 @@ void E131PDUTest::testSimpleE131PDU() {
 void E131PDUTest::testNestedE131PDU() {
   // TODO(simon): add this test
 }
+
+
+/*
+ * Check that PackIOVec() produces the same data as Pack(), without copying
+ * the slot data.
+ */
+void E131PDUTest::testPackIOVec() {
+  uint8_t slot_data[DMX_UNIVERSE_SIZE + 1];
+  for (unsigned int i = 0; i < sizeof(slot_data); i++) {
+    slot_data[i] = static_cast<uint8_t>(i);
+  }
+
+  TwoByteRangeDMPAddress range_addr(0, 1, sizeof(slot_data));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(
+      &range_addr, slot_data, sizeof(slot_data));
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  const DMPPDU *dmp_pdu = NewRangeDMPSetProperty<uint16_t>(true, false,
+                                                           ranged_chunks);
+
+  E131Header header("foo source", 1, 2, 6000);
+  E131PDU e131_pdu(TEST_VECTOR, header, dmp_pdu);
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+
+  RootPDU root_pdu(TEST_VECTOR, CID::Generate(), &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  PreamblePacker packer;
+  unsigned int packed_size;
+  const uint8_t *packed = packer.Pack(root_block, &packed_size);
+  OLA_ASSERT_NOT_NULL(packed);
+
+  IOVecBuilder output;
+  OLA_ASSERT_TRUE(PreamblePacker::PackIOVec(root_block, &output));
+  OLA_ASSERT_EQ(packed_size, output.Size());
+
+  // All the headers are in the first IOVec, then the slot data.
+  OLA_ASSERT_EQ(2u, output.IOVecCount());
+  int io_count;
+  const ola::io::IOVec *iov = output.AsIOVec(&io_count);
+  OLA_ASSERT_EQ(2, io_count);
+  OLA_ASSERT_EQ(static_cast<void*>(slot_data), iov[1].iov_base);
+  OLA_ASSERT_EQ(sizeof(slot_data), iov[1].iov_len);
+  ola::io::IOVecInterface::FreeIOVec(iov);
+
+  uint8_t flattened[IOVecBuilder::SCRATCH_SIZE];
+  unsigned int flattened_size = sizeof(flattened);
+  OLA_ASSERT_TRUE(output.Flatten(flattened, &flattened_size));
+  OLA_ASSERT_DATA_EQUALS(packed, packed_size, flattened, flattened_size);
+
+  // Popping part of the headers leaves the data in place.
+  output.Pop(10);
+  OLA_ASSERT_EQ(packed_size - 10, output.Size());
+  output.Pop(packed_size);
+  OLA_ASSERT_EQ(0u, output.Size());
+  OLA_ASSERT_EQ(0u, output.IOVecCount());
+  delete dmp_pdu;
+}
 }  // namespace acn
 }  // namespace ola
@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.cpp
+ * A pre-built E1.31 data packet for a universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131PDU.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/IOVecBuilder.h"
+#include "libs/acn/RootPDU.h"
+
+namespace ola {
+namespace acn {
+
+using std::string;
+using std::vector;
+
+namespace {
+// flags & length + vector
+const unsigned int ROOT_PREAMBLE_SIZE = 2 + 4;
+const unsigned int E131_PREAMBLE_SIZE = 2 + 4;
+// flags & length, vector, header & a two byte range address.
+const unsigned int DMP_PREAMBLE_SIZE = 2 + 1 + 1;
+const unsigned int DMP_ADDRESS_SIZE = 6;
+// The offset of the address count from the start of the DMP PDU.
+const unsigned int DMP_COUNT_OFFSET = DMP_PREAMBLE_SIZE + 4;
+}  // namespace
+
+E131PacketTemplate::E131PacketTemplate()
+    : m_size(0),
+      m_slot_count(0),
+      m_rev2(false),
+      m_e131_header_size(0) {
+}
+
+
+/*
+ * Build the template by packing a full universe with the regular PDU classes.
+ */
+bool E131PacketTemplate::Init(const CID &cid,
+                              const string &source,
+                              uint16_t universe,
+                              bool use_rev2,
+                              uint16_t sync_address) {
+  m_rev2 = use_rev2;
+  m_e131_header_size = static_cast<unsigned int>(
+      m_rev2 ? sizeof(E131Rev2Header::e131_rev2_pdu_header) :
+               sizeof(E131Header::e131_pdu_header));
+
+  uint8_t slots[DMX_UNIVERSE_SIZE + 1];
+  memset(slots, 0, sizeof(slots));
+  uint16_t property_size = static_cast<uint16_t>(
+      m_rev2 ? DMX_UNIVERSE_SIZE : DMX_UNIVERSE_SIZE + 1);
+
+  TwoByteRangeDMPAddress range_addr(0, 1, property_size);
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, slots,
+                                                     property_size);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  const DMPPDU *dmp_pdu = NewRangeDMPSetProperty<uint16_t>(true, false,
+                                                           ranged_chunks);
+
+  E131Header header(source, 0, 0, universe, false, false, m_rev2,
+                    m_rev2 ? 0 : sync_address);
+  E131PDU e131_pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+
+  RootPDU root_pdu(
+      m_rev2 ? ola::acn::VECTOR_ROOT_E131_REV2 : ola::acn::VECTOR_ROOT_E131,
+      cid, &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  IOVecBuilder output;
+  bool ok = PreamblePacker::PackIOVec(root_block, &output);
+  delete dmp_pdu;
+  if (!ok) {
+    m_size = 0;
+    return false;
+  }
+
+  m_size = sizeof(m_data);
+  if (!output.Flatten(m_data, &m_size)) {
+    m_size = 0;
+    return false;
+  }
+  m_slot_count = DMX_UNIVERSE_SIZE;
+  return true;
+}
+
+
+/*
+ * Patch the template with the data for this frame.
+ */
+void E131PacketTemplate::Update(const DmxBuffer &buffer,
+                                uint8_t sequence,
+                                uint8_t priority,
+                                bool preview) {
+  if (buffer.Size() != m_slot_count) {
+    SetSlotCount(buffer.Size());
+  }
+
+  uint8_t *header = m_data + E131HeaderOffset();
+  if (m_rev2) {
+    header[offsetof(E131Rev2Header::e131_rev2_pdu_header, priority)] =
+        priority;
+    header[offsetof(E131Rev2Header::e131_rev2_pdu_header, sequence)] =
+        sequence;
+  } else {
+    header[offsetof(E131Header::e131_pdu_header, priority)] = priority;
+    header[offsetof(E131Header::e131_pdu_header, sequence)] = sequence;
+    header[offsetof(E131Header::e131_pdu_header, options)] =
+        preview ? E131Header::PREVIEW_DATA_MASK : 0;
+  }
+
+  unsigned int slot_count = m_slot_count;
+  buffer.Get(m_data + SlotOffset(), &slot_count);
+}
+
+
+/*
+ * Update the PDU lengths and the DMP address for a new number of slots.
+ */
+void E131PacketTemplate::SetSlotCount(unsigned int slot_count) {
+  unsigned int property_size = m_rev2 ? slot_count : slot_count + 1;
+  unsigned int dmp_size = DMP_PREAMBLE_SIZE + DMP_ADDRESS_SIZE +
+                          property_size;
+  unsigned int e131_size = E131_PREAMBLE_SIZE + m_e131_header_size +
+                           dmp_size;
+  unsigned int root_size = ROOT_PREAMBLE_SIZE + CID::CID_LENGTH + e131_size;
+
+  SetLength(PreamblePacker::ACN_HEADER_SIZE, root_size);
+  SetLength(E131Offset(), e131_size);
+  SetLength(DMPOffset(), dmp_size);
+
+  uint8_t *count = m_data + DMPOffset() + DMP_COUNT_OFFSET;
+  count[0] = static_cast<uint8_t>(property_size >> 8);
+  count[1] = static_cast<uint8_t>(property_size & 0xff);
+
+  m_size = PreamblePacker::ACN_HEADER_SIZE + root_size;
+  m_slot_count = slot_count;
+}
+
+
+/*
+ * Write the flags & length field of a PDU. E1.31 packets always fit the two
+ * byte format.
+ */
+void E131PacketTemplate::SetLength(unsigned int offset, unsigned int length) {
+  m_data[offset] = static_cast<uint8_t>(
+      PDU::VFLAG_MASK | PDU::HFLAG_MASK | PDU::DFLAG_MASK |
+      ((length >> 8) & 0x0f));
+  m_data[offset + 1] = static_cast<uint8_t>(length & 0xff);
+}
+
+
+unsigned int E131PacketTemplate::E131Offset() const {
+  return PreamblePacker::ACN_HEADER_SIZE + ROOT_PREAMBLE_SIZE +
+    CID::CID_LENGTH;
+}
+
+
+unsigned int E131PacketTemplate::E131HeaderOffset() const {
+  return E131Offset() + E131_PREAMBLE_SIZE;
+}
+
+
+unsigned int E131PacketTemplate::DMPOffset() const {
+  return E131HeaderOffset() + m_e131_header_size;
+}
+
+
+unsigned int E131PacketTemplate::SlotOffset() const {
+  // skip over the start code if there is one
+  return DMPOffset() + DMP_PREAMBLE_SIZE + DMP_ADDRESS_SIZE + (m_rev2 ? 0 : 1);
+}
+}  // namespace acn
+}  // namespace ola
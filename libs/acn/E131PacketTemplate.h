@@ -0,0 +1,83 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.h
+ * A pre-built E1.31 data packet for a universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131PACKETTEMPLATE_H_
+#define LIBS_ACN_E131PACKETTEMPLATE_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/acn/CID.h"
+#include "ola/base/Macro.h"
+#include "libs/acn/PreamblePacker.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * A serialized E1.31 data packet, including the ACN preamble, for a single
+ * universe. The packet is built once, and then only the fields which change
+ * from frame to frame are patched by Update(): the sequence number, the
+ * priority, the options, the slot data and, if the number of slots changes,
+ * the PDU lengths.
+ */
+class E131PacketTemplate {
+ public:
+    E131PacketTemplate();
+    ~E131PacketTemplate() {}
+
+    // Build the packet template. The sequence number, priority and slots are
+    // all 0 until Update() is called.
+    bool Init(const ola::acn::CID &cid,
+              const std::string &source,
+              uint16_t universe,
+              bool use_rev2,
+              uint16_t sync_address = 0);
+
+    // Patch the packet for this frame.
+    void Update(const DmxBuffer &buffer,
+                uint8_t sequence,
+                uint8_t priority,
+                bool preview);
+
+    const uint8_t *Data() const { return m_data; }
+    unsigned int Size() const { return m_size; }
+
+ private:
+    uint8_t m_data[PreamblePacker::MAX_DATAGRAM_SIZE];
+    unsigned int m_size;
+    unsigned int m_slot_count;
+    bool m_rev2;
+    unsigned int m_e131_header_size;
+
+    void SetSlotCount(unsigned int slot_count);
+    void SetLength(unsigned int offset, unsigned int length);
+
+    unsigned int E131Offset() const;
+    unsigned int E131HeaderOffset() const;
+    unsigned int DMPOffset() const;
+    unsigned int SlotOffset() const;
+
+    DISALLOW_COPY_AND_ASSIGN(E131PacketTemplate);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131PACKETTEMPLATE_H_
@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplateTest.cpp
+ * Test fixture for the E131PacketTemplate class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131PDU.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using ola::DmxBuffer;
+using std::string;
+using std::vector;
+
+class E131PacketTemplateTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131PacketTemplateTest);
+  CPPUNIT_TEST(testTemplate);
+  CPPUNIT_TEST(testRev2Template);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() { m_cid = CID::Generate(); }
+    void testTemplate();
+    void testRev2Template();
+
+ private:
+    CID m_cid;
+
+    void CheckFrame(E131PacketTemplate *packet, const string &dmx,
+                    uint8_t sequence, uint8_t priority, bool preview,
+                    bool use_rev2);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131PacketTemplateTest);
+
+const char SOURCE[] = "template test";
+const uint16_t UNIVERSE = 42;
+
+
+/*
+ * Check the template matches the packet built from the PDU classes.
+ */
+void E131PacketTemplateTest::CheckFrame(E131PacketTemplate *packet,
+                                        const string &dmx,
+                                        uint8_t sequence,
+                                        uint8_t priority,
+                                        bool preview,
+                                        bool use_rev2) {
+  DmxBuffer buffer;
+  OLA_ASSERT_TRUE(buffer.SetFromString(dmx));
+  packet->Update(buffer, sequence, priority, preview);
+
+  uint8_t slots[DMX_UNIVERSE_SIZE + 1];
+  slots[0] = 0;
+  unsigned int size = DMX_UNIVERSE_SIZE;
+  buffer.Get(use_rev2 ? slots : slots + 1, &size);
+  uint16_t property_size = static_cast<uint16_t>(use_rev2 ? size : size + 1);
+
+  TwoByteRangeDMPAddress range_addr(0, 1, property_size);
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr, slots,
+                                                     property_size);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  const DMPPDU *dmp_pdu = NewRangeDMPSetProperty<uint16_t>(true, false,
+                                                           ranged_chunks);
+
+  E131Header header(SOURCE, priority, sequence, UNIVERSE, preview, false,
+                    use_rev2);
+  E131PDU e131_pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+  RootPDU root_pdu(
+      use_rev2 ? ola::acn::VECTOR_ROOT_E131_REV2 : ola::acn::VECTOR_ROOT_E131,
+      m_cid, &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  PreamblePacker packer;
+  unsigned int expected_size;
+  const uint8_t *expected = packer.Pack(root_block, &expected_size);
+  OLA_ASSERT_NOT_NULL(expected);
+  OLA_ASSERT_DATA_EQUALS(expected, expected_size, packet->Data(),
+                         packet->Size());
+  delete dmp_pdu;
+}
+
+
+void E131PacketTemplateTest::testTemplate() {
+  E131PacketTemplate packet;
+  OLA_ASSERT_TRUE(packet.Init(m_cid, SOURCE, UNIVERSE, false));
+
+  CheckFrame(&packet, "1,2,3", 0, 100, false, false);
+  CheckFrame(&packet, "4,5,6", 1, 100, false, false);
+  CheckFrame(&packet, "255,0,0,0,128", 2, 200, true, false);
+  CheckFrame(&packet, "", 3, 100, false, false);
+
+  DmxBuffer full;
+  full.Blackout();
+  full.SetChannel(511, 99);
+  CheckFrame(&packet, full.ToString(), 255, 1, false, false);
+  CheckFrame(&packet, "7", 0, 100, false, false);
+}
+
+
+void E131PacketTemplateTest::testRev2Template() {
+  E131PacketTemplate packet;
+  OLA_ASSERT_TRUE(packet.Init(m_cid, SOURCE, UNIVERSE, true));
+
+  CheckFrame(&packet, "1,2,3", 0, 100, false, true);
+  CheckFrame(&packet, "4,5,6,7,8", 1, 150, false, true);
+
+  DmxBuffer full;
+  full.Blackout();
+  CheckFrame(&packet, full.ToString(), 2, 100, false, true);
+}
+}  // namespace acn
+}  // namespace ola
@@ -27,6 +27,7 @@
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
 
@@ -43,7 +44,7 @@ using ola::network::HostToNetwork;
 E131Sender::E131Sender(ola::network::UDPSocket *socket,
                        RootSender *root_sender)
     : m_socket(socket),
-      m_transport_impl(socket, &m_packer),
+      m_transport_impl(socket),
       m_root_sender(root_sender) {
   if (!m_root_sender) {
     OLA_WARN << "root_sender is null, this won't work";
@@ -57,18 +58,29 @@ E131Sender::E131Sender(ola::network::UDPSocket *socket,
  * @param dmp_pdu the DMPPDU to send
  */
 bool E131Sender::SendDMP(const E131Header &header, const DMPPDU *dmp_pdu) {
-  if (!m_root_sender) {
-    return false;
-  }
-
   IPV4Address addr;
   if (!UniverseIP(header.Universe(), &addr)) {
     OLA_INFO << "Could not convert universe " << header.Universe()
              << " to IP.";
     return false;
   }
+  return SendDMP(header, dmp_pdu, addr);
+}
 
-  OutgoingUDPTransport transport(&m_transport_impl, addr);
+
+/*
+ * Send a DMPPDU to a specific address
+ * @param header the E131Header
+ * @param dmp_pdu the DMPPDU to send
+ * @param destination the address to send to, this may be unicast
+ */
+bool E131Sender::SendDMP(const E131Header &header, const DMPPDU *dmp_pdu,
+                         const IPV4Address &destination) {
+  if (!m_root_sender) {
+    return false;
+  }
+
+  OutgoingUDPTransport transport(&m_transport_impl, destination);
 
   E131PDU pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
   unsigned int vector = ola::acn::VECTOR_ROOT_E131;
@@ -100,6 +112,30 @@ bool E131Sender::SendDiscoveryData(const E131Header &header,
 }
 
 
+/*
+ * Send a synchronization packet.
+ * @param sequence the sequence number to use
+ * @param sync_address the universe to send the sync packet on
+ */
+bool E131Sender::SendSync(uint8_t sequence, uint16_t sync_address) {
+  if (!m_root_sender) {
+    return false;
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(sync_address, &addr)) {
+    OLA_INFO << "Could not convert universe " << sync_address << " to IP.";
+    return false;
+  }
+
+  OutgoingUDPTransport transport(&m_transport_impl, addr);
+
+  E131SyncPDU pdu(sequence, sync_address);
+  return m_root_sender->SendPDU(ola::acn::VECTOR_ROOT_E131_EXTENDED, pdu,
+                                &transport);
+}
+
+
 /*
  * Calculate the IP that corresponds to a universe.
  * @param universe the universe id
@@ -41,15 +41,21 @@ class E131Sender {
   ~E131Sender() {}
 
   bool SendDMP(const E131Header &header, const DMPPDU *pdu);
+  bool SendDMP(const E131Header &header, const DMPPDU *pdu,
+               const ola::network::IPV4Address &destination);
   bool SendDiscoveryData(const E131Header &header, const uint8_t *data,
                          unsigned int data_size);
+  bool SendSync(uint8_t sequence, uint16_t sync_address);
+
+  void SetBatcher(ola::network::UDPTransmitBatcher *batcher) {
+    m_transport_impl.SetBatcher(batcher);
+  }
 
   static bool UniverseIP(uint16_t universe,
                          class ola::network::IPV4Address *addr);
 
  private:
   ola::network::UDPSocket *m_socket;
-  PreamblePacker m_packer;
   OutgoingUDPTransportImpl m_transport_impl;
   class RootSender *m_root_sender;
 
@@ -0,0 +1,67 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncInflator.cpp
+ * Handles E1.31 synchronization packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::NetworkToHost;
+
+bool E131SyncInflator::DecodeHeader(HeaderSet *,
+                                    const uint8_t *,
+                                    unsigned int,
+                                    unsigned int *bytes_used) {
+  *bytes_used = 0;
+  return true;
+}
+
+
+/*
+ * Decode the sync packet and run the callback.
+ */
+bool E131SyncInflator::HandlePDUData(uint32_t vector,
+                                     const HeaderSet &headers,
+                                     const uint8_t *data,
+                                     unsigned int pdu_len) {
+  if (vector != ola::acn::VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+    OLA_INFO << "Unknown E1.31 extended vector: " << vector;
+    return true;
+  }
+
+  if (pdu_len < sizeof(E131SyncPDU::sync_pdu_data)) {
+    OLA_WARN << "E1.31 sync packet is too small: " << pdu_len;
+    return false;
+  }
+
+  E131SyncPDU::sync_pdu_data sync_data;
+  memcpy(&sync_data, data, sizeof(sync_data));
+  if (m_sync_callback.get()) {
+    m_sync_callback->Run(headers, sync_data.sequence,
+                         NetworkToHost(sync_data.sync_address));
+  }
+  return true;
+}
+}  // namespace acn
+}  // namespace ola
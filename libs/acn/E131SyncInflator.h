@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncInflator.h
+ * Handles E1.31 synchronization packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131SYNCINFLATOR_H_
+#define LIBS_ACN_E131SYNCINFLATOR_H_
+
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/BaseInflator.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * The inflator for the E1.31 extended framing layer. This only handles
+ * synchronization packets, the callback is run with the sequence number and
+ * the synchronization address.
+ */
+class E131SyncInflator: public BaseInflator {
+ public:
+  typedef ola::Callback3<void, const HeaderSet&, uint8_t, uint16_t>
+      SyncCallback;
+
+  explicit E131SyncInflator(SyncCallback *callback)
+      : BaseInflator(),
+        m_sync_callback(callback) {
+  }
+  ~E131SyncInflator() {}
+
+  uint32_t Id() const { return ola::acn::VECTOR_ROOT_E131_EXTENDED; }
+
+ protected:
+  // The framing layer doesn't have a header.
+  bool DecodeHeader(HeaderSet *headers,
+                    const uint8_t *data,
+                    unsigned int len,
+                    unsigned int *bytes_used);
+
+  void ResetHeaderField() {}
+
+  bool HandlePDUData(uint32_t vector,
+                     const HeaderSet &headers,
+                     const uint8_t *data,
+                     unsigned int pdu_len);
+
+ private:
+  std::auto_ptr<SyncCallback> m_sync_callback;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131SYNCINFLATOR_H_
@@ -0,0 +1,106 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncInflatorTest.cpp
+ * Test fixture for the E131SyncPDU and E131SyncInflator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/testing/TestUtils.h"
+
+
+namespace ola {
+namespace acn {
+
+using ola::acn::CID;
+
+class E131SyncInflatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131SyncInflatorTest);
+  CPPUNIT_TEST(testInflateSync);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    E131SyncInflatorTest()
+        : m_syncs(0),
+          m_sequence(0),
+          m_sync_address(0) {
+    }
+
+    void testInflateSync();
+
+ private:
+    unsigned int m_syncs;
+    uint8_t m_sequence;
+    uint16_t m_sync_address;
+    CID m_cid;
+
+    void NewSync(const HeaderSet &headers, uint8_t sequence,
+                 uint16_t sync_address) {
+      OLA_ASSERT_TRUE(m_cid == headers.GetRootHeader().GetCid());
+      m_sequence = sequence;
+      m_sync_address = sync_address;
+      m_syncs++;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131SyncInflatorTest);
+
+
+/*
+ * Check that a sync packet survives a round trip.
+ */
+void E131SyncInflatorTest::testInflateSync() {
+  E131SyncPDU sync_pdu(12, 7962);
+  OLA_ASSERT_EQ(11u, sync_pdu.Size());
+  PDUBlock<PDU> block;
+  block.AddPDU(&sync_pdu);
+
+  m_cid = CID::Generate();
+  RootPDU pdu(VECTOR_ROOT_E131_EXTENDED, m_cid, &block);
+
+  unsigned int size = pdu.Size();
+  uint8_t *data = new uint8_t[size];
+  unsigned int bytes_used = size;
+  OLA_ASSERT(pdu.Pack(data, &bytes_used));
+  OLA_ASSERT_EQ(size, bytes_used);
+
+  // The sync address follows the sequence number, then 2 reserved bytes.
+  OLA_ASSERT_EQ(static_cast<uint8_t>(7962 >> 8), data[size - 4]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(7962 & 0xff), data[size - 3]);
+
+  E131SyncInflator sync_inflator(
+      NewCallback(this, &E131SyncInflatorTest::NewSync));
+  RootInflator inflator;
+  inflator.AddInflator(&sync_inflator);
+  HeaderSet header_set;
+  OLA_ASSERT(inflator.InflatePDUBlock(&header_set, data, size));
+  delete[] data;
+
+  OLA_ASSERT_EQ(1u, m_syncs);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(12), m_sequence);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(7962), m_sync_address);
+}
+}  // namespace acn
+}  // namespace ola
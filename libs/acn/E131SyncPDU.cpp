@@ -0,0 +1,85 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDU.cpp
+ * The E1.31 synchronization PDU.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131SyncPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::io::OutputStream;
+using ola::network::HostToNetwork;
+
+E131SyncPDU::E131SyncPDU(uint8_t sequence, uint16_t sync_address)
+    : PDU(ola::acn::VECTOR_E131_EXTENDED_SYNCHRONIZATION),
+      m_sequence(sequence),
+      m_sync_address(sync_address) {
+}
+
+
+/*
+ * There is no header.
+ */
+bool E131SyncPDU::PackHeader(uint8_t *, unsigned int *length) const {
+  *length = 0;
+  return true;
+}
+
+
+/*
+ * Pack the sequence number & sync address.
+ */
+bool E131SyncPDU::PackData(uint8_t *data, unsigned int *length) const {
+  if (*length < sizeof(sync_pdu_data)) {
+    OLA_WARN << "E131SyncPDU::PackData: buffer too small, got " << *length
+             << " required " << sizeof(sync_pdu_data);
+    *length = 0;
+    return false;
+  }
+
+  sync_pdu_data sync_data;
+  PopulateData(&sync_data);
+  *length = sizeof(sync_pdu_data);
+  memcpy(data, &sync_data, *length);
+  return true;
+}
+
+
+void E131SyncPDU::PackHeader(OutputStream *) const {
+}
+
+
+void E131SyncPDU::PackData(OutputStream *stream) const {
+  sync_pdu_data sync_data;
+  PopulateData(&sync_data);
+  stream->Write(reinterpret_cast<uint8_t*>(&sync_data), sizeof(sync_data));
+}
+
+
+void E131SyncPDU::PopulateData(sync_pdu_data *data) const {
+  data->sequence = m_sequence;
+  data->sync_address = HostToNetwork(m_sync_address);
+  data->reserved = 0;
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDU.h
+ * The E1.31 synchronization PDU.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131SYNCPDU_H_
+#define LIBS_ACN_E131SYNCPDU_H_
+
+#include <ola/base/Macro.h>
+#include <stdint.h>
+#include "libs/acn/PDU.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * The framing layer of an E1.31 synchronization packet. This PDU has no
+ * header, the sequence number and synchronization address are carried as the
+ * data.
+ */
+class E131SyncPDU: public PDU {
+ public:
+  E131SyncPDU(uint8_t sequence, uint16_t sync_address);
+  ~E131SyncPDU() {}
+
+  unsigned int HeaderSize() const { return 0; }
+  unsigned int DataSize() const { return sizeof(sync_pdu_data); }
+  bool PackHeader(uint8_t *data, unsigned int *length) const;
+  bool PackData(uint8_t *data, unsigned int *length) const;
+
+  void PackHeader(ola::io::OutputStream *stream) const;
+  void PackData(ola::io::OutputStream *stream) const;
+
+  PACK(
+  struct sync_pdu_data_s {
+    uint8_t sequence;
+    uint16_t sync_address;
+    uint16_t reserved;
+  });
+  typedef struct sync_pdu_data_s sync_pdu_data;
+
+ private:
+  const uint8_t m_sequence;
+  const uint16_t m_sync_address;
+
+  void PopulateData(sync_pdu_data *data) const;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131SYNCPDU_H_
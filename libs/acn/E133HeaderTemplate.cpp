@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E133HeaderTemplate.cpp
+ * Pre-built root layer and E1.33 headers for a component.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "ola/acn/ACNVectors.h"
+#include "ola/base/Array.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMPacket.h"
+#include "ola/strings/Utils.h"
+#include "libs/acn/E133HeaderTemplate.h"
+#include "libs/acn/E133PDU.h"
+#include "libs/acn/PDU.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RDMPDU.h"
+#include "libs/acn/RootPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::HostToNetwork;
+using std::string;
+
+E133HeaderTemplate::E133HeaderTemplate(const CID &cid, const string &source)
+    : m_cid(cid),
+      m_source(source) {
+  memset(m_data, 0, sizeof(m_data));
+  // The UDP preamble is copied in by PrependHeaders().
+  memcpy(m_data, PreamblePacker::TCP_ACN_HEADER,
+         PreamblePacker::TCP_ACN_HEADER_SIZE);
+
+  uint8_t *ptr = m_data + PREAMBLE_SIZE + 2;
+  uint32_t root_vector = HostToNetwork(
+      static_cast<uint32_t>(ola::acn::VECTOR_ROOT_E133));
+  memcpy(ptr, &root_vector, sizeof(root_vector));
+  cid.Pack(ptr + sizeof(root_vector));
+
+  E133Header::e133_pdu_header header;
+  memset(&header, 0, sizeof(header));
+  strings::CopyToFixedLengthBuffer(source, header.source,
+                                   arraysize(header.source));
+  memcpy(m_data + PREAMBLE_SIZE + ROOT_HEADER_SIZE + 2 + 4, &header,
+         sizeof(header));
+
+  m_data[HEADER_SIZE - 1] = ola::rdm::START_CODE;
+}
+
+
+void E133HeaderTemplate::Prepend(ola::io::IOStack *stack,
+                                 Preamble preamble,
+                                 uint32_t vector,
+                                 uint32_t sequence_number,
+                                 uint16_t endpoint_id) const {
+  PrependHeaders(stack, preamble, vector, sequence_number, endpoint_id,
+                 false);
+}
+
+
+void E133HeaderTemplate::PrependRDM(ola::io::IOStack *stack,
+                                    Preamble preamble,
+                                    uint32_t sequence_number,
+                                    uint16_t endpoint_id) const {
+  PrependHeaders(stack, preamble, ola::acn::VECTOR_FRAMING_RDMNET,
+                 sequence_number, endpoint_id, true);
+}
+
+
+/*
+ * Copy the template and patch in the lengths & the per message fields.
+ */
+void E133HeaderTemplate::PrependHeaders(ola::io::IOStack *stack,
+                                        Preamble preamble,
+                                        uint32_t vector,
+                                        uint32_t sequence_number,
+                                        uint16_t endpoint_id,
+                                        bool rdm) const {
+  const unsigned int data_size = stack->Size();
+  const unsigned int rdm_size = rdm ? RDM_HEADER_SIZE + data_size : 0;
+  const unsigned int e133_size = E133_HEADER_SIZE +
+                                 (rdm ? rdm_size : data_size);
+  const unsigned int root_size = ROOT_HEADER_SIZE + e133_size;
+  if (root_size > MAX_TWO_BYTE_LENGTH) {
+    // Too large for the two byte lengths in the template.
+    PrependWithPDUs(stack, preamble, vector, sequence_number, endpoint_id,
+                    rdm);
+    return;
+  }
+
+  const unsigned int header_size = rdm ?
+      HEADER_SIZE : HEADER_SIZE - RDM_HEADER_SIZE;
+  uint8_t data[HEADER_SIZE];
+  memcpy(data, m_data, header_size);
+
+  unsigned int offset = PREAMBLE_SIZE;
+  SetLength(data + offset, root_size);
+  offset += ROOT_HEADER_SIZE;
+  SetLength(data + offset, e133_size);
+  vector = HostToNetwork(vector);
+  memcpy(data + offset + 2, &vector, sizeof(vector));
+
+  uint8_t *header = data + offset + 2 + 4;
+  sequence_number = HostToNetwork(sequence_number);
+  memcpy(header + offsetof(E133Header::e133_pdu_header, sequence),
+         &sequence_number, sizeof(sequence_number));
+  endpoint_id = HostToNetwork(endpoint_id);
+  memcpy(header + offsetof(E133Header::e133_pdu_header, endpoint),
+         &endpoint_id, sizeof(endpoint_id));
+
+  if (rdm) {
+    SetLength(data + HEADER_SIZE - RDM_HEADER_SIZE, rdm_size);
+  }
+
+  offset = PREAMBLE_SIZE - PreamblePacker::ACN_HEADER_SIZE;
+  if (preamble == TCP_PREAMBLE) {
+    uint32_t length = HostToNetwork(static_cast<uint32_t>(root_size));
+    memcpy(data + PREAMBLE_SIZE - sizeof(length), &length, sizeof(length));
+    offset -= static_cast<unsigned int>(sizeof(length));
+  } else {
+    memcpy(data + offset, PreamblePacker::ACN_HEADER,
+           PreamblePacker::ACN_HEADER_SIZE);
+  }
+  stack->Write(data + offset, header_size - offset);
+}
+
+
+/*
+ * The slow path, for messages that need three byte lengths.
+ */
+void E133HeaderTemplate::PrependWithPDUs(ola::io::IOStack *stack,
+                                         Preamble preamble,
+                                         uint32_t vector,
+                                         uint32_t sequence_number,
+                                         uint16_t endpoint_id,
+                                         bool rdm) const {
+  if (rdm) {
+    RDMPDU::PrependPDU(stack);
+  }
+  E133PDU::PrependPDU(stack, vector, m_source, sequence_number, endpoint_id);
+  RootPDU::PrependPDU(stack, ola::acn::VECTOR_ROOT_E133, m_cid);
+  if (preamble == TCP_PREAMBLE) {
+    PreamblePacker::AddTCPPreamble(stack);
+  } else {
+    PreamblePacker::AddUDPPreamble(stack);
+  }
+}
+
+
+/*
+ * Write the two byte flags & length field of a PDU.
+ */
+void E133HeaderTemplate::SetLength(uint8_t *data, unsigned int length) {
+  data[0] = static_cast<uint8_t>(
+      PDU::VFLAG_MASK | PDU::HFLAG_MASK | PDU::DFLAG_MASK |
+      ((length >> 8) & 0x0f));
+  data[1] = static_cast<uint8_t>(length & 0xff);
+}
+}  // namespace acn
+}  // namespace ola
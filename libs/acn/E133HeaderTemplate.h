@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E133HeaderTemplate.h
+ * Pre-built root layer and E1.33 headers for a component.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E133HEADERTEMPLATE_H_
+#define LIBS_ACN_E133HEADERTEMPLATE_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "ola/acn/CID.h"
+#include "ola/base/Macro.h"
+#include "ola/io/IOStack.h"
+#include "libs/acn/E133Header.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * The ACN preamble, root layer PDU and E1.33 PDU headers, and optionally the
+ * RDM PDU header, for messages sent by one component. The CID and source name
+ * are serialized once, and Prepend() patches in the fields which change from
+ * message to message: the PDU lengths, the E1.33 vector, the sequence number
+ * and the endpoint. The headers are then added to the front of the message
+ * with a single write.
+ *
+ * This produces the same bytes as RootPDU::PrependPDU() and
+ * E133PDU::PrependPDU().
+ */
+class E133HeaderTemplate {
+ public:
+    enum Preamble {
+      TCP_PREAMBLE,
+      UDP_PREAMBLE
+    };
+
+    E133HeaderTemplate(const ola::acn::CID &cid, const std::string &source);
+    ~E133HeaderTemplate() {}
+
+    // Prepend the headers for an E1.33 PDU to the data on the stack.
+    void Prepend(ola::io::IOStack *stack,
+                 Preamble preamble,
+                 uint32_t vector,
+                 uint32_t sequence_number,
+                 uint16_t endpoint_id) const;
+
+    // Prepend the headers for an RDM PDU, the data on the stack should be a
+    // RDM message without the start code.
+    void PrependRDM(ola::io::IOStack *stack,
+                    Preamble preamble,
+                    uint32_t sequence_number,
+                    uint16_t endpoint_id) const;
+
+ private:
+    enum {
+      // The TCP preamble is 16 bytes plus a 4 byte length, the UDP preamble
+      // is 16 bytes and ends at the same offset.
+      PREAMBLE_SIZE = 20,
+      // flags & length, vector & CID
+      ROOT_HEADER_SIZE = 2 + 4 + CID::CID_LENGTH,
+      // flags & length, vector & the E1.33 header
+      E133_HEADER_SIZE = 2 + 4 + sizeof(E133Header::e133_pdu_header),
+      // flags & length & the start code
+      RDM_HEADER_SIZE = 2 + 1,
+      HEADER_SIZE = PREAMBLE_SIZE + ROOT_HEADER_SIZE + E133_HEADER_SIZE +
+                    RDM_HEADER_SIZE,
+      // The largest PDU the template's two byte lengths can describe.
+      MAX_TWO_BYTE_LENGTH = 0x0fff
+    };
+
+    const ola::acn::CID m_cid;
+    const std::string m_source;
+    uint8_t m_data[HEADER_SIZE];
+
+    void PrependHeaders(ola::io::IOStack *stack,
+                        Preamble preamble,
+                        uint32_t vector,
+                        uint32_t sequence_number,
+                        uint16_t endpoint_id,
+                        bool rdm) const;
+    void PrependWithPDUs(ola::io::IOStack *stack,
+                         Preamble preamble,
+                         uint32_t vector,
+                         uint32_t sequence_number,
+                         uint16_t endpoint_id,
+                         bool rdm) const;
+    static void SetLength(uint8_t *data, unsigned int length);
+
+    DISALLOW_COPY_AND_ASSIGN(E133HeaderTemplate);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E133HEADERTEMPLATE_H_
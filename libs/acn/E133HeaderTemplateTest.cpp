@@ -0,0 +1,188 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E133HeaderTemplateTest.cpp
+ * Test fixture for the E133HeaderTemplate class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "ola/io/ByteString.h"
+#include "ola/io/IOStack.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "libs/acn/E133HeaderTemplate.h"
+#include "libs/acn/E133PDU.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RDMPDU.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using ola::io::ByteString;
+using ola::io::IOStack;
+using ola::io::MemoryBlockPool;
+using std::string;
+
+class E133HeaderTemplateTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E133HeaderTemplateTest);
+  CPPUNIT_TEST(testPrepend);
+  CPPUNIT_TEST(testPrependRDM);
+  CPPUNIT_TEST(testLargeMessage);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() { m_cid = CID::Generate(); }
+    void testPrepend();
+    void testPrependRDM();
+    void testLargeMessage();
+
+ private:
+    CID m_cid;
+    MemoryBlockPool m_pool;
+
+    void CheckMessage(const E133HeaderTemplate &header_template,
+                      E133HeaderTemplate::Preamble preamble,
+                      const ByteString &payload,
+                      bool rdm);
+    void Fill(IOStack *stack, const ByteString &payload);
+    void Flatten(IOStack *stack, ByteString *output);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E133HeaderTemplateTest);
+
+const char SOURCE[] = "template test";
+const uint32_t SEQUENCE_NUMBER = 0x01020304;
+const uint16_t ENDPOINT = 0x0506;
+
+
+void E133HeaderTemplateTest::Fill(IOStack *stack, const ByteString &payload) {
+  stack->Write(payload.data(), payload.size());
+}
+
+
+void E133HeaderTemplateTest::Flatten(IOStack *stack, ByteString *output) {
+  uint8_t data[256];
+  while (!stack->Empty()) {
+    unsigned int length = stack->Read(data, sizeof(data));
+    output->append(data, length);
+  }
+}
+
+
+/*
+ * Check the template produces the same bytes as the PDU classes.
+ */
+void E133HeaderTemplateTest::CheckMessage(
+    const E133HeaderTemplate &header_template,
+    E133HeaderTemplate::Preamble preamble,
+    const ByteString &payload,
+    bool rdm) {
+  const uint32_t vector = rdm ? ola::acn::VECTOR_FRAMING_RDMNET :
+                                ola::acn::VECTOR_FRAMING_STATUS;
+
+  IOStack expected_stack(&m_pool);
+  Fill(&expected_stack, payload);
+  if (rdm) {
+    RDMPDU::PrependPDU(&expected_stack);
+  }
+  E133PDU::PrependPDU(&expected_stack, vector, SOURCE, SEQUENCE_NUMBER,
+                      ENDPOINT);
+  RootPDU::PrependPDU(&expected_stack, ola::acn::VECTOR_ROOT_E133, m_cid);
+  if (preamble == E133HeaderTemplate::TCP_PREAMBLE) {
+    PreamblePacker::AddTCPPreamble(&expected_stack);
+  } else {
+    PreamblePacker::AddUDPPreamble(&expected_stack);
+  }
+
+  IOStack stack(&m_pool);
+  Fill(&stack, payload);
+  if (rdm) {
+    header_template.PrependRDM(&stack, preamble, SEQUENCE_NUMBER, ENDPOINT);
+  } else {
+    header_template.Prepend(&stack, preamble, vector, SEQUENCE_NUMBER,
+                            ENDPOINT);
+  }
+
+  ByteString expected, actual;
+  Flatten(&expected_stack, &expected);
+  Flatten(&stack, &actual);
+  OLA_ASSERT_DATA_EQUALS(expected.data(), expected.size(),
+                         actual.data(), actual.size());
+}
+
+
+/*
+ * Check the headers for non-RDM messages.
+ */
+void E133HeaderTemplateTest::testPrepend() {
+  E133HeaderTemplate header_template(m_cid, SOURCE);
+  const uint8_t status[] = {0, 0, 'o', 'k'};
+  ByteString payload(status, sizeof(status));
+
+  CheckMessage(header_template, E133HeaderTemplate::TCP_PREAMBLE, payload,
+               false);
+  CheckMessage(header_template, E133HeaderTemplate::UDP_PREAMBLE, payload,
+               false);
+  CheckMessage(header_template, E133HeaderTemplate::TCP_PREAMBLE,
+               ByteString(), false);
+}
+
+
+/*
+ * Check the headers for RDM messages.
+ */
+void E133HeaderTemplateTest::testPrependRDM() {
+  E133HeaderTemplate header_template(m_cid, SOURCE);
+  ByteString payload;
+  for (unsigned int i = 0; i < 256; i++) {
+    payload.push_back(static_cast<uint8_t>(i));
+    if (i % 51 == 0) {
+      CheckMessage(header_template, E133HeaderTemplate::TCP_PREAMBLE,
+                   payload, true);
+      CheckMessage(header_template, E133HeaderTemplate::UDP_PREAMBLE,
+                   payload, true);
+    }
+  }
+}
+
+
+/*
+ * Check messages that need three byte PDU lengths.
+ */
+void E133HeaderTemplateTest::testLargeMessage() {
+  E133HeaderTemplate header_template(m_cid, SOURCE);
+  // Either side of the largest root PDU with a two byte length.
+  for (unsigned int size = 3994; size < 4000; size++) {
+    ByteString payload(size, 0x5a);
+    CheckMessage(header_template, E133HeaderTemplate::TCP_PREAMBLE, payload,
+                 false);
+    CheckMessage(header_template, E133HeaderTemplate::UDP_PREAMBLE, payload,
+                 true);
+  }
+
+  ByteString payload(5000, 0x5a);
+  CheckMessage(header_template, E133HeaderTemplate::TCP_PREAMBLE, payload,
+               false);
+  CheckMessage(header_template, E133HeaderTemplate::UDP_PREAMBLE, payload,
+               true);
+}
+}  // namespace acn
+}  // namespace ola
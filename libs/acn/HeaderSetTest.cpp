@@ -19,9 +19,11 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
 #include <string>
 #include <iostream>
 
+#include "ola/Clock.h"
 #include "ola/acn/CID.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/network/NetworkUtils.h"
@@ -41,6 +43,7 @@ using ola::acn::ONE_BYTES;
 using ola::acn::RANGE_EQUAL;
 using ola::acn::RootHeader;
 using ola::acn::TransportHeader;
+using std::string;
 
 class HeaderSetTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(HeaderSetTest);
@@ -81,6 +84,16 @@ void HeaderSetTest::testTransportHeader() {
   TransportHeader header3(header);
   OLA_ASSERT(address == header3.Source());
   OLA_ASSERT(header3 == header);
+  OLA_ASSERT_FALSE(header.Arrival().IsSet());
+
+  // the arrival time is optional
+  ola::TimeStamp arrival;
+  ola::Clock().CurrentTime(&arrival);
+  TransportHeader header4(address, TransportHeader::UDP, arrival);
+  OLA_ASSERT_EQ(arrival, header4.Arrival());
+  OLA_ASSERT_FALSE(header4 == header);
+  header3 = header4;
+  OLA_ASSERT(header3 == header4);
 }
 
 
@@ -100,6 +113,20 @@ void HeaderSetTest::testRootHeader() {
   RootHeader header3(header);
   OLA_ASSERT(cid == header3.GetCid());
   OLA_ASSERT(header3 == header);
+
+  // test the packed form
+  uint8_t packed_cid[CID::CID_LENGTH];
+  cid.Pack(packed_cid);
+  OLA_ASSERT_DATA_EQUALS(packed_cid, sizeof(packed_cid), header.CidData(),
+                         CID::CID_LENGTH);
+  OLA_ASSERT_FALSE(header.CidIsNil());
+  RootHeader header4;
+  OLA_ASSERT(header4.CidIsNil());
+  header4.SetCidData(packed_cid);
+  OLA_ASSERT(header4 == header);
+  header4.ResetCid();
+  OLA_ASSERT(header4.CidIsNil());
+  OLA_ASSERT(header4.GetCid().IsNil());
 }
 
 
@@ -154,6 +181,14 @@ void HeaderSetTest::testE131Header() {
   OLA_ASSERT_EQ(true, header4.PreviewData());
   OLA_ASSERT_EQ(true, header4.StreamTerminated());
   OLA_ASSERT_FALSE(header4.UsingRev2());
+
+  // names longer than the field are truncated
+  const string long_name(E131Header::SOURCE_NAME_LEN + 10, 'x');
+  E131Header header5(long_name, 1, 2, 2050);
+  OLA_ASSERT_EQ(long_name.substr(0, E131Header::SOURCE_NAME_LEN),
+                header5.Source());
+  OLA_ASSERT_EQ(static_cast<size_t>(E131Header::SOURCE_NAME_LEN),
+                strlen(header5.SourceName()));
 }
 
 
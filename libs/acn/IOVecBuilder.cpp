@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IOVecBuilder.cpp
+ * Builds a list of IOVecs for a datagram, without copying the data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+
+#include "libs/acn/IOVecBuilder.h"
+
+namespace ola {
+namespace acn {
+
+using ola::io::IOVec;
+using std::vector;
+
+void IOVecBuilder::Clear() {
+  m_iovecs.clear();
+  m_scratch_used = 0;
+  m_size = 0;
+}
+
+
+/*
+ * Reserve scratch space.
+ * @param length the number of bytes required.
+ * @returns a pointer to the space, or NULL if there isn't enough left.
+ */
+uint8_t *IOVecBuilder::Reserve(unsigned int length) {
+  if (length > SCRATCH_SIZE - m_scratch_used)
+    return NULL;
+
+  uint8_t *ptr = m_scratch + m_scratch_used;
+  if (!m_iovecs.empty() &&
+      static_cast<uint8_t*>(m_iovecs.back().iov_base) +
+        m_iovecs.back().iov_len == ptr) {
+    m_iovecs.back().iov_len += length;
+  } else {
+    IOVec iov = {ptr, length};
+    m_iovecs.push_back(iov);
+  }
+  m_scratch_used += length;
+  m_size += length;
+  return ptr;
+}
+
+
+/*
+ * Return unused bytes from the last call to Reserve().
+ */
+void IOVecBuilder::Unreserve(unsigned int length) {
+  if (m_iovecs.empty() || !length)
+    return;
+
+  length = std::min(length, static_cast<unsigned int>(
+      m_iovecs.back().iov_len));
+  m_iovecs.back().iov_len -= length;
+  m_scratch_used -= length;
+  m_size -= length;
+  if (!m_iovecs.back().iov_len)
+    m_iovecs.pop_back();
+}
+
+
+void IOVecBuilder::AddData(const uint8_t *data, unsigned int length) {
+  if (!length)
+    return;
+  IOVec iov = {const_cast<uint8_t*>(data), length};
+  m_iovecs.push_back(iov);
+  m_size += length;
+}
+
+
+/*
+ * Copy the data into a contiguous buffer.
+ * @param data the buffer to copy to.
+ * @param length the size of the buffer, updated with the number of bytes
+ *   copied.
+ */
+bool IOVecBuilder::Flatten(uint8_t *data, unsigned int *length) const {
+  if (*length < m_size) {
+    *length = 0;
+    return false;
+  }
+
+  unsigned int offset = 0;
+  vector<IOVec>::const_iterator iter = m_iovecs.begin();
+  for (; iter != m_iovecs.end(); ++iter) {
+    memcpy(data + offset, iter->iov_base, iter->iov_len);
+    offset += static_cast<unsigned int>(iter->iov_len);
+  }
+  *length = offset;
+  return true;
+}
+
+
+const IOVec *IOVecBuilder::AsIOVec(int *io_count) const {
+  *io_count = static_cast<int>(m_iovecs.size());
+  if (m_iovecs.empty())
+    return NULL;
+
+  // The caller frees this with FreeIOVec()
+  IOVec *iov = new IOVec[m_iovecs.size()];
+  std::copy(m_iovecs.begin(), m_iovecs.end(), iov);
+  return iov;
+}
+
+
+/*
+ * Remove bytes from the front.
+ */
+void IOVecBuilder::Pop(unsigned int bytes) {
+  if (bytes >= m_size) {
+    Clear();
+    return;
+  }
+
+  m_size -= bytes;
+  vector<IOVec>::iterator iter = m_iovecs.begin();
+  while (bytes) {
+    if (bytes >= iter->iov_len) {
+      bytes -= static_cast<unsigned int>(iter->iov_len);
+      ++iter;
+    } else {
+      iter->iov_base = static_cast<uint8_t*>(iter->iov_base) + bytes;
+      iter->iov_len -= bytes;
+      bytes = 0;
+    }
+  }
+  m_iovecs.erase(m_iovecs.begin(), iter);
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IOVecBuilder.h
+ * Builds a list of IOVecs for a datagram, without copying the data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_IOVECBUILDER_H_
+#define LIBS_ACN_IOVECBUILDER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/io/IOVecInterface.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * Holds a datagram as a list of IOVecs. Headers are packed into scratch space
+ * owned by this object, while data is referenced in place, so the caller must
+ * keep the data alive until the datagram is sent.
+ *
+ * Consecutive reservations of scratch space are merged into a single IOVec.
+ */
+class IOVecBuilder: public ola::io::IOVecInterface {
+ public:
+    IOVecBuilder() : m_scratch_used(0), m_size(0) {}
+    ~IOVecBuilder() {}
+
+    // Remove everything
+    void Clear();
+
+    // Reserve length bytes of scratch space, returns NULL if there isn't
+    // enough left.
+    uint8_t *Reserve(unsigned int length);
+
+    // Give back the last length bytes of the previous reservation.
+    void Unreserve(unsigned int length);
+
+    // Reference data, this isn't copied.
+    void AddData(const uint8_t *data, unsigned int length);
+
+    // The total number of bytes.
+    unsigned int Size() const { return m_size; }
+
+    // The number of IOVecs.
+    unsigned int IOVecCount() const {
+      return static_cast<unsigned int>(m_iovecs.size());
+    }
+
+    // Copy everything into a buffer, returns false if it's too small.
+    bool Flatten(uint8_t *data, unsigned int *length) const;
+
+    const struct ola::io::IOVec *AsIOVec(int *io_count) const;
+    void Pop(unsigned int bytes);
+
+    static const unsigned int SCRATCH_SIZE = 1472;
+
+ private:
+    uint8_t m_scratch[SCRATCH_SIZE];
+    unsigned int m_scratch_used;
+    unsigned int m_size;
+    std::vector<ola::io::IOVec> m_iovecs;
+
+    DISALLOW_COPY_AND_ASSIGN(IOVecBuilder);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_IOVECBUILDER_H_
@@ -47,11 +47,19 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E131Inflator.h \
     libs/acn/E131Node.cpp \
     libs/acn/E131Node.h \
+    libs/acn/E131PacketTemplate.cpp \
+    libs/acn/E131PacketTemplate.h \
     libs/acn/E131PDU.cpp \
     libs/acn/E131PDU.h \
     libs/acn/E131Sender.cpp \
     libs/acn/E131Sender.h \
+    libs/acn/E131SyncInflator.cpp \
+    libs/acn/E131SyncInflator.h \
+    libs/acn/E131SyncPDU.cpp \
+    libs/acn/E131SyncPDU.h \
     libs/acn/E133Header.h \
+    libs/acn/E133HeaderTemplate.cpp \
+    libs/acn/E133HeaderTemplate.h \
     libs/acn/E133Inflator.cpp \
     libs/acn/E133Inflator.h \
     libs/acn/E133PDU.cpp \
@@ -61,6 +69,10 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E133StatusPDU.cpp \
     libs/acn/E133StatusPDU.h \
     libs/acn/HeaderSet.h \
+    libs/acn/IOVecBuilder.cpp \
+    libs/acn/IOVecBuilder.h \
+    libs/acn/MulticastMembershipManager.cpp \
+    libs/acn/MulticastMembershipManager.h \
     libs/acn/PDU.cpp \
     libs/acn/PDU.h \
     libs/acn/PDUTestCommon.h \
@@ -114,10 +126,13 @@ libs_acn_E131Tester_SOURCES = \
     libs/acn/BaseInflatorTest.cpp \
     libs/acn/CIDTest.cpp \
     libs/acn/DMPAddressTest.cpp \
+    libs/acn/DMPE131InflatorTest.cpp \
     libs/acn/DMPInflatorTest.cpp \
     libs/acn/DMPPDUTest.cpp \
     libs/acn/E131InflatorTest.cpp \
     libs/acn/E131PDUTest.cpp \
+    libs/acn/E131PacketTemplateTest.cpp \
+    libs/acn/E131SyncInflatorTest.cpp \
     libs/acn/HeaderSetTest.cpp \
     libs/acn/PDUTest.cpp \
     libs/acn/RootInflatorTest.cpp \
@@ -132,6 +147,7 @@ libs_acn_E131Tester_LDADD = \
     $(COMMON_TESTING_LIBS)
 
 libs_acn_E133Tester_SOURCES = \
+    libs/acn/E133HeaderTemplateTest.cpp \
     libs/acn/E133InflatorTest.cpp \
     libs/acn/E133PDUTest.cpp \
     libs/acn/RDMPDUTest.cpp
@@ -141,6 +157,7 @@ libs_acn_E133Tester_LDADD = \
     $(COMMON_TESTING_LIBS)
 
 libs_acn_TransportTester_SOURCES = \
+    libs/acn/MulticastMembershipManagerTest.cpp \
     libs/acn/TCPTransportTest.cpp \
     libs/acn/UDPTransportTest.cpp
 libs_acn_TransportTester_CPPFLAGS = $(COMMON_TESTING_FLAGS)
@@ -0,0 +1,256 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MulticastMembershipManager.cpp
+ * Manages the multicast groups joined by a node.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/InlineCallback.h"
+#include "ola/Logging.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "libs/acn/MulticastMembershipManager.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPSocket;
+using std::auto_ptr;
+
+const char MulticastMembershipManager::GROUPS_VAR[] = "multicast-groups";
+const char MulticastMembershipManager::SOCKETS_VAR[] = "multicast-sockets";
+const char MulticastMembershipManager::JOIN_FAILURES_VAR[] =
+    "multicast-join-failures";
+const char MulticastMembershipManager::NODE_KEY[] = "node";
+
+MulticastMembershipManager::MulticastMembershipManager(
+    ola::thread::SchedulerInterface *scheduler,
+    ola::io::SelectServerInterface *select_server,
+    UDPSocket *socket,
+    const IPV4Address &iface,
+    uint16_t port,
+    BaseInflator *inflator,
+    const Options &options)
+    : m_scheduler(scheduler),
+      m_select_server(select_server),
+      m_interface(iface),
+      m_port(port),
+      m_inflator(inflator),
+      m_options(options),
+      m_join_failures(0),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT),
+      m_groups_var(NULL),
+      m_sockets_var(NULL),
+      m_join_failures_var(NULL) {
+  MemberSocket member = {socket, NULL, 0, false};
+  m_sockets.push_back(member);
+
+  if (m_options.export_map) {
+    m_groups_var = m_options.export_map->GetUIntMapVar(GROUPS_VAR, NODE_KEY);
+    m_sockets_var = m_options.export_map->GetUIntMapVar(SOCKETS_VAR,
+                                                        NODE_KEY);
+    m_join_failures_var = m_options.export_map->GetUIntMapVar(
+        JOIN_FAILURES_VAR, NODE_KEY);
+  }
+  UpdateStats();
+}
+
+MulticastMembershipManager::~MulticastMembershipManager() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+  }
+
+  // The node's socket outlives us, so leave its groups. The groups on the
+  // extra sockets are left when they're closed.
+  GroupMap::const_iterator iter = m_groups.begin();
+  for (; iter != m_groups.end(); ++iter) {
+    if (iter->second == 0) {
+      m_sockets[0].socket->LeaveMulticast(m_interface, iter->first);
+    }
+  }
+  m_groups.clear();
+
+  for (unsigned int i = 1; i < m_sockets.size(); i++) {
+    m_select_server->RemoveReadDescriptor(m_sockets[i].socket);
+    m_sockets[i].socket->Close();
+    delete m_sockets[i].socket;
+    delete m_sockets[i].transport;
+  }
+  m_sockets.resize(1);
+  UpdateStats();
+}
+
+void MulticastMembershipManager::Join(const IPV4Address &group) {
+  QueueChange(group, true);
+}
+
+void MulticastMembershipManager::Leave(const IPV4Address &group) {
+  QueueChange(group, false);
+}
+
+void MulticastMembershipManager::Flush() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  // Leaves are applied first, so they free up space for the joins.
+  PendingChanges::const_iterator iter = m_pending.begin();
+  for (; iter != m_pending.end(); ++iter) {
+    if (!iter->second) {
+      LeaveGroup(iter->first);
+    }
+  }
+  for (iter = m_pending.begin(); iter != m_pending.end(); ++iter) {
+    if (iter->second) {
+      JoinGroup(iter->first);
+    }
+  }
+  m_pending.clear();
+  UpdateStats();
+}
+
+bool MulticastMembershipManager::IsMember(const IPV4Address &group) const {
+  return STLContains(m_groups, group);
+}
+
+void MulticastMembershipManager::QueueChange(const IPV4Address &group,
+                                             bool join) {
+  // The last request for a group wins.
+  m_pending[group] = join;
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        TimeInterval(0, 0),
+        MakeInlineCallback(this,
+                           &MulticastMembershipManager::ScheduledFlush));
+  }
+}
+
+void MulticastMembershipManager::ScheduledFlush() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  Flush();
+}
+
+void MulticastMembershipManager::JoinGroup(const IPV4Address &group) {
+  if (STLContains(m_groups, group)) {
+    return;
+  }
+
+  for (unsigned int i = 0; i <= m_sockets.size(); i++) {
+    if (i == m_sockets.size() && !AddSocket()) {
+      break;
+    }
+
+    MemberSocket &member = m_sockets[i];
+    if (member.full ||
+        member.group_count >= m_options.max_groups_per_socket) {
+      continue;
+    }
+
+    if (member.socket->JoinMulticast(m_interface, group)) {
+      member.group_count++;
+      m_groups[group] = i;
+      return;
+    }
+
+    // If a socket with no groups can't join, another socket won't help.
+    if (member.group_count == 0) {
+      break;
+    }
+    member.full = true;
+  }
+
+  m_join_failures++;
+  OLA_WARN << "Unable to join multicast group " << group << " on "
+           << m_interface << ", " << m_groups.size() << " groups joined";
+}
+
+void MulticastMembershipManager::LeaveGroup(const IPV4Address &group) {
+  GroupMap::iterator iter = m_groups.find(group);
+  if (iter == m_groups.end()) {
+    return;
+  }
+
+  MemberSocket &member = m_sockets[iter->second];
+  member.socket->LeaveMulticast(m_interface, group);
+  member.group_count--;
+  member.full = false;
+  m_groups.erase(iter);
+}
+
+/*
+ * Open another socket, bound to the same port as the node's socket.
+ */
+bool MulticastMembershipManager::AddSocket() {
+  if (!m_select_server) {
+    return false;
+  }
+
+  auto_ptr<UDPSocket> socket(new UDPSocket());
+  if (!socket->Init()) {
+    return false;
+  }
+
+  if (!socket->Bind(IPV4SocketAddress(IPV4Address::WildCard(), m_port))) {
+    socket->Close();
+    return false;
+  }
+
+  // Otherwise each socket would receive the data for every group.
+  socket->SetMulticastAll(false);
+  if (m_sockets.size() == 1) {
+    m_sockets[0].socket->SetMulticastAll(false);
+  }
+  if (m_options.receive_buffer_size) {
+    socket->SetReceiveBufferSize(m_options.receive_buffer_size);
+  }
+  socket->EnableDropCounting();
+  socket->EnableReceiveTimestamps();
+
+  MemberSocket member = {
+    socket.release(),
+    NULL,
+    0,
+    false
+  };
+  member.transport = new IncomingUDPTransport(member.socket, m_inflator);
+  member.transport->ExportDrops(
+      m_options.export_map,
+      m_options.name + ":" +
+      strings::IntToString(static_cast<unsigned int>(m_sockets.size())));
+  member.socket->SetOnData(
+      NewCallback(member.transport, &IncomingUDPTransport::Receive));
+  m_select_server->AddReadDescriptor(member.socket);
+  m_sockets.push_back(member);
+  OLA_INFO << "Opened multicast socket " << m_sockets.size() << " for "
+           << m_interface;
+  return true;
+}
+
+void MulticastMembershipManager::UpdateStats() {
+  if (m_groups_var) {
+    (*m_groups_var)[m_options.name] = GroupCount();
+    (*m_sockets_var)[m_options.name] = SocketCount();
+    (*m_join_failures_var)[m_options.name] = m_join_failures;
+  }
+}
+}  // namespace acn
+}  // namespace ola
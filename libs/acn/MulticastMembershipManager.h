@@ -0,0 +1,193 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MulticastMembershipManager.h
+ * Manages the multicast groups joined by a node, spreading them over more
+ * than one socket if required.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_MULTICASTMEMBERSHIPMANAGER_H_
+#define LIBS_ACN_MULTICASTMEMBERSHIPMANAGER_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Socket.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "libs/acn/UDPTransport.h"
+
+namespace ola {
+namespace acn {
+
+/**
+ * @brief Joins and leaves multicast groups on behalf of a node.
+ *
+ * The kernel limits the number of groups a single socket can join (on Linux
+ * this is net.ipv4.igmp_max_memberships, which defaults to 20). Once the
+ * node's socket is full, extra sockets bound to the same port are opened and
+ * the remaining groups are joined on those. Data received on the extra
+ * sockets is passed to the same inflator as the node's socket.
+ *
+ * Join() and Leave() requests are queued and applied at the end of the
+ * current event loop iteration, so a large number of universes can be set up
+ * in one go.
+ */
+class MulticastMembershipManager {
+ public:
+  struct Options {
+   public:
+    Options()
+        : max_groups_per_socket(DEFAULT_MAX_GROUPS_PER_SOCKET),
+          receive_buffer_size(0),
+          export_map(NULL) {
+    }
+
+    /** The number of groups to join on each socket */
+    unsigned int max_groups_per_socket;
+    /** The kernel receive buffer size for the extra sockets, 0 for default */
+    unsigned int receive_buffer_size;
+    /**
+     * The ExportMap for the membership stats and the extra sockets' kernel
+     * drops, may be NULL
+     */
+    ola::ExportMap *export_map;
+    /** The key used for the stats */
+    std::string name;
+  };
+
+  /**
+   * @brief Create a new MulticastMembershipManager.
+   * @param scheduler the SchedulerInterface used to apply the queued changes.
+   * @param select_server the SelectServerInterface to register the extra
+   *   sockets with, or NULL to only use the existing socket.
+   * @param socket the socket to join the groups on first, ownership is not
+   *   transferred. It must already be bound.
+   * @param iface the address of the interface to join the groups on.
+   * @param port the port the socket is bound to.
+   * @param inflator the inflator to pass the data from the extra sockets to.
+   * @param options the Options to use.
+   */
+  MulticastMembershipManager(ola::thread::SchedulerInterface *scheduler,
+                             ola::io::SelectServerInterface *select_server,
+                             ola::network::UDPSocket *socket,
+                             const ola::network::IPV4Address &iface,
+                             uint16_t port,
+                             class BaseInflator *inflator,
+                             const Options &options);
+
+  /**
+   * @brief Destructor.
+   *
+   * This leaves all the groups and closes the extra sockets.
+   */
+  ~MulticastMembershipManager();
+
+  /**
+   * @brief Queue a join for a multicast group.
+   */
+  void Join(const ola::network::IPV4Address &group);
+
+  /**
+   * @brief Queue a leave for a multicast group.
+   */
+  void Leave(const ola::network::IPV4Address &group);
+
+  /**
+   * @brief Apply any queued joins and leaves now.
+   */
+  void Flush();
+
+  /**
+   * @brief Check if a group has been joined.
+   *
+   * This doesn't include any queued joins.
+   */
+  bool IsMember(const ola::network::IPV4Address &group) const;
+
+  /**
+   * @brief The number of groups joined.
+   */
+  unsigned int GroupCount() const {
+    return static_cast<unsigned int>(m_groups.size());
+  }
+
+  /**
+   * @brief The number of sockets in use, including the node's socket.
+   */
+  unsigned int SocketCount() const {
+    return static_cast<unsigned int>(m_sockets.size());
+  }
+
+  /**
+   * @brief The number of joins that failed.
+   */
+  unsigned int JoinFailures() const { return m_join_failures; }
+
+  static const unsigned int DEFAULT_MAX_GROUPS_PER_SOCKET = 20;
+
+  static const char GROUPS_VAR[];
+  static const char SOCKETS_VAR[];
+  static const char JOIN_FAILURES_VAR[];
+
+ private:
+  struct MemberSocket {
+    ola::network::UDPSocket *socket;
+    // NULL for the node's socket.
+    IncomingUDPTransport *transport;
+    unsigned int group_count;
+    // Set once a join has been refused.
+    bool full;
+  };
+
+  typedef std::map<ola::network::IPV4Address, bool> PendingChanges;
+  typedef std::map<ola::network::IPV4Address, unsigned int> GroupMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::io::SelectServerInterface *m_select_server;
+  const ola::network::IPV4Address m_interface;
+  const uint16_t m_port;
+  class BaseInflator *m_inflator;
+  const Options m_options;
+  std::vector<MemberSocket> m_sockets;
+  // true for a join, false for a leave.
+  PendingChanges m_pending;
+  // group -> index into m_sockets
+  GroupMap m_groups;
+  unsigned int m_join_failures;
+  ola::thread::timeout_id m_flush_timeout;
+  UIntMap *m_groups_var;
+  UIntMap *m_sockets_var;
+  UIntMap *m_join_failures_var;
+
+  void QueueChange(const ola::network::IPV4Address &group, bool join);
+  void ScheduledFlush();
+  void JoinGroup(const ola::network::IPV4Address &group);
+  void LeaveGroup(const ola::network::IPV4Address &group);
+  bool AddSocket();
+  void UpdateStats();
+
+  static const char NODE_KEY[];
+
+  DISALLOW_COPY_AND_ASSIGN(MulticastMembershipManager);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_MULTICASTMEMBERSHIPMANAGER_H_
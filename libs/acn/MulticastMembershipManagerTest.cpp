@@ -0,0 +1,226 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MulticastMembershipManagerTest.cpp
+ * Test fixture for the MulticastMembershipManager class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/MulticastMembershipManager.h"
+#include "libs/acn/RootInflator.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::HostToNetwork;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::auto_ptr;
+
+class MulticastMembershipManagerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MulticastMembershipManagerTest);
+  CPPUNIT_TEST(testJoinAndLeave);
+  CPPUNIT_TEST(testBatching);
+  CPPUNIT_TEST(testWithoutSelectServer);
+  CPPUNIT_TEST(testKernelLimit);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testJoinAndLeave();
+    void testBatching();
+    void testWithoutSelectServer();
+    void testKernelLimit();
+    void setUp();
+
+ private:
+    ola::io::SelectServer m_ss;
+    ola::network::UDPSocket m_socket;
+    RootInflator m_inflator;
+    uint16_t m_port;
+
+    MulticastMembershipManager *NewManager(
+        ola::io::SelectServerInterface *select_server,
+        const MulticastMembershipManager::Options &options);
+    static IPV4Address Group(unsigned int i);
+
+    static const char NAME[];
+};
+
+const char MulticastMembershipManagerTest::NAME[] = "e131:127.0.0.1";
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MulticastMembershipManagerTest);
+
+void MulticastMembershipManagerTest::setUp() {
+  OLA_ASSERT_TRUE(m_socket.Init());
+  OLA_ASSERT_TRUE(m_socket.Bind(
+      IPV4SocketAddress(IPV4Address::WildCard(), 0)));
+  IPV4SocketAddress address;
+  OLA_ASSERT_TRUE(m_socket.GetSocketAddress(&address));
+  m_port = address.Port();
+}
+
+MulticastMembershipManager *MulticastMembershipManagerTest::NewManager(
+    ola::io::SelectServerInterface *select_server,
+    const MulticastMembershipManager::Options &options) {
+  return new MulticastMembershipManager(&m_ss, select_server, &m_socket,
+                                        IPV4Address::Loopback(), m_port,
+                                        &m_inflator, options);
+}
+
+IPV4Address MulticastMembershipManagerTest::Group(unsigned int i) {
+  // 239.255.1.0 onwards
+  return IPV4Address(HostToNetwork(0xefff0100 + i));
+}
+
+
+/*
+ * Check the groups are spread across the sockets.
+ */
+void MulticastMembershipManagerTest::testJoinAndLeave() {
+  ExportMap export_map;
+  MulticastMembershipManager::Options options;
+  options.max_groups_per_socket = 4;
+  options.export_map = &export_map;
+  options.name = NAME;
+  auto_ptr<MulticastMembershipManager> manager(NewManager(&m_ss, options));
+
+  OLA_ASSERT_EQ(0u, manager->GroupCount());
+  OLA_ASSERT_EQ(1u, manager->SocketCount());
+
+  for (unsigned int i = 0; i < 10; i++) {
+    manager->Join(Group(i));
+  }
+  manager->Flush();
+  OLA_ASSERT_EQ(10u, manager->GroupCount());
+  OLA_ASSERT_EQ(3u, manager->SocketCount());
+  OLA_ASSERT_EQ(0u, manager->JoinFailures());
+  OLA_ASSERT_TRUE(manager->IsMember(Group(9)));
+
+  UIntMap *groups = export_map.GetUIntMapVar(
+      MulticastMembershipManager::GROUPS_VAR);
+  UIntMap *sockets = export_map.GetUIntMapVar(
+      MulticastMembershipManager::SOCKETS_VAR);
+  UIntMap *failures = export_map.GetUIntMapVar(
+      MulticastMembershipManager::JOIN_FAILURES_VAR);
+  OLA_ASSERT_EQ(10u, (*groups)[NAME]);
+  OLA_ASSERT_EQ(3u, (*sockets)[NAME]);
+  OLA_ASSERT_EQ(0u, (*failures)[NAME]);
+
+  // Leaving makes room on the node's socket, the extra sockets are kept.
+  manager->Leave(Group(0));
+  manager->Leave(Group(1));
+  manager->Flush();
+  OLA_ASSERT_EQ(8u, manager->GroupCount());
+  OLA_ASSERT_FALSE(manager->IsMember(Group(0)));
+  OLA_ASSERT_EQ(8u, (*groups)[NAME]);
+
+  manager->Join(Group(10));
+  manager->Join(Group(11));
+  manager->Flush();
+  OLA_ASSERT_EQ(10u, manager->GroupCount());
+  OLA_ASSERT_EQ(3u, manager->SocketCount());
+
+  // Leaving a group we're not in is a no-op.
+  manager->Leave(Group(100));
+  manager->Flush();
+  OLA_ASSERT_EQ(10u, manager->GroupCount());
+
+  manager.reset();
+  OLA_ASSERT_EQ(0u, (*groups)[NAME]);
+  OLA_ASSERT_EQ(1u, (*sockets)[NAME]);
+}
+
+
+/*
+ * Check the changes are applied at the end of the loop iteration, and that
+ * the last change for a group wins.
+ */
+void MulticastMembershipManagerTest::testBatching() {
+  MulticastMembershipManager::Options options;
+  auto_ptr<MulticastMembershipManager> manager(NewManager(&m_ss, options));
+
+  manager->Join(Group(0));
+  manager->Join(Group(1));
+  manager->Join(Group(2));
+  manager->Leave(Group(2));
+  OLA_ASSERT_EQ(0u, manager->GroupCount());
+
+  m_ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, manager->GroupCount());
+  OLA_ASSERT_TRUE(manager->IsMember(Group(0)));
+  OLA_ASSERT_TRUE(manager->IsMember(Group(1)));
+  OLA_ASSERT_FALSE(manager->IsMember(Group(2)));
+
+  manager->Leave(Group(0));
+  manager->Join(Group(0));
+  m_ss.RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, manager->GroupCount());
+  OLA_ASSERT_TRUE(manager->IsMember(Group(0)));
+}
+
+
+/*
+ * Without a SelectServer only the node's socket is used.
+ */
+void MulticastMembershipManagerTest::testWithoutSelectServer() {
+  ExportMap export_map;
+  MulticastMembershipManager::Options options;
+  options.max_groups_per_socket = 4;
+  options.export_map = &export_map;
+  options.name = NAME;
+  auto_ptr<MulticastMembershipManager> manager(NewManager(NULL, options));
+
+  for (unsigned int i = 0; i < 6; i++) {
+    manager->Join(Group(i));
+  }
+  manager->Flush();
+  OLA_ASSERT_EQ(4u, manager->GroupCount());
+  OLA_ASSERT_EQ(1u, manager->SocketCount());
+  OLA_ASSERT_EQ(2u, manager->JoinFailures());
+
+  UIntMap *failures = export_map.GetUIntMapVar(
+      MulticastMembershipManager::JOIN_FAILURES_VAR);
+  OLA_ASSERT_EQ(2u, (*failures)[NAME]);
+}
+
+
+/*
+ * Check that joins refused by the kernel move on to another socket.
+ */
+void MulticastMembershipManagerTest::testKernelLimit() {
+  MulticastMembershipManager::Options options;
+  options.max_groups_per_socket = 1000;
+  auto_ptr<MulticastMembershipManager> manager(NewManager(&m_ss, options));
+
+  // More than the default igmp_max_memberships on Linux.
+  for (unsigned int i = 0; i < 50; i++) {
+    manager->Join(Group(i));
+  }
+  manager->Flush();
+  OLA_ASSERT_EQ(50u, manager->GroupCount());
+  OLA_ASSERT_EQ(0u, manager->JoinFailures());
+}
+}  // namespace acn
+}  // namespace ola
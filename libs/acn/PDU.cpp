@@ -50,7 +50,6 @@ unsigned int PDU::Size() const {
  */
 bool PDU::Pack(uint8_t *buffer, unsigned int *length) const {
   unsigned int size = Size();
-  unsigned int offset = 0;
 
   if (*length < size) {
     OLA_WARN << "PDU Pack: buffer too small, required " << size << ", got "
@@ -59,6 +58,86 @@ bool PDU::Pack(uint8_t *buffer, unsigned int *length) const {
     return false;
   }
 
+  unsigned int offset = PackFlagsAndVector(buffer, size);
+  if (!offset) {
+    *length = 0;
+    return false;
+  }
+
+  unsigned int bytes_used = *length - offset;
+  if (!PackHeader(buffer + offset, &bytes_used)) {
+    *length = 0;
+    return false;
+  }
+  offset += bytes_used;
+
+  bytes_used = *length - offset;
+  if (!PackData(buffer + offset, &bytes_used)) {
+    *length = 0;
+    return false;
+  }
+  offset += bytes_used;
+  *length = offset;
+  return true;
+}
+
+
+/*
+ * Add this PDU to an IOVecBuilder
+ * @param output the IOVecBuilder to use
+ * @return false on error, true otherwise
+ */
+bool PDU::PackIOVec(IOVecBuilder *output) const {
+  unsigned int size = Size();
+  unsigned int header_size = size - DataSize();
+  uint8_t *buffer = output->Reserve(header_size);
+  if (!buffer) {
+    OLA_WARN << "PDU PackIOVec: out of scratch space, required "
+             << header_size;
+    return false;
+  }
+
+  unsigned int offset = PackFlagsAndVector(buffer, size);
+  if (!offset)
+    return false;
+
+  unsigned int bytes_used = header_size - offset;
+  if (!PackHeader(buffer + offset, &bytes_used))
+    return false;
+  output->Unreserve(header_size - offset - bytes_used);
+  return PackDataIOVec(output);
+}
+
+
+/*
+ * Pack the data into the IOVecBuilder's scratch space.
+ */
+bool PDU::PackDataIOVec(IOVecBuilder *output) const {
+  unsigned int data_size = DataSize();
+  uint8_t *buffer = output->Reserve(data_size);
+  if (!buffer) {
+    OLA_WARN << "PDU PackDataIOVec: out of scratch space, required "
+             << data_size;
+    return false;
+  }
+
+  unsigned int bytes_used = data_size;
+  if (!PackData(buffer, &bytes_used))
+    return false;
+  output->Unreserve(data_size - bytes_used);
+  return true;
+}
+
+
+/*
+ * Pack the flags, length and vector.
+ * @param buffer the buffer to pack into, this must be large enough.
+ * @param size the size of the PDU.
+ * @return the number of bytes used, or 0 on error.
+ */
+unsigned int PDU::PackFlagsAndVector(uint8_t *buffer,
+                                     unsigned int size) const {
+  unsigned int offset = 0;
   if (size <= TWOB_LENGTH_LIMIT) {
     buffer[0] = (uint8_t) ((size & 0x0f00) >> 8);
     buffer[1] = (uint8_t) (size & 0xff);
@@ -90,24 +169,9 @@ bool PDU::Pack(uint8_t *buffer, unsigned int *length) const {
       break;
     default:
       OLA_WARN << "unknown vector size " << m_vector_size;
-      return false;
+      return 0;
   }
-
-  unsigned int bytes_used = *length - offset;
-  if (!PackHeader(buffer + offset, &bytes_used)) {
-    *length = 0;
-    return false;
-  }
-  offset += bytes_used;
-
-  bytes_used = *length - offset;
-  if (!PackData(buffer + offset, &bytes_used)) {
-    *length = 0;
-    return false;
-  }
-  offset += bytes_used;
-  *length = offset;
-  return true;
+  return offset;
 }
 
 
@@ -26,6 +26,8 @@
 #include <ola/io/OutputBuffer.h>
 #include <vector>
 
+#include "libs/acn/IOVecBuilder.h"
+
 namespace ola {
 namespace acn {
 
@@ -70,6 +72,18 @@ class PDU {
     virtual void PackHeader(ola::io::OutputStream *stream) const = 0;
     virtual void PackData(ola::io::OutputStream *stream) const = 0;
 
+    /**
+     * Add the PDU to an IOVecBuilder. The flags, vector and header are packed
+     * into the builder's scratch space, PackDataIOVec() adds the data.
+     */
+    bool PackIOVec(IOVecBuilder *output) const;
+    /**
+     * Add the data to an IOVecBuilder. By default this packs the data into
+     * the scratch space, PDUs which carry data that can be referenced in
+     * place override this.
+     */
+    virtual bool PackDataIOVec(IOVecBuilder *output) const;
+
     static void PrependFlagsAndLength(
         ola::io::OutputBufferInterface *output,
         uint8_t flags = VFLAG_MASK | HFLAG_MASK | DFLAG_MASK);
@@ -90,6 +104,8 @@ class PDU {
     unsigned int m_vector;
     unsigned int m_vector_size;
 
+    unsigned int PackFlagsAndVector(uint8_t *buffer, unsigned int size) const;
+
     // The max PDU length that can be represented with the 2 byte format for
     // the length field.
     static const unsigned int TWOB_LENGTH_LIMIT = 0x0FFF;
@@ -124,6 +140,12 @@ class PDUBlock {
      */
     bool Pack(uint8_t *data, unsigned int *length) const;
 
+    /**
+     * Add this PDUBlock to an IOVecBuilder
+     * @return true on success, false on failure
+     */
+    bool PackIOVec(IOVecBuilder *output) const;
+
     /**
      * Write this PDU block to an OutputStream
      */
@@ -157,6 +179,22 @@ bool PDUBlock<C>::Pack(uint8_t *data, unsigned int *length) const {
 }
 
 
+/*
+ * Add this block of PDUs to an IOVecBuilder.
+ * @param output the IOVecBuilder to add the PDUs to
+ * @return true on success, false on failure
+ */
+template <class C>
+bool PDUBlock<C>::PackIOVec(IOVecBuilder *output) const {
+  typename std::vector<const C*>::const_iterator iter;
+  for (iter = m_pdus.begin(); iter != m_pdus.end(); ++iter) {
+    if (!(*iter)->PackIOVec(output))
+      return false;
+  }
+  return true;
+}
+
+
 /*
  * Write this block of PDUs to an OutputStream.
  * @param stream the OutputStream to write to
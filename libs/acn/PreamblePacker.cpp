@@ -87,6 +87,30 @@ const uint8_t *PreamblePacker::Pack(const PDUBlock<PDU> &pdu_block,
 }
 
 
+/**
+ * Add the preamble and the PDU block to an IOVecBuilder, without copying the
+ * PDU data.
+ * @param pdu_block the block of pdus to send
+ * @param output the IOVecBuilder to use, this is cleared first.
+ * @return true on success, false on failure
+ */
+bool PreamblePacker::PackIOVec(const PDUBlock<PDU> &pdu_block,
+                               IOVecBuilder *output) {
+  output->Clear();
+  uint8_t *preamble = output->Reserve(ACN_HEADER_SIZE);
+  if (!preamble)
+    return false;
+  memcpy(preamble, ACN_HEADER, ACN_HEADER_SIZE);
+
+  if (!pdu_block.PackIOVec(output) || output->Size() > MAX_DATAGRAM_SIZE) {
+    OLA_WARN << "Failed to pack E1.31 PDU";
+    output->Clear();
+    return false;
+  }
+  return true;
+}
+
+
 /**
  * Add the UDP Preamble to an IOStack
  */
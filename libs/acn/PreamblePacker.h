@@ -23,6 +23,7 @@
 #define LIBS_ACN_PREAMBLEPACKER_H_
 
 #include "ola/io/IOStack.h"
+#include "libs/acn/IOVecBuilder.h"
 #include "libs/acn/PDU.h"
 
 namespace ola {
@@ -40,20 +41,22 @@ class PreamblePacker {
     const uint8_t *Pack(const PDUBlock<PDU> &pdu_block,
                         unsigned int *length);
 
+    static bool PackIOVec(const PDUBlock<PDU> &pdu_block,
+                          IOVecBuilder *output);
+
     static void AddUDPPreamble(ola::io::IOStack *stack);
     static void AddTCPPreamble(ola::io::IOStack *stack);
 
     static const uint8_t ACN_HEADER[];
     static const unsigned int ACN_HEADER_SIZE;
+    static const uint8_t TCP_ACN_HEADER[];
+    static const unsigned int TCP_ACN_HEADER_SIZE;
     static const unsigned int MAX_DATAGRAM_SIZE = 1472;
 
  private:
     uint8_t *m_send_buffer;
 
     void Init();
-
-    static const uint8_t TCP_ACN_HEADER[];
-    static const unsigned int TCP_ACN_HEADER_SIZE;
 };
 }  // namespace acn
 }  // namespace ola
@@ -21,27 +21,48 @@
 #ifndef LIBS_ACN_ROOTHEADER_H_
 #define LIBS_ACN_ROOTHEADER_H_
 
+#include <stdint.h>
+#include <string.h>
 #include "ola/acn/CID.h"
 
 namespace ola {
 namespace acn {
 
 /*
- * The header for the root layer
+ * The header for the root layer. The CID is held in its packed form, so
+ * decoding a packet doesn't construct a CID object.
  */
 class RootHeader {
  public:
-    RootHeader() {}
+    RootHeader() { memset(m_cid, 0, sizeof(m_cid)); }
     ~RootHeader() {}
-    void SetCid(ola::acn::CID cid) { m_cid = cid; }
-    ola::acn::CID GetCid() const { return m_cid; }
+
+    void SetCid(const ola::acn::CID &cid) { cid.Pack(m_cid); }
+    void SetCidData(const uint8_t *data) {
+      memcpy(m_cid, data, sizeof(m_cid));
+    }
+    void ResetCid() { memset(m_cid, 0, sizeof(m_cid)); }
+
+    ola::acn::CID GetCid() const { return ola::acn::CID::FromData(m_cid); }
+    // The CID in network byte order, CID::CID_LENGTH bytes long.
+    const uint8_t *CidData() const { return m_cid; }
+    bool CidIsNil() const;
 
     bool operator==(const RootHeader &other) const {
-      return m_cid == other.m_cid;
+      return memcmp(m_cid, other.m_cid, sizeof(m_cid)) == 0;
     }
  private:
-    ola::acn::CID m_cid;
+    uint8_t m_cid[ola::acn::CID::CID_LENGTH];
 };
+
+inline bool RootHeader::CidIsNil() const {
+  for (unsigned int i = 0; i < sizeof(m_cid); i++) {
+    if (m_cid[i]) {
+      return false;
+    }
+  }
+  return true;
+}
 }  // namespace acn
 }  // namespace ola
 #endif  // LIBS_ACN_ROOTHEADER_H_
@@ -40,8 +40,7 @@ bool RootInflator::DecodeHeader(HeaderSet *headers,
                                 unsigned int *bytes_used) {
   if (data) {
     if (length >= CID::CID_LENGTH) {
-      CID cid = CID::FromData(data);
-      m_last_hdr.SetCid(cid);
+      m_last_hdr.SetCidData(data);
       headers->SetRootHeader(m_last_hdr);
       *bytes_used = CID::CID_LENGTH;
       return true;
@@ -49,7 +48,7 @@ bool RootInflator::DecodeHeader(HeaderSet *headers,
     return false;
   }
   *bytes_used = 0;
-  if (m_last_hdr.GetCid().IsNil()) {
+  if (m_last_hdr.CidIsNil()) {
     OLA_WARN << "Missing CID data";
     return false;
   }
@@ -62,8 +61,7 @@ bool RootInflator::DecodeHeader(HeaderSet *headers,
  * Reset the header field
  */
 void RootInflator::ResetHeaderField() {
-  CID cid;
-  m_last_hdr.SetCid(cid);
+  m_last_hdr.ResetCid();
 }
 
 
@@ -77,6 +77,16 @@ void RootPDU::PackData(OutputStream *stream) const {
 }
 
 
+/*
+ * Add the data to an IOVecBuilder
+ */
+bool RootPDU::PackDataIOVec(IOVecBuilder *output) const {
+  if (m_block)
+    return m_block->PackIOVec(output);
+  return true;
+}
+
+
 void RootPDU::SetBlock(const PDUBlock<PDU> *block) {
   m_block = block;
   m_block_size = m_block ? block->Size() : 0;
@@ -55,6 +55,8 @@ class RootPDU: public PDU {
   void PackHeader(ola::io::OutputStream *stream) const;
   void PackData(ola::io::OutputStream *stream) const;
 
+  bool PackDataIOVec(IOVecBuilder *output) const;
+
   const ola::acn::CID &Cid() const { return m_cid; }
   const ola::acn::CID &Cid(const ola::acn::CID &cid) { return m_cid = cid; }
   void SetBlock(const PDUBlock<PDU> *block);
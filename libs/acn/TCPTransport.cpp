@@ -21,7 +21,6 @@
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
 #include <ola/network/SocketAddress.h>
-#include <algorithm>
 #include <iostream>
 #include "libs/acn/BaseInflator.h"
 #include "libs/acn/HeaderSet.h"
@@ -41,8 +40,8 @@ const uint8_t ACN_HEADER[] = {
 
 const unsigned int ACN_HEADER_SIZE = sizeof(ACN_HEADER);
 
-// TODO(simon): tune this once we have an idea of what the sizes will be
-const unsigned int IncomingStreamTransport::INITIAL_SIZE = 500;
+// Enough for several E1.33 PDUs per read, larger PDUs grow the buffer.
+const unsigned int IncomingStreamTransport::INITIAL_SIZE = 4096;
 
 
 /**
@@ -58,9 +57,10 @@ IncomingStreamTransport::IncomingStreamTransport(
     : m_transport_header(source, TransportHeader::TCP),
       m_inflator(inflator),
       m_descriptor(descriptor),
-      m_buffer_start(NULL),
-      m_buffer_end(NULL),
-      m_data_end(NULL),
+      m_buffer(new uint8_t[INITIAL_SIZE]),
+      m_buffer_size(INITIAL_SIZE),
+      m_data_start(m_buffer),
+      m_data_end(m_buffer),
       m_block_size(0),
       m_consumed_block_size(0),
       m_stream_valid(true),
@@ -74,46 +74,48 @@ IncomingStreamTransport::IncomingStreamTransport(
  * Clean up
  */
 IncomingStreamTransport::~IncomingStreamTransport() {
-  if (m_buffer_start)
-    delete[] m_buffer_start;
+  delete[] m_buffer;
 }
 
 
 /**
  * Read from this stream, looking for ACN messages.
+ *
+ * Each read fills as much of the buffer as it can, and the PDUs are inflated
+ * in place. Only the trailing partial PDU is moved to the front of the buffer
+ * before the next read.
  * @returns false if the stream is no longer consistent. At this point the
  * caller should close the descriptor since the data is no longer valid.
  */
 bool IncomingStreamTransport::Receive() {
   while (true) {
-    OLA_DEBUG << "start read, outstanding bytes is " << m_outstanding_data;
-    // Read as much as we need
-    ReadRequiredData();
-
-    OLA_DEBUG << "done read, bytes outstanding is " << m_outstanding_data;
-
-    // if we still don't have enough, return
-    if (m_stream_valid == false || m_outstanding_data)
-      return m_stream_valid;
-
-    OLA_DEBUG << "state is " << m_state;
-
-    switch (m_state) {
-      case WAITING_FOR_PREAMBLE:
-        HandlePreamble();
-        break;
-      case WAITING_FOR_PDU_FLAGS:
-        HandlePDUFlags();
-        break;
-      case WAITING_FOR_PDU_LENGTH:
-        HandlePDULength();
-        break;
-      case WAITING_FOR_PDU:
-        HandlePDU();
-        break;
+    bool buffer_filled = ReadData();
+    OLA_DEBUG << "done read, " << DataLength() << " bytes unparsed";
+
+    while (m_stream_valid && DataLength() >= m_required_data) {
+      OLA_DEBUG << "state is " << m_state;
+
+      switch (m_state) {
+        case WAITING_FOR_PREAMBLE:
+          HandlePreamble();
+          break;
+        case WAITING_FOR_PDU_FLAGS:
+          HandlePDUFlags();
+          break;
+        case WAITING_FOR_PDU_LENGTH:
+          HandlePDULength();
+          break;
+        case WAITING_FOR_PDU:
+          HandlePDU();
+          break;
+      }
     }
+
     if (!m_stream_valid)
       return false;
+    // if the buffer wasn't filled there's no more data to read
+    if (!buffer_filled)
+      return true;
   }
 }
 
@@ -125,8 +127,8 @@ bool IncomingStreamTransport::Receive() {
 void IncomingStreamTransport::HandlePreamble() {
   OLA_DEBUG << "in handle preamble, data len is " << DataLength();
 
-  if (memcmp(m_buffer_start, ACN_HEADER, ACN_HEADER_SIZE) != 0) {
-    ola::FormatData(&std::cout, m_buffer_start, ACN_HEADER_SIZE);
+  if (memcmp(m_data_start, ACN_HEADER, ACN_HEADER_SIZE) != 0) {
+    ola::FormatData(&std::cout, m_data_start, ACN_HEADER_SIZE);
     ola::FormatData(&std::cout, ACN_HEADER, ACN_HEADER_SIZE);
     OLA_WARN << "bad ACN header";
     m_stream_valid = false;
@@ -135,10 +137,11 @@ void IncomingStreamTransport::HandlePreamble() {
 
   // read the PDU block length
   memcpy(reinterpret_cast<void*>(&m_block_size),
-         m_buffer_start + ACN_HEADER_SIZE,
+         m_data_start + ACN_HEADER_SIZE,
          sizeof(m_block_size));
   m_block_size = ola::network::NetworkToHost(m_block_size);
   OLA_DEBUG << "pdu block size is " << m_block_size;
+  m_data_start += ACN_HEADER_SIZE + PDU_BLOCK_SIZE;
 
   if (m_block_size) {
     m_consumed_block_size = 0;
@@ -156,9 +159,9 @@ void IncomingStreamTransport::HandlePreamble() {
  */
 void IncomingStreamTransport::HandlePDUFlags() {
   OLA_DEBUG << "Reading PDU flags, data size is " << DataLength();
-  m_pdu_length_size = (*m_buffer_start  & BaseInflator::LFLAG_MASK) ?
+  m_pdu_length_size = (*m_data_start & BaseInflator::LFLAG_MASK) ?
     THREE_BYTES : TWO_BYTES;
-  m_outstanding_data += static_cast<unsigned int>(m_pdu_length_size) - 1;
+  m_required_data = static_cast<unsigned int>(m_pdu_length_size);
   OLA_DEBUG << "PDU length size is " << static_cast<int>(m_pdu_length_size) <<
     " bytes";
   m_state = WAITING_FOR_PDU_LENGTH;
@@ -172,13 +175,13 @@ void IncomingStreamTransport::HandlePDUFlags() {
 void IncomingStreamTransport::HandlePDULength() {
   if (m_pdu_length_size == THREE_BYTES) {
     m_pdu_size = (
-      m_buffer_start[2] +
-      static_cast<unsigned int>(m_buffer_start[1] << 8) +
-      static_cast<unsigned int>((m_buffer_start[0] & BaseInflator::LENGTH_MASK)
+      m_data_start[2] +
+      static_cast<unsigned int>(m_data_start[1] << 8) +
+      static_cast<unsigned int>((m_data_start[0] & BaseInflator::LENGTH_MASK)
         << 16));
   } else {
-    m_pdu_size = m_buffer_start[1] + static_cast<unsigned int>(
-        (m_buffer_start[0] & BaseInflator::LENGTH_MASK) << 8);
+    m_pdu_size = m_data_start[1] + static_cast<unsigned int>(
+        (m_data_start[0] & BaseInflator::LENGTH_MASK) << 8);
   }
   OLA_DEBUG << "PDU size is " << m_pdu_size;
 
@@ -190,9 +193,8 @@ void IncomingStreamTransport::HandlePDULength() {
     return;
   }
 
-  m_outstanding_data += (
-    m_pdu_size - static_cast<unsigned int>(m_pdu_length_size));
-  OLA_DEBUG << "Processed length, now waiting on another " << m_outstanding_data
+  m_required_data = m_pdu_size;
+  OLA_DEBUG << "Processed length, now waiting on " << m_required_data
     << " bytes";
   m_state = WAITING_FOR_PDU;
 }
@@ -206,18 +208,12 @@ void IncomingStreamTransport::HandlePDU() {
   OLA_DEBUG << "Got PDU, data length is " << DataLength() << ", expected " <<
     m_pdu_size;
 
-  if (DataLength() != m_pdu_size) {
-    OLA_WARN << "PDU size doesn't match the available data";
-    m_stream_valid = false;
-    return;
-  }
-
   HeaderSet header_set;
   header_set.SetTransportHeader(m_transport_header);
 
   unsigned int data_consumed = m_inflator->InflatePDUBlock(
       &header_set,
-      m_buffer_start,
+      m_data_start,
       m_pdu_size);
   OLA_DEBUG << "inflator consumed " << data_consumed << " bytes";
 
@@ -228,6 +224,7 @@ void IncomingStreamTransport::HandlePDU() {
     return;
   }
 
+  m_data_start += data_consumed;
   m_consumed_block_size += data_consumed;
 
   if (m_consumed_block_size == m_block_size) {
@@ -241,53 +238,51 @@ void IncomingStreamTransport::HandlePDU() {
 
 /**
  * Grow the rx buffer to the new size.
+ * @pre the unparsed data is at the start of the buffer.
  */
 void IncomingStreamTransport::IncreaseBufferSize(unsigned int new_size) {
-  if (new_size <= BufferSize())
+  if (new_size <= m_buffer_size)
     return;
 
-  new_size = std::max(new_size, INITIAL_SIZE);
-
   unsigned int data_length = DataLength();
-  if (!m_buffer_start)
-    data_length = 0;
-
-  // allocate new buffer and copy the data over
   uint8_t *buffer = new uint8_t[new_size];
-  if (m_buffer_start) {
-    if (data_length > 0)
-      // this moves the data to the start of the buffer if it wasn't already
-      memcpy(buffer, m_buffer_start, data_length);
-    delete[] m_buffer_start;
-  }
+  memcpy(buffer, m_data_start, data_length);
+  delete[] m_buffer;
 
-  m_buffer_start = buffer;
-  m_buffer_end = buffer + new_size;
+  m_buffer = buffer;
+  m_buffer_size = new_size;
+  m_data_start = buffer;
   m_data_end = buffer + data_length;
 }
 
 
 /**
- * Read data until we reach the number of bytes we required or there is no more
- * data to be read
+ * Read as much data as will fit in the buffer.
+ * @returns true if the buffer was filled, in which case there may be more
+ * data to read.
  */
-void IncomingStreamTransport::ReadRequiredData() {
-  if (m_outstanding_data == 0)
-    return;
+bool IncomingStreamTransport::ReadData() {
+  // Move the partial data to the start of the buffer, this is less than one
+  // PDU.
+  if (m_data_start != m_buffer) {
+    unsigned int data_length = DataLength();
+    memmove(m_buffer, m_data_start, data_length);
+    m_data_start = m_buffer;
+    m_data_end = m_buffer + data_length;
+  }
 
-  if (m_outstanding_data > FreeSpace())
-    IncreaseBufferSize(DataLength() + m_outstanding_data);
+  if (m_required_data > m_buffer_size)
+    IncreaseBufferSize(m_required_data);
 
+  unsigned int free_space = FreeSpace();
   unsigned int data_read;
-  int ok = m_descriptor->Receive(m_data_end,
-                                 m_outstanding_data,
-                                 data_read);
+  int ok = m_descriptor->Receive(m_data_end, free_space, data_read);
 
   if (ok != 0)
     OLA_WARN << "tcp rx failed";
   OLA_DEBUG << "read " << data_read;
   m_data_end += data_read;
-  m_outstanding_data -= data_read;
+  return data_read == free_space;
 }
 
 
@@ -295,9 +290,8 @@ void IncomingStreamTransport::ReadRequiredData() {
  * Enter the wait-for-preamble state
  */
 void IncomingStreamTransport::EnterWaitingForPreamble() {
-  m_data_end = m_buffer_start;
   m_state = WAITING_FOR_PREAMBLE;
-  m_outstanding_data = ACN_HEADER_SIZE + PDU_BLOCK_SIZE;
+  m_required_data = ACN_HEADER_SIZE + PDU_BLOCK_SIZE;
 }
 
 
@@ -306,9 +300,8 @@ void IncomingStreamTransport::EnterWaitingForPreamble() {
  */
 void IncomingStreamTransport::EnterWaitingForPDU() {
   m_state = WAITING_FOR_PDU_FLAGS;
-  m_data_end = m_buffer_start;
   // we need 1 byte to read the flags
-  m_outstanding_data = 1;
+  m_required_data = 1;
 }
 
 
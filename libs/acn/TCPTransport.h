@@ -75,10 +75,14 @@ class IncomingStreamTransport {
     class BaseInflator *m_inflator;
     ola::io::ConnectedDescriptor *m_descriptor;
 
-    // end points to the byte after the data
-    uint8_t *m_buffer_start, *m_buffer_end, *m_data_end;
-    // the amount of data we need before we can move to the next stage
-    unsigned int m_outstanding_data;
+    // The data between m_data_start and m_data_end has been read but not yet
+    // parsed.
+    uint8_t *m_buffer;
+    unsigned int m_buffer_size;
+    uint8_t *m_data_start, *m_data_end;
+    // the amount of data, from m_data_start, we need before we can move to
+    // the next stage
+    unsigned int m_required_data;
     // the state we're currently in
     RXState m_state;
     unsigned int m_block_size;
@@ -93,7 +97,7 @@ class IncomingStreamTransport {
     void HandlePDU();
 
     void IncreaseBufferSize(unsigned int new_size);
-    void ReadRequiredData();
+    bool ReadData();
     void EnterWaitingForPreamble();
     void EnterWaitingForPDU();
 
@@ -101,23 +105,14 @@ class IncomingStreamTransport {
      * Returns the free space at the end of the buffer.
      */
     inline unsigned int FreeSpace() const {
-      return m_buffer_start ?
-        static_cast<unsigned int>(m_buffer_end - m_data_end) : 0u;
+      return static_cast<unsigned int>(m_buffer + m_buffer_size - m_data_end);
     }
 
     /**
-     * Return the amount of data in the buffer
+     * Return the amount of unparsed data in the buffer
      */
     inline unsigned int DataLength() const {
-      return m_buffer_start ?
-        static_cast<unsigned int>(m_data_end - m_buffer_start) : 0u;
-    }
-
-    /**
-     * Return the size of the buffer
-     */
-    inline unsigned int BufferSize() const {
-      return static_cast<unsigned int>(m_buffer_end - m_buffer_start);
+      return static_cast<unsigned int>(m_data_end - m_data_start);
     }
 
     static const unsigned int INITIAL_SIZE;
@@ -52,6 +52,7 @@ class TCPTransportTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testZeroLengthPDUBlock);
   CPPUNIT_TEST(testMultiplePDUs);
   CPPUNIT_TEST(testSinglePDUBlock);
+  CPPUNIT_TEST(testBufferedPDUs);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,6 +64,7 @@ class TCPTransportTest: public CppUnit::TestFixture {
     void testMultiplePDUs();
     void testMultiplePDUsWithExtraData();
     void testSinglePDUBlock();
+    void testBufferedPDUs();
     void setUp();
     void tearDown();
 
@@ -245,6 +247,23 @@ void TCPTransportTest::testSinglePDUBlock() {
 }
 
 
+/**
+ * Send more PDUs than fit in the receive buffer, so some PDUs straddle reads.
+ */
+void TCPTransportTest::testBufferedPDUs() {
+  const unsigned int pdu_count = 150;
+  for (unsigned int i = 0; i < pdu_count; i++) {
+    SendPDU(OLA_SOURCELINE());
+  }
+
+  m_ss->RunOnce(TimeInterval(1, 0));
+  m_loopback.CloseClient();
+  m_ss->RunOnce(TimeInterval(1, 0));
+  OLA_ASSERT(m_stream_ok);
+  OLA_ASSERT_EQ(pdu_count, m_pdus_received);
+}
+
+
 /**
  * Send empty PDU block.
  */
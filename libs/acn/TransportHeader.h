@@ -24,6 +24,7 @@
 #ifndef LIBS_ACN_TRANSPORTHEADER_H_
 #define LIBS_ACN_TRANSPORTHEADER_H_
 
+#include "ola/Clock.h"
 #include "ola/network/SocketAddress.h"
 
 namespace ola {
@@ -42,27 +43,34 @@ class TransportHeader {
 
   TransportHeader() : m_transport_type(UNDEFINED) {}
   TransportHeader(const ola::network::IPV4SocketAddress &source,
-                  TransportType type)
+                  TransportType type,
+                  const TimeStamp &arrival = TimeStamp())
       : m_source(source),
-        m_transport_type(type) {}
+        m_transport_type(type),
+        m_arrival(arrival) {}
 
   ~TransportHeader() {}
   const ola::network::IPV4SocketAddress& Source() const { return m_source; }
   TransportType Transport() const { return m_transport_type; }
+  // The wall clock time the kernel received the packet, this may not be set.
+  const TimeStamp &Arrival() const { return m_arrival; }
 
   bool operator==(const TransportHeader &other) const {
     return (m_source == other.m_source &&
-            m_transport_type == other.m_transport_type);
+            m_transport_type == other.m_transport_type &&
+            m_arrival == other.m_arrival);
   }
 
   void operator=(const TransportHeader &other) {
     m_source = other.m_source;
     m_transport_type = other.m_transport_type;
+    m_arrival = other.m_arrival;
   }
 
  private:
   ola::network::IPV4SocketAddress m_source;
   TransportType m_transport_type;
+  TimeStamp m_arrival;
 };
 }  // namespace acn
 }  // namespace ola
@@ -24,6 +24,7 @@
 #include "ola/Logging.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/SocketAddress.h"
+#include "ola/util/Trace.h"
 #include "libs/acn/BaseInflator.h"
 #include "libs/acn/HeaderSet.h"
 #include "libs/acn/UDPTransport.h"
@@ -51,13 +52,14 @@ bool OutgoingUDPTransport::Send(const PDUBlock<PDU> &pdu_block) {
  */
 bool OutgoingUDPTransportImpl::Send(const PDUBlock<PDU> &pdu_block,
                                     const IPV4SocketAddress &destination) {
-  unsigned int data_size;
-  const uint8_t *data = m_packer->Pack(pdu_block, &data_size);
-
-  if (!data)
+  // The headers are packed into m_iovec, the slot data is sent from where it
+  // is.
+  if (!PreamblePacker::PackIOVec(pdu_block, &m_iovec))
     return false;
 
-  return m_socket->SendTo(data, data_size, destination);
+  if (m_batcher)
+    return m_batcher->SendTo(&m_iovec, destination);
+  return m_socket->SendTo(&m_iovec, destination);
 }
 
 
@@ -66,43 +68,49 @@ IncomingUDPTransport::IncomingUDPTransport(ola::network::UDPSocket *socket,
                                            BaseInflator *inflator)
     : m_socket(socket),
       m_inflator(inflator),
-      m_recv_buffer(NULL) {
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  PreamblePacker::MAX_DATAGRAM_SIZE) {
 }
 
 
 /*
- * Called when new data arrives.
+ * Called when new data arrives. This drains all the queued datagrams.
  */
 void IncomingUDPTransport::Receive() {
-  if (!m_recv_buffer)
-    m_recv_buffer = new uint8_t[PreamblePacker::MAX_DATAGRAM_SIZE];
+  ola::TraceSpan span("acn.receive");
+  unsigned int count = m_recv_ring.Receive(m_socket);
+  for (unsigned int i = 0; i < count; i++) {
+    HandleDatagram(m_recv_ring.Get(i));
+  }
+}
 
-  ssize_t size = PreamblePacker::MAX_DATAGRAM_SIZE;
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(m_recv_buffer, &size, &source))
-    return;
 
+/*
+ * Check the preamble and inflate a single datagram.
+ */
+void IncomingUDPTransport::HandleDatagram(
+    const ola::network::UDPDatagram &datagram) {
+  ola::TraceSpan span("acn.inflate");
   unsigned int header_size = PreamblePacker::ACN_HEADER_SIZE;
-  if (size < static_cast<ssize_t>(header_size)) {
+  if (datagram.size < header_size) {
     OLA_WARN << "short ACN frame, discarding";
     return;
   }
 
-  if (memcmp(m_recv_buffer, PreamblePacker::ACN_HEADER, header_size)) {
+  if (memcmp(datagram.data, PreamblePacker::ACN_HEADER, header_size)) {
     OLA_WARN << "ACN header is bad, discarding";
     return;
   }
 
   HeaderSet header_set;
-  TransportHeader transport_header(source, TransportHeader::UDP);
+  TransportHeader transport_header(datagram.source, TransportHeader::UDP,
+                                   datagram.arrival);
   header_set.SetTransportHeader(transport_header);
 
   m_inflator->InflatePDUBlock(
       &header_set,
-      m_recv_buffer + header_size,
-      static_cast<unsigned int>(size) - header_size);
-  return;
+      datagram.data + header_size,
+      datagram.size - header_size);
 }
 }  // namespace acn
 }  // namespace ola
@@ -21,9 +21,12 @@
 #ifndef LIBS_ACN_UDPTRANSPORT_H_
 #define LIBS_ACN_UDPTRANSPORT_H_
 
+#include <string>
 #include "ola/acn/ACNPort.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPTransmitBatcher.h"
+#include "libs/acn/IOVecBuilder.h"
 #include "libs/acn/PDU.h"
 #include "libs/acn/PreamblePacker.h"
 #include "libs/acn/Transport.h"
@@ -61,28 +64,27 @@ class OutgoingUDPTransport: public OutgoingTransport {
  */
 class OutgoingUDPTransportImpl {
  public:
-    OutgoingUDPTransportImpl(ola::network::UDPSocket *socket,
-                             PreamblePacker *packer = NULL)
+    explicit OutgoingUDPTransportImpl(ola::network::UDPSocket *socket)
         : m_socket(socket),
-          m_packer(packer),
-          m_free_packer(false) {
-      if (!m_packer) {
-        m_packer = new PreamblePacker();
-        m_free_packer = true;
-      }
-    }
-    ~OutgoingUDPTransportImpl() {
-      if (m_free_packer)
-        delete m_packer;
+          m_batcher(NULL) {
     }
+    ~OutgoingUDPTransportImpl() {}
 
     bool Send(const PDUBlock<PDU> &pdu_block,
               const ola::network::IPV4SocketAddress &destination);
 
+    /**
+     * Queue the datagrams with a UDPTransmitBatcher rather than sending them
+     * directly. Pass NULL to go back to sending directly.
+     */
+    void SetBatcher(ola::network::UDPTransmitBatcher *batcher) {
+      m_batcher = batcher;
+    }
+
  private:
     ola::network::UDPSocket *m_socket;
-    PreamblePacker *m_packer;
-    bool m_free_packer;
+    ola::network::UDPTransmitBatcher *m_batcher;
+    IOVecBuilder m_iovec;
 };
 
 
@@ -95,17 +97,21 @@ class IncomingUDPTransport {
  public:
     IncomingUDPTransport(ola::network::UDPSocket *socket,
                          class BaseInflator *inflator);
-    ~IncomingUDPTransport() {
-      if (m_recv_buffer)
-        delete[] m_recv_buffer;
-    }
+    ~IncomingUDPTransport() {}
 
     void Receive();
 
+    // Export the datagrams the kernel dropped on the socket, keyed by name.
+    void ExportDrops(ola::ExportMap *export_map, const std::string &name) {
+      m_recv_ring.ExportDrops(export_map, name);
+    }
+
  private:
     ola::network::UDPSocket *m_socket;
     class BaseInflator *m_inflator;
-    uint8_t *m_recv_buffer;
+    ola::network::UDPReceiveRing m_recv_ring;
+
+    void HandleDatagram(const ola::network::UDPDatagram &datagram);
 };
 }  // namespace acn
 }  // namespace ola
@@ -20,8 +20,10 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <iostream>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
@@ -30,13 +32,22 @@
 #include "libs/acn/E131Node.h"
 
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::io::SelectServer;
 using ola::acn::E131Node;
 using ola::NewCallback;
+using std::cout;
+using std::endl;
 using std::min;
 
 DEFINE_s_uint32(fps, s, 10, "Frames per second per universe [1 - 40]");
 DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
+DEFINE_uint32(benchmark_frames, 0,
+              "If non-0, send this many frames per universe as fast as "
+              "possible, print the rate and exit.");
+DEFINE_default_bool(batch_transmit, false,
+                    "Batch the datagrams with sendmmsg().");
 
 /**
  * Send N DMX frames using E1.31, where N is given by number_of_universes.
@@ -49,6 +60,34 @@ bool SendFrames(E131Node *node, DmxBuffer *buffer,
   return true;
 }
 
+/**
+ * Send frames as fast as we can and report the rate. Since the packets for
+ * each universe are pre-built, this is mostly the cost of the syscalls.
+ */
+void RunBenchmark(SelectServer *ss, E131Node *node, DmxBuffer *buffer,
+                  uint16_t number_of_universes, unsigned int frames) {
+  ola::MonotonicClock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  for (unsigned int frame = 0; frame < frames; frame++) {
+    buffer->SetChannel(0, static_cast<uint8_t>(frame));
+    SendFrames(node, buffer, number_of_universes);
+    if (FLAGS_batch_transmit) {
+      // Run the loop so the batch is flushed.
+      ss->RunOnce(TimeInterval(0, 0));
+    }
+  }
+  clock.CurrentTime(&end);
+
+  TimeInterval duration = end - start;
+  uint64_t packets = static_cast<uint64_t>(frames) * number_of_universes;
+  cout << "Sent " << packets << " packets in " << duration << "s";
+  if (duration.AsInt()) {
+    cout << ", " << (packets * 1000000 / duration.AsInt()) << " packets/s";
+  }
+  cout << endl;
+}
+
 int main(int argc, char* argv[]) {
   ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
 
@@ -62,10 +101,17 @@ int main(int argc, char* argv[]) {
   output.Blackout();
   SelectServer ss;
 
-  E131Node node(&ss, "", E131Node::Options());
+  E131Node::Options options;
+  options.batch_transmit = FLAGS_batch_transmit;
+  E131Node node(&ss, "", options);
   if (!node.Start())
     return -1;
 
+  if (FLAGS_benchmark_frames) {
+    RunBenchmark(&ss, &node, &output, universes, FLAGS_benchmark_frames);
+    return 0;
+  }
+
   ss.AddReadDescriptor(node.GetSocket());
   ss.RegisterRepeatingTimeout(
       1000 / fps,
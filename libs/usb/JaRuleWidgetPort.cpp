@@ -20,6 +20,8 @@
 
 #include "libs/usb/JaRuleWidgetPort.h"
 
+#include <string.h>
+
 #include <ola/Callback.h>
 #include <ola/Constants.h>
 #include <ola/Logging.h>
@@ -52,7 +54,7 @@ __attribute__((__stdcall__))
 #endif  // _WIN32
 void InTransferCompleteHandler(struct libusb_transfer *transfer) {
   JaRuleWidgetPort *port = static_cast<JaRuleWidgetPort*>(transfer->user_data);
-  return port->_InTransferComplete();
+  return port->_InTransferComplete(transfer);
 }
 
 #ifdef _WIN32
@@ -60,7 +62,7 @@ __attribute__((__stdcall__))
 #endif  // _WIN32
 void OutTransferCompleteHandler(struct libusb_transfer *transfer) {
   JaRuleWidgetPort *port = static_cast<JaRuleWidgetPort*>(transfer->user_data);
-  return port->_OutTransferComplete();
+  return port->_OutTransferComplete(transfer);
 }
 
 }  // namespace
@@ -77,11 +79,13 @@ JaRuleWidgetPort::JaRuleWidgetPort(ola::thread::ExecutorInterface *executor,
       m_endpoint_number(endpoint_number),
       m_uid(uid),
       m_physical_port(physical_port),
-      m_handle(NULL),
-      m_out_transfer(adaptor->AllocTransfer(0)),
-      m_out_in_progress(false),
-      m_in_transfer(adaptor->AllocTransfer(0)),
-      m_in_in_progress(false) {
+      m_handle(NULL) {
+  for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+    m_out[i].transfer = adaptor->AllocTransfer(0);
+  }
+  for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+    m_in[i].transfer = adaptor->AllocTransfer(0);
+  }
 }
 
 JaRuleWidgetPort::~JaRuleWidgetPort() {
@@ -104,12 +108,16 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
 
     // Cancelling may take up to a second if the endpoint has stalled. I can't
     // really see a way to speed this up.
-    if (m_out_in_progress) {
-      m_adaptor->CancelTransfer(m_out_transfer);
+    for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+      if (m_out[i].in_progress) {
+        m_adaptor->CancelTransfer(m_out[i].transfer);
+      }
     }
 
-    if (m_in_in_progress) {
-      m_adaptor->CancelTransfer(m_in_transfer);
+    for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+      if (m_in[i].in_progress) {
+        m_adaptor->CancelTransfer(m_in[i].transfer);
+      }
     }
   }
 
@@ -118,15 +126,19 @@ JaRuleWidgetPort::~JaRuleWidgetPort() {
   while (transfers_pending) {
     // Spin waiting for the transfers to complete.
     MutexLocker locker(&m_mutex);
-    transfers_pending = m_out_in_progress || m_in_in_progress;
+    transfers_pending = TransfersInProgress();
   }
 
-  if (m_out_transfer) {
-    m_adaptor->FreeTransfer(m_out_transfer);
+  for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+    if (m_out[i].transfer) {
+      m_adaptor->FreeTransfer(m_out[i].transfer);
+    }
   }
 
-  if (m_in_transfer) {
-    m_adaptor->FreeTransfer(m_in_transfer);
+  for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+    if (m_in[i].transfer) {
+      m_adaptor->FreeTransfer(m_in[i].transfer);
+    }
   }
 }
 
@@ -227,7 +239,7 @@ void JaRuleWidgetPort::SendCommand(
   auto_ptr<PendingCommand> command(new PendingCommand(
       command_class, callback, payload));
 
-  OLA_INFO << "Adding new command " << ToHex(command_class);
+  OLA_DEBUG << "Adding new command " << ToHex(command_class);
 
   MutexLocker locker(&m_mutex);
 
@@ -244,31 +256,39 @@ void JaRuleWidgetPort::SendCommand(
   MaybeSendCommand();
 }
 
-void JaRuleWidgetPort::_OutTransferComplete() {
+void JaRuleWidgetPort::_OutTransferComplete(libusb_transfer *transfer) {
   OLA_DEBUG << "Out Command status is "
-            << LibUsbAdaptor::ErrorCodeToString(m_in_transfer->status);
-  if (m_out_transfer->status == LIBUSB_TRANSFER_COMPLETED) {
-    if (m_out_transfer->actual_length != m_out_transfer->length) {
+            << LibUsbAdaptor::ErrorCodeToString(transfer->status);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    if (transfer->actual_length != transfer->length) {
       // TODO(simon): Decide what to do here
-      OLA_WARN << "Only sent " << m_out_transfer->actual_length << " / "
-               << m_out_transfer->length << " bytes";
+      OLA_WARN << "Only sent " << transfer->actual_length << " / "
+               << transfer->length << " bytes";
     }
   }
 
   MutexLocker locker(&m_mutex);
-  m_out_in_progress = false;
+  for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+    if (m_out[i].transfer == transfer) {
+      m_out[i].in_progress = false;
+    }
+  }
   MaybeSendCommand();
 }
 
-void JaRuleWidgetPort::_InTransferComplete() {
+void JaRuleWidgetPort::_InTransferComplete(libusb_transfer *transfer) {
   OLA_DEBUG << "In transfer completed status is "
-            << LibUsbAdaptor::ErrorCodeToString(m_in_transfer->status);
+            << LibUsbAdaptor::ErrorCodeToString(transfer->status);
 
   MutexLocker locker(&m_mutex);
-  m_in_in_progress = false;
+  for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+    if (m_in[i].transfer == transfer) {
+      m_in[i].in_progress = false;
+    }
+  }
 
-  if (m_in_transfer->status == LIBUSB_TRANSFER_COMPLETED) {
-    HandleResponse(m_in_transfer->buffer, m_in_transfer->actual_length);
+  if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+    HandleResponse(transfer->buffer, transfer->actual_length);
   }
 
   PendingCommandMap::iterator iter = m_pending_commands.begin();
@@ -287,37 +307,49 @@ void JaRuleWidgetPort::_InTransferComplete() {
     }
   }
 
-  if (!m_pending_commands.empty()) {
-    SubmitInTransfer();
-  }
+  // A response frees a slot, so more commands may be sent.
+  MaybeSendCommand();
+  MaybeSubmitInTransfers();
 }
 
 void JaRuleWidgetPort::MaybeSendCommand() {
-  if (m_out_in_progress ||
-      m_pending_commands.size() > MAX_IN_FLIGHT ||
-      m_queued_commands.empty()) {
-    return;
-  }
+  for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+    if (m_pending_commands.size() >= MAX_IN_FLIGHT ||
+        m_queued_commands.empty()) {
+      break;
+    }
+    if (m_out[i].in_progress) {
+      continue;
+    }
 
-  PendingCommand *command = m_queued_commands.front();
-  m_queued_commands.pop();
+    PendingCommand *command = m_queued_commands.front();
+    m_queued_commands.pop();
+    SubmitOutTransfer(&m_out[i], command);
+  }
+  MaybeSubmitInTransfers();
+}
 
+bool JaRuleWidgetPort::SubmitOutTransfer(Transfer<OUT_BUFFER_SIZE> *transfer,
+                                         PendingCommand *command) {
   uint8_t token = m_token.Next();
   command->payload[1] = token;
+  // The transfer has its own copy of the data, since the response may
+  // arrive, and the command be deleted, before the transfer completes.
+  memcpy(transfer->buffer, command->payload.data(), command->payload.size());
   m_adaptor->FillBulkTransfer(
-      m_out_transfer, m_usb_handle, m_endpoint_number | LIBUSB_ENDPOINT_OUT,
-      const_cast<uint8_t*>(command->payload.data()),
-      command->payload.size(), OutTransferCompleteHandler,
+      transfer->transfer, m_usb_handle,
+      m_endpoint_number | LIBUSB_ENDPOINT_OUT,
+      transfer->buffer, command->payload.size(), OutTransferCompleteHandler,
       static_cast<void*>(this), ENDPOINT_TIMEOUT_MS);
 
-  int r = m_adaptor->SubmitTransfer(m_out_transfer);
+  int r = m_adaptor->SubmitTransfer(transfer->transfer);
   if (r) {
     OLA_WARN << "Failed to submit outbound transfer: "
              << LibUsbAdaptor::ErrorCodeToString(r);
     ScheduleCallback(command->callback, COMMAND_RESULT_SEND_ERROR, RC_UNKNOWN,
                      0, ByteString());
     delete command;
-    return;
+    return false;
   }
 
   m_clock.CurrentTime(&command->out_time);
@@ -331,37 +363,60 @@ void JaRuleWidgetPort::MaybeSendCommand() {
     p.first->second = command;
   }
 
-  m_out_in_progress = true;
-  if (!m_in_in_progress) {
-    SubmitInTransfer();
-  }
-  return;
+  transfer->in_progress = true;
+  return true;
 }
 
-bool JaRuleWidgetPort::SubmitInTransfer() {
-  if (m_in_in_progress) {
-    OLA_WARN << "Read already pending";
-    return true;
+void JaRuleWidgetPort::MaybeSubmitInTransfers() {
+  // Keep enough reads queued for the outstanding responses.
+  unsigned int in_progress = 0;
+  for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+    if (m_in[i].in_progress) {
+      in_progress++;
+    }
+  }
+
+  for (unsigned int i = 0;
+       i < IN_TRANSFERS && in_progress < m_pending_commands.size(); i++) {
+    if (!m_in[i].in_progress && SubmitInTransfer(&m_in[i])) {
+      in_progress++;
+    }
   }
+}
 
-  m_adaptor->FillBulkTransfer(m_in_transfer, m_usb_handle,
+bool JaRuleWidgetPort::SubmitInTransfer(Transfer<IN_BUFFER_SIZE> *transfer) {
+  m_adaptor->FillBulkTransfer(transfer->transfer, m_usb_handle,
                               m_endpoint_number | LIBUSB_ENDPOINT_IN,
-                              m_in_buffer, IN_BUFFER_SIZE,
+                              transfer->buffer, IN_BUFFER_SIZE,
                               InTransferCompleteHandler,
                               static_cast<void*>(this),
                               ENDPOINT_TIMEOUT_MS);
 
-  int r = m_adaptor->SubmitTransfer(m_in_transfer);
+  int r = m_adaptor->SubmitTransfer(transfer->transfer);
   if (r) {
     OLA_WARN << "Failed to submit input transfer: "
              << LibUsbAdaptor::ErrorCodeToString(r);
     return false;
   }
 
-  m_in_in_progress = true;
+  transfer->in_progress = true;
   return true;
 }
 
+bool JaRuleWidgetPort::TransfersInProgress() {
+  for (unsigned int i = 0; i < OUT_TRANSFERS; i++) {
+    if (m_out[i].in_progress) {
+      return true;
+    }
+  }
+  for (unsigned int i = 0; i < IN_TRANSFERS; i++) {
+    if (m_in[i].in_progress) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /*
  *
  */
@@ -394,7 +449,7 @@ void JaRuleWidgetPort::HandleResponse(const uint8_t *data, unsigned int size) {
   }
 
   // TODO(simon): Remove this.
-  if (LogLevel() >= OLA_LOG_INFO) {
+  if (LogLevel() >= OLA_LOG_DEBUG) {
     ola::strings::FormatData(&std::cerr, data, size);
   }
 
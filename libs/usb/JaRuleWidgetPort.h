@@ -43,6 +43,11 @@ namespace usb {
  *
  * Each port has its own libusb transfers as well as a command queue. This
  * avoids slow commands on one port blocking another.
+ *
+ * Commands are pipelined: up to MAX_IN_FLIGHT commands can be waiting for a
+ * response, using OUT_TRANSFERS outbound and IN_TRANSFERS inbound transfers.
+ * Responses are matched to commands by token, so they may complete in any
+ * order.
  */
 class JaRuleWidgetPort {
  public:
@@ -104,14 +109,16 @@ class JaRuleWidgetPort {
   /**
    * @brief Called by the libusb callback when the transfer completes or is
    * cancelled.
+   * @param transfer the transfer that completed.
    */
-  void _OutTransferComplete();
+  void _OutTransferComplete(libusb_transfer *transfer);
 
   /**
    * @brief Called by the libusb callback when the transfer completes or is
    * cancelled.
+   * @param transfer the transfer that completed.
    */
-  void _InTransferComplete();
+  void _InTransferComplete(libusb_transfer *transfer);
 
  private:
   // This must be a multiple of the USB packet size otherwise we can experience
@@ -119,6 +126,18 @@ class JaRuleWidgetPort {
   // to be safe.
   enum { IN_BUFFER_SIZE = 1024 };
   enum { OUT_BUFFER_SIZE = 1024 };
+  enum { OUT_TRANSFERS = 2 };
+  enum { IN_TRANSFERS = 2 };
+
+  // A libusb transfer and the buffer it uses.
+  template <unsigned int buffer_size>
+  struct Transfer {
+    Transfer() : transfer(NULL), in_progress(false) {}
+
+    libusb_transfer *transfer;
+    bool in_progress;
+    uint8_t buffer[buffer_size];
+  };
 
   // The arguments passed to the user supplied callback.
   typedef struct {
@@ -162,15 +181,16 @@ class JaRuleWidgetPort {
   CommandQueue m_queued_commands;  // GUARDED_BY(m_mutex);
   PendingCommandMap m_pending_commands;  // GUARDED_BY(m_mutex);
 
-  libusb_transfer *m_out_transfer;  // GUARDED_BY(m_mutex);
-  bool m_out_in_progress;  // GUARDED_BY(m_mutex);
-
-  uint8_t m_in_buffer[IN_BUFFER_SIZE];  // GUARDED_BY(m_mutex);
-  libusb_transfer *m_in_transfer;  // GUARDED_BY(m_mutex);
-  bool m_in_in_progress;  // GUARDED_BY(m_mutex);
+  Transfer<OUT_BUFFER_SIZE> m_out[OUT_TRANSFERS];  // GUARDED_BY(m_mutex);
+  Transfer<IN_BUFFER_SIZE> m_in[IN_TRANSFERS];  // GUARDED_BY(m_mutex);
 
   void MaybeSendCommand();  // LOCK_REQUIRED(m_mutex);
-  bool SubmitInTransfer();  // LOCK_REQUIRED(m_mutex);
+  bool SubmitOutTransfer(Transfer<OUT_BUFFER_SIZE> *transfer,
+                         PendingCommand *command);  // LOCK_REQUIRED(m_mutex);
+  void MaybeSubmitInTransfers();  // LOCK_REQUIRED(m_mutex);
+  bool SubmitInTransfer(
+      Transfer<IN_BUFFER_SIZE> *transfer);  // LOCK_REQUIRED(m_mutex);
+  bool TransfersInProgress();  // LOCK_REQUIRED(m_mutex);
   void HandleResponse(const uint8_t *data,
                       unsigned int size);  // LOCK_REQUIRED(m_mutex);
 
@@ -187,8 +207,8 @@ class JaRuleWidgetPort {
   static const unsigned int MAX_PAYLOAD_SIZE = 513;
   static const unsigned int MIN_RESPONSE_SIZE = 9;
   static const unsigned int USB_PACKET_SIZE = 64;
-  static const unsigned int MAX_IN_FLIGHT = 2;
-  static const unsigned int MAX_QUEUED_MESSAGES = 10;
+  static const unsigned int MAX_IN_FLIGHT = 8;
+  static const unsigned int MAX_QUEUED_MESSAGES = 64;
 
   static const unsigned int ENDPOINT_TIMEOUT_MS = 1000;
 
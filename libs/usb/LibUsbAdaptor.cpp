@@ -364,6 +364,77 @@ void SyncronousLibUsbAdaptor::Close(libusb_device_handle *usb_handle) {
 
 // AsyncronousLibUsbAdaptor
 // -----------------------------------------------------------------------------
+const char AsyncronousLibUsbAdaptor::TRANSFER_LATENCY_VAR[] =
+    "usb-transfer-latency-us";
+const char AsyncronousLibUsbAdaptor::TRANSFER_MAX_LATENCY_VAR[] =
+    "usb-transfer-max-latency-us";
+const char AsyncronousLibUsbAdaptor::TRANSFERS_VAR[] = "usb-transfers";
+const char AsyncronousLibUsbAdaptor::FPS_VAR[] = "usb-frames-per-second";
+
+void AsyncronousLibUsbAdaptor::SetExportMap(ola::ExportMap *export_map) {
+  ola::thread::MutexLocker locker(&m_stats_mutex);
+  if (!export_map) {
+    m_latency_map = NULL;
+    m_max_latency_map = NULL;
+    m_transfer_map = NULL;
+    m_fps_map = NULL;
+    return;
+  }
+  m_latency_map = export_map->GetUIntMapVar(TRANSFER_LATENCY_VAR, "device");
+  m_max_latency_map = export_map->GetUIntMapVar(TRANSFER_MAX_LATENCY_VAR,
+                                                "device");
+  m_transfer_map = export_map->GetUIntMapVar(TRANSFERS_VAR, "device");
+  m_fps_map = export_map->GetUIntMapVar(FPS_VAR, "device");
+}
+
+void AsyncronousLibUsbAdaptor::RecordTransferLatency(
+    libusb_device *dev,
+    const ola::TimeInterval &latency) {
+  ola::thread::MutexLocker locker(&m_stats_mutex);
+  if (!m_latency_map) {
+    return;
+  }
+  ostringstream str;
+  str << GetDeviceId(dev);
+  const string key = str.str();
+  const unsigned int latency_us = static_cast<unsigned int>(latency.AsInt());
+
+  (*m_latency_map)[key] = latency_us;
+  unsigned int &max_latency = (*m_max_latency_map)[key];
+  if (latency_us > max_latency) {
+    max_latency = latency_us;
+  }
+  m_transfer_map->Increment(key);
+}
+
+void AsyncronousLibUsbAdaptor::RecordFrame(libusb_device *dev) {
+  ola::thread::MutexLocker locker(&m_stats_mutex);
+  if (!m_fps_map) {
+    return;
+  }
+  ostringstream str;
+  str << GetDeviceId(dev);
+  const string key = str.str();
+
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  FrameCount &count = m_frame_counts[key];
+  if (count.start.IsSet()) {
+    count.frames++;
+  } else {
+    count.start = now;
+  }
+
+  // Update the rate once a second.
+  const int64_t elapsed = (now - count.start).InMilliSeconds();
+  if (elapsed >= 1000) {
+    (*m_fps_map)[key] = static_cast<unsigned int>(
+        count.frames * 1000 / elapsed);
+    count.start = now;
+    count.frames = 0;
+  }
+}
+
 bool AsyncronousLibUsbAdaptor::OpenDevice(libusb_device *usb_device,
                                           libusb_device_handle **usb_handle) {
   bool ok = Open(usb_device, usb_handle);
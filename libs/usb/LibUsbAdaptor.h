@@ -22,9 +22,13 @@
 #define LIBS_USB_LIBUSBADAPTOR_H_
 
 #include <libusb.h>
+#include <map>
 #include <string>
 
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
 #include "libs/usb/Types.h"
 
 namespace ola {
@@ -229,6 +233,20 @@ class LibUsbAdaptor {
    */
   virtual int CancelTransfer(struct libusb_transfer *transfer) = 0;
 
+  /**
+   * @brief Record how long an asynchronous transfer took to complete.
+   * @param dev the device the transfer was for.
+   * @param latency the time from submitting the transfer to the callback.
+   */
+  virtual void RecordTransferLatency(libusb_device *dev,
+                                     const ola::TimeInterval &latency) = 0;
+
+  /**
+   * @brief Record that a frame of data was sent to a device.
+   * @param dev the device the frame was sent to.
+   */
+  virtual void RecordFrame(libusb_device *dev) = 0;
+
   /**
    * @brief Wraps libusb_fill_control_setup
    * @param[out] buffer buffer to output the setup packet into
@@ -465,6 +483,11 @@ class BaseLibUsbAdaptor : public LibUsbAdaptor {
 
   int CancelTransfer(struct libusb_transfer *transfer);
 
+  void RecordTransferLatency(OLA_UNUSED libusb_device *dev,
+                             OLA_UNUSED const ola::TimeInterval &latency) {}
+
+  void RecordFrame(OLA_UNUSED libusb_device *dev) {}
+
   void FillControlSetup(unsigned char *buffer,
                         uint8_t bmRequestType,
                         uint8_t bRequest,
@@ -552,13 +575,33 @@ class SyncronousLibUsbAdaptor : public BaseLibUsbAdaptor {
  *
  * Asyncronous mode requires notifying the LibUsbThread when handles are opened
  * and closed.
+ *
+ * All the asynchronous widgets share the one adaptor, so it also keeps the
+ * per-device transfer latency stats.
  */
 class AsyncronousLibUsbAdaptor : public BaseLibUsbAdaptor {
  public:
   explicit AsyncronousLibUsbAdaptor(class LibUsbThread *thread)
-      : m_thread(thread) {
+      : m_thread(thread),
+        m_latency_map(NULL),
+        m_max_latency_map(NULL),
+        m_transfer_map(NULL),
+        m_fps_map(NULL) {
   }
 
+  /**
+   * @brief Export the transfer latency stats.
+   * @param export_map the ExportMap to use, ownership is not transferred.
+   *
+   * This must be called before any transfers are submitted.
+   */
+  void SetExportMap(ola::ExportMap *export_map);
+
+  void RecordTransferLatency(libusb_device *dev,
+                             const ola::TimeInterval &latency);
+
+  void RecordFrame(libusb_device *dev);
+
   bool OpenDevice(libusb_device *usb_device,
                   libusb_device_handle **usb_handle);
 
@@ -591,8 +634,28 @@ class AsyncronousLibUsbAdaptor : public BaseLibUsbAdaptor {
                         int *actual_length,
                         unsigned int timeout);
 
+  static const char TRANSFER_LATENCY_VAR[];
+  static const char TRANSFER_MAX_LATENCY_VAR[];
+  static const char TRANSFERS_VAR[];
+  static const char FPS_VAR[];
+
  private:
+  struct FrameCount {
+    ola::TimeStamp start;
+    unsigned int frames;
+
+    FrameCount() : frames(0) {}
+  };
+  typedef std::map<std::string, FrameCount> FrameCounts;
+
   class LibUsbThread *m_thread;
+  ola::thread::Mutex m_stats_mutex;
+  ola::UIntMap *m_latency_map;  // GUARDED_BY(m_stats_mutex)
+  ola::UIntMap *m_max_latency_map;  // GUARDED_BY(m_stats_mutex)
+  ola::UIntMap *m_transfer_map;  // GUARDED_BY(m_stats_mutex)
+  ola::UIntMap *m_fps_map;  // GUARDED_BY(m_stats_mutex)
+  FrameCounts m_frame_counts;  // GUARDED_BY(m_stats_mutex)
+  ola::Clock m_clock;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncronousLibUsbAdaptor);
 };
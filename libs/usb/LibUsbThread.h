@@ -59,7 +59,8 @@ class LibUsbThread : private ola::thread::Thread {
    * @param context the libusb context to use.
    */
   explicit LibUsbThread(libusb_context *context)
-    : m_context(context),
+    : ola::thread::Thread(ola::thread::Thread::Options("libusb")),
+      m_context(context),
       m_term(false) {
   }
 
@@ -68,7 +68,9 @@ OlaOutputPort ClientTypesFactory::OutputPortFromProtobufOut(
                        static_cast<port_priority_mode>(
                            port_info.priority_mode()),
                        port_info.priority(),
-                       port_info.supports_rdm());
+                       port_info.supports_rdm(),
+                       port_info.max_frame_rate(),
+                       port_info.skipped_frames());
 }
 
 /*
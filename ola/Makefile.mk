@@ -26,7 +26,8 @@ ola_libola_la_SOURCES = \
     ola/OlaClientCore.h \
     ola/OlaClientCore.cpp \
     ola/OlaClientWrapper.cpp \
-    ola/StreamingClient.cpp
+    ola/StreamingClient.cpp \
+    ola/ThreadedClient.cpp
 ola_libola_la_LDFLAGS = -version-info 1:1:0
 ola_libola_la_LIBADD = common/libolacommon.la
 
@@ -35,7 +36,8 @@ ola_libola_la_LIBADD = common/libolacommon.la
 test_programs += ola/OlaClientTester
 
 ola_OlaClientTester_SOURCES = ola/OlaClientWrapperTest.cpp \
-                              ola/StreamingClientTest.cpp
+                              ola/StreamingClientTest.cpp \
+                              ola/ThreadedClientTest.cpp
 ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 ola_OlaClientTester_LDADD = $(COMMON_TESTING_LIBS) \
                             $(PLUGIN_LIBS) \
@@ -62,6 +62,11 @@ void OlaClient::SetDMXCallback(RepeatableDMXCallback *callback) {
   m_core->SetDMXCallback(callback);
 }
 
+void OlaClient::SetUniverseInfoCallback(
+    UniverseInfoUpdateCallback *callback) {
+  m_core->SetUniverseInfoCallback(callback);
+}
+
 void OlaClient::ReloadPlugins(SetCallback *callback) {
   m_core->ReloadPlugins(callback);
 }
@@ -122,6 +127,13 @@ void OlaClient::SetPortPriorityOverride(unsigned int device_alias,
                                   callback);
 }
 
+void OlaClient::SetPortMaxFrameRate(unsigned int device_alias,
+                                    unsigned int port,
+                                    unsigned int max_frame_rate,
+                                    SetCallback *callback) {
+  m_core->SetPortMaxFrameRate(device_alias, port, max_frame_rate, callback);
+}
+
 void OlaClient::FetchUniverseList(UniverseListCallback *callback) {
   m_core->FetchUniverseList(callback);
 }
@@ -152,22 +164,48 @@ void OlaClient::Patch(unsigned int device_alias,
   m_core->Patch(device_alias, port, port_direction, action, universe, callback);
 }
 
+void OlaClient::PatchBatch(const vector<PatchBatchEntry> &patches,
+                           SetCallback *callback) {
+  m_core->PatchBatch(patches, callback);
+}
+
 void OlaClient::RegisterUniverse(unsigned int universe,
                                  RegisterAction register_action,
                                  SetCallback *callback) {
   m_core->RegisterUniverse(universe, register_action, callback);
 }
 
+void OlaClient::RegisterUniverse(unsigned int universe,
+                                 RegisterAction register_action,
+                                 const RegisterArgs &args,
+                                 SetCallback *callback) {
+  m_core->RegisterUniverse(universe, register_action, args, callback);
+}
+
 void OlaClient::SendDMX(unsigned int universe,
                         const DmxBuffer &data,
                         const SendDMXArgs &args) {
   m_core->SendDMX(universe, data, args);
 }
 
+void OlaClient::SendDMXBatch(const vector<DMXBatchEntry> &batch) {
+  m_core->SendDMXBatch(batch);
+}
+
 void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
 
+void OlaClient::FetchDMXBatch(const vector<unsigned int> &universes,
+                              DMXBatchCallback *callback) {
+  m_core->FetchDMXBatch(universes, callback);
+}
+
+void OlaClient::RegisterForUniverseInfo(RegisterAction register_action,
+                                        SetCallback *callback) {
+  m_core->RegisterForUniverseInfo(register_action, callback);
+}
+
 void OlaClient::RunDiscovery(unsigned int universe,
                              DiscoveryType discovery_type,
                              DiscoveryCallback *callback) {
@@ -184,6 +222,15 @@ void OlaClient::SendTimeCode(const ola::timecode::TimeCode &timecode,
   m_core->SendTimeCode(timecode, callback);
 }
 
+void OlaClient::RunTimeCode(const ola::timecode::TimeCode &start,
+                            SetCallback *callback) {
+  m_core->RunTimeCode(start, callback);
+}
+
+void OlaClient::StopTimeCode(SetCallback *callback) {
+  m_core->StopTimeCode(callback);
+}
+
 void OlaClient::RDMGet(unsigned int universe,
                        const ola::rdm::UID &uid,
                        uint16_t sub_device,
@@ -203,5 +250,9 @@ void OlaClient::RDMSet(unsigned int universe,
                        const SendRDMArgs& args) {
   m_core->RDMSet(universe, uid, sub_device, pid, data, data_length, args);
 }
+
+void OlaClient::RDMBatch(const vector<RDMBatchEntry> &requests) {
+  m_core->RDMBatch(requests);
+}
 }  // namespace client
 }  // namespace ola
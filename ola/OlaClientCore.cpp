@@ -24,6 +24,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,10 +51,12 @@ using ola::rdm::UIDSet;
 using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
 using std::auto_ptr;
+using std::map;
 using std::string;
 using std::vector;
 
 const char OlaClientCore::NOT_CONNECTED_ERROR[] = "Not connected";
+const unsigned int OlaClientCore::RDM_BATCH_SIZE;
 
 OlaClientCore::OlaClientCore(ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
@@ -123,6 +126,11 @@ void OlaClientCore::SetDMXCallback(RepeatableDMXCallback *callback) {
   m_dmx_callback.reset(callback);
 }
 
+void OlaClientCore::SetUniverseInfoCallback(
+    UniverseInfoUpdateCallback *callback) {
+  m_universe_info_callback.reset(callback);
+}
+
 void OlaClientCore::ReloadPlugins(SetCallback *callback) {
   ola::proto::PluginReloadRequest request;
   RpcController *controller = new RpcController();
@@ -328,6 +336,30 @@ void OlaClientCore::SetPortPriorityOverride(unsigned int device_alias,
   }
 }
 
+void OlaClientCore::SetPortMaxFrameRate(unsigned int device_alias,
+                                        unsigned int port,
+                                        unsigned int max_frame_rate,
+                                        SetCallback *callback) {
+  ola::proto::PortFrameRateRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_device_alias(device_alias);
+  request.set_port_id(port);
+  request.set_max_frame_rate(max_frame_rate);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SetPortMaxFrameRate(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::FetchUniverseList(UniverseListCallback *callback) {
   RpcController *controller = new RpcController();
   ola::proto::OptionalUniverseRequest request;
@@ -441,9 +473,45 @@ void OlaClientCore::Patch(unsigned int device_alias,
   }
 }
 
+void OlaClientCore::PatchBatch(const vector<PatchBatchEntry> &patches,
+                               SetCallback *callback) {
+  ola::proto::PatchPortBatchRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  vector<PatchBatchEntry>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    ola::proto::PatchPortRequest *patch = request.add_patch();
+    patch->set_universe(iter->universe);
+    patch->set_device_alias(iter->device_alias);
+    patch->set_port_id(iter->port);
+    patch->set_is_output(iter->port_direction == OUTPUT_PORT);
+    patch->set_action(
+        iter->action == PATCH ? ola::proto::PATCH : ola::proto::UNPATCH);
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->PatchPortBatch(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::RegisterUniverse(unsigned int universe,
                                      RegisterAction register_action,
                                      SetCallback *callback) {
+  RegisterUniverse(universe, register_action, RegisterArgs(), callback);
+}
+
+void OlaClientCore::RegisterUniverse(unsigned int universe,
+                                     RegisterAction register_action,
+                                     const RegisterArgs &args,
+                                     SetCallback *callback) {
   ola::proto::RegisterDmxRequest request;
   RpcController *controller = new RpcController();
   ola::proto::Ack *reply = new ola::proto::Ack();
@@ -453,6 +521,20 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
         ola::proto::UNREGISTER);
   request.set_universe(universe);
   request.set_action(action);
+  if (register_action == REGISTER) {
+    if (args.max_rate) {
+      request.set_max_rate(args.max_rate);
+    }
+    if (args.changes_only) {
+      request.set_changes_only(true);
+    }
+    if (args.start_slot) {
+      request.set_start_slot(args.start_slot);
+    }
+    if (args.slot_count) {
+      request.set_slot_count(args.slot_count);
+    }
+  }
 
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
@@ -495,6 +577,29 @@ void OlaClientCore::SendDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::SendDMXBatch(const vector<DMXBatchEntry> &batch) {
+  if (!m_connected) {
+    return;
+  }
+
+  ola::proto::DmxDataBatch request;
+  vector<DMXBatchEntry>::const_iterator iter = batch.begin();
+  for (; iter != batch.end(); ++iter) {
+    ola::proto::DmxData *data = request.add_data();
+    data->set_universe(iter->universe);
+    data->set_data(iter->data.Get());
+    data->set_priority(iter->priority);
+    if (static_cast<unsigned int>(request.data_size()) == DMX_BATCH_SIZE) {
+      m_stub->StreamDmxDataBatch(NULL, &request, NULL, NULL);
+      request.Clear();
+    }
+  }
+
+  if (request.data_size()) {
+    m_stub->StreamDmxDataBatch(NULL, &request, NULL, NULL);
+  }
+}
+
 void OlaClientCore::FetchDMX(unsigned int universe,
                              DMXCallback *callback) {
   ola::proto::UniverseRequest request;
@@ -515,6 +620,50 @@ void OlaClientCore::FetchDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::FetchDMXBatch(const vector<unsigned int> &universes,
+                                  DMXBatchCallback *callback) {
+  ola::proto::UniverseBatchRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::DmxDataBatch *reply = new ola::proto::DmxDataBatch();
+
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    request.add_universe(*iter);
+  }
+
+  if (m_connected) {
+    CompletionCallback *cb = NewSingleCallback(
+        this,
+        &OlaClientCore::HandleGetDmxBatch,
+        controller, reply, callback);
+    m_stub->GetDmxBatch(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleGetDmxBatch(controller, reply, callback);
+  }
+}
+
+void OlaClientCore::RegisterForUniverseInfo(RegisterAction register_action,
+                                            SetCallback *callback) {
+  ola::proto::UniverseInfoSubscription request;
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_action(register_action == REGISTER ? ola::proto::REGISTER :
+                     ola::proto::UNREGISTER);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->RegisterForUniverseInfo(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::RunDiscovery(unsigned int universe,
                                  DiscoveryType discovery_type,
                                  DiscoveryCallback *callback) {
@@ -588,37 +737,27 @@ void OlaClientCore::RDMSet(unsigned int universe,
                  args);
 }
 
-void OlaClientCore::SendTimeCode(const ola::timecode::TimeCode &timecode,
-                                 SetCallback *callback) {
-  if (!timecode.IsValid()) {
-    Result result("Invalid timecode");
-    OLA_WARN << "Invalid timecode: " << timecode;
-    if (callback) {
-      callback->Run(result);
-    }
+void OlaClientCore::RDMBatch(const vector<RDMBatchEntry> &requests) {
+  if (requests.empty()) {
     return;
   }
+  SendRDMBatch(new vector<RDMBatchEntry>(requests), 0);
+}
 
-  RpcController *controller = new RpcController();
-  ola::proto::TimeCode request;
-  ola::proto::Ack *reply = new ola::proto::Ack();
+void OlaClientCore::SendTimeCode(const ola::timecode::TimeCode &timecode,
+                                 SetCallback *callback) {
+  SendTimeCodeRequest(timecode, ola::proto::SEND_TIMECODE, callback);
+}
 
-  request.set_type(static_cast<ola::proto::TimeCodeType>(timecode.Type()));
-  request.set_hours(timecode.Hours());
-  request.set_minutes(timecode.Minutes());
-  request.set_seconds(timecode.Seconds());
-  request.set_frames(timecode.Frames());
+void OlaClientCore::RunTimeCode(const ola::timecode::TimeCode &start,
+                                SetCallback *callback) {
+  SendTimeCodeRequest(start, ola::proto::RUN_TIMECODE, callback);
+}
 
-  if (m_connected) {
-    CompletionCallback *cb = ola::NewSingleCallback(
-        this,
-        &OlaClientCore::HandleAck,
-        controller, reply, callback);
-    m_stub->SendTimeCode(controller, &request, reply, cb);
-  } else {
-    controller->SetFailed(NOT_CONNECTED_ERROR);
-    HandleAck(controller, reply, callback);
-  }
+void OlaClientCore::StopTimeCode(SetCallback *callback) {
+  SendTimeCodeRequest(
+      ola::timecode::TimeCode(ola::timecode::TIMECODE_SMPTE, 0, 0, 0, 0),
+      ola::proto::STOP_TIMECODE, callback);
 }
 
 void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
@@ -639,6 +778,27 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
   done->Run();
 }
 
+void OlaClientCore::UpdateUniverseInfo(
+    ola::rpc::RpcController*,
+    const ola::proto::UniverseInfoReply *request,
+    ola::proto::Ack*,
+    CompletionCallback *done) {
+  if (m_universe_info_callback.get()) {
+    UniverseInfoUpdate update;
+    update.version = request->version();
+    update.full = request->full();
+    for (int i = 0; i < request->universe_size(); ++i) {
+      update.universes.push_back(
+          ClientTypesFactory::UniverseFromProtobuf(request->universe(i)));
+    }
+    for (int i = 0; i < request->removed_universe_size(); ++i) {
+      update.removed.push_back(request->removed_universe(i));
+    }
+    m_universe_info_callback->Run(update);
+  }
+  done->Run();
+}
+
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
                                   OLA_UNUSED ola::rpc::RpcSession *session) {
   callback->Run();
@@ -886,6 +1046,26 @@ void OlaClientCore::HandleGetDmx(RpcController *controller_ptr,
   callback->Run(result, metadata, buffer);
 }
 
+void OlaClientCore::HandleGetDmxBatch(RpcController *controller_ptr,
+                                      ola::proto::DmxDataBatch *reply_ptr,
+                                      DMXBatchCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::DmxDataBatch> reply(reply_ptr);
+
+  if (!callback) {
+    return;
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  map<unsigned int, DmxBuffer> data;
+  if (!controller->Failed()) {
+    for (int i = 0; i < reply->data_size(); i++) {
+      data[reply->data(i).universe()].Set(reply->data(i).data());
+    }
+  }
+  callback->Run(result, data);
+}
+
 void OlaClientCore::HandleUIDList(RpcController *controller_ptr,
                                   ola::proto::UIDListReply *reply_ptr,
                                   DiscoveryCallback *callback) {
@@ -918,13 +1098,58 @@ void OlaClientCore::HandleRDM(RpcController *controller_ptr,
   if (!callback) {
     return;
   }
+  RunRDMCallback(*controller, reply.get(), callback);
+}
 
-  Result result(controller->Failed() ? controller->ErrorText() : "");
+void OlaClientCore::HandleRDMBatch(RpcController *controller_ptr,
+                                   ola::proto::RDMBatchResponse *reply_ptr,
+                                   vector<RDMBatchEntry> *requests,
+                                   unsigned int offset) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::RDMBatchResponse> reply(reply_ptr);
+
+  const unsigned int end = std::min(
+      static_cast<unsigned int>(requests->size()), offset + RDM_BATCH_SIZE);
+  if (!controller->Failed() &&
+      static_cast<unsigned int>(reply->response_size()) != end - offset) {
+    controller->SetFailed("Invalid RDM batch response");
+  }
+
+  if (controller->Failed()) {
+    // Fail all the remaining requests.
+    ola::proto::RDMResponse empty_reply;
+    for (unsigned int i = offset; i < requests->size(); i++) {
+      if ((*requests)[i].args.callback) {
+        RunRDMCallback(*controller, &empty_reply, (*requests)[i].args.callback);
+      }
+    }
+    delete requests;
+    return;
+  }
+
+  for (unsigned int i = offset; i < end; i++) {
+    if ((*requests)[i].args.callback) {
+      RunRDMCallback(*controller, reply->mutable_response(i - offset),
+                     (*requests)[i].args.callback);
+    }
+  }
+
+  if (end < requests->size()) {
+    SendRDMBatch(requests, end);
+  } else {
+    delete requests;
+  }
+}
+
+void OlaClientCore::RunRDMCallback(const RpcController &controller,
+                                   ola::proto::RDMResponse *reply,
+                                   RDMCallback *callback) {
+  Result result(controller.Failed() ? controller.ErrorText() : "");
   RDMMetadata metadata;
   ola::rdm::RDMResponse *response = NULL;
 
-  if (!controller->Failed()) {
-    response = BuildRDMResponse(reply.get(), &metadata.response_code);
+  if (!controller.Failed()) {
+    response = BuildRDMResponse(reply, &metadata.response_code);
     for (int i = 0; i < reply->raw_frame_size(); i++) {
       const ola::proto::RDMFrame &proto_frame = reply->raw_frame(i);
 
@@ -1004,6 +1229,9 @@ void OlaClientCore::SendRDMCommand(bool is_set,
   if (args.include_raw_frames) {
     request.set_include_raw_response(true);
   }
+  if (args.bulk) {
+    request.set_bulk(true);
+  }
 
   CompletionCallback *cb = NewSingleCallback(
       this,
@@ -1013,6 +1241,85 @@ void OlaClientCore::SendRDMCommand(bool is_set,
   m_stub->RDMCommand(controller, &request, reply, cb);
 }
 
+/*
+ * Send up to RDM_BATCH_SIZE requests, starting from offset.
+ */
+void OlaClientCore::SendRDMBatch(vector<RDMBatchEntry> *requests,
+                                 unsigned int offset) {
+  RpcController *controller = new RpcController();
+  ola::proto::RDMBatchResponse *reply = new ola::proto::RDMBatchResponse();
+
+  if (!m_connected) {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleRDMBatch(controller, reply, requests, offset);
+    return;
+  }
+
+  const unsigned int end = std::min(
+      static_cast<unsigned int>(requests->size()), offset + RDM_BATCH_SIZE);
+  ola::proto::RDMBatchRequest request;
+  for (unsigned int i = offset; i < end; i++) {
+    const RDMBatchEntry &entry = (*requests)[i];
+    ola::proto::RDMRequest *rdm_request = request.add_request();
+    rdm_request->set_universe(entry.universe);
+    ola::proto::UID *pb_uid = rdm_request->mutable_uid();
+    pb_uid->set_esta_id(entry.uid.ManufacturerId());
+    pb_uid->set_device_id(entry.uid.DeviceId());
+    rdm_request->set_sub_device(entry.sub_device);
+    rdm_request->set_param_id(entry.pid);
+    rdm_request->set_is_set(entry.is_set);
+    rdm_request->set_data(entry.data);
+    if (entry.args.include_raw_frames) {
+      rdm_request->set_include_raw_response(true);
+    }
+  }
+
+  CompletionCallback *cb = NewSingleCallback(
+      this,
+      &OlaClientCore::HandleRDMBatch,
+      controller, reply, requests, offset);
+  m_stub->RDMBatchCommand(controller, &request, reply, cb);
+}
+
+/*
+ * Send a TimeCode request, with the action for olad to take.
+ */
+void OlaClientCore::SendTimeCodeRequest(
+    const ola::timecode::TimeCode &timecode,
+    ola::proto::TimeCodeAction action,
+    SetCallback *callback) {
+  if (!timecode.IsValid()) {
+    Result result("Invalid timecode");
+    OLA_WARN << "Invalid timecode: " << timecode;
+    if (callback) {
+      callback->Run(result);
+    }
+    return;
+  }
+
+  RpcController *controller = new RpcController();
+  ola::proto::TimeCode request;
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_type(static_cast<ola::proto::TimeCodeType>(timecode.Type()));
+  request.set_hours(timecode.Hours());
+  request.set_minutes(timecode.Minutes());
+  request.set_seconds(timecode.Seconds());
+  request.set_frames(timecode.Frames());
+  request.set_action(action);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SendTimeCode(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
 /**
  * This constructs a ola::rdm::RDMResponse object from the information in a
  * ola::proto::RDMResponse.
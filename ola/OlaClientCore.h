@@ -23,6 +23,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -74,6 +75,15 @@ class OlaClientCore: public ola::proto::OlaClientService {
    */
   void SetDMXCallback(RepeatableDMXCallback *callback);
 
+  /**
+   * @brief Set the callback to be run when olad pushes a change to the
+   * universes.
+   * @param callback the callback to run, ownership is transferred.
+   *
+   * Call RegisterForUniverseInfo() to start receiving changes.
+   */
+  void SetUniverseInfoCallback(UniverseInfoUpdateCallback *callback);
+
   /**
    * @brief Trigger a plugin reload.
    * @param callback the SetCallback to invoke upon completion.
@@ -175,6 +185,19 @@ class OlaClientCore: public ola::proto::OlaClientService {
                                uint8_t value,
                                SetCallback *callback);
 
+  /**
+   * @brief Limit the rate that DMX is written to an output port.
+   * @param device_alias the device containing the port to change
+   * @param port the port id of the output port to change.
+   * @param max_frame_rate the maximum rate in frames per second, or 0 to
+   *   remove the limit.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetPortMaxFrameRate(unsigned int device_alias,
+                           unsigned int port,
+                           unsigned int max_frame_rate,
+                           SetCallback *callback);
+
   /**
    * @brief Request a list of universes.
    * @param callback the UniverseListCallback to invoke upon completion.
@@ -225,6 +248,17 @@ class OlaClientCore: public ola::proto::OlaClientService {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Patch or unpatch a list of ports in one request.
+   * @param patches the changes to make, in order.
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * The changes are made as a single transaction: if any of them fail, olad
+   * puts back the ports it's already changed and the callback gets an error.
+   */
+  void PatchBatch(const std::vector<PatchBatchEntry> &patches,
+                  SetCallback *callback);
+
   /**
    * @brief Register our interest in a universe. The callback set by
    * SetDMXCallback() will be called when new DMX data arrives.
@@ -236,6 +270,19 @@ class OlaClientCore: public ola::proto::OlaClientService {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Register our interest in a universe, with options to limit the
+   * updates sent.
+   * @param universe the id of the universe to register for.
+   * @param register_action the action (register or unregister)
+   * @param args the RegisterArgs to use for this call.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void RegisterUniverse(unsigned int universe,
+                        RegisterAction register_action,
+                        const RegisterArgs &args,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -246,6 +293,16 @@ class OlaClientCore: public ola::proto::OlaClientService {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Send DMX data for many universes at once.
+   * @param batch the universes to send.
+   *
+   * The data is streamed to olad in as few messages as possible, without
+   * waiting for an acknowledgement. Versions of olad that predate this method
+   * ignore the data.
+   */
+  void SendDMXBatch(const std::vector<DMXBatchEntry> &batch);
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -253,6 +310,25 @@ class OlaClientCore: public ola::proto::OlaClientService {
    */
   void FetchDMX(unsigned int universe, DMXCallback *callback);
 
+  /**
+   * @brief Fetch the latest DMX data for several universes in one request.
+   * @param universes the universe ids to get data for.
+   * @param callback the DMXBatchCallback to invoke upon completion.
+   */
+  void FetchDMXBatch(const std::vector<unsigned int> &universes,
+                     DMXBatchCallback *callback);
+
+  /**
+   * @brief Register to have changes to the universes pushed to the
+   * UniverseInfoUpdateCallback.
+   * @param register_action the action (register or unregister)
+   * @param callback the SetCallback to invoke upon completion.
+   *
+   * The first update after registering lists every universe.
+   */
+  void RegisterForUniverseInfo(RegisterAction register_action,
+                               SetCallback *callback);
+
   /**
    * @brief Trigger discovery for a universe.
    * @param universe the universe id to run discovery on.
@@ -306,6 +382,17 @@ class OlaClientCore: public ola::proto::OlaClientService {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send a list of RDM Get and Set Commands.
+   * @param requests the requests to send. The callback for each request is
+   *   run once it completes.
+   *
+   * This avoids waiting a full round trip between each request. The requests
+   * are sent to olad in batches; the callbacks for a batch are run once all
+   * of the requests in it have completed.
+   */
+  void RDMBatch(const std::vector<RDMBatchEntry> &requests);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
@@ -314,6 +401,20 @@ class OlaClientCore: public ola::proto::OlaClientService {
   void SendTimeCode(const ola::timecode::TimeCode &timecode,
                     SetCallback *callback);
 
+  /**
+   * @brief Start olad's timecode generator.
+   * @param start The first frame, olad counts the frames from this.
+   * @param callback the SetCallback to invoke when the request completes.
+   */
+  void RunTimeCode(const ola::timecode::TimeCode &start,
+                   SetCallback *callback);
+
+  /**
+   * @brief Stop olad's timecode generator.
+   * @param callback the SetCallback to invoke when the request completes.
+   */
+  void StopTimeCode(SetCallback *callback);
+
   /**
    * @brief This is called by the channel when new DMX data arrives.
    */
@@ -322,9 +423,18 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::Ack* response,
                      CompletionCallback* done);
 
+  /**
+   * @brief This is called by the channel when olad pushes a universe change.
+   */
+  void UpdateUniverseInfo(ola::rpc::RpcController* controller,
+                          const ola::proto::UniverseInfoReply* request,
+                          ola::proto::Ack* response,
+                          CompletionCallback* done);
+
  private:
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
+  std::auto_ptr<UniverseInfoUpdateCallback> m_universe_info_callback;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
@@ -401,6 +511,13 @@ class OlaClientCore: public ola::proto::OlaClientService {
                     ola::proto::DmxData *reply,
                     DMXCallback *callback);
 
+  /**
+   * @brief Called when a GetDmxBatch() request completes.
+   */
+  void HandleGetDmxBatch(ola::rpc::RpcController *controller,
+                         ola::proto::DmxDataBatch *reply,
+                         DMXBatchCallback *callback);
+
   /**
    * @brief Called when a RunDiscovery() request completes.
    */
@@ -415,6 +532,14 @@ class OlaClientCore: public ola::proto::OlaClientService {
                  ola::proto::RDMResponse *reply,
                  RDMCallback *callback);
 
+  /**
+   * @brief Called when a batch of RDM requests completes.
+   */
+  void HandleRDMBatch(ola::rpc::RpcController *controller,
+                      ola::proto::RDMBatchResponse *reply,
+                      std::vector<RDMBatchEntry> *requests,
+                      unsigned int offset);
+
   /**
    * @brief Fetch a list of candidate ports, with or without a universe
    */
@@ -434,6 +559,26 @@ class OlaClientCore: public ola::proto::OlaClientService {
                       unsigned int data_length,
                       const SendRDMArgs &args);
 
+  /**
+   * @brief Sends the next batch of RDM commands to the server.
+   */
+  void SendRDMBatch(std::vector<RDMBatchEntry> *requests,
+                    unsigned int offset);
+
+  /**
+   * @brief Sends a TimeCode request to the server.
+   */
+  void SendTimeCodeRequest(const ola::timecode::TimeCode &timecode,
+                           ola::proto::TimeCodeAction action,
+                           SetCallback *callback);
+
+  /**
+   * @brief Runs the callback for an RDM request.
+   */
+  void RunRDMCallback(const ola::rpc::RpcController &controller,
+                      ola::proto::RDMResponse *reply,
+                      RDMCallback *callback);
+
   /**
    * @brief Builds a RDMResponse from the server's RDM reply message.
    */
@@ -442,6 +587,10 @@ class OlaClientCore: public ola::proto::OlaClientService {
       ola::rdm::RDMStatusCode *status_code);
 
   static const char NOT_CONNECTED_ERROR[];
+  static const unsigned int RDM_BATCH_SIZE = 256;
+  // The most universes sent in one StreamDmxDataBatch message, this keeps
+  // the message well below RpcChannel::MAX_BUFFER_SIZE.
+  static const unsigned int DMX_BATCH_SIZE = 1024;
 
   DISALLOW_COPY_AND_ASSIGN(OlaClientCore);
 };
@@ -18,6 +18,7 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <unistd.h>
 #include <ola/AutoStart.h>  // NOLINT(build/include)
 // ola/StreamingClient.h deprecated
 #include <ola/Callback.h>
@@ -25,23 +26,63 @@
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/client/StreamingClient.h>
+#include <ola/dmx/DmxSharedMemory.h>
 #include <ola/io/SelectServer.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/SocketAddress.h>
 #include <ola/network/TCPSocket.h>
+#include <ola/thread/CallbackThread.h>
+#include <ola/thread/Mutex.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
 
 namespace ola {
 namespace client {
 
+using ola::dmx::DmxSharedMemory;
 using ola::io::SelectServer;
 using ola::network::TCPSocket;
 using ola::proto::OlaServerService_Stub;
 using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using ola::thread::MutexLocker;
+using std::string;
+
+const unsigned int StreamingClient::MAX_BATCH_SIZE;
+const unsigned int StreamingClient::CONGESTED_RETRY_MS;
+
+namespace {
+/*
+ * The state of the RegisterSharedMemory call. If olad doesn't reply in time
+ * this is abandoned, and deleted if the reply turns up later.
+ */
+struct SharedMemoryRegistration {
+  SharedMemoryRegistration() : complete(false), abandoned(false) {}
+
+  RpcController controller;
+  ola::proto::Ack reply;
+  bool complete;
+  bool abandoned;
+};
+
+void RegistrationComplete(SharedMemoryRegistration *registration) {
+  if (registration->abandoned) {
+    delete registration;
+  } else {
+    registration->complete = true;
+  }
+}
+
+// How long to wait for olad to map the shared memory, in 100ms steps.
+const unsigned int REGISTRATION_TIMEOUT_STEPS = 10;
+}  // namespace
 
 StreamingClient::StreamingClient(bool auto_start)
     : m_auto_start(auto_start),
@@ -50,7 +91,13 @@ StreamingClient::StreamingClient(bool auto_start)
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shared_memory_slots(0),
+      m_shared_memory(NULL),
+      m_async(false),
+      m_drop_policy(DROP_OLDEST),
+      m_send_thread(NULL),
+      m_drain_scheduled(false) {
 }
 
 StreamingClient::StreamingClient(const Options &options)
@@ -60,7 +107,13 @@ StreamingClient::StreamingClient(const Options &options)
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
-      m_socket_closed(false) {
+      m_socket_closed(false),
+      m_shared_memory_slots(options.shared_memory_slots),
+      m_shared_memory(NULL),
+      m_async(options.async),
+      m_drop_policy(options.drop_policy),
+      m_send_thread(NULL),
+      m_drain_scheduled(false) {
 }
 
 StreamingClient::~StreamingClient() {
@@ -105,26 +158,67 @@ bool StreamingClient::Setup() {
   m_channel->SetChannelCloseHandler(
       NewSingleCallback(this, &StreamingClient::ChannelClosed));
 
+  m_socket_closed = false;
+  if (m_shared_memory_slots) {
+    SetupSharedMemory();
+  }
+
+  if (m_async) {
+    // The I/O thread can't block on the socket, so anything it won't accept
+    // straight away is queued and written once the socket is writable.
+    m_channel->EnableWriteQueue(m_ss);
+    m_async_stats = AsyncStats();
+    m_send_thread = new ola::thread::CallbackThread(
+        NewSingleCallback(m_ss, &SelectServer::Run),
+        ola::thread::Thread::Options("ola-streaming"));
+    if (!m_send_thread->Start()) {
+      OLA_WARN << "Failed to start the StreamingClient I/O thread";
+      delete m_send_thread;
+      m_send_thread = NULL;
+      Stop();
+      return false;
+    }
+  }
   return true;
 }
 
 void StreamingClient::Stop() {
+  StopSendThread();
+
+  if (m_shared_memory) {
+    delete m_shared_memory;
+  }
+  m_shared_memory = NULL;
+  m_universe_slots.clear();
+
   if (m_stub)
     delete m_stub;
 
   if (m_channel)
     delete m_channel;
 
+  m_stub = NULL;
+  m_channel = NULL;
+
+  // This runs any callbacks queued before the I/O thread stopped, which
+  // check m_channel.
   if (m_ss)
     delete m_ss;
 
   if (m_socket)
     delete m_socket;
 
-  m_channel = NULL;
   m_socket = NULL;
   m_ss = NULL;
-  m_stub = NULL;
+
+  MutexLocker lock(&m_mutex);
+  m_mailbox.clear();
+  m_drain_scheduled = false;
+}
+
+StreamingClient::AsyncStats StreamingClient::GetAsyncStats() const {
+  MutexLocker lock(&m_mutex);
+  return m_async_stats;
 }
 
 bool StreamingClient::SendDmx(unsigned int universe,
@@ -138,8 +232,57 @@ bool StreamingClient::SendDMX(unsigned int universe,
   return Send(universe, args.priority, data);
 }
 
-bool StreamingClient::Send(unsigned int universe, uint8_t priority,
-                           const DmxBuffer &data) {
+bool StreamingClient::SendDmxBatch(const DmxBatch &batch) {
+  if (m_async) {
+    if (IsClosed()) {
+      return false;
+    }
+    MutexLocker lock(&m_mutex);
+    DmxBatch::const_iterator iter = batch.begin();
+    for (; iter != batch.end(); ++iter) {
+      QueueFrame(iter->universe, iter->priority, iter->data);
+    }
+    ScheduleDrain();
+    return true;
+  }
+
+  if (!CheckConnection()) {
+    return false;
+  }
+
+  ola::proto::DmxDataBatch request;
+  DmxBatch::const_iterator iter = batch.begin();
+  for (; iter != batch.end() && !m_socket_closed; ++iter) {
+    if (m_shared_memory &&
+        SendSharedMemory(iter->universe, iter->priority, iter->data)) {
+      continue;
+    }
+
+    ola::proto::DmxData *data = request.add_data();
+    data->set_universe(iter->universe);
+    data->set_data(iter->data.Get());
+    data->set_priority(iter->priority);
+    if (static_cast<unsigned int>(request.data_size()) == MAX_BATCH_SIZE) {
+      m_stub->StreamDmxDataBatch(NULL, &request, NULL, NULL);
+      request.Clear();
+    }
+  }
+
+  if (request.data_size() && !m_socket_closed) {
+    m_stub->StreamDmxDataBatch(NULL, &request, NULL, NULL);
+  }
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Check if the connection to olad is still up.
+ */
+bool StreamingClient::CheckConnection() {
   if (!m_stub || !m_socket->ValidReadDescriptor())
     return false;
 
@@ -153,22 +296,247 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
     Stop();
     return false;
   }
+  return true;
+}
+
+bool StreamingClient::Send(unsigned int universe, uint8_t priority,
+                           const DmxBuffer &data) {
+  if (m_async) {
+    if (IsClosed()) {
+      return false;
+    }
+    MutexLocker lock(&m_mutex);
+    QueueFrame(universe, priority, data);
+    ScheduleDrain();
+    return true;
+  }
+
+  if (!CheckConnection()) {
+    return false;
+  }
+
+  SendFrame(universe, priority, data);
+
+  if (m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Write a frame to shared memory if there's a slot for it, otherwise send it
+ * as a message.
+ */
+void StreamingClient::SendFrame(unsigned int universe, uint8_t priority,
+                                const DmxBuffer &data) {
+  if (m_shared_memory && SendSharedMemory(universe, priority, data)) {
+    return;
+  }
 
   ola::proto::DmxData request;
   request.set_universe(universe);
   request.set_data(data.Get());
   request.set_priority(priority);
   m_stub->StreamDmxData(NULL, &request, NULL, NULL);
+}
 
-  if (m_socket_closed) {
+/*
+ * In async mode, check if the I/O thread has seen the connection close. If
+ * so the client is stopped, as the synchronous path does.
+ */
+bool StreamingClient::IsClosed() {
+  if (!m_send_thread) {
+    return true;
+  }
+
+  bool closed;
+  {
+    MutexLocker lock(&m_mutex);
+    closed = m_socket_closed;
+  }
+  if (closed) {
     Stop();
+  }
+  return closed;
+}
+
+/*
+ * Put a frame in the mailbox, m_mutex must be held.
+ */
+void StreamingClient::QueueFrame(unsigned int universe, uint8_t priority,
+                                 const DmxBuffer &data) {
+  m_async_stats.frames_queued++;
+  Mailbox::iterator iter = m_mailbox.find(universe);
+  if (iter == m_mailbox.end()) {
+    iter = m_mailbox.insert(
+        Mailbox::value_type(universe, PendingFrame())).first;
+  } else {
+    m_async_stats.frames_dropped++;
+    if (m_drop_policy == DROP_NEWEST) {
+      return;
+    }
+  }
+
+  iter->second.priority = priority;
+  iter->second.data = data;
+  m_clock.CurrentTime(&iter->second.queued);
+}
+
+/*
+ * Wake the I/O thread, if it isn't already due to drain the mailbox. m_mutex
+ * must be held.
+ */
+void StreamingClient::ScheduleDrain() {
+  if (m_drain_scheduled || m_mailbox.empty()) {
+    return;
+  }
+  m_drain_scheduled = true;
+  m_ss->Execute(NewSingleCallback(this, &StreamingClient::DrainMailbox));
+}
+
+/*
+ * Called in the I/O thread to send everything in the mailbox. While the RPC
+ * channel is congested, frames stay in the mailbox so newer ones can replace
+ * them, rather than piling up in the write queue.
+ */
+void StreamingClient::DrainMailbox() {
+  if (!m_channel) {
+    return;  // we're being stopped
+  }
+
+  if (m_channel->Congested()) {
+    m_ss->RegisterSingleTimeout(
+        CONGESTED_RETRY_MS,
+        NewSingleCallback(this, &StreamingClient::DrainMailbox));
+    return;
+  }
+
+  Mailbox frames;
+  {
+    MutexLocker lock(&m_mutex);
+    frames.swap(m_mailbox);
+    m_drain_scheduled = false;
+  }
+
+  uint64_t sent = 0;
+  uint64_t max_latency = 0;
+  uint64_t total_latency = 0;
+  ola::TimeStamp now;
+  Mailbox::const_iterator iter = frames.begin();
+  for (; iter != frames.end() && !m_socket_closed; ++iter) {
+    SendFrame(iter->first, iter->second.priority, iter->second.data);
+    m_clock.CurrentTime(&now);
+    uint64_t latency = (now - iter->second.queued).AsInt();
+    max_latency = std::max(max_latency, latency);
+    total_latency += latency;
+    sent++;
+  }
+
+  MutexLocker lock(&m_mutex);
+  m_async_stats.frames_sent += sent;
+  m_async_stats.max_send_latency_us = std::max(
+      m_async_stats.max_send_latency_us, max_latency);
+  m_async_stats.total_send_latency_us += total_latency;
+}
+
+/*
+ * Stop the I/O thread, if it's running.
+ */
+void StreamingClient::StopSendThread() {
+  if (!m_send_thread) {
+    return;
+  }
+  // Terminate() needs to be called from within the loop, otherwise it's a
+  // no-op if the thread hasn't reached SelectServer::Run() yet.
+  m_ss->Execute(NewSingleCallback(m_ss, &SelectServer::Terminate));
+  m_send_thread->Join();
+  delete m_send_thread;
+  m_send_thread = NULL;
+}
+
+/*
+ * Create a shared memory segment and ask olad to map it. If this fails we
+ * carry on sending messages.
+ */
+void StreamingClient::SetupSharedMemory() {
+  static unsigned int segment_count = 0;
+  std::ostringstream name;
+  name << DmxSharedMemory::NAME_PREFIX << getpid() << "-" << segment_count++;
+
+  DmxSharedMemory *memory = DmxSharedMemory::Create(name.str(),
+                                                    m_shared_memory_slots);
+  if (!memory) {
+    return;
+  }
+
+  SharedMemoryRegistration *registration = new SharedMemoryRegistration();
+  ola::proto::SharedMemoryRequest request;
+  request.set_name(memory->Name());
+  m_socket_closed = false;
+  m_stub->RegisterSharedMemory(
+      &registration->controller, &request, &registration->reply,
+      NewSingleCallback(RegistrationComplete, registration));
+
+  for (unsigned int i = 0;
+       i < REGISTRATION_TIMEOUT_STEPS && !registration->complete &&
+       !m_socket_closed;
+       i++) {
+    m_ss->RunOnce(ola::TimeInterval(0, 100000));
+  }
+
+  // olad has the segment mapped (or never will), so the name can go.
+  memory->Unlink();
+  if (!registration->complete) {
+    OLA_WARN << "Timed out registering shared memory, sending messages instead";
+    registration->abandoned = true;
+    delete memory;
+  } else if (registration->controller.Failed()) {
+    OLA_WARN << "olad couldn't use shared memory, sending messages instead: "
+             << registration->controller.ErrorText();
+    delete registration;
+    delete memory;
+  } else {
+    OLA_INFO << "Sending DMX through shared memory " << memory->Name();
+    delete registration;
+    m_shared_memory = memory;
+  }
+}
+
+/*
+ * Write the frame to shared memory.
+ * @returns false if there are no free slots for this universe.
+ */
+bool StreamingClient::SendSharedMemory(unsigned int universe,
+                                       uint8_t priority,
+                                       const DmxBuffer &data) {
+  std::map<unsigned int, unsigned int>::const_iterator iter =
+      m_universe_slots.find(universe);
+  unsigned int slot;
+  if (iter != m_universe_slots.end()) {
+    slot = iter->second;
+  } else if (m_universe_slots.size() < m_shared_memory->SlotCount()) {
+    slot = m_universe_slots.size();
+    m_universe_slots[universe] = slot;
+  } else {
     return false;
   }
+
+  m_shared_memory->Write(slot, universe, priority, data);
+  // If the doorbell was already set, olad hasn't processed the last
+  // notification yet and will pick this frame up along with it.
+  if (m_shared_memory->RingDoorbell()) {
+    ola::proto::SharedMemoryNotification notification;
+    m_stub->SharedMemoryUpdated(NULL, &notification, NULL, NULL);
+  }
   return true;
 }
 
 void StreamingClient::ChannelClosed(OLA_UNUSED ola::rpc::RpcSession *session) {
-  m_socket_closed = true;
+  {
+    MutexLocker lock(&m_mutex);
+    m_socket_closed = true;
+  }
   OLA_WARN << "The RPC socket has been closed, this is more than likely due"
     << " to a framing error, perhaps you're sending too fast?";
 }
@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <string>
 #include <memory>
 
@@ -29,6 +30,7 @@
 #include "ola/network/SocketAddress.h"
 #include "ola/testing/TestUtils.h"
 #include "ola/thread/Thread.h"
+#include "ola/util/Trace.h"
 #include "olad/OlaDaemon.h"
 
 DECLARE_uint16(rpc_port);
@@ -45,12 +47,18 @@ using std::auto_ptr;
 class StreamingClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(StreamingClientTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSendDMXSharedMemory);
+  CPPUNIT_TEST(testSendDmxBatch);
+  CPPUNIT_TEST(testSendDMXAsync);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void setUp();
     void tearDown();
     void testSendDMX();
+    void testSendDMXSharedMemory();
+    void testSendDmxBatch();
+    void testSendDMXAsync();
 
  private:
     class OlaServerThread *m_server_thread;
@@ -94,6 +102,15 @@ bool OlaServerThread::Setup() {
   ola_options.http_enable_quit = false;
   ola_options.http_port = 0;
   ola_options.http_data_dir = "";
+  ola_options.load_pid_store = true;
+  ola_options.trace_events = ola::DEFAULT_TRACE_EVENTS;
+  ola_options.dmx_buffer_pool_size = 0;
+  ola_options.output_tick_ms = 0;
+  ola_options.loop_cpu = -1;
+  ola_options.timecode_shared_memory = false;
+  ola_options.timecode_freewheel_ms = 0;
+  ola_options.dmx_snapshot_file = "";
+  ola_options.universe_shared_memory_slots = 0;
 
   // pick an unused port
   auto_ptr<OlaDaemon> olad(new OlaDaemon(ola_options, NULL));
@@ -221,3 +238,152 @@ void StreamingClientTest::testSendDMX() {
 
   OLA_ASSERT_FALSE(ola_client.Setup());
 }
+
+
+/*
+ * Check that sending through shared memory works, including falling back to
+ * messages once all the slots are in use.
+ */
+void StreamingClientTest::testSendDMXSharedMemory() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  options.shared_memory_slots = 2;
+  StreamingClient ola_client(options);
+
+  ola::DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+    OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE + 1, buffer));
+    OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE + 2, buffer));
+  }
+  ola_client.Stop();
+
+  // Now Terminate the server mid flight
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+
+  OLA_ASSERT_FALSE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+  ola_client.Stop();
+}
+
+
+/*
+ * Check that the SendDmxBatch method works, with and without shared memory.
+ */
+void StreamingClientTest::testSendDmxBatch() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  StreamingClient ola_client(options);
+
+  ola::DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  StreamingClient::DmxBatch batch;
+  for (unsigned int i = 0; i < 4; i++) {
+    batch.push_back(StreamingClient::BatchEntry(TEST_UNIVERSE + i, buffer));
+  }
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  OLA_ASSERT_TRUE(ola_client.SendDmxBatch(batch));
+  OLA_ASSERT_TRUE(ola_client.SendDmxBatch(StreamingClient::DmxBatch()));
+  ola_client.Stop();
+
+  // Half the universes go through shared memory
+  options.shared_memory_slots = 2;
+  StreamingClient shm_client(options);
+  OLA_ASSERT_TRUE(shm_client.Setup());
+  OLA_ASSERT_TRUE(shm_client.SendDmxBatch(batch));
+
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+  OLA_ASSERT_FALSE(shm_client.SendDmxBatch(batch));
+  shm_client.Stop();
+}
+
+
+/*
+ * Wait for the I/O thread to deal with all the frames that have been queued.
+ */
+static ola::client::StreamingClient::AsyncStats WaitForAsync(
+    const StreamingClient &client) {
+  ola::client::StreamingClient::AsyncStats stats = client.GetAsyncStats();
+  for (unsigned int i = 0; i < 200; i++) {
+    if (stats.frames_sent + stats.frames_dropped == stats.frames_queued) {
+      break;
+    }
+    usleep(10000);
+    stats = client.GetAsyncStats();
+  }
+  return stats;
+}
+
+
+/*
+ * Check that async mode works, with both drop policies.
+ */
+void StreamingClientTest::testSendDMXAsync() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  options.async = true;
+
+  ola::DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  StreamingClient::DmxBatch batch;
+  for (unsigned int i = 0; i < 4; i++) {
+    batch.push_back(StreamingClient::BatchEntry(TEST_UNIVERSE + i, buffer));
+  }
+
+  StreamingClient ola_client(options);
+  // Nothing is sent before Setup()
+  OLA_ASSERT_FALSE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  for (unsigned int i = 0; i < 100; i++) {
+    OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+  }
+  OLA_ASSERT_TRUE(ola_client.SendDmxBatch(batch));
+
+  StreamingClient::AsyncStats stats = WaitForAsync(ola_client);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(104), stats.frames_queued);
+  OLA_ASSERT_EQ(stats.frames_queued, stats.frames_sent + stats.frames_dropped);
+  OLA_ASSERT_TRUE(stats.frames_sent >= 4);
+  OLA_ASSERT_TRUE(stats.max_send_latency_us * stats.frames_sent >=
+                  stats.total_send_latency_us);
+  ola_client.Stop();
+
+  // The stats are reset by Setup()
+  options.drop_policy = StreamingClient::DROP_NEWEST;
+  options.shared_memory_slots = 2;
+  StreamingClient shm_client(options);
+  OLA_ASSERT_TRUE(shm_client.Setup());
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_ASSERT_TRUE(shm_client.SendDmxBatch(batch));
+  }
+  stats = WaitForAsync(shm_client);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(40), stats.frames_queued);
+  OLA_ASSERT_EQ(stats.frames_queued, stats.frames_sent + stats.frames_dropped);
+
+  // Once the server has gone, the I/O thread notices the connection close.
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+  bool sent = true;
+  for (unsigned int i = 0; i < 200 && sent; i++) {
+    sent = shm_client.SendDmx(TEST_UNIVERSE + 3, buffer);
+    usleep(10000);
+  }
+  OLA_ASSERT_FALSE(sent);
+  OLA_ASSERT_FALSE(shm_client.SendDmx(TEST_UNIVERSE, buffer));
+}
@@ -0,0 +1,329 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadedClient.cpp
+ * An OLA client that can be used from many threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/AutoStart.h>  // NOLINT(build/include)
+#include <ola/Callback.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/client/OlaClient.h>
+#include <ola/client/ThreadedClient.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/SocketAddress.h>
+#include <ola/network/TCPSocket.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/CallbackThread.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace client {
+
+using ola::io::SelectServer;
+using ola::network::TCPSocket;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using std::vector;
+
+namespace {
+/*
+ * Run an RDM callback on the executor, with copies of the result, metadata
+ * and response since the originals are gone by then.
+ */
+void RunRDMCallback(RDMCallback *callback, Result *result,
+                    RDMMetadata *metadata, RDMResponse *response) {
+  callback->Run(*result, *metadata, response);
+  delete result;
+  delete metadata;
+  delete response;
+}
+}  // namespace
+
+const char ThreadedClient::NOT_CONNECTED[] = "Not connected to olad";
+
+ThreadedClient::ThreadedClient(const Options &options)
+    : m_options(options),
+      m_thread(NULL),
+      m_connected(0),
+      m_frames_dropped(0) {
+  vector<unsigned int>::const_iterator iter = m_options.universes.begin();
+  for (; iter != m_options.universes.end(); ++iter) {
+    if (!STLContains(m_mailboxes, *iter)) {
+      m_mailboxes[*iter] = new Mailbox(*iter);
+    }
+  }
+}
+
+ThreadedClient::~ThreadedClient() {
+  Stop();
+  STLDeleteValues(&m_mailboxes);
+}
+
+bool ThreadedClient::Setup() {
+  if (m_thread) {
+    return false;
+  }
+
+  if (m_options.auto_start) {
+    m_socket.reset(ola::client::ConnectToServer(m_options.server_port));
+  } else {
+    m_socket.reset(TCPSocket::Connect(
+        ola::network::IPV4SocketAddress(ola::network::IPV4Address::Loopback(),
+                                        m_options.server_port)));
+  }
+  if (!m_socket.get()) {
+    return false;
+  }
+  m_socket->SetNoDelay();
+
+  m_ss.reset(new SelectServer());
+  m_client.reset(new OlaClient(m_socket.get()));
+  if (!m_ss->AddReadDescriptor(m_socket.get()) || !m_client->Setup()) {
+    Cleanup();
+    return false;
+  }
+  m_client->SetCloseHandler(NewSingleCallback(this, &ThreadedClient::Closed));
+  __sync_lock_test_and_set(&m_connected, 1);
+
+  m_thread = new ola::thread::CallbackThread(
+      NewSingleCallback(m_ss.get(), &SelectServer::Run),
+      ola::thread::Thread::Options("ola-threaded"));
+  if (!m_thread->Start()) {
+    OLA_WARN << "Failed to start the ThreadedClient I/O thread";
+    delete m_thread;
+    m_thread = NULL;
+    __sync_lock_release(&m_connected);
+    Cleanup();
+    return false;
+  }
+  return true;
+}
+
+void ThreadedClient::Stop() {
+  if (!m_thread) {
+    return;
+  }
+
+  __sync_lock_release(&m_connected);
+  // Terminate() needs to be called from within the loop, otherwise it's a
+  // no-op if the thread hasn't reached SelectServer::Run() yet.
+  m_ss->Execute(NewSingleCallback(m_ss.get(), &SelectServer::Terminate));
+  m_thread->Join();
+  delete m_thread;
+  m_thread = NULL;
+
+  // Nothing else runs the queues now.
+  Flush();
+  Cleanup();
+}
+
+bool ThreadedClient::SendDmx(unsigned int universe,
+                             const DmxBuffer &data,
+                             uint8_t priority) {
+  Mailbox *mailbox = STLFindOrNull(m_mailboxes, universe);
+  if (!mailbox || !IsConnected()) {
+    return false;
+  }
+
+  if (__sync_lock_test_and_set(&mailbox->writing, 1)) {
+    __sync_fetch_and_add(&m_frames_dropped, 1);
+    return false;
+  }
+  // Set() copies the data, the slot must not share it with the caller.
+  Frame *frame = mailbox->frames.WriteSlot();
+  frame->data.Set(data);
+  frame->priority = priority;
+  if (mailbox->frames.Publish()) {
+    __sync_fetch_and_add(&m_frames_dropped, 1);
+  }
+  __sync_lock_release(&mailbox->writing);
+
+  if (!__sync_lock_test_and_set(&mailbox->queued, 1) &&
+      m_dirty.Push(mailbox)) {
+    Wake();
+  }
+  return true;
+}
+
+void ThreadedClient::RDMGet(unsigned int universe,
+                            const UID &uid,
+                            uint16_t sub_device,
+                            uint16_t pid,
+                            const uint8_t *data,
+                            unsigned int data_length,
+                            RDMCallback *callback) {
+  QueueRDM(universe, uid, sub_device, pid, false, data, data_length,
+           callback);
+}
+
+void ThreadedClient::RDMSet(unsigned int universe,
+                            const UID &uid,
+                            uint16_t sub_device,
+                            uint16_t pid,
+                            const uint8_t *data,
+                            unsigned int data_length,
+                            RDMCallback *callback) {
+  QueueRDM(universe, uid, sub_device, pid, true, data, data_length,
+           callback);
+}
+
+bool ThreadedClient::IsConnected() const {
+  return __sync_fetch_and_add(const_cast<int*>(&m_connected), 0) != 0;
+}
+
+uint64_t ThreadedClient::FramesDropped() const {
+  return __sync_fetch_and_add(const_cast<uint64_t*>(&m_frames_dropped), 0);
+}
+
+void ThreadedClient::QueueRDM(unsigned int universe, const UID &uid,
+                              uint16_t sub_device, uint16_t pid, bool is_set,
+                              const uint8_t *data, unsigned int data_length,
+                              RDMCallback *callback) {
+  if (!IsConnected()) {
+    RDMComplete(callback, Result(NOT_CONNECTED),
+                RDMMetadata(ola::rdm::RDM_FAILED_TO_SEND), NULL);
+    return;
+  }
+
+  RDMBatchEntry *entry = new RDMBatchEntry(universe, uid, sub_device, pid,
+                                           is_set, callback);
+  if (data && data_length) {
+    entry->data.assign(reinterpret_cast<const char*>(data), data_length);
+  }
+  if (m_rdm_requests.Push(entry)) {
+    Wake();
+  }
+}
+
+/*
+ * Called by a producer that found a queue empty, so the I/O thread is only
+ * woken once for each batch.
+ */
+void ThreadedClient::Wake() {
+  m_ss->Execute(NewSingleCallback(this, &ThreadedClient::Flush));
+}
+
+/*
+ * Called in the I/O thread, or by Stop() once the thread has exited.
+ */
+void ThreadedClient::Flush() {
+  SendPendingDmx();
+  SendPendingRDM();
+}
+
+void ThreadedClient::SendPendingDmx() {
+  vector<Mailbox*> mailboxes;
+  if (!m_dirty.PopAll(&mailboxes)) {
+    return;
+  }
+
+  const bool connected = IsConnected();
+  vector<DMXBatchEntry> batch;
+  batch.reserve(mailboxes.size());
+  vector<Mailbox*>::iterator iter = mailboxes.begin();
+  for (; iter != mailboxes.end(); ++iter) {
+    Mailbox *mailbox = *iter;
+    // Clear the flag before fetching, so a frame published after the fetch
+    // queues the mailbox again.
+    __sync_lock_release(&mailbox->queued);
+    if (mailbox->frames.Fetch() && connected) {
+      const Frame *frame = mailbox->frames.ReadSlot();
+      batch.push_back(DMXBatchEntry(mailbox->universe, frame->data,
+                                    frame->priority));
+    }
+  }
+
+  // The entries share their data with the read slots, so they have to be
+  // released before the next Fetch() hands a slot back to a producer.
+  if (!batch.empty()) {
+    m_client->SendDMXBatch(batch);
+  }
+}
+
+void ThreadedClient::SendPendingRDM() {
+  vector<RDMBatchEntry*> entries;
+  if (!m_rdm_requests.PopAll(&entries)) {
+    return;
+  }
+
+  if (!IsConnected()) {
+    vector<RDMBatchEntry*>::iterator iter = entries.begin();
+    for (; iter != entries.end(); ++iter) {
+      RDMComplete((*iter)->args.callback, Result(NOT_CONNECTED),
+                  RDMMetadata(ola::rdm::RDM_FAILED_TO_SEND), NULL);
+      delete *iter;
+    }
+    return;
+  }
+
+  vector<RDMBatchEntry> batch;
+  batch.reserve(entries.size());
+  vector<RDMBatchEntry*>::iterator iter = entries.begin();
+  for (; iter != entries.end(); ++iter) {
+    batch.push_back(**iter);
+    batch.back().args.callback = NewSingleCallback(
+        this, &ThreadedClient::RDMComplete, (*iter)->args.callback);
+    delete *iter;
+  }
+  m_client->RDMBatch(batch);
+}
+
+/*
+ * Called in the I/O thread when the connection to olad closes.
+ */
+void ThreadedClient::Closed() {
+  OLA_INFO << "ThreadedClient lost the connection to olad";
+  __sync_lock_release(&m_connected);
+  Flush();
+  m_ss->Terminate();
+}
+
+/*
+ * Delete the client, socket and SelectServer, in that order.
+ */
+void ThreadedClient::Cleanup() {
+  m_client.reset();
+  if (m_socket.get()) {
+    m_ss->RemoveReadDescriptor(m_socket.get());
+    m_socket->Close();
+    m_socket.reset();
+  }
+  m_ss.reset();
+}
+
+void ThreadedClient::RDMComplete(RDMCallback *callback,
+                                 const Result &result,
+                                 const RDMMetadata &metadata,
+                                 const RDMResponse *response) {
+  if (!callback) {
+    return;
+  }
+  if (!m_options.executor) {
+    callback->Run(result, metadata, response);
+    return;
+  }
+  m_options.executor->Execute(NewSingleCallback(
+      &RunRDMCallback, callback, new Result(result.Error()),
+      new RDMMetadata(metadata),
+      response ? response->Duplicate() : NULL));
+}
+}  // namespace client
+}  // namespace ola
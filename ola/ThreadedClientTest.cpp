@@ -0,0 +1,148 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ThreadedClientTest.cpp
+ * Test fixture for the ThreadedClient class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/client/ThreadedClient.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/ExecutorInterface.h"
+
+using ola::client::RDMMetadata;
+using ola::client::Result;
+using ola::client::ThreadedClient;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using std::vector;
+
+/*
+ * An executor that holds the callbacks until they're drained.
+ */
+class QueueingExecutor: public ola::thread::ExecutorInterface {
+ public:
+  ~QueueingExecutor() { DrainCallbacks(); }
+
+  void Execute(ola::BaseCallback0<void> *callback) {
+    m_callbacks.push_back(callback);
+  }
+
+  void DrainCallbacks() {
+    vector<ola::BaseCallback0<void>*> callbacks;
+    callbacks.swap(m_callbacks);
+    vector<ola::BaseCallback0<void>*>::iterator iter = callbacks.begin();
+    for (; iter != callbacks.end(); ++iter) {
+      (*iter)->Run();
+    }
+  }
+
+  unsigned int Pending() const { return m_callbacks.size(); }
+
+ private:
+  vector<ola::BaseCallback0<void>*> m_callbacks;
+};
+
+
+class ThreadedClientTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ThreadedClientTest);
+  CPPUNIT_TEST(testNoOlad);
+  CPPUNIT_TEST(testRDMWithoutConnection);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      m_rdm_callbacks = 0;
+      m_response_code = ola::rdm::RDM_COMPLETED_OK;
+    }
+
+    void testNoOlad();
+    void testRDMWithoutConnection();
+
+ private:
+    unsigned int m_rdm_callbacks;
+    ola::rdm::rdm_response_code m_response_code;
+
+    void RDMComplete(const Result &result,
+                     const RDMMetadata &metadata,
+                     const RDMResponse *response) {
+      OLA_ASSERT_FALSE(result.Success());
+      m_rdm_callbacks++;
+      m_response_code = metadata.response_code;
+      OLA_ASSERT_NULL(response);
+    }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadedClientTest);
+
+
+/*
+ * Check that the client fails cleanly without olad running.
+ */
+void ThreadedClientTest::testNoOlad() {
+  ThreadedClient::Options options;
+  options.auto_start = false;
+  options.universes.push_back(1);
+  ThreadedClient client(options);
+
+  OLA_ASSERT_FALSE_MSG(client.Setup(),
+                       "Check for another instance of olad running");
+  OLA_ASSERT_FALSE(client.IsConnected());
+
+  ola::DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_FALSE(client.SendDmx(1, buffer));
+  OLA_ASSERT_FALSE(client.SendDmx(2, buffer));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), client.FramesDropped());
+
+  // Stop() is a no-op, and Setup() still fails.
+  client.Stop();
+  OLA_ASSERT_FALSE_MSG(client.Setup(),
+                       "Check for another instance of olad running");
+}
+
+
+/*
+ * Check that RDM requests fail on the executor while there's no connection.
+ */
+void ThreadedClientTest::testRDMWithoutConnection() {
+  QueueingExecutor executor;
+  ThreadedClient::Options options;
+  options.auto_start = false;
+  options.executor = &executor;
+  ThreadedClient client(options);
+
+  const UID uid(0x7a70, 1);
+  client.RDMGet(1, uid, 0, 0x0060, NULL, 0,
+                ola::NewSingleCallback(this, &ThreadedClientTest::RDMComplete));
+  const uint8_t data = 1;
+  client.RDMSet(1, uid, 0, 0x1000, &data, sizeof(data),
+                ola::NewSingleCallback(this, &ThreadedClientTest::RDMComplete));
+
+  // The callbacks only run on the executor.
+  OLA_ASSERT_EQ(0u, m_rdm_callbacks);
+  OLA_ASSERT_EQ(2u, executor.Pending());
+  executor.DrainCallbacks();
+  OLA_ASSERT_EQ(2u, m_rdm_callbacks);
+  OLA_ASSERT_EQ(ola::rdm::RDM_FAILED_TO_SEND, m_response_code);
+}
@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ChangeFeedModule.cpp
+ * Pushes change notifications to WebSocket clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/ChangeFeedModule.h"
+
+#include <stdint.h>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/http/WebSocket.h"
+#include "ola/web/JsonStreamWriter.h"
+
+namespace ola {
+
+using ola::client::OlaUniverse;
+using ola::client::Result;
+using ola::client::UniverseInfoUpdate;
+using ola::http::HTTPRequest;
+using ola::http::WebSocketConnection;
+using ola::web::JsonStreamWriter;
+using std::set;
+using std::string;
+using std::vector;
+
+const char ChangeFeedModule::FEED_PATH[] = "/ws/changes";
+
+ChangeFeedModule::ChangeFeedModule(ola::http::HTTPServer *http_server,
+                                   ola::client::OlaClient *client)
+    : m_client(client),
+      m_have_universes(false),
+      m_version(0) {
+  m_client->SetUniverseInfoCallback(
+      NewCallback(this, &ChangeFeedModule::UniverseInfoChanged));
+  http_server->RegisterWebSocketHandler(
+      FEED_PATH,
+      NewCallback(this, &ChangeFeedModule::NewConnection));
+}
+
+/*
+ * The HTTPServer has closed all the connections by now.
+ */
+ChangeFeedModule::~ChangeFeedModule() {
+  m_viewers.clear();
+  m_stale_viewers.clear();
+}
+
+void ChangeFeedModule::PluginsChanged() {
+  string message;
+  JsonStreamWriter json(&message);
+  json.StartObject();
+  json.Add("type", "plugins");
+  json.End();
+  Broadcast(message);
+}
+
+void ChangeFeedModule::NewConnection(const HTTPRequest*,
+                                     WebSocketConnection *connection) {
+  connection->SetOnDrain(
+      NewCallback(this, &ChangeFeedModule::QueueDrained, connection));
+  connection->SetOnClose(
+      NewSingleCallback(this, &ChangeFeedModule::ViewerClosed, connection));
+
+  bool first_viewer = m_viewers.empty();
+  m_viewers.insert(connection);
+  if (first_viewer) {
+    // olad sends the full list once we've registered.
+    m_client->RegisterForUniverseInfo(
+        ola::client::REGISTER,
+        NewSingleCallback(this, &ChangeFeedModule::RegisterComplete));
+  } else {
+    SendFullList(connection);
+  }
+}
+
+void ChangeFeedModule::ViewerClosed(WebSocketConnection *connection) {
+  m_viewers.erase(connection);
+  m_stale_viewers.erase(connection);
+  if (m_viewers.empty()) {
+    m_client->RegisterForUniverseInfo(
+        ola::client::UNREGISTER,
+        NewSingleCallback(this, &ChangeFeedModule::RegisterComplete));
+    m_have_universes = false;
+    m_universes.clear();
+  }
+}
+
+void ChangeFeedModule::QueueDrained(WebSocketConnection *connection) {
+  if (m_stale_viewers.erase(connection)) {
+    SendFullList(connection);
+  }
+}
+
+void ChangeFeedModule::UniverseInfoChanged(const UniverseInfoUpdate &update) {
+  if (m_viewers.empty() || (!update.full && !m_have_universes)) {
+    // An update from an earlier registration.
+    return;
+  }
+
+  vector<unsigned int> changed;
+  vector<OlaUniverse>::const_iterator iter = update.universes.begin();
+  for (; iter != update.universes.end(); ++iter) {
+    changed.push_back(iter->Id());
+  }
+
+  if (update.full) {
+    m_universes.clear();
+  }
+  m_universes.insert(changed.begin(), changed.end());
+  vector<unsigned int>::const_iterator removed_iter = update.removed.begin();
+  for (; removed_iter != update.removed.end(); ++removed_iter) {
+    m_universes.erase(*removed_iter);
+  }
+  m_have_universes = true;
+  m_version = update.version;
+
+  Broadcast(UniverseMessage(update.full, changed, update.removed));
+}
+
+void ChangeFeedModule::RegisterComplete(const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Change feed failed to (un)register for universe info: "
+             << result.Error();
+  }
+}
+
+void ChangeFeedModule::SendFullList(WebSocketConnection *connection) {
+  if (!m_have_universes) {
+    return;
+  }
+  const vector<unsigned int> universes(m_universes.begin(),
+                                       m_universes.end());
+  Send(connection, UniverseMessage(true, universes, vector<unsigned int>()));
+}
+
+void ChangeFeedModule::Send(WebSocketConnection *connection,
+                            const string &message) {
+  if (!connection->IsOpen() || m_stale_viewers.count(connection)) {
+    return;
+  }
+  if (connection->SendQueueFull()) {
+    m_stale_viewers.insert(connection);
+    return;
+  }
+  connection->SendText(message);
+}
+
+void ChangeFeedModule::Broadcast(const string &message) {
+  ViewerSet::const_iterator iter = m_viewers.begin();
+  for (; iter != m_viewers.end(); ++iter) {
+    Send(*iter, message);
+  }
+}
+
+string ChangeFeedModule::UniverseMessage(
+    bool full,
+    const vector<unsigned int> &changed,
+    const vector<unsigned int> &removed) const {
+  std::ostringstream version;
+  version << m_version;
+
+  string message;
+  JsonStreamWriter json(&message);
+  json.StartObject();
+  json.Add("type", "universes");
+  json.AddRaw("version", version.str());
+  json.Add("full", full);
+  json.AddArray("changed");
+  vector<unsigned int>::const_iterator iter = changed.begin();
+  for (; iter != changed.end(); ++iter) {
+    json.Append(*iter);
+  }
+  json.End();
+  json.AddArray("removed");
+  for (iter = removed.begin(); iter != removed.end(); ++iter) {
+    json.Append(*iter);
+  }
+  json.End();
+  json.End();
+  return message;
+}
+}  // namespace ola
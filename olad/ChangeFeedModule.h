@@ -0,0 +1,105 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ChangeFeedModule.h
+ * Pushes change notifications to WebSocket clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_CHANGEFEEDMODULE_H_
+#define OLAD_CHANGEFEEDMODULE_H_
+
+#include <stdint.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/http/WebSocket.h"
+
+namespace ola {
+
+/**
+ * @brief Tells WebSocket clients what changed, so they don't need to poll
+ * /json/universe_plugin_list and /json/universe_info.
+ *
+ * Clients connect to /ws/changes and receive text messages, each a JSON
+ * object:
+ * @code
+ *   {"type": "universes", "version": 12, "full": false,
+ *    "changed": [1, 2], "removed": [3]}
+ *   {"type": "plugins"}
+ * @endcode
+ * The messages only carry the ids, the client fetches the details of the
+ * universes it's interested in. The first message sent to a new client is a
+ * universes message with full set, which lists every universe.
+ *
+ * The universe changes come from olad's universe info updates, which we
+ * register for while there is at least one client. If a client's send queue
+ * fills up, it's sent the full list once the queue drains.
+ */
+class ChangeFeedModule {
+ public:
+  /**
+   * @param http_server the HTTPServer to register the handler with.
+   * @param client the OlaClient to register for universe info with. This
+   *   module sets the client's universe info callback.
+   */
+  ChangeFeedModule(ola::http::HTTPServer *http_server,
+                   ola::client::OlaClient *client);
+  ~ChangeFeedModule();
+
+  /**
+   * @brief Tell the clients that the plugins changed.
+   */
+  void PluginsChanged();
+
+  static const char FEED_PATH[];
+
+ private:
+  typedef std::set<ola::http::WebSocketConnection*> ViewerSet;
+
+  ola::client::OlaClient *m_client;
+  ViewerSet m_viewers;
+  // Viewers that missed a message and need the full list.
+  ViewerSet m_stale_viewers;
+  std::set<unsigned int> m_universes;
+  // True once the first update from olad has arrived.
+  bool m_have_universes;
+  uint64_t m_version;
+
+  void NewConnection(const ola::http::HTTPRequest *request,
+                     ola::http::WebSocketConnection *connection);
+  void ViewerClosed(ola::http::WebSocketConnection *connection);
+  void QueueDrained(ola::http::WebSocketConnection *connection);
+
+  void UniverseInfoChanged(const ola::client::UniverseInfoUpdate &update);
+  void RegisterComplete(const ola::client::Result &result);
+
+  void SendFullList(ola::http::WebSocketConnection *connection);
+  void Send(ola::http::WebSocketConnection *connection,
+            const std::string &message);
+  void Broadcast(const std::string &message);
+
+  std::string UniverseMessage(bool full,
+                              const std::vector<unsigned int> &changed,
+                              const std::vector<unsigned int> &removed) const;
+
+  DISALLOW_COPY_AND_ASSIGN(ChangeFeedModule);
+};
+}  // namespace ola
+#endif  // OLAD_CHANGEFEEDMODULE_H_
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxFrameEncoder.cpp
+ * Encodes DMX data for the WebSocket DMX stream.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/DmxFrameEncoder.h"
+
+#include <stdint.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/io/ByteString.h"
+
+namespace ola {
+
+using ola::io::ByteString;
+
+const unsigned int DmxFrameEncoder::HEADER_SIZE;
+const unsigned int DmxFrameEncoder::RUN_HEADER_SIZE;
+
+namespace {
+void AppendUInt16(uint16_t value, ByteString *output) {
+  output->push_back(static_cast<uint8_t>(value >> 8));
+  output->push_back(static_cast<uint8_t>(value & 0xff));
+}
+}  // namespace
+
+bool DmxFrameEncoder::Encode(unsigned int universe,
+                             const DmxBuffer *previous,
+                             const DmxBuffer &current,
+                             ByteString *output) {
+  output->clear();
+  const unsigned int size = current.Size();
+
+  if (previous && previous->Size() == size) {
+    const uint8_t *old_data = previous->GetRaw();
+    const uint8_t *new_data = current.GetRaw();
+    const unsigned int full_size = HEADER_SIZE + size;
+
+    AppendHeader(DELTA_FRAME, universe, output);
+    unsigned int i = 0;
+    while (i < size && output->size() < full_size) {
+      if (old_data[i] == new_data[i]) {
+        i++;
+        continue;
+      }
+
+      // Extend the run over gaps that are cheaper to send than a new run
+      // header.
+      const unsigned int start = i;
+      unsigned int end = i + 1;
+      for (unsigned int j = end; j < size && j - end < RUN_HEADER_SIZE; j++) {
+        if (old_data[j] != new_data[j]) {
+          end = j + 1;
+        }
+      }
+
+      AppendUInt16(static_cast<uint16_t>(start), output);
+      AppendUInt16(static_cast<uint16_t>(end - start), output);
+      output->append(new_data + start, end - start);
+      i = end;
+    }
+
+    if (output->size() == HEADER_SIZE) {
+      output->clear();
+      return false;
+    }
+    if (output->size() < full_size) {
+      return true;
+    }
+    output->clear();
+  }
+
+  AppendHeader(FULL_FRAME, universe, output);
+  output->append(current.GetRaw(), size);
+  return true;
+}
+
+void DmxFrameEncoder::AppendHeader(FrameType type, unsigned int universe,
+                                   ByteString *output) {
+  output->push_back(static_cast<uint8_t>(type));
+  AppendUInt16(static_cast<uint16_t>(universe >> 16), output);
+  AppendUInt16(static_cast<uint16_t>(universe & 0xffff), output);
+}
+}  // namespace ola
@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxFrameEncoder.h
+ * Encodes DMX data for the WebSocket DMX stream.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_DMXFRAMEENCODER_H_
+#define OLAD_DMXFRAMEENCODER_H_
+
+#include <stdint.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/io/ByteString.h"
+
+namespace ola {
+
+/**
+ * @brief Builds the binary messages sent to DMX stream clients.
+ *
+ * Every message starts with a 5 byte header: the message type, then the
+ * universe id as a big endian uint32. What follows depends on the type:
+ *  - FULL_FRAME: the slot data.
+ *  - DELTA_FRAME: one or more runs, each a big endian uint16 offset, a big
+ *    endian uint16 length and then length slots. Slots outside the runs are
+ *    unchanged.
+ *
+ * A delta is only sent if the client already has a frame of the same size
+ * and the delta is smaller than the full frame.
+ */
+class DmxFrameEncoder {
+ public:
+  enum FrameType {
+    FULL_FRAME = 0,
+    DELTA_FRAME = 1
+  };
+
+  /**
+   * @brief Encode a frame.
+   * @param universe the universe id.
+   * @param previous the last frame sent to the client for this universe, or
+   *   NULL if there wasn't one.
+   * @param current the new frame.
+   * @param output the message, the existing contents are replaced.
+   * @returns false if the client already has current, in which case there's
+   *   nothing to send.
+   */
+  static bool Encode(unsigned int universe,
+                     const DmxBuffer *previous,
+                     const DmxBuffer &current,
+                     ola::io::ByteString *output);
+
+  static const unsigned int HEADER_SIZE = 5;
+  static const unsigned int RUN_HEADER_SIZE = 4;
+
+ private:
+  static void AppendHeader(FrameType type, unsigned int universe,
+                           ola::io::ByteString *output);
+};
+}  // namespace ola
+#endif  // OLAD_DMXFRAMEENCODER_H_
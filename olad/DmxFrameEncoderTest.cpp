@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxFrameEncoderTest.cpp
+ * Test fixture for the DmxFrameEncoder class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/DmxBuffer.h"
+#include "ola/io/ByteString.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/DmxFrameEncoder.h"
+
+using ola::DmxBuffer;
+using ola::DmxFrameEncoder;
+using ola::io::ByteString;
+
+class DmxFrameEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxFrameEncoderTest);
+  CPPUNIT_TEST(testFullFrame);
+  CPPUNIT_TEST(testUnchanged);
+  CPPUNIT_TEST(testDelta);
+  CPPUNIT_TEST(testLargeChange);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFullFrame();
+  void testUnchanged();
+  void testDelta();
+  void testLargeChange();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxFrameEncoderTest);
+
+
+/*
+ * Check we send the whole frame if there's nothing to compare against.
+ */
+void DmxFrameEncoderTest::testFullFrame() {
+  const uint8_t data[] = {1, 2, 3};
+  DmxBuffer buffer(data, sizeof(data));
+  ByteString output;
+  OLA_ASSERT_TRUE(DmxFrameEncoder::Encode(0x01020304, NULL, buffer, &output));
+  const uint8_t expected[] = {0, 1, 2, 3, 4, 1, 2, 3};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output.data(),
+                         output.size());
+
+  // The frame size changed.
+  const uint8_t longer_data[] = {1, 2, 3, 4};
+  DmxBuffer longer(longer_data, sizeof(longer_data));
+  OLA_ASSERT_TRUE(DmxFrameEncoder::Encode(1, &buffer, longer, &output));
+  const uint8_t expected2[] = {0, 0, 0, 0, 1, 1, 2, 3, 4};
+  OLA_ASSERT_DATA_EQUALS(expected2, sizeof(expected2), output.data(),
+                         output.size());
+}
+
+
+/*
+ * Check nothing is sent if the data is the same.
+ */
+void DmxFrameEncoderTest::testUnchanged() {
+  DmxBuffer buffer;
+  buffer.Blackout();
+  DmxBuffer copy(buffer);
+  ByteString output;
+  OLA_ASSERT_FALSE(DmxFrameEncoder::Encode(1, &copy, buffer, &output));
+  OLA_ASSERT_TRUE(output.empty());
+}
+
+
+/*
+ * Check changes are sent as runs, with small gaps merged.
+ */
+void DmxFrameEncoderTest::testDelta() {
+  DmxBuffer previous;
+  previous.Blackout();
+  DmxBuffer current(previous);
+  current.SetChannel(0, 10);
+  // Three unchanged slots between changes are cheaper than a new run.
+  current.SetChannel(4, 11);
+  current.SetChannel(100, 12);
+  current.SetChannel(511, 13);
+
+  ByteString output;
+  OLA_ASSERT_TRUE(DmxFrameEncoder::Encode(2, &previous, current, &output));
+  const uint8_t expected[] = {
+    1, 0, 0, 0, 2,
+    0, 0, 0, 5, 10, 0, 0, 0, 11,
+    0, 100, 0, 1, 12,
+    1, 255, 0, 1, 13
+  };
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output.data(),
+                         output.size());
+}
+
+
+/*
+ * Check we fall back to a full frame if the delta would be larger.
+ */
+void DmxFrameEncoderTest::testLargeChange() {
+  DmxBuffer previous;
+  previous.Blackout();
+  DmxBuffer current;
+  for (unsigned int i = 0; i < 512; i++) {
+    // Change every 5th slot, so each change needs its own run.
+    current.SetChannel(i, i % 5 ? 0 : 255);
+  }
+
+  ByteString output;
+  OLA_ASSERT_TRUE(DmxFrameEncoder::Encode(3, &previous, current, &output));
+  OLA_ASSERT_EQ(static_cast<size_t>(DmxFrameEncoder::HEADER_SIZE + 512),
+                output.size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(DmxFrameEncoder::FULL_FRAME), output[0]);
+  OLA_ASSERT_DATA_EQUALS(current.GetRaw(), current.Size(),
+                         output.data() + DmxFrameEncoder::HEADER_SIZE,
+                         output.size() - DmxFrameEncoder::HEADER_SIZE);
+}
@@ -0,0 +1,252 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxStreamModule.cpp
+ * Streams live DMX data to WebSocket clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/DmxStreamModule.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/http/WebSocket.h"
+#include "ola/io/ByteString.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/DmxFrameEncoder.h"
+
+namespace ola {
+
+using ola::client::DMXMetadata;
+using ola::client::RegisterArgs;
+using ola::client::Result;
+using ola::http::HTTPRequest;
+using ola::http::WebSocketConnection;
+using ola::io::ByteString;
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+const char DmxStreamModule::STREAM_PATH[] = "/ws/dmx";
+const unsigned int DmxStreamModule::MAX_RATE;
+const unsigned int DmxStreamModule::MAX_UNIVERSES_PER_VIEWER;
+
+DmxStreamModule::DmxStreamModule(ola::http::HTTPServer *http_server,
+                                 ola::client::OlaClient *client)
+    : m_client(client) {
+  m_client->SetDMXCallback(NewCallback(this, &DmxStreamModule::NewDmx));
+  http_server->RegisterWebSocketHandler(
+      STREAM_PATH,
+      NewCallback(this, &DmxStreamModule::NewConnection));
+}
+
+/*
+ * The HTTPServer has closed all the connections by now.
+ */
+DmxStreamModule::~DmxStreamModule() {
+  STLDeleteElements(&m_viewers);
+  STLDeleteValues(&m_universes);
+}
+
+void DmxStreamModule::NewConnection(const HTTPRequest *request,
+                                    WebSocketConnection *connection) {
+  Viewer *viewer = new Viewer(connection);
+  m_viewers.insert(viewer);
+  connection->SetOnMessage(
+      NewCallback(this, &DmxStreamModule::HandleMessage, viewer));
+  connection->SetOnDrain(
+      NewCallback(this, &DmxStreamModule::QueueDrained, viewer));
+  connection->SetOnClose(
+      NewSingleCallback(this, &DmxStreamModule::ViewerClosed, viewer));
+
+  vector<string> universes;
+  StringSplit(request->GetParameter("u"), &universes, ",");
+  vector<string>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    unsigned int universe;
+    if (StringToInt(*iter, &universe)) {
+      Subscribe(viewer, universe);
+    }
+  }
+}
+
+void DmxStreamModule::ViewerClosed(Viewer *viewer) {
+  while (!viewer->sent.empty()) {
+    Unsubscribe(viewer, viewer->sent.begin()->first);
+  }
+  m_viewers.erase(viewer);
+  delete viewer;
+}
+
+void DmxStreamModule::HandleMessage(Viewer *viewer, const string &message) {
+  vector<string> tokens;
+  StringSplit(message, &tokens);
+  unsigned int universe;
+  if (tokens.size() != 2 || !StringToInt(tokens[1], &universe)) {
+    OLA_INFO << "Invalid DMX stream request: " << message;
+    return;
+  }
+
+  if (tokens[0] == "subscribe") {
+    Subscribe(viewer, universe);
+  } else if (tokens[0] == "unsubscribe") {
+    Unsubscribe(viewer, universe);
+  } else {
+    OLA_INFO << "Invalid DMX stream request: " << message;
+  }
+}
+
+/*
+ * Send the latest data for the universes that were held back.
+ */
+void DmxStreamModule::QueueDrained(Viewer *viewer) {
+  const set<unsigned int> pending(viewer->pending);
+  set<unsigned int>::const_iterator iter = pending.begin();
+  for (; iter != pending.end(); ++iter) {
+    const UniverseState *state = STLFindOrNull(m_universes, *iter);
+    if (state) {
+      SendUniverse(viewer, *iter, *state);
+    }
+  }
+}
+
+void DmxStreamModule::Subscribe(Viewer *viewer, unsigned int universe) {
+  if (STLContains(viewer->sent, universe)) {
+    return;
+  }
+  if (viewer->sent.size() >= MAX_UNIVERSES_PER_VIEWER) {
+    OLA_INFO << "DMX stream viewer has too many universes";
+    return;
+  }
+
+  UniverseState *state = STLFindOrNull(m_universes, universe);
+  if (!state) {
+    state = new UniverseState();
+    m_universes[universe] = state;
+
+    RegisterArgs args;
+    args.max_rate = MAX_RATE;
+    args.changes_only = true;
+    m_client->RegisterUniverse(
+        universe, ola::client::REGISTER, args,
+        NewSingleCallback(this, &DmxStreamModule::RegisterComplete,
+                          universe));
+    // We only get changes, so fetch the current data.
+    m_client->FetchDMX(
+        universe,
+        NewSingleCallback(this, &DmxStreamModule::FetchComplete, universe));
+  }
+
+  state->viewers.insert(viewer);
+  // An empty buffer marks the subscription, it's replaced by the first frame
+  // we send.
+  viewer->sent[universe] = DmxBuffer();
+  if (state->has_data) {
+    SendUniverse(viewer, universe, *state);
+  }
+}
+
+void DmxStreamModule::Unsubscribe(Viewer *viewer, unsigned int universe) {
+  viewer->sent.erase(universe);
+  viewer->pending.erase(universe);
+
+  UniverseMap::iterator iter = m_universes.find(universe);
+  if (iter == m_universes.end()) {
+    return;
+  }
+  UniverseState *state = iter->second;
+  state->viewers.erase(viewer);
+  if (state->viewers.empty()) {
+    m_client->RegisterUniverse(
+        universe, ola::client::UNREGISTER,
+        NewSingleCallback(this, &DmxStreamModule::RegisterComplete,
+                          universe));
+    delete state;
+    m_universes.erase(iter);
+  }
+}
+
+void DmxStreamModule::SendUniverse(Viewer *viewer, unsigned int universe,
+                                   const UniverseState &state) {
+  if (!viewer->connection->IsOpen()) {
+    return;
+  }
+  if (viewer->connection->SendQueueFull()) {
+    viewer->pending.insert(universe);
+    return;
+  }
+  viewer->pending.erase(universe);
+
+  DmxBuffer *previous = STLFind(&viewer->sent, universe);
+  if (!previous) {
+    return;
+  }
+
+  ByteString frame;
+  // A new subscription has an empty buffer, which always gets a full frame.
+  if (!DmxFrameEncoder::Encode(universe,
+                               previous->Size() ? previous : NULL,
+                               state.data, &frame)) {
+    return;
+  }
+  if (viewer->connection->SendBinary(frame.data(), frame.size())) {
+    *previous = state.data;
+  }
+}
+
+void DmxStreamModule::NewDmx(const DMXMetadata &metadata,
+                             const DmxBuffer &data) {
+  UniverseState *state = STLFindOrNull(m_universes, metadata.universe);
+  if (!state) {
+    return;
+  }
+  state->data = data;
+  state->has_data = true;
+
+  set<Viewer*>::const_iterator iter = state->viewers.begin();
+  for (; iter != state->viewers.end(); ++iter) {
+    SendUniverse(*iter, metadata.universe, *state);
+  }
+}
+
+void DmxStreamModule::FetchComplete(unsigned int universe,
+                                    const Result &result,
+                                    const DMXMetadata&,
+                                    const DmxBuffer &data) {
+  UniverseState *state = STLFindOrNull(m_universes, universe);
+  if (!result.Success() || !state || state->has_data) {
+    return;
+  }
+  NewDmx(DMXMetadata(universe), data);
+}
+
+void DmxStreamModule::RegisterComplete(unsigned int universe,
+                                       const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "DMX stream failed to (un)register for universe " << universe
+             << ": " << result.Error();
+  }
+}
+}  // namespace ola
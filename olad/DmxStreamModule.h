@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxStreamModule.h
+ * Streams live DMX data to WebSocket clients.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_DMXSTREAMMODULE_H_
+#define OLAD_DMXSTREAMMODULE_H_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/http/WebSocket.h"
+
+namespace ola {
+
+/**
+ * @brief Streams DMX data to WebSocket clients, so they don't need to poll
+ * /get_dmx.
+ *
+ * Clients connect to /ws/dmx, optionally with ?u=1,2,3 to subscribe to
+ * universes straight away, and can then send the text messages
+ * "subscribe <universe>" and "unsubscribe <universe>". Updates are sent as
+ * binary messages, see DmxFrameEncoder for the format.
+ *
+ * We register for each universe that has a viewer, using the same
+ * registration as any other client; olad limits the rate to MAX_RATE and only
+ * sends changes. Each viewer gets a delta against the last frame it was
+ * sent. If a viewer's send queue is full, its updates are held back and the
+ * latest data is sent once the queue drains.
+ */
+class DmxStreamModule {
+ public:
+  /**
+   * @param http_server the HTTPServer to register the handler with.
+   * @param client the OlaClient to register for DMX with. This module sets
+   *   the client's DMX callback.
+   */
+  DmxStreamModule(ola::http::HTTPServer *http_server,
+                  ola::client::OlaClient *client);
+  ~DmxStreamModule();
+
+  static const char STREAM_PATH[];
+  static const unsigned int MAX_RATE = 25;
+  static const unsigned int MAX_UNIVERSES_PER_VIEWER = 64;
+
+ private:
+  struct Viewer {
+    explicit Viewer(ola::http::WebSocketConnection *_connection)
+        : connection(_connection) {}
+
+    ola::http::WebSocketConnection *connection;
+    // The universes this viewer is subscribed to, and the last data sent.
+    std::map<unsigned int, DmxBuffer> sent;
+    // Universes with updates which were held back.
+    std::set<unsigned int> pending;
+  };
+
+  struct UniverseState {
+    UniverseState() : has_data(false) {}
+
+    DmxBuffer data;
+    bool has_data;
+    std::set<Viewer*> viewers;
+  };
+
+  typedef std::map<unsigned int, UniverseState*> UniverseMap;
+
+  ola::client::OlaClient *m_client;
+  std::set<Viewer*> m_viewers;
+  UniverseMap m_universes;
+
+  void NewConnection(const ola::http::HTTPRequest *request,
+                     ola::http::WebSocketConnection *connection);
+  void ViewerClosed(Viewer *viewer);
+  void HandleMessage(Viewer *viewer, const std::string &message);
+  void QueueDrained(Viewer *viewer);
+
+  void Subscribe(Viewer *viewer, unsigned int universe);
+  void Unsubscribe(Viewer *viewer, unsigned int universe);
+  void SendUniverse(Viewer *viewer, unsigned int universe,
+                    const UniverseState &state);
+
+  void NewDmx(const ola::client::DMXMetadata &metadata,
+              const DmxBuffer &data);
+  void FetchComplete(unsigned int universe,
+                     const ola::client::Result &result,
+                     const ola::client::DMXMetadata &metadata,
+                     const DmxBuffer &data);
+  void RegisterComplete(unsigned int universe,
+                        const ola::client::Result &result);
+
+  DISALLOW_COPY_AND_ASSIGN(DmxStreamModule);
+};
+}  // namespace ola
+#endif  // OLAD_DMXSTREAMMODULE_H_
@@ -27,10 +27,23 @@
 #include "olad/DynamicPluginLoader.h"
 #include "olad/Plugin.h"
 
+#ifdef OLA_PLUGIN_MODULES
+#include <dlfcn.h>
+#include <string>
+#include "ola/Logging.h"
+#include "ola/file/Util.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
+#else
 #ifdef USE_ARTNET
 #include "plugins/artnet/ArtNetPlugin.h"
 #endif  // USE_ARTNET
 
+#ifdef USE_CLUSTER
+#include "plugins/cluster/ClusterPlugin.h"
+#endif  // USE_CLUSTER
+
 #ifdef USE_DUMMY
 #include "plugins/dummy/DummyPlugin.h"
 #endif  // USE_DUMMY
@@ -114,11 +127,109 @@
 #ifdef USE_DMX4LINUX
 #include "plugins/dmx4linux/Dmx4LinuxPlugin.h"
 #endif  // USE_DMX4LINUX
+#endif  // OLA_PLUGIN_MODULES
 
 namespace ola {
 
 using std::vector;
 
+#ifdef OLA_PLUGIN_MODULES
+using std::string;
+
+namespace {
+/*
+ * The modules that were built, and the preferences prefix of the plugin in
+ * each. The module for <name> is libola<name>.
+ */
+struct PluginModuleEntry {
+  const char *name;
+  const char *prefix;
+};
+
+const PluginModuleEntry PLUGIN_MODULES[] = {
+#ifdef USE_DMX4LINUX
+  {"dmx4linux", "dmx4linux"},
+#endif  // USE_DMX4LINUX
+#ifdef USE_ARTNET
+  {"artnet", "artnet"},
+#endif  // USE_ARTNET
+#ifdef USE_CLUSTER
+  {"cluster", "cluster"},
+#endif  // USE_CLUSTER
+#ifdef USE_DUMMY
+  {"dummy", "dummy"},
+#endif  // USE_DUMMY
+#ifdef USE_E131
+  {"e131", "e131"},
+#endif  // USE_E131
+#ifdef USE_ESPNET
+  {"espnet", "espnet"},
+#endif  // USE_ESPNET
+#ifdef USE_GPIO
+  {"gpio", "gpio"},
+#endif  // USE_GPIO
+#ifdef USE_KARATE
+  {"karate", "karate"},
+#endif  // USE_KARATE
+#ifdef USE_KINET
+  {"kinet", "kinet"},
+#endif  // USE_KINET
+#ifdef USE_MILINST
+  {"milinst", "milinst"},
+#endif  // USE_MILINST
+#ifdef USE_OPENDMX
+  {"opendmx", "opendmx"},
+#endif  // USE_OPENDMX
+#ifdef USE_OPENPIXELCONTROL
+  {"openpixelcontrol", "openpixelcontrol"},
+#endif  // USE_OPENPIXELCONTROL
+#ifdef USE_OSC
+  {"osc", "osc"},
+#endif  // USE_OSC
+#ifdef USE_RENARD
+  {"renard", "renard"},
+#endif  // USE_RENARD
+#ifdef USE_SANDNET
+  {"sandnet", "sandnet"},
+#endif  // USE_SANDNET
+#ifdef USE_SHOWNET
+  {"shownet", "shownet"},
+#endif  // USE_SHOWNET
+#ifdef USE_SPI
+  {"spi", "spi"},
+#endif  // USE_SPI
+#ifdef USE_STAGEPROFI
+  {"stageprofi", "stageprofi"},
+#endif  // USE_STAGEPROFI
+#ifdef USE_USBPRO
+  {"usbpro", "usbserial"},
+#endif  // USE_USBPRO
+#ifdef USE_LIBUSB
+  {"usbdmx", "usbdmx"},
+#endif  // USE_LIBUSB
+#ifdef USE_PATHPORT
+  {"pathport", "pathport"},
+#endif  // USE_PATHPORT
+#ifdef USE_FTDI
+  {"ftdidmx", "ftdidmx"},
+#endif  // USE_FTDI
+#ifdef USE_UART
+  {"uartdmx", "uartdmx"},
+#endif  // USE_UART
+  {NULL, NULL}
+};
+
+#ifdef __APPLE__
+const char MODULE_SUFFIX[] = ".dylib";
+#else
+const char MODULE_SUFFIX[] = ".so";
+#endif  // __APPLE__
+
+// This matches Plugin::ENABLED_KEY.
+const char ENABLED_KEY[] = "enabled";
+}  // namespace
+#endif  // OLA_PLUGIN_MODULES
+
 DynamicPluginLoader::~DynamicPluginLoader() {
   UnloadPlugins();
 }
@@ -130,6 +241,62 @@ vector<AbstractPlugin*> DynamicPluginLoader::LoadPlugins() {
   return m_plugins;
 }
 
+#ifdef OLA_PLUGIN_MODULES
+/*
+ * Open the module for each plugin that's enabled.
+ */
+void DynamicPluginLoader::PopulatePlugins() {
+  for (const PluginModuleEntry *entry = PLUGIN_MODULES; entry->name;
+       ++entry) {
+    OpenModule(entry->name, entry->prefix);
+  }
+}
+
+/*
+ * Open a module and create the plugin in it. The plugin's preferences are
+ * checked first, so a plugin that's been disabled is never mapped.
+ */
+void DynamicPluginLoader::OpenModule(const string &name,
+                                     const string &prefix) {
+  Preferences *preferences = m_plugin_adaptor->NewPreference(prefix);
+  if (preferences) {
+    preferences->Load();
+    if (preferences->GetValue(ENABLED_KEY) == BoolValidator::DISABLED) {
+      OLA_INFO << "Skipping module " << name << ", it's disabled";
+      return;
+    }
+  }
+
+  const string path = ola::file::JoinPaths(
+      m_module_dir, "libola" + name + MODULE_SUFFIX);
+  void *module = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!module) {
+    OLA_WARN << "Failed to open " << path << ": " << dlerror();
+    return;
+  }
+
+  ola_new_plugin_t *new_plugin = reinterpret_cast<ola_new_plugin_t*>(
+      dlsym(module, OLA_NEW_PLUGIN));
+  if (!new_plugin) {
+    OLA_WARN << path << " doesn't export " << OLA_NEW_PLUGIN;
+    dlclose(module);
+    return;
+  }
+
+  AbstractPlugin *plugin = new_plugin(m_plugin_adaptor);
+  // A missing preferences file is only populated with the defaults here, so
+  // check again.
+  if (!plugin->LoadPreferences() || !plugin->IsEnabled()) {
+    OLA_INFO << "Closing module " << name << ", it's disabled";
+    delete plugin;
+    dlclose(module);
+    return;
+  }
+  OLA_INFO << "Opened module " << path;
+  m_plugins.push_back(plugin);
+  m_modules.push_back(module);
+}
+#else
 /*
  * Setup the plugin list
  */
@@ -143,6 +310,11 @@ void DynamicPluginLoader::PopulatePlugins() {
   m_plugins.push_back(new ola::plugin::artnet::ArtNetPlugin(m_plugin_adaptor));
 #endif  // USE_ARTNET
 
+#ifdef USE_CLUSTER
+  m_plugins.push_back(
+      new ola::plugin::cluster::ClusterPlugin(m_plugin_adaptor));
+#endif  // USE_CLUSTER
+
 #ifdef USE_DUMMY
   m_plugins.push_back(new ola::plugin::dummy::DummyPlugin(m_plugin_adaptor));
 #endif  // USE_DUMMY
@@ -237,8 +409,17 @@ void DynamicPluginLoader::PopulatePlugins() {
       new ola::plugin::uartdmx::UartDmxPlugin(m_plugin_adaptor));
 #endif  // USE_UART
 }
+#endif  // OLA_PLUGIN_MODULES
 
 void DynamicPluginLoader::UnloadPlugins() {
   STLDeleteElements(&m_plugins);
+#ifdef OLA_PLUGIN_MODULES
+  // The plugins' code lives in the modules, so they're closed last.
+  vector<void*>::iterator iter = m_modules.begin();
+  for (; iter != m_modules.end(); ++iter) {
+    dlclose(*iter);
+  }
+  m_modules.clear();
+#endif  // OLA_PLUGIN_MODULES
 }
 }  // namespace ola
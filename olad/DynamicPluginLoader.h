@@ -21,6 +21,7 @@
 #ifndef OLAD_DYNAMICPLUGINLOADER_H_
 #define OLAD_DYNAMICPLUGINLOADER_H_
 
+#include <string>
 #include <vector>
 #include "ola/base/Macro.h"
 #include "olad/PluginLoader.h"
@@ -29,10 +30,24 @@ namespace ola {
 
 /**
  * @brief A PluginLoader which loads from shared (dynamic) libraries.
+ *
+ * By default the plugins are linked into olad. If olad was configured with
+ * --enable-plugin-modules, each plugin is opened from the module directory
+ * with dlopen() instead. A module whose preferences disable it isn't opened
+ * at all, and a module which turns out to be disabled once its default
+ * preferences have been set is closed again, so olad only maps the plugins
+ * it runs.
  */
 class DynamicPluginLoader: public PluginLoader {
  public:
-  DynamicPluginLoader() {}
+  /**
+   * @brief Create a new DynamicPluginLoader.
+   * @param module_dir the directory to open the plugin modules from. This is
+   *   only used with --enable-plugin-modules.
+   */
+  explicit DynamicPluginLoader(const std::string &module_dir = "")
+      : m_module_dir(module_dir) {
+  }
   ~DynamicPluginLoader();
 
   std::vector<class AbstractPlugin*> LoadPlugins();
@@ -40,9 +55,12 @@ class DynamicPluginLoader: public PluginLoader {
   void UnloadPlugins();
 
  private:
-  void PopulatePlugins();
-
+  const std::string m_module_dir;
   std::vector<class AbstractPlugin*> m_plugins;
+  std::vector<void*> m_modules;
+
+  void PopulatePlugins();
+  void OpenModule(const std::string &name, const std::string &prefix);
 
   DISALLOW_COPY_AND_ASSIGN(DynamicPluginLoader);
 };
@@ -93,4 +93,14 @@ void PortPriorityStaticAction::DoAction() {
     NewSingleCallback(static_cast<BaseHttpAction*>(this),
                       &PortPriorityStaticAction::CallbackComplete));
 }
+
+
+void PortFrameRateAction::DoAction() {
+  m_client->SetPortMaxFrameRate(
+    m_device_alias,
+    m_port,
+    m_max_frame_rate,
+    NewSingleCallback(static_cast<BaseHttpAction*>(this),
+                      &PortFrameRateAction::CallbackComplete));
+}
 }  // namespace ola
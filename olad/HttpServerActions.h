@@ -209,5 +209,34 @@ class PortPriorityStaticAction: public BaseHttpAction {
 
     DISALLOW_COPY_AND_ASSIGN(PortPriorityStaticAction);
 };
+
+
+/*
+ * An action that sets the max frame rate of an output port.
+ */
+class PortFrameRateAction: public BaseHttpAction {
+ public:
+    PortFrameRateAction(client::OlaClient *client,
+                        unsigned int device_alias,
+                        unsigned int port,
+                        unsigned int max_frame_rate):
+      BaseHttpAction(client),
+      m_device_alias(device_alias),
+      m_port(port),
+      m_max_frame_rate(max_frame_rate) {
+    }
+
+    bool IsFatal() const { return false; }
+
+ protected:
+    void DoAction();
+
+ private:
+    unsigned int m_device_alias;
+    unsigned int m_port;
+    unsigned int m_max_frame_rate;
+
+    DISALLOW_COPY_AND_ASSIGN(PortFrameRateAction);
+};
 }  // namespace ola
 #endif  // OLAD_HTTPSERVERACTIONS_H_
@@ -9,10 +9,14 @@ oladinclude_HEADERS += olad/OlaDaemon.h olad/OlaServer.h
 # LIBRARIES
 ##################################################
 ola_server_sources = \
+    olad/ChangeFeedModule.h \
     olad/ClientBroker.cpp \
     olad/ClientBroker.h \
     olad/DiscoveryAgent.cpp \
     olad/DiscoveryAgent.h \
+    olad/DmxFrameEncoder.cpp \
+    olad/DmxFrameEncoder.h \
+    olad/DmxStreamModule.h \
     olad/DynamicPluginLoader.cpp \
     olad/DynamicPluginLoader.h \
     olad/HttpServerActions.h \
@@ -22,7 +26,21 @@ ola_server_sources = \
     olad/PluginLoader.h \
     olad/PluginManager.cpp \
     olad/PluginManager.h \
-    olad/RDMHTTPModule.h
+    olad/RDMDeviceCache.cpp \
+    olad/RDMDeviceCache.h \
+    olad/RDMHTTPModule.h \
+    olad/RDMResponseCache.cpp \
+    olad/RDMResponseCache.h \
+    olad/ShowLogger.cpp \
+    olad/ShowLogger.h \
+    olad/TimeCodeGenerator.cpp \
+    olad/TimeCodeGenerator.h
+# The show logger writes the same binary format as ola_recorder.
+ola_server_sources += \
+    examples/BinaryShowFormat.h \
+    examples/BinaryShowSaver.cpp \
+    examples/BinaryShowSaver.h \
+    examples/ShowSaverInterface.h
 ola_server_additional_libs =
 
 if HAVE_DNSSD
@@ -36,7 +54,9 @@ ola_server_additional_libs += $(avahi_LIBS)
 endif
 
 if HAVE_LIBMICROHTTPD
-ola_server_sources += olad/HttpServerActions.cpp \
+ola_server_sources += olad/ChangeFeedModule.cpp \
+                      olad/DmxStreamModule.cpp \
+                      olad/HttpServerActions.cpp \
                       olad/OladHTTPServer.cpp \
                       olad/RDMHTTPModule.cpp
 ola_server_additional_libs += common/http/libolahttp.la
@@ -49,8 +69,15 @@ olad_libolaserver_la_SOURCES = $(ola_server_sources) \
                                olad/OlaServer.cpp \
                                olad/OlaDaemon.cpp
 olad_libolaserver_la_CXXFLAGS = $(COMMON_CXXFLAGS) \
-                                -DHTTP_DATA_DIR=\"${www_datadir}\"
-olad_libolaserver_la_LIBADD = $(PLUGIN_LIBS) \
+                                -DHTTP_DATA_DIR=\"${www_datadir}\" \
+                                -DPLUGIN_DIR=\"${libdir}\"
+# Plugin modules are opened by the DynamicPluginLoader rather than linked in.
+if PLUGIN_MODULES
+ola_server_plugin_libs =
+else
+ola_server_plugin_libs = $(PLUGIN_LIBS)
+endif
+olad_libolaserver_la_LIBADD = $(ola_server_plugin_libs) \
                               common/libolacommon.la \
                               common/web/libolaweb.la \
                               ola/libola.la \
@@ -87,8 +114,16 @@ COMMON_OLAD_TEST_LDADD = $(COMMON_TESTING_LIBS) $(libprotobuf_LIBS) \
                          common/libolacommon.la
 
 olad_OlaTester_SOURCES = \
+    olad/DmxFrameEncoderTest.cpp \
     olad/PluginManagerTest.cpp \
-    olad/OlaServerServiceImplTest.cpp
+    olad/OlaServerServiceImplTest.cpp \
+    olad/RDMDeviceCacheTest.cpp \
+    olad/RDMResponseCacheTest.cpp \
+    olad/ShowLoggerTest.cpp \
+    olad/TimeCodeGeneratorTest.cpp \
+    examples/BinaryShowLoader.cpp \
+    examples/BinaryShowLoader.h \
+    examples/ShowLoaderInterface.h
 olad_OlaTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_OlaTester_LDADD = $(COMMON_OLAD_TEST_LDADD)
 
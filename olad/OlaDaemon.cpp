@@ -46,10 +46,20 @@
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/PluginLoader.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/IndexedPreferences.h"
 
 DEFINE_s_string(config_dir, c, "",
                 "The path to the config directory, Defaults to ~/.ola/ " \
                 "on *nix and %LOCALAPPDATA%\\.ola\\ on Windows.");
+DEFINE_default_bool(indexed_preferences, false,
+                    "Keep the preferences in a single indexed file rather "
+                    "than one file per plugin. The existing files are "
+                    "imported the first time.");
+
+#ifdef OLA_PLUGIN_MODULES
+DEFINE_string(plugin_dir, PLUGIN_DIR,
+              "The directory to load the plugin modules from.");
+#endif  // OLA_PLUGIN_MODULES
 
 namespace ola {
 
@@ -68,11 +78,22 @@ const char OlaDaemon::GID_KEY[] = "gid";
 const char OlaDaemon::USER_NAME_KEY[] = "user";
 const char OlaDaemon::GROUP_NAME_KEY[] = "group";
 
+namespace {
+
+SelectServer::Options SelectServerOptions(const OlaServer::Options &options,
+                                          ExportMap *export_map) {
+  SelectServer::Options ss_options;
+  ss_options.export_map = export_map;
+  ss_options.loop_cpu = options.loop_cpu;
+  return ss_options;
+}
+}  // namespace
+
 OlaDaemon::OlaDaemon(const OlaServer::Options &options,
                      ExportMap *export_map)
     : m_options(options),
       m_export_map(export_map),
-      m_ss(m_export_map) {
+      m_ss(SelectServerOptions(options, m_export_map)) {
   if (m_export_map) {
     uid_t uid;
     if (GetUID(&uid)) {
@@ -122,11 +143,19 @@ bool OlaDaemon::Init() {
   if (m_export_map) {
     m_export_map->GetStringVar(CONFIG_DIR_KEY)->Set(config_dir);
   }
-  auto_ptr<PreferencesFactory> preferences_factory(
-      new FileBackedPreferencesFactory(config_dir));
+  auto_ptr<PreferencesFactory> preferences_factory;
+  if (FLAGS_indexed_preferences) {
+    preferences_factory.reset(new IndexedPreferencesFactory(config_dir));
+  } else {
+    preferences_factory.reset(new FileBackedPreferencesFactory(config_dir));
+  }
 
   // Order is important here as we won't load the same plugin twice.
+#ifdef OLA_PLUGIN_MODULES
+  m_plugin_loaders.push_back(new DynamicPluginLoader(FLAGS_plugin_dir.str()));
+#else
   m_plugin_loaders.push_back(new DynamicPluginLoader());
+#endif  // OLA_PLUGIN_MODULES
 
   auto_ptr<OlaServer> server(
       new OlaServer(m_plugin_loaders,
@@ -24,12 +24,16 @@
 
 #include <errno.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "common/dmx/DmxBufferPool.h"
 #include "common/protocol/Ola.pb.h"
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcServer.h"
@@ -38,11 +42,15 @@
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
+#include "ola/dmx/UniverseSharedMemory.h"
 #include "ola/network/InterfacePicker.h"
+#include "ola/network/InterfaceWatcher.h"
 #include "ola/network/Socket.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/ThreadRoles.h"
+#include "ola/timecode/TimeCodeSharedMemory.h"
 #include "olad/ClientBroker.h"
 #include "olad/DiscoveryAgent.h"
 #include "olad/OlaServer.h"
@@ -53,9 +61,15 @@
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
+#include "olad/ShowLogger.h"
+#include "olad/TimeCodeGenerator.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/DmxSnapshot.h"
+#include "olad/plugin_api/OutputScheduler.h"
+#include "olad/plugin_api/SoftPatch.h"
+#include "olad/plugin_api/SourceExpiryScheduler.h"
 #include "olad/plugin_api/PortManager.h"
 #include "olad/plugin_api/UniverseStore.h"
 
@@ -67,6 +81,9 @@ DEFINE_s_uint16(rpc_port, r, ola::OlaServer::DEFAULT_RPC_PORT,
                 "The port to listen for RPCs on. Defaults to 9010.");
 DEFINE_default_bool(register_with_dns_sd, true,
                     "Don't register the web service using DNS-SD (Bonjour).");
+DEFINE_default_bool(reload_on_interface_change, false,
+                    "Reload the plugins when a network interface or address "
+                    "changes.");
 
 namespace ola {
 
@@ -82,11 +99,24 @@ using std::vector;
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
 const char OlaServer::K_INSTANCE_NAME_VAR[] = "server-instance-name";
 const char OlaServer::K_UID_VAR[] = "server-uid";
+const char OlaServer::K_LOG_DROPPED_VAR[] = "log-lines-dropped";
+const char OlaServer::K_LOG_SUPPRESSED_VAR[] = "log-lines-suppressed";
+const char OlaServer::K_SHOW_LOG_DROPPED_VAR[] = "show-log-frames-dropped";
+const char OlaServer::K_THREAD_CPU_VAR[] = "thread-cpu-ms";
+const char OlaServer::K_TIMECODE_SKIPPED_VAR[] = "timecode-frames-skipped";
 const char OlaServer::SERVER_PREFERENCES[] = "server";
 const char OlaServer::UNIVERSE_PREFERENCES[] = "universe";
+const char OlaServer::RDM_CACHE_PREFERENCES[] = "rdm-cache";
+const char OlaServer::SOFT_PATCH_PREFERENCES[] = "softpatch";
 // The Bonjour API expects <service>[,<sub-type>] so we use that form here.
 const char OlaServer::K_DISCOVERY_SERVICE_TYPE[] = "_http._tcp,_ola";
 const unsigned int OlaServer::K_HOUSEKEEPING_TIMEOUT_MS = 10000;
+// A fraction of Universe::K_OUTPUT_REFRESH_INTERVAL_MS, so the refreshes
+// aren't late by much.
+const unsigned int OlaServer::K_OUTPUT_REFRESH_TICK_MS = 250;
+const unsigned int OlaServer::K_UNIVERSE_INFO_DELAY_MS = 100;
+const unsigned int OlaServer::K_UNIVERSE_GC_LIMIT = 64;
+const unsigned int OlaServer::K_SHOW_LOG_SEGMENT_S = 60;
 
 OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
                      PreferencesFactory *preferences_factory,
@@ -103,7 +133,9 @@ OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
       m_default_uid(OPEN_LIGHTING_ESTA_CODE, 0),
       m_server_preferences(NULL),
       m_universe_preferences(NULL),
-      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT),
+      m_refresh_timeout(ola::thread::INVALID_TIMEOUT),
+      m_universe_info_timeout(ola::thread::INVALID_TIMEOUT) {
   if (!m_export_map) {
     m_our_export_map.reset(new ExportMap());
     m_export_map = m_our_export_map.get();
@@ -113,6 +145,12 @@ OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
 OlaServer::~OlaServer() {
   m_ss->DrainCallbacks();
 
+  // Save the data before the clients are removed and the universes re-merge.
+  if (m_dmx_snapshot.get()) {
+    SaveDmxSnapshot();
+    m_dmx_snapshot->Stop();
+  }
+
 #ifdef HAVE_LIBMICROHTTPD
   if (m_httpd.get()) {
     m_httpd->Stop();
@@ -123,11 +161,23 @@ OlaServer::~OlaServer() {
   // Order is important during shutdown.
   // Shutdown the RPC server first since it depends on almost everything else.
   m_rpc_server.reset();
+  m_timecode_generator.reset();
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
-    m_ss->RemoveTimeout(m_housekeeping_timeout);
+    m_ss->RemovePeriodicTask(m_housekeeping_timeout);
+  }
+  if (m_refresh_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemovePeriodicTask(m_refresh_timeout);
+  }
+  if (m_universe_info_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_universe_info_timeout);
+    m_universe_info_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  if (m_universe_store.get()) {
+    m_universe_store->SetInfoChangedCallback(NULL);
   }
 
+  m_interface_watcher.reset();
   StopPlugins();
 
   m_broker.reset();
@@ -137,6 +187,14 @@ OlaServer::~OlaServer() {
     m_universe_store->DeleteAll();
     m_universe_store.reset();
   }
+  // The targets have the soft patch as a source client.
+  m_soft_patch.reset();
+  if (m_universe_shared_memory.get()) {
+    m_universe_shared_memory->Unlink();
+    m_universe_shared_memory.reset();
+  }
+  // This flushes the last of the show log, so it's done after the universes.
+  m_show_logger.reset();
 
   if (m_server_preferences) {
     m_server_preferences->Save();
@@ -151,6 +209,11 @@ OlaServer::~OlaServer() {
   m_device_manager.reset();
   m_plugin_manager.reset();
   m_service_impl.reset();
+
+  if (m_options.dmx_buffer_pool_size) {
+    // The export map may be about to go away, the pool lives on.
+    ola::dmx::DmxBufferPool::Global()->SetExportMap(NULL);
+  }
 }
 
 bool OlaServer::Init() {
@@ -167,10 +230,21 @@ bool OlaServer::Init() {
     return false;
   }
 
-  auto_ptr<const RootPidStore> pid_store(
-      RootPidStore::LoadFromDirectory(m_options.pid_data_dir));
-  if (!pid_store.get()) {
-    OLA_WARN << "No PID definitions loaded";
+  // This needs to happen before the plugins start any threads.
+  if (m_options.dmx_buffer_pool_size) {
+    ola::dmx::DmxBufferPool *pool = ola::dmx::DmxBufferPool::Global();
+    pool->SetMaxFreeBlocks(m_options.dmx_buffer_pool_size);
+    pool->SetExportMap(m_export_map);
+    OLA_INFO << "Using a pool of " << m_options.dmx_buffer_pool_size
+             << " DMX buffers";
+  }
+
+  auto_ptr<const RootPidStore> pid_store;
+  if (m_options.load_pid_store) {
+    pid_store.reset(RootPidStore::LoadFromDirectory(m_options.pid_data_dir));
+    if (!pid_store.get()) {
+      OLA_WARN << "No PID definitions loaded";
+    }
   }
 
 #ifndef _WIN32
@@ -209,8 +283,72 @@ bool OlaServer::Init() {
       UNIVERSE_PREFERENCES);
   universe_preferences->Load();
 
+  // The scheduler must outlive the universes.
+  auto_ptr<OutputScheduler> output_scheduler;
+  if (m_options.output_tick_ms) {
+    output_scheduler.reset(new OutputScheduler(
+        m_ss, TimeInterval(m_options.output_tick_ms * ONE_THOUSAND)));
+  }
+  // Sources are timestamped with the loop clock, so the deadlines use it too.
+  auto_ptr<SourceExpiryScheduler> source_expiry_scheduler(
+      new SourceExpiryScheduler(m_ss, m_ss->LoopClock()));
+
+  auto_ptr<ShowLogger> show_logger;
+  if (!m_options.show_log_dir.empty()) {
+    ShowLogger::Options show_log_options;
+    show_log_options.directory = m_options.show_log_dir;
+    show_log_options.segment_length = K_SHOW_LOG_SEGMENT_S;
+    // The current file is partly written, so keep one more.
+    show_log_options.segments =
+        m_options.show_log_minutes * 60 / K_SHOW_LOG_SEGMENT_S + 1;
+    show_logger.reset(new ShowLogger(show_log_options));
+    if (!show_logger->Start()) {
+      OLA_WARN << "Failed to start the show logger";
+      return false;
+    }
+  }
+
+  // Restore the snapshot before the plugins start, so the universes have
+  // their data as soon as the ports are patched.
+  auto_ptr<DmxSnapshot> dmx_snapshot;
+  if (!m_options.dmx_snapshot_file.empty()) {
+    dmx_snapshot.reset(new DmxSnapshot(m_options.dmx_snapshot_file));
+    dmx_snapshot->Load();
+    if (!dmx_snapshot->Start()) {
+      OLA_WARN << "Failed to start the DMX snapshot writer";
+      return false;
+    }
+  }
+
+  auto_ptr<ola::dmx::UniverseSharedMemory> universe_shared_memory;
+  if (m_options.universe_shared_memory_slots) {
+    universe_shared_memory.reset(ola::dmx::UniverseSharedMemory::Create(
+        ola::dmx::UniverseSharedMemory::DEFAULT_NAME,
+        m_options.universe_shared_memory_slots));
+    if (!universe_shared_memory.get()) {
+      OLA_WARN << "Failed to create the universe shared memory segment";
+    }
+  }
+
   auto_ptr<UniverseStore> universe_store(
       new UniverseStore(universe_preferences, m_export_map));
+  universe_store->SetOutputScheduler(output_scheduler.get());
+  universe_store->SetSourceExpiryScheduler(source_expiry_scheduler.get());
+  universe_store->SetFrameRecorder(show_logger.get());
+  universe_store->SetDmxSnapshot(dmx_snapshot.get());
+  universe_store->SetSharedMemory(universe_shared_memory.get());
+  universe_store->SetLoopClock(m_ss->LoopClock());
+
+  // The soft patch is only installed if there are patches.
+  auto_ptr<SoftPatch> soft_patch(new SoftPatch(universe_store.get()));
+  Preferences *soft_patch_preferences = m_preferences_factory->NewPreference(
+      SOFT_PATCH_PREFERENCES);
+  soft_patch_preferences->Load();
+  if (soft_patch->Load(*soft_patch_preferences)) {
+    universe_store->SetSoftPatch(soft_patch.get());
+  } else {
+    soft_patch.reset();
+  }
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -226,9 +364,24 @@ bool OlaServer::Init() {
       new PluginAdaptor(device_manager.get(), m_ss, m_export_map,
                         m_preferences_factory, port_broker.get(),
                         &m_instance_name));
+  plugin_adaptor->SetUniverseStore(universe_store.get());
 
   auto_ptr<PluginManager> plugin_manager(
     new PluginManager(m_plugin_loaders, plugin_adaptor.get()));
+  plugin_manager->SetScheduler(m_ss);
+
+  auto_ptr<TimeCodeGenerator> timecode_generator(new TimeCodeGenerator(
+      m_ss, NewCallback(device_manager.get(), &DeviceManager::SendTimeCode)));
+  if (m_options.timecode_shared_memory) {
+    ola::timecode::TimeCodeSharedMemory *memory =
+        ola::timecode::TimeCodeSharedMemory::Create(
+            ola::timecode::TimeCodeSharedMemory::DEFAULT_NAME);
+    if (memory) {
+      timecode_generator->SetSharedMemory(memory);
+    } else {
+      OLA_WARN << "Failed to create the timecode shared memory segment";
+    }
+  }
 
   auto_ptr<OlaServerServiceImpl> service_impl(new OlaServerServiceImpl(
       universe_store.get(),
@@ -238,6 +391,13 @@ bool OlaServer::Init() {
       broker.get(),
       m_ss->WakeUpTime(),
       NewCallback(this, &OlaServer::ReloadPluginsInternal)));
+  service_impl->SetTimeCodeGenerator(
+      timecode_generator.get(),
+      TimeInterval(m_options.timecode_freewheel_ms * ONE_THOUSAND));
+  service_impl->SetUniverseInfoCallback(
+      NewCallback(this, &OlaServer::UniverseInfoChanged));
+  universe_store->SetInfoChangedCallback(
+      NewCallback(this, &OlaServer::UniverseInfoChanged));
 
   // Initialize the RPC server.
   RpcServer::Options rpc_options;
@@ -304,22 +464,49 @@ bool OlaServer::Init() {
   m_port_manager.reset(port_manager.release());
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
+  m_output_scheduler.reset(output_scheduler.release());
+  m_source_expiry_scheduler.reset(source_expiry_scheduler.release());
+  m_show_logger.reset(show_logger.release());
+  m_dmx_snapshot.reset(dmx_snapshot.release());
+  m_timecode_generator.reset(timecode_generator.release());
+  m_soft_patch.reset(soft_patch.release());
+  m_universe_shared_memory.reset(universe_shared_memory.release());
   m_universe_store.reset(universe_store.release());
 
   UpdatePidStore(pid_store.release());
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
-    m_ss->RemoveTimeout(m_housekeeping_timeout);
+    m_ss->RemovePeriodicTask(m_housekeeping_timeout);
   }
 
-  m_housekeeping_timeout = m_ss->RegisterRepeatingTimeout(
-      K_HOUSEKEEPING_TIMEOUT_MS,
+  m_housekeeping_timeout = m_ss->RegisterPeriodicTask(
+      TimeInterval(K_HOUSEKEEPING_TIMEOUT_MS * ONE_THOUSAND),
       ola::NewCallback(this, &OlaServer::RunHousekeeping));
 
-  // The plugin load procedure can take a while so we run it in the main loop.
+  if (m_refresh_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemovePeriodicTask(m_refresh_timeout);
+  }
+  m_refresh_timeout = m_ss->RegisterPeriodicTask(
+      TimeInterval(K_OUTPUT_REFRESH_TICK_MS * ONE_THOUSAND),
+      ola::NewCallback(this, &OlaServer::RefreshOutputs));
+
+  // The plugin load procedure can take a while so we run it in the main loop,
+  // the plugins are then started one at a time so clients are served in the
+  // meantime.
   m_ss->Execute(
       ola::NewSingleCallback(m_plugin_manager.get(), &PluginManager::LoadAll));
 
+  // Plugins bind to the addresses that were configured when they started, so
+  // restart them if the addresses change.
+  if (FLAGS_reload_on_interface_change) {
+    m_interface_watcher.reset(new ola::network::InterfaceWatcher(
+        m_ss, NewCallback(this, &OlaServer::ReloadPluginsInternal)));
+    if (!m_interface_watcher->Start()) {
+      OLA_WARN << "Unable to watch for network interface changes";
+      m_interface_watcher.reset();
+    }
+  }
+
   return true;
 }
 
@@ -366,6 +553,9 @@ void OlaServer::ClientRemoved(RpcSession *session) {
   session->SetData(NULL);
 
   m_broker->RemoveClient(client.get());
+  if (m_service_impl.get()) {
+    m_service_impl->RemoveClient(client.get());
+  }
 
   vector<Universe*> universe_list;
   m_universe_store->GetList(&universe_list);
@@ -378,12 +568,61 @@ void OlaServer::ClientRemoved(RpcSession *session) {
   }
 }
 
+/*
+ * Schedule an update for the clients subscribed to the universe info.
+ */
+void OlaServer::UniverseInfoChanged() {
+  if (m_universe_info_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+  m_universe_info_timeout = m_ss->RegisterRepeatingTimeout(
+      K_UNIVERSE_INFO_DELAY_MS,
+      ola::NewCallback(this, &OlaServer::SendUniverseInfo));
+}
+
+/*
+ * Send the universe info updates, this keeps running until every subscribed
+ * client has caught up.
+ */
+bool OlaServer::SendUniverseInfo() {
+  if (m_service_impl.get() && m_service_impl->SendUniverseInfoUpdates()) {
+    return true;
+  }
+  m_universe_info_timeout = ola::thread::INVALID_TIMEOUT;
+  return false;
+}
+
 /*
  * Run the garbage collector
  */
 bool OlaServer::RunHousekeeping() {
   OLA_DEBUG << "Garbage collecting";
-  m_universe_store->GarbageCollectUniverses();
+  m_universe_store->GarbageCollectUniverses(K_UNIVERSE_GC_LIMIT);
+
+  m_export_map->GetIntegerVar(K_LOG_DROPPED_VAR)->Set(ola::DroppedLogLines());
+  m_export_map->GetIntegerVar(K_LOG_SUPPRESSED_VAR)->Set(
+      ola::SuppressedLogLines());
+  if (m_show_logger.get()) {
+    m_export_map->GetIntegerVar(K_SHOW_LOG_DROPPED_VAR)->Set(
+        m_show_logger->Dropped());
+  }
+  m_export_map->GetIntegerVar(K_TIMECODE_SKIPPED_VAR)->Set(
+      m_timecode_generator->SkippedFrames());
+
+  std::map<std::string, uint64_t> thread_times;
+  if (ola::thread::GetThreadCPUTimes(&thread_times)) {
+    UIntMap *thread_cpu = m_export_map->GetUIntMapVar(K_THREAD_CPU_VAR,
+                                                      "thread");
+    std::map<std::string, uint64_t>::const_iterator iter;
+    for (iter = thread_times.begin(); iter != thread_times.end(); ++iter) {
+      (*thread_cpu)[iter->first] = static_cast<unsigned int>(
+          iter->second / 1000);
+    }
+  }
+
+  if (m_dmx_snapshot.get()) {
+    SaveDmxSnapshot();
+  }
 
   // Give the universes an opportunity to run discovery
   vector<Universe*> universes;
@@ -392,7 +631,7 @@ bool OlaServer::RunHousekeeping() {
   vector<Universe*>::iterator iter = universes.begin();
   const TimeStamp *now = m_ss->WakeUpTime();
   for (; iter != universes.end(); ++iter) {
-    (*iter)->CleanStaleSourceClients();
+    (*iter)->ExportMemoryUsage();
     if ((*iter)->IsActive() &&
         (*iter)->RDMDiscoveryInterval().Seconds() &&
         *now - (*iter)->LastRDMDiscovery() > (*iter)->RDMDiscoveryInterval()) {
@@ -403,6 +642,26 @@ bool OlaServer::RunHousekeeping() {
   return true;
 }
 
+/*
+ * Resend the last frame on universes that haven't had an update for a while.
+ */
+bool OlaServer::RefreshOutputs() {
+  vector<Universe*> universes;
+  m_universe_store->GetList(&universes);
+  const TimeStamp *now = m_ss->WakeUpTime();
+  vector<Universe*>::iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    (*iter)->RefreshOutputs(*now);
+  }
+  return true;
+}
+
+void OlaServer::SaveDmxSnapshot() {
+  vector<Universe*> universes;
+  m_universe_store->GetList(&universes);
+  m_dmx_snapshot->Save(universes);
+}
+
 #ifdef HAVE_LIBMICROHTTPD
 bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
                                 const ola::network::Interface &iface) {
@@ -424,6 +683,10 @@ bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
   options.data_dir = (m_options.http_data_dir.empty() ? HTTP_DATA_DIR :
                       m_options.http_data_dir);
   options.enable_quit = m_options.http_enable_quit;
+  options.trace_events = m_options.trace_events;
+  options.rdm_cache_preferences = m_preferences_factory->NewPreference(
+      RDM_CACHE_PREFERENCES);
+  options.rdm_cache_preferences->Load();
 
   auto_ptr<OladHTTPServer> httpd(
       new OladHTTPServer(m_export_map, options,
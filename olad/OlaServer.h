@@ -30,6 +30,7 @@
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServer.h>
 #include <ola/network/InterfacePicker.h>
+#include <ola/network/InterfaceWatcher.h>
 #include <ola/network/Socket.h>
 #include <ola/network/TCPSocketFactory.h>
 #include <ola/plugin_id.h>
@@ -44,6 +45,10 @@
 
 namespace ola {
 
+namespace dmx {
+class UniverseSharedMemory;
+}
+
 namespace rpc {
 class RpcSession;
 class RpcServer;
@@ -72,6 +77,46 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
     std::string http_data_dir;
     std::string network_interface;
     std::string pid_data_dir;  /** @brief Directory with the PID definitions */
+    /**
+     * @brief Load the PID definitions at startup. If false they're loaded by
+     *   ReloadPidStore().
+     */
+    bool load_pid_store;
+    /** @brief The number of trace events to keep for each thread */
+    unsigned int trace_events;
+    /** @brief Number of free DmxBuffer blocks to keep, 0 disables the pool */
+    unsigned int dmx_buffer_pool_size;
+    /**
+     * @brief Tick for universes with a max frame rate, in ms. 0 disables the
+     *   output scheduler.
+     */
+    unsigned int output_tick_ms;
+    /** @brief CPU to pin the main SelectServer thread to, -1 for none */
+    int loop_cpu;
+    /**
+     * @brief Directory to log the frames sent by the universes to. Empty
+     *   disables show logging.
+     */
+    std::string show_log_dir;
+    /** @brief The number of minutes of show logs to keep */
+    unsigned int show_log_minutes;
+    /** @brief Publish the timecode to shared memory */
+    bool timecode_shared_memory;
+    /**
+     * @brief How long to keep chasing timecode after the last frame from a
+     *   client, in ms. 0 sends each frame as is.
+     */
+    unsigned int timecode_freewheel_ms;
+    /**
+     * @brief The file to save the DMX data for each universe to, so it can be
+     *   restored on start. Empty disables the snapshot.
+     */
+    std::string dmx_snapshot_file;
+    /**
+     * @brief The number of universes to publish the output of to shared
+     *   memory. 0 disables the segment.
+     */
+    unsigned int universe_shared_memory_slots;
   };
 
   /**
@@ -185,7 +230,14 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<class DeviceManager> m_device_manager;
   std::auto_ptr<class PluginManager> m_plugin_manager;
   std::auto_ptr<class PluginAdaptor> m_plugin_adaptor;
+  std::auto_ptr<class ShowLogger> m_show_logger;
+  std::auto_ptr<class DmxSnapshot> m_dmx_snapshot;
+  std::auto_ptr<class TimeCodeGenerator> m_timecode_generator;
+  std::auto_ptr<class OutputScheduler> m_output_scheduler;
+  std::auto_ptr<class SourceExpiryScheduler> m_source_expiry_scheduler;
   std::auto_ptr<class UniverseStore> m_universe_store;
+  std::auto_ptr<class SoftPatch> m_soft_patch;
+  std::auto_ptr<ola::dmx::UniverseSharedMemory> m_universe_shared_memory;
   std::auto_ptr<class PortManager> m_port_manager;
   std::auto_ptr<class OlaServerServiceImpl> m_service_impl;
   std::auto_ptr<class ClientBroker> m_broker;
@@ -193,14 +245,21 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<const ola::rdm::RootPidStore> m_pid_store;
   std::auto_ptr<class DiscoveryAgentInterface> m_discovery_agent;
   std::auto_ptr<ola::rpc::RpcServer> m_rpc_server;
+  std::auto_ptr<ola::network::InterfaceWatcher> m_interface_watcher;
   class Preferences *m_server_preferences;
   class Preferences *m_universe_preferences;
   std::string m_instance_name;
 
   ola::thread::timeout_id m_housekeeping_timeout;
+  ola::thread::timeout_id m_refresh_timeout;
+  ola::thread::timeout_id m_universe_info_timeout;
   std::auto_ptr<OladHTTPServer_t> m_httpd;
 
   bool RunHousekeeping();
+  bool RefreshOutputs();
+  void UniverseInfoChanged();
+  bool SendUniverseInfo();
+  void SaveDmxSnapshot();
 
 #ifdef HAVE_LIBMICROHTTPD
   bool StartHttpServer(ola::rpc::RpcServer *server,
@@ -221,10 +280,23 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   static const char INSTANCE_NAME_KEY[];
   static const char K_INSTANCE_NAME_VAR[];
   static const char K_DISCOVERY_SERVICE_TYPE[];
+  static const char K_LOG_DROPPED_VAR[];
+  static const char K_LOG_SUPPRESSED_VAR[];
+  static const char K_SHOW_LOG_DROPPED_VAR[];
+  static const char K_THREAD_CPU_VAR[];
+  static const char K_TIMECODE_SKIPPED_VAR[];
   static const char K_UID_VAR[];
   static const char SERVER_PREFERENCES[];
   static const char UNIVERSE_PREFERENCES[];
+  static const char RDM_CACHE_PREFERENCES[];
+  static const char SOFT_PATCH_PREFERENCES[];
   static const unsigned int K_HOUSEKEEPING_TIMEOUT_MS;
+  static const unsigned int K_OUTPUT_REFRESH_TICK_MS;
+  // Universe info changes within this time are sent in a single update.
+  static const unsigned int K_UNIVERSE_INFO_DELAY_MS;
+  // The maximum number of universes deleted on each housekeeping run.
+  static const unsigned int K_UNIVERSE_GC_LIMIT;
+  static const unsigned int K_SHOW_LOG_SEGMENT_S;
 
   DISALLOW_COPY_AND_ASSIGN(OlaServer);
 };
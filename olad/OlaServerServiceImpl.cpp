@@ -19,15 +19,19 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <stdint.h>
 #include <algorithm>
+#include <set>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
 #include "common/rpc/RpcSession.h"
 #include "ola/Callback.h"
 #include "ola/CallbackRunner.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/dmx/DmxSharedMemory.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/strings/Format.h"
@@ -40,6 +44,7 @@
 #include "olad/Plugin.h"
 #include "olad/PluginManager.h"
 #include "olad/Port.h"
+#include "olad/TimeCodeGenerator.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
@@ -56,6 +61,7 @@ using ola::proto::DeviceInfo;
 using ola::proto::DeviceInfoReply;
 using ola::proto::DeviceInfoRequest;
 using ola::proto::DmxData;
+using ola::proto::DmxDataBatch;
 using ola::proto::MergeModeRequest;
 using ola::proto::OptionalUniverseRequest;
 using ola::proto::PatchPortRequest;
@@ -66,8 +72,12 @@ using ola::proto::PluginListReply;
 using ola::proto::PluginListRequest;
 using ola::proto::PortInfo;
 using ola::proto::RegisterDmxRequest;
+using ola::proto::SharedMemoryNotification;
+using ola::proto::SharedMemoryRequest;
+using ola::proto::UniverseBatchRequest;
 using ola::proto::UniverseInfo;
 using ola::proto::UniverseInfoReply;
+using ola::proto::UniverseInfoSubscription;
 using ola::proto::UniverseNameRequest;
 using ola::proto::UniverseRequest;
 using ola::rdm::RDMRequest;
@@ -75,6 +85,7 @@ using ola::rdm::RDMResponse;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
+using std::set;
 using std::string;
 using std::vector;
 
@@ -106,8 +117,80 @@ RDMRequest::OverrideOptions RDMRequestOptionsFromProto(
   }
   return options;
 }
+
+/*
+ * Build a Get or Set request from the RDMRequest message.
+ */
+ola::rdm::RDMRequest *NewRDMRequest(const Client &client,
+                                    const ola::proto::RDMRequest &request,
+                                    bool bulk) {
+  UID destination(request.uid().esta_id(),
+                  request.uid().device_id());
+
+  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(request);
+
+  RDMRequest *rdm_request;
+  if (request.is_set()) {
+    rdm_request = new ola::rdm::RDMSetRequest(
+        client.GetUID(),
+        destination,
+        0,  // transaction #
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  } else {
+    rdm_request = new ola::rdm::RDMGetRequest(
+        client.GetUID(),
+        destination,
+        0,  // transaction #
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  }
+
+  RDMRequest::Scheduling scheduling;
+  scheduling.bulk = bulk || request.bulk();
+  scheduling.originator = client.Id();
+  rdm_request->SetScheduling(scheduling);
+  return rdm_request;
+}
 }  // namespace
 
+/*
+ * The state of an RDMBatchCommand RPC.
+ */
+struct OlaServerServiceImpl::RDMBatch {
+  RDMBatch(Client *client,
+           const ola::proto::RDMBatchRequest *request,
+           ola::proto::RDMBatchResponse *response,
+           ola::rpc::RpcService::CompletionCallback *done)
+      : client(client),
+        request(request),
+        response(response),
+        done(done),
+        next(0),
+        in_flight(0),
+        dispatching(false) {
+  }
+
+  Client *client;
+  const ola::proto::RDMBatchRequest *request;
+  ola::proto::RDMBatchResponse *response;
+  ola::rpc::RpcService::CompletionCallback *done;
+  int next;  // the index of the next request to send
+  unsigned int in_flight;
+  bool dispatching;
+};
+
+const unsigned int OlaServerServiceImpl::MAX_RDM_BATCH_SIZE;
+const unsigned int OlaServerServiceImpl::MAX_RDM_BATCH_IN_FLIGHT;
+
 typedef CallbackRunner<ola::rpc::RpcService::CompletionCallback> ClosureRunner;
 
 OlaServerServiceImpl::OlaServerServiceImpl(
@@ -124,7 +207,45 @@ OlaServerServiceImpl::OlaServerServiceImpl(
       m_port_manager(port_manager),
       m_broker(broker),
       m_wake_up_time(wake_up_time),
-      m_reload_plugins_callback(reload_plugins_callback) {
+      m_reload_plugins_callback(reload_plugins_callback),
+      m_timecode_generator(NULL) {
+}
+
+void OlaServerServiceImpl::SetUniverseInfoCallback(
+    UniverseInfoCallback *callback) {
+  m_universe_info_callback.reset(callback);
+}
+
+bool OlaServerServiceImpl::SendUniverseInfoUpdates() {
+  const uint64_t version = m_universe_store->InfoVersion();
+  bool pending = false;
+  set<Client*>::iterator iter = m_universe_info_clients.begin();
+  for (; iter != m_universe_info_clients.end(); ++iter) {
+    Client *client = *iter;
+    if (client->UniverseInfoVersion() == version) {
+      continue;
+    }
+    if (client->UniverseInfoInFlight()) {
+      pending = true;
+      continue;
+    }
+    UniverseInfoReply update;
+    ListUniverses(client->UniverseInfoVersion(), 0, 0,
+                  client->UniverseInfoIncludesPorts(), &update);
+    client->SendUniverseInfo(update);
+  }
+  return pending;
+}
+
+void OlaServerServiceImpl::RemoveClient(Client *client) {
+  m_universe_info_clients.erase(client);
+}
+
+void OlaServerServiceImpl::SetTimeCodeGenerator(
+    TimeCodeGenerator *generator,
+    const TimeInterval &freewheel) {
+  m_timecode_generator = generator;
+  m_timecode_freewheel = freewheel;
 }
 
 void OlaServerServiceImpl::GetDmx(
@@ -143,12 +264,34 @@ void OlaServerServiceImpl::GetDmx(
   response->set_universe(request->universe());
 }
 
+void OlaServerServiceImpl::GetDmxBatch(
+    RpcController*,
+    const UniverseBatchRequest* request,
+    DmxDataBatch* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  for (int i = 0; i < request->universe_size(); i++) {
+    Universe *universe = m_universe_store->GetUniverse(request->universe(i));
+    if (!universe) {
+      continue;
+    }
+    DmxData *data = response->add_data();
+    data->set_universe(request->universe(i));
+    data->set_data(universe->GetDMX().Get());
+  }
+}
+
 void OlaServerServiceImpl::RegisterForDmx(
     RpcController* controller,
     const RegisterDmxRequest* request,
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
+  if (request->start_slot() >= DMX_UNIVERSE_SIZE) {
+    controller->SetFailed("Invalid start slot");
+    return;
+  }
+
   Universe *universe = m_universe_store->GetUniverseOrCreate(
       request->universe());
   if (!universe) {
@@ -157,9 +300,16 @@ void OlaServerServiceImpl::RegisterForDmx(
 
   Client *client = GetClient(controller);
   if (request->action() == ola::proto::REGISTER) {
+    SinkOptions options;
+    options.max_rate = request->max_rate();
+    options.changes_only = request->changes_only();
+    options.start_slot = request->start_slot();
+    options.slot_count = request->slot_count();
+    client->SetSinkOptions(universe->UniverseId(), options);
     universe->AddSinkClient(client);
   } else {
     universe->RemoveSinkClient(client);
+    client->ClearSinkOptions(universe->UniverseId());
   }
 }
 
@@ -196,27 +346,73 @@ void OlaServerServiceImpl::StreamDmxData(
     const ola::proto::DmxData* request,
     ola::proto::STREAMING_NO_RESPONSE*,
     ola::rpc::RpcService::CompletionCallback*) {
-  Universe *universe = m_universe_store->GetUniverse(request->universe());
+  DmxBuffer buffer;
+  buffer.Set(request->data());
+  ClientDMXReceived(GetClient(controller), request->universe(), buffer,
+                    request->has_priority() ?
+                    request->priority() : ola::dmx::SOURCE_PRIORITY_DEFAULT);
+}
 
-  if (!universe) {
+void OlaServerServiceImpl::StreamDmxDataBatch(
+    RpcController* controller,
+    const DmxDataBatch* request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
+  Client *client = GetClient(controller);
+  DmxBuffer buffer;
+  for (int i = 0; i < request->data_size(); i++) {
+    const DmxData &data = request->data(i);
+    buffer.Set(data.data());
+    ClientDMXReceived(client, data.universe(), buffer,
+                      data.has_priority() ?
+                      data.priority() : ola::dmx::SOURCE_PRIORITY_DEFAULT);
+  }
+}
+
+void OlaServerServiceImpl::RegisterSharedMemory(
+    RpcController* controller,
+    const SharedMemoryRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  if (!ola::dmx::DmxSharedMemory::IsValidName(request->name())) {
+    controller->SetFailed("Invalid shared memory name");
+    return;
+  }
+
+  ola::dmx::DmxSharedMemory *memory =
+      ola::dmx::DmxSharedMemory::Open(request->name());
+  if (!memory) {
+    controller->SetFailed("Failed to open shared memory");
     return;
   }
+  OLA_INFO << "Client is using shared memory " << request->name() << " with "
+           << memory->SlotCount() << " universes";
+  GetClient(controller)->SetSharedMemory(memory);
+}
 
+void OlaServerServiceImpl::SharedMemoryUpdated(
+    RpcController* controller,
+    const SharedMemoryNotification*,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    ola::rpc::RpcService::CompletionCallback*) {
   Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
+  ola::dmx::DmxSharedMemory *memory = client->SharedMemory();
+  if (!memory) {
+    return;
+  }
 
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
+  // Clear the doorbell first, so the client rings it again for any slots
+  // it updates while we're reading.
+  memory->ClearDoorbell();
+  DmxBuffer buffer;
+  for (unsigned int slot = 0; slot < memory->SlotCount(); slot++) {
+    unsigned int universe_id;
+    uint8_t priority;
+    if (memory->Read(slot, &universe_id, &priority, &buffer)) {
+      ClientDMXReceived(client, universe_id, buffer, priority);
+    }
   }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
 }
 
 void OlaServerServiceImpl::SetUniverseName(
@@ -292,6 +488,47 @@ void OlaServerServiceImpl::PatchPort(
   }
 }
 
+void OlaServerServiceImpl::PatchPortBatch(
+    RpcController* controller,
+    const ola::proto::PatchPortBatchRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+
+  // Look up all the ports first, so nothing is changed if one is missing.
+  vector<PortManager::PortPatch> patches;
+  patches.reserve(request->patch_size());
+  for (int i = 0; i < request->patch_size(); i++) {
+    const PatchPortRequest &patch_request = request->patch(i);
+    AbstractDevice *device =
+      m_device_manager->GetDevice(patch_request.device_alias());
+    if (!device) {
+      return MissingDeviceError(controller);
+    }
+
+    const bool patch = patch_request.action() == ola::proto::PATCH;
+    if (patch_request.is_output()) {
+      OutputPort *port = device->GetOutputPort(patch_request.port_id());
+      if (!port) {
+        return MissingPortError(controller);
+      }
+      patches.push_back(
+          PortManager::PortPatch(port, patch, patch_request.universe()));
+    } else {
+      InputPort *port = device->GetInputPort(patch_request.port_id());
+      if (!port) {
+        return MissingPortError(controller);
+      }
+      patches.push_back(
+          PortManager::PortPatch(port, patch, patch_request.universe()));
+    }
+  }
+
+  if (!m_port_manager->PatchPorts(patches)) {
+    controller->SetFailed("Patch port request failed");
+  }
+}
+
 void OlaServerServiceImpl::SetPortPriority(
     RpcController* controller,
     const ola::proto::PortPriorityRequest* request,
@@ -322,6 +559,7 @@ void OlaServerServiceImpl::SetPortPriority(
     }
   }
 
+  Universe *universe = NULL;
   if (request->is_output()) {
     OutputPort *port = device->GetOutputPort(request->port_id());
     if (!port) {
@@ -333,6 +571,7 @@ void OlaServerServiceImpl::SetPortPriority(
     } else {
       status = m_port_manager->SetPriorityStatic(port, value);
     }
+    universe = port->GetUniverse();
   } else {
     InputPort *port = device->GetInputPort(request->port_id());
     if (!port) {
@@ -344,17 +583,47 @@ void OlaServerServiceImpl::SetPortPriority(
     } else {
       status = m_port_manager->SetPriorityStatic(port, value);
     }
+    universe = port->GetUniverse();
   }
 
   if (!status) {
     controller->SetFailed(
         "Invalid SetPortPriority request, see logs for more info");
+  } else if (universe) {
+    universe->InfoChanged();
+  }
+}
+
+void OlaServerServiceImpl::SetPortMaxFrameRate(
+    RpcController* controller,
+    const ola::proto::PortFrameRateRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  AbstractDevice *device =
+      m_device_manager->GetDevice(request->device_alias());
+
+  if (!device) {
+    return MissingDeviceError(controller);
+  }
+
+  OutputPort *port = device->GetOutputPort(request->port_id());
+  if (!port) {
+    return MissingPortError(controller);
+  }
+
+  if (request->max_frame_rate() < 0 ||
+      !port->SetMaxFrameRate(request->max_frame_rate())) {
+    controller->SetFailed("Invalid max frame rate");
+  } else if (port->GetUniverse()) {
+    port->GetUniverse()->InfoChanged();
   }
 }
 
 void OlaServerServiceImpl::AddUniverse(
     const Universe * universe,
-    ola::proto::UniverseInfoReply *universe_info_reply) const {
+    ola::proto::UniverseInfoReply *universe_info_reply,
+    bool include_ports) const {
   UniverseInfo *universe_info = universe_info_reply->add_universe();
   universe_info->set_universe(universe->UniverseId());
   universe_info->set_name(universe->Name());
@@ -363,6 +632,9 @@ void OlaServerServiceImpl::AddUniverse(
   universe_info->set_input_port_count(universe->InputPortCount());
   universe_info->set_output_port_count(universe->OutputPortCount());
   universe_info->set_rdm_devices(universe->UIDCount());
+  if (!include_ports) {
+    return;
+  }
 
   std::vector<InputPort*> input_ports;
   std::vector<InputPort*>::const_iterator input_it;
@@ -381,7 +653,7 @@ void OlaServerServiceImpl::AddUniverse(
        output_it != output_ports.end();
        output_it++) {
     PortInfo *pi = universe_info->add_output_ports();
-    PopulatePort(**output_it, pi);
+    PopulateOutputPort(**output_it, pi);
   }
 }
 
@@ -401,13 +673,74 @@ void OlaServerServiceImpl::GetUniverseInfo(
 
     AddUniverse(universe, response);
   } else {
-    // return all
-    vector<Universe*> uni_list;
-    m_universe_store->GetList(&uni_list);
-    vector<Universe*>::const_iterator iter;
+    ListUniverses(request->since_version(),
+                  std::max(request->start_universe(), 0),
+                  request->max_universes(),
+                  request->include_ports(),
+                  response);
+  }
+}
+
+void OlaServerServiceImpl::RegisterForUniverseInfo(
+    RpcController* controller,
+    const UniverseInfoSubscription* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Client *client = GetClient(controller);
+  if (request->action() == ola::proto::REGISTER) {
+    client->SetUniverseInfoSubscription(request->include_ports(),
+                                        request->since_version());
+    m_universe_info_clients.insert(client);
+    if (m_universe_info_callback.get()) {
+      m_universe_info_callback->Run();
+    }
+  } else {
+    client->ClearUniverseInfoSubscription();
+    m_universe_info_clients.erase(client);
+  }
+}
+
+void OlaServerServiceImpl::ListUniverses(
+    uint64_t since_version,
+    unsigned int start_universe,
+    unsigned int max_universes,
+    bool include_ports,
+    UniverseInfoReply *response) const {
+  vector<unsigned int> removed;
+  bool full = !since_version ||
+              since_version > m_universe_store->InfoVersion() ||
+              !m_universe_store->GetRemovedSince(since_version, &removed);
+  response->set_version(m_universe_store->InfoVersion());
+  response->set_full(full);
+
+  // The list is sorted by universe-id.
+  vector<Universe*> uni_list;
+  m_universe_store->GetList(&uni_list);
+  unsigned int count = 0;
+  unsigned int end_universe = 0;  // 0 means the end of the list
+  vector<Universe*>::const_iterator iter = uni_list.begin();
+  for (; iter != uni_list.end(); ++iter) {
+    const Universe *universe = *iter;
+    if (universe->UniverseId() < start_universe ||
+        (!full && universe->InfoVersion() <= since_version)) {
+      continue;
+    }
+    if (max_universes && count == max_universes) {
+      end_universe = universe->UniverseId();
+      response->set_next_universe(end_universe);
+      break;
+    }
+    AddUniverse(universe, response, include_ports);
+    count++;
+  }
 
-    for (iter = uni_list.begin(); iter != uni_list.end(); ++iter) {
-      AddUniverse(*iter, response);
+  // Each page has the removals in its range of universe-ids.
+  vector<unsigned int>::const_iterator removed_iter = removed.begin();
+  for (; removed_iter != removed.end(); ++removed_iter) {
+    if (*removed_iter >= start_universe &&
+        (!end_universe || *removed_iter < end_universe)) {
+      response->add_removed_universe(*removed_iter);
     }
   }
 }
@@ -636,7 +969,7 @@ void OlaServerServiceImpl::GetCandidatePorts(
       }
 
       PortInfo *port_info = device_info->add_output_port();
-      PopulatePort(**output_iter, port_info);
+      PopulateOutputPort(**output_iter, port_info);
 
       if (!device->AllowMultiPortPatching()) {
         break;
@@ -721,37 +1054,7 @@ void OlaServerServiceImpl::RDMCommand(
   }
 
   Client *client = GetClient(controller);
-  UID source_uid = client->GetUID();
-
-  UID destination(request->uid().esta_id(),
-                  request->uid().device_id());
-
-  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(*request);
-
-  ola::rdm::RDMRequest *rdm_request = NULL;
-  if (request->is_set()) {
-    rdm_request = new ola::rdm::RDMSetRequest(
-        source_uid,
-        destination,
-        0,  // transaction #
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  } else {
-    rdm_request = new ola::rdm::RDMGetRequest(
-        source_uid,
-        destination,
-        0,  // transaction #
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  }
+  ola::rdm::RDMRequest *rdm_request = NewRDMRequest(*client, *request, false);
 
   ola::rdm::RDMCallback *callback =
     NewSingleCallback(
@@ -806,6 +1109,26 @@ void OlaServerServiceImpl::RDMDiscoveryCommand(
   m_broker->SendRDMRequest(client, universe, rdm_request, callback);
 }
 
+void OlaServerServiceImpl::RDMBatchCommand(
+    RpcController* controller,
+    const ola::proto::RDMBatchRequest* request,
+    ola::proto::RDMBatchResponse* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  if (static_cast<unsigned int>(request->request_size()) >
+      MAX_RDM_BATCH_SIZE) {
+    controller->SetFailed("Too many RDM requests in batch");
+    done->Run();
+    return;
+  }
+
+  for (int i = 0; i < request->request_size(); i++) {
+    response->add_response()->set_response_code(
+        ola::proto::RDM_FAILED_TO_SEND);
+  }
+
+  RunRDMBatch(new RDMBatch(GetClient(controller), request, response, done));
+}
+
 void OlaServerServiceImpl::SetSourceUID(
     RpcController *controller,
     const ola::proto::UID* request,
@@ -823,6 +1146,13 @@ void OlaServerServiceImpl::SendTimeCode(
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
+  if (request->action() == ola::proto::STOP_TIMECODE) {
+    if (m_timecode_generator) {
+      m_timecode_generator->Stop();
+    }
+    return;
+  }
+
   ola::timecode::TimeCode time_code(
       static_cast<ola::timecode::TimeCodeType>(request->type()),
       request->hours(),
@@ -830,10 +1160,21 @@ void OlaServerServiceImpl::SendTimeCode(
       request->seconds(),
       request->frames());
 
-  if (time_code.IsValid()) {
-    m_device_manager->SendTimeCode(time_code);
-  } else {
+  if (!time_code.IsValid()) {
     controller->SetFailed("Invalid TimeCode");
+    return;
+  }
+
+  if (request->action() == ola::proto::RUN_TIMECODE) {
+    if (m_timecode_generator) {
+      m_timecode_generator->Run(time_code);
+    } else {
+      controller->SetFailed("TimeCode generator not available");
+    }
+  } else if (m_timecode_generator && !m_timecode_freewheel.IsZero()) {
+    m_timecode_generator->Chase(time_code, m_timecode_freewheel);
+  } else {
+    m_device_manager->SendTimeCode(time_code);
   }
 }
 
@@ -850,6 +1191,68 @@ void OlaServerServiceImpl::HandleRDMResponse(
     bool include_raw_packets,
     ola::rdm::RDMReply *reply) {
   ClosureRunner runner(done);
+  RDMReplyToProto(reply, include_raw_packets, response);
+}
+
+/*
+ * Send the requests from an RDM batch, keeping up to MAX_RDM_BATCH_IN_FLIGHT
+ * outstanding so we don't overflow the port's queue. Once all the requests
+ * have completed, the batch is deleted.
+ */
+void OlaServerServiceImpl::RunRDMBatch(RDMBatch *batch) {
+  if (batch->dispatching) {
+    // One of the requests completed straight away, the loop below will send
+    // the next one.
+    return;
+  }
+
+  batch->dispatching = true;
+  while (batch->next < batch->request->request_size() &&
+         batch->in_flight < MAX_RDM_BATCH_IN_FLIGHT) {
+    const int index = batch->next++;
+    const ola::proto::RDMRequest &request = batch->request->request(index);
+    Universe *universe = m_universe_store->GetUniverse(request.universe());
+    if (!universe) {
+      // This is left as RDM_FAILED_TO_SEND.
+      continue;
+    }
+
+    batch->in_flight++;
+    m_broker->SendRDMRequest(
+        batch->client,
+        universe,
+        NewRDMRequest(*batch->client, request, true),
+        NewSingleCallback(this, &OlaServerServiceImpl::HandleRDMBatchResponse,
+                          batch, index));
+  }
+  batch->dispatching = false;
+
+  if (!batch->in_flight && batch->next >= batch->request->request_size()) {
+    batch->done->Run();
+    delete batch;
+  }
+}
+
+/*
+ * Called when a request in an RDM batch completes.
+ */
+void OlaServerServiceImpl::HandleRDMBatchResponse(
+    RDMBatch *batch,
+    int index,
+    ola::rdm::RDMReply *reply) {
+  RDMReplyToProto(reply, batch->request->request(index).include_raw_response(),
+                  batch->response->mutable_response(index));
+  batch->in_flight--;
+  RunRDMBatch(batch);
+}
+
+/*
+ * Copy an RDMReply into the RDMResponse message.
+ */
+void OlaServerServiceImpl::RDMReplyToProto(
+    ola::rdm::RDMReply *reply,
+    bool include_raw_packets,
+    ola::proto::RDMResponse *response) {
   response->set_response_code(
       static_cast<ola::proto::RDMResponseCode>(reply->StatusCode()));
 
@@ -937,6 +1340,27 @@ void OlaServerServiceImpl::RDMDiscoveryComplete(
 }
 
 
+/*
+ * Pass data from a streaming client to the universe.
+ */
+void OlaServerServiceImpl::ClientDMXReceived(Client *client,
+                                             unsigned int universe_id,
+                                             const DmxBuffer &buffer,
+                                             int priority) {
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+  if (!universe) {
+    return;
+  }
+
+  priority = std::max(static_cast<int>(ola::dmx::SOURCE_PRIORITY_MIN),
+                      priority);
+  priority = std::min(static_cast<int>(ola::dmx::SOURCE_PRIORITY_MAX),
+                      priority);
+  DmxSource source(buffer, *m_wake_up_time, priority);
+  client->DMXReceived(universe_id, source);
+  universe->SourceClientDataChanged(client);
+}
+
 void OlaServerServiceImpl::MissingUniverseError(RpcController* controller) {
   controller->SetFailed("Universe doesn't exist");
 }
@@ -1000,7 +1424,7 @@ void OlaServerServiceImpl::AddDevice(AbstractDevice *device,
   for (output_iter = output_ports.begin(); output_iter != output_ports.end();
       ++output_iter) {
     PortInfo *port_info = device_info->add_output_port();
-    PopulatePort(**output_iter, port_info);
+    PopulateOutputPort(**output_iter, port_info);
   }
 }
 
@@ -1029,6 +1453,13 @@ void OlaServerServiceImpl::PopulatePort(const PortClass &port,
   port_info->set_supports_rdm(port.SupportsRDM());
 }
 
+void OlaServerServiceImpl::PopulateOutputPort(const OutputPort &port,
+                                              PortInfo *port_info) const {
+  PopulatePort(port, port_info);
+  port_info->set_max_frame_rate(port.MaxFrameRate());
+  port_info->set_skipped_frames(port.SkippedFrames());
+}
+
 void OlaServerServiceImpl::SetProtoUID(const ola::rdm::UID &uid,
                                        ola::proto::UID *pb_uid) {
   pb_uid->set_esta_id(uid.ManufacturerId());
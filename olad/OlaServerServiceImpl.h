@@ -18,12 +18,16 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <stdint.h>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UID.h"
@@ -46,6 +50,8 @@ class Universe;
  * There is no client specific member data, so a single OlaServerServiceImpl
  * is created. Any OLA client data is passed via the user data in the
  * ola::rpc::RpcSession object, accessible via the ola::rpc::RpcController.
+ * The only exception is the set of clients subscribed to universe info
+ * updates, which the owner keeps up to date with RemoveClient().
  */
 class OlaServerServiceImpl : public ola::proto::OlaServerService {
  public:
@@ -54,6 +60,11 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
    */
   typedef Callback0<void> ReloadPluginsCallback;
 
+  /**
+   * @brief A Callback run when a client subscribes to universe info updates.
+   */
+  typedef Callback0<void> UniverseInfoCallback;
+
   /**
    * @brief Create a new OlaServerServiceImpl.
    */
@@ -67,6 +78,37 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
 
   ~OlaServerServiceImpl() {}
 
+  /**
+   * @brief Set the generator used for the RUN_TIMECODE & STOP_TIMECODE
+   *   actions.
+   * @param generator the TimeCodeGenerator, ownership is not transferred.
+   * @param freewheel if non-zero, frames sent by clients are chased by the
+   *   generator, which keeps going for this long after the last one.
+   */
+  void SetTimeCodeGenerator(class TimeCodeGenerator *generator,
+                            const TimeInterval &freewheel);
+
+  /**
+   * @brief Set the callback run when a client subscribes to universe info
+   *   updates.
+   * @param callback the callback, ownership is transferred. This should
+   *   arrange for SendUniverseInfoUpdates() to be called.
+   */
+  void SetUniverseInfoCallback(UniverseInfoCallback *callback);
+
+  /**
+   * @brief Send the changes to the universe info to the subscribed clients.
+   * @returns true if a client was still waiting to acknowledge an earlier
+   *   update and has changes to send, in which case this should be called
+   *   again later.
+   */
+  bool SendUniverseInfoUpdates();
+
+  /**
+   * @brief Called when a client disconnects.
+   */
+  void RemoveClient(class Client *client);
+
   /**
    * @brief Returns the current DMX values for a particular universe.
    */
@@ -75,6 +117,15 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
               ola::proto::DmxData* response,
               ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Returns the current DMX values for a set of universes. Universes
+   *   that don't exist are left out.
+   */
+  void GetDmxBatch(ola::rpc::RpcController* controller,
+                   const ola::proto::UniverseBatchRequest* request,
+                   ola::proto::DmxDataBatch* response,
+                   ola::rpc::RpcService::CompletionCallback* done);
+
 
   /**
    * @brief Register a client to receive DMX data.
@@ -99,6 +150,34 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                      ::ola::proto::STREAMING_NO_RESPONSE* response,
                      ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Handle a streaming DMX update for many universes, no response is
+   * sent.
+   */
+  void StreamDmxDataBatch(ola::rpc::RpcController* controller,
+                          const ::ola::proto::DmxDataBatch* request,
+                          ::ola::proto::STREAMING_NO_RESPONSE* response,
+                          ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Map the shared memory segment the client will send DMX data
+   * through.
+   */
+  void RegisterSharedMemory(ola::rpc::RpcController* controller,
+                            const ::ola::proto::SharedMemoryRequest* request,
+                            ::ola::proto::Ack* response,
+                            ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Read the universes that have changed in the client's shared memory
+   * segment, no response is sent.
+   */
+  void SharedMemoryUpdated(
+      ola::rpc::RpcController* controller,
+      const ::ola::proto::SharedMemoryNotification* request,
+      ::ola::proto::STREAMING_NO_RESPONSE* response,
+      ola::rpc::RpcService::CompletionCallback* done);
+
 
   /**
    * @brief Sets the name of a universe.
@@ -124,6 +203,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                  ola::proto::Ack* response,
                  ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Patch and unpatch a list of ports as a single change.
+   */
+  void PatchPortBatch(ola::rpc::RpcController* controller,
+                      const ola::proto::PatchPortBatchRequest* request,
+                      ola::proto::Ack* response,
+                      ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Set the priority of one or more ports.
    */
@@ -132,14 +219,34 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        ola::proto::Ack* response,
                        ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Limit the rate that DMX is written to an output port.
+   */
+  void SetPortMaxFrameRate(ola::rpc::RpcController* controller,
+                           const ola::proto::PortFrameRateRequest* request,
+                           ola::proto::Ack* response,
+                           ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Returns information on the active universes.
+   *
+   * When listing all universes, the reply can be split into pages and
+   * limited to the universes that changed since an earlier reply.
    */
   void GetUniverseInfo(ola::rpc::RpcController* controller,
                        const ola::proto::OptionalUniverseRequest* request,
                        ola::proto::UniverseInfoReply* response,
                        ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Register a client to have universe info changes pushed to it.
+   */
+  void RegisterForUniverseInfo(
+      ola::rpc::RpcController* controller,
+      const ola::proto::UniverseInfoSubscription* request,
+      ola::proto::Ack* response,
+      ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Return info on available plugins.
    */
@@ -243,6 +350,23 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                            ola::proto::RDMResponse* response,
                            ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Handle a batch of RDM Commands.
+   *
+   * The requests are sent in order, with a few outstanding at once so that
+   * the round trip time between them is hidden. The response is sent once
+   * all the requests have completed.
+   */
+  void RDMBatchCommand(ola::rpc::RpcController* controller,
+                       const ::ola::proto::RDMBatchRequest* request,
+                       ola::proto::RDMBatchResponse* response,
+                       ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief The largest number of requests in an RDM batch.
+   */
+  static const unsigned int MAX_RDM_BATCH_SIZE = 1024;
+
   /**
    * @brief Set this client's source UID.
    */
@@ -252,7 +376,7 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::rpc::RpcService::CompletionCallback* done);
 
   /**
-   * @brief Send Timecode
+   * @brief Send Timecode, or start or stop the timecode generator.
    */
   void SendTimeCode(ola::rpc::RpcController* controller,
                     const ::ola::proto::TimeCode* request,
@@ -260,10 +384,18 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::rpc::RpcService::CompletionCallback* done);
 
  private:
+  struct RDMBatch;
+
   void HandleRDMResponse(ola::proto::RDMResponse* response,
                          ola::rpc::RpcService::CompletionCallback* done,
                          bool include_raw_packets,
                          ola::rdm::RDMReply *reply);
+  void RunRDMBatch(RDMBatch *batch);
+  void HandleRDMBatchResponse(RDMBatch *batch, int index,
+                              ola::rdm::RDMReply *reply);
+  void RDMReplyToProto(ola::rdm::RDMReply *reply,
+                       bool include_raw_packets,
+                       ola::proto::RDMResponse *response);
   void RDMDiscoveryComplete(unsigned int universe,
                             ola::rpc::RpcService::CompletionCallback* done,
                             ola::proto::UIDListReply *response,
@@ -280,13 +412,23 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                  unsigned int alias,
                  ola::proto::DeviceInfoReply* response) const;
   void AddUniverse(const Universe *universe,
-                   ola::proto::UniverseInfoReply *universe_info_reply) const;
+                   ola::proto::UniverseInfoReply *universe_info_reply,
+                   bool include_ports = true) const;
+  void ListUniverses(uint64_t since_version,
+                     unsigned int start_universe,
+                     unsigned int max_universes,
+                     bool include_ports,
+                     ola::proto::UniverseInfoReply *response) const;
 
   template <class PortClass>
   void PopulatePort(const PortClass &port,
                     ola::proto::PortInfo *port_info) const;
+  void PopulateOutputPort(const class OutputPort &port,
+                          ola::proto::PortInfo *port_info) const;
 
   void SetProtoUID(const ola::rdm::UID &uid, ola::proto::UID *pb_uid);
+  void ClientDMXReceived(class Client *client, unsigned int universe_id,
+                         const ola::DmxBuffer &buffer, int priority);
 
   class Client* GetClient(ola::rpc::RpcController *controller);
 
@@ -297,6 +439,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   class ClientBroker *m_broker;
   const class TimeStamp *m_wake_up_time;
   std::auto_ptr<ReloadPluginsCallback> m_reload_plugins_callback;
+  class TimeCodeGenerator *m_timecode_generator;
+  TimeInterval m_timecode_freewheel;
+  std::auto_ptr<UniverseInfoCallback> m_universe_info_callback;
+  std::set<class Client*> m_universe_info_clients;
+
+  // The QueueingRDMControllers used by most ports hold 20 requests, so this
+  // leaves room for other clients.
+  static const unsigned int MAX_RDM_BATCH_IN_FLIGHT = 8;
 };
 }  // namespace ola
 #endif  // OLAD_OLASERVERSERVICEIMPL_H_
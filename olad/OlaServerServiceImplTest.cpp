@@ -35,6 +35,7 @@
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
+#include "olad/ClientBroker.h"
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/PluginLoader.h"
 #include "olad/Universe.h"
@@ -56,8 +57,13 @@ using std::string;
 class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OlaServerServiceImplTest);
   CPPUNIT_TEST(testGetDmx);
+  CPPUNIT_TEST(testGetDmxBatch);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
+  CPPUNIT_TEST(testStreamDmxDataBatch);
+  CPPUNIT_TEST(testRDMBatchCommand);
+  CPPUNIT_TEST(testGetUniverseInfo);
+  CPPUNIT_TEST(testUniverseInfoUpdates);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
   CPPUNIT_TEST_SUITE_END();
@@ -72,8 +78,13 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     }
 
     void testGetDmx();
+    void testGetDmxBatch();
     void testRegisterForDmx();
     void testUpdateDmxData();
+    void testStreamDmxDataBatch();
+    void testRDMBatchCommand();
+    void testGetUniverseInfo();
+    void testUniverseInfoUpdates();
     void testSetUniverseName();
     void testSetMergeMode();
 
@@ -85,14 +96,20 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
                     int universe_id,
                     class GetDmxCheck *check);
     void CallRegisterForDmx(OlaServerServiceImpl *service,
+                            Client *client,
                             int universe_id,
                             ola::proto::RegisterAction action,
-                            class RegisterForDmxCheck *check);
+                            class RegisterForDmxCheck *check,
+                            unsigned int start_slot = 0);
     void CallUpdateDmxData(OlaServerServiceImpl *service,
                            Client *client,
                            int universe_id,
                            const DmxBuffer &data,
                            class UpdateDmxDataCheck *check);
+    void Increment(unsigned int *count) { (*count)++; }
+    void CallGetUniverseInfo(OlaServerServiceImpl *service,
+                             const ola::proto::OptionalUniverseRequest &request,
+                             ola::proto::UniverseInfoReply *response);
     void CallSetUniverseName(OlaServerServiceImpl *service,
                              int universe_id,
                              const string &name,
@@ -107,6 +124,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION(OlaServerServiceImplTest);
 
 static const uint8_t SAMPLE_DMX_DATA[] = {1, 2, 3, 4, 5};
 
+static void Done() {}
+
 /*
  * The GetDmx Checks
  */
@@ -212,6 +231,19 @@ class GenericAckCheck: public parent {
 };
 
 
+/*
+ * Assert that we got an invalid slot error
+ */
+template<typename parent>
+class InvalidSlotCheck: public parent {
+ public:
+  void Check(RpcController *controller, OLA_UNUSED ola::proto::Ack *r) {
+    OLA_ASSERT(controller->Failed());
+    OLA_ASSERT_EQ(string("Invalid start slot"), controller->ErrorText());
+  }
+};
+
+
 /*
  * Check that the GetDmx method works
  */
@@ -275,62 +307,83 @@ void OlaServerServiceImplTest::CallGetDmx(OlaServerServiceImpl *service,
 void OlaServerServiceImplTest::testRegisterForDmx() {
   UniverseStore store(NULL, NULL);
   OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  ola::Client client(NULL, m_uid);
 
   // Register for a universe that doesn't exist
   unsigned int universe_id = 0;
   unsigned int second_universe_id = 99;
   GenericAckCheck<RegisterForDmxCheck> ack_check;
-  CallRegisterForDmx(&service, universe_id, ola::proto::REGISTER, &ack_check);
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::REGISTER,
+                     &ack_check);
 
   // The universe should exist now and the client should be bound
   Universe *universe = store.GetUniverse(universe_id);
   OLA_ASSERT_NOT_NULL(universe);
-  OLA_ASSERT(universe->ContainsSinkClient(NULL));
+  OLA_ASSERT(universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 1, universe->SinkClientCount());
 
   // Try to register again
-  CallRegisterForDmx(&service, universe_id, ola::proto::REGISTER, &ack_check);
-  OLA_ASSERT(universe->ContainsSinkClient(NULL));
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::REGISTER,
+                     &ack_check);
+  OLA_ASSERT(universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 1, universe->SinkClientCount());
 
   // Register a second universe
-  CallRegisterForDmx(&service, second_universe_id, ola::proto::REGISTER,
-                     &ack_check);
+  CallRegisterForDmx(&service, &client, second_universe_id,
+                     ola::proto::REGISTER, &ack_check);
   Universe *second_universe = store.GetUniverse(universe_id);
-  OLA_ASSERT(second_universe->ContainsSinkClient(NULL));
+  OLA_ASSERT(second_universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 1, second_universe->SinkClientCount());
 
   // Unregister the first universe
-  CallRegisterForDmx(&service, universe_id, ola::proto::UNREGISTER, &ack_check);
-  OLA_ASSERT_FALSE(universe->ContainsSinkClient(NULL));
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::UNREGISTER,
+                     &ack_check);
+  OLA_ASSERT_FALSE(universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 0, universe->SinkClientCount());
 
   // Unregister the second universe
-  CallRegisterForDmx(&service, second_universe_id, ola::proto::UNREGISTER,
-                     &ack_check);
-  OLA_ASSERT_FALSE(second_universe->ContainsSinkClient(NULL));
+  CallRegisterForDmx(&service, &client, second_universe_id,
+                     ola::proto::UNREGISTER, &ack_check);
+  OLA_ASSERT_FALSE(second_universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 0, second_universe->SinkClientCount());
 
   // Unregister again
-  CallRegisterForDmx(&service, universe_id, ola::proto::UNREGISTER, &ack_check);
-  OLA_ASSERT_FALSE(universe->ContainsSinkClient(NULL));
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::UNREGISTER,
+                     &ack_check);
+  OLA_ASSERT_FALSE(universe->ContainsSinkClient(&client));
   OLA_ASSERT_EQ((unsigned int) 0, universe->SinkClientCount());
+
+  // A start slot past the end of the universe is rejected
+  InvalidSlotCheck<RegisterForDmxCheck> invalid_slot_check;
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::REGISTER,
+                     &invalid_slot_check, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_FALSE(universe->ContainsSinkClient(&client));
+
+  // A valid range is accepted
+  CallRegisterForDmx(&service, &client, universe_id, ola::proto::REGISTER,
+                     &ack_check, ola::DMX_UNIVERSE_SIZE - 1);
+  OLA_ASSERT(universe->ContainsSinkClient(&client));
 }
 
 
 /*
  * Call the RegisterForDmx method
  * @param impl the OlaServerServiceImpl to use
+ * @param client the client to use
  * @param universe_id the universe_id in the request
  * @param action the action to use REGISTER or UNREGISTER
  * @param check the RegisterForDmxCheck to use for the callback check
+ * @param start_slot the first slot to receive, 0 if not set
  */
 void OlaServerServiceImplTest::CallRegisterForDmx(
     OlaServerServiceImpl *service,
+    Client *client,
     int universe_id,
     ola::proto::RegisterAction action,
-    RegisterForDmxCheck *check) {
+    RegisterForDmxCheck *check,
+    unsigned int start_slot) {
   RpcSession session(NULL);
+  session.SetData(client);
   RpcController controller(&session);
   ola::proto::RegisterDmxRequest request;
   ola::proto::Ack response;
@@ -343,6 +396,9 @@ void OlaServerServiceImplTest::CallRegisterForDmx(
 
   request.set_universe(universe_id);
   request.set_action(action);
+  if (start_slot) {
+    request.set_start_slot(start_slot);
+  }
   service->RegisterForDmx(&controller, &request, &response, closure);
 }
 
@@ -422,9 +478,293 @@ void OlaServerServiceImplTest::CallUpdateDmxData(
   service->UpdateDmxData(&controller, &request, &response, closure);
 }
 
+/*
+ * Check the StreamDmxDataBatch method works
+ */
+void OlaServerServiceImplTest::testStreamDmxDataBatch() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  m_clock.CurrentTime(&time1);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  DmxBuffer dmx_data("this is a test");
+  DmxBuffer dmx_data2("different data hmm");
+
+  ola::proto::DmxDataBatch request;
+  ola::proto::DmxData *data = request.add_data();
+  data->set_universe(1);
+  data->set_data(dmx_data.Get());
+  // universe 3 doesn't exist and should be skipped
+  data = request.add_data();
+  data->set_universe(3);
+  data->set_data(dmx_data.Get());
+  data = request.add_data();
+  data->set_universe(2);
+  data->set_data(dmx_data2.Get());
+  data->set_priority(250);
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  service.StreamDmxDataBatch(&controller, &request, NULL, NULL);
+
+  OLA_ASSERT_EQ(dmx_data, universe1->GetDMX());
+  OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_DEFAULT,
+                universe1->ActivePriority());
+  OLA_ASSERT_EQ(dmx_data2, universe2->GetDMX());
+  OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MAX, universe2->ActivePriority());
+  OLA_ASSERT_FALSE(store.GetUniverse(3));
+}
+
+/*
+ * Check GetDmxBatch returns the data for the universes that exist.
+ */
+void OlaServerServiceImplTest::testGetDmxBatch() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  store.GetUniverseOrCreate(2);
+  DmxBuffer buffer(SAMPLE_DMX_DATA, sizeof(SAMPLE_DMX_DATA));
+  universe1->SetDMX(buffer);
+
+  ola::proto::UniverseBatchRequest request;
+  request.add_universe(1);
+  request.add_universe(3);
+  request.add_universe(2);
+  ola::proto::DmxDataBatch response;
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  service.GetDmxBatch(&controller, &request, &response,
+                      NewSingleCallback(&Done));
+
+  OLA_ASSERT_FALSE(controller.Failed());
+  OLA_ASSERT_EQ(2, response.data_size());
+  OLA_ASSERT_EQ(1, response.data(0).universe());
+  OLA_ASSERT_EQ(buffer, DmxBuffer(response.data(0).data()));
+  OLA_ASSERT_EQ(2, response.data(1).universe());
+  OLA_ASSERT_EQ(DmxBuffer(), DmxBuffer(response.data(1).data()));
+}
+
+namespace {
+void SetFlag(bool *flag) {
+  *flag = true;
+}
+}  // namespace
+
+/*
+ * Check the RDMBatchCommand method works
+ */
+void OlaServerServiceImplTest::testRDMBatchCommand() {
+  UniverseStore store(NULL, NULL);
+  ola::ClientBroker broker;
+  ola::Client client(NULL, m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker, NULL, NULL);
+  store.GetUniverseOrCreate(1);
+
+  // More requests than are sent at once. Universe 1 has no ports, so the
+  // requests complete straight away.
+  const unsigned int request_count = 20;
+  ola::proto::RDMBatchRequest request;
+  for (unsigned int i = 0; i < request_count; i++) {
+    ola::proto::RDMRequest *rdm_request = request.add_request();
+    // universe 2 doesn't exist
+    rdm_request->set_universe(i == 5 ? 2 : 1);
+    rdm_request->mutable_uid()->set_esta_id(0x7a70);
+    rdm_request->mutable_uid()->set_device_id(i);
+    rdm_request->set_sub_device(0);
+    rdm_request->set_param_id(0x60);
+    rdm_request->set_data("");
+    rdm_request->set_is_set(false);
+  }
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::RDMBatchResponse response;
+  bool done = false;
+  service.RDMBatchCommand(&controller, &request, &response,
+                          NewSingleCallback(SetFlag, &done));
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_FALSE(controller.Failed());
+  OLA_ASSERT_EQ(static_cast<int>(request_count), response.response_size());
+  for (unsigned int i = 0; i < request_count; i++) {
+    OLA_ASSERT_EQ(i == 5 ? ola::proto::RDM_FAILED_TO_SEND :
+                      ola::proto::RDM_UNKNOWN_UID,
+                  response.response(i).response_code());
+  }
+
+  // Too many requests
+  for (unsigned int i = request_count;
+       i <= OlaServerServiceImpl::MAX_RDM_BATCH_SIZE; i++) {
+    *request.add_request() = request.request(0);
+  }
+  controller.Reset();
+  response.Clear();
+  done = false;
+  service.RDMBatchCommand(&controller, &request, &response,
+                          NewSingleCallback(SetFlag, &done));
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_TRUE(controller.Failed());
+  OLA_ASSERT_EQ(0, response.response_size());
+  broker.RemoveClient(&client);
+}
+
 /*
  * Check the SetUniverseName method works
  */
+/*
+ * Check the universe list can be paged, and limited to the changes.
+ */
+void OlaServerServiceImplTest::testGetUniverseInfo() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  Universe *universe3 = store.GetUniverseOrCreate(3);
+  store.GetUniverseOrCreate(5);
+
+  ola::proto::OptionalUniverseRequest request;
+  request.set_max_universes(2);
+  request.set_include_ports(false);
+  ola::proto::UniverseInfoReply response;
+  CallGetUniverseInfo(&service, request, &response);
+  OLA_ASSERT_EQ(2, response.universe_size());
+  OLA_ASSERT_EQ(1, response.universe(0).universe());
+  OLA_ASSERT_EQ(2, response.universe(1).universe());
+  OLA_ASSERT_EQ(3, response.next_universe());
+  OLA_ASSERT_TRUE(response.full());
+  const uint64_t version = response.version();
+  OLA_ASSERT_EQ(store.InfoVersion(), version);
+
+  request.set_start_universe(response.next_universe());
+  response.Clear();
+  CallGetUniverseInfo(&service, request, &response);
+  OLA_ASSERT_EQ(2, response.universe_size());
+  OLA_ASSERT_EQ(3, response.universe(0).universe());
+  OLA_ASSERT_EQ(5, response.universe(1).universe());
+  OLA_ASSERT_FALSE(response.has_next_universe());
+
+  // Now just the changes
+  universe2->SetName("new name");
+  store.AddUniverseGarbageCollection(universe3);
+  store.GarbageCollectUniverses();
+
+  request.Clear();
+  request.set_since_version(version);
+  response.Clear();
+  CallGetUniverseInfo(&service, request, &response);
+  OLA_ASSERT_FALSE(response.full());
+  OLA_ASSERT_EQ(1, response.universe_size());
+  OLA_ASSERT_EQ(2, response.universe(0).universe());
+  OLA_ASSERT_EQ(string("new name"), response.universe(0).name());
+  OLA_ASSERT_EQ(1, response.removed_universe_size());
+  OLA_ASSERT_EQ(3, response.removed_universe(0));
+
+  // Nothing changed since the last reply
+  request.set_since_version(response.version());
+  response.Clear();
+  CallGetUniverseInfo(&service, request, &response);
+  OLA_ASSERT_FALSE(response.full());
+  OLA_ASSERT_EQ(0, response.universe_size());
+  OLA_ASSERT_EQ(0, response.removed_universe_size());
+
+  // A version we've never handed out gets the full list.
+  request.set_since_version(store.InfoVersion() + 10);
+  response.Clear();
+  CallGetUniverseInfo(&service, request, &response);
+  OLA_ASSERT_TRUE(response.full());
+  OLA_ASSERT_EQ(3, response.universe_size());
+}
+
+void OlaServerServiceImplTest::CallGetUniverseInfo(
+    OlaServerServiceImpl *service,
+    const ola::proto::OptionalUniverseRequest &request,
+    ola::proto::UniverseInfoReply *response) {
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  service->GetUniverseInfo(&controller, &request, response,
+                           NewSingleCallback(&Done));
+  OLA_ASSERT_FALSE(controller.Failed());
+}
+
+namespace {
+/*
+ * A client that records the universe info updates.
+ */
+class UniverseInfoClient : public Client {
+ public:
+  explicit UniverseInfoClient(const ola::rdm::UID &uid)
+      : Client(NULL, uid),
+        updates(0) {
+  }
+
+  bool SendUniverseInfo(const ola::proto::UniverseInfoReply &update) {
+    last_update.CopyFrom(update);
+    updates++;
+    SetUniverseInfoSubscription(UniverseInfoIncludesPorts(), update.version());
+    return true;
+  }
+
+  ola::proto::UniverseInfoReply last_update;
+  unsigned int updates;
+};
+}  // namespace
+
+/*
+ * Check the changes are pushed to the subscribed clients.
+ */
+void OlaServerServiceImplTest::testUniverseInfoUpdates() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+  unsigned int subscriptions = 0;
+  service.SetUniverseInfoCallback(
+      ola::NewCallback(this, &OlaServerServiceImplTest::Increment,
+                       &subscriptions));
+  Universe *universe = store.GetUniverseOrCreate(1);
+
+  UniverseInfoClient client(m_uid);
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::UniverseInfoSubscription request;
+  request.set_action(ola::proto::REGISTER);
+  request.set_include_ports(false);
+  ola::proto::Ack ack;
+  service.RegisterForUniverseInfo(&controller, &request, &ack,
+                                  NewSingleCallback(&Done));
+  OLA_ASSERT_EQ(1u, subscriptions);
+  OLA_ASSERT_TRUE(client.UniverseInfoSubscribed());
+
+  // The first update has everything.
+  OLA_ASSERT_FALSE(service.SendUniverseInfoUpdates());
+  OLA_ASSERT_EQ(1u, client.updates);
+  OLA_ASSERT_TRUE(client.last_update.full());
+  OLA_ASSERT_EQ(1, client.last_update.universe_size());
+
+  // No changes, no update.
+  OLA_ASSERT_FALSE(service.SendUniverseInfoUpdates());
+  OLA_ASSERT_EQ(1u, client.updates);
+
+  universe->SetMergeMode(Universe::MERGE_HTP);
+  store.GetUniverseOrCreate(2);
+  OLA_ASSERT_FALSE(service.SendUniverseInfoUpdates());
+  OLA_ASSERT_EQ(2u, client.updates);
+  OLA_ASSERT_FALSE(client.last_update.full());
+  OLA_ASSERT_EQ(2, client.last_update.universe_size());
+  OLA_ASSERT_EQ(ola::proto::HTP, client.last_update.universe(0).merge_mode());
+
+  // Once the client is removed it doesn't get updates.
+  service.RemoveClient(&client);
+  universe->SetName("foo");
+  OLA_ASSERT_FALSE(service.SendUniverseInfoUpdates());
+  OLA_ASSERT_EQ(2u, client.updates);
+}
+
 void OlaServerServiceImplTest::testSetUniverseName() {
   UniverseStore store(NULL, NULL);
   OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
@@ -39,8 +39,20 @@
 #include "ola/base/SysExits.h"
 #include "ola/base/Version.h"
 #include "ola/thread/SignalThread.h"
+#include "ola/thread/ThreadRoles.h"
+#include "ola/util/Trace.h"
 #include "olad/OlaDaemon.h"
 
+#ifdef OLA_EMBEDDED
+// The embedded profile doesn't load the PID definitions until they're needed,
+// and keeps fewer trace events.
+static const bool DEFAULT_LOAD_PID_STORE = false;
+static const unsigned int DEFAULT_TRACE_EVENTS = 1024;
+#else
+static const bool DEFAULT_LOAD_PID_STORE = true;
+static const unsigned int DEFAULT_TRACE_EVENTS = ola::DEFAULT_TRACE_EVENTS;
+#endif  // OLA_EMBEDDED
+
 using ola::OlaDaemon;
 using ola::thread::SignalThread;
 using std::cout;
@@ -57,8 +69,49 @@ DEFINE_s_string(interface, i, "",
                 "to use.");
 DEFINE_string(pid_location, "",
               "The directory containing the PID definitions.");
+DEFINE_bool(load_pids, DEFAULT_LOAD_PID_STORE,
+            "Load the PID definitions at startup, otherwise they're loaded "
+            "by /reload_pids.");
 DEFINE_s_uint16(http_port, p, ola::OlaServer::DEFAULT_HTTP_PORT,
                 "The port to run the http server on. Defaults to 9090.");
+DEFINE_uint32(output_tick, 5,
+              "The tick in ms used to write to universes with a max frame "
+              "rate, 0 disables frame rate limiting.");
+DEFINE_uint32(dmx_buffer_pool_size, 0,
+              "The number of released DMX buffers to keep for reuse, 0 "
+              "disables the buffer pool.");
+DEFINE_default_bool(async_logging, false,
+                    "Write log messages from a background thread, so a slow "
+                    "stderr or syslog doesn't block the event loop.");
+DEFINE_default_bool(trace, false,
+                    "Record trace spans from startup, see /trace.json.");
+DEFINE_uint32(trace_events, DEFAULT_TRACE_EVENTS,
+              "The number of trace events to keep for each thread.");
+DEFINE_string(show_log_dir, "",
+              "The directory to log the frames sent by the universes to, "
+              "as binary show files that ola_recorder can play back.");
+DEFINE_uint32(show_log_minutes, 10,
+              "The number of minutes of show logs to keep.");
+DEFINE_default_bool(timecode_shm, false,
+                    "Publish the timecode sent by olad to the /ola-timecode "
+                    "shared memory segment.");
+DEFINE_uint32(timecode_freewheel, 0,
+              "Chase the timecode sent by clients, and keep generating it "
+              "for this many ms after the last frame. 0 sends each frame "
+              "as is.");
+DEFINE_string(dmx_snapshot, "",
+              "The file to save the DMX data for each universe to. The data "
+              "is restored from it on start.");
+DEFINE_uint32(universe_shm, 0,
+              "Publish the output of up to this many universes to the "
+              "/ola-universes shared memory segment, 0 disables it.");
+DEFINE_int16(loop_cpu, -1,
+             "The CPU to pin the main event loop to, -1 leaves it to the "
+             "scheduler.");
+DEFINE_string(thread_roles, "",
+              "The CPUs and scheduling for threads by name, e.g. "
+              "main:cpus=1:fifo=40;usb-*:node=0:fifo=30;pref-saver:cpus=0. "
+              "A name ending in * matches any thread starting with it.");
 
 /**
  * This is called by the SelectServer loop to start up the SignalThread. If the
@@ -93,6 +146,14 @@ int main(int argc, char *argv[]) {
   ola::InitLoggingFromFlags();
   OLA_INFO << "OLA Daemon version " << ola::base::Version::GetVersion();
 
+  // The roles must be set before any threads start.
+  ola::thread::ThreadRoleMap thread_roles;
+  if (!ola::thread::ParseThreadRoles(FLAGS_thread_roles.str(),
+                                     &thread_roles)) {
+    return ola::EXIT_USAGE;
+  }
+  ola::thread::SetThreadRoles(thread_roles);
+
   #ifndef OLAD_SKIP_ROOT_CHECK
   uid_t uid;
   ola::GetEUID(&uid);
@@ -107,10 +168,17 @@ int main(int argc, char *argv[]) {
     ola::Daemonise();
 #endif  // _WIN32
 
+  if (FLAGS_trace) {
+    ola::StartTracing(FLAGS_trace_events);
+  }
+
   ola::ExportMap export_map;
   if (!ola::ServerInit(original_argc, original_argv, &export_map)) {
     return ola::EXIT_UNAVAILABLE;
   }
+  // This follows ServerInit so a role overrides --scheduler-policy.
+  ola::thread::ApplyThreadRole("main");
+  ola::thread::RegisterThread("main");
 
   // We need to block signals before we start any threads.
   // Signal setup is complex. First of all we need to install NULL handlers to
@@ -125,6 +193,11 @@ int main(int argc, char *argv[]) {
       SIGUSR1, ola::NewCallback(&ola::IncrementLogLevel));
 #endif  // _WIN32
 
+  // The logging thread must start after the signals are blocked.
+  if (FLAGS_async_logging && !ola::StartAsyncLogging()) {
+    OLA_WARN << "Failed to start the logging thread";
+  }
+
   ola::OlaServer::Options options;
   options.http_enable = FLAGS_http;
   options.http_enable_quit = FLAGS_http_quit;
@@ -132,9 +205,21 @@ int main(int argc, char *argv[]) {
   options.http_data_dir = FLAGS_http_data_dir.str();
   options.network_interface = FLAGS_interface.str();
   options.pid_data_dir = FLAGS_pid_location.str();
+  options.load_pid_store = FLAGS_load_pids;
+  options.trace_events = FLAGS_trace_events;
+  options.dmx_buffer_pool_size = FLAGS_dmx_buffer_pool_size;
+  options.output_tick_ms = FLAGS_output_tick;
+  options.loop_cpu = FLAGS_loop_cpu;
+  options.show_log_dir = FLAGS_show_log_dir.str();
+  options.show_log_minutes = FLAGS_show_log_minutes;
+  options.timecode_shared_memory = FLAGS_timecode_shm;
+  options.timecode_freewheel_ms = FLAGS_timecode_freewheel;
+  options.dmx_snapshot_file = FLAGS_dmx_snapshot.str();
+  options.universe_shared_memory_slots = FLAGS_universe_shm;
 
   std::auto_ptr<OlaDaemon> olad(new OlaDaemon(options, &export_map));
   if (!olad.get()) {
+    ola::StopAsyncLogging();
     return ola::EXIT_UNAVAILABLE;
   }
 
@@ -158,6 +243,8 @@ int main(int argc, char *argv[]) {
         &signal_thread));
 
   if (!olad->Init()) {
+    olad.reset();
+    ola::StopAsyncLogging();
     return ola::EXIT_UNAVAILABLE;
   }
 
@@ -169,5 +256,8 @@ int main(int argc, char *argv[]) {
 #endif  // _WIN32
 
   olad->Run();
+  olad.reset();
+  ola::StopAsyncLogging();
+  ola::thread::UnregisterThread();
   return ola::EXIT_OK;
 }
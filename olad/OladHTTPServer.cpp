@@ -19,24 +19,35 @@
  */
 
 #include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "common/dmx/DmxBufferPool.h"
+#include "common/io/LoopProfiler.h"
 #include "ola/ActionQueue.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/Array.h"
 #include "ola/base/Version.h"
 #include "ola/dmx/SourcePriorities.h"
 #include "ola/network/NetworkUtils.h"
+#include "ola/util/Trace.h"
 #include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/DmxSource.h"
 #include "olad/HttpServerActions.h"
 #include "olad/OladHTTPServer.h"
 #include "olad/OlaServer.h"
 #include "olad/Preferences.h"
+#include "olad/Universe.h"
 
 namespace ola {
 
@@ -50,20 +61,55 @@ using ola::http::HTTPRequest;
 using ola::http::HTTPResponse;
 using ola::http::HTTPServer;
 using ola::io::ConnectedDescriptor;
+using ola::io::LoopProfiler;
 using ola::web::JsonArray;
 using ola::web::JsonObject;
+using ola::web::JsonStreamWriter;
 using std::cout;
 using std::endl;
 using std::ostringstream;
 using std::string;
 using std::vector;
 
+namespace {
+struct LoopProfileSite {
+  string name;
+  unsigned int count;
+  unsigned int time;
+};
+
+bool LongerTotalTime(const LoopProfileSite &a, const LoopProfileSite &b) {
+  return a.time > b.time;
+}
+
+/*
+ * Read the size of the process from /proc, in kB.
+ */
+bool ProcessMemory(OLA_UNUSED unsigned int *virtual_kb,
+                   OLA_UNUSED unsigned int *resident_kb) {
+#ifdef _WIN32
+  return false;
+#else
+  std::ifstream statm("/proc/self/statm");
+  uint64_t virtual_pages, resident_pages;
+  if (!(statm >> virtual_pages >> resident_pages)) {
+    return false;
+  }
+  const uint64_t page_kb = sysconf(_SC_PAGESIZE) / 1024;
+  *virtual_kb = static_cast<unsigned int>(virtual_pages * page_kb);
+  *resident_kb = static_cast<unsigned int>(resident_pages * page_kb);
+  return true;
+#endif  // _WIN32
+}
+}  // namespace
+
 const char OladHTTPServer::HELP_PARAMETER[] = "help";
 const char OladHTTPServer::HELP_REDIRECTION[] = "?help=1";
 const char OladHTTPServer::K_BACKEND_DISCONNECTED_ERROR[] =
     "Failed to send request, client isn't connected";
 const char OladHTTPServer::K_PRIORITY_VALUE_SUFFIX[] = "_priority_value";
 const char OladHTTPServer::K_PRIORITY_MODE_SUFFIX[] = "_priority_mode";
+const char OladHTTPServer::K_MAX_FRAME_RATE_SUFFIX[] = "_max_frame_rate";
 
 /**
  * @brief Create a new OLA HTTP server
@@ -84,8 +130,11 @@ OladHTTPServer::OladHTTPServer(ExportMap *export_map,
       m_client(client_socket),
       m_ola_server(ola_server),
       m_enable_quit(options.enable_quit),
+      m_trace_events(options.trace_events),
       m_interface(iface),
-      m_rdm_module(&m_server, &m_client) {
+      m_rdm_module(&m_server, &m_client, options.rdm_cache_preferences),
+      m_dmx_stream_module(&m_server, &m_client),
+      m_change_feed_module(&m_server, &m_client) {
   // The main handlers
   RegisterHandler("/quit", &OladHTTPServer::DisplayQuit);
   RegisterHandler("/reload", &OladHTTPServer::ReloadPlugins);
@@ -95,9 +144,16 @@ OladHTTPServer::OladHTTPServer(ExportMap *export_map,
   RegisterHandler("/set_plugin_state", &OladHTTPServer::SetPluginState);
   RegisterHandler("/set_dmx", &OladHTTPServer::HandleSetDmx);
   RegisterHandler("/get_dmx", &OladHTTPServer::GetDmx);
+  RegisterHandler("/trace.json", &OladHTTPServer::DumpTrace);
+  RegisterHandler("/trace/start", &OladHTTPServer::StartTrace);
+  RegisterHandler("/trace/stop", &OladHTTPServer::StopTrace);
 
   // json endpoints for the new UI
   RegisterHandler("/json/server_stats", &OladHTTPServer::JsonServerStats);
+  RegisterHandler("/json/loop_profile", &OladHTTPServer::JsonLoopProfile);
+  RegisterHandler("/json/memory", &OladHTTPServer::JsonMemory);
+  RegisterHandler("/json/rdm_timing", &OladHTTPServer::JsonRDMTiming);
+  RegisterHandler("/json/e131_stats", &OladHTTPServer::JsonE131Stats);
   RegisterHandler("/json/universe_plugin_list",
                   &OladHTTPServer::JsonUniversePluginList);
   RegisterHandler("/json/plugin_info", &OladHTTPServer::JsonPluginInfo);
@@ -441,22 +497,320 @@ int OladHTTPServer::JsonServerStats(const HTTPRequest*,
   strftime(start_time_str, sizeof(start_time_str), "%c", &start_time);
 #endif  // _WIN32
 
-  JsonObject json;
-  json.Add("hostname", ola::network::FQDN());
-  json.Add("instance_name", m_ola_server->InstanceName());
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+  json.Add("broadcast", m_interface.bcast_address.ToString());
   json.Add("config_dir",
            m_ola_server->GetPreferencesFactory()->ConfigLocation());
+  json.Add("hostname", ola::network::FQDN());
+  json.Add("hw_address", m_interface.hw_address.ToString());
+  json.Add("instance_name", m_ola_server->InstanceName());
   json.Add("ip", m_interface.ip_address.ToString());
-  json.Add("broadcast", m_interface.bcast_address.ToString());
+  json.Add("quit_enabled", m_enable_quit);
   json.Add("subnet", m_interface.subnet_mask.ToString());
-  json.Add("hw_address", m_interface.hw_address.ToString());
-  json.Add("version", ola::base::Version::GetVersion());
+  json.AddObject("universe_stats");
+  AddUniverseStats(&json);
+  json.End();
   json.Add("up_since", start_time_str);
-  json.Add("quit_enabled", m_enable_quit);
+  json.Add("version", ola::base::Version::GetVersion());
+  json.End();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  int r = response->SendJson(json);
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Add the per-universe timing stats from the ExportMap.
+ * @param json the JsonStreamWriter to add the stats to, keyed by universe id.
+ */
+void OladHTTPServer::AddUniverseStats(JsonStreamWriter *json) {
+  const StatVariable stats[] = {
+    {Universe::K_FPS_VAR, "dmx_frames"},
+    {Universe::K_UNIVERSE_MERGES_SKIPPED_VAR, "merges_skipped"},
+    {Universe::K_UNIVERSE_MERGE_TIME_P50_VAR, "merge_p50_usec"},
+    {Universe::K_UNIVERSE_MERGE_TIME_P99_VAR, "merge_p99_usec"},
+    {Universe::K_UNIVERSE_MERGE_TIME_MAX_VAR, "merge_max_usec"},
+    {Universe::K_UNIVERSE_LATENCY_P50_VAR, "latency_p50_usec"},
+    {Universe::K_UNIVERSE_LATENCY_P99_VAR, "latency_p99_usec"},
+    {Universe::K_UNIVERSE_LATENCY_MAX_VAR, "latency_max_usec"},
+    {Universe::K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR,
+     "arrival_latency_p50_usec"},
+    {Universe::K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR,
+     "arrival_latency_p99_usec"},
+    {Universe::K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR,
+     "arrival_latency_max_usec"},
+    {Universe::K_UNIVERSE_MEMORY_VAR, "memory_bytes"},
+  };
+  AddKeyedStats(json, stats, arraysize(stats));
+}
+
+
+/**
+ * @brief Add a set of UIntMap variables that share the same keys.
+ * @param json the JsonStreamWriter to add the stats to, with an object for
+ *   each key.
+ * @param stats the variables, and the names to use for them.
+ * @param stats_count the number of variables.
+ */
+void OladHTTPServer::AddKeyedStats(JsonStreamWriter *json,
+                                   const StatVariable stats[],
+                                   unsigned int stats_count) {
+  if (!m_export_map) {
+    return;
+  }
+
+  // Each variable is keyed in sorted order. Walk them in step so each key's
+  // object can be written in one go.
+  vector<const UIntMap*> vars(stats_count);
+  vector<UIntMap::const_iterator> iters(stats_count);
+  std::set<string> keys;
+  for (unsigned int i = 0; i < stats_count; i++) {
+    vars[i] = m_export_map->GetUIntMapVar(stats[i].var);
+    iters[i] = vars[i]->begin();
+    UIntMap::const_iterator iter = vars[i]->begin();
+    for (; iter != vars[i]->end(); ++iter) {
+      keys.insert(iter->first);
+    }
+  }
+
+  std::set<string>::const_iterator key = keys.begin();
+  for (; key != keys.end(); ++key) {
+    json->AddObject(*key);
+    for (unsigned int i = 0; i < stats_count; i++) {
+      if (iters[i] != vars[i]->end() && iters[i]->first == *key) {
+        json->Add(stats[i].key, iters[i]->second);
+        ++iters[i];
+      }
+    }
+    json->End();
+  }
+}
+
+
+/**
+ * @brief Print the RDM timing of each port and responder.
+ *
+ * This is the request to response latency, along with the timeouts,
+ * ACK_TIMERs and retransmits, which can be used to find the responders that
+ * slow down a line.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::JsonRDMTiming(const HTTPRequest*,
+                                  HTTPResponse *response) {
+  const StatVariable port_stats[] = {
+    {Universe::K_RDM_PORT_REQUESTS_VAR, "requests"},
+    {Universe::K_RDM_PORT_TIMEOUTS_VAR, "timeouts"},
+    {Universe::K_RDM_PORT_ACK_TIMERS_VAR, "ack_timers"},
+    {Universe::K_RDM_PORT_RETRANSMITS_VAR, "retransmits"},
+    {Universe::K_RDM_PORT_LATENCY_P50_VAR, "latency_p50_usec"},
+    {Universe::K_RDM_PORT_LATENCY_P99_VAR, "latency_p99_usec"},
+    {Universe::K_RDM_PORT_LATENCY_MAX_VAR, "latency_max_usec"},
+  };
+  const StatVariable responder_stats[] = {
+    {Universe::K_RDM_RESPONDER_REQUESTS_VAR, "requests"},
+    {Universe::K_RDM_RESPONDER_TIMEOUTS_VAR, "timeouts"},
+    {Universe::K_RDM_RESPONDER_ACK_TIMERS_VAR, "ack_timers"},
+    {Universe::K_RDM_RESPONDER_RETRANSMITS_VAR, "retransmits"},
+    {Universe::K_RDM_RESPONDER_LATENCY_P50_VAR, "latency_p50_usec"},
+    {Universe::K_RDM_RESPONDER_LATENCY_P99_VAR, "latency_p99_usec"},
+    {Universe::K_RDM_RESPONDER_LATENCY_MAX_VAR, "latency_max_usec"},
+  };
+
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+  json.AddObject("ports");
+  AddKeyedStats(&json, port_stats, arraysize(port_stats));
+  json.End();
+  json.AddObject("responders");
+  AddKeyedStats(&json, responder_stats, arraysize(responder_stats));
+  json.End();
+  json.End();
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Print the receive statistics for each E1.31 source.
+ *
+ * The variables are exported by the E1.31 plugin, keyed by universe:cid. If
+ * the plugin isn't running the object is empty.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::JsonE131Stats(const HTTPRequest*,
+                                  HTTPResponse *response) {
+  const StatVariable source_stats[] = {
+    {"e131-source-packets", "packets"},
+    {"e131-source-sequence-gaps", "sequence_gaps"},
+    {"e131-source-out-of-order", "out_of_order"},
+    {"e131-source-priority", "priority"},
+    {"e131-source-jitter-p50-us", "jitter_p50_usec"},
+    {"e131-source-jitter-p99-us", "jitter_p99_usec"},
+    {"e131-source-jitter-max-us", "jitter_max_usec"},
+  };
+
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+  json.AddObject("sources");
+  AddKeyedStats(&json, source_stats, arraysize(source_stats));
+  json.End();
+  json.End();
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Print the memory used by olad, broken down by subsystem.
+ *
+ * The per-universe figures are estimates, updated on each housekeeping run.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::JsonMemory(const HTTPRequest*,
+                               HTTPResponse *response) {
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+
+  unsigned int virtual_kb, resident_kb;
+  if (ProcessMemory(&virtual_kb, &resident_kb)) {
+    json.AddObject("process");
+    json.Add("virtual_kb", virtual_kb);
+    json.Add("resident_kb", resident_kb);
+    json.End();
+  }
+
+  if (m_export_map) {
+    const UIntMap *memory = m_export_map->GetUIntMapVar(
+        Universe::K_UNIVERSE_MEMORY_VAR);
+    unsigned int universes = 0;
+    unsigned int universe_bytes = 0;
+    UIntMap::const_iterator iter = memory->begin();
+    for (; iter != memory->end(); ++iter) {
+      universes++;
+      universe_bytes += iter->second;
+    }
+    json.AddObject("universes");
+    json.Add("count", universes);
+    json.Add("bytes", universe_bytes);
+    json.End();
+  }
+
+  json.AddObject("dmx_buffer_pool");
+  json.Add("free_bytes", static_cast<unsigned int>(
+      ola::dmx::DmxBufferPool::Global()->FreeBlocks() *
+      sizeof(ola::dmx::DmxBufferBlock)));
+  json.End();
+
+  json.AddObject("pid_store");
+  json.Add("loaded", m_rdm_module.HasPidStore());
+  json.End();
+
+  json.AddObject("trace");
+  json.Add("enabled", ola::TracingEnabled());
+  json.Add("events_per_thread", m_trace_events);
+  json.End();
+  json.End();
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Print the event loop profile.
+ *
+ * The callbacks are sorted by the total time they've taken. This is empty
+ * unless olad was started with --profile-loop.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::JsonLoopProfile(const HTTPRequest*,
+                                    HTTPResponse *response) {
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+  const bool enabled = m_export_map &&
+      m_export_map->GetBoolVar(LoopProfiler::K_ENABLED_VAR)->Get();
+  json.Add("enabled", enabled);
+
+  json.AddArray("callbacks");
+  if (enabled) {
+    const UIntMap *counts = m_export_map->GetUIntMapVar(
+        LoopProfiler::K_CALLBACK_COUNT_VAR);
+    UIntMap *times = m_export_map->GetUIntMapVar(
+        LoopProfiler::K_CALLBACK_TIME_VAR);
+    UIntMap *max_times = m_export_map->GetUIntMapVar(
+        LoopProfiler::K_CALLBACK_MAX_TIME_VAR);
+
+    // Sort by total time, longest first.
+    vector<LoopProfileSite> sites;
+    UIntMap::const_iterator iter = counts->begin();
+    for (; iter != counts->end(); ++iter) {
+      if (iter->second) {
+        LoopProfileSite site = {iter->first, iter->second,
+                                (*times)[iter->first]};
+        sites.push_back(site);
+      }
+    }
+    std::sort(sites.begin(), sites.end(), LongerTotalTime);
+
+    vector<LoopProfileSite>::const_iterator site;
+    for (site = sites.begin(); site != sites.end(); ++site) {
+      json.StartObject();
+      json.Add("name", site->name);
+      json.Add("count", site->count);
+      json.Add("total_usec", site->time);
+      json.Add("mean_usec", site->time / site->count);
+      json.Add("max_usec", (*max_times)[site->name]);
+      json.End();
+    }
+  }
+  json.End();
+
+  if (enabled) {
+    json.AddObject("longest_stall");
+    json.Add("name", m_export_map->GetStringVar(
+        LoopProfiler::K_LONGEST_STALL_SITE_VAR)->Get());
+    json.Add("usec", m_export_map->GetIntegerVar(
+        LoopProfiler::K_LONGEST_STALL_VAR)->Get());
+    json.End();
+
+    const Histogram &lag = m_export_map->GetHistogramVar(
+        LoopProfiler::K_TIMEOUT_LAG_VAR)->Get();
+    json.AddObject("timeout_lag");
+    json.Add("count", static_cast<unsigned int>(lag.Count()));
+    json.Add("p50_usec", lag.Percentile(50));
+    json.Add("p90_usec", lag.Percentile(90));
+    json.Add("p99_usec", lag.Percentile(99));
+    json.Add("max_usec", lag.Max());
+    json.End();
+  }
+  json.End();
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->Send();
   delete response;
   return r;
 }
@@ -666,6 +1020,7 @@ int OladHTTPServer::ModifyUniverse(const HTTPRequest *request,
   AddPatchActions(action_queue, add_port_ids, universe_id, client::PATCH);
 
   AddPriorityActions(action_queue, request);
+  AddFrameRateActions(action_queue, request);
 
   action_queue->NextAction();
   return MHD_YES;
@@ -703,7 +1058,7 @@ int OladHTTPServer::SetPluginState(const HTTPRequest *request,
   m_client.SetPluginState(
       (ola_plugin_id) plugin_id,
       state,
-      NewSingleCallback(this, &OladHTTPServer::HandleBoolResponse, response));
+      NewSingleCallback(this, &OladHTTPServer::HandlePluginChange, response));
 
   return MHD_YES;
 }
@@ -743,17 +1098,25 @@ int OladHTTPServer::HandleSetDmx(const HTTPRequest *request,
                                  HTTPResponse *response) {
   if (request->CheckParameterExists(HELP_PARAMETER)) {
     return ServeUsage(response,
-        "POST u=[universe], d=[DMX data (a comma separated list of values)]");
+        "POST u=[universe], d=[DMX data (a comma separated list of values)]"
+        "<br />or POST to set_dmx?u=[universe] with a Content-Type of "
+        "application/octet-stream and one byte per slot as the body");
   }
-  string dmx_data_str = request->GetPostParameter("d");
-  string uni_id = request->GetPostParameter("u");
+  // A body that isn't form encoded holds the raw slot data.
+  const string &body = request->Body();
+  string uni_id = body.empty() ? request->GetPostParameter("u") :
+                                 request->GetParameter("u");
   unsigned int universe_id;
   if (!StringToInt(uni_id, &universe_id)) {
     return ServeHelpRedirect(response);
   }
 
   DmxBuffer buffer;
-  buffer.SetFromString(dmx_data_str);
+  if (body.empty()) {
+    buffer.SetFromString(request->GetPostParameter("d"));
+  } else {
+    buffer.Set(reinterpret_cast<const uint8_t*>(body.data()), body.size());
+  }
   if (!buffer.Size()) {
     return m_server.ServeError(response, "Invalid DMX string");
   }
@@ -798,7 +1161,7 @@ int OladHTTPServer::DisplayQuit(OLA_UNUSED const HTTPRequest *request,
 int OladHTTPServer::ReloadPlugins(const HTTPRequest*,
                                   HTTPResponse *response) {
   m_client.ReloadPlugins(
-      NewSingleCallback(this, &OladHTTPServer::HandleBoolResponse, response));
+      NewSingleCallback(this, &OladHTTPServer::HandlePluginChange, response));
   return MHD_YES;
 }
 
@@ -821,6 +1184,63 @@ int OladHTTPServer::ReloadPidStore(OLA_UNUSED const HTTPRequest *request,
 }
 
 
+/**
+ * @brief Write the recorded trace events.
+ *
+ * The output can be loaded into chrome://tracing or ui.perfetto.dev.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::DumpTrace(OLA_UNUSED const HTTPRequest *request,
+                              HTTPResponse *response) {
+  std::ostringstream str;
+  ola::WriteChromeTrace(&str);
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_JSON);
+  response->Append(str.str());
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Start recording trace events, this discards any existing events.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::StartTrace(OLA_UNUSED const HTTPRequest *request,
+                               HTTPResponse *response) {
+  ola::StartTracing(m_trace_events);
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  response->Append("ok");
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Stop recording trace events.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int OladHTTPServer::StopTrace(OLA_UNUSED const HTTPRequest *request,
+                              HTTPResponse *response) {
+  ola::StopTracing();
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  response->Append("ok");
+  int r = response->Send();
+  delete response;
+  return r;
+}
+
+
 /**
  * @brief Handle the plugin list callback
  * @param response the HTTPResponse that is associated with the request.
@@ -835,7 +1255,19 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
     return;
   }
 
-  JsonObject *json = new JsonObject();
+  JsonStreamWriter *json = new JsonStreamWriter(response->MutableBody());
+  json->StartObject();
+  json->AddArray("plugins");
+  vector<OlaPlugin>::const_iterator iter;
+  for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
+    json->AppendObject();
+    json->Add("active", iter->IsActive());
+    json->Add("enabled", iter->IsEnabled());
+    json->Add("id", iter->Id());
+    json->Add("name", iter->Name());
+    json->End();
+  }
+  json->End();
 
   // fire off the universe request now. the main server is running in a
   // separate thread.
@@ -844,49 +1276,42 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
                         &OladHTTPServer::HandleUniverseList,
                         response,
                         json));
-
-  JsonArray *plugins_json = json->AddArray("plugins");
-  vector<OlaPlugin>::const_iterator iter;
-  for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-    JsonObject *plugin = plugins_json->AppendObject();
-    plugin->Add("name", iter->Name());
-    plugin->Add("id", iter->Id());
-    plugin->Add("active", iter->IsActive());
-    plugin->Add("enabled", iter->IsEnabled());
-  }
 }
 
 
 /**
  * @brief Handle the universe list callback
  * @param response the HTTPResponse that is associated with the request.
- * @param json the JsonObject to add the data to
+ * @param json the JsonStreamWriter to add the data to
  * @param result the result of the API call
  * @param universes the vector of OlaUniverse
  */
 void OladHTTPServer::HandleUniverseList(HTTPResponse *response,
-                                        JsonObject *json,
+                                        JsonStreamWriter *json,
                                         const client::Result &result,
                                         const vector<OlaUniverse> &universes) {
   if (result.Success()) {
-    JsonArray *universe_json = json->AddArray("universes");
+    json->AddArray("universes");
 
     vector<OlaUniverse>::const_iterator iter;
     for (iter = universes.begin(); iter != universes.end(); ++iter) {
-      JsonObject *universe = universe_json->AppendObject();
-      universe->Add("id", iter->Id());
-      universe->Add("input_ports", iter->InputPortCount());
-      universe->Add("name", iter->Name());
-      universe->Add("output_ports", iter->OutputPortCount());
-      universe->Add("rdm_devices", iter->RDMDeviceCount());
+      json->AppendObject();
+      json->Add("id", iter->Id());
+      json->Add("input_ports", iter->InputPortCount());
+      json->Add("name", iter->Name());
+      json->Add("output_ports", iter->OutputPortCount());
+      json->Add("rdm_devices", iter->RDMDeviceCount());
+      json->End();
     }
+    json->End();
   }
+  json->End();
+  delete json;
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(*json);
+  response->Send();
   delete response;
-  delete json;
 }
 
 
@@ -968,7 +1393,12 @@ void OladHTTPServer::HandleUniverseInfo(HTTPResponse *response,
     return;
   }
 
-  JsonObject *json = new JsonObject();
+  JsonStreamWriter *json = new JsonStreamWriter(response->MutableBody());
+  json->StartObject();
+  json->Add("id", universe.Id());
+  json->Add("merge_mode",
+           (universe.MergeMode() == OlaUniverse::MERGE_HTP ? "HTP" : "LTP"));
+  json->Add("name", universe.Name());
 
   // fire off the device/port request now. the main server is running in a
   // separate thread.
@@ -979,54 +1409,51 @@ void OladHTTPServer::HandleUniverseInfo(HTTPResponse *response,
                         response,
                         json,
                         universe.Id()));
-
-  json->Add("id", universe.Id());
-  json->Add("name", universe.Name());
-  json->Add("merge_mode",
-           (universe.MergeMode() == OlaUniverse::MERGE_HTP ? "HTP" : "LTP"));
 }
 
 
 void OladHTTPServer::HandlePortsForUniverse(
     HTTPResponse *response,
-    JsonObject *json,
+    JsonStreamWriter *json,
     unsigned int universe_id,
     const client::Result &result,
     const vector<OlaDevice> &devices) {
   if (result.Success()) {
-    vector<OlaDevice>::const_iterator iter = devices.begin();
+    vector<OlaDevice>::const_iterator iter;
     vector<OlaInputPort>::const_iterator input_iter;
     vector<OlaOutputPort>::const_iterator output_iter;
 
-    JsonArray *output_ports_json = json->AddArray("output_ports");
-    JsonArray *input_ports_json = json->AddArray("input_ports");
-
-    for (; iter != devices.end(); ++iter) {
+    json->AddArray("input_ports");
+    for (iter = devices.begin(); iter != devices.end(); ++iter) {
       const vector<OlaInputPort> &input_ports = iter->InputPorts();
       for (input_iter = input_ports.begin(); input_iter != input_ports.end();
            ++input_iter) {
         if (input_iter->IsActive() && input_iter->Universe() == universe_id) {
-          JsonObject *obj = input_ports_json->AppendObject();
-          PortToJson(obj, *iter, *input_iter, false);
+          PortToJson(json, *iter, *input_iter, false);
         }
       }
+    }
+    json->End();
 
+    json->AddArray("output_ports");
+    for (iter = devices.begin(); iter != devices.end(); ++iter) {
       const vector<OlaOutputPort> &output_ports = iter->OutputPorts();
       for (output_iter = output_ports.begin();
            output_iter != output_ports.end(); ++output_iter) {
         if (output_iter->IsActive() &&
             output_iter->Universe() == universe_id) {
-          JsonObject *obj = output_ports_json->AppendObject();
-          PortToJson(obj, *iter, *output_iter, true);
+          PortToJson(json, *iter, *output_iter, true);
         }
       }
     }
+    json->End();
   }
+  json->End();
+  delete json;
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(*json);
-  delete json;
+  response->Send();
   delete response;
 }
 
@@ -1050,26 +1477,26 @@ void OladHTTPServer::HandleCandidatePorts(
   vector<OlaInputPort>::const_iterator input_iter;
   vector<OlaOutputPort>::const_iterator output_iter;
 
-  JsonArray json;
+  JsonStreamWriter json(response->MutableBody());
+  json.StartArray();
   for (; iter != devices.end(); ++iter) {
     const vector<OlaInputPort> &input_ports = iter->InputPorts();
     for (input_iter = input_ports.begin(); input_iter != input_ports.end();
          ++input_iter) {
-      JsonObject *obj = json.AppendObject();
-      PortToJson(obj, *iter, *input_iter, false);
+      PortToJson(&json, *iter, *input_iter, false);
     }
 
     const vector<OlaOutputPort> &output_ports = iter->OutputPorts();
     for (output_iter = output_ports.begin();
          output_iter != output_ports.end(); ++output_iter) {
-      JsonObject *obj = json.AppendObject();
-      PortToJson(obj, *iter, *output_iter, true);
+      PortToJson(&json, *iter, *output_iter, true);
     }
   }
+  json.End();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(json);
+  response->Send();
   delete response;
 }
 
@@ -1214,21 +1641,36 @@ void OladHTTPServer::HandleBoolResponse(HTTPResponse *response,
 
 
 /**
- * @brief Add the json representation of this port to the ostringstream
+ * @brief Handle the response to a plugin state change or reload.
+ * @param response the HTTPResponse that is associated with the request.
+ * @param result the result of the API call
  */
-void OladHTTPServer::PortToJson(JsonObject *json,
+void OladHTTPServer::HandlePluginChange(HTTPResponse *response,
+                                        const client::Result &result) {
+  if (result.Success()) {
+    m_change_feed_module.PluginsChanged();
+  }
+  HandleBoolResponse(response, result);
+}
+
+
+/**
+ * @brief Append the json representation of this port to the current array.
+ */
+void OladHTTPServer::PortToJson(JsonStreamWriter *json,
                                 const OlaDevice &device,
                                 const OlaPort &port,
                                 bool is_output) {
   ostringstream str;
   str << device.Alias() << "-" << (is_output ? "O" : "I") << "-" << port.Id();
 
-  json->Add("device", device.Name());
+  json->AppendObject();
   json->Add("description", port.Description());
+  json->Add("device", device.Name());
   json->Add("id", str.str());
   json->Add("is_output", is_output);
 
-  JsonObject *priority_json = json->AddObject("priority");
+  json->AddObject("priority");
   if (port.PriorityCapability() != CAPABILITY_NONE) {
     // This can be used as the default value for the priority input and because
     // inherit ports can return a 0 priority we shall set it to the default
@@ -1238,13 +1680,20 @@ void OladHTTPServer::PortToJson(JsonObject *json,
       // We check here because 0 is an invalid priority outside of Olad
       priority = dmx::SOURCE_PRIORITY_DEFAULT;
     }
-    priority_json->Add("value", static_cast<int>(priority));
-    priority_json->Add(
+    json->Add(
       "current_mode",
       (port.PriorityMode() == PRIORITY_MODE_INHERIT ?  "inherit" : "static"));
-    priority_json->Add("priority_capability",
+    json->Add("priority_capability",
       (port.PriorityCapability() == CAPABILITY_STATIC ? "static" : "full"));
+    json->Add("value", static_cast<int>(priority));
+  }
+  json->End();  // priority
+
+  if (is_output) {
+    json->Add("max_frame_rate", port.MaxFrameRate());
+    json->Add("skipped_frames", port.SkippedFrames());
   }
+  json->End();
 }
 
 
@@ -1315,6 +1764,36 @@ void OladHTTPServer::AddPriorityActions(ActionQueue *action_queue,
 }
 
 
+/**
+ * @brief Add the actions for the output rate limits to the ActionQueue.
+ * @param action_queue the ActionQueue to add the actions to.
+ * @param request the HTTPRequest to read the url params from.
+ */
+void OladHTTPServer::AddFrameRateActions(ActionQueue *action_queue,
+                                         const HTTPRequest *request) {
+  string port_ids = request->GetPostParameter("modify_ports");
+  vector<port_identifier> ports;
+  vector<port_identifier>::const_iterator iter;
+  DecodePortIds(port_ids, &ports);
+
+  for (iter = ports.begin(); iter != ports.end(); ++iter) {
+    if (iter->direction != client::OUTPUT_PORT) {
+      continue;
+    }
+    string value = request->GetPostParameter(
+        iter->string_id + K_MAX_FRAME_RATE_SUFFIX);
+    unsigned int max_frame_rate;
+    if (!value.empty() && StringToInt(value, &max_frame_rate)) {
+      action_queue->AddAction(new PortFrameRateAction(
+        &m_client,
+        iter->device_alias,
+        iter->port,
+        max_frame_rate));
+    }
+  }
+}
+
+
 /**
  * @brief Decode port ids in a string.
  *
@@ -31,6 +31,10 @@
 #include "ola/http/OlaHTTPServer.h"
 #include "ola/network/Interface.h"
 #include "ola/rdm/PidStore.h"
+#include "ola/util/Trace.h"
+#include "ola/web/JsonStreamWriter.h"
+#include "olad/ChangeFeedModule.h"
+#include "olad/DmxStreamModule.h"
 #include "olad/RDMHTTPModule.h"
 
 namespace ola {
@@ -45,10 +49,16 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
       ola::http::HTTPServer::HTTPServerOptions {
    public:
     bool enable_quit;
+    // Where to keep the RDM device cache, ownership is not transferred.
+    Preferences *rdm_cache_preferences;
+    // The number of trace events to keep for each thread.
+    unsigned int trace_events;
 
     OladHTTPServerOptions()
         : ola::http::HTTPServer::HTTPServerOptions(),
-          enable_quit(true) {
+          enable_quit(true),
+          rdm_cache_preferences(NULL),
+          trace_events(ola::DEFAULT_TRACE_EVENTS) {
     }
   };
 
@@ -64,6 +74,14 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
 
   int JsonServerStats(const ola::http::HTTPRequest *request,
                       ola::http::HTTPResponse *response);
+  int JsonMemory(const ola::http::HTTPRequest *request,
+                 ola::http::HTTPResponse *response);
+  int JsonLoopProfile(const ola::http::HTTPRequest *request,
+                      ola::http::HTTPResponse *response);
+  int JsonRDMTiming(const ola::http::HTTPRequest *request,
+                    ola::http::HTTPResponse *response);
+  int JsonE131Stats(const ola::http::HTTPRequest *request,
+                    ola::http::HTTPResponse *response);
   int JsonUniversePluginList(const ola::http::HTTPRequest *request,
                              ola::http::HTTPResponse *response);
   int JsonPluginInfo(const ola::http::HTTPRequest *request,
@@ -89,13 +107,22 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
                     ola::http::HTTPResponse *response);
   int ReloadPidStore(const ola::http::HTTPRequest *request,
                      ola::http::HTTPResponse *response);
+  int DumpTrace(const ola::http::HTTPRequest *request,
+                ola::http::HTTPResponse *response);
+  int StartTrace(const ola::http::HTTPRequest *request,
+                 ola::http::HTTPResponse *response);
+  int StopTrace(const ola::http::HTTPRequest *request,
+                ola::http::HTTPResponse *response);
+
+  void HandlePluginChange(ola::http::HTTPResponse *response,
+                          const client::Result &result);
 
   void HandlePluginList(ola::http::HTTPResponse *response,
                         const client::Result &result,
                         const std::vector<client::OlaPlugin> &plugins);
 
   void HandleUniverseList(ola::http::HTTPResponse *response,
-                          ola::web::JsonObject *json,
+                          ola::web::JsonStreamWriter *json,
                           const client::Result &result,
                           const std::vector<client::OlaUniverse> &universes);
 
@@ -113,7 +140,7 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
                           const client::OlaUniverse &universe);
 
   void HandlePortsForUniverse(ola::http::HTTPResponse *response,
-                              ola::web::JsonObject *json,
+                              ola::web::JsonStreamWriter *json,
                               unsigned int universe_id,
                               const client::Result &result,
                               const std::vector<client::OlaDevice> &devices);
@@ -155,10 +182,24 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   ola::client::OlaClient m_client;
   class OlaServer *m_ola_server;
   bool m_enable_quit;
+  unsigned int m_trace_events;
   ola::network::Interface m_interface;
   RDMHTTPModule m_rdm_module;
+  DmxStreamModule m_dmx_stream_module;
+  ChangeFeedModule m_change_feed_module;
   time_t m_start_time_t;
 
+  // A UIntMap in the ExportMap, and the name it's given in the JSON.
+  struct StatVariable {
+    const char *var;
+    const char *key;
+  };
+
+  void AddUniverseStats(ola::web::JsonStreamWriter *json);
+  void AddKeyedStats(ola::web::JsonStreamWriter *json,
+                     const StatVariable stats[],
+                     unsigned int stats_count);
+
   void HandleGetDmx(ola::http::HTTPResponse *response,
                     const client::Result &result,
                     const client::DMXMetadata &metadata,
@@ -167,7 +208,7 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   void HandleBoolResponse(ola::http::HTTPResponse *response,
                           const client::Result &result);
 
-  void PortToJson(ola::web::JsonObject *object,
+  void PortToJson(ola::web::JsonStreamWriter *json,
                   const client::OlaDevice &device,
                   const client::OlaPort &port,
                   bool is_output);
@@ -180,6 +221,9 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   void AddPriorityActions(ActionQueue *action_queue,
                           const ola::http::HTTPRequest *request);
 
+  void AddFrameRateActions(ActionQueue *action_queue,
+                           const ola::http::HTTPRequest *request);
+
   typedef struct {
     unsigned int device_alias;
     unsigned int port;
@@ -200,6 +244,7 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   static const unsigned int K_UNIVERSE_NAME_LIMIT = 100;
   static const char K_PRIORITY_VALUE_SUFFIX[];
   static const char K_PRIORITY_MODE_SUFFIX[];
+  static const char K_MAX_FRAME_RATE_SUFFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(OladHTTPServer);
 };
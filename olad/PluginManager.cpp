@@ -22,6 +22,8 @@
 
 #include <set>
 #include <vector>
+#include "ola/Callback.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Plugin.h"
@@ -30,13 +32,23 @@
 
 namespace ola {
 
+using ola::thread::INVALID_TIMEOUT;
 using std::vector;
 using std::set;
 
+namespace {
+const char PLUGIN_START_TIME_VAR[] = "plugin-start-time-ms";
+// The delay between starting each plugin. A zero delay would run the next
+// start in the same pass of the event loop, which defeats the purpose.
+const unsigned int START_INTERVAL_US = 1000;
+}  // namespace
+
 PluginManager::PluginManager(const vector<PluginLoader*> &plugin_loaders,
                              class PluginAdaptor *plugin_adaptor)
     : m_plugin_loaders(plugin_loaders),
-      m_plugin_adaptor(plugin_adaptor) {
+      m_plugin_adaptor(plugin_adaptor),
+      m_scheduler(NULL),
+      m_start_timeout(INVALID_TIMEOUT) {
 }
 
 PluginManager::~PluginManager() {
@@ -78,13 +90,29 @@ void PluginManager::LoadAll() {
   }
 
   // The second pass checks for conflicts and starts each plugin
-  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
-  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
-    StartIfSafe(plugin_iter->second);
+  m_clock.CurrentTime(&m_load_time);
+  m_pending_plugins.clear();
+  PluginMap::reverse_iterator plugin_iter = m_enabled_plugins.rbegin();
+  for (; plugin_iter != m_enabled_plugins.rend(); ++plugin_iter) {
+    m_pending_plugins.push_back(plugin_iter->first);
+  }
+
+  if (m_scheduler) {
+    ScheduleNextPlugin();
+  } else {
+    while (!m_pending_plugins.empty()) {
+      StartNextPlugin();
+    }
   }
 }
 
 void PluginManager::UnloadAll() {
+  m_pending_plugins.clear();
+  if (m_start_timeout != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_start_timeout);
+    m_start_timeout = INVALID_TIMEOUT;
+  }
+
   PluginMap::iterator plugin_iter = m_loaded_plugins.begin();
   for (; plugin_iter != m_loaded_plugins.end(); ++plugin_iter) {
     plugin_iter->second->Stop();
@@ -182,6 +210,40 @@ void PluginManager::GetConflictList(ola_plugin_id plugin_id,
   }
 }
 
+void PluginManager::StartNextPlugin() {
+  m_start_timeout = INVALID_TIMEOUT;
+  if (m_pending_plugins.empty()) {
+    return;
+  }
+
+  const ola_plugin_id plugin_id = m_pending_plugins.back();
+  m_pending_plugins.pop_back();
+  // The plugin may have been started or disabled by a client since LoadAll()
+  // was called.
+  AbstractPlugin *plugin = STLFindOrNull(m_enabled_plugins, plugin_id);
+  if (plugin && !STLContains(m_active_plugins, plugin_id)) {
+    StartIfSafe(plugin);
+  }
+
+  if (m_pending_plugins.empty()) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    OLA_INFO << "Started " << m_active_plugins.size() << " plugins in "
+             << (now - m_load_time).InMilliSeconds() << " ms";
+  } else if (m_scheduler) {
+    ScheduleNextPlugin();
+  }
+}
+
+void PluginManager::ScheduleNextPlugin() {
+  if (m_pending_plugins.empty() || m_start_timeout != INVALID_TIMEOUT) {
+    return;
+  }
+  m_start_timeout = m_scheduler->RegisterSingleTimeout(
+      TimeInterval(START_INTERVAL_US),
+      NewSingleCallback(this, &PluginManager::StartNextPlugin));
+}
+
 bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
   AbstractPlugin *conflicting_plugin = CheckForRunningConflicts(plugin);
   if (conflicting_plugin) {
@@ -193,13 +255,25 @@ bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
   }
 
   OLA_INFO << "Trying to start " << plugin->Name();
+  TimeStamp start, end;
+  m_clock.CurrentTime(&start);
   bool ok = plugin->Start();
+  m_clock.CurrentTime(&end);
+  const int64_t start_time = (end - start).InMilliSeconds();
+
   if (!ok) {
-    OLA_WARN << "Failed to start " << plugin->Name();
+    OLA_WARN << "Failed to start " << plugin->Name() << " after "
+             << start_time << " ms";
   } else {
-    OLA_INFO << "Started " << plugin->Name();
+    OLA_INFO << "Started " << plugin->Name() << " in " << start_time << " ms";
     STLReplace(&m_active_plugins, plugin->Id(), plugin);
   }
+
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+  if (export_map) {
+    (*export_map->GetUIntMapVar(PLUGIN_START_TIME_VAR, "plugin"))[
+        plugin->Name()] = static_cast<unsigned int>(start_time);
+  }
   return ok;
 }
 
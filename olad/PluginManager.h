@@ -24,8 +24,10 @@
 #include <map>
 #include <vector>
 
+#include "ola/Clock.h"
 #include "ola/base/Macro.h"
 #include "ola/plugin_id.h"
+#include "ola/thread/SchedulerInterface.h"
 
 namespace ola {
 
@@ -48,6 +50,13 @@ class AbstractPlugin;
  *
  * Plugins are active if they weren't disabled, there were no conflicts that
  * prevented them from loading, and the call to Start() was successfull.
+ *
+ * Some plugins take a long time to start, since they probe hardware or wait
+ * for the network. If a scheduler is provided with SetScheduler(), LoadAll()
+ * returns once the plugins are loaded, and they're then started one per pass
+ * of the event loop, so clients are served while the rest of the plugins
+ * start. The plugins are still started in order of ID, so conflicts are
+ * resolved the same way either way.
  */
 class PluginManager {
  public:
@@ -64,6 +73,15 @@ class PluginManager {
    */
   ~PluginManager();
 
+  /**
+   * @brief Start the plugins from a scheduler, rather than within LoadAll().
+   * @param scheduler the SchedulerInterface to use, ownership is not
+   *   transferred. This must outlive the PluginManager.
+   */
+  void SetScheduler(ola::thread::SchedulerInterface *scheduler) {
+    m_scheduler = scheduler;
+  }
+
   /**
    * @brief Attempt to load all the plugins and start them.
    *
@@ -72,7 +90,13 @@ class PluginManager {
   void LoadAll();
 
   /**
-   * Unload all the plugins.
+   * @brief Returns true if there are plugins that are still to be started.
+   */
+  bool StartPending() const { return !m_pending_plugins.empty(); }
+
+  /**
+   * Unload all the plugins. Any plugins that haven't been started yet won't
+   * be.
    */
   void UnloadAll();
 
@@ -150,7 +174,15 @@ class PluginManager {
   PluginMap m_active_plugins;  // active plugins
   PluginMap m_enabled_plugins;  // enabled plugins
   PluginAdaptor *m_plugin_adaptor;
-
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::thread::timeout_id m_start_timeout;
+  // The plugins still to be started, the next one is at the back.
+  std::vector<ola_plugin_id> m_pending_plugins;
+  MonotonicClock m_clock;
+  TimeStamp m_load_time;
+
+  void StartNextPlugin();
+  void ScheduleNextPlugin();
   bool StartIfSafe(AbstractPlugin *plugin);
   AbstractPlugin* CheckForRunningConflicts(const AbstractPlugin *plugin) const;
 
@@ -29,6 +29,9 @@
 #include "olad/PluginManager.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/TestCommon.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
 #include "ola/testing/TestUtils.h"
 
 
@@ -44,11 +47,13 @@ class PluginManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PluginManagerTest);
   CPPUNIT_TEST(testPluginManager);
   CPPUNIT_TEST(testConflictingPlugins);
+  CPPUNIT_TEST(testScheduledStart);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testPluginManager();
     void testConflictingPlugins();
+    void testScheduledStart();
 
     void setUp() {
       ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -181,3 +186,86 @@ void PluginManagerTest::testConflictingPlugins() {
   manager.UnloadAll();
   VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
 }
+
+
+/*
+ * Check that plugins are started one at a time when there is a scheduler.
+ */
+void PluginManagerTest::testScheduledStart() {
+  ola::MockClock clock;
+  ola::io::SelectServer ss(NULL, &clock);
+  ola::ExportMap export_map;
+  ola::MemoryPreferencesFactory factory;
+  ola::PluginAdaptor adaptor(NULL, &ss, &export_map, &factory, NULL, NULL);
+
+  set<ola::ola_plugin_id> conflict_set;
+  conflict_set.insert(ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin1(&adaptor, ola::OLA_PLUGIN_DUMMY, conflict_set);
+  TestMockPlugin plugin2(&adaptor, ola::OLA_PLUGIN_ARTNET);
+  TestMockPlugin plugin3(&adaptor, ola::OLA_PLUGIN_SHOWNET);
+  TestMockPlugin plugin4(&adaptor, ola::OLA_PLUGIN_SANDNET);
+
+  vector<AbstractPlugin*> our_plugins;
+  our_plugins.push_back(&plugin1);
+  our_plugins.push_back(&plugin2);
+  our_plugins.push_back(&plugin3);
+  our_plugins.push_back(&plugin4);
+
+  MockLoader loader(our_plugins);
+  vector<PluginLoader*> loaders;
+  loaders.push_back(&loader);
+
+  PluginManager manager(loaders, &adaptor);
+  manager.SetScheduler(&ss);
+  manager.LoadAll();
+  VerifyPluginCounts(&manager, 4, 0, OLA_SOURCELINE());
+  OLA_ASSERT_TRUE(manager.StartPending());
+
+  clock.AdvanceTime(ola::TimeInterval(1000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  VerifyPluginCounts(&manager, 4, 1, OLA_SOURCELINE());
+  OLA_ASSERT_TRUE(plugin1.IsRunning());
+
+  // The Art-Net plugin conflicts with the dummy plugin, so it's skipped.
+  clock.AdvanceTime(ola::TimeInterval(1000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  VerifyPluginCounts(&manager, 4, 1, OLA_SOURCELINE());
+  OLA_ASSERT_FALSE(plugin2.IsRunning());
+
+  // Plugins can be started and stopped while the others are pending.
+  OLA_ASSERT_TRUE(manager.EnableAndStartPlugin(ola::OLA_PLUGIN_SANDNET));
+  manager.DisableAndStopPlugin(ola::OLA_PLUGIN_SHOWNET);
+  VerifyPluginCounts(&manager, 4, 2, OLA_SOURCELINE());
+
+  for (unsigned int i = 0; i < 2; i++) {
+    clock.AdvanceTime(ola::TimeInterval(1000));
+    ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+  OLA_ASSERT_FALSE(manager.StartPending());
+  VerifyPluginCounts(&manager, 4, 2, OLA_SOURCELINE());
+  OLA_ASSERT_FALSE(plugin3.IsRunning());
+  OLA_ASSERT_TRUE(plugin4.IsRunning());
+
+  // The start time is recorded for each plugin that was started.
+  const ola::UIntMap *start_times = export_map.GetUIntMapVar(
+      "plugin-start-time-ms");
+  vector<string> started;
+  ola::UIntMap::const_iterator iter = start_times->begin();
+  for (; iter != start_times->end(); ++iter) {
+    started.push_back(iter->first);
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(2), started.size());
+  OLA_ASSERT_EQ(plugin1.Name(), started[0]);
+  OLA_ASSERT_EQ(plugin4.Name(), started[1]);
+
+  // Unloading cancels any pending starts.
+  manager.UnloadAll();
+  manager.LoadAll();
+  OLA_ASSERT_TRUE(manager.StartPending());
+  manager.UnloadAll();
+  OLA_ASSERT_FALSE(manager.StartPending());
+  clock.AdvanceTime(ola::TimeInterval(1000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
+  OLA_ASSERT_FALSE(plugin1.IsRunning());
+}
@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMDeviceCache.cpp
+ * Remembers information about RDM devices across restarts.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "olad/RDMDeviceCache.h"
+
+namespace ola {
+
+using ola::rdm::DeviceDescriptor;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::ostringstream;
+using std::string;
+using std::vector;
+
+const char RDMDeviceCache::DEVICE_INFO_SUFFIX[] = "device_info";
+const char RDMDeviceCache::DEVICE_LABEL_SUFFIX[] = "device_label";
+const char RDMDeviceCache::MANUFACTURER_LABEL_SUFFIX[] = "manufacturer_label";
+const char RDMDeviceCache::SUPPORTED_PARAMETERS_SUFFIX[] = "supported_pids";
+const char RDMDeviceCache::UIDS_SUFFIX[] = "uids";
+
+namespace {
+
+// The number of fields in the serialized DEVICE_INFO.
+const unsigned int DEVICE_INFO_FIELDS = 11;
+
+/*
+ * Split a comma separated list of integers.
+ */
+template <typename int_type>
+bool SplitIntegers(const string &input, vector<int_type> *output) {
+  if (input.empty()) {
+    return true;
+  }
+  vector<string> tokens;
+  StringSplit(input, &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    int_type value;
+    if (!StringToInt(*iter, &value, true)) {
+      return false;
+    }
+    output->push_back(value);
+  }
+  return true;
+}
+
+/*
+ * The preferences file is line based and uses = as the separator, labels
+ * which contain either can't be stored.
+ */
+bool IsStorableLabel(const string &label) {
+  return label.find_first_of("=\r\n") == string::npos;
+}
+}  // namespace
+
+
+void RDMDeviceCache::GetUIDs(unsigned int universe, UIDSet *uids) const {
+  vector<string> tokens;
+  StringSplit(m_preferences->GetValue(UIDListKey(universe)), &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    auto_ptr<UID> uid(UID::FromString(*iter));
+    if (uid.get()) {
+      uids->AddUID(*uid);
+    }
+  }
+}
+
+
+bool RDMDeviceCache::GetLabels(unsigned int universe, const UID &uid,
+                               string *manufacturer_label,
+                               string *device_label) const {
+  const string manufacturer_key = Key(universe, uid,
+                                      MANUFACTURER_LABEL_SUFFIX);
+  const string device_key = Key(universe, uid, DEVICE_LABEL_SUFFIX);
+  if (!m_preferences->HasKey(manufacturer_key) ||
+      !m_preferences->HasKey(device_key)) {
+    return false;
+  }
+  *manufacturer_label = m_preferences->GetValue(manufacturer_key);
+  *device_label = m_preferences->GetValue(device_key);
+  return true;
+}
+
+
+void RDMDeviceCache::SetManufacturerLabel(unsigned int universe,
+                                          const UID &uid,
+                                          const string &label) {
+  if (!IsStorableLabel(label)) {
+    return;
+  }
+  AddUID(universe, uid);
+  m_preferences->SetValue(Key(universe, uid, MANUFACTURER_LABEL_SUFFIX),
+                          label);
+  m_dirty = true;
+}
+
+
+void RDMDeviceCache::SetDeviceLabel(unsigned int universe, const UID &uid,
+                                    const string &label) {
+  if (!IsStorableLabel(label)) {
+    return;
+  }
+  AddUID(universe, uid);
+  m_preferences->SetValue(Key(universe, uid, DEVICE_LABEL_SUFFIX), label);
+  m_dirty = true;
+}
+
+
+bool RDMDeviceCache::GetDeviceInfo(unsigned int universe, const UID &uid,
+                                   DeviceDescriptor *device) const {
+  const string key = Key(universe, uid, DEVICE_INFO_SUFFIX);
+  if (!m_preferences->HasKey(key)) {
+    return false;
+  }
+
+  vector<uint32_t> fields;
+  if (!SplitIntegers(m_preferences->GetValue(key), &fields) ||
+      fields.size() != DEVICE_INFO_FIELDS) {
+    OLA_WARN << "Invalid cached device info for " << uid;
+    return false;
+  }
+
+  device->protocol_version_high = fields[0];
+  device->protocol_version_low = fields[1];
+  device->device_model = fields[2];
+  device->product_category = fields[3];
+  device->software_version = fields[4];
+  device->dmx_footprint = fields[5];
+  device->current_personality = fields[6];
+  device->personality_count = fields[7];
+  device->dmx_start_address = fields[8];
+  device->sub_device_count = fields[9];
+  device->sensor_count = fields[10];
+  return true;
+}
+
+
+void RDMDeviceCache::SetDeviceInfo(unsigned int universe, const UID &uid,
+                                   const DeviceDescriptor &device) {
+  DeviceDescriptor old_device;
+  if (GetDeviceInfo(universe, uid, &old_device) &&
+      old_device.software_version != device.software_version) {
+    m_preferences->RemoveValue(
+        Key(universe, uid, SUPPORTED_PARAMETERS_SUFFIX));
+  }
+
+  ostringstream str;
+  str << static_cast<unsigned int>(device.protocol_version_high) << ","
+      << static_cast<unsigned int>(device.protocol_version_low) << ","
+      << device.device_model << ","
+      << device.product_category << ","
+      << device.software_version << ","
+      << device.dmx_footprint << ","
+      << static_cast<unsigned int>(device.current_personality) << ","
+      << static_cast<unsigned int>(device.personality_count) << ","
+      << device.dmx_start_address << ","
+      << device.sub_device_count << ","
+      << static_cast<unsigned int>(device.sensor_count);
+  AddUID(universe, uid);
+  m_preferences->SetValue(Key(universe, uid, DEVICE_INFO_SUFFIX), str.str());
+  m_dirty = true;
+}
+
+
+void RDMDeviceCache::InvalidateDeviceInfo(unsigned int universe,
+                                          const UID &uid) {
+  m_preferences->RemoveValue(Key(universe, uid, DEVICE_INFO_SUFFIX));
+  m_dirty = true;
+}
+
+
+bool RDMDeviceCache::GetSupportedParameters(unsigned int universe,
+                                            const UID &uid,
+                                            vector<uint16_t> *pids) const {
+  const string key = Key(universe, uid, SUPPORTED_PARAMETERS_SUFFIX);
+  if (!m_preferences->HasKey(key)) {
+    return false;
+  }
+
+  vector<uint16_t> cached_pids;
+  if (!SplitIntegers(m_preferences->GetValue(key), &cached_pids)) {
+    OLA_WARN << "Invalid cached supported parameters for " << uid;
+    return false;
+  }
+  pids->swap(cached_pids);
+  return true;
+}
+
+
+void RDMDeviceCache::SetSupportedParameters(unsigned int universe,
+                                            const UID &uid,
+                                            const vector<uint16_t> &pids) {
+  AddUID(universe, uid);
+  m_preferences->SetValue(Key(universe, uid, SUPPORTED_PARAMETERS_SUFFIX),
+                          StringJoin(",", pids));
+  m_dirty = true;
+}
+
+
+void RDMDeviceCache::RemoveUID(unsigned int universe, const UID &uid) {
+  m_preferences->RemoveValue(Key(universe, uid, DEVICE_INFO_SUFFIX));
+  m_preferences->RemoveValue(Key(universe, uid, DEVICE_LABEL_SUFFIX));
+  m_preferences->RemoveValue(Key(universe, uid, MANUFACTURER_LABEL_SUFFIX));
+  m_preferences->RemoveValue(Key(universe, uid, SUPPORTED_PARAMETERS_SUFFIX));
+
+  UIDSet uids;
+  GetUIDs(universe, &uids);
+  if (!uids.Contains(uid)) {
+    return;
+  }
+  uids.RemoveUID(uid);
+  m_dirty = true;
+  if (uids.Empty()) {
+    m_preferences->RemoveValue(UIDListKey(universe));
+  } else {
+    m_preferences->SetValue(UIDListKey(universe), uids.ToString());
+  }
+}
+
+
+void RDMDeviceCache::Save() {
+  if (m_dirty) {
+    m_preferences->Save();
+    m_dirty = false;
+  }
+}
+
+
+void RDMDeviceCache::AddUID(unsigned int universe, const UID &uid) {
+  UIDSet uids;
+  GetUIDs(universe, &uids);
+  if (!uids.Contains(uid)) {
+    uids.AddUID(uid);
+    m_preferences->SetValue(UIDListKey(universe), uids.ToString());
+  }
+}
+
+
+string RDMDeviceCache::UIDListKey(unsigned int universe) const {
+  ostringstream str;
+  str << universe << "_" << UIDS_SUFFIX;
+  return str.str();
+}
+
+
+string RDMDeviceCache::Key(unsigned int universe, const UID &uid,
+                           const char *suffix) const {
+  ostringstream str;
+  str << universe << "_" << uid << "_" << suffix;
+  return str.str();
+}
+}  // namespace ola
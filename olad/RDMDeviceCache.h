@@ -0,0 +1,135 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMDeviceCache.h
+ * Remembers information about RDM devices across restarts.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_RDMDEVICECACHE_H_
+#define OLAD_RDMDEVICECACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMAPI.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "olad/Preferences.h"
+
+namespace ola {
+
+/**
+ * @brief A cache of the labels, DEVICE_INFO and SUPPORTED_PARAMETERS for RDM
+ * devices, stored in a Preferences object.
+ *
+ * The cache doesn't know when a device changes; the caller removes a UID once
+ * discovery no longer reports it, and invalidates the device info after
+ * changing a setting that's part of it.
+ */
+class RDMDeviceCache {
+ public:
+  /**
+   * @brief Create a new RDMDeviceCache.
+   * @param preferences the Preferences to store the cache in. Ownership is not
+   *   transferred.
+   */
+  explicit RDMDeviceCache(Preferences *preferences)
+      : m_preferences(preferences),
+        m_dirty(false) {
+  }
+
+  /**
+   * @brief Get the UIDs that have entries in the cache.
+   * @param universe the universe id.
+   * @param[out] uids the set to add the UIDs to.
+   */
+  void GetUIDs(unsigned int universe, ola::rdm::UIDSet *uids) const;
+
+  /**
+   * @brief Get the labels for a device.
+   * @returns true if the labels were in the cache, false otherwise.
+   */
+  bool GetLabels(unsigned int universe, const ola::rdm::UID &uid,
+                 std::string *manufacturer_label,
+                 std::string *device_label) const;
+
+  void SetManufacturerLabel(unsigned int universe, const ola::rdm::UID &uid,
+                            const std::string &label);
+  void SetDeviceLabel(unsigned int universe, const ola::rdm::UID &uid,
+                      const std::string &label);
+
+  /**
+   * @brief Get the DEVICE_INFO for a device.
+   * @returns true if the device info was in the cache, false otherwise.
+   */
+  bool GetDeviceInfo(unsigned int universe, const ola::rdm::UID &uid,
+                     ola::rdm::DeviceDescriptor *device) const;
+
+  /**
+   * @brief Store the DEVICE_INFO for a device.
+   *
+   * If the software version has changed, the supported parameters are removed
+   * since the new firmware may not have the same ones.
+   */
+  void SetDeviceInfo(unsigned int universe, const ola::rdm::UID &uid,
+                     const ola::rdm::DeviceDescriptor &device);
+
+  /**
+   * @brief Remove the DEVICE_INFO for a device.
+   */
+  void InvalidateDeviceInfo(unsigned int universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Get the SUPPORTED_PARAMETERS for a device.
+   * @returns true if the parameters were in the cache, false otherwise.
+   */
+  bool GetSupportedParameters(unsigned int universe, const ola::rdm::UID &uid,
+                              std::vector<uint16_t> *pids) const;
+
+  void SetSupportedParameters(unsigned int universe, const ola::rdm::UID &uid,
+                              const std::vector<uint16_t> &pids);
+
+  /**
+   * @brief Remove everything stored for a device.
+   */
+  void RemoveUID(unsigned int universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Write the cache to storage, if it's changed since the last Save().
+   */
+  void Save();
+
+ private:
+  Preferences *m_preferences;
+  bool m_dirty;
+
+  void AddUID(unsigned int universe, const ola::rdm::UID &uid);
+  std::string UIDListKey(unsigned int universe) const;
+  std::string Key(unsigned int universe, const ola::rdm::UID &uid,
+                  const char *suffix) const;
+
+  static const char DEVICE_INFO_SUFFIX[];
+  static const char DEVICE_LABEL_SUFFIX[];
+  static const char MANUFACTURER_LABEL_SUFFIX[];
+  static const char SUPPORTED_PARAMETERS_SUFFIX[];
+  static const char UIDS_SUFFIX[];
+
+  DISALLOW_COPY_AND_ASSIGN(RDMDeviceCache);
+};
+}  // namespace ola
+#endif  // OLAD_RDMDEVICECACHE_H_
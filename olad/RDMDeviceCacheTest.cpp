@@ -0,0 +1,228 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMDeviceCacheTest.cpp
+ * Test fixture for the RDMDeviceCache class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "ola/rdm/RDMAPI.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/Preferences.h"
+#include "olad/RDMDeviceCache.h"
+
+using ola::MemoryPreferences;
+using ola::RDMDeviceCache;
+using ola::rdm::DeviceDescriptor;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::string;
+using std::vector;
+
+
+class RDMDeviceCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMDeviceCacheTest);
+  CPPUNIT_TEST(testLabels);
+  CPPUNIT_TEST(testDeviceInfo);
+  CPPUNIT_TEST(testSupportedParameters);
+  CPPUNIT_TEST(testRemoveUID);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    RDMDeviceCacheTest()
+        : m_uid1(0x7a70, 1),
+          m_uid2(0x7a70, 2) {
+    }
+
+    void testLabels();
+    void testDeviceInfo();
+    void testSupportedParameters();
+    void testRemoveUID();
+
+ private:
+    UID m_uid1;
+    UID m_uid2;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMDeviceCacheTest);
+
+static const unsigned int UNIVERSE = 1;
+
+
+/*
+ * Check the labels are stored.
+ */
+void RDMDeviceCacheTest::testLabels() {
+  MemoryPreferences preferences("rdm-cache");
+  RDMDeviceCache cache(&preferences);
+
+  string manufacturer, device;
+  OLA_ASSERT_FALSE(cache.GetLabels(UNIVERSE, m_uid1, &manufacturer, &device));
+
+  // both labels are needed
+  cache.SetManufacturerLabel(UNIVERSE, m_uid1, "Open Lighting");
+  OLA_ASSERT_FALSE(cache.GetLabels(UNIVERSE, m_uid1, &manufacturer, &device));
+  cache.SetDeviceLabel(UNIVERSE, m_uid1, "");
+  OLA_ASSERT_TRUE(cache.GetLabels(UNIVERSE, m_uid1, &manufacturer, &device));
+  OLA_ASSERT_EQ(string("Open Lighting"), manufacturer);
+  OLA_ASSERT_EQ(string(""), device);
+
+  // labels can't break the preferences file
+  cache.SetDeviceLabel(UNIVERSE, m_uid1, "a=b");
+  OLA_ASSERT_TRUE(cache.GetLabels(UNIVERSE, m_uid1, &manufacturer, &device));
+  OLA_ASSERT_EQ(string(""), device);
+
+  // a new cache with the same preferences sees the labels
+  RDMDeviceCache new_cache(&preferences);
+  OLA_ASSERT_TRUE(new_cache.GetLabels(UNIVERSE, m_uid1, &manufacturer,
+                                      &device));
+  OLA_ASSERT_EQ(string("Open Lighting"), manufacturer);
+
+  // other universes are separate
+  OLA_ASSERT_FALSE(cache.GetLabels(UNIVERSE + 1, m_uid1, &manufacturer,
+                                   &device));
+
+  UIDSet uids;
+  cache.GetUIDs(UNIVERSE, &uids);
+  OLA_ASSERT_EQ(1u, uids.Size());
+  OLA_ASSERT_TRUE(uids.Contains(m_uid1));
+}
+
+
+/*
+ * Check the DEVICE_INFO is stored.
+ */
+void RDMDeviceCacheTest::testDeviceInfo() {
+  MemoryPreferences preferences("rdm-cache");
+  RDMDeviceCache cache(&preferences);
+
+  DeviceDescriptor device;
+  OLA_ASSERT_FALSE(cache.GetDeviceInfo(UNIVERSE, m_uid1, &device));
+
+  memset(&device, 0, sizeof(device));
+  device.protocol_version_high = 1;
+  device.device_model = 0x1234;
+  device.product_category = 0x0101;
+  device.software_version = 0x01020304;
+  device.dmx_footprint = 24;
+  device.current_personality = 2;
+  device.personality_count = 3;
+  device.dmx_start_address = 512;
+  device.sub_device_count = 4;
+  device.sensor_count = 255;
+  cache.SetDeviceInfo(UNIVERSE, m_uid1, device);
+
+  DeviceDescriptor cached_device;
+  memset(&cached_device, 0, sizeof(cached_device));
+  OLA_ASSERT_TRUE(cache.GetDeviceInfo(UNIVERSE, m_uid1, &cached_device));
+  OLA_ASSERT_EQ(0, memcmp(&device, &cached_device, sizeof(device)));
+
+  cache.InvalidateDeviceInfo(UNIVERSE, m_uid1);
+  OLA_ASSERT_FALSE(cache.GetDeviceInfo(UNIVERSE, m_uid1, &cached_device));
+
+  // corrupt entries are ignored
+  preferences.SetValue("1_7a70:00000002_device_info", "1,2,3");
+  OLA_ASSERT_FALSE(cache.GetDeviceInfo(UNIVERSE, m_uid2, &cached_device));
+}
+
+
+/*
+ * Check the SUPPORTED_PARAMETERS are stored, and dropped if the software
+ * version changes.
+ */
+void RDMDeviceCacheTest::testSupportedParameters() {
+  MemoryPreferences preferences("rdm-cache");
+  RDMDeviceCache cache(&preferences);
+
+  vector<uint16_t> pids;
+  OLA_ASSERT_FALSE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+
+  // an empty list is still a valid response
+  cache.SetSupportedParameters(UNIVERSE, m_uid1, pids);
+  OLA_ASSERT_TRUE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+  OLA_ASSERT_TRUE(pids.empty());
+
+  vector<uint16_t> expected_pids;
+  expected_pids.push_back(0x0080);
+  expected_pids.push_back(0x0082);
+  expected_pids.push_back(0x8000);
+  cache.SetSupportedParameters(UNIVERSE, m_uid1, expected_pids);
+  OLA_ASSERT_TRUE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+  OLA_ASSERT_TRUE(expected_pids == pids);
+
+  DeviceDescriptor device;
+  memset(&device, 0, sizeof(device));
+  device.software_version = 1;
+  cache.SetDeviceInfo(UNIVERSE, m_uid1, device);
+  device.dmx_start_address = 10;
+  cache.SetDeviceInfo(UNIVERSE, m_uid1, device);
+  pids.clear();
+  OLA_ASSERT_TRUE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+  OLA_ASSERT_TRUE(expected_pids == pids);
+
+  // new firmware
+  device.software_version = 2;
+  cache.SetDeviceInfo(UNIVERSE, m_uid1, device);
+  OLA_ASSERT_FALSE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+}
+
+
+/*
+ * Check RemoveUID removes everything.
+ */
+void RDMDeviceCacheTest::testRemoveUID() {
+  MemoryPreferences preferences("rdm-cache");
+  RDMDeviceCache cache(&preferences);
+
+  DeviceDescriptor device;
+  memset(&device, 0, sizeof(device));
+  vector<uint16_t> pids;
+  pids.push_back(0x0080);
+
+  cache.SetManufacturerLabel(UNIVERSE, m_uid1, "foo");
+  cache.SetDeviceLabel(UNIVERSE, m_uid1, "bar");
+  cache.SetDeviceInfo(UNIVERSE, m_uid1, device);
+  cache.SetSupportedParameters(UNIVERSE, m_uid1, pids);
+  cache.SetDeviceLabel(UNIVERSE, m_uid2, "baz");
+
+  UIDSet uids;
+  cache.GetUIDs(UNIVERSE, &uids);
+  OLA_ASSERT_EQ(2u, uids.Size());
+
+  cache.RemoveUID(UNIVERSE, m_uid1);
+  string manufacturer, label;
+  OLA_ASSERT_FALSE(cache.GetLabels(UNIVERSE, m_uid1, &manufacturer, &label));
+  OLA_ASSERT_FALSE(cache.GetDeviceInfo(UNIVERSE, m_uid1, &device));
+  OLA_ASSERT_FALSE(cache.GetSupportedParameters(UNIVERSE, m_uid1, &pids));
+
+  uids.Clear();
+  cache.GetUIDs(UNIVERSE, &uids);
+  OLA_ASSERT_EQ(1u, uids.Size());
+  OLA_ASSERT_TRUE(uids.Contains(m_uid2));
+
+  cache.RemoveUID(UNIVERSE, m_uid2);
+  uids.Clear();
+  cache.GetUIDs(UNIVERSE, &uids);
+  OLA_ASSERT_TRUE(uids.Empty());
+  OLA_ASSERT_FALSE(preferences.HasKey("1_uids"));
+}
@@ -42,6 +42,7 @@
 #include "ola/thread/Mutex.h"
 #include "ola/web/Json.h"
 #include "ola/web/JsonSections.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/OlaServer.h"
 #include "olad/OladHTTPServer.h"
 #include "olad/RDMHTTPModule.h"
@@ -62,6 +63,7 @@ using ola::web::HiddenItem;
 using ola::web::JsonArray;
 using ola::web::JsonObject;
 using ola::web::JsonSection;
+using ola::web::JsonStreamWriter;
 using ola::web::SelectItem;
 using ola::web::StringItem;
 using ola::web::UIntItem;
@@ -159,12 +161,19 @@ const char RDMHTTPModule::RESET_DEVICE_SECTION_NAME[] = "Reset Device";
 const char RDMHTTPModule::TILT_INVERT_SECTION_NAME[] = "Tilt Invert";
 
 RDMHTTPModule::RDMHTTPModule(HTTPServer *http_server,
-                             client::OlaClient *client)
+                             client::OlaClient *client,
+                             Preferences *cache_preferences)
     : m_server(http_server),
       m_client(client),
       m_shim(client),
-      m_rdm_api(&m_shim),
-      m_pid_store(NULL) {
+      m_rdm_api(&m_response_cache),
+      m_memory_preferences(
+          cache_preferences ? NULL : new MemoryPreferences("rdm-cache")),
+      m_cache(cache_preferences ? cache_preferences :
+              m_memory_preferences.get()),
+      m_pid_store(NULL),
+      m_response_cache(&m_shim, http_server->SelectServer(),
+                       http_server->SelectServer()->LoopClock()) {
 
   m_server->RegisterHandler(
       "/rdm/run_discovery",
@@ -204,6 +213,8 @@ RDMHTTPModule::RDMHTTPModule(HTTPServer *http_server,
  * Teardown
  */
 RDMHTTPModule::~RDMHTTPModule() {
+  m_cache.Save();
+
   map<unsigned int, uid_resolution_state*>::iterator uid_iter;
   for (uid_iter = m_universe_uids.begin(); uid_iter != m_universe_uids.end();
        uid_iter++) {
@@ -221,6 +232,12 @@ void RDMHTTPModule::SetPidStore(const ola::rdm::RootPidStore *pid_store) {
 }
 
 
+bool RDMHTTPModule::HasPidStore() const {
+  MutexLocker lock(&m_pid_store_mu);
+  return m_pid_store != NULL;
+}
+
+
 /**
  * @brief Run RDM discovery for a universe
  * @param request the HTTPRequest
@@ -300,13 +317,31 @@ int RDMHTTPModule::JsonUIDInfo(const HTTPRequest *request,
   }
 
   string error;
+  ola::rdm::DeviceDescriptor device;
+  if (m_cache.GetDeviceInfo(universe_id, *uid, &device)) {
+    // Serve what we have, and refresh it for the next request.
+    m_rdm_api.GetDeviceInfo(
+        universe_id,
+        *uid,
+        ola::rdm::ROOT_RDM_DEVICE,
+        NewSingleCallback(this,
+                          &RDMHTTPModule::DeviceInfoRefreshed,
+                          universe_id,
+                          *uid),
+        &error);
+    delete uid;
+    return SendUIDInfo(response, device);
+  }
+
   bool ok = m_rdm_api.GetDeviceInfo(
       universe_id,
       *uid,
       ola::rdm::ROOT_RDM_DEVICE,
       NewSingleCallback(this,
                         &RDMHTTPModule::UIDInfoHandler,
-                        response),
+                        response,
+                        universe_id,
+                        *uid),
       &error);
   delete uid;
 
@@ -412,6 +447,12 @@ int RDMHTTPModule::JsonSupportedPIDs(const HTTPRequest *request,
     return OladHTTPServer::ServeHelpRedirect(response);
   }
 
+  vector<uint16_t> pids;
+  if (m_cache.GetSupportedParameters(universe_id, *uid, &pids)) {
+    delete uid;
+    return SendSupportedParams(response, pids);
+  }
+
   string error;
   bool ok = m_rdm_api.GetSupportedParameters(
       universe_id,
@@ -419,7 +460,9 @@ int RDMHTTPModule::JsonSupportedPIDs(const HTTPRequest *request,
       ola::rdm::ROOT_RDM_DEVICE,
       NewSingleCallback(this,
                         &RDMHTTPModule::SupportedParamsHandler,
-                        response),
+                        response,
+                        universe_id,
+                        *uid),
       &error);
   delete uid;
 
@@ -456,16 +499,37 @@ int RDMHTTPModule::JsonSupportedSections(const HTTPRequest *request,
   }
 
   string error;
-  bool ok = m_rdm_api.GetSupportedParameters(
-      universe_id,
-      *uid,
-      ola::rdm::ROOT_RDM_DEVICE,
-      NewSingleCallback(this,
-                        &RDMHTTPModule::SupportedSectionsHandler,
-                        response,
-                        universe_id,
-                        *uid),
-      &error);
+  bool ok;
+  vector<uint16_t> pids;
+  if (m_cache.GetSupportedParameters(universe_id, *uid, &pids)) {
+    ola::rdm::DeviceDescriptor device;
+    if (m_cache.GetDeviceInfo(universe_id, *uid, &device)) {
+      delete uid;
+      return SendSupportedSections(response, pids, &device);
+    }
+    ok = m_rdm_api.GetDeviceInfo(
+        universe_id,
+        *uid,
+        ola::rdm::ROOT_RDM_DEVICE,
+        NewSingleCallback(this,
+                          &RDMHTTPModule::SupportedSectionsDeviceInfoHandler,
+                          response,
+                          universe_id,
+                          *uid,
+                          pids),
+        &error);
+  } else {
+    ok = m_rdm_api.GetSupportedParameters(
+        universe_id,
+        *uid,
+        ola::rdm::ROOT_RDM_DEVICE,
+        NewSingleCallback(this,
+                          &RDMHTTPModule::SupportedSectionsHandler,
+                          response,
+                          universe_id,
+                          *uid),
+        &error);
+  }
   delete uid;
 
   if (!ok) {
@@ -649,6 +713,8 @@ int RDMHTTPModule::JsonSaveSectionInfo(const HTTPRequest *request,
     return OladHTTPServer::ServeHelpRedirect(response);
   }
 
+  // Most settings are reflected in DEVICE_INFO, so fetch it again next time.
+  m_cache.InvalidateDeviceInfo(universe_id, *uid);
   delete uid;
   if (!error.empty()) {
     return RespondWithError(response, error);
@@ -681,6 +747,7 @@ void RDMHTTPModule::PruneUniverseList(const vector<OlaUniverse> &universes) {
   for (uid_iter = m_universe_uids.begin(); uid_iter != m_universe_uids.end();) {
     if (!uid_iter->second->active) {
       OLA_DEBUG << "removing " << uid_iter->first << " from the uid map";
+      m_response_cache.InvalidateUniverse(uid_iter->first);
       delete uid_iter->second;
       m_universe_uids.erase(uid_iter++);
     } else {
@@ -713,9 +780,9 @@ void RDMHTTPModule::HandleUIDList(HTTPResponse *response,
        uid_iter != uid_state->resolved_uids.end(); ++uid_iter)
     uid_iter->second.active = false;
 
-  JsonObject json;
-  json.Add("universe", universe_id);
-  JsonArray *json_uids = json.AddArray("uids");
+  JsonStreamWriter json(response->MutableBody());
+  json.StartObject();
+  json.AddArray("uids");
 
   for (; iter != uids.End(); ++iter) {
     uid_iter = uid_state->resolved_uids.find(*iter);
@@ -724,29 +791,40 @@ void RDMHTTPModule::HandleUIDList(HTTPResponse *response,
     string device = "";
 
     if (uid_iter == uid_state->resolved_uids.end()) {
-      // schedule resolution
-      uid_state->pending_uids.push(std::make_pair(*iter, RESOLVE_MANUFACTURER));
-      uid_state->pending_uids.push(std::make_pair(*iter, RESOLVE_DEVICE));
       resolved_uid uid_descriptor = {"", "", true};
+      if (m_cache.GetLabels(universe_id, *iter, &uid_descriptor.manufacturer,
+                            &uid_descriptor.device)) {
+        manufacturer = uid_descriptor.manufacturer;
+        device = uid_descriptor.device;
+      } else {
+        // schedule resolution
+        uid_state->pending_uids.push(
+            std::make_pair(*iter, RESOLVE_MANUFACTURER));
+        uid_state->pending_uids.push(std::make_pair(*iter, RESOLVE_DEVICE));
+        OLA_INFO << "Adding UID " << *iter << " to resolution queue";
+      }
       uid_state->resolved_uids[*iter] = uid_descriptor;
-      OLA_INFO << "Adding UID " << *iter << " to resolution queue";
     } else {
       manufacturer = uid_iter->second.manufacturer;
       device = uid_iter->second.device;
       uid_iter->second.active = true;
     }
 
-    JsonObject *json_uid = json_uids->AppendObject();
-    json_uid->Add("manufacturer_id", iter->ManufacturerId());
-    json_uid->Add("device_id", iter->DeviceId());
-    json_uid->Add("device", device);
-    json_uid->Add("manufacturer", manufacturer);
-    json_uid->Add("uid", iter->ToString());
+    json.AppendObject();
+    json.Add("device", device);
+    json.Add("device_id", iter->DeviceId());
+    json.Add("manufacturer", manufacturer);
+    json.Add("manufacturer_id", iter->ManufacturerId());
+    json.Add("uid", iter->ToString());
+    json.End();
   }
+  json.End();  // uids
+  json.Add("universe", universe_id);
+  json.End();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(json);
+  response->Send();
   delete response;
 
   // remove any old UIDs
@@ -760,6 +838,16 @@ void RDMHTTPModule::HandleUIDList(HTTPResponse *response,
     }
   }
 
+  // This also catches UIDs that were cached by a previous run.
+  ola::rdm::UIDSet cached_uids;
+  m_cache.GetUIDs(universe_id, &cached_uids);
+  ola::rdm::UIDSet removed_uids = cached_uids.SetDifference(uids);
+  for (iter = removed_uids.Begin(); iter != removed_uids.End(); ++iter) {
+    m_cache.RemoveUID(universe_id, *iter);
+    m_response_cache.InvalidateUID(universe_id, *iter);
+  }
+  m_cache.Save();
+
   if (!uid_state->uid_resolution_running) {
     ResolveNextUID(universe_id);
   }
@@ -782,6 +870,7 @@ void RDMHTTPModule::ResolveNextUID(unsigned int universe_id) {
   while (!sent_request) {
     if (uid_state->pending_uids.empty()) {
       uid_state->uid_resolution_running = false;
+      m_cache.Save();
       return;
     }
     uid_state->uid_resolution_running = true;
@@ -838,7 +927,11 @@ void RDMHTTPModule::UpdateUIDManufacturerLabel(
     uid_iter = uid_state->resolved_uids.find(uid);
     if (uid_iter != uid_state->resolved_uids.end()) {
       uid_iter->second.manufacturer = manufacturer_label;
+      m_cache.SetManufacturerLabel(universe, uid, manufacturer_label);
     }
+  } else if (status.WasNacked()) {
+    // The device doesn't have a label, don't ask again.
+    m_cache.SetManufacturerLabel(universe, uid, "");
   }
   ResolveNextUID(universe);
 }
@@ -863,7 +956,10 @@ void RDMHTTPModule::UpdateUIDDeviceLabel(
     uid_iter = uid_state->resolved_uids.find(uid);
     if (uid_iter != uid_state->resolved_uids.end()) {
       uid_iter->second.device = device_label;
+      m_cache.SetDeviceLabel(universe, uid, device_label);
     }
+  } else if (status.WasNacked()) {
+    m_cache.SetDeviceLabel(universe, uid, "");
   }
   ResolveNextUID(universe);
 }
@@ -907,12 +1003,39 @@ RDMHTTPModule::uid_resolution_state *RDMHTTPModule::GetUniverseUidsOrCreate(
  * @brief Handle the Device Info response and build the JSON
  */
 void RDMHTTPModule::UIDInfoHandler(HTTPResponse *response,
+                                   unsigned int universe,
+                                   UID uid,
                                    const ola::rdm::ResponseStatus &status,
                                    const ola::rdm::DeviceDescriptor &device) {
   if (CheckForRDMError(response, status)) {
     return;
   }
+  m_cache.SetDeviceInfo(universe, uid, device);
+  SendUIDInfo(response, device);
+}
 
+
+/**
+ * @brief Store the Device Info fetched after serving the cached copy.
+ */
+void RDMHTTPModule::DeviceInfoRefreshed(
+    unsigned int universe,
+    UID uid,
+    const ola::rdm::ResponseStatus &status,
+    const ola::rdm::DeviceDescriptor &device) {
+  if (CheckForRDMSuccess(status)) {
+    m_cache.SetDeviceInfo(universe, uid, device);
+  } else {
+    m_cache.InvalidateDeviceInfo(universe, uid);
+  }
+}
+
+
+/**
+ * @brief Build the JSON for the Device Info
+ */
+int RDMHTTPModule::SendUIDInfo(HTTPResponse *response,
+                               const ola::rdm::DeviceDescriptor &device) {
   JsonObject json;
   json.Add("error", "");
   json.Add("address", device.dmx_start_address);
@@ -922,8 +1045,9 @@ void RDMHTTPModule::UIDInfoHandler(HTTPResponse *response,
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(json);
+  int r = response->SendJson(json);
   delete response;
+  return r;
 }
 
 
@@ -983,16 +1107,17 @@ void RDMHTTPModule::SendPersonalityResponse(HTTPResponse *response,
  */
 void RDMHTTPModule::SupportedParamsHandler(
     HTTPResponse *response,
+    unsigned int universe,
+    UID uid,
     const ola::rdm::ResponseStatus &status,
     const vector<uint16_t> &pids) {
-  JsonObject json;
   if (CheckForRDMSuccess(status)) {
-    JsonArray *pids_json = json.AddArray("pids");
-    vector<uint16_t>::const_iterator iter = pids.begin();
-    for (; iter != pids.end(); ++iter)
-      pids_json->Append(*iter);
+    m_cache.SetSupportedParameters(universe, uid, pids);
+    SendSupportedParams(response, pids);
+    return;
   }
 
+  JsonObject json;
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
   response->SendJson(json);
@@ -1000,6 +1125,25 @@ void RDMHTTPModule::SupportedParamsHandler(
 }
 
 
+/*
+ * @brief Build the JSON for a list of supported params
+ */
+int RDMHTTPModule::SendSupportedParams(HTTPResponse *response,
+                                       const vector<uint16_t> &pids) {
+  JsonObject json;
+  JsonArray *pids_json = json.AddArray("pids");
+  vector<uint16_t>::const_iterator iter = pids.begin();
+  for (; iter != pids.end(); ++iter)
+    pids_json->Append(*iter);
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->SendJson(json);
+  delete response;
+  return r;
+}
+
+
 /**
  * @brief Takes the supported PIDs for a device and come up with the list of
  * sections to display in the RDM panel
@@ -1017,6 +1161,15 @@ void RDMHTTPModule::SupportedSectionsHandler(
     m_server->ServeError(response, BACKEND_DISCONNECTED_ERROR + error);
     return;
   }
+  if (CheckForRDMSuccess(status)) {
+    m_cache.SetSupportedParameters(universe_id, uid, pid_list);
+  }
+
+  ola::rdm::DeviceDescriptor device;
+  if (m_cache.GetDeviceInfo(universe_id, uid, &device)) {
+    SendSupportedSections(response, pid_list, &device);
+    return;
+  }
 
   m_rdm_api.GetDeviceInfo(
       universe_id,
@@ -1025,6 +1178,8 @@ void RDMHTTPModule::SupportedSectionsHandler(
       NewSingleCallback(this,
                         &RDMHTTPModule::SupportedSectionsDeviceInfoHandler,
                         response,
+                        universe_id,
+                        uid,
                         pid_list),
       &error);
   if (!error.empty())
@@ -1037,9 +1192,28 @@ void RDMHTTPModule::SupportedSectionsHandler(
  */
 void RDMHTTPModule::SupportedSectionsDeviceInfoHandler(
     HTTPResponse *response,
+    unsigned int universe_id,
+    UID uid,
     const vector<uint16_t> pid_list,
     const ola::rdm::ResponseStatus &status,
     const ola::rdm::DeviceDescriptor &device) {
+  if (CheckForRDMSuccess(status)) {
+    m_cache.SetDeviceInfo(universe_id, uid, device);
+    SendSupportedSections(response, pid_list, &device);
+  } else {
+    SendSupportedSections(response, pid_list, NULL);
+  }
+}
+
+
+/**
+ * @brief Build the list of sections from the supported PIDs and the device
+ * info, if we have it.
+ */
+int RDMHTTPModule::SendSupportedSections(
+    HTTPResponse *response,
+    const vector<uint16_t> &pid_list,
+    const ola::rdm::DeviceDescriptor *device) {
   vector<section_info> sections;
   std::set<uint16_t> pids;
   copy(pid_list.begin(), pid_list.end(), inserter(pids, pids.end()));
@@ -1161,15 +1335,15 @@ void RDMHTTPModule::SupportedSectionsDeviceInfoHandler(
     AddSection(&sections, BOOT_SOFTWARE_SECTION, BOOT_SOFTWARE_SECTION_NAME);
   }
 
-  if (CheckForRDMSuccess(status)) {
-    if (device.dmx_footprint && !dmx_address_added) {
+  if (device) {
+    if (device->dmx_footprint && !dmx_address_added) {
       AddSection(&sections, DMX_ADDRESS_SECTION, DMX_ADDRESS_SECTION_NAME);
     }
-    if (device.sensor_count &&
+    if (device->sensor_count &&
         pids.find(ola::rdm::PID_SENSOR_DEFINITION) != pids.end() &&
         pids.find(ola::rdm::PID_SENSOR_VALUE) != pids.end()) {
       // sensors count from 1
-      for (unsigned int i = 0; i < device.sensor_count; ++i) {
+      for (unsigned int i = 0; i < device->sensor_count; ++i) {
         ostringstream heading, hint;
         hint << i;
         heading << "Sensor " << std::setfill(' ') << std::setw(3) << i;
@@ -1191,8 +1365,9 @@ void RDMHTTPModule::SupportedSectionsDeviceInfoHandler(
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(json);
+  int r = response->SendJson(json);
   delete response;
+  return r;
 }
 
 
@@ -1430,6 +1605,7 @@ void RDMHTTPModule::GetDeviceInfoHandler(
   if (CheckForRDMError(response, status)) {
     return;
   }
+  m_cache.SetDeviceInfo(dev_info.universe_id, dev_info.uid, device);
 
   ostringstream stream;
   stream << static_cast<int>(device.protocol_version_high) << "."
@@ -1575,6 +1751,7 @@ void RDMHTTPModule::GetManufacturerLabelHandler(
       uid_state->resolved_uids.find(uid);
     if (uid_iter != uid_state->resolved_uids.end()) {
       uid_iter->second.manufacturer = label;
+      m_cache.SetManufacturerLabel(universe_id, uid, label);
     }
   }
 }
@@ -1626,6 +1803,7 @@ void RDMHTTPModule::GetDeviceLabelHandler(
       uid_state->resolved_uids.find(uid);
     if (uid_iter != uid_state->resolved_uids.end()) {
       uid_iter->second.device = label;
+      m_cache.SetDeviceLabel(universe_id, uid, label);
     }
   }
 }
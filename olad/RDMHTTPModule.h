@@ -22,6 +22,7 @@
 #define OLAD_RDMHTTPMODULE_H_
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <string>
 #include <utility>
@@ -35,6 +36,9 @@
 #include "ola/rdm/UID.h"
 #include "ola/thread/Mutex.h"
 #include "ola/web/JsonSections.h"
+#include "olad/Preferences.h"
+#include "olad/RDMDeviceCache.h"
+#include "olad/RDMResponseCache.h"
 
 namespace ola {
 
@@ -44,11 +48,19 @@ namespace ola {
  */
 class RDMHTTPModule {
  public:
+    /**
+     * @param http_server the HTTPServer to register the handlers with.
+     * @param client the OlaClient to use for RDM requests.
+     * @param cache_preferences the Preferences to keep the RDMDeviceCache in,
+     *   or NULL to only cache in memory. Ownership is not transferred.
+     */
     RDMHTTPModule(ola::http::HTTPServer *http_server,
-                  ola::client::OlaClient *client);
+                  ola::client::OlaClient *client,
+                  Preferences *cache_preferences = NULL);
     ~RDMHTTPModule();
 
     void SetPidStore(const ola::rdm::RootPidStore *pid_store);
+    bool HasPidStore() const;
 
     int RunRDMDiscovery(const ola::http::HTTPRequest *request,
                         ola::http::HTTPResponse *response);
@@ -100,10 +112,16 @@ class RDMHTTPModule {
     ola::client::ClientRDMAPIShim m_shim;
     ola::rdm::RDMAPI m_rdm_api;
     std::map<unsigned int, uid_resolution_state*> m_universe_uids;
+    std::auto_ptr<Preferences> m_memory_preferences;
+    RDMDeviceCache m_cache;
 
-    ola::thread::Mutex m_pid_store_mu;
+    mutable ola::thread::Mutex m_pid_store_mu;
     const ola::rdm::RootPidStore *m_pid_store;  // GUARDED_BY(m_pid_store_mu);
 
+    // m_rdm_api sends through this. It's declared last so it's destroyed
+    // first, while the handlers for any undelivered responses still work.
+    RDMResponseCache m_response_cache;
+
     typedef struct {
       std::string id;
       std::string name;
@@ -158,8 +176,16 @@ class RDMHTTPModule {
 
     // uid info handler
     void UIDInfoHandler(ola::http::HTTPResponse *response,
+                        unsigned int universe,
+                        ola::rdm::UID uid,
                         const ola::rdm::ResponseStatus &status,
                         const ola::rdm::DeviceDescriptor &device);
+    int SendUIDInfo(ola::http::HTTPResponse *response,
+                    const ola::rdm::DeviceDescriptor &device);
+    void DeviceInfoRefreshed(unsigned int universe,
+                             ola::rdm::UID uid,
+                             const ola::rdm::ResponseStatus &status,
+                             const ola::rdm::DeviceDescriptor &device);
 
     // uid identify handler
     void UIDIdentifyDeviceHandler(ola::http::HTTPResponse *response,
@@ -173,8 +199,12 @@ class RDMHTTPModule {
 
     // supported params / sections
     void SupportedParamsHandler(ola::http::HTTPResponse *response,
+                                unsigned int universe,
+                                ola::rdm::UID uid,
                                 const ola::rdm::ResponseStatus &status,
                                 const std::vector<uint16_t> &pids);
+    int SendSupportedParams(ola::http::HTTPResponse *response,
+                            const std::vector<uint16_t> &pids);
     void SupportedSectionsHandler(ola::http::HTTPResponse *response,
                                   unsigned int universe,
                                   ola::rdm::UID uid,
@@ -182,9 +212,14 @@ class RDMHTTPModule {
                                   const std::vector<uint16_t> &pids);
     void SupportedSectionsDeviceInfoHandler(
         ola::http::HTTPResponse *response,
+        unsigned int universe,
+        ola::rdm::UID uid,
         const std::vector<uint16_t> pids,
         const ola::rdm::ResponseStatus &status,
         const ola::rdm::DeviceDescriptor &device);
+    int SendSupportedSections(ola::http::HTTPResponse *response,
+                              const std::vector<uint16_t> &pids,
+                              const ola::rdm::DeviceDescriptor *device);
 
     // section methods
     std::string GetCommStatus(ola::http::HTTPResponse *response,
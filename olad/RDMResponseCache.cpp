@@ -0,0 +1,323 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.cpp
+ * Caches the responses to RDM GETs for a short time.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/RDMResponseCache.h"
+
+namespace ola {
+
+using ola::rdm::RDMAPIImplInterface;
+using ola::rdm::ResponseStatus;
+using ola::rdm::UID;
+using std::string;
+using std::vector;
+
+const unsigned int RDMResponseCache::DEFAULT_TTL_MS;
+const unsigned int RDMResponseCache::STATIC_TTL_MS;
+// Once there are this many entries, remove the expired ones as new ones are
+// added.
+const unsigned int RDMResponseCache::PRUNE_THRESHOLD = 1024;
+
+RDMResponseCache::Key::Key(unsigned int universe, const UID &uid,
+                           uint16_t sub_device, uint16_t pid,
+                           const uint8_t *data, unsigned int data_length)
+    : universe(universe),
+      uid(uid),
+      sub_device(sub_device),
+      pid(pid) {
+  if (data && data_length) {
+    param_data.assign(reinterpret_cast<const char*>(data), data_length);
+  }
+}
+
+bool RDMResponseCache::Key::operator<(const Key &other) const {
+  if (universe != other.universe) {
+    return universe < other.universe;
+  }
+  if (uid != other.uid) {
+    return uid < other.uid;
+  }
+  if (sub_device != other.sub_device) {
+    return sub_device < other.sub_device;
+  }
+  if (pid != other.pid) {
+    return pid < other.pid;
+  }
+  return param_data < other.param_data;
+}
+
+RDMResponseCache::RDMResponseCache(RDMAPIImplInterface *impl,
+                                   ola::thread::ExecutorInterface *executor,
+                                   const Clock *clock)
+    : m_impl(impl),
+      m_executor(executor),
+      m_clock(clock),
+      m_pending_responses(0) {
+}
+
+RDMResponseCache::~RDMResponseCache() {
+  if (m_pending_responses) {
+    // The cached responses refer to this object.
+    m_executor->DrainCallbacks();
+  }
+
+  FetchMap::iterator iter = m_fetches.begin();
+  for (; iter != m_fetches.end(); ++iter) {
+    vector<Waiter>::iterator waiter = iter->second->waiters.begin();
+    for (; waiter != iter->second->waiters.end(); ++waiter) {
+      delete waiter->callback;
+      delete waiter->pid_callback;
+    }
+    delete iter->second;
+  }
+}
+
+bool RDMResponseCache::RDMGet(rdm_callback *callback,
+                              unsigned int universe,
+                              const UID &uid,
+                              uint16_t sub_device,
+                              uint16_t pid,
+                              const uint8_t *data,
+                              unsigned int data_length) {
+  if (uid.IsBroadcast() || !TTLForPid(pid)) {
+    return m_impl->RDMGet(callback, universe, uid, sub_device, pid, data,
+                          data_length);
+  }
+  return Get(Waiter(callback, NULL),
+             Key(universe, uid, sub_device, pid, data, data_length));
+}
+
+bool RDMResponseCache::RDMGet(rdm_pid_callback *callback,
+                              unsigned int universe,
+                              const UID &uid,
+                              uint16_t sub_device,
+                              uint16_t pid,
+                              const uint8_t *data,
+                              unsigned int data_length) {
+  if (uid.IsBroadcast() || !TTLForPid(pid)) {
+    return m_impl->RDMGet(callback, universe, uid, sub_device, pid, data,
+                          data_length);
+  }
+  return Get(Waiter(NULL, callback),
+             Key(universe, uid, sub_device, pid, data, data_length));
+}
+
+bool RDMResponseCache::RDMSet(rdm_callback *callback,
+                              unsigned int universe,
+                              const UID &uid,
+                              uint16_t sub_device,
+                              uint16_t pid,
+                              const uint8_t *data,
+                              unsigned int data_length) {
+  InvalidateUID(universe, uid);
+  return m_impl->RDMSet(callback, universe, uid, sub_device, pid, data,
+                        data_length);
+}
+
+void RDMResponseCache::InvalidateUID(unsigned int universe, const UID &uid) {
+  EntryMap::iterator iter = m_entries.begin();
+  while (iter != m_entries.end()) {
+    if (Matches(iter->first, universe, uid)) {
+      m_entries.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+
+  FetchMap::iterator fetch_iter = m_fetches.begin();
+  for (; fetch_iter != m_fetches.end(); ++fetch_iter) {
+    if (Matches(fetch_iter->first, universe, uid)) {
+      fetch_iter->second->invalidated = true;
+    }
+  }
+}
+
+void RDMResponseCache::InvalidateUniverse(unsigned int universe) {
+  InvalidateUID(universe, UID::AllDevices());
+}
+
+/*
+ * Answer a GET from the cache, join an outstanding GET or send a new one.
+ */
+bool RDMResponseCache::Get(const Waiter &waiter, const Key &key) {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  EntryMap::iterator iter = m_entries.find(key);
+  if (iter != m_entries.end()) {
+    const Entry &entry = iter->second;
+    if (now < entry.expiry_time) {
+      m_pending_responses++;
+      m_executor->Execute(NewSingleCallback(
+          this, &RDMResponseCache::CachedResponse, waiter, entry.status,
+          key.pid, entry.data));
+
+      if (now >= entry.refresh_time && !STLContains(m_fetches, key)) {
+        // Keep this entry warm for the next caller.
+        StartFetch(key, new Fetch());
+      }
+      return true;
+    }
+    m_entries.erase(iter);
+  }
+
+  Fetch *fetch = STLFindOrNull(m_fetches, key);
+  if (fetch) {
+    fetch->waiters.push_back(waiter);
+    return true;
+  }
+
+  fetch = new Fetch();
+  fetch->waiters.push_back(waiter);
+  return StartFetch(key, fetch);
+}
+
+/*
+ * Send the GET for a fetch. Ownership of the fetch is transferred, if this
+ * fails the fetch is deleted but the waiters' callbacks aren't.
+ */
+bool RDMResponseCache::StartFetch(const Key &key, Fetch *fetch) {
+  // The response may arrive before RDMGet() returns.
+  m_fetches[key] = fetch;
+  rdm_pid_callback *callback = NewSingleCallback(
+      this, &RDMResponseCache::FetchComplete, key);
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(
+      key.param_data.data());
+  bool ok = m_impl->RDMGet(callback, key.universe, key.uid, key.sub_device,
+                           key.pid, key.param_data.empty() ? NULL : data,
+                           key.param_data.size());
+  if (!ok) {
+    delete callback;
+    m_fetches.erase(key);
+    delete fetch;
+  }
+  return ok;
+}
+
+void RDMResponseCache::FetchComplete(Key key,
+                                     const ResponseStatus &status,
+                                     uint16_t pid,
+                                     const string &data) {
+  FetchMap::iterator iter = m_fetches.find(key);
+  if (iter == m_fetches.end()) {
+    return;
+  }
+  Fetch *fetch = iter->second;
+  m_fetches.erase(iter);
+
+  // If a background refresh failed, the existing entry is left to expire.
+  if (!fetch->invalidated && pid == key.pid && IsCacheable(status)) {
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    unsigned int ttl = TTLForPid(key.pid);
+    Entry &entry = m_entries[key];
+    entry.status = status;
+    entry.data = data;
+    // Refresh in the background once the entry is half way to expiry.
+    entry.refresh_time = now + TimeInterval(static_cast<int64_t>(ttl) * 500);
+    entry.expiry_time = now + TimeInterval(static_cast<int64_t>(ttl) * 1000);
+    if (m_entries.size() > PRUNE_THRESHOLD) {
+      PruneExpired(now);
+    }
+  }
+
+  vector<Waiter>::const_iterator waiter = fetch->waiters.begin();
+  for (; waiter != fetch->waiters.end(); ++waiter) {
+    Deliver(*waiter, status, pid, data);
+  }
+  delete fetch;
+}
+
+void RDMResponseCache::CachedResponse(Waiter waiter,
+                                      ResponseStatus status,
+                                      uint16_t pid,
+                                      string data) {
+  m_pending_responses--;
+  Deliver(waiter, status, pid, data);
+}
+
+void RDMResponseCache::Deliver(const Waiter &waiter,
+                               const ResponseStatus &status,
+                               uint16_t pid,
+                               const string &data) {
+  if (waiter.callback) {
+    waiter.callback->Run(status, data);
+  } else {
+    waiter.pid_callback->Run(status, pid, data);
+  }
+}
+
+void RDMResponseCache::PruneExpired(const TimeStamp &now) {
+  EntryMap::iterator iter = m_entries.begin();
+  while (iter != m_entries.end()) {
+    if (iter->second.expiry_time <= now) {
+      m_entries.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+bool RDMResponseCache::Matches(const Key &key, unsigned int universe,
+                               const UID &uid) const {
+  return key.universe == universe && uid.DirectedToUID(key.uid);
+}
+
+/*
+ * Returns how long to cache a PID for, 0 means it's never cached.
+ */
+unsigned int RDMResponseCache::TTLForPid(uint16_t pid) {
+  switch (pid) {
+    // Reading these changes the device's state.
+    case ola::rdm::PID_QUEUED_MESSAGE:
+    case ola::rdm::PID_STATUS_MESSAGES:
+      return 0;
+    case ola::rdm::PID_SUPPORTED_PARAMETERS:
+    case ola::rdm::PID_PARAMETER_DESCRIPTION:
+    case ola::rdm::PID_PRODUCT_DETAIL_ID_LIST:
+    case ola::rdm::PID_DEVICE_MODEL_DESCRIPTION:
+    case ola::rdm::PID_MANUFACTURER_LABEL:
+    case ola::rdm::PID_LANGUAGE_CAPABILITIES:
+    case ola::rdm::PID_SOFTWARE_VERSION_LABEL:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_ID:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_LABEL:
+    case ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION:
+    case ola::rdm::PID_SLOT_INFO:
+    case ola::rdm::PID_SLOT_DESCRIPTION:
+    case ola::rdm::PID_DEFAULT_SLOT_VALUE:
+    case ola::rdm::PID_SENSOR_DEFINITION:
+    case ola::rdm::PID_SELF_TEST_DESCRIPTION:
+    case ola::rdm::PID_STATUS_ID_DESCRIPTION:
+      return STATIC_TTL_MS;
+    default:
+      return DEFAULT_TTL_MS;
+  }
+}
+
+bool RDMResponseCache::IsCacheable(const ResponseStatus &status) {
+  return status.WasAcked() || status.WasNacked();
+}
+}  // namespace ola
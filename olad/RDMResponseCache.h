@@ -0,0 +1,206 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.h
+ * Caches the responses to RDM GETs for a short time.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_RDMRESPONSECACHE_H_
+#define OLAD_RDMRESPONSECACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMAPIImplInterface.h"
+#include "ola/rdm/UID.h"
+#include "ola/thread/ExecutorInterface.h"
+
+namespace ola {
+
+/**
+ * @brief An RDMAPIImplInterface that caches GET responses.
+ *
+ * When several people have the RDM pages open, the web UI sends the same GETs
+ * over and over. The RDMResponseCache sits between the RDMAPI and the real
+ * implementation and:
+ *  - answers a GET from the cache if the response is fresh enough,
+ *  - shares a single outstanding GET between everyone who asks for the same
+ *    (universe, UID, sub device, PID, param data) while it's in flight,
+ *  - once a cached response is half way to expiry, the next hit is answered
+ *    from the cache while the response is fetched again in the background.
+ *
+ * Only ACKs and NACKs are cached. A SET to a device drops everything cached
+ * for it, since a SET often changes more than one PID. PIDs that are
+ * destructive to read, like QUEUED_MESSAGE, are never cached.
+ *
+ * Responses from the cache are delivered via the executor, so the callback
+ * never runs before RDMGet() returns, which matches the real implementation.
+ * Everything must be called from the executor's thread.
+ */
+class RDMResponseCache : public ola::rdm::RDMAPIImplInterface {
+ public:
+  /**
+   * @brief Create a new RDMResponseCache.
+   * @param impl the implementation to send requests with.
+   * @param executor the executor to run cached responses on.
+   * @param clock the clock to use for expiry.
+   *
+   * Ownership of the arguments is not transferred.
+   */
+  RDMResponseCache(ola::rdm::RDMAPIImplInterface *impl,
+                   ola::thread::ExecutorInterface *executor,
+                   const Clock *clock);
+
+  /**
+   * @brief Destructor. Cached responses which haven't been delivered yet are
+   *   run by draining the executor. The wrapped implementation must not run
+   *   any callbacks for outstanding GETs once this returns.
+   */
+  ~RDMResponseCache();
+
+  bool RDMGet(rdm_callback *callback,
+              unsigned int universe,
+              const ola::rdm::UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data = NULL,
+              unsigned int data_length = 0);
+
+  bool RDMGet(rdm_pid_callback *callback,
+              unsigned int universe,
+              const ola::rdm::UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data = NULL,
+              unsigned int data_length = 0);
+
+  bool RDMSet(rdm_callback *callback,
+              unsigned int universe,
+              const ola::rdm::UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data = NULL,
+              unsigned int data_length = 0);
+
+  /**
+   * @brief Drop the cached responses for a device, or for all devices the UID
+   *   addresses if it's a broadcast UID.
+   */
+  void InvalidateUID(unsigned int universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Drop the cached responses for all devices on a universe.
+   */
+  void InvalidateUniverse(unsigned int universe);
+
+  /**
+   * @brief The number of cached responses, including expired ones that
+   *   haven't been removed yet.
+   */
+  unsigned int Size() const { return m_entries.size(); }
+
+  /**
+   * @brief How long responses are cached for, unless the PID is one that
+   * rarely changes.
+   */
+  static const unsigned int DEFAULT_TTL_MS = 2000;
+
+  /**
+   * @brief How long responses are cached for PIDs which only change when the
+   * device is reconfigured, like DEVICE_MODEL_DESCRIPTION.
+   */
+  static const unsigned int STATIC_TTL_MS = 60000;
+
+ private:
+  struct Key {
+    Key(unsigned int universe, const ola::rdm::UID &uid, uint16_t sub_device,
+        uint16_t pid, const uint8_t *data, unsigned int data_length);
+
+    unsigned int universe;
+    ola::rdm::UID uid;
+    uint16_t sub_device;
+    uint16_t pid;
+    std::string param_data;
+
+    bool operator<(const Key &other) const;
+  };
+
+  struct Entry {
+    ola::rdm::ResponseStatus status;
+    std::string data;
+    TimeStamp refresh_time;
+    TimeStamp expiry_time;
+  };
+
+  struct Waiter {
+    Waiter(rdm_callback *callback, rdm_pid_callback *pid_callback)
+        : callback(callback),
+          pid_callback(pid_callback) {
+    }
+
+    rdm_callback *callback;
+    rdm_pid_callback *pid_callback;
+  };
+
+  struct Fetch {
+    Fetch() : invalidated(false) {}
+
+    std::vector<Waiter> waiters;
+    // Set if the device was sent a SET while the GET was in flight.
+    bool invalidated;
+  };
+
+  typedef std::map<Key, Entry> EntryMap;
+  typedef std::map<Key, Fetch*> FetchMap;
+
+  ola::rdm::RDMAPIImplInterface *m_impl;
+  ola::thread::ExecutorInterface *m_executor;
+  const Clock *m_clock;
+  EntryMap m_entries;
+  FetchMap m_fetches;
+  unsigned int m_pending_responses;
+
+  bool Get(const Waiter &waiter, const Key &key);
+  bool StartFetch(const Key &key, Fetch *fetch);
+  void FetchComplete(Key key,
+                     const ola::rdm::ResponseStatus &status,
+                     uint16_t pid,
+                     const std::string &data);
+  void CachedResponse(Waiter waiter,
+                      ola::rdm::ResponseStatus status,
+                      uint16_t pid,
+                      std::string data);
+  void Deliver(const Waiter &waiter,
+               const ola::rdm::ResponseStatus &status,
+               uint16_t pid,
+               const std::string &data);
+  void PruneExpired(const TimeStamp &now);
+  bool Matches(const Key &key, unsigned int universe,
+               const ola::rdm::UID &uid) const;
+
+  static unsigned int TTLForPid(uint16_t pid);
+  static bool IsCacheable(const ola::rdm::ResponseStatus &status);
+
+  static const unsigned int PRUNE_THRESHOLD;
+
+  DISALLOW_COPY_AND_ASSIGN(RDMResponseCache);
+};
+}  // namespace ola
+#endif  // OLAD_RDMRESPONSECACHE_H_
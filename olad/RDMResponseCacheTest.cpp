@@ -0,0 +1,372 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCacheTest.cpp
+ * Test fixture for the RDMResponseCache.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/rdm/RDMAPIImplInterface.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/ExecutorInterface.h"
+#include "olad/RDMResponseCache.h"
+
+using ola::MockClock;
+using ola::RDMResponseCache;
+using ola::rdm::RDMAPIImplInterface;
+using ola::rdm::ResponseStatus;
+using ola::rdm::UID;
+using std::deque;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * Holds on to requests until the test responds to them.
+ */
+class MockRDMAPIImpl : public RDMAPIImplInterface {
+ public:
+  struct Request {
+    rdm_callback *callback;
+    rdm_pid_callback *pid_callback;
+    uint16_t pid;
+    string data;
+    bool is_set;
+  };
+
+  ~MockRDMAPIImpl() {
+    while (!m_requests.empty()) {
+      delete m_requests.front().callback;
+      delete m_requests.front().pid_callback;
+      m_requests.pop_front();
+    }
+  }
+
+  bool RDMGet(rdm_callback *callback, unsigned int, const UID&, uint16_t,
+              uint16_t pid, const uint8_t *data, unsigned int data_length) {
+    return AddRequest(callback, NULL, pid, data, data_length, false);
+  }
+
+  bool RDMGet(rdm_pid_callback *callback, unsigned int, const UID&, uint16_t,
+              uint16_t pid, const uint8_t *data, unsigned int data_length) {
+    return AddRequest(NULL, callback, pid, data, data_length, false);
+  }
+
+  bool RDMSet(rdm_callback *callback, unsigned int, const UID&, uint16_t,
+              uint16_t pid, const uint8_t *data, unsigned int data_length) {
+    return AddRequest(callback, NULL, pid, data, data_length, true);
+  }
+
+  unsigned int Size() const { return m_requests.size(); }
+
+  const Request &Front() const { return m_requests.front(); }
+
+  void Respond(const ResponseStatus &status, const string &data) {
+    Request request = m_requests.front();
+    m_requests.pop_front();
+    if (request.callback) {
+      request.callback->Run(status, data);
+    } else {
+      request.pid_callback->Run(status, request.pid, data);
+    }
+  }
+
+ private:
+  deque<Request> m_requests;
+
+  bool AddRequest(rdm_callback *callback, rdm_pid_callback *pid_callback,
+                  uint16_t pid, const uint8_t *data, unsigned int data_length,
+                  bool is_set) {
+    Request request;
+    request.callback = callback;
+    request.pid_callback = pid_callback;
+    request.pid = pid;
+    if (data) {
+      request.data.assign(reinterpret_cast<const char*>(data), data_length);
+    }
+    request.is_set = is_set;
+    m_requests.push_back(request);
+    return true;
+  }
+};
+
+class MockExecutor : public ola::thread::ExecutorInterface {
+ public:
+  ~MockExecutor() { DrainCallbacks(); }
+
+  void Execute(ola::BaseCallback0<void> *callback) {
+    m_callbacks.push_back(callback);
+  }
+
+  void DrainCallbacks() {
+    while (!m_callbacks.empty()) {
+      ola::BaseCallback0<void> *callback = m_callbacks.front();
+      m_callbacks.pop_front();
+      callback->Run();
+    }
+  }
+
+  unsigned int Size() const { return m_callbacks.size(); }
+
+ private:
+  deque<ola::BaseCallback0<void>*> m_callbacks;
+};
+}  // namespace
+
+
+class RDMResponseCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMResponseCacheTest);
+  CPPUNIT_TEST(testDeduplication);
+  CPPUNIT_TEST(testCachedResponse);
+  CPPUNIT_TEST(testRefreshAndExpiry);
+  CPPUNIT_TEST(testSetInvalidates);
+  CPPUNIT_TEST(testUncached);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    RDMResponseCacheTest()
+        : m_uid(0x7a70, 1),
+          m_cache(&m_impl, &m_executor, &m_clock) {
+    }
+
+    void setUp() {
+      m_responses.clear();
+      m_ack.error = "";
+      m_ack.response_code = ola::rdm::RDM_COMPLETED_OK;
+      m_ack.response_type = ola::rdm::RDM_ACK;
+      m_ack.message_count = 0;
+      m_ack.m_param = 0;
+      m_ack.set_command = false;
+      m_ack.pid_value = 0;
+    }
+
+    void testDeduplication();
+    void testCachedResponse();
+    void testRefreshAndExpiry();
+    void testSetInvalidates();
+    void testUncached();
+
+ private:
+    UID m_uid;
+    MockRDMAPIImpl m_impl;
+    MockExecutor m_executor;
+    MockClock m_clock;
+    RDMResponseCache m_cache;
+    ResponseStatus m_ack;
+    vector<string> m_responses;
+
+    void Get(uint16_t pid) {
+      OLA_ASSERT_TRUE(m_cache.RDMGet(
+          ola::NewSingleCallback(this, &RDMResponseCacheTest::HandleResponse),
+          UNIVERSE, m_uid, ola::rdm::ROOT_RDM_DEVICE, pid));
+    }
+
+    void HandleResponse(const ResponseStatus&, const string &data) {
+      m_responses.push_back(data);
+    }
+
+    void HandleSet(const ResponseStatus&, const string&) {}
+
+    static const unsigned int UNIVERSE = 1;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMResponseCacheTest);
+
+const unsigned int RDMResponseCacheTest::UNIVERSE;
+
+
+/*
+ * Check that GETs for the same parameter share a request.
+ */
+void RDMResponseCacheTest::testDeduplication() {
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(1u, m_impl.Size());
+  // a different PID is a different request
+  Get(ola::rdm::PID_DMX_START_ADDRESS);
+  OLA_ASSERT_EQ(2u, m_impl.Size());
+
+  m_impl.Respond(m_ack, "label");
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_responses.size());
+  for (unsigned int i = 0; i < m_responses.size(); i++) {
+    OLA_ASSERT_EQ(string("label"), m_responses[i]);
+  }
+  m_impl.Respond(m_ack, "start address");
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_responses.size());
+  OLA_ASSERT_EQ(2u, m_cache.Size());
+}
+
+
+/*
+ * Check that cached responses are delivered via the executor.
+ */
+void RDMResponseCacheTest::testCachedResponse() {
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  m_impl.Respond(m_ack, "label");
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_responses.size());
+
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(0u, m_impl.Size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_responses.size());
+  OLA_ASSERT_EQ(1u, m_executor.Size());
+  m_executor.DrainCallbacks();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_responses.size());
+  OLA_ASSERT_EQ(string("label"), m_responses[1]);
+
+  // NACKs are cached too
+  Get(ola::rdm::PID_DMX_START_ADDRESS);
+  ResponseStatus nack = m_ack;
+  nack.response_type = ola::rdm::RDM_NACK_REASON;
+  nack.m_param = ola::rdm::NR_UNKNOWN_PID;
+  m_impl.Respond(nack, "");
+  Get(ola::rdm::PID_DMX_START_ADDRESS);
+  OLA_ASSERT_EQ(0u, m_impl.Size());
+  m_executor.DrainCallbacks();
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_responses.size());
+}
+
+
+/*
+ * Check responses are refreshed in the background, and expire.
+ */
+void RDMResponseCacheTest::testRefreshAndExpiry() {
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  m_impl.Respond(m_ack, "old");
+
+  // Past the refresh time, the cached response is returned but refreshed.
+  m_clock.AdvanceTime(1, 100000);
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(1u, m_impl.Size());
+  m_executor.DrainCallbacks();
+  OLA_ASSERT_EQ(string("old"), m_responses.back());
+  // a second hit doesn't start another refresh
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(1u, m_impl.Size());
+  m_executor.DrainCallbacks();
+
+  m_impl.Respond(m_ack, "new");
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_responses.size());
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(0u, m_impl.Size());
+  m_executor.DrainCallbacks();
+  OLA_ASSERT_EQ(string("new"), m_responses.back());
+
+  // Once expired, the GET goes to the device.
+  m_clock.AdvanceTime(3, 0);
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_EQ(1u, m_impl.Size());
+  OLA_ASSERT_EQ(0u, m_executor.Size());
+  m_impl.Respond(m_ack, "newer");
+  OLA_ASSERT_EQ(string("newer"), m_responses.back());
+
+  // PIDs that rarely change are kept longer.
+  Get(ola::rdm::PID_DEVICE_MODEL_DESCRIPTION);
+  m_impl.Respond(m_ack, "model");
+  m_clock.AdvanceTime(10, 0);
+  Get(ola::rdm::PID_DEVICE_MODEL_DESCRIPTION);
+  OLA_ASSERT_EQ(0u, m_impl.Size());
+  m_executor.DrainCallbacks();
+  OLA_ASSERT_EQ(string("model"), m_responses.back());
+}
+
+
+/*
+ * Check that a SET drops the cached responses for the device.
+ */
+void RDMResponseCacheTest::testSetInvalidates() {
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  m_impl.Respond(m_ack, "label");
+  OLA_ASSERT_EQ(1u, m_cache.Size());
+
+  uint8_t identify = 1;
+  OLA_ASSERT_TRUE(m_cache.RDMSet(
+      ola::NewSingleCallback(this, &RDMResponseCacheTest::HandleSet),
+      UNIVERSE, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+      ola::rdm::PID_IDENTIFY_DEVICE, &identify, sizeof(identify)));
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+  OLA_ASSERT_TRUE(m_impl.Front().is_set);
+  m_impl.Respond(m_ack, "");
+
+  // A response to a GET that was in flight during the SET isn't cached.
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  OLA_ASSERT_TRUE(m_cache.RDMSet(
+      ola::NewSingleCallback(this, &RDMResponseCacheTest::HandleSet),
+      UNIVERSE, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+      ola::rdm::PID_IDENTIFY_DEVICE, &identify, sizeof(identify)));
+  m_impl.Respond(m_ack, "label");
+  m_impl.Respond(m_ack, "");
+  OLA_ASSERT_EQ(string("label"), m_responses.back());
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+
+  // Other devices aren't affected, but a broadcast SET clears them all.
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  m_impl.Respond(m_ack, "label");
+  m_cache.InvalidateUID(UNIVERSE, UID(0x7a70, 2));
+  m_cache.InvalidateUID(UNIVERSE + 1, m_uid);
+  OLA_ASSERT_EQ(1u, m_cache.Size());
+  m_cache.InvalidateUID(UNIVERSE, UID::VendorcastAddress(0x7a70));
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  m_impl.Respond(m_ack, "label");
+  m_cache.InvalidateUniverse(UNIVERSE);
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+}
+
+
+/*
+ * Check the responses that aren't cached.
+ */
+void RDMResponseCacheTest::testUncached() {
+  // Failures aren't cached, but everyone waiting gets them.
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  ResponseStatus timeout = m_ack;
+  timeout.response_code = ola::rdm::RDM_TIMEOUT;
+  m_impl.Respond(timeout, "");
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_responses.size());
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+
+  // Neither are ACK_TIMERs
+  Get(ola::rdm::PID_DEVICE_LABEL);
+  ResponseStatus ack_timer = m_ack;
+  ack_timer.response_type = ola::rdm::RDM_ACK_TIMER;
+  m_impl.Respond(ack_timer, "");
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+
+  // Reading the status messages changes them, so these aren't shared.
+  Get(ola::rdm::PID_STATUS_MESSAGES);
+  Get(ola::rdm::PID_STATUS_MESSAGES);
+  OLA_ASSERT_EQ(2u, m_impl.Size());
+  // and the caller's callback is passed through.
+  OLA_ASSERT_NOT_NULL(m_impl.Front().callback);
+  m_impl.Respond(m_ack, "");
+  m_impl.Respond(m_ack, "");
+  OLA_ASSERT_EQ(0u, m_cache.Size());
+}
@@ -0,0 +1,210 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLogger.cpp
+ * Records the frames sent by olad to a rolling set of binary show files.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/ShowLogger.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShowSaver.h"
+#include "ola/Logging.h"
+#include "ola/file/Util.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+ShowLogger::ShowLogger(const Options &options)
+    : m_options(options),
+      m_queued(0),
+      m_dropped(0),
+      m_running(false),
+      m_stop(false) {
+}
+
+
+ShowLogger::~ShowLogger() {
+  Stop();
+}
+
+
+bool ShowLogger::Start() {
+  if (m_running) {
+    return false;
+  }
+
+  m_stop = false;
+  m_thread.reset(new WriterThread(this));
+  m_running = true;
+  if (!m_thread->Start()) {
+    m_running = false;
+    m_thread.reset();
+    return false;
+  }
+  OLA_INFO << "Logging the show to " << m_options.directory;
+  return true;
+}
+
+
+void ShowLogger::Stop() {
+  if (!m_thread.get()) {
+    return;
+  }
+
+  m_running = false;
+  {
+    MutexLocker lock(&m_mutex);
+    m_stop = true;
+    m_condition.Signal();
+  }
+  m_thread->Join();
+  m_thread.reset();
+  // Anything queued after the thread exited.
+  WriteQueued();
+  CloseSegment();
+}
+
+
+void ShowLogger::RecordFrame(unsigned int universe_id,
+                             const TimeStamp &time,
+                             const DmxBuffer &data) {
+  if (!m_running) {
+    return;
+  }
+
+  if (__sync_add_and_fetch(&m_queued, 1) > m_options.max_queued) {
+    __sync_sub_and_fetch(&m_queued, 1);
+    __sync_fetch_and_add(&m_dropped, 1);
+    return;
+  }
+
+  QueuedFrame frame;
+  frame.time = time;
+  frame.universe = universe_id;
+  frame.length = sizeof(frame.data);
+  data.Get(frame.data, &frame.length);
+  if (m_queue.Push(frame)) {
+    MutexLocker lock(&m_mutex);
+    m_condition.Signal();
+  }
+}
+
+
+void *ShowLogger::RunWriter() {
+  while (true) {
+    bool stop;
+    {
+      MutexLocker lock(&m_mutex);
+      while (m_queue.Empty() && !m_stop) {
+        m_condition.Wait(&m_mutex);
+      }
+      stop = m_stop;
+    }
+    WriteQueued();
+    if (stop) {
+      break;
+    }
+  }
+  return NULL;
+}
+
+
+/*
+ * Write everything that's in the queue. This is only called from one thread
+ * at a time.
+ */
+void ShowLogger::WriteQueued() {
+  unsigned int count = m_queue.PopAll(&m_frames);
+  __sync_sub_and_fetch(&m_queued, count);
+
+  vector<QueuedFrame>::const_iterator iter = m_frames.begin();
+  for (; iter != m_frames.end(); ++iter) {
+    WriteFrame(*iter);
+  }
+  m_frames.clear();
+}
+
+
+void ShowLogger::WriteFrame(const QueuedFrame &frame) {
+  // m_segment_end is also set if we failed to create the file, so we don't
+  // retry on every frame.
+  if (!m_segment_end.IsSet() || frame.time >= m_segment_end) {
+    StartSegment(frame.time);
+  }
+
+  DmxBuffer buffer(frame.data, frame.length);
+  if (m_saver.get()) {
+    m_saver->NewFrame(frame.time, frame.universe, buffer);
+  }
+  m_universes[frame.universe] = buffer;
+  m_last_time = frame.time;
+}
+
+
+/*
+ * Close the current file and start a new one, deleting the oldest file if
+ * there are too many.
+ */
+void ShowLogger::StartSegment(const TimeStamp &time) {
+  CloseSegment();
+  m_segment_end = time + TimeInterval(m_options.segment_length, 0);
+
+  std::ostringstream filename;
+  filename << "olad-" << time.Seconds() << ".bin";
+  const string path = ola::file::JoinPaths(m_options.directory,
+                                           filename.str());
+  m_saver.reset(new BinaryShowSaver(path));
+  if (!m_saver->Open()) {
+    m_saver.reset();
+    return;
+  }
+
+  m_segment_files.push_back(path);
+  while (m_segment_files.size() > m_options.segments) {
+    const string &oldest = m_segment_files.front();
+    if (remove(oldest.c_str())) {
+      OLA_WARN << "Failed to remove " << oldest << ": " << strerror(errno);
+    }
+    m_segment_files.pop_front();
+  }
+
+  UniverseMap::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    m_saver->NewFrame(time, iter->first, iter->second);
+  }
+}
+
+
+void ShowLogger::CloseSegment() {
+  if (!m_saver.get()) {
+    return;
+  }
+  m_saver->SetEndTime(m_last_time);
+  m_saver->Close();
+  m_saver.reset();
+}
+}  // namespace ola
@@ -0,0 +1,162 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLogger.h
+ * Records the frames sent by olad to a rolling set of binary show files.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_SHOWLOGGER_H_
+#define OLAD_SHOWLOGGER_H_
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/MPSCQueue.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+#include "olad/plugin_api/FrameRecorderInterface.h"
+
+class BinaryShowSaver;
+
+namespace ola {
+
+/**
+ * @brief Records every frame olad sends, for black box show logging.
+ *
+ * The show is split into segments, each of which is a binary show file that
+ * ola_recorder can play back. Each segment starts with the current data for
+ * every universe, so it's complete on its own. Once there are more than
+ * Options::segments files, the oldest is deleted, which keeps at least the
+ * last (segments - 1) * segment_length seconds of the show.
+ *
+ * RecordFrame() copies the frame onto a lock-free queue and the files are
+ * written from a background thread. If more than Options::max_queued frames
+ * are waiting, new frames are dropped and counted.
+ */
+class ShowLogger: public FrameRecorderInterface {
+ public:
+  struct Options {
+    Options()
+        : segment_length(60),
+          segments(11),
+          max_queued(DEFAULT_MAX_QUEUED) {
+    }
+
+    /** @brief The directory to write the show files to. */
+    std::string directory;
+    /** @brief The length of each file, in seconds. */
+    unsigned int segment_length;
+    /** @brief The number of files to keep. */
+    unsigned int segments;
+    /** @brief The maximum number of frames waiting to be written. */
+    unsigned int max_queued;
+  };
+
+  explicit ShowLogger(const Options &options);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~ShowLogger();
+
+  /**
+   * @brief Start the writer thread.
+   * @returns true if the thread started.
+   */
+  bool Start();
+
+  /**
+   * @brief Write the queued frames, close the current file and stop the
+   *   writer thread.
+   */
+  void Stop();
+
+  void RecordFrame(unsigned int universe_id,
+                   const TimeStamp &time,
+                   const DmxBuffer &data);
+
+  /**
+   * @brief The number of frames dropped because the queue was full.
+   */
+  unsigned int Dropped() const { return m_dropped; }
+
+  enum { DEFAULT_MAX_QUEUED = 10000 };
+
+ private:
+  /*
+   * DmxBuffers share their data with a reference count that isn't thread
+   * safe, so the frame is copied into the queue.
+   */
+  struct QueuedFrame {
+    QueuedFrame() : universe(0), length(0) {}
+
+    TimeStamp time;
+    unsigned int universe;
+    unsigned int length;
+    uint8_t data[DMX_UNIVERSE_SIZE];
+  };
+
+  class WriterThread: public ola::thread::Thread {
+   public:
+    explicit WriterThread(ShowLogger *parent)
+        : ola::thread::Thread(ola::thread::Thread::Options("show-log")),
+          m_parent(parent) {}
+
+   protected:
+    void *Run() { return m_parent->RunWriter(); }
+
+   private:
+    ShowLogger *m_parent;
+  };
+
+  typedef std::map<unsigned int, DmxBuffer> UniverseMap;
+
+  const Options m_options;
+  ola::thread::MPSCQueue<QueuedFrame> m_queue;
+  volatile unsigned int m_queued;
+  volatile unsigned int m_dropped;
+  volatile bool m_running;
+  bool m_stop;
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  std::auto_ptr<WriterThread> m_thread;
+
+  // These are only used by the writer thread.
+  std::vector<QueuedFrame> m_frames;
+  std::auto_ptr<BinaryShowSaver> m_saver;
+  std::deque<std::string> m_segment_files;
+  TimeStamp m_segment_end;
+  TimeStamp m_last_time;
+  UniverseMap m_universes;
+
+  void *RunWriter();
+  void WriteQueued();
+  void WriteFrame(const QueuedFrame &frame);
+  void StartSegment(const TimeStamp &time);
+  void CloseSegment();
+
+  DISALLOW_COPY_AND_ASSIGN(ShowLogger);
+};
+}  // namespace ola
+#endif  // OLAD_SHOWLOGGER_H_
@@ -0,0 +1,183 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLoggerTest.cpp
+ * Test fixture for the ShowLogger class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShowLoader.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/file/Util.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/ShowLogger.h"
+
+using ola::DmxBuffer;
+using ola::ShowLogger;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::file::JoinPaths;
+using std::string;
+using std::vector;
+
+class ShowLoggerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ShowLoggerTest);
+  CPPUNIT_TEST(testRotation);
+  CPPUNIT_TEST(testDropped);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+  void testRotation();
+  void testDropped();
+
+ private:
+  string m_directory;
+
+  vector<string> ShowFiles();
+  void CheckNextFrame(BinaryShowLoader *loader, unsigned int universe,
+                      const DmxBuffer &expected);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ShowLoggerTest);
+
+namespace {
+bool FileExists(const string &path) {
+  return access(path.c_str(), F_OK) == 0;
+}
+}  // namespace
+
+
+void ShowLoggerTest::setUp() {
+  char path[] = "/tmp/ola-show-log-XXXXXX";
+  OLA_ASSERT_NOT_NULL(mkdtemp(path));
+  m_directory = path;
+}
+
+
+void ShowLoggerTest::tearDown() {
+  vector<string> files = ShowFiles();
+  vector<string>::const_iterator iter = files.begin();
+  for (; iter != files.end(); ++iter) {
+    remove(iter->c_str());
+  }
+  rmdir(m_directory.c_str());
+}
+
+
+/*
+ * Check the logger starts a new file every segment_length seconds, and only
+ * keeps the most recent files.
+ */
+void ShowLoggerTest::testRotation() {
+  ShowLogger::Options options;
+  options.directory = m_directory;
+  options.segment_length = 1;
+  options.segments = 2;
+  ShowLogger logger(options);
+
+  DmxBuffer frame1, frame2, frame3, frame4;
+  frame1.SetFromString("1,2,3");
+  frame2.SetFromString("4,5");
+  frame3.SetFromString("1,2,4");
+  frame4.SetFromString("1,2,5");
+
+  // Frames before Start() aren't recorded.
+  struct timeval tv = {1000, 0};
+  const TimeStamp start(tv);
+  logger.RecordFrame(1, start, frame4);
+
+  OLA_ASSERT_TRUE(logger.Start());
+  logger.RecordFrame(1, start, frame1);
+  logger.RecordFrame(2, start + TimeInterval(0, 500000), frame2);
+  logger.RecordFrame(1, start + TimeInterval(1, 200000), frame3);
+  logger.RecordFrame(1, start + TimeInterval(2, 500000), frame4);
+  logger.Stop();
+  OLA_ASSERT_EQ(0u, logger.Dropped());
+
+  vector<string> files = ShowFiles();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), files.size());
+  OLA_ASSERT_FALSE(FileExists(
+      JoinPaths(m_directory, "olad-1000.bin")));
+  OLA_ASSERT_TRUE(FileExists(
+      JoinPaths(m_directory, "olad-1001.bin")));
+
+  // The last file starts with the state of both universes.
+  BinaryShowLoader loader(JoinPaths(m_directory, "olad-1002.bin"));
+  OLA_ASSERT_TRUE(loader.Load());
+  CheckNextFrame(&loader, 1, frame3);
+  CheckNextFrame(&loader, 2, frame2);
+  CheckNextFrame(&loader, 1, frame4);
+
+  unsigned int universe;
+  DmxBuffer data;
+  OLA_ASSERT_EQ(ShowLoaderInterface::END_OF_FILE,
+                loader.NextFrame(&universe, &data));
+}
+
+
+/*
+ * Check frames are dropped once the queue is full.
+ */
+void ShowLoggerTest::testDropped() {
+  ShowLogger::Options options;
+  options.directory = m_directory;
+  options.max_queued = 0;
+  ShowLogger logger(options);
+  OLA_ASSERT_TRUE(logger.Start());
+
+  DmxBuffer frame;
+  frame.SetFromString("1,2,3");
+  TimeStamp now;
+  ola::Clock().CurrentTime(&now);
+  logger.RecordFrame(1, now, frame);
+  logger.RecordFrame(2, now, frame);
+  logger.Stop();
+
+  OLA_ASSERT_EQ(2u, logger.Dropped());
+  OLA_ASSERT_TRUE(ShowFiles().empty());
+}
+
+
+vector<string> ShowLoggerTest::ShowFiles() {
+  vector<string> files;
+  ola::file::FindMatchingFiles(m_directory, "olad-", &files);
+  return files;
+}
+
+
+void ShowLoggerTest::CheckNextFrame(BinaryShowLoader *loader,
+                                    unsigned int universe,
+                                    const DmxBuffer &expected) {
+  unsigned int timeout;
+  unsigned int frame_universe;
+  DmxBuffer data;
+  OLA_ASSERT_EQ(ShowLoaderInterface::OK,
+                loader->NextFrame(&frame_universe, &data));
+  OLA_ASSERT_EQ(universe, frame_universe);
+  OLA_ASSERT_DATA_EQUALS(expected.GetRaw(), expected.Size(),
+                         data.GetRaw(), data.Size());
+  loader->NextTimeout(&timeout);
+}
@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeGenerator.cpp
+ * Generates a stream of timecode frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/TimeCodeGenerator.h"
+
+#include "ola/InlineCallback.h"
+#include "ola/Logging.h"
+
+namespace ola {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeSharedMemory;
+
+namespace {
+const uint64_t USEC_PER_SECOND = 1000000;
+}  // namespace
+
+TimeCodeGenerator::TimeCodeGenerator(
+    ola::thread::SchedulerInterface *scheduler,
+    FrameCallback *callback,
+    const Clock *clock)
+    : m_scheduler(scheduler),
+      m_callback(callback),
+      m_clock(clock ? clock : &m_monotonic_clock),
+      m_timeout(INVALID_TIMEOUT),
+      m_type(ola::timecode::TIMECODE_SMPTE),
+      m_start_frame(0),
+      m_frame_offset(0),
+      m_skipped_frames(0) {
+}
+
+TimeCodeGenerator::~TimeCodeGenerator() {
+  Stop();
+  if (m_memory.get()) {
+    m_memory->Unlink();
+  }
+}
+
+void TimeCodeGenerator::SetSharedMemory(TimeCodeSharedMemory *memory) {
+  m_memory.reset(memory);
+}
+
+void TimeCodeGenerator::Run(const TimeCode &start) {
+  Lock(start);
+  m_stop_time = TimeStamp();
+  SendFrame();
+}
+
+void TimeCodeGenerator::Chase(const TimeCode &timecode,
+                              const TimeInterval &freewheel) {
+  Lock(timecode);
+  m_stop_time = m_start_time + freewheel;
+  SendFrame();
+}
+
+void TimeCodeGenerator::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+  m_scheduler->RemoveTimeout(m_timeout);
+  m_timeout = INVALID_TIMEOUT;
+  Publish(false);
+}
+
+/*
+ * Count the frames from this timecode, starting now.
+ */
+void TimeCodeGenerator::Lock(const TimeCode &timecode) {
+  if (IsRunning()) {
+    m_scheduler->RemoveTimeout(m_timeout);
+    m_timeout = INVALID_TIMEOUT;
+  }
+  m_type = timecode.Type();
+  m_start_frame = timecode.FrameNumber();
+  m_clock->CurrentTime(&m_start_time);
+  m_frame_offset = 0;
+}
+
+void TimeCodeGenerator::FrameTimeout() {
+  m_timeout = INVALID_TIMEOUT;
+  SendFrame();
+}
+
+void TimeCodeGenerator::SendFrame() {
+  const uint32_t frame_number = static_cast<uint32_t>(
+      (m_start_frame + m_frame_offset) % TimeCode::FramesPerDay(m_type));
+  m_last_frame.timecode = TimeCode::FromFrameNumber(m_type, frame_number);
+  m_last_frame.frame_number = frame_number;
+  m_last_frame.frame_time = FrameTime(m_frame_offset);
+  m_callback->Run(m_last_frame.timecode);
+  ScheduleNextFrame();
+  Publish(IsRunning());
+}
+
+void TimeCodeGenerator::ScheduleNextFrame() {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  m_frame_offset++;
+  TimeStamp next = FrameTime(m_frame_offset);
+  if (FrameTime(m_frame_offset + 1) <= now) {
+    // We're more than a frame behind, jump to the frame that's due now.
+    const uint64_t frame_offset = FrameOffset(now);
+    m_skipped_frames += frame_offset - m_frame_offset;
+    m_frame_offset = frame_offset;
+    next = FrameTime(m_frame_offset);
+  }
+
+  if (m_stop_time.IsSet() && next > m_stop_time) {
+    OLA_INFO << "Timecode stopped after " << m_last_frame.timecode;
+    return;
+  }
+
+  m_timeout = m_scheduler->RegisterSingleTimeout(
+      next > now ? next - now : TimeInterval(0, 0),
+      MakeInlineCallback(this, &TimeCodeGenerator::FrameTimeout));
+}
+
+void TimeCodeGenerator::Publish(bool running) {
+  if (m_memory.get()) {
+    m_last_frame.running = running;
+    m_memory->Write(m_last_frame);
+  }
+}
+
+TimeStamp TimeCodeGenerator::FrameTime(uint64_t frame_offset) const {
+  unsigned int frames, seconds;
+  FrameRate(&frames, &seconds);
+  return m_start_time + TimeInterval(static_cast<int64_t>(
+      frame_offset * USEC_PER_SECOND * seconds / frames));
+}
+
+uint64_t TimeCodeGenerator::FrameOffset(const TimeStamp &time) const {
+  unsigned int frames, seconds;
+  FrameRate(&frames, &seconds);
+  const uint64_t elapsed = (time - m_start_time).AsInt();
+  return elapsed * frames / (USEC_PER_SECOND * seconds);
+}
+
+/*
+ * The frame rate, as a number of frames per number of seconds.
+ */
+void TimeCodeGenerator::FrameRate(unsigned int *frames,
+                                  unsigned int *seconds) const {
+  switch (m_type) {
+    case ola::timecode::TIMECODE_FILM:
+      *frames = 24;
+      *seconds = 1;
+      return;
+    case ola::timecode::TIMECODE_EBU:
+      *frames = 25;
+      *seconds = 1;
+      return;
+    case ola::timecode::TIMECODE_DF:
+      // 29.97 fps
+      *frames = 30000;
+      *seconds = 1001;
+      return;
+    case ola::timecode::TIMECODE_SMPTE:
+      break;
+  }
+  *frames = 30;
+  *seconds = 1;
+}
+}  // namespace ola
@@ -0,0 +1,142 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeGenerator.h
+ * Generates a stream of timecode frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_TIMECODEGENERATOR_H_
+#define OLAD_TIMECODEGENERATOR_H_
+
+#include <stdint.h>
+#include <memory>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeSharedMemory.h"
+
+namespace ola {
+
+/**
+ * @brief Generates timecode frames inside olad.
+ *
+ * Without this, clients have to send each frame over RPC, so the frames
+ * inherit the client's scheduling jitter plus the RPC latency. The generator
+ * instead times the frames itself: frame N is due at the time the generator
+ * locked to the timecode plus N frame periods, so errors in when a timer
+ * fires don't accumulate. If the event loop falls more than a frame behind,
+ * the frames that were missed are skipped rather than sent in a burst.
+ *
+ * Run() free runs from a timecode until Stop() is called. Chase() follows
+ * timecode from another source: each call relocks to the new frame, and the
+ * generator freewheels for a while if the source stops.
+ *
+ * Each frame is passed to the FrameCallback and, if there is one, written to
+ * a TimeCodeSharedMemory segment so other processes on the same machine can
+ * follow the timecode without an RPC per frame.
+ */
+class TimeCodeGenerator {
+ public:
+  typedef ola::Callback1<void, const ola::timecode::TimeCode&> FrameCallback;
+
+  /**
+   * @brief Create a new TimeCodeGenerator.
+   * @param scheduler the SchedulerInterface to use for the frame timer.
+   * @param callback the callback to run for each frame, ownership is
+   *   transferred.
+   * @param clock the Clock to time the frames with, or NULL to use a
+   *   MonotonicClock. Ownership is not transferred.
+   */
+  TimeCodeGenerator(ola::thread::SchedulerInterface *scheduler,
+                    FrameCallback *callback,
+                    const Clock *clock = NULL);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~TimeCodeGenerator();
+
+  /**
+   * @brief Publish the frames to a shared memory segment.
+   * @param memory the segment, ownership is transferred.
+   */
+  void SetSharedMemory(ola::timecode::TimeCodeSharedMemory *memory);
+
+  /**
+   * @brief Send the timecode and keep counting from it until Stop().
+   * @param start the first frame.
+   */
+  void Run(const ola::timecode::TimeCode &start);
+
+  /**
+   * @brief Send the timecode and keep counting from it until the next call
+   *   to Chase(), or until freewheel has passed.
+   * @param timecode the frame from the source being chased.
+   * @param freewheel how long to keep going without a new frame.
+   */
+  void Chase(const ola::timecode::TimeCode &timecode,
+             const TimeInterval &freewheel);
+
+  /**
+   * @brief Stop sending frames.
+   */
+  void Stop();
+
+  /**
+   * @brief Returns true if the generator is sending frames.
+   */
+  bool IsRunning() const {
+    return m_timeout != ola::thread::INVALID_TIMEOUT;
+  }
+
+  /**
+   * @brief The number of frames skipped because the event loop was late.
+   */
+  uint64_t SkippedFrames() const { return m_skipped_frames; }
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+  std::auto_ptr<FrameCallback> m_callback;
+  MonotonicClock m_monotonic_clock;
+  const Clock *m_clock;
+  std::auto_ptr<ola::timecode::TimeCodeSharedMemory> m_memory;
+
+  ola::thread::timeout_id m_timeout;
+  ola::timecode::TimeCodeType m_type;
+  uint32_t m_start_frame;
+  TimeStamp m_start_time;
+  TimeStamp m_stop_time;
+  // The number of frames since m_start_frame.
+  uint64_t m_frame_offset;
+  uint64_t m_skipped_frames;
+  ola::timecode::TimeCodeSharedMemory::Frame m_last_frame;
+
+  void Lock(const ola::timecode::TimeCode &timecode);
+  void FrameTimeout();
+  void SendFrame();
+  void ScheduleNextFrame();
+  void Publish(bool running);
+  TimeStamp FrameTime(uint64_t frame_offset) const;
+  uint64_t FrameOffset(const TimeStamp &time) const;
+  void FrameRate(unsigned int *frames, unsigned int *seconds) const;
+
+  DISALLOW_COPY_AND_ASSIGN(TimeCodeGenerator);
+};
+}  // namespace ola
+#endif  // OLAD_TIMECODEGENERATOR_H_
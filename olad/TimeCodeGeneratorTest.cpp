@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeGeneratorTest.cpp
+ * Test fixture for the TimeCodeGenerator class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeSharedMemory.h"
+#include "olad/TimeCodeGenerator.h"
+
+using ola::MockClock;
+using ola::NewCallback;
+using ola::TimeCodeGenerator;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::SelectServer;
+using ola::timecode::TIMECODE_EBU;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeSharedMemory;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+class TimeCodeGeneratorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TimeCodeGeneratorTest);
+  CPPUNIT_TEST(testRun);
+  CPPUNIT_TEST(testSkippedFrames);
+  CPPUNIT_TEST(testChase);
+  CPPUNIT_TEST(testSharedMemory);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+
+  void testRun();
+  void testSkippedFrames();
+  void testChase();
+  void testSharedMemory();
+
+ private:
+  MockClock m_clock;
+  auto_ptr<SelectServer> m_ss;
+  auto_ptr<TimeCodeGenerator> m_generator;
+  vector<TimeCode> m_frames;
+
+  void NewFrame(const TimeCode &timecode) { m_frames.push_back(timecode); }
+  void Advance(unsigned int ms);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeGeneratorTest);
+
+void TimeCodeGeneratorTest::setUp() {
+  m_frames.clear();
+  m_ss.reset(new SelectServer(NULL, &m_clock));
+  m_generator.reset(new TimeCodeGenerator(
+      m_ss.get(), NewCallback(this, &TimeCodeGeneratorTest::NewFrame),
+      &m_clock));
+}
+
+void TimeCodeGeneratorTest::Advance(unsigned int ms) {
+  m_clock.AdvanceTime(TimeInterval(ms * 1000));
+  m_ss->RunOnce(TimeInterval(0, 0));
+}
+
+/*
+ * Check the frames are sent on time.
+ */
+void TimeCodeGeneratorTest::testRun() {
+  m_generator->Run(TimeCode(TIMECODE_EBU, 0, 0, 59, 24));
+  OLA_ASSERT_TRUE(m_generator->IsRunning());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 0, 59, 24), m_frames[0]);
+
+  // EBU is 25 fps, so a frame every 40ms
+  Advance(39);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  Advance(1);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 1, 0, 0), m_frames[1]);
+
+  // A late frame doesn't delay the ones after it.
+  Advance(50);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  Advance(30);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 1, 0, 2), m_frames[3]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), m_generator->SkippedFrames());
+
+  m_generator->Stop();
+  OLA_ASSERT_FALSE(m_generator->IsRunning());
+  Advance(100);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_frames.size());
+}
+
+/*
+ * Check frames are skipped if the loop falls behind.
+ */
+void TimeCodeGeneratorTest::testSkippedFrames() {
+  m_generator->Run(TimeCode(TIMECODE_EBU, 1, 0, 0, 0));
+  Advance(210);
+  // The frame due at 40ms is sent late, and it's followed straight away by
+  // the one due at 200ms.
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 1, 0, 0, 1), m_frames[1]);
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 1, 0, 0, 5), m_frames[2]);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(3), m_generator->SkippedFrames());
+}
+
+/*
+ * Check chasing relocks to each frame, and freewheels when they stop.
+ */
+void TimeCodeGeneratorTest::testChase() {
+  const TimeInterval freewheel(100000);
+  m_generator->Chase(TimeCode(TIMECODE_EBU, 0, 0, 0, 0), freewheel);
+  Advance(40);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+
+  // The source jumps
+  m_generator->Chase(TimeCode(TIMECODE_EBU, 0, 10, 0, 0), freewheel);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 10, 0, 0), m_frames[2]);
+
+  Advance(40);
+  Advance(40);
+  OLA_ASSERT_EQ(static_cast<size_t>(5), m_frames.size());
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 10, 0, 2), m_frames[4]);
+  OLA_ASSERT_FALSE(m_generator->IsRunning());
+
+  Advance(40);
+  OLA_ASSERT_EQ(static_cast<size_t>(5), m_frames.size());
+}
+
+/*
+ * Check the frames are published to shared memory.
+ */
+void TimeCodeGeneratorTest::testSharedMemory() {
+  std::ostringstream str;
+  str << TimeCodeSharedMemory::DEFAULT_NAME << "-generator-test-" << getpid();
+  const string name = str.str();
+  m_generator->SetSharedMemory(TimeCodeSharedMemory::Create(name));
+  auto_ptr<TimeCodeSharedMemory> reader(TimeCodeSharedMemory::Open(name));
+  OLA_ASSERT_NOT_NULL(reader.get());
+
+  m_generator->Run(TimeCode(TIMECODE_EBU, 0, 0, 0, 10));
+  TimeCodeSharedMemory::Frame frame;
+  OLA_ASSERT_TRUE(reader->Read(&frame));
+  OLA_ASSERT_EQ(10u, frame.frame_number);
+  const TimeStamp start = frame.frame_time;
+  Advance(45);
+
+  OLA_ASSERT_TRUE(reader->Read(&frame));
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 0, 0, 11), frame.timecode);
+  OLA_ASSERT_EQ(11u, frame.frame_number);
+  // The frame is stamped with the time it was due, not when it was sent.
+  OLA_ASSERT_EQ(start + TimeInterval(40000), frame.frame_time);
+  OLA_ASSERT_TRUE(frame.running);
+
+  m_generator->Stop();
+  OLA_ASSERT_TRUE(reader->Read(&frame));
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 0, 0, 11), frame.timecode);
+  OLA_ASSERT_FALSE(frame.running);
+
+  // The segment is removed with the generator.
+  m_generator.reset();
+  OLA_ASSERT_NULL(TimeCodeSharedMemory::Open(name));
+}
@@ -18,10 +18,13 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <algorithm>
 #include <map>
+#include <string>
 #include <utility>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
@@ -30,14 +33,44 @@
 
 namespace ola {
 
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::rdm::UID;
 using ola::rpc::RpcController;
 using std::map;
+using std::string;
+
+namespace {
+unsigned int NextClientId() {
+  static unsigned int next_id = 0;
+  if (++next_id == 0) {
+    next_id++;
+  }
+  return next_id;
+}
+}  // namespace
+
+const string &SinkFrame::Encoded() const {
+  if (!m_encoded) {
+    ola::proto::DmxData dmx_data;
+    dmx_data.set_priority(m_priority);
+    dmx_data.set_universe(m_universe_id);
+    dmx_data.set_data(m_buffer.Get());
+    dmx_data.SerializeToString(&m_encoded_data);
+    m_encoded = true;
+  }
+  return m_encoded_data;
+}
 
 Client::Client(ola::proto::OlaClientService_Stub *client_stub,
-               const ola::rdm::UID &uid)
-    : m_client_stub(client_stub),
-      m_uid(uid) {
+               const ola::rdm::UID &uid,
+               const ola::Clock *clock)
+    : m_clock(clock ? clock : &m_real_clock),
+      m_client_stub(client_stub),
+      m_uid(uid),
+      m_id(NextClientId()),
+      m_superseded_updates(0),
+      m_filtered_updates(0) {
 }
 
 Client::~Client() {
@@ -46,24 +79,124 @@ Client::~Client() {
 
 bool Client::SendDMX(unsigned int universe, uint8_t priority,
                      const DmxBuffer &buffer) {
-  if (!m_client_stub.get()) {
+  return SendDMX(SinkFrame(universe, priority, buffer));
+}
+
+bool Client::SendDMX(const SinkFrame &frame) {
+  if (!m_client_stub.get() || !m_client_stub->channel()) {
     OLA_FATAL << "client_stub is null";
     return false;
   }
 
-  RpcController *controller = new RpcController();
-  ola::proto::DmxData dmx_data;
-  ola::proto::Ack *ack = new ola::proto::Ack();
+  SinkState *state = STLFind(&m_sink_state, frame.UniverseId());
+  if (!state) {
+    return QueueUpdate(frame);
+  }
 
-  dmx_data.set_priority(priority);
-  dmx_data.set_universe(universe);
-  dmx_data.set_data(buffer.Get());
+  const SinkOptions &options = state->options;
+  TimeStamp now;
+  if (options.max_rate) {
+    m_clock->CurrentTime(&now);
+    // The universe re-sends the data at least once a second, so a dropped
+    // change is delivered by a later update.
+    if (state->sent && now - state->last_sent <
+        TimeInterval(USEC_IN_SECONDS / options.max_rate)) {
+      m_filtered_updates++;
+      return true;
+    }
+  }
 
-  m_client_stub->UpdateDmxData(
-      controller,
-      &dmx_data,
-      ack,
-      ola::NewSingleCallback(this, &ola::Client::SendDMXCallback,
+  DmxBuffer slots;
+  const DmxBuffer *data = &frame.Data();
+  if (options.start_slot || options.slot_count) {
+    const DmxBuffer &buffer = frame.Data();
+    if (options.start_slot < buffer.Size()) {
+      unsigned int length = buffer.Size() - options.start_slot;
+      if (options.slot_count) {
+        length = std::min(length, options.slot_count);
+      }
+      slots.Set(buffer.GetRaw() + options.start_slot, length);
+    }
+    data = &slots;
+  }
+
+  if (options.changes_only) {
+    if (state->sent && state->last_priority == frame.Priority() &&
+        state->last_data == *data) {
+      m_filtered_updates++;
+      return true;
+    }
+    state->last_data = *data;
+  }
+
+  state->sent = true;
+  state->last_sent = now;
+  state->last_priority = frame.Priority();
+  if (data == &frame.Data()) {
+    return QueueUpdate(frame);
+  }
+  // This client gets its own encoding.
+  return QueueUpdate(SinkFrame(frame.UniverseId(), frame.Priority(), *data));
+}
+
+void Client::SetSinkOptions(unsigned int universe_id,
+                            const SinkOptions &options) {
+  if (options.IsDefault()) {
+    ClearSinkOptions(universe_id);
+    return;
+  }
+  SinkState state;
+  state.options = options;
+  m_sink_state[universe_id] = state;
+}
+
+void Client::ClearSinkOptions(unsigned int universe_id) {
+  m_sink_state.erase(universe_id);
+}
+
+bool Client::QueueUpdate(const SinkFrame &frame) {
+  PendingUpdate *update = &m_pending_updates[frame.UniverseId()];
+  if (update->in_flight) {
+    // Latest frame wins, drop whatever was waiting.
+    if (update->has_next) {
+      m_superseded_updates++;
+    }
+    update->next = frame.Encoded();
+    update->has_next = true;
+    return true;
+  }
+  SendUpdate(frame.UniverseId(), update, frame.Encoded());
+  return true;
+}
+
+void Client::SetUniverseInfoSubscription(bool include_ports,
+                                         uint64_t version) {
+  m_universe_info.subscribed = true;
+  m_universe_info.include_ports = include_ports;
+  m_universe_info.version = version;
+}
+
+void Client::ClearUniverseInfoSubscription() {
+  m_universe_info.subscribed = false;
+  m_universe_info.version = 0;
+}
+
+bool Client::SendUniverseInfo(const ola::proto::UniverseInfoReply &update) {
+  if (!m_universe_info.subscribed || m_universe_info.in_flight) {
+    return false;
+  }
+  if (!m_client_stub.get() || !m_client_stub->channel()) {
+    OLA_FATAL << "client_stub is null";
+    return false;
+  }
+
+  m_universe_info.in_flight = true;
+  m_universe_info.version = update.version();
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *ack = new ola::proto::Ack();
+  m_client_stub->UpdateUniverseInfo(
+      controller, &update, ack,
+      ola::NewSingleCallback(this, &ola::Client::SendUniverseInfoCallback,
                              controller, ack));
   return true;
 }
@@ -92,14 +225,65 @@ void Client::SetUID(const ola::rdm::UID &uid) {
   m_uid = uid;
 }
 
+/*
+ * Send a serialized DmxData message with UpdateDmxData.
+ */
+void Client::SendUpdate(unsigned int universe_id, PendingUpdate *update,
+                        const string &encoded) {
+  static const google::protobuf::MethodDescriptor *method =
+      ola::proto::OlaClientService::descriptor()->FindMethodByName(
+          "UpdateDmxData");
+
+  update->in_flight = true;
+  RpcController *controller = new RpcController();
+  // A newer frame will be along soon.
+  controller->SetDroppable(true);
+  ola::proto::Ack *ack = new ola::proto::Ack();
+  m_client_stub->channel()->CallMethod(
+      method, controller, encoded, ack,
+      ola::NewSingleCallback(this, &ola::Client::SendDMXCallback,
+                             universe_id, controller, ack));
+}
+
 /*
  * Called when UpdateDmxData completes.
  */
-void Client::SendDMXCallback(RpcController *controller,
+void Client::SendDMXCallback(unsigned int universe_id,
+                             RpcController *controller,
                              ola::proto::Ack *reply) {
+  if (controller->Failed()) {
+    // The update may have been dropped, so make sure the next one is sent
+    // even if the data hasn't changed.
+    SinkState *state = STLFind(&m_sink_state, universe_id);
+    if (state) {
+      state->sent = false;
+    }
+  }
   delete controller;
   delete reply;
-}
 
+  PendingUpdate *update = STLFind(&m_pending_updates, universe_id);
+  if (!update) {
+    return;
+  }
+  update->in_flight = false;
+  if (update->has_next) {
+    update->has_next = false;
+    SendUpdate(universe_id, update, update->next);
+  }
+}
 
+/*
+ * Called when UpdateUniverseInfo completes.
+ */
+void Client::SendUniverseInfoCallback(RpcController *controller,
+                                      ola::proto::Ack *reply) {
+  m_universe_info.in_flight = false;
+  if (controller->Failed()) {
+    // We don't know what the client has, so the next update lists everything.
+    m_universe_info.version = 0;
+  }
+  delete controller;
+  delete reply;
+}
 }  // namespace ola
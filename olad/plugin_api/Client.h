@@ -21,10 +21,14 @@
 #ifndef OLAD_PLUGIN_API_CLIENT_H_
 #define OLAD_PLUGIN_API_CLIENT_H_
 
+#include <stdint.h>
 #include <map>
 #include <memory>
+#include <string>
 #include "common/rpc/RpcController.h"
+#include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/dmx/DmxSharedMemory.h"
 #include "ola/rdm/UID.h"
 #include "olad/DmxSource.h"
 
@@ -32,11 +36,73 @@ namespace ola {
 namespace proto {
 class OlaClientService_Stub;
 class Ack;
+class UniverseInfoReply;
 }
 }
 
 namespace ola {
 
+/**
+ * @brief A DMX update for the sink clients of a universe.
+ *
+ * The update is serialized the first time a client asks for it, and the
+ * serialized message is shared by all the clients.
+ */
+class SinkFrame {
+ public:
+  SinkFrame(unsigned int universe_id, uint8_t priority,
+            const DmxBuffer &buffer)
+      : m_universe_id(universe_id),
+        m_priority(priority),
+        m_buffer(buffer),
+        m_encoded(false) {
+  }
+
+  unsigned int UniverseId() const { return m_universe_id; }
+  uint8_t Priority() const { return m_priority; }
+  const DmxBuffer &Data() const { return m_buffer; }
+
+  /**
+   * @brief The update as a serialized DmxData message.
+   */
+  const std::string &Encoded() const;
+
+ private:
+  const unsigned int m_universe_id;
+  const uint8_t m_priority;
+  const DmxBuffer &m_buffer;
+  mutable bool m_encoded;
+  mutable std::string m_encoded_data;
+
+  DISALLOW_COPY_AND_ASSIGN(SinkFrame);
+};
+
+
+/**
+ * @brief The options a client can set when it registers for a universe.
+ */
+struct SinkOptions {
+  SinkOptions()
+      : max_rate(0),
+        changes_only(false),
+        start_slot(0),
+        slot_count(0) {
+  }
+
+  /**
+   * @brief Returns true if the client wants every slot of every update.
+   */
+  bool IsDefault() const {
+    return !max_rate && !changes_only && !start_slot && !slot_count;
+  }
+
+  unsigned int max_rate;  // updates per second, 0 is no limit
+  bool changes_only;  // only send updates if the data changed
+  unsigned int start_slot;  // the first slot to send
+  unsigned int slot_count;  // the number of slots to send, 0 is all
+};
+
+
 /**
  * @brief Represents a connected OLA client on the OLA server side.
  *
@@ -51,9 +117,12 @@ class Client {
    *   the client. Ownership is transferred to the client.
    * @param uid The default UID to use for this client. The client may set its
    *   own UID later.
+   * @param clock the clock to use for rate limiting, ownership is not
+   *   transferred. If NULL a real clock is used.
    */
   Client(ola::proto::OlaClientService_Stub *client_stub,
-         const ola::rdm::UID &uid);
+         const ola::rdm::UID &uid,
+         const ola::Clock *clock = NULL);
 
   virtual ~Client();
 
@@ -67,6 +136,81 @@ class Client {
   virtual bool SendDMX(unsigned int universe_id, uint8_t priority,
                        const DmxBuffer &buffer);
 
+  /**
+   * @brief Push a DMX update, that may be shared with other clients, to this
+   * client.
+   * @param frame the DMX update.
+   * @return true if the update was sent or queued, false otherwise
+   *
+   * Only one update per universe is sent at a time. If the client hasn't
+   * acknowledged the last update, the new one replaces any update that is
+   * waiting, so slow clients get the latest data rather than a backlog.
+   *
+   * Updates are filtered by the SinkOptions for the universe, if any.
+   */
+  virtual bool SendDMX(const SinkFrame &frame);
+
+  /**
+   * @brief Set the options for the updates sent for a universe.
+   * @param universe_id the universe the options apply to.
+   * @param options the SinkOptions.
+   */
+  void SetSinkOptions(unsigned int universe_id, const SinkOptions &options);
+
+  /**
+   * @brief Remove the options for a universe, so every update is sent.
+   * @param universe_id the universe to remove the options for.
+   */
+  void ClearSinkOptions(unsigned int universe_id);
+
+  /**
+   * @brief Subscribe this client to changes to the universe info.
+   * @param include_ports true if the updates should include the ports.
+   * @param version the info version the client already has, 0 if the first
+   *   update should list every universe.
+   */
+  void SetUniverseInfoSubscription(bool include_ports, uint64_t version);
+
+  /**
+   * @brief Stop sending universe info updates to this client.
+   */
+  void ClearUniverseInfoSubscription();
+
+  bool UniverseInfoSubscribed() const { return m_universe_info.subscribed; }
+  bool UniverseInfoIncludesPorts() const {
+    return m_universe_info.include_ports;
+  }
+
+  /**
+   * @brief The info version of the last update sent to this client.
+   */
+  uint64_t UniverseInfoVersion() const { return m_universe_info.version; }
+
+  /**
+   * @brief Check if the client hasn't acknowledged the last info update.
+   */
+  bool UniverseInfoInFlight() const { return m_universe_info.in_flight; }
+
+  /**
+   * @brief Push a universe info update to this client.
+   * @param update the update, the version must be set.
+   * @return true if the update was sent, false if the last update hasn't
+   *   been acknowledged yet or the client isn't subscribed.
+   */
+  virtual bool SendUniverseInfo(const ola::proto::UniverseInfoReply &update);
+
+  /**
+   * @brief The number of updates that were replaced by newer data before
+   * they could be sent.
+   */
+  unsigned int SupersededUpdates() const { return m_superseded_updates; }
+
+  /**
+   * @brief The number of updates that weren't sent because of the
+   * SinkOptions.
+   */
+  unsigned int FilteredUpdates() const { return m_filtered_updates; }
+
   /**
    * @brief Called when this client sends us new data
    * @param universe the id of the universe for the new data
@@ -89,19 +233,102 @@ class Client {
    */
   ola::rdm::UID GetUID() const;
 
+  /**
+   * @brief A number that identifies this client, used to share the RDM
+   * queues fairly between clients.
+   * @returns the client's id, this is never 0.
+   */
+  unsigned int Id() const { return m_id; }
+
   /**
    * @brief Set the UID for the client.
    * @param uid the new UID to use for this client.
    */
   void SetUID(const ola::rdm::UID &uid);
 
+  /**
+   * @brief Set the shared memory segment this client sends DMX data through.
+   * @param memory the segment, ownership is transferred. This replaces any
+   *   existing segment.
+   */
+  void SetSharedMemory(ola::dmx::DmxSharedMemory *memory) {
+    m_shared_memory.reset(memory);
+  }
+
+  /**
+   * @brief The shared memory segment for this client, or NULL if there isn't
+   * one.
+   */
+  ola::dmx::DmxSharedMemory *SharedMemory() { return m_shared_memory.get(); }
+
  private:
-  void SendDMXCallback(ola::rpc::RpcController *controller,
+  /*
+   * The updates for a universe that haven't been acknowledged yet.
+   */
+  struct PendingUpdate {
+    PendingUpdate() : in_flight(false), has_next(false) {}
+
+    bool in_flight;  // true if we're waiting for the client to ack
+    bool has_next;  // true if there is an update waiting to be sent
+    std::string next;  // the serialized DmxData to send next
+  };
+
+  typedef std::map<unsigned int, PendingUpdate> PendingUpdateMap;
+
+  /*
+   * The options for a universe, and what we last sent for it.
+   */
+  struct SinkState {
+    SinkState() : sent(false), last_priority(0) {}
+
+    SinkOptions options;
+    bool sent;
+    ola::TimeStamp last_sent;
+    uint8_t last_priority;
+    DmxBuffer last_data;  // only used if options.changes_only is set
+  };
+
+  typedef std::map<unsigned int, SinkState> SinkStateMap;
+
+  /*
+   * The universe info subscription.
+   */
+  struct UniverseInfoState {
+    UniverseInfoState()
+        : subscribed(false),
+          include_ports(true),
+          in_flight(false),
+          version(0) {
+    }
+
+    bool subscribed;
+    bool include_ports;
+    bool in_flight;
+    uint64_t version;
+  };
+
+  bool QueueUpdate(const SinkFrame &frame);
+
+  void SendUpdate(unsigned int universe_id, PendingUpdate *update,
+                  const std::string &encoded);
+  void SendDMXCallback(unsigned int universe_id,
+                       ola::rpc::RpcController *controller,
                        ola::proto::Ack *ack);
+  void SendUniverseInfoCallback(ola::rpc::RpcController *controller,
+                                ola::proto::Ack *ack);
 
+  ola::Clock m_real_clock;
+  const ola::Clock *m_clock;
   std::auto_ptr<class ola::proto::OlaClientService_Stub> m_client_stub;
   std::map<unsigned int, DmxSource> m_data_map;
   ola::rdm::UID m_uid;
+  const unsigned int m_id;
+  std::auto_ptr<ola::dmx::DmxSharedMemory> m_shared_memory;
+  PendingUpdateMap m_pending_updates;
+  SinkStateMap m_sink_state;
+  UniverseInfoState m_universe_info;
+  unsigned int m_superseded_updates;
+  unsigned int m_filtered_updates;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
@@ -20,14 +20,18 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcService.h"
 #include "ola/Clock.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
 #include "olad/DmxSource.h"
@@ -41,17 +45,27 @@ static const char TEST_DATA2[] = "another set of test data";
 
 using ola::Client;
 using ola::DmxBuffer;
+using ola::SinkFrame;
+using ola::SinkOptions;
+using ola::io::LoopbackDescriptor;
+using ola::io::SelectServer;
+using ola::rpc::RpcChannel;
 using std::string;
+using std::vector;
 
 class ClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ClientTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSinkFrame);
+  CPPUNIT_TEST(testSinkOptions);
   CPPUNIT_TEST(testGetSetDMX);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   ClientTest() : m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
   void testSendDMX();
+  void testSinkFrame();
+  void testSinkOptions();
   void testGetSetDMX();
 
  private:
@@ -63,28 +77,57 @@ class ClientTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(ClientTest);
 
 /*
- * Mock out the ClientStub for testing
+ * Mock out the client end of the connection. This holds on to the completion
+ * callbacks, so the test controls when updates are acknowledged.
  */
-class MockClientStub: public ola::proto::OlaClientService_Stub {
+class MockClientService: public ola::proto::OlaClientService {
  public:
-  MockClientStub(): ola::proto::OlaClientService_Stub(NULL) {}
+  ~MockClientService() { AckAll(); }
 
   void UpdateDmxData(ola::rpc::RpcController *controller,
                      const ola::proto::DmxData *request,
                      ola::proto::Ack *response,
                      ola::rpc::RpcService::CompletionCallback *done);
+
+  void AckAll();
+
+  vector<ola::proto::DmxData> updates;
+
+ private:
+  vector<ola::rpc::RpcService::CompletionCallback*> m_callbacks;
 };
 
-void MockClientStub::UpdateDmxData(
+void MockClientService::UpdateDmxData(
     ola::rpc::RpcController* controller,
     const ola::proto::DmxData *request,
     OLA_UNUSED ola::proto::Ack *response,
     ola::rpc::RpcService::CompletionCallback *done) {
   OLA_ASSERT(controller);
   OLA_ASSERT_FALSE(controller->Failed());
-  OLA_ASSERT_EQ(TEST_UNIVERSE, (unsigned int) request->universe());
-  OLA_ASSERT(TEST_DATA == request->data());
-  done->Run();
+  updates.push_back(*request);
+  m_callbacks.push_back(done);
+}
+
+void MockClientService::AckAll() {
+  vector<ola::rpc::RpcService::CompletionCallback*>::iterator iter;
+  for (iter = m_callbacks.begin(); iter != m_callbacks.end(); ++iter) {
+    (*iter)->Run();
+  }
+  m_callbacks.clear();
+}
+
+/*
+ * Run the SelectServer until the service has received the expected number of
+ * updates.
+ */
+static void WaitForUpdates(SelectServer *ss, MockClientService *service,
+                           unsigned int count) {
+  for (unsigned int i = 0; i < 100 && service->updates.size() < count; i++) {
+    ss->RunOnce(ola::TimeInterval(0, 10000));
+  }
+  // Make sure nothing else arrives.
+  ss->RunOnce(ola::TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(static_cast<size_t>(count), service->updates.size());
 }
 
 /*
@@ -93,15 +136,139 @@ void MockClientStub::UpdateDmxData(
 void ClientTest::testSendDMX() {
   // check we survive a null pointer
   const DmxBuffer buffer(TEST_DATA);
+  const DmxBuffer buffer2(TEST_DATA2);
+  const DmxBuffer buffer3("yet more test data");
   uint8_t priority = 100;
   Client client(NULL, m_test_uid);
   client.SendDMX(TEST_UNIVERSE, priority, buffer);
 
-  // check the stub is called correctly
-  Client client2(new MockClientStub(), m_test_uid);
-  client2.SendDMX(TEST_UNIVERSE, priority, buffer);
+  // The loopback descriptor means the channel talks to itself.
+  SelectServer ss;
+  LoopbackDescriptor descriptor;
+  OLA_ASSERT_TRUE(descriptor.Init());
+  MockClientService service;
+  RpcChannel channel(&service, &descriptor);
+  ss.AddReadDescriptor(&descriptor);
+
+  // check the service receives the update
+  Client client2(new ola::proto::OlaClientService_Stub(&channel), m_test_uid);
+  OLA_ASSERT_TRUE(client2.SendDMX(TEST_UNIVERSE, priority, buffer));
+  WaitForUpdates(&ss, &service, 1);
+  OLA_ASSERT_EQ(TEST_UNIVERSE,
+                static_cast<unsigned int>(service.updates[0].universe()));
+  OLA_ASSERT_EQ(static_cast<int>(priority), service.updates[0].priority());
+  OLA_ASSERT_EQ(string(TEST_DATA), service.updates[0].data());
+
+  // Until the update is acked, new updates replace each other. Other
+  // universes aren't held up.
+  OLA_ASSERT_TRUE(client2.SendDMX(TEST_UNIVERSE, priority, buffer2));
+  OLA_ASSERT_TRUE(client2.SendDMX(TEST_UNIVERSE, priority, buffer3));
+  OLA_ASSERT_TRUE(client2.SendDMX(TEST_UNIVERSE2, priority, buffer2));
+  WaitForUpdates(&ss, &service, 2);
+  OLA_ASSERT_EQ(TEST_UNIVERSE2,
+                static_cast<unsigned int>(service.updates[1].universe()));
+  OLA_ASSERT_EQ(1u, client2.SupersededUpdates());
+
+  // Once acked, the latest update is sent.
+  service.AckAll();
+  WaitForUpdates(&ss, &service, 3);
+  OLA_ASSERT_EQ(TEST_UNIVERSE,
+                static_cast<unsigned int>(service.updates[2].universe()));
+  OLA_ASSERT_EQ(buffer3.Get(), service.updates[2].data());
+
+  // Nothing is waiting now.
+  service.AckAll();
+  WaitForUpdates(&ss, &service, 3);
+  ss.RemoveReadDescriptor(&descriptor);
 }
 
+/*
+ * Check that the SinkFrame is serialized correctly.
+ */
+void ClientTest::testSinkFrame() {
+  const DmxBuffer buffer(TEST_DATA);
+  SinkFrame frame(TEST_UNIVERSE, 120, buffer);
+  OLA_ASSERT_EQ(TEST_UNIVERSE, frame.UniverseId());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), frame.Priority());
+  OLA_ASSERT_EQ(buffer, frame.Data());
+
+  ola::proto::DmxData dmx_data;
+  OLA_ASSERT_TRUE(dmx_data.ParseFromString(frame.Encoded()));
+  OLA_ASSERT_EQ(TEST_UNIVERSE, static_cast<unsigned int>(dmx_data.universe()));
+  OLA_ASSERT_EQ(120, dmx_data.priority());
+  OLA_ASSERT_EQ(string(TEST_DATA), dmx_data.data());
+  // The same string is returned each time.
+  OLA_ASSERT_EQ(&frame.Encoded(), &frame.Encoded());
+}
+
+/*
+ * Check that the SinkOptions limit the updates sent.
+ */
+void ClientTest::testSinkOptions() {
+  const DmxBuffer buffer(TEST_DATA);
+  const DmxBuffer buffer2(TEST_DATA2);
+  uint8_t priority = 100;
+
+  SelectServer ss;
+  LoopbackDescriptor descriptor;
+  OLA_ASSERT_TRUE(descriptor.Init());
+  MockClientService service;
+  RpcChannel channel(&service, &descriptor);
+  ss.AddReadDescriptor(&descriptor);
+
+  ola::MockClock clock;
+  Client client(new ola::proto::OlaClientService_Stub(&channel), m_test_uid,
+                &clock);
+  SinkOptions options;
+  options.max_rate = 10;
+  options.changes_only = true;
+  options.start_slot = 2;
+  options.slot_count = 3;
+  client.SetSinkOptions(TEST_UNIVERSE, options);
+
+  // Only the range of slots is sent
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, priority, buffer));
+  WaitForUpdates(&ss, &service, 1);
+  OLA_ASSERT_EQ(string(TEST_DATA).substr(2, 3), service.updates[0].data());
+  service.AckAll();
+
+  // This is too soon after the last update
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, priority, buffer2));
+  WaitForUpdates(&ss, &service, 1);
+  OLA_ASSERT_EQ(1u, client.FilteredUpdates());
+
+  // Once the interval has passed, the update is sent
+  clock.AdvanceTime(0, 100000);
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, priority, buffer2));
+  WaitForUpdates(&ss, &service, 2);
+  OLA_ASSERT_EQ(string(TEST_DATA2).substr(2, 3), service.updates[1].data());
+  service.AckAll();
+
+  // The slots in the range haven't changed
+  clock.AdvanceTime(0, 100000);
+  DmxBuffer buffer3(buffer2);
+  buffer3.SetChannel(10, 255);
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, priority, buffer3));
+  WaitForUpdates(&ss, &service, 2);
+  OLA_ASSERT_EQ(2u, client.FilteredUpdates());
+
+  // Other universes are sent as is
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE2, priority, buffer));
+  WaitForUpdates(&ss, &service, 3);
+  OLA_ASSERT_EQ(string(TEST_DATA), service.updates[2].data());
+  service.AckAll();
+
+  // Once cleared, all updates are sent
+  client.ClearSinkOptions(TEST_UNIVERSE);
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, priority, buffer3));
+  WaitForUpdates(&ss, &service, 4);
+  OLA_ASSERT_EQ(buffer3.Get(), service.updates[3].data());
+  service.AckAll();
+  WaitForUpdates(&ss, &service, 4);
+  ss.RemoveReadDescriptor(&descriptor);
+}
+
+
 /*
  * Check that the DMX get/set works correctly.
  */
@@ -28,6 +28,9 @@
 
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcService.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Device.h"
@@ -51,7 +54,9 @@ Device::Device(AbstractPlugin *owner, const string &name)
     : AbstractDevice(),
       m_enabled(false),
       m_owner(owner),
-      m_name(name) {
+      m_name(name),
+      m_scheduler(NULL),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT) {
 }
 
 
@@ -63,6 +68,7 @@ Device::~Device() {
   if (m_enabled)
     OLA_FATAL << "Device " << m_name << " wasn't stopped before deleting, " <<
       "this represents a serious programming error.";
+  DiscardStagedFrames();
 }
 
 
@@ -88,6 +94,8 @@ bool Device::Stop() {
     return true;
 
   PrePortStop();
+  // The staged frames refer to the ports.
+  DiscardStagedFrames();
   DeleteAllPorts();
   PostPortStop();
 
@@ -190,6 +198,61 @@ void Device::Configure(ola::rpc::RpcController *controller,
 }
 
 
+bool Device::StageFrame(OutputPort *port, const DmxBuffer &buffer,
+                        uint8_t priority) {
+  if (!m_scheduler) {
+    return false;
+  }
+
+  vector<StagedFrame>::iterator iter = m_staged_frames.begin();
+  for (; iter != m_staged_frames.end(); ++iter) {
+    if (iter->port == port) {
+      iter->buffer = buffer;
+      iter->priority = priority;
+      return true;
+    }
+  }
+  m_staged_frames.push_back(StagedFrame(port, buffer, priority));
+
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        TimeInterval(0, 0), MakeInlineCallback(this, &Device::Flush));
+  }
+  return true;
+}
+
+
+void Device::EnableBatchedOutput(ola::thread::SchedulerInterface *scheduler) {
+  m_scheduler = scheduler;
+}
+
+
+/*
+ * Called at the end of the event loop iteration after a frame was staged.
+ */
+void Device::Flush() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  // Ports may stage new frames from within FlushFrames().
+  vector<StagedFrame> frames;
+  frames.swap(m_staged_frames);
+  FlushFrames(frames);
+  // Keep the capacity, the same ports are usually written every frame.
+  if (m_staged_frames.empty()) {
+    frames.clear();
+    m_staged_frames.swap(frames);
+  }
+}
+
+
+void Device::DiscardStagedFrames() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_staged_frames.clear();
+}
+
+
 template<class PortClass>
 bool Device::GenericAddPort(PortClass *port,
                             map<unsigned int, PortClass*> *port_map) {
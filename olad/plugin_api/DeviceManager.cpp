@@ -45,6 +45,7 @@ const unsigned int DeviceManager::MISSING_DEVICE_ALIAS = 0;
 const char DeviceManager::PORT_PREFERENCES[] = "port";
 const char DeviceManager::PRIORITY_VALUE_SUFFIX[] = "_priority_value";
 const char DeviceManager::PRIORITY_MODE_SUFFIX[] = "_priority_mode";
+const char DeviceManager::MAX_FRAME_RATE_SUFFIX[] = "_max_frame_rate";
 
 bool operator <(const device_alias_pair& left,
                 const device_alias_pair &right) {
@@ -107,15 +108,18 @@ bool DeviceManager::RegisterDevice(AbstractDevice *device) {
 
   vector<InputPort*> input_ports;
   device->InputPorts(&input_ports);
-  RestorePortSettings(input_ports);
-
   vector<OutputPort*> output_ports;
   device->OutputPorts(&output_ports);
+
+  device->EnterConfigurationMode();
+  RestorePortSettings(input_ports);
   RestorePortSettings(output_ports);
+  device->ExitConfigurationMode();
 
   // look for timecode ports and add them to the set
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
+    RestorePortFrameRate(*output_iter);
     if ((*output_iter)->SupportsTimeCode()) {
       m_timecode_ports.insert(*output_iter);
     }
@@ -219,6 +223,7 @@ void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
     SavePortPriority(**output_iter);
+    SavePortFrameRate(**output_iter);
 
     // remove from the timecode port set
     STLRemove(&m_timecode_ports, *output_iter);
@@ -273,6 +278,47 @@ void DeviceManager::SavePortPriority(const Port &port) const {
 }
 
 
+/*
+ * Save the rate limit for an output port
+ */
+void DeviceManager::SavePortFrameRate(const OutputPort &port) const {
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  if (port.MaxFrameRate()) {
+    m_port_preferences->SetValue(port_id + MAX_FRAME_RATE_SUFFIX,
+                                 IntToString(port.MaxFrameRate()));
+  } else {
+    m_port_preferences->RemoveValue(port_id + MAX_FRAME_RATE_SUFFIX);
+  }
+}
+
+
+/*
+ * Restore the rate limit for an output port
+ */
+void DeviceManager::RestorePortFrameRate(OutputPort *port) const {
+  if (!m_port_preferences) {
+    return;
+  }
+
+  string port_id = port->UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  string rate_str = m_port_preferences->GetValue(
+      port_id + MAX_FRAME_RATE_SUFFIX);
+  unsigned int rate;
+  if (!rate_str.empty() && StringToInt(rate_str, &rate) &&
+      !port->SetMaxFrameRate(rate)) {
+    OLA_WARN << "Invalid max frame rate for " << port_id << ": " << rate_str;
+  }
+}
+
+
 /*
  * Restore the priority settings for a port
  */
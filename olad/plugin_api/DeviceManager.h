@@ -158,6 +158,8 @@ class DeviceManager {
 
   void SavePortPriority(const Port &port) const;
   void RestorePortPriority(Port *port) const;
+  void SavePortFrameRate(const OutputPort &port) const;
+  void RestorePortFrameRate(OutputPort *port) const;
 
   template <class PortClass>
   void RestorePortSettings(const std::vector<PortClass*> &ports) const;
@@ -166,6 +168,7 @@ class DeviceManager {
   static const unsigned int FIRST_DEVICE_ALIAS = 1;
   static const char PRIORITY_VALUE_SUFFIX[];
   static const char PRIORITY_MODE_SUFFIX[];
+  static const char MAX_FRAME_RATE_SUFFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(DeviceManager);
 };
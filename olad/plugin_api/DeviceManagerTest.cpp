@@ -221,6 +221,9 @@ void DeviceManagerTest::testRestorePriorities() {
   prefs->SetValue("2-test_device_1-I-3_priority_value", "210");
   prefs->SetValue("2-test_device_1-O-3_priority_mode", "0");  // inherit mode
   prefs->SetValue("2-test_device_1-O-3_priority_value", "180");
+  prefs->SetValue("2-test_device_1-O-1_max_frame_rate", "30");
+  // out of range
+  prefs->SetValue("2-test_device_1-O-2_max_frame_rate", "100000");
 
   TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
   MockDevice device1(&plugin, "test_device_1");
@@ -266,6 +269,9 @@ void DeviceManagerTest::testRestorePriorities() {
   OLA_ASSERT_EQ(ola::PRIORITY_MODE_INHERIT, output_port3.GetPriorityMode());
   OLA_ASSERT_EQ((uint8_t) 180, output_port3.GetPriority());
 
+  OLA_ASSERT_EQ(30u, output_port.MaxFrameRate());
+  OLA_ASSERT_EQ(0u, output_port2.MaxFrameRate());
+
   // Now make some changes
   input_port2.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
   output_port2.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
@@ -273,6 +279,8 @@ void DeviceManagerTest::testRestorePriorities() {
   input_port3.SetPriority(40);
   output_port3.SetPriorityMode(ola::PRIORITY_MODE_STATIC);
   output_port3.SetPriority(60);
+  output_port.SetMaxFrameRate(0);
+  output_port3.SetMaxFrameRate(25);
 
   // unregister all
   manager.UnregisterAllDevices();
@@ -290,4 +298,7 @@ void DeviceManagerTest::testRestorePriorities() {
                 prefs->GetValue("2-test_device_1-O-3_priority_mode"));
   OLA_ASSERT_EQ(string("60"),
                 prefs->GetValue("2-test_device_1-O-3_priority_value"));
+  OLA_ASSERT_FALSE(prefs->HasKey("2-test_device_1-O-1_max_frame_rate"));
+  OLA_ASSERT_EQ(string("25"),
+                prefs->GetValue("2-test_device_1-O-3_max_frame_rate"));
 }
@@ -22,6 +22,8 @@
 #include <string>
 #include <vector>
 
+#include "ola/DmxBuffer.h"
+#include "ola/io/SelectServer.h"
 #include "olad/Device.h"
 #include "olad/Plugin.h"
 #include "olad/Port.h"
@@ -32,6 +34,7 @@
 
 using ola::AbstractDevice;
 using ola::AbstractPlugin;
+using ola::DmxBuffer;
 using ola::InputPort;
 using ola::OutputPort;
 using std::string;
@@ -41,10 +44,12 @@ using std::vector;
 class DeviceTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DeviceTest);
   CPPUNIT_TEST(testDevice);
+  CPPUNIT_TEST(testBatchedOutput);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDevice();
+    void testBatchedOutput();
 
  private:
     void AddPortsToDeviceAndCheck(ola::Device *device);
@@ -54,6 +59,61 @@ class DeviceTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(DeviceTest);
 
 
+/*
+ * A device which collects the frames from its ports.
+ */
+class BatchingDevice: public MockDevice {
+ public:
+  BatchingDevice(AbstractPlugin *owner,
+                 ola::thread::SchedulerInterface *scheduler)
+      : MockDevice(owner, "batching"),
+        flushes(0),
+        m_scheduler(scheduler) {
+  }
+
+  std::vector<StagedFrame> frames;
+  unsigned int flushes;
+
+ protected:
+  bool StartHook() {
+    if (m_scheduler) {
+      EnableBatchedOutput(m_scheduler);
+    }
+    return true;
+  }
+
+  void FlushFrames(const std::vector<StagedFrame> &staged_frames) {
+    frames = staged_frames;
+    flushes++;
+  }
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+};
+
+
+/*
+ * A port which stages its frames with a BatchingDevice.
+ */
+class BatchingOutputPort: public TestMockOutputPort {
+ public:
+  BatchingOutputPort(BatchingDevice *parent, unsigned int port_id)
+      : TestMockOutputPort(parent, port_id),
+        m_device(parent) {
+  }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    if (m_device->StageFrame(this, buffer, priority)) {
+      return true;
+    }
+    return TestMockOutputPort::WriteDMX(buffer, priority);
+  }
+
+ private:
+  BatchingDevice *m_device;
+};
+
+
 /*
  * Check that the base device class works correctly.
  */
@@ -109,3 +169,65 @@ void DeviceTest::AddPortsToDeviceAndCheck(ola::Device *device) {
   OLA_ASSERT(output_port);
   OLA_ASSERT_EQ((unsigned int) 1, output_port->PortId());
 }
+
+
+/*
+ * Check the frames from a device's ports are flushed together.
+ */
+void DeviceTest::testBatchedOutput() {
+  ola::io::SelectServer ss;
+  const uint8_t data[] = {1, 2, 3, 4};
+  const DmxBuffer first(data, 2);
+  const DmxBuffer second(data, 3);
+  const DmxBuffer third(data, 4);
+
+  // Without batched output the ports send the frames themselves.
+  BatchingDevice unbatched(NULL, NULL);
+  OLA_ASSERT(unbatched.Start());
+  BatchingOutputPort *unbatched_port = new BatchingOutputPort(&unbatched, 1);
+  unbatched.AddPort(unbatched_port);
+  OLA_ASSERT(unbatched_port->WriteDMX(first, 100));
+  OLA_ASSERT(first == unbatched_port->ReadDMX());
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(0u, unbatched.flushes);
+  unbatched.Stop();
+
+  BatchingDevice device(NULL, &ss);
+  OLA_ASSERT(device.Start());
+  BatchingOutputPort *port1 = new BatchingOutputPort(&device, 1);
+  BatchingOutputPort *port2 = new BatchingOutputPort(&device, 2);
+  device.AddPort(port1);
+  device.AddPort(port2);
+
+  OLA_ASSERT(port2->WriteDMX(first, 100));
+  OLA_ASSERT(port1->WriteDMX(second, 100));
+  // The latest frame for each port wins.
+  OLA_ASSERT(port2->WriteDMX(third, 50));
+  OLA_ASSERT_EQ(0u, port2->ReadDMX().Size());
+  OLA_ASSERT_EQ(0u, device.flushes);
+
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, device.flushes);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), device.frames.size());
+  OLA_ASSERT_EQ(static_cast<OutputPort*>(port2), device.frames[0].port);
+  OLA_ASSERT(third == device.frames[0].buffer);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), device.frames[0].priority);
+  OLA_ASSERT_EQ(static_cast<OutputPort*>(port1), device.frames[1].port);
+  OLA_ASSERT(second == device.frames[1].buffer);
+
+  // Nothing was staged, so there's no flush.
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, device.flushes);
+
+  OLA_ASSERT(port1->WriteDMX(first, 100));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, device.flushes);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), device.frames.size());
+  OLA_ASSERT(first == device.frames[0].buffer);
+
+  // Frames staged when the device stops are discarded.
+  OLA_ASSERT(port1->WriteDMX(second, 100));
+  device.Stop();
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, device.flushes);
+}
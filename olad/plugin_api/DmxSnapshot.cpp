@@ -0,0 +1,244 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxSnapshot.cpp
+ * Saves the last DMX data for each universe, so it can be restored on start.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/DmxSnapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+using ola::network::HostToNetwork;
+using ola::network::NetworkToHost;
+using std::string;
+using std::vector;
+
+namespace {
+const uint32_t SNAPSHOT_MAGIC = 0x4f4c4453;  // OLDS
+const uint16_t SNAPSHOT_VERSION = 1;
+// The universe count is a uint16.
+const unsigned int MAX_UNIVERSES = 0xffff;
+
+void AppendUInt16(uint16_t value, string *output) {
+  value = HostToNetwork(value);
+  output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendUInt32(uint32_t value, string *output) {
+  value = HostToNetwork(value);
+  output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ExtractUInt16(const string &input, unsigned int *offset,
+                   uint16_t *value) {
+  if (input.size() - *offset < sizeof(*value)) {
+    return false;
+  }
+  memcpy(value, input.data() + *offset, sizeof(*value));
+  *value = NetworkToHost(*value);
+  *offset += sizeof(*value);
+  return true;
+}
+
+bool ExtractUInt32(const string &input, unsigned int *offset,
+                   uint32_t *value) {
+  if (input.size() - *offset < sizeof(*value)) {
+    return false;
+  }
+  memcpy(value, input.data() + *offset, sizeof(*value));
+  *value = NetworkToHost(*value);
+  *offset += sizeof(*value);
+  return true;
+}
+
+/*
+ * Write the snapshot to a temporary file and then rename it over the
+ * original, so a crash never leaves a partial snapshot behind. This runs in
+ * the writer thread.
+ */
+void WriteSnapshot(const string filename, const string contents) {
+  const string temp_filename = filename + ".new";
+  int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
+    return;
+  }
+
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    ssize_t r = write(fd, contents.data() + offset, contents.size() - offset);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to write " << temp_filename << ": "
+               << strerror(errno);
+      close(fd);
+      unlink(temp_filename.c_str());
+      return;
+    }
+    offset += r;
+  }
+
+  if (fsync(fd)) {
+    OLA_WARN << "Failed to sync " << temp_filename << ": " << strerror(errno);
+  }
+  close(fd);
+
+  if (rename(temp_filename.c_str(), filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << " to " << filename
+             << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
+  }
+}
+}  // namespace
+
+DmxSnapshot::DmxSnapshot(const string &filename)
+    : m_filename(filename),
+      m_writer(ola::thread::Thread::Options("dmx-snapshot")) {
+}
+
+DmxSnapshot::~DmxSnapshot() {
+  Stop();
+}
+
+bool DmxSnapshot::Start() {
+  return m_writer.Start();
+}
+
+void DmxSnapshot::Stop() {
+  m_writer.Stop();
+}
+
+bool DmxSnapshot::Load() {
+  std::ifstream file(m_filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    OLA_INFO << "No DMX snapshot at " << m_filename;
+    return false;
+  }
+
+  std::ostringstream str;
+  str << file.rdbuf();
+  const string contents = str.str();
+
+  FrameMap frames;
+  if (!Decode(contents, &frames)) {
+    OLA_WARN << "Invalid DMX snapshot " << m_filename;
+    return false;
+  }
+  m_frames.swap(frames);
+  m_last_saved = contents;
+  OLA_INFO << "Loaded DMX for " << m_frames.size() << " universes from "
+           << m_filename;
+  return true;
+}
+
+bool DmxSnapshot::Restore(Universe *universe) {
+  FrameMap::iterator iter = m_frames.find(universe->UniverseId());
+  if (iter == m_frames.end()) {
+    return false;
+  }
+  universe->RestoreDMX(iter->second);
+  m_frames.erase(iter);
+  return true;
+}
+
+void DmxSnapshot::Save(const vector<Universe*> &universes) {
+  string contents;
+  Encode(universes, &contents);
+  if (contents == m_last_saved) {
+    return;
+  }
+  m_last_saved = contents;
+  m_writer.Execute(NewSingleCallback(&WriteSnapshot, m_filename, contents));
+}
+
+void DmxSnapshot::Flush() {
+  m_writer.DrainCallbacks();
+}
+
+void DmxSnapshot::Encode(const vector<Universe*> &universes,
+                         string *output) {
+  vector<const Universe*> saved;
+  vector<Universe*>::const_iterator iter = universes.begin();
+  for (; iter != universes.end() && saved.size() < MAX_UNIVERSES; ++iter) {
+    if ((*iter)->GetDMX().Size()) {
+      saved.push_back(*iter);
+    }
+  }
+
+  output->clear();
+  AppendUInt32(SNAPSHOT_MAGIC, output);
+  AppendUInt16(SNAPSHOT_VERSION, output);
+  AppendUInt16(saved.size(), output);
+  vector<const Universe*>::const_iterator saved_iter = saved.begin();
+  for (; saved_iter != saved.end(); ++saved_iter) {
+    const DmxBuffer &buffer = (*saved_iter)->GetDMX();
+    AppendUInt32((*saved_iter)->UniverseId(), output);
+    AppendUInt16(buffer.Size(), output);
+    output->append(reinterpret_cast<const char*>(buffer.GetRaw()),
+                   buffer.Size());
+  }
+}
+
+bool DmxSnapshot::Decode(const string &input, FrameMap *frames) {
+  unsigned int offset = 0;
+  uint32_t magic;
+  uint16_t version, count;
+  if (!ExtractUInt32(input, &offset, &magic) || magic != SNAPSHOT_MAGIC ||
+      !ExtractUInt16(input, &offset, &version) ||
+      version != SNAPSHOT_VERSION ||
+      !ExtractUInt16(input, &offset, &count)) {
+    return false;
+  }
+
+  frames->clear();
+  for (unsigned int i = 0; i < count; i++) {
+    uint32_t universe_id;
+    uint16_t length;
+    if (!ExtractUInt32(input, &offset, &universe_id) ||
+        !ExtractUInt16(input, &offset, &length) ||
+        length == 0 || length > DMX_UNIVERSE_SIZE ||
+        input.size() - offset < length) {
+      frames->clear();
+      return false;
+    }
+    (*frames)[universe_id].Set(
+        reinterpret_cast<const uint8_t*>(input.data() + offset), length);
+    offset += length;
+  }
+  return offset == input.size();
+}
+}  // namespace ola
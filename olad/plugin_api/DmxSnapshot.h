@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxSnapshot.h
+ * Saves the last DMX data for each universe, so it can be restored on start.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_DMXSNAPSHOT_H_
+#define OLAD_PLUGIN_API_DMXSNAPSHOT_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/ExecutorThread.h"
+
+namespace ola {
+
+class Universe;
+
+/**
+ * @brief Saves the last DMX data for each universe to a file, so the
+ *   outputs can be restored as soon as olad starts.
+ *
+ * The universe names, merge modes, port patchings and RDM UIDs are already
+ * kept in the preferences. What's lost on a restart is the data itself, so
+ * the outputs stay dark until every source has sent again.
+ *
+ * Save() is called periodically; it encodes the data in the calling thread
+ * and, if it changed since the last save, hands the file write to a writer
+ * thread. The file is replaced atomically so a crash mid-write leaves the
+ * previous snapshot intact.
+ *
+ * On start, Load() reads the snapshot and the UniverseStore calls Restore()
+ * when each universe is created. The restored data is written to each output
+ * port as it's patched, and is replaced by the first live update.
+ *
+ * The file is a sequence of network byte order fields:
+ * @code
+ *   uint32 magic, uint16 version, uint16 universe count,
+ *   then for each universe: uint32 id, uint16 length, length bytes of data.
+ * @endcode
+ */
+class DmxSnapshot {
+ public:
+  typedef std::map<unsigned int, DmxBuffer> FrameMap;
+
+  /**
+   * @brief Create a new DmxSnapshot.
+   * @param filename the file to save the snapshot to, and load it from.
+   */
+  explicit DmxSnapshot(const std::string &filename);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  ~DmxSnapshot();
+
+  /**
+   * @brief Start the writer thread.
+   * @returns true if the thread started.
+   */
+  bool Start();
+
+  /**
+   * @brief Write any pending snapshot and stop the writer thread.
+   */
+  void Stop();
+
+  /**
+   * @brief Load the snapshot from the file.
+   * @returns true if the snapshot was loaded, false if the file doesn't exist
+   *   or is invalid.
+   */
+  bool Load();
+
+  /**
+   * @brief Restore the data saved for a universe.
+   * @param universe the universe to restore.
+   * @returns true if there was data for the universe.
+   *
+   * The data is only restored once, a universe that's deleted and created
+   * again starts empty.
+   */
+  bool Restore(Universe *universe);
+
+  /**
+   * @brief Save the data for a set of universes.
+   * @param universes the universes to save.
+   *
+   * The file is only written if the data changed since the last save.
+   */
+  void Save(const std::vector<Universe*> &universes);
+
+  /**
+   * @brief Block until the writer thread has written the last snapshot.
+   */
+  void Flush();
+
+  /**
+   * @brief The number of universes loaded which haven't been restored yet.
+   */
+  unsigned int PendingRestores() const { return m_frames.size(); }
+
+  /**
+   * @brief Encode the data for a set of universes.
+   * @param universes the universes to encode, those without data are skipped.
+   * @param[out] output the encoded snapshot.
+   */
+  static void Encode(const std::vector<Universe*> &universes,
+                     std::string *output);
+
+  /**
+   * @brief Decode a snapshot.
+   * @param input the encoded snapshot.
+   * @param[out] frames the data for each universe.
+   * @returns true if the snapshot was valid.
+   */
+  static bool Decode(const std::string &input, FrameMap *frames);
+
+ private:
+  const std::string m_filename;
+  ola::thread::ExecutorThread m_writer;
+  FrameMap m_frames;
+  std::string m_last_saved;
+
+  DISALLOW_COPY_AND_ASSIGN(DmxSnapshot);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_DMXSNAPSHOT_H_
@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxSnapshotTest.cpp
+ * Test fixture for the DmxSnapshot class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/DmxSnapshot.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::DmxBuffer;
+using ola::DmxSnapshot;
+using ola::Universe;
+using ola::UniverseStore;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+class DmxSnapshotTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxSnapshotTest);
+  CPPUNIT_TEST(testEncodeDecode);
+  CPPUNIT_TEST(testInvalid);
+  CPPUNIT_TEST(testSaveAndRestore);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testEncodeDecode();
+  void testInvalid();
+  void testSaveAndRestore();
+
+ private:
+  string m_filename;
+  auto_ptr<UniverseStore> m_store;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxSnapshotTest);
+
+void DmxSnapshotTest::setUp() {
+  m_filename = TEST_BUILD_DIR "/olad/ola-dmx-snapshot.bin";
+  unlink(m_filename.c_str());
+  m_store.reset(new UniverseStore(NULL, NULL));
+}
+
+void DmxSnapshotTest::tearDown() {
+  m_store.reset();
+  unlink(m_filename.c_str());
+}
+
+/*
+ * Check universes with data are encoded, and decode to the same data.
+ */
+void DmxSnapshotTest::testEncodeDecode() {
+  Universe *universe1 = m_store->GetUniverseOrCreate(1);
+  Universe *universe2 = m_store->GetUniverseOrCreate(2);
+  m_store->GetUniverseOrCreate(3);
+  OLA_ASSERT_TRUE(universe1->SetDMX(DmxBuffer("abc")));
+  DmxBuffer full;
+  full.SetRangeToValue(0, 255, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(universe2->SetDMX(full));
+
+  vector<Universe*> universes;
+  m_store->GetList(&universes);
+  string encoded;
+  DmxSnapshot::Encode(universes, &encoded);
+
+  DmxSnapshot::FrameMap frames;
+  OLA_ASSERT_TRUE(DmxSnapshot::Decode(encoded, &frames));
+  // Universe 3 has no data
+  OLA_ASSERT_EQ(static_cast<size_t>(2), frames.size());
+  OLA_ASSERT_EQ(DmxBuffer("abc"), frames[1]);
+  OLA_ASSERT_EQ(full, frames[2]);
+}
+
+/*
+ * Check invalid snapshots are rejected.
+ */
+void DmxSnapshotTest::testInvalid() {
+  DmxSnapshot::FrameMap frames;
+  OLA_ASSERT_FALSE(DmxSnapshot::Decode("", &frames));
+  OLA_ASSERT_FALSE(DmxSnapshot::Decode("junk", &frames));
+
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  OLA_ASSERT_TRUE(universe->SetDMX(DmxBuffer("abc")));
+  vector<Universe*> universes;
+  m_store->GetList(&universes);
+  string encoded;
+  DmxSnapshot::Encode(universes, &encoded);
+
+  // truncated
+  OLA_ASSERT_FALSE(DmxSnapshot::Decode(
+      encoded.substr(0, encoded.size() - 1), &frames));
+  OLA_ASSERT_TRUE(frames.empty());
+  // trailing data
+  OLA_ASSERT_FALSE(DmxSnapshot::Decode(encoded + "x", &frames));
+  // wrong version
+  string bad_version = encoded;
+  bad_version[5] = 2;
+  OLA_ASSERT_FALSE(DmxSnapshot::Decode(bad_version, &frames));
+}
+
+/*
+ * Check a saved snapshot is restored to new universes, and written to the
+ * ports as they're patched.
+ */
+void DmxSnapshotTest::testSaveAndRestore() {
+  {
+    DmxSnapshot snapshot(m_filename);
+    OLA_ASSERT_FALSE(snapshot.Load());
+    OLA_ASSERT_TRUE(snapshot.Start());
+    Universe *universe = m_store->GetUniverseOrCreate(1);
+    OLA_ASSERT_TRUE(universe->SetDMX(DmxBuffer("abc")));
+    vector<Universe*> universes;
+    m_store->GetList(&universes);
+    snapshot.Save(universes);
+    snapshot.Flush();
+    OLA_ASSERT_EQ(-1, access((m_filename + ".new").c_str(), F_OK));
+  }
+
+  // Restart
+  m_store.reset(new UniverseStore(NULL, NULL));
+  DmxSnapshot snapshot(m_filename);
+  OLA_ASSERT_TRUE(snapshot.Load());
+  OLA_ASSERT_EQ(1u, snapshot.PendingRestores());
+  m_store->SetDmxSnapshot(&snapshot);
+
+  Universe *universe = m_store->GetUniverseOrCreate(1);
+  OLA_ASSERT_EQ(DmxBuffer("abc"), universe->GetDMX());
+  OLA_ASSERT_EQ(0u, snapshot.PendingRestores());
+  OLA_ASSERT_EQ(0u, m_store->GetUniverseOrCreate(2)->GetDMX().Size());
+
+  // The restored data is written to the ports as they're added.
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  OLA_ASSERT_EQ(DmxBuffer("abc"), port.ReadDMX());
+
+  // And replaced by live data
+  OLA_ASSERT_TRUE(universe->SetDMX(DmxBuffer("xyz")));
+  OLA_ASSERT_EQ(DmxBuffer("xyz"), port.ReadDMX());
+  universe->RemovePort(&port);
+}
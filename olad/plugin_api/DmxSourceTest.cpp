@@ -76,6 +76,20 @@ void DmxSourceTest::testDmxSource() {
   OLA_ASSERT(buffer2 == source.Data());
   OLA_ASSERT_EQ(timestamp2, source.Timestamp());
   OLA_ASSERT_EQ((uint8_t) 120, source.Priority());
+  OLA_ASSERT_FALSE(source.HasSlotPriorities());
+
+  // per-slot priorities
+  DmxBuffer slot_priorities("abcdefghi");
+  source.UpdateData(buffer, timestamp2, 120, slot_priorities);
+  OLA_ASSERT(source.HasSlotPriorities());
+  OLA_ASSERT(slot_priorities == source.SlotPriorities());
+  DmxSource copy(source);
+  OLA_ASSERT(copy == source);
+
+  // and a regular update clears them
+  source.UpdateData(buffer2, timestamp2, 120);
+  OLA_ASSERT_FALSE(source.HasSlotPriorities());
+  OLA_ASSERT_FALSE(copy == source);
 
   DmxSource empty_source;
   OLA_ASSERT_FALSE(empty_source.IsSet());
@@ -0,0 +1,50 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * FrameRecorderInterface.h
+ * The interface for recording the frames sent by universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_FRAMERECORDERINTERFACE_H_
+#define OLAD_PLUGIN_API_FRAMERECORDERINTERFACE_H_
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+
+namespace ola {
+
+/**
+ * @brief Records the frames universes send to their outputs.
+ *
+ * RecordFrame() is called from the universe's thread for every frame written
+ * to the ports and sink clients, so it needs to return quickly.
+ */
+class FrameRecorderInterface {
+ public:
+  virtual ~FrameRecorderInterface() {}
+
+  /**
+   * @brief Record a frame.
+   * @param universe_id the universe the frame was sent on.
+   * @param time the time the frame was sent.
+   * @param data the DMX data.
+   */
+  virtual void RecordFrame(unsigned int universe_id,
+                           const TimeStamp &time,
+                           const DmxBuffer &data) = 0;
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_FRAMERECORDERINTERFACE_H_
@@ -0,0 +1,610 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IndexedPreferences.cpp
+ * Preferences kept in a single indexed, append only store.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/file/Util.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/plugin_api/IndexedPreferences.h"
+
+namespace ola {
+
+using std::string;
+using std::vector;
+
+namespace {
+const char SET_RECORD = 'S';
+const char ADD_RECORD = 'A';
+const char REMOVE_RECORD = 'R';
+const char CLEAR_RECORD = 'C';
+
+bool WriteAll(int fd, const string &data) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    ssize_t r = write(fd, data.data() + offset, data.size() - offset);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    offset += r;
+  }
+  return true;
+}
+}  // namespace
+
+const char IndexedPreferencesFactory::STORE_FILE_NAME[] =
+    "ola-preferences.log";
+
+// IndexedPreferenceStore
+//-----------------------------------------------------------------------------
+
+IndexedPreferenceStore::IndexedPreferenceStore(const string &filename)
+    : m_filename(filename),
+      m_log_records(0),
+      m_live_values(0),
+      m_fd(-1) {
+}
+
+
+IndexedPreferenceStore::~IndexedPreferenceStore() {
+  Sync();
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+  STLDeleteValues(&m_namespaces);
+}
+
+
+bool IndexedPreferenceStore::Open() {
+  int fd = open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      OLA_INFO << "Missing " << m_filename << ", it will be created";
+      return true;
+    }
+    OLA_WARN << "Could not open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  string contents;
+  char buffer[65536];
+  while (true) {
+    ssize_t r = read(fd, buffer, sizeof(buffer));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to read " << m_filename << ": " << strerror(errno);
+      close(fd);
+      return false;
+    }
+    if (r == 0) {
+      break;
+    }
+    contents.append(buffer, r);
+  }
+  close(fd);
+
+  // Anything after the last newline is a partial record.
+  size_t start = 0;
+  size_t end;
+  while ((end = contents.find('\n', start)) != string::npos) {
+    if (!ReplayLine(contents.substr(start, end - start))) {
+      OLA_INFO << "Skipping record: " << contents.substr(start, end - start);
+    }
+    start = end + 1;
+  }
+  if (start != contents.size()) {
+    // Remove it, so the next record is appended on a line of its own.
+    OLA_WARN << "Removing partial record at the end of " << m_filename;
+    if (truncate(m_filename.c_str(), start)) {
+      OLA_WARN << "Failed to truncate " << m_filename << ": "
+               << strerror(errno);
+      return false;
+    }
+  }
+  OLA_INFO << "Loaded " << m_live_values << " preferences from "
+           << m_log_records << " records in " << m_filename;
+  return true;
+}
+
+
+bool IndexedPreferenceStore::Sync() {
+  if (m_pending.empty()) {
+    return true;
+  }
+
+  if (m_log_records >= MIN_COMPACTION_RECORDS &&
+      m_log_records > COMPACTION_RATIO * m_live_values) {
+    return Compact();
+  }
+
+  if (!OpenForAppend()) {
+    return false;
+  }
+  if (!WriteAll(m_fd, m_pending)) {
+    OLA_WARN << "Failed to write " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  m_pending.clear();
+  return true;
+}
+
+
+/*
+ * The snapshot starts each set of preferences with a clear record, so it has
+ * the same result when it's appended to the old log. That's how it's retried
+ * if the rename fails.
+ */
+bool IndexedPreferenceStore::Compact() {
+  const unsigned int old_records = m_log_records;
+  m_pending.clear();
+  m_log_records = 0;
+  NamespaceMap::const_iterator ns_iter = m_namespaces.begin();
+  for (; ns_iter != m_namespaces.end(); ++ns_iter) {
+    if (!STLContains(m_known, ns_iter->first)) {
+      continue;
+    }
+    AppendRecord(CLEAR_RECORD, ns_iter->first, "", NULL);
+    ValueMap::const_iterator iter = ns_iter->second->begin();
+    for (; iter != ns_iter->second->end(); ++iter) {
+      vector<string>::const_iterator value = iter->second.begin();
+      for (; value != iter->second.end(); ++value) {
+        AppendRecord(ADD_RECORD, ns_iter->first, iter->first, &(*value));
+      }
+    }
+  }
+  const unsigned int records = m_log_records;
+
+  const string temp_filename = m_filename + ".new";
+  int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  bool ok = fd >= 0;
+  if (!ok) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
+  } else {
+    ok = WriteAll(fd, m_pending);
+    if (!ok) {
+      OLA_WARN << "Failed to write " << temp_filename << ": "
+               << strerror(errno);
+    } else if (fsync(fd)) {
+      OLA_WARN << "Failed to sync " << temp_filename << ": "
+               << strerror(errno);
+    }
+    close(fd);
+  }
+
+  if (ok && rename(temp_filename.c_str(), m_filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << " to " << m_filename
+             << ": " << strerror(errno);
+    ok = false;
+  }
+
+  if (!ok) {
+    unlink(temp_filename.c_str());
+    m_log_records += old_records;
+    return false;
+  }
+
+  // The old descriptor refers to the file we just replaced.
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+  m_pending.clear();
+  OLA_INFO << "Compacted " << m_filename << " from " << old_records << " to "
+           << records << " records";
+  return true;
+}
+
+
+IndexedPreferenceStore::ValueMap *IndexedPreferenceStore::Values(
+    const string &name) {
+  ValueMap *values = STLFindOrNull(m_namespaces, name);
+  if (!values) {
+    values = new ValueMap();
+    m_namespaces[name] = values;
+  }
+  return values;
+}
+
+
+bool IndexedPreferenceStore::Contains(const string &name) const {
+  return STLContains(m_known, name);
+}
+
+
+void IndexedPreferenceStore::Set(const string &name, const string &key,
+                                 const string &value) {
+  Apply(SET_RECORD, name, key, value);
+  AppendRecord(SET_RECORD, name, key, &value);
+}
+
+
+void IndexedPreferenceStore::Add(const string &name, const string &key,
+                                 const string &value) {
+  Apply(ADD_RECORD, name, key, value);
+  AppendRecord(ADD_RECORD, name, key, &value);
+}
+
+
+void IndexedPreferenceStore::Remove(const string &name, const string &key) {
+  Apply(REMOVE_RECORD, name, key, "");
+  AppendRecord(REMOVE_RECORD, name, key, NULL);
+}
+
+
+void IndexedPreferenceStore::Clear(const string &name) {
+  Apply(CLEAR_RECORD, name, "", "");
+  AppendRecord(CLEAR_RECORD, name, "", NULL);
+}
+
+
+void IndexedPreferenceStore::AppendRecord(char op, const string &name,
+                                          const string &key,
+                                          const string *value) {
+  m_pending.push_back(op);
+  m_pending.push_back('\t');
+  AppendField(name, &m_pending);
+  if (op != CLEAR_RECORD) {
+    m_pending.push_back('\t');
+    AppendField(key, &m_pending);
+  }
+  if (value) {
+    m_pending.push_back('\t');
+    AppendField(*value, &m_pending);
+  }
+  m_pending.push_back('\n');
+  m_log_records++;
+}
+
+
+/*
+ * Update the values, and the count of live values.
+ */
+void IndexedPreferenceStore::Apply(char op, const string &name,
+                                   const string &key, const string &value) {
+  m_known.insert(name);
+  ValueMap *values = Values(name);
+  switch (op) {
+    case SET_RECORD:
+      {
+        vector<string> &entry = (*values)[key];
+        m_live_values -= static_cast<unsigned int>(entry.size());
+        entry.assign(1, value);
+        m_live_values++;
+      }
+      break;
+    case ADD_RECORD:
+      (*values)[key].push_back(value);
+      m_live_values++;
+      break;
+    case REMOVE_RECORD:
+      {
+        ValueMap::iterator iter = values->find(key);
+        if (iter != values->end()) {
+          m_live_values -= static_cast<unsigned int>(iter->second.size());
+          values->erase(iter);
+        }
+      }
+      break;
+    case CLEAR_RECORD:
+      {
+        ValueMap::const_iterator iter = values->begin();
+        for (; iter != values->end(); ++iter) {
+          m_live_values -= static_cast<unsigned int>(iter->second.size());
+        }
+        values->clear();
+      }
+      break;
+  }
+}
+
+
+bool IndexedPreferenceStore::ReplayLine(const string &line) {
+  vector<string> fields;
+  StringSplit(line, &fields, "\t");
+  if (fields.size() < 2 || fields[0].size() != 1) {
+    return false;
+  }
+
+  const char op = fields[0][0];
+  size_t expected_fields;
+  switch (op) {
+    case SET_RECORD:
+    case ADD_RECORD:
+      expected_fields = 4;
+      break;
+    case REMOVE_RECORD:
+      expected_fields = 3;
+      break;
+    case CLEAR_RECORD:
+      expected_fields = 2;
+      break;
+    default:
+      return false;
+  }
+  if (fields.size() != expected_fields) {
+    return false;
+  }
+
+  string name, key, value;
+  if (!UnescapeField(fields[1], &name) ||
+      (expected_fields > 2 && !UnescapeField(fields[2], &key)) ||
+      (expected_fields > 3 && !UnescapeField(fields[3], &value))) {
+    return false;
+  }
+  Apply(op, name, key, value);
+  m_log_records++;
+  return true;
+}
+
+
+bool IndexedPreferenceStore::OpenForAppend() {
+  if (m_fd >= 0) {
+    return true;
+  }
+  m_fd = open(m_filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+  if (m_fd < 0) {
+    OLA_WARN << "Could not open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+
+void IndexedPreferenceStore::AppendField(const string &field,
+                                         string *output) {
+  string::const_iterator iter = field.begin();
+  for (; iter != field.end(); ++iter) {
+    switch (*iter) {
+      case '\\':
+        output->append("\\\\");
+        break;
+      case '\t':
+        output->append("\\t");
+        break;
+      case '\n':
+        output->append("\\n");
+        break;
+      default:
+        output->push_back(*iter);
+    }
+  }
+}
+
+
+bool IndexedPreferenceStore::UnescapeField(const string &field,
+                                           string *output) {
+  output->clear();
+  output->reserve(field.size());
+  for (size_t i = 0; i < field.size(); i++) {
+    if (field[i] != '\\') {
+      output->push_back(field[i]);
+      continue;
+    }
+    if (++i == field.size()) {
+      return false;
+    }
+    switch (field[i]) {
+      case '\\':
+        output->push_back('\\');
+        break;
+      case 't':
+        output->push_back('\t');
+        break;
+      case 'n':
+        output->push_back('\n');
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+
+// IndexedPreferences
+//-----------------------------------------------------------------------------
+
+IndexedPreferences::IndexedPreferences(IndexedPreferenceStore *store,
+                                       const string &name,
+                                       const string &import_directory)
+    : Preferences(name),
+      m_store(store),
+      m_import_directory(import_directory),
+      m_values(store->Values(name)) {
+}
+
+
+/*
+ * The store was read when it was opened, so this only imports the old
+ * ola-<name>.conf file the first time these preferences are used.
+ */
+bool IndexedPreferences::Load() {
+  if (m_store->Contains(m_preference_name)) {
+    return true;
+  }
+  if (m_import_directory.empty()) {
+    return false;
+  }
+
+  FilePreferenceSaverThread::PreferencesMap pref_map;
+  const string filename = FileBackedPreferences::FileName(m_import_directory,
+                                                          m_preference_name);
+  if (!FileBackedPreferences::ParseFile(filename, &pref_map)) {
+    return false;
+  }
+
+  OLA_INFO << "Importing " << pref_map.size() << " preferences from "
+           << filename;
+  m_store->Clear(m_preference_name);
+  FilePreferenceSaverThread::PreferencesMap::const_iterator iter;
+  for (iter = pref_map.begin(); iter != pref_map.end(); ++iter) {
+    m_store->Add(m_preference_name, iter->first, iter->second);
+  }
+  return true;
+}
+
+
+bool IndexedPreferences::Save() const {
+  return m_store->Sync();
+}
+
+
+void IndexedPreferences::Clear() {
+  m_store->Clear(m_preference_name);
+}
+
+
+void IndexedPreferences::SetValue(const string &key, const string &value) {
+  m_store->Set(m_preference_name, key, value);
+}
+
+
+void IndexedPreferences::SetValue(const string &key, unsigned int value) {
+  SetValue(key, IntToString(value));
+}
+
+
+void IndexedPreferences::SetValue(const string &key, int value) {
+  SetValue(key, IntToString(value));
+}
+
+
+void IndexedPreferences::SetMultipleValue(const string &key,
+                                          const string &value) {
+  m_store->Add(m_preference_name, key, value);
+}
+
+
+void IndexedPreferences::SetMultipleValue(const string &key,
+                                          unsigned int value) {
+  SetMultipleValue(key, IntToString(value));
+}
+
+
+void IndexedPreferences::SetMultipleValue(const string &key, int value) {
+  SetMultipleValue(key, IntToString(value));
+}
+
+
+bool IndexedPreferences::SetDefaultValue(const string &key,
+                                         const Validator &validator,
+                                         const string &value) {
+  IndexedPreferenceStore::ValueMap::const_iterator iter = m_values->find(key);
+  if (iter == m_values->end() || iter->second.empty() ||
+      !validator.IsValid(iter->second.front())) {
+    SetValue(key, value);
+    return true;
+  }
+  return false;
+}
+
+
+bool IndexedPreferences::SetDefaultValue(const string &key,
+                                         const Validator &validator,
+                                         const char value[]) {
+  return SetDefaultValue(key, validator, string(value));
+}
+
+
+bool IndexedPreferences::SetDefaultValue(const string &key,
+                                         const Validator &validator,
+                                         unsigned int value) {
+  return SetDefaultValue(key, validator, IntToString(value));
+}
+
+
+bool IndexedPreferences::SetDefaultValue(const string &key,
+                                         const Validator &validator,
+                                         int value) {
+  return SetDefaultValue(key, validator, IntToString(value));
+}
+
+
+bool IndexedPreferences::SetDefaultValue(const string &key,
+                                         const Validator &validator,
+                                         bool value) {
+  return SetDefaultValue(
+      key,
+      validator,
+      value ? BoolValidator::ENABLED : BoolValidator::DISABLED);
+}
+
+
+string IndexedPreferences::GetValue(const string &key) const {
+  IndexedPreferenceStore::ValueMap::const_iterator iter = m_values->find(key);
+  if (iter != m_values->end() && !iter->second.empty()) {
+    return iter->second.front();
+  }
+  return "";
+}
+
+
+vector<string> IndexedPreferences::GetMultipleValue(const string &key) const {
+  IndexedPreferenceStore::ValueMap::const_iterator iter = m_values->find(key);
+  if (iter != m_values->end()) {
+    return iter->second;
+  }
+  return vector<string>();
+}
+
+
+bool IndexedPreferences::HasKey(const string &key) const {
+  return STLContains(*m_values, key);
+}
+
+
+void IndexedPreferences::RemoveValue(const string &key) {
+  m_store->Remove(m_preference_name, key);
+}
+
+
+bool IndexedPreferences::GetValueAsBool(const string &key) const {
+  return GetValue(key) == BoolValidator::ENABLED;
+}
+
+
+void IndexedPreferences::SetValueAsBool(const string &key, bool value) {
+  SetValue(key, value ? BoolValidator::ENABLED : BoolValidator::DISABLED);
+}
+
+
+// IndexedPreferencesFactory
+//-----------------------------------------------------------------------------
+
+IndexedPreferencesFactory::IndexedPreferencesFactory(const string &directory)
+    : m_directory(directory),
+      m_store(directory + ola::file::PATH_SEPARATOR + STORE_FILE_NAME) {
+  m_store.Open();
+}
+}  // namespace ola
@@ -0,0 +1,265 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IndexedPreferences.h
+ * Preferences kept in a single indexed, append only store.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_INDEXEDPREFERENCES_H_
+#define OLAD_PLUGIN_API_INDEXEDPREFERENCES_H_
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include HASH_MAP_H
+
+#include "ola/base/Macro.h"
+#include "olad/Preferences.h"
+
+#ifndef HAVE_UNORDERED_MAP
+// This adds support for hashing strings if it's not present
+namespace HASH_NAMESPACE {
+
+template<> struct hash<std::string> {
+  size_t operator()(const std::string& x) const {
+    return hash<const char*>()(x.c_str());
+  }
+};
+}  // namespace HASH_NAMESPACE
+#endif  // HAVE_UNORDERED_MAP
+
+namespace ola {
+
+/**
+ * @brief The values for every set of preferences, in one file.
+ *
+ * The file is a log of changes, one per line. It's read once when the store
+ * is opened and replayed into a hash map for each set of preferences, so
+ * startup is a single read and lookups don't depend on the number of keys.
+ * Changes are buffered and appended to the file by Sync(). Once the log
+ * holds more than COMPACTION_RATIO records for each live value, Sync()
+ * rewrites it with only the live values, using a temporary file which is
+ * renamed over the original.
+ *
+ * Each record is tab separated, with tabs, newlines and backslashes escaped:
+ *   S <name> <key> <value>   set the only value of a key
+ *   A <name> <key> <value>   add a value to a key
+ *   R <name> <key>           remove a key
+ *   C <name>                 remove all the keys
+ * A partial record at the end of the file, from a crash during a write, is
+ * removed when the store is opened.
+ */
+class IndexedPreferenceStore {
+ public:
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<std::string,
+                                         std::vector<std::string> > ValueMap;
+
+  /**
+   * @brief Create a new store.
+   * @param filename the file to use.
+   */
+  explicit IndexedPreferenceStore(const std::string &filename);
+
+  /**
+   * @brief Destructor, this calls Sync().
+   *
+   * Sync() writes the changes to every set of preferences, so this also
+   * writes changes which IndexedPreferences::Save() wasn't called for.
+   */
+  ~IndexedPreferenceStore();
+
+  /**
+   * @brief Read the file.
+   * @returns false if the file exists but couldn't be read.
+   */
+  bool Open();
+
+  /**
+   * @brief Write the buffered changes to the file, compacting it if needed.
+   * @returns true if the changes were written.
+   */
+  bool Sync();
+
+  /**
+   * @brief Rewrite the file with only the live values.
+   */
+  bool Compact();
+
+  /**
+   * @brief Get the values for a set of preferences.
+   * @param name the name of the preferences.
+   * @returns the values, the map remains valid for the life of the store.
+   */
+  ValueMap *Values(const std::string &name);
+
+  /**
+   * @brief Check if a set of preferences has any records in the store.
+   */
+  bool Contains(const std::string &name) const;
+
+  void Set(const std::string &name, const std::string &key,
+           const std::string &value);
+  void Add(const std::string &name, const std::string &key,
+           const std::string &value);
+  void Remove(const std::string &name, const std::string &key);
+  void Clear(const std::string &name);
+
+  const std::string &FileName() const { return m_filename; }
+
+  /**
+   * @brief The number of records in the file, including those not yet
+   *   written.
+   */
+  unsigned int LogRecords() const { return m_log_records; }
+
+  /**
+   * @brief The number of values in the store.
+   */
+  unsigned int LiveValues() const { return m_live_values; }
+
+  /**
+   * @brief The log isn't compacted until it has at least this many records.
+   */
+  static const unsigned int MIN_COMPACTION_RECORDS = 1024;
+
+  /**
+   * @brief The number of records for each live value that triggers a
+   *   compaction.
+   */
+  static const unsigned int COMPACTION_RATIO = 2;
+
+ private:
+  typedef std::map<std::string, ValueMap*> NamespaceMap;
+
+  const std::string m_filename;
+  NamespaceMap m_namespaces;
+  std::set<std::string> m_known;  // the names with records in the log
+  std::string m_pending;  // records not yet written
+  unsigned int m_log_records;  // including those in m_pending
+  unsigned int m_live_values;
+  int m_fd;
+
+  void AppendRecord(char op, const std::string &name, const std::string &key,
+                    const std::string *value);
+  void Apply(char op, const std::string &name, const std::string &key,
+             const std::string &value);
+  bool ReplayLine(const std::string &line);
+  bool OpenForAppend();
+
+  static void AppendField(const std::string &field, std::string *output);
+  static bool UnescapeField(const std::string &field, std::string *output);
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedPreferenceStore);
+};
+
+
+/**
+ * @brief Preferences backed by an IndexedPreferenceStore.
+ *
+ * Changes are visible immediately and written to the store by Save().
+ */
+class IndexedPreferences: public Preferences {
+ public:
+  /**
+   * @brief Create new preferences.
+   * @param store the store to use, ownership is not transferred.
+   * @param name the name of the preferences.
+   * @param import_directory if the store has no records for these
+   *   preferences, Load() imports them from the ola-<name>.conf file in this
+   *   directory. May be empty.
+   */
+  IndexedPreferences(IndexedPreferenceStore *store,
+                     const std::string &name,
+                     const std::string &import_directory = "");
+
+  bool Load();
+  bool Save() const;
+  void Clear();
+
+  std::string ConfigLocation() const { return m_store->FileName(); }
+
+  void SetValue(const std::string &key, const std::string &value);
+  void SetValue(const std::string &key, unsigned int value);
+  void SetValue(const std::string &key, int value);
+  void SetMultipleValue(const std::string &key, const std::string &value);
+  void SetMultipleValue(const std::string &key, unsigned int value);
+  void SetMultipleValue(const std::string &key, int value);
+  bool SetDefaultValue(const std::string &key,
+                       const Validator &validator,
+                       const std::string &value);
+  bool SetDefaultValue(const std::string &key,
+                       const Validator &validator,
+                       const char value[]);
+  bool SetDefaultValue(const std::string &key,
+                       const Validator &validator,
+                       unsigned int value);
+  bool SetDefaultValue(const std::string &key,
+                       const Validator &validator,
+                       int value);
+  bool SetDefaultValue(const std::string &key,
+                       const Validator &validator,
+                       bool value);
+
+  std::string GetValue(const std::string &key) const;
+  std::vector<std::string> GetMultipleValue(const std::string &key) const;
+  bool HasKey(const std::string &key) const;
+
+  void RemoveValue(const std::string &key);
+
+  bool GetValueAsBool(const std::string &key) const;
+  void SetValueAsBool(const std::string &key, bool value);
+
+ private:
+  IndexedPreferenceStore *m_store;
+  const std::string m_import_directory;
+  IndexedPreferenceStore::ValueMap *m_values;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexedPreferences);
+};
+
+
+/**
+ * @brief Creates IndexedPreferences which share a single store.
+ */
+class IndexedPreferencesFactory: public PreferencesFactory {
+ public:
+  /**
+   * @brief Create a new factory.
+   * @param directory the config directory. The store is kept in
+   *   STORE_FILE_NAME, and preferences which aren't in the store yet are
+   *   imported from the ola-<name>.conf files.
+   */
+  explicit IndexedPreferencesFactory(const std::string &directory);
+
+  std::string ConfigLocation() const { return m_directory; }
+
+  static const char STORE_FILE_NAME[];
+
+ private:
+  const std::string m_directory;
+  IndexedPreferenceStore m_store;
+
+  Preferences *Create(const std::string &name) {
+    return new IndexedPreferences(&m_store, name, m_directory);
+  }
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_INDEXEDPREFERENCES_H_
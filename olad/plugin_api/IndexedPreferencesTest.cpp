@@ -0,0 +1,277 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * IndexedPreferencesTest.cpp
+ * Test fixture for the IndexedPreferences classes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/IndexedPreferences.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::BoolValidator;
+using ola::IndexedPreferenceStore;
+using ola::IndexedPreferences;
+using ola::UIntValidator;
+using std::string;
+using std::vector;
+
+
+class IndexedPreferencesTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(IndexedPreferencesTest);
+  CPPUNIT_TEST(testGetSetRemove);
+  CPPUNIT_TEST(testPersistence);
+  CPPUNIT_TEST(testPartialRecord);
+  CPPUNIT_TEST(testCompaction);
+  CPPUNIT_TEST(testImport);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      ola::InitLogging(ola::OLA_LOG_DEBUG, ola::OLA_LOG_STDERR);
+      unlink(STORE_FILE);
+    }
+    void tearDown() {
+      unlink(STORE_FILE);
+    }
+    void testGetSetRemove();
+    void testPersistence();
+    void testPartialRecord();
+    void testCompaction();
+    void testImport();
+
+ private:
+    static const char STORE_FILE[];
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IndexedPreferencesTest);
+
+const char IndexedPreferencesTest::STORE_FILE[] =
+    TEST_BUILD_DIR "/olad/ola-indexed-test.log";
+
+
+/*
+ * Check that we can get/set the preferences
+ */
+void IndexedPreferencesTest::testGetSetRemove() {
+  IndexedPreferenceStore store(STORE_FILE);
+  OLA_ASSERT(store.Open());
+  IndexedPreferences preferences(&store, "dummy");
+
+  OLA_ASSERT_FALSE(preferences.HasKey("foo"));
+  OLA_ASSERT_EQ(string(""), preferences.GetValue("foo"));
+  OLA_ASSERT(preferences.GetMultipleValue("foo").empty());
+
+  preferences.SetValue("foo", "bar");
+  preferences.SetValue("foo", "baz");
+  OLA_ASSERT(preferences.HasKey("foo"));
+  OLA_ASSERT_EQ(string("baz"), preferences.GetValue("foo"));
+  OLA_ASSERT_EQ(static_cast<size_t>(1),
+                preferences.GetMultipleValue("foo").size());
+
+  preferences.SetMultipleValue("multi", "1");
+  preferences.SetMultipleValue("multi", 2u);
+  preferences.SetMultipleValue("multi", -3);
+  vector<string> values = preferences.GetMultipleValue("multi");
+  OLA_ASSERT_EQ(static_cast<size_t>(3), values.size());
+  OLA_ASSERT_EQ(string("1"), values[0]);
+  OLA_ASSERT_EQ(string("2"), values[1]);
+  OLA_ASSERT_EQ(string("-3"), values[2]);
+  OLA_ASSERT_EQ(string("1"), preferences.GetValue("multi"));
+
+  preferences.RemoveValue("multi");
+  OLA_ASSERT_FALSE(preferences.HasKey("multi"));
+  OLA_ASSERT_EQ(1u, store.LiveValues());
+
+  // Defaults only replace missing or invalid values.
+  OLA_ASSERT(preferences.SetDefaultValue("port", UIntValidator(1, 10), 5u));
+  OLA_ASSERT_FALSE(preferences.SetDefaultValue("port", UIntValidator(1, 10),
+                                               6u));
+  OLA_ASSERT_EQ(string("5"), preferences.GetValue("port"));
+  OLA_ASSERT(preferences.SetDefaultValue("foo", BoolValidator(), true));
+  OLA_ASSERT(preferences.GetValueAsBool("foo"));
+  preferences.SetValueAsBool("foo", false);
+  OLA_ASSERT_FALSE(preferences.GetValueAsBool("foo"));
+
+  // Another set of preferences in the same store is independent.
+  IndexedPreferences other(&store, "other");
+  OLA_ASSERT_FALSE(other.HasKey("foo"));
+  other.SetValue("foo", "other");
+  OLA_ASSERT_EQ(string("false"), preferences.GetValue("foo"));
+
+  preferences.Clear();
+  OLA_ASSERT_FALSE(preferences.HasKey("foo"));
+  OLA_ASSERT_FALSE(preferences.HasKey("port"));
+  OLA_ASSERT_EQ(string("other"), other.GetValue("foo"));
+  OLA_ASSERT_EQ(1u, store.LiveValues());
+}
+
+
+/*
+ * Check the values are written by Save() and read back.
+ */
+void IndexedPreferencesTest::testPersistence() {
+  const string awkward = "a\tb\\nc\nd";
+  {
+    IndexedPreferenceStore store(STORE_FILE);
+    OLA_ASSERT(store.Open());
+    IndexedPreferences preferences(&store, "output");
+    preferences.SetValue("foo", "bar");
+    preferences.SetValue("/dev/ttyUSB0", "boo");
+    preferences.SetValue("=key", "x = y");
+    preferences.SetValue("awkward", awkward);
+    preferences.SetMultipleValue("multi", "1");
+    preferences.SetMultipleValue("multi", "2");
+    preferences.SetValue("removed", "1");
+    OLA_ASSERT(preferences.Save());
+    preferences.RemoveValue("removed");
+    preferences.SetValue("foo", "baz");
+    OLA_ASSERT(preferences.Save());
+
+    IndexedPreferences empty(&store, "empty");
+    empty.Clear();
+    OLA_ASSERT(empty.Save());
+  }
+
+  IndexedPreferenceStore store(STORE_FILE);
+  OLA_ASSERT(store.Open());
+  OLA_ASSERT(store.Contains("output"));
+  OLA_ASSERT(store.Contains("empty"));
+  OLA_ASSERT_FALSE(store.Contains("missing"));
+  IndexedPreferences preferences(&store, "output");
+  OLA_ASSERT(preferences.Load());
+  OLA_ASSERT_EQ(string("baz"), preferences.GetValue("foo"));
+  OLA_ASSERT_EQ(string("boo"), preferences.GetValue("/dev/ttyUSB0"));
+  OLA_ASSERT_EQ(string("x = y"), preferences.GetValue("=key"));
+  OLA_ASSERT_EQ(awkward, preferences.GetValue("awkward"));
+  OLA_ASSERT_EQ(static_cast<size_t>(2),
+                preferences.GetMultipleValue("multi").size());
+  OLA_ASSERT_FALSE(preferences.HasKey("removed"));
+  OLA_ASSERT_EQ(6u, store.LiveValues());
+}
+
+
+/*
+ * Check that bad records are skipped and a partial record at the end of the
+ * file is removed.
+ */
+void IndexedPreferencesTest::testPartialRecord() {
+  {
+    std::ofstream file(STORE_FILE);
+    file << "S\tdummy\tfoo\tbar\n"
+         << "X\tdummy\tfoo\tbad op\n"
+         << "S\tdummy\tbad\\escape\tbar\n"
+         << "S\tdummy\tfoo\tpartial";
+  }
+
+  IndexedPreferenceStore store(STORE_FILE);
+  OLA_ASSERT(store.Open());
+  IndexedPreferences preferences(&store, "dummy");
+  OLA_ASSERT_EQ(string("bar"), preferences.GetValue("foo"));
+  OLA_ASSERT_EQ(1u, store.LogRecords());
+  OLA_ASSERT_EQ(1u, store.LiveValues());
+
+  // The partial record was removed, so the next one is on its own line.
+  preferences.SetValue("foo", "new");
+  OLA_ASSERT(preferences.Save());
+
+  IndexedPreferenceStore reopened_store(STORE_FILE);
+  OLA_ASSERT(reopened_store.Open());
+  IndexedPreferences reopened(&reopened_store, "dummy");
+  OLA_ASSERT_EQ(string("new"), reopened.GetValue("foo"));
+  OLA_ASSERT_EQ(2u, reopened_store.LogRecords());
+}
+
+
+/*
+ * Check the log is compacted once it's mostly overwritten records.
+ */
+void IndexedPreferencesTest::testCompaction() {
+  const unsigned int updates = IndexedPreferenceStore::MIN_COMPACTION_RECORDS;
+  {
+    IndexedPreferenceStore store(STORE_FILE);
+    OLA_ASSERT(store.Open());
+    IndexedPreferences preferences(&store, "dummy");
+    preferences.SetMultipleValue("multi", "1");
+    preferences.SetMultipleValue("multi", "2");
+    for (unsigned int i = 0; i < updates; i++) {
+      preferences.SetValue("foo", i);
+    }
+    OLA_ASSERT_EQ(updates + 2, store.LogRecords());
+    OLA_ASSERT(preferences.Save());
+
+    // One clear record and three values.
+    OLA_ASSERT_EQ(4u, store.LogRecords());
+
+    // Appends continue after a compaction.
+    preferences.SetValue("bar", "baz");
+    OLA_ASSERT(preferences.Save());
+    OLA_ASSERT_EQ(5u, store.LogRecords());
+  }
+
+  IndexedPreferenceStore store(STORE_FILE);
+  OLA_ASSERT(store.Open());
+  OLA_ASSERT_EQ(5u, store.LogRecords());
+  IndexedPreferences preferences(&store, "dummy");
+  OLA_ASSERT_EQ(ola::IntToString(updates - 1), preferences.GetValue("foo"));
+  OLA_ASSERT_EQ(string("baz"), preferences.GetValue("bar"));
+  OLA_ASSERT_EQ(static_cast<size_t>(2),
+                preferences.GetMultipleValue("multi").size());
+}
+
+
+/*
+ * Check preferences are imported from the old file the first time they're
+ * loaded.
+ */
+void IndexedPreferencesTest::testImport() {
+  IndexedPreferenceStore store(STORE_FILE);
+  OLA_ASSERT(store.Open());
+
+  IndexedPreferences missing(&store, "missing", TEST_SRC_DIR "/olad/testdata");
+  OLA_ASSERT_FALSE(missing.Load());
+
+  unlink(TEST_BUILD_DIR "/olad/ola-import.conf");
+  {
+    std::ofstream file(TEST_BUILD_DIR "/olad/ola-import.conf");
+    file << "# comment\n"
+         << "foo = bar\n"
+         << "multi = 1\n"
+         << "multi = 2\n";
+  }
+  IndexedPreferences imported(&store, "import", TEST_BUILD_DIR "/olad");
+  OLA_ASSERT(imported.Load());
+  OLA_ASSERT_EQ(string("bar"), imported.GetValue("foo"));
+  OLA_ASSERT_EQ(static_cast<size_t>(2),
+                imported.GetMultipleValue("multi").size());
+  OLA_ASSERT(store.Contains("import"));
+
+  // Once the store has the preferences, the old file is ignored.
+  imported.SetValue("foo", "baz");
+  OLA_ASSERT(imported.Load());
+  OLA_ASSERT_EQ(string("baz"), imported.GetValue("foo"));
+  unlink(TEST_BUILD_DIR "/olad/ola-import.conf");
+}
@@ -17,14 +17,27 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/Device.cpp \
     olad/plugin_api/DeviceManager.cpp \
     olad/plugin_api/DeviceManager.h \
+    olad/plugin_api/DmxSnapshot.cpp \
+    olad/plugin_api/DmxSnapshot.h \
     olad/plugin_api/DmxSource.cpp \
+    olad/plugin_api/FrameRecorderInterface.h \
+    olad/plugin_api/IndexedPreferences.cpp \
+    olad/plugin_api/IndexedPreferences.h \
+    olad/plugin_api/OutputScheduler.cpp \
+    olad/plugin_api/OutputScheduler.h \
     olad/plugin_api/Plugin.cpp \
     olad/plugin_api/PluginAdaptor.cpp \
+    olad/plugin_api/PluginLoop.cpp \
+    olad/plugin_api/PluginModule.h \
     olad/plugin_api/Port.cpp \
     olad/plugin_api/PortBroker.cpp \
     olad/plugin_api/PortManager.cpp \
     olad/plugin_api/PortManager.h \
     olad/plugin_api/Preferences.cpp \
+    olad/plugin_api/SoftPatch.cpp \
+    olad/plugin_api/SoftPatch.h \
+    olad/plugin_api/SourceExpiryScheduler.cpp \
+    olad/plugin_api/SourceExpiryScheduler.h \
     olad/plugin_api/Universe.cpp \
     olad/plugin_api/UniverseStore.cpp \
     olad/plugin_api/UniverseStore.h
@@ -39,9 +52,12 @@ olad_plugin_api_libolaserverplugininterface_la_LIBADD = \
 test_programs += \
     olad/plugin_api/ClientTester \
     olad/plugin_api/DeviceTester \
+    olad/plugin_api/DmxSnapshotTester \
     olad/plugin_api/DmxSourceTester \
+    olad/plugin_api/PluginLoopTester \
     olad/plugin_api/PortTester \
     olad/plugin_api/PreferencesTester \
+    olad/plugin_api/SoftPatchTester \
     olad/plugin_api/UniverseTester
 
 COMMON_OLAD_PLUGIN_API_TEST_LDADD = \
@@ -59,19 +75,33 @@ olad_plugin_api_DeviceTester_SOURCES = olad/plugin_api/DeviceManagerTest.cpp \
 olad_plugin_api_DeviceTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_DeviceTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
+olad_plugin_api_DmxSnapshotTester_SOURCES = olad/plugin_api/DmxSnapshotTest.cpp
+olad_plugin_api_DmxSnapshotTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+olad_plugin_api_DmxSnapshotTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
 olad_plugin_api_DmxSourceTester_SOURCES = olad/plugin_api/DmxSourceTest.cpp
 olad_plugin_api_DmxSourceTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_DmxSourceTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
+olad_plugin_api_PluginLoopTester_SOURCES = olad/plugin_api/PluginLoopTest.cpp
+olad_plugin_api_PluginLoopTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+olad_plugin_api_PluginLoopTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
 olad_plugin_api_PortTester_SOURCES = olad/plugin_api/PortTest.cpp \
                                      olad/plugin_api/PortManagerTest.cpp
 olad_plugin_api_PortTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_PortTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
-olad_plugin_api_PreferencesTester_SOURCES = olad/plugin_api/PreferencesTest.cpp
+olad_plugin_api_PreferencesTester_SOURCES = \
+    olad/plugin_api/IndexedPreferencesTest.cpp \
+    olad/plugin_api/PreferencesTest.cpp
 olad_plugin_api_PreferencesTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_PreferencesTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
+olad_plugin_api_SoftPatchTester_SOURCES = olad/plugin_api/SoftPatchTest.cpp
+olad_plugin_api_SoftPatchTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+olad_plugin_api_SoftPatchTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
 olad_plugin_api_UniverseTester_SOURCES = olad/plugin_api/UniverseTest.cpp
 olad_plugin_api_UniverseTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_UniverseTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputScheduler.cpp
+ * Coalesces universe output onto a shared tick.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/OutputScheduler.h"
+
+#include "ola/Callback.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+OutputScheduler::OutputScheduler(ola::thread::SchedulerInterface *scheduler,
+                                 const TimeInterval &tick)
+    : m_scheduler(scheduler),
+      m_tick(tick),
+      m_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+
+OutputScheduler::~OutputScheduler() {
+  if (m_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+}
+
+
+void OutputScheduler::Schedule(Universe *universe) {
+  m_pending.insert(universe);
+  if (m_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_timeout = m_scheduler->RegisterRepeatingTimeout(
+        m_tick, NewCallback(this, &OutputScheduler::RunTick));
+  }
+}
+
+
+void OutputScheduler::Cancel(Universe *universe) {
+  m_pending.erase(universe);
+}
+
+
+/*
+ * Flush the universes that are due.
+ * @returns false once there are no universes waiting, which stops the timer.
+ */
+bool OutputScheduler::RunTick() {
+  // Universes may be re-scheduled while we write to the outputs, so work on
+  // a copy of the set.
+  UniverseSet pending;
+  pending.swap(m_pending);
+  UniverseSet::iterator iter = pending.begin();
+  for (; iter != pending.end(); ++iter) {
+    if ((*iter)->RunScheduledOutput()) {
+      m_pending.insert(*iter);
+    }
+  }
+
+  if (m_pending.empty()) {
+    m_timeout = ola::thread::INVALID_TIMEOUT;
+    return false;
+  }
+  return true;
+}
+}  // namespace ola
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OutputScheduler.h
+ * Coalesces universe output onto a shared tick.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
+#define OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
+
+#include <set>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+
+class Universe;
+
+/**
+ * @brief Writes universe data to the outputs on a shared tick.
+ *
+ * Universes with a maximum frame rate don't write to their output ports and
+ * sink clients as soon as the data changes. Instead they register with the
+ * OutputScheduler, and are flushed on the next tick once enough time has
+ * passed since the last write. Any updates that arrive in between are
+ * collapsed into a single write.
+ *
+ * All universes share the same timer, so their output is aligned to the same
+ * clock. The timer only runs while there are universes waiting.
+ */
+class OutputScheduler {
+ public:
+  /**
+   * @brief Create a new OutputScheduler.
+   * @param scheduler the SchedulerInterface to use for the tick timer.
+   * @param tick the time between ticks.
+   */
+  OutputScheduler(ola::thread::SchedulerInterface *scheduler,
+                  const TimeInterval &tick);
+
+  ~OutputScheduler();
+
+  /**
+   * @brief The time between ticks.
+   */
+  const TimeInterval &Tick() const { return m_tick; }
+
+  /**
+   * @brief Flush a universe on an upcoming tick.
+   * @param universe the Universe to flush, calling this multiple times before
+   *   the universe is flushed has no effect.
+   */
+  void Schedule(Universe *universe);
+
+  /**
+   * @brief Remove a universe that is being deleted.
+   * @param universe the Universe to remove.
+   */
+  void Cancel(Universe *universe);
+
+  /**
+   * @brief The number of universes waiting to be flushed.
+   */
+  unsigned int PendingCount() const { return m_pending.size(); }
+
+ private:
+  typedef std::set<Universe*> UniverseSet;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  const TimeInterval m_tick;
+  ola::thread::timeout_id m_timeout;
+  UniverseSet m_pending;
+
+  bool RunTick();
+
+  DISALLOW_COPY_AND_ASSIGN(OutputScheduler);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_OUTPUTSCHEDULER_H_
@@ -21,10 +21,13 @@
 
 #include <string>
 #include "ola/Callback.h"
+#include "ola/stl/STLUtils.h"
 #include "olad/PluginAdaptor.h"
+#include "olad/PluginLoop.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
 
@@ -43,7 +46,14 @@ PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
   m_export_map(export_map),
   m_preferences_factory(preferences_factory),
   m_port_broker(port_broker),
-  m_instance_name(instance_name) {
+  m_instance_name(instance_name),
+  m_universe_store(NULL),
+  m_loop_clock(select_server ? select_server->WakeUpTime() : NULL,
+               &m_clock) {
+}
+
+PluginAdaptor::~PluginAdaptor() {
+  STLDeleteValues(&m_loops);
 }
 
 bool PluginAdaptor::AddReadDescriptor(
@@ -101,18 +111,52 @@ timeout_id PluginAdaptor::RegisterSingleTimeout(
   return m_ss->RegisterSingleTimeout(interval, closure);
 }
 
+timeout_id PluginAdaptor::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    const InlineCallback0<void> &closure) {
+  return m_ss->RegisterSingleTimeout(interval, closure);
+}
+
 void PluginAdaptor::RemoveTimeout(timeout_id id) {
   m_ss->RemoveTimeout(id);
 }
 
+timeout_id PluginAdaptor::RegisterPeriodicTask(const TimeInterval &period,
+                                               Callback0<bool> *closure) {
+  return m_ss->RegisterPeriodicTask(period, closure);
+}
+
+void PluginAdaptor::RemovePeriodicTask(timeout_id id) {
+  m_ss->RemovePeriodicTask(id);
+}
+
 void PluginAdaptor::Execute(ola::BaseCallback0<void> *closure) {
   m_ss->Execute(closure);
 }
 
+void PluginAdaptor::Execute(const ola::InlineCallback0<void> &closure) {
+  m_ss->Execute(closure);
+}
+
 void PluginAdaptor::DrainCallbacks() {
   m_ss->DrainCallbacks();
 }
 
+PluginLoop *PluginAdaptor::DedicatedLoop(const string &name) {
+  PluginLoop *loop = STLFindOrNull(m_loops, name);
+  if (loop) {
+    return loop;
+  }
+
+  loop = new PluginLoop(name, m_export_map);
+  if (!loop->Start()) {
+    delete loop;
+    return NULL;
+  }
+  m_loops[name] = loop;
+  return loop;
+}
+
 bool PluginAdaptor::RegisterDevice(AbstractDevice *device) const {
   return m_device_manager->RegisterDevice(device);
 }
@@ -121,6 +165,12 @@ bool PluginAdaptor::UnregisterDevice(AbstractDevice *device) const {
   return m_device_manager->UnregisterDevice(device);
 }
 
+void PluginAdaptor::SetOutputsHeld(bool held) {
+  if (m_universe_store) {
+    m_universe_store->SetOutputsHeld(held);
+  }
+}
+
 Preferences *PluginAdaptor::NewPreference(const string &name) const {
   return m_preferences_factory->NewPreference(name);
 }
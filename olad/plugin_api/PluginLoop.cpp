@@ -0,0 +1,142 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginLoop.cpp
+ * An event loop in its own thread, for plugins with slow or blocking work.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/thread/CallbackThread.h"
+#include "ola/thread/Future.h"
+#include "olad/PluginLoop.h"
+
+namespace ola {
+
+using ola::thread::Future;
+using std::string;
+
+namespace {
+void RunAndSignal(BaseCallback0<void> *callback, Future<void> *done) {
+  callback->Run();
+  done->Set();
+}
+}  // namespace
+
+const char PluginLoop::LAG_VAR[] = "plugin-loop-lag-usec";
+const char PluginLoop::MAX_LAG_VAR[] = "plugin-loop-max-lag-usec";
+
+PluginLoop::PluginLoop(const string &name, ExportMap *export_map)
+    : m_name(name),
+      m_thread(NULL),
+      m_probe_timeout(ola::thread::INVALID_TIMEOUT),
+      m_max_lag(0) {
+  if (export_map) {
+    m_lag = export_map->GetUIntMapVar(LAG_VAR, "loop")->GetHandle(name);
+    m_max_lag_var = export_map->GetUIntMapVar(MAX_LAG_VAR, "loop")->GetHandle(
+        name);
+  }
+}
+
+PluginLoop::~PluginLoop() {
+  Stop();
+}
+
+bool PluginLoop::Start() {
+  if (m_thread) {
+    return true;
+  }
+
+  m_ss.Execute(NewSingleCallback(this, &PluginLoop::StartProbe));
+  m_thread = new ola::thread::CallbackThread(
+      NewSingleCallback(&m_ss, &ola::io::SelectServer::Run),
+      ola::thread::Thread::Options(m_name));
+  if (!m_thread->Start()) {
+    OLA_WARN << "Failed to start the thread for plugin loop " << m_name;
+    delete m_thread;
+    m_thread = NULL;
+    m_ss.DrainCallbacks();
+    StopProbe();
+    return false;
+  }
+  return true;
+}
+
+void PluginLoop::Stop() {
+  if (!m_thread) {
+    return;
+  }
+
+  // Terminate() needs to be called from within the loop, otherwise it's a
+  // no-op if the thread hasn't reached SelectServer::Run() yet.
+  ExecuteAndWait(NewSingleCallback(this, &PluginLoop::StopProbe));
+  m_ss.Execute(NewSingleCallback(&m_ss, &ola::io::SelectServer::Terminate));
+  m_thread->Join();
+  delete m_thread;
+  m_thread = NULL;
+}
+
+void PluginLoop::ExecuteAndWait(BaseCallback0<void> *callback) {
+  if (!m_thread) {
+    callback->Run();
+    return;
+  }
+
+  Future<void> done;
+  m_ss.Execute(NewSingleCallback(&RunAndSignal, callback, &done));
+  done.Get();
+}
+
+void PluginLoop::StartProbe() {
+  if (m_lag.IsValid()) {
+    RegisterProbe();
+  }
+}
+
+void PluginLoop::StopProbe() {
+  if (m_probe_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss.RemoveTimeout(m_probe_timeout);
+    m_probe_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+}
+
+/*
+ * Called in the loop, the lag is how late the timeout ran.
+ */
+void PluginLoop::Probe() {
+  m_probe_timeout = ola::thread::INVALID_TIMEOUT;
+  TimeInterval late = *m_ss.WakeUpTime() - m_probe_due;
+  unsigned int lag = late.AsInt() > 0 ?
+      static_cast<unsigned int>(late.AsInt()) : 0;
+  if (lag > m_max_lag) {
+    m_max_lag = lag;
+  }
+  m_lag.Set(lag);
+  m_max_lag_var.Set(m_max_lag);
+  RegisterProbe();
+}
+
+void PluginLoop::RegisterProbe() {
+  const TimeInterval interval(0, LAG_PROBE_INTERVAL_MS * ONE_THOUSAND);
+  m_probe_due = *m_ss.WakeUpTime() + interval;
+  m_probe_timeout = m_ss.RegisterSingleTimeout(
+      interval, NewSingleCallback(this, &PluginLoop::Probe));
+}
+}  // namespace ola
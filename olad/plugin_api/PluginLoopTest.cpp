@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginLoopTest.cpp
+ * Test fixture for the PluginLoop class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/thread/Thread.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/PluginLoop.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::ExportMap;
+using ola::NewSingleCallback;
+using ola::PluginAdaptor;
+using ola::PluginLoop;
+using ola::thread::Thread;
+using ola::thread::ThreadId;
+using std::string;
+
+
+class PluginLoopTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PluginLoopTest);
+  CPPUNIT_TEST(testExecuteAndWait);
+  CPPUNIT_TEST(testLag);
+  CPPUNIT_TEST(testPluginAdaptor);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    }
+    void testExecuteAndWait();
+    void testLag();
+    void testPluginAdaptor();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PluginLoopTest);
+
+
+namespace {
+void RecordThread(ThreadId *thread_id) {
+  *thread_id = Thread::Self();
+}
+
+void Block(unsigned int usec) {
+  usleep(usec);
+}
+}  // namespace
+
+
+/*
+ * Check callbacks run in the loop's thread.
+ */
+void PluginLoopTest::testExecuteAndWait() {
+  PluginLoop loop("test-loop", NULL);
+  OLA_ASSERT_FALSE(loop.IsRunning());
+  OLA_ASSERT_EQ(string("test-loop"), loop.Name());
+
+  // Before the loop starts, the callback runs in this thread.
+  ThreadId thread_id;
+  loop.ExecuteAndWait(NewSingleCallback(&RecordThread, &thread_id));
+  OLA_ASSERT(pthread_equal(Thread::Self(), thread_id));
+
+  OLA_ASSERT(loop.Start());
+  OLA_ASSERT(loop.IsRunning());
+  loop.ExecuteAndWait(NewSingleCallback(&RecordThread, &thread_id));
+  OLA_ASSERT_FALSE(pthread_equal(Thread::Self(), thread_id));
+
+  loop.Stop();
+  OLA_ASSERT_FALSE(loop.IsRunning());
+  loop.Stop();
+}
+
+
+/*
+ * Check a blocked loop shows up in the lag variables.
+ */
+void PluginLoopTest::testLag() {
+  const unsigned int block_usec = PluginLoop::LAG_PROBE_INTERVAL_MS * 1000 +
+                                  100000;
+  ExportMap export_map;
+  PluginLoop loop("slow-loop", &export_map);
+  ola::UIntMap *max_lag = export_map.GetUIntMapVar(PluginLoop::MAX_LAG_VAR);
+  OLA_ASSERT_EQ(0u, (*max_lag)["slow-loop"]);
+
+  OLA_ASSERT(loop.Start());
+  // The probe is due while the loop is blocked, so it runs at least 100ms
+  // late.
+  loop.ExecuteAndWait(NewSingleCallback(&Block, block_usec));
+  loop.ExecuteAndWait(NewSingleCallback(&Block, 0u));
+  loop.Stop();
+  OLA_ASSERT((*max_lag)["slow-loop"] >= 100000u);
+  OLA_ASSERT((*max_lag)["slow-loop"] >=
+                  (*export_map.GetUIntMapVar(PluginLoop::LAG_VAR))[
+                      "slow-loop"]);
+}
+
+
+/*
+ * Check the PluginAdaptor shares loops by name.
+ */
+void PluginLoopTest::testPluginAdaptor() {
+  ExportMap export_map;
+  ola::io::SelectServer ss;
+  PluginAdaptor adaptor(NULL, &ss, &export_map, NULL, NULL, NULL);
+
+  PluginLoop *loop = adaptor.DedicatedLoop("first");
+  OLA_ASSERT_NOT_NULL(loop);
+  OLA_ASSERT(loop->IsRunning());
+  OLA_ASSERT_EQ(loop, adaptor.DedicatedLoop("first"));
+  PluginLoop *other = adaptor.DedicatedLoop("second");
+  OLA_ASSERT_NOT_NULL(other);
+  OLA_ASSERT_NE(loop, other);
+}
@@ -0,0 +1,64 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginModule.h
+ * The entry point for plugins that are loaded with dlopen().
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_PLUGINMODULE_H_
+#define OLAD_PLUGIN_API_PLUGINMODULE_H_
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+namespace ola {
+class AbstractPlugin;
+class PluginAdaptor;
+}  // namespace ola
+
+/**
+ * @brief The symbol a plugin module exports to create the plugin.
+ */
+#define OLA_NEW_PLUGIN "ola_new_plugin"
+
+/**
+ * @brief The type of the OLA_NEW_PLUGIN function.
+ * @param adaptor the PluginAdaptor to pass to the plugin.
+ * @returns a new plugin, ownership is transferred to the caller.
+ */
+typedef ola::AbstractPlugin *ola_new_plugin_t(ola::PluginAdaptor *adaptor);
+
+/**
+ * @brief Define the entry point for a plugin module.
+ * @param plugin_class the fully qualified class name of the plugin.
+ *
+ * This is used once in each plugin, at global scope. Unless olad was
+ * configured with --enable-plugin-modules the plugins are linked into olad,
+ * so this expands to nothing rather than defining the same symbol in each
+ * plugin.
+ */
+#ifdef OLA_PLUGIN_MODULES
+#define OLA_PLUGIN_MODULE(plugin_class) \
+  extern "C" ola::AbstractPlugin *ola_new_plugin( \
+      ola::PluginAdaptor *adaptor) { \
+    return new plugin_class(adaptor); \
+  }
+#else
+#define OLA_PLUGIN_MODULE(plugin_class)
+#endif  // OLA_PLUGIN_MODULES
+
+#endif  // OLAD_PLUGIN_API_PLUGINMODULE_H_
@@ -56,6 +56,9 @@ bool BasicInputPort::SetUniverse(Universe *new_universe) {
 
   if (PreSetUniverse(old_universe, new_universe)) {
     m_universe = new_universe;
+    // The new universe hasn't merged the old data, so the next frame must
+    // reach it even if it's the same.
+    m_dmx_source = DmxSource();
     PostSetUniverse(old_universe, new_universe);
     return true;
   }
@@ -83,12 +86,35 @@ bool BasicInputPort::SetPriority(uint8_t priority) {
 void BasicInputPort::DmxChanged() {
   if (GetUniverse()) {
     const DmxBuffer &buffer = ReadDMX();
-    uint8_t priority = (PriorityCapability() == CAPABILITY_FULL &&
-                        GetPriorityMode() == PRIORITY_MODE_INHERIT ?
-                        InheritedPriority() :
-                        GetPriority());
-    m_dmx_source.UpdateData(buffer, *m_plugin_adaptor->WakeUpTime(), priority);
-    GetUniverse()->PortDataChanged(this);
+    bool inherit = (PriorityCapability() == CAPABILITY_FULL &&
+                    GetPriorityMode() == PRIORITY_MODE_INHERIT);
+    uint8_t priority = inherit ? InheritedPriority() : GetPriority();
+    const DmxBuffer *slot_priorities = (
+        inherit ? InheritedSlotPriorities() : NULL);
+    const TimeStamp &now = *m_plugin_adaptor->WakeUpTime();
+
+    // Many sources resend the same frame to keep the data alive. That only
+    // needs to refresh the timestamp, unless it's an LTP universe with other
+    // sources, where the resend makes this the latest source again.
+    Universe *universe = GetUniverse();
+    bool unchanged = (
+        m_dmx_source.IsSet() && m_dmx_source.IsActive(now) &&
+        m_dmx_source.Priority() == priority &&
+        m_dmx_source.Data() == buffer &&
+        (universe->MergeMode() == Universe::MERGE_HTP ||
+         universe->InputPortCount() + universe->SourceClientCount() == 1));
+    if (slot_priorities && slot_priorities->Size()) {
+      unchanged &= m_dmx_source.SlotPriorities() == *slot_priorities;
+      m_dmx_source.UpdateData(buffer, now, priority, *slot_priorities);
+    } else {
+      unchanged &= !m_dmx_source.HasSlotPriorities();
+      m_dmx_source.UpdateData(buffer, now, priority);
+    }
+    m_dmx_source.SetArrivalTime(ArrivalTime());
+
+    if (!unchanged) {
+      universe->PortDataChanged(this);
+    }
   }
 }
 
@@ -117,6 +143,8 @@ void BasicInputPort::TriggerRDMDiscovery(
   }
 }
 
+const unsigned int BasicOutputPort::MAX_FRAME_RATE = 1000;
+
 BasicOutputPort::BasicOutputPort(AbstractDevice *parent,
                                  unsigned int port_id,
                                  bool start_rdm_discovery_on_patch,
@@ -128,7 +156,10 @@ BasicOutputPort::BasicOutputPort(AbstractDevice *parent,
     m_port_string(""),
     m_universe(NULL),
     m_device(parent),
-    m_supports_rdm(supports_rdm) {
+    m_supports_rdm(supports_rdm),
+    m_max_frame_rate(0),
+    m_skipped_frames(0),
+    m_frame_pending(false) {
 }
 
 bool BasicOutputPort::SetUniverse(Universe *new_universe) {
@@ -138,10 +169,16 @@ bool BasicOutputPort::SetUniverse(Universe *new_universe) {
 
   if (PreSetUniverse(old_universe, new_universe)) {
     m_universe = new_universe;
+    // the new universe writes its data to us when we're added
+    m_frame_pending = false;
     PostSetUniverse(old_universe, new_universe);
-    if (m_discover_on_patch)
+    if (m_discover_on_patch) {
+      if (new_universe && !new_universe->CachedUIDs().Empty()) {
+        SeedUIDs(new_universe->CachedUIDs());
+      }
       RunIncrementalDiscovery(
           NewSingleCallback(this, &BasicOutputPort::UpdateUIDs));
+    }
     return true;
   }
   return false;
@@ -165,6 +202,35 @@ bool BasicOutputPort::SetPriority(uint8_t priority) {
   return true;
 }
 
+bool BasicOutputPort::SetMaxFrameRate(unsigned int frames_per_second) {
+  if (frames_per_second > MAX_FRAME_RATE)
+    return false;
+
+  if (frames_per_second != m_max_frame_rate) {
+    m_max_frame_rate = frames_per_second;
+    m_frame_bucket.reset();
+  }
+  return true;
+}
+
+bool BasicOutputPort::AdmitFrame(const TimeStamp &now) {
+  // The universe only keeps the latest data, so a held frame is lost once a
+  // new one arrives.
+  if (m_frame_pending) {
+    m_skipped_frames++;
+  }
+  m_frame_pending = !TakeFrameToken(now);
+  return !m_frame_pending;
+}
+
+bool BasicOutputPort::AdmitPendingFrame(const TimeStamp &now) {
+  if (!m_frame_pending || !TakeFrameToken(now)) {
+    return false;
+  }
+  m_frame_pending = false;
+  return true;
+}
+
 void BasicOutputPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
                                      ola::rdm::RDMCallback *callback) {
   auto_ptr<ola::rdm::RDMRequest> request(request_ptr);
@@ -191,6 +257,17 @@ void BasicOutputPort::RunIncrementalDiscovery(
   on_complete->Run(uids);
 }
 
+bool BasicOutputPort::TakeFrameToken(const TimeStamp &now) {
+  if (!m_max_frame_rate) {
+    return true;
+  }
+  // A bucket of one token, so the frames are never sent in a burst.
+  if (!m_frame_bucket.get()) {
+    m_frame_bucket.reset(new TokenBucket(1, m_max_frame_rate, 1, now));
+  }
+  return m_frame_bucket->GetToken(now);
+}
+
 void BasicOutputPort::UpdateUIDs(const ola::rdm::UIDSet &uids) {
   Universe *universe = GetUniverse();
   if (universe)
@@ -20,6 +20,7 @@
 
 #include "olad/plugin_api/PortManager.h"
 
+#include <set>
 #include <vector>
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
@@ -27,6 +28,7 @@
 
 namespace ola {
 
+using std::set;
 using std::vector;
 
 bool PortManager::PatchPort(InputPort *port,
@@ -47,6 +49,30 @@ bool PortManager::UnPatchPort(OutputPort *port) {
   return GenericUnPatchPort(port);
 }
 
+bool PortManager::PatchPorts(const vector<PortPatch> &patches) {
+  // Each device sees the whole batch as one change.
+  set<AbstractDevice*> devices;
+  vector<PortPatch>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    AbstractDevice *device = iter->input_port ?
+        iter->input_port->GetDevice() : iter->output_port->GetDevice();
+    if (device) {
+      devices.insert(device);
+    }
+  }
+
+  set<AbstractDevice*>::iterator device_iter = devices.begin();
+  for (; device_iter != devices.end(); ++device_iter) {
+    (*device_iter)->EnterConfigurationMode();
+  }
+  const bool ok = ApplyPatches(patches);
+  for (device_iter = devices.begin(); device_iter != devices.end();
+       ++device_iter) {
+    (*device_iter)->ExitConfigurationMode();
+  }
+  return ok;
+}
+
 bool PortManager::SetPriorityInherit(Port *port) {
   if (port->PriorityCapability() != CAPABILITY_FULL)
     return true;
@@ -79,6 +105,58 @@ bool PortManager::SetPriorityStatic(Port *port, uint8_t value) {
 }
 
 
+bool PortManager::ApplyPatches(const vector<PortPatch> &patches) {
+  // How to put back each port that's been changed so far.
+  vector<PortPatch> undo;
+  undo.reserve(patches.size());
+
+  vector<PortPatch>::const_iterator iter = patches.begin();
+  for (; iter != patches.end(); ++iter) {
+    const PortPatch previous = CurrentPatch(*iter);
+    if (!ApplyPatch(*iter)) {
+      OLA_WARN << "Patch " << (iter - patches.begin()) << " of "
+               << patches.size() << " failed, reverting";
+      vector<PortPatch>::const_reverse_iterator undo_iter = undo.rbegin();
+      for (; undo_iter != undo.rend(); ++undo_iter) {
+        if (!ApplyPatch(*undo_iter)) {
+          OLA_WARN << "Failed to revert a port patch";
+        }
+      }
+      return false;
+    }
+    undo.push_back(previous);
+  }
+  return true;
+}
+
+bool PortManager::ApplyPatch(const PortPatch &patch) {
+  if (patch.input_port) {
+    return patch.patch ?
+        GenericPatchPort(patch.input_port, patch.universe_id) :
+        GenericUnPatchPort(patch.input_port);
+  } else {
+    return patch.patch ?
+        GenericPatchPort(patch.output_port, patch.universe_id) :
+        GenericUnPatchPort(patch.output_port);
+  }
+}
+
+/*
+ * Returns the PortPatch that would restore the port to its current universe.
+ */
+PortManager::PortPatch PortManager::CurrentPatch(
+    const PortPatch &patch) const {
+  if (patch.input_port) {
+    const Universe *universe = patch.input_port->GetUniverse();
+    return PortPatch(patch.input_port, universe != NULL,
+                     universe ? universe->UniverseId() : 0);
+  } else {
+    const Universe *universe = patch.output_port->GetUniverse();
+    return PortPatch(patch.output_port, universe != NULL,
+                     universe ? universe->UniverseId() : 0);
+  }
+}
+
 template<class PortClass>
 bool PortManager::GenericPatchPort(PortClass *port,
                                    unsigned int new_universe_id) {
@@ -36,6 +36,32 @@ namespace ola {
  */
 class PortManager {
  public:
+  /**
+   * @brief A change to the patching of one port, used with PatchPorts().
+   *
+   * Exactly one of input_port and output_port is set.
+   */
+  struct PortPatch {
+    InputPort *input_port;
+    OutputPort *output_port;
+    bool patch;  // false to unpatch the port
+    unsigned int universe_id;
+
+    PortPatch(InputPort *port, bool _patch, unsigned int _universe_id)
+        : input_port(port),
+          output_port(NULL),
+          patch(_patch),
+          universe_id(_universe_id) {
+    }
+
+    PortPatch(OutputPort *port, bool _patch, unsigned int _universe_id)
+        : input_port(NULL),
+          output_port(port),
+          patch(_patch),
+          universe_id(_universe_id) {
+    }
+  };
+
   /**
    * @brief Create a new PortManager.
    * @param universe_store the UniverseStore used to lookup / create Universes.
@@ -82,6 +108,18 @@ class PortManager {
    */
   bool UnPatchPort(OutputPort *port);
 
+  /**
+   * @brief Patch and unpatch a set of ports as a single change.
+   * @param patches the changes to make, in the order to make them.
+   * @returns true if all the changes were made. If one of the changes fails,
+   *   the ports that were already changed are returned to the universes they
+   *   were patched to before, and false is returned.
+   *
+   * Each device with a port in the batch is put in configuration mode while
+   * the changes are made, so it can announce them once.
+   */
+  bool PatchPorts(const std::vector<PortPatch> &patches);
+
   /**
    * @brief Set a port to 'inherit' priority mode.
    * @param port the port to configure
@@ -96,6 +134,10 @@ class PortManager {
   bool SetPriorityStatic(Port *port, uint8_t value);
 
  private:
+  bool ApplyPatches(const std::vector<PortPatch> &patches);
+  bool ApplyPatch(const PortPatch &patch);
+  PortPatch CurrentPatch(const PortPatch &patch) const;
+
   template<class PortClass>
   bool GenericPatchPort(PortClass *port,
                         unsigned int new_universe_id);
@@ -20,6 +20,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
+#include <vector>
 
 #include "olad/DmxSource.h"
 #include "olad/PortBroker.h"
@@ -34,12 +35,42 @@ using ola::PortManager;
 using ola::Port;
 using ola::Universe;
 using std::string;
+using std::vector;
+
+
+/*
+ * A device which counts the configuration mode transitions.
+ */
+class ConfigurationCountingDevice: public MockDevice {
+ public:
+  ConfigurationCountingDevice(ola::AbstractPlugin *owner,
+                              const string &name)
+      : MockDevice(owner, name),
+        in_configuration_mode(false),
+        configuration_count(0) {
+  }
+
+  void EnterConfigurationMode() {
+    OLA_ASSERT_FALSE(in_configuration_mode);
+    in_configuration_mode = true;
+  }
+
+  void ExitConfigurationMode() {
+    OLA_ASSERT_TRUE(in_configuration_mode);
+    in_configuration_mode = false;
+    configuration_count++;
+  }
+
+  bool in_configuration_mode;
+  unsigned int configuration_count;
+};
 
 
 class PortManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PortManagerTest);
   CPPUNIT_TEST(testPortPatching);
   CPPUNIT_TEST(testPortPatchingLoopMulti);
+  CPPUNIT_TEST(testPatchPorts);
   CPPUNIT_TEST(testInputPortSetPriority);
   CPPUNIT_TEST(testOutputPortSetPriority);
   CPPUNIT_TEST_SUITE_END();
@@ -47,6 +78,7 @@ class PortManagerTest: public CppUnit::TestFixture {
  public:
     void testPortPatching();
     void testPortPatchingLoopMulti();
+    void testPatchPorts();
     void testInputPortSetPriority();
     void testOutputPortSetPriority();
 };
@@ -175,6 +207,57 @@ void PortManagerTest::testPortPatchingLoopMulti() {
 }
 
 
+/*
+ * Check that a set of patches is applied as a single change.
+ */
+void PortManagerTest::testPatchPorts() {
+  ola::UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&uni_store, &broker);
+
+  // mock device, this doesn't allow looping or multiport patching
+  ConfigurationCountingDevice device1(NULL, "test_device_1");
+  TestMockInputPort input_port(&device1, 1, NULL);
+  TestMockOutputPort output_port(&device1, 1);
+  TestMockOutputPort output_port2(&device1, 2);
+  device1.AddPort(&input_port);
+  device1.AddPort(&output_port);
+  device1.AddPort(&output_port2);
+
+  OLA_ASSERT(port_manager.PatchPort(&output_port2, 5));
+  OLA_ASSERT_EQ(0u, device1.configuration_count);
+
+  vector<PortManager::PortPatch> patches;
+  patches.push_back(PortManager::PortPatch(&input_port, true, 1));
+  patches.push_back(PortManager::PortPatch(&output_port, true, 2));
+  patches.push_back(PortManager::PortPatch(&output_port2, false, 0));
+  OLA_ASSERT(port_manager.PatchPorts(patches));
+  // The device is in configuration mode once for the whole batch.
+  OLA_ASSERT_EQ(1u, device1.configuration_count);
+  OLA_ASSERT_FALSE(device1.in_configuration_mode);
+  OLA_ASSERT(input_port.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 1, input_port.GetUniverse()->UniverseId());
+  OLA_ASSERT(output_port.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 2, output_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), output_port2.GetUniverse());
+
+  // The last patch loops, so the earlier ones are reverted.
+  patches.clear();
+  patches.push_back(PortManager::PortPatch(&output_port, false, 0));
+  patches.push_back(PortManager::PortPatch(&output_port2, true, 3));
+  patches.push_back(PortManager::PortPatch(&input_port, true, 3));
+  OLA_ASSERT_FALSE(port_manager.PatchPorts(patches));
+  // The revert is part of the same batch.
+  OLA_ASSERT_EQ(2u, device1.configuration_count);
+  OLA_ASSERT_FALSE(device1.in_configuration_mode);
+  OLA_ASSERT(input_port.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 1, input_port.GetUniverse()->UniverseId());
+  OLA_ASSERT(output_port.GetUniverse());
+  OLA_ASSERT_EQ((unsigned int) 2, output_port.GetUniverse()->UniverseId());
+  OLA_ASSERT_EQ(static_cast<Universe*>(NULL), output_port2.GetUniverse());
+}
+
+
 /*
  * Check that we can set priorities on an input port
  */
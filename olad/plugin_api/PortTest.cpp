@@ -31,18 +31,23 @@
 
 
 using ola::Clock;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using std::string;
 
 class PortTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PortTest);
   CPPUNIT_TEST(testOutputPortPriorities);
+  CPPUNIT_TEST(testOutputPortFrameRate);
   CPPUNIT_TEST(testInputPortPriorities);
+  CPPUNIT_TEST(testInputPortUnchangedData);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testOutputPortPriorities();
+    void testOutputPortFrameRate();
     void testInputPortPriorities();
+    void testInputPortUnchangedData();
 
  private:
     Clock m_clock;
@@ -78,6 +83,60 @@ void PortTest::testOutputPortPriorities() {
 }
 
 
+/*
+ * Check the rate limit on output ports
+ */
+void PortTest::testOutputPortFrameRate() {
+  TestMockOutputPort output_port(NULL, 1);
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+
+  // no limit by default
+  OLA_ASSERT_EQ(0u, output_port.MaxFrameRate());
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_ASSERT_TRUE(output_port.AdmitFrame(now));
+  }
+  OLA_ASSERT_FALSE(output_port.FramePending());
+
+  OLA_ASSERT_FALSE(output_port.SetMaxFrameRate(
+      ola::BasicOutputPort::MAX_FRAME_RATE + 1));
+  OLA_ASSERT_EQ(0u, output_port.MaxFrameRate());
+  OLA_ASSERT_TRUE(output_port.SetMaxFrameRate(10));
+  OLA_ASSERT_EQ(10u, output_port.MaxFrameRate());
+
+  // the first frame is sent, the next one is held
+  OLA_ASSERT_TRUE(output_port.AdmitFrame(now));
+  OLA_ASSERT_FALSE(output_port.AdmitFrame(now));
+  OLA_ASSERT_TRUE(output_port.FramePending());
+  OLA_ASSERT_EQ(0u, output_port.SkippedFrames());
+  OLA_ASSERT_FALSE(output_port.AdmitPendingFrame(now));
+
+  // a newer frame replaces the held one
+  now += TimeInterval(50000);
+  OLA_ASSERT_FALSE(output_port.AdmitFrame(now));
+  OLA_ASSERT_EQ(1u, output_port.SkippedFrames());
+
+  // and it's sent once the frame interval has passed
+  now += TimeInterval(50000);
+  OLA_ASSERT_TRUE(output_port.AdmitPendingFrame(now));
+  OLA_ASSERT_FALSE(output_port.FramePending());
+  OLA_ASSERT_FALSE(output_port.AdmitPendingFrame(now));
+  OLA_ASSERT_EQ(1u, output_port.SkippedFrames());
+
+  // a frame that's sent replaces the held one as well
+  OLA_ASSERT_FALSE(output_port.AdmitFrame(now));
+  now += TimeInterval(100000);
+  OLA_ASSERT_TRUE(output_port.AdmitFrame(now));
+  OLA_ASSERT_FALSE(output_port.FramePending());
+  OLA_ASSERT_EQ(2u, output_port.SkippedFrames());
+
+  // removing the limit releases a held frame
+  OLA_ASSERT_FALSE(output_port.AdmitFrame(now));
+  OLA_ASSERT_TRUE(output_port.SetMaxFrameRate(0));
+  OLA_ASSERT_TRUE(output_port.AdmitPendingFrame(now));
+}
+
+
 /*
  * Test that we can set the priorities & modes of input ports
  */
@@ -150,3 +209,59 @@ void PortTest::testInputPortPriorities() {
   input_port2.DmxChanged();
   OLA_ASSERT_EQ(new_priority,  universe->ActivePriority());
 }
+
+
+/*
+ * Check that resending the same data refreshes the source without merging.
+ */
+void PortTest::testInputPortUnchangedData() {
+  unsigned int universe_id = 1;
+  ola::MemoryPreferences preferences("foo");
+  ola::UniverseStore store(&preferences, NULL);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&store, &broker);
+
+  MockDevice device(NULL, "foo");
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  TestMockInputPort input_port(&device, 1, &plugin_adaptor);
+  port_manager.PatchPort(&input_port, universe_id);
+  ola::Universe *universe = store.GetUniverseOrCreate(universe_id);
+  OLA_ASSERT(universe);
+
+  const ola::DmxBuffer buffer("foo bar baz");
+  m_clock.CurrentTime(&time_stamp);
+  input_port.WriteDMX(buffer);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(buffer, universe->GetDMX());
+
+  // Overwrite the merged data, so we can tell if the next frame is merged.
+  const ola::DmxBuffer other("other");
+  universe->SetDMX(other);
+
+  time_stamp += ola::TimeInterval(0, 100000);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(other, universe->GetDMX());
+  OLA_ASSERT_EQ(time_stamp, input_port.SourceData().Timestamp());
+
+  // A change in priority is merged
+  port_manager.SetPriorityStatic(&input_port, 120);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(buffer, universe->GetDMX());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), universe->ActivePriority());
+
+  // As is new data
+  const ola::DmxBuffer new_buffer("new data");
+  input_port.WriteDMX(new_buffer);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(new_buffer, universe->GetDMX());
+
+  // And the first frame after the port is patched to another universe.
+  port_manager.UnPatchPort(&input_port);
+  port_manager.PatchPort(&input_port, universe_id + 1);
+  ola::Universe *universe2 = store.GetUniverseOrCreate(universe_id + 1);
+  input_port.DmxChanged();
+  OLA_ASSERT_EQ(new_buffer, universe2->GetDMX());
+  port_manager.UnPatchPort(&input_port);
+}
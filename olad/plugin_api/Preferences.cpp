@@ -21,6 +21,7 @@
 #define __STDC_LIMIT_MACROS  // for UINT8_MAX & friends
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -32,6 +33,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,36 +48,64 @@
 
 namespace ola {
 
+using ola::thread::INVALID_TIMEOUT;
 using ola::thread::Mutex;
+using ola::thread::MutexLocker;
 using ola::thread::ConditionVariable;
 using std::ifstream;
-using std::ofstream;
 using std::map;
 using std::pair;
 using std::string;
 using std::vector;
 
 namespace {
+/*
+ * Write the preferences to a temporary file and then rename it over the
+ * original, so readers only ever see a complete file.
+ */
 void SavePreferencesToFile(
-    const string *filename_ptr,
-    const FilePreferenceSaverThread::PreferencesMap *pref_map_ptr) {
-  std::auto_ptr<const string> filename(filename_ptr);
-  std::auto_ptr<const FilePreferenceSaverThread::PreferencesMap> pref_map(
-      pref_map_ptr);
-
+    const string &filename,
+    const FilePreferenceSaverThread::PreferencesMap &pref_map) {
+  std::ostringstream str;
   FilePreferenceSaverThread::PreferencesMap::const_iterator iter;
-  ofstream pref_file(filename->data());
+  for (iter = pref_map.begin(); iter != pref_map.end(); ++iter) {
+    str << iter->first << " = " << iter->second << std::endl;
+  }
+  const string contents = str.str();
 
-  if (!pref_file.is_open()) {
-    OLA_WARN << "Could not open " << *filename_ptr << ": " << strerror(errno);
+  const string temp_filename = filename + ".new";
+  int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
     return;
   }
 
-  for (iter = pref_map->begin(); iter != pref_map->end(); ++iter) {
-    pref_file << iter->first << " = " << iter->second << std::endl;
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    ssize_t r = write(fd, contents.data() + offset, contents.size() - offset);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to write " << temp_filename << ": "
+               << strerror(errno);
+      close(fd);
+      unlink(temp_filename.c_str());
+      return;
+    }
+    offset += r;
+  }
+
+  if (fsync(fd)) {
+    OLA_WARN << "Failed to sync " << temp_filename << ": " << strerror(errno);
+  }
+  close(fd);
+
+  if (rename(temp_filename.c_str(), filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << " to " << filename
+             << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
   }
-  pref_file.flush();
-  pref_file.close();
 }
 }  // namespace
 
@@ -344,8 +374,12 @@ void MemoryPreferences::SetValueAsBool(const string &key, bool value) {
 // FilePreferenceSaverThread
 //-----------------------------------------------------------------------------
 
-FilePreferenceSaverThread::FilePreferenceSaverThread()
-    : Thread(Thread::Options("pref-saver")) {
+FilePreferenceSaverThread::FilePreferenceSaverThread(
+    const TimeInterval &save_delay)
+    : Thread(Thread::Options("pref-saver")),
+      m_save_delay(save_delay),
+      m_save_scheduled(false),
+      m_save_timeout(INVALID_TIMEOUT) {
   // set a long poll interval so we don't spin
   m_ss.SetDefaultInterval(TimeInterval(60, 0));
 }
@@ -353,16 +387,19 @@ FilePreferenceSaverThread::FilePreferenceSaverThread()
 void FilePreferenceSaverThread::SavePreferences(
     const string &file_name,
     const PreferencesMap &preferences) {
-  const string *file_name_ptr = new string(file_name);
-  const PreferencesMap *save_map = new PreferencesMap(preferences);
-  SingleUseCallback0<void> *cb =
-      NewSingleCallback(SavePreferencesToFile, file_name_ptr, save_map);
-  m_ss.Execute(cb);
+  MutexLocker lock(&m_mutex);
+  m_pending_saves[file_name] = preferences;
+  if (!m_save_scheduled) {
+    m_save_scheduled = true;
+    m_ss.Execute(NewSingleCallback(
+        this, &FilePreferenceSaverThread::ScheduleSave));
+  }
 }
 
 
 void *FilePreferenceSaverThread::Run() {
   m_ss.Run();
+  SavePending();
   return NULL;
 }
 
@@ -389,6 +426,7 @@ void FilePreferenceSaverThread::Syncronize() {
 void FilePreferenceSaverThread::CompleteSyncronization(
     ConditionVariable *condition,
     Mutex *mutex) {
+  SavePending();
   // calling lock here forces us to block until Wait() is called on the
   // condition_var.
   mutex->Lock();
@@ -397,6 +435,41 @@ void FilePreferenceSaverThread::CompleteSyncronization(
 }
 
 
+void FilePreferenceSaverThread::ScheduleSave() {
+  if (m_save_timeout == INVALID_TIMEOUT) {
+    m_save_timeout = m_ss.RegisterSingleTimeout(
+        m_save_delay,
+        NewSingleCallback(this, &FilePreferenceSaverThread::SaveTimeout));
+  }
+}
+
+
+void FilePreferenceSaverThread::SaveTimeout() {
+  m_save_timeout = INVALID_TIMEOUT;
+  SavePending();
+}
+
+
+void FilePreferenceSaverThread::SavePending() {
+  if (m_save_timeout != INVALID_TIMEOUT) {
+    m_ss.RemoveTimeout(m_save_timeout);
+    m_save_timeout = INVALID_TIMEOUT;
+  }
+
+  PendingSaves saves;
+  {
+    MutexLocker lock(&m_mutex);
+    saves.swap(m_pending_saves);
+    m_save_scheduled = false;
+  }
+
+  PendingSaves::const_iterator iter = saves.begin();
+  for (; iter != saves.end(); ++iter) {
+    SavePreferencesToFile(iter->first, iter->second);
+  }
+}
+
+
 // FileBackedPreferences
 //-----------------------------------------------------------------------------
 
@@ -412,12 +485,17 @@ bool FileBackedPreferences::Save() const {
 
 
 const string FileBackedPreferences::FileName() const {
-  return (m_directory + ola::file::PATH_SEPARATOR + OLA_CONFIG_PREFIX +
-          m_preference_name + OLA_CONFIG_SUFFIX);
+  return FileName(m_directory, m_preference_name);
 }
 
 
 bool FileBackedPreferences::LoadFromFile(const string &filename) {
+  return ParseFile(filename, &m_pref_map);
+}
+
+
+bool FileBackedPreferences::ParseFile(const string &filename,
+                                      PreferencesMap *preferences) {
   ifstream pref_file(filename.data());
 
   if (!pref_file.is_open()) {
@@ -426,7 +504,7 @@ bool FileBackedPreferences::LoadFromFile(const string &filename) {
     return false;
   }
 
-  m_pref_map.clear();
+  preferences->clear();
   string line;
   while (getline(pref_file, line)) {
     StringTrim(&line);
@@ -447,9 +525,16 @@ bool FileBackedPreferences::LoadFromFile(const string &filename) {
     string value = tokens[1];
     StringTrim(&key);
     StringTrim(&value);
-    m_pref_map.insert(make_pair(key, value));
+    preferences->insert(make_pair(key, value));
   }
   pref_file.close();
   return true;
 }
+
+
+string FileBackedPreferences::FileName(const string &directory,
+                                       const string &name) {
+  return (directory + ola::file::PATH_SEPARATOR + OLA_CONFIG_PREFIX + name +
+          OLA_CONFIG_SUFFIX);
+}
 }  // namespace ola
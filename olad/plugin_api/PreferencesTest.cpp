@@ -19,6 +19,7 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <set>
 #include <string>
 #include <vector>
@@ -52,6 +53,7 @@ class PreferencesTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testFactory);
   CPPUNIT_TEST(testLoad);
   CPPUNIT_TEST(testSave);
+  CPPUNIT_TEST(testCoalescedSave);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -64,6 +66,7 @@ class PreferencesTest: public CppUnit::TestFixture {
     void testFactory();
     void testLoad();
     void testSave();
+    void testCoalescedSave();
 };
 
 
@@ -377,3 +380,38 @@ void PreferencesTest::testSave() {
 
   saver_thread.Join();
 }
+
+
+/*
+ * Check that saves are held back and only the latest version is written.
+ */
+void PreferencesTest::testCoalescedSave() {
+  const string data_path = TEST_BUILD_DIR "/olad/ola-coalesced.conf";
+  unlink(data_path.c_str());
+
+  // The delay is long enough that the save only happens when we force it.
+  ola::FilePreferenceSaverThread saver_thread(ola::TimeInterval(3600, 0));
+  saver_thread.Start();
+  FileBackedPreferences preferences(TEST_BUILD_DIR "/olad", "coalesced",
+                                    &saver_thread);
+  preferences.SetValue("foo", "bar");
+  preferences.Save();
+  preferences.SetValue("foo", "baz");
+  preferences.Save();
+
+  FileBackedPreferences input_preferences("", "input", NULL);
+  OLA_ASSERT_FALSE(input_preferences.LoadFromFile(data_path));
+
+  saver_thread.Syncronize();
+  OLA_ASSERT_TRUE(input_preferences.LoadFromFile(data_path));
+  OLA_ASSERT_EQ(string("baz"), input_preferences.GetValue("foo"));
+  OLA_ASSERT_EQ(-1, access((data_path + ".new").c_str(), F_OK));
+
+  // Pending saves are written when the thread stops.
+  preferences.SetValue("foo", "bat");
+  preferences.Save();
+  saver_thread.Join();
+  OLA_ASSERT_TRUE(input_preferences.LoadFromFile(data_path));
+  OLA_ASSERT_EQ(string("bat"), input_preferences.GetValue("foo"));
+  unlink(data_path.c_str());
+}
@@ -0,0 +1,252 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SoftPatch.cpp
+ * Builds virtual universes from slot ranges of other universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/SoftPatch.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/SourcePriorities.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/DmxSource.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+namespace ola {
+
+using std::string;
+using std::vector;
+
+const char SoftPatch::PATCH_KEY[] = "patch";
+
+namespace {
+/*
+ * Parse a universe:slot or universe:first-last token, the slots are 1-based.
+ */
+bool ParseSlots(const string &token, unsigned int *universe,
+                unsigned int *first, unsigned int *last) {
+  vector<string> tokens;
+  StringSplit(token, &tokens, ":");
+  if (tokens.size() != 2 || !StringToInt(tokens[0], universe, true)) {
+    return false;
+  }
+
+  vector<string> slots;
+  StringSplit(tokens[1], &slots, "-");
+  if (slots.empty() || slots.size() > 2 ||
+      !StringToInt(slots[0], first, true)) {
+    return false;
+  }
+  if (slots.size() == 1) {
+    *last = *first;
+  } else if (!StringToInt(slots[1], last, true)) {
+    return false;
+  }
+  return *first >= 1 && *first <= *last && *last <= DMX_UNIVERSE_SIZE;
+}
+}  // namespace
+
+SoftPatch::SoftPatch(UniverseStore *universe_store)
+    : m_universe_store(universe_store),
+      m_client(NULL, ola::rdm::UID(0, 0), NULL) {
+}
+
+SoftPatch::~SoftPatch() {
+  STLDeleteValues(&m_targets);
+}
+
+unsigned int SoftPatch::Load(const Preferences &preferences) {
+  const vector<string> values = preferences.GetMultipleValue(PATCH_KEY);
+  unsigned int added = 0;
+  vector<string>::const_iterator iter = values.begin();
+  for (; iter != values.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+    Patch patch;
+    if (!ParsePatch(*iter, &patch)) {
+      OLA_WARN << "Invalid soft patch: " << *iter;
+      continue;
+    }
+    if (AddPatch(patch)) {
+      added++;
+    }
+  }
+  OLA_INFO << "Loaded " << added << " soft patches into " << m_targets.size()
+           << " universes";
+  return added;
+}
+
+bool SoftPatch::AddPatch(const Patch &patch) {
+  if (!patch.length || patch.source_slot + patch.length > DMX_UNIVERSE_SIZE ||
+      patch.target_slot + patch.length > DMX_UNIVERSE_SIZE) {
+    OLA_WARN << "Soft patch from universe " << patch.source_universe
+             << " to " << patch.target_universe << " is out of range";
+    return false;
+  }
+  if (patch.source_universe == patch.target_universe ||
+      IsSource(patch.target_universe) ||
+      STLContains(m_targets, patch.source_universe)) {
+    OLA_WARN << "Soft patch from universe " << patch.source_universe
+             << " to " << patch.target_universe << " would create a cycle";
+    return false;
+  }
+
+  Target *target = GetTarget(patch.target_universe,
+                             patch.target_slot + patch.length);
+  GatherList &gathers = m_gathers[patch.source_universe];
+  if (!gathers.empty()) {
+    Gather &last = gathers.back();
+    if (last.target == target &&
+        last.source_offset + last.length == patch.source_slot &&
+        last.target_offset + last.length == patch.target_slot) {
+      last.length += patch.length;
+      return true;
+    }
+  }
+
+  Gather gather;
+  gather.target = target;
+  gather.source_offset = patch.source_slot;
+  gather.target_offset = patch.target_slot;
+  gather.length = patch.length;
+  gathers.push_back(gather);
+  return true;
+}
+
+unsigned int SoftPatch::RunCount() const {
+  unsigned int runs = 0;
+  GatherMap::const_iterator iter = m_gathers.begin();
+  for (; iter != m_gathers.end(); ++iter) {
+    runs += iter->second.size();
+  }
+  return runs;
+}
+
+void SoftPatch::SourceUpdated(const Universe &universe, const TimeStamp &now) {
+  GatherMap::const_iterator gathers = m_gathers.find(universe.UniverseId());
+  if (gathers == m_gathers.end()) {
+    return;
+  }
+
+  const DmxBuffer &data = universe.GetDMX();
+  const uint8_t *raw = data.GetRaw();
+  const unsigned int size = data.Size();
+  GatherList::const_iterator iter = gathers->second.begin();
+  for (; iter != gathers->second.end(); ++iter) {
+    // Slots the source doesn't have yet leave the target unchanged.
+    if (iter->source_offset < size) {
+      iter->target->buffer.SetRange(
+          iter->target_offset, raw + iter->source_offset,
+          std::min(static_cast<unsigned int>(iter->length),
+                   size - iter->source_offset));
+    }
+    if (!iter->target->touched) {
+      iter->target->touched = true;
+      m_touched.push_back(iter->target);
+    }
+  }
+
+  vector<Target*>::iterator target_iter = m_touched.begin();
+  for (; target_iter != m_touched.end(); ++target_iter) {
+    (*target_iter)->touched = false;
+    SendTarget(*target_iter, now);
+  }
+  m_touched.clear();
+}
+
+bool SoftPatch::ParsePatch(const string &value, Patch *patch) {
+  vector<string> all_tokens, tokens;
+  StringSplit(value, &all_tokens, " \t");
+  vector<string>::const_iterator iter = all_tokens.begin();
+  for (; iter != all_tokens.end(); ++iter) {
+    if (!iter->empty()) {
+      tokens.push_back(*iter);
+    }
+  }
+  if (tokens.size() != 2) {
+    return false;
+  }
+
+  unsigned int first, last, target_slot, target_last;
+  if (!ParseSlots(tokens[0], &patch->source_universe, &first, &last) ||
+      !ParseSlots(tokens[1], &patch->target_universe, &target_slot,
+                  &target_last) ||
+      target_last != target_slot) {
+    return false;
+  }
+  patch->source_slot = first - 1;
+  patch->length = last - first + 1;
+  patch->target_slot = target_slot - 1;
+  return patch->target_slot + patch->length <= DMX_UNIVERSE_SIZE;
+}
+
+/*
+ * Get the target for a universe, creating it if needed, and make sure the
+ * buffer has at least size slots.
+ */
+SoftPatch::Target *SoftPatch::GetTarget(unsigned int universe_id,
+                                        unsigned int size) {
+  Target *target = STLFindOrNull(m_targets, universe_id);
+  if (!target) {
+    target = new Target();
+    target->universe_id = universe_id;
+    target->touched = false;
+    m_targets[universe_id] = target;
+  }
+  if (target->buffer.Size() < size) {
+    if (target->buffer.Size()) {
+      target->buffer.SetRangeToValue(target->buffer.Size(), 0,
+                                     size - target->buffer.Size());
+    } else {
+      const uint8_t zeros[DMX_UNIVERSE_SIZE] = {0};
+      target->buffer.Set(zeros, size);
+    }
+  }
+  return target;
+}
+
+/*
+ * Pass a target's data to its universe. Unchanged data only refreshes the
+ * timestamp of the source, so it doesn't time out.
+ */
+void SoftPatch::SendTarget(Target *target, const TimeStamp &now) {
+  Universe *universe = m_universe_store->GetUniverseOrCreate(
+      target->universe_id);
+  if (!universe) {
+    return;
+  }
+
+  m_client.DMXReceived(
+      target->universe_id,
+      DmxSource(target->buffer, now, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  if (target->buffer.HasChanges() ||
+      !universe->ContainsSourceClient(&m_client)) {
+    target->buffer.ClearChanges();
+    universe->SourceClientDataChanged(&m_client);
+  }
+}
+}  // namespace ola
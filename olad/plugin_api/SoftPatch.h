@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SoftPatch.h
+ * Builds virtual universes from slot ranges of other universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_SOFTPATCH_H_
+#define OLAD_PLUGIN_API_SOFTPATCH_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "olad/plugin_api/Client.h"
+
+namespace ola {
+
+class Preferences;
+class Universe;
+class UniverseStore;
+
+/**
+ * @brief Copies slot ranges from source universes into target universes.
+ *
+ * Each patch maps a range of slots in a source universe to a position in a
+ * target universe. When patches are added they're compiled into a table of
+ * copy runs for each source universe, adjacent ranges are joined so a block
+ * patched in pieces is still a single copy.
+ *
+ * The universes call SourceUpdated() each time they write to their outputs,
+ * including the periodic refreshes of unchanged data. The runs for the
+ * universe are copied into the target buffers, and the targets are passed to
+ * their universes as the data of a source client, at the default priority.
+ * The target universes merge this with any other sources as usual.
+ *
+ * A target universe can't also be a source, so there are no cycles.
+ *
+ * The patches are loaded from the softpatch preferences, one patch value per
+ * mapping with 1-based slots:
+ * @code
+ *   patch = 1:1-24 10:1
+ * @endcode
+ * copies slots 1 to 24 of universe 1 to slots 1 to 24 of universe 10.
+ */
+class SoftPatch {
+ public:
+  /**
+   * @brief A single mapping, the slots are 0-based.
+   */
+  struct Patch {
+    unsigned int source_universe;
+    unsigned int source_slot;
+    unsigned int length;
+    unsigned int target_universe;
+    unsigned int target_slot;
+  };
+
+  /**
+   * @brief Create a new SoftPatch.
+   * @param universe_store the UniverseStore the target universes are fetched
+   *   from, ownership is not transferred.
+   */
+  explicit SoftPatch(UniverseStore *universe_store);
+
+  ~SoftPatch();
+
+  /**
+   * @brief Add the patches in a Preferences object.
+   * @param preferences the Preferences to read the patch values from.
+   * @returns the number of patches added, invalid values are logged and
+   *   skipped.
+   */
+  unsigned int Load(const Preferences &preferences);
+
+  /**
+   * @brief Add a patch.
+   * @param patch the Patch to add.
+   * @returns true if the patch was added, false if the slots are out of range
+   *   or the patch would create a cycle.
+   */
+  bool AddPatch(const Patch &patch);
+
+  /**
+   * @brief Check if a universe is the source of any patches.
+   */
+  bool IsSource(unsigned int universe_id) const {
+    return m_gathers.find(universe_id) != m_gathers.end();
+  }
+
+  /**
+   * @brief The number of target universes.
+   */
+  unsigned int TargetCount() const { return m_targets.size(); }
+
+  /**
+   * @brief The number of copy runs, after adjacent ranges were joined.
+   */
+  unsigned int RunCount() const;
+
+  /**
+   * @brief Called when a universe writes to its outputs.
+   * @param universe the universe that was updated.
+   * @param now the time of the update.
+   */
+  void SourceUpdated(const Universe &universe, const TimeStamp &now);
+
+  /**
+   * @brief Parse a patch value.
+   * @param value the value, in the form
+   *   <tt>source:first-last target:slot</tt>, with 1-based slots.
+   * @param[out] patch the parsed Patch.
+   * @returns true if the value was valid.
+   */
+  static bool ParsePatch(const std::string &value, Patch *patch);
+
+  static const char PATCH_KEY[];
+
+ private:
+  struct Target {
+    unsigned int universe_id;
+    DmxBuffer buffer;
+    bool touched;
+  };
+
+  struct Gather {
+    Target *target;
+    uint16_t source_offset;
+    uint16_t target_offset;
+    uint16_t length;
+  };
+
+  typedef std::vector<Gather> GatherList;
+  typedef std::map<unsigned int, GatherList> GatherMap;
+  typedef std::map<unsigned int, Target*> TargetMap;
+
+  UniverseStore *m_universe_store;
+  Client m_client;
+  GatherMap m_gathers;
+  TargetMap m_targets;
+  std::vector<Target*> m_touched;
+
+  Target *GetTarget(unsigned int universe_id, unsigned int size);
+  void SendTarget(Target *target, const TimeStamp &now);
+
+  DISALLOW_COPY_AND_ASSIGN(SoftPatch);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_SOFTPATCH_H_
@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SoftPatchTest.cpp
+ * Test fixture for the SoftPatch class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/SoftPatch.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::DmxBuffer;
+using ola::MemoryPreferences;
+using ola::SoftPatch;
+using ola::Universe;
+using ola::UniverseStore;
+using std::auto_ptr;
+using std::string;
+
+class SoftPatchTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SoftPatchTest);
+  CPPUNIT_TEST(testParsePatch);
+  CPPUNIT_TEST(testAddPatch);
+  CPPUNIT_TEST(testLoad);
+  CPPUNIT_TEST(testForwarding);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testParsePatch();
+  void testAddPatch();
+  void testLoad();
+  void testForwarding();
+
+ private:
+  auto_ptr<UniverseStore> m_store;
+  auto_ptr<SoftPatch> m_soft_patch;
+
+  static SoftPatch::Patch MakePatch(unsigned int source_universe,
+                                    unsigned int source_slot,
+                                    unsigned int length,
+                                    unsigned int target_universe,
+                                    unsigned int target_slot);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SoftPatchTest);
+
+void SoftPatchTest::setUp() {
+  m_store.reset(new UniverseStore(NULL, NULL));
+  m_soft_patch.reset(new SoftPatch(m_store.get()));
+  m_store->SetSoftPatch(m_soft_patch.get());
+}
+
+void SoftPatchTest::tearDown() {
+  m_store->DeleteAll();
+  m_store.reset();
+  m_soft_patch.reset();
+}
+
+SoftPatch::Patch SoftPatchTest::MakePatch(unsigned int source_universe,
+                                          unsigned int source_slot,
+                                          unsigned int length,
+                                          unsigned int target_universe,
+                                          unsigned int target_slot) {
+  SoftPatch::Patch patch;
+  patch.source_universe = source_universe;
+  patch.source_slot = source_slot;
+  patch.length = length;
+  patch.target_universe = target_universe;
+  patch.target_slot = target_slot;
+  return patch;
+}
+
+/*
+ * Check patch values are parsed.
+ */
+void SoftPatchTest::testParsePatch() {
+  SoftPatch::Patch patch;
+  OLA_ASSERT_TRUE(SoftPatch::ParsePatch("1:1-24 10:1", &patch));
+  OLA_ASSERT_EQ(1u, patch.source_universe);
+  OLA_ASSERT_EQ(0u, patch.source_slot);
+  OLA_ASSERT_EQ(24u, patch.length);
+  OLA_ASSERT_EQ(10u, patch.target_universe);
+  OLA_ASSERT_EQ(0u, patch.target_slot);
+
+  OLA_ASSERT_TRUE(SoftPatch::ParsePatch("  2:512   3:100 ", &patch));
+  OLA_ASSERT_EQ(2u, patch.source_universe);
+  OLA_ASSERT_EQ(511u, patch.source_slot);
+  OLA_ASSERT_EQ(1u, patch.length);
+  OLA_ASSERT_EQ(3u, patch.target_universe);
+  OLA_ASSERT_EQ(99u, patch.target_slot);
+
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:1-24", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:0-24 10:1", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:24-1 10:1", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:1-513 10:1", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:1-24 10:1-24", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:1-24 10:500", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("a:1-24 10:1", &patch));
+  OLA_ASSERT_FALSE(SoftPatch::ParsePatch("1:1-24 10:1 11:1", &patch));
+}
+
+/*
+ * Check adjacent patches are joined, and cycles are rejected.
+ */
+void SoftPatchTest::testAddPatch() {
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(1, 0, 10, 10, 0)));
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(1, 10, 10, 10, 10)));
+  OLA_ASSERT_EQ(1u, m_soft_patch->RunCount());
+  // Not adjacent in the target
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(1, 20, 10, 10, 40)));
+  OLA_ASSERT_EQ(2u, m_soft_patch->RunCount());
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(2, 0, 10, 11, 0)));
+  OLA_ASSERT_EQ(3u, m_soft_patch->RunCount());
+  OLA_ASSERT_EQ(2u, m_soft_patch->TargetCount());
+
+  OLA_ASSERT_TRUE(m_soft_patch->IsSource(1));
+  OLA_ASSERT_TRUE(m_soft_patch->IsSource(2));
+  OLA_ASSERT_FALSE(m_soft_patch->IsSource(10));
+
+  // Cycles
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(3, 0, 10, 3, 0)));
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(10, 0, 10, 12, 0)));
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(3, 0, 10, 1, 0)));
+
+  // Out of range
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(3, 0, 0, 12, 0)));
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(3, 500, 20, 12, 0)));
+  OLA_ASSERT_FALSE(m_soft_patch->AddPatch(MakePatch(3, 0, 20, 12, 500)));
+  OLA_ASSERT_EQ(3u, m_soft_patch->RunCount());
+}
+
+/*
+ * Check the patches are loaded from the preferences.
+ */
+void SoftPatchTest::testLoad() {
+  MemoryPreferences preferences("softpatch");
+  preferences.SetMultipleValue(SoftPatch::PATCH_KEY, "1:1-12 10:1");
+  preferences.SetMultipleValue(SoftPatch::PATCH_KEY, "1:13-24 10:13");
+  preferences.SetMultipleValue(SoftPatch::PATCH_KEY, "junk");
+  preferences.SetMultipleValue(SoftPatch::PATCH_KEY, "10:1 1:1");
+  OLA_ASSERT_EQ(2u, m_soft_patch->Load(preferences));
+  OLA_ASSERT_EQ(1u, m_soft_patch->RunCount());
+  OLA_ASSERT_EQ(1u, m_soft_patch->TargetCount());
+}
+
+/*
+ * Check the data is copied to the target universes.
+ */
+void SoftPatchTest::testForwarding() {
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(1, 0, 3, 10, 0)));
+  OLA_ASSERT_TRUE(m_soft_patch->AddPatch(MakePatch(2, 0, 2, 10, 4)));
+
+  Universe *universe1 = m_store->GetUniverseOrCreate(1);
+  Universe *universe2 = m_store->GetUniverseOrCreate(2);
+  OLA_ASSERT_TRUE(universe1->SetDMX(DmxBuffer("abcdef")));
+
+  Universe *target = m_store->GetUniverse(10);
+  OLA_ASSERT_NOT_NULL(target);
+  OLA_ASSERT_EQ(1u, target->SourceClientCount());
+  OLA_ASSERT_EQ(DmxBuffer(string("abc\0\0\0", 6)), target->GetDMX());
+
+  TestMockOutputPort port(NULL, 1);
+  target->AddPort(&port);
+  OLA_ASSERT_TRUE(universe2->SetDMX(DmxBuffer("xy")));
+  OLA_ASSERT_EQ(DmxBuffer(string("abc\0xy", 6)), target->GetDMX());
+  OLA_ASSERT_EQ(DmxBuffer(string("abc\0xy", 6)), port.ReadDMX());
+
+  // A short source only updates the slots it has.
+  OLA_ASSERT_TRUE(universe1->SetDMX(DmxBuffer("z")));
+  OLA_ASSERT_EQ(DmxBuffer(string("zbc\0xy", 6)), port.ReadDMX());
+  target->RemovePort(&port);
+}
@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SourceExpiryScheduler.cpp
+ * Times out DMX sources when they stop sending.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "olad/plugin_api/SourceExpiryScheduler.h"
+
+#include <vector>
+
+#include "ola/Callback.h"
+#include "olad/Universe.h"
+
+namespace ola {
+
+using std::vector;
+
+SourceExpiryScheduler::SourceExpiryScheduler(
+    ola::thread::SchedulerInterface *scheduler,
+    const Clock *clock)
+    : m_scheduler(scheduler),
+      m_clock(clock),
+      m_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+
+SourceExpiryScheduler::~SourceExpiryScheduler() {
+  if (m_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+}
+
+
+void SourceExpiryScheduler::Schedule(Universe *universe,
+                                     const TimeStamp &expiry) {
+  UniverseMap::iterator iter = m_universes.find(universe);
+  if (iter != m_universes.end()) {
+    m_deadlines.erase(std::make_pair(iter->second, universe));
+    iter->second = expiry;
+  } else {
+    m_universes[universe] = expiry;
+  }
+  m_deadlines.insert(std::make_pair(expiry, universe));
+  UpdateTimer();
+}
+
+
+void SourceExpiryScheduler::Cancel(Universe *universe) {
+  UniverseMap::iterator iter = m_universes.find(universe);
+  if (iter != m_universes.end()) {
+    m_deadlines.erase(std::make_pair(iter->second, universe));
+    m_universes.erase(iter);
+  }
+  // If that was the earliest deadline the timer fires early, which is
+  // harmless.
+}
+
+
+/*
+ * Make sure the timer fires no later than the earliest deadline.
+ */
+void SourceExpiryScheduler::UpdateTimer() {
+  if (m_deadlines.empty()) {
+    return;
+  }
+
+  const TimeStamp &next = m_deadlines.begin()->first;
+  if (m_timeout != ola::thread::INVALID_TIMEOUT) {
+    if (m_timeout_time <= next) {
+      return;
+    }
+    m_scheduler->RemoveTimeout(m_timeout);
+  }
+
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  m_timeout_time = next;
+  m_timeout = m_scheduler->RegisterSingleTimeout(
+      next > now ? next - now : TimeInterval(0, 0),
+      NewSingleCallback(this, &SourceExpiryScheduler::ExpireSources));
+}
+
+
+/*
+ * Call the universes with deadlines that have passed.
+ */
+void SourceExpiryScheduler::ExpireSources() {
+  m_timeout = ola::thread::INVALID_TIMEOUT;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  // Universes re-register as they expire their sources, so remove them all
+  // first.
+  vector<Universe*> due;
+  while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+    due.push_back(m_deadlines.begin()->second);
+    m_universes.erase(m_deadlines.begin()->second);
+    m_deadlines.erase(m_deadlines.begin());
+  }
+
+  vector<Universe*>::iterator iter = due.begin();
+  for (; iter != due.end(); ++iter) {
+    (*iter)->ExpireSources();
+  }
+  UpdateTimer();
+}
+}  // namespace ola
@@ -0,0 +1,98 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SourceExpiryScheduler.h
+ * Times out DMX sources when they stop sending.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_SOURCEEXPIRYSCHEDULER_H_
+#define OLAD_PLUGIN_API_SOURCEEXPIRYSCHEDULER_H_
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+
+class Universe;
+
+/**
+ * @brief Tells universes when their sources time out.
+ *
+ * A DmxSource that stops sending times out after DmxSource::TIMEOUT_INTERVAL.
+ * Rather than scanning every universe for stale sources, each universe
+ * registers the time its next source expires, and is called back at that
+ * time to drop the source and re-merge.
+ *
+ * All universes share a single timer, which is set for the earliest
+ * deadline. Universes without any sources aren't registered, so they cost
+ * nothing.
+ */
+class SourceExpiryScheduler {
+ public:
+  /**
+   * @brief Create a new SourceExpiryScheduler.
+   * @param scheduler the SchedulerInterface to use for the timer.
+   * @param clock the Clock the deadlines are measured with, this should be
+   *   the same clock the universes use to timestamp their sources. Ownership
+   *   is not transferred.
+   */
+  SourceExpiryScheduler(ola::thread::SchedulerInterface *scheduler,
+                        const Clock *clock);
+
+  ~SourceExpiryScheduler();
+
+  /**
+   * @brief Call Universe::ExpireSources() once a deadline has passed.
+   * @param universe the Universe to call.
+   * @param expiry the time the universe's next source times out. This
+   *   replaces any earlier deadline for the universe.
+   */
+  void Schedule(Universe *universe, const TimeStamp &expiry);
+
+  /**
+   * @brief Remove a universe that is being deleted.
+   * @param universe the Universe to remove.
+   */
+  void Cancel(Universe *universe);
+
+  /**
+   * @brief The number of universes waiting for a deadline.
+   */
+  unsigned int PendingCount() const { return m_deadlines.size(); }
+
+ private:
+  typedef std::set<std::pair<TimeStamp, Universe*> > DeadlineSet;
+  typedef std::map<Universe*, TimeStamp> UniverseMap;
+
+  ola::thread::SchedulerInterface *m_scheduler;
+  const Clock *m_clock;
+  ola::thread::timeout_id m_timeout;
+  TimeStamp m_timeout_time;
+  DeadlineSet m_deadlines;
+  UniverseMap m_universes;
+
+  void UpdateTimer();
+  void ExpireSources();
+
+  DISALLOW_COPY_AND_ASSIGN(SourceExpiryScheduler);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_SOURCEEXPIRYSCHEDULER_H_
@@ -53,8 +53,12 @@ class TestMockInputPort: public ola::BasicInputPort {
   }
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
 
+  void SetArrivalTime(const ola::TimeStamp &arrival) { m_arrival = arrival; }
+  ola::TimeStamp ArrivalTime() const { return m_arrival; }
+
  private:
   ola::DmxBuffer m_buffer;
+  ola::TimeStamp m_arrival;
 };
 
 
@@ -78,11 +82,20 @@ class TestMockPriorityInputPort: public TestMockInputPort {
     m_inherited_priority = priority;
   }
 
+  const ola::DmxBuffer *InheritedSlotPriorities() const {
+    return &m_slot_priorities;
+  }
+
+  void SetInheritedSlotPriorities(const ola::DmxBuffer &priorities) {
+    m_slot_priorities = priorities;
+  }
+
  protected:
   bool SupportsPriorities() const { return true; }
 
  private:
   uint8_t m_inherited_priority;
+  ola::DmxBuffer m_slot_priorities;
 };
 
 
@@ -161,8 +174,12 @@ class TestMockRDMOutputPort: public TestMockOutputPort {
     on_complete->Run(*m_uids);
   }
 
+  void SeedUIDs(const ola::rdm::UIDSet &uids) { m_seeded_uids = uids; }
+  const ola::rdm::UIDSet &SeededUIDs() const { return m_seeded_uids; }
+
  private:
   ola::rdm::UIDSet *m_uids;
+  ola::rdm::UIDSet m_seeded_uids;
   std::auto_ptr<RDMRequestHandler> m_rdm_handler;
 };
 
@@ -30,25 +30,33 @@
  *   A list of sink clients, which we update whenever the DmxBuffer changes.
  */
 
+#include <string.h>
 #include <algorithm>
 #include <iterator>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ola/Constants.h"
 #include "ola/base/Array.h"
 #include "ola/Logging.h"
 #include "ola/MultiCallback.h"
+#include "ola/dmx/UniverseSharedMemory.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMTimingStats.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
+#include "ola/util/Trace.h"
 #include "olad/Port.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/FrameRecorderInterface.h"
+#include "olad/plugin_api/OutputScheduler.h"
+#include "olad/plugin_api/SoftPatch.h"
+#include "olad/plugin_api/SourceExpiryScheduler.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
@@ -56,16 +64,32 @@ namespace ola {
 using ola::rdm::RDMDiscoveryCallback;
 using ola::rdm::RDMReply;
 using ola::rdm::RDMRequest;
+using ola::rdm::RDMTimingStats;
 using ola::rdm::RunRDMCallback;
 using ola::rdm::UID;
 using ola::strings::ToHex;
 using std::auto_ptr;
 using std::map;
 using std::ostringstream;
-using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+/*
+ * Return the source that got data most recently.
+ */
+const DmxSource &NewestSource(const vector<DmxSource> &sources) {
+  vector<DmxSource>::const_iterator newest = sources.begin();
+  vector<DmxSource>::const_iterator iter = sources.begin();
+  for (; iter != sources.end(); ++iter) {
+    if (newest->Timestamp() < iter->Timestamp()) {
+      newest = iter;
+    }
+  }
+  return *newest;
+}
+}  // namespace
+
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
@@ -78,25 +102,112 @@ const char Universe::K_UNIVERSE_RDM_REQUESTS[] = "universe-rdm-requests";
 const char Universe::K_UNIVERSE_SINK_CLIENTS_VAR[] = "universe-sink-clients";
 const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
     "universe-source-clients";
+const char Universe::K_UNIVERSE_UNCHANGED_FRAMES_VAR[] =
+  "universe-unchanged-frames";
+const char Universe::K_UNIVERSE_COALESCED_FRAMES_VAR[] =
+  "universe-coalesced-frames";
+const char Universe::K_UNIVERSE_PORT_SKIPPED_FRAMES_VAR[] =
+  "universe-port-skipped-frames";
+const char Universe::K_UNIVERSE_MERGES_SKIPPED_VAR[] =
+  "universe-merges-skipped";
+const char Universe::K_UNIVERSE_LATENCY_P50_VAR[] =
+  "universe-latency-p50-usec";
+const char Universe::K_UNIVERSE_LATENCY_P99_VAR[] =
+  "universe-latency-p99-usec";
+const char Universe::K_UNIVERSE_LATENCY_MAX_VAR[] =
+  "universe-latency-max-usec";
+const char Universe::K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR[] =
+  "universe-arrival-latency-p50-usec";
+const char Universe::K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR[] =
+  "universe-arrival-latency-p99-usec";
+const char Universe::K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR[] =
+  "universe-arrival-latency-max-usec";
+const char Universe::K_UNIVERSE_MERGE_TIME_P50_VAR[] =
+  "universe-merge-p50-usec";
+const char Universe::K_UNIVERSE_MERGE_TIME_P99_VAR[] =
+  "universe-merge-p99-usec";
+const char Universe::K_UNIVERSE_MERGE_TIME_MAX_VAR[] =
+  "universe-merge-max-usec";
+const char Universe::K_UNIVERSE_MEMORY_VAR[] = "universe-memory-bytes";
+const char Universe::K_RDM_PORT_REQUESTS_VAR[] = "rdm-port-requests";
+const char Universe::K_RDM_PORT_TIMEOUTS_VAR[] = "rdm-port-timeouts";
+const char Universe::K_RDM_PORT_ACK_TIMERS_VAR[] = "rdm-port-ack-timers";
+const char Universe::K_RDM_PORT_RETRANSMITS_VAR[] = "rdm-port-retransmits";
+const char Universe::K_RDM_PORT_LATENCY_P50_VAR[] =
+  "rdm-port-latency-p50-usec";
+const char Universe::K_RDM_PORT_LATENCY_P99_VAR[] =
+  "rdm-port-latency-p99-usec";
+const char Universe::K_RDM_PORT_LATENCY_MAX_VAR[] =
+  "rdm-port-latency-max-usec";
+const char Universe::K_RDM_RESPONDER_REQUESTS_VAR[] = "rdm-responder-requests";
+const char Universe::K_RDM_RESPONDER_TIMEOUTS_VAR[] = "rdm-responder-timeouts";
+const char Universe::K_RDM_RESPONDER_ACK_TIMERS_VAR[] =
+  "rdm-responder-ack-timers";
+const char Universe::K_RDM_RESPONDER_RETRANSMITS_VAR[] =
+  "rdm-responder-retransmits";
+const char Universe::K_RDM_RESPONDER_LATENCY_P50_VAR[] =
+  "rdm-responder-latency-p50-usec";
+const char Universe::K_RDM_RESPONDER_LATENCY_P99_VAR[] =
+  "rdm-responder-latency-p99-usec";
+const char Universe::K_RDM_RESPONDER_LATENCY_MAX_VAR[] =
+  "rdm-responder-latency-max-usec";
+
+namespace {
+// The RDM timing variables, in the order ExportRDMTiming() sets them.
+const char *const RDM_PORT_TIMING_VARS[] = {
+  Universe::K_RDM_PORT_REQUESTS_VAR,
+  Universe::K_RDM_PORT_TIMEOUTS_VAR,
+  Universe::K_RDM_PORT_ACK_TIMERS_VAR,
+  Universe::K_RDM_PORT_RETRANSMITS_VAR,
+  Universe::K_RDM_PORT_LATENCY_P50_VAR,
+  Universe::K_RDM_PORT_LATENCY_P99_VAR,
+  Universe::K_RDM_PORT_LATENCY_MAX_VAR,
+};
+
+const char *const RDM_RESPONDER_TIMING_VARS[] = {
+  Universe::K_RDM_RESPONDER_REQUESTS_VAR,
+  Universe::K_RDM_RESPONDER_TIMEOUTS_VAR,
+  Universe::K_RDM_RESPONDER_ACK_TIMERS_VAR,
+  Universe::K_RDM_RESPONDER_RETRANSMITS_VAR,
+  Universe::K_RDM_RESPONDER_LATENCY_P50_VAR,
+  Universe::K_RDM_RESPONDER_LATENCY_P99_VAR,
+  Universe::K_RDM_RESPONDER_LATENCY_MAX_VAR,
+};
+}  // namespace
 
 /*
  * Create a new universe
  * @param uid  the universe id of this universe
  * @param store the store this universe came from
  * @param export_map the ExportMap that we update
+ * @param clock the Clock used for timing
+ * @param loop_clock the Clock used to check sources and output rates, if NULL
+ *   clock is used.
  */
 Universe::Universe(unsigned int universe_id, UniverseStore *store,
                    ExportMap *export_map,
-                   Clock *clock)
+                   Clock *clock,
+                   const Clock *loop_clock)
     : m_universe_name(""),
       m_universe_id(universe_id),
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
       m_merge_mode(Universe::MERGE_LTP),
+      m_info_version(0),
       m_universe_store(store),
       m_export_map(export_map),
       m_clock(clock),
+      m_loop_clock(loop_clock ? loop_clock : clock),
       m_rdm_discovery_interval(),
-      m_last_discovery_time() {
+      m_last_discovery_time(),
+      m_htp_merge_valid(false),
+      m_slot_owners_valid(false),
+      m_cut_through_key(NULL),
+      m_last_output_time(),
+      m_last_output_priority(ola::dmx::SOURCE_PRIORITY_MIN),
+      m_outputs_stale(true),
+      m_max_frame_rate(0),
+      m_output_pending(false),
+      m_ports_pending(false) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -114,12 +225,36 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UNCHANGED_FRAMES_VAR,
+    K_UNIVERSE_COALESCED_FRAMES_VAR,
+    K_UNIVERSE_PORT_SKIPPED_FRAMES_VAR,
+    K_UNIVERSE_MERGES_SKIPPED_VAR,
+    K_UNIVERSE_LATENCY_P50_VAR,
+    K_UNIVERSE_LATENCY_P99_VAR,
+    K_UNIVERSE_LATENCY_MAX_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR,
+    K_UNIVERSE_MERGE_TIME_P50_VAR,
+    K_UNIVERSE_MERGE_TIME_P99_VAR,
+    K_UNIVERSE_MERGE_TIME_MAX_VAR,
+    K_UNIVERSE_MEMORY_VAR,
   };
 
   if (m_export_map) {
     for (unsigned int i = 0; i < arraysize(vars); ++i) {
       (*m_export_map->GetUIntMapVar(vars[i]))[m_universe_id_str] = 0;
     }
+    m_frames_var = UniverseVarHandle(K_FPS_VAR);
+    m_coalesced_frames_var = UniverseVarHandle(
+        K_UNIVERSE_COALESCED_FRAMES_VAR);
+    m_unchanged_frames_var = UniverseVarHandle(
+        K_UNIVERSE_UNCHANGED_FRAMES_VAR);
+    m_port_skipped_frames_var = UniverseVarHandle(
+        K_UNIVERSE_PORT_SKIPPED_FRAMES_VAR);
+    m_merges_skipped_var = UniverseVarHandle(K_UNIVERSE_MERGES_SKIPPED_VAR);
+    m_memory_var = UniverseVarHandle(K_UNIVERSE_MEMORY_VAR);
+    m_memory_var.Set(MemoryUsage());
   }
 
   // We set the last discovery time to now, since most ports will trigger
@@ -132,6 +267,15 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  if ((m_output_pending || m_ports_pending) && m_universe_store &&
+      m_universe_store->GetOutputScheduler()) {
+    m_universe_store->GetOutputScheduler()->Cancel(this);
+  }
+  if (m_source_expiry.IsSet() && m_universe_store &&
+      m_universe_store->GetSourceExpiryScheduler()) {
+    m_universe_store->GetSourceExpiryScheduler()->Cancel(this);
+  }
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -145,6 +289,20 @@ Universe::~Universe() {
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UNCHANGED_FRAMES_VAR,
+    K_UNIVERSE_COALESCED_FRAMES_VAR,
+    K_UNIVERSE_PORT_SKIPPED_FRAMES_VAR,
+    K_UNIVERSE_MERGES_SKIPPED_VAR,
+    K_UNIVERSE_LATENCY_P50_VAR,
+    K_UNIVERSE_LATENCY_P99_VAR,
+    K_UNIVERSE_LATENCY_MAX_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR,
+    K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR,
+    K_UNIVERSE_MERGE_TIME_P50_VAR,
+    K_UNIVERSE_MERGE_TIME_P99_VAR,
+    K_UNIVERSE_MERGE_TIME_MAX_VAR,
+    K_UNIVERSE_MEMORY_VAR,
   };
 
   if (m_export_map) {
@@ -155,6 +313,10 @@ Universe::~Universe() {
       m_export_map->GetUIntMapVar(uint_vars[i])->Remove(m_universe_id_str);
     }
   }
+
+  while (!m_rdm_timing.empty()) {
+    RemoveRDMTiming(m_rdm_timing.begin()->first);
+  }
 }
 
 
@@ -163,8 +325,12 @@ Universe::~Universe() {
  * @param name the new universe name
  */
 void Universe::SetName(const string &name) {
+  bool changed = name != m_universe_name;
   m_universe_name = name;
   UpdateName();
+  if (changed) {
+    InfoChanged();
+  }
 
   // notify ports
   vector<OutputPort*>::const_iterator iter;
@@ -179,8 +345,12 @@ void Universe::SetName(const string &name) {
  * @param merge_mode the new merge_mode
  */
 void Universe::SetMergeMode(enum merge_mode merge_mode) {
+  bool changed = merge_mode != m_merge_mode;
   m_merge_mode = merge_mode;
   UpdateMode();
+  if (changed) {
+    InfoChanged();
+  }
 }
 
 
@@ -189,7 +359,12 @@ void Universe::SetMergeMode(enum merge_mode merge_mode) {
  * @param port the port to add
  */
 bool Universe::AddPort(InputPort *port) {
-  return GenericAddPort(port, &m_input_ports);
+  bool ret = GenericAddPort(port, &m_input_ports, &m_input_port_index);
+  UpdateCutThrough();
+  if (ret) {
+    InfoChanged();
+  }
+  return ret;
 }
 
 
@@ -198,7 +373,18 @@ bool Universe::AddPort(InputPort *port) {
  * @param port the port to add
  */
 bool Universe::AddPort(OutputPort *port) {
-  return GenericAddPort(port, &m_output_ports);
+  bool ret = GenericAddPort(port, &m_output_ports, &m_output_port_index);
+  if (m_buffer.Size()) {
+    // The sources may not send again until something changes, so the port
+    // gets the current data now.
+    port->WriteDMX(m_buffer, m_active_priority);
+  } else {
+    m_outputs_stale = true;
+  }
+  if (ret) {
+    InfoChanged();
+  }
+  return ret;
 }
 
 
@@ -208,7 +394,12 @@ bool Universe::AddPort(OutputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(InputPort *port) {
-  return GenericRemovePort(port, &m_input_ports);
+  bool ret = GenericRemovePort(port, &m_input_ports, &m_input_port_index);
+  UpdateCutThrough();
+  if (ret) {
+    InfoChanged();
+  }
+  return ret;
 }
 
 
@@ -218,7 +409,12 @@ bool Universe::RemovePort(InputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(OutputPort *port) {
-  bool ret = GenericRemovePort(port, &m_output_ports, &m_output_uids);
+  bool ret = GenericRemovePort(port, &m_output_ports, &m_output_port_index,
+                               &m_output_uids);
+  if (ret) {
+    RemoveRDMTiming(port->UniqueId());
+    InfoChanged();
+  }
 
   if (m_export_map) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
@@ -234,7 +430,7 @@ bool Universe::RemovePort(OutputPort *port) {
  * @return true if the port exists in this universe, false otherwise
  */
 bool Universe::ContainsPort(InputPort *port) const {
-  return GenericContainsPort(port, m_input_ports);
+  return m_input_port_index.Contains(port);
 }
 
 
@@ -244,7 +440,7 @@ bool Universe::ContainsPort(InputPort *port) const {
  * @return true if the port exists in this universe, false otherwise
  */
 bool Universe::ContainsPort(OutputPort *port) const {
-  return GenericContainsPort(port, m_output_ports);
+  return m_output_port_index.Contains(port);
 }
 
 
@@ -278,12 +474,13 @@ void Universe::OutputPorts(vector<OutputPort*> *ports) const {
 bool Universe::AddSourceClient(Client *client) {
   // Check to see if it exists already. It doesn't make sense to have multiple
   //  clients
-  if (STLReplace(&m_source_clients, client, false)) {
+  if (m_source_clients.Replace(client, false)) {
     return true;
   }
 
   OLA_INFO << "Added source client, " << client << " to universe "
            << m_universe_id;
+  UpdateCutThrough();
 
   SafeIncrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
   return true;
@@ -298,11 +495,12 @@ bool Universe::AddSourceClient(Client *client) {
  * @return true is this client was removed, false if it didn't exist
  */
 bool Universe::RemoveSourceClient(Client *client) {
-  if (!STLRemove(&m_source_clients, client)) {
+  if (!m_source_clients.Remove(client)) {
     return false;
   }
 
   SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+  UpdateCutThrough();
 
   OLA_INFO << "Source client " << client << " has been removed from uni "
            << m_universe_id;
@@ -320,7 +518,7 @@ bool Universe::RemoveSourceClient(Client *client) {
  * @returns true if this universe contains the client, false otherwise
  */
 bool Universe::ContainsSourceClient(Client *client) const {
-  return STLContains(m_source_clients, client);
+  return m_source_clients.Contains(client);
 }
 
 
@@ -330,12 +528,13 @@ bool Universe::ContainsSourceClient(Client *client) const {
  * @return true if client was added, and false if it was already a sink client
  */
 bool Universe::AddSinkClient(Client *client) {
-  if (!STLInsertIfNotPresent(&m_sink_clients, client)) {
+  if (!m_sink_clients.Insert(client)) {
     return false;
   }
 
   OLA_INFO << "Added sink client, " << client << " to universe "
            << m_universe_id;
+  m_outputs_stale = true;
 
   SafeIncrement(K_UNIVERSE_SINK_CLIENTS_VAR);
   return true;
@@ -350,7 +549,7 @@ bool Universe::AddSinkClient(Client *client) {
  * @return true is this client was removed, false if it didn't exist
  */
 bool Universe::RemoveSinkClient(Client *client) {
-  if (!STLRemove(&m_sink_clients, client)) {
+  if (!m_sink_clients.Remove(client)) {
     return false;
   }
 
@@ -371,7 +570,7 @@ bool Universe::RemoveSinkClient(Client *client) {
  * @returns true if this universe contains the client, false otherwise
  */
 bool Universe::ContainsSinkClient(Client *client) const {
-  return STLContains(m_sink_clients, client);
+  return m_sink_clients.Contains(client);
 }
 
 
@@ -388,15 +587,57 @@ bool Universe::SetDMX(const DmxBuffer &buffer) {
     return true;
   }
   m_buffer.Set(buffer);
+  m_htp_merge_valid = false;
   return UpdateDependants();
 }
 
 
+void Universe::RestoreDMX(const DmxBuffer &buffer) {
+  m_buffer.Set(buffer);
+  m_htp_merge_valid = false;
+}
+
+
+void Universe::RefreshOutputs(const TimeStamp &now) {
+  // A soft patch source needs refreshing even if it has no outputs, so the
+  // targets don't time out.
+  // The frames held by rate limited ports are normally written by the
+  // OutputScheduler, this catches them if there isn't one.
+  if (m_ports_pending) {
+    WritePendingPorts(now);
+  }
+
+  SoftPatch *soft_patch = m_universe_store ?
+      m_universe_store->GetSoftPatch() : NULL;
+  if (!m_buffer.Size() || m_output_pending ||
+      (m_output_ports.empty() && !m_sink_clients.Size() &&
+       !(soft_patch && soft_patch->IsSource(m_universe_id))) ||
+      now - m_last_output_time <
+        TimeInterval(K_OUTPUT_REFRESH_INTERVAL_MS * ONE_THOUSAND)) {
+    return;
+  }
+  WriteToDependants(now);
+}
+
+
+void Universe::FlushOutputs() {
+  if (!m_buffer.Size()) {
+    return;
+  }
+  TimeStamp now;
+  m_loop_clock->CurrentTime(&now);
+  m_outputs_stale = true;
+  WriteToDependants(now);
+}
+
+
 /*
  * Call this when the dmx in a port that is part of this universe changes
  * @param port the port that has changed
  */
 bool Universe::PortDataChanged(InputPort *port) {
+  ola::TraceSpan span("universe.port_data_changed", "universe",
+                      m_universe_id);
   if (!ContainsPort(port)) {
     OLA_INFO << "Trying to update a port which isn't bound to universe: "
              << UniverseId();
@@ -433,7 +674,7 @@ void Universe::CleanStaleSourceClients() {
   while (iter != m_source_clients.end()) {
     if (iter->second) {
       // if stale remove it
-      m_source_clients.erase(iter++);
+      iter = m_source_clients.Erase(iter);
       SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
       OLA_INFO << "Removed Stale Client";
       if (!IsActive()) {
@@ -445,6 +686,123 @@ void Universe::CleanStaleSourceClients() {
       ++iter;
     }
   }
+  UpdateCutThrough();
+}
+
+
+/*
+ * Remove the source clients that have timed out, and merge what's left.
+ */
+void Universe::ExpireSources() {
+  m_source_expiry = TimeStamp();
+  TimeStamp now;
+  m_loop_clock->CurrentTime(&now);
+
+  bool expired = false;
+  vector<InputPort*>::const_iterator port_iter = m_input_ports.begin();
+  for (; port_iter != m_input_ports.end(); ++port_iter) {
+    expired |= SourceExpired((*port_iter)->SourceData(), now);
+  }
+
+  bool removed = false;
+  SourceClientMap::iterator iter = m_source_clients.begin();
+  while (iter != m_source_clients.end()) {
+    const DmxSource source = iter->first->SourceData(UniverseId());
+    if (source.IsSet() && !source.IsActive(now)) {
+      OLA_INFO << "Source client " << iter->first << " timed out on uni "
+               << m_universe_id;
+      iter = m_source_clients.Erase(iter);
+      SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+      removed = true;
+    } else {
+      ++iter;
+    }
+  }
+  m_last_expiry_check = now;
+  if (removed) {
+    UpdateCutThrough();
+  }
+
+  // This also registers the next deadline.
+  if (MergeAll(NULL, NULL) && (expired || removed)) {
+    UpdateDependants();
+  }
+  if (!m_source_expiry.IsSet()) {
+    // There aren't any active sources left.
+    Compact();
+  }
+
+  if (removed && !IsActive()) {
+    m_universe_store->AddUniverseGarbageCollection(this);
+  }
+}
+
+
+/*
+ * The merge vectors keep their capacity between frames, so swap them with
+ * empty ones to release the memory.
+ */
+void Universe::Compact() {
+  vector<DmxSource>().swap(m_scan_sources);
+  vector<DmxSource>().swap(m_merge_sources);
+  vector<const void*>().swap(m_scan_keys);
+  vector<const void*>().swap(m_merge_keys);
+  vector<uint16_t>().swap(m_slot_owners);
+  vector<uint8_t>().swap(m_priority_scratch);
+  m_htp_merge_valid = false;
+  m_slot_owners_valid = false;
+  m_latency.reset();
+  m_arrival_latency.reset();
+  m_merge_time.reset();
+  ExportMemoryUsage();
+}
+
+
+unsigned int Universe::MemoryUsage() const {
+  // The per-entry cost of a std::map or std::set, on top of the value.
+  const unsigned int node_overhead = 4 * sizeof(void*);
+
+  size_t bytes = sizeof(*this);
+  bytes += m_universe_name.capacity() + m_universe_id_str.capacity();
+  bytes += m_buffer.Size();
+  bytes += (m_input_ports.capacity() + m_output_ports.capacity() +
+            m_input_port_index.Size() + m_output_port_index.Size() +
+            m_sink_clients.Size()) * sizeof(void*);
+  bytes += m_source_clients.Size() * sizeof(SourceClientMap::Entry);
+  bytes += (m_scan_sources.capacity() + m_merge_sources.capacity()) *
+           sizeof(DmxSource);
+  bytes += (m_scan_keys.capacity() + m_merge_keys.capacity()) *
+           sizeof(void*);
+  bytes += m_slot_owners.capacity() * sizeof(uint16_t);
+  bytes += m_priority_scratch.capacity();
+  bytes += m_output_uids.size() *
+           (sizeof(ola::rdm::UID) + sizeof(void*) + node_overhead);
+  bytes += m_cached_uids.Size() * (sizeof(ola::rdm::UID) + node_overhead);
+  if (m_latency.get()) {
+    bytes += sizeof(Histogram);
+  }
+  if (m_arrival_latency.get()) {
+    bytes += sizeof(Histogram);
+  }
+  if (m_merge_time.get()) {
+    bytes += sizeof(Histogram);
+  }
+  RDMTimingMap::const_iterator timing = m_rdm_timing.begin();
+  for (; timing != m_rdm_timing.end(); ++timing) {
+    bytes += sizeof(ola::rdm::RDMTimingStats) + timing->first.capacity() +
+             node_overhead;
+    bytes += timing->second->Responders().size() *
+             (sizeof(ola::rdm::UID) + sizeof(RDMTimingStats::Timing) +
+              node_overhead);
+  }
+  return static_cast<unsigned int>(bytes);
+}
+
+
+void Universe::ExportMemoryUsage() {
+  if (m_memory_var.IsValid()) {
+    m_memory_var.Set(MemoryUsage());
+  }
 }
 
 
@@ -507,13 +865,34 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
       OLA_WARN << "Can't find UID " << request->DestinationUID()
                << " in the output universe map, dropping request";
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
-    } else {
-      iter->second->SendRDMRequest(request.release(), callback);
+      return;
+    }
+
+    OutputPort *port = iter->second;
+    const string port_id = port->UniqueId();
+    RDMTimingMap::iterator timing = STLLookupOrInsertNull(&m_rdm_timing,
+                                                          port_id);
+    if (!timing->second) {
+      timing->second = new ola::rdm::RDMTimingStats();
+    }
+    if (callback && timing->second->RecordRequest(*request)) {
+      timed_request_tracker *tracker = new timed_request_tracker(
+          port_id, request->DestinationUID(), callback);
+      m_clock->CurrentTime(&tracker->sent);
+      callback = NewSingleCallback(this, &Universe::HandleTimedRDMReply,
+                                   tracker);
     }
+    port->SendRDMRequest(request.release(), callback);
   }
 }
 
 
+const ola::rdm::RDMTimingStats *Universe::PortRDMTiming(
+    const OutputPort *port) const {
+  return STLFindOrNull(m_rdm_timing, port->UniqueId());
+}
+
+
 /*
  * Trigger RDM discovery for this universe
  */
@@ -563,10 +942,12 @@ void Universe::RunRDMDiscovery(RDMDiscoveryCallback *on_complete, bool full) {
  * Update the UID : port mapping with this new data
  */
 void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
+  bool changed = false;
   map<UID, OutputPort*>::iterator iter = m_output_uids.begin();
   while (iter != m_output_uids.end()) {
     if (iter->second == port && !uids.Contains(iter->first)) {
       m_output_uids.erase(iter++);
+      changed = true;
     } else {
       ++iter;
     }
@@ -577,6 +958,8 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
     iter = m_output_uids.find(*set_iter);
     if (iter == m_output_uids.end()) {
       m_output_uids[*set_iter] = port;
+      m_cached_uids.RemoveUID(*set_iter);
+      changed = true;
     } else if (iter->second != port) {
       OLA_WARN << "UID " << *set_iter << " seen on more than one port";
     }
@@ -586,6 +969,15 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
         = m_output_uids.size();
   }
+
+  if (changed) {
+    InfoChanged();
+  }
+
+  // Ports that are being removed may report an empty list, don't save that.
+  if (changed && m_universe_store && port->GetUniverse() == this) {
+    m_universe_store->SaveUniverseUIDs(this);
+  }
 }
 
 
@@ -593,10 +985,15 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
  * Returns the complete UIDSet for this universe
  */
 void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
+  // The map is sorted, so the UIDs are appended to the set.
+  ola::rdm::UIDSet output_uids;
+  output_uids.Reserve(m_output_uids.size());
   map<UID, OutputPort*>::const_iterator iter = m_output_uids.begin();
   for (; iter != m_output_uids.end(); ++iter) {
-    uids->AddUID(iter->first);
+    output_uids.AddUID(iter->first);
   }
+  output_uids.AddUIDs(m_cached_uids);
+  uids->AddUIDs(output_uids);
 }
 
 
@@ -608,13 +1005,31 @@ unsigned int Universe::UIDCount() const {
 }
 
 
+void Universe::SetCachedUIDs(const ola::rdm::UIDSet &uids) {
+  m_cached_uids.Clear();
+  ola::rdm::UIDSet::Iterator iter = uids.Begin();
+  for (; iter != uids.End(); ++iter) {
+    if (!STLContains(m_output_uids, *iter)) {
+      m_cached_uids.AddUID(*iter);
+    }
+  }
+}
+
+
+void Universe::InfoChanged() {
+  if (m_universe_store) {
+    m_info_version = m_universe_store->UniverseInfoChanged(m_universe_id);
+  }
+}
+
+
 /*
  * Return true if this universe is in use (has at least one port or client).
  */
 bool Universe::IsActive() const {
   // any of the following means the port is active
   return !(m_output_ports.empty() && m_input_ports.empty() &&
-           m_source_clients.empty() && m_sink_clients.empty());
+           m_source_clients.Empty() && m_sink_clients.Empty());
 }
 
 
@@ -624,29 +1039,213 @@ bool Universe::IsActive() const {
 
 /*
  * Called when the dmx data for this universe changes,
- * updates everyone who needs to know (patched ports and network clients)
+ * updates everyone who needs to know (patched ports and network clients).
+ * If the universe has a maximum frame rate, the update is deferred to the
+ * OutputScheduler.
  */
 bool Universe::UpdateDependants() {
+  ola::TraceSpan span("universe.update_dependants", "universe",
+                      m_universe_id);
+  m_frames_var.Increment();
+
+  OutputScheduler *scheduler = NULL;
+  if (m_max_frame_rate && m_universe_store) {
+    scheduler = m_universe_store->GetOutputScheduler();
+  }
+
+  if (scheduler) {
+    // Wait for the scheduler to call RunScheduledOutput()
+    if (m_output_pending) {
+      m_coalesced_frames_var.Increment();
+    } else {
+      m_output_pending = true;
+      scheduler->Schedule(this);
+    }
+    return true;
+  }
+
+  TimeStamp now;
+  m_loop_clock->CurrentTime(&now);
+  return WriteToDependants(now);
+}
+
+
+/*
+ * Write the data to the output ports and sink clients.
+ * If the data and priority are the same as the last update, and we sent it
+ * recently, the update is skipped.
+ * @param now the current time
+ */
+bool Universe::WriteToDependants(const TimeStamp &now) {
   vector<OutputPort*>::const_iterator iter;
-  set<Client*>::const_iterator client_iter;
+  FlatSet<Client*>::const_iterator client_iter;
+
+  // If nothing changed we only send the data often enough to keep the
+  // receivers from timing out.
+  if (!m_buffer.HasChanges() && !m_outputs_stale &&
+      m_active_priority == m_last_output_priority &&
+      now - m_last_output_time <
+        TimeInterval(K_OUTPUT_REFRESH_INTERVAL_MS * ONE_THOUSAND)) {
+    m_unchanged_frames_var.Increment();
+    m_input_time = TimeStamp();
+    m_arrival_time = TimeStamp();
+    return true;
+  }
 
-  // write to all ports assigned to this universe
-  for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
-    (*iter)->WriteDMX(m_buffer, m_active_priority);
+  // write to all ports assigned to this universe, unless another olad has
+  // the outputs. Rate limited ports hold the frame if it's too soon.
+  if (!(m_universe_store && m_universe_store->OutputsHeld())) {
+    bool ports_pending = false;
+    for (iter = m_output_ports.begin(); iter != m_output_ports.end();
+         ++iter) {
+      unsigned int skipped_frames = (*iter)->SkippedFrames();
+      bool admitted = (*iter)->AdmitFrame(now);
+      if ((*iter)->SkippedFrames() != skipped_frames) {
+        m_port_skipped_frames_var.Increment();
+      }
+      if (!admitted) {
+        ports_pending = true;
+        continue;
+      }
+      ola::TraceSpan port_span("port.write_dmx", "universe", m_universe_id);
+      (*iter)->WriteDMX(m_buffer, m_active_priority);
+    }
+    if (ports_pending) {
+      SchedulePendingPorts();
+    }
   }
 
-  // write to all clients
+  // write to all clients, the frame is only serialized once
+  SinkFrame frame(m_universe_id, m_active_priority, m_buffer);
   for (client_iter = m_sink_clients.begin();
        client_iter != m_sink_clients.end();
        ++client_iter) {
-    (*client_iter)->SendDMX(m_universe_id, m_active_priority, m_buffer);
+    (*client_iter)->SendDMX(frame);
+  }
+
+  // Refreshes of unchanged data aren't worth recording.
+  FrameRecorderInterface *recorder = m_universe_store ?
+      m_universe_store->GetFrameRecorder() : NULL;
+  if (recorder && m_buffer.HasChanges()) {
+    recorder->RecordFrame(m_universe_id, now, m_buffer);
+  }
+
+  ola::dmx::UniverseSharedMemory *shared_memory = m_universe_store ?
+      m_universe_store->GetSharedMemory() : NULL;
+  if (shared_memory && (m_buffer.HasChanges() ||
+                        m_active_priority != m_last_output_priority)) {
+    shared_memory->Write(m_universe_id, m_active_priority, m_buffer);
+  }
+
+  SoftPatch *soft_patch = m_universe_store ?
+      m_universe_store->GetSoftPatch() : NULL;
+  if (soft_patch) {
+    soft_patch->SourceUpdated(*this, now);
+  }
+
+  if (m_export_map && m_input_time.IsSet()) {
+    TimeStamp end;
+    m_clock->CurrentTime(&end);
+    AddTimingSample(&m_latency, end - m_input_time,
+                    K_UNIVERSE_LATENCY_P50_VAR, K_UNIVERSE_LATENCY_P99_VAR,
+                    K_UNIVERSE_LATENCY_MAX_VAR);
   }
+  // The kernel's arrival time is from the wall clock, so the latency has to
+  // be too.
+  if (m_export_map && m_arrival_time.IsSet()) {
+    TimeStamp wall_end;
+    m_wall_clock.CurrentTime(&wall_end);
+    AddTimingSample(&m_arrival_latency, wall_end - m_arrival_time,
+                    K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR,
+                    K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR,
+                    K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR);
+  }
+  m_input_time = TimeStamp();
+  m_arrival_time = TimeStamp();
 
-  SafeIncrement(K_FPS_VAR);
+  m_buffer.ClearChanges();
+  m_last_output_time = now;
+  m_last_output_priority = m_active_priority;
+  m_outputs_stale = false;
   return true;
 }
 
 
+/*
+ * Write the held frame to the rate limited ports that are now allowed to
+ * send. This is the trailing send, so the last frame is never lost.
+ * @param now the current time
+ */
+void Universe::WritePendingPorts(const TimeStamp &now) {
+  m_ports_pending = false;
+  if (m_universe_store && m_universe_store->OutputsHeld()) {
+    return;
+  }
+
+  vector<OutputPort*>::const_iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    if (!(*iter)->FramePending()) {
+      continue;
+    }
+    if ((*iter)->AdmitPendingFrame(now)) {
+      ola::TraceSpan port_span("port.write_dmx", "universe", m_universe_id);
+      (*iter)->WriteDMX(m_buffer, m_active_priority);
+    } else {
+      m_ports_pending = true;
+    }
+  }
+}
+
+
+/*
+ * Ask the OutputScheduler to call us back so the held frames are written.
+ */
+void Universe::SchedulePendingPorts() {
+  m_ports_pending = true;
+  OutputScheduler *scheduler = m_universe_store ?
+      m_universe_store->GetOutputScheduler() : NULL;
+  if (scheduler) {
+    scheduler->Schedule(this);
+  }
+}
+
+
+/*
+ * Set the maximum rate at which we write to the outputs.
+ */
+void Universe::SetMaxFrameRate(unsigned int frames_per_second) {
+  m_max_frame_rate = frames_per_second;
+}
+
+
+/*
+ * Called by the OutputScheduler, this writes to the outputs if enough time
+ * has passed since the last write.
+ */
+bool Universe::RunScheduledOutput() {
+  if (!m_output_pending && !m_ports_pending) {
+    return false;
+  }
+
+  TimeStamp now;
+  m_loop_clock->CurrentTime(&now);
+  if (!m_output_pending) {
+    WritePendingPorts(now);
+    return m_ports_pending;
+  }
+
+  if (m_max_frame_rate &&
+      now - m_last_output_time <
+        TimeInterval(USEC_IN_SECONDS / m_max_frame_rate)) {
+    return true;
+  }
+
+  m_output_pending = false;
+  WriteToDependants(now);
+  return m_ports_pending;
+}
+
+
 /*
  * Update the name in the export map.
  */
@@ -678,11 +1277,213 @@ void Universe::UpdateMode() {
  * @param sources the list of DmxSources to merge
  */
 void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
-  vector<DmxSource>::const_iterator iter;
-  m_buffer.Reset();
+  vector<const DmxBuffer*> buffers;
+  buffers.reserve(sources.size());
 
+  vector<DmxSource>::const_iterator iter;
   for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    m_buffer.HTPMerge(iter->Data());
+    buffers.push_back(&iter->Data());
+  }
+  m_buffer.HTPMergeMany(&buffers[0], buffers.size());
+}
+
+
+/*
+ * Get all the active sources, regardless of priority.
+ */
+void Universe::CollectActiveSources(const TimeStamp &now,
+                                    vector<DmxSource> *sources) const {
+  sources->clear();
+  vector<InputPort*>::const_iterator iter;
+  for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
+    const DmxSource &source = (*iter)->SourceData();
+    if (source.IsSet() && source.IsActive(now) && source.Data().Size()) {
+      sources->push_back(source);
+    }
+  }
+
+  SourceClientMap::const_iterator client_iter;
+  for (client_iter = m_source_clients.begin();
+       client_iter != m_source_clients.end();
+       ++client_iter) {
+    const DmxSource source = client_iter->first->SourceData(UniverseId());
+    if (source.IsSet() && source.IsActive(now) && source.Data().Size()) {
+      sources->push_back(source);
+    }
+  }
+}
+
+
+/*
+ * Merge the sources slot by slot, using the per-slot priorities if the source
+ * has them, or the source priority if it doesn't. The active priority is set
+ * to the highest slot priority.
+ */
+void Universe::PriorityMergeSources(const vector<DmxSource> &sources) {
+  vector<const DmxBuffer*> buffers;
+  vector<const uint8_t*> priorities;
+  buffers.reserve(sources.size());
+  priorities.reserve(sources.size());
+  m_priority_scratch.resize(sources.size() * DMX_UNIVERSE_SIZE);
+
+  for (unsigned int i = 0; i < sources.size(); i++) {
+    const DmxSource &source = sources[i];
+    const DmxBuffer &slot_priorities = source.SlotPriorities();
+    buffers.push_back(&source.Data());
+
+    if (slot_priorities.Size() >= source.Data().Size()) {
+      priorities.push_back(slot_priorities.GetRaw());
+      continue;
+    }
+
+    uint8_t *scratch = &m_priority_scratch[i * DMX_UNIVERSE_SIZE];
+    if (source.HasSlotPriorities()) {
+      // The remaining slots aren't controlled by this source.
+      unsigned int length = DMX_UNIVERSE_SIZE;
+      slot_priorities.Get(scratch, &length);
+      memset(scratch + length, 0, DMX_UNIVERSE_SIZE - length);
+    } else {
+      // A slot priority of 0 means 'not controlled', so a source at the
+      // minimum priority is bumped up one.
+      memset(scratch, std::max(source.Priority(), static_cast<uint8_t>(1)),
+             DMX_UNIVERSE_SIZE);
+    }
+    priorities.push_back(scratch);
+  }
+
+  uint8_t slot_priorities[DMX_UNIVERSE_SIZE];
+  m_buffer.PriorityMergeMany(&buffers[0], &priorities[0], buffers.size(),
+                             slot_priorities);
+
+  m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
+  for (unsigned int i = 0; i < m_buffer.Size(); i++) {
+    m_active_priority = std::max(m_active_priority, slot_priorities[i]);
+  }
+}
+
+
+/*
+ * Check if the last HTP merge can be updated in place.
+ * This is the case if the set of active sources hasn't changed, and none of
+ * the sources other than the one at changed_index have new data.
+ * @param changed_index the index into m_scan_sources of the changed source.
+ */
+bool Universe::CanMergeIncrementally(unsigned int changed_index) const {
+  if (!m_htp_merge_valid || m_scan_keys != m_merge_keys) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_scan_sources.size(); i++) {
+    const DmxBuffer &new_data = m_scan_sources[i].Data();
+    const DmxBuffer &old_data = m_merge_sources[i].Data();
+    if (new_data.Size() != old_data.Size()) {
+      return false;
+    }
+    // DmxBuffer is copy-on-write, and we hold a reference to the old data, so
+    // if the pointers match the data is the same.
+    if (i != changed_index && new_data.GetRaw() != old_data.GetRaw()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/*
+ * Update the HTP merge for a change to a single source. Only the slots that
+ * changed in the source are looked at, and only the slots where the source
+ * was providing the highest value and has since dropped need to be merged
+ * from all sources.
+ * @param changed_index the index into m_scan_sources of the changed source.
+ */
+void Universe::IncrementalHTPMerge(unsigned int changed_index) {
+  if (!m_slot_owners_valid) {
+    BuildSlotOwners();
+  }
+
+  const DmxBuffer &new_data = m_scan_sources[changed_index].Data();
+  const uint8_t *old_raw = m_merge_sources[changed_index].Data().GetRaw();
+  const uint8_t *new_raw = new_data.GetRaw();
+  if (old_raw == new_raw) {
+    return;
+  }
+
+  for (unsigned int slot = 0; slot < new_data.Size(); slot++) {
+    if (old_raw[slot] == new_raw[slot]) {
+      continue;
+    }
+
+    if (new_raw[slot] > m_buffer.Get(slot)) {
+      m_buffer.SetChannel(slot, new_raw[slot]);
+      m_slot_owners[slot] = changed_index;
+    } else if (m_slot_owners[slot] == changed_index) {
+      MergeSlot(slot, m_scan_sources);
+    }
+  }
+}
+
+
+/*
+ * Work out which source provides the value for each slot in m_buffer.
+ * @pre m_buffer is the HTP merge of m_merge_sources.
+ */
+void Universe::BuildSlotOwners() {
+  m_slot_owners.resize(DMX_UNIVERSE_SIZE);
+  for (unsigned int slot = 0; slot < m_buffer.Size(); slot++) {
+    uint8_t value = m_buffer.Get(slot);
+    for (unsigned int i = 0; i < m_merge_sources.size(); i++) {
+      const DmxBuffer &data = m_merge_sources[i].Data();
+      if (slot < data.Size() && data.GetRaw()[slot] == value) {
+        m_slot_owners[slot] = i;
+        break;
+      }
+    }
+  }
+  m_slot_owners_valid = true;
+}
+
+
+/*
+ * HTP merge a single slot from all sources, and update the owner for it.
+ */
+void Universe::MergeSlot(unsigned int slot, const vector<DmxSource> &sources) {
+  uint8_t value = 0;
+  uint16_t owner = 0;
+  for (unsigned int i = 0; i < sources.size(); i++) {
+    const DmxBuffer &data = sources[i].Data();
+    if (slot < data.Size() && data.GetRaw()[slot] > value) {
+      value = data.GetRaw()[slot];
+      owner = i;
+    }
+  }
+  m_buffer.SetChannel(slot, value);
+  m_slot_owners[slot] = owner;
+}
+
+
+/*
+ * Add a source to m_scan_sources if it's at or above the active priority.
+ * @param source the source to add
+ * @param key the port or client that the source belongs to
+ * @param changed_key the port or client that triggered the merge.
+ * @param changed_index updated with the index of the changed source, or -1 if
+ *   it's not at the active priority.
+ */
+void Universe::AddActiveSource(const DmxSource &source, const void *key,
+                               const void *changed_key, int *changed_index) {
+  if (source.Priority() > m_active_priority) {
+    *changed_index = -1;
+    m_scan_sources.clear();
+    m_scan_keys.clear();
+    m_active_priority = source.Priority();
+  }
+
+  if (source.Priority() == m_active_priority) {
+    if (key == changed_key) {
+      *changed_index = m_scan_sources.size();
+    }
+    m_scan_sources.push_back(source);
+    m_scan_keys.push_back(key);
   }
 }
 
@@ -691,108 +1492,287 @@ void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
  * Merge all port/client sources.
  * This does a priority based merge as documented at:
  * https://wiki.openlighting.org/index.php/OLA_Merging_Algorithms
+ *
+ * The sources used for the last merge are kept, so if only one source at the
+ * active priority changed, the HTP merge is updated rather than re-done.
  * @param port the input port that changed or NULL
  * @param client the client that changed or NULL
  * @returns true if the data for this universe changed, false otherwise
  */
 bool Universe::MergeAll(const InputPort *port, const Client *client) {
-  vector<DmxSource> active_sources;
+  ola::TraceSpan span("universe.merge", "universe", m_universe_id);
+  const void *changed_key = port ? static_cast<const void*>(port) :
+                                   static_cast<const void*>(client);
+  if (changed_key && changed_key == m_cut_through_key &&
+      CutThroughMerge(port, client)) {
+    return true;
+  }
+
+  int changed_index = -1;
+  bool slot_priorities = false;
+  TimeStamp input_time, arrival_time;
+
+  TimeStamp next_expiry;
 
   vector<InputPort*>::const_iterator iter;
   SourceClientMap::const_iterator client_iter;
 
+  m_scan_sources.clear();
+  m_scan_keys.clear();
   m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
-  TimeStamp now;
-  m_clock->CurrentTime(&now);
-  bool changed_source_is_active = false;
+  TimeStamp now, start;
+  m_loop_clock->CurrentTime(&now);
+  if (m_export_map) {
+    m_clock->CurrentTime(&start);
+  }
 
   // Find the highest active ports
   for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
-    DmxSource source = (*iter)->SourceData();
+    const DmxSource &source = (*iter)->SourceData();
     if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
       continue;
     }
-
-    if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
-      m_active_priority = source.Priority();
+    if (*iter == changed_key) {
+      input_time = source.Timestamp();
+      arrival_time = source.ArrivalTime();
     }
-
-    if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
-      if (*iter == port) {
-        changed_source_is_active = true;
-      }
+    if (!next_expiry.IsSet() || source.ExpiryTime() < next_expiry) {
+      next_expiry = source.ExpiryTime();
     }
+    slot_priorities |= source.HasSlotPriorities();
+    AddActiveSource(source, *iter, changed_key, &changed_index);
   }
 
   // find the highest priority active clients
   for (client_iter = m_source_clients.begin();
        client_iter != m_source_clients.end();
        ++client_iter) {
-    const DmxSource &source = client_iter->first->SourceData(UniverseId());
+    const DmxSource source = client_iter->first->SourceData(UniverseId());
 
     if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
       continue;
     }
-
-    if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
-      m_active_priority = source.Priority();
+    if (client_iter->first == changed_key) {
+      input_time = source.Timestamp();
+      arrival_time = source.ArrivalTime();
     }
-
-    if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
-      if (client_iter->first == client) {
-        changed_source_is_active = true;
-      }
+    if (!next_expiry.IsSet() || source.ExpiryTime() < next_expiry) {
+      next_expiry = source.ExpiryTime();
     }
+    slot_priorities |= source.HasSlotPriorities();
+    AddActiveSource(source, client_iter->first, changed_key, &changed_index);
   }
 
-  if (active_sources.empty()) {
-    OLA_WARN << "Something changed but we didn't find any active sources "
-             << " for universe " << UniverseId();
+  ScheduleSourceExpiry(next_expiry);
+
+  if (m_scan_sources.empty()) {
+    if (changed_key) {
+      OLA_WARN_LIMITED << "Something changed but we didn't find any active "
+                       << "sources for universe " << UniverseId();
+    }
     return false;
   }
 
-  if (!changed_source_is_active) {
+  if (slot_priorities) {
+    // Sources below the active priority may still win some slots, so this
+    // always merges everything.
+    CollectActiveSources(now, &m_scan_sources);
+    PriorityMergeSources(m_scan_sources);
+    m_scan_sources.clear();
+    m_merge_sources.clear();
+    m_merge_keys.clear();
+    m_htp_merge_valid = false;
+    MergeComplete(start, input_time, arrival_time);
+    return true;
+  }
+
+  if (changed_index < 0 && changed_key) {
     // this source didn't have any effect, skip
+    m_merges_skipped_var.Increment();
     return false;
   }
 
   // only one source at the active priority
-  if (active_sources.size() == 1) {
-    m_buffer.Set(active_sources[0].Data());
-  } else {
-    // multi source merge
-    if (m_merge_mode == Universe::MERGE_LTP) {
-      vector<DmxSource>::const_iterator source_iter = active_sources.begin();
-      DmxSource changed_source;
-      if (port) {
-        changed_source = port->SourceData();
-      } else {
-        changed_source = client->SourceData(UniverseId());
-      }
-
-      // check that the current port/client is newer than all other active
-      // sources
-      for (; source_iter != active_sources.end(); source_iter++) {
-        if (changed_source.Timestamp() < source_iter->Timestamp()) {
-          return false;
-        }
+  if (m_scan_sources.size() == 1) {
+    m_buffer.Set(m_scan_sources[0].Data());
+    m_htp_merge_valid = false;
+  } else if (m_merge_mode == Universe::MERGE_LTP) {
+    // multi source merge. If a source timed out, the newest of the
+    // remaining sources wins.
+    const DmxSource &changed_source = changed_index < 0 ?
+        NewestSource(m_scan_sources) : m_scan_sources[changed_index];
+
+    // check that the current port/client is newer than all other active
+    // sources
+    vector<DmxSource>::const_iterator source_iter = m_scan_sources.begin();
+    for (; source_iter != m_scan_sources.end(); source_iter++) {
+      if (changed_source.Timestamp() < source_iter->Timestamp()) {
+        return false;
       }
-      // if we made it to here this is the newest source
-      m_buffer.Set(changed_source.Data());
-    } else {
-      HTPMergeSources(active_sources);
     }
+    // if we made it to here this is the newest source
+    m_buffer.Set(changed_source.Data());
+    m_htp_merge_valid = false;
+  } else if (changed_index >= 0 && CanMergeIncrementally(changed_index)) {
+    IncrementalHTPMerge(changed_index);
+  } else {
+    HTPMergeSources(m_scan_sources);
+    m_htp_merge_valid = true;
+    m_slot_owners_valid = false;
   }
+
+  m_merge_sources.swap(m_scan_sources);
+  m_merge_keys.swap(m_scan_keys);
+  MergeComplete(start, input_time, arrival_time);
   return true;
 }
 
 
+/*
+ * Use the data of the only source as the universe data. The buffer is shared
+ * with the source rather than copied, and the outputs are passed the same
+ * buffer.
+ * @param port the input port that changed or NULL
+ * @param client the client that changed or NULL
+ * @returns true if the data was used, false if the source needs the full
+ *   merge.
+ */
+bool Universe::CutThroughMerge(const InputPort *port, const Client *client) {
+  TimeStamp now, start;
+  m_loop_clock->CurrentTime(&now);
+  if (m_export_map) {
+    m_clock->CurrentTime(&start);
+  }
+
+  const DmxSource source = port ? port->SourceData() :
+                                  client->SourceData(UniverseId());
+  if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size() ||
+      source.HasSlotPriorities()) {
+    return false;
+  }
+
+  ScheduleSourceExpiry(source.ExpiryTime());
+  m_active_priority = source.Priority();
+  m_buffer = source.Data();
+  m_htp_merge_valid = false;
+  // Don't hold on to the data of the last full merge.
+  if (!m_merge_sources.empty()) {
+    m_merge_sources.clear();
+    m_merge_keys.clear();
+  }
+  MergeComplete(start, source.Timestamp(), source.ArrivalTime());
+  return true;
+}
+
+
+/*
+ * Check if the universe has a single source, this is called when the sources
+ * change.
+ */
+void Universe::UpdateCutThrough() {
+  if (m_input_ports.size() + m_source_clients.Size() != 1) {
+    m_cut_through_key = NULL;
+  } else if (m_input_ports.empty()) {
+    m_cut_through_key = m_source_clients.begin()->first;
+  } else {
+    m_cut_through_key = m_input_ports.front();
+  }
+}
+
+
+/*
+ * Make sure ExpireSources() is called by the time the next source times out.
+ * Deadlines only move later as sources get new data, so the universe doesn't
+ * re-register unless the new deadline is earlier than the one it has.
+ * @param expiry the time the next active source times out, or an unset
+ *   TimeStamp if there are no active sources.
+ */
+void Universe::ScheduleSourceExpiry(const TimeStamp &expiry) {
+  SourceExpiryScheduler *scheduler = NULL;
+  if (m_universe_store) {
+    scheduler = m_universe_store->GetSourceExpiryScheduler();
+  }
+  if (!scheduler || !expiry.IsSet() ||
+      (m_source_expiry.IsSet() && m_source_expiry <= expiry)) {
+    return;
+  }
+  m_source_expiry = expiry;
+  scheduler->Schedule(this, expiry);
+}
+
+
+/*
+ * Check if a source timed out since the last call to ExpireSources().
+ */
+bool Universe::SourceExpired(const DmxSource &source,
+                             const TimeStamp &now) const {
+  if (!source.IsSet() || source.IsActive(now)) {
+    return false;
+  }
+  return !m_last_expiry_check.IsSet() ||
+         source.IsActive(m_last_expiry_check);
+}
+
+
+/*
+ * Record the time taken by a merge.
+ * @param start the time the merge started.
+ * @param input_time the time the data that triggered the merge arrived.
+ * @param arrival_time the wall clock time the kernel received that data, this
+ *   may not be set.
+ */
+void Universe::MergeComplete(const TimeStamp &start,
+                             const TimeStamp &input_time,
+                             const TimeStamp &arrival_time) {
+  if (!m_input_time.IsSet()) {
+    m_input_time = input_time;
+    m_arrival_time = arrival_time;
+  }
+
+  if (m_export_map) {
+    TimeStamp end;
+    m_clock->CurrentTime(&end);
+    AddTimingSample(&m_merge_time, end - start, K_UNIVERSE_MERGE_TIME_P50_VAR,
+                    K_UNIVERSE_MERGE_TIME_P99_VAR,
+                    K_UNIVERSE_MERGE_TIME_MAX_VAR);
+  }
+}
+
+
+/*
+ * Add a sample to one of the timing histograms, and update the exported
+ * values. To keep the per-frame cost down the percentiles are only exported
+ * every K_TIMING_EXPORT_INTERVAL samples, or when there is a new maximum.
+ */
+void Universe::AddTimingSample(auto_ptr<Histogram> *histogram,
+                               const TimeInterval &interval,
+                               const char *p50_var,
+                               const char *p99_var,
+                               const char *max_var) {
+  // The clock may have gone backwards.
+  int64_t usec = std::max(interval.AsInt(), static_cast<int64_t>(0));
+  uint32_t value = static_cast<uint32_t>(
+      std::min(usec, static_cast<int64_t>(0xffffffff)));
+  if (!histogram->get()) {
+    histogram->reset(new Histogram());
+  }
+  Histogram *samples = histogram->get();
+  bool new_max = value > samples->Max();
+  samples->Add(value);
+
+  if (!m_export_map ||
+      (!new_max && samples->Count() % K_TIMING_EXPORT_INTERVAL != 1)) {
+    return;
+  }
+  (*m_export_map->GetUIntMapVar(p50_var))[m_universe_id_str] =
+      samples->Percentile(50);
+  (*m_export_map->GetUIntMapVar(p99_var))[m_universe_id_str] =
+      samples->Percentile(99);
+  (*m_export_map->GetUIntMapVar(max_var))[m_universe_id_str] =
+      samples->Max();
+}
+
+
 /**
  * Called when discovery completes on a single ports.
  */
@@ -808,6 +1788,14 @@ void Universe::PortDiscoveryComplete(BaseCallback0<void> *on_complete,
  * Called when discovery completes on all ports.
  */
 void Universe::DiscoveryComplete(RDMDiscoveryCallback *on_complete) {
+  if (!m_cached_uids.Empty()) {
+    // Every port has now reported, so anything left over has gone.
+    m_cached_uids.Clear();
+    if (m_universe_store) {
+      m_universe_store->SaveUniverseUIDs(this);
+    }
+  }
+
   ola::rdm::UIDSet uids;
   GetUIDs(&uids);
   if (on_complete) {
@@ -816,6 +1804,87 @@ void Universe::DiscoveryComplete(RDMDiscoveryCallback *on_complete) {
 }
 
 
+/**
+ * Record the outcome of a unicast request, then pass the reply on.
+ */
+void Universe::HandleTimedRDMReply(timed_request_tracker *tracker,
+                                   RDMReply *reply) {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  // The port may have been removed while the request was in flight.
+  ola::rdm::RDMTimingStats *timing = STLFindOrNull(m_rdm_timing,
+                                                   tracker->port_id);
+  if (timing) {
+    timing->RecordReply(tracker->uid, now - tracker->sent, *reply);
+    ExportRDMTiming(RDM_PORT_TIMING_VARS, tracker->port_id,
+                    timing->Totals());
+    const RDMTimingStats::Timing *responder = timing->Responder(
+        tracker->uid);
+    if (responder) {
+      ExportRDMTiming(RDM_RESPONDER_TIMING_VARS, tracker->uid.ToString(),
+                      *responder);
+    }
+  }
+
+  ola::rdm::RDMCallback *callback = tracker->callback;
+  delete tracker;
+  callback->Run(reply);
+}
+
+
+/*
+ * Update one set of RDM timing variables.
+ * @param vars the variable names, in the order of RDM_PORT_TIMING_VARS.
+ */
+void Universe::ExportRDMTiming(const char *const vars[], const string &key,
+                               const RDMTimingStats::Timing &timing) {
+  if (!m_export_map) {
+    return;
+  }
+  const unsigned int values[] = {
+    timing.requests,
+    timing.timeouts,
+    timing.ack_timers,
+    timing.retransmits,
+    timing.latency.Percentile(50),
+    timing.latency.Percentile(99),
+    timing.latency.Max(),
+  };
+  for (unsigned int i = 0; i < arraysize(values); i++) {
+    (*m_export_map->GetUIntMapVar(vars[i]))[key] = values[i];
+  }
+}
+
+
+/*
+ * Drop the RDM timing for a port, along with the exported values.
+ */
+void Universe::RemoveRDMTiming(const string &port_id) {
+  RDMTimingMap::iterator iter = m_rdm_timing.find(port_id);
+  if (iter == m_rdm_timing.end()) {
+    return;
+  }
+
+  if (m_export_map) {
+    const RDMTimingStats::ResponderMap &responders =
+        iter->second->Responders();
+    for (unsigned int i = 0; i < arraysize(RDM_PORT_TIMING_VARS); i++) {
+      m_export_map->GetUIntMapVar(RDM_PORT_TIMING_VARS[i])->Remove(port_id);
+      UIntMap *var = m_export_map->GetUIntMapVar(
+          RDM_RESPONDER_TIMING_VARS[i]);
+      RDMTimingStats::ResponderMap::const_iterator responder =
+          responders.begin();
+      for (; responder != responders.end(); ++responder) {
+        var->Remove(responder->first.ToString());
+      }
+    }
+  }
+  delete iter->second;
+  m_rdm_timing.erase(iter);
+}
+
+
 /**
  * Track fan-out responses for a broadcast request.
  * This increments the port counter until we reach the expected value, and
@@ -891,6 +1960,15 @@ void Universe::SafeIncrement(const string &name) {
   }
 }
 
+/*
+ * Return a handle to this universe's entry in an Export Map variable. The
+ * entries are removed in the destructor, so the handle is valid for the
+ * lifetime of the universe.
+ */
+UIntMap::Handle Universe::UniverseVarHandle(const string &name) {
+  return m_export_map->GetUIntMapVar(name)->GetHandle(m_universe_id_str);
+}
+
 /*
  * Helper function to decrement an Export Map variable
  */
@@ -907,8 +1985,9 @@ void Universe::SafeDecrement(const string &name) {
  * @param ports, the vector of ports to add to
  */
 template<class PortClass>
-bool Universe::GenericAddPort(PortClass *port, vector<PortClass*> *ports) {
-  if (find(ports->begin(), ports->end(), port) != ports->end()) {
+bool Universe::GenericAddPort(PortClass *port, vector<PortClass*> *ports,
+                              FlatSet<PortClass*> *index) {
+  if (!index->Insert(port)) {
     return true;
   }
 
@@ -927,21 +2006,20 @@ bool Universe::GenericAddPort(PortClass *port, vector<PortClass*> *ports) {
  * Remove an Input or Output port from this universe.
  * @param port, the port to add
  * @param ports, the vector of ports to remove from
+ * @param index, the index of the ports
  */
 template<class PortClass>
 bool Universe::GenericRemovePort(PortClass *port,
                                  vector<PortClass*> *ports,
+                                 FlatSet<PortClass*> *index,
                                  map<UID, PortClass*> *uid_map) {
-  typename vector<PortClass*>::iterator iter =
-    find(ports->begin(), ports->end(), port);
-
-  if (iter == ports->end()) {
+  if (!index->Remove(port)) {
     OLA_DEBUG << "Could not find port " << port->UniqueId() << " in universe "
       << UniverseId();
     return true;
   }
 
-  ports->erase(iter);
+  ports->erase(find(ports->begin(), ports->end(), port));
   if (m_export_map) {
     UIntMap *map = m_export_map->GetUIntMapVar(
         IsInputPort<PortClass>() ? K_UNIVERSE_INPUT_PORT_VAR :
@@ -966,16 +2044,4 @@ bool Universe::GenericRemovePort(PortClass *port,
   }
   return true;
 }
-
-
-/*
- * Check if this universe contains a particular port.
- * @param port, the port to add
- * @param ports, the vector of ports to remove from
- */
-template<class PortClass>
-bool Universe::GenericContainsPort(PortClass *port,
-                                   const vector<PortClass*> &ports) const {
-  return find(ports.begin(), ports.end(), port) != ports.end();
-}
 }  // namespace  ola
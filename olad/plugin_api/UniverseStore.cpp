@@ -22,6 +22,7 @@
 #include "olad/plugin_api/UniverseStore.h"
 
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
@@ -31,23 +32,38 @@
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
+#include "olad/plugin_api/DmxSnapshot.h"
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
 
 namespace ola {
 
+using std::auto_ptr;
 using std::pair;
 using std::set;
 using std::string;
 using std::vector;
 
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
+const unsigned int UniverseStore::MAX_REMOVED_UNIVERSES = 512;
 
 UniverseStore::UniverseStore(Preferences *preferences,
                              ExportMap *export_map)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_loop_clock(NULL),
+      m_output_scheduler(NULL),
+      m_source_expiry_scheduler(NULL),
+      m_dmx_snapshot(NULL),
+      m_frame_recorder(NULL),
+      m_soft_patch(NULL),
+      m_shared_memory(NULL),
+      m_outputs_held(false),
+      m_info_version(0),
+      m_removed_floor(0) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
@@ -59,6 +75,19 @@ UniverseStore::UniverseStore(Preferences *preferences,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
       Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR,
       Universe::K_UNIVERSE_UID_COUNT_VAR,
+      Universe::K_UNIVERSE_UNCHANGED_FRAMES_VAR,
+      Universe::K_UNIVERSE_COALESCED_FRAMES_VAR,
+      Universe::K_UNIVERSE_MERGES_SKIPPED_VAR,
+      Universe::K_UNIVERSE_LATENCY_P50_VAR,
+      Universe::K_UNIVERSE_LATENCY_P99_VAR,
+      Universe::K_UNIVERSE_LATENCY_MAX_VAR,
+      Universe::K_UNIVERSE_ARRIVAL_LATENCY_P50_VAR,
+      Universe::K_UNIVERSE_ARRIVAL_LATENCY_P99_VAR,
+      Universe::K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR,
+      Universe::K_UNIVERSE_MERGE_TIME_P50_VAR,
+      Universe::K_UNIVERSE_MERGE_TIME_P99_VAR,
+      Universe::K_UNIVERSE_MERGE_TIME_MAX_VAR,
+      Universe::K_UNIVERSE_MEMORY_VAR,
     };
 
     for (unsigned int i = 0; i < sizeof(vars) / sizeof(vars[0]); ++i) {
@@ -68,6 +97,7 @@ UniverseStore::UniverseStore(Preferences *preferences,
 }
 
 UniverseStore::~UniverseStore() {
+  m_info_changed_callback.reset();
   DeleteAll();
 }
 
@@ -80,12 +110,17 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
       &m_universe_map, universe_id);
 
   if (!iter->second) {
-    iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
+    iter->second = new Universe(universe_id, this, m_export_map, &m_clock,
+                                m_loop_clock);
 
     if (iter->second) {
       if (m_preferences) {
         RestoreUniverseSettings(iter->second);
       }
+      if (m_dmx_snapshot) {
+        m_dmx_snapshot->Restore(iter->second);
+      }
+      iter->second->InfoChanged();
     } else {
       OLA_WARN << "Failed to create universe " << universe_id;
     }
@@ -103,6 +138,7 @@ void UniverseStore::DeleteAll() {
   for (iter = m_universe_map.begin(); iter != m_universe_map.end(); iter++) {
     SaveUniverseSettings(iter->second);
     delete iter->second;
+    UniverseRemoved(iter->first);
   }
   m_deletion_candiates.clear();
   m_universe_map.clear();
@@ -112,21 +148,87 @@ void UniverseStore::AddUniverseGarbageCollection(Universe *universe) {
   m_deletion_candiates.insert(universe);
 }
 
-void UniverseStore::GarbageCollectUniverses() {
-  set<Universe*>::iterator iter;
-  UniverseMap::iterator map_iter;
+unsigned int UniverseStore::GarbageCollectUniverses(unsigned int limit) {
+  unsigned int deleted = 0;
+  set<Universe*>::iterator iter = m_deletion_candiates.begin();
+  while (iter != m_deletion_candiates.end() && (!limit || deleted < limit)) {
+    Universe *universe = *iter;
+    m_deletion_candiates.erase(iter++);
+    if (!universe->IsActive()) {
+      SaveUniverseSettings(universe);
+      m_universe_map.erase(universe->UniverseId());
+      UniverseRemoved(universe->UniverseId());
+      delete universe;
+      deleted++;
+    }
+  }
+  return m_deletion_candiates.size();
+}
+
+
+void UniverseStore::SetOutputsHeld(bool held) {
+  if (held == m_outputs_held) {
+    return;
+  }
+  m_outputs_held = held;
+  if (held) {
+    return;
+  }
+
+  UniverseMap::const_iterator iter = m_universe_map.begin();
+  for (; iter != m_universe_map.end(); ++iter) {
+    iter->second->FlushOutputs();
+  }
+}
 
-  for (iter = m_deletion_candiates.begin();
-       iter != m_deletion_candiates.end(); iter++) {
-    if (!(*iter)->IsActive()) {
-      SaveUniverseSettings(*iter);
-      m_universe_map.erase((*iter)->UniverseId());
-      delete *iter;
+uint64_t UniverseStore::UniverseInfoChanged(unsigned int universe_id) {
+  m_removed_universes.erase(universe_id);
+  m_info_version++;
+  if (m_info_changed_callback.get()) {
+    m_info_changed_callback->Run();
+  }
+  return m_info_version;
+}
+
+bool UniverseStore::GetRemovedSince(uint64_t version,
+                                    vector<unsigned int> *removed) const {
+  if (version < m_removed_floor) {
+    return false;
+  }
+  RemovedUniverseMap::const_iterator iter = m_removed_universes.begin();
+  for (; iter != m_removed_universes.end(); ++iter) {
+    if (iter->second > version) {
+      removed->push_back(iter->first);
     }
   }
-  m_deletion_candiates.clear();
+  return true;
 }
 
+void UniverseStore::SetInfoChangedCallback(Callback0<void> *callback) {
+  m_info_changed_callback.reset(callback);
+}
+
+void UniverseStore::UniverseRemoved(unsigned int universe_id) {
+  m_info_version++;
+  m_removed_universes[universe_id] = m_info_version;
+
+  if (m_removed_universes.size() > MAX_REMOVED_UNIVERSES) {
+    // Forget the oldest removal.
+    RemovedUniverseMap::iterator oldest = m_removed_universes.begin();
+    RemovedUniverseMap::iterator iter = m_removed_universes.begin();
+    for (; iter != m_removed_universes.end(); ++iter) {
+      if (iter->second < oldest->second) {
+        oldest = iter;
+      }
+    }
+    m_removed_floor = oldest->second;
+    m_removed_universes.erase(oldest);
+  }
+
+  if (m_info_changed_callback.get()) {
+    m_info_changed_callback->Run();
+  }
+}
 
 /*
  * Restore a universe's settings
@@ -181,6 +283,41 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
         universe->UniverseId() << ", value was " << value;
     }
   }
+
+  // load the UIDs found last time
+  key = "uni_" + oss.str() + "_rdm_uids";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    vector<string> uid_strings;
+    StringSplit(value, &uid_strings, ",");
+    ola::rdm::UIDSet uids;
+    vector<string>::const_iterator iter = uid_strings.begin();
+    for (; iter != uid_strings.end(); ++iter) {
+      auto_ptr<ola::rdm::UID> uid(ola::rdm::UID::FromString(*iter));
+      if (uid.get()) {
+        uids.AddUID(*uid);
+      } else {
+        OLA_WARN << "Invalid RDM UID for universe " << universe->UniverseId()
+                 << ", value was " << *iter;
+      }
+    }
+    universe->SetCachedUIDs(uids);
+  }
+
+  // load the maximum output frame rate
+  key = "uni_" + oss.str() + "_max_frame_rate";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int frame_rate;
+    if (StringToInt(value, &frame_rate, true)) {
+      universe->SetMaxFrameRate(frame_rate);
+    } else {
+      OLA_WARN << "Invalid max frame rate for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
   return 0;
 }
 
@@ -207,11 +344,28 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
   mode = (universe->MergeMode() == Universe::MERGE_HTP ? "HTP" : "LTP");
   m_preferences->SetValue(key, mode);
 
-  // We don't save the RDM Discovery interval since it can only be set in the
-  // config files for now.
+  // We don't save the RDM Discovery interval or the max frame rate since they
+  // can only be set in the config files for now.
 
   m_preferences->Save();
 
   return 0;
 }
+
+void UniverseStore::SaveUniverseUIDs(const Universe *universe) const {
+  if (!universe || !m_preferences) {
+    return;
+  }
+
+  ola::rdm::UIDSet uids;
+  universe->GetUIDs(&uids);
+  const string key = "uni_" + IntToString(universe->UniverseId()) +
+                     "_rdm_uids";
+  if (uids.Empty()) {
+    m_preferences->RemoveValue(key);
+  } else {
+    m_preferences->SetValue(key, uids.ToString());
+  }
+  m_preferences->Save();
+}
 }  // namespace ola
@@ -21,16 +21,28 @@
 #ifndef OLAD_PLUGIN_API_UNIVERSESTORE_H_
 #define OLAD_PLUGIN_API_UNIVERSESTORE_H_
 
+#include <stdint.h>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
 
 namespace ola {
 
+namespace dmx {
+class UniverseSharedMemory;
+}  // namespace dmx
+
+class DmxSnapshot;
+class FrameRecorderInterface;
+class OutputScheduler;
+class SoftPatch;
+class SourceExpiryScheduler;
 class Universe;
 
 /**
@@ -89,11 +101,170 @@ class UniverseStore {
 
   /**
    * @brief Garbage collect any pending universes.
+   * @param limit the maximum number of universes to delete, or 0 for no
+   *   limit. Deleting a universe saves its settings, so this bounds the work
+   *   done in a single call.
+   * @returns the number of candidates left for the next call.
+   */
+  unsigned int GarbageCollectUniverses(unsigned int limit = 0);
+
+  /**
+   * @brief Set the OutputScheduler used by rate limited universes.
+   * @param scheduler the OutputScheduler to use, or NULL. Ownership is not
+   *   transferred, the scheduler must outlive the universes.
+   */
+  void SetOutputScheduler(OutputScheduler *scheduler) {
+    m_output_scheduler = scheduler;
+  }
+
+  /**
+   * @brief Return the OutputScheduler, or NULL if there isn't one.
+   */
+  OutputScheduler *GetOutputScheduler() const { return m_output_scheduler; }
+
+  /**
+   * @brief Set the SourceExpiryScheduler used to time out sources.
+   * @param scheduler the SourceExpiryScheduler to use, or NULL. Ownership is
+   *   not transferred, the scheduler must outlive the universes.
+   *
+   * Without a scheduler, sources that stop sending are only removed by
+   * Universe::CleanStaleSourceClients().
+   */
+  void SetSourceExpiryScheduler(SourceExpiryScheduler *scheduler) {
+    m_source_expiry_scheduler = scheduler;
+  }
+
+  /**
+   * @brief Return the SourceExpiryScheduler, or NULL if there isn't one.
+   */
+  SourceExpiryScheduler *GetSourceExpiryScheduler() const {
+    return m_source_expiry_scheduler;
+  }
+
+  /**
+   * @brief Set the snapshot that new universes restore their data from.
+   * @param snapshot the DmxSnapshot to use, or NULL. Ownership is not
+   *   transferred.
+   */
+  void SetDmxSnapshot(DmxSnapshot *snapshot) { m_dmx_snapshot = snapshot; }
+
+  /**
+   * @brief Set the recorder that's passed every frame sent by the universes.
+   * @param recorder the FrameRecorderInterface to use, or NULL. Ownership is
+   *   not transferred, the recorder must outlive the universes.
+   */
+  void SetFrameRecorder(FrameRecorderInterface *recorder) {
+    m_frame_recorder = recorder;
+  }
+
+  /**
+   * @brief Return the FrameRecorderInterface, or NULL if there isn't one.
+   */
+  FrameRecorderInterface *GetFrameRecorder() const { return m_frame_recorder; }
+
+  /**
+   * @brief Set the SoftPatch that's passed the data of each universe as it's
+   *   written to the outputs.
+   * @param soft_patch the SoftPatch to use, or NULL. Ownership is not
+   *   transferred, the SoftPatch must outlive the universes.
+   */
+  void SetSoftPatch(SoftPatch *soft_patch) { m_soft_patch = soft_patch; }
+
+  /**
+   * @brief Return the SoftPatch, or NULL if there isn't one.
+   */
+  SoftPatch *GetSoftPatch() const { return m_soft_patch; }
+
+  /**
+   * @brief Set the shared memory segment the universes publish their output
+   *   to.
+   * @param memory the UniverseSharedMemory to write to, or NULL. Ownership is
+   *   not transferred, the segment must outlive the universes.
+   */
+  void SetSharedMemory(ola::dmx::UniverseSharedMemory *memory) {
+    m_shared_memory = memory;
+  }
+
+  /**
+   * @brief Return the UniverseSharedMemory, or NULL if there isn't one.
+   */
+  ola::dmx::UniverseSharedMemory *GetSharedMemory() const {
+    return m_shared_memory;
+  }
+
+  /**
+   * @brief Hold, or release, the output ports of every universe.
+   * @param held true to stop writing to the output ports.
+   *
+   * Sink clients and the rest of the consumers are still updated while the
+   * outputs are held. When the outputs are released the current data of
+   * each universe is written straight away.
+   */
+  void SetOutputsHeld(bool held);
+
+  /**
+   * @brief Check if the output ports are held.
+   */
+  bool OutputsHeld() const { return m_outputs_held; }
+
+  /**
+   * @brief Set the Clock that universes created from now on use to check
+   *   source activity and output rates.
+   * @param clock a Clock that may return a cached time, such as
+   *   ola::io::SelectServer::LoopClock(), or NULL to always read the clock.
+   *   Ownership is not transferred.
+   */
+  void SetLoopClock(const Clock *clock) { m_loop_clock = clock; }
+
+  /**
+   * @brief Save the RDM UIDs of a universe, so they can be restored after a
+   *   restart.
+   * @param universe the Universe to save the UIDs for.
+   */
+  void SaveUniverseUIDs(const Universe *universe) const;
+
+  /**
+   * @brief Record that the name, merge mode, ports or RDM devices of a
+   *   universe changed.
+   * @param universe_id the universe-id of the universe.
+   * @returns the new info version, which the universe stores.
+   *
+   * This runs the info changed callback, if there is one.
+   */
+  uint64_t UniverseInfoChanged(unsigned int universe_id);
+
+  /**
+   * @brief Return the version of the universe info.
+   *
+   * This increases each time a universe's info changes, or a universe is
+   * created or removed.
+   */
+  uint64_t InfoVersion() const { return m_info_version; }
+
+  /**
+   * @brief Get the universes removed after a version.
+   * @param version the info version.
+   * @param[out] removed the universe-ids of the universes removed after
+   *   version, which haven't been created again since.
+   * @returns false if version is too old to know what was removed, in which
+   *   case the caller needs to start from the full universe list.
+   */
+  bool GetRemovedSince(uint64_t version,
+                       std::vector<unsigned int> *removed) const;
+
+  /**
+   * @brief Set the callback run when the universe info changes.
+   * @param callback the callback to run, or NULL. Ownership is transferred.
+   *
+   * The callback is run from within the change, so it shouldn't do much more
+   * than schedule the work.
    */
-  void GarbageCollectUniverses();
+  void SetInfoChangedCallback(Callback0<void> *callback);
 
  private:
   typedef std::map<unsigned int, Universe*> UniverseMap;
+  // universe-id to the info version it was removed at
+  typedef std::map<unsigned int, uint64_t> RemovedUniverseMap;
 
   Preferences *m_preferences;
   ExportMap *m_export_map;
@@ -101,11 +272,26 @@ class UniverseStore {
   std::set<Universe*> m_deletion_candiates;  // list of universes we may be
                                              // able to delete
   Clock m_clock;
+  const Clock *m_loop_clock;
+  OutputScheduler *m_output_scheduler;
+  SourceExpiryScheduler *m_source_expiry_scheduler;
+  DmxSnapshot *m_dmx_snapshot;
+  FrameRecorderInterface *m_frame_recorder;
+  SoftPatch *m_soft_patch;
+  ola::dmx::UniverseSharedMemory *m_shared_memory;
+  bool m_outputs_held;
+  uint64_t m_info_version;
+  RemovedUniverseMap m_removed_universes;
+  // Removals at or before this version have been forgotten.
+  uint64_t m_removed_floor;
+  std::auto_ptr<Callback0<void> > m_info_changed_callback;
 
+  void UniverseRemoved(unsigned int universe_id);
   bool RestoreUniverseSettings(Universe *universe) const;
   bool SaveUniverseSettings(Universe *universe) const;
 
   static const unsigned int MINIMUM_RDM_DISCOVERY_INTERVAL;
+  static const unsigned int MAX_REMOVED_UNIVERSES;
 
   DISALLOW_COPY_AND_ASSIGN(UniverseStore);
 };
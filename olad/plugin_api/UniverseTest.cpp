@@ -19,7 +19,10 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -27,6 +30,10 @@
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/UniverseSharedMemory.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
@@ -38,7 +45,10 @@
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/FrameRecorderInterface.h"
+#include "olad/plugin_api/OutputScheduler.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/SourceExpiryScheduler.h"
 #include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
 #include "ola/testing/TestUtils.h"
@@ -47,6 +57,7 @@
 using ola::AbstractDevice;
 using ola::Clock;
 using ola::DmxBuffer;
+using ola::IntToString;
 using ola::NewCallback;
 using ola::NewSingleCallback;
 using ola::TimeStamp;
@@ -69,30 +80,64 @@ static const char TEST_DATA[] = "this is some test data";
 class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(UniverseTest);
   CPPUNIT_TEST(testLifecycle);
+  CPPUNIT_TEST(testIncrementalGarbageCollection);
   CPPUNIT_TEST(testSetGetDmx);
   CPPUNIT_TEST(testSendDmx);
+  CPPUNIT_TEST(testUnchangedDmx);
+  CPPUNIT_TEST(testUnchangedDmxStats);
+  CPPUNIT_TEST(testRefreshOutputs);
+  CPPUNIT_TEST(testFrameRecorder);
+  CPPUNIT_TEST(testSharedMemory);
+  CPPUNIT_TEST(testOutputsHeld);
+  CPPUNIT_TEST(testMaxFrameRate);
+  CPPUNIT_TEST(testPortMaxFrameRate);
   CPPUNIT_TEST(testReceiveDmx);
   CPPUNIT_TEST(testSourceClients);
   CPPUNIT_TEST(testSinkClients);
   CPPUNIT_TEST(testLtpMerging);
   CPPUNIT_TEST(testHtpMerging);
+  CPPUNIT_TEST(testIncrementalHtpMerging);
+  CPPUNIT_TEST(testSlotPriorityMerging);
+  CPPUNIT_TEST(testCutThrough);
+  CPPUNIT_TEST(testSourceExpiry);
+  CPPUNIT_TEST(testCompact);
+  CPPUNIT_TEST(testTimingStats);
   CPPUNIT_TEST(testRDMDiscovery);
+  CPPUNIT_TEST(testRDMUIDCache);
   CPPUNIT_TEST(testRDMSend);
+  CPPUNIT_TEST(testRDMTiming);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void setUp();
   void tearDown();
   void testLifecycle();
+  void testIncrementalGarbageCollection();
   void testSetGetDmx();
   void testSendDmx();
+  void testUnchangedDmx();
+  void testUnchangedDmxStats();
+  void testRefreshOutputs();
+  void testFrameRecorder();
+  void testSharedMemory();
+  void testOutputsHeld();
+  void testMaxFrameRate();
+  void testPortMaxFrameRate();
   void testReceiveDmx();
   void testSourceClients();
   void testSinkClients();
   void testLtpMerging();
   void testHtpMerging();
+  void testIncrementalHtpMerging();
+  void testSlotPriorityMerging();
+  void testCutThrough();
+  void testSourceExpiry();
+  void testCompact();
+  void testTimingStats();
   void testRDMDiscovery();
+  void testRDMUIDCache();
   void testRDMSend();
+  void testRDMTiming();
 
  private:
   ola::MemoryPreferences *m_preferences;
@@ -123,11 +168,10 @@ class MockClient: public ola::Client {
         m_dmx_set(false) {
   }
 
-  bool SendDMX(unsigned int universe_id, uint8_t priority,
-               const DmxBuffer &buffer) {
-    OLA_ASSERT_EQ(TEST_UNIVERSE, universe_id);
-    OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MIN, priority);
-    OLA_ASSERT_EQ(string(TEST_DATA), buffer.Get());
+  bool SendDMX(const ola::SinkFrame &frame) {
+    OLA_ASSERT_EQ(TEST_UNIVERSE, frame.UniverseId());
+    OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MIN, frame.Priority());
+    OLA_ASSERT_EQ(string(TEST_DATA), frame.Data().Get());
     m_dmx_set = true;
     return true;
   }
@@ -135,6 +179,85 @@ class MockClient: public ola::Client {
 };
 
 
+/*
+ * An OutputPort that counts the number of writes.
+ */
+class CountingOutputPort: public TestMockOutputPort {
+ public:
+  CountingOutputPort(ola::AbstractDevice *parent, unsigned int port_id)
+      : TestMockOutputPort(parent, port_id),
+        writes(0) {
+  }
+
+  bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority) {
+    writes++;
+    return TestMockOutputPort::WriteDMX(buffer, priority);
+  }
+
+  unsigned int writes;
+};
+
+
+
+/*
+ * A FrameRecorderInterface that keeps the frames it's passed.
+ */
+class MockFrameRecorder: public ola::FrameRecorderInterface {
+ public:
+  void RecordFrame(unsigned int universe_id,
+                   const ola::TimeStamp&,
+                   const ola::DmxBuffer &data) {
+    universes.push_back(universe_id);
+    frames.push_back(data);
+  }
+
+  vector<unsigned int> universes;
+  vector<DmxBuffer> frames;
+};
+
+
+/*
+ * A SelectServer that holds on to the repeating timeout so we can run it.
+ */
+class TickingSelectServer: public MockSelectServer {
+ public:
+  explicit TickingSelectServer(const ola::TimeStamp *wake_up)
+      : MockSelectServer(wake_up),
+        callback(NULL) {
+  }
+
+  ~TickingSelectServer() { delete callback; }
+
+  using MockSelectServer::RegisterRepeatingTimeout;
+
+  ola::thread::timeout_id RegisterRepeatingTimeout(
+      const ola::TimeInterval&,
+      ola::Callback0<bool> *timeout_callback) {
+    delete callback;
+    callback = timeout_callback;
+    return callback;
+  }
+
+  void RemoveTimeout(ola::thread::timeout_id id) {
+    if (id == callback) {
+      delete callback;
+      callback = NULL;
+    }
+  }
+
+  // Run the timeout, returns true if it's still registered
+  bool Tick() {
+    if (callback && !callback->Run()) {
+      delete callback;
+      callback = NULL;
+    }
+    return callback != NULL;
+  }
+
+  ola::Callback0<bool> *callback;
+};
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(UniverseTest);
 
 
@@ -191,6 +314,22 @@ void UniverseTest::testLifecycle() {
 }
 
 
+/*
+ * Check garbage collection can be spread over several calls.
+ */
+void UniverseTest::testIncrementalGarbageCollection() {
+  for (unsigned int i = 1; i <= 3; i++) {
+    m_store->AddUniverseGarbageCollection(m_store->GetUniverseOrCreate(i));
+  }
+  OLA_ASSERT_EQ(3u, m_store->UniverseCount());
+
+  OLA_ASSERT_EQ(1u, m_store->GarbageCollectUniverses(2));
+  OLA_ASSERT_EQ(1u, m_store->UniverseCount());
+  OLA_ASSERT_EQ(0u, m_store->GarbageCollectUniverses(2));
+  OLA_ASSERT_EQ(0u, m_store->UniverseCount());
+}
+
+
 /*
  * Check that SetDMX/GetDMX works
  */
@@ -233,6 +372,335 @@ void UniverseTest::testSendDmx() {
 }
 
 
+/*
+ * Check that unchanged data isn't sent to the ports again.
+ */
+void UniverseTest::testUnchangedDmx() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port.writes);
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+
+  // the same data again is skipped
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port.writes);
+
+  // new data is sent
+  DmxBuffer buffer(m_buffer);
+  buffer.SetChannel(0, buffer.Get(0) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(2u, port.writes);
+  OLA_ASSERT(buffer == port.ReadDMX());
+
+  // a new port gets the current data straight away
+  CountingOutputPort port2(NULL, 2);
+  universe->AddPort(&port2);
+  OLA_ASSERT_EQ(1u, port2.writes);
+  OLA_ASSERT(buffer == port2.ReadDMX());
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(2u, port.writes);
+  OLA_ASSERT_EQ(1u, port2.writes);
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Check the skipped updates are exported.
+ */
+void UniverseTest::testUnchangedDmxStats() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(NULL, &export_map);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  TestMockOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+
+  ola::UIntMap *unchanged = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_UNCHANGED_FRAMES_VAR);
+  OLA_ASSERT_EQ(string("universe"), unchanged->Label());
+  OLA_ASSERT_EQ(2u, (*unchanged)["1"]);
+}
+
+
+/*
+ * Check the last frame is held and refreshed when the sources stop sending.
+ */
+void UniverseTest::testRefreshOutputs() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  // nothing to refresh yet
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  const ola::TimeInterval refresh_interval(
+      Universe::K_OUTPUT_REFRESH_INTERVAL_MS * 1000);
+  universe->RefreshOutputs(now + refresh_interval);
+  OLA_ASSERT_EQ(0u, port.writes);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port.writes);
+  m_clock.CurrentTime(&now);
+
+  // too soon
+  universe->RefreshOutputs(now);
+  OLA_ASSERT_EQ(1u, port.writes);
+
+  universe->RefreshOutputs(now + refresh_interval);
+  OLA_ASSERT_EQ(2u, port.writes);
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+
+  // the refresh restarts the interval
+  universe->RefreshOutputs(now + refresh_interval);
+  OLA_ASSERT_EQ(2u, port.writes);
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check the frame recorder is passed each new frame, but not refreshes.
+ */
+void UniverseTest::testFrameRecorder() {
+  MockFrameRecorder recorder;
+  m_store->SetFrameRecorder(&recorder);
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), recorder.frames.size());
+  OLA_ASSERT_EQ(TEST_UNIVERSE, recorder.universes[0]);
+  OLA_ASSERT(m_buffer == recorder.frames[0]);
+
+  // a new port gets the same data again, which isn't recorded
+  CountingOutputPort port2(NULL, 2);
+  universe->AddPort(&port2);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port2.writes);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), recorder.frames.size());
+
+  DmxBuffer buffer(m_buffer);
+  buffer.SetChannel(0, buffer.Get(0) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), recorder.frames.size());
+  OLA_ASSERT(buffer == recorder.frames[1]);
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  m_store->SetFrameRecorder(NULL);
+}
+
+
+/*
+ * Check the output is published to shared memory when it changes.
+ */
+void UniverseTest::testSharedMemory() {
+  using ola::dmx::UniverseSharedMemory;
+  std::ostringstream str;
+  str << UniverseSharedMemory::DEFAULT_NAME << "-universe-test-" << getpid();
+  std::auto_ptr<UniverseSharedMemory> memory(
+      UniverseSharedMemory::Create(str.str(), 2));
+  OLA_ASSERT_NOT_NULL(memory.get());
+  memory->Unlink();
+  m_store->SetSharedMemory(memory.get());
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, memory->ChangeCount());
+  UniverseSharedMemory::Frame frame;
+  OLA_ASSERT_TRUE(memory->Read(memory->FindSlot(TEST_UNIVERSE), &frame));
+  OLA_ASSERT_EQ(TEST_UNIVERSE, frame.universe);
+  OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MIN, frame.priority);
+  OLA_ASSERT(m_buffer == frame.data);
+
+  // Unchanged data isn't written again.
+  CountingOutputPort port2(NULL, 2);
+  universe->AddPort(&port2);
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, memory->ChangeCount());
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  m_store->DeleteAll();
+  m_store->SetSharedMemory(NULL);
+}
+
+
+/*
+ * Check the output ports aren't written while the outputs are held, and get
+ * the current data when they're released.
+ */
+void UniverseTest::testOutputsHeld() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  m_store->SetOutputsHeld(true);
+  OLA_ASSERT_TRUE(m_store->OutputsHeld());
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(0u, port.writes);
+  OLA_ASSERT(m_buffer == universe->GetDMX());
+
+  m_store->SetOutputsHeld(false);
+  OLA_ASSERT_FALSE(m_store->OutputsHeld());
+  OLA_ASSERT_EQ(1u, port.writes);
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+
+  // Releasing the outputs again doesn't write anything.
+  m_store->SetOutputsHeld(false);
+  OLA_ASSERT_EQ(1u, port.writes);
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that universes with a max frame rate coalesce their output.
+ */
+void UniverseTest::testMaxFrameRate() {
+  TimeStamp time_stamp;
+  TickingSelectServer ss(&time_stamp);
+  ola::OutputScheduler scheduler(&ss, ola::TimeInterval(5000));
+  m_store->SetOutputScheduler(&scheduler);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMaxFrameRate(1);
+  OLA_ASSERT_EQ(1u, universe->MaxFrameRate());
+
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  // the write waits for the next tick
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(0u, port.writes);
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+  OLA_ASSERT_FALSE(ss.Tick());
+  OLA_ASSERT_EQ(1u, port.writes);
+  OLA_ASSERT(m_buffer == port.ReadDMX());
+  OLA_ASSERT_EQ(0u, scheduler.PendingCount());
+
+  // two updates within the frame interval are sent as one
+  DmxBuffer buffer(m_buffer);
+  buffer.SetChannel(0, buffer.Get(0) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  buffer.SetChannel(1, buffer.Get(1) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  // it's too soon to send again
+  OLA_ASSERT(ss.Tick());
+  OLA_ASSERT_EQ(1u, port.writes);
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  // without a rate limit, the pending data goes out on the next tick
+  universe->SetMaxFrameRate(0);
+  OLA_ASSERT_FALSE(ss.Tick());
+  OLA_ASSERT_EQ(2u, port.writes);
+  OLA_ASSERT(buffer == port.ReadDMX());
+
+  universe->RemovePort(&port);
+  OLA_ASSERT_FALSE(universe->IsActive());
+  m_store->DeleteAll();
+  m_store->SetOutputScheduler(NULL);
+}
+
+
+/*
+ * Check that rate limited ports only get the latest frame, and that the
+ * last frame is always sent.
+ */
+void UniverseTest::testPortMaxFrameRate() {
+  TimeStamp time_stamp;
+  TickingSelectServer ss(&time_stamp);
+  ola::OutputScheduler scheduler(&ss, ola::TimeInterval(5000));
+  m_store->SetOutputScheduler(&scheduler);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  CountingOutputPort port(NULL, 1);
+  CountingOutputPort limited_port(NULL, 2);
+  OLA_ASSERT_TRUE(limited_port.SetMaxFrameRate(1));
+  universe->AddPort(&port);
+  universe->AddPort(&limited_port);
+
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_EQ(1u, port.writes);
+  OLA_ASSERT_EQ(1u, limited_port.writes);
+  OLA_ASSERT_EQ(0u, scheduler.PendingCount());
+
+  // the next frames are held by the limited port
+  DmxBuffer buffer(m_buffer);
+  buffer.SetChannel(0, buffer.Get(0) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  buffer.SetChannel(1, buffer.Get(1) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_EQ(3u, port.writes);
+  OLA_ASSERT_EQ(1u, limited_port.writes);
+  OLA_ASSERT_TRUE(limited_port.FramePending());
+  OLA_ASSERT_EQ(1u, limited_port.SkippedFrames());
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  // it's too soon to send again
+  OLA_ASSERT(ss.Tick());
+  OLA_ASSERT_EQ(1u, limited_port.writes);
+
+  // the trailing send writes the latest frame, and only to the held port
+  OLA_ASSERT_TRUE(limited_port.SetMaxFrameRate(0));
+  OLA_ASSERT_FALSE(ss.Tick());
+  OLA_ASSERT_EQ(3u, port.writes);
+  OLA_ASSERT_EQ(2u, limited_port.writes);
+  OLA_ASSERT(buffer == limited_port.ReadDMX());
+  OLA_ASSERT_FALSE(limited_port.FramePending());
+  OLA_ASSERT_EQ(0u, scheduler.PendingCount());
+
+  // without a scheduler the held frame is written by the refresh
+  m_store->SetOutputScheduler(NULL);
+  OLA_ASSERT_TRUE(limited_port.SetMaxFrameRate(10));
+  buffer.SetChannel(2, buffer.Get(2) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  buffer.SetChannel(3, buffer.Get(3) + 1);
+  OLA_ASSERT(universe->SetDMX(buffer));
+  OLA_ASSERT_TRUE(limited_port.FramePending());
+  OLA_ASSERT_EQ(3u, limited_port.writes);
+
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  universe->RefreshOutputs(now + ola::TimeInterval(200000));
+  OLA_ASSERT_EQ(4u, limited_port.writes);
+  OLA_ASSERT(buffer == limited_port.ReadDMX());
+  OLA_ASSERT_FALSE(limited_port.FramePending());
+  OLA_ASSERT_EQ(5u, port.writes);
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&limited_port);
+  m_store->DeleteAll();
+}
+
+
 /*
  * Check that we update when ports have new data
  */
@@ -521,6 +989,419 @@ void UniverseTest::testHtpMerging() {
 }
 
 
+/**
+ * Check that updating the HTP merge as a single source changes gives the same
+ * result as merging all the sources.
+ */
+void UniverseTest::testIncrementalHtpMerging() {
+  DmxBuffer buffer1, buffer2, buffer3;
+  buffer1.SetFromString("1,0,0,10,0,100");
+  buffer2.SetFromString("0,255,0,5,6,7");
+  buffer3.SetFromString("20,0,30,5,0,50");
+
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  MockDevice device3(NULL, "baz");
+  TestMockInputPort port(&device, 1, &plugin_adaptor);
+  TestMockInputPort port2(&device2, 1, &plugin_adaptor);
+  TestMockInputPort port3(&device3, 1, &plugin_adaptor);
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+  port_manager.PatchPort(&port3, TEST_UNIVERSE);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  m_clock.CurrentTime(&time_stamp);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  port3.WriteDMX(buffer3);
+  port3.DmxChanged();
+
+  DmxBuffer expected;
+  expected.HTPMerge(buffer1);
+  expected.HTPMerge(buffer2);
+  expected.HTPMerge(buffer3);
+  OLA_ASSERT(expected == universe->GetDMX());
+
+  // move the first source up and down, so it gains and loses slots
+  const uint8_t values[] = {0, 255, 50, 1, 100, 0, 30, 200, 0, 10};
+  for (unsigned int i = 0; i < sizeof(values); i++) {
+    for (unsigned int slot = 0; slot < buffer1.Size(); slot++) {
+      buffer1.SetChannel(slot, values[(i + slot) % sizeof(values)]);
+    }
+    port.WriteDMX(buffer1);
+    port.DmxChanged();
+
+    expected.Reset();
+    expected.HTPMerge(buffer1);
+    expected.HTPMerge(buffer2);
+    expected.HTPMerge(buffer3);
+    OLA_ASSERT(expected == universe->GetDMX());
+  }
+
+  // now the third source changes
+  buffer3.SetFromString("0,0,0,0,0,0");
+  port3.WriteDMX(buffer3);
+  port3.DmxChanged();
+  expected.Reset();
+  expected.HTPMerge(buffer1);
+  expected.HTPMerge(buffer2);
+  expected.HTPMerge(buffer3);
+  OLA_ASSERT(expected == universe->GetDMX());
+
+  // a change in length
+  buffer2.SetFromString("0,255,0,5,6,7,8,9,10");
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  expected.Reset();
+  expected.HTPMerge(buffer1);
+  expected.HTPMerge(buffer2);
+  expected.HTPMerge(buffer3);
+  OLA_ASSERT_EQ(buffer2.Size(), universe->GetDMX().Size());
+  OLA_ASSERT(expected == universe->GetDMX());
+
+  // setting the data directly means the next update needs a full merge
+  DmxBuffer direct;
+  direct.SetFromString("1,2,3");
+  universe->SetDMX(direct);
+  OLA_ASSERT(direct == universe->GetDMX());
+
+  buffer1.SetChannel(0, 99);
+  port.WriteDMX(buffer1);
+  port.DmxChanged();
+  expected.Reset();
+  expected.HTPMerge(buffer1);
+  expected.HTPMerge(buffer2);
+  expected.HTPMerge(buffer3);
+  OLA_ASSERT(expected == universe->GetDMX());
+
+  universe->RemovePort(&port);
+  universe->RemovePort(&port2);
+  universe->RemovePort(&port3);
+  OLA_ASSERT_FALSE(universe->IsActive());
+}
+
+
+/*
+ * Test merging sources with per-slot priorities.
+ */
+void UniverseTest::testSlotPriorityMerging() {
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  TestMockPriorityInputPort port(&device, 1, &plugin_adaptor);
+  TestMockPriorityInputPort port2(&device2, 1, &plugin_adaptor);
+  port.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
+  port2.SetPriorityMode(ola::PRIORITY_MODE_INHERIT);
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  DmxBuffer buffer1, priorities1, buffer2;
+  buffer1.SetFromString("10,20,30,40,50");
+  priorities1.SetFromString("150,150,50,0");
+  buffer2.SetFromString("1,2,3,4,5,6");
+
+  // a single source with slot priorities, uncontrolled slots are 0
+  m_clock.CurrentTime(&time_stamp);
+  port.WriteDMX(buffer1);
+  port.SetInheritedSlotPriorities(priorities1);
+  port.DmxChanged();
+  DmxBuffer expected;
+  expected.SetFromString("10,20,30,0,0");
+  OLA_ASSERT(expected == universe->GetDMX());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe->ActivePriority());
+
+  // a second source at a single priority of 100 takes the slots where the
+  // first source is lower, even though it's below the active priority.
+  m_clock.CurrentTime(&time_stamp);
+  port2.WriteDMX(buffer2);
+  port2.SetInheritedPriority(100);
+  port2.DmxChanged();
+  expected.SetFromString("10,20,3,4,5,6");
+  OLA_ASSERT(expected == universe->GetDMX());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe->ActivePriority());
+
+  // equal priorities are HTP merged
+  port2.SetInheritedPriority(150);
+  buffer2.SetFromString("100,2,3,4,5,6");
+  port2.WriteDMX(buffer2);
+  port2.DmxChanged();
+  expected.SetFromString("100,20,3,4,5,6");
+  OLA_ASSERT(expected == universe->GetDMX());
+
+  // once the slot priorities are removed we're back to a normal merge.
+  port.SetInheritedSlotPriorities(DmxBuffer());
+  port.SetInheritedPriority(160);
+  port.DmxChanged();
+  OLA_ASSERT(buffer1 == universe->GetDMX());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(160), universe->ActivePriority());
+
+  port_manager.UnPatchPort(&port);
+  port_manager.UnPatchPort(&port2);
+}
+
+
+/*
+ * Check the data of a single source is passed to the outputs without being
+ * copied, and the full merge is used while there's more than one source.
+ */
+void UniverseTest::testCutThrough() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  DmxBuffer buffer1, buffer2, htp_buffer;
+  buffer1.SetFromString("1,0,0,10");
+  buffer2.SetFromString("0,255,0,5");
+  htp_buffer.SetFromString("1,255,0,10");
+
+  TimeStamp time_stamp;
+  m_clock.CurrentTime(&time_stamp);
+  MockClient client1, client2;
+  client1.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer1, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client1);
+  OLA_ASSERT(buffer1 == universe->GetDMX());
+  OLA_ASSERT(buffer1.GetRaw() == universe->GetDMX().GetRaw());
+  OLA_ASSERT(buffer1.GetRaw() == port.ReadDMX().GetRaw());
+  OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_DEFAULT, universe->ActivePriority());
+  OLA_ASSERT_EQ(1u, port.writes);
+
+  // A second source is merged
+  client2.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer2, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client2);
+  OLA_ASSERT(htp_buffer == universe->GetDMX());
+  OLA_ASSERT(htp_buffer == port.ReadDMX());
+  OLA_ASSERT_EQ(2u, port.writes);
+
+  // And once it's gone the remaining source is passed through again.
+  universe->RemoveSourceClient(&client1);
+  buffer2.SetChannel(0, 20);
+  client2.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer2, time_stamp, ola::dmx::SOURCE_PRIORITY_MAX));
+  universe->SourceClientDataChanged(&client2);
+  OLA_ASSERT(buffer2 == universe->GetDMX());
+  OLA_ASSERT(buffer2.GetRaw() == port.ReadDMX().GetRaw());
+  OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MAX, universe->ActivePriority());
+  OLA_ASSERT_EQ(3u, port.writes);
+
+  universe->RemoveSourceClient(&client2);
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check sources are dropped as soon as they time out.
+ */
+void UniverseTest::testSourceExpiry() {
+  ola::MockClock clock;
+  ola::io::SelectServer ss(NULL, &clock);
+  ola::SourceExpiryScheduler scheduler(&ss, &clock);
+  m_store->SetLoopClock(&clock);
+  m_store->SetSourceExpiryScheduler(&scheduler);
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+  CountingOutputPort port(NULL, 1);
+  universe->AddPort(&port);
+
+  DmxBuffer buffer1, buffer2, htp_buffer;
+  buffer1.SetFromString("1,0,0,10");
+  buffer2.SetFromString("0,255,0,5");
+  htp_buffer.SetFromString("1,255,0,10");
+
+  TimeStamp time_stamp;
+  clock.CurrentTime(&time_stamp);
+  MockClient client1, client2;
+  client1.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer1, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client1);
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  clock.AdvanceTime(ola::TimeInterval(1, 0));
+  clock.CurrentTime(&time_stamp);
+  client2.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer2, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client2);
+  OLA_ASSERT(htp_buffer == universe->GetDMX());
+  OLA_ASSERT_EQ(2u, port.writes);
+
+  // Nothing happens until the first source times out.
+  clock.AdvanceTime(ola::TimeInterval(1400000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2u, universe->SourceClientCount());
+  OLA_ASSERT_EQ(2u, port.writes);
+
+  clock.AdvanceTime(ola::TimeInterval(100000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, universe->SourceClientCount());
+  OLA_ASSERT_FALSE(universe->ContainsSourceClient(&client1));
+  OLA_ASSERT(buffer2 == universe->GetDMX());
+  OLA_ASSERT_EQ(3u, port.writes);
+  OLA_ASSERT(buffer2 == port.ReadDMX());
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  // New data pushes the deadline back.
+  clock.CurrentTime(&time_stamp);
+  client2.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer2, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client2);
+  clock.AdvanceTime(ola::TimeInterval(2, 0));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(1u, universe->SourceClientCount());
+  OLA_ASSERT_EQ(1u, scheduler.PendingCount());
+
+  // Once the last source has gone, the universe isn't registered.
+  clock.AdvanceTime(ola::TimeInterval(500000));
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(0u, universe->SourceClientCount());
+  OLA_ASSERT_EQ(0u, scheduler.PendingCount());
+
+  universe->RemovePort(&port);
+  m_store->DeleteAll();
+  m_store->SetSourceExpiryScheduler(NULL);
+  m_store->SetLoopClock(NULL);
+}
+
+
+/*
+ * Check the merge state is freed when a universe is compacted, and rebuilt
+ * when data arrives.
+ */
+void UniverseTest::testCompact() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(NULL, &export_map);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  ola::UIntMap *memory = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_MEMORY_VAR);
+  const string key = IntToString(TEST_UNIVERSE);
+  OLA_ASSERT_EQ(universe->MemoryUsage(), (*memory)[key]);
+
+  DmxBuffer buffer1, buffer2, htp_buffer;
+  buffer1.SetFromString("1,0,0,10");
+  buffer2.SetFromString("0,255,0,5");
+  htp_buffer.SetFromString("1,255,0,10");
+
+  TimeStamp time_stamp;
+  m_clock.CurrentTime(&time_stamp);
+  MockClient client1, client2;
+  client1.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer1, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  client2.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer2, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client1);
+  universe->SourceClientDataChanged(&client2);
+  OLA_ASSERT(htp_buffer == universe->GetDMX());
+
+  const unsigned int merged_size = universe->MemoryUsage();
+  universe->Compact();
+  OLA_ASSERT_LT(universe->MemoryUsage(), merged_size);
+  OLA_ASSERT_EQ(universe->MemoryUsage(), (*memory)[key]);
+
+  // The next update does a full merge.
+  buffer1.SetFromString("1,0,0,20");
+  htp_buffer.SetFromString("1,255,0,20");
+  m_clock.CurrentTime(&time_stamp);
+  client1.DMXReceived(TEST_UNIVERSE, ola::DmxSource(
+      buffer1, time_stamp, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client1);
+  OLA_ASSERT(htp_buffer == universe->GetDMX());
+
+  universe->RemoveSourceClient(&client1);
+  universe->RemoveSourceClient(&client2);
+}
+
+
+/*
+ * Check the merge and latency stats are exported.
+ */
+void UniverseTest::testTimingStats() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(NULL, &export_map);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&store, &broker);
+
+  TimeStamp time_stamp;
+  MockSelectServer ss(&time_stamp);
+  ola::PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  MockDevice device(NULL, "foo");
+  MockDevice device2(NULL, "bar");
+  TestMockInputPort port(&device, 1, &plugin_adaptor);
+  TestMockInputPort port2(&device2, 1, &plugin_adaptor);
+  port_manager.PatchPort(&port, TEST_UNIVERSE);
+  port_manager.PatchPort(&port2, TEST_UNIVERSE);
+
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+  TestMockOutputPort output_port(NULL, 1);
+  universe->AddPort(&output_port);
+
+  ola::UIntMap *skipped = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_MERGES_SKIPPED_VAR);
+  ola::UIntMap *latency_max = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_LATENCY_MAX_VAR);
+  ola::UIntMap *merge_max = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_MERGE_TIME_MAX_VAR);
+  ola::UIntMap *arrival_max = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_ARRIVAL_LATENCY_MAX_VAR);
+  const string key = "1";
+  OLA_ASSERT_EQ(0u, (*skipped)[key]);
+
+  // The input was read 10ms ago, and the kernel received it 20ms before that.
+  m_clock.CurrentTime(&time_stamp);
+  time_stamp -= ola::TimeInterval(10000);
+  TimeStamp arrival;
+  ola::Clock().CurrentTime(&arrival);
+  port.SetArrivalTime(arrival - ola::TimeInterval(30000));
+  port.WriteDMX(m_buffer);
+  port.SetPriority(120);
+  port.DmxChanged();
+  OLA_ASSERT(m_buffer == output_port.ReadDMX());
+  OLA_ASSERT_TRUE((*latency_max)[key] >= 10000);
+  OLA_ASSERT_TRUE((*merge_max)[key] < 10000);
+  ola::UIntMap *latency_p50 = export_map.GetUIntMapVar(
+      Universe::K_UNIVERSE_LATENCY_P50_VAR);
+  OLA_ASSERT_TRUE((*latency_p50)[key] >= 10000);
+  OLA_ASSERT_TRUE((*latency_p50)[key] <= (*latency_max)[key]);
+  OLA_ASSERT_TRUE((*arrival_max)[key] >= 30000);
+
+  // The second port at a lower priority is skipped
+  m_clock.CurrentTime(&time_stamp);
+  port2.WriteDMX(m_buffer);
+  port2.DmxChanged();
+  OLA_ASSERT_EQ(1u, (*skipped)[key]);
+
+  universe->RemovePort(&output_port);
+  port_manager.UnPatchPort(&port);
+  port_manager.UnPatchPort(&port2);
+}
+
+
 /**
  * Test RDM discovery for a universe/
  */
@@ -593,6 +1474,62 @@ void UniverseTest::testRDMDiscovery() {
 }
 
 
+/**
+ * Check the UIDs are saved, and restored when the universe is created.
+ */
+void UniverseTest::testRDMUIDCache() {
+  const string key = "uni_" + IntToString(TEST_UNIVERSE) + "_rdm_uids";
+  m_preferences->SetValue(key, "7a70:00000001,7a70:00000002,foo");
+
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  UID uid1(0x7a70, 1);
+  UID uid2(0x7a70, 2);
+  UID uid3(0x7a70, 3);
+  UIDSet cached_uids;
+  cached_uids.AddUID(uid1);
+  cached_uids.AddUID(uid2);
+  OLA_ASSERT_EQ(cached_uids, universe->CachedUIDs());
+
+  // the cached UIDs are reported before discovery has run
+  UIDSet universe_uids;
+  universe->GetUIDs(&universe_uids);
+  OLA_ASSERT_EQ(cached_uids, universe_uids);
+
+  // uid1 has gone and uid3 is new
+  UIDSet port_uids;
+  port_uids.AddUID(uid2);
+  port_uids.AddUID(uid3);
+  TestMockRDMOutputPort port(NULL, 1, &port_uids, true);
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  OLA_ASSERT_EQ(cached_uids, port.SeededUIDs());
+
+  // uid1 hasn't been found, but another port may have it
+  UIDSet expected_uids;
+  expected_uids.AddUID(uid1);
+  expected_uids.AddUID(uid2);
+  expected_uids.AddUID(uid3);
+  universe_uids.Clear();
+  universe->GetUIDs(&universe_uids);
+  OLA_ASSERT_EQ(expected_uids, universe_uids);
+  OLA_ASSERT_EQ(string("7a70:00000001,7a70:00000002,7a70:00000003"),
+                m_preferences->GetValue(key));
+
+  // once discovery has run on every port, uid1 is dropped
+  expected_uids.RemoveUID(uid1);
+  universe->RunRDMDiscovery(
+    NewSingleCallback(this, &UniverseTest::ConfirmUIDs, &expected_uids),
+    true);
+  OLA_ASSERT(universe->CachedUIDs().Empty());
+  OLA_ASSERT_EQ(string("7a70:00000002,7a70:00000003"),
+                m_preferences->GetValue(key));
+
+  universe->RemovePort(&port);
+  port.SetUniverse(NULL);
+}
+
 /**
  * test Sending an RDM request
  */
@@ -800,6 +1737,96 @@ void UniverseTest::testRDMSend() {
 }
 
 
+/*
+ * Check the RDM timing is recorded per port and per responder.
+ */
+void UniverseTest::testRDMTiming() {
+  ola::ExportMap export_map;
+  ola::UniverseStore store(NULL, &export_map);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  UID uid1(0x7a70, 1);
+  UID uid2(0x7a70, 2);
+  UIDSet port1_uids, port2_uids;
+  port1_uids.AddUID(uid1);
+  port2_uids.AddUID(uid2);
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device(&plugin, "foo");
+  TestMockRDMOutputPort port1(&device, 1, &port1_uids, true);
+  TestMockRDMOutputPort port2(&device, 2, &port2_uids, true);
+  universe->AddPort(&port1);
+  port1.SetUniverse(universe);
+  universe->AddPort(&port2);
+  port2.SetUniverse(universe);
+  OLA_ASSERT_NULL(universe->PortRDMTiming(&port1));
+
+  // A request that times out twice, and is answered on the third attempt.
+  UID source_uid(0x7a70, 100);
+  port1.SetRDMHandler(
+    NewCallback(this, &UniverseTest::ReturnRDMCode, ola::rdm::RDM_TIMEOUT));
+  for (unsigned int i = 0; i < 2; i++) {
+    universe->SendRDMRequest(
+        new ola::rdm::RDMGetRequest(source_uid, uid1, 0, 1, 10, 296, NULL, 0),
+        NewSingleCallback(this,
+                          &UniverseTest::ConfirmRDM,
+                          __LINE__,
+                          ola::rdm::RDM_TIMEOUT,
+                          reinterpret_cast<const RDMResponse*>(NULL)));
+  }
+  port1.SetRDMHandler(
+    NewCallback(this, &UniverseTest::ReturnRDMCode,
+                ola::rdm::RDM_COMPLETED_OK));
+  universe->SendRDMRequest(
+      new ola::rdm::RDMGetRequest(source_uid, uid1, 0, 1, 10, 296, NULL, 0),
+      NewSingleCallback(this,
+                        &UniverseTest::ConfirmRDM,
+                        __LINE__,
+                        ola::rdm::RDM_COMPLETED_OK,
+                        reinterpret_cast<const RDMResponse*>(NULL)));
+
+  // Broadcasts aren't tracked.
+  port1.SetRDMHandler(
+    NewCallback(this, &UniverseTest::ReturnRDMCode,
+                ola::rdm::RDM_WAS_BROADCAST));
+  port2.SetRDMHandler(
+    NewCallback(this, &UniverseTest::ReturnRDMCode,
+                ola::rdm::RDM_WAS_BROADCAST));
+  universe->SendRDMRequest(
+      new ola::rdm::RDMGetRequest(source_uid, UID::VendorcastAddress(0x7a70),
+                                  0, 1, 10, 296, NULL, 0),
+      NewSingleCallback(this,
+                        &UniverseTest::ConfirmRDM,
+                        __LINE__,
+                        ola::rdm::RDM_WAS_BROADCAST,
+                        reinterpret_cast<const RDMResponse*>(NULL)));
+
+  const ola::rdm::RDMTimingStats *timing = universe->PortRDMTiming(&port1);
+  OLA_ASSERT_NOT_NULL(timing);
+  OLA_ASSERT_EQ(3u, timing->Totals().requests);
+  OLA_ASSERT_EQ(2u, timing->Totals().timeouts);
+  OLA_ASSERT_EQ(2u, timing->Totals().retransmits);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1), timing->Totals().latency.Count());
+  OLA_ASSERT_NULL(universe->PortRDMTiming(&port2));
+
+  const string port_id = port1.UniqueId();
+  OLA_ASSERT_EQ(3u, (*export_map.GetUIntMapVar(
+      Universe::K_RDM_PORT_REQUESTS_VAR))[port_id]);
+  OLA_ASSERT_EQ(2u, (*export_map.GetUIntMapVar(
+      Universe::K_RDM_PORT_RETRANSMITS_VAR))[port_id]);
+  OLA_ASSERT_EQ(2u, (*export_map.GetUIntMapVar(
+      Universe::K_RDM_RESPONDER_TIMEOUTS_VAR))[uid1.ToString()]);
+
+  // Removing the port drops the stats.
+  universe->RemovePort(&port1);
+  OLA_ASSERT_NULL(universe->PortRDMTiming(&port1));
+  const ola::UIntMap *requests = export_map.GetUIntMapVar(
+      Universe::K_RDM_RESPONDER_REQUESTS_VAR);
+  OLA_ASSERT_TRUE(requests->begin() == requests->end());
+  universe->RemovePort(&port2);
+}
+
+
 /**
  * Check we got the uids we expect
  */
@@ -143,3 +143,22 @@ dist_bootfonts_DATA = \
     olad/www/new/libs/bootstrap/fonts/glyphicons-halflings-regular.woff2
 dist_bootcss_DATA = \
     olad/www/new/libs/bootstrap/css/bootstrap.min.css
+
+# Install pre-compressed copies of the text files, the HTTP server sends these
+# to clients that accept them. brotli is optional.
+www_compressed_files = find $(DESTDIR)$(www_datadir) -type f \
+    \( -name '*.css' -o -name '*.html' -o -name '*.js' -o -name '*.json' \)
+
+install-data-hook-www:
+	$(www_compressed_files) -exec sh -c 'gzip -9 -n -c "$$1" > "$$1.gz"' \
+	    sh {} \;
+	if command -v brotli > /dev/null 2>&1; then \
+	  $(www_compressed_files) -exec brotli -f -q 11 {} \; ; \
+	fi
+
+uninstall-hook-www:
+	-find $(DESTDIR)$(www_datadir) -type f \
+	    \( -name '*.gz' -o -name '*.br' \) -exec rm -f {} \;
+
+INSTALL_DATA_HOOKS += install-data-hook-www
+UNINSTALL_HOOKS += uninstall-hook-www
@@ -95,7 +95,24 @@ ola.controller('menuCtrl', ['$scope', '$ola', '$interval', '$location',
     };
 
     getData();
-    $interval(getData, 10000);
+
+    // Refresh when olad reports a change, fall back to polling if the
+    // change feed isn't available.
+    var poll = null;
+    var startPolling = function() {
+      if (poll === null) {
+        poll = $interval(getData, 10000);
+      }
+    };
+
+    if ('WebSocket' in window) {
+      var scheme = window.location.protocol === 'https:' ? 'wss://' : 'ws://';
+      var feed = new WebSocket(scheme + window.location.host + '/ws/changes');
+      feed.onmessage = getData;
+      feed.onclose = startPolling;
+    } else {
+      startPolling();
+    }
   }]);
 
 /*jshint browser: true, jquery: true*/
@@ -612,6 +629,12 @@ ola.controller('settingUniverseCtrl',
                 modified.push(port.id);
               }
             }
+            if (port.is_output && typeof port.max_frame_rate === 'number') {
+              a[port.id + '_max_frame_rate'] = port.max_frame_rate;
+              if (modified.indexOf(port.id) === -1) {
+                modified.push(port.id);
+              }
+            }
           }
         });
         a.modify_ports = $.grep(modified, Boolean).join(',');
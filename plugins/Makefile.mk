@@ -1,4 +1,5 @@
 include plugins/artnet/Makefile.mk
+include plugins/cluster/Makefile.mk
 include plugins/dummy/Makefile.mk
 include plugins/espnet/Makefile.mk
 include plugins/ftdidmx/Makefile.mk
@@ -57,18 +57,28 @@ using std::string;
 using std::vector;
 
 const char ArtNetDevice::K_ALWAYS_BROADCAST_KEY[] = "always_broadcast";
+const char ArtNetDevice::K_BATCH_TRANSMIT_KEY[] = "batch_transmit";
 const char ArtNetDevice::K_DEVICE_NAME[] = "ArtNet";
+const char ArtNetDevice::K_INPUT_PORT_KEY[] = "input_ports";
 const char ArtNetDevice::K_IP_KEY[] = "ip";
 const char ArtNetDevice::K_LIMITED_BROADCAST_KEY[] = "use_limited_broadcast";
 const char ArtNetDevice::K_LONG_NAME_KEY[] = "long_name";
 const char ArtNetDevice::K_LOOPBACK_KEY[] = "use_loopback";
 const char ArtNetDevice::K_NET_KEY[] = "net";
 const char ArtNetDevice::K_OUTPUT_PORT_KEY[] = "output_ports";
+const char ArtNetDevice::K_RECEIVE_BUFFER_KEY[] = "receive_buffer_size";
+const char ArtNetDevice::K_SEND_BUFFER_KEY[] = "send_buffer_size";
+const char ArtNetDevice::K_SEND_SYNC_KEY[] = "send_sync";
 const char ArtNetDevice::K_SHORT_NAME_KEY[] = "short_name";
 const char ArtNetDevice::K_SUBNET_KEY[] = "subnet";
+const char ArtNetDevice::K_TRANSMIT_PACING_KEY[] = "transmit_pacing_ms";
 const unsigned int ArtNetDevice::K_ARTNET_NET = 0;
 const unsigned int ArtNetDevice::K_ARTNET_SUBNET = 0;
+const unsigned int ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT = 4;
 const unsigned int ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT = 4;
+const unsigned int ArtNetDevice::K_MAX_PORT_COUNT = 64;
+const unsigned int ArtNetDevice::K_MAX_SOCKET_BUFFER_SIZE = 64 * 1024 * 1024;
+const unsigned int ArtNetDevice::K_MAX_TRANSMIT_PACING_MS = 1000;
 
 ArtNetDevice::ArtNetDevice(AbstractPlugin *owner,
                            ola::Preferences *preferences,
@@ -104,10 +114,24 @@ bool ArtNetDevice::StartHook() {
       K_ALWAYS_BROADCAST_KEY);
   node_options.use_limited_broadcast_address = m_preferences->GetValueAsBool(
       K_LIMITED_BROADCAST_KEY);
+  node_options.batch_transmit = m_preferences->GetValueAsBool(
+      K_BATCH_TRANSMIT_KEY);
+  node_options.transmit_pacing_ms = StringToIntOrDefault(
+      m_preferences->GetValue(K_TRANSMIT_PACING_KEY), 0);
+  node_options.send_sync = m_preferences->GetValueAsBool(K_SEND_SYNC_KEY);
+  node_options.receive_buffer_size = StringToIntOrDefault(
+      m_preferences->GetValue(K_RECEIVE_BUFFER_KEY), 0);
+  node_options.send_buffer_size = StringToIntOrDefault(
+      m_preferences->GetValue(K_SEND_BUFFER_KEY), 0);
+  node_options.export_map = m_plugin_adaptor->GetExportMap();
   // OLA Output ports are ArtNet input ports
   node_options.input_port_count = StringToIntOrDefault(
       m_preferences->GetValue(K_OUTPUT_PORT_KEY),
       K_DEFAULT_OUTPUT_PORT_COUNT);
+  // OLA Input ports are ArtNet output ports
+  node_options.output_port_count = StringToIntOrDefault(
+      m_preferences->GetValue(K_INPUT_PORT_KEY),
+      K_DEFAULT_INPUT_PORT_COUNT);
 
   m_node = new ArtNetNode(iface, m_plugin_adaptor, node_options);
   m_node->SetNetAddress(net);
@@ -119,7 +143,7 @@ bool ArtNetDevice::StartHook() {
     AddPort(new ArtNetOutputPort(this, i, m_node));
   }
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < node_options.output_port_count; i++) {
     AddPort(new ArtNetInputPort(this, i, m_plugin_adaptor, m_node));
   }
 
@@ -134,15 +158,15 @@ bool ArtNetDevice::StartHook() {
   str << K_DEVICE_NAME << " [" << iface.ip_address << "]";
   SetName(str.str());
 
-  m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
-      POLL_INTERVAL,
+  m_timeout_id = m_plugin_adaptor->RegisterPeriodicTask(
+      ola::TimeInterval(POLL_INTERVAL * ola::ONE_THOUSAND),
       NewCallback(m_node, &ArtNetNode::SendPoll));
   return true;
 }
 
 void ArtNetDevice::PrePortStop() {
   if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
-    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+    m_plugin_adaptor->RemovePeriodicTask(m_timeout_id);
     m_timeout_id = ola::thread::INVALID_TIMEOUT;
   }
   m_node->Stop();
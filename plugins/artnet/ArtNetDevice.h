@@ -56,6 +56,10 @@ class ArtNetDevice: public Device {
   // only one ArtNet device
   std::string DeviceId() const { return "1"; }
 
+  /**
+   * Batch port changes, so a single ArtPoll / ArtPollReply is sent once
+   * they're complete.
+   */
   void EnterConfigurationMode() { m_node->EnterConfigurationMode(); }
   void ExitConfigurationMode() { m_node->ExitConfigurationMode(); }
 
@@ -72,18 +76,28 @@ class ArtNetDevice: public Device {
                  ConfigureCallback *done);
 
   static const char K_ALWAYS_BROADCAST_KEY[];
+  static const char K_BATCH_TRANSMIT_KEY[];
   static const char K_DEVICE_NAME[];
+  static const char K_INPUT_PORT_KEY[];
   static const char K_IP_KEY[];
   static const char K_LIMITED_BROADCAST_KEY[];
   static const char K_LONG_NAME_KEY[];
   static const char K_LOOPBACK_KEY[];
   static const char K_NET_KEY[];
   static const char K_OUTPUT_PORT_KEY[];
+  static const char K_RECEIVE_BUFFER_KEY[];
+  static const char K_SEND_BUFFER_KEY[];
+  static const char K_SEND_SYNC_KEY[];
   static const char K_SHORT_NAME_KEY[];
   static const char K_SUBNET_KEY[];
+  static const char K_TRANSMIT_PACING_KEY[];
   static const unsigned int K_ARTNET_NET;
   static const unsigned int K_ARTNET_SUBNET;
+  static const unsigned int K_DEFAULT_INPUT_PORT_COUNT;
   static const unsigned int K_DEFAULT_OUTPUT_PORT_COUNT;
+  static const unsigned int K_MAX_PORT_COUNT;
+  static const unsigned int K_MAX_SOCKET_BUFFER_SIZE;
+  static const unsigned int K_MAX_TRANSMIT_PACING_MS;
   // 10s between polls when we're sending data, DMX-workshop uses 8s;
   static const unsigned int POLL_INTERVAL = 10000;
 
@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "ola/Constants.h"
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/network/IPV4Address.h"
@@ -38,6 +39,7 @@
 #include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/strings/Utils.h"
+#include "ola/util/Trace.h"
 #include "plugins/artnet/ArtNetNode.h"
 
 
@@ -53,6 +55,7 @@ using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
 using ola::network::LittleEndianToHost;
 using ola::network::NetworkToHost;
+using ola::network::UDPDatagram;
 using ola::network::UDPSocket;
 using ola::rdm::RDMCallback;
 using ola::rdm::RDMCommand;
@@ -77,9 +80,19 @@ using std::vector;
 const char ArtNetNodeImpl::ARTNET_ID[] = "Art-Net";
 
 
-// UID to the IP Address it came from, and the number of times since we last
-// saw it in an ArtTod message.
-typedef map<UID, std::pair<IPV4Address, uint8_t> > uid_map;
+// UID to the IP Address of the node that reported it.
+typedef map<UID, IPV4Address> uid_map;
+
+// The part of a port's TOD that came from one node.
+struct NodeTod {
+  NodeTod() : missed(0) {}
+
+  UIDSet uids;  // the UIDs this node reported
+  UIDSet pending;  // the UIDs from the blocks of the current TOD so far
+  uint8_t missed;  // the discovery runs since we last heard from the node
+};
+
+typedef map<IPV4Address, NodeTod> NodeTods;
 
 // Input ports are ones that send data using ArtNet
 class ArtNetNodeImpl::InputPort {
@@ -92,6 +105,9 @@ class ArtNetNodeImpl::InputPort {
         rdm_request_callback(NULL),
         pending_request(NULL),
         rdm_send_timeout(ola::thread::INVALID_TIMEOUT),
+        next_port(NO_PORT),
+        node_expiry_timeout(ola::thread::INVALID_TIMEOUT),
+        destinations_valid(false),
         m_port_address(0),
         m_tod_callback(NULL) {
   }
@@ -105,13 +121,22 @@ class ArtNetNodeImpl::InputPort {
     }
 
     m_port_address = ((m_port_address & 0xf0) | universe_address);
-    uids.clear();
-    subscribed_nodes.clear();
+    ClearUIDs();
+    ClearSubscribedNodes();
     return true;
   }
 
   void ClearSubscribedNodes() {
     subscribed_nodes.clear();
+    destinations_valid = false;
+  }
+
+  // Record that a node is listening to this port.
+  void AddSubscribedNode(const IPV4Address &address, const TimeStamp &now) {
+    if (!STLReplace(&subscribed_nodes, address, now)) {
+      // A new node, the destinations need to be rebuilt.
+      destinations_valid = false;
+    }
   }
 
   // Returns true if the address changed.
@@ -122,8 +147,8 @@ class ArtNetNodeImpl::InputPort {
     }
 
     m_port_address = subnet_address | (m_port_address & 0x0f);
-    uids.clear();
-    subscribed_nodes.clear();
+    ClearUIDs();
+    ClearSubscribedNodes();
     return true;
   }
 
@@ -139,7 +164,7 @@ class ArtNetNodeImpl::InputPort {
 
   void RunTodCallback() {
     if (m_tod_callback.get()) {
-      RunRDMCallbackWithUIDs(uids, m_tod_callback.get());
+      m_tod_callback->Run(m_uid_set);
     }
   }
 
@@ -147,20 +172,80 @@ class ArtNetNodeImpl::InputPort {
     if (discovery_callback) {
       RDMDiscoveryCallback *callback = discovery_callback;
       discovery_callback = NULL;
-      RunRDMCallbackWithUIDs(uids, callback);
+      callback->Run(m_uid_set);
+    }
+  }
+
+  // Record that a node reported a UID, returns true if the UID is new to
+  // this port.
+  bool AddNodeUID(const IPV4Address &node, const UID &uid) {
+    std::pair<uid_map::iterator, bool> result = uids.insert(
+        uid_map::value_type(uid, node));
+    if (result.second) {
+      m_uid_set.AddUID(uid);
+    } else if (result.first->second != node) {
+      OLA_WARN << "UID " << uid << " changed from "
+               << result.first->second << " to " << node;
+      NodeTod *previous = STLFind(&node_tods, result.first->second);
+      if (previous) {
+        previous->uids.RemoveUID(uid);
+      }
+      result.first->second = node;
+    }
+    node_tods[node].uids.AddUID(uid);
+    return result.second;
+  }
+
+  // Remove a UID a node no longer reports, returns true if it was removed
+  // from this port.
+  bool RemoveNodeUID(const IPV4Address &node, const UID &uid) {
+    NodeTod *node_tod = STLFind(&node_tods, node);
+    if (node_tod) {
+      node_tod->uids.RemoveUID(uid);
+    }
+    uid_map::iterator iter = uids.find(uid);
+    if (iter == uids.end() || iter->second != node) {
+      return false;
+    }
+    uids.erase(iter);
+    m_uid_set.RemoveUID(uid);
+    return true;
+  }
+
+  // Remove all the UIDs reported by a node.
+  void RemoveNode(const IPV4Address &node) {
+    NodeTods::iterator iter = node_tods.find(node);
+    if (iter == node_tods.end()) {
+      return;
+    }
+    UIDSet::Iterator uid_iter = iter->second.uids.Begin();
+    for (; uid_iter != iter->second.uids.End(); ++uid_iter) {
+      uids.erase(*uid_iter);
+      m_uid_set.RemoveUID(*uid_iter);
     }
+    node_tods.erase(iter);
   }
 
-  void IncrementUIDCounts() {
-    for (uid_map::iterator iter = uids.begin(); iter != uids.end(); ++iter) {
-      iter->second.second++;
+  void IncrementNodeCounts() {
+    NodeTods::iterator iter = node_tods.begin();
+    for (; iter != node_tods.end(); ++iter) {
+      iter->second.missed++;
     }
   }
 
+  void ClearUIDs() {
+    uids.clear();
+    node_tods.clear();
+    m_uid_set.Clear();
+  }
+
   bool enabled;
   uint8_t sequence_number;
   map<IPV4Address, TimeStamp> subscribed_nodes;
   uid_map uids;  // used to keep track of the UIDs
+  // The TOD from each node, so a TodData packet only touches the entries
+  // for the node that sent it.
+  NodeTods node_tods;
   // NULL if discovery isn't running, otherwise the callback to run when it
   // finishes
   RDMDiscoveryCallback *discovery_callback;
@@ -176,21 +261,25 @@ class ArtNetNodeImpl::InputPort {
   // these control the sending of RDM requests.
   ola::thread::timeout_id rdm_send_timeout;
 
+  // The next enabled port with the same port address, or NO_PORT.
+  uint8_t next_port;
+  // Fires at node_expiry, when the oldest of the subscribed_nodes could
+  // time out.
+  ola::thread::timeout_id node_expiry_timeout;
+  TimeStamp node_expiry;
+
+  // The unicast destinations for ArtDmx, built from subscribed_nodes. This
+  // is rebuilt when a node is added or removed.
+  vector<IPV4SocketAddress> destinations;
+  bool destinations_valid;
+
  private:
   uint8_t m_port_address;
   // The callback to run if we receive an TOD and the discovery process
   // isn't running
   auto_ptr<RDMDiscoveryCallback> m_tod_callback;
-
-  void RunRDMCallbackWithUIDs(const uid_map &uids,
-                              RDMDiscoveryCallback *callback) {
-    UIDSet uid_set;
-    uid_map::const_iterator uid_iter = uids.begin();
-    for (; uid_iter != uids.end(); ++uid_iter) {
-      uid_set.AddUID(uid_iter->first);
-    }
-    callback->Run(uid_set);
-  }
+  // The keys of uids, kept up to date so the callbacks don't rebuild it.
+  UIDSet m_uid_set;
 };
 
 ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
@@ -199,6 +288,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
                                ola::network::UDPSocketInterface *socket)
     : m_running(false),
       m_net_address(0),
+      m_subnet_address(0),
       m_send_reply_on_change(true),
       m_short_name(""),
       m_long_name(""),
@@ -211,7 +301,17 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_artpoll_required(false),
       m_artpollreply_required(false),
       m_interface(iface),
-      m_socket(socket) {
+      m_socket(socket),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  sizeof(artnet_packet)),
+      m_batch_transmit(options.batch_transmit),
+      m_transmit_pacing_ms(options.transmit_pacing_ms),
+      m_receive_buffer_size(options.receive_buffer_size),
+      m_send_buffer_size(options.send_buffer_size),
+      m_export_map(options.export_map),
+      m_send_sync(options.send_sync),
+      m_send_sync_timeout(ola::thread::INVALID_TIMEOUT),
+      m_sync_mode(false) {
 
   if (!m_socket.get()) {
     m_socket.reset(new UDPSocket());
@@ -222,18 +322,24 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
   }
 
   // reset all the port structures
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = 0;
-    m_output_ports[i].sequence_number = 0;
-    m_output_ports[i].enabled = false;
-    m_output_ports[i].is_merging = false;
-    m_output_ports[i].merge_mode = ARTNET_MERGE_HTP;
-    m_output_ports[i].buffer = NULL;
-    m_output_ports[i].on_data = NULL;
-    m_output_ports[i].on_discover = NULL;
-    m_output_ports[i].on_flush = NULL;
-    m_output_ports[i].on_rdm_request = NULL;
-  }
+  for (unsigned int i = 0; i < options.output_port_count; i++) {
+    m_output_ports.push_back(new OutputPort());
+    m_output_ports[i]->universe_address = 0;
+    m_output_ports[i]->sequence_number = 0;
+    m_output_ports[i]->enabled = false;
+    m_output_ports[i]->is_merging = false;
+    m_output_ports[i]->merge_mode = ARTNET_MERGE_HTP;
+    m_output_ports[i]->buffer = NULL;
+    m_output_ports[i]->arrival = NULL;
+    m_output_ports[i]->on_data = NULL;
+    m_output_ports[i]->on_discover = NULL;
+    m_output_ports[i]->on_flush = NULL;
+    m_output_ports[i]->on_rdm_request = NULL;
+    m_output_ports[i]->next_port = NO_PORT;
+    m_output_ports[i]->sync_pending = false;
+  }
+  UpdateInputPortTable();
+  UpdateOutputPortTable();
 }
 
 ArtNetNodeImpl::~ArtNetNodeImpl() {
@@ -241,20 +347,21 @@ ArtNetNodeImpl::~ArtNetNodeImpl() {
 
   STLDeleteElements(&m_input_ports);
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    if (m_output_ports[i].on_data) {
-      delete m_output_ports[i].on_data;
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    if (m_output_ports[i]->on_data) {
+      delete m_output_ports[i]->on_data;
     }
-    if (m_output_ports[i].on_discover) {
-      delete m_output_ports[i].on_discover;
+    if (m_output_ports[i]->on_discover) {
+      delete m_output_ports[i]->on_discover;
     }
-    if (m_output_ports[i].on_flush) {
-      delete m_output_ports[i].on_flush;
+    if (m_output_ports[i]->on_flush) {
+      delete m_output_ports[i]->on_flush;
     }
-    if (m_output_ports[i].on_rdm_request) {
-      delete m_output_ports[i].on_rdm_request;
+    if (m_output_ports[i]->on_rdm_request) {
+      delete m_output_ports[i]->on_rdm_request;
     }
   }
+  STLDeleteElements(&m_output_ports);
 }
 
 bool ArtNetNodeImpl::Start() {
@@ -262,6 +369,14 @@ bool ArtNetNodeImpl::Start() {
     return false;
   }
 
+  const string socket_name = "artnet:" + m_interface.ip_address.ToString();
+  m_recv_ring.ExportDrops(m_export_map, socket_name);
+  if (m_batch_transmit) {
+    m_tx_batcher.reset(new ola::network::UDPTransmitBatcher(
+        m_ss, m_socket.get(), m_export_map, socket_name));
+    m_tx_batcher->SetPacing(TimeInterval(
+        static_cast<int64_t>(m_transmit_pacing_ms) * ONE_THOUSAND));
+  }
   m_running = true;
   return true;
 }
@@ -282,6 +397,11 @@ bool ArtNetNodeImpl::Stop() {
       port->discovery_timeout = ola::thread::INVALID_TIMEOUT;
     }
 
+    if (port->node_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+      m_ss->RemoveTimeout(port->node_expiry_timeout);
+      port->node_expiry_timeout = ola::thread::INVALID_TIMEOUT;
+    }
+
     port->RunDiscoveryCallback();
 
     // clean up request state
@@ -302,6 +422,15 @@ bool ArtNetNodeImpl::Stop() {
     }
   }
 
+  if (m_send_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_send_sync_timeout);
+    m_send_sync_timeout = ola::thread::INVALID_TIMEOUT;
+    SendSync();
+  }
+  m_sync_mode = false;
+
+  // This sends anything that's still queued.
+  m_tx_batcher.reset();
   m_ss->RemoveReadDescriptor(m_socket.get());
 
   m_running = false;
@@ -385,22 +514,26 @@ bool ArtNetNodeImpl::SetSubnetAddress(uint8_t subnet_address) {
     input_ports_enabled |= (*iter)->enabled;
     changed |= (*iter)->SetSubNetAddress(subnet_address);
   }
+  if (changed) {
+    UpdateInputPortTable();
+  }
 
   if (input_ports_enabled && changed) {
     SendPollIfAllowed();
   }
 
   // set for all output ports.
-  uint8_t old_address = m_output_ports[0].universe_address >> 4;
-  if (old_address == subnet_address && !changed) {
+  if (m_subnet_address == subnet_address && !changed) {
     return true;
   }
 
+  m_subnet_address = subnet_address;
   subnet_address = subnet_address << 4;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = subnet_address |
-        (m_output_ports[i].universe_address & 0x0f);
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    m_output_ports[i]->universe_address = subnet_address |
+        (m_output_ports[i]->universe_address & 0x0f);
   }
+  UpdateOutputPortTable();
 
   return SendPollReplyIfRequired();
 }
@@ -409,6 +542,10 @@ uint8_t ArtNetNodeImpl::InputPortCount() const {
   return m_input_ports.size();
 }
 
+uint8_t ArtNetNodeImpl::OutputPortCount() const {
+  return m_output_ports.size();
+}
+
 bool ArtNetNodeImpl::SetInputPortUniverse(uint8_t port_id,
                                           uint8_t universe_id) {
   InputPort *port = GetInputPort(port_id);
@@ -416,11 +553,16 @@ bool ArtNetNodeImpl::SetInputPortUniverse(uint8_t port_id,
     return false;
   }
 
+  const bool was_enabled = port->enabled;
   port->enabled = true;
   if (port->SetUniverseAddress(universe_id)) {
+    UpdateInputPortTable();
     SendPollIfAllowed();
     return SendPollReplyIfRequired();
   }
+  if (!was_enabled) {
+    UpdateInputPortTable();
+  }
   return true;
 }
 
@@ -438,6 +580,7 @@ void ArtNetNodeImpl::DisableInputPort(uint8_t port_id) {
   }
 
   if (was_enabled) {
+    UpdateInputPortTable();
     SendPollReplyIfRequired();
   }
 }
@@ -461,6 +604,7 @@ bool ArtNetNodeImpl::SetOutputPortUniverse(uint8_t port_id,
   port->universe_address = (
       (universe_id & 0x0f) | (port->universe_address & 0xf0));
   port->enabled = true;
+  UpdateOutputPortTable();
   return SendPollReplyIfRequired();
 }
 
@@ -478,6 +622,7 @@ void ArtNetNodeImpl::DisableOutputPort(uint8_t port_id) {
   bool was_enabled = port->enabled;
   port->enabled = false;
   if (was_enabled) {
+    UpdateOutputPortTable();
     SendPollReplyIfRequired();
   }
 }
@@ -559,9 +704,13 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
 
   unsigned int size = sizeof(packet.data.dmx) - DMX_UNIVERSE_SIZE + buffer_size;
 
+  if (!m_always_broadcast) {
+    UpdatePortDestinations(port);
+  }
+
   bool sent_ok = false;
-  if (port->subscribed_nodes.size() >= m_broadcast_threshold ||
-      m_always_broadcast) {
+  if (m_always_broadcast ||
+      port->destinations.size() >= m_broadcast_threshold) {
     sent_ok = SendPacket(
         packet,
         size,
@@ -569,37 +718,46 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         IPV4Address::Broadcast() :
         m_interface.bcast_address);
     port->sequence_number++;
+  } else if (port->destinations.empty()) {
+    OLA_DEBUG << "Suppressing data transmit due to no active nodes for "
+                 "universe "
+              << static_cast<int>(port->PortAddress());
+    sent_ok = true;
   } else {
-    map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
-    TimeStamp last_heard_threshold = (
-        *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
-    while (iter != port->subscribed_nodes.end()) {
-      // if this node has timed out, remove it from the set
-      if (iter->second < last_heard_threshold) {
-        port->subscribed_nodes.erase(iter++);
-        continue;
-      }
-      sent_ok |= SendPacket(packet, size, iter->first);
-      ++iter;
-    }
-
-    if (port->subscribed_nodes.empty()) {
-      OLA_DEBUG << "Suppressing data transmit due to no active nodes for "
-                   "universe "
-                << static_cast<int>(port->PortAddress());
-      sent_ok = true;
-    } else {
-      // We sent at least one packet, increment the sequence number
-      port->sequence_number++;
+    vector<IPV4SocketAddress>::const_iterator iter =
+        port->destinations.begin();
+    for (; iter != port->destinations.end(); ++iter) {
+      sent_ok |= SendPacket(packet, size, *iter);
     }
+    // We sent at least one packet, increment the sequence number
+    port->sequence_number++;
   }
 
   if (!sent_ok) {
     OLA_WARN << "Failed to send ArtNet DMX packet";
+  } else if (m_send_sync &&
+             m_send_sync_timeout == ola::thread::INVALID_TIMEOUT) {
+    // The ArtSync follows all the ArtDmx packets sent in this loop iteration.
+    m_send_sync_timeout = m_ss->RegisterSingleTimeout(
+        TimeInterval(0, 0),
+        ola::MakeInlineCallback(this, &ArtNetNodeImpl::ScheduledSendSync));
   }
   return sent_ok;
 }
 
+bool ArtNetNodeImpl::SendSync() {
+  artnet_packet packet;
+  PopulatePacketHeader(&packet, ARTNET_SYNC);
+  memset(&packet.data.sync, 0, sizeof(packet.data.sync));
+  packet.data.sync.version = HostToNetwork(ARTNET_VERSION);
+  if (!SendPacket(packet, sizeof(packet.data.sync),
+                  m_interface.bcast_address)) {
+    OLA_INFO << "Failed to send ArtSync";
+    return false;
+  }
+  return true;
+}
+
 void ArtNetNodeImpl::RunFullDiscovery(uint8_t port_id,
                                       RDMDiscoveryCallback *callback) {
   InputPort *port = GetEnabledInputPort(port_id, "ArtTodControl");
@@ -686,7 +844,7 @@ void ArtNetNodeImpl::SendRDMRequest(uint8_t port_id,
                << " in the uid map, broadcasting packet";
     }
   } else {
-    port->rdm_ip_destination = iter->second.first;
+    port->rdm_ip_destination = iter->second;
   }
 
   port->rdm_request_callback = on_complete;
@@ -728,29 +886,27 @@ void ArtNetNodeImpl::GetSubscribedNodes(
     return;
   }
 
-  map<IPV4Address, TimeStamp> &subscribed_nodes = port->subscribed_nodes;
-  map<IPV4Address, TimeStamp>::const_iterator iter = subscribed_nodes.begin();
-  for (; iter != subscribed_nodes.end(); ++iter) {
-    TimeStamp last_heard_threshold = (
-        *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
-    if (iter->second >= last_heard_threshold) {
-      node_addresses->push_back(iter->first);
-    }
+  UpdatePortDestinations(port);
+  vector<IPV4SocketAddress>::const_iterator iter = port->destinations.begin();
+  for (; iter != port->destinations.end(); ++iter) {
+    node_addresses->push_back(iter->Host());
   }
 }
 
 bool ArtNetNodeImpl::SetDMXHandler(uint8_t port_id,
                                    DmxBuffer *buffer,
-                                   Callback0<void> *on_data) {
+                                   Callback0<void> *on_data,
+                                   TimeStamp *arrival) {
   OutputPort *port = GetOutputPort(port_id);
   if (!port) {
     return false;
   }
 
   if (port->on_data) {
-    delete m_output_ports[port_id].on_data;
+    delete m_output_ports[port_id]->on_data;
   }
   port->buffer = buffer;
+  port->arrival = arrival;
   port->on_data = on_data;
   return true;
 }
@@ -761,7 +917,7 @@ bool ArtNetNodeImpl::SendTod(uint8_t port_id, const UIDSet &uid_set) {
     return false;
   }
 
-  OLA_DEBUG << "Sending ArtTodRequest";
+  OLA_DEBUG << "Sending ArtTodData";
   artnet_packet packet;
   PopulatePacketHeader(&packet, ARTNET_TODDATA);
   memset(&packet.data.tod_data, 0, sizeof(packet.data.tod_data));
@@ -851,17 +1007,16 @@ bool ArtNetNodeImpl::SendTimeCode(const ola::timecode::TimeCode &timecode) {
 }
 
 void ArtNetNodeImpl::SocketReady() {
-  artnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size,
-                          &source)) {
-    return;
+  ola::TraceSpan span("artnet.receive");
+  unsigned int count = m_recv_ring.Receive(m_socket.get());
+  for (unsigned int i = 0; i < count; i++) {
+    const UDPDatagram &datagram = m_recv_ring.Get(i);
+    ola::TraceSpan packet_span("artnet.packet");
+    m_packet_arrival = datagram.arrival;
+    HandlePacket(datagram.source.Host(),
+                 *reinterpret_cast<const artnet_packet*>(datagram.data),
+                 datagram.size);
   }
-
-  HandlePacket(source.Host(), packet, packet_size);
 }
 
 bool ArtNetNodeImpl::SendPollIfAllowed() {
@@ -890,6 +1045,21 @@ bool ArtNetNodeImpl::SendPollReplyIfRequired() {
 }
 
 bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
+  unsigned int port_count = std::max(m_input_ports.size(),
+                                     m_output_ports.size());
+  unsigned int page_count = std::max(
+      1u, (port_count + ARTNET_MAX_PORTS - 1) / ARTNET_MAX_PORTS);
+
+  bool ok = true;
+  for (unsigned int page = 0; page < page_count; page++) {
+    ok &= SendPollReplyPage(destination, page, page_count);
+  }
+  return ok;
+}
+
+bool ArtNetNodeImpl::SendPollReplyPage(const IPV4Address &destination,
+                                       unsigned int page,
+                                       unsigned int page_count) {
   artnet_packet packet;
   PopulatePacketHeader(&packet, ARTNET_REPLY);
   memset(&packet.data.reply, 0, sizeof(packet.data.reply));
@@ -897,7 +1067,7 @@ bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
   m_interface.ip_address.Get(packet.data.reply.ip);
   packet.data.reply.port = HostToLittleEndian(ARTNET_PORT);
   packet.data.reply.net_address = m_net_address;
-  packet.data.reply.subnet_address = m_output_ports[0].universe_address >> 4;
+  packet.data.reply.subnet_address = m_subnet_address;
   packet.data.reply.oem = HostToNetwork(OEM_CODE);
   packet.data.reply.status1 = 0xd2;  // normal indicators, rdm enabled
   packet.data.reply.esta_id = HostToLittleEndian(OPEN_LIGHTING_ESTA_CODE);
@@ -910,22 +1080,41 @@ bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
   str << "#0001 [" << m_unsolicited_replies << "] OLA";
   CopyToFixedLengthBuffer(str.str(), packet.data.reply.node_report,
                           arraysize(packet.data.reply.node_report));
-  packet.data.reply.number_ports[1] = ARTNET_MAX_PORTS;
+  // Each page describes the next ARTNET_MAX_PORTS input & output ports.
+  uint8_t number_ports = 0;
   for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    InputPort *iport = GetInputPort(i, false);
-    packet.data.reply.port_types[i] = iport ? 0xc0 : 0x80;
+    unsigned int port_id = page * ARTNET_MAX_PORTS + i;
+    const InputPort *iport = port_id < m_input_ports.size() ?
+        m_input_ports[port_id] : NULL;
+    const OutputPort *oport = port_id < m_output_ports.size() ?
+        m_output_ports[port_id] : NULL;
+    if (!(iport || oport)) {
+      break;
+    }
+    number_ports++;
+
+    packet.data.reply.port_types[i] = (
+        (iport ? 0x40 : 0x00) | (oport ? 0x80 : 0x00));
     packet.data.reply.good_input[i] = iport && iport->enabled ? 0x0 : 0x8;
     packet.data.reply.sw_in[i] = iport ? iport->PortAddress() : 0;
 
-    packet.data.reply.good_output[i] = (
-        (m_output_ports[i].enabled ? 0x80 : 0x00) |
-        (m_output_ports[i].merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
-        (m_output_ports[i].is_merging ? 0x8 : 0x0));
-    packet.data.reply.sw_out[i] = m_output_ports[i].universe_address;
+    if (oport) {
+      packet.data.reply.good_output[i] = (
+          (oport->enabled ? 0x80 : 0x00) |
+          (oport->merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
+          (oport->is_merging ? 0x8 : 0x0));
+      packet.data.reply.sw_out[i] = oport->universe_address;
+    }
   }
+  packet.data.reply.number_ports[1] = number_ports;
   packet.data.reply.style = NODE_CODE;
   m_interface.hw_address.Get(packet.data.reply.mac);
   m_interface.ip_address.Get(packet.data.reply.bind_ip);
+  // A node with a single page sends the original ArtPollReply, otherwise the
+  // pages are numbered from 1, which is the root device.
+  if (page_count > 1) {
+    packet.data.reply.bind_index = static_cast<uint8_t>(page + 1);
+  }
   // maybe set status2 here if the web UI is enabled
   packet.data.reply.status2 = 0x08;  // node supports 15 bit port addresses
   if (!SendPacket(packet, sizeof(packet.data.reply), destination)) {
@@ -978,6 +1167,11 @@ void ArtNetNodeImpl::HandlePacket(const IPV4Address &source_address,
                        packet.data.dmx,
                        packet_size - header_size);
       break;
+    case ARTNET_SYNC:
+      HandleSyncPacket(source_address,
+                       packet.data.sync,
+                       packet_size - header_size);
+      break;
     case ARTNET_TODREQUEST:
       HandleTodRequest(source_address,
                        packet.data.tod_request,
@@ -1063,20 +1257,22 @@ void ArtNetNodeImpl::HandleReplyPacket(const IPV4Address &source_address,
     return;
   }
 
-  // Update the subscribed nodes list
+  // Update the subscribed nodes list. Only the port types and swout fields
+  // are read, and only for the output ports that match one of our input
+  // ports.
   unsigned int port_limit = std::min((uint8_t) ARTNET_MAX_PORTS,
                                      packet.number_ports[1]);
+  const TimeStamp &now = *m_ss->WakeUpTime();
   for (unsigned int i = 0; i < port_limit; i++) {
-    if (packet.port_types[i] & 0x80) {
-      // port is of type output
-      uint8_t universe_id = packet.sw_out[i];
-      InputPorts::iterator iter = m_input_ports.begin();
-      for (; iter != m_input_ports.end(); ++iter) {
-        if ((*iter)->enabled && (*iter)->PortAddress() == universe_id) {
-          STLReplace(&(*iter)->subscribed_nodes, source_address,
-                     *m_ss->WakeUpTime());
-        }
-      }
+    if (!(packet.port_types[i] & 0x80)) {
+      continue;  // not an output port
+    }
+    uint8_t port_id = m_input_port_table[packet.sw_out[i]];
+    while (port_id != NO_PORT) {
+      InputPort *port = m_input_ports[port_id];
+      port->AddSubscribedNode(source_address, now);
+      ScheduleNodeExpiry(port, now, now);
+      port_id = port->next_port;
     }
   }
 }
@@ -1104,26 +1300,53 @@ void ArtNetNodeImpl::HandleDataPacket(const IPV4Address &source_address,
     return;
   }
 
+  if (m_sync_mode &&
+      m_last_sync < *m_ss->WakeUpTime() - TimeInterval(SYNC_TIMEOUT, 0)) {
+    OLA_INFO << "No ArtSync received for " << SYNC_TIMEOUT
+             << "s, reverting to non-synchronous mode";
+    m_sync_mode = false;
+    ReleaseSyncedPorts();
+  }
+
   uint16_t universe_id = LittleEndianToHost(packet.universe);
   uint16_t data_size = std::min(
       (unsigned int) ((packet.length[0] << 8) + packet.length[1]),
       packet_size - header_size);
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == universe_id &&
-        m_output_ports[port_id].on_data &&
-        m_output_ports[port_id].buffer) {
+  uint8_t port_id = m_output_port_table[universe_id & 0xff];
+  while (port_id != NO_PORT) {
+    OutputPort *port = m_output_ports[port_id];
+    if (port->on_data && port->buffer) {
       // update this port, doing a merge if necessary
-      DMXSource source;
-      source.address = source_address;
-      source.timestamp = *m_ss->WakeUpTime();
-      source.buffer.Set(packet.data, data_size);
-      UpdatePortFromSource(&m_output_ports[port_id], source);
+      UpdatePortFromSource(port, source_address, packet.data, data_size);
     }
+    port_id = port->next_port;
   }
 }
 
+void ArtNetNodeImpl::HandleSyncPacket(const IPV4Address &source_address,
+                                      const artnet_sync_t &packet,
+                                      unsigned int packet_size) {
+  if (!CheckPacketSize(source_address,
+                       "ArtSync",
+                       packet_size,
+                       sizeof(packet))) {
+    return;
+  }
+
+  if (!CheckPacketVersion(source_address, "ArtSync", packet.version)) {
+    return;
+  }
+
+  if (!m_sync_mode) {
+    OLA_INFO << "Received ArtSync from " << source_address
+             << ", entering synchronous mode";
+    m_sync_mode = true;
+  }
+  m_last_sync = *m_ss->WakeUpTime();
+  ReleaseSyncedPorts();
+}
+
 void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
                                       const artnet_todrequest_t &packet,
                                       unsigned int packet_size) {
@@ -1159,16 +1382,16 @@ void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
       static_cast<unsigned int>(ARTNET_MAX_RDM_ADDRESS_COUNT),
       addresses);
 
-  bool handler_called[ARTNET_MAX_PORTS];
-  memset(handler_called, 0, sizeof(handler_called));
+  vector<bool> handler_called(m_output_ports.size(), false);
 
   for (unsigned int i = 0; i < addresses; i++) {
-    for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-      if (m_output_ports[port_id].enabled &&
-          m_output_ports[port_id].universe_address == packet.addresses[i] &&
-          m_output_ports[port_id].on_discover &&
+    for (unsigned int port_id = 0; port_id < m_output_ports.size();
+         port_id++) {
+      if (m_output_ports[port_id]->enabled &&
+          m_output_ports[port_id]->universe_address == packet.addresses[i] &&
+          m_output_ports[port_id]->on_discover &&
           !handler_called[port_id]) {
-        m_output_ports[port_id].on_discover->Run();
+        m_output_ports[port_id]->on_discover->Run();
         handler_called[port_id] = true;
       }
     }
@@ -1207,11 +1430,11 @@ void ArtNetNodeImpl::HandleTodData(const IPV4Address &source_address,
     return;
   }
 
-  InputPorts::iterator iter = m_input_ports.begin();
-  for (; iter != m_input_ports.end(); ++iter) {
-    if ((*iter)->enabled && (*iter)->PortAddress() == packet.address) {
-      UpdatePortFromTodPacket(*iter, source_address, packet, packet_size);
-    }
+  uint8_t port_id = m_input_port_table[packet.address];
+  while (port_id != NO_PORT) {
+    InputPort *port = m_input_ports[port_id];
+    UpdatePortFromTodPacket(port, source_address, packet, packet_size);
+    port_id = port->next_port;
   }
 }
 
@@ -1239,11 +1462,11 @@ void ArtNetNodeImpl::HandleTodControl(const IPV4Address &source_address,
     return;
   }
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_flush) {
-      m_output_ports[port_id].on_flush->Run();
+  for (unsigned int port_id = 0; port_id < m_output_ports.size(); port_id++) {
+    if (m_output_ports[port_id]->enabled &&
+        m_output_ports[port_id]->universe_address == packet.address &&
+        m_output_ports[port_id]->on_flush) {
+      m_output_ports[port_id]->on_flush->Run();
     }
   }
 }
@@ -1285,21 +1508,21 @@ void ArtNetNodeImpl::HandleRdm(const IPV4Address &source_address,
 
   // look for the port that this was sent to, once we know the port we can try
   // to parse the message
-  for (uint8_t port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_rdm_request) {
+  for (uint8_t port_id = 0; port_id < m_output_ports.size(); port_id++) {
+    if (m_output_ports[port_id]->enabled &&
+        m_output_ports[port_id]->universe_address == packet.address &&
+        m_output_ports[port_id]->on_rdm_request) {
       RDMRequest *request = RDMRequest::InflateFromData(packet.data,
                                                         rdm_length);
 
       if (request) {
-        m_output_ports[port_id].on_rdm_request->Run(
+        m_output_ports[port_id]->on_rdm_request->Run(
             request,
             NewSingleCallback(this,
                               &ArtNetNodeImpl::RDMRequestCompletion,
                               source_address,
                               port_id,
-                              m_output_ports[port_id].universe_address));
+                              m_output_ports[port_id]->universe_address));
       }
     }
   }
@@ -1446,11 +1669,18 @@ void ArtNetNodeImpl::PopulatePacketHeader(artnet_packet *packet,
 bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
                                 unsigned int size,
                                 const IPV4Address &ip_destination) {
+  return SendPacket(packet, size,
+                    IPV4SocketAddress(ip_destination, ARTNET_PORT));
+}
+
+bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
+                                unsigned int size,
+                                const IPV4SocketAddress &destination) {
   size += sizeof(packet.id) + sizeof(packet.op_code);
-  unsigned int bytes_sent = m_socket->SendTo(
-      reinterpret_cast<const uint8_t*>(&packet),
-      size,
-      IPV4SocketAddress(ip_destination, ARTNET_PORT));
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(&packet);
+  unsigned int bytes_sent = m_tx_batcher.get() ?
+      m_tx_batcher->SendTo(data, size, destination) :
+      m_socket->SendTo(data, size, destination);
 
   if (bytes_sent != size) {
     OLA_INFO << "Only sent " << bytes_sent << " of " << size;
@@ -1459,6 +1689,69 @@ bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
   return true;
 }
 
+void ArtNetNodeImpl::UpdatePortDestinations(InputPort *port) {
+  if (port->destinations_valid) {
+    return;
+  }
+
+  port->destinations.clear();
+  map<IPV4Address, TimeStamp>::const_iterator iter =
+      port->subscribed_nodes.begin();
+  for (; iter != port->subscribed_nodes.end(); ++iter) {
+    port->destinations.push_back(IPV4SocketAddress(iter->first, ARTNET_PORT));
+  }
+  port->destinations_valid = true;
+}
+
+void ArtNetNodeImpl::ScheduleNodeExpiry(InputPort *port,
+                                        const TimeStamp &oldest,
+                                        const TimeStamp &now) {
+  if (port->node_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+  port->node_expiry = oldest + TimeInterval(NODE_TIMEOUT, 0);
+  TimeInterval delay;
+  if (port->node_expiry > now) {
+    delay = port->node_expiry - now;
+  }
+  port->node_expiry_timeout = m_ss->RegisterSingleTimeout(
+      delay,
+      ola::NewSingleCallback(this, &ArtNetNodeImpl::ExpireNodes, port));
+}
+
+void ArtNetNodeImpl::ExpireNodes(InputPort *port) {
+  port->node_expiry_timeout = ola::thread::INVALID_TIMEOUT;
+
+  // Timeouts can run before the wake up time is updated, but it's at
+  // least node_expiry by now.
+  const TimeStamp now = std::max(*m_ss->WakeUpTime(), port->node_expiry);
+  // Nodes that are about to time out are removed now as well, so a burst of
+  // replies from one poll doesn't become a burst of timeouts.
+  const TimeStamp last_heard_threshold = (
+      now - TimeInterval(NODE_TIMEOUT, 0) +
+      TimeInterval(NODE_EXPIRY_GRANULARITY, 0));
+  // The time the next node was last heard from.
+  TimeStamp oldest = now;
+
+  map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
+  while (iter != port->subscribed_nodes.end()) {
+    if (iter->second <= last_heard_threshold) {
+      OLA_DEBUG << "ArtNet node " << iter->first << " timed out";
+      port->subscribed_nodes.erase(iter++);
+      port->destinations_valid = false;
+      continue;
+    }
+    if (iter->second < oldest) {
+      oldest = iter->second;
+    }
+    ++iter;
+  }
+
+  if (!port->subscribed_nodes.empty()) {
+    ScheduleNodeExpiry(port, oldest, now);
+  }
+}
+
 void ArtNetNodeImpl::TimeoutRDMRequest(InputPort *port) {
   OLA_INFO << "RDM Request timed out.";
   port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
@@ -1490,9 +1783,11 @@ bool ArtNetNodeImpl::SendRDMCommand(const RDMCommand &command,
 }
 
 void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
-                                          const DMXSource &source) {
-  TimeStamp merge_time_threshold = (
-      *m_ss->WakeUpTime() - TimeInterval(MERGE_TIMEOUT, 0));
+                                          const IPV4Address &address,
+                                          const uint8_t *data,
+                                          unsigned int length) {
+  const TimeStamp &now = *m_ss->WakeUpTime();
+  TimeStamp merge_time_threshold = now - TimeInterval(MERGE_TIMEOUT, 0);
   // the index of the first empty slot, of MAX_MERGE_SOURCES if we're already
   // tracking MAX_MERGE_SOURCES sources.
   unsigned int first_empty_slot = MAX_MERGE_SOURCES;
@@ -1504,7 +1799,7 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
   // empty source location in case this source is new, and timeout any sources
   // we haven't heard from.
   for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
-    if (port->sources[i].address == source.address) {
+    if (port->sources[i].address == address) {
       source_slot = i;
       continue;
     }
@@ -1541,27 +1836,87 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
     port->is_merging = false;
   }
 
-  port->sources[source_slot] = source;
+  // The data is copied straight into the source's slot.
+  DMXSource *source = &port->sources[source_slot];
+  source->address = address;
+  source->timestamp = now;
+  source->buffer.Set(data, length);
+  if (port->arrival) {
+    *port->arrival = m_packet_arrival;
+  }
+
+  // Ports that are merging ignore ArtSync, as per the spec.
+  bool hold = m_sync_mode && !port->is_merging;
+  DmxBuffer *output = hold ? &port->sync_buffer : port->buffer;
 
   // Now we need to merge
   if (port->merge_mode == ARTNET_MERGE_LTP) {
     // the current source is the latest
-    (*port->buffer) = source.buffer;
+    output->Set(data, length);
   } else {
     // HTP merge
-    bool first = true;
+    const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+    unsigned int buffer_count = 0;
     for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
       if (!port->sources[i].address.IsWildcard()) {
-        if (first) {
-          (*port->buffer) = port->sources[i].buffer;
-          first = false;
-        } else {
-          port->buffer->HTPMerge(port->sources[i].buffer);
-        }
+        buffers[buffer_count++] = &port->sources[i].buffer;
       }
     }
+    output->HTPMergeMany(buffers, buffer_count);
+  }
+
+  port->sync_pending = hold;
+  if (!hold) {
+    port->on_data->Run();
   }
-  port->on_data->Run();
+}
+
+void ArtNetNodeImpl::UpdateOutputPortTable() {
+  memset(m_output_port_table, NO_PORT, sizeof(m_output_port_table));
+  // Walk the ports backwards so each chain is in port order.
+  for (int port_id = static_cast<int>(m_output_ports.size()) - 1;
+       port_id >= 0; port_id--) {
+    OutputPort *port = m_output_ports[port_id];
+    port->next_port = NO_PORT;
+    if (port->enabled) {
+      port->next_port = m_output_port_table[port->universe_address];
+      m_output_port_table[port->universe_address] =
+          static_cast<uint8_t>(port_id);
+    }
+  }
+}
+
+void ArtNetNodeImpl::UpdateInputPortTable() {
+  memset(m_input_port_table, NO_PORT, sizeof(m_input_port_table));
+  // Walk the ports backwards so each chain is in port order.
+  for (int port_id = static_cast<int>(m_input_ports.size()) - 1;
+       port_id >= 0; port_id--) {
+    InputPort *port = m_input_ports[port_id];
+    port->next_port = NO_PORT;
+    if (port->enabled) {
+      port->next_port = m_input_port_table[port->PortAddress()];
+      m_input_port_table[port->PortAddress()] = static_cast<uint8_t>(port_id);
+    }
+  }
+}
+
+void ArtNetNodeImpl::ReleaseSyncedPorts() {
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
+    OutputPort *port = m_output_ports[i];
+    if (!port->sync_pending) {
+      continue;
+    }
+    port->sync_pending = false;
+    if (port->on_data && port->buffer) {
+      port->buffer->Set(port->sync_buffer);
+      port->on_data->Run();
+    }
+  }
+}
+
+void ArtNetNodeImpl::ScheduledSendSync() {
+  m_send_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  SendSync();
 }
 
 bool ArtNetNodeImpl::CheckPacketVersion(const IPV4Address &source_address,
@@ -1580,9 +1935,9 @@ bool ArtNetNodeImpl::CheckPacketSize(const IPV4Address &source_address,
                                      unsigned int actual_size,
                                      unsigned int expected_size) {
   if (actual_size < expected_size) {
-    OLA_INFO << packet_type << " from " << source_address
-             << " was too small, got " << actual_size
-             << " required at least " << expected_size;
+    OLA_INFO_LIMITED << packet_type << " from " << source_address
+                     << " was too small, got " << actual_size
+                     << " required at least " << expected_size;
     return false;
   }
   return true;
@@ -1626,22 +1981,22 @@ ArtNetNodeImpl::InputPort *ArtNetNodeImpl::GetEnabledInputPort(
 }
 
 ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
-  return &m_output_ports[port_id];
+  return m_output_ports[port_id];
 }
 
 const ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(
     uint8_t port_id) const {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
-  return &m_output_ports[port_id];
+  return m_output_ports[port_id];
 }
 
 ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetEnabledOutputPort(
@@ -1675,7 +2030,18 @@ bool ArtNetNodeImpl::InitNetwork() {
     return false;
   }
 
+  // These are tuning, not fatal if they fail.
+  if (m_receive_buffer_size) {
+    m_socket->SetReceiveBufferSize(m_receive_buffer_size);
+  }
+  if (m_send_buffer_size) {
+    m_socket->SetSendBufferSize(m_send_buffer_size);
+  }
+  m_socket->EnableDropCounting();
+  m_socket->EnableReceiveTimestamps();
+
   m_socket->SetOnData(NewCallback(this, &ArtNetNodeImpl::SocketReady));
+  m_socket->SetReadLabel("artnet");
   m_ss->AddReadDescriptor(m_socket.get());
   return true;
 }
@@ -1689,37 +2055,30 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
                                     (unsigned int) packet.uid_count);
 
   OLA_DEBUG << "Got TOD data packet with " << uid_count << " UIDs";
-  uid_map &port_uids = port->uids;
-  UIDSet uid_set;
+  NodeTod &node_tod = port->node_tods[source_address];
+  node_tod.missed = 0;
+  if (packet.block_count == 0) {
+    node_tod.pending.Clear();
+  }
 
+  bool changed = false;
   for (unsigned int i = 0; i < uid_count; i++) {
     UID uid(packet.tod[i]);
-    uid_set.AddUID(uid);
-    uid_map::iterator iter = port_uids.find(uid);
-    if (iter == port_uids.end()) {
-      port_uids[uid] = std::pair<IPV4Address, uint8_t>(source_address, 0);
-    } else {
-      if (iter->second.first != source_address) {
-        OLA_WARN << "UID " << uid << " changed from "
-                 << iter->second.first << " to " << source_address;
-        iter->second.first = source_address;
-      }
-      iter->second.second = 0;
-    }
+    node_tod.pending.AddUID(uid);
+    changed |= port->AddNodeUID(source_address, uid);
   }
 
-  // If this is the one and only block from this node, we can remove all uids
-  // that don't appear in it.
+  // Once we have every block of this node's TOD, we can remove the uids
+  // that don't appear in it. If a block is dropped the TOD is incomplete
+  // until the node sends it again, RDM_MISSED_TODDATA_LIMIT covers nodes
+  // that stop responding altogether.
   // There is a bug in ArtNet nodes where sometimes UidCount > UidTotal.
-  if (uid_count >= NetworkToHost(packet.uid_total)) {
-    uid_map::iterator iter = port_uids.begin();
-    while (iter != port_uids.end()) {
-      if (iter->second.first == source_address &&
-          !uid_set.Contains(iter->first)) {
-        port_uids.erase(iter++);
-      } else {
-        ++iter;
-      }
+  if (node_tod.pending.Size() >= NetworkToHost(packet.uid_total)) {
+    const UIDSet removed = node_tod.uids.SetDifference(node_tod.pending);
+    node_tod.pending.Clear();
+    UIDSet::Iterator iter = removed.Begin();
+    for (; iter != removed.End(); ++iter) {
+      changed |= port->RemoveNodeUID(source_address, *iter);
     }
 
     // mark this node as complete
@@ -1734,14 +2093,9 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
     }
   }
 
-  // Removing uids from multi-block messages is much harder as you need to
-  // consider dropped packets. For the moment we rely on the
-  // RDM_MISSED_TODDATA_LIMIT to clean these up.
-  // TODO(simon): figure this out sometime
-
   // if we're not in the middle of a discovery process, send an unsolicited
-  // update if we have a callback
-  if (!port->discovery_callback)
+  // update if the TOD changed and we have a callback
+  if (!port->discovery_callback && changed)
     port->RunTodCallback();
 }
 
@@ -1755,7 +2109,7 @@ bool ArtNetNodeImpl::StartDiscoveryProcess(InputPort *port,
   }
 
   port->discovery_callback = callback;
-  port->IncrementUIDCounts();
+  port->IncrementNodeCounts();
 
   // populate the discovery set with the nodes we know about, this allows us to
   // 'finish' the discovery process when we receive ArtTod packets from all
@@ -1779,15 +2133,18 @@ void ArtNetNodeImpl::ReleaseDiscoveryLock(InputPort *port) {
   port->discovery_timeout = ola::thread::INVALID_TIMEOUT;
   port->discovery_node_set.clear();
 
-  // delete all uids that have reached the max count
-  uid_map::iterator iter = port->uids.begin();
-  while (iter != port->uids.end()) {
-    if (iter->second.second == RDM_MISSED_TODDATA_LIMIT) {
-      port->uids.erase(iter++);
-    } else {
-      ++iter;
+  // delete the uids of all the nodes that have reached the max count
+  vector<IPV4Address> missing_nodes;
+  NodeTods::const_iterator iter = port->node_tods.begin();
+  for (; iter != port->node_tods.end(); ++iter) {
+    if (iter->second.missed >= RDM_MISSED_TODDATA_LIMIT) {
+      missing_nodes.push_back(iter->first);
     }
   }
+  vector<IPV4Address>::const_iterator node_iter = missing_nodes.begin();
+  for (; node_iter != missing_nodes.end(); ++node_iter) {
+    port->RemoveNode(*node_iter);
+  }
 
   port->RunDiscoveryCallback();
 }
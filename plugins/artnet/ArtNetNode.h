@@ -30,15 +30,19 @@
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPTransmitBatcher.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMFrame.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "ola/timecode/TimeCode.h"
 #include "plugins/artnet/ArtNetPackets.h"
 
@@ -69,7 +73,14 @@ class ArtNetNodeOptions {
         use_limited_broadcast_address(false),
         rdm_queue_size(20),
         broadcast_threshold(30),
-        input_port_count(4) {
+        input_port_count(ARTNET_MAX_PORTS),
+        output_port_count(ARTNET_MAX_PORTS),
+        batch_transmit(false),
+        transmit_pacing_ms(0),
+        send_sync(false),
+        receive_buffer_size(0),
+        send_buffer_size(0),
+        export_map(NULL) {
   }
 
   bool always_broadcast;
@@ -77,6 +88,44 @@ class ArtNetNodeOptions {
   unsigned int rdm_queue_size;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
+  /**
+   * @brief The number of output ports (those which receive ArtNet data).
+   *
+   * If there are more than ARTNET_MAX_PORTS input or output ports, the
+   * ArtPollReply is sent as multiple pages, each with its own bind index.
+   */
+  uint8_t output_port_count;
+  /**
+   * @brief Collect the packets sent in each loop iteration and send them
+   * together with a UDPTransmitBatcher.
+   */
+  bool batch_transmit;
+  /**
+   * @brief Spread the batched packets over this many milliseconds, see
+   * UDPTransmitBatcher::SetPacing(). 0 sends each batch at once. This only
+   * applies if batch_transmit is set.
+   */
+  unsigned int transmit_pacing_ms;
+  /**
+   * @brief Send an ArtSync after the ArtDmx packets sent in each loop
+   * iteration.
+   */
+  bool send_sync;
+  /**
+   * @brief The size of the socket's kernel receive buffer, 0 leaves the
+   * system default.
+   */
+  unsigned int receive_buffer_size;
+  /**
+   * @brief The size of the socket's kernel send buffer, 0 leaves the system
+   * default.
+   */
+  unsigned int send_buffer_size;
+  /**
+   * @brief The ExportMap used for the transmit batch stats and the kernel
+   * drop count, may be NULL.
+   */
+  ola::ExportMap *export_map;
 };
 
 
@@ -162,9 +211,7 @@ class ArtNetNodeImpl {
    * @param subnet_address the ArtNet 'subnet' address, 4 bits.
    */
   bool SetSubnetAddress(uint8_t subnet_address);
-  uint8_t SubnetAddress() const {
-    return m_output_ports[0].universe_address >> 4;
-  }
+  uint8_t SubnetAddress() const { return m_subnet_address; }
 
   /**
    * Get the number of input ports
@@ -172,6 +219,12 @@ class ArtNetNodeImpl {
    */
   uint8_t InputPortCount() const;
 
+  /**
+   * Get the number of output ports
+   * @returns the number of output ports
+   */
+  uint8_t OutputPortCount() const;
+
   /**
    * Set the universe address of an input port
    */
@@ -182,20 +235,20 @@ class ArtNetNodeImpl {
    *
    * Return the 8bit universe address for a port. This does not include the
    * ArtNet III net-address.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and InputPortCount() - 1
    * @return The universe address for the port. Invalid port_ids return 0.
    */
   uint8_t GetInputPortUniverse(uint8_t port_id) const;
 
   /**
    * @brief Disable an input port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and InputPortCount() - 1
    */
   void DisableInputPort(uint8_t port_id);
 
   /**
    * @brief Check the state of an input port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and InputPortCount() - 1
    * @return the state (enabled or disabled) of an input port. An invalid
    * port_id returns false.
    */
@@ -203,27 +256,27 @@ class ArtNetNodeImpl {
 
   /**
    * @brief Set the universe for an output port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and OutputPortCount() - 1
    * @param universe_id the new universe id.
    */
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id);
 
   /**
    * Return the current universe address for an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and OutputPortCount() - 1
    * @return the universe address for the port
    */
   uint8_t GetOutputPortUniverse(uint8_t port_id);
 
   /**
    * @brief Disable an output port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and OutputPortCount() - 1
    */
   void DisableOutputPort(uint8_t port_id);
 
   /**
    * @brief Check the state of an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and OutputPortCount() - 1
    * @return the state (enabled or disabled) of an output port. An invalid
    * port_id returns false.
    */
@@ -235,7 +288,7 @@ class ArtNetNodeImpl {
 
   /**
    * @brief Set the merge mode for an output port
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
+   * @param port_id a port id between 0 and OutputPortCount() - 1
    * @param merge_mode the artnet_merge_mode
    */
   bool SetMergeMode(uint8_t port_id, artnet_merge_mode merge_mode);
@@ -256,6 +309,15 @@ class ArtNetNodeImpl {
    */
   bool SendDMX(uint8_t port_id, const ola::DmxBuffer &buffer);
 
+  /**
+   * @brief Send an ArtSync.
+   *
+   * This tells the receiving nodes to output the ArtDmx data they've been
+   * holding. If send_sync is set in the ArtNetNodeOptions this is sent
+   * automatically after each batch of SendDMX() calls.
+   */
+  bool SendSync();
+
   /**
    * @brief Flush the TOD and force a full discovery.
    *
@@ -324,10 +386,13 @@ class ArtNetNodeImpl {
    * @param buffer a pointer to the DmxBuffer
    * @param handler the Callback0 to call when there is data for this universe.
    * Ownership of the closure is transferred to the node.
+   * @param arrival if not NULL, this is set to the time the kernel received
+   *   the packet the data came from. It's unset if the time isn't known.
    */
   bool SetDMXHandler(uint8_t port_id,
                      DmxBuffer *buffer,
-                     ola::Callback0<void> *handler);
+                     ola::Callback0<void> *handler,
+                     TimeStamp *arrival = NULL);
 
   /**
    * @brief Send an set of UIDs in one of more ArtTod packets
@@ -355,11 +420,8 @@ class ArtNetNodeImpl {
  private:
   class InputPort;
   typedef std::vector<InputPort*> InputPorts;
-
-  // map a uid to a IP address and the number of times we've missed a
-  // response.
-  typedef std::map<ola::rdm::UID,
-                   std::pair<ola::network::IPV4Address, uint8_t> > uid_map;
+  struct OutputPort;
+  typedef std::vector<OutputPort*> OutputPorts;
 
   enum { MAX_MERGE_SOURCES = 2 };
 
@@ -378,6 +440,7 @@ class ArtNetNodeImpl {
     bool is_merging;
     DMXSource sources[MAX_MERGE_SOURCES];
     DmxBuffer *buffer;
+    TimeStamp *arrival;
     std::map<ola::rdm::UID, ola::network::IPV4Address> uid_map;
     Callback0<void> *on_data;
     Callback0<void> *on_discover;
@@ -385,10 +448,19 @@ class ArtNetNodeImpl {
     ola::Callback2<void,
                    ola::rdm::RDMRequest*,
                    ola::rdm::RDMCallback*> *on_rdm_request;
+    // The next enabled port with the same universe address, or NO_PORT.
+    uint8_t next_port;
+    // In synchronous mode the data is held here until the next ArtSync.
+    DmxBuffer sync_buffer;
+    bool sync_pending;
   };
 
+  enum { NO_PORT = 0xff };
+  enum { UNIVERSE_ADDRESS_COUNT = 256 };
+
   bool m_running;
   uint8_t m_net_address;  // this is the 'net' portion of the Artnet address
+  uint8_t m_subnet_address;
   bool m_send_reply_on_change;
   std::string m_short_name;
   std::string m_long_name;
@@ -404,9 +476,30 @@ class ArtNetNodeImpl {
   bool m_artpollreply_required;
 
   InputPorts m_input_ports;
-  OutputPort m_output_ports[ARTNET_MAX_PORTS];
+  OutputPorts m_output_ports;
+  // The first enabled output port for each universe address, or NO_PORT. The
+  // ports that share a universe address are chained with next_port.
+  uint8_t m_output_port_table[UNIVERSE_ADDRESS_COUNT];
+  // The same for the enabled input ports, so an ArtPollReply or ArtTodData
+  // only touches the ports it's for.
+  uint8_t m_input_port_table[UNIVERSE_ADDRESS_COUNT];
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  ola::network::UDPReceiveRing m_recv_ring;
+  // The kernel's arrival time for the packet being handled.
+  TimeStamp m_packet_arrival;
+  const bool m_batch_transmit;
+  const unsigned int m_transmit_pacing_ms;
+  const unsigned int m_receive_buffer_size;
+  const unsigned int m_send_buffer_size;
+  ola::ExportMap *m_export_map;
+  std::auto_ptr<ola::network::UDPTransmitBatcher> m_tx_batcher;
+  const bool m_send_sync;
+  ola::thread::timeout_id m_send_sync_timeout;
+  // true once we've received an ArtSync, until SYNC_TIMEOUT passes without
+  // one.
+  bool m_sync_mode;
+  TimeStamp m_last_sync;
 
   /**
    * @brief Called when there is data on this socket
@@ -434,6 +527,16 @@ class ArtNetNodeImpl {
    */
   bool SendPollReply(const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Send one page of the ArtPollReply.
+   * @param destination where to send the reply to
+   * @param page the page number, each page describes ARTNET_MAX_PORTS ports.
+   * @param page_count the total number of pages.
+   */
+  bool SendPollReplyPage(const ola::network::IPV4Address &destination,
+                         unsigned int page,
+                         unsigned int page_count);
+
   /**
    * @brief Send an IPProgReply
    */
@@ -467,6 +570,13 @@ class ArtNetNodeImpl {
                         const artnet_dmx_t &packet,
                         unsigned int packet_size);
 
+  /**
+   * @brief Handle an ArtSync packet, this releases the held DMX data.
+   */
+  void HandleSyncPacket(const ola::network::IPV4Address &source_address,
+                        const artnet_sync_t &packet,
+                        unsigned int packet_size);
+
   /**
    * @brief Handle a TOD Request packet
    */
@@ -538,6 +648,36 @@ class ArtNetNodeImpl {
                   unsigned int size,
                   const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Send an ArtNet packet
+   * @param packet the packet to send
+   * @param size the size of the packet, excluding the header portion
+   * @param destination the address and port to send the packet to
+   */
+  bool SendPacket(const artnet_packet &packet,
+                  unsigned int size,
+                  const ola::network::IPV4SocketAddress &destination);
+
+  /**
+   * @brief Rebuild the unicast destinations for an input port if required.
+   */
+  void UpdatePortDestinations(InputPort *port);
+
+  /**
+   * @brief Schedule the node expiry timer for an input port, if it isn't
+   *   already running.
+   */
+  void ScheduleNodeExpiry(InputPort *port, const TimeStamp &oldest,
+                          const TimeStamp &now);
+
+  /**
+   * @brief Remove the nodes that have timed out from an input port.
+   *
+   * This is run by the node expiry timer, and schedules the timer again for
+   * the next node that could time out.
+   */
+  void ExpireNodes(InputPort *port);
+
   /**
    * @brief Timeout a pending RDM request
    * @param port the id of the port to timeout.
@@ -554,7 +694,36 @@ class ArtNetNodeImpl {
   /**
    * @brief Update a port from a source, merging if necessary
    */
-  void UpdatePortFromSource(OutputPort *port, const DMXSource &source);
+  void UpdatePortFromSource(OutputPort *port,
+                            const ola::network::IPV4Address &address,
+                            const uint8_t *data,
+                            unsigned int length);
+
+  /**
+   * @brief Rebuild the universe address to output port table.
+   *
+   * This must be called whenever the universe address or state of an output
+   * port changes.
+   */
+  void UpdateOutputPortTable();
+
+  /**
+   * @brief Rebuild the port address to input port table.
+   *
+   * This must be called whenever the port address or state of an input port
+   * changes.
+   */
+  void UpdateInputPortTable();
+
+  /**
+   * @brief Pass the data held for synchronous mode to the output ports.
+   */
+  void ReleaseSyncedPorts();
+
+  /**
+   * @brief Called at the end of the loop iteration to send the ArtSync.
+   */
+  void ScheduledSendSync();
 
   /**
    * @brief Check the version number of a incoming packet
@@ -640,11 +809,15 @@ class ArtNetNodeImpl {
   static const uint8_t RDM_VERSION = 0x01;  // v1.0 standard baby!
   static const uint8_t TOD_FLUSH_COMMAND = 0x01;
   static const unsigned int MERGE_TIMEOUT = 10;  // As per the spec
+  // seconds without an ArtSync before we revert to non-synchronous mode
+  static const unsigned int SYNC_TIMEOUT = 4;
   // seconds after which a node is marked as inactive for the dmx merging
   static const unsigned int NODE_TIMEOUT = 31;
+  // seconds, nodes that would time out within this are removed together
+  static const unsigned int NODE_EXPIRY_GRANULARITY = 1;
   // mseconds we wait for a TodData packet before declaring a node missing
   static const unsigned int RDM_TOD_TIMEOUT_MS = 4000;
-  // Number of missed TODs before we decide a UID has gone
+  // Number of missed TODs before we decide a node's UIDs have gone
   static const unsigned int RDM_MISSED_TODDATA_LIMIT = 3;
   // The maximum number of requests we'll allow in the queue. This is a per
   // port (universe) limit.
@@ -737,6 +910,9 @@ class ArtNetNode {
   uint8_t InputPortCount() const {
     return m_impl.InputPortCount();
   }
+  uint8_t OutputPortCount() const {
+    return m_impl.OutputPortCount();
+  }
 
   bool SetInputPortUniverse(uint8_t port_id, uint8_t universe_id) {
     return m_impl.SetInputPortUniverse(port_id, universe_id);
@@ -782,6 +958,10 @@ class ArtNetNode {
     return m_impl.SendDMX(port_id, buffer);
   }
 
+  bool SendSync() {
+    return m_impl.SendSync();
+  }
+
   /**
    * @brief Trigger full discovery for a port
    */
@@ -819,8 +999,9 @@ class ArtNetNode {
   // The following apply to Output Ports (those which receive data);
   bool SetDMXHandler(uint8_t port_id,
                      DmxBuffer *buffer,
-                     ola::Callback0<void> *handler) {
-    return m_impl.SetDMXHandler(port_id, buffer, handler);
+                     ola::Callback0<void> *handler,
+                     TimeStamp *arrival = NULL) {
+    return m_impl.SetDMXHandler(port_id, buffer, handler, arrival);
   }
   bool SendTod(uint8_t port_id, const ola::rdm::UIDSet &uid_set) {
     return m_impl.SendTod(port_id, uid_set);
@@ -47,6 +47,7 @@
 
 
 using ola::DmxBuffer;
+using ola::TimeStamp;
 using ola::network::IPV4Address;
 using ola::network::Interface;
 using ola::network::MACAddress;
@@ -72,13 +73,18 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ArtNetNodeTest);
   CPPUNIT_TEST(testBasicBehaviour);
   CPPUNIT_TEST(testConfigurationMode);
+  CPPUNIT_TEST(testPollReplyPages);
   CPPUNIT_TEST(testExtendedInputPorts);
   CPPUNIT_TEST(testBroadcastSendDMX);
   CPPUNIT_TEST(testBroadcastSendDMXZeroUniverse);
+  CPPUNIT_TEST(testBatchedSendDMX);
+  CPPUNIT_TEST(testSendSync);
   CPPUNIT_TEST(testLimitedBroadcastDMX);
   CPPUNIT_TEST(testNonBroadcastSendDMX);
   CPPUNIT_TEST(testReceiveDMX);
   CPPUNIT_TEST(testReceiveDMXZeroUniverse);
+  CPPUNIT_TEST(testReceiveDMXSharedUniverse);
+  CPPUNIT_TEST(testReceiveSync);
   CPPUNIT_TEST(testHTPMerge);
   CPPUNIT_TEST(testLTPMerge);
   CPPUNIT_TEST(testControllerDiscovery);
@@ -113,13 +119,18 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
 
   void testBasicBehaviour();
   void testConfigurationMode();
+  void testPollReplyPages();
   void testExtendedInputPorts();
   void testBroadcastSendDMX();
   void testBroadcastSendDMXZeroUniverse();
+  void testBatchedSendDMX();
+  void testSendSync();
   void testLimitedBroadcastDMX();
   void testNonBroadcastSendDMX();
   void testReceiveDMX();
   void testReceiveDMXZeroUniverse();
+  void testReceiveDMXSharedUniverse();
+  void testReceiveSync();
   void testHTPMerge();
   void testLTPMerge();
   void testControllerDiscovery();
@@ -417,6 +428,98 @@ void ArtNetNodeTest::testBasicBehaviour() {
 }
 
 
+/**
+ * Check that nodes with more than four ports send multiple ArtPollReplies.
+ */
+void ArtNetNodeTest::testPollReplyPages() {
+  ArtNetNodeOptions node_options;
+  node_options.input_port_count = 2;
+  node_options.output_port_count = 6;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  OLA_ASSERT_EQ((uint8_t) 2, node.InputPortCount());
+  OLA_ASSERT_EQ((uint8_t) 6, node.OutputPortCount());
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+
+  uint8_t page1[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x21,
+    10, 0, 0, 1,
+    0x36, 0x19,
+    0, 0,
+    0, 0,  // subnet address
+    0x4, 0x31,  // oem
+    0,
+    0xd2,
+    0x70, 0x7a,  // esta
+    'S', 'h', 'o', 'r', 't', ' ', 'N', 'a', 'm', 'e',
+    0, 0, 0, 0, 0, 0, 0, 0,  // short name
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // long name
+    '#', '0', '0', '0', '1', ' ', '[', '1', ']', ' ', 'O', 'L', 'A',
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0,  // node report
+    0, 4,  // num ports
+    0xc0, 0xc0, 0x80, 0x80,  // port types
+    8, 8, 8, 8,  // good input
+    0, 0, 0, 0,  // good output
+    0x0, 0x0, 0x0, 0x0,  // swin
+    0x0, 0x0, 0x0, 0x0,  // swout
+    0, 0, 0, 0, 0, 0, 0,  // video, macro, remote, spare, style
+    0xa, 0xb, 0xc, 0x12, 0x34, 0x56,  // mac address
+    0xa, 0x0, 0x0, 0x1,
+    1,  // bind index
+    8,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0  // filler
+  };
+
+  uint8_t page2[sizeof(page1)];
+  memcpy(page2, page1, sizeof(page1));
+  page2[173] = 2;  // num ports
+  page2[174] = 0x80;  // port types
+  page2[175] = 0x80;
+  page2[176] = 0;
+  page2[177] = 0;
+  page2[180] = 0;  // good input
+  page2[181] = 0;
+  page2[183] = 0x80;  // good output
+  page2[191] = 0x7;  // swout
+  page2[211] = 2;  // bind index
+
+  node.EnterConfigurationMode();
+  node.SetShortName("Short Name");
+  OLA_ASSERT(node.SetOutputPortUniverse(5, 7));
+  OLA_ASSERT_FALSE(node.SetOutputPortUniverse(6, 7));
+  ExpectedBroadcast(page1, sizeof(page1));
+  ExpectedBroadcast(page2, sizeof(page2));
+  node.ExitConfigurationMode();
+  m_socket->Verify();
+
+  // Data for a port on the second page.
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(5, &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+  const uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x07, 0,  // subnet & net address
+    0, 4,  // dmx length
+    1, 2, 3, 4
+  };
+  ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+  OLA_ASSERT(m_got_dmx);
+  OLA_ASSERT_EQ(string("1,2,3,4"), input_buffer.ToString());
+  m_socket->Verify();
+}
+
 /**
  * Check that configuration mode works correctly.
  */
@@ -800,6 +903,135 @@ void ArtNetNodeTest::testBroadcastSendDMXZeroUniverse() {
   }
 }
 
+/*
+ * Check that DMX frames are held until the end of the loop iteration when
+ * batch_transmit is set.
+ */
+void ArtNetNodeTest::testBatchedSendDMX() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.batch_transmit = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  const uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  const uint8_t DMX_MESSAGE2[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    1,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    5, 4, 3, 2, 1, 0
+  };
+
+  {
+    // Nothing is sent until the loop runs.
+    SocketVerifier verifer(m_socket);
+    DmxBuffer dmx;
+    dmx.SetFromString("0,1,2,3,4,5");
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+    dmx.SetFromString("5,4,3,2,1,0");
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    ExpectedBroadcast(DMX_MESSAGE2, sizeof(DMX_MESSAGE2));
+    ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+}
+
+
+/*
+ * Check an ArtSync is sent after the DMX data.
+ */
+void ArtNetNodeTest::testSendSync() {
+  m_socket->SetDiscardMode(true);
+
+  ArtNetNodeOptions node_options;
+  node_options.always_broadcast = true;
+  node_options.send_sync = true;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupInputPort(&node);
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  const uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  const uint8_t DMX_MESSAGE2[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    1,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    5, 4, 3, 2, 1, 0
+  };
+  const uint8_t SYNC_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x52,
+    0x0, 14,
+    0, 0  // aux
+  };
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(DMX_MESSAGE, sizeof(DMX_MESSAGE));
+    ExpectedBroadcast(DMX_MESSAGE2, sizeof(DMX_MESSAGE2));
+    DmxBuffer dmx;
+    dmx.SetFromString("0,1,2,3,4,5");
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+    dmx.SetFromString("5,4,3,2,1,0");
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
+
+  {
+    // One ArtSync for both frames.
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    OLA_ASSERT(node.SendSync());
+  }
+}
+
 /*
  * Check sending DMX using the limited broadcast address.
  */
@@ -1017,6 +1249,19 @@ void ArtNetNodeTest::testNonBroadcastSendDMX() {
     ExpectedBroadcast(DMX_MESSAGE3, sizeof(DMX_MESSAGE3));
     OLA_ASSERT(node.SendDMX(m_port_id, dmx));
   }
+
+  // once the nodes time out, nothing is sent
+  {
+    SocketVerifier verifer(m_socket);
+    node.SetBroadcastThreshold(30);
+    m_clock.AdvanceTime(32, 0);
+    ss.RunOnce();  // update the wake up time
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+
+    node_addresses.clear();
+    node.GetSubscribedNodes(m_port_id, &node_addresses);
+    OLA_ASSERT_EQ(static_cast<size_t>(0), node_addresses.size());
+  }
 }
 
 /**
@@ -1028,14 +1273,17 @@ void ArtNetNodeTest::testReceiveDMX() {
   ArtNetNode node(iface, &ss, node_options, m_socket);
   SetupOutputPort(&node);
   DmxBuffer input_buffer;
+  TimeStamp arrival;
   node.SetDMXHandler(m_port_id,
                      &input_buffer,
-                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx),
+                     &arrival);
 
   OLA_ASSERT(node.Start());
   ss.RemoveReadDescriptor(m_socket);
   m_socket->Verify();
   m_socket->SetDiscardMode(false);
+  OLA_ASSERT_TRUE(m_socket->ReceiveTimestampsEnabled());
 
   uint8_t DMX_MESSAGE[] = {
     'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
@@ -1048,13 +1296,18 @@ void ArtNetNodeTest::testReceiveDMX() {
     0, 1, 2, 3, 4, 5
   };
 
-  // 'receive' a DMX message
+  // 'receive' a DMX message, the kernel's arrival time is passed on
   {
     SocketVerifier verifer(m_socket);
     OLA_ASSERT_FALSE(m_got_dmx);
+    TimeStamp kernel_time;
+    m_clock.CurrentTime(&kernel_time);
+    m_socket->SetArrivalTime(kernel_time);
     ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
     OLA_ASSERT(m_got_dmx);
     OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+    OLA_ASSERT_EQ(kernel_time, arrival);
+    m_socket->SetArrivalTime(TimeStamp());
   }
 
   // send a second frame
@@ -1166,6 +1419,160 @@ void ArtNetNodeTest::testReceiveDMXZeroUniverse() {
   }
 }
 
+/**
+ * Check that DMX is delivered to every output port patched to a universe.
+ */
+void ArtNetNodeTest::testReceiveDMXSharedUniverse() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetOutputPortUniverse(0, 3);
+  node.SetOutputPortUniverse(1, 5);
+  node.SetOutputPortUniverse(2, 3);
+
+  DmxBuffer buffers[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    node.SetDMXHandler(i, &buffers[i],
+                       ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+  }
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), buffers[0].ToString());
+    OLA_ASSERT_EQ(0u, buffers[1].Size());
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), buffers[2].ToString());
+  }
+
+  // Disable the first port and move the second one onto the universe.
+  m_socket->SetDiscardMode(true);
+  node.EnterConfigurationMode();
+  node.DisableOutputPort(0);
+  node.SetOutputPortUniverse(1, 3);
+  node.ExitConfigurationMode();
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  {
+    SocketVerifier verifer(m_socket);
+    DMX_MESSAGE[12] = 1;
+    DMX_MESSAGE[18] = 9;
+    m_got_dmx = false;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), buffers[0].ToString());
+    OLA_ASSERT_EQ(string("9,1,2,3,4,5"), buffers[1].ToString());
+    OLA_ASSERT_EQ(string("9,1,2,3,4,5"), buffers[2].ToString());
+  }
+
+  // A universe with no ports is ignored.
+  {
+    SocketVerifier verifer(m_socket);
+    DMX_MESSAGE[12] = 2;
+    DMX_MESSAGE[14] = 0x25;
+    DMX_MESSAGE[18] = 7;
+    m_got_dmx = false;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    OLA_ASSERT_EQ(string("9,1,2,3,4,5"), buffers[1].ToString());
+  }
+}
+
+/**
+ * Check that ArtSync holds the DMX data until the next ArtSync.
+ */
+void ArtNetNodeTest::testReceiveSync() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupOutputPort(&node);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(m_port_id,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+  const uint8_t SYNC_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x52,
+    0x0, 14,
+    0, 0  // aux
+  };
+
+  SocketVerifier verifer(m_socket);
+  // Until an ArtSync arrives the data is passed on straight away.
+  ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+  OLA_ASSERT(m_got_dmx);
+  OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+
+  m_got_dmx = false;
+  ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+  OLA_ASSERT_FALSE(m_got_dmx);
+
+  // Now the frame is held until the next ArtSync.
+  DMX_MESSAGE[12] = 1;
+  DMX_MESSAGE[18] = 9;
+  ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+  OLA_ASSERT_FALSE(m_got_dmx);
+  OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+
+  ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+  OLA_ASSERT(m_got_dmx);
+  OLA_ASSERT_EQ(string("9,1,2,3,4,5"), input_buffer.ToString());
+
+  // A second ArtSync with no new data doesn't run the handler.
+  m_got_dmx = false;
+  ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+  OLA_ASSERT_FALSE(m_got_dmx);
+
+  DMX_MESSAGE[12] = 2;
+  DMX_MESSAGE[18] = 8;
+  ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+  OLA_ASSERT_FALSE(m_got_dmx);
+
+  // Without an ArtSync for 4s, we go back to non-synchronous mode and the
+  // held data is released.
+  m_clock.AdvanceTime(5, 0);
+  DMX_MESSAGE[12] = 3;
+  DMX_MESSAGE[18] = 7;
+  ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+  OLA_ASSERT(m_got_dmx);
+  OLA_ASSERT_EQ(string("7,1,2,3,4,5"), input_buffer.ToString());
+}
+
 /**
  * Check that merging works
  */
@@ -1823,6 +2230,68 @@ void ArtNetNodeTest::testUnsolicitedTod() {
     UIDSet uids;
     UID uid1(0x7a70, 0);
     uids.AddUID(uid1);
+    OLA_ASSERT_EQ(uids, m_uids);
+
+    // The same TOD again doesn't change anything
+    m_discovery_done = false;
+    ReceiveFromPeer(art_tod, sizeof(art_tod), peer_ip);
+    OLA_ASSERT_FALSE(m_discovery_done);
+  }
+
+  // receive a TOD in two blocks, the old UID is only removed once both have
+  // arrived
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t art_tod1[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x81,
+      0x0, 14,
+      1,  // rdm standard
+      1,  // first port
+      0, 0, 0, 0, 0, 0, 0,
+      4,  // net
+      0,  // full tod
+      0x23,  // universe address
+      0, 2,  // uid total
+      0,  // block count
+      1,  // uid count
+      0x7a, 0x70, 0, 0, 0, 1,
+    };
+    const uint8_t art_tod2[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x81,
+      0x0, 14,
+      1,  // rdm standard
+      1,  // first port
+      0, 0, 0, 0, 0, 0, 0,
+      4,  // net
+      0,  // full tod
+      0x23,  // universe address
+      0, 2,  // uid total
+      1,  // block count
+      1,  // uid count
+      0x7a, 0x70, 0, 0, 0, 2,
+    };
+
+    UID uid1(0x7a70, 0);
+    UID uid2(0x7a70, 1);
+    UID uid3(0x7a70, 2);
+
+    m_discovery_done = false;
+    ReceiveFromPeer(art_tod1, sizeof(art_tod1), peer_ip);
+    OLA_ASSERT(m_discovery_done);
+    UIDSet uids;
+    uids.AddUID(uid1);
+    uids.AddUID(uid2);
+    OLA_ASSERT_EQ(uids, m_uids);
+
+    m_discovery_done = false;
+    ReceiveFromPeer(art_tod2, sizeof(art_tod2), peer_ip);
+    OLA_ASSERT(m_discovery_done);
+    uids.Clear();
+    uids.AddUID(uid2);
+    uids.AddUID(uid3);
+    OLA_ASSERT_EQ(uids, m_uids);
   }
 }
 
@@ -25,6 +25,7 @@
 #include "ola/Logging.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/artnet/ArtNetPlugin.h"
 #include "plugins/artnet/ArtNetPluginDescription.h"
 #include "plugins/artnet/ArtNetDevice.h"
@@ -50,11 +51,9 @@ bool ArtNetPlugin::StartHook() {
     delete m_device;
     return false;
   }
-  // Register device will restore the port settings. To avoid a flurry of
-  // ArtPoll / ArtPollReply messages, we enter config mode here.
-  m_device->EnterConfigurationMode();
+  // RegisterDevice() restores the port settings in configuration mode, so
+  // there's a single ArtPoll / ArtPollReply once they're all set.
   m_plugin_adaptor->RegisterDevice(m_device);
-  m_device->ExitConfigurationMode();
   return true;
 }
 
@@ -99,17 +98,39 @@ bool ArtNetPlugin::SetDefaultPreferences() {
                                          ArtNetDevice::K_ARTNET_SUBNET);
   save |= m_preferences->SetDefaultValue(
       ArtNetDevice::K_OUTPUT_PORT_KEY,
-      UIntValidator(0, 16),
+      UIntValidator(0, ArtNetDevice::K_MAX_PORT_COUNT),
       ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_INPUT_PORT_KEY,
+      UIntValidator(0, ArtNetDevice::K_MAX_PORT_COUNT),
+      ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_ALWAYS_BROADCAST_KEY,
                                          BoolValidator(),
                                          false);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_BATCH_TRANSMIT_KEY,
+                                         BoolValidator(),
+                                         false);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_TRANSMIT_PACING_KEY,
+      UIntValidator(0, ArtNetDevice::K_MAX_TRANSMIT_PACING_MS),
+      0);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_SEND_SYNC_KEY,
+                                         BoolValidator(),
+                                         false);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_LIMITED_BROADCAST_KEY,
                                          BoolValidator(),
                                          false);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_LOOPBACK_KEY,
                                          BoolValidator(),
                                          false);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_RECEIVE_BUFFER_KEY,
+      UIntValidator(0, ArtNetDevice::K_MAX_SOCKET_BUFFER_SIZE),
+      0);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_SEND_BUFFER_KEY,
+      UIntValidator(0, ArtNetDevice::K_MAX_SOCKET_BUFFER_SIZE),
+      0);
 
   if (save) {
     m_preferences->Save();
@@ -121,6 +142,7 @@ bool ArtNetPlugin::SetDefaultPreferences() {
       m_preferences->GetValue(ArtNetDevice::K_LONG_NAME_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_SUBNET_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_OUTPUT_PORT_KEY).empty() ||
+      m_preferences->GetValue(ArtNetDevice::K_INPUT_PORT_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_NET_KEY).empty()) {
     return false;
   }
@@ -130,3 +152,5 @@ bool ArtNetPlugin::SetDefaultPreferences() {
 }  // namespace artnet
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::artnet::ArtNetPlugin)
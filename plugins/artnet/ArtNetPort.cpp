@@ -53,7 +53,8 @@ void ArtNetInputPort::PostSetUniverse(Universe *old_universe,
         PortId(),
         &m_buffer,
         NewCallback(static_cast<ola::BasicInputPort*>(this),
-                    &ArtNetInputPort::DmxChanged));
+                    &ArtNetInputPort::DmxChanged),
+        &m_arrival);
     m_node->SetOutputPortRDMHandlers(
         PortId(),
         NewCallback(
@@ -110,7 +111,7 @@ void ArtNetInputPort::TriggerDiscovery() {
 
 bool ArtNetOutputPort::WriteDMX(const DmxBuffer &buffer,
                                 OLA_UNUSED uint8_t priority) {
-  if (PortId() >= ARTNET_MAX_PORTS) {
+  if (PortId() >= m_node->InputPortCount()) {
     OLA_WARN << "Invalid artnet port id " << PortId();
     return false;
   }
@@ -41,6 +41,7 @@ class ArtNetInputPort: public BasicInputPort {
         m_node(node) {}
 
   const DmxBuffer &ReadDMX() const { return m_buffer; }
+  TimeStamp ArrivalTime() const { return m_arrival; }
 
   /**
    * Set the DMX Handlers as needed
@@ -56,6 +57,7 @@ class ArtNetInputPort: public BasicInputPort {
 
  private:
   DmxBuffer m_buffer;
+  TimeStamp m_arrival;
   ArtNetNode *m_node;
 
   /**
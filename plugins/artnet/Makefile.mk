@@ -37,7 +37,9 @@ plugins_artnet_libolaartnet_la_LIBADD = \
 noinst_PROGRAMS += plugins/artnet/artnet_loadtest
 
 plugins_artnet_artnet_loadtest_SOURCES = plugins/artnet/artnet_loadtest.cpp
-plugins_artnet_artnet_loadtest_LDADD = plugins/artnet/libolaartnetnode.la
+plugins_artnet_artnet_loadtest_LDADD = plugins/artnet/libolaartnetnode.la \
+                                    common/web/libolaweb.la \
+                                    ola/libola.la
 
 # TESTS
 ##################################################
@@ -14,62 +14,455 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  *
  * artnet_loadtest.cpp
- * A simple ArtNet load tester
+ * An ArtNet load tester.
  * Copyright (C) 2013 Simon Newton
+ *
+ * This sends N universes of ArtNet at a fixed rate and receives them again,
+ * either in-process or from olad, and reports the latency, loss and CPU
+ * usage as JSON.
  */
 
+#include <stdint.h>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif  // _WIN32
 #include <algorithm>
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
 #include "ola/base/Init.h"
+#include "ola/client/ClientWrapper.h"
+#include "ola/client/OlaClient.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/InterfacePicker.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonWriter.h"
 #include "plugins/artnet/ArtNetNode.h"
 
 using ola::DmxBuffer;
 using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClientWrapper;
+using ola::client::Result;
 using ola::io::SelectServer;
 using ola::network::Interface;
 using ola::network::InterfacePicker;
 using ola::plugin::artnet::ArtNetNode;
 using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::web::JsonObject;
+using ola::web::JsonUInt64;
+using ola::web::JsonWriter;
 using std::auto_ptr;
 using std::cout;
 using std::endl;
 using std::min;
+using std::string;
+using std::vector;
 
 DEFINE_s_uint32(fps, f, 10, "Frames per second per universe [1 - 1000]");
-DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
+DEFINE_s_uint16(universes, u, 1, "Number of universes to send [1 - 256]");
+DEFINE_s_uint32(duration, d, 10, "The number of seconds to send for.");
 DEFINE_string(iface, "", "The interface to send from");
+DEFINE_default_bool(batch_transmit, false,
+                    "Batch the datagrams with sendmmsg().");
+DEFINE_uint32(transmit_pacing_ms, 0,
+              "With --batch-transmit, spread each batch over this many ms.");
+DEFINE_default_bool(olad, false,
+                    "Receive the frames from olad rather than in-process. "
+                    "olad must patch ArtNet port address N to universe N.");
+DEFINE_uint32(olad_pid, 0,
+              "The pid of olad, if set the CPU usage of olad is reported "
+              "rather than our own.");
+
+namespace {
+
+// Each ArtNet subnet holds 16 universes.
+const unsigned int UNIVERSES_PER_SUBNET = 16;
+const unsigned int MAX_UNIVERSES = 256;
+// How long to wait for the last frames once we stop sending.
+const unsigned int DRAIN_TIME_MS = 500;
+
+/**
+ * Get the CPU time used by a process.
+ * @param pid the process to check, or 0 for this process.
+ * @param[out] cpu_time the user + system time.
+ * @returns true if the time is available.
+ */
+bool ProcessCPUTime(unsigned int pid, TimeInterval *cpu_time) {
+#ifdef _WIN32
+  (void) pid;
+  (void) cpu_time;
+  return false;
+#else
+  if (pid == 0) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+      return false;
+    }
+    *cpu_time = TimeInterval(usage.ru_utime.tv_sec, usage.ru_utime.tv_usec);
+    *cpu_time += TimeInterval(usage.ru_stime.tv_sec, usage.ru_stime.tv_usec);
+    return true;
+  }
+
+  std::ostringstream path;
+  path << "/proc/" << pid << "/stat";
+  std::ifstream stat_file(path.str().c_str());
+  string line;
+  if (!std::getline(stat_file, line)) {
+    return false;
+  }
+
+  // The command name may contain spaces, so skip past it. utime and stime
+  // are the 12th and 13th fields after it.
+  string::size_type end_of_name = line.rfind(')');
+  if (end_of_name == string::npos) {
+    return false;
+  }
+  std::istringstream fields(line.substr(end_of_name + 1));
+  string field;
+  for (unsigned int i = 0; i < 11; i++) {
+    fields >> field;
+  }
+  uint64_t utime = 0, stime = 0;
+  if (!(fields >> utime >> stime)) {
+    return false;
+  }
+  long ticks_per_second = sysconf(_SC_CLK_TCK);  // NOLINT(runtime/int)
+  if (ticks_per_second <= 0) {
+    return false;
+  }
+  *cpu_time = TimeInterval(
+      static_cast<int64_t>((utime + stime) * 1000000 / ticks_per_second));
+  return true;
+#endif  // _WIN32
+}
+}  // namespace
+
+
+/**
+ * Sends the frames and collects the results.
+ *
+ * Each frame carries a sequence number and the time it was sent in the first
+ * 8 slots, so the receiver can work out the loss and latency.
+ */
+class LoadTest {
+ public:
+  LoadTest(SelectServer *ss, const Interface &iface, unsigned int universes,
+           unsigned int fps, unsigned int duration)
+      : m_ss(ss),
+        m_interface(iface),
+        m_universe_count(universes),
+        m_fps(fps),
+        m_duration(duration),
+        m_states(universes),
+        m_reordered(0),
+        m_send_timeout(ola::thread::INVALID_TIMEOUT),
+        m_pending_registrations(0),
+        m_have_cpu_time(false) {
+  }
+
+  ~LoadTest() {
+    ola::STLDeleteElements(&m_nodes);
+  }
+
+  bool Setup(ola::client::OlaClient *client);
+  void WriteReport(std::ostream *output);
+
+ private:
+  struct UniverseState {
+    UniverseState() : sent(0), received(0), last_sequence(0) {}
+
+    DmxBuffer buffer;
+    uint32_t sent;
+    uint32_t received;
+    uint32_t last_sequence;
+  };
+
+  SelectServer *m_ss;
+  const Interface m_interface;
+  const unsigned int m_universe_count;
+  const unsigned int m_fps;
+  const unsigned int m_duration;
+  ola::MonotonicClock m_clock;
+  vector<ArtNetNode*> m_nodes;
+  vector<UniverseState> m_states;
+  vector<uint32_t> m_latencies;
+  unsigned int m_reordered;
+  DmxBuffer m_output;
+  ola::thread::timeout_id m_send_timeout;
+  unsigned int m_pending_registrations;
+  TimeStamp m_start_time;
+  TimeStamp m_stop_time;
+  TimeInterval m_start_cpu_time;
+  TimeInterval m_stop_cpu_time;
+  bool m_have_cpu_time;
+
+  void Start();
+  bool SendFrames();
+  void StopSending();
+  void FrameReceived(unsigned int universe);
+  void OladFrame(const DMXMetadata &metadata, const DmxBuffer &data);
+  void RegisterComplete(const Result &result);
+  void RecordFrame(unsigned int universe, const DmxBuffer &data);
+  uint32_t Now();
+
+  static void SetUInt32(DmxBuffer *buffer, unsigned int offset,
+                        uint32_t value);
+  static uint32_t GetUInt32(const DmxBuffer &buffer, unsigned int offset);
+};
+
 
 /**
- * Send N DMX frames using ArtNet, where N is given by number_of_universes.
+ * Create the nodes. Each node uses a separate subnet and takes care of 16
+ * universes. If client is NULL the nodes also receive the frames.
  */
-bool SendFrames(ArtNetNode *node, DmxBuffer *buffer,
-                uint16_t number_of_universes) {
-  for (uint16_t i = 0; i < number_of_universes; i++) {
-    node->SendDMX(i, *buffer);
+bool LoadTest::Setup(ola::client::OlaClient *client) {
+  m_output.Blackout();
+
+  unsigned int node_count = (
+      (m_universe_count + UNIVERSES_PER_SUBNET - 1) / UNIVERSES_PER_SUBNET);
+  for (unsigned int i = 0; i < node_count; i++) {
+    uint8_t ports = static_cast<uint8_t>(
+        min(UNIVERSES_PER_SUBNET, m_universe_count - i * UNIVERSES_PER_SUBNET));
+
+    ArtNetNodeOptions options;
+    options.always_broadcast = true;
+    options.batch_transmit = FLAGS_batch_transmit;
+    options.transmit_pacing_ms = FLAGS_transmit_pacing_ms;
+    options.input_port_count = ports;
+    options.output_port_count = client ? 0 : ports;
+    ArtNetNode *node = new ArtNetNode(m_interface, m_ss, options);
+    m_nodes.push_back(node);
+
+    node->SetSubnetAddress(static_cast<uint8_t>(i));
+    for (uint8_t port = 0; port < ports; port++) {
+      unsigned int universe = i * UNIVERSES_PER_SUBNET + port;
+      if (!node->SetInputPortUniverse(port, port)) {
+        OLA_WARN << "Failed to set port " << static_cast<int>(port);
+        return false;
+      }
+      if (!client) {
+        node->SetOutputPortUniverse(port, port);
+        node->SetDMXHandler(
+            port, &m_states[universe].buffer,
+            NewCallback(this, &LoadTest::FrameReceived, universe));
+      }
+    }
+
+    if (!node->Start()) {
+      return false;
+    }
+  }
+
+  if (client) {
+    // Wait until we're registered for all the universes before sending.
+    client->SetDMXCallback(NewCallback(this, &LoadTest::OladFrame));
+    m_pending_registrations = m_universe_count;
+    for (unsigned int i = 0; i < m_universe_count; i++) {
+      client->RegisterUniverse(
+          i, ola::client::REGISTER,
+          NewSingleCallback(this, &LoadTest::RegisterComplete));
+    }
+  } else {
+    Start();
   }
   return true;
 }
 
+/**
+ * Output the results as a JSON object.
+ */
+void LoadTest::WriteReport(std::ostream *output) {
+  uint64_t sent = 0;
+  uint64_t received = 0;
+  vector<UniverseState>::const_iterator iter = m_states.begin();
+  for (; iter != m_states.end(); ++iter) {
+    sent += iter->sent;
+    received += iter->received;
+  }
+  uint64_t lost = sent > received ? sent - received : 0;
+  TimeInterval duration = m_stop_time - m_start_time;
+
+  JsonObject json;
+  json.Add("universes", m_universe_count);
+  json.Add("fps", m_fps);
+  json.Add("duration", static_cast<double>(duration.AsInt()) / 1000000);
+  json.Add("receiver", FLAGS_olad ? "olad" : "in-process");
+  json.Add("batch_transmit", static_cast<bool>(FLAGS_batch_transmit));
+  json.Add("transmit_pacing_ms",
+           static_cast<unsigned int>(FLAGS_transmit_pacing_ms));
+  json.AddValue("frames_sent", new JsonUInt64(sent));
+  json.AddValue("frames_received", new JsonUInt64(received));
+  json.AddValue("frames_lost", new JsonUInt64(lost));
+  json.Add("frames_reordered", m_reordered);
+  json.Add("loss_percent",
+           sent ? static_cast<double>(lost) * 100 / sent : 0.0);
+
+  JsonObject *latency = json.AddObject("latency_us");
+  if (!m_latencies.empty()) {
+    std::sort(m_latencies.begin(), m_latencies.end());
+    uint64_t total = 0;
+    vector<uint32_t>::const_iterator latency_iter = m_latencies.begin();
+    for (; latency_iter != m_latencies.end(); ++latency_iter) {
+      total += *latency_iter;
+    }
+    size_t count = m_latencies.size();
+    latency->Add("min", m_latencies.front());
+    latency->Add("mean", static_cast<double>(total) / count);
+    latency->Add("p50", m_latencies[count / 2]);
+    latency->Add("p90", m_latencies[count * 9 / 10]);
+    latency->Add("p99", m_latencies[count * 99 / 100]);
+    latency->Add("max", m_latencies.back());
+  }
+
+  if (m_have_cpu_time) {
+    JsonObject *cpu = json.AddObject("cpu");
+    TimeInterval cpu_time = m_stop_cpu_time;
+    cpu->Add("process", FLAGS_olad_pid ? "olad" : "loadtest");
+    cpu->Add("seconds",
+             static_cast<double>(cpu_time.AsInt() -
+                                 m_start_cpu_time.AsInt()) / 1000000);
+    if (duration.AsInt()) {
+      cpu->Add("percent",
+               static_cast<double>(cpu_time.AsInt() -
+                                   m_start_cpu_time.AsInt()) * 100 /
+               duration.AsInt());
+    }
+  }
+
+  JsonWriter::Write(output, json);
+  *output << endl;
+}
+
+void LoadTest::Start() {
+  OLA_INFO << "Sending " << m_universe_count << " universe(s) at " << m_fps
+           << " fps for " << m_duration << "s";
+  m_clock.CurrentTime(&m_start_time);
+  m_have_cpu_time = ProcessCPUTime(FLAGS_olad_pid, &m_start_cpu_time);
+  m_send_timeout = m_ss->RegisterRepeatingTimeout(
+      1000 / m_fps,
+      NewCallback(this, &LoadTest::SendFrames));
+  m_ss->RegisterSingleTimeout(
+      m_duration * 1000,
+      NewSingleCallback(this, &LoadTest::StopSending));
+}
+
+/**
+ * Send one frame for each universe.
+ */
+bool LoadTest::SendFrames() {
+  SetUInt32(&m_output, 4, Now());
+  for (unsigned int universe = 0; universe < m_universe_count; universe++) {
+    UniverseState *state = &m_states[universe];
+    SetUInt32(&m_output, 0, state->sent);
+    if (m_nodes[universe / UNIVERSES_PER_SUBNET]->SendDMX(
+          static_cast<uint8_t>(universe % UNIVERSES_PER_SUBNET), m_output)) {
+      state->sent++;
+    }
+  }
+  return true;
+}
+
+void LoadTest::StopSending() {
+  m_clock.CurrentTime(&m_stop_time);
+  if (m_have_cpu_time) {
+    m_have_cpu_time = ProcessCPUTime(FLAGS_olad_pid, &m_stop_cpu_time);
+  }
+  m_ss->RemoveTimeout(m_send_timeout);
+  m_send_timeout = ola::thread::INVALID_TIMEOUT;
+  m_ss->RegisterSingleTimeout(
+      DRAIN_TIME_MS,
+      NewSingleCallback(m_ss, &SelectServer::Terminate));
+}
+
+void LoadTest::FrameReceived(unsigned int universe) {
+  RecordFrame(universe, m_states[universe].buffer);
+}
+
+void LoadTest::OladFrame(const DMXMetadata &metadata, const DmxBuffer &data) {
+  if (metadata.universe < m_universe_count) {
+    RecordFrame(metadata.universe, data);
+  }
+}
+
+void LoadTest::RegisterComplete(const Result &result) {
+  if (!result.Success()) {
+    OLA_WARN << "Failed to register universe: " << result.Error();
+    m_ss->Terminate();
+    return;
+  }
+  if (--m_pending_registrations == 0) {
+    Start();
+  }
+}
+
+void LoadTest::RecordFrame(unsigned int universe, const DmxBuffer &data) {
+  if (!m_start_time.IsSet() || data.Size() < 8) {
+    return;
+  }
+
+  UniverseState *state = &m_states[universe];
+  uint32_t sequence = GetUInt32(data, 0);
+  if (state->received && sequence <= state->last_sequence) {
+    m_reordered++;
+  } else {
+    state->last_sequence = sequence;
+  }
+  state->received++;
+  m_latencies.push_back(Now() - GetUInt32(data, 4));
+}
+
+/**
+ * The time since the start of the test, in microseconds.
+ */
+uint32_t LoadTest::Now() {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  return static_cast<uint32_t>((now - m_start_time).AsInt());
+}
+
+void LoadTest::SetUInt32(DmxBuffer *buffer, unsigned int offset,
+                         uint32_t value) {
+  for (unsigned int i = 0; i < 4; i++) {
+    buffer->SetChannel(offset + i,
+                       static_cast<uint8_t>(value >> (24 - 8 * i)));
+  }
+}
+
+uint32_t LoadTest::GetUInt32(const DmxBuffer &buffer, unsigned int offset) {
+  uint32_t value = 0;
+  for (unsigned int i = 0; i < 4; i++) {
+    value = (value << 8) | buffer.Get(offset + i);
+  }
+  return value;
+}
+
+
 int main(int argc, char* argv[]) {
-  ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
+  ola::AppInit(&argc, argv, "", "Run the ArtNet load test.");
 
-  if (FLAGS_universes == 0 || FLAGS_fps == 0) {
+  if (FLAGS_universes == 0 || FLAGS_fps == 0 || FLAGS_duration == 0) {
     return -1;
   }
 
   unsigned int fps = min(1000u, static_cast<unsigned int>(FLAGS_fps));
-  uint16_t universes = FLAGS_universes;
-
-  DmxBuffer output;
-  output.Blackout();
+  unsigned int universes = min(MAX_UNIVERSES,
+                               static_cast<unsigned int>(FLAGS_universes));
 
   Interface iface;
   {
@@ -80,26 +473,27 @@ int main(int argc, char* argv[]) {
     }
   }
 
-  ArtNetNodeOptions options;
-  options.always_broadcast = true;
-
-  SelectServer ss;
-  ArtNetNode node(iface, &ss, options);
-
-  for (uint16_t i = 0; i < universes; i++) {
-    if (!node.SetInputPortUniverse(i, i)) {
-      OLA_WARN << "Failed to set port";
+  auto_ptr<OlaClientWrapper> client;
+  auto_ptr<SelectServer> local_ss;
+  SelectServer *ss;
+  if (FLAGS_olad) {
+    client.reset(new OlaClientWrapper());
+    if (!client->Setup()) {
+      OLA_WARN << "Failed to connect to olad";
+      return -1;
     }
+    ss = client->GetSelectServer();
+  } else {
+    local_ss.reset(new SelectServer());
+    ss = local_ss.get();
   }
 
-  if (!node.Start()) {
+  LoadTest load_test(ss, iface, universes, fps, FLAGS_duration);
+  if (!load_test.Setup(client.get() ? client->GetClient() : NULL)) {
     return -1;
   }
 
-  ss.RegisterRepeatingTimeout(
-      1000 / fps,
-      NewCallback(&SendFrames, &node, &output, universes));
-  cout << "Starting loadtester: " << universes << " universe(s), " << fps
-       << " fps" << endl;
-  ss.Run();
+  ss->Run();
+  load_test.WriteReport(&cout);
+  return 0;
 }
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterDevice.cpp
+ * Cluster device
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <sstream>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "olad/Plugin.h"
+#include "olad/PluginAdaptor.h"
+#include "plugins/cluster/ClusterDevice.h"
+#include "plugins/cluster/ClusterNode.h"
+#include "plugins/cluster/ClusterPort.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using ola::network::IPV4SocketAddress;
+using std::ostringstream;
+using std::vector;
+
+const char ClusterDevice::CLUSTER_DEVICE_NAME[] = "Cluster";
+
+ClusterDevice::ClusterDevice(Plugin *owner,
+                             const ClusterDeviceOptions &options,
+                             PluginAdaptor *plugin_adaptor)
+    : Device(owner, CLUSTER_DEVICE_NAME),
+      m_options(options),
+      m_plugin_adaptor(plugin_adaptor),
+      m_tick_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+ClusterDevice::~ClusterDevice() {}
+
+/*
+ * Start this device
+ */
+bool ClusterDevice::StartHook() {
+  m_node.reset(new ClusterNode(m_options.listen_address));
+  if (!m_node->Start()) {
+    m_node.reset();
+    DeleteAllPorts();
+    return false;
+  }
+
+  vector<IPV4SocketAddress>::const_iterator iter = m_options.peers.begin();
+  for (; iter != m_options.peers.end(); ++iter) {
+    m_node->AddPeer(*iter);
+  }
+
+  ostringstream str;
+  str << CLUSTER_DEVICE_NAME << " [" << m_options.listen_address << "]";
+  SetName(str.str());
+
+  for (unsigned int i = 0; i < m_options.input_ports; i++) {
+    AddPort(new ClusterInputPort(this, i, m_plugin_adaptor, m_node.get()));
+  }
+  for (unsigned int i = 0; i < m_options.output_ports; i++) {
+    AddPort(new ClusterOutputPort(this, i, m_node.get()));
+  }
+
+  m_node->GetSocket()->SetReadLabel("cluster");
+  m_plugin_adaptor->AddReadDescriptor(m_node->GetSocket());
+  m_tick_timeout = m_plugin_adaptor->RegisterRepeatingTimeout(
+      m_options.tick_interval_ms,
+      NewCallback(this, &ClusterDevice::Tick));
+
+  if (m_options.failover) {
+    m_failover.reset(new ClusterFailover(
+        m_plugin_adaptor, m_node.get(), m_options.failover_role,
+        TimeInterval(m_options.heartbeat_interval_ms * 1000),
+        NewCallback(m_plugin_adaptor, &PluginAdaptor::SetOutputsHeld)));
+    m_failover->Start();
+  }
+  return true;
+}
+
+/*
+ * Stop this device
+ */
+void ClusterDevice::PrePortStop() {
+  // This releases the outputs if they were held.
+  m_failover.reset();
+  if (m_tick_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_tick_timeout);
+    m_tick_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_plugin_adaptor->RemoveReadDescriptor(m_node->GetSocket());
+}
+
+/*
+ * Stop this device
+ */
+void ClusterDevice::PostPortStop() {
+  m_node->Stop();
+  m_node.reset();
+}
+
+/*
+ * Send the universes that changed in the last tick.
+ */
+bool ClusterDevice::Tick() {
+  TimeStamp now;
+  m_plugin_adaptor->LoopClock()->CurrentTime(&now);
+  m_node->Flush(now);
+  return true;
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterDevice.h
+ * Interface for the Cluster device
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERDEVICE_H_
+#define PLUGINS_CLUSTER_CLUSTERDEVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ola/network/SocketAddress.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/Device.h"
+#include "olad/Plugin.h"
+#include "plugins/cluster/ClusterFailover.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+class ClusterNode;
+
+class ClusterDevice: public ola::Device {
+ public:
+  struct ClusterDeviceOptions {
+   public:
+    ClusterDeviceOptions()
+        : input_ports(0),
+          output_ports(0),
+          tick_interval_ms(0),
+          failover(false),
+          failover_role(ClusterFailover::PRIMARY),
+          heartbeat_interval_ms(0) {
+    }
+
+    ola::network::IPV4SocketAddress listen_address;
+    std::vector<ola::network::IPV4SocketAddress> peers;
+    unsigned int input_ports;
+    unsigned int output_ports;
+    unsigned int tick_interval_ms;
+    // If true, this node is one of a primary / standby pair.
+    bool failover;
+    ClusterFailover::Role failover_role;
+    unsigned int heartbeat_interval_ms;
+  };
+
+  ClusterDevice(Plugin *owner,
+                const ClusterDeviceOptions &options,
+                class PluginAdaptor *plugin_adaptor);
+  ~ClusterDevice();
+
+  bool AllowMultiPortPatching() const { return true; }
+  std::string DeviceId() const { return "1"; }
+
+ protected:
+  bool StartHook();
+  void PrePortStop();
+  void PostPortStop();
+
+ private:
+  const ClusterDeviceOptions m_options;
+  class PluginAdaptor *m_plugin_adaptor;
+  std::auto_ptr<ClusterNode> m_node;
+  std::auto_ptr<ClusterFailover> m_failover;
+  ola::thread::timeout_id m_tick_timeout;
+
+  bool Tick();
+
+  static const char CLUSTER_DEVICE_NAME[];
+};
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERDEVICE_H_
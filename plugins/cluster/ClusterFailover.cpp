@@ -0,0 +1,114 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterFailover.cpp
+ * Hands the outputs over between a primary and a standby olad.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "plugins/cluster/ClusterFailover.h"
+#include "plugins/cluster/ClusterNode.h"
+#include "plugins/cluster/ClusterPackets.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+ClusterFailover::ClusterFailover(ola::thread::SchedulerInterface *scheduler,
+                                 ClusterNode *node,
+                                 Role role,
+                                 const TimeInterval &heartbeat_interval,
+                                 Callback1<void, bool> *hold_outputs)
+    : HealthCheckedConnection(scheduler, heartbeat_interval),
+      m_node(node),
+      m_role(role),
+      m_active(true),
+      m_peer_up(false),
+      m_hold_outputs(hold_outputs) {
+}
+
+ClusterFailover::~ClusterFailover() {
+  m_node->SetPacketHandler(NULL);
+  SetActive(true);
+  delete m_hold_outputs;
+}
+
+/*
+ * A standby starts with its outputs held, so it doesn't fight the primary
+ * while the first heartbeat is on the way.
+ */
+bool ClusterFailover::Start() {
+  m_node->SetHeaderFlags(
+      m_role == PRIMARY ? CLUSTER_FROM_PRIMARY : CLUSTER_FROM_STANDBY);
+  m_node->SetPacketHandler(
+      NewCallback(this, &ClusterFailover::PacketReceived));
+  if (m_role == STANDBY) {
+    SetActive(false);
+  }
+  return Setup();
+}
+
+void ClusterFailover::SendHeartbeat() {
+  m_node->SendHeartbeat();
+}
+
+void ClusterFailover::HeartbeatTimeout() {
+  m_peer_up = false;
+  if (m_role == STANDBY) {
+    OLA_WARN << "Lost the cluster primary, taking over the outputs";
+    SetActive(true);
+  } else {
+    OLA_WARN << "Lost the cluster standby";
+  }
+}
+
+/*
+ * Any packet from the other node of the pair counts as a heartbeat.
+ */
+void ClusterFailover::PacketReceived(uint8_t flags) {
+  const uint8_t peer_flag =
+      m_role == PRIMARY ? CLUSTER_FROM_STANDBY : CLUSTER_FROM_PRIMARY;
+  if (!(flags & peer_flag)) {
+    return;
+  }
+
+  HeartbeatReceived();
+  if (m_peer_up) {
+    return;
+  }
+
+  m_peer_up = true;
+  if (m_role == STANDBY) {
+    if (m_active) {
+      OLA_INFO << "Cluster primary is back, handing over the outputs";
+    }
+    SetActive(false);
+  } else {
+    OLA_INFO << "Cluster standby is up";
+  }
+}
+
+void ClusterFailover::SetActive(bool active) {
+  if (active == m_active) {
+    return;
+  }
+  m_active = active;
+  m_hold_outputs->Run(!active);
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
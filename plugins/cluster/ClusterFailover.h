@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterFailover.h
+ * Hands the outputs over between a primary and a standby olad.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERFAILOVER_H_
+#define PLUGINS_CLUSTER_CLUSTERFAILOVER_H_
+
+#include <stdint.h>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/network/HealthCheckedConnection.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+class ClusterNode;
+
+/**
+ * @brief Decides which olad of a primary / standby pair drives the outputs.
+ *
+ * Both nodes send heartbeats over the cluster socket. The standby holds its
+ * outputs while it hears from the primary, and takes them over once the
+ * primary misses its heartbeats. When the primary comes back the standby
+ * holds its outputs again.
+ */
+class ClusterFailover: public ola::network::HealthCheckedConnection {
+ public:
+  enum Role {
+    PRIMARY,
+    STANDBY
+  };
+
+  /**
+   * @brief Create a new ClusterFailover.
+   * @param scheduler the scheduler to use for the heartbeat timers.
+   * @param node the ClusterNode to send the heartbeats with, ownership is not
+   *   transferred.
+   * @param role the role of this node.
+   * @param heartbeat_interval how often to send a heartbeat.
+   * @param hold_outputs run with true to hold the outputs, and false to
+   *   release them. Ownership is transferred.
+   */
+  ClusterFailover(ola::thread::SchedulerInterface *scheduler,
+                  ClusterNode *node,
+                  Role role,
+                  const ola::TimeInterval &heartbeat_interval,
+                  ola::Callback1<void, bool> *hold_outputs);
+  ~ClusterFailover();
+
+  bool Start();
+
+  /**
+   * @brief True if this node is driving its outputs.
+   */
+  bool Active() const { return m_active; }
+
+  /**
+   * @brief True if the heartbeats from the other node are arriving.
+   */
+  bool PeerUp() const { return m_peer_up; }
+
+  void SendHeartbeat();
+
+ protected:
+  void HeartbeatTimeout();
+
+ private:
+  ClusterNode *m_node;
+  const Role m_role;
+  bool m_active;
+  bool m_peer_up;
+  ola::Callback1<void, bool> *m_hold_outputs;
+
+  void PacketReceived(uint8_t flags);
+  void SetActive(bool active);
+
+  DISALLOW_COPY_AND_ASSIGN(ClusterFailover);
+};
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERFAILOVER_H_
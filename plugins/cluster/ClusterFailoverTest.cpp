@@ -0,0 +1,188 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterFailoverTest.cpp
+ * Test fixture for the ClusterFailover class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/cluster/ClusterFailover.h"
+#include "plugins/cluster/ClusterNode.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using ola::MockClock;
+using ola::TimeInterval;
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::auto_ptr;
+
+class ClusterFailoverTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ClusterFailoverTest);
+  CPPUNIT_TEST(testPrimary);
+  CPPUNIT_TEST(testTakeOverAndFailBack);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ClusterFailoverTest()
+      : CppUnit::TestFixture(),
+        m_ss(NULL, &m_clock),
+        m_heartbeat_interval(0, 100000) {
+  }
+
+  void setUp();
+
+  void testPrimary();
+  void testTakeOverAndFailBack();
+
+ private:
+  MockClock m_clock;
+  SelectServer m_ss;
+  const TimeInterval m_heartbeat_interval;
+  auto_ptr<ClusterNode> m_primary_node;
+  auto_ptr<ClusterNode> m_standby_node;
+  bool m_primary_held;
+  bool m_standby_held;
+
+  void PrimaryHold(bool held) { m_primary_held = held; }
+  void StandbyHold(bool held) { m_standby_held = held; }
+  ClusterFailover *NewPrimary();
+  ClusterFailover *NewStandby();
+  void AdvanceTime(unsigned int ms);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClusterFailoverTest);
+
+void ClusterFailoverTest::setUp() {
+  m_primary_held = false;
+  m_standby_held = false;
+
+  const IPV4SocketAddress loopback(IPV4Address::Loopback(), 0);
+  m_primary_node.reset(new ClusterNode(loopback));
+  OLA_ASSERT_TRUE(m_primary_node->Start());
+  m_standby_node.reset(new ClusterNode(loopback));
+  OLA_ASSERT_TRUE(m_standby_node->Start());
+
+  IPV4SocketAddress address;
+  OLA_ASSERT_TRUE(m_primary_node->GetLocalAddress(&address));
+  m_standby_node->AddPeer(address);
+  OLA_ASSERT_TRUE(m_standby_node->GetLocalAddress(&address));
+  m_primary_node->AddPeer(address);
+}
+
+ClusterFailover *ClusterFailoverTest::NewPrimary() {
+  return new ClusterFailover(
+      &m_ss, m_primary_node.get(), ClusterFailover::PRIMARY,
+      m_heartbeat_interval,
+      NewCallback(this, &ClusterFailoverTest::PrimaryHold));
+}
+
+ClusterFailover *ClusterFailoverTest::NewStandby() {
+  return new ClusterFailover(
+      &m_ss, m_standby_node.get(), ClusterFailover::STANDBY,
+      m_heartbeat_interval,
+      NewCallback(this, &ClusterFailoverTest::StandbyHold));
+}
+
+/*
+ * Advance the clock, run the timers and read the heartbeats that were sent.
+ */
+void ClusterFailoverTest::AdvanceTime(unsigned int ms) {
+  m_clock.AdvanceTime(TimeInterval(0, ms * 1000));
+  m_ss.RunOnce(TimeInterval(0, 0));
+  m_primary_node->SocketReady();
+  m_standby_node->SocketReady();
+}
+
+/*
+ * Check a primary never holds its outputs.
+ */
+void ClusterFailoverTest::testPrimary() {
+  auto_ptr<ClusterFailover> primary(NewPrimary());
+  OLA_ASSERT_TRUE(primary->Start());
+  OLA_ASSERT_TRUE(primary->Active());
+  OLA_ASSERT_FALSE(primary->PeerUp());
+
+  auto_ptr<ClusterFailover> standby(NewStandby());
+  OLA_ASSERT_TRUE(standby->Start());
+  AdvanceTime(0);
+  OLA_ASSERT_TRUE(primary->PeerUp());
+
+  // Losing the standby doesn't change anything.
+  standby.reset();
+  AdvanceTime(300);
+  OLA_ASSERT_FALSE(primary->PeerUp());
+  OLA_ASSERT_TRUE(primary->Active());
+  OLA_ASSERT_FALSE(m_primary_held);
+}
+
+/*
+ * Check the standby takes over when the primary goes away, and hands the
+ * outputs back when it returns.
+ */
+void ClusterFailoverTest::testTakeOverAndFailBack() {
+  auto_ptr<ClusterFailover> standby(NewStandby());
+  OLA_ASSERT_TRUE(standby->Start());
+  OLA_ASSERT_FALSE(standby->Active());
+  OLA_ASSERT_TRUE(m_standby_held);
+
+  auto_ptr<ClusterFailover> primary(NewPrimary());
+  OLA_ASSERT_TRUE(primary->Start());
+  AdvanceTime(0);
+  OLA_ASSERT_TRUE(standby->PeerUp());
+  OLA_ASSERT_FALSE(standby->Active());
+
+  // The heartbeats keep the standby from taking over.
+  for (unsigned int i = 0; i < 5; i++) {
+    AdvanceTime(100);
+  }
+  OLA_ASSERT_FALSE(standby->Active());
+  OLA_ASSERT_TRUE(m_standby_held);
+
+  primary.reset();
+  AdvanceTime(100);
+  AdvanceTime(100);
+  OLA_ASSERT_FALSE(standby->Active());
+  AdvanceTime(100);
+  OLA_ASSERT_TRUE(standby->Active());
+  OLA_ASSERT_FALSE(standby->PeerUp());
+  OLA_ASSERT_FALSE(m_standby_held);
+
+  primary.reset(NewPrimary());
+  OLA_ASSERT_TRUE(primary->Start());
+  AdvanceTime(0);
+  OLA_ASSERT_TRUE(standby->PeerUp());
+  OLA_ASSERT_FALSE(standby->Active());
+  OLA_ASSERT_TRUE(m_standby_held);
+
+  // Stopping the standby releases the outputs.
+  standby.reset();
+  OLA_ASSERT_FALSE(m_standby_held);
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,352 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterNode.cpp
+ * Replicates universes between olad nodes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/stl/STLUtils.h"
+#include "plugins/cluster/ClusterNode.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using ola::network::HostToNetwork;
+using ola::network::IPV4SocketAddress;
+using ola::network::NetworkToHost;
+using ola::network::UDPSocket;
+using std::vector;
+
+const uint16_t ClusterNode::DEFAULT_PORT;
+
+ClusterNode::ClusterNode(const IPV4SocketAddress &listen_address)
+    : m_listen_address(listen_address),
+      m_running(false),
+      m_packet_sequence(0),
+      m_header_flags(0),
+      m_packet_handler(NULL),
+      m_socket(NULL),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  CLUSTER_MAX_PACKET_SIZE),
+      m_packet_size(sizeof(cluster_header)),
+      m_record_count(0) {
+}
+
+ClusterNode::~ClusterNode() {
+  Stop();
+  STLDeleteValues(&m_outputs);
+  delete m_packet_handler;
+
+  InputMap::iterator iter = m_inputs.begin();
+  for (; iter != m_inputs.end(); ++iter) {
+    delete iter->second.closure;
+  }
+  m_inputs.clear();
+}
+
+bool ClusterNode::Start() {
+  if (m_running) {
+    return false;
+  }
+
+  m_socket = new UDPSocket();
+  if (!m_socket->Init()) {
+    OLA_WARN << "Socket init failed";
+    delete m_socket;
+    m_socket = NULL;
+    return false;
+  }
+
+  if (!m_socket->Bind(m_listen_address)) {
+    delete m_socket;
+    m_socket = NULL;
+    return false;
+  }
+
+  m_socket->SetOnData(NewCallback(this, &ClusterNode::SocketReady));
+  m_running = true;
+  return true;
+}
+
+bool ClusterNode::Stop() {
+  if (!m_running) {
+    return false;
+  }
+
+  delete m_socket;
+  m_socket = NULL;
+  m_running = false;
+  return true;
+}
+
+void ClusterNode::AddPeer(const IPV4SocketAddress &peer) {
+  m_peers.push_back(peer);
+}
+
+bool ClusterNode::SendDMX(unsigned int universe, const DmxBuffer &buffer,
+                          uint8_t priority) {
+  if (!m_running) {
+    return false;
+  }
+
+  OutputUniverse *state = STLFindOrNull(m_outputs, universe);
+  if (!state) {
+    state = new OutputUniverse();
+    m_outputs[universe] = state;
+  }
+  // This records which slots changed.
+  state->buffer = buffer;
+  state->priority = priority;
+  state->pending = true;
+  return true;
+}
+
+void ClusterNode::Flush(const TimeStamp &now) {
+  if (!m_running) {
+    return;
+  }
+
+  const TimeInterval full_frame_interval(FULL_FRAME_INTERVAL_MS * 1000);
+  OutputMap::iterator iter = m_outputs.begin();
+  for (; iter != m_outputs.end(); ++iter) {
+    OutputUniverse *state = iter->second;
+    if (!state->pending) {
+      continue;
+    }
+    state->pending = false;
+
+    bool full = !state->sent ||
+                now >= state->last_full_frame + full_frame_interval;
+    if (!full) {
+      if (!state->buffer.HasChanges() &&
+          state->priority == state->sent_priority) {
+        continue;
+      }
+      // A delta that covers most of the frame isn't worth it.
+      unsigned int offset, length;
+      state->buffer.GetChangedRange(&offset, &length);
+      full = offset + length > state->buffer.Size() ||
+             2 * length > state->buffer.Size();
+    }
+
+    AppendRecord(iter->first, state, full);
+    if (full) {
+      state->last_full_frame = now;
+    }
+    state->sent = true;
+    state->sent_priority = state->priority;
+    state->buffer.ClearChanges();
+  }
+
+  if (m_record_count) {
+    SendPacket();
+  }
+}
+
+bool ClusterNode::SendHeartbeat() {
+  if (!m_running) {
+    return false;
+  }
+  if (!m_record_count) {
+    SendPacket();
+  }
+  return true;
+}
+
+void ClusterNode::SetPacketHandler(Callback1<void, uint8_t> *callback) {
+  delete m_packet_handler;
+  m_packet_handler = callback;
+}
+
+bool ClusterNode::SetHandler(unsigned int universe, DmxBuffer *buffer,
+                             uint8_t *priority, Callback0<void> *closure) {
+  if (!closure) {
+    return false;
+  }
+
+  InputMap::iterator iter = m_inputs.find(universe);
+  if (iter == m_inputs.end()) {
+    InputUniverse input;
+    input.buffer = buffer;
+    input.priority = priority;
+    input.closure = closure;
+    input.sequence = 0;
+    input.synced = false;
+    m_inputs[universe] = input;
+  } else {
+    Callback0<void> *old_closure = iter->second.closure;
+    iter->second.closure = closure;
+    delete old_closure;
+  }
+  return true;
+}
+
+bool ClusterNode::RemoveHandler(unsigned int universe) {
+  InputMap::iterator iter = m_inputs.find(universe);
+  if (iter == m_inputs.end()) {
+    return false;
+  }
+  delete iter->second.closure;
+  m_inputs.erase(iter);
+  return true;
+}
+
+bool ClusterNode::GetLocalAddress(IPV4SocketAddress *address) const {
+  return m_socket && m_socket->GetSocketAddress(address);
+}
+
+void ClusterNode::SocketReady() {
+  unsigned int count = m_recv_ring.Receive(m_socket);
+  for (unsigned int i = 0; i < count; i++) {
+    const ola::network::UDPDatagram &datagram = m_recv_ring.Get(i);
+    HandlePacket(datagram.data, datagram.size);
+  }
+}
+
+/*
+ * Add a universe to the packet, sending the packet first if it's full.
+ */
+void ClusterNode::AppendRecord(unsigned int universe, OutputUniverse *state,
+                               bool full) {
+  unsigned int offset = 0;
+  unsigned int length = state->buffer.Size();
+  if (!full) {
+    state->buffer.GetChangedRange(&offset, &length);
+  }
+
+  if (m_record_count == MAX_RECORDS ||
+      m_packet_size + sizeof(cluster_record) + length >
+        CLUSTER_MAX_PACKET_SIZE) {
+    SendPacket();
+  }
+
+  cluster_record record;
+  record.universe = HostToNetwork(static_cast<uint32_t>(universe));
+  record.sequence = ++state->sequence;
+  record.flags = full ? CLUSTER_FULL_FRAME : 0;
+  record.priority = state->priority;
+  record.reserved = 0;
+  record.offset = HostToNetwork(static_cast<uint16_t>(offset));
+  record.length = HostToNetwork(static_cast<uint16_t>(length));
+  memcpy(m_packet + m_packet_size, &record, sizeof(record));
+  m_packet_size += sizeof(record);
+
+  if (length) {
+    memcpy(m_packet + m_packet_size, state->buffer.GetRaw() + offset, length);
+    m_packet_size += length;
+  }
+  m_record_count++;
+}
+
+void ClusterNode::SendPacket() {
+  cluster_header header;
+  header.magic = HostToNetwork(static_cast<uint32_t>(CLUSTER_MAGIC));
+  header.version = CLUSTER_VERSION;
+  header.flags = m_header_flags;
+  header.record_count = m_record_count;
+  header.reserved = 0;
+  header.sequence = HostToNetwork(m_packet_sequence++);
+  memcpy(m_packet, &header, sizeof(header));
+
+  vector<IPV4SocketAddress>::const_iterator iter = m_peers.begin();
+  for (; iter != m_peers.end(); ++iter) {
+    ssize_t bytes_sent = m_socket->SendTo(m_packet, m_packet_size, *iter);
+    if (bytes_sent != static_cast<ssize_t>(m_packet_size)) {
+      OLA_WARN << "Only sent " << bytes_sent << " of " << m_packet_size
+               << " to " << *iter;
+    }
+  }
+  m_packet_size = sizeof(cluster_header);
+  m_record_count = 0;
+}
+
+bool ClusterNode::HandlePacket(const uint8_t *data, unsigned int size) {
+  cluster_header header;
+  if (size < sizeof(header)) {
+    OLA_WARN << "Skipping small cluster packet, size=" << size;
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (NetworkToHost(header.magic) != CLUSTER_MAGIC ||
+      header.version != CLUSTER_VERSION) {
+    OLA_INFO << "Skipping a packet that isn't a cluster packet";
+    return false;
+  }
+
+  unsigned int offset = sizeof(header);
+  for (unsigned int i = 0; i < header.record_count; i++) {
+    cluster_record record;
+    if (size - offset < sizeof(record)) {
+      OLA_WARN << "Truncated cluster packet";
+      return false;
+    }
+    memcpy(&record, data + offset, sizeof(record));
+    offset += sizeof(record);
+
+    record.universe = NetworkToHost(record.universe);
+    record.offset = NetworkToHost(record.offset);
+    record.length = NetworkToHost(record.length);
+    if (size - offset < record.length ||
+        record.offset + record.length > DMX_UNIVERSE_SIZE) {
+      OLA_WARN << "Invalid cluster record for universe " << record.universe;
+      return false;
+    }
+    HandleRecord(record, data + offset);
+    offset += record.length;
+  }
+
+  if (m_packet_handler) {
+    m_packet_handler->Run(header.flags);
+  }
+  return true;
+}
+
+void ClusterNode::HandleRecord(const cluster_record &record,
+                               const uint8_t *data) {
+  InputMap::iterator iter = m_inputs.find(record.universe);
+  if (iter == m_inputs.end()) {
+    return;
+  }
+
+  InputUniverse *input = &iter->second;
+  const uint8_t expected_sequence = input->sequence + 1;
+  input->sequence = record.sequence;
+  if (record.flags & CLUSTER_FULL_FRAME) {
+    input->buffer->Set(data, record.length);
+    input->synced = true;
+  } else if (!input->synced || record.sequence != expected_sequence ||
+             record.offset > input->buffer->Size()) {
+    // A record was lost, wait for the next full frame.
+    input->synced = false;
+    return;
+  } else if (record.length) {
+    input->buffer->SetRange(record.offset, data, record.length);
+  }
+
+  *input->priority = record.priority;
+  input->closure->Run();
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
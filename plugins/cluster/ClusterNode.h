@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterNode.h
+ * Replicates universes between olad nodes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERNODE_H_
+#define PLUGINS_CLUSTER_CLUSTERNODE_H_
+
+#include <map>
+#include <vector>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "plugins/cluster/ClusterPackets.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+/**
+ * @brief Sends universes to, and receives them from, the other olad nodes
+ * in a cluster.
+ *
+ * SendDMX() only records the frame. Flush() is called once per tick and sends
+ * a single datagram to each peer, with the slots that changed in each
+ * universe since the last tick. Every universe is sent in full once a second
+ * so the peers recover from lost datagrams.
+ */
+class ClusterNode {
+ public:
+  /**
+   * @brief Create a new node.
+   * @param listen_address the address to receive datagrams on.
+   */
+  explicit ClusterNode(const ola::network::IPV4SocketAddress &listen_address);
+  ~ClusterNode();
+
+  bool Start();
+  bool Stop();
+
+  /**
+   * @brief Add a node to send the universes to.
+   */
+  void AddPeer(const ola::network::IPV4SocketAddress &peer);
+
+  /**
+   * @brief Record the latest frame for a universe, it's sent on the next
+   *   Flush().
+   */
+  bool SendDMX(unsigned int universe, const ola::DmxBuffer &buffer,
+               uint8_t priority);
+
+  /**
+   * @brief Send the universes that have changed to the peers.
+   * @param now the current time.
+   */
+  void Flush(const TimeStamp &now);
+
+  /**
+   * @brief Send a packet without any records, so the peers know this node is
+   *   up.
+   */
+  bool SendHeartbeat();
+
+  /**
+   * @brief Set the flags sent in the header of each packet.
+   * @param flags a combination of ClusterHeaderFlags.
+   */
+  void SetHeaderFlags(uint8_t flags) { m_header_flags = flags; }
+
+  /**
+   * @brief Set the callback to run for each valid packet received.
+   * @param callback run with the header flags of the packet, ownership is
+   *   transferred.
+   */
+  void SetPacketHandler(ola::Callback1<void, uint8_t> *callback);
+
+  /**
+   * @brief Set the closure to run when data arrives for a universe.
+   * @param universe the universe to receive.
+   * @param buffer the buffer to update.
+   * @param priority updated with the priority of the sender.
+   * @param closure run after the buffer is updated, ownership is
+   *   transferred.
+   */
+  bool SetHandler(unsigned int universe, DmxBuffer *buffer,
+                  uint8_t *priority, ola::Callback0<void> *closure);
+  bool RemoveHandler(unsigned int universe);
+
+  bool GetLocalAddress(ola::network::IPV4SocketAddress *address) const;
+  ola::network::UDPSocket* GetSocket() { return m_socket; }
+  void SocketReady();
+
+  static const uint16_t DEFAULT_PORT = 5580;
+
+  friend class ClusterNodeTest;
+
+ private:
+  struct OutputUniverse {
+    OutputUniverse()
+        : priority(0),
+          sent_priority(0),
+          sequence(0),
+          pending(false),
+          sent(false) {
+    }
+
+    DmxBuffer buffer;
+    uint8_t priority;
+    uint8_t sent_priority;
+    uint8_t sequence;
+    // True if SendDMX() was called since the last Flush().
+    bool pending;
+    bool sent;
+    TimeStamp last_full_frame;
+  };
+
+  struct InputUniverse {
+    DmxBuffer *buffer;
+    uint8_t *priority;
+    Callback0<void> *closure;
+    uint8_t sequence;
+    // False until a full frame arrives, and after a record is lost.
+    bool synced;
+  };
+
+  typedef std::map<unsigned int, OutputUniverse*> OutputMap;
+  typedef std::map<unsigned int, InputUniverse> InputMap;
+
+  const ola::network::IPV4SocketAddress m_listen_address;
+  bool m_running;
+  uint16_t m_packet_sequence;
+  uint8_t m_header_flags;
+  Callback1<void, uint8_t> *m_packet_handler;
+  std::vector<ola::network::IPV4SocketAddress> m_peers;
+  OutputMap m_outputs;
+  InputMap m_inputs;
+  ola::network::UDPSocket *m_socket;
+  ola::network::UDPReceiveRing m_recv_ring;
+  uint8_t m_packet[CLUSTER_MAX_PACKET_SIZE];
+  unsigned int m_packet_size;
+  unsigned int m_record_count;
+
+  void AppendRecord(unsigned int universe, OutputUniverse *state, bool full);
+  void SendPacket();
+  bool HandlePacket(const uint8_t *data, unsigned int size);
+  void HandleRecord(const cluster_record &record, const uint8_t *data);
+
+  static const unsigned int FULL_FRAME_INTERVAL_MS = 1000;
+  // The most records the record_count field can hold.
+  static const unsigned int MAX_RECORDS = 255;
+
+  DISALLOW_COPY_AND_ASSIGN(ClusterNode);
+};
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERNODE_H_
@@ -0,0 +1,265 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterNodeTest.cpp
+ * Test fixture for the ClusterNode class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/cluster/ClusterNode.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using ola::DmxBuffer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::auto_ptr;
+using std::string;
+
+class ClusterNodeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ClusterNodeTest);
+  CPPUNIT_TEST(testHandlePacket);
+  CPPUNIT_TEST(testSendAndReceive);
+  CPPUNIT_TEST(testResync);
+  CPPUNIT_TEST(testLargePacket);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+
+  void testHandlePacket();
+  void testSendAndReceive();
+  void testResync();
+  void testLargePacket();
+
+ private:
+  int m_handler_called;
+  uint8_t m_priority;
+  DmxBuffer m_received;
+  auto_ptr<ClusterNode> m_sender;
+  auto_ptr<ClusterNode> m_receiver;
+
+  void DataReceived() { m_handler_called++; }
+  void Receive(unsigned int universe, DmxBuffer *buffer);
+  static unsigned int BuildPacket(uint8_t *packet, uint8_t sequence,
+                                  uint8_t flags, uint16_t offset,
+                                  const string &data);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClusterNodeTest);
+
+void ClusterNodeTest::setUp() {
+  m_handler_called = 0;
+  m_priority = 0;
+  m_received.Reset();
+
+  const IPV4SocketAddress loopback(IPV4Address::Loopback(), 0);
+  m_receiver.reset(new ClusterNode(loopback));
+  OLA_ASSERT_TRUE(m_receiver->Start());
+  IPV4SocketAddress receiver_address;
+  OLA_ASSERT_TRUE(m_receiver->GetLocalAddress(&receiver_address));
+
+  m_sender.reset(new ClusterNode(loopback));
+  OLA_ASSERT_TRUE(m_sender->Start());
+  m_sender->AddPeer(receiver_address);
+}
+
+void ClusterNodeTest::Receive(unsigned int universe, DmxBuffer *buffer) {
+  m_receiver->SetHandler(
+      universe, buffer, &m_priority,
+      ola::NewCallback(this, &ClusterNodeTest::DataReceived));
+}
+
+/*
+ * Build a packet with a single record for universe 1.
+ */
+unsigned int ClusterNodeTest::BuildPacket(uint8_t *packet, uint8_t sequence,
+                                          uint8_t flags, uint16_t offset,
+                                          const string &data) {
+  const uint8_t header[] = {
+    'O', 'L', 'C', 'L', CLUSTER_VERSION, 0, 1, 0, 0, 0,
+    0, 0, 0, 1, sequence, flags, 120, 0,
+    static_cast<uint8_t>(offset >> 8), static_cast<uint8_t>(offset & 0xff),
+    0, static_cast<uint8_t>(data.size()),
+  };
+  memcpy(packet, header, sizeof(header));
+  memcpy(packet + sizeof(header), data.data(), data.size());
+  return sizeof(header) + data.size();
+}
+
+/*
+ * Check the packet handling code.
+ */
+void ClusterNodeTest::testHandlePacket() {
+  Receive(1, &m_received);
+  uint8_t packet[CLUSTER_MAX_PACKET_SIZE];
+
+  // short and invalid packets
+  unsigned int size = BuildPacket(packet, 1, CLUSTER_FULL_FRAME, 0, "abcd");
+  OLA_ASSERT_FALSE(m_receiver->HandlePacket(packet, 4));
+  OLA_ASSERT_FALSE(m_receiver->HandlePacket(packet, 10));
+  OLA_ASSERT_FALSE(m_receiver->HandlePacket(packet, size - 1));
+  packet[0] = 'X';
+  OLA_ASSERT_FALSE(m_receiver->HandlePacket(packet, size));
+  size = BuildPacket(packet, 1, CLUSTER_FULL_FRAME, 510, "abcd");
+  OLA_ASSERT_FALSE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(0, m_handler_called);
+
+  // A delta before the first full frame is ignored.
+  size = BuildPacket(packet, 1, 0, 0, "abcd");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(0, m_handler_called);
+
+  size = BuildPacket(packet, 2, CLUSTER_FULL_FRAME, 0, "abcd");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(1, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("abcd"), m_received);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), m_priority);
+
+  size = BuildPacket(packet, 3, 0, 1, "xy");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(2, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("axyd"), m_received);
+
+  // A lost record means the deltas are ignored until the next full frame.
+  size = BuildPacket(packet, 5, 0, 0, "z");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  size = BuildPacket(packet, 6, 0, 0, "z");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(2, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("axyd"), m_received);
+
+  size = BuildPacket(packet, 7, CLUSTER_FULL_FRAME, 0, "ef");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(3, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("ef"), m_received);
+
+  // Universes without a handler are skipped.
+  OLA_ASSERT_TRUE(m_receiver->RemoveHandler(1));
+  size = BuildPacket(packet, 8, CLUSTER_FULL_FRAME, 0, "gh");
+  OLA_ASSERT_TRUE(m_receiver->HandlePacket(packet, size));
+  OLA_ASSERT_EQ(3, m_handler_called);
+}
+
+/*
+ * Check the changes are sent to the peers on each tick.
+ */
+void ClusterNodeTest::testSendAndReceive() {
+  Receive(1, &m_received);
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdef"), 150));
+  OLA_ASSERT_TRUE(m_sender->SendDMX(2, DmxBuffer("xyz"), 100));
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(1, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("abcdef"), m_received);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), m_priority);
+
+  // Several frames within a tick are sent as one.
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeg"), 150));
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeh"), 150));
+  now += TimeInterval(20000);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(2, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("abcdeh"), m_received);
+
+  // Unchanged frames aren't sent, unless the priority changed.
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeh"), 150));
+  now += TimeInterval(20000);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(2, m_handler_called);
+
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeh"), 50));
+  now += TimeInterval(20000);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(3, m_handler_called);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(50), m_priority);
+  OLA_ASSERT_EQ(DmxBuffer("abcdeh"), m_received);
+}
+
+/*
+ * Check a receiver that missed the full frame catches up on the next one.
+ */
+void ClusterNodeTest::testResync() {
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdef"), 100));
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+
+  Receive(1, &m_received);
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeg"), 100));
+  now += TimeInterval(20000);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(0, m_handler_called);
+
+  OLA_ASSERT_TRUE(m_sender->SendDMX(1, DmxBuffer("abcdeg"), 100));
+  now += TimeInterval(1000000);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(1, m_handler_called);
+  OLA_ASSERT_EQ(DmxBuffer("abcdeg"), m_received);
+}
+
+/*
+ * Check the records are split across datagrams when they don't fit in one.
+ */
+void ClusterNodeTest::testLargePacket() {
+  DmxBuffer received[4];
+  uint8_t data[DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < 4; i++) {
+    Receive(i + 1, &received[i]);
+    memset(data, i + 1, sizeof(data));
+    OLA_ASSERT_TRUE(m_sender->SendDMX(i + 1, DmxBuffer(data, sizeof(data)),
+                                      100));
+  }
+
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+  m_sender->Flush(now);
+  m_receiver->SocketReady();
+  OLA_ASSERT_EQ(4, m_handler_called);
+  for (unsigned int i = 0; i < 4; i++) {
+    memset(data, i + 1, sizeof(data));
+    OLA_ASSERT_EQ(DmxBuffer(data, sizeof(data)), received[i]);
+  }
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
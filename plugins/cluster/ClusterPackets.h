@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterPackets.h
+ * The packets exchanged between olad nodes in a cluster.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERPACKETS_H_
+#define PLUGINS_CLUSTER_CLUSTERPACKETS_H_
+
+#include <stdint.h>
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+/*
+ * Each tick a node sends one datagram to each peer, holding a record for
+ * every universe that changed. All fields are in network byte order.
+ *
+ *   header, record, data, record, data, ...
+ *
+ * A packet without any records is a heartbeat.
+ */
+enum { CLUSTER_MAGIC = 0x4f4c434c };  // OLCL
+enum { CLUSTER_VERSION = 1 };
+
+// Keep the datagrams within a typical MTU.
+enum { CLUSTER_MAX_PACKET_SIZE = 1400 };
+
+enum ClusterRecordFlags {
+  // The record holds the whole frame, rather than a range of slots.
+  CLUSTER_FULL_FRAME = 0x01
+};
+
+enum ClusterHeaderFlags {
+  // The sender is the primary of a failover pair.
+  CLUSTER_FROM_PRIMARY = 0x01,
+  // The sender is the standby of a failover pair.
+  CLUSTER_FROM_STANDBY = 0x02
+};
+
+PACK(
+struct cluster_header_s {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t flags;
+  uint8_t record_count;
+  uint8_t reserved;
+  uint16_t sequence;
+});
+
+typedef struct cluster_header_s cluster_header;
+
+PACK(
+struct cluster_record_s {
+  uint32_t universe;
+  // Incremented for each record sent for the universe, so receivers can
+  // tell when a delta was lost.
+  uint8_t sequence;
+  uint8_t flags;
+  uint8_t priority;
+  uint8_t reserved;
+  uint16_t offset;
+  uint16_t length;
+});
+
+typedef struct cluster_record_s cluster_record;
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERPACKETS_H_
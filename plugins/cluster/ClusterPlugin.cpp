@@ -0,0 +1,228 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterPlugin.cpp
+ * The Cluster plugin for ola, this replicates universes between olad nodes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
+#include "plugins/cluster/ClusterDevice.h"
+#include "plugins/cluster/ClusterNode.h"
+#include "plugins/cluster/ClusterPlugin.h"
+#include "plugins/cluster/ClusterPluginDescription.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::set;
+using std::string;
+using std::vector;
+
+const char ClusterPlugin::PLUGIN_NAME[] = "Cluster";
+const char ClusterPlugin::PLUGIN_PREFIX[] = "cluster";
+const char ClusterPlugin::FAILOVER_ROLE_KEY[] = "failover_role";
+const char ClusterPlugin::HEARTBEAT_INTERVAL_KEY[] = "heartbeat_interval";
+const char ClusterPlugin::INPUT_PORT_COUNT_KEY[] = "input_ports";
+const char ClusterPlugin::IP_KEY[] = "ip";
+const char ClusterPlugin::OUTPUT_PORT_COUNT_KEY[] = "output_ports";
+const char ClusterPlugin::PEER_KEY[] = "peer";
+const char ClusterPlugin::PORT_KEY[] = "port";
+const char ClusterPlugin::TICK_INTERVAL_KEY[] = "tick_interval";
+const char ClusterPlugin::ROLE_NONE[] = "none";
+const char ClusterPlugin::ROLE_PRIMARY[] = "primary";
+const char ClusterPlugin::ROLE_STANDBY[] = "standby";
+const unsigned int ClusterPlugin::DEFAULT_HEARTBEAT_INTERVAL_MS = 40;
+const unsigned int ClusterPlugin::DEFAULT_PORT_COUNT = 5;
+const unsigned int ClusterPlugin::DEFAULT_TICK_INTERVAL_MS = 20;
+
+/*
+ * Start the plugin
+ */
+bool ClusterPlugin::StartHook() {
+  ClusterDevice::ClusterDeviceOptions options;
+
+  uint16_t port;
+  if (!StringToInt(m_preferences->GetValue(PORT_KEY), &port)) {
+    OLA_WARN << "Invalid value for " << PORT_KEY;
+    return false;
+  }
+
+  IPV4Address ip = IPV4Address::WildCard();
+  const string ip_value = m_preferences->GetValue(IP_KEY);
+  if (!ip_value.empty() && !IPV4Address::FromString(ip_value, &ip)) {
+    OLA_WARN << "Invalid value for " << IP_KEY << ": " << ip_value;
+    return false;
+  }
+  options.listen_address = IPV4SocketAddress(ip, port);
+
+  // Peers without a port use the same port as this node.
+  const vector<string> peers = m_preferences->GetMultipleValue(PEER_KEY);
+  vector<string>::const_iterator iter = peers.begin();
+  for (; iter != peers.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+    IPV4SocketAddress peer;
+    IPV4Address peer_ip;
+    if (IPV4SocketAddress::FromString(*iter, &peer)) {
+      options.peers.push_back(peer);
+    } else if (IPV4Address::FromString(*iter, &peer_ip)) {
+      options.peers.push_back(IPV4SocketAddress(peer_ip, port));
+    } else {
+      OLA_WARN << "Invalid value for " << PEER_KEY << ": " << *iter;
+    }
+  }
+  if (options.peers.empty()) {
+    OLA_INFO << "No cluster peers configured, only receiving";
+  }
+
+  if (!StringToInt(m_preferences->GetValue(INPUT_PORT_COUNT_KEY),
+                   &options.input_ports)) {
+    OLA_WARN << "Invalid value for " << INPUT_PORT_COUNT_KEY;
+  }
+  if (!StringToInt(m_preferences->GetValue(OUTPUT_PORT_COUNT_KEY),
+                   &options.output_ports)) {
+    OLA_WARN << "Invalid value for " << OUTPUT_PORT_COUNT_KEY;
+  }
+  if (!StringToInt(m_preferences->GetValue(TICK_INTERVAL_KEY),
+                   &options.tick_interval_ms)) {
+    OLA_WARN << "Invalid value for " << TICK_INTERVAL_KEY;
+    options.tick_interval_ms = DEFAULT_TICK_INTERVAL_MS;
+  }
+
+  const string role = m_preferences->GetValue(FAILOVER_ROLE_KEY);
+  if (role == ROLE_PRIMARY || role == ROLE_STANDBY) {
+    options.failover = true;
+    options.failover_role = role == ROLE_PRIMARY ? ClusterFailover::PRIMARY :
+                                                   ClusterFailover::STANDBY;
+    if (!StringToInt(m_preferences->GetValue(HEARTBEAT_INTERVAL_KEY),
+                     &options.heartbeat_interval_ms)) {
+      OLA_WARN << "Invalid value for " << HEARTBEAT_INTERVAL_KEY;
+      options.heartbeat_interval_ms = DEFAULT_HEARTBEAT_INTERVAL_MS;
+    }
+    if (options.peers.empty()) {
+      OLA_WARN << "Failover needs a " << PEER_KEY << " to send heartbeats to";
+    }
+  }
+
+  m_device = new ClusterDevice(this, options, m_plugin_adaptor);
+  if (!m_device->Start()) {
+    delete m_device;
+    m_device = NULL;
+    return false;
+  }
+
+  m_plugin_adaptor->RegisterDevice(m_device);
+  return true;
+}
+
+
+/*
+ * Stop the plugin
+ * @return true on success, false on failure
+ */
+bool ClusterPlugin::StopHook() {
+  if (m_device) {
+    m_plugin_adaptor->UnregisterDevice(m_device);
+    bool ret = m_device->Stop();
+    delete m_device;
+    m_device = NULL;
+    return ret;
+  }
+  return true;
+}
+
+
+/*
+ * Return the description for this plugin
+ */
+string ClusterPlugin::Description() const {
+  return plugin_description;
+}
+
+
+/*
+ * Set default preferences
+ */
+bool ClusterPlugin::SetDefaultPreferences() {
+  if (!m_preferences) {
+    return false;
+  }
+
+  bool save = false;
+
+  set<string> valid_roles;
+  valid_roles.insert(ROLE_NONE);
+  valid_roles.insert(ROLE_PRIMARY);
+  valid_roles.insert(ROLE_STANDBY);
+  save |= m_preferences->SetDefaultValue(FAILOVER_ROLE_KEY,
+                                         SetValidator<string>(valid_roles),
+                                         ROLE_NONE);
+
+  save |= m_preferences->SetDefaultValue(
+      HEARTBEAT_INTERVAL_KEY,
+      UIntValidator(10, 10000),
+      DEFAULT_HEARTBEAT_INTERVAL_MS);
+
+  save |= m_preferences->SetDefaultValue(
+      INPUT_PORT_COUNT_KEY,
+      UIntValidator(0, 512),
+      DEFAULT_PORT_COUNT);
+
+  save |= m_preferences->SetDefaultValue(IP_KEY, StringValidator(true), "");
+
+  save |= m_preferences->SetDefaultValue(
+      OUTPUT_PORT_COUNT_KEY,
+      UIntValidator(0, 512),
+      DEFAULT_PORT_COUNT);
+
+  save |= m_preferences->SetDefaultValue(
+      PORT_KEY,
+      UIntValidator(1, 65535),
+      static_cast<unsigned int>(ClusterNode::DEFAULT_PORT));
+
+  save |= m_preferences->SetDefaultValue(
+      TICK_INTERVAL_KEY,
+      UIntValidator(1, 1000),
+      DEFAULT_TICK_INTERVAL_MS);
+
+  if (save) {
+    m_preferences->Save();
+  }
+
+  if (m_preferences->GetValue(PORT_KEY).empty()) {
+    return false;
+  }
+  return true;
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::cluster::ClusterPlugin)
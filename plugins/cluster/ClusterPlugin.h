@@ -0,0 +1,73 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterPlugin.h
+ * Interface for the Cluster plugin class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERPLUGIN_H_
+#define PLUGINS_CLUSTER_CLUSTERPLUGIN_H_
+
+#include <string>
+#include "olad/Plugin.h"
+#include "ola/plugin_id.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+class ClusterDevice;
+
+class ClusterPlugin: public Plugin {
+ public:
+  explicit ClusterPlugin(PluginAdaptor *plugin_adaptor)
+      : Plugin(plugin_adaptor),
+        m_device(NULL) {}
+  ~ClusterPlugin() {}
+
+  std::string Name() const { return PLUGIN_NAME; }
+  ola_plugin_id Id() const { return OLA_PLUGIN_CLUSTER; }
+  std::string Description() const;
+  std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+
+ private:
+  bool StartHook();
+  bool StopHook();
+  bool SetDefaultPreferences();
+
+  ClusterDevice *m_device;
+
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+  static const char FAILOVER_ROLE_KEY[];
+  static const char HEARTBEAT_INTERVAL_KEY[];
+  static const char INPUT_PORT_COUNT_KEY[];
+  static const char IP_KEY[];
+  static const char OUTPUT_PORT_COUNT_KEY[];
+  static const char PEER_KEY[];
+  static const char PORT_KEY[];
+  static const char TICK_INTERVAL_KEY[];
+  static const char ROLE_NONE[];
+  static const char ROLE_PRIMARY[];
+  static const char ROLE_STANDBY[];
+  static const unsigned int DEFAULT_HEARTBEAT_INTERVAL_MS;
+  static const unsigned int DEFAULT_PORT_COUNT;
+  static const unsigned int DEFAULT_TICK_INTERVAL_MS;
+};
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERPLUGIN_H_
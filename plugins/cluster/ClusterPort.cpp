@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterPort.cpp
+ * The Cluster plugin for ola
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "olad/Universe.h"
+#include "plugins/cluster/ClusterDevice.h"
+#include "plugins/cluster/ClusterPort.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+using std::string;
+using std::vector;
+
+namespace {
+/*
+ * Check the universe isn't patched to a port of the other direction, which
+ * would loop the data back to the peers.
+ */
+template <typename PortClass>
+bool CheckForLoop(const vector<PortClass*> &ports,
+                  const Universe *new_universe) {
+  if (!new_universe) {
+    return true;
+  }
+  typename vector<PortClass*>::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    if ((*iter)->GetUniverse() == new_universe) {
+      OLA_WARN << "Avoiding possible cluster loop on universe "
+               << new_universe->UniverseId();
+      return false;
+    }
+  }
+  return true;
+}
+
+string PortDescription(const Universe *universe) {
+  std::ostringstream str;
+  if (universe) {
+    str << "Cluster Universe " << universe->UniverseId();
+  }
+  return str.str();
+}
+}  // namespace
+
+string ClusterInputPort::Description() const {
+  return PortDescription(GetUniverse());
+}
+
+bool ClusterInputPort::PreSetUniverse(OLA_UNUSED Universe *old_universe,
+                                      Universe *new_universe) {
+  vector<OutputPort*> ports;
+  GetDevice()->OutputPorts(&ports);
+  return CheckForLoop(ports, new_universe);
+}
+
+void ClusterInputPort::PostSetUniverse(Universe *old_universe,
+                                       Universe *new_universe) {
+  if (old_universe) {
+    m_node->RemoveHandler(old_universe->UniverseId());
+  }
+
+  if (new_universe) {
+    m_node->SetHandler(
+        new_universe->UniverseId(),
+        &m_buffer,
+        &m_priority,
+        NewCallback<ClusterInputPort, void>(this,
+                                            &ClusterInputPort::DmxChanged));
+  }
+}
+
+
+string ClusterOutputPort::Description() const {
+  return PortDescription(GetUniverse());
+}
+
+bool ClusterOutputPort::PreSetUniverse(OLA_UNUSED Universe *old_universe,
+                                       Universe *new_universe) {
+  vector<InputPort*> ports;
+  GetDevice()->InputPorts(&ports);
+  return CheckForLoop(ports, new_universe);
+}
+
+bool ClusterOutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+  Universe *universe = GetUniverse();
+  if (!universe) {
+    return false;
+  }
+  return m_node->SendDMX(
+      universe->UniverseId(), buffer,
+      GetPriorityMode() == PRIORITY_MODE_STATIC ? GetPriority() : priority);
+}
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
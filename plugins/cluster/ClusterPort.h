@@ -0,0 +1,89 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ClusterPort.h
+ * The Cluster plugin for ola
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_CLUSTER_CLUSTERPORT_H_
+#define PLUGINS_CLUSTER_CLUSTERPORT_H_
+
+#include <string>
+#include "ola/dmx/SourcePriorities.h"
+#include "olad/Port.h"
+#include "plugins/cluster/ClusterDevice.h"
+#include "plugins/cluster/ClusterNode.h"
+
+namespace ola {
+namespace plugin {
+namespace cluster {
+
+/*
+ * Receives a universe from the other nodes. The universe on each node is
+ * matched by id, and the data keeps the priority it had on the sending
+ * node.
+ */
+class ClusterInputPort: public BasicInputPort {
+ public:
+  ClusterInputPort(ClusterDevice *parent,
+                   unsigned int id,
+                   class PluginAdaptor *plugin_adaptor,
+                   ClusterNode *node)
+      : BasicInputPort(parent, id, plugin_adaptor),
+        m_node(node),
+        m_priority(ola::dmx::SOURCE_PRIORITY_DEFAULT) {
+    SetPriorityMode(PRIORITY_MODE_INHERIT);
+  }
+  ~ClusterInputPort() {}
+
+  std::string Description() const;
+  const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
+  bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
+  void PostSetUniverse(Universe *old_universe, Universe *new_universe);
+  bool SupportsPriorities() const { return true; }
+  uint8_t InheritedPriority() const { return m_priority; }
+
+ private:
+  DmxBuffer m_buffer;
+  ClusterNode *m_node;
+  uint8_t m_priority;
+};
+
+
+/*
+ * Sends a universe to the other nodes.
+ */
+class ClusterOutputPort: public BasicOutputPort {
+ public:
+  ClusterOutputPort(ClusterDevice *parent,
+                    unsigned int id,
+                    ClusterNode *node)
+      : BasicOutputPort(parent, id),
+        m_node(node) {}
+  ~ClusterOutputPort() {}
+
+  std::string Description() const;
+  bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
+  bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
+  bool SupportsPriorities() const { return true; }
+
+ private:
+  ClusterNode *m_node;
+};
+}  // namespace cluster
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_CLUSTER_CLUSTERPORT_H_
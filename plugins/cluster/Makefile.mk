@@ -0,0 +1,43 @@
+# LIBRARIES
+##################################################
+if USE_CLUSTER
+lib_LTLIBRARIES += plugins/cluster/libolacluster.la
+
+# Plugin description is generated from README.md
+built_sources += plugins/cluster/ClusterPluginDescription.h
+nodist_plugins_cluster_libolacluster_la_SOURCES = \
+    plugins/cluster/ClusterPluginDescription.h
+plugins/cluster/ClusterPluginDescription.h: plugins/cluster/README.md plugins/cluster/Makefile.mk plugins/convert_README_to_header.sh
+	sh $(top_srcdir)/plugins/convert_README_to_header.sh $(top_srcdir)/plugins/cluster $(top_builddir)/plugins/cluster/ClusterPluginDescription.h
+
+plugins_cluster_libolacluster_la_SOURCES = \
+    plugins/cluster/ClusterPlugin.cpp \
+    plugins/cluster/ClusterDevice.cpp \
+    plugins/cluster/ClusterPort.cpp \
+    plugins/cluster/ClusterNode.cpp \
+    plugins/cluster/ClusterFailover.cpp \
+    plugins/cluster/ClusterPlugin.h \
+    plugins/cluster/ClusterDevice.h \
+    plugins/cluster/ClusterPort.h \
+    plugins/cluster/ClusterPackets.h \
+    plugins/cluster/ClusterNode.h \
+    plugins/cluster/ClusterFailover.h
+plugins_cluster_libolacluster_la_LIBADD = \
+    common/libolacommon.la \
+    olad/plugin_api/libolaserverplugininterface.la
+
+# TESTS
+##################################################
+test_programs += plugins/cluster/ClusterTester
+
+plugins_cluster_ClusterTester_SOURCES = \
+    plugins/cluster/ClusterNode.cpp \
+    plugins/cluster/ClusterNodeTest.cpp \
+    plugins/cluster/ClusterFailover.cpp \
+    plugins/cluster/ClusterFailoverTest.cpp
+plugins_cluster_ClusterTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_cluster_ClusterTester_LDADD = $(COMMON_TESTING_LIBS) \
+                                      common/libolacommon.la
+endif
+
+EXTRA_DIST += plugins/cluster/README.md
@@ -37,6 +37,7 @@
 #include "ola/StringUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 
 #include "plugins/dmx4linux/Dmx4LinuxDevice.h"
 #include "plugins/dmx4linux/Dmx4LinuxPlugin.h"
@@ -299,3 +300,5 @@ bool Dmx4LinuxPlugin::SetupDevices() {
 }  // namespace dmx4linux
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::dmx4linux::Dmx4LinuxPlugin)
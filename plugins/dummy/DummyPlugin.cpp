@@ -20,20 +20,26 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <set>
 #include <string>
 
+#include "ola/Constants.h"
+#include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/dummy/DummyDevice.h"
 #include "plugins/dummy/DummyPort.h"
 #include "plugins/dummy/DummyPlugin.h"
 #include "plugins/dummy/DummyPluginDescription.h"
+#include "plugins/dummy/LoadGenerator.h"
 
 namespace ola {
 namespace plugin {
 namespace dummy {
 
+using std::set;
 using std::string;
 
 const char DummyPlugin::ACK_TIMER_COUNT_KEY[] = "ack_timer_count";
@@ -46,11 +52,25 @@ const char DummyPlugin::DEVICE_NAME[] = "Dummy Device";
 const char DummyPlugin::DIMMER_COUNT_KEY[] = "dimmer_count";
 const char DummyPlugin::DIMMER_SUBDEVICE_COUNT_KEY[] = "dimmer_subdevice_count";
 const char DummyPlugin::DUMMY_DEVICE_COUNT_KEY[] = "dummy_device_count";
+const unsigned int DummyPlugin::DEFAULT_LOAD_FRAME_RATE = 40;
+const char DummyPlugin::LOAD_FRAME_RATE_KEY[] = "load_frame_rate";
+const char DummyPlugin::LOAD_OUTPUT_COUNT_KEY[] = "load_output_count";
+const char DummyPlugin::LOAD_PATTERN_KEY[] = "load_pattern";
+const char DummyPlugin::LOAD_SLOT_COUNT_KEY[] = "load_slot_count";
+const char DummyPlugin::LOAD_UNIVERSE_COUNT_KEY[] = "load_universe_count";
 const char DummyPlugin::MOVING_LIGHT_COUNT_KEY[] = "moving_light_count";
 const char DummyPlugin::NETWORK_COUNT_KEY[] = "network_device_count";
 const char DummyPlugin::PLUGIN_NAME[] = "Dummy";
 const char DummyPlugin::PLUGIN_PREFIX[] = "dummy";
 const char DummyPlugin::SENSOR_COUNT_KEY[] = "sensor_device_count";
+const char DummyPlugin::SIMULATED_ACK_TIMER_KEY[] =
+    "simulated_ack_timer_percent";
+const char DummyPlugin::SIMULATED_COUNT_KEY[] = "simulated_responder_count";
+const char DummyPlugin::SIMULATED_DUB_CORRUPTION_KEY[] =
+    "simulated_dub_corruption_percent";
+const char DummyPlugin::SIMULATED_LATENCY_KEY[] = "simulated_reply_latency_ms";
+const char DummyPlugin::SIMULATED_QUEUED_MESSAGE_KEY[] =
+    "simulated_queued_message_percent";
 
 /*
  * Start the plugin
@@ -100,6 +120,33 @@ bool DummyPlugin::StartHook() {
     options.number_of_network_responders = DEFAULT_DEVICE_COUNT;
   }
 
+  SimulatedResponderPool::Options *simulated = &options.simulated_responders;
+  if (!StringToInt(m_preferences->GetValue(SIMULATED_COUNT_KEY),
+                   &simulated->count)) {
+    simulated->count = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(SIMULATED_LATENCY_KEY),
+                   &simulated->reply_latency_ms)) {
+    simulated->reply_latency_ms = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(SIMULATED_ACK_TIMER_KEY),
+                   &simulated->ack_timer_percent)) {
+    simulated->ack_timer_percent = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(SIMULATED_QUEUED_MESSAGE_KEY),
+                   &simulated->queued_message_percent)) {
+    simulated->queued_message_percent = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(SIMULATED_DUB_CORRUPTION_KEY),
+                   &simulated->dub_corruption_percent)) {
+    simulated->dub_corruption_percent = 0;
+  }
+  options.scheduler = m_plugin_adaptor;
+
   std::auto_ptr<DummyDevice> device(
       new DummyDevice(this, DEVICE_NAME, options));
   if (!device->Start()) {
@@ -107,6 +154,10 @@ bool DummyPlugin::StartHook() {
   }
   m_device = device.release();
   m_plugin_adaptor->RegisterDevice(m_device);
+
+  if (!StartLoadGenerator()) {
+    OLA_WARN << "Failed to start the dummy load generator";
+  }
   return true;
 }
 
@@ -116,12 +167,64 @@ bool DummyPlugin::StartHook() {
  * @return true on success, false on failure
  */
 bool DummyPlugin::StopHook() {
+  bool ret = true;
+  if (m_load_device) {
+    m_plugin_adaptor->UnregisterDevice(m_load_device);
+    ret &= m_load_device->Stop();
+    delete m_load_device;
+    m_load_device = NULL;
+  }
   if (m_device) {
     m_plugin_adaptor->UnregisterDevice(m_device);
-    bool ret = m_device->Stop();
+    ret &= m_device->Stop();
     delete m_device;
-    return ret;
+    m_device = NULL;
+  }
+  return ret;
+}
+
+
+/*
+ * Start the load generator device, if any load ports are configured.
+ */
+bool DummyPlugin::StartLoadGenerator() {
+  LoadGeneratorDevice::Options options;
+  if (!StringToInt(m_preferences->GetValue(LOAD_UNIVERSE_COUNT_KEY),
+                   &options.input_count)) {
+    options.input_count = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(LOAD_OUTPUT_COUNT_KEY),
+                   &options.output_count)) {
+    options.output_count = 0;
+  }
+
+  if (!options.input_count && !options.output_count) {
+    return true;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(LOAD_FRAME_RATE_KEY),
+                   &options.frame_rate) || !options.frame_rate) {
+    options.frame_rate = DEFAULT_LOAD_FRAME_RATE;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(LOAD_SLOT_COUNT_KEY),
+                   &options.slot_count)) {
+    options.slot_count = DMX_UNIVERSE_SIZE;
+  }
+
+  if (!PatternGenerator::PatternFromName(
+        m_preferences->GetValue(LOAD_PATTERN_KEY), &options.pattern)) {
+    options.pattern = PatternGenerator::PATTERN_RAMP;
+  }
+
+  std::auto_ptr<LoadGeneratorDevice> device(
+      new LoadGeneratorDevice(this, m_plugin_adaptor, options));
+  if (!device->Start()) {
+    return false;
   }
+  m_load_device = device.release();
+  m_plugin_adaptor->RegisterDevice(m_load_device);
   return true;
 }
 
@@ -173,6 +276,51 @@ bool DummyPlugin::SetDefaultPreferences() {
                                          IntValidator(0, 254),
                                          DEFAULT_DEVICE_COUNT);
 
+  save |= m_preferences->SetDefaultValue(SIMULATED_COUNT_KEY,
+                                         UIntValidator(0, 65535),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(SIMULATED_LATENCY_KEY,
+                                         UIntValidator(0, 10000),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(SIMULATED_ACK_TIMER_KEY,
+                                         UIntValidator(0, 100),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(SIMULATED_QUEUED_MESSAGE_KEY,
+                                         UIntValidator(0, 100),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(SIMULATED_DUB_CORRUPTION_KEY,
+                                         UIntValidator(0, 100),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(LOAD_UNIVERSE_COUNT_KEY,
+                                         UIntValidator(0, 4096),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(LOAD_OUTPUT_COUNT_KEY,
+                                         UIntValidator(0, 4096),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(LOAD_FRAME_RATE_KEY,
+                                         UIntValidator(1, 1000),
+                                         DEFAULT_LOAD_FRAME_RATE);
+
+  save |= m_preferences->SetDefaultValue(LOAD_SLOT_COUNT_KEY,
+                                         UIntValidator(1, DMX_UNIVERSE_SIZE),
+                                         DMX_UNIVERSE_SIZE);
+
+  set<string> patterns;
+  patterns.insert(PatternGenerator::STATIC_NAME);
+  patterns.insert(PatternGenerator::RAMP_NAME);
+  patterns.insert(PatternGenerator::RANDOM_NAME);
+  patterns.insert(PatternGenerator::NOISE_NAME);
+  save |= m_preferences->SetDefaultValue(LOAD_PATTERN_KEY,
+                                         SetValidator<string>(patterns),
+                                         PatternGenerator::RAMP_NAME);
+
   if (save) {
     m_preferences->Save();
   }
@@ -182,3 +330,5 @@ bool DummyPlugin::SetDefaultPreferences() {
 }  // namespace dummy
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::dummy::DummyPlugin)
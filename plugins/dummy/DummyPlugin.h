@@ -31,12 +31,14 @@ namespace plugin {
 namespace dummy {
 
 class DummyDevice;
+class LoadGeneratorDevice;
 
 class DummyPlugin: public Plugin {
  public:
     explicit DummyPlugin(PluginAdaptor *plugin_adaptor):
       Plugin(plugin_adaptor),
-      m_device(NULL) {}
+      m_device(NULL),
+      m_load_device(NULL) {}
 
     std::string Name() const { return PLUGIN_NAME; }
     std::string Description() const;
@@ -49,6 +51,10 @@ class DummyPlugin: public Plugin {
     bool SetDefaultPreferences();
 
     DummyDevice *m_device;  // the dummy device
+    LoadGeneratorDevice *m_load_device;  // NULL if not enabled
+
+    bool StartLoadGenerator();
+
     static const char ACK_TIMER_COUNT_KEY[];
     static const char ADVANCED_DIMMER_KEY[];
     static const uint8_t DEFAULT_DEVICE_COUNT;
@@ -58,11 +64,22 @@ class DummyPlugin: public Plugin {
     static const char DIMMER_COUNT_KEY[];
     static const char DIMMER_SUBDEVICE_COUNT_KEY[];
     static const char DUMMY_DEVICE_COUNT_KEY[];
+    static const unsigned int DEFAULT_LOAD_FRAME_RATE;
+    static const char LOAD_FRAME_RATE_KEY[];
+    static const char LOAD_OUTPUT_COUNT_KEY[];
+    static const char LOAD_PATTERN_KEY[];
+    static const char LOAD_SLOT_COUNT_KEY[];
+    static const char LOAD_UNIVERSE_COUNT_KEY[];
     static const char MOVING_LIGHT_COUNT_KEY[];
     static const char NETWORK_COUNT_KEY[];
     static const char PLUGIN_NAME[];
     static const char PLUGIN_PREFIX[];
     static const char SENSOR_COUNT_KEY[];
+    static const char SIMULATED_ACK_TIMER_KEY[];
+    static const char SIMULATED_COUNT_KEY[];
+    static const char SIMULATED_DUB_CORRUPTION_KEY[];
+    static const char SIMULATED_LATENCY_KEY[];
+    static const char SIMULATED_QUEUED_MESSAGE_KEY[];
     static const char SUBDEVICE_COUNT_KEY[];
 };
 }  // namespace dummy
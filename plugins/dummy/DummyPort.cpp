@@ -107,6 +107,14 @@ DummyPort::DummyPort(DummyDevice *parent,
       &m_responders, &allocator, options.number_of_sensor_responders);
   AddResponders<ola::rdm::NetworkResponder>(
       &m_responders, &allocator, options.number_of_network_responders);
+
+  if (options.simulated_responders.count) {
+    m_simulated_responders.reset(new SimulatedResponderPool(
+        UID(OPEN_LIGHTING_ESTA_CODE, DummyPort::kSimulatedStartAddress),
+        options.simulated_responders, options.scheduler));
+    m_discovery_agent.reset(
+        new ola::rdm::DiscoveryAgent(m_simulated_responders.get()));
+  }
 }
 
 
@@ -125,11 +133,21 @@ bool DummyPort::WriteDMX(const DmxBuffer &buffer,
 }
 
 void DummyPort::RunFullDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  if (m_discovery_agent.get()) {
+    m_discovery_agent->StartFullDiscovery(NewSingleCallback(
+        this, &DummyPort::SimulatedDiscoveryComplete, callback));
+  } else {
+    RunDiscovery(callback);
+  }
 }
 
 void DummyPort::RunIncrementalDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  if (m_discovery_agent.get()) {
+    m_discovery_agent->StartIncrementalDiscovery(NewSingleCallback(
+        this, &DummyPort::SimulatedDiscoveryComplete, callback));
+  } else {
+    RunDiscovery(callback);
+  }
 }
 
 void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
@@ -138,11 +156,14 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
 
   UID dest = request->DestinationUID();
   if (dest.IsBroadcast()) {
-    if (m_responders.empty()) {
+    // The simulated responders reply as one.
+    unsigned int expected_count = (
+        m_responders.size() + (m_simulated_responders.get() ? 1 : 0));
+    if (expected_count == 0) {
       RunRDMCallback(callback, ola::rdm::RDM_WAS_BROADCAST);
     } else {
       broadcast_request_tracker *tracker = new broadcast_request_tracker;
-      tracker->expected_count = m_responders.size();
+      tracker->expected_count = expected_count;
       tracker->current_count = 0;
       tracker->failed = false;
       tracker->callback = callback;
@@ -152,7 +173,15 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
           request->Duplicate(),
           NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
       }
+      if (m_simulated_responders.get()) {
+        m_simulated_responders->SendRDMRequest(
+          request.release(),
+          NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
+      }
     }
+  } else if (m_simulated_responders.get() &&
+             m_simulated_responders->Contains(dest)) {
+    m_simulated_responders->SendRDMRequest(request.release(), callback);
   } else {
     ola::rdm::RDMControllerInterface *controller = STLFindOrNull(
         m_responders, dest);
@@ -175,6 +204,25 @@ void DummyPort::RunDiscovery(RDMDiscoveryCallback *callback) {
 }
 
 
+/*
+ * Called when the DiscoveryAgent has found the simulated responders, the
+ * other responders are added directly.
+ */
+void DummyPort::SimulatedDiscoveryComplete(RDMDiscoveryCallback *callback,
+                                           bool ok,
+                                           const ola::rdm::UIDSet &uids) {
+  if (!ok) {
+    OLA_WARN << "Discovery of the simulated responders failed";
+  }
+  ola::rdm::UIDSet uid_set(uids);
+  for (ResponderMap::iterator i = m_responders.begin();
+    i != m_responders.end(); i++) {
+    uid_set.AddUID(i->first);
+  }
+  callback->Run(uid_set);
+}
+
+
 void DummyPort::HandleBroadcastAck(broadcast_request_tracker *tracker,
                                    ola::rdm::RDMReply *reply) {
   tracker->current_count++;
@@ -194,6 +242,8 @@ void DummyPort::HandleBroadcastAck(broadcast_request_tracker *tracker,
 
 
 DummyPort::~DummyPort() {
+  m_discovery_agent.reset();
+  m_simulated_responders.reset();
   STLDeleteValues(&m_responders);
 }
 }  // namespace dummy
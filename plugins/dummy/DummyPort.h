@@ -24,13 +24,18 @@
 #include <stdint.h>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Port.h"
+#include "plugins/dummy/SimulatedResponders.h"
 
 namespace ola {
 namespace plugin {
@@ -48,7 +53,8 @@ class DummyPort: public BasicOutputPort {
           number_of_ack_timer_responders(0),
           number_of_advanced_dimmers(1),
           number_of_sensor_responders(1),
-          number_of_network_responders(1) {
+          number_of_network_responders(1),
+          scheduler(NULL) {
     }
 
     uint8_t number_of_dimmers;
@@ -59,6 +65,10 @@ class DummyPort: public BasicOutputPort {
     uint8_t number_of_advanced_dimmers;
     uint8_t number_of_sensor_responders;
     uint8_t number_of_network_responders;
+    // Simulated responders are found with DUB, rather than directly.
+    SimulatedResponderPool::Options simulated_responders;
+    // Used to delay the replies from simulated responders.
+    ola::thread::SchedulerInterface *scheduler;
   };
 
 
@@ -97,14 +107,21 @@ class DummyPort: public BasicOutputPort {
 
   DmxBuffer m_buffer;
   ResponderMap m_responders;
+  std::auto_ptr<SimulatedResponderPool> m_simulated_responders;
+  std::auto_ptr<ola::rdm::DiscoveryAgent> m_discovery_agent;
 
   void RunDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+  void SimulatedDiscoveryComplete(ola::rdm::RDMDiscoveryCallback *callback,
+                                  bool ok,
+                                  const ola::rdm::UIDSet &uids);
   void HandleBroadcastAck(broadcast_request_tracker *tracker,
                           ola::rdm::RDMReply *reply);
 
   // See https://wiki.openlighting.org/index.php/Open_Lighting_Allocations
   // Do not change.
   static const unsigned int kStartAddress = 0xffffff00;
+  // The simulated responders are below the range above.
+  static const unsigned int kSimulatedStartAddress = 0xfffe0000;
 };
 }  // namespace dummy
 }  // namespace plugin
@@ -80,6 +80,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testParamDescription);
   CPPUNIT_TEST(testOlaManufacturerPidCodeVersion);
   CPPUNIT_TEST(testSlotInfo);
+  CPPUNIT_TEST(testSimulatedResponders);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -109,6 +110,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   void testParamDescription();
   void testOlaManufacturerPidCodeVersion();
   void testSlotInfo();
+  void testSimulatedResponders();
 
  private:
   UID m_expected_uid;
@@ -117,8 +119,13 @@ class DummyPortTest: public CppUnit::TestFixture {
   ola::rdm::RDMStatusCode m_expected_code;
   const RDMResponse *m_expected_response;
   bool m_got_uids;
+  UIDSet m_uids;
 
   void VerifyUIDs(const UIDSet &uids);
+  void StoreUIDs(const UIDSet &uids) {
+    m_uids = uids;
+    m_got_uids = true;
+  }
   void checkSubDeviceOutOfRange(uint16_t pid);
   void checkSubDeviceOutOfRange(ola::rdm::rdm_pid pid) {
     checkSubDeviceOutOfRange(static_cast<uint16_t>(pid));
@@ -790,6 +797,58 @@ void DummyPortTest::testSlotInfo() {
 }
 
 
+/*
+ * Check that the simulated responders are discovered and can be addressed.
+ */
+void DummyPortTest::testSimulatedResponders() {
+  DummyPort::Options options;
+  options.simulated_responders.count = 20;
+  DummyPort port(NULL, options, 0);
+
+  port.RunFullDiscovery(NewSingleCallback(this, &DummyPortTest::StoreUIDs));
+  OLA_ASSERT(m_got_uids);
+  OLA_ASSERT_EQ(26u, m_uids.Size());
+  UID simulated_uid(OPEN_LIGHTING_ESTA_CODE, 0xfffe0000 + 19);
+  OLA_ASSERT_TRUE(m_uids.Contains(simulated_uid));
+  OLA_ASSERT_TRUE(m_uids.Contains(m_expected_uid));
+
+  uint8_t identify = 1;
+  RDMRequest *request = new RDMSetRequest(
+      m_test_source,
+      UID::AllDevices(),
+      0,  // transaction #
+      1,  // port id
+      0,  // sub device
+      ola::rdm::PID_IDENTIFY_DEVICE,  // param id
+      &identify,  // data
+      sizeof(identify));  // data length
+
+  SetExpectedResponse(ola::rdm::RDM_WAS_BROADCAST, NULL);
+  port.SendRDMRequest(
+      request,
+      NewSingleCallback(this, &DummyPortTest::HandleRDMResponse));
+  Verify();
+
+  request = new RDMGetRequest(
+      m_test_source,
+      simulated_uid,
+      0,  // transaction #
+      1,  // port id
+      0,  // sub device
+      ola::rdm::PID_IDENTIFY_DEVICE,  // param id
+      NULL,  // data
+      0);  // data length
+
+  RDMResponse *response = GetResponseFromData(request, &identify,
+                                              sizeof(identify));
+  SetExpectedResponse(ola::rdm::RDM_COMPLETED_OK, response);
+  port.SendRDMRequest(
+      request,
+      NewSingleCallback(this, &DummyPortTest::HandleRDMResponse));
+  Verify();
+}
+
+
 void DummyPortTest::VerifyUIDs(const UIDSet &uids) {
   UIDSet expected_uids;
   for (unsigned int i = 0; i < 6; i++) {
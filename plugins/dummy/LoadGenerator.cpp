@@ -0,0 +1,194 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LoadGenerator.cpp
+ * Synthetic DMX sources and sinks for capacity testing.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "olad/PluginAdaptor.h"
+#include "plugins/dummy/LoadGenerator.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using std::string;
+using std::vector;
+
+const char PatternGenerator::STATIC_NAME[] = "static";
+const char PatternGenerator::RAMP_NAME[] = "ramp";
+const char PatternGenerator::RANDOM_NAME[] = "random";
+const char PatternGenerator::NOISE_NAME[] = "noise";
+
+PatternGenerator::PatternGenerator(Pattern pattern,
+                                   unsigned int slot_count,
+                                   uint32_t seed)
+    : m_pattern(pattern),
+      m_slot_count(std::min(slot_count,
+                            static_cast<unsigned int>(DMX_UNIVERSE_SIZE))),
+      m_state(seed * 2654435761u + 1) {
+  if (!m_state) {
+    m_state = 1;
+  }
+  for (unsigned int i = 0; i < m_slot_count; i++) {
+    m_frame[i] = static_cast<uint8_t>(i + seed);
+  }
+}
+
+void PatternGenerator::NextFrame(DmxBuffer *buffer) {
+  switch (m_pattern) {
+    case PATTERN_STATIC:
+      break;
+    case PATTERN_RAMP:
+      for (unsigned int i = 0; i < m_slot_count; i++) {
+        m_frame[i]++;
+      }
+      break;
+    case PATTERN_RANDOM:
+      for (unsigned int i = 0; i < m_slot_count; i++) {
+        m_frame[i] = static_cast<uint8_t>(NextRandom() >> 24);
+      }
+      break;
+    case PATTERN_NOISE:
+      for (unsigned int i = 0; i < m_slot_count; i++) {
+        uint32_t value = NextRandom();
+        if ((value & 0x7) == 0) {
+          m_frame[i] = static_cast<uint8_t>(value >> 24);
+        }
+      }
+      break;
+  }
+  buffer->Set(m_frame, m_slot_count);
+}
+
+bool PatternGenerator::PatternFromName(const string &name, Pattern *pattern) {
+  if (name == STATIC_NAME) {
+    *pattern = PATTERN_STATIC;
+  } else if (name == RAMP_NAME) {
+    *pattern = PATTERN_RAMP;
+  } else if (name == RANDOM_NAME) {
+    *pattern = PATTERN_RANDOM;
+  } else if (name == NOISE_NAME) {
+    *pattern = PATTERN_NOISE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/*
+ * xorshift32, this is much cheaper than rand() and the sequence is the same
+ * on every platform.
+ */
+uint32_t PatternGenerator::NextRandom() {
+  m_state ^= m_state << 13;
+  m_state ^= m_state >> 17;
+  m_state ^= m_state << 5;
+  return m_state;
+}
+
+
+LoadInputPort::LoadInputPort(AbstractDevice *parent,
+                             unsigned int id,
+                             const PluginAdaptor *plugin_adaptor,
+                             PatternGenerator::Pattern pattern,
+                             unsigned int slot_count)
+    : BasicInputPort(parent, id, plugin_adaptor),
+      m_generator(pattern, slot_count, id) {
+}
+
+void LoadInputPort::GenerateFrame() {
+  if (!GetUniverse()) {
+    return;
+  }
+  m_generator.NextFrame(&m_buffer);
+  DmxChanged();
+}
+
+
+string BlackHolePort::Description() const {
+  std::ostringstream str;
+  str << "Black Hole, " << m_frames << " frames";
+  return str.str();
+}
+
+
+LoadGeneratorDevice::LoadGeneratorDevice(AbstractPlugin *owner,
+                                         PluginAdaptor *plugin_adaptor,
+                                         const Options &options)
+    : Device(owner, "Dummy Load Generator"),
+      m_plugin_adaptor(plugin_adaptor),
+      m_options(options),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT) {
+}
+
+bool LoadGeneratorDevice::GenerateFrames() {
+  vector<LoadInputPort*>::iterator iter = m_input_ports.begin();
+  for (; iter != m_input_ports.end(); ++iter) {
+    (*iter)->GenerateFrame();
+  }
+  return true;
+}
+
+bool LoadGeneratorDevice::StartHook() {
+  for (unsigned int i = 0; i < m_options.input_count; i++) {
+    LoadInputPort *port = new LoadInputPort(
+        this, i, m_plugin_adaptor, m_options.pattern, m_options.slot_count);
+    if (!AddPort(port)) {
+      delete port;
+      return false;
+    }
+    m_input_ports.push_back(port);
+  }
+
+  for (unsigned int i = 0; i < m_options.output_count; i++) {
+    BlackHolePort *port = new BlackHolePort(this, i);
+    if (!AddPort(port)) {
+      delete port;
+      return false;
+    }
+  }
+
+  if (!m_input_ports.empty() && m_options.frame_rate) {
+    TimeInterval period(static_cast<int64_t>(USEC_IN_SECONDS /
+                                             m_options.frame_rate));
+    m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
+        period,
+        NewCallback(this, &LoadGeneratorDevice::GenerateFrames));
+    OLA_INFO << "Generating " << m_options.frame_rate << " fps on "
+             << m_input_ports.size() << " ports";
+  }
+  return true;
+}
+
+void LoadGeneratorDevice::PrePortStop() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+    m_timeout_id = ola::thread::INVALID_TIMEOUT;
+  }
+  m_input_ports.clear();
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LoadGenerator.h
+ * Synthetic DMX sources and sinks for capacity testing.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_DUMMY_LOADGENERATOR_H_
+#define PLUGINS_DUMMY_LOADGENERATOR_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/Device.h"
+#include "olad/Port.h"
+
+namespace ola {
+
+class AbstractPlugin;
+class PluginAdaptor;
+
+namespace plugin {
+namespace dummy {
+
+/**
+ * @brief Produces a stream of DMX frames.
+ */
+class PatternGenerator {
+ public:
+  enum Pattern {
+    PATTERN_STATIC,  ///< The same frame every time.
+    PATTERN_RAMP,  ///< Every slot steps by one each frame.
+    PATTERN_RANDOM,  ///< Every slot gets a new random value each frame.
+    PATTERN_NOISE,  ///< About one slot in eight gets a random value.
+  };
+
+  /**
+   * @param pattern the pattern to generate.
+   * @param slot_count the number of slots in each frame.
+   * @param seed the seed for the random patterns, and the offset for the
+   *   others. Use a different seed for each universe.
+   */
+  PatternGenerator(Pattern pattern, unsigned int slot_count, uint32_t seed);
+
+  /**
+   * @brief Write the next frame into buffer.
+   */
+  void NextFrame(DmxBuffer *buffer);
+
+  /**
+   * @brief Convert a name to a Pattern.
+   * @returns true if the name was valid.
+   */
+  static bool PatternFromName(const std::string &name, Pattern *pattern);
+
+  static const char STATIC_NAME[];
+  static const char RAMP_NAME[];
+  static const char RANDOM_NAME[];
+  static const char NOISE_NAME[];
+
+ private:
+  const Pattern m_pattern;
+  const unsigned int m_slot_count;
+  uint32_t m_state;
+  uint8_t m_frame[DMX_UNIVERSE_SIZE];
+
+  uint32_t NextRandom();
+
+  DISALLOW_COPY_AND_ASSIGN(PatternGenerator);
+};
+
+
+/**
+ * @brief An input port that produces the frames from a PatternGenerator.
+ */
+class LoadInputPort: public BasicInputPort {
+ public:
+  LoadInputPort(AbstractDevice *parent,
+                unsigned int id,
+                const PluginAdaptor *plugin_adaptor,
+                PatternGenerator::Pattern pattern,
+                unsigned int slot_count);
+
+  std::string Description() const { return "Load Generator"; }
+  const DmxBuffer &ReadDMX() const { return m_buffer; }
+
+  /**
+   * @brief Produce the next frame, if the port is patched.
+   */
+  void GenerateFrame();
+
+ private:
+  PatternGenerator m_generator;
+  DmxBuffer m_buffer;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadInputPort);
+};
+
+
+/**
+ * @brief An output port that counts the frames it's sent and drops them.
+ */
+class BlackHolePort: public BasicOutputPort {
+ public:
+  BlackHolePort(AbstractDevice *parent, unsigned int id)
+      : BasicOutputPort(parent, id),
+        m_frames(0) {
+  }
+
+  bool WriteDMX(const DmxBuffer&, uint8_t) {
+    m_frames++;
+    return true;
+  }
+
+  std::string Description() const;
+
+  uint64_t Frames() const { return m_frames; }
+
+ private:
+  uint64_t m_frames;
+
+  DISALLOW_COPY_AND_ASSIGN(BlackHolePort);
+};
+
+
+/**
+ * @brief A device with LoadInputPorts and BlackHolePorts.
+ *
+ * All the input ports are driven from a single timer.
+ */
+class LoadGeneratorDevice: public Device {
+ public:
+  struct Options {
+    Options()
+        : input_count(0),
+          output_count(0),
+          frame_rate(40),
+          slot_count(DMX_UNIVERSE_SIZE),
+          pattern(PatternGenerator::PATTERN_RAMP) {
+    }
+
+    unsigned int input_count;
+    unsigned int output_count;
+    unsigned int frame_rate;  // frames per second, per input port
+    unsigned int slot_count;
+    PatternGenerator::Pattern pattern;
+  };
+
+  LoadGeneratorDevice(AbstractPlugin *owner,
+                      PluginAdaptor *plugin_adaptor,
+                      const Options &options);
+
+  std::string DeviceId() const { return "2"; }
+
+  /**
+   * @brief Produce one frame on each input port.
+   */
+  bool GenerateFrames();
+
+ protected:
+  bool StartHook();
+  void PrePortStop();
+
+ private:
+  PluginAdaptor *m_plugin_adaptor;
+  const Options m_options;
+  std::vector<LoadInputPort*> m_input_ports;
+  ola::thread::timeout_id m_timeout_id;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadGeneratorDevice);
+};
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DUMMY_LOADGENERATOR_H_
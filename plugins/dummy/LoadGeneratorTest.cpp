@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * LoadGeneratorTest.cpp
+ * Test fixture for the load generator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/dummy/LoadGenerator.h"
+
+using ola::DmxBuffer;
+using ola::plugin::dummy::BlackHolePort;
+using ola::plugin::dummy::PatternGenerator;
+
+class LoadGeneratorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(LoadGeneratorTest);
+  CPPUNIT_TEST(testStaticAndRamp);
+  CPPUNIT_TEST(testRandom);
+  CPPUNIT_TEST(testPatternNames);
+  CPPUNIT_TEST(testBlackHole);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testStaticAndRamp();
+  void testRandom();
+  void testPatternNames();
+  void testBlackHole();
+
+ private:
+  static unsigned int ChangedSlots(const DmxBuffer &a, const DmxBuffer &b);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LoadGeneratorTest);
+
+
+unsigned int LoadGeneratorTest::ChangedSlots(const DmxBuffer &a,
+                                             const DmxBuffer &b) {
+  unsigned int changed = 0;
+  for (unsigned int i = 0; i < a.Size(); i++) {
+    if (a.Get(i) != b.Get(i)) {
+      changed++;
+    }
+  }
+  return changed;
+}
+
+
+/*
+ * Check the static and ramp patterns.
+ */
+void LoadGeneratorTest::testStaticAndRamp() {
+  DmxBuffer first, second;
+  PatternGenerator fixed(PatternGenerator::PATTERN_STATIC, 10, 3);
+  fixed.NextFrame(&first);
+  fixed.NextFrame(&second);
+  OLA_ASSERT_EQ(10u, first.Size());
+  OLA_ASSERT_TRUE(first == second);
+  OLA_ASSERT_EQ((uint8_t) 3, first.Get(0));
+  OLA_ASSERT_EQ((uint8_t) 12, first.Get(9));
+
+  PatternGenerator ramp(PatternGenerator::PATTERN_RAMP, 1000, 0);
+  ramp.NextFrame(&first);
+  ramp.NextFrame(&second);
+  OLA_ASSERT_EQ((unsigned int) ola::DMX_UNIVERSE_SIZE, first.Size());
+  OLA_ASSERT_EQ((uint8_t) 1, first.Get(0));
+  OLA_ASSERT_EQ((uint8_t) 2, second.Get(0));
+  OLA_ASSERT_EQ((uint8_t) 0, first.Get(255));
+  OLA_ASSERT_EQ((uint8_t) 1, second.Get(255));
+}
+
+
+/*
+ * Check the random patterns change the expected number of slots.
+ */
+void LoadGeneratorTest::testRandom() {
+  DmxBuffer first, second;
+  PatternGenerator random(PatternGenerator::PATTERN_RANDOM,
+                          ola::DMX_UNIVERSE_SIZE, 1);
+  random.NextFrame(&first);
+  random.NextFrame(&second);
+  OLA_ASSERT_TRUE(ChangedSlots(first, second) > 400);
+
+  // The same seed produces the same frames.
+  DmxBuffer other;
+  PatternGenerator same(PatternGenerator::PATTERN_RANDOM,
+                        ola::DMX_UNIVERSE_SIZE, 1);
+  same.NextFrame(&other);
+  OLA_ASSERT_TRUE(first == other);
+
+  PatternGenerator noise(PatternGenerator::PATTERN_NOISE,
+                         ola::DMX_UNIVERSE_SIZE, 1);
+  noise.NextFrame(&first);
+  unsigned int total = 0;
+  for (unsigned int i = 0; i < 10; i++) {
+    noise.NextFrame(&second);
+    unsigned int changed = ChangedSlots(first, second);
+    OLA_ASSERT_TRUE(changed < 128);
+    total += changed;
+    first = second;
+  }
+  OLA_ASSERT_TRUE(total > 200);
+}
+
+
+void LoadGeneratorTest::testPatternNames() {
+  PatternGenerator::Pattern pattern = PatternGenerator::PATTERN_STATIC;
+  OLA_ASSERT_TRUE(PatternGenerator::PatternFromName("noise", &pattern));
+  OLA_ASSERT_EQ(PatternGenerator::PATTERN_NOISE, pattern);
+  OLA_ASSERT_TRUE(PatternGenerator::PatternFromName("ramp", &pattern));
+  OLA_ASSERT_EQ(PatternGenerator::PATTERN_RAMP, pattern);
+  OLA_ASSERT_FALSE(PatternGenerator::PatternFromName("sine", &pattern));
+  OLA_ASSERT_EQ(PatternGenerator::PATTERN_RAMP, pattern);
+}
+
+
+/*
+ * Check the black hole port counts frames.
+ */
+void LoadGeneratorTest::testBlackHole() {
+  BlackHolePort port(NULL, 1);
+  DmxBuffer buffer;
+  buffer.Blackout();
+  OLA_ASSERT_EQ(static_cast<uint64_t>(0), port.Frames());
+  OLA_ASSERT_TRUE(port.WriteDMX(buffer, 100));
+  OLA_ASSERT_TRUE(port.WriteDMX(buffer, 100));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(2), port.Frames());
+  OLA_ASSERT_EQ(std::string("Black Hole, 2 frames"), port.Description());
+}
@@ -16,7 +16,11 @@ plugins_dummy_liboladummy_la_SOURCES = \
     plugins/dummy/DummyPlugin.cpp \
     plugins/dummy/DummyPlugin.h \
     plugins/dummy/DummyPort.cpp \
-    plugins/dummy/DummyPort.h
+    plugins/dummy/DummyPort.h \
+    plugins/dummy/LoadGenerator.cpp \
+    plugins/dummy/LoadGenerator.h \
+    plugins/dummy/SimulatedResponders.cpp \
+    plugins/dummy/SimulatedResponders.h
 plugins_dummy_liboladummy_la_LIBADD = \
     common/libolacommon.la \
     olad/plugin_api/libolaserverplugininterface.la
@@ -25,7 +29,10 @@ plugins_dummy_liboladummy_la_LIBADD = \
 ##################################################
 test_programs += plugins/dummy/DummyPluginTester
 
-plugins_dummy_DummyPluginTester_SOURCES = plugins/dummy/DummyPortTest.cpp
+plugins_dummy_DummyPluginTester_SOURCES = \
+    plugins/dummy/DummyPortTest.cpp \
+    plugins/dummy/LoadGeneratorTest.cpp \
+    plugins/dummy/SimulatedResponderPoolTest.cpp
 plugins_dummy_DummyPluginTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 # it's unclear to me why liboladummyresponder has to be included here
 # but if it isn't, the test breaks with gcc 4.6.1
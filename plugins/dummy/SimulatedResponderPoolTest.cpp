@@ -0,0 +1,316 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedResponderPoolTest.cpp
+ * Test fixture for the SimulatedResponderPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/dummy/SimulatedResponders.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using ola::rdm::DiscoveryAgent;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::string;
+
+class SimulatedResponderPoolTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SimulatedResponderPoolTest);
+  CPPUNIT_TEST(testDiscovery);
+  CPPUNIT_TEST(testCorruptDiscovery);
+  CPPUNIT_TEST(testUnknownUID);
+  CPPUNIT_TEST(testAckTimer);
+  CPPUNIT_TEST(testQueuedStatusMessages);
+  CPPUNIT_TEST(testBroadcast);
+  CPPUNIT_TEST(testLatency);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  SimulatedResponderPoolTest()
+      : m_first_uid(0x7a70, 0xfffe0000),
+        m_source(1, 2) {
+  }
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    m_got_uids = false;
+    m_discovery_ok = false;
+    m_uids = UIDSet();
+    m_reply.reset();
+    m_ss = NULL;
+  }
+
+  void testDiscovery();
+  void testCorruptDiscovery();
+  void testUnknownUID();
+  void testAckTimer();
+  void testQueuedStatusMessages();
+  void testBroadcast();
+  void testLatency();
+
+ private:
+  UID m_first_uid;
+  UID m_source;
+  bool m_got_uids;
+  bool m_discovery_ok;
+  UIDSet m_uids;
+  auto_ptr<RDMReply> m_reply;
+  ola::io::SelectServer *m_ss;
+
+  void DiscoveryComplete(bool ok, const UIDSet &uids) {
+    m_got_uids = true;
+    m_discovery_ok = ok;
+    m_uids = uids;
+  }
+
+  void HandleReply(RDMReply *reply) {
+    const ola::rdm::RDMResponse *response = reply->Response();
+    m_reply.reset(new RDMReply(reply->StatusCode(),
+                               response ? response->Duplicate() : NULL));
+    if (m_ss) {
+      m_ss->Terminate();
+    }
+  }
+
+  void Send(SimulatedResponderPool *pool, RDMRequest *request) {
+    m_reply.reset();
+    pool->SendRDMRequest(
+        request,
+        NewSingleCallback(this, &SimulatedResponderPoolTest::HandleReply));
+  }
+
+  RDMRequest *NewGet(const UID &destination, uint16_t pid,
+                     const uint8_t *data = NULL, unsigned int length = 0) {
+    return new RDMGetRequest(m_source, destination, 0, 1,
+                             ola::rdm::ROOT_RDM_DEVICE, pid, data, length);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SimulatedResponderPoolTest);
+
+
+/*
+ * Check that a DiscoveryAgent finds all the responders.
+ */
+void SimulatedResponderPoolTest::testDiscovery() {
+  SimulatedResponderPool::Options options;
+  options.count = 2000;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+  OLA_ASSERT_EQ(2000u, pool.Size());
+
+  UIDSet expected;
+  pool.GetUIDs(&expected);
+  OLA_ASSERT_EQ(2000u, expected.Size());
+  OLA_ASSERT_TRUE(pool.Contains(m_first_uid));
+  OLA_ASSERT_FALSE(pool.Contains(UID(0x7a70, 0xfffe0000 + 2000)));
+
+  DiscoveryAgent agent(&pool);
+  agent.StartFullDiscovery(NewSingleCallback(
+      this, &SimulatedResponderPoolTest::DiscoveryComplete));
+  OLA_ASSERT_TRUE(m_got_uids);
+  OLA_ASSERT_TRUE(m_discovery_ok);
+  OLA_ASSERT_EQ(expected, m_uids);
+
+  // Incremental discovery should find the same set.
+  m_got_uids = false;
+  agent.StartIncrementalDiscovery(NewSingleCallback(
+      this, &SimulatedResponderPoolTest::DiscoveryComplete));
+  OLA_ASSERT_TRUE(m_got_uids);
+  OLA_ASSERT_EQ(expected, m_uids);
+}
+
+
+/*
+ * Check that corrupt DUB replies stop a responder from being found.
+ */
+void SimulatedResponderPoolTest::testCorruptDiscovery() {
+  SimulatedResponderPool::Options options;
+  options.count = 1;
+  options.dub_corruption_percent = 100;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+
+  DiscoveryAgent agent(&pool);
+  agent.StartFullDiscovery(NewSingleCallback(
+      this, &SimulatedResponderPoolTest::DiscoveryComplete));
+  OLA_ASSERT_TRUE(m_got_uids);
+  OLA_ASSERT_FALSE(m_discovery_ok);
+  OLA_ASSERT_EQ(0u, m_uids.Size());
+}
+
+
+/*
+ * Check requests to UIDs that aren't in the pool time out.
+ */
+void SimulatedResponderPoolTest::testUnknownUID() {
+  SimulatedResponderPool::Options options;
+  options.count = 10;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+
+  Send(&pool, NewGet(UID(0x7a70, 0x12345678), ola::rdm::PID_DEVICE_INFO));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_TIMEOUT, m_reply->StatusCode());
+}
+
+
+/*
+ * Check that ACK_TIMER responses can be collected with QUEUED_MESSAGE.
+ */
+void SimulatedResponderPoolTest::testAckTimer() {
+  SimulatedResponderPool::Options options;
+  options.count = 10;
+  options.ack_timer_percent = 100;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_DMX_START_ADDRESS));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_reply->StatusCode());
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK_TIMER),
+                m_reply->Response()->ResponseType());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1),
+                m_reply->Response()->MessageCount());
+
+  uint8_t status_type = ola::rdm::STATUS_GET_LAST_MESSAGE;
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_QUEUED_MESSAGE,
+                     &status_type, sizeof(status_type)));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_reply->Response()->ResponseType());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_DMX_START_ADDRESS),
+                m_reply->Response()->ParamId());
+  OLA_ASSERT_EQ(2u, m_reply->Response()->ParamDataSize());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0),
+                m_reply->Response()->MessageCount());
+
+  // Once the queue is empty, QUEUED_MESSAGE returns STATUS_MESSAGES.
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_QUEUED_MESSAGE,
+                     &status_type, sizeof(status_type)));
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_STATUS_MESSAGES),
+                m_reply->Response()->ParamId());
+  OLA_ASSERT_EQ(0u, m_reply->Response()->ParamDataSize());
+}
+
+
+/*
+ * Check that status messages are queued.
+ */
+void SimulatedResponderPoolTest::testQueuedStatusMessages() {
+  SimulatedResponderPool::Options options;
+  options.count = 10;
+  options.queued_message_percent = 100;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_IDENTIFY_DEVICE));
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_reply->Response()->ResponseType());
+
+  // The message count was set before the message was queued, the next
+  // response has it.
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_DEVICE_INFO));
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1),
+                m_reply->Response()->MessageCount());
+
+  uint8_t status_type = ola::rdm::STATUS_ADVISORY;
+  Send(&pool, NewGet(m_first_uid, ola::rdm::PID_QUEUED_MESSAGE,
+                     &status_type, sizeof(status_type)));
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_STATUS_MESSAGES),
+                m_reply->Response()->ParamId());
+  OLA_ASSERT_EQ(9u, m_reply->Response()->ParamDataSize());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::STATUS_ADVISORY),
+                m_reply->Response()->ParamData()[2]);
+}
+
+
+/*
+ * Check broadcast requests reach every responder.
+ */
+void SimulatedResponderPoolTest::testBroadcast() {
+  SimulatedResponderPool::Options options;
+  options.count = 100;
+  SimulatedResponderPool pool(m_first_uid, options, NULL);
+
+  uint8_t identify = 1;
+  Send(&pool, new RDMSetRequest(m_source, UID::AllDevices(), 0, 1,
+                                ola::rdm::ROOT_RDM_DEVICE,
+                                ola::rdm::PID_IDENTIFY_DEVICE,
+                                &identify, sizeof(identify)));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST, m_reply->StatusCode());
+
+  Send(&pool, NewGet(UID(0x7a70, 0xfffe0000 + 99),
+                     ola::rdm::PID_IDENTIFY_DEVICE));
+  OLA_ASSERT_NOT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(1u, m_reply->Response()->ParamDataSize());
+  OLA_ASSERT_EQ(identify, m_reply->Response()->ParamData()[0]);
+}
+
+
+/*
+ * Check replies are delayed.
+ */
+void SimulatedResponderPoolTest::testLatency() {
+  ola::io::SelectServer ss;
+  m_ss = &ss;
+
+  SimulatedResponderPool::Options options;
+  options.count = 10;
+  options.reply_latency_ms = 10;
+  auto_ptr<SimulatedResponderPool> pool(
+      new SimulatedResponderPool(m_first_uid, options, &ss));
+
+  Send(pool.get(), NewGet(m_first_uid, ola::rdm::PID_DEVICE_INFO));
+  OLA_ASSERT_NULL(m_reply.get());
+  ss.Run();
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_reply->StatusCode());
+
+  // Delayed replies are run if the pool is deleted.
+  Send(pool.get(), NewGet(m_first_uid, ola::rdm::PID_DEVICE_INFO));
+  OLA_ASSERT_NULL(m_reply.get());
+  m_ss = NULL;
+  pool.reset();
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,569 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedResponders.cpp
+ * Lots of lightweight RDM responders, for load testing.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/InlineCallback.h"
+#include "ola/Logging.h"
+#include "ola/math/Random.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/OpenLightingEnums.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/ResponderHelper.h"
+#include "ola/rdm/UIDAllocator.h"
+#include "plugins/dummy/SimulatedResponders.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using ola::network::HostToNetwork;
+using ola::rdm::GetResponseFromData;
+using ola::rdm::GetResponseWithPid;
+using ola::rdm::NackWithReason;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::ResponderHelper;
+using ola::rdm::ResponderOps;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+void RunReply(RDMCallback *callback, RDMReply *reply) {
+  callback->Run(reply);
+  delete reply;
+}
+
+void RunMuteCallback(
+    ola::rdm::DiscoveryTargetInterface::MuteDeviceCallback *callback,
+    bool ok) {
+  callback->Run(ok);
+}
+
+void RunUnMuteCallback(
+    ola::rdm::DiscoveryTargetInterface::UnMuteDeviceCallback *callback) {
+  callback->Run();
+}
+
+void RunBranchCallback(
+    ola::rdm::DiscoveryTargetInterface::BranchCallback *callback,
+    string data) {
+  if (data.empty()) {
+    callback->Run(NULL, 0);
+  } else {
+    callback->Run(reinterpret_cast<const uint8_t*>(data.data()),
+                  data.size());
+  }
+}
+
+void OrAndChecksum(uint8_t *data, unsigned int offset, uint8_t value,
+                   uint16_t *checksum) {
+  data[offset] |= value;
+  *checksum += value;
+}
+
+struct UIDLessThan {
+  bool operator()(const SimulatedResponder &responder, const UID &uid) const {
+    return responder.GetUID() < uid;
+  }
+};
+}  // namespace
+
+SimulatedResponder::RDMOps *SimulatedResponder::RDMOps::instance = NULL;
+
+const ResponderOps<SimulatedResponder>::ParamHandler
+    SimulatedResponder::PARAM_HANDLERS[] = {
+  { ola::rdm::PID_QUEUED_MESSAGE,
+    &SimulatedResponder::GetQueuedMessage,
+    NULL},
+  { ola::rdm::PID_STATUS_MESSAGES,
+    &SimulatedResponder::GetStatusMessages,
+    NULL},
+  { ola::rdm::PID_DEVICE_INFO,
+    &SimulatedResponder::GetDeviceInfo,
+    NULL},
+  { ola::rdm::PID_PRODUCT_DETAIL_ID_LIST,
+    &SimulatedResponder::GetProductDetailList,
+    NULL},
+  { ola::rdm::PID_DEVICE_MODEL_DESCRIPTION,
+    &SimulatedResponder::GetDeviceModelDescription,
+    NULL},
+  { ola::rdm::PID_MANUFACTURER_LABEL,
+    &SimulatedResponder::GetManufacturerLabel,
+    NULL},
+  { ola::rdm::PID_DEVICE_LABEL,
+    &SimulatedResponder::GetDeviceLabel,
+    &SimulatedResponder::SetDeviceLabel},
+  { ola::rdm::PID_SOFTWARE_VERSION_LABEL,
+    &SimulatedResponder::GetSoftwareVersionLabel,
+    NULL},
+  { ola::rdm::PID_DMX_START_ADDRESS,
+    &SimulatedResponder::GetDmxStartAddress,
+    &SimulatedResponder::SetDmxStartAddress},
+  { ola::rdm::PID_IDENTIFY_DEVICE,
+    &SimulatedResponder::GetIdentify,
+    &SimulatedResponder::SetIdentify},
+  { 0, NULL, NULL},
+};
+
+const uint16_t SimulatedResponder::FOOTPRINT;
+
+SimulatedResponder::SimulatedResponder(const UID &uid)
+    : m_uid(uid),
+      m_start_address(1),
+      m_identify_mode(false),
+      m_muted(false) {
+}
+
+void SimulatedResponder::SendRDMRequest(const RDMRequest *request,
+                                        RDMCallback *callback) {
+  RDMOps::Instance()->HandleRDMRequest(this, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                                       request, callback);
+}
+
+void SimulatedResponder::QueueMessage(uint16_t pid,
+                                      RDMCommand::RDMCommandClass command_class,
+                                      const uint8_t *data,
+                                      unsigned int length) {
+  QueuedMessage message;
+  message.pid = pid;
+  message.command_class = command_class;
+  if (data && length) {
+    message.data.assign(reinterpret_cast<const char*>(data), length);
+  }
+  m_queued_messages.push_back(message);
+}
+
+uint8_t SimulatedResponder::QueuedMessageCount() const {
+  return std::min(m_queued_messages.size(),
+                  static_cast<size_t>(ola::rdm::MAX_QUEUED_MESSAGE_COUNT));
+}
+
+RDMResponse *SimulatedResponder::GetDeviceInfo(const RDMRequest *request) {
+  return ResponderHelper::GetDeviceInfo(
+      request, ola::rdm::OLA_DUMMY_DEVICE_MODEL,
+      ola::rdm::PRODUCT_CATEGORY_TEST, 1, FOOTPRINT, 1, 1, m_start_address,
+      0, 0, QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetProductDetailList(
+    const RDMRequest *request) {
+  vector<ola::rdm::rdm_product_detail> product_details;
+  product_details.push_back(ola::rdm::PRODUCT_DETAIL_TEST);
+  return ResponderHelper::GetProductDetailList(request, product_details,
+                                               QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetDeviceModelDescription(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, "Simulated Responder",
+                                    QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetManufacturerLabel(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, ola::rdm::OLA_MANUFACTURER_LABEL,
+                                    QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetSoftwareVersionLabel(
+    const RDMRequest *request) {
+  return ResponderHelper::GetString(request, "Simulated Software Version",
+                                    QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetDeviceLabel(const RDMRequest *request) {
+  return ResponderHelper::GetString(request, m_device_label,
+                                    QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::SetDeviceLabel(const RDMRequest *request) {
+  return ResponderHelper::SetString(request, &m_device_label,
+                                    QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetDmxStartAddress(
+    const RDMRequest *request) {
+  return ResponderHelper::GetUInt16Value(request, m_start_address,
+                                         QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::SetDmxStartAddress(
+    const RDMRequest *request) {
+  uint16_t address;
+  if (!ResponderHelper::ExtractUInt16(request, &address)) {
+    return NackWithReason(request, ola::rdm::NR_FORMAT_ERROR,
+                          QueuedMessageCount());
+  }
+
+  if (address == 0 || address > DMX_UNIVERSE_SIZE + 1 - FOOTPRINT) {
+    return NackWithReason(request, ola::rdm::NR_DATA_OUT_OF_RANGE,
+                          QueuedMessageCount());
+  }
+  m_start_address = address;
+  return ResponderHelper::EmptySetResponse(request, QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetIdentify(const RDMRequest *request) {
+  return ResponderHelper::GetBoolValue(request, m_identify_mode,
+                                       QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::SetIdentify(const RDMRequest *request) {
+  return ResponderHelper::SetBoolValue(request, &m_identify_mode,
+                                       QueuedMessageCount());
+}
+
+RDMResponse *SimulatedResponder::GetQueuedMessage(const RDMRequest *request) {
+  uint8_t status_type;
+  if (!ResponderHelper::ExtractUInt8(request, &status_type)) {
+    return NackWithReason(request, ola::rdm::NR_FORMAT_ERROR,
+                          QueuedMessageCount());
+  }
+
+  if (m_queued_messages.empty()) {
+    return GetResponseWithPid(request, ola::rdm::PID_STATUS_MESSAGES, NULL, 0);
+  }
+
+  QueuedMessage message = m_queued_messages.front();
+  m_queued_messages.erase(m_queued_messages.begin());
+  const uint8_t *data = message.data.empty() ? NULL :
+      reinterpret_cast<const uint8_t*>(message.data.data());
+  if (message.command_class == RDMCommand::SET_COMMAND_RESPONSE) {
+    return new ola::rdm::RDMSetResponse(
+        request->DestinationUID(), request->SourceUID(),
+        request->TransactionNumber(), ola::rdm::RDM_ACK, QueuedMessageCount(),
+        ola::rdm::ROOT_RDM_DEVICE, message.pid, data, message.data.size());
+  }
+  return new ola::rdm::RDMGetResponse(
+      request->DestinationUID(), request->SourceUID(),
+      request->TransactionNumber(), ola::rdm::RDM_ACK, QueuedMessageCount(),
+      ola::rdm::ROOT_RDM_DEVICE, message.pid, data, message.data.size());
+}
+
+RDMResponse *SimulatedResponder::GetStatusMessages(
+    const RDMRequest *request) {
+  // Status messages are only returned via QUEUED_MESSAGE.
+  return ResponderHelper::EmptyGetResponse(request, QueuedMessageCount());
+}
+
+
+const unsigned int SimulatedResponderPool::DUB_RESPONSE_SIZE;
+const uint16_t SimulatedResponderPool::ACK_TIMER_MS;
+
+SimulatedResponderPool::SimulatedResponderPool(
+    const UID &first_uid,
+    const Options &options,
+    ola::thread::SchedulerInterface *scheduler)
+    : m_options(options),
+      m_scheduler(scheduler),
+      m_running_replies(false) {
+  ola::rdm::UIDAllocator allocator(first_uid);
+  m_responders.reserve(options.count);
+  for (unsigned int i = 0; i < options.count; i++) {
+    auto_ptr<UID> uid(allocator.AllocateNext());
+    if (!uid.get()) {
+      OLA_WARN << "Insufficient UIDs to create simulated RDM devices";
+      break;
+    }
+    // The allocator hands out UIDs in order, so this stays sorted.
+    m_responders.push_back(SimulatedResponder(*uid));
+  }
+}
+
+SimulatedResponderPool::~SimulatedResponderPool() {
+  // Anything the callbacks send now is answered immediately.
+  ola::thread::SchedulerInterface *scheduler = m_scheduler;
+  m_scheduler = NULL;
+  while (!m_delayed_replies.empty()) {
+    DelayedReply *reply = *m_delayed_replies.begin();
+    m_delayed_replies.erase(m_delayed_replies.begin());
+    scheduler->RemoveTimeout(reply->timeout);
+    reply->callback->Run();
+    delete reply;
+  }
+
+  while (!m_immediate_replies.empty()) {
+    SingleUseCallback0<void> *callback = m_immediate_replies.front();
+    m_immediate_replies.pop_front();
+    callback->Run();
+  }
+}
+
+bool SimulatedResponderPool::Contains(const UID &uid) const {
+  return std::binary_search(m_responders.begin(), m_responders.end(),
+                            SimulatedResponder(uid));
+}
+
+void SimulatedResponderPool::GetUIDs(UIDSet *uids) const {
+  ResponderList::const_iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    uids->AddUID(iter->GetUID());
+  }
+}
+
+void SimulatedResponderPool::SendRDMRequest(RDMRequest *request_ptr,
+                                            RDMCallback *callback) {
+  auto_ptr<RDMRequest> request(request_ptr);
+  const UID &destination = request->DestinationUID();
+
+  if (destination.IsBroadcast()) {
+    ResponderList::iterator iter = m_responders.begin();
+    for (; iter != m_responders.end(); ++iter) {
+      if (destination.DirectedToUID(iter->GetUID())) {
+        iter->SendRDMRequest(
+            request->Duplicate(),
+            NewSingleCallback(this,
+                              &SimulatedResponderPool::HandleBroadcastReply));
+      }
+    }
+    Reply(NewSingleCallback(&RunReply, callback,
+                            new RDMReply(ola::rdm::RDM_WAS_BROADCAST)));
+    return;
+  }
+
+  SimulatedResponder *responder = Find(destination);
+  if (!responder) {
+    Reply(NewSingleCallback(&RunReply, callback,
+                            new RDMReply(ola::rdm::RDM_TIMEOUT)));
+    return;
+  }
+
+  bool ack_timer = (
+      request->SubDevice() == ola::rdm::ROOT_RDM_DEVICE &&
+      request->ParamId() != ola::rdm::PID_QUEUED_MESSAGE &&
+      (request->CommandClass() == RDMCommand::GET_COMMAND ||
+       request->CommandClass() == RDMCommand::SET_COMMAND) &&
+      Chance(m_options.ack_timer_percent));
+
+  // ResponderOps runs the callback before it deletes the request.
+  const RDMRequest *raw_request = request.release();
+  if (ack_timer) {
+    responder->SendRDMRequest(
+        raw_request,
+        NewSingleCallback(this, &SimulatedResponderPool::HandleAckTimerReply,
+                          responder, raw_request, callback));
+  } else {
+    responder->SendRDMRequest(
+        raw_request,
+        NewSingleCallback(this, &SimulatedResponderPool::HandleReply,
+                          responder, callback));
+  }
+}
+
+void SimulatedResponderPool::MuteDevice(const UID &target,
+                                        MuteDeviceCallback *mute_complete) {
+  SimulatedResponder *responder = Find(target);
+  if (responder) {
+    responder->SetMuted(true);
+  }
+  Reply(NewSingleCallback(&RunMuteCallback, mute_complete, responder != NULL));
+}
+
+void SimulatedResponderPool::UnMuteAll(UnMuteDeviceCallback *unmute_complete) {
+  ResponderList::iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    iter->SetMuted(false);
+  }
+  Reply(NewSingleCallback(&RunUnMuteCallback, unmute_complete));
+}
+
+void SimulatedResponderPool::Branch(const UID &lower,
+                                    const UID &upper,
+                                    BranchCallback *callback) {
+  uint8_t data[DUB_RESPONSE_SIZE];
+  memset(data, 0, sizeof(data));
+
+  // Once two responders have replied, the rest don't change the outcome.
+  unsigned int replies = 0;
+  ResponderList::const_iterator iter = std::lower_bound(
+      m_responders.begin(), m_responders.end(), lower, UIDLessThan());
+  for (; iter != m_responders.end() && !(upper < iter->GetUID()) &&
+         replies < 2; ++iter) {
+    if (!iter->IsMuted()) {
+      FormDUBResponse(iter->GetUID(), data);
+      replies++;
+    }
+  }
+
+  string response;
+  if (replies) {
+    if (replies == 1 && Chance(m_options.dub_corruption_percent)) {
+      // Invert the low byte of the checksum, keeping the encoding valid.
+      uint8_t checksum_low = ~(data[22] & data[23]);
+      data[22] = checksum_low | 0xaa;
+      data[23] = checksum_low | 0x55;
+    }
+    response.assign(reinterpret_cast<char*>(data), sizeof(data));
+  }
+  Reply(NewSingleCallback(&RunBranchCallback, callback, response));
+}
+
+SimulatedResponder *SimulatedResponderPool::Find(const UID &uid) {
+  ResponderList::iterator iter = std::lower_bound(
+      m_responders.begin(), m_responders.end(), uid, UIDLessThan());
+  if (iter == m_responders.end() || iter->GetUID() != uid) {
+    return NULL;
+  }
+  return &(*iter);
+}
+
+void SimulatedResponderPool::HandleReply(SimulatedResponder *responder,
+                                         RDMCallback *callback,
+                                         RDMReply *reply) {
+  const RDMResponse *response = reply->Response();
+  if (response && response->ResponseType() == ola::rdm::RDM_ACK &&
+      Chance(m_options.queued_message_percent)) {
+    // sub device, status type, status message id, data value 1 & 2
+    uint8_t status_message[9];
+    memset(status_message, 0, sizeof(status_message));
+    status_message[2] = ola::rdm::STATUS_ADVISORY;
+    uint16_t message_id = HostToNetwork(
+        static_cast<uint16_t>(ola::rdm::STS_READY));
+    memcpy(status_message + 3, &message_id, sizeof(message_id));
+    responder->QueueMessage(ola::rdm::PID_STATUS_MESSAGES,
+                            RDMCommand::GET_COMMAND_RESPONSE,
+                            status_message, sizeof(status_message));
+  }
+
+  Reply(NewSingleCallback(
+      &RunReply, callback,
+      new RDMReply(reply->StatusCode(),
+                   response ? response->Duplicate() : NULL)));
+}
+
+void SimulatedResponderPool::HandleAckTimerReply(
+    SimulatedResponder *responder,
+    const RDMRequest *request,
+    RDMCallback *callback,
+    RDMReply *reply) {
+  const RDMResponse *response = reply->Response();
+  if (!response || response->ResponseType() != ola::rdm::RDM_ACK) {
+    HandleReply(responder, callback, reply);
+    return;
+  }
+
+  responder->QueueMessage(response->ParamId(), response->CommandClass(),
+                          response->ParamData(), response->ParamDataSize());
+  uint16_t ack_time = HostToNetwork(static_cast<uint16_t>(ACK_TIMER_MS / 100));
+  RDMResponse *ack_timer_response = GetResponseFromData(
+      request, reinterpret_cast<const uint8_t*>(&ack_time), sizeof(ack_time),
+      ola::rdm::RDM_ACK_TIMER, responder->QueuedMessageCount());
+  Reply(NewSingleCallback(
+      &RunReply, callback,
+      new RDMReply(ola::rdm::RDM_COMPLETED_OK, ack_timer_response)));
+}
+
+void SimulatedResponderPool::HandleBroadcastReply(RDMReply*) {}
+
+/*
+ * Run a reply, after the latency if there is one.
+ */
+void SimulatedResponderPool::Reply(SingleUseCallback0<void> *callback) {
+  if (!m_options.reply_latency_ms || !m_scheduler) {
+    m_immediate_replies.push_back(callback);
+    if (m_running_replies) {
+      // Run once the reply that triggered this returns.
+      return;
+    }
+    m_running_replies = true;
+    while (!m_immediate_replies.empty()) {
+      SingleUseCallback0<void> *next = m_immediate_replies.front();
+      m_immediate_replies.pop_front();
+      next->Run();
+    }
+    m_running_replies = false;
+    return;
+  }
+
+  DelayedReply *reply = new DelayedReply();
+  reply->callback = callback;
+  reply->timeout = m_scheduler->RegisterSingleTimeout(
+      TimeInterval(static_cast<int64_t>(m_options.reply_latency_ms) * 1000),
+      MakeInlineCallback(this, &SimulatedResponderPool::RunDelayedReply,
+                         reply));
+  m_delayed_replies.insert(reply);
+}
+
+void SimulatedResponderPool::RunDelayedReply(DelayedReply *reply) {
+  m_delayed_replies.erase(reply);
+  SingleUseCallback0<void> *callback = reply->callback;
+  delete reply;
+  callback->Run();
+}
+
+bool SimulatedResponderPool::Chance(unsigned int percent) const {
+  if (percent == 0) {
+    return false;
+  }
+  return percent >= 100 ||
+      static_cast<unsigned int>(ola::math::Random(1, 100)) <= percent;
+}
+
+/*
+ * OR the DUB response for a UID into data, so that responses from more than
+ * one responder collide the way they would on the line.
+ */
+void SimulatedResponderPool::FormDUBResponse(const UID &uid, uint8_t *data) {
+  uint16_t manufacturer_id = uid.ManufacturerId();
+  uint32_t device_id = uid.DeviceId();
+
+  for (unsigned int i = 0; i < 7; i++) {
+    data[i] |= 0xfe;
+  }
+  data[7] |= 0xaa;
+
+  uint16_t checksum = 0;
+  OrAndChecksum(data, 8, (manufacturer_id >> 8) | 0xaa, &checksum);
+  OrAndChecksum(data, 9, (manufacturer_id >> 8) | 0x55, &checksum);
+  OrAndChecksum(data, 10, manufacturer_id | 0xaa, &checksum);
+  OrAndChecksum(data, 11, manufacturer_id | 0x55, &checksum);
+
+  OrAndChecksum(data, 12, (device_id >> 24) | 0xaa, &checksum);
+  OrAndChecksum(data, 13, (device_id >> 24) | 0x55, &checksum);
+  OrAndChecksum(data, 14, (device_id >> 16) | 0xaa, &checksum);
+  OrAndChecksum(data, 15, (device_id >> 16) | 0x55, &checksum);
+  OrAndChecksum(data, 16, (device_id >> 8) | 0xaa, &checksum);
+  OrAndChecksum(data, 17, (device_id >> 8) | 0x55, &checksum);
+  OrAndChecksum(data, 18, device_id | 0xaa, &checksum);
+  OrAndChecksum(data, 19, device_id | 0x55, &checksum);
+
+  data[20] |= (checksum >> 8) | 0xaa;
+  data[21] |= (checksum >> 8) | 0x55;
+  data[22] |= (checksum & 0xff) | 0xaa;
+  data[23] |= (checksum & 0xff) | 0x55;
+}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
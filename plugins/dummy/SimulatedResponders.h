@@ -0,0 +1,252 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SimulatedResponders.h
+ * Lots of lightweight RDM responders, for load testing.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_DUMMY_SIMULATEDRESPONDERS_H_
+#define PLUGINS_DUMMY_SIMULATEDRESPONDERS_H_
+
+#include <stdint.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+/**
+ * @brief The state of one simulated responder.
+ *
+ * Unlike the responders in ola/rdm, this holds only the values that can
+ * change; everything else, including the PID handlers, is shared between all
+ * the simulated responders. This keeps the cost of a responder to a few dozen
+ * bytes, so a port can have thousands of them.
+ */
+class SimulatedResponder {
+ public:
+  explicit SimulatedResponder(const ola::rdm::UID &uid);
+
+  const ola::rdm::UID &GetUID() const { return m_uid; }
+
+  bool IsMuted() const { return m_muted; }
+  void SetMuted(bool muted) { m_muted = muted; }
+
+  /**
+   * @brief Handle a request, calls ResponderOps::HandleRDMRequest.
+   */
+  void SendRDMRequest(const ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback);
+
+  /**
+   * @brief Queue a response, to be returned by a GET QUEUED_MESSAGE.
+   */
+  void QueueMessage(uint16_t pid,
+                    ola::rdm::RDMCommand::RDMCommandClass command_class,
+                    const uint8_t *data,
+                    unsigned int length);
+
+  uint8_t QueuedMessageCount() const;
+
+  bool operator<(const SimulatedResponder &other) const {
+    return m_uid < other.m_uid;
+  }
+
+ private:
+  struct QueuedMessage {
+    uint16_t pid;
+    ola::rdm::RDMCommand::RDMCommandClass command_class;
+    std::string data;
+  };
+
+  class RDMOps : public ola::rdm::ResponderOps<SimulatedResponder> {
+   public:
+    static RDMOps *Instance() {
+      if (!instance) {
+        instance = new RDMOps();
+      }
+      return instance;
+    }
+
+   private:
+    RDMOps() : ola::rdm::ResponderOps<SimulatedResponder>(PARAM_HANDLERS) {}
+
+    static RDMOps *instance;
+  };
+
+  ola::rdm::UID m_uid;
+  uint16_t m_start_address;
+  bool m_identify_mode;
+  bool m_muted;
+  std::string m_device_label;
+  std::vector<QueuedMessage> m_queued_messages;
+
+  ola::rdm::RDMResponse *GetDeviceInfo(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetProductDetailList(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetDeviceModelDescription(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetManufacturerLabel(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetSoftwareVersionLabel(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetDeviceLabel(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *SetDeviceLabel(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetDmxStartAddress(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *SetDmxStartAddress(
+      const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetIdentify(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *SetIdentify(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetQueuedMessage(const ola::rdm::RDMRequest *request);
+  ola::rdm::RDMResponse *GetStatusMessages(
+      const ola::rdm::RDMRequest *request);
+
+  static const ola::rdm::ResponderOps<SimulatedResponder>::ParamHandler
+      PARAM_HANDLERS[];
+  static const uint16_t FOOTPRINT = 4;
+};
+
+
+/**
+ * @brief A collection of SimulatedResponders on a single port.
+ *
+ * The pool behaves like the responders on a real line; it implements
+ * DiscoveryTargetInterface so a DiscoveryAgent can find the responders with
+ * DUB, and two or more unmuted responders in a branch produce a collision.
+ * To put more load on the controller it can also:
+ *  - delay every reply, including those for discovery,
+ *  - reply to a percentage of GETs and SETs with ACK_TIMER, queuing the real
+ *    response for GET QUEUED_MESSAGE,
+ *  - queue a status message after a percentage of replies,
+ *  - corrupt a percentage of DUB replies, as noise on the line would.
+ */
+class SimulatedResponderPool : public ola::rdm::DiscoveryTargetInterface {
+ public:
+  struct Options {
+   public:
+    Options()
+        : count(0),
+          reply_latency_ms(0),
+          ack_timer_percent(0),
+          queued_message_percent(0),
+          dub_corruption_percent(0) {
+    }
+
+    unsigned int count;
+    unsigned int reply_latency_ms;
+    unsigned int ack_timer_percent;
+    unsigned int queued_message_percent;
+    unsigned int dub_corruption_percent;
+  };
+
+  /**
+   * @brief Create a new SimulatedResponderPool.
+   * @param first_uid the UID of the first responder, the rest follow.
+   * @param options the options for the pool.
+   * @param scheduler used to delay replies, may be NULL if the
+   *   reply_latency_ms is 0. Ownership is not transferred.
+   */
+  SimulatedResponderPool(const ola::rdm::UID &first_uid,
+                         const Options &options,
+                         ola::thread::SchedulerInterface *scheduler);
+
+  /**
+   * @brief Destructor, any delayed replies are sent immediately.
+   */
+  ~SimulatedResponderPool();
+
+  unsigned int Size() const { return m_responders.size(); }
+  bool Contains(const ola::rdm::UID &uid) const;
+  void GetUIDs(ola::rdm::UIDSet *uids) const;
+
+  /**
+   * @brief Send a request to the responders it's addressed to.
+   *
+   * Broadcast requests run the callback once, with RDM_WAS_BROADCAST.
+   */
+  void SendRDMRequest(ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback);
+
+  // DiscoveryTargetInterface methods
+  void MuteDevice(const ola::rdm::UID &target,
+                  MuteDeviceCallback *mute_complete);
+  void UnMuteAll(UnMuteDeviceCallback *unmute_complete);
+  void Branch(const ola::rdm::UID &lower,
+              const ola::rdm::UID &upper,
+              BranchCallback *callback);
+
+  /**
+   * @brief The size of a DUB reply, including the preamble.
+   */
+  static const unsigned int DUB_RESPONSE_SIZE = 24;
+
+  /**
+   * @brief The ACK_TIMER delay sent by the responders.
+   */
+  static const uint16_t ACK_TIMER_MS = 200;
+
+ private:
+  typedef std::vector<SimulatedResponder> ResponderList;
+
+  struct DelayedReply {
+    ola::thread::timeout_id timeout;
+    ola::SingleUseCallback0<void> *callback;
+  };
+
+  const Options m_options;
+  ola::thread::SchedulerInterface *m_scheduler;
+  ResponderList m_responders;  // sorted by UID
+  std::set<DelayedReply*> m_delayed_replies;
+  // Replies without latency are run from here, so that discovering thousands
+  // of responders doesn't recurse once per DUB.
+  std::deque<ola::SingleUseCallback0<void>*> m_immediate_replies;
+  bool m_running_replies;
+
+  SimulatedResponder *Find(const ola::rdm::UID &uid);
+  void HandleReply(SimulatedResponder *responder,
+                   ola::rdm::RDMCallback *callback,
+                   ola::rdm::RDMReply *reply);
+  void HandleAckTimerReply(SimulatedResponder *responder,
+                           const ola::rdm::RDMRequest *request,
+                           ola::rdm::RDMCallback *callback,
+                           ola::rdm::RDMReply *reply);
+  void HandleBroadcastReply(ola::rdm::RDMReply *reply);
+  void Reply(ola::SingleUseCallback0<void> *callback);
+  void RunDelayedReply(DelayedReply *reply);
+  bool Chance(unsigned int percent) const;
+
+  static void FormDUBResponse(const ola::rdm::UID &uid, uint8_t *data);
+
+  DISALLOW_COPY_AND_ASSIGN(SimulatedResponderPool);
+};
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DUMMY_SIMULATEDRESPONDERS_H_
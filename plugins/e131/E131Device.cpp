@@ -31,6 +31,7 @@
 #include "common/rpc/RpcController.h"
 #include "ola/CallbackRunner.h"
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/network/NetworkUtils.h"
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
@@ -45,6 +46,7 @@ namespace e131 {
 
 const char E131Device::DEVICE_NAME[] = "E1.31 (DMX over ACN)";
 
+using ola::IntToString;
 using ola::acn::E131Node;
 using ola::rpc::RpcController;
 using std::ostringstream;
@@ -59,12 +61,14 @@ E131Device::E131Device(Plugin *owner,
                        const ola::acn::CID &cid,
                        string ip_addr,
                        PluginAdaptor *plugin_adaptor,
-                       const E131DeviceOptions &options)
+                       const E131DeviceOptions &options,
+                       unsigned int device_id)
     : Device(owner, DEVICE_NAME),
       m_plugin_adaptor(plugin_adaptor),
       m_options(options),
       m_ip_addr(ip_addr),
-      m_cid(cid) {
+      m_cid(cid),
+      m_device_id(IntToString(device_id)) {
 }
 
 
@@ -92,12 +96,19 @@ bool E131Device::StartHook() {
   }
 
   for (unsigned int i = 0; i < m_options.output_ports; i++) {
+    uint16_t sync_address = i < m_options.output_sync_addresses.size() ?
+        m_options.output_sync_addresses[i] : 0;
+    ola::dmx::OutputCurve::Options curve;
+    if (i < m_options.output_curves.size()) {
+      curve = m_options.output_curves[i];
+    }
     E131OutputPort *output_port = new E131OutputPort(
-        this, i, m_node.get());
+        this, i, m_node.get(), sync_address, curve);
     AddPort(output_port);
     m_output_ports.push_back(output_port);
   }
 
+  m_node->GetSocket()->SetReadLabel("e131");
   m_plugin_adaptor->AddReadDescriptor(m_node->GetSocket());
   return true;
 }
@@ -26,6 +26,7 @@
 #include <vector>
 #include "libs/acn/E131Node.h"
 #include "ola/acn/CID.h"
+#include "ola/dmx/OutputCurve.h"
 #include "olad/Device.h"
 #include "olad/Plugin.h"
 #include "plugins/e131/messages/E131ConfigMessages.pb.h"
@@ -48,15 +49,30 @@ class E131Device: public ola::Device {
     }
     unsigned int input_ports;
     unsigned int output_ports;
+    // The sync address for each output port, 0 means unsynchronized.
+    std::vector<uint16_t> output_sync_addresses;
+    // The gamma / dimming curve for each output port.
+    std::vector<ola::dmx::OutputCurve::Options> output_curves;
   };
 
+  /**
+   * @brief Create a new E1.31 device.
+   * @param owner the plugin that owns this device.
+   * @param cid the CID to use.
+   * @param ip_addr the IP address or interface name to bind to.
+   * @param plugin_adaptor the PluginAdaptor to use.
+   * @param options the options for the device.
+   * @param device_id the id of the device, there is one device per
+   *   interface.
+   */
   E131Device(ola::Plugin *owner,
              const ola::acn::CID &cid,
              std::string ip_addr,
              class PluginAdaptor *plugin_adaptor,
-             const E131DeviceOptions &options);
+             const E131DeviceOptions &options,
+             unsigned int device_id = 1);
 
-  std::string DeviceId() const { return "1"; }
+  std::string DeviceId() const { return m_device_id; }
 
   void Configure(ola::rpc::RpcController *controller,
                  const std::string &request,
@@ -76,6 +92,7 @@ class E131Device: public ola::Device {
   std::vector<E131OutputPort*> m_output_ports;
   std::string m_ip_addr;
   ola::acn::CID m_cid;
+  const std::string m_device_id;
 
   void HandlePreviewMode(const ola::plugin::e131::Request *request,
                          std::string *response);
@@ -18,15 +18,20 @@
  * Copyright (C) 2007 Simon Newton
  */
 
+#include <algorithm>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/StringUtils.h"
 #include "ola/acn/CID.h"
+#include "ola/dmx/OutputCurve.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/e131/E131Device.h"
 #include "plugins/e131/E131Plugin.h"
 #include "plugins/e131/E131PluginDescription.h"
@@ -36,11 +41,19 @@ namespace plugin {
 namespace e131 {
 
 using ola::acn::CID;
+using ola::dmx::OutputCurve;
+using ola::network::IPV4Address;
+using std::set;
 using std::string;
+using std::vector;
 
+const char E131Plugin::BATCH_TRANSMIT_KEY[] = "batch_transmit";
+const char E131Plugin::BRIGHTNESS_KEY_SUFFIX[] = "_brightness";
 const char E131Plugin::CID_KEY[] = "cid";
 const unsigned int E131Plugin::DEFAULT_DSCP_VALUE = 0;
+const char E131Plugin::DITHER_KEY_SUFFIX[] = "_dither";
 const char E131Plugin::DSCP_KEY[] = "dscp";
+const char E131Plugin::GAMMA_KEY_SUFFIX[] = "_gamma";
 const char E131Plugin::DRAFT_DISCOVERY_KEY[] = "draft_discovery";
 const char E131Plugin::IGNORE_PREVIEW_DATA_KEY[] = "ignore_preview";
 const char E131Plugin::INPUT_PORT_COUNT_KEY[] = "input_ports";
@@ -49,10 +62,17 @@ const char E131Plugin::OUTPUT_PORT_COUNT_KEY[] = "output_ports";
 const char E131Plugin::PLUGIN_NAME[] = "E1.31 (sACN)";
 const char E131Plugin::PLUGIN_PREFIX[] = "e131";
 const char E131Plugin::PREPEND_HOSTNAME_KEY[] = "prepend_hostname";
+const char E131Plugin::RECEIVE_BUFFER_KEY[] = "receive_buffer_size";
 const char E131Plugin::REVISION_0_2[] = "0.2";
 const char E131Plugin::REVISION_0_46[] = "0.46";
 const char E131Plugin::REVISION_KEY[] = "revision";
+const char E131Plugin::SEND_BUFFER_KEY[] = "send_buffer_size";
+const char E131Plugin::SYNC_ADDRESS_KEY_SUFFIX[] = "_sync_address";
+const char E131Plugin::TRANSMIT_PACING_KEY[] = "transmit_pacing_ms";
+const char E131Plugin::UNICAST_KEY[] = "unicast";
 const unsigned int E131Plugin::DEFAULT_PORT_COUNT = 5;
+const unsigned int E131Plugin::MAX_SOCKET_BUFFER_SIZE = 64 * 1024 * 1024;
+const unsigned int E131Plugin::MAX_TRANSMIT_PACING_MS = 1000;
 
 
 /*
@@ -60,7 +80,6 @@ const unsigned int E131Plugin::DEFAULT_PORT_COUNT = 5;
  */
 bool E131Plugin::StartHook() {
   CID cid = CID::FromString(m_preferences->GetValue(CID_KEY));
-  string ip_addr = m_preferences->GetValue(IP_KEY);
 
   E131Device::E131DeviceOptions options;
   options.use_rev2 = (m_preferences->GetValue(REVISION_KEY) == REVISION_0_2);
@@ -68,6 +87,16 @@ bool E131Plugin::StartHook() {
       IGNORE_PREVIEW_DATA_KEY);
   options.enable_draft_discovery = m_preferences->GetValueAsBool(
       DRAFT_DISCOVERY_KEY);
+  options.batch_transmit = m_preferences->GetValueAsBool(BATCH_TRANSMIT_KEY);
+  options.transmit_pacing_ms = StringToIntOrDefault(
+      m_preferences->GetValue(TRANSMIT_PACING_KEY), 0);
+  options.receive_buffer_size = StringToIntOrDefault(
+      m_preferences->GetValue(RECEIVE_BUFFER_KEY), 0);
+  options.send_buffer_size = StringToIntOrDefault(
+      m_preferences->GetValue(SEND_BUFFER_KEY), 0);
+  options.export_map = m_plugin_adaptor->GetExportMap();
+  options.clock = m_plugin_adaptor->LoopClock();
+  options.select_server = m_plugin_adaptor;
   if (m_preferences->GetValueAsBool(PREPEND_HOSTNAME_KEY)) {
     std::ostringstream str;
     str << ola::network::Hostname() << "-" << m_plugin_adaptor->InstanceName();
@@ -96,15 +125,52 @@ bool E131Plugin::StartHook() {
     OLA_WARN << "Invalid value for input_ports";
   }
 
-  m_device = new E131Device(this, cid, ip_addr, m_plugin_adaptor, options);
+  for (unsigned int i = 0; i < options.output_ports; i++) {
+    uint16_t sync_address = 0;
+    const string value = m_preferences->GetValue(SyncAddressKey(i));
+    if (!value.empty() &&
+        (!StringToInt(value, &sync_address) ||
+         sync_address > MAX_E131_UNIVERSE)) {
+      OLA_WARN << "Invalid value for " << SyncAddressKey(i) << ": " << value;
+      sync_address = 0;
+    }
+    options.output_sync_addresses.push_back(sync_address);
+
+    OutputCurve::Options curve_options;
+    PopulateCurveOptions(i, &curve_options);
+    options.output_curves.push_back(curve_options);
+  }
+  PopulateUnicastDestinations(&options.unicast_destinations);
 
-  if (!m_device->Start()) {
-    delete m_device;
-    return false;
+  // One device per interface, the first uses the cid key.
+  vector<string> interfaces = m_preferences->GetMultipleValue(IP_KEY);
+  if (interfaces.empty()) {
+    interfaces.push_back("");
   }
 
-  m_plugin_adaptor->RegisterDevice(m_device);
-  return true;
+  set<string> seen_interfaces;
+  for (unsigned int i = 0; i < interfaces.size(); i++) {
+    const string &ip_addr = interfaces[i];
+    if (!seen_interfaces.insert(ip_addr).second) {
+      OLA_WARN << "Ignoring duplicate " << IP_KEY << " " << ip_addr;
+      continue;
+    }
+
+    unsigned int device_id = i + 1;
+    E131Device *device = new E131Device(
+        this, i ? DeviceCID(device_id) : cid, ip_addr, m_plugin_adaptor,
+        options, device_id);
+
+    if (!device->Start()) {
+      OLA_WARN << "Failed to start E1.31 device for " << ip_addr;
+      delete device;
+      continue;
+    }
+
+    m_plugin_adaptor->RegisterDevice(device);
+    m_devices.push_back(device);
+  }
+  return !m_devices.empty();
 }
 
 
@@ -113,13 +179,15 @@ bool E131Plugin::StartHook() {
  * @return true on success, false on failure
  */
 bool E131Plugin::StopHook() {
-  if (m_device) {
-    m_plugin_adaptor->UnregisterDevice(m_device);
-    bool ret = m_device->Stop();
-    delete m_device;
-    return ret;
+  bool ret = true;
+  vector<E131Device*>::iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    m_plugin_adaptor->UnregisterDevice(*iter);
+    ret &= (*iter)->Stop();
+    delete *iter;
   }
-  return true;
+  m_devices.clear();
+  return ret;
 }
 
 
@@ -131,6 +199,104 @@ string E131Plugin::Description() const {
 }
 
 
+/*
+ * The key for the sync address of an output port
+ */
+string E131Plugin::SyncAddressKey(unsigned int port_id) const {
+  return OutputPortKey(port_id, SYNC_ADDRESS_KEY_SUFFIX);
+}
+
+
+/*
+ * The key for a setting of an output port
+ */
+string E131Plugin::OutputPortKey(unsigned int port_id,
+                                 const char *suffix) const {
+  std::ostringstream str;
+  str << "output_port_" << port_id << suffix;
+  return str.str();
+}
+
+
+/*
+ * Read the gamma / dimming curve for an output port.
+ */
+void E131Plugin::PopulateCurveOptions(unsigned int port_id,
+                                      OutputCurve::Options *options) {
+  const string gamma_key = OutputPortKey(port_id, GAMMA_KEY_SUFFIX);
+  string value = m_preferences->GetValue(gamma_key);
+  if (!value.empty() && !OutputCurve::ParseGamma(value, &options->gamma)) {
+    OLA_WARN << "Invalid value for " << gamma_key << ": " << value;
+  }
+
+  const string brightness_key = OutputPortKey(port_id, BRIGHTNESS_KEY_SUFFIX);
+  value = m_preferences->GetValue(brightness_key);
+  uint8_t brightness;
+  if (!value.empty()) {
+    if (StringToInt(value, &brightness) &&
+        brightness <= OutputCurve::MAX_BRIGHTNESS) {
+      options->brightness = brightness;
+    } else {
+      OLA_WARN << "Invalid value for " << brightness_key << ": " << value;
+    }
+  }
+
+  options->dither = m_preferences->GetValueAsBool(
+      OutputPortKey(port_id, DITHER_KEY_SUFFIX));
+}
+
+
+/*
+ * Read the unicast receivers, each value is <universe>:<ip>.
+ */
+void E131Plugin::PopulateUnicastDestinations(
+    ola::acn::E131Node::UnicastDestinations *destinations) {
+  const vector<string> values = m_preferences->GetMultipleValue(UNICAST_KEY);
+  vector<string>::const_iterator iter = values.begin();
+  for (; iter != values.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+
+    const string::size_type colon = iter->find(':');
+    uint16_t universe;
+    IPV4Address address;
+    if (colon == string::npos ||
+        !StringToInt(iter->substr(0, colon), &universe) ||
+        universe == 0 || universe > MAX_E131_UNIVERSE ||
+        !IPV4Address::FromString(iter->substr(colon + 1), &address)) {
+      OLA_WARN << "Invalid value for " << UNICAST_KEY << ": " << *iter;
+      continue;
+    }
+
+    vector<IPV4Address> &receivers = (*destinations)[universe];
+    if (std::find(receivers.begin(), receivers.end(), address) ==
+        receivers.end()) {
+      receivers.push_back(address);
+    }
+  }
+}
+
+
+/*
+ * Return the CID for a device other than the first one, generating it if
+ * required.
+ */
+CID E131Plugin::DeviceCID(unsigned int device_id) {
+  std::ostringstream str;
+  str << CID_KEY << "_" << device_id;
+  const string key = str.str();
+
+  CID cid = CID::FromString(m_preferences->GetValue(key));
+  if (cid.IsNil()) {
+    cid = CID::Generate();
+    m_preferences->SetValue(key, cid.ToString());
+    m_preferences->Save();
+  }
+  return cid;
+}
+
+
 /*
  * Load the plugin prefs and default to sensible values
  *
@@ -148,6 +314,11 @@ bool E131Plugin::SetDefaultPreferences() {
     save = true;
   }
 
+  save |= m_preferences->SetDefaultValue(
+      BATCH_TRANSMIT_KEY,
+      BoolValidator(),
+      false);
+
   save |= m_preferences->SetDefaultValue(
       DSCP_KEY,
       UIntValidator(0, 63),
@@ -180,6 +351,24 @@ bool E131Plugin::SetDefaultPreferences() {
       BoolValidator(),
       true);
 
+  save |= m_preferences->SetDefaultValue(
+      RECEIVE_BUFFER_KEY,
+      UIntValidator(0, MAX_SOCKET_BUFFER_SIZE),
+      0);
+
+  save |= m_preferences->SetDefaultValue(
+      SEND_BUFFER_KEY,
+      UIntValidator(0, MAX_SOCKET_BUFFER_SIZE),
+      0);
+
+  save |= m_preferences->SetDefaultValue(
+      TRANSMIT_PACING_KEY,
+      UIntValidator(0, MAX_TRANSMIT_PACING_MS),
+      0);
+
+  save |= m_preferences->SetDefaultValue(UNICAST_KEY, StringValidator(true),
+                                         "");
+
   std::set<string> revision_values;
   revision_values.insert(REVISION_0_2);
   revision_values.insert(REVISION_0_46);
@@ -206,3 +395,5 @@ bool E131Plugin::SetDefaultPreferences() {
 }  // namespace e131
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::e131::E131Plugin)
@@ -22,8 +22,12 @@
 #define PLUGINS_E131_E131PLUGIN_H_
 
 #include <string>
+#include <vector>
+#include "ola/acn/CID.h"
+#include "ola/dmx/OutputCurve.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
+#include "libs/acn/E131Node.h"
 
 namespace ola {
 namespace plugin {
@@ -34,8 +38,7 @@ class E131Device;
 class E131Plugin: public ola::Plugin {
  public:
     explicit E131Plugin(ola::PluginAdaptor *plugin_adaptor):
-      ola::Plugin(plugin_adaptor),
-      m_device(NULL) {}
+      ola::Plugin(plugin_adaptor) {}
     ~E131Plugin() {}
 
     std::string Name() const { return PLUGIN_NAME; }
@@ -47,13 +50,26 @@ class E131Plugin: public ola::Plugin {
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
+    std::string SyncAddressKey(unsigned int port_id) const;
+    std::string OutputPortKey(unsigned int port_id, const char *suffix) const;
+    void PopulateCurveOptions(unsigned int port_id,
+                              ola::dmx::OutputCurve::Options *options);
+    ola::acn::CID DeviceCID(unsigned int device_id);
+    void PopulateUnicastDestinations(
+        ola::acn::E131Node::UnicastDestinations *destinations);
 
-    E131Device *m_device;
+    std::vector<E131Device*> m_devices;
+    static const char BATCH_TRANSMIT_KEY[];
+    static const char BRIGHTNESS_KEY_SUFFIX[];
     static const char CID_KEY[];
     static const unsigned int DEFAULT_DSCP_VALUE;
     static const unsigned int DEFAULT_PORT_COUNT;
+    static const unsigned int MAX_SOCKET_BUFFER_SIZE;
+    static const unsigned int MAX_TRANSMIT_PACING_MS;
     static const char DRAFT_DISCOVERY_KEY[];
+    static const char DITHER_KEY_SUFFIX[];
     static const char DSCP_KEY[];
+    static const char GAMMA_KEY_SUFFIX[];
     static const char IGNORE_PREVIEW_DATA_KEY[];
     static const char INPUT_PORT_COUNT_KEY[];
     static const char IP_KEY[];
@@ -61,9 +77,15 @@ class E131Plugin: public ola::Plugin {
     static const char PLUGIN_NAME[];
     static const char PLUGIN_PREFIX[];
     static const char PREPEND_HOSTNAME_KEY[];
+    static const char RECEIVE_BUFFER_KEY[];
     static const char REVISION_0_2[];
     static const char REVISION_0_46[];
     static const char REVISION_KEY[];
+    static const char SEND_BUFFER_KEY[];
+    static const char SYNC_ADDRESS_KEY_SUFFIX[];
+    static const char TRANSMIT_PACING_KEY[];
+    static const char UNICAST_KEY[];
+    static const unsigned int MAX_E131_UNIVERSE = 63999;
 };
 }  // namespace e131
 }  // namespace plugin
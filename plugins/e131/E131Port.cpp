@@ -65,7 +65,9 @@ void E131InputPort::PostSetUniverse(Universe *old_universe,
         new_universe->UniverseId(),
         &m_buffer,
         &m_priority,
-        NewCallback<E131InputPort, void>(this, &E131InputPort::DmxChanged));
+        NewCallback<E131InputPort, void>(this, &E131InputPort::DmxChanged),
+        &m_arrival,
+        &m_slot_priorities);
 }
 
 E131OutputPort::~E131OutputPort() {
@@ -85,6 +87,9 @@ void E131OutputPort::PostSetUniverse(Universe *old_universe,
   }
   if (new_universe) {
     m_node->StartStream(new_universe->UniverseId());
+    if (m_sync_address) {
+      m_node->SetSyncAddress(new_universe->UniverseId(), m_sync_address);
+    }
   }
 }
 
@@ -99,6 +104,11 @@ bool E131OutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
 
   m_last_priority = (GetPriorityMode() == PRIORITY_MODE_STATIC) ?
       GetPriority() : priority;
+  if (!m_curve.IsIdentity()) {
+    m_curve.Apply(buffer, &m_buffer);
+    return m_node->SendDMX(universe->UniverseId(), m_buffer, m_last_priority,
+                           m_preview_on);
+  }
   return m_node->SendDMX(universe->UniverseId(), buffer, m_last_priority,
                          m_preview_on);
 }
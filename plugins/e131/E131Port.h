@@ -22,6 +22,7 @@
 #define PLUGINS_E131_E131PORT_H_
 
 #include <string>
+#include "ola/dmx/OutputCurve.h"
 #include "olad/Port.h"
 #include "plugins/e131/E131Device.h"
 #include "libs/acn/E131Node.h"
@@ -59,9 +60,15 @@ class E131InputPort: public BasicInputPort {
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
   bool SupportsPriorities() const { return true; }
   uint8_t InheritedPriority() const { return m_priority; }
+  const ola::DmxBuffer *InheritedSlotPriorities() const {
+    return &m_slot_priorities;
+  }
+  TimeStamp ArrivalTime() const { return m_arrival; }
 
  private:
   ola::DmxBuffer m_buffer;
+  ola::DmxBuffer m_slot_priorities;
+  TimeStamp m_arrival;
   ola::acn::E131Node *m_node;
   E131PortHelper m_helper;
   uint8_t m_priority;
@@ -70,10 +77,15 @@ class E131InputPort: public BasicInputPort {
 
 class E131OutputPort: public BasicOutputPort {
  public:
-  E131OutputPort(E131Device *parent, int id, ola::acn::E131Node *node)
+  E131OutputPort(E131Device *parent, int id, ola::acn::E131Node *node,
+                 uint16_t sync_address = 0,
+                 const ola::dmx::OutputCurve::Options &curve =
+                     ola::dmx::OutputCurve::Options())
       : BasicOutputPort(parent, id),
         m_preview_on(false),
-        m_node(node) {
+        m_sync_address(sync_address),
+        m_node(node),
+        m_curve(curve) {
     m_last_priority = GetPriority();
   }
 
@@ -95,10 +107,12 @@ class E131OutputPort: public BasicOutputPort {
 
  private:
   bool m_preview_on;
+  const uint16_t m_sync_address;
   uint8_t m_last_priority;
   ola::DmxBuffer m_buffer;
   ola::acn::E131Node *m_node;
   E131PortHelper m_helper;
+  ola::dmx::OutputCurve m_curve;
 };
 }  // namespace e131
 }  // namespace plugin
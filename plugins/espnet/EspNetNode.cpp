@@ -23,6 +23,7 @@
 #include <map>
 #include <string>
 #include "ola/Logging.h"
+#include "ola/dmx/RunLengthEncoder.h"
 #include "ola/network/InterfacePicker.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/MACAddress.h"
@@ -58,7 +59,9 @@ EspNetNode::EspNetNode(const string &ip_address)
       m_universe(0),
       m_type(ESPNET_NODE_TYPE_IO),
       m_node_name(NODE_NAME),
-      m_preferred_ip(ip_address) {
+      m_preferred_ip(ip_address),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  sizeof(espnet_packet_union_t)) {
 }
 
 
@@ -117,15 +120,22 @@ bool EspNetNode::Stop() {
  * Called when there is data on this socket
  */
 void EspNetNode::SocketReady() {
+  unsigned int count = m_recv_ring.Receive(&m_socket);
+  for (unsigned int i = 0; i < count; i++) {
+    HandleDatagram(m_recv_ring.Get(i));
+  }
+}
+
+
+/*
+ * Handle a datagram read from the socket.
+ */
+void EspNetNode::HandleDatagram(const ola::network::UDPDatagram &datagram) {
   espnet_packet_union_t packet;
   memset(&packet, 0, sizeof(packet));
-  ola::network::IPV4SocketAddress source;
-
-  ssize_t packet_size = sizeof(packet);
-  if (!m_socket.RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                         &packet_size,
-                         &source))
-    return;
+  memcpy(&packet, datagram.data, datagram.size);
+  const IPV4SocketAddress &source = datagram.source;
+  ssize_t packet_size = datagram.size;
 
   if (packet_size < (ssize_t) sizeof(packet.poll.head)) {
     OLA_WARN << "Small espnet packet received, discarding";
@@ -410,8 +420,21 @@ bool EspNetNode::SendEspData(const IPV4Address &dst,
   packet.dmx.head = HostToNetwork((uint32_t) ESPNET_DMX);
   packet.dmx.universe = universe;
   packet.dmx.start = START_CODE;
+
+  // Use RLE if it's smaller than the raw data, only the encoded data is sent
+  // in that case.
+  static const unsigned int header_size = (
+      sizeof(espnet_data_t) - DMX_UNIVERSE_SIZE);
+  unsigned int size = ola::dmx::RunLengthEncoder::MaxUsefulSize(
+      buffer.Size());
+  if (m_encoder.Encode(buffer, packet.dmx.data, &size)) {
+    packet.dmx.type = DATA_RLE;
+    packet.dmx.size = HostToNetwork((uint16_t) size);
+    return SendPacket(dst, packet, header_size + size);
+  }
+
   packet.dmx.type = DATA_RAW;
-  unsigned int size = DMX_UNIVERSE_SIZE;
+  size = DMX_UNIVERSE_SIZE;
   buffer.Get(packet.dmx.data, &size);
   packet.dmx.size = HostToNetwork((uint16_t) size);
   return SendPacket(dst, packet, sizeof(packet.dmx));
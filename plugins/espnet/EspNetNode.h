@@ -30,6 +30,7 @@
 #include "ola/network/Socket.h"
 #include "plugins/espnet/EspNetPackets.h"
 #include "plugins/espnet/RunLengthDecoder.h"
+#include "plugins/espnet/RunLengthEncoder.h"
 
 namespace ola {
 namespace plugin {
@@ -84,6 +85,7 @@ class EspNetNode {
     EspNetNode(const EspNetNode&);
     EspNetNode& operator=(const EspNetNode&);
     bool InitNetwork();
+    void HandleDatagram(const ola::network::UDPDatagram &datagram);
     void HandlePoll(const espnet_poll_t &poll, ssize_t length,
                     const ola::network::IPV4Address &source);
     void HandleReply(const espnet_poll_reply_t &reply,
@@ -117,7 +119,9 @@ class EspNetNode {
     std::map<uint8_t, universe_handler> m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
+    ola::network::UDPReceiveRing m_recv_ring;
     RunLengthDecoder m_decoder;
+    RunLengthEncoder m_encoder;
 
     static const char NODE_NAME[];
     static const uint8_t DEFAULT_OPTIONS = 0;
@@ -20,6 +20,7 @@
 
 #include <string>
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/espnet/EspNetPlugin.h"
 #include "plugins/espnet/EspNetPluginDescription.h"
 #include "plugins/espnet/EspNetDevice.h"
@@ -107,3 +108,5 @@ bool EspNetPlugin::SetDefaultPreferences() {
 }  // namespace espnet
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::espnet::EspNetPlugin)
@@ -22,7 +22,9 @@ plugins_espnet_libolaespnet_la_SOURCES = \
     plugins/espnet/EspNetPort.cpp \
     plugins/espnet/EspNetPort.h \
     plugins/espnet/RunLengthDecoder.cpp \
-    plugins/espnet/RunLengthDecoder.h
+    plugins/espnet/RunLengthDecoder.h \
+    plugins/espnet/RunLengthEncoder.cpp \
+    plugins/espnet/RunLengthEncoder.h
 plugins_espnet_libolaespnet_la_LIBADD = \
     common/libolacommon.la \
     olad/plugin_api/libolaserverplugininterface.la
@@ -33,7 +35,9 @@ test_programs += plugins/espnet/EspNetTester
 
 plugins_espnet_EspNetTester_SOURCES = \
     plugins/espnet/RunLengthDecoderTest.cpp \
-    plugins/espnet/RunLengthDecoder.cpp
+    plugins/espnet/RunLengthDecoder.cpp \
+    plugins/espnet/RunLengthEncoderTest.cpp \
+    plugins/espnet/RunLengthEncoder.cpp
 plugins_espnet_EspNetTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_espnet_EspNetTester_LDADD = $(COMMON_TESTING_LIBS) \
                                     common/libolacommon.la
@@ -19,6 +19,7 @@
  */
 
 #include <ola/Constants.h>
+#include "common/dmx/RunKernels.h"
 #include "plugins/espnet/RunLengthDecoder.h"
 
 namespace ola {
@@ -34,26 +35,38 @@ namespace espnet {
 void RunLengthDecoder::Decode(DmxBuffer *dst,
                               const uint8_t *src_data,
                               unsigned int length) {
+  const ola::dmx::RunKernel &kernel = ola::dmx::BestRunKernel();
   dst->Reset();
   unsigned int i = 0;
   const uint8_t *value = src_data;
+  const uint8_t *end = src_data + length;
   uint8_t count;
-  while (i < DMX_UNIVERSE_SIZE && value < src_data + length) {
+  while (i < DMX_UNIVERSE_SIZE && value < end) {
     switch (*value) {
       case REPEAT_VALUE:
         value++;
         count = *(value++);
         dst->SetRangeToValue(i, *value, count);
         i+= count;
+        value++;
         break;
       case ESCAPE_VALUE:
         value++;
-        // fall through
-      default:
         dst->SetChannel(i, *value);
         i++;
+        value++;
+        break;
+      default:
+        {
+          // copy everything up to the next special value in one go
+          unsigned int literal_length = kernel.find_either(
+              value, static_cast<unsigned int>(end - value),
+              ESCAPE_VALUE, REPEAT_VALUE);
+          dst->SetRange(i, value, literal_length);
+          i += literal_length;
+          value += literal_length;
+        }
     }
-    value++;
   }
 }
 }  // namespace espnet
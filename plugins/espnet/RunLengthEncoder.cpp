@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RunLengthEncoder.cpp
+ * The ESP Net Run Length Encoder
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "common/dmx/RunKernels.h"
+#include "plugins/espnet/RunLengthEncoder.h"
+
+namespace ola {
+namespace plugin {
+namespace espnet {
+
+const unsigned int RunLengthEncoder::MAX_RUN_LENGTH;
+
+/*
+ * Runs of three or more values are sent as REPEAT_VALUE, count, value. Any
+ * other value is sent as is, unless it's one of the special values in which
+ * case it's preceded by ESCAPE_VALUE.
+ */
+bool RunLengthEncoder::Encode(const DmxBuffer &src,
+                              uint8_t *data,
+                              unsigned int *size) {
+  const unsigned int src_size = src.Size();
+  const unsigned int dst_size = *size;
+  unsigned int &dst_index = *size;
+  dst_index = 0;
+
+  const ola::dmx::RunKernel &kernel = ola::dmx::BestRunKernel();
+  const uint8_t *src_data = src.GetRaw();
+
+  unsigned int i = 0;
+  while (i < src_size) {
+    uint8_t value = src_data[i];
+    unsigned int run = kernel.run_length(
+        src_data + i, std::min(src_size - i, MAX_RUN_LENGTH));
+
+    bool special = value == ESCAPE_VALUE || value == REPEAT_VALUE;
+    if (run > 2 || (special && run == 2)) {
+      if (dst_size - dst_index < 3) {
+        return false;
+      }
+      data[dst_index++] = REPEAT_VALUE;
+      data[dst_index++] = static_cast<uint8_t>(run);
+      data[dst_index++] = value;
+      i += run;
+    } else if (special) {
+      if (dst_size - dst_index < 2) {
+        return false;
+      }
+      data[dst_index++] = ESCAPE_VALUE;
+      data[dst_index++] = value;
+      i++;
+    } else {
+      // Copy everything up to the next special value or run in one go.
+      unsigned int remaining = src_size - i;
+      unsigned int special_offset = kernel.find_either(
+          src_data + i, remaining, ESCAPE_VALUE, REPEAT_VALUE);
+      unsigned int length = std::min(
+          special_offset,
+          kernel.find_repeat(src_data + i,
+                             std::min(special_offset + 2, remaining)));
+      unsigned int room = dst_size - dst_index;
+      if (length > room) {
+        memcpy(data + dst_index, src_data + i, room);
+        dst_index += room;
+        return false;
+      }
+      memcpy(data + dst_index, src_data + i, length);
+      dst_index += length;
+      i += length;
+    }
+  }
+  return true;
+}
+}  // namespace espnet
+}  // namespace plugin
+}  // namespace ola
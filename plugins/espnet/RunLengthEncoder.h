@@ -0,0 +1,58 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RunLengthEncoder.h
+ * Header file for the RunLengthEncoder class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_ESPNET_RUNLENGTHENCODER_H_
+#define PLUGINS_ESPNET_RUNLENGTHENCODER_H_
+
+#include <ola/DmxBuffer.h>
+
+namespace ola {
+namespace plugin {
+namespace espnet {
+
+/**
+ * Encodes DMX data in the ESP Net RLE format, the reverse of
+ * RunLengthDecoder.
+ */
+class RunLengthEncoder {
+ public:
+  RunLengthEncoder() {}
+  ~RunLengthEncoder() {}
+
+  /**
+   * Encode a DmxBuffer.
+   * @param src the DmxBuffer to encode.
+   * @param data where to store the RLE data.
+   * @param size the size of data, set to the amount of data encoded.
+   * @returns true if all the data was encoded, false if we ran out of space.
+   */
+  bool Encode(const DmxBuffer &src,
+              uint8_t *data,
+              unsigned int *size);
+
+ private:
+  static const uint8_t ESCAPE_VALUE = 0xFD;
+  static const uint8_t REPEAT_VALUE = 0xFE;
+  static const unsigned int MAX_RUN_LENGTH = 0xFF;
+};
+}  // namespace espnet
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_ESPNET_RUNLENGTHENCODER_H_
@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RunLengthEncoderTest.cpp
+ * Test fixture for the ESP Net RunLengthEncoder class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+
+#include "ola/testing/TestUtils.h"
+#include "plugins/espnet/RunLengthDecoder.h"
+#include "plugins/espnet/RunLengthEncoder.h"
+
+using ola::DmxBuffer;
+using ola::plugin::espnet::RunLengthDecoder;
+using ola::plugin::espnet::RunLengthEncoder;
+
+class RunLengthEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RunLengthEncoderTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testEncodeDecode);
+  CPPUNIT_TEST(testOutOfSpace);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncode();
+    void testEncodeDecode();
+    void testOutOfSpace();
+ private:
+    RunLengthEncoder m_encoder;
+    RunLengthDecoder m_decoder;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RunLengthEncoderTest);
+
+
+/*
+ * Check that we can encode DMX data
+ */
+void RunLengthEncoderTest::testEncode() {
+  const uint8_t input[] = {0x78, 0x56, 0x74, 0x10, 0x10, 0x10, 0x10, 0x10,
+                           0x41, 0x78, 0xFE, 0x36, 0xFD, 0xFD, 0x42, 0x42};
+  const uint8_t expected[] = {0x78, 0x56, 0x74, 0xFE, 0x5, 0x10, 0x41, 0x78,
+                              0xFD, 0xFE, 0x36, 0xFE, 0x2, 0xFD, 0x42, 0x42};
+  DmxBuffer buffer(input, sizeof(input));
+
+  uint8_t output[sizeof(expected)];
+  unsigned int size = sizeof(output);
+  OLA_ASSERT_TRUE(m_encoder.Encode(buffer, output, &size));
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, size);
+}
+
+
+/*
+ * Check the decoder gives back what we encoded, including runs longer than
+ * the maximum count.
+ */
+void RunLengthEncoderTest::testEncodeDecode() {
+  DmxBuffer buffer;
+  buffer.SetRangeToValue(0, 0xFE, 300);
+  buffer.SetChannel(300, 1);
+  buffer.SetChannel(301, 0xFD);
+  buffer.SetRangeToValue(302, 0, 210);
+
+  uint8_t output[ola::DMX_UNIVERSE_SIZE];
+  unsigned int size = sizeof(output);
+  OLA_ASSERT_TRUE(m_encoder.Encode(buffer, output, &size));
+  OLA_ASSERT_EQ(12u, size);
+
+  DmxBuffer decoded;
+  m_decoder.Decode(&decoded, output, size);
+  OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(),
+                         decoded.GetRaw(), decoded.Size());
+}
+
+
+/*
+ * Check we stop once the output is full.
+ */
+void RunLengthEncoderTest::testOutOfSpace() {
+  const uint8_t input[] = {1, 2, 3, 4, 5, 6};
+  DmxBuffer buffer(input, sizeof(input));
+
+  uint8_t output[sizeof(input)];
+  unsigned int size = sizeof(input) - 1;
+  OLA_ASSERT_FALSE(m_encoder.Encode(buffer, output, &size));
+  OLA_ASSERT_EQ(5u, size);
+
+  size = sizeof(input);
+  OLA_ASSERT_TRUE(m_encoder.Encode(buffer, output, &size));
+  OLA_ASSERT_EQ(6u, size);
+}
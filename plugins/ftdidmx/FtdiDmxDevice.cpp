@@ -37,10 +37,16 @@ using std::string;
 
 FtdiDmxDevice::FtdiDmxDevice(AbstractPlugin *owner,
                              const FtdiWidgetInfo &widget_info,
-                             unsigned int frequency)
+                             unsigned int frequency,
+                             bool realtime,
+                             ExportMap *export_map,
+                             ola::dmx::DmxOutputMultiplexer *multiplexer)
     : Device(owner, widget_info.Description()),
       m_widget_info(widget_info),
-      m_frequency(frequency) {
+      m_frequency(frequency),
+      m_realtime(realtime),
+      m_export_map(export_map),
+      m_multiplexer(multiplexer) {
   m_widget = new FtdiWidget(widget_info.Serial(),
                             widget_info.Name(),
                             widget_info.Id(),
@@ -64,7 +70,8 @@ bool FtdiDmxDevice::StartHook() {
     FtdiInterface *port = new FtdiInterface(m_widget,
                                             static_cast<ftdi_interface>(i));
     if (port->SetupOutput()) {
-      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency));
+      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency, m_realtime,
+                                    m_export_map, m_multiplexer));
       successfully_added += 1;
     } else {
       OLA_WARN << "Failed to add interface: " << i;
@@ -29,6 +29,8 @@
 #include <string>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -41,7 +43,10 @@ class FtdiDmxDevice : public Device {
  public:
   FtdiDmxDevice(AbstractPlugin *owner,
                 const FtdiWidgetInfo &widget_info,
-                unsigned int frequency);
+                unsigned int frequency,
+                bool realtime,
+                ExportMap *export_map,
+                ola::dmx::DmxOutputMultiplexer *multiplexer = NULL);
   ~FtdiDmxDevice();
 
   std::string DeviceId() const { return m_widget->Serial(); }
@@ -55,6 +60,9 @@ class FtdiDmxDevice : public Device {
   FtdiWidget *m_widget;
   const FtdiWidgetInfo m_widget_info;
   unsigned int m_frequency;
+  const bool m_realtime;
+  ExportMap *m_export_map;
+  ola::dmx::DmxOutputMultiplexer *m_multiplexer;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
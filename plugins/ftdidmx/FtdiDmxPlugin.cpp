@@ -23,12 +23,16 @@
  * by E.S. Rosenberg a.k.a. Keeper of the Keys 5774/2014
  */
 
+#include <algorithm>
+#include <set>
 #include <vector>
 #include <string>
 
+#include "ola/Callback.h"
 #include "ola/StringUtils.h"
 #include "olad/Preferences.h"
 #include "olad/PluginAdaptor.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/ftdidmx/FtdiDmxPlugin.h"
 #include "plugins/ftdidmx/FtdiDmxPluginDescription.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
@@ -38,17 +42,38 @@ namespace ola {
 namespace plugin {
 namespace ftdidmx {
 
+using ola::thread::MutexLocker;
+using std::set;
 using std::string;
 using std::vector;
 
+typedef vector<FtdiWidgetInfo> FtdiWidgetInfoVector;
+
 const char FtdiDmxPlugin::K_FREQUENCY[] = "frequency";
+const char FtdiDmxPlugin::K_REALTIME[] = "realtime";
+const char FtdiDmxPlugin::K_THREADS[] = "threads";
+const unsigned int FtdiDmxPlugin::MAX_THREADS;
 const char FtdiDmxPlugin::PLUGIN_NAME[] = "FTDI USB DMX";
 const char FtdiDmxPlugin::PLUGIN_PREFIX[] = "ftdidmx";
 
+/**
+ * @brief Create a new device for a widget
+ */
+void FtdiDmxPlugin::AddWidget(const FtdiWidgetInfo &widget_info) {
+  ola::dmx::DmxOutputMultiplexer *multiplexer = NULL;
+  if (!m_multiplexers.empty()) {
+    multiplexer = m_multiplexers[m_next_multiplexer++ % m_multiplexers.size()];
+  }
+  AddDevice(new FtdiDmxDevice(this, widget_info, m_frequency, m_realtime,
+                              m_plugin_adaptor->GetExportMap(), multiplexer));
+}
+
+
 /**
  * @brief Attempt to start a device and, if successful, register it
  *
- * Ownership of the FtdiDmxDevice is transfered to us here.
+ * Ownership of the FtdiDmxDevice is transfered to us here. Registering the
+ * device restores the port patches from the last time it was seen.
  */
 void FtdiDmxPlugin::AddDevice(FtdiDmxDevice *device) {
   if (device->Start()) {
@@ -62,21 +87,137 @@ void FtdiDmxPlugin::AddDevice(FtdiDmxDevice *device) {
 
 
 /**
- * @brief Fetch a list of all FTDI widgets and create a new device for each of them.
+ * @brief Unregister, stop and delete a device.
+ *
+ * Unregistering the device saves the port patches, so they can be restored if
+ * the widget returns.
  */
-bool FtdiDmxPlugin::StartHook() {
-  typedef vector<FtdiWidgetInfo> FtdiWidgetInfoVector;
+void FtdiDmxPlugin::RemoveDevice(FtdiDmxDevice *device) {
+  m_plugin_adaptor->UnregisterDevice(device);
+  device->Stop();
+  delete device;
+}
+
+
+/**
+ * @brief Add devices for new widgets and remove those that have gone away.
+ *
+ * Widgets are matched by serial number, so the devices that are still
+ * present are left alone.
+ */
+void FtdiDmxPlugin::RescanWidgets() {
   FtdiWidgetInfoVector widgets;
   FtdiWidget::Widgets(&widgets);
 
-  unsigned int frequency = StringToIntOrDefault(
-      m_preferences->GetValue(K_FREQUENCY),
-      DEFAULT_FREQUENCY);
+  set<string> present;
+  FtdiWidgetInfoVector::const_iterator widget_iter = widgets.begin();
+  for (; widget_iter != widgets.end(); ++widget_iter) {
+    present.insert(widget_iter->Serial());
+  }
+
+  set<string> existing;
+  FtdiDeviceVector::iterator iter = m_devices.begin();
+  while (iter != m_devices.end()) {
+    if (present.find((*iter)->DeviceId()) == present.end()) {
+      OLA_INFO << "FTDI device " << (*iter)->Description() << " removed";
+      RemoveDevice(*iter);
+      iter = m_devices.erase(iter);
+    } else {
+      existing.insert((*iter)->DeviceId());
+      ++iter;
+    }
+  }
+
+  for (widget_iter = widgets.begin(); widget_iter != widgets.end();
+       ++widget_iter) {
+    if (existing.find(widget_iter->Serial()) == existing.end()) {
+      OLA_INFO << "FTDI device " << widget_iter->Description() << " added";
+      AddWidget(*widget_iter);
+    }
+  }
+}
+
+
+/**
+ * @brief Rescan the widgets if there was a hotplug event for an FTDI device.
+ *
+ * This runs in the main thread, so there are no callbacks outstanding when
+ * the plugin is stopped.
+ */
+bool FtdiDmxPlugin::HotplugCheck() {
+  {
+    MutexLocker locker(&m_rescan_mutex);
+    if (!m_rescan_needed) {
+      return true;
+    }
+    m_rescan_needed = false;
+  }
+  RescanWidgets();
+  return true;
+}
+
+
+#ifdef HAVE_LIBUSB
+/**
+ * @brief Called by the HotplugAgent, possibly in the hotplug thread.
+ */
+void FtdiDmxPlugin::DeviceEvent(ola::usb::HotplugAgent::EventType,
+                                struct libusb_device *device) {
+  struct libusb_device_descriptor descriptor;
+  if (libusb_get_device_descriptor(device, &descriptor) ||
+      descriptor.idVendor != FtdiWidgetInfo::FTDI_VID) {
+    return;
+  }
+  MutexLocker locker(&m_rescan_mutex);
+  m_rescan_needed = true;
+}
+#endif  // HAVE_LIBUSB
+
+
+/**
+ * @brief Fetch a list of all FTDI widgets and create a new device for each of them.
+ */
+bool FtdiDmxPlugin::StartHook() {
+  m_frequency = StringToIntOrDefault(m_preferences->GetValue(K_FREQUENCY),
+                                     DEFAULT_FREQUENCY);
+  m_realtime = m_preferences->GetValueAsBool(K_REALTIME);
+  m_next_multiplexer = 0;
+  unsigned int threads = std::min(
+      StringToIntOrDefault(m_preferences->GetValue(K_THREADS),
+                           DEFAULT_THREADS),
+      MAX_THREADS);
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+
+  // If threads is set, the ports are shared between that many threads rather
+  // than each one getting its own.
+  for (unsigned int i = 0; i < threads; i++) {
+    ola::dmx::DmxOutputMultiplexer *multiplexer =
+        new ola::dmx::DmxOutputMultiplexer(m_realtime, export_map);
+    if (multiplexer->Start()) {
+      m_multiplexers.push_back(multiplexer);
+    } else {
+      OLA_WARN << "Failed to start FTDI output thread";
+      delete multiplexer;
+    }
+  }
+
+  RescanWidgets();
 
-  FtdiWidgetInfoVector::const_iterator iter;
-  for (iter = widgets.begin(); iter != widgets.end(); ++iter) {
-    AddDevice(new FtdiDmxDevice(this, *iter, frequency));
+#ifdef HAVE_LIBUSB
+  // Widgets that are plugged in or removed later are added or removed one
+  // at a time, without disturbing the others.
+  std::auto_ptr<ola::usb::HotplugAgent> agent(new ola::usb::HotplugAgent(
+      NewCallback(this, &FtdiDmxPlugin::DeviceEvent), 0));
+  if (agent->Init() && agent->Start()) {
+    m_agent.reset(agent.release());
+    m_hotplug_timeout = m_plugin_adaptor->RegisterPeriodicTask(
+        ola::TimeInterval(HOTPLUG_CHECK_INTERVAL_MS * ola::ONE_THOUSAND),
+        NewCallback(this, &FtdiDmxPlugin::HotplugCheck));
+  } else {
+    OLA_WARN << "Failed to start the USB hotplug agent, FTDI devices will "
+             << "only be detected when the plugin starts";
   }
+#endif  // HAVE_LIBUSB
   return true;
 }
 
@@ -85,13 +226,30 @@ bool FtdiDmxPlugin::StartHook() {
  * @brief Stop all the devices.
  */
 bool FtdiDmxPlugin::StopHook() {
+#ifdef HAVE_LIBUSB
+  if (m_agent.get()) {
+    m_agent->Stop();
+    m_agent.reset();
+  }
+#endif  // HAVE_LIBUSB
+  if (m_hotplug_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemovePeriodicTask(m_hotplug_timeout);
+    m_hotplug_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_rescan_needed = false;
+
   FtdiDeviceVector::iterator iter;
   for (iter = m_devices.begin(); iter != m_devices.end(); ++iter) {
-    m_plugin_adaptor->UnregisterDevice(*iter);
-    (*iter)->Stop();
-    delete (*iter);
+    RemoveDevice(*iter);
   }
   m_devices.clear();
+
+  // The ports have been removed, so the threads can be stopped.
+  MultiplexerVector::iterator multiplexer_iter = m_multiplexers.begin();
+  for (; multiplexer_iter != m_multiplexers.end(); ++multiplexer_iter) {
+    delete *multiplexer_iter;
+  }
+  m_multiplexers.clear();
   return true;
 }
 
@@ -112,9 +270,16 @@ bool FtdiDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
-                                     UIntValidator(1, 44),
-                                     DEFAULT_FREQUENCY)) {
+  bool save = m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
+                                             UIntValidator(1, 44),
+                                             DEFAULT_FREQUENCY);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_REALTIME,
+                                         BoolValidator(),
+                                         false);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_THREADS,
+                                         UIntValidator(0, MAX_THREADS),
+                                         DEFAULT_THREADS);
+  if (save) {
     m_preferences->Save();
   }
 
@@ -127,3 +292,5 @@ bool FtdiDmxPlugin::SetDefaultPreferences() {
 }  // namespace ftdidmx
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::ftdidmx::FtdiDmxPlugin)
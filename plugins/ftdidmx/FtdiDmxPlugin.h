@@ -21,14 +21,27 @@
 #ifndef PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 #define PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "ola/dmx/DmxOutputMultiplexer.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
+#include "plugins/ftdidmx/FtdiWidget.h"
+
+#ifdef HAVE_LIBUSB
+#include "libs/usb/HotplugAgent.h"
+#endif  // HAVE_LIBUSB
 
 namespace ola {
 namespace plugin {
@@ -38,7 +51,12 @@ namespace ftdidmx {
 class FtdiDmxPlugin : public Plugin {
  public:
   explicit FtdiDmxPlugin(ola::PluginAdaptor *plugin_adaptor)
-      : Plugin(plugin_adaptor) {
+      : Plugin(plugin_adaptor),
+        m_frequency(DEFAULT_FREQUENCY),
+        m_realtime(false),
+        m_next_multiplexer(0),
+        m_rescan_needed(false),
+        m_hotplug_timeout(ola::thread::INVALID_TIMEOUT) {
   }
 
   ola_plugin_id Id() const { return OLA_PLUGIN_FTDIDMX; }
@@ -56,16 +74,43 @@ class FtdiDmxPlugin : public Plugin {
 
  private:
   typedef std::vector<FtdiDmxDevice*> FtdiDeviceVector;
+  typedef std::vector<ola::dmx::DmxOutputMultiplexer*> MultiplexerVector;
   FtdiDeviceVector m_devices;
+  MultiplexerVector m_multiplexers;
+  unsigned int m_frequency;
+  bool m_realtime;
+  unsigned int m_next_multiplexer;
+
+  // Set by the hotplug thread, checked by HotplugCheck() in the main thread.
+  ola::thread::Mutex m_rescan_mutex;
+  bool m_rescan_needed;  // GUARDED_BY(m_rescan_mutex)
+  ola::thread::timeout_id m_hotplug_timeout;
+#ifdef HAVE_LIBUSB
+  std::auto_ptr<ola::usb::HotplugAgent> m_agent;
 
+  void DeviceEvent(ola::usb::HotplugAgent::EventType event,
+                   struct libusb_device *device);
+#endif  // HAVE_LIBUSB
+
+  void AddWidget(const FtdiWidgetInfo &widget_info);
   void AddDevice(FtdiDmxDevice *device);
+  void RemoveDevice(FtdiDmxDevice *device);
+  void RescanWidgets();
+  bool HotplugCheck();
   bool StartHook();
   bool StopHook();
   bool SetDefaultPreferences();
 
+  // How often we check if a hotplug event requires a rescan.
+  static const unsigned int HOTPLUG_CHECK_INTERVAL_MS = 1000;
+
   static const uint8_t DEFAULT_FREQUENCY = 30;
+  static const unsigned int DEFAULT_THREADS = 0;
+  static const unsigned int MAX_THREADS = 16;
 
   static const char K_FREQUENCY[];
+  static const char K_REALTIME[];
+  static const char K_THREADS[];
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
 };
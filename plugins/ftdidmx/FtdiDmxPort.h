@@ -26,9 +26,12 @@
 #ifndef PLUGINS_FTDIDMX_FTDIDMXPORT_H_
 #define PLUGINS_FTDIDMX_FTDIDMXPORT_H_
 
+#include <memory>
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
@@ -41,29 +44,52 @@ namespace ftdidmx {
 
 class FtdiDmxOutputPort : public ola::BasicOutputPort {
  public:
+    /*
+     * If a multiplexer is provided, the port is driven by the multiplexer's
+     * thread, otherwise it gets a thread of its own.
+     */
     FtdiDmxOutputPort(FtdiDmxDevice *parent,
                       FtdiInterface *interface,
                       unsigned int id,
-                      unsigned int freq)
+                      unsigned int freq,
+                      bool realtime,
+                      ExportMap *export_map,
+                      ola::dmx::DmxOutputMultiplexer *multiplexer)
         : BasicOutputPort(parent, id),
           m_interface(interface),
-          m_thread(interface, freq) {
-      m_thread.Start();
+          m_multiplexer(multiplexer) {
+      if (m_multiplexer) {
+        ola::dmx::DmxOutputMultiplexer::Timing timing;
+        timing.frame_rate = freq;
+        m_multiplexer->AddOutput(interface, timing);
+      } else {
+        m_thread.reset(
+            new FtdiDmxThread(interface, freq, realtime, export_map));
+        m_thread->Start();
+      }
     }
     ~FtdiDmxOutputPort() {
-      m_thread.Stop();
+      if (m_multiplexer) {
+        m_multiplexer->RemoveOutput(m_interface);
+      }
+      // This stops the thread, it must happen before the interface is deleted.
+      m_thread.reset();
       delete m_interface;
     }
 
     bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-      return m_thread.WriteDMX(buffer);
+      if (m_multiplexer) {
+        return m_multiplexer->WriteDMX(m_interface, buffer);
+      }
+      return m_thread->WriteDMX(buffer);
     }
 
     std::string Description() const { return m_interface->Description(); }
 
  private:
     FtdiInterface *m_interface;
-    FtdiDmxThread m_thread;
+    ola::dmx::DmxOutputMultiplexer *m_multiplexer;
+    std::auto_ptr<FtdiDmxThread> m_thread;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
@@ -23,7 +23,6 @@
  * by E.S. Rosenberg a.k.a. Keeper of the Keys 5774/2014
  */
 
-#include <math.h>
 #include <unistd.h>
 
 #include <string>
@@ -38,11 +37,16 @@ namespace ola {
 namespace plugin {
 namespace ftdidmx {
 
-FtdiDmxThread::FtdiDmxThread(FtdiInterface *interface, unsigned int frequency)
-  : m_granularity(UNKNOWN),
+FtdiDmxThread::FtdiDmxThread(FtdiInterface *interface,
+                             unsigned int frequency,
+                             bool realtime,
+                             ExportMap *export_map)
+  : ola::thread::Thread(ola::thread::Thread::Options("ftdi-dmx")),
+    m_granularity(UNKNOWN),
     m_interface(interface),
     m_term(false),
-    m_frequency(frequency) {
+    m_realtime(realtime),
+    m_timer(frequency, export_map, interface->Description()) {
 }
 
 FtdiDmxThread::~FtdiDmxThread() {
@@ -66,11 +70,13 @@ bool FtdiDmxThread::Stop() {
  * @brief Copy a DMXBuffer to the output thread
  */
 bool FtdiDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  {
-    ola::thread::MutexLocker locker(&m_buffer_mutex);
-    m_buffer.Set(buffer);
-    return true;
+  // The output thread doesn't see the slot until it's published.
+  DmxBuffer *frame = m_frame.WriteSlot();
+  if (!frame->Set(buffer)) {
+    frame->Reset();
   }
+  m_frame.Publish();
+  return true;
 }
 
 
@@ -78,13 +84,12 @@ bool FtdiDmxThread::WriteDMX(const DmxBuffer &buffer) {
  * @brief The method called by the thread
  */
 void *FtdiDmxThread::Run() {
-  TimeStamp ts1, ts2, ts3;
-  Clock clock;
   CheckTimeGranularity();
-  DmxBuffer buffer;
 
-  int frameTime = static_cast<int>(floor(
-    (static_cast<double>(1000) / m_frequency) + static_cast<double>(0.5)));
+  if (m_realtime && !ola::dmx::FrameTimer::UseRealtimeScheduling()) {
+    OLA_WARN << "Failed to enable real time scheduling for "
+             << m_interface->Description();
+  }
 
   // Setup the interface
   if (!m_interface->IsOpen()) {
@@ -99,19 +104,19 @@ void *FtdiDmxThread::Run() {
       }
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    m_frame.Fetch();
+    const DmxBuffer &buffer = *m_frame.ReadSlot();
 
-    clock.CurrentTime(&ts1);
+    m_timer.StartFrame();
 
     if (!m_interface->SetBreak(true)) {
       goto framesleep;
     }
 
+    // If the timer is coarse, the time taken to toggle the line is a long
+    // enough break and MAB.
     if (m_granularity == GOOD) {
-      usleep(DMX_BREAK);
+      m_timer.Delay(DMX_BREAK);
     }
 
     if (!m_interface->SetBreak(false)) {
@@ -119,7 +124,7 @@ void *FtdiDmxThread::Run() {
     }
 
     if (m_granularity == GOOD) {
-      usleep(DMX_MAB);
+      m_timer.Delay(DMX_MAB);
     }
 
     if (!m_interface->Write(buffer)) {
@@ -128,31 +133,7 @@ void *FtdiDmxThread::Run() {
 
   framesleep:
     // Sleep for the remainder of the DMX frame time
-    clock.CurrentTime(&ts2);
-    TimeInterval elapsed = ts2 - ts1;
-
-    if (m_granularity == GOOD) {
-      while (elapsed.InMilliSeconds() < frameTime) {
-        usleep(1000);
-        clock.CurrentTime(&ts2);
-        elapsed = ts2 - ts1;
-      }
-    } else {
-      // See if we can drop out of bad mode.
-      usleep(1000);
-      clock.CurrentTime(&ts3);
-      TimeInterval interval = ts3 - ts2;
-      if (interval.InMilliSeconds() < BAD_GRANULARITY_LIMIT) {
-        m_granularity = GOOD;
-        OLA_INFO << "Switching from BAD to GOOD granularity for ftdi thread";
-      }
-
-      elapsed = ts3 - ts1;
-      while (elapsed.InMilliSeconds() < frameTime) {
-        clock.CurrentTime(&ts2);
-        elapsed = ts2 - ts1;
-      }
-    }
+    m_timer.WaitForNextFrame();
   }
   return NULL;
 }
@@ -26,8 +26,13 @@
 #ifndef PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
 #define PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
 
+#include <string>
+
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameTimer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -35,7 +40,18 @@ namespace ftdidmx {
 
 class FtdiDmxThread : public ola::thread::Thread {
  public:
-    FtdiDmxThread(FtdiInterface *interface, unsigned int frequency);
+    /**
+     * @brief Create a new FtdiDmxThread.
+     * @param interface the interface to send on.
+     * @param frequency the number of frames per second.
+     * @param realtime true to run the thread with real time scheduling.
+     * @param export_map the ExportMap to record the timing stats in, may be
+     *   NULL.
+     */
+    FtdiDmxThread(FtdiInterface *interface,
+                  unsigned int frequency,
+                  bool realtime = false,
+                  ExportMap *export_map = NULL);
     ~FtdiDmxThread();
 
     bool Stop();
@@ -48,10 +64,10 @@ class FtdiDmxThread : public ola::thread::Thread {
     TimerGranularity m_granularity;
     FtdiInterface *m_interface;
     bool m_term;
-    unsigned int m_frequency;
-    DmxBuffer m_buffer;
+    const bool m_realtime;
+    ola::dmx::FrameTimer m_timer;
+    ola::thread::TripleBuffer<DmxBuffer> m_frame;
     ola::thread::Mutex m_term_mutex;
-    ola::thread::Mutex m_buffer_mutex;
 
     void CheckTimeGranularity();
 
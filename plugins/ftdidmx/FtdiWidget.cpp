@@ -98,6 +98,9 @@ bool FtdiWidget::m_missing_serial = false;
 void FtdiWidget::Widgets(vector<FtdiWidgetInfo> *widgets) {
   int i = -1;
   widgets->clear();
+  // We can be called again when widgets are hotplugged, so this is reset for
+  // each scan.
+  FtdiWidget::m_missing_serial = false;
   struct ftdi_context *ftdi = ftdi_new();
   if (!ftdi) {
     OLA_WARN << "Failed to allocate FTDI context";
@@ -24,6 +24,13 @@ plugins_ftdidmx_libolaftdidmx_la_LIBADD = \
     $(libftdi_LIBS) \
     common/libolacommon.la \
     olad/plugin_api/libolaserverplugininterface.la
+
+if USE_LIBUSB
+# Used to detect widgets that are plugged in while olad is running.
+plugins_ftdidmx_libolaftdidmx_la_CXXFLAGS = $(COMMON_CXXFLAGS) \
+                                            $(libusb_CFLAGS)
+plugins_ftdidmx_libolaftdidmx_la_LIBADD += libs/usb/libolausb.la
+endif
 endif
 
 EXTRA_DIST += plugins/ftdidmx/README.md
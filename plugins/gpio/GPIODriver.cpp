@@ -24,9 +24,13 @@
 #include <fcntl.h>
 #include <stdint.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#ifdef HAVE_LINUX_GPIO_H
+#include <linux/gpio.h>
+#endif  // HAVE_LINUX_GPIO_H
 
 #include <sstream>
 #include <string>
@@ -47,7 +51,9 @@ using std::string;
 using std::vector;
 
 GPIODriver::GPIODriver(const Options &options)
-    : m_options(options),
+    : ola::thread::Thread(ola::thread::Thread::Options("gpio")),
+      m_options(options),
+      m_line_fd(-1),
       m_term(false),
       m_dmx_changed(false) {
 }
@@ -116,6 +122,10 @@ void *GPIODriver::Run() {
 }
 
 bool GPIODriver::SetupGPIO() {
+  if (!m_options.gpio_chip.empty()) {
+    return SetupLineRequest();
+  }
+
   /**
    * This relies on the pins being exported:
    *   echo N > /sys/class/gpio/export
@@ -160,6 +170,47 @@ bool GPIODriver::SetupGPIO() {
   return true;
 }
 
+bool GPIODriver::SetupLineRequest() {
+#ifdef HAVE_LINUX_GPIO_H
+  if (m_options.gpio_pins.size() > GPIOHANDLES_MAX) {
+    OLA_WARN << "At most " << GPIOHANDLES_MAX << " pins can be used with "
+             << m_options.gpio_chip;
+    return false;
+  }
+
+  int chip_fd;
+  if (!ola::io::Open(m_options.gpio_chip, O_RDWR, &chip_fd)) {
+    return false;
+  }
+
+  struct gpiohandle_request request;
+  memset(&request, 0, sizeof(request));
+  request.flags = GPIOHANDLE_REQUEST_OUTPUT;
+  request.lines = m_options.gpio_pins.size();
+  strncpy(request.consumer_label, "olad", sizeof(request.consumer_label) - 1);
+  for (unsigned int i = 0; i < m_options.gpio_pins.size(); i++) {
+    request.lineoffsets[i] = m_options.gpio_pins[i];
+  }
+
+  int r = ioctl(chip_fd, GPIO_GET_LINEHANDLE_IOCTL, &request);
+  close(chip_fd);
+  if (r < 0) {
+    OLA_WARN << "Failed to request the lines on " << m_options.gpio_chip
+             << ": " << strerror(errno);
+    return false;
+  }
+
+  m_line_fd = request.fd;
+  GPIOPin pin = {-1, UNDEFINED, false};
+  m_gpio_pins.assign(m_options.gpio_pins.size(), pin);
+  return true;
+#else
+  OLA_WARN << "GPIO character devices aren't supported on this platform, "
+           << "can't use " << m_options.gpio_chip;
+  return false;
+#endif  // HAVE_LINUX_GPIO_H
+}
+
 bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
   enum Action {
     TURN_ON,
@@ -167,6 +218,7 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
     NO_CHANGE,
   };
 
+  bool changed = false;
   for (uint16_t i = 0;
        i < m_gpio_pins.size() && (i + m_options.start_address < dmx.Size());
        i++) {
@@ -187,8 +239,12 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
         action = (slot_value >= m_options.turn_on ? TURN_ON : TURN_OFF);
     }
 
-    // Change the pin state if required.
-    if (action != NO_CHANGE) {
+    if (action != NO_CHANGE && m_line_fd >= 0) {
+      // The new values are set together once all the pins are done.
+      m_gpio_pins[i].state = (action == TURN_ON ? ON : OFF);
+      changed = true;
+    } else if (action != NO_CHANGE) {
+      // Change the pin state if required.
       char data = (action == TURN_ON ? '1' : '0');
       if (write(m_gpio_pins[i].fd, &data, sizeof(data)) < 0) {
         OLA_WARN << "Failed to toggle GPIO pin " << i << ", fd "
@@ -199,15 +255,38 @@ bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
       m_gpio_pins[i].state = (action == TURN_ON ? ON : OFF);
     }
   }
+  return changed ? SetLineValues() : true;
+}
+
+bool GPIODriver::SetLineValues() {
+#ifdef HAVE_LINUX_GPIO_H
+  struct gpiohandle_data data;
+  memset(&data, 0, sizeof(data));
+  for (unsigned int i = 0; i < m_gpio_pins.size(); i++) {
+    data.values[i] = (m_gpio_pins[i].state == ON);
+  }
+  if (ioctl(m_line_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data) < 0) {
+    OLA_WARN << "Failed to set the GPIO lines on " << m_options.gpio_chip
+             << ": " << strerror(errno);
+    return false;
+  }
+#endif  // HAVE_LINUX_GPIO_H
   return true;
 }
 
 void GPIODriver::CloseGPIOFDs() {
   GPIOPins::iterator iter = m_gpio_pins.begin();
   for (; iter != m_gpio_pins.end(); ++iter) {
-    close(iter->fd);
+    if (iter->fd >= 0) {
+      close(iter->fd);
+    }
   }
   m_gpio_pins.clear();
+
+  if (m_line_fd >= 0) {
+    close(m_line_fd);
+    m_line_fd = -1;
+  }
 }
 }  // namespace gpio
 }  // namespace plugin
@@ -26,6 +26,7 @@
 #include <ola/base/Macro.h>
 #include <ola/thread/Thread.h>
 
+#include <string>
 #include <vector>
 
 namespace ola {
@@ -63,6 +64,15 @@ class GPIODriver : private ola::thread::Thread {
      * @brief The value below which a pin will be turned off.
      */
     uint8_t turn_off;
+
+    /**
+     * @brief The GPIO character device, e.g. /dev/gpiochip0.
+     *
+     * If this is set, gpio_pins are line offsets on the chip and all the
+     * pins are set with a single ioctl() per frame. Otherwise each pin is
+     * written through its sysfs value file.
+     */
+    std::string gpio_chip;
   };
 
   /**
@@ -114,6 +124,7 @@ class GPIODriver : private ola::thread::Thread {
 
   const Options m_options;
   GPIOPins m_gpio_pins;
+  int m_line_fd;
 
   DmxBuffer m_buffer;
   bool m_term;  // GUARDED_BY(m_mutex);
@@ -122,7 +133,9 @@ class GPIODriver : private ola::thread::Thread {
   ola::thread::ConditionVariable m_cond;
 
   bool SetupGPIO();
+  bool SetupLineRequest();
   bool UpdateGPIOPins(const DmxBuffer &dmx);
+  bool SetLineValues();
   void CloseGPIOFDs();
 
   static const char GPIO_BASE_DIR[];
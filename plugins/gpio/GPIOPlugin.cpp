@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "plugins/gpio/GPIODevice.h"
@@ -38,6 +39,7 @@ using std::auto_ptr;
 using std::string;
 using std::vector;
 
+const char GPIOPlugin::GPIO_CHIP_KEY[] = "gpio_chip";
 const char GPIOPlugin::GPIO_PINS_KEY[] = "gpio_pins";
 const char GPIOPlugin::GPIO_SLOT_OFFSET_KEY[] = "gpio_slot_offset";
 const char GPIOPlugin::GPIO_TURN_OFF_KEY[] = "gpio_turn_off";
@@ -71,6 +73,8 @@ bool GPIOPlugin::StartHook() {
     return false;
   }
 
+  options.gpio_chip = m_preferences->GetValue(GPIO_CHIP_KEY);
+
   vector<string> pin_list;
   StringSplit(m_preferences->GetValue(GPIO_PINS_KEY), &pin_list, ",");
   vector<string>::const_iterator iter = pin_list.begin();
@@ -121,6 +125,9 @@ bool GPIOPlugin::SetDefaultPreferences() {
   if (!m_preferences)
     return false;
 
+  save |= m_preferences->SetDefaultValue(GPIO_CHIP_KEY,
+                                         StringValidator(true),
+                                         "");
   save |= m_preferences->SetDefaultValue(GPIO_PINS_KEY,
                                          StringValidator(),
                                          "");
@@ -149,3 +156,5 @@ bool GPIOPlugin::SetDefaultPreferences() {
 }  // namespace gpio
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::gpio::GPIOPlugin)
@@ -354,21 +354,7 @@ bool KarateLight::SendCommand(uint8_t cmd, const uint8_t *output_buffer,
     return false;
   }
 
-  // build header
-  wr_buffer[CMD_HD_SYNC] = CMD_SYNC_SEND;
-  wr_buffer[CMD_HD_COMMAND] = cmd;
-  wr_buffer[CMD_HD_LEN] = n_bytes_to_write;
-
-  // copy data to our local buffer
-  memcpy(&wr_buffer[CMD_DATA_START], output_buffer, n_bytes_to_write);
-
-  // calc checksum
-  wr_buffer[CMD_HD_CHECK] = 0;  // clear byte 2
-  for (int i = 0; i < cmd_length; i++) {
-    if (i != CMD_HD_CHECK) {
-      wr_buffer[CMD_HD_CHECK] ^= wr_buffer[i];
-    }
-  }
+  BuildCommand(cmd, output_buffer, n_bytes_to_write, wr_buffer);
 
   // now write to the serial port
   if (write(m_fd, wr_buffer, cmd_length) != cmd_length) {
@@ -388,35 +374,84 @@ bool KarateLight::SendCommand(uint8_t cmd, const uint8_t *output_buffer,
   return true;
 }
 
+/**
+ * @brief Builds a command, header, payload and checksum
+ * @param cmd the commandcode to be used
+ * @param data the payload-data
+ * @param length the number of bytes of payload-data
+ * @param buffer where to build the command, this must have room for
+ *     length + CMD_DATA_START bytes
+ * @returns the length of the command
+ */
+unsigned int KarateLight::BuildCommand(uint8_t cmd, const uint8_t *data,
+                                       unsigned int length, uint8_t *buffer) {
+  const unsigned int cmd_length = length + CMD_DATA_START;
+
+  // build header
+  buffer[CMD_HD_SYNC] = CMD_SYNC_SEND;
+  buffer[CMD_HD_COMMAND] = cmd;
+  buffer[CMD_HD_LEN] = length;
+
+  // copy the payload
+  memcpy(&buffer[CMD_DATA_START], data, length);
+
+  // calc checksum
+  buffer[CMD_HD_CHECK] = 0;
+  for (unsigned int i = 0; i < cmd_length; i++) {
+    if (i != CMD_HD_CHECK) {
+      buffer[CMD_HD_CHECK] ^= buffer[i];
+    }
+  }
+  return cmd_length;
+}
+
 /**
  * @brief Sends color values currently stored in the local buffer
  * to the hardware.
+ *
+ * Only the chunks that changed are sent. The commands for all of them go
+ * out in a single write, then we collect the replies.
  * @returns true on success
  */
 bool KarateLight::UpdateColors() {
-  int block;
-  int n_chunks;
-
   if (!m_active)
     return false;
 
-  n_chunks = (m_nChannels + CHUNK_SIZE - 1) / CHUNK_SIZE;
-
-  // write colors
-  for (block = 0; block < n_chunks; block++) {
-    if ((memcmp(&m_color_buffer[block * CHUNK_SIZE],
-         &m_color_buffer_old[block * CHUNK_SIZE], CHUNK_SIZE) == 0)
-         && (m_use_memcmp == 1)) {
+  const unsigned int n_chunks = std::min(
+      (m_nChannels + CHUNK_SIZE - 1) / CHUNK_SIZE,
+      static_cast<int>(MAX_CHUNKS));
+
+  // build the commands for the chunks that changed
+  unsigned int frame_length = 0;
+  unsigned int n_commands = 0;
+  for (unsigned int block = 0; block < n_chunks; block++) {
+    const uint8_t *chunk = &m_color_buffer[block * CHUNK_SIZE];
+    if (m_use_memcmp == 1 &&
+        memcmp(chunk, &m_color_buffer_old[block * CHUNK_SIZE],
+               CHUNK_SIZE) == 0) {
       continue;
     }
-    if (!SendCommand(CMD_SET_DATA_00 + block,  // cmd-code
-                     &m_color_buffer[block * CHUNK_SIZE],  // data to write
-                     CHUNK_SIZE,  // len of data
-                     NULL,  // buffer for incoming data
-                     0)) {  // number of data-bytes expected
+    frame_length += BuildCommand(CMD_SET_DATA_00 + block, chunk, CHUNK_SIZE,
+                                 &m_frame_buffer[frame_length]);
+    n_commands++;
+  }
+
+  if (n_commands) {
+    const ssize_t written = write(m_fd, m_frame_buffer, frame_length);
+    if (written != static_cast<ssize_t>(frame_length)) {
+      OLA_WARN << "Failed to write data to " << m_devname;
       KarateLight::Close();
       return false;
     }
+
+    // each command is acknowledged with an empty reply
+    for (unsigned int i = 0; i < n_commands; i++) {
+      uint8_t n_bytes_read = 0;
+      if (!ReadBack(NULL, &n_bytes_read)) {
+        KarateLight::Close();
+        return false;
+      }
+    }
   }
   // update old_values
   memcpy(m_color_buffer_old, m_color_buffer, DMX_UNIVERSE_SIZE);
@@ -52,6 +52,8 @@ class KarateLight {
   bool SendCommand(uint8_t cmd, const uint8_t *output_buffer,
                    int n_bytes_to_write, uint8_t *input_buffer,
                    int n_bytes_expected);
+  static unsigned int BuildCommand(uint8_t cmd, const uint8_t *data,
+                                   unsigned int length, uint8_t *buffer);
   bool UpdateColors();
 
   const std::string m_devname;
@@ -59,6 +61,7 @@ class KarateLight {
 
   static const uint16_t CMD_MAX_LENGTH = 64;
   static const uint16_t CHUNK_SIZE = 32;
+  static const uint16_t MAX_CHUNKS = DMX_UNIVERSE_SIZE / CHUNK_SIZE;
 
   uint8_t m_fw_version;
   uint8_t m_hw_version;
@@ -78,6 +81,9 @@ class KarateLight {
   static const uint8_t CMD_HD_LEN = 0x03;
   static const uint8_t CMD_DATA_START = 0x04;
 
+  // The SET_DATA commands for a frame, sent in a single write.
+  uint8_t m_frame_buffer[MAX_CHUNKS * (CMD_DATA_START + CHUNK_SIZE)];
+
   // sync words
   static const uint8_t CMD_SYNC_SEND = 0xAA;
   static const uint8_t CMD_SYNC_RECV = 0x55;
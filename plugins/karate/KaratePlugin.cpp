@@ -31,6 +31,7 @@
 #include "ola/io/IOUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/karate/KarateDevice.h"
 #include "plugins/karate/KaratePlugin.h"
 #include "plugins/karate/KaratePluginDescription.h"
@@ -133,3 +134,5 @@ bool KaratePlugin::SetDefaultPreferences() {
 }  // namespace karate
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::karate::KaratePlugin)
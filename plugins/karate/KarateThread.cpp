@@ -50,7 +50,7 @@ using std::string;
  * @brief Create a new KarateThread object
  */
 KarateThread::KarateThread(const string &path)
-    : ola::thread::Thread(),
+    : ola::thread::Thread(ola::thread::Thread::Options("karate")),
       m_path(path),
       m_term(false) {
 }
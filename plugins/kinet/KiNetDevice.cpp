@@ -46,10 +46,14 @@ using std::vector;
  */
 KiNetDevice::KiNetDevice(
     AbstractPlugin *owner,
-    const vector<ola::network::IPV4Address> &power_supplies,
-    PluginAdaptor *plugin_adaptor)
+    const vector<KiNetPowerSupply> &power_supplies,
+    PluginAdaptor *plugin_adaptor,
+    unsigned int send_buffer_size,
+    unsigned int transmit_pacing_ms)
     : Device(owner, "KiNet Device"),
       m_power_supplies(power_supplies),
+      m_send_buffer_size(send_buffer_size),
+      m_transmit_pacing_ms(transmit_pacing_ms),
       m_node(NULL),
       m_plugin_adaptor(plugin_adaptor) {
 }
@@ -60,7 +64,11 @@ KiNetDevice::KiNetDevice(
  * @return true on success, false on failure
  */
 bool KiNetDevice::StartHook() {
-  m_node = new KiNetNode(m_plugin_adaptor);
+  // All the ports are written in the same iteration of the event loop when a
+  // universe fans out, so batch the sends.
+  m_node = new KiNetNode(m_plugin_adaptor, NULL, true);
+  m_node->SetSendBufferSize(m_send_buffer_size);
+  m_node->SetTransmitPacing(m_transmit_pacing_ms);
 
   if (!m_node->Start()) {
     delete m_node;
@@ -68,10 +76,16 @@ bool KiNetDevice::StartHook() {
     return false;
   }
 
-  vector<IPV4Address>::const_iterator iter = m_power_supplies.begin();
+  vector<KiNetPowerSupply>::const_iterator iter = m_power_supplies.begin();
   unsigned int port_id = 0;
   for (; iter != m_power_supplies.end(); ++iter) {
-    AddPort(new KiNetOutputPort(this, *iter, m_node, port_id++));
+    if (!iter->portout_ports) {
+      AddPort(new KiNetOutputPort(this, iter->ip, m_node, port_id++));
+      continue;
+    }
+    for (unsigned int i = 1; i <= iter->portout_ports; i++) {
+      AddPort(new KiNetOutputPort(this, iter->ip, m_node, port_id++, i));
+    }
   }
   return true;
 }
@@ -31,11 +31,24 @@ namespace ola {
 namespace plugin {
 namespace kinet {
 
+/*
+ * A power supply to send to.
+ */
+struct KiNetPowerSupply {
+  ola::network::IPV4Address ip;
+  // The number of ports to send PORTOUT packets to, or 0 to send DMXOUT.
+  unsigned int portout_ports;
+
+  KiNetPowerSupply() : portout_ports(0) {}
+};
+
 class KiNetDevice: public ola::Device {
  public:
     KiNetDevice(AbstractPlugin *owner,
-                const std::vector<ola::network::IPV4Address> &power_supplies,
-                class PluginAdaptor *plugin_adaptor);
+                const std::vector<KiNetPowerSupply> &power_supplies,
+                class PluginAdaptor *plugin_adaptor,
+                unsigned int send_buffer_size = 0,
+                unsigned int transmit_pacing_ms = 0);
 
     // Only one KiNet device
     std::string DeviceId() const { return "1"; }
@@ -46,7 +59,9 @@ class KiNetDevice: public ola::Device {
     void PostPortStop();
 
  private:
-    const std::vector<ola::network::IPV4Address> m_power_supplies;
+    const std::vector<KiNetPowerSupply> m_power_supplies;
+    const unsigned int m_send_buffer_size;
+    const unsigned int m_transmit_pacing_ms;
     class KiNetNode *m_node;
     class PluginAdaptor *m_plugin_adaptor;
 };
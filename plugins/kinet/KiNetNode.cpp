@@ -18,8 +18,10 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <string.h>
 #include <memory>
 
+#include "ola/Clock.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/network/IPV4Address.h"
@@ -35,17 +37,51 @@ using ola::network::IPV4SocketAddress;
 using ola::network::UDPSocket;
 using std::auto_ptr;
 
+namespace {
+// The packet headers never change, so rather than serializing the fields for
+// every frame they're kept pre-built and copied in front of the data. All
+// multi-byte fields are little endian, and everything sets the sequence
+// number to 0.
+
+// V1 DMXOUT: magic, version 1, type 0x0101, sequence, then port 0, flags 0,
+// timer 0, universe 0xffffffff and the start code.
+const uint8_t DMXOUT_HEADER[] = {
+  0x04, 0x01, 0xdc, 0x4a, 0x01, 0x00, 0x01, 0x01,
+  0, 0, 0, 0,
+  0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff,
+  DMX512_START_CODE
+};
+
+// V2 PORTOUT: magic, version 2, type 0x0108, sequence, then universe
+// 0xffffffff, port, pad, flags, length and a 16 bit start code.
+const uint8_t PORTOUT_HEADER[] = {
+  0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00, 0x08, 0x01,
+  0, 0, 0, 0,
+  0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0, 0, 0,
+  DMX512_START_CODE, 0
+};
+const unsigned int PORTOUT_PORT_OFFSET = 16;
+const unsigned int PORTOUT_LENGTH_OFFSET = 20;
+}  // namespace
+
 /*
  * Create a new KiNet node.
  * @param ss a SelectServerInterface to use
  * @param socket a UDPSocket or Null. Ownership is transferred.
+ * @param batch_transmit true to send the packets for each iteration of the
+ *   event loop together.
  */
 KiNetNode::KiNetNode(ola::io::SelectServerInterface *ss,
-                     ola::network::UDPSocketInterface *socket)
+                     ola::network::UDPSocketInterface *socket,
+                     bool batch_transmit)
     : m_running(false),
+      m_batch_transmit(batch_transmit),
+      m_send_buffer_size(0),
+      m_transmit_pacing_ms(0),
       m_ss(ss),
-      m_output_stream(&m_output_queue),
-      m_socket(socket) {
+      m_socket(socket),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  MAX_PACKET_SIZE) {
 }
 
 
@@ -66,6 +102,13 @@ bool KiNetNode::Start() {
 
   if (!InitNetwork())
     return false;
+
+  if (m_batch_transmit) {
+    m_tx_batcher.reset(new ola::network::UDPTransmitBatcher(
+        m_ss, m_socket.get(), NULL, "kinet"));
+    m_tx_batcher->SetPacing(TimeInterval(
+        static_cast<int64_t>(m_transmit_pacing_ms) * ONE_THOUSAND));
+  }
   m_running = true;
   return true;
 }
@@ -79,6 +122,8 @@ bool KiNetNode::Stop() {
     return false;
 
   m_ss->RemoveReadDescriptor(m_socket.get());
+  // This sends anything still queued.
+  m_tx_batcher.reset();
   m_socket.reset();
   m_running = false;
   return true;
@@ -89,59 +134,65 @@ bool KiNetNode::Stop() {
  * Send some DMX data
  */
 bool KiNetNode::SendDMX(const IPV4Address &target_ip, const DmxBuffer &buffer) {
-  static const uint8_t port = 0;
-  static const uint8_t flags = 0;
-  static const uint16_t timer_val = 0;
-  static const uint32_t universe = 0xffffffff;
-
   if (!buffer.Size()) {
     OLA_DEBUG << "Not sending 0 length packet";
     return true;
   }
 
-  m_output_queue.Clear();
-  PopulatePacketHeader(KINET_DMX_MSG);
-  m_output_stream << port << flags << timer_val << universe;
-  m_output_stream << DMX512_START_CODE;
-  m_output_stream.Write(buffer.GetRaw(), buffer.Size());
+  memcpy(m_packet, DMXOUT_HEADER, sizeof(DMXOUT_HEADER));
+  unsigned int length = MAX_PACKET_SIZE - sizeof(DMXOUT_HEADER);
+  buffer.Get(m_packet + sizeof(DMXOUT_HEADER), &length);
+  return SendPacket(target_ip, sizeof(DMXOUT_HEADER) + length);
+}
 
-  IPV4SocketAddress target(target_ip, KINET_PORT);
-  bool ok = m_socket->SendTo(&m_output_queue, target);
-  if (!ok)
-    OLA_WARN << "Failed to send KiNet DMX packet";
 
-  if (!m_output_queue.Empty()) {
-    OLA_WARN << "Failed to send complete KiNet packet";
-    m_output_queue.Clear();
+/*
+ * Send some DMX data to one port of a power supply.
+ */
+bool KiNetNode::SendPortOut(const IPV4Address &target_ip, uint8_t port,
+                            const DmxBuffer &buffer) {
+  if (!buffer.Size()) {
+    OLA_DEBUG << "Not sending 0 length packet";
+    return true;
   }
-  return ok;
+
+  memcpy(m_packet, PORTOUT_HEADER, sizeof(PORTOUT_HEADER));
+  unsigned int length = MAX_PACKET_SIZE - sizeof(PORTOUT_HEADER);
+  buffer.Get(m_packet + sizeof(PORTOUT_HEADER), &length);
+  m_packet[PORTOUT_PORT_OFFSET] = port;
+  m_packet[PORTOUT_LENGTH_OFFSET] = length & 0xff;
+  m_packet[PORTOUT_LENGTH_OFFSET + 1] = length >> 8;
+  return SendPacket(target_ip, sizeof(PORTOUT_HEADER) + length);
 }
 
 
 /*
- * Called when there is data on this socket. Right now we discard all packets.
+ * Send the packet in m_packet, or queue it if we're batching.
  */
-void KiNetNode::SocketReady() {
-  uint8_t packet[1500];
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size,
-                          &source))
-    return;
+bool KiNetNode::SendPacket(const IPV4Address &target_ip, unsigned int size) {
+  IPV4SocketAddress target(target_ip, KINET_PORT);
+  ssize_t bytes_sent = m_tx_batcher.get() ?
+      m_tx_batcher->SendTo(m_packet, size, target) :
+      m_socket->SendTo(m_packet, size, target);
 
-  OLA_INFO << "Received Kinet packet from " << source << ", discarding";
+  if (bytes_sent != static_cast<ssize_t>(size)) {
+    OLA_WARN << "Failed to send KiNet packet, only sent " << bytes_sent
+             << " of " << size;
+    return false;
+  }
+  return true;
 }
 
 
 /*
- * Fill in the header for a packet
+ * Called when there is data on this socket. Right now we discard all packets.
  */
-void KiNetNode::PopulatePacketHeader(uint16_t msg_type) {
-  uint32_t sequence_number = 0;  // everything seems to set this to 0.
-  m_output_stream << KINET_MAGIC_NUMBER << KINET_VERSION_ONE;
-  m_output_stream << msg_type << sequence_number;
+void KiNetNode::SocketReady() {
+  unsigned int count = m_recv_ring.Receive(m_socket.get());
+  for (unsigned int i = 0; i < count; i++) {
+    OLA_INFO << "Received Kinet packet from " << m_recv_ring.Get(i).source
+             << ", discarding";
+  }
 }
 
 
@@ -163,6 +214,10 @@ bool KiNetNode::InitNetwork() {
     return false;
   }
 
+  if (m_send_buffer_size) {
+    socket->SetSendBufferSize(m_send_buffer_size);
+  }
+
   socket->SetOnData(NewCallback(this, &KiNetNode::SocketReady));
   m_ss->AddReadDescriptor(socket.get());
   m_socket.reset(socket.release());
@@ -21,14 +21,15 @@
 #ifndef PLUGINS_KINET_KINETNODE_H_
 #define PLUGINS_KINET_KINETNODE_H_
 
+#include <stdint.h>
 #include <memory>
 
 #include "ola/DmxBuffer.h"
-#include "ola/io/BigEndianStream.h"
-#include "ola/io/IOQueue.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/Interface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPTransmitBatcher.h"
 
 namespace ola {
 namespace plugin {
@@ -36,36 +37,62 @@ namespace kinet {
 
 class KiNetNode {
  public:
+    // If batch_transmit is true, the packets sent during an iteration of the
+    // event loop are queued and sent together by a UDPTransmitBatcher, so a
+    // power supply with many ports costs one system call rather than one per
+    // port.
     KiNetNode(ola::io::SelectServerInterface *ss,
-              ola::network::UDPSocketInterface *socket = NULL);
+              ola::network::UDPSocketInterface *socket = NULL,
+              bool batch_transmit = false);
     virtual ~KiNetNode();
 
     bool Start();
     bool Stop();
 
+    // The kernel send buffer size for the socket, 0 leaves the system
+    // default. This must be called before Start().
+    void SetSendBufferSize(unsigned int size) { m_send_buffer_size = size; }
+
+    // Spread each batch over this many milliseconds, see
+    // UDPTransmitBatcher::SetPacing(). This only applies if batch_transmit
+    // is true, and must be called before Start().
+    void SetTransmitPacing(unsigned int pacing_ms) {
+      m_transmit_pacing_ms = pacing_ms;
+    }
+
     // The following apply to Input Ports (those which send data)
     bool SendDMX(const ola::network::IPV4Address &target,
                  const ola::DmxBuffer &buffer);
 
+    // Send a KiNet v2 PORTOUT packet to one port of a multi-port supply.
+    // Ports are numbered from 1.
+    bool SendPortOut(const ola::network::IPV4Address &target,
+                     uint8_t port,
+                     const ola::DmxBuffer &buffer);
+
  private:
+    enum { MAX_PACKET_SIZE = 1500 };
+
     bool m_running;
+    const bool m_batch_transmit;
+    unsigned int m_send_buffer_size;
+    unsigned int m_transmit_pacing_ms;
     ola::io::SelectServerInterface *m_ss;
-    ola::io::IOQueue m_output_queue;
-    ola::io::BigEndianOutputStream m_output_stream;
     ola::network::Interface m_interface;
     std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+    std::auto_ptr<ola::network::UDPTransmitBatcher> m_tx_batcher;
+    ola::network::UDPReceiveRing m_recv_ring;
+    uint8_t m_packet[MAX_PACKET_SIZE];
 
     KiNetNode(const KiNetNode&);
     KiNetNode& operator=(const KiNetNode&);
 
     void SocketReady();
-    void PopulatePacketHeader(uint16_t msg_type);
+    bool SendPacket(const ola::network::IPV4Address &target,
+                    unsigned int size);
     bool InitNetwork();
 
     static const uint16_t KINET_PORT = 6038;
-    static const uint32_t KINET_MAGIC_NUMBER = 0x0401dc4a;
-    static const uint16_t KINET_VERSION_ONE = 0x0100;
-    static const uint16_t KINET_DMX_MSG = 0x0101;
 };
 }  // namespace kinet
 }  // namespace plugin
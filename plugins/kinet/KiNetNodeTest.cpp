@@ -37,6 +37,8 @@ using ola::testing::MockUDPSocket;
 class KiNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(KiNetNodeTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSendPortOut);
+  CPPUNIT_TEST(testBatchTransmit);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -48,6 +50,8 @@ class KiNetNodeTest: public CppUnit::TestFixture {
     void setUp();
 
     void testSendDMX();
+    void testSendPortOut();
+    void testBatchTransmit();
 
  private:
     ola::io::SelectServer ss;
@@ -88,3 +92,60 @@ void KiNetNodeTest::testSendDMX() {
   m_socket->Verify();
   OLA_ASSERT(node.Stop());
 }
+
+
+/**
+ * Check sending PORTOUT packets works.
+ */
+void KiNetNodeTest::testSendPortOut() {
+  KiNetNode node(&ss, m_socket);
+  OLA_ASSERT_TRUE(node.Start());
+
+  const uint8_t expected_data[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff, 3, 0, 0, 0, 8, 0, 0, 0,
+    1, 5, 8, 10, 14, 45, 100, 255
+  };
+
+  m_socket->AddExpectedData(expected_data, sizeof(expected_data), target_ip,
+                            KINET_PORT);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,5,8,10,14,45,100,255");
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 3, buffer));
+  m_socket->Verify();
+  OLA_ASSERT(node.Stop());
+}
+
+/**
+ * Check batched packets are sent at the end of the loop iteration.
+ */
+void KiNetNodeTest::testBatchTransmit() {
+  KiNetNode node(&ss, m_socket, true);
+  OLA_ASSERT_TRUE(node.Start());
+
+  const uint8_t port1_data[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff, 1, 0, 0, 0, 2, 0, 0, 0,
+    1, 2
+  };
+  const uint8_t port2_data[] = {
+    0x04, 0x01, 0xdc, 0x4a, 0x02, 0x00,
+    0x08, 0x01, 0, 0, 0, 0,
+    0xff, 0xff, 0xff, 0xff, 2, 0, 0, 0, 1, 0, 0, 0,
+    3
+  };
+
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 1, DmxBuffer("\001\002")));
+  OLA_ASSERT_TRUE(node.SendPortOut(target_ip, 2, DmxBuffer("\003")));
+
+  m_socket->AddExpectedData(port1_data, sizeof(port1_data), target_ip,
+                            KINET_PORT);
+  m_socket->AddExpectedData(port2_data, sizeof(port2_data), target_ip,
+                            KINET_PORT);
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  m_socket->Verify();
+  OLA_ASSERT(node.Stop());
+}
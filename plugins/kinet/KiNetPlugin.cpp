@@ -18,13 +18,16 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/network/IPV4Address.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/kinet/KiNetDevice.h"
 #include "plugins/kinet/KiNetPlugin.h"
 #include "plugins/kinet/KiNetPluginDescription.h"
@@ -35,10 +38,17 @@ namespace plugin {
 namespace kinet {
 
 using ola::network::IPV4Address;
+using std::set;
 using std::string;
 using std::vector;
 
 const char KiNetPlugin::POWER_SUPPLY_KEY[] = "power_supply";
+const char KiNetPlugin::MODE_SUFFIX[] = "-mode";
+const char KiNetPlugin::PORTS_SUFFIX[] = "-ports";
+const char KiNetPlugin::SEND_BUFFER_KEY[] = "send_buffer_size";
+const char KiNetPlugin::TRANSMIT_PACING_KEY[] = "transmit_pacing_ms";
+const char KiNetPlugin::DMXOUT_MODE[] = "dmxout";
+const char KiNetPlugin::PORTOUT_MODE[] = "portout";
 const char KiNetPlugin::PLUGIN_NAME[] = "KiNET";
 const char KiNetPlugin::PLUGIN_PREFIX[] = "kinet";
 
@@ -52,23 +62,26 @@ KiNetPlugin::~KiNetPlugin() {}
  * Start the plugin.
  */
 bool KiNetPlugin::StartHook() {
-  vector<string> power_supplies_strings = m_preferences->GetMultipleValue(
-      POWER_SUPPLY_KEY);
-  vector<string>::const_iterator iter = power_supplies_strings.begin();
-  vector<IPV4Address> power_supplies;
-
-  for (; iter != power_supplies_strings.end(); ++iter) {
-    if (iter->empty()) {
-      continue;
-    }
-    IPV4Address target;
-    if (IPV4Address::FromString(*iter, &target)) {
-      power_supplies.push_back(target);
-    } else {
-      OLA_WARN << "Invalid power supply IP address : " << *iter;
+  vector<IPV4Address> ips;
+  PowerSupplies(&ips);
+
+  vector<KiNetPowerSupply> power_supplies;
+  vector<IPV4Address>::const_iterator iter = ips.begin();
+  for (; iter != ips.end(); ++iter) {
+    KiNetPowerSupply power_supply;
+    power_supply.ip = *iter;
+    const string ip = iter->ToString();
+    if (m_preferences->GetValue(ip + MODE_SUFFIX) == PORTOUT_MODE &&
+        !StringToInt(m_preferences->GetValue(ip + PORTS_SUFFIX),
+                     &power_supply.portout_ports)) {
+      power_supply.portout_ports = DEFAULT_PORTOUT_PORTS;
     }
+    power_supplies.push_back(power_supply);
   }
-  m_device.reset(new KiNetDevice(this, power_supplies, m_plugin_adaptor));
+  m_device.reset(new KiNetDevice(
+      this, power_supplies, m_plugin_adaptor,
+      StringToIntOrDefault(m_preferences->GetValue(SEND_BUFFER_KEY), 0),
+      StringToIntOrDefault(m_preferences->GetValue(TRANSMIT_PACING_KEY), 0)));
 
   if (!m_device->Start()) {
     m_device.reset();
@@ -116,12 +129,61 @@ bool KiNetPlugin::SetDefaultPreferences() {
 
   save |= m_preferences->SetDefaultValue(POWER_SUPPLY_KEY,
                                          StringValidator(true), "");
+  save |= m_preferences->SetDefaultValue(SEND_BUFFER_KEY,
+                                         UIntValidator(0,
+                                                       MAX_SOCKET_BUFFER_SIZE),
+                                         0);
+  save |= m_preferences->SetDefaultValue(TRANSMIT_PACING_KEY,
+                                         UIntValidator(0,
+                                                       MAX_TRANSMIT_PACING_MS),
+                                         0);
+
+  set<string> modes;
+  modes.insert(DMXOUT_MODE);
+  modes.insert(PORTOUT_MODE);
+
+  vector<IPV4Address> ips;
+  PowerSupplies(&ips);
+  vector<IPV4Address>::const_iterator iter = ips.begin();
+  for (; iter != ips.end(); ++iter) {
+    const string ip = iter->ToString();
+    save |= m_preferences->SetDefaultValue(ip + MODE_SUFFIX,
+                                           SetValidator<string>(modes),
+                                           DMXOUT_MODE);
+    save |= m_preferences->SetDefaultValue(ip + PORTS_SUFFIX,
+                                           UIntValidator(1, 255),
+                                           DEFAULT_PORTOUT_PORTS);
+  }
 
   if (save) {
     m_preferences->Save();
   }
   return true;
 }
+
+
+/*
+ * Get the IPs of the power supplies from the preferences.
+ */
+void KiNetPlugin::PowerSupplies(vector<IPV4Address> *ips) const {
+  vector<string> power_supplies_strings = m_preferences->GetMultipleValue(
+      POWER_SUPPLY_KEY);
+  vector<string>::const_iterator iter = power_supplies_strings.begin();
+
+  for (; iter != power_supplies_strings.end(); ++iter) {
+    if (iter->empty()) {
+      continue;
+    }
+    IPV4Address target;
+    if (IPV4Address::FromString(*iter, &target)) {
+      ips->push_back(target);
+    } else {
+      OLA_WARN << "Invalid power supply IP address : " << *iter;
+    }
+  }
+}
 }  // namespace kinet
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::kinet::KiNetPlugin)
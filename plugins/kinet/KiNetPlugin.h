@@ -23,6 +23,8 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include "ola/network/IPV4Address.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -46,10 +48,20 @@ class KiNetPlugin : public Plugin {
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
+    void PowerSupplies(std::vector<ola::network::IPV4Address> *ips) const;
 
     static const char PLUGIN_NAME[];
     static const char PLUGIN_PREFIX[];
     static const char POWER_SUPPLY_KEY[];
+    static const char MODE_SUFFIX[];
+    static const char PORTS_SUFFIX[];
+    static const char SEND_BUFFER_KEY[];
+    static const char TRANSMIT_PACING_KEY[];
+    static const char DMXOUT_MODE[];
+    static const char PORTOUT_MODE[];
+    static const unsigned int DEFAULT_PORTOUT_PORTS = 16;
+    static const unsigned int MAX_SOCKET_BUFFER_SIZE = 64 * 1024 * 1024;
+    static const unsigned int MAX_TRANSMIT_PACING_MS = 1000;
 };
 }  // namespace kinet
 }  // namespace plugin
@@ -22,6 +22,7 @@
 #define PLUGINS_KINET_KINETPORT_H_
 
 #include <string>
+#include "ola/StringUtils.h"
 #include "ola/network/IPV4Address.h"
 #include "olad/Port.h"
 #include "plugins/kinet/KiNetDevice.h"
@@ -33,26 +34,40 @@ namespace kinet {
 
 class KiNetOutputPort: public BasicOutputPort {
  public:
+  /*
+   * @param kinet_port the port on the power supply to send PORTOUT packets
+   *   to, or 0 to send DMXOUT packets.
+   */
   KiNetOutputPort(KiNetDevice *device,
                   const ola::network::IPV4Address &target,
                   KiNetNode *node,
-                  unsigned int port_id)
+                  unsigned int port_id,
+                  uint8_t kinet_port = 0)
       : BasicOutputPort(device, port_id),
         m_node(node),
-        m_target(target) {
+        m_target(target),
+        m_kinet_port(kinet_port) {
   }
 
   bool WriteDMX(const DmxBuffer &buffer, OLA_UNUSED uint8_t priority) {
+    if (m_kinet_port) {
+      return m_node->SendPortOut(m_target, m_kinet_port, buffer);
+    }
     return m_node->SendDMX(m_target, buffer);
   }
 
   std::string Description() const {
-    return "Power Supply: " + m_target.ToString();
+    std::string description = "Power Supply: " + m_target.ToString();
+    if (m_kinet_port) {
+      description += ", Port: " + ola::IntToString(m_kinet_port);
+    }
+    return description;
   }
 
  private:
   KiNetNode *m_node;
   const ola::network::IPV4Address m_target;
+  const uint8_t m_kinet_port;
 };
 }  // namespace kinet
 }  // namespace plugin
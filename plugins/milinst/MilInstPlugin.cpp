@@ -24,6 +24,7 @@
 #include "ola/Logging.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/milinst/MilInstDevice.h"
 #include "plugins/milinst/MilInstPlugin.h"
 #include "plugins/milinst/MilInstPluginDescription.h"
@@ -161,3 +162,5 @@ void MilInstPlugin::DeleteDevice(MilInstDevice *device) {
 }  // namespace milinst
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::milinst::MilInstPlugin)
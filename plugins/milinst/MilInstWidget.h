@@ -56,7 +56,7 @@ class MilInstWidget {
     return str.str();
   }
 
-  virtual bool SendDmx(const DmxBuffer &buffer) const = 0;
+  virtual bool SendDmx(const DmxBuffer &buffer) = 0;
   virtual bool DetectDevice() = 0;
 
  protected:
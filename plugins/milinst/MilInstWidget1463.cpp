@@ -39,6 +39,8 @@ bool MilInstWidget1463::Connect() {
     return false;
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  // The widget's state is unknown, so the first frame sends every channel.
+  m_last_size = 0;
 
   OLA_DEBUG << "Connected to " << m_path;
   return true;
@@ -58,7 +60,7 @@ bool MilInstWidget1463::DetectDevice() {
 /*
  * Send a DMX msg.
   */
-bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) const {
+bool MilInstWidget1463::SendDmx(const DmxBuffer &buffer) {
   // TODO(Peter): Probably add offset in here to send higher channels shifted
   // down
   int bytes_sent = Send112(buffer);
@@ -84,21 +86,32 @@ int MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) const {
 
 
 /*
- * Send 112 channels worth of data
+ * Send up to 112 channels worth of data. Each channel is set individually,
+ * so only the channels that changed since the last frame are sent, in a
+ * single write.
  * @param buffer a DmxBuffer with the data
  */
-int MilInstWidget1463::Send112(const DmxBuffer &buffer) const {
+int MilInstWidget1463::Send112(const DmxBuffer &buffer) {
   unsigned int channels = std::min((unsigned int) DMX_MAX_TRANSMIT_CHANNELS,
                                    buffer.Size());
-  uint8_t msg[channels * 2];
+  const uint8_t *data = buffer.GetRaw();
+  unsigned int length = 0;
+
+  for (unsigned int i = 0; i < channels; i++) {
+    if (i < m_last_size && m_last_values[i] == data[i]) {
+      continue;
+    }
+    m_frame[length++] = i + 1;
+    m_frame[length++] = data[i];
+    m_last_values[i] = data[i];
+  }
+  m_last_size = std::max(m_last_size, channels);
 
-  for (unsigned int i = 0; i <= channels; i++) {
-    msg[i * 2] = i + 1;
-    msg[(i * 2) + 1] = buffer.Get(i);
-    OLA_DEBUG << "Setting " << (i + 1) << " to " <<
-        static_cast<int>(buffer.Get(i));
+  if (!length) {
+    return 0;
   }
-  return m_socket->Send(msg, (channels * 2));
+  OLA_DEBUG << "Setting " << (length / 2) << " channels";
+  return m_socket->Send(m_frame, length);
 }
 }  // namespace milinst
 }  // namespace plugin
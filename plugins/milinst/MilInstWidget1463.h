@@ -21,6 +21,7 @@
 #ifndef PLUGINS_MILINST_MILINSTWIDGET1463_H_
 #define PLUGINS_MILINST_MILINSTWIDGET1463_H_
 
+#include <stdint.h>
 #include <string>
 
 #include "plugins/milinst/MilInstWidget.h"
@@ -31,20 +32,29 @@ namespace milinst {
 
 class MilInstWidget1463: public MilInstWidget {
  public:
-  explicit MilInstWidget1463(const std::string &path): MilInstWidget(path) {}
+  explicit MilInstWidget1463(const std::string &path)
+      : MilInstWidget(path),
+        m_last_size(0) {}
   ~MilInstWidget1463() {}
 
   bool Connect();
   bool DetectDevice();
-  bool SendDmx(const DmxBuffer &buffer) const;
+  bool SendDmx(const DmxBuffer &buffer);
   std::string Type() { return "Milford Instruments 1-463 Widget"; }
 
  protected:
   int SetChannel(unsigned int chan, uint8_t val) const;
-  int Send112(const DmxBuffer &buffer) const;
+  int Send112(const DmxBuffer &buffer);
 
   // This interface can only transmit 112 channels
   enum { DMX_MAX_TRANSMIT_CHANNELS = 112 };
+
+ private:
+  // The channel / value pairs for a frame.
+  uint8_t m_frame[DMX_MAX_TRANSMIT_CHANNELS * 2];
+  // The values the widget has, the first m_last_size are valid.
+  uint8_t m_last_values[DMX_MAX_TRANSMIT_CHANNELS];
+  unsigned int m_last_size;
 };
 }  // namespace milinst
 }  // namespace plugin
@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Peter Newman
  */
 
+#include <string.h>
 #include <algorithm>
 #include <set>
 #include <string>
@@ -47,7 +48,8 @@ const uint16_t MilInstWidget1553::DEFAULT_CHANNELS = CHANNELS_128;
 MilInstWidget1553::MilInstWidget1553(const string &path,
                                      Preferences *preferences)
     : MilInstWidget(path),
-      m_preferences(preferences) {
+      m_preferences(preferences),
+      m_last_size(0) {
   SetWidgetDefaults();
 
   if (!StringToInt(m_preferences->GetValue(ChannelsKey()), &m_channels)) {
@@ -78,6 +80,8 @@ bool MilInstWidget1553::Connect() {
   }
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  // The widget's state is unknown, so the first frame sends every channel.
+  m_last_size = 0;
   m_socket->SetOnData(
       NewCallback<MilInstWidget1553>(this, &MilInstWidget1553::SocketReady));
 
@@ -117,7 +121,7 @@ bool MilInstWidget1553::DetectDevice() {
 /*
  * Send a DMX msg.
   */
-bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) const {
+bool MilInstWidget1553::SendDmx(const DmxBuffer &buffer) {
   // TODO(Peter): Probably add offset in here to send higher channels shifted
   // down
   int bytes_sent = Send(buffer);
@@ -145,19 +149,33 @@ int MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) const {
 
 /*
  * Send data
+ *
+ * The load command starts at an address, so we send from the first channel
+ * that changed since the last frame. Nothing is sent if nothing changed.
  * @param buffer a DmxBuffer with the data
  */
-int MilInstWidget1553::Send(const DmxBuffer &buffer) const {
+int MilInstWidget1553::Send(const DmxBuffer &buffer) {
   unsigned int channels = std::min(static_cast<unsigned int>(m_channels),
                                    buffer.Size());
-  uint8_t msg[3 + channels];
+  const uint8_t *data = buffer.GetRaw();
 
-  msg[0] = MILINST_1553_LOAD_COMMAND;
-  ola::utils::SplitUInt16(1, &msg[1], &msg[2]);
+  unsigned int first = 0;
+  while (first < channels && first < m_last_size &&
+         m_last_values[first] == data[first]) {
+    first++;
+  }
+  if (first == channels) {
+    return 0;
+  }
 
-  buffer.Get(msg + 3, &channels);
+  const unsigned int length = channels - first;
+  m_frame[0] = MILINST_1553_LOAD_COMMAND;
+  ola::utils::SplitUInt16(first + 1, &m_frame[1], &m_frame[2]);
+  memcpy(m_frame + LOAD_HEADER_SIZE, data + first, length);
+  memcpy(m_last_values + first, data + first, length);
+  m_last_size = std::max(m_last_size, channels);
 
-  return m_socket->Send(msg, sizeof(msg));
+  return m_socket->Send(m_frame, LOAD_HEADER_SIZE + length);
 }
 
 
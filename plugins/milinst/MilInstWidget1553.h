@@ -21,8 +21,10 @@
 #ifndef PLUGINS_MILINST_MILINSTWIDGET1553_H_
 #define PLUGINS_MILINST_MILINSTWIDGET1553_H_
 
+#include <stdint.h>
 #include <string>
 
+#include "ola/Constants.h"
 #include "plugins/milinst/MilInstWidget.h"
 
 namespace ola {
@@ -36,16 +38,18 @@ class MilInstWidget1553: public MilInstWidget {
 
   bool Connect();
   bool DetectDevice();
-  bool SendDmx(const DmxBuffer &buffer) const;
+  bool SendDmx(const DmxBuffer &buffer);
   std::string Type() { return "Milford Instruments 1-553 Widget"; }
 
   void SocketReady();
 
  protected:
   int SetChannel(unsigned int chan, uint8_t val) const;
-  int Send(const DmxBuffer &buffer) const;
+  int Send(const DmxBuffer &buffer);
 
   static const uint8_t MILINST_1553_LOAD_COMMAND = 0x01;
+  // The command byte and the 16 bit start address.
+  static const unsigned int LOAD_HEADER_SIZE = 3;
 
   static const speed_t DEFAULT_BAUDRATE;
 
@@ -57,6 +61,11 @@ class MilInstWidget1553: public MilInstWidget {
  private:
   class Preferences *m_preferences;
   uint16_t m_channels;
+  // The load command for a frame, and the values the widget has. The first
+  // m_last_size values are valid.
+  uint8_t m_frame[LOAD_HEADER_SIZE + DMX_UNIVERSE_SIZE];
+  uint8_t m_last_values[DMX_UNIVERSE_SIZE];
+  unsigned int m_last_size;
 
   // Per widget options
   std::string BaudRateKey() const;
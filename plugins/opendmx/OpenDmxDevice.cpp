@@ -40,13 +40,23 @@ using std::string;
  * @param owner
  * @param name
  * @param path to device
+ * @param device_id
+ * @param frame_rate the frames per second while the data is changing
+ * @param idle_rate the frames per second while it isn't
+ * @param export_map the ExportMap to use for the output rate, may be NULL
  */
 OpenDmxDevice::OpenDmxDevice(AbstractPlugin *owner,
                              const string &name,
                              const string &path,
-                             unsigned int device_id)
+                             unsigned int device_id,
+                             unsigned int frame_rate,
+                             unsigned int idle_rate,
+                             ExportMap *export_map)
     : Device(owner, name),
-      m_path(path) {
+      m_path(path),
+      m_frame_rate(frame_rate),
+      m_idle_rate(idle_rate),
+      m_export_map(export_map) {
   std::ostringstream str;
   str << device_id;
   m_device_id = str.str();
@@ -58,7 +68,8 @@ OpenDmxDevice::OpenDmxDevice(AbstractPlugin *owner,
  * Start this device
  */
 bool OpenDmxDevice::StartHook() {
-  AddPort(new OpenDmxOutputPort(this, 0, m_path));
+  AddPort(new OpenDmxOutputPort(this, 0, m_path, m_frame_rate, m_idle_rate,
+                                m_export_map));
   return true;
 }
 }  // namespace opendmx
@@ -22,6 +22,7 @@
 #define PLUGINS_OPENDMX_OPENDMXDEVICE_H_
 
 #include <string>
+#include "ola/ExportMap.h"
 #include "olad/Device.h"
 
 namespace ola {
@@ -33,7 +34,10 @@ class OpenDmxDevice: public ola::Device {
     OpenDmxDevice(ola::AbstractPlugin *owner,
                   const std::string &name,
                   const std::string &path,
-                  unsigned int device_id);
+                  unsigned int device_id,
+                  unsigned int frame_rate,
+                  unsigned int idle_rate,
+                  ExportMap *export_map);
 
     // we only support one widget for now
     std::string DeviceId() const { return m_device_id; }
@@ -44,6 +48,9 @@ class OpenDmxDevice: public ola::Device {
  private:
     std::string m_path;
     std::string m_device_id;
+    unsigned int m_frame_rate;
+    unsigned int m_idle_rate;
+    ExportMap *m_export_map;
 };
 }  // namespace opendmx
 }  // namespace plugin
@@ -27,12 +27,15 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/io/IOUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/opendmx/OpenDmxDevice.h"
 #include "plugins/opendmx/OpenDmxPlugin.h"
 #include "plugins/opendmx/OpenDmxPluginDescription.h"
+#include "plugins/opendmx/OpenDmxThread.h"
 
 namespace ola {
 namespace plugin {
@@ -47,6 +50,8 @@ const char OpenDmxPlugin::OPENDMX_DEVICE_NAME[] = "OpenDmx USB Device";
 const char OpenDmxPlugin::PLUGIN_NAME[] = "Enttec Open DMX";
 const char OpenDmxPlugin::PLUGIN_PREFIX[] = "opendmx";
 const char OpenDmxPlugin::DEVICE_KEY[] = "device";
+const char OpenDmxPlugin::FRAME_RATE_KEY[] = "frame_rate";
+const char OpenDmxPlugin::IDLE_RATE_KEY[] = "idle_rate";
 
 
 /*
@@ -60,6 +65,14 @@ bool OpenDmxPlugin::StartHook() {
   // start counting device ids from 0
   unsigned int device_id = 0;
 
+  unsigned int frame_rate, idle_rate;
+  if (!StringToInt(m_preferences->GetValue(FRAME_RATE_KEY), &frame_rate)) {
+    frame_rate = OpenDmxThread::DEFAULT_FRAME_RATE;
+  }
+  if (!StringToInt(m_preferences->GetValue(IDLE_RATE_KEY), &idle_rate)) {
+    idle_rate = OpenDmxThread::DEFAULT_IDLE_RATE;
+  }
+
   for (; iter != devices.end(); ++iter) {
     // first check if it's there
     int fd;
@@ -69,7 +82,10 @@ bool OpenDmxPlugin::StartHook() {
           this,
           OPENDMX_DEVICE_NAME,
           *iter,
-          device_id++);
+          device_id++,
+          frame_rate,
+          idle_rate,
+          m_plugin_adaptor->GetExportMap());
       if (device->Start()) {
         m_devices.push_back(device);
         m_plugin_adaptor->RegisterDevice(device);
@@ -118,8 +134,15 @@ bool OpenDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
-                                     OPENDMX_DEVICE_PATH)) {
+  bool save = m_preferences->SetDefaultValue(DEVICE_KEY, StringValidator(),
+                                             OPENDMX_DEVICE_PATH);
+  save |= m_preferences->SetDefaultValue(FRAME_RATE_KEY,
+                                         UIntValidator(1, 44),
+                                         OpenDmxThread::DEFAULT_FRAME_RATE);
+  save |= m_preferences->SetDefaultValue(IDLE_RATE_KEY,
+                                         UIntValidator(0, 44),
+                                         OpenDmxThread::DEFAULT_IDLE_RATE);
+  if (save) {
     m_preferences->Save();
   }
 
@@ -134,3 +157,5 @@ bool OpenDmxPlugin::SetDefaultPreferences() {
 }  // namespace opendmx
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::opendmx::OpenDmxPlugin)
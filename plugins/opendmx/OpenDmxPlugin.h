@@ -55,6 +55,8 @@ class OpenDmxPlugin: public Plugin {
     static const char OPENDMX_DEVICE_PATH[];
     static const char OPENDMX_DEVICE_NAME[];
     static const char DEVICE_KEY[];
+    static const char FRAME_RATE_KEY[];
+    static const char IDLE_RATE_KEY[];
 };
 }  // namespace opendmx
 }  // namespace plugin
@@ -23,6 +23,7 @@
 
 #include <string>
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "olad/Port.h"
 #include "plugins/opendmx/OpenDmxDevice.h"
 #include "plugins/opendmx/OpenDmxThread.h"
@@ -35,9 +36,12 @@ class OpenDmxOutputPort: public BasicOutputPort {
  public:
   OpenDmxOutputPort(OpenDmxDevice *parent,
                     unsigned int id,
-                    const std::string &path)
+                    const std::string &path,
+                    unsigned int frame_rate,
+                    unsigned int idle_rate,
+                    ExportMap *export_map)
       : BasicOutputPort(parent, id),
-        m_thread(path),
+        m_thread(path, frame_rate, idle_rate, export_map),
         m_path(path) {
     m_thread.Start();
   }
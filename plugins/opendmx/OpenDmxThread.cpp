@@ -45,13 +45,25 @@ using std::string;
 using ola::thread::Mutex;
 using ola::thread::MutexLocker;
 
+const unsigned int OpenDmxThread::DEFAULT_FRAME_RATE;
+const unsigned int OpenDmxThread::DEFAULT_IDLE_RATE;
+
 /*
  * Create a new OpenDmxThread object
+ * @param path the path to the device.
+ * @param frame_rate the frames per second to send while the data is changing.
+ * @param idle_rate the frames per second to send while it isn't.
+ * @param export_map the ExportMap to use for the output rate, may be NULL.
  */
-OpenDmxThread::OpenDmxThread(const string &path)
-    : ola::thread::Thread(),
+OpenDmxThread::OpenDmxThread(const string &path,
+                             unsigned int frame_rate,
+                             unsigned int idle_rate,
+                             ExportMap *export_map)
+    : ola::thread::Thread(ola::thread::Thread::Options("opendmx")),
     m_fd(INVALID_FD),
     m_path(path),
+    m_idle_period(idle_rate ? 1000000000ll / idle_rate : 0),
+    m_timer(frame_rate, export_map, "Open DMX at " + path),
     m_term(false) {
 }
 
@@ -61,7 +73,9 @@ OpenDmxThread::OpenDmxThread(const string &path)
  */
 void *OpenDmxThread::Run() {
   uint8_t buffer[DMX_UNIVERSE_SIZE+1];
-  unsigned int length = DMX_UNIVERSE_SIZE;
+  uint8_t frame[DMX_UNIVERSE_SIZE];
+  unsigned int length = 0;
+  int64_t last_write = 0;
   Clock clock;
 
   // should close other fd here
@@ -92,20 +106,34 @@ void *OpenDmxThread::Run() {
       ola::io::Open(m_path, O_WRONLY, &m_fd);
 
     } else {
-      length = DMX_UNIVERSE_SIZE;
-      {
-        MutexLocker locker(&m_mutex);
-        m_buffer.Get(buffer + 1, &length);
+      bool changed = false;
+      if (m_frame.Fetch()) {
+        unsigned int frame_length = DMX_UNIVERSE_SIZE;
+        m_frame.ReadSlot()->Get(frame, &frame_length);
+        if (frame_length != length || memcmp(frame, buffer + 1, length)) {
+          memcpy(buffer + 1, frame, frame_length);
+          length = frame_length;
+          changed = true;
+        }
       }
 
-      if (write(m_fd, buffer, length + 1) < 0) {
-        // if you unplug the dongle
-        OLA_WARN << "Error writing to device: " << strerror(errno);
-
-        if (close(m_fd) < 0)
-          OLA_WARN << "Close failed " << strerror(errno);
-        m_fd = INVALID_FD;
+      // While the data is the same, only send often enough to keep the
+      // receivers from timing out.
+      const int64_t now = ola::dmx::FrameTimer::Now();
+      if (changed || !last_write || now - last_write >= m_idle_period) {
+        m_timer.StartFrame();
+        last_write = now;
+        if (write(m_fd, buffer, length + 1) < 0) {
+          // if you unplug the dongle
+          OLA_WARN << "Error writing to device: " << strerror(errno);
+
+          if (close(m_fd) < 0)
+            OLA_WARN << "Close failed " << strerror(errno);
+          m_fd = INVALID_FD;
+          continue;
+        }
       }
+      m_timer.WaitForNextFrame();
     }
   }
   return NULL;
@@ -117,7 +145,7 @@ void *OpenDmxThread::Run() {
  */
 bool OpenDmxThread::Stop() {
   {
-    MutexLocker locker(&m_mutex);
+    MutexLocker locker(&m_term_mutex);
     m_term = true;
   }
   m_term_cond.Signal();
@@ -130,9 +158,12 @@ bool OpenDmxThread::Stop() {
  *
  */
 bool OpenDmxThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
-  // avoid the reference counting
-  m_buffer.Set(buffer);
+  // The output thread doesn't see the slot until it's published.
+  DmxBuffer *frame = m_frame.WriteSlot();
+  if (!frame->Set(buffer)) {
+    frame->Reset();
+  }
+  m_frame.Publish();
   return true;
 }
 }  // namespace opendmx
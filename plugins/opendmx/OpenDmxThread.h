@@ -21,9 +21,13 @@
 #ifndef PLUGINS_OPENDMX_OPENDMXTHREAD_H_
 #define PLUGINS_OPENDMX_OPENDMXTHREAD_H_
 
+#include <stdint.h>
 #include <string>
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameTimer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -31,19 +35,30 @@ namespace opendmx {
 
 class OpenDmxThread: public ola::thread::Thread {
  public:
-    explicit OpenDmxThread(const std::string &path);
+    /*
+     * Frames are sent at frame_rate while the data is changing, and at
+     * idle_rate once it stops.
+     */
+    OpenDmxThread(const std::string &path,
+                  unsigned int frame_rate = DEFAULT_FRAME_RATE,
+                  unsigned int idle_rate = DEFAULT_IDLE_RATE,
+                  ExportMap *export_map = NULL);
     ~OpenDmxThread() {}
 
     bool Stop();
     bool WriteDmx(const DmxBuffer &buffer);
     void *Run();
 
+    static const unsigned int DEFAULT_FRAME_RATE = 40;
+    static const unsigned int DEFAULT_IDLE_RATE = 2;
+
  private:
     int m_fd;
     std::string m_path;
-    DmxBuffer m_buffer;
+    const int64_t m_idle_period;
+    ola::dmx::FrameTimer m_timer;
+    ola::thread::TripleBuffer<DmxBuffer> m_frame;
     bool m_term;
-    ola::thread::Mutex m_mutex;
     ola::thread::Mutex m_term_mutex;
     ola::thread::ConditionVariable m_term_cond;
 
@@ -20,7 +20,10 @@
 
 #include "plugins/openpixelcontrol/OPCClient.h"
 
+#include <algorithm>
+
 #include "ola/Callback.h"
+#include "ola/InlineCallback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/io/BigEndianStream.h"
@@ -37,6 +40,8 @@ namespace openpixelcontrol {
 using ola::TimeInterval;
 using ola::network::TCPSocket;
 
+const unsigned int OPCClient::MAX_DATA_LENGTH;
+
 OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
                      const ola::network::IPV4SocketAddress &target)
     : m_ss(ss),
@@ -44,11 +49,16 @@ OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
       m_backoff(TimeInterval(1, 0), TimeInterval(300, 0)),
       m_pool(OPC_FRAME_SIZE),
       m_socket_factory(NewCallback(this, &OPCClient::SocketConnected)),
-      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)) {
+      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT),
+      m_dropped_frames(0) {
   m_tcp_connector.AddEndpoint(target, &m_backoff);
 }
 
 OPCClient::~OPCClient() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_flush_timeout);
+  }
   if (m_client_socket.get()) {
     m_ss->RemoveReadDescriptor(m_client_socket.get());
     m_tcp_connector.Disconnect(m_target, true);
@@ -56,17 +66,25 @@ OPCClient::~OPCClient() {
 }
 
 bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer) {
+  return SendFrame(channel, buffer.GetRaw(), buffer.Size());
+}
+
+bool OPCClient::SendFrame(uint8_t channel, const uint8_t *data,
+                          unsigned int length) {
   if (!m_sender.get()) {
     return false;  // not connected
   }
 
-  ola::io::IOQueue queue(&m_pool);
-  ola::io::BigEndianOutputStream stream(&queue);
-  stream << channel;
-  stream << SET_PIXEL_COMMAND;
-  stream << static_cast<uint16_t>(buffer.Size());
-  stream.Write(buffer.GetRaw(), buffer.Size());
-  return m_sender->SendMessage(&queue);
+  length = std::min(length, MAX_DATA_LENGTH);
+  std::pair<PendingFrames::iterator, bool> p = m_pending_frames.insert(
+      PendingFrames::value_type(channel, ola::io::ByteString()));
+  if (!p.second) {
+    // The previous frame for this channel never made it out.
+    m_dropped_frames++;
+  }
+  p.first->second.assign(data, length);
+  ScheduleFlush(TimeInterval(0, 0));
+  return true;
 }
 
 void OPCClient::SetSocketCallback(SocketEventCallback *callback) {
@@ -79,6 +97,10 @@ void OPCClient::SocketConnected(TCPSocket *socket) {
   m_client_socket->SetOnClose(
       NewSingleCallback(this, &OPCClient::SocketClosed));
   m_ss->AddReadDescriptor(socket);
+  // We do our own coalescing, there is no point waiting on Nagle.
+  if (!m_client_socket->SetNoDelay()) {
+    OLA_WARN << "Failed to set TCP_NODELAY for " << m_target;
+  }
 
   m_sender.reset(
       new ola::io::NonBlockingSender(socket, m_ss, &m_pool, OPC_FRAME_SIZE));
@@ -101,11 +123,50 @@ void OPCClient::NewData() {
 void OPCClient::SocketClosed() {
   m_sender.reset();
   m_client_socket.reset();
+  m_pending_frames.clear();
 
   if (m_socket_callback.get()) {
     m_socket_callback->Run(false);
   }
 }
+
+void OPCClient::ScheduleFlush(const TimeInterval &delay) {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+  m_flush_timeout = m_ss->RegisterSingleTimeout(
+      delay, MakeInlineCallback(this, &OPCClient::FlushFrames));
+}
+
+/*
+ * Write all pending frames in a single call.
+ */
+void OPCClient::FlushFrames() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  if (!m_sender.get() || m_pending_frames.empty()) {
+    return;
+  }
+
+  if (m_sender->LimitReached()) {
+    // Hold on to the latest frames and try again once the socket has had a
+    // chance to drain.
+    ScheduleFlush(TimeInterval(0, RETRY_DELAY_US));
+    return;
+  }
+
+  ola::io::IOQueue queue(&m_pool);
+  ola::io::BigEndianOutputStream stream(&queue);
+  PendingFrames::const_iterator iter = m_pending_frames.begin();
+  for (; iter != m_pending_frames.end(); ++iter) {
+    const ola::io::ByteString &data = iter->second;
+    stream << iter->first;
+    stream << SET_PIXEL_COMMAND;
+    stream << static_cast<uint16_t>(data.size());
+    stream.Write(data.data(), static_cast<unsigned int>(data.size()));
+  }
+  m_pending_frames.clear();
+  m_sender->SendMessage(&queue);
+}
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
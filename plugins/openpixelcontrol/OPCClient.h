@@ -21,10 +21,12 @@
 #ifndef PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 #define PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/io/ByteString.h"
 #include "ola/io/MemoryBlockPool.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/AdvancedTCPConnector.h"
@@ -45,6 +47,12 @@ namespace openpixelcontrol {
  * @brief An Open Pixel Control client.
  *
  * The OPC client connects to a remote IP:port and sends OPC messages.
+ *
+ * Frames aren't written immediately. Instead the latest frame for each
+ * channel is held until the end of the current loop iteration, at which
+ * point all pending frames are written to the socket in a single call. If the
+ * socket has backed up, the pending frames are held back and replaced by any
+ * newer frames, so stale data is dropped rather than queued.
  */
 class OPCClient {
  public:
@@ -76,9 +84,22 @@ class OPCClient {
    * @brief Send a DMX frame.
    * @param channel the OPC channel to use.
    * @param buffer the DMX data.
+   * @returns true if the frame was queued for sending, false if the client
+   *   isn't connected.
    */
   bool SendDmx(uint8_t channel, const DmxBuffer &buffer);
 
+  /**
+   * @brief Send a frame of pixel data.
+   * @param channel the OPC channel to use.
+   * @param data the pixel data.
+   * @param length the length of the data. This may be larger than a
+   *   universe, but is truncated to the maximum OPC message size.
+   * @returns true if the frame was queued for sending, false if the client
+   *   isn't connected.
+   */
+  bool SendFrame(uint8_t channel, const uint8_t *data, unsigned int length);
+
   /**
    * @brief Set the callback to be run when the socket state changes.
    * @param callback the callback to run when the socket state changes.
@@ -86,7 +107,15 @@ class OPCClient {
    */
   void SetSocketCallback(SocketEventCallback *callback);
 
+  /**
+   * @brief The number of frames that were replaced by a newer frame before
+   *   they could be sent.
+   */
+  unsigned int DroppedFrames() const { return m_dropped_frames; }
+
  private:
+  typedef std::map<uint8_t, ola::io::ByteString> PendingFrames;
+
   ola::io::SelectServerInterface *m_ss;
   const ola::network::IPV4SocketAddress m_target;
 
@@ -97,10 +126,20 @@ class OPCClient {
   std::auto_ptr<ola::network::TCPSocket> m_client_socket;
   std::auto_ptr<ola::io::NonBlockingSender> m_sender;
   std::auto_ptr<SocketEventCallback> m_socket_callback;
+  PendingFrames m_pending_frames;
+  ola::thread::timeout_id m_flush_timeout;
+  unsigned int m_dropped_frames;
 
   void SocketConnected(ola::network::TCPSocket *socket);
   void NewData();
   void SocketClosed();
+  void ScheduleFlush(const ola::TimeInterval &delay);
+  void FlushFrames();
+
+  // How long to wait before retrying if the socket has backed up.
+  static const unsigned int RETRY_DELAY_US = 5000;
+  // The length field is 16 bits.
+  static const unsigned int MAX_DATA_LENGTH = 0xffff;
 
   DISALLOW_COPY_AND_ASSIGN(OPCClient);
 };
@@ -44,22 +44,31 @@ using std::auto_ptr;
 class OPCClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OPCClientTest);
   CPPUNIT_TEST(testTransmit);
+  CPPUNIT_TEST(testCoalescing);
+  CPPUNIT_TEST(testLargeFrame);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCClientTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_frame_count(0),
+        m_other_length(0) {
   }
   void setUp();
 
   void testTransmit();
+  void testCoalescing();
+  void testLargeFrame();
 
  private:
   ola::io::SelectServer m_ss;
   auto_ptr<OPCServer> m_server;
   DmxBuffer m_received_data;
   uint8_t m_command;
+  DmxBuffer m_other_data;
+  unsigned int m_frame_count;
+  unsigned int m_other_length;
 
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
@@ -75,7 +84,43 @@ class OPCClientTest: public CppUnit::TestFixture {
     }
   }
 
+  void CaptureOtherData(uint8_t, const uint8_t *data, unsigned int length) {
+    m_other_data.Set(data, length);
+    m_other_length = length;
+    m_frame_count++;
+    m_ss.Terminate();
+  }
+
+  void CaptureFrame(uint8_t, const uint8_t *data, unsigned int length) {
+    m_received_data.Set(data, length);
+    m_frame_count++;
+  }
+
+  void SendFrames(OPCClient *client, bool connected) {
+    if (!connected) {
+      m_ss.Terminate();
+      return;
+    }
+    DmxBuffer buffer;
+    buffer.SetFromString("1,2,3");
+    OLA_ASSERT_TRUE(client->SendDmx(CHANNEL, buffer));
+    buffer.SetFromString("4,5,6");
+    OLA_ASSERT_TRUE(client->SendDmx(CHANNEL, buffer));
+    buffer.SetFromString("7,8");
+    OLA_ASSERT_TRUE(client->SendDmx(OTHER_CHANNEL, buffer));
+  }
+
+  void SendLargeFrame(OPCClient *client, const uint8_t *data,
+                      unsigned int length, bool connected) {
+    if (!connected) {
+      m_ss.Terminate();
+      return;
+    }
+    OLA_ASSERT_TRUE(client->SendFrame(OTHER_CHANNEL, data, length));
+  }
+
   static const uint8_t CHANNEL = 1;
+  static const uint8_t OTHER_CHANNEL = 2;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OPCClientTest);
@@ -111,3 +156,54 @@ void OPCClientTest::testTransmit() {
   // Now sends should fail since there is no connection
   OLA_ASSERT_FALSE(client.SendDmx(CHANNEL, buffer));
 }
+
+/*
+ * Check that frames sent in the same loop iteration are written together, and
+ * that only the latest frame for each channel is sent.
+ */
+void OPCClientTest::testCoalescing() {
+  m_server->SetCallback(
+      CHANNEL,
+      ola::NewCallback(this, &OPCClientTest::CaptureFrame));
+  m_server->SetCallback(
+      OTHER_CHANNEL,
+      ola::NewCallback(this, &OPCClientTest::CaptureOtherData));
+
+  OPCClient client(&m_ss, m_server->ListenAddress());
+  client.SetSocketCallback(
+      ola::NewCallback(this, &OPCClientTest::SendFrames, &client));
+
+  m_ss.Run();
+  DmxBuffer expected;
+  expected.SetFromString("4,5,6");
+  OLA_ASSERT_EQ(expected, m_received_data);
+  expected.SetFromString("7,8");
+  OLA_ASSERT_EQ(expected, m_other_data);
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(1u, client.DroppedFrames());
+}
+
+
+/*
+ * Check that frames larger than a universe are sent in a single message.
+ */
+void OPCClientTest::testLargeFrame() {
+  m_server->SetCallback(
+      OTHER_CHANNEL,
+      ola::NewCallback(this, &OPCClientTest::CaptureOtherData));
+
+  uint8_t data[1020];
+  for (unsigned int i = 0; i < arraysize(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  OPCClient client(&m_ss, m_server->ListenAddress());
+  client.SetSocketCallback(
+      ola::NewCallback(this, &OPCClientTest::SendLargeFrame, &client,
+                       static_cast<const uint8_t*>(data),
+                       static_cast<unsigned int>(arraysize(data))));
+
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(arraysize(data)), m_other_length);
+}
@@ -39,6 +39,17 @@ enum {
    * @brief The size of an OPC frame with DMX512 data.
    */
   OPC_FRAME_SIZE = DMX_UNIVERSE_SIZE + OPC_HEADER_SIZE,
+
+  /**
+   * @brief The number of slots in each universe when a channel is split
+   *   across more than one universe. This is 170 RGB pixels.
+   */
+  OPC_SPLIT_UNIVERSE_SIZE = 510,
+
+  /**
+   * @brief The maximum number of universes a channel can be split across.
+   */
+  OPC_MAX_UNIVERSES_PER_CHANNEL = 128,
 };
 
 /**
@@ -26,7 +26,10 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "plugins/openpixelcontrol/OPCConstants.h"
 #include "plugins/openpixelcontrol/OPCPort.h"
 
 namespace ola {
@@ -34,6 +37,8 @@ namespace plugin {
 namespace openpixelcontrol {
 
 using ola::AbstractPlugin;
+using ola::dmx::OutputCurve;
+using ola::dmx::PixelBuffer;
 using std::ostringstream;
 using std::set;
 using std::string;
@@ -55,6 +60,43 @@ set<uint8_t> DeDupChannels(const vector<string> &channels) {
   }
   return output;
 }
+
+unsigned int UniversesPerChannel(Preferences *preferences,
+                                 const string &key) {
+  unsigned int universes = 1;
+  string value = preferences->GetValue(key);
+  if (!value.empty() &&
+      (!StringToInt(value, &universes) || universes == 0 ||
+       universes > OPC_MAX_UNIVERSES_PER_CHANNEL)) {
+    OLA_WARN << "Invalid value for " << key << ": " << value;
+    universes = 1;
+  }
+  return universes;
+}
+
+void PopulateCurveOptions(Preferences *preferences,
+                          const string &prefix,
+                          OutputCurve::Options *options) {
+  const string gamma_key = prefix + "_gamma";
+  string value = preferences->GetValue(gamma_key);
+  if (!value.empty() && !OutputCurve::ParseGamma(value, &options->gamma)) {
+    OLA_WARN << "Invalid value for " << gamma_key << ": " << value;
+  }
+
+  const string brightness_key = prefix + "_brightness";
+  value = preferences->GetValue(brightness_key);
+  uint8_t brightness;
+  if (!value.empty()) {
+    if (StringToInt(value, &brightness) &&
+        brightness <= OutputCurve::MAX_BRIGHTNESS) {
+      options->brightness = brightness;
+    } else {
+      OLA_WARN << "Invalid value for " << brightness_key << ": " << value;
+    }
+  }
+
+  options->dither = preferences->GetValueAsBool(prefix + "_dither");
+}
 }  // namespace
 
 OPCServerDevice::OPCServerDevice(
@@ -82,11 +124,24 @@ bool OPCServerDevice::StartHook() {
   str << "listen_" << m_listen_addr << "_channel";
   set<uint8_t> channels = DeDupChannels(
       m_preferences->GetMultipleValue(str.str()));
+
+  // Large channels can be split across several universes.
+  str.str("");
+  str << "listen_" << m_listen_addr << "_universes_per_channel";
+  unsigned int universes = UniversesPerChannel(m_preferences, str.str());
+  unsigned int slot_count = DMX_UNIVERSE_SIZE;
+  if (universes > 1) {
+    slot_count = OPC_SPLIT_UNIVERSE_SIZE;
+  }
+
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCInputPort *port = new OPCInputPort(this, *iter, m_plugin_adaptor,
-                                          m_server.get());
-    AddPort(port);
+    for (unsigned int i = 0; i < universes; i++) {
+      OPCInputPort *port = new OPCInputPort(
+          this, *iter * universes + i, *iter, i * slot_count, slot_count,
+          m_plugin_adaptor, m_server.get());
+      AddPort(port);
+    }
   }
   return true;
 }
@@ -102,6 +157,11 @@ OPCClientDevice::OPCClientDevice(AbstractPlugin *owner,
       m_client(new OPCClient(plugin_adaptor, target)) {
 }
 
+OPCClientDevice::~OPCClientDevice() {
+  STLDeleteValues(&m_pixel_buffers);
+  STLDeleteValues(&m_curves);
+}
+
 string OPCClientDevice::DeviceId() const {
   return m_target.ToString();
 }
@@ -111,13 +171,55 @@ bool OPCClientDevice::StartHook() {
   str << "target_" << m_target << "_channel";
   set<uint8_t> channels = DeDupChannels(
       m_preferences->GetMultipleValue(str.str()));
+
+  // Long strips can be driven from several universes.
+  str.str("");
+  str << "target_" << m_target << "_universes_per_channel";
+  unsigned int universes = UniversesPerChannel(m_preferences, str.str());
+
+  str.str("");
+  str << "target_" << m_target;
+  OutputCurve::Options curve_options;
+  PopulateCurveOptions(m_preferences, str.str(), &curve_options);
+
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCOutputPort *port = new OPCOutputPort(this, *iter, m_client.get());
-    AddPort(port);
+    // Each channel has its own curve, since the dithering state is per slot.
+    OutputCurve *curve = new OutputCurve(curve_options);
+    if (curve->IsIdentity()) {
+      delete curve;
+      curve = NULL;
+    } else {
+      STLReplaceAndDelete(&m_curves, *iter, curve);
+    }
+
+    if (universes == 1) {
+      AddPort(new OPCOutputPort(this, *iter, *iter, m_client.get(), curve));
+      continue;
+    }
+
+    PixelBuffer *pixel_buffer = new PixelBuffer(
+        m_plugin_adaptor, PixelBuffer::Options(universes),
+        NewCallback(this, &OPCClientDevice::SendFrame, *iter));
+    STLReplaceAndDelete(&m_pixel_buffers, *iter, pixel_buffer);
+    for (unsigned int i = 0; i < universes; i++) {
+      AddPort(new OPCOutputPort(this, *iter * universes + i, *iter,
+                                m_client.get(), NULL, pixel_buffer, i));
+    }
   }
   return true;
 }
+
+void OPCClientDevice::SendFrame(uint8_t channel, const uint8_t *data,
+                                unsigned int length) {
+  OutputCurve *curve = STLFindOrNull(m_curves, channel);
+  if (curve && length) {
+    m_curve_data.resize(length);
+    curve->Apply(data, &m_curve_data[0], length);
+    data = &m_curve_data[0];
+  }
+  m_client->SendFrame(channel, data, length);
+}
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
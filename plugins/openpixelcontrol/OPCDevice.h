@@ -21,9 +21,13 @@
 #ifndef PLUGINS_OPENPIXELCONTROL_OPCDEVICE_H_
 #define PLUGINS_OPENPIXELCONTROL_OPCDEVICE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "ola/dmx/OutputCurve.h"
+#include "ola/dmx/PixelBuffer.h"
 #include "ola/network/Socket.h"
 #include "olad/Device.h"
 #include "plugins/openpixelcontrol/OPCClient.h"
@@ -79,6 +83,7 @@ class OPCClientDevice: public ola::Device {
                   PluginAdaptor *plugin_adaptor,
                   Preferences *preferences,
                   const ola::network::IPV4SocketAddress target);
+  ~OPCClientDevice();
 
   std::string DeviceId() const;
 
@@ -88,10 +93,18 @@ class OPCClientDevice: public ola::Device {
   bool StartHook();
 
  private:
+  typedef std::map<uint8_t, ola::dmx::PixelBuffer*> PixelBufferMap;
+  typedef std::map<uint8_t, ola::dmx::OutputCurve*> CurveMap;
+
   PluginAdaptor* const m_plugin_adaptor;
   Preferences* const m_preferences;
   const ola::network::IPV4SocketAddress m_target;
   std::auto_ptr<class OPCClient> m_client;
+  PixelBufferMap m_pixel_buffers;
+  CurveMap m_curves;
+  std::vector<uint8_t> m_curve_data;
+
+  void SendFrame(uint8_t channel, const uint8_t *data, unsigned int length);
 
   DISALLOW_COPY_AND_ASSIGN(OPCClientDevice);
 };
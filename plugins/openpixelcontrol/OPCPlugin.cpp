@@ -29,6 +29,7 @@
 #include "olad/Device.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/openpixelcontrol/OPCDevice.h"
 #include "plugins/openpixelcontrol/OPCPluginDescription.h"
 
@@ -106,3 +107,5 @@ void OPCPlugin::AddDevices(const std::string &key) {
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::openpixelcontrol::OPCPlugin)
@@ -20,6 +20,7 @@
 
 #include "plugins/openpixelcontrol/OPCPort.h"
 
+#include <algorithm>
 #include <string>
 #include "ola/base/Macro.h"
 #include "plugins/openpixelcontrol/OPCClient.h"
@@ -34,13 +35,19 @@ namespace openpixelcontrol {
 using std::string;
 
 OPCInputPort::OPCInputPort(OPCServerDevice *parent,
+                           unsigned int port_id,
                            uint8_t channel,
+                           unsigned int offset,
+                           unsigned int slot_count,
                            class PluginAdaptor *plugin_adaptor,
                            class OPCServer *server)
-    : BasicInputPort(parent, channel, plugin_adaptor),
+    : BasicInputPort(parent, port_id, plugin_adaptor),
       m_channel(channel),
+      m_offset(offset),
+      m_slot_count(slot_count),
       m_server(server) {
-  m_server->SetCallback(channel, NewCallback(this, &OPCInputPort::NewData));
+  m_server->SetCallback(channel, offset,
+                        NewCallback(this, &OPCInputPort::NewData));
 }
 
 void OPCInputPort::NewData(uint8_t command,
@@ -51,7 +58,7 @@ void OPCInputPort::NewData(uint8_t command,
               << static_cast<int>(command);
     return;
   }
-  m_buffer.Set(data, length);
+  m_buffer.Set(data, std::min(length, m_slot_count));
   DmxChanged();
 }
 
@@ -59,19 +66,36 @@ string OPCInputPort::Description() const {
   std::ostringstream str;
   str << m_server->ListenAddress() << ", Channel "
       << static_cast<int>(m_channel);
+  if (m_offset) {
+    str << ", from slot " << m_offset + 1;
+  }
   return str.str();
 }
 
 OPCOutputPort::OPCOutputPort(OPCClientDevice *parent,
+                             unsigned int port_id,
                              uint8_t channel,
-                             OPCClient *client)
-    : BasicOutputPort(parent, channel),
+                             OPCClient *client,
+                             ola::dmx::OutputCurve *curve,
+                             ola::dmx::PixelBuffer *pixel_buffer,
+                             unsigned int segment)
+    : BasicOutputPort(parent, port_id),
       m_client(client),
-      m_channel(channel) {
+      m_channel(channel),
+      m_curve(curve),
+      m_pixel_buffer(pixel_buffer),
+      m_segment(segment) {
 }
 
 bool OPCOutputPort::WriteDMX(const DmxBuffer &buffer,
                              OLA_UNUSED uint8_t priority) {
+  if (m_pixel_buffer) {
+    return m_pixel_buffer->Update(m_segment, buffer);
+  }
+  if (m_curve) {
+    m_curve->Apply(buffer, &m_buffer);
+    return m_client->SendDmx(m_channel, m_buffer);
+  }
   return m_client->SendDmx(m_channel, buffer);
 }
 
@@ -79,6 +103,10 @@ string OPCOutputPort::Description() const {
   std::ostringstream str;
   str << m_client->GetRemoteAddress() << ", Channel "
       << static_cast<int>(m_channel);
+  if (m_pixel_buffer) {
+    str << ", from slot "
+        << m_segment * m_pixel_buffer->SlotsPerSegment() + 1;
+  }
   return str.str();
 }
 }  // namespace openpixelcontrol
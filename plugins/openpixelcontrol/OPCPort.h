@@ -23,6 +23,8 @@
 
 #include <string>
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/OutputCurve.h"
+#include "ola/dmx/PixelBuffer.h"
 #include "olad/Port.h"
 #include "plugins/openpixelcontrol/OPCDevice.h"
 
@@ -40,12 +42,20 @@ class OPCInputPort: public BasicInputPort {
   /**
    * @brief Create a new OPC Input Port.
    * @param parent the OPCDevice this port belongs to
+   * @param port_id the id of the port.
    * @param channel the OPC channel for the port.
+   * @param offset the offset into the channel data where this port's
+   *   universe starts.
+   * @param slot_count the maximum number of slots to take from the channel
+   *   data.
    * @param plugin_adaptor the PluginAdaptor to use
    * @param server the OPCServer to use, ownership is not transferred.
    */
   OPCInputPort(OPCServerDevice *parent,
+               unsigned int port_id,
                uint8_t channel,
+               unsigned int offset,
+               unsigned int slot_count,
                class PluginAdaptor *plugin_adaptor,
                class OPCServer *server);
 
@@ -57,6 +67,8 @@ class OPCInputPort: public BasicInputPort {
 
  private:
   const uint8_t m_channel;
+  const unsigned int m_offset;
+  const unsigned int m_slot_count;
   class OPCServer* const m_server;
   DmxBuffer m_buffer;
 
@@ -67,19 +79,34 @@ class OPCInputPort: public BasicInputPort {
 
 /**
  * @brief An OutputPort for the OPC plugin.
+ *
+ * If the channel spans several universes, the port updates its segment of
+ * the channel's PixelBuffer and the message is sent once the frame is
+ * complete.
  */
 class OPCOutputPort: public BasicOutputPort {
  public:
   /**
    * @brief Create a new OPC Output Port.
    * @param parent the OPCDevice this port belongs to
+   * @param port_id the id of the port.
    * @param channel the OPC channel for the port.
    * @param client the OPCClient to use for this port, ownership is not
    *   transferred.
+   * @param curve the OutputCurve to apply, or NULL to send the data
+   *   unchanged. This is only used for single universe channels. Ownership
+   *   is not transferred.
+   * @param pixel_buffer the PixelBuffer for the channel, or NULL if the
+   *   channel uses a single universe. Ownership is not transferred.
+   * @param segment the segment of the PixelBuffer this port updates.
    */
   OPCOutputPort(OPCClientDevice *parent,
+                unsigned int port_id,
                 uint8_t channel,
-                class OPCClient *client);
+                class OPCClient *client,
+                ola::dmx::OutputCurve *curve = NULL,
+                ola::dmx::PixelBuffer *pixel_buffer = NULL,
+                unsigned int segment = 0);
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
 
@@ -88,6 +115,10 @@ class OPCOutputPort: public BasicOutputPort {
  private:
   class OPCClient* const m_client;
   const uint8_t m_channel;
+  ola::dmx::OutputCurve* const m_curve;
+  ola::dmx::PixelBuffer* const m_pixel_buffer;
+  const unsigned int m_segment;
+  DmxBuffer m_buffer;
 
   DISALLOW_COPY_AND_ASSIGN(OPCOutputPort);
 };
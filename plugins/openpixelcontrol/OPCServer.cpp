@@ -20,6 +20,7 @@
 
 #include "plugins/openpixelcontrol/OPCServer.h"
 
+#include <string.h>
 #include <string>
 #include "ola/Callback.h"
 #include "ola/Logging.h"
@@ -45,16 +46,27 @@ void CleanupSocket(TCPSocket *socket) {
 }
 }  // namespace
 
-void OPCServer::RxState::CheckSize() {
-  expected_size = utils::JoinUInt8(data[2], data[3]);
-  if (static_cast<unsigned int>(expected_size) + OPC_HEADER_SIZE >
-      buffer_size) {
-    uint8_t *new_buffer = new uint8_t[expected_size + OPC_HEADER_SIZE];
-    memcpy(new_buffer, data, offset);
+/*
+ * Make sure there is room for size bytes from start. This moves any
+ * unprocessed data to the start of the buffer, growing it if required.
+ */
+void OPCServer::RxState::Reserve(unsigned int size) {
+  if (start + size <= buffer_size) {
+    return;
+  }
+
+  unsigned int pending = end - start;
+  if (size <= buffer_size) {
+    memmove(data, data + start, pending);
+  } else {
+    uint8_t *new_buffer = new uint8_t[size];
+    memcpy(new_buffer, data + start, pending);
     delete[] data;
     data = new_buffer;
-    buffer_size = expected_size + OPC_HEADER_SIZE;
+    buffer_size = size;
   }
+  start = 0;
+  end = pending;
 }
 
 OPCServer::OPCServer(ola::io::SelectServerInterface *ss,
@@ -103,7 +115,12 @@ IPV4SocketAddress OPCServer::ListenAddress() const {
 }
 
 void OPCServer::SetCallback(uint8_t channel, ChannelCallback *callback) {
-  STLReplaceAndDelete(&m_callbacks, channel, callback);
+  SetCallback(channel, 0, callback);
+}
+
+void OPCServer::SetCallback(uint8_t channel, unsigned int offset,
+                            ChannelCallback *callback) {
+  STLReplaceAndDelete(&m_callbacks, CallbackKey(channel, offset), callback);
 }
 
 void OPCServer::NewTCPConnection(TCPSocket *socket) {
@@ -122,36 +139,53 @@ void OPCServer::NewTCPConnection(TCPSocket *socket) {
 }
 
 void OPCServer::SocketReady(TCPSocket *socket, RxState *rx_state) {
+  if (rx_state->end == rx_state->buffer_size) {
+    rx_state->Reserve(rx_state->buffer_size);
+  }
+
   unsigned int data_received = 0;
-  if (socket->Receive(rx_state->data + rx_state->offset,
-                      rx_state->buffer_size - rx_state->offset,
+  if (socket->Receive(rx_state->data + rx_state->end,
+                      rx_state->buffer_size - rx_state->end,
                       data_received) < 0) {
     OLA_WARN << "Bad read from " << socket->GetPeerAddress();
     SocketClosed(socket);
     return;
   }
-
-  rx_state->offset += data_received;
-  if (rx_state->offset < OPC_HEADER_SIZE) {
-    return;
+  rx_state->end += data_received;
+
+  // Dispatch all the complete messages we have, in place.
+  while (rx_state->end - rx_state->start >= OPC_HEADER_SIZE) {
+    const uint8_t *message = rx_state->data + rx_state->start;
+    unsigned int message_size = OPC_HEADER_SIZE +
+        utils::JoinUInt8(message[2], message[3]);
+    if (rx_state->end - rx_state->start < message_size) {
+      rx_state->Reserve(message_size);
+      return;
+    }
+    DispatchMessage(message);
+    rx_state->start += message_size;
   }
 
-  rx_state->CheckSize();
-  if (rx_state->offset <
-      static_cast<unsigned int>(rx_state->expected_size) + OPC_HEADER_SIZE) {
-    return;
+  if (rx_state->start == rx_state->end) {
+    rx_state->start = 0;
+    rx_state->end = 0;
   }
+}
 
-  ChannelCallback *cb = STLFindOrNull(m_callbacks, rx_state->data[0]);
-  if (cb) {
-    DmxBuffer buffer(rx_state->data + OPC_HEADER_SIZE,
-                     rx_state->offset - OPC_HEADER_SIZE);
-    cb->Run(rx_state->data[1],
-            rx_state->data + OPC_HEADER_SIZE,
-            rx_state->expected_size);
+void OPCServer::DispatchMessage(const uint8_t *message) {
+  uint8_t channel = message[0];
+  unsigned int length = utils::JoinUInt8(message[2], message[3]);
+  const uint8_t *data = message + OPC_HEADER_SIZE;
+
+  CallbackMap::iterator iter = m_callbacks.lower_bound(
+      CallbackKey(channel, 0));
+  for (; iter != m_callbacks.end() && iter->first.first == channel; ++iter) {
+    unsigned int offset = iter->first.second;
+    if (offset && offset >= length) {
+      break;
+    }
+    iter->second->Run(message[1], data + offset, length - offset);
   }
-  rx_state->offset = 0;
-  rx_state->expected_size = 0;
 }
 
 void OPCServer::SocketClosed(TCPSocket *socket) {
@@ -24,6 +24,7 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <utility>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/SelectServerInterface.h"
@@ -77,6 +78,21 @@ class OPCServer {
    */
   void SetCallback(uint8_t channel, ChannelCallback *callback);
 
+  /**
+   * @brief Set a callback for part of the channel data.
+   *
+   * This allows a large OPC message to be split across several universes.
+   * The callback is passed the data from offset onwards, and isn't run if the
+   * message is shorter than that. The data points into the receive buffer so
+   * it's only valid for the duration of the callback.
+   * @param channel the OPC channel this callback is for.
+   * @param offset the offset into the message data.
+   * @param callback The callback to run, ownership is transferred and any
+   *   previous callback for this channel and offset is removed.
+   */
+  void SetCallback(uint8_t channel, unsigned int offset,
+                   ChannelCallback *callback);
+
   /**
    * @brief The listen address of this server
    * @returns The listen address of the server. If the server isn't listening
@@ -85,17 +101,23 @@ class OPCServer {
   ola::network::IPV4SocketAddress ListenAddress() const;
 
  private:
+  /*
+   * Data from a client is received into a buffer and the complete messages
+   * are dispatched from there. Anything left over is moved to the start of
+   * the buffer before the next read.
+   */
   struct RxState {
    public:
-    unsigned int offset;
-    uint16_t expected_size;
     uint8_t *data;
     unsigned int buffer_size;
+    // The unprocessed data is in [start, end)
+    unsigned int start;
+    unsigned int end;
 
     RxState()
-        : offset(0),
-          expected_size(0) {
-      buffer_size = OPC_FRAME_SIZE,
+        : buffer_size(INITIAL_BUFFER_SIZE),
+          start(0),
+          end(0) {
       data = new uint8_t[buffer_size];
     }
 
@@ -103,10 +125,12 @@ class OPCServer {
       delete[] data;
     }
 
-    void CheckSize();
+    void Reserve(unsigned int size);
   };
 
   typedef std::map<ola::network::TCPSocket*, RxState*> ClientMap;
+  typedef std::pair<uint8_t, unsigned int> CallbackKey;
+  typedef std::map<CallbackKey, ChannelCallback*> CallbackMap;
 
   ola::io::SelectServerInterface* const m_ss;
   const ola::network::IPV4SocketAddress m_listen_addr;
@@ -114,11 +138,15 @@ class OPCServer {
 
   std::auto_ptr<ola::network::TCPAcceptingSocket> m_listening_socket;
   ClientMap m_clients;
-  std::map<uint8_t, ChannelCallback*> m_callbacks;
+  CallbackMap m_callbacks;
 
   void NewTCPConnection(ola::network::TCPSocket *socket);
   void SocketReady(ola::network::TCPSocket *socket, RxState *rx_state);
   void SocketClosed(ola::network::TCPSocket *socket);
+  void DispatchMessage(const uint8_t *message);
+
+  // Enough for a few full size frames per read.
+  static const unsigned int INITIAL_BUFFER_SIZE = 4 * OPC_FRAME_SIZE;
 
   DISALLOW_COPY_AND_ASSIGN(OPCServer);
 };
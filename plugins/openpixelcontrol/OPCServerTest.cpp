@@ -20,6 +20,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
 #include <memory>
 #include "ola/base/Array.h"
 #include "ola/Callback.h"
@@ -47,12 +48,16 @@ class OPCServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUnknownCommand);
   CPPUNIT_TEST(testLargeFrame);
   CPPUNIT_TEST(testHangingFrame);
+  CPPUNIT_TEST(testMultipleFrames);
+  CPPUNIT_TEST(testSplitChannel);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCServerTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_command(0),
+        m_frame_count(0) {
   }
   void setUp();
 
@@ -60,13 +65,17 @@ class OPCServerTest: public CppUnit::TestFixture {
   void testUnknownCommand();
   void testLargeFrame();
   void testHangingFrame();
+  void testMultipleFrames();
+  void testSplitChannel();
 
  private:
   ola::io::SelectServer m_ss;
   auto_ptr<OPCServer> m_server;
   auto_ptr<TCPSocket> m_client_socket;
   DmxBuffer m_received_data;
+  DmxBuffer m_split_data[3];
   uint8_t m_command;
+  unsigned int m_frame_count;
 
   void SendDataAndCheck(uint8_t channel,
                         const DmxBuffer &data);
@@ -77,6 +86,22 @@ class OPCServerTest: public CppUnit::TestFixture {
     m_ss.Terminate();
   }
 
+  void CountFrames(unsigned int expected, uint8_t, const uint8_t *data,
+                   unsigned int length) {
+    m_received_data.Set(data, length);
+    if (++m_frame_count == expected) {
+      m_ss.Terminate();
+    }
+  }
+
+  void CaptureSplitData(unsigned int universe, uint8_t, const uint8_t *data,
+                        unsigned int length) {
+    m_split_data[universe].Set(data, std::min(length, 510u));
+    if (universe == 1) {
+      m_ss.Terminate();
+    }
+  }
+
   static const uint8_t CHANNEL = 1;
   static const uint8_t SET_PIXELS_COMMAND = 0;
 };
@@ -151,3 +176,60 @@ void OPCServerTest::testHangingFrame() {
   uint8_t data[] = {1, 0};
   m_client_socket->Send(data, arraysize(data));
 }
+
+/*
+ * Check that all the messages in a single read are handled.
+ */
+void OPCServerTest::testMultipleFrames() {
+  m_server->SetCallback(
+      CHANNEL,
+      ola::NewCallback(this, &OPCServerTest::CountFrames, 3u));
+
+  uint8_t data[] = {
+    1, 0, 0, 2, 1, 2,
+    1, 0, 0, 3, 4, 5, 6,
+    1, 0, 0, 1, 7,
+  };
+  m_client_socket->Send(data, arraysize(data));
+  m_ss.Run();
+
+  DmxBuffer buffer;
+  buffer.SetFromString("7");
+  OLA_ASSERT_EQ(3u, m_frame_count);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+}
+
+/*
+ * Check a large message can be split across several callbacks.
+ */
+void OPCServerTest::testSplitChannel() {
+  const uint8_t SPLIT_CHANNEL = 2;
+  m_server->SetCallback(
+      SPLIT_CHANNEL, 0,
+      ola::NewCallback(this, &OPCServerTest::CaptureSplitData, 0u));
+  m_server->SetCallback(
+      SPLIT_CHANNEL, 510,
+      ola::NewCallback(this, &OPCServerTest::CaptureSplitData, 1u));
+  // This is past the end of the message, so it's never run.
+  m_server->SetCallback(
+      SPLIT_CHANNEL, 1020,
+      ola::NewCallback(this, &OPCServerTest::CaptureSplitData, 2u));
+
+  uint8_t data[1004];
+  data[0] = SPLIT_CHANNEL;
+  data[1] = 0;
+  ola::utils::SplitUInt16(1000, &data[2], &data[3]);
+  for (unsigned int i = 0; i < 1000; i++) {
+    data[i + 4] = i % 251;
+  }
+
+  // Send the data in two parts, to check they're re-assembled.
+  m_client_socket->Send(data, 300);
+  m_ss.RunOnce(ola::TimeInterval(1, 0));
+  m_client_socket->Send(data + 300, arraysize(data) - 300);
+  m_ss.Run();
+
+  OLA_ASSERT_EQ(DmxBuffer(data + 4, 510), m_split_data[0]);
+  OLA_ASSERT_EQ(DmxBuffer(data + 514, 490), m_split_data[1]);
+  OLA_ASSERT_EQ(0u, m_split_data[2].Size());
+}
@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCBundleBuilder.cpp
+ * Packs single argument OSC messages into bundles.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <string>
+#include "ola/network/NetworkUtils.h"
+#include "plugins/osc/OSCBundleBuilder.h"
+
+namespace ola {
+namespace plugin {
+namespace osc {
+
+using ola::network::HostToNetwork;
+using std::string;
+
+// "#bundle" and the null terminator, followed by the timetag.
+const char OSCBundleBuilder::BUNDLE_HEADER[] = "#bundle";
+
+namespace {
+// The size of each bundle element is sent before it.
+const unsigned int ELEMENT_SIZE_LENGTH = 4;
+// The type tag string, e.g. ",i", padded to four bytes.
+const unsigned int TYPE_TAG_LENGTH = 4;
+const unsigned int ARGUMENT_LENGTH = 4;
+}  // namespace
+
+OSCBundleBuilder::OSCBundleBuilder(unsigned int max_size)
+    : m_max_size(max_size),
+      m_message_count(0) {
+  Reset();
+}
+
+bool OSCBundleBuilder::AddInt32(const string &encoded_address,
+                                int32_t value) {
+  return AddMessage(encoded_address, 'i', static_cast<uint32_t>(value));
+}
+
+bool OSCBundleBuilder::AddFloat(const string &encoded_address, float value) {
+  uint32_t raw_value;
+  memcpy(&raw_value, &value, sizeof(raw_value));
+  return AddMessage(encoded_address, 'f', raw_value);
+}
+
+void OSCBundleBuilder::Reset() {
+  m_bundle.assign(BUNDLE_HEADER, sizeof(BUNDLE_HEADER));
+  // A timetag of 1 means 'immediately'.
+  AppendUInt32(0);
+  AppendUInt32(1);
+  m_message_count = 0;
+}
+
+const uint8_t *OSCBundleBuilder::Data() const {
+  unsigned int offset = m_message_count == 1 ?
+      BUNDLE_HEADER_SIZE + ELEMENT_SIZE_LENGTH : 0;
+  return reinterpret_cast<const uint8_t*>(m_bundle.data()) + offset;
+}
+
+unsigned int OSCBundleBuilder::Size() const {
+  unsigned int size = m_bundle.size();
+  return m_message_count == 1 ?
+      size - BUNDLE_HEADER_SIZE - ELEMENT_SIZE_LENGTH : size;
+}
+
+string OSCBundleBuilder::EncodeAddress(const string &address) {
+  string encoded = address;
+  // There's always at least one null.
+  encoded.append(4 - address.size() % 4, '\0');
+  return encoded;
+}
+
+bool OSCBundleBuilder::AddMessage(const string &encoded_address, char type,
+                                  uint32_t value) {
+  const unsigned int message_size =
+      encoded_address.size() + TYPE_TAG_LENGTH + ARGUMENT_LENGTH;
+  if (m_message_count &&
+      m_bundle.size() + ELEMENT_SIZE_LENGTH + message_size > m_max_size) {
+    return false;
+  }
+
+  AppendUInt32(message_size);
+  m_bundle.append(encoded_address);
+  m_bundle.push_back(',');
+  m_bundle.push_back(type);
+  m_bundle.append(2, '\0');
+  AppendUInt32(value);
+  m_message_count++;
+  return true;
+}
+
+void OSCBundleBuilder::AppendUInt32(uint32_t value) {
+  value = HostToNetwork(value);
+  m_bundle.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}  // namespace osc
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCBundleBuilder.h
+ * Packs single argument OSC messages into bundles.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_OSC_OSCBUNDLEBUILDER_H_
+#define PLUGINS_OSC_OSCBUNDLEBUILDER_H_
+
+#include <stdint.h>
+#include <string>
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace plugin {
+namespace osc {
+
+/**
+ * @brief Packs OSC messages with a single int32 or float argument into an
+ * OSC bundle.
+ *
+ * This is used for the per-slot formats, where a frame can change up to 512
+ * slots. Rather than sending a datagram per slot, the messages are packed
+ * into bundles no larger than the maximum size, which by default fills an
+ * Ethernet frame.
+ *
+ * The addresses are passed in already encoded, see EncodeAddress(), so they
+ * can be rendered once and reused for every frame.
+ *
+ * @code
+ *   OSCBundleBuilder builder;
+ *   while (...) {
+ *     if (!builder.AddInt32(address, value)) {
+ *       // send builder.Data(), builder.Size()
+ *       builder.Reset();
+ *       builder.AddInt32(address, value);
+ *     }
+ *   }
+ * @endcode
+ */
+class OSCBundleBuilder {
+ public:
+  /**
+   * @brief Create a new OSCBundleBuilder.
+   * @param max_size the largest bundle to build, in bytes.
+   */
+  explicit OSCBundleBuilder(unsigned int max_size = DEFAULT_MAX_SIZE);
+
+  /**
+   * @brief Add a message with an int32 argument.
+   * @param encoded_address the address, from EncodeAddress().
+   * @param value the argument.
+   * @returns false if the bundle is full. A message is always added to an
+   *   empty bundle.
+   */
+  bool AddInt32(const std::string &encoded_address, int32_t value);
+
+  /**
+   * @brief Add a message with a float argument.
+   * @param encoded_address the address, from EncodeAddress().
+   * @param value the argument.
+   * @returns false if the bundle is full. A message is always added to an
+   *   empty bundle.
+   */
+  bool AddFloat(const std::string &encoded_address, float value);
+
+  /**
+   * @brief Remove all the messages.
+   */
+  void Reset();
+
+  /**
+   * @brief The number of messages added since the last Reset().
+   */
+  unsigned int MessageCount() const { return m_message_count; }
+
+  /**
+   * @brief The data to send.
+   *
+   * If there's exactly one message it's returned on its own, since a bundle
+   * only adds overhead, and isn't understood by all receivers.
+   */
+  const uint8_t *Data() const;
+
+  /**
+   * @brief The size of Data().
+   */
+  unsigned int Size() const;
+
+  /**
+   * @brief Encode an OSC address.
+   * @param address the OSC address, e.g. /dmx/universe/1/10.
+   * @returns the address, null terminated and padded to a multiple of four
+   *   bytes.
+   */
+  static std::string EncodeAddress(const std::string &address);
+
+  // An Ethernet frame, less the IPv4 and UDP headers.
+  static const unsigned int DEFAULT_MAX_SIZE = 1472;
+
+ private:
+  const unsigned int m_max_size;
+  std::string m_bundle;
+  unsigned int m_message_count;
+
+  bool AddMessage(const std::string &encoded_address, char type,
+                  uint32_t value);
+  void AppendUInt32(uint32_t value);
+
+  static const char BUNDLE_HEADER[];
+  // The header and an immediate timetag.
+  static const unsigned int BUNDLE_HEADER_SIZE = 16;
+
+  DISALLOW_COPY_AND_ASSIGN(OSCBundleBuilder);
+};
+}  // namespace osc
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_OSC_OSCBUNDLEBUILDER_H_
@@ -0,0 +1,125 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OSCBundleBuilderTest.cpp
+ * Test fixture for the OSCBundleBuilder class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/testing/TestUtils.h"
+#include "plugins/osc/OSCBundleBuilder.h"
+
+using ola::plugin::osc::OSCBundleBuilder;
+using std::string;
+
+class OSCBundleBuilderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OSCBundleBuilderTest);
+  CPPUNIT_TEST(testEncodeAddress);
+  CPPUNIT_TEST(testSingleMessage);
+  CPPUNIT_TEST(testBundle);
+  CPPUNIT_TEST(testMaxSize);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncodeAddress();
+    void testSingleMessage();
+    void testBundle();
+    void testMaxSize();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OSCBundleBuilderTest);
+
+/**
+ * Check that addresses are terminated and padded.
+ */
+void OSCBundleBuilderTest::testEncodeAddress() {
+  OLA_ASSERT_EQ(string("\0\0\0\0", 4), OSCBundleBuilder::EncodeAddress(""));
+  OLA_ASSERT_EQ(string("/a\0\0", 4), OSCBundleBuilder::EncodeAddress("/a"));
+  OLA_ASSERT_EQ(string("/ab\0", 4), OSCBundleBuilder::EncodeAddress("/ab"));
+  OLA_ASSERT_EQ(string("/abc\0\0\0\0", 8),
+                OSCBundleBuilder::EncodeAddress("/abc"));
+}
+
+/**
+ * Check a single message is sent without the bundle.
+ */
+void OSCBundleBuilderTest::testSingleMessage() {
+  const uint8_t expected[] = {
+    '/', 'd', 'm', 'x', '/', '6', 0, 0,
+    ',', 'i', 0, 0,
+    0, 0, 0, 140
+  };
+
+  OSCBundleBuilder builder;
+  OLA_ASSERT_EQ(0u, builder.MessageCount());
+  OLA_ASSERT_TRUE(
+      builder.AddInt32(OSCBundleBuilder::EncodeAddress("/dmx/6"), 140));
+  OLA_ASSERT_EQ(1u, builder.MessageCount());
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                         builder.Data(), builder.Size());
+}
+
+/**
+ * Check messages are packed into a bundle.
+ */
+void OSCBundleBuilderTest::testBundle() {
+  const uint8_t expected[] = {
+    '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 16,
+    '/', 'd', 'm', 'x', '/', '1', 0, 0,
+    ',', 'i', 0, 0,
+    0, 0, 0, 10,
+    0, 0, 0, 16,
+    '/', 'd', 'm', 'x', '/', '2', 0, 0,
+    ',', 'f', 0, 0,
+    0x3f, 0, 0, 0
+  };
+
+  OSCBundleBuilder builder;
+  OLA_ASSERT_TRUE(
+      builder.AddInt32(OSCBundleBuilder::EncodeAddress("/dmx/1"), 10));
+  OLA_ASSERT_TRUE(
+      builder.AddFloat(OSCBundleBuilder::EncodeAddress("/dmx/2"), 0.5));
+  OLA_ASSERT_EQ(2u, builder.MessageCount());
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected),
+                         builder.Data(), builder.Size());
+
+  builder.Reset();
+  OLA_ASSERT_EQ(0u, builder.MessageCount());
+}
+
+/**
+ * Check bundles don't grow past the maximum size.
+ */
+void OSCBundleBuilderTest::testMaxSize() {
+  // The header and two 16 byte messages.
+  OSCBundleBuilder builder(56);
+  const string address = OSCBundleBuilder::EncodeAddress("/dmx/1");
+  OLA_ASSERT_TRUE(builder.AddInt32(address, 1));
+  OLA_ASSERT_TRUE(builder.AddInt32(address, 2));
+  OLA_ASSERT_FALSE(builder.AddInt32(address, 3));
+  OLA_ASSERT_EQ(2u, builder.MessageCount());
+  OLA_ASSERT_EQ(56u, builder.Size());
+
+  // A message that's too large on its own is still added to an empty bundle.
+  OSCBundleBuilder small_builder(8);
+  OLA_ASSERT_TRUE(small_builder.AddInt32(address, 1));
+  OLA_ASSERT_FALSE(small_builder.AddInt32(address, 2));
+  OLA_ASSERT_EQ(16u, small_builder.Size());
+}
@@ -18,20 +18,33 @@
  * Copyright (C) 2012 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #ifdef _WIN32
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
 
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif  // HAVE_SYS_SOCKET_H
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif  // HAVE_NETINET_IN_H
+
 #include <ola/Callback.h>
 #include <ola/Constants.h>
 #include <ola/ExportMap.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
 #include <ola/stl/STLUtils.h>
+#include <string.h>
 #include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
+#include "plugins/osc/OSCBundleBuilder.h"
 #include "plugins/osc/OSCNode.h"
 
 namespace ola {
@@ -80,28 +93,42 @@ void OSCErrorHandler(int error_code, const char *msg, const char *stack) {
 
 
 /**
- * Extract the slot number and group address from an OSC address
+ * Split an OSC address of the form <group address>/<slot>. This is called
+ * for every per-slot message, so it works on the raw address rather than
+ * copying it.
+ * @param osc_address the OSC address.
+ * @param[out] group_length the length of the group address.
+ * @param[out] slot the slot offset, from 0.
+ * @returns true if the address ends in a valid slot number.
  */
-bool ExtractSlotFromPath(const string &osc_address,
-                         string *group_address,
-                         uint16_t *slot) {
-  size_t pos = osc_address.find_last_of("/");
-  if (pos == string::npos) {
-    OLA_WARN << "Got invalid OSC message to " << osc_address;
-    return false;
+bool SplitSlotAddress(const char *osc_address, size_t *group_length,
+                      uint16_t *slot) {
+  size_t pos = strlen(osc_address);
+  unsigned int value = 0;
+  unsigned int multiplier = 1;
+  while (pos > 0 && osc_address[pos - 1] >= '0' &&
+         osc_address[pos - 1] <= '9') {
+    pos--;
+    value += (osc_address[pos] - '0') * multiplier;
+    multiplier *= 10;
+    if (multiplier > 1000) {
+      OLA_WARN << "Ignoring slot in " << osc_address;
+      return false;
+    }
   }
-  if (!StringToInt(osc_address.substr(pos + 1), slot, true)) {
-    OLA_WARN << "Unable to extract slot from " << osc_address.substr(pos + 1);
+
+  if (pos == 0 || osc_address[pos - 1] != '/' || multiplier == 1) {
+    OLA_WARN << "Got invalid OSC message to " << osc_address;
     return false;
   }
 
-  if (*slot == 0 || *slot > DMX_UNIVERSE_SIZE) {
-    OLA_WARN << "Ignoring slot " << *slot;
-    return 0;
+  if (value == 0 || value > DMX_UNIVERSE_SIZE) {
+    OLA_WARN << "Ignoring slot " << value;
+    return false;
   }
-  (*slot)--;
 
-  *group_address = osc_address.substr(0, pos);
+  *slot = static_cast<uint16_t>(value - 1);
+  *group_length = pos - 1;
   return true;
 }
 
@@ -147,6 +174,7 @@ int OSCDataHandler(const char *osc_address, const char *types, lo_arg **argv,
   OSCNode *node = reinterpret_cast<OSCNode*>(user_data);
   const string type(types);
   uint16_t slot;
+  size_t group_length;
 
   if (argc == 1) {
     if (type == "b") {
@@ -154,23 +182,23 @@ int OSCDataHandler(const char *osc_address, const char *types, lo_arg **argv,
       unsigned int size = min(static_cast<uint32_t>(DMX_UNIVERSE_SIZE),
                               lo_blob_datasize(blob));
       node->SetUniverse(
-          osc_address, static_cast<uint8_t*>(lo_blob_dataptr(blob)), size);
+          osc_address, strlen(osc_address),
+          static_cast<uint8_t*>(lo_blob_dataptr(blob)), size);
       return 0;
     } else if (type == "f") {
       float val = max(0.0f, min(1.0f, argv[0]->f));
-      string group_address;
-      if (!ExtractSlotFromPath(osc_address, &group_address, &slot))
+      if (!SplitSlotAddress(osc_address, &group_length, &slot))
         return 0;
 
-      node->SetSlot(group_address, slot,  val * DMX_MAX_SLOT_VALUE);
+      node->SetSlot(osc_address, group_length, slot,
+                    val * DMX_MAX_SLOT_VALUE);
       return 0;
     } else if (type == "i") {
       int val = min(static_cast<int>(DMX_MAX_SLOT_VALUE), max(0, argv[0]->i));
-      string group_address;
-      if (!ExtractSlotFromPath(osc_address, &group_address, &slot))
+      if (!SplitSlotAddress(osc_address, &group_length, &slot))
         return 0;
 
-      node->SetSlot(group_address, slot,  val);
+      node->SetSlot(osc_address, group_length, slot, val);
       return 0;
     }
   } else if (argc == 2) {
@@ -179,7 +207,7 @@ int OSCDataHandler(const char *osc_address, const char *types, lo_arg **argv,
       return 0;
     }
 
-    node->SetSlot(osc_address, slot,  value);
+    node->SetSlot(osc_address, strlen(osc_address), slot, value);
     return 0;
   }
   OLA_WARN << "Unknown OSC message type " << type;
@@ -285,6 +313,7 @@ void OSCNode::Stop() {
   m_output_map.clear();
 
   // Delete all the RX callbacks.
+  m_changed_groups.clear();
   STLDeleteValues(&m_input_map);
 
   if (m_descriptor.get()) {
@@ -423,6 +452,13 @@ bool OSCNode::RegisterAddress(const string &osc_address,
     }
   } else {
     // deregister
+    OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
+    if (universe_data && universe_data->changed) {
+      m_changed_groups.erase(std::remove(m_changed_groups.begin(),
+                                         m_changed_groups.end(),
+                                         universe_data),
+                             m_changed_groups.end());
+    }
     STLRemoveAndDelete(&m_input_map, osc_address);
   }
   return true;
@@ -432,37 +468,36 @@ bool OSCNode::RegisterAddress(const string &osc_address,
 /**
  * Called by OSCDataHandler when there is new data.
  * @param osc_address the OSC address this data arrived on
+ * @param address_length the length of osc_address.
  * @param data the DmxBuffer containing the data.
  * @param size the number of slots.
  */
-void OSCNode::SetUniverse(const string &osc_address, const uint8_t *data,
-                          unsigned int size) {
-  OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
+void OSCNode::SetUniverse(const char *osc_address, size_t address_length,
+                          const uint8_t *data, unsigned int size) {
+  OSCInputGroup *universe_data = FindInputGroup(osc_address, address_length);
   if (!universe_data)
     return;
 
   universe_data->dmx.Set(data, size);
-  if (universe_data->callback.get()) {
-    universe_data->callback->Run(universe_data->dmx);
-  }
+  MarkChanged(universe_data);
 }
 
 /**
  * Called by OSCDataHandler when there is new data.
- * @param osc_address the OSC address this data arrived on
+ * @param osc_address the OSC address this data arrived on. Only the first
+ *   address_length characters are used.
+ * @param address_length the length of the group address in osc_address.
  * @param slot the slot offset to set.
  * @param value the DMX value for the slot
  */
-void OSCNode::SetSlot(const string &osc_address, uint16_t slot, uint8_t value) {
-  OSCInputGroup *universe_data = STLFindOrNull(m_input_map, osc_address);
+void OSCNode::SetSlot(const char *osc_address, size_t address_length,
+                      uint16_t slot, uint8_t value) {
+  OSCInputGroup *universe_data = FindInputGroup(osc_address, address_length);
   if (!universe_data)
     return;
 
   universe_data->dmx.SetChannel(slot, value);
-
-  if (universe_data->callback.get()) {
-    universe_data->callback->Run(universe_data->dmx);
-  }
+  MarkChanged(universe_data);
 }
 
 
@@ -483,6 +518,40 @@ uint16_t OSCNode::ListeningPort() const {
 void OSCNode::DescriptorReady() {
   // Call into liblo with a timeout of 0 so we don't block.
   lo_server_recv_noblock(m_osc_server, 0);
+
+  // A bundle can update many slots of a group, so the callbacks are run once
+  // the whole datagram has been handled.
+  vector<OSCInputGroup*> changed_groups;
+  changed_groups.swap(m_changed_groups);
+  vector<OSCInputGroup*>::iterator iter = changed_groups.begin();
+  for (; iter != changed_groups.end(); ++iter) {
+    (*iter)->changed = false;
+    if ((*iter)->callback.get()) {
+      (*iter)->callback->Run((*iter)->dmx);
+    }
+  }
+}
+
+
+/**
+ * Find the input group for an address.
+ */
+OSCNode::OSCInputGroup *OSCNode::FindInputGroup(const char *osc_address,
+                                                size_t address_length) {
+  // This reuses the key's storage, rather than allocating for each message.
+  m_lookup_key.assign(osc_address, address_length);
+  return STLFindOrNull(m_input_map, m_lookup_key);
+}
+
+
+/**
+ * Queue the callback for an input group.
+ */
+void OSCNode::MarkChanged(OSCInputGroup *group) {
+  if (!group->changed) {
+    group->changed = true;
+    m_changed_groups.push_back(group);
+  }
 }
 
 
@@ -582,8 +651,46 @@ bool OSCNode::SendMessageToTargets(lo_message message,
 }
 
 
+/**
+ * Send an encoded OSC packet to a target.
+ */
+bool OSCNode::SendPacket(const NodeOSCTarget &target, const uint8_t *data,
+                         unsigned int size) {
+  struct sockaddr_in address;
+  target.socket_address.ToSockAddr(
+      reinterpret_cast<struct sockaddr*>(&address), sizeof(address));
+  ssize_t sent = sendto(lo_server_get_socket_fd(m_osc_server),
+                        reinterpret_cast<const char*>(data), size, 0,
+                        reinterpret_cast<struct sockaddr*>(&address),
+                        sizeof(address));
+  if (sent != static_cast<ssize_t>(size)) {
+    OLA_INFO << "Failed to send OSC packet to " << target.socket_address;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Return the encoded OSC address for a slot of a target, rendering the
+ * addresses the first time they're used.
+ */
+const string &OSCNode::SlotAddress(NodeOSCTarget *target, unsigned int slot) {
+  if (target->slot_addresses.empty()) {
+    target->slot_addresses.reserve(DMX_UNIVERSE_SIZE);
+    for (unsigned int i = 1; i <= DMX_UNIVERSE_SIZE; i++) {
+      target->slot_addresses.push_back(OSCBundleBuilder::EncodeAddress(
+          target->osc_address + "/" + IntToString(i)));
+    }
+  }
+  return target->slot_addresses[slot];
+}
+
 /**
  * Send individual messages (one slot per message) to a set of targets.
+ *
+ * Only the slots that changed since the last call are sent. The messages are
+ * packed into bundles, so a full universe is a handful of datagrams per
+ * target.
  * @param dmx_data the DmxBuffer to send
  * @param group the OSCOutputGroup with the targets.
  * @param osc_type the type of OSC message, either "i" or "f"
@@ -591,49 +698,43 @@ bool OSCNode::SendMessageToTargets(lo_message message,
 bool OSCNode::SendIndividualMessages(const DmxBuffer &dmx_data,
                                      OSCOutputGroup *group,
                                      const string &osc_type) {
-  bool ok = true;
-  const OSCTargetVector &targets = group->targets;
-
-  vector<SlotMessage> messages;
-
-  // We only send the slots that have changed.
+  vector<unsigned int> changed_slots;
   for (unsigned int i = 0; i < dmx_data.Size(); ++i) {
-    if (i > group->dmx.Size() || dmx_data.Get(i) != group->dmx.Get(i)) {
-      SlotMessage message = {i, lo_message_new()};
-      if (osc_type == "i") {
-        lo_message_add_int32(message.message, dmx_data.Get(i));
-      } else {
-        lo_message_add_float(message.message, dmx_data.Get(i) / 255.0f);
-      }
-      messages.push_back(message);
+    if (i >= group->dmx.Size() || dmx_data.Get(i) != group->dmx.Get(i)) {
+      changed_slots.push_back(i);
     }
   }
   group->dmx.Set(dmx_data);
 
-  // Send all messages to each target.
-  OSCTargetVector::const_iterator target_iter = targets.begin();
-  for (; target_iter != targets.end(); ++target_iter) {
-    OLA_DEBUG << "Sending to " << (*target_iter)->socket_address;
-
-    vector<SlotMessage>::const_iterator message_iter = messages.begin();
-    for (; message_iter != messages.end(); ++message_iter) {
-      std::ostringstream path;
-      path << (*target_iter)->osc_address << "/" << message_iter->slot + 1;
-
-      int ret = lo_send_message_from((*target_iter)->liblo_address,
-                                     m_osc_server,
-                                     path.str().c_str(),
-                                     message_iter->message);
-      ok &= (ret > 0);
-    }
+  if (changed_slots.empty()) {
+    return true;
   }
 
-  // Clean up the messages.
-  vector<SlotMessage>::iterator message_iter = messages.begin();
-  for (; message_iter != messages.end(); ++message_iter) {
-    lo_message_free(message_iter->message);
+  const bool send_ints = osc_type == "i";
+  bool ok = true;
+  OSCBundleBuilder builder;
+  OSCTargetVector::const_iterator target_iter = group->targets.begin();
+  for (; target_iter != group->targets.end(); ++target_iter) {
+    OLA_DEBUG << "Sending to " << (*target_iter)->socket_address;
+    builder.Reset();
+
+    vector<unsigned int>::const_iterator slot_iter = changed_slots.begin();
+    while (slot_iter != changed_slots.end()) {
+      const string &address = SlotAddress(*target_iter, *slot_iter);
+      const uint8_t value = dmx_data.Get(*slot_iter);
+      bool added = send_ints ?
+          builder.AddInt32(address, value) :
+          builder.AddFloat(address, value / 255.0f);
+      if (added) {
+        ++slot_iter;
+      } else {
+        // The bundle is full, send it and add this slot to the next one.
+        ok &= SendPacket(**target_iter, builder.Data(), builder.Size());
+        builder.Reset();
+      }
+    }
+    ok &= SendPacket(**target_iter, builder.Data(), builder.Size());
   }
-
   return ok;
 }
 }  // namespace osc
@@ -21,6 +21,10 @@
 #ifndef PLUGINS_OSC_OSCNODE_H_
 #define PLUGINS_OSC_OSCNODE_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <lo/lo.h>
 #include <ola/DmxBuffer.h>
 #include <ola/ExportMap.h>
@@ -32,8 +36,21 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include HASH_MAP_H
 #include "plugins/osc/OSCTarget.h"
 
+#ifndef HAVE_UNORDERED_MAP
+// This adds support for hashing strings if it's not present
+namespace HASH_NAMESPACE {
+
+template<> struct hash<std::string> {
+  size_t operator()(const std::string& x) const {
+    return hash<const char*>()(x.c_str());
+  }
+};
+}  // namespace HASH_NAMESPACE
+#endif  // HAVE_UNORDERED_MAP
+
 namespace ola {
 namespace plugin {
 namespace osc {
@@ -104,10 +121,12 @@ class OSCNode {
   // Receiving methods
   bool RegisterAddress(const std::string &osc_address, DMXCallback *callback);
 
-  // Called by the liblo handlers.
-  void SetUniverse(const std::string &osc_address, const uint8_t *data,
-                   unsigned int size);
-  void SetSlot(const std::string &osc_address, uint16_t slot, uint8_t value);
+  // Called by the liblo handlers. The callbacks are run once the datagram
+  // has been handled, so a bundle results in a single callback.
+  void SetUniverse(const char *osc_address, size_t address_length,
+                   const uint8_t *data, unsigned int size);
+  void SetSlot(const char *osc_address, size_t address_length,
+               uint16_t slot, uint8_t value);
 
   // The port OSC is listening on.
   uint16_t ListeningPort() const;
@@ -131,6 +150,8 @@ class OSCNode {
     ola::network::IPV4SocketAddress socket_address;
     std::string osc_address;
     lo_address liblo_address;
+    // The encoded address for each slot, used by the per-slot formats.
+    std::vector<std::string> slot_addresses;
 
    private:
     NodeOSCTarget(const NodeOSCTarget&);
@@ -145,19 +166,19 @@ class OSCNode {
   };
 
   struct OSCInputGroup {
-    explicit OSCInputGroup(DMXCallback *callback) : callback(callback) {}
+    explicit OSCInputGroup(DMXCallback *callback)
+        : callback(callback),
+          changed(false) {
+    }
 
     DmxBuffer dmx;
     std::auto_ptr<DMXCallback> callback;
+    bool changed;  // true if the callback is queued
   };
 
   typedef std::map<unsigned int, OSCOutputGroup*> OutputGroupMap;
-  typedef std::map<std::string, OSCInputGroup*> InputUniverseMap;
-
-  struct SlotMessage {
-    unsigned int slot;
-    lo_message message;
-  };
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<std::string,
+                                         OSCInputGroup*> InputUniverseMap;
 
   ola::io::SelectServerInterface *m_ss;
   const uint16_t m_listen_port;
@@ -165,8 +186,13 @@ class OSCNode {
   lo_server m_osc_server;
   OutputGroupMap m_output_map;
   InputUniverseMap m_input_map;
+  std::vector<OSCInputGroup*> m_changed_groups;
+  std::string m_lookup_key;
 
   void DescriptorReady();
+  OSCInputGroup *FindInputGroup(const char *osc_address,
+                                size_t address_length);
+  void MarkChanged(OSCInputGroup *group);
   bool SendBlob(const DmxBuffer &data, const OSCTargetVector &targets);
   bool SendIndividualFloats(const DmxBuffer &data,
                             OSCOutputGroup *group);
@@ -181,6 +207,9 @@ class OSCNode {
   bool SendIndividualMessages(const DmxBuffer &data,
                               OSCOutputGroup *group,
                               const std::string &osc_type);
+  bool SendPacket(const NodeOSCTarget &target, const uint8_t *data,
+                  unsigned int size);
+  const std::string &SlotAddress(NodeOSCTarget *target, unsigned int slot);
 
   static const uint16_t DEFAULT_OSC_PORT = 7770;
   static const char OSC_PORT_VARIABLE[];
@@ -50,6 +50,7 @@ using std::auto_ptr;
 class OSCNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OSCNodeTest);
   CPPUNIT_TEST(testSendBlob);
+  CPPUNIT_TEST(testSendIndividualInts);
   CPPUNIT_TEST(testReceive);
   CPPUNIT_TEST_SUITE_END();
 
@@ -59,7 +60,10 @@ class OSCNodeTest: public CppUnit::TestFixture {
      */
     OSCNodeTest()
         : CppUnit::TestFixture(),
-          m_timeout_id(ola::thread::INVALID_TIMEOUT) {
+          m_timeout_id(ola::thread::INVALID_TIMEOUT),
+          m_expected_data(NULL),
+          m_expected_size(0),
+          m_dmx_callbacks(0) {
       OSCNode::OSCNodeOptions options;
       options.listen_port = 0;
       m_osc_node.reset(new OSCNode(&m_ss, NULL, options));
@@ -70,8 +74,8 @@ class OSCNodeTest: public CppUnit::TestFixture {
     void setUp();
     void tearDown() { m_osc_node->Stop(); }
 
-    // our two tests
     void testSendBlob();
+    void testSendIndividualInts();
     void testReceive();
 
     // Called if we don't receive data in ABORT_TIMEOUT_IN_MS
@@ -84,7 +88,12 @@ class OSCNodeTest: public CppUnit::TestFixture {
     ola::thread::timeout_id m_timeout_id;
     DmxBuffer m_dmx_data;
     DmxBuffer m_received_data;
+    // The packet we expect to receive on m_udp_socket.
+    const uint8_t *m_expected_data;
+    unsigned int m_expected_size;
+    unsigned int m_dmx_callbacks;
 
+    void SetupTarget(OSCTarget *target);
     void UDPSocketReady();
     void DMXHandler(const DmxBuffer &dmx);
 
@@ -92,6 +101,7 @@ class OSCNodeTest: public CppUnit::TestFixture {
     // The number of mseconds to wait before failing the test.
     static const int ABORT_TIMEOUT_IN_MS = 2000;
     static const uint8_t OSC_BLOB_DATA[];
+    static const uint8_t OSC_INT_BUNDLE_DATA[];
     static const uint8_t OSC_SINGLE_FLOAT_DATA[];
     static const uint8_t OSC_SINGLE_INT_DATA[];
     static const uint8_t OSC_INT_TUPLE_DATA[];
@@ -116,6 +126,27 @@ const uint8_t OSCNodeTest::OSC_BLOB_DATA[] = {
   8, 9, 0xa, 0
 };
 
+// An OSC bundle with int messages for slots 1 & 2
+const uint8_t OSCNodeTest::OSC_INT_BUNDLE_DATA[] = {
+  // bundle header and timetag
+  '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+  0, 0, 0, 0, 0, 0, 0, 1,
+  // first message
+  0, 0, 0, 28,
+  '/', 'd', 'm', 'x', '/', 'u', 'n', 'i',
+  'v', 'e', 'r', 's', 'e', '/', '1', '0',
+  '/', '1', 0, 0,
+  ',', 'i', 0, 0,
+  0, 0, 0, 10,
+  // second message
+  0, 0, 0, 28,
+  '/', 'd', 'm', 'x', '/', 'u', 'n', 'i',
+  'v', 'e', 'r', 's', 'e', '/', '1', '0',
+  '/', '2', 0, 0,
+  ',', 'i', 0, 0,
+  0, 0, 0, 140
+};
+
 // An OSC single float packet for slot 1
 const uint8_t OSCNodeTest::OSC_SINGLE_FLOAT_DATA[] = {
   // osc address
@@ -199,7 +230,7 @@ void OSCNodeTest::UDPSocketReady() {
   // Read the received packet into 'data'.
   OLA_ASSERT_TRUE(m_udp_socket.RecvFrom(data, &data_read));
   // Verify it matches the expected packet
-  OLA_ASSERT_DATA_EQUALS(OSC_BLOB_DATA, sizeof(OSC_BLOB_DATA), data, data_read);
+  OLA_ASSERT_DATA_EQUALS(m_expected_data, m_expected_size, data, data_read);
   // Stop the SelectServer
   m_ss.Terminate();
 }
@@ -210,14 +241,15 @@ void OSCNodeTest::UDPSocketReady() {
  */
 void OSCNodeTest::DMXHandler(const DmxBuffer &dmx) {
   m_received_data = dmx;
+  m_dmx_callbacks++;
   m_ss.Terminate();
 }
 
 
 /**
- * Check that we send OSC messages correctly.
+ * Bind the UDP socket and return a target which points at it.
  */
-void OSCNodeTest::testSendBlob() {
+void OSCNodeTest::SetupTarget(OSCTarget *target) {
   // First up create a UDP socket to receive the messages on.
   // Port 0 means 'ANY'
   IPV4SocketAddress socket_address(IPV4Address::Loopback(), 0);
@@ -230,7 +262,19 @@ void OSCNodeTest::testSendBlob() {
   OLA_ASSERT_TRUE(m_udp_socket.GetSocketAddress(&socket_address));
 
   // Setup the OSCTarget pointing to the local socket address
-  OSCTarget target(socket_address, TEST_OSC_ADDRESS);
+  *target = OSCTarget(socket_address, TEST_OSC_ADDRESS);
+}
+
+
+/**
+ * Check that we send OSC messages correctly.
+ */
+void OSCNodeTest::testSendBlob() {
+  OSCTarget target;
+  SetupTarget(&target);
+  m_expected_data = OSC_BLOB_DATA;
+  m_expected_size = sizeof(OSC_BLOB_DATA);
+
   // Add the target to the node.
   m_osc_node->AddTarget(TEST_GROUP, target);
   // Send the data
@@ -251,6 +295,29 @@ void OSCNodeTest::testSendBlob() {
 }
 
 
+/**
+ * Check that the per-slot messages are sent in a bundle.
+ */
+void OSCNodeTest::testSendIndividualInts() {
+  OSCTarget target;
+  SetupTarget(&target);
+  m_expected_data = OSC_INT_BUNDLE_DATA;
+  m_expected_size = sizeof(OSC_INT_BUNDLE_DATA);
+
+  m_osc_node->AddTarget(TEST_GROUP, target);
+  DmxBuffer dmx;
+  dmx.SetFromString("10,140");
+  OLA_ASSERT_TRUE(m_osc_node->SendData(
+      TEST_GROUP, OSCNode::FORMAT_INT_INDIVIDUAL, dmx));
+  m_ss.Run();
+
+  // Nothing changed, so nothing is sent.
+  OLA_ASSERT_TRUE(m_osc_node->SendData(
+      TEST_GROUP, OSCNode::FORMAT_INT_INDIVIDUAL, dmx));
+  OLA_ASSERT_TRUE(m_osc_node->RemoveTarget(TEST_GROUP, target));
+}
+
+
 /**
  * Check that we receive OSC messages correctly.
  */
@@ -324,6 +391,16 @@ void OSCNodeTest::testReceive() {
   expected_data.SetChannel(8, 127);
   OLA_ASSERT_EQ(expected_data, m_received_data);
 
+  // A bundle updating two slots runs the callback once.
+  const unsigned int callbacks = m_dmx_callbacks;
+  m_udp_socket.SendTo(OSC_INT_BUNDLE_DATA, sizeof(OSC_INT_BUNDLE_DATA),
+                      dest_address);
+  m_ss.Run();
+  OLA_ASSERT_EQ(callbacks + 1, m_dmx_callbacks);
+  expected_data.SetChannel(0, 10);
+  expected_data.SetChannel(1, 140);
+  OLA_ASSERT_EQ(expected_data, m_received_data);
+
   // De-regsiter
   OLA_ASSERT_TRUE(m_osc_node->RegisterAddress(TEST_OSC_ADDRESS, NULL));
   // De-register a second time
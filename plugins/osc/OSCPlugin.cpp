@@ -30,6 +30,7 @@
 #include "ola/StringUtils.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/osc/OSCAddressTemplate.h"
 #include "plugins/osc/OSCDevice.h"
 #include "plugins/osc/OSCPlugin.h"
@@ -247,3 +248,5 @@ void OSCPlugin::SetDataFormat(const string &format_option,
 }  // namespace osc
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::osc::OSCPlugin)
@@ -110,8 +110,8 @@ bool PathportDevice::StartHook() {
   }
 
   m_plugin_adaptor->AddReadDescriptor(m_node->GetSocket());
-  m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
-      ADVERTISTMENT_PERIOD_MS,
+  m_timeout_id = m_plugin_adaptor->RegisterPeriodicTask(
+      ola::TimeInterval(ADVERTISTMENT_PERIOD_MS * ola::ONE_THOUSAND),
       NewCallback(this, &PathportDevice::SendArpReply));
 
   return true;
@@ -125,7 +125,7 @@ void PathportDevice::PrePortStop() {
   m_plugin_adaptor->RemoveReadDescriptor(m_node->GetSocket());
 
   if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
-    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+    m_plugin_adaptor->RemovePeriodicTask(m_timeout_id);
     m_timeout_id = ola::thread::INVALID_TIMEOUT;
   }
 }
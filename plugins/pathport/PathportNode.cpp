@@ -56,7 +56,9 @@ PathportNode::PathportNode(const string &ip_address,
       m_dscp(dscp),
       m_preferred_ip(ip_address),
       m_device_id(device_id),
-      m_sequence_number(1) {
+      m_sequence_number(1),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  sizeof(pathport_packet_s)) {
 }
 
 
@@ -122,18 +124,25 @@ bool PathportNode::Stop() {
  * Called when there is data on this socket
  */
 void PathportNode::SocketReady(UDPSocket *socket) {
-  pathport_packet_s packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
+  unsigned int count = m_recv_ring.Receive(socket);
+  for (unsigned int i = 0; i < count; i++) {
+    HandleDatagram(m_recv_ring.Get(i));
+  }
+}
 
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source))
-    return;
 
+/*
+ * Handle a datagram read from the socket.
+ */
+void PathportNode::HandleDatagram(const ola::network::UDPDatagram &datagram) {
   // skip packets sent by us
-  if (source.Host() == m_interface.ip_address)
+  if (datagram.source.Host() == m_interface.ip_address)
     return;
 
+  pathport_packet_s packet;
+  ssize_t packet_size = datagram.size;
+  memcpy(&packet, datagram.data, datagram.size);
+
   if (packet_size < static_cast<ssize_t>(sizeof(packet.header))) {
     OLA_WARN << "Small pathport packet received, discarding";
     return;
@@ -101,6 +101,7 @@ class PathportNode {
     typedef std::map<uint8_t, universe_handler> universe_handlers;
 
     bool InitNetwork();
+    void HandleDatagram(const ola::network::UDPDatagram &datagram);
     void PopulateHeader(pathport_packet_header *header, uint32_t destination);
     bool ValidateHeader(const pathport_packet_header &header);
     void HandleDmxData(const pathport_pdu_data &packet,
@@ -119,6 +120,7 @@ class PathportNode {
     universe_handlers m_handlers;
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_socket;
+    ola::network::UDPReceiveRing m_recv_ring;
     ola::network::IPV4Address m_config_addr;
     ola::network::IPV4Address m_status_addr;
     ola::network::IPV4Address m_data_addr;
@@ -25,6 +25,7 @@
 #include "ola/math/Random.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/pathport/PathportDevice.h"
 #include "plugins/pathport/PathportPlugin.h"
 #include "plugins/pathport/PathportPluginDescription.h"
@@ -127,3 +128,5 @@ bool PathportPlugin::SetDefaultPreferences() {
 }  // namespace pathport
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::pathport::PathportPlugin)
@@ -24,6 +24,7 @@
 #include "ola/Logging.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/renard/RenardDevice.h"
 #include "plugins/renard/RenardPlugin.h"
 #include "plugins/renard/RenardPluginDescription.h"
@@ -161,3 +162,5 @@ void RenardPlugin::DeleteDevice(RenardDevice *device) {
 }  // namespace renard
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::renard::RenardPlugin)
@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Hakan Lindestaf
  */
 
+#include <string.h>
 #include <algorithm>
 #include <string>
 
@@ -43,10 +44,35 @@ const uint8_t RenardWidget::RENARD_ESCAPE_ESCAPE = 0x31;
 const uint8_t RenardWidget::RENARD_CHANNELS_IN_BANK = 8;
 // Discussions on the Renard firmware recommended a padding each 100 bytes or so
 const uint32_t RenardWidget::RENARD_BYTES_BETWEEN_PADDING = 100;
+// Send every bank at least this often, in case a change was lost.
+const unsigned int RenardWidget::RENARD_FULL_FRAME_INTERVAL = 40;
 
 /*
  * New widget
  */
+RenardWidget::RenardWidget(const string &path,
+                           int dmxOffset,
+                           int channels,
+                           uint32_t baudrate,
+                           uint8_t startAddress)
+    : m_path(path),
+      m_socket(NULL),
+      m_byteCounter(0),
+      m_dmxOffset(dmxOffset),
+      m_channels(channels),
+      m_baudrate(baudrate),
+      m_startAddress(startAddress),
+      m_frames_since_full(RENARD_FULL_FRAME_INTERVAL) {
+  // Worst case, every channel is escaped and each bank has a pad, start byte
+  // and address.
+  unsigned int banks = (m_channels + RENARD_CHANNELS_IN_BANK - 1) /
+                       RENARD_CHANNELS_IN_BANK;
+  m_output.resize(m_channels * 2 + banks * 3);
+}
+
+/*
+ * Cleanup
+ */
 RenardWidget::~RenardWidget() {
   if (m_socket) {
     m_socket->Close();
@@ -138,14 +164,22 @@ bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
 
   OLA_DEBUG << "Sending " << static_cast<int>(channels) << " channels";
 
-  // Max buffer size for worst case scenario (escaping + padding)
-  unsigned int bufferSize = channels * 2 + 10;
-  uint8_t msg[bufferSize];
+  const bool full_frame = m_frames_since_full >= RENARD_FULL_FRAME_INTERVAL;
+  m_frames_since_full = full_frame ? 0 : m_frames_since_full + 1;
 
+  uint8_t *msg = m_output.empty() ? NULL : &m_output[0];
   int dataToSend = 0;
 
   for (unsigned int i = 0; i < channels; i++) {
     if ((i % RENARD_CHANNELS_IN_BANK) == 0) {
+      unsigned int last = std::min(i + RENARD_CHANNELS_IN_BANK, channels);
+      if (!full_frame && !BankChanged(buffer, i, last)) {
+        // Each board forwards packets for the other addresses, so unchanged
+        // banks can be skipped.
+        i = last - 1;
+        continue;
+      }
+
       if (m_byteCounter >= RENARD_BYTES_BETWEEN_PADDING) {
         // Send PAD every 100 (or so) bytes. Note that the counter is per
         // device, so the counter should span multiple calls to SendDMX.
@@ -193,12 +227,34 @@ bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
       static_cast<int>(b);
   }
 
+  m_last_frame.Set(buffer);
+  if (!dataToSend) {
+    return true;
+  }
+
   int bytes_sent = m_socket->Send(msg, dataToSend);
 
   OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
 
   return true;
 }
+
+
+/*
+ * Check if any of the channels in a bank changed since the last frame.
+ * @param buffer the new frame.
+ * @param first the first channel in the bank.
+ * @param last one past the last channel in the bank.
+ */
+bool RenardWidget::BankChanged(const DmxBuffer &buffer, unsigned int first,
+                               unsigned int last) const {
+  if (m_dmxOffset + last > m_last_frame.Size()) {
+    return true;
+  }
+  return memcmp(buffer.GetRaw() + m_dmxOffset + first,
+                m_last_frame.GetRaw() + m_dmxOffset + first,
+                last - first) != 0;
+}
 }  // namespace renard
 }  // namespace plugin
 }  // namespace ola
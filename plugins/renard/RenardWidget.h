@@ -24,6 +24,7 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <string>
+#include <vector>
 
 #include "ola/io/SelectServer.h"
 #include "ola/io/Serial.h"
@@ -50,18 +51,13 @@ class RenardWidget {
     // default in the standard firmware is 0x80, and it may be a reasonable
     // future feature request to have this configurable for more advanced
     // Renard configurations (using wireless transmitters, etc).
+    // Only the banks that changed since the last frame are sent, with a full
+    // frame every RENARD_FULL_FRAME_INTERVAL frames in case one was lost.
     explicit RenardWidget(const std::string &path,
                           int dmxOffset,
                           int channels,
                           uint32_t baudrate,
-                          uint8_t startAddress)
-      : m_path(path),
-        m_socket(NULL),
-        m_byteCounter(0),
-        m_dmxOffset(dmxOffset),
-        m_channels(channels),
-        m_baudrate(baudrate),
-        m_startAddress(startAddress) {}
+                          uint8_t startAddress);
     virtual ~RenardWidget();
 
     // these methods are for communicating with the device
@@ -85,6 +81,12 @@ class RenardWidget {
     uint32_t m_channels;
     uint32_t m_baudrate;
     uint8_t m_startAddress;
+    DmxBuffer m_last_frame;
+    unsigned int m_frames_since_full;
+    std::vector<uint8_t> m_output;
+
+    bool BankChanged(const DmxBuffer &buffer, unsigned int first,
+                     unsigned int last) const;
 
     static const uint8_t RENARD_COMMAND_PAD;
     static const uint8_t RENARD_COMMAND_START_PACKET;
@@ -93,6 +95,7 @@ class RenardWidget {
     static const uint8_t RENARD_ESCAPE_START_PACKET;
     static const uint8_t RENARD_ESCAPE_ESCAPE;
     static const uint32_t RENARD_BYTES_BETWEEN_PADDING;
+    static const unsigned int RENARD_FULL_FRAME_INTERVAL;
 };
 }  // namespace renard
 }  // namespace plugin
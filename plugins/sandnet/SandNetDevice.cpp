@@ -110,8 +110,8 @@ bool SandNetDevice::StartHook() {
   for (iter = sockets.begin(); iter != sockets.end(); ++iter)
     m_plugin_adaptor->AddReadDescriptor(*iter);
 
-  m_timeout_id = m_plugin_adaptor->RegisterRepeatingTimeout(
-      ADVERTISTMENT_PERIOD_MS,
+  m_timeout_id = m_plugin_adaptor->RegisterPeriodicTask(
+      ola::TimeInterval(ADVERTISTMENT_PERIOD_MS * ola::ONE_THOUSAND),
       NewCallback(this, &SandNetDevice::SendAdvertisement));
 
   return true;
@@ -128,7 +128,7 @@ void SandNetDevice::PrePortStop() {
     m_plugin_adaptor->RemoveReadDescriptor(*iter);
 
   if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
-    m_plugin_adaptor->RemoveTimeout(m_timeout_id);
+    m_plugin_adaptor->RemovePeriodicTask(m_timeout_id);
     m_timeout_id = ola::thread::INVALID_TIMEOUT;
   }
 }
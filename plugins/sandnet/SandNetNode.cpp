@@ -59,7 +59,9 @@ const char SandNetNode::DEFAULT_NODE_NAME[] = "ola-SandNet";
 SandNetNode::SandNetNode(const string &ip_address)
     : m_running(false),
       m_node_name(DEFAULT_NODE_NAME),
-      m_preferred_ip(ip_address) {
+      m_preferred_ip(ip_address),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  sizeof(sandnet_packet)) {
   for (unsigned int i = 0; i < SANDNET_MAX_PORTS; i++) {
     m_ports[i].group = 0;
     m_ports[i].universe = i;
@@ -148,18 +150,25 @@ vector<UDPSocket*> SandNetNode::GetSockets() {
  * Called when there is data on this socket
  */
 void SandNetNode::SocketReady(UDPSocket *socket) {
-  sandnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  IPV4SocketAddress source;
+  unsigned int count = m_recv_ring.Receive(socket);
+  for (unsigned int i = 0; i < count; i++) {
+    HandleDatagram(m_recv_ring.Get(i));
+  }
+}
 
-  if (!socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                        &packet_size, &source))
-    return;
 
+/*
+ * Handle a datagram read from one of the sockets.
+ */
+void SandNetNode::HandleDatagram(const ola::network::UDPDatagram &datagram) {
   // skip packets sent by us
-  if (source.Host() == m_interface.ip_address)
+  if (datagram.source.Host() == m_interface.ip_address)
     return;
 
+  sandnet_packet packet;
+  ssize_t packet_size = datagram.size;
+  memcpy(&packet, datagram.data, datagram.size);
+
   if (packet_size < static_cast<ssize_t>(sizeof(packet.opcode))) {
     OLA_WARN << "Small sandnet packet received, discarding";
     return;
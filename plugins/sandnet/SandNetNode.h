@@ -90,6 +90,7 @@ class SandNetNode {
     typedef std::map<group_universe_pair, universe_handler> universe_handlers;
 
     bool InitNetwork();
+    void HandleDatagram(const ola::network::UDPDatagram &datagram);
 
     bool HandleCompressedDMX(const sandnet_compressed_dmx &dmx_packet,
                              unsigned int size);
@@ -110,6 +111,7 @@ class SandNetNode {
     ola::network::Interface m_interface;
     ola::network::UDPSocket m_control_socket;
     ola::network::UDPSocket m_data_socket;
+    ola::network::UDPReceiveRing m_recv_ring;
     ola::dmx::RunLengthEncoder m_encoder;
     ola::network::IPV4SocketAddress m_control_addr;
     ola::network::IPV4SocketAddress m_data_addr;
@@ -20,6 +20,7 @@
 
 #include <string>
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/sandnet/SandNetDevice.h"
 #include "plugins/sandnet/SandNetPlugin.h"
 #include "plugins/sandnet/SandNetPluginDescription.h"
@@ -107,3 +108,4 @@ bool SandNetPlugin::SetDefaultPreferences() {
 }  // namespace plugin
 }  // namespace ola
 
+OLA_PLUGIN_MODULE(ola::plugin::sandnet::SandNetPlugin)
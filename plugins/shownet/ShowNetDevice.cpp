@@ -22,6 +22,7 @@
 #include <string>
 
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/network/NetworkUtils.h"
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
@@ -38,6 +39,9 @@ using std::ostringstream;
 
 const char ShowNetDevice::SHOWNET_DEVICE_NAME[] = "ShowNet";
 const char ShowNetDevice::IP_KEY[] = "ip";
+const char ShowNetDevice::RECEIVE_BUFFER_KEY[] = "receive_buffer_size";
+const char ShowNetDevice::SEND_BUFFER_KEY[] = "send_buffer_size";
+const unsigned int ShowNetDevice::MAX_SOCKET_BUFFER_SIZE = 64 * 1024 * 1024;
 
 
 /*
@@ -58,6 +62,10 @@ ShowNetDevice::ShowNetDevice(ola::Plugin *owner,
 bool ShowNetDevice::StartHook() {
   m_node = new ShowNetNode(m_preferences->GetValue(IP_KEY));
   m_node->SetName(m_preferences->GetValue("name"));
+  m_node->SetBufferSizes(
+      StringToIntOrDefault(m_preferences->GetValue(RECEIVE_BUFFER_KEY), 0),
+      StringToIntOrDefault(m_preferences->GetValue(SEND_BUFFER_KEY), 0));
+  m_node->SetExportMap(m_plugin_adaptor->GetExportMap());
 
   if (!m_node->Start()) {
     delete m_node;
@@ -41,6 +41,9 @@ class ShowNetDevice: public ola::Device {
     std::string DeviceId() const { return "1"; }
 
     static const char IP_KEY[];
+    static const char RECEIVE_BUFFER_KEY[];
+    static const char SEND_BUFFER_KEY[];
+    static const unsigned int MAX_SOCKET_BUFFER_SIZE;
 
  protected:
     bool StartHook();
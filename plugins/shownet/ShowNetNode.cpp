@@ -58,7 +58,12 @@ ShowNetNode::ShowNetNode(const std::string &ip_address)
       m_packet_count(0),
       m_node_name(),
       m_preferred_ip(ip_address),
-      m_socket(NULL) {
+      m_receive_buffer_size(0),
+      m_send_buffer_size(0),
+      m_export_map(NULL),
+      m_socket(NULL),
+      m_recv_ring(ola::network::UDPReceiveRing::DEFAULT_DEPTH,
+                  sizeof(shownet_packet)) {
 }
 
 
@@ -126,6 +131,18 @@ void ShowNetNode::SetName(const string &name) {
 }
 
 
+/*
+ * Set the socket's kernel buffer sizes
+ * @param receive_size the receive buffer size, 0 for the system default.
+ * @param send_size the send buffer size, 0 for the system default.
+ */
+void ShowNetNode::SetBufferSizes(unsigned int receive_size,
+                                 unsigned int send_size) {
+  m_receive_buffer_size = receive_size;
+  m_send_buffer_size = send_size;
+}
+
+
 /*
  * Send some DMX data
  * @param universe the id of the universe to send
@@ -165,10 +182,13 @@ bool ShowNetNode::SendDMX(unsigned int universe,
  * @param universe the universe to register the handler for
  * @param handler the Callback0 to call when there is data for this universe.
  * Ownership of the closure is transferred to the node.
+ * @param arrival if not NULL, this is set to the time the kernel received the
+ *   data.
  */
 bool ShowNetNode::SetHandler(unsigned int universe,
                              DmxBuffer *buffer,
-                             Callback0<void> *closure) {
+                             Callback0<void> *closure,
+                             TimeStamp *arrival) {
   if (!closure)
     return false;
 
@@ -179,10 +199,12 @@ bool ShowNetNode::SetHandler(unsigned int universe,
     universe_handler handler;
     handler.buffer = buffer;
     handler.closure = closure;
+    handler.arrival = arrival;
     m_handlers[universe] = handler;
   } else {
     Callback0<void> *old_closure = iter->second.closure;
     iter->second.closure = closure;
+    iter->second.arrival = arrival;
     delete old_closure;
   }
   return true;
@@ -212,17 +234,18 @@ bool ShowNetNode::RemoveHandler(unsigned int universe) {
  * Called when there is data on this socket
  */
 void ShowNetNode::SocketReady() {
-  shownet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size, &source))
-    return;
-
-  // skip packets sent by us
-  if (source.Host() != m_interface.ip_address)
-    HandlePacket(&packet, packet_size);
+  unsigned int count = m_recv_ring.Receive(m_socket);
+  for (unsigned int i = 0; i < count; i++) {
+    const ola::network::UDPDatagram &datagram = m_recv_ring.Get(i);
+    // skip packets sent by us
+    if (datagram.source.Host() == m_interface.ip_address)
+      continue;
+
+    shownet_packet packet;
+    memcpy(&packet, datagram.data, datagram.size);
+    m_packet_arrival = datagram.arrival;
+    HandlePacket(&packet, datagram.size);
+  }
 }
 
 
@@ -303,6 +326,9 @@ bool ShowNetNode::HandleCompressedPacket(const shownet_compressed_dmx *packet,
                               packet->data + data_offset,
                               enc_len);
   }
+  if (handler->arrival) {
+    *handler->arrival = m_packet_arrival;
+  }
   handler->closure->Run();
   return true;
 }
@@ -325,9 +351,14 @@ unsigned int ShowNetNode::BuildCompressedPacket(shownet_packet *packet,
   compressed_dmx->slotSize[0] = HostToLittleEndian(
       static_cast<uint16_t>(buffer.Size()));
 
-  unsigned int enc_len = sizeof(packet->data);
-  if (!m_encoder.Encode(buffer, compressed_dmx->data, &enc_len))
-    OLA_WARN << "Failed to encode all data (used " << enc_len << " bytes";
+  // A slot with an encoded length equal to the slot size is raw data, so
+  // only use RLE if it makes the data smaller.
+  unsigned int enc_len = ola::dmx::RunLengthEncoder::MaxUsefulSize(
+      buffer.Size());
+  if (!m_encoder.Encode(buffer, compressed_dmx->data, &enc_len)) {
+    enc_len = buffer.Size();
+    buffer.Get(compressed_dmx->data, &enc_len);
+  }
 
   compressed_dmx->indexBlock[0] = HostToLittleEndian(
       static_cast<uint16_t>(MAGIC_INDEX_OFFSET));
@@ -367,6 +398,17 @@ bool ShowNetNode::InitNetwork() {
     return false;
   }
 
+  if (m_receive_buffer_size) {
+    m_socket->SetReceiveBufferSize(m_receive_buffer_size);
+  }
+  if (m_send_buffer_size) {
+    m_socket->SetSendBufferSize(m_send_buffer_size);
+  }
+  m_socket->EnableDropCounting();
+  m_socket->EnableReceiveTimestamps();
+  m_recv_ring.ExportDrops(m_export_map,
+                          "shownet:" + m_interface.ip_address.ToString());
+
   m_socket->SetOnData(NewCallback(this, &ShowNetNode::SocketReady));
   return true;
 }
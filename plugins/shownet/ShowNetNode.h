@@ -24,6 +24,7 @@
 #include <string>
 #include <map>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/dmx/RunLengthEncoder.h"
@@ -43,11 +44,20 @@ class ShowNetNode {
     bool Start();
     bool Stop();
     void SetName(const std::string &name);
+    // The kernel buffer sizes for the socket, 0 leaves the system default.
+    // This must be called before Start().
+    void SetBufferSizes(unsigned int receive_size, unsigned int send_size);
+    // Export the datagrams the kernel dropped, this must be called before
+    // Start().
+    void SetExportMap(ola::ExportMap *export_map) {
+      m_export_map = export_map;
+    }
 
     bool SendDMX(unsigned int universe, const ola::DmxBuffer &buffer);
     bool SetHandler(unsigned int universe,
                     DmxBuffer *buffer,
-                    ola::Callback0<void> *handler);
+                    ola::Callback0<void> *handler,
+                    TimeStamp *arrival = NULL);
     bool RemoveHandler(unsigned int universe);
 
     const ola::network::Interface &GetInterface() const {
@@ -65,16 +75,23 @@ class ShowNetNode {
     typedef struct {
       DmxBuffer *buffer;
       Callback0<void> *closure;
+      TimeStamp *arrival;
     } universe_handler;
 
     bool m_running;
     uint16_t m_packet_count;
     std::string m_node_name;
     std::string m_preferred_ip;
+    unsigned int m_receive_buffer_size;
+    unsigned int m_send_buffer_size;
+    ola::ExportMap *m_export_map;
     std::map<unsigned int, universe_handler> m_handlers;
     ola::network::Interface m_interface;
     ola::dmx::RunLengthEncoder m_encoder;
     ola::network::UDPSocket *m_socket;
+    ola::network::UDPReceiveRing m_recv_ring;
+    // The kernel's arrival time for the packet being handled.
+    TimeStamp m_packet_arrival;
 
     bool HandlePacket(const shownet_packet *packet, unsigned int size);
     bool HandleCompressedPacket(const shownet_compressed_dmx *packet,
@@ -73,6 +73,7 @@ class ShowNetNodeTest: public CppUnit::TestFixture {
 
     static const uint8_t EXPECTED_PACKET[];
     static const uint8_t EXPECTED_PACKET2[];
+    static const uint8_t EXPECTED_PACKET3[];
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ShowNetNodeTest);
@@ -82,10 +83,10 @@ const uint8_t ShowNetNodeTest::EXPECTED_PACKET[] = {
   0x80, 0x8f, 0, 0, 0, 0,
   1, 0, 0, 0, 0, 0, 0, 0,  // net slots
   3, 0, 0, 0, 0, 0, 0, 0,  // slot sizes
-  11, 0, 15, 0, 0, 0, 0, 0, 0, 0,  // index blocks
+  11, 0, 14, 0, 0, 0, 0, 0, 0, 0,  // index blocks
   0, 0, 0, 0, 0, 0,
   'f', 'o', 'o', 'b', 'a', 'r', 'b', 'a', 'z',
-  3, 'a', 'b', 'c',
+  'a', 'b', 'c',
 };
 
 // Start slot 513
@@ -93,10 +94,21 @@ const uint8_t ShowNetNodeTest::EXPECTED_PACKET2[] = {
   0x80, 0x8f, 0, 0, 0, 0,
   1, 2, 0, 0, 0, 0, 0, 0,  // net slots
   3, 0, 0, 0, 0, 0, 0, 0,  // slot sizes
-  11, 0, 15, 0, 0, 0, 0, 0, 0, 0,  // index blocks
+  11, 0, 14, 0, 0, 0, 0, 0, 0, 0,  // index blocks
   0, 0, 0, 0, 0, 0,
   'f', 'o', 'o', 'b', 'a', 'r', 'b', 'a', 'z',
-  3, 'a', 'b', 'c',
+  'a', 'b', 'c',
+};
+
+// RLE data, start slot 1
+const uint8_t ShowNetNodeTest::EXPECTED_PACKET3[] = {
+  0x80, 0x8f, 0, 0, 0, 0,
+  1, 0, 0, 0, 0, 0, 0, 0,  // net slots
+  12, 0, 0, 0, 0, 0, 0, 0,  // slot sizes
+  11, 0, 16, 0, 0, 0, 0, 0, 0, 0,  // index blocks
+  0, 0, 0, 0, 0, 0,
+  'f', 'o', 'o', 'b', 'a', 'r', 'b', 'a', 'z',
+  0x8a, 1, 2, 2, 3,
 };
 
 void ShowNetNodeTest::setUp() {
@@ -255,6 +267,13 @@ void ShowNetNodeTest::testPopulatePacket() {
   size = m_node->BuildCompressedPacket(&packet, universe, buffer);
   OLA_ASSERT_DATA_EQUALS(EXPECTED_PACKET2, sizeof(EXPECTED_PACKET2),
                          reinterpret_cast<const uint8_t*>(&packet), size);
+
+  // data which compresses is sent RLE'ed
+  universe = 0;
+  buffer.SetFromString("1,1,1,1,1,1,1,1,1,1,2,3");
+  size = m_node->BuildCompressedPacket(&packet, universe, buffer);
+  OLA_ASSERT_DATA_EQUALS(EXPECTED_PACKET3, sizeof(EXPECTED_PACKET3),
+                         reinterpret_cast<const uint8_t*>(&packet), size);
 }
 
 
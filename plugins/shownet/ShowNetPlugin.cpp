@@ -21,6 +21,7 @@
 #include <string>
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/shownet/ShowNetDevice.h"
 #include "plugins/shownet/ShowNetPlugin.h"
 #include "plugins/shownet/ShowNetPluginDescription.h"
@@ -91,6 +92,14 @@ bool ShowNetPlugin::SetDefaultPreferences() {
                                          StringValidator(true), "");
   save |= m_preferences->SetDefaultValue(SHOWNET_NAME_KEY, StringValidator(),
                                          SHOWNET_NODE_NAME);
+  save |= m_preferences->SetDefaultValue(
+      ShowNetDevice::RECEIVE_BUFFER_KEY,
+      UIntValidator(0, ShowNetDevice::MAX_SOCKET_BUFFER_SIZE),
+      0);
+  save |= m_preferences->SetDefaultValue(
+      ShowNetDevice::SEND_BUFFER_KEY,
+      UIntValidator(0, ShowNetDevice::MAX_SOCKET_BUFFER_SIZE),
+      0);
 
   if (save) {
     m_preferences->Save();
@@ -104,3 +113,5 @@ bool ShowNetPlugin::SetDefaultPreferences() {
 }  // namespace shownet
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::shownet::ShowNetPlugin)
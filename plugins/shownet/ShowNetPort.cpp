@@ -68,7 +68,8 @@ void ShowNetInputPort::PostSetUniverse(Universe *old_universe,
         PortId(),
         &m_buffer,
         ola::NewCallback<ShowNetInputPort, void>(this,
-                                                &ShowNetInputPort::DmxChanged));
+                                                &ShowNetInputPort::DmxChanged),
+        &m_arrival);
 }
 
 
@@ -42,11 +42,13 @@ class ShowNetInputPort: public BasicInputPort {
 
   std::string Description() const;
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
+  TimeStamp ArrivalTime() const { return m_arrival; }
   bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
   void PostSetUniverse(Universe *old_universe, Universe *new_universe);
 
  private:
   DmxBuffer m_buffer;
+  TimeStamp m_arrival;
   ShowNetNode *m_node;
 };
 
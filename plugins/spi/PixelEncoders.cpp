@@ -0,0 +1,339 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoders.cpp
+ * Convert RGB data to the formats used by the SPI pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Like the merge kernels in common/dmx, the x86 versions use function level
+ * target attributes and are only picked once the CPU has been probed. The
+ * x86 encoders need pshufb to reorder the bytes, so they start at SSSE3
+ * rather than SSE2. On ARM, vld3q_u8 splits the RGB data into separate
+ * vectors which makes the conversion trivial.
+ */
+
+#include "plugins/spi/PixelEncoders.h"
+
+#include <string.h>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || \
+     (defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define OLA_PIXEL_X86 1
+#include <immintrin.h>
+#endif  // x86 & compiler supports target attributes
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__GNUC__)
+#define OLA_PIXEL_NEON 1
+#include <arm_neon.h>
+#endif  // __ARM_NEON
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+using std::vector;
+
+namespace {
+
+void ScalarLPD8806(const uint8_t *rgb, uint8_t *output,
+                   unsigned int pixel_count) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = static_cast<uint8_t>(0x80 | (rgb[1] >> 1));
+    output[1] = static_cast<uint8_t>(0x80 | (rgb[0] >> 1));
+    output[2] = static_cast<uint8_t>(0x80 | (rgb[2] >> 1));
+    rgb += 3;
+    output += 3;
+  }
+}
+
+void ScalarP9813(const uint8_t *rgb, uint8_t *output,
+                 unsigned int pixel_count) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = P9813Flag(rgb[0], rgb[1], rgb[2]);
+    output[1] = rgb[2];
+    output[2] = rgb[1];
+    output[3] = rgb[0];
+    rgb += 3;
+    output += 4;
+  }
+}
+
+void ScalarAPA102(const uint8_t *rgb, uint8_t *output,
+                  unsigned int pixel_count) {
+  for (unsigned int i = 0; i < pixel_count; i++) {
+    output[0] = 0xff;
+    output[1] = rgb[2];
+    output[2] = rgb[1];
+    output[3] = rgb[0];
+    rgb += 3;
+    output += 4;
+  }
+}
+
+#ifdef OLA_PIXEL_X86
+/*
+ * The vector versions load 16 bytes at a time, but only use 12 or 15 of
+ * them, so they stop while there's enough data left for a full load and
+ * leave the rest to the scalar code.
+ */
+__attribute__((target("ssse3")))
+void SSSE3LPD8806(const uint8_t *rgb, uint8_t *output,
+                  unsigned int pixel_count) {
+  // 5 pixels per iteration, the last byte is overwritten by the next one.
+  const __m128i order = _mm_setr_epi8(1, 0, 2, 4, 3, 5, 7, 6, 8, 10, 9, 11,
+                                      13, 12, 14, 15);
+  const __m128i high_bit = _mm_set1_epi8(static_cast<char>(0x80));
+  unsigned int i = 0;
+  for (; i + 6 <= pixel_count; i += 5) {
+    __m128i pixels = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i)),
+        order);
+    // The bit shifted in from the neighbouring byte is replaced by the high
+    // bit.
+    pixels = _mm_or_si128(_mm_srli_epi16(pixels, 1), high_bit);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 3 * i), pixels);
+  }
+  ScalarLPD8806(rgb + 3 * i, output + 3 * i, pixel_count - i);
+}
+
+/*
+ * This moves RGB into the top three bytes of each 32 bit lane, in BGR
+ * order, leaving the first byte of each pixel 0.
+ */
+#define OLA_PIXEL_BGR_ORDER \
+    -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9
+
+__attribute__((target("ssse3")))
+void SSSE3P9813(const uint8_t *rgb, uint8_t *output,
+                unsigned int pixel_count) {
+  const __m128i order = _mm_setr_epi8(OLA_PIXEL_BGR_ORDER);
+  const __m128i low_byte = _mm_set1_epi32(0xff);
+  unsigned int i = 0;
+  for (; i + 6 <= pixel_count; i += 4) {
+    const __m128i pixels = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i)),
+        order);
+    // Pick the top two bits of each colour from the 32 bit lanes.
+    __m128i flag = _mm_srli_epi32(pixels, 30);
+    flag = _mm_or_si128(
+        flag, _mm_and_si128(_mm_srli_epi32(pixels, 20), _mm_set1_epi32(0x0c)));
+    flag = _mm_or_si128(
+        flag, _mm_and_si128(_mm_srli_epi32(pixels, 10), _mm_set1_epi32(0x30)));
+    flag = _mm_xor_si128(flag, low_byte);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4 * i),
+                     _mm_or_si128(pixels, flag));
+  }
+  ScalarP9813(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3APA102(const uint8_t *rgb, uint8_t *output,
+                 unsigned int pixel_count) {
+  const __m128i order = _mm_setr_epi8(OLA_PIXEL_BGR_ORDER);
+  const __m128i low_byte = _mm_set1_epi32(0xff);
+  unsigned int i = 0;
+  for (; i + 6 <= pixel_count; i += 4) {
+    const __m128i pixels = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 3 * i)),
+        order);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4 * i),
+                     _mm_or_si128(pixels, low_byte));
+  }
+  ScalarAPA102(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+
+/*
+ * The AVX2 shuffle doesn't cross 128 bit lanes, so each lane is loaded with
+ * 4 pixels separately.
+ */
+__attribute__((target("avx2")))
+inline __m256i AVX2LoadBGR(const uint8_t *rgb, const __m256i &order) {
+  const __m256i pixels = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 12)), 1);
+  return _mm256_shuffle_epi8(pixels, order);
+}
+
+__attribute__((target("avx2")))
+void AVX2P9813(const uint8_t *rgb, uint8_t *output,
+               unsigned int pixel_count) {
+  const __m256i order = _mm256_setr_epi8(OLA_PIXEL_BGR_ORDER,
+                                         OLA_PIXEL_BGR_ORDER);
+  const __m256i low_byte = _mm256_set1_epi32(0xff);
+  unsigned int i = 0;
+  for (; i + 10 <= pixel_count; i += 8) {
+    const __m256i pixels = AVX2LoadBGR(rgb + 3 * i, order);
+    __m256i flag = _mm256_srli_epi32(pixels, 30);
+    flag = _mm256_or_si256(
+        flag,
+        _mm256_and_si256(_mm256_srli_epi32(pixels, 20),
+                         _mm256_set1_epi32(0x0c)));
+    flag = _mm256_or_si256(
+        flag,
+        _mm256_and_si256(_mm256_srli_epi32(pixels, 10),
+                         _mm256_set1_epi32(0x30)));
+    flag = _mm256_xor_si256(flag, low_byte);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 4 * i),
+                        _mm256_or_si256(pixels, flag));
+  }
+  SSSE3P9813(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+
+__attribute__((target("avx2")))
+void AVX2APA102(const uint8_t *rgb, uint8_t *output,
+                unsigned int pixel_count) {
+  const __m256i order = _mm256_setr_epi8(OLA_PIXEL_BGR_ORDER,
+                                         OLA_PIXEL_BGR_ORDER);
+  const __m256i low_byte = _mm256_set1_epi32(0xff);
+  unsigned int i = 0;
+  for (; i + 10 <= pixel_count; i += 8) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(output + 4 * i),
+        _mm256_or_si256(AVX2LoadBGR(rgb + 3 * i, order), low_byte));
+  }
+  SSSE3APA102(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+
+#undef OLA_PIXEL_BGR_ORDER
+#endif  // OLA_PIXEL_X86
+
+#ifdef OLA_PIXEL_NEON
+void NEONLPD8806(const uint8_t *rgb, uint8_t *output,
+                 unsigned int pixel_count) {
+  const uint8x16_t high_bit = vdupq_n_u8(0x80);
+  unsigned int i = 0;
+  for (; i + 16 <= pixel_count; i += 16) {
+    const uint8x16x3_t pixels = vld3q_u8(rgb + 3 * i);
+    uint8x16x3_t encoded;
+    encoded.val[0] = vorrq_u8(vshrq_n_u8(pixels.val[1], 1), high_bit);
+    encoded.val[1] = vorrq_u8(vshrq_n_u8(pixels.val[0], 1), high_bit);
+    encoded.val[2] = vorrq_u8(vshrq_n_u8(pixels.val[2], 1), high_bit);
+    vst3q_u8(output + 3 * i, encoded);
+  }
+  ScalarLPD8806(rgb + 3 * i, output + 3 * i, pixel_count - i);
+}
+
+void NEONP9813(const uint8_t *rgb, uint8_t *output,
+               unsigned int pixel_count) {
+  unsigned int i = 0;
+  for (; i + 16 <= pixel_count; i += 16) {
+    const uint8x16x3_t pixels = vld3q_u8(rgb + 3 * i);
+    uint8x16_t flag = vshrq_n_u8(pixels.val[0], 6);
+    flag = vorrq_u8(flag, vshlq_n_u8(vshrq_n_u8(pixels.val[1], 6), 2));
+    flag = vorrq_u8(flag, vshlq_n_u8(vshrq_n_u8(pixels.val[2], 6), 4));
+    uint8x16x4_t encoded;
+    encoded.val[0] = vmvnq_u8(flag);
+    encoded.val[1] = pixels.val[2];
+    encoded.val[2] = pixels.val[1];
+    encoded.val[3] = pixels.val[0];
+    vst4q_u8(output + 4 * i, encoded);
+  }
+  ScalarP9813(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+
+void NEONAPA102(const uint8_t *rgb, uint8_t *output,
+                unsigned int pixel_count) {
+  unsigned int i = 0;
+  for (; i + 16 <= pixel_count; i += 16) {
+    const uint8x16x3_t pixels = vld3q_u8(rgb + 3 * i);
+    uint8x16x4_t encoded;
+    encoded.val[0] = vdupq_n_u8(0xff);
+    encoded.val[1] = pixels.val[2];
+    encoded.val[2] = pixels.val[1];
+    encoded.val[3] = pixels.val[0];
+    vst4q_u8(output + 4 * i, encoded);
+  }
+  ScalarAPA102(rgb + 3 * i, output + 4 * i, pixel_count - i);
+}
+#endif  // OLA_PIXEL_NEON
+
+const PixelEncoder kScalarEncoder = {
+  "scalar", ScalarLPD8806, ScalarP9813, ScalarAPA102
+};
+
+#ifdef OLA_PIXEL_X86
+const PixelEncoder kSSSE3Encoder = {
+  "ssse3", SSSE3LPD8806, SSSE3P9813, SSSE3APA102
+};
+// The 15 byte LPD8806 pixels don't split nicely across the AVX2 lanes.
+const PixelEncoder kAVX2Encoder = {
+  "avx2", SSSE3LPD8806, AVX2P9813, AVX2APA102
+};
+#endif  // OLA_PIXEL_X86
+
+#ifdef OLA_PIXEL_NEON
+const PixelEncoder kNEONEncoder = {
+  "neon", NEONLPD8806, NEONP9813, NEONAPA102
+};
+#endif  // OLA_PIXEL_NEON
+
+const PixelEncoder *DetectBestEncoder() {
+  vector<const PixelEncoder*> encoders;
+  SupportedPixelEncoders(&encoders);
+  return encoders.back();
+}
+}  // namespace
+
+
+const PixelEncoder &ScalarPixelEncoder() {
+  return kScalarEncoder;
+}
+
+
+const PixelEncoder &BestPixelEncoder() {
+  static const PixelEncoder *best_encoder = DetectBestEncoder();
+  return *best_encoder;
+}
+
+
+void SupportedPixelEncoders(vector<const PixelEncoder*> *encoders) {
+  encoders->clear();
+  encoders->push_back(&kScalarEncoder);
+
+#ifdef OLA_PIXEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3")) {
+    encoders->push_back(&kSSSE3Encoder);
+    // The AVX2 encoder falls back to the SSSE3 code for the tail.
+    if (__builtin_cpu_supports("avx2")) {
+      encoders->push_back(&kAVX2Encoder);
+    }
+  }
+#endif  // OLA_PIXEL_X86
+
+#ifdef OLA_PIXEL_NEON
+  encoders->push_back(&kNEONEncoder);
+#endif  // OLA_PIXEL_NEON
+}
+
+
+void RepeatPattern(uint8_t *output, unsigned int pattern_size,
+                   unsigned int count) {
+  const unsigned int total = pattern_size * count;
+  unsigned int filled = pattern_size;
+  while (filled && filled < total) {
+    const unsigned int length = filled < total - filled ?
+        filled : total - filled;
+    memcpy(output + filled, output, length);
+    filled += length;
+  }
+}
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoders.h
+ * Convert RGB data to the formats used by the SPI pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_PIXELENCODERS_H_
+#define PLUGINS_SPI_PIXELENCODERS_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * @brief A set of functions that convert RGB pixels to the SPI formats.
+ *
+ * Each function reads pixel_count * 3 bytes of RGB data and writes the
+ * encoded pixels to output. The WS2801 takes RGB as-is, so it doesn't need
+ * an encoder.
+ */
+struct PixelEncoder {
+  /**
+   * @brief The name of the encoder, e.g. "ssse3".
+   */
+  const char *name;
+
+  /**
+   * @brief Encode LPD8806 pixels, 3 bytes per pixel: 0x80 | G >> 1,
+   *   0x80 | R >> 1, 0x80 | B >> 1.
+   */
+  void (*lpd8806)(const uint8_t *rgb, uint8_t *output,
+                  unsigned int pixel_count);
+
+  /**
+   * @brief Encode P9813 pixels, 4 bytes per pixel: flag, B, G, R.
+   */
+  void (*p9813)(const uint8_t *rgb, uint8_t *output,
+                unsigned int pixel_count);
+
+  /**
+   * @brief Encode APA102 pixels, 4 bytes per pixel: 0xff, B, G, R.
+   */
+  void (*apa102)(const uint8_t *rgb, uint8_t *output,
+                 unsigned int pixel_count);
+};
+
+/**
+ * @brief Return the portable, pixel-at-a-time encoder.
+ */
+const PixelEncoder &ScalarPixelEncoder();
+
+/**
+ * @brief Return the fastest encoder supported by the CPU we're running on.
+ *
+ * The CPU is probed on the first call, the result is cached.
+ */
+const PixelEncoder &BestPixelEncoder();
+
+/**
+ * @brief Get all the encoders that can run on this CPU.
+ * @param[out] encoders the list of encoders, the scalar encoder is always
+ *   first.
+ */
+void SupportedPixelEncoders(std::vector<const PixelEncoder*> *encoders);
+
+/**
+ * @brief Calculate the flag byte for a P9813 pixel.
+ *
+ * For more information please visit:
+ * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
+ */
+inline uint8_t P9813Flag(uint8_t red, uint8_t green, uint8_t blue) {
+  uint8_t flag = (red & 0xc0) >> 6;
+  flag |= (green & 0xc0) >> 4;
+  flag |= (blue & 0xc0) >> 2;
+  return static_cast<uint8_t>(~flag);
+}
+
+/**
+ * @brief Repeat a pattern to fill a buffer.
+ * @param output the buffer, the first pattern_size bytes hold the pattern.
+ * @param pattern_size the size of the pattern.
+ * @param count the number of times the pattern should appear in output,
+ *   including the first one.
+ *
+ * This is used by the combined personalities. Rather than copying the
+ * pattern once per pixel, the filled part of the buffer is doubled each
+ * time.
+ */
+void RepeatPattern(uint8_t *output, unsigned int pattern_size,
+                   unsigned int count);
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_PIXELENCODERS_H_
@@ -26,6 +26,7 @@
 #include <string.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -41,12 +42,123 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+using ola::thread::ConditionVariable;
+using ola::thread::Mutex;
 using ola::thread::MutexLocker;
 using std::string;
 using std::vector;
 
 const char SPIBackendInterface::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendInterface::SPI_DROP_VAR_KEY[] = "device";
+const char SPIBackendInterface::SPI_LATENCY_VAR[] = "spi-latency-us";
+
+namespace {
+
+TimeInterval FrameInterval(uint16_t refresh_rate) {
+  if (!refresh_rate) {
+    return TimeInterval(0, 0);
+  }
+  return TimeInterval(static_cast<int64_t>(USEC_IN_SECONDS / refresh_rate));
+}
+
+/*
+ * Block until it's time for the next write. This must be called with the
+ * mutex held, it returns early if exit becomes true.
+ */
+void WaitForFrameSlot(const Clock &clock,
+                      const TimeStamp &next_write,
+                      Mutex *mutex,
+                      ConditionVariable *cond_var,
+                      const bool *exit) {
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  while (!*exit && now < next_write) {
+    cond_var->TimedWait(mutex, next_write);
+    clock.CurrentTime(&now);
+  }
+}
+
+/*
+ * Wake the write thread after a frame has been published.
+ *
+ * The write thread checks for new frames with the mutex held before it
+ * waits, so once we've held the mutex it's either going to see the new frame
+ * or it's waiting on the condition variable. Nothing is done while holding
+ * the lock, so this only blocks if the write thread is between the check and
+ * the wait.
+ */
+void WakeWriteThread(Mutex *mutex, ConditionVariable *cond_var) {
+  {
+    MutexLocker lock(mutex);
+  }
+  cond_var->Signal();
+}
+
+/*
+ * Record the time between the Commit() and the end of the write.
+ */
+void UpdateLatency(const Clock &clock, const TimeStamp &commit_time,
+                   const string &device, UIntMap *latency_map) {
+  if (!latency_map) {
+    return;
+  }
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  (*latency_map)[device] = static_cast<unsigned int>(
+      (now - commit_time).AsInt());
+}
+}  // namespace
+
+FrameBarrier::FrameBarrier(const TimeInterval &timeout)
+    : m_timeout(timeout),
+      m_participants(0),
+      m_waiting(0),
+      m_generation(0) {
+}
+
+void FrameBarrier::AddParticipant() {
+  MutexLocker lock(&m_mutex);
+  m_participants++;
+}
+
+void FrameBarrier::RemoveParticipant() {
+  MutexLocker lock(&m_mutex);
+  if (m_participants) {
+    m_participants--;
+  }
+  // This may be the participant's own thread, so release everyone rather
+  // than only when the rest have arrived.
+  if (m_waiting) {
+    Release();
+  }
+}
+
+bool FrameBarrier::Wait() {
+  MutexLocker lock(&m_mutex);
+  const unsigned int generation = m_generation;
+  if (++m_waiting >= m_participants) {
+    Release();
+    return true;
+  }
+
+  TimeStamp deadline;
+  m_clock.CurrentTime(&deadline);
+  deadline += m_timeout;
+  while (generation == m_generation) {
+    if (!m_cond_var.TimedWait(&m_mutex, deadline) &&
+        generation == m_generation) {
+      m_waiting--;
+      return false;
+    }
+  }
+  return true;
+}
+
+void FrameBarrier::Release() {
+  m_waiting = 0;
+  m_generation++;
+  m_cond_var.Broadcast();
+}
 
 uint8_t *HardwareBackend::OutputData::Resize(unsigned int length) {
   if (length < m_size) {
@@ -82,10 +194,10 @@ void HardwareBackend::OutputData::SetLatchBytes(unsigned int latch_bytes) {
 HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
     const HardwareBackend::OutputData &other) {
   if (this != &other) {
-    uint8_t *data = Resize(other.m_size + other.m_latch_bytes);
+    uint8_t *data = Resize(other.m_size);
     if (data) {
       memcpy(data, other.m_data, other.m_size);
-      memset(data + other.m_size, 0, other.m_latch_bytes);
+      m_latch_bytes = other.m_latch_bytes;
       m_write_pending = true;
     } else {
       m_write_pending = false;
@@ -97,16 +209,26 @@ HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
 HardwareBackend::HardwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
-    : m_spi_writer(writer),
+    : ola::thread::Thread(ola::thread::Thread::Options("spi-output")),
+      m_spi_writer(writer),
       m_drop_map(NULL),
+      m_latency_map(NULL),
       m_output_count(1 << options.gpio_pins.size()),
+      m_frame_interval(FrameInterval(options.refresh_rate)),
+      m_barrier(options.barrier),
       m_exit(false),
       m_gpio_pins(options.gpio_pins) {
-  SetupOutputs(&m_output_data);
+  for (unsigned int i = 0; i < m_output_count; i++) {
+    m_output_data.push_back(new OutputData());
+    m_pending_data.push_back(new OutputMailbox());
+  }
   if (export_map) {
     m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
                                            SPI_DROP_VAR_KEY);
     (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_latency_map = export_map->GetUIntMapVar(SPI_LATENCY_VAR,
+                                              SPI_DROP_VAR_KEY);
+    (*m_latency_map)[m_spi_writer->DevicePath()] = 0;
   }
 }
 
@@ -118,9 +240,13 @@ HardwareBackend::~HardwareBackend() {
   }
 
   m_cond_var.Signal();
+  if (m_barrier && IsRunning()) {
+    m_barrier->RemoveParticipant();
+  }
   Join();
 
   STLDeleteElements(&m_output_data);
+  STLDeleteElements(&m_pending_data);
   CloseGPIOFDs();
 }
 
@@ -129,7 +255,13 @@ bool HardwareBackend::Init() {
     return false;
   }
 
+  if (m_barrier) {
+    m_barrier->AddParticipant();
+  }
   if (!Start()) {
+    if (m_barrier) {
+      m_barrier->RemoveParticipant();
+    }
     CloseGPIOFDs();
     return false;
   }
@@ -143,14 +275,9 @@ uint8_t *HardwareBackend::Checkout(uint8_t output_id,
     return NULL;
   }
 
-  m_mutex.Lock();
+  // The write thread never touches m_output_data, so no lock is needed.
   uint8_t *output = m_output_data[output_id]->Resize(length);
-  if (!output) {
-    m_mutex.Unlock();
-  }
   m_output_data[output_id]->SetLatchBytes(latch_bytes);
-  // We return with the Mutex locked, the caller must then call Commit()
-  // coverity[LOCK]
   return output;
 }
 
@@ -159,72 +286,75 @@ void HardwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  OutputData *output_data = m_output_data[output];
-  if (output_data->IsPending() && m_drop_map) {
-    // There was already another write pending which we're now stomping on
+  OutputMailbox *mailbox = m_pending_data[output];
+  OutputData *pending = mailbox->WriteSlot();
+  *pending = *m_output_data[output];
+  if (!pending->IsPending()) {
+    return;
+  }
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  pending->SetCommitTime(now);
+
+  if (mailbox->Publish() && m_drop_map) {
+    // There was already another write pending which we've now replaced
     (*m_drop_map)[m_spi_writer->DevicePath()]++;
   }
-  output_data->SetPending();
-  m_mutex.Unlock();
-  m_cond_var.Signal();
+  WakeWriteThread(&m_mutex, &m_cond_var);
 }
 
 void *HardwareBackend::Run() {
-  Outputs outputs;
-  SetupOutputs(&outputs);
+  TimeStamp next_write;
 
   while (true) {
     m_mutex.Lock();
 
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
+    while (!m_exit && !WritePending()) {
+      m_cond_var.Wait(&m_mutex);
     }
 
-    bool action_pending = false;
-    Outputs::const_iterator iter = m_output_data.begin();
-    for (; iter != m_output_data.end(); ++iter) {
-      if ((*iter)->IsPending()) {
-        action_pending = true;
-        break;
-      }
-    }
-    if (!action_pending) {
-      m_cond_var.Wait(&m_mutex);
+    if (!m_frame_interval.IsZero()) {
+      WaitForFrameSlot(m_clock, next_write, &m_mutex, &m_cond_var, &m_exit);
     }
 
     if (m_exit) {
       m_mutex.Unlock();
-      STLDeleteElements(&outputs);
       return NULL;
     }
+    m_mutex.Unlock();
 
-    for (unsigned int i = 0; i < m_output_data.size(); i++) {
-      if (m_output_data[i]->IsPending()) {
-        // take a copy
-        *outputs[i] = *m_output_data[i];
-        m_output_data[i]->ResetPending();
-      }
+    if (m_barrier) {
+      m_barrier->Wait();
+    }
+
+    if (!m_frame_interval.IsZero()) {
+      m_clock.CurrentTime(&next_write);
+      next_write += m_frame_interval;
     }
-    m_mutex.Unlock();
 
-    for (unsigned int i = 0; i < outputs.size(); i++) {
-      if (outputs[i]->IsPending()) {
-        WriteOutput(i, outputs[i]);
-        outputs[i]->ResetPending();
+    for (unsigned int i = 0; i < m_pending_data.size(); i++) {
+      if (m_pending_data[i]->Fetch()) {
+        const OutputData *output = m_pending_data[i]->ReadSlot();
+        WriteOutput(i, output);
+        UpdateLatency(m_clock, output->CommitTime(),
+                      m_spi_writer->DevicePath(), m_latency_map);
       }
     }
   }
 }
 
-void HardwareBackend::SetupOutputs(Outputs *outputs) {
-  for (unsigned int i = 0; i < m_output_count; i++) {
-    outputs->push_back(new OutputData());
+bool HardwareBackend::WritePending() const {
+  vector<OutputMailbox*>::const_iterator iter = m_pending_data.begin();
+  for (; iter != m_pending_data.end(); ++iter) {
+    if ((*iter)->HasNewValue()) {
+      return true;
+    }
   }
+  return false;
 }
 
-void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
+void HardwareBackend::WriteOutput(uint8_t output_id,
+                                  const OutputData *output) {
   const string on("1");
   const string off("0");
 
@@ -247,7 +377,16 @@ void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
     }
   }
 
-  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+  // The outputs share the bus behind the de-multiplexer so each is its own
+  // message, but the latch bytes go out in the same message as the data.
+  if (m_latch_data.size() < output->LatchBytes()) {
+    m_latch_data.resize(output->LatchBytes(), 0);
+  }
+  SPISegment segments[] = {
+    {output->GetData(), output->Size()},
+    {m_latch_data.empty() ? NULL : &m_latch_data[0], output->LatchBytes()},
+  };
+  m_spi_writer->WriteSPISegments(segments, output->LatchBytes() ? 2 : 1);
 }
 
 bool HardwareBackend::SetupGPIO() {
@@ -303,9 +442,12 @@ void HardwareBackend::CloseGPIOFDs() {
 SoftwareBackend::SoftwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
-    : m_spi_writer(writer),
+    : ola::thread::Thread(ola::thread::Thread::Options("spi-output")),
+      m_spi_writer(writer),
       m_drop_map(NULL),
-      m_write_pending(false),
+      m_latency_map(NULL),
+      m_frame_interval(FrameInterval(options.refresh_rate)),
+      m_barrier(options.barrier),
       m_exit(false),
       m_sync_output(options.sync_output),
       m_output_sizes(options.outputs, 0),
@@ -316,6 +458,9 @@ SoftwareBackend::SoftwareBackend(const Options &options,
     m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
                                            SPI_DROP_VAR_KEY);
     (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_latency_map = export_map->GetUIntMapVar(SPI_LATENCY_VAR,
+                                              SPI_DROP_VAR_KEY);
+    (*m_latency_map)[m_spi_writer->DevicePath()] = 0;
   }
 }
 
@@ -326,6 +471,9 @@ SoftwareBackend::~SoftwareBackend() {
   }
 
   m_cond_var.Signal();
+  if (m_barrier && IsRunning()) {
+    m_barrier->RemoveParticipant();
+  }
   Join();
 
   delete[] m_output;
@@ -336,7 +484,13 @@ bool SoftwareBackend::Init() {
     return false;
   }
 
+  if (m_barrier) {
+    m_barrier->AddParticipant();
+  }
   if (!Start()) {
+    if (m_barrier) {
+      m_barrier->RemoveParticipant();
+    }
     return false;
   }
   return true;
@@ -350,8 +504,7 @@ uint8_t *SoftwareBackend::Checkout(uint8_t output,
     return NULL;
   }
 
-  m_mutex.Lock();
-
+  // The write thread only sees copies of m_output, so no lock is needed.
   unsigned int leading = 0;
   unsigned int trailing = 0;
   for (uint8_t i = 0; i < m_output_sizes.size(); i++) {
@@ -391,59 +544,58 @@ void SoftwareBackend::Commit(uint8_t output) {
   }
 
   bool should_write = m_sync_output < 0 || output == m_sync_output;
-  if (should_write) {
-    if (m_write_pending && m_drop_map) {
-      // There was already another write pending which we're now stomping on
-      (*m_drop_map)[m_spi_writer->DevicePath()]++;
-    }
-    m_write_pending = should_write;
+  if (!should_write) {
+    return;
   }
-  m_mutex.Unlock();
-  if (should_write) {
-    m_cond_var.Signal();
+
+  // Once the slot has grown to the full size this doesn't allocate.
+  PendingFrame *frame = m_pending.WriteSlot();
+  frame->data.assign(m_output, m_output + m_length);
+  m_clock.CurrentTime(&frame->commit_time);
+
+  if (m_pending.Publish() && m_drop_map) {
+    // There was already another write pending which we've now replaced
+    (*m_drop_map)[m_spi_writer->DevicePath()]++;
   }
+  WakeWriteThread(&m_mutex, &m_cond_var);
 }
 
 void *SoftwareBackend::Run() {
-  uint8_t *output_data = NULL;
-  unsigned int length = 0;
+  TimeStamp next_write;
 
   while (true) {
     m_mutex.Lock();
 
-    if (m_exit) {
-      m_mutex.Unlock();
-      delete output_data;
-      return NULL;
+    while (!m_exit && !m_pending.HasNewValue()) {
+      m_cond_var.Wait(&m_mutex);
     }
 
-    if (!m_write_pending) {
-      m_cond_var.Wait(&m_mutex);
+    if (!m_frame_interval.IsZero()) {
+      WaitForFrameSlot(m_clock, next_write, &m_mutex, &m_cond_var, &m_exit);
     }
 
     if (m_exit) {
       m_mutex.Unlock();
-      delete[] output_data;
       return NULL;
     }
 
-    bool write_pending = m_write_pending;
-    m_write_pending = false;
-    if (write_pending) {
-      if (length < m_length) {
-        delete[] output_data;
-        output_data = new uint8_t[m_length];
-        length = m_length;
-      }
-      // TODO(simon) Add an actual size here
-      length = m_length;
-      memcpy(output_data, m_output, m_length);
-    }
     m_mutex.Unlock();
 
-    if (write_pending) {
-      m_spi_writer->WriteSPIData(output_data, length);
+    if (m_barrier) {
+      m_barrier->Wait();
     }
+
+    if (!m_frame_interval.IsZero()) {
+      m_clock.CurrentTime(&next_write);
+      next_write += m_frame_interval;
+    }
+
+    m_pending.Fetch();
+    const PendingFrame *frame = m_pending.ReadSlot();
+    m_spi_writer->WriteSPIData(
+        frame->data.empty() ? NULL : &frame->data[0], frame->data.size());
+    UpdateLatency(m_clock, frame->commit_time, m_spi_writer->DevicePath(),
+                  m_latency_map);
   }
 }
 
@@ -23,8 +23,10 @@
 #define PLUGINS_SPI_SPIBACKEND_H_
 
 #include <stdint.h>
+#include <ola/Clock.h>
 #include <ola/thread/Mutex.h>
 #include <ola/thread/Thread.h>
+#include <ola/thread/TripleBuffer.h>
 #include <string>
 #include <vector>
 
@@ -36,6 +38,10 @@ namespace spi {
 
 /**
  * The interface for all SPI Backends.
+ *
+ * Checkout() returns a buffer owned by the caller until the matching Commit(),
+ * the contents are preserved between frames. Checkout() and Commit() must be
+ * called from a single thread.
  */
 class SPIBackendInterface {
  public:
@@ -54,11 +60,64 @@ class SPIBackendInterface {
  protected:
   static const char SPI_DROP_VAR[];
   static const char SPI_DROP_VAR_KEY[];
+  static const char SPI_LATENCY_VAR[];
+};
+
+
+/**
+ * @brief Lines up the writes of several backends, so that frames on different
+ * SPI buses are written, and latched, together.
+ *
+ * Each backend's write thread calls Wait() once it has a frame ready. The
+ * threads are released when every participant is waiting, so a group of
+ * buses refreshes at the rate of the slowest bus rather than the sum of them.
+ * If a participant doesn't arrive within the timeout, for instance because
+ * its universe isn't being updated, the waiting threads go ahead on their
+ * own.
+ */
+class FrameBarrier {
+ public:
+  explicit FrameBarrier(const TimeInterval &timeout);
+
+  /**
+   * @brief Add a participant, this must be called before the participant's
+   * first Wait().
+   */
+  void AddParticipant();
+
+  /**
+   * @brief Remove a participant. Any threads that are waiting are released.
+   */
+  void RemoveParticipant();
+
+  /**
+   * @brief Block until all participants are waiting.
+   * @returns true if all the participants arrived, false if we timed out.
+   */
+  bool Wait();
+
+ private:
+  const TimeInterval m_timeout;
+  ola::Clock m_clock;
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond_var;
+  unsigned int m_participants;  // GUARDED_BY(m_mutex)
+  unsigned int m_waiting;  // GUARDED_BY(m_mutex)
+  unsigned int m_generation;  // GUARDED_BY(m_mutex)
+
+  void Release();
+
+  FrameBarrier(const FrameBarrier&);
+  FrameBarrier& operator=(const FrameBarrier&);
 };
 
 
 /**
- * A HardwareBackend which uses GPIO pins and an external de-multiplexer
+ * A HardwareBackend which uses GPIO pins and an external de-multiplexer.
+ *
+ * The caller fills its own buffer for each output, and Commit() copies it into
+ * the output's TripleBuffer. The write thread takes the latest frame from
+ * each TripleBuffer without locking.
  */
 class HardwareBackend : public ola::thread::Thread,
                         public SPIBackendInterface {
@@ -67,6 +126,14 @@ class HardwareBackend : public ola::thread::Thread,
     // Which GPIO bits to use to select the output. The number of outputs
     // will be 2 ** gpio_pins.size();
     std::vector<uint16_t> gpio_pins;
+    // The maximum number of frames per second for each output, 0 means no
+    // limit. Frames committed faster than this replace the pending frame.
+    uint16_t refresh_rate;
+    // If not NULL, each write waits until the other backends sharing the
+    // barrier are ready. Ownership is not transferred.
+    FrameBarrier *barrier;
+
+    Options() : refresh_rate(0), barrier(NULL) {}
   };
 
   HardwareBackend(const Options &options,
@@ -107,9 +174,14 @@ class HardwareBackend : public ola::thread::Thread,
     void SetLatchBytes(unsigned int latch_bytes);
     void SetPending();
     bool IsPending() const { return m_write_pending; }
-    void ResetPending() { m_write_pending = false; }
     const uint8_t *GetData() const { return m_data; }
     unsigned int Size() const { return m_size; }
+    unsigned int LatchBytes() const { return m_latch_bytes; }
+
+    void SetCommitTime(const TimeStamp &commit_time) {
+      m_commit_time = commit_time;
+    }
+    const TimeStamp &CommitTime() const { return m_commit_time; }
 
     OutputData& operator=(const OutputData &other);
 
@@ -119,29 +191,43 @@ class HardwareBackend : public ola::thread::Thread,
     unsigned int m_size;
     unsigned int m_actual_size;
     unsigned int m_latch_bytes;
+    TimeStamp m_commit_time;
 
     OutputData(const OutputData&);
   };
 
   typedef std::vector<int> GPIOFds;
   typedef std::vector<OutputData*> Outputs;
+  typedef ola::thread::TripleBuffer<OutputData> OutputMailbox;
 
   SPIWriterInterface *m_spi_writer;
   UIntMap *m_drop_map;
+  UIntMap *m_latency_map;
   const uint8_t m_output_count;
+  const TimeInterval m_frame_interval;
+  FrameBarrier *m_barrier;
+  ola::Clock m_clock;
+  // The mutex & condition variable are only used to put the write thread to
+  // sleep.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
-  bool m_exit;
+  bool m_exit;  // GUARDED_BY(m_mutex)
 
+  // The buffers the caller fills, these are never touched by the write thread.
   Outputs m_output_data;
+  // The frames waiting to be written.
+  std::vector<OutputMailbox*> m_pending_data;
+
+  // Zeros used for the latch bytes, only used by the write thread.
+  std::vector<uint8_t> m_latch_data;
 
   // GPIO members
   GPIOFds m_gpio_fds;
   const std::vector<uint16_t> m_gpio_pins;
   std::vector<bool> m_gpio_pin_state;
 
-  void SetupOutputs(Outputs *outputs);
-  void WriteOutput(uint8_t output_id, OutputData *output);
+  bool WritePending() const;
+  void WriteOutput(uint8_t output_id, const OutputData *output);
   bool SetupGPIO();
   void CloseGPIOFDs();
 };
@@ -150,6 +236,9 @@ class HardwareBackend : public ola::thread::Thread,
 /**
  * An SPI Backend which uses a software multipliexer. This accumulates all data
  * into a single buffer and then writes it to the SPI bus.
+ *
+ * Like the HardwareBackend the caller fills the buffer without holding the
+ * lock, and Commit() hands a copy to the write thread through a TripleBuffer.
  */
 class SoftwareBackend : public SPIBackendInterface,
                         public ola::thread::Thread {
@@ -165,8 +254,22 @@ class SoftwareBackend : public SPIBackendInterface,
      * If set to -1, we perform an SPI write on each update.
      */
     int16_t sync_output;
+    /*
+     * The maximum number of SPI writes per second, 0 means no limit.
+     */
+    uint16_t refresh_rate;
+    /*
+     * If not NULL, each write waits until the other backends sharing the
+     * barrier are ready. Ownership is not transferred.
+     */
+    FrameBarrier *barrier;
 
-    Options() : outputs(1), sync_output(0) {}
+    Options()
+        : outputs(1),
+          sync_output(0),
+          refresh_rate(0),
+          barrier(NULL) {
+    }
   };
 
   SoftwareBackend(const Options &options,
@@ -191,18 +294,30 @@ class SoftwareBackend : public SPIBackendInterface,
   void* Run();
 
  private:
+  struct PendingFrame {
+    std::vector<uint8_t> data;
+    TimeStamp commit_time;
+  };
+
   SPIWriterInterface *m_spi_writer;
   UIntMap *m_drop_map;
+  UIntMap *m_latency_map;
+  const TimeInterval m_frame_interval;
+  FrameBarrier *m_barrier;
+  ola::Clock m_clock;
+  // The mutex & condition variable are only used to put the write thread to
+  // sleep.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
-  bool m_write_pending;
-  bool m_exit;
+  bool m_exit;  // GUARDED_BY(m_mutex)
 
   const int16_t m_sync_output;
   std::vector<unsigned int> m_output_sizes;
   std::vector<unsigned int> m_latch_bytes;
   uint8_t *m_output;
   unsigned int m_length;
+
+  ola::thread::TripleBuffer<PendingFrame> m_pending;
 };
 
 
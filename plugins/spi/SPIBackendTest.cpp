@@ -21,6 +21,7 @@
 #include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "ola/Clock.h"
 #include "ola/base/Array.h"
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
@@ -32,6 +33,7 @@
 using ola::DmxBuffer;
 using ola::ExportMap;
 using ola::plugin::spi::FakeSPIWriter;
+using ola::plugin::spi::FrameBarrier;
 using ola::plugin::spi::HardwareBackend;
 using ola::plugin::spi::SoftwareBackend;
 using ola::plugin::spi::SPIBackendInterface;
@@ -44,6 +46,11 @@ class SPIBackendTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testInvalidOutputs);
   CPPUNIT_TEST(testSoftwareDrops);
   CPPUNIT_TEST(testSoftwareVariousFrameLengths);
+  CPPUNIT_TEST(testHardwarePacing);
+  CPPUNIT_TEST(testSoftwarePacing);
+  CPPUNIT_TEST(testSegments);
+  CPPUNIT_TEST(testBarrier);
+  CPPUNIT_TEST(testBarrierTimeout);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -51,6 +58,8 @@ class SPIBackendTest: public CppUnit::TestFixture {
 
   void setUp();
   unsigned int DropCount();
+  bool HasLatency();
+  void CheckPacing(SPIBackendInterface *backend);
   bool SendSomeData(SPIBackendInterface *backend,
                     uint8_t output,
                     const uint8_t *data,
@@ -63,6 +72,11 @@ class SPIBackendTest: public CppUnit::TestFixture {
   void testInvalidOutputs();
   void testSoftwareDrops();
   void testSoftwareVariousFrameLengths();
+  void testHardwarePacing();
+  void testSoftwarePacing();
+  void testSegments();
+  void testBarrier();
+  void testBarrierTimeout();
 
  private:
   ExportMap m_export_map;
@@ -79,6 +93,8 @@ class SPIBackendTest: public CppUnit::TestFixture {
   static const char DEVICE_NAME[];
   static const char SPI_DROP_VAR[];
   static const char SPI_DROP_VAR_KEY[];
+  static const char SPI_LATENCY_VAR[];
+  static const uint16_t REFRESH_RATE = 20;
 };
 
 const uint8_t SPIBackendTest::DATA1[] = {
@@ -115,6 +131,7 @@ const uint8_t SPIBackendTest::EXPECTED4[] = {
 const char SPIBackendTest::DEVICE_NAME[] = "Fake Device";
 const char SPIBackendTest::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendTest::SPI_DROP_VAR_KEY[] = "device";
+const char SPIBackendTest::SPI_LATENCY_VAR[] = "spi-latency-us";
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SPIBackendTest);
@@ -135,6 +152,50 @@ unsigned int SPIBackendTest::DropCount() {
   return (*drop_map)[DEVICE_NAME];
 }
 
+bool SPIBackendTest::HasLatency() {
+  UIntMap *latency_map = m_export_map.GetUIntMapVar(SPI_LATENCY_VAR,
+                                                    SPI_DROP_VAR_KEY);
+  UIntMap::const_iterator iter = latency_map->begin();
+  for (; iter != latency_map->end(); ++iter) {
+    if (iter->first == DEVICE_NAME) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Send a burst of frames, only the first and last should be written. The
+ * writer is blocked after the first write so the burst is never raced.
+ */
+void SPIBackendTest::CheckPacing(SPIBackendInterface *backend) {
+  OLA_ASSERT(backend->Init());
+  OLA_ASSERT_TRUE(HasLatency());
+  ola::Clock clock;
+  ola::TimeStamp start, end;
+  clock.CurrentTime(&start);
+
+  m_writer.BlockWriter();
+  OLA_ASSERT(SendSomeData(backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  m_writer.WaitForWrite();
+  m_writer.ResetWrite();
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+
+  OLA_ASSERT(SendSomeData(backend, 0, DATA2, arraysize(DATA2), m_total_size));
+  OLA_ASSERT(SendSomeData(backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  OLA_ASSERT(SendSomeData(backend, 0, DATA3, arraysize(DATA3), m_total_size));
+  OLA_ASSERT_EQ(2u, DropCount());
+
+  m_writer.UnblockWriter();
+  m_writer.WaitForWrite();
+  clock.CurrentTime(&end);
+  OLA_ASSERT_EQ(2u, m_writer.WriteCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA3, arraysize(DATA3));
+  // The second write can't start until a frame interval after the first.
+  OLA_ASSERT_TRUE(end - start >=
+                  ola::TimeInterval(ola::USEC_IN_SECONDS / REFRESH_RATE));
+}
+
 bool SPIBackendTest::SendSomeData(SPIBackendInterface *backend,
                                   uint8_t output,
                                   const uint8_t *data,
@@ -324,3 +385,90 @@ void SPIBackendTest::testSoftwareVariousFrameLengths() {
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 }
+
+/**
+ * Check the HardwareBackend holds frames back to the refresh rate.
+ */
+void SPIBackendTest::testHardwarePacing() {
+  HardwareBackend::Options options;
+  options.refresh_rate = REFRESH_RATE;
+  HardwareBackend backend(options, &m_writer, &m_export_map);
+  CheckPacing(&backend);
+}
+
+/**
+ * Check the SoftwareBackend holds frames back to the refresh rate.
+ */
+void SPIBackendTest::testSoftwarePacing() {
+  SoftwareBackend::Options options;
+  options.refresh_rate = REFRESH_RATE;
+  SoftwareBackend backend(options, &m_writer, &m_export_map);
+  CheckPacing(&backend);
+}
+
+/**
+ * Check the default WriteSPISegments() joins the segments.
+ */
+void SPIBackendTest::testSegments() {
+  ola::plugin::spi::SPISegment segments[] = {
+    {DATA1, arraysize(DATA1)},
+    {DATA2, 0},
+    {DATA2, arraysize(DATA2)},
+  };
+  OLA_ASSERT_TRUE(m_writer.WriteSPISegments(segments, arraysize(segments)));
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), DATA3, arraysize(DATA3));
+}
+
+
+/**
+ * Check a backend doesn't write until the other participants are ready.
+ */
+void SPIBackendTest::testBarrier() {
+  FrameBarrier barrier(ola::TimeInterval(5, 0));
+  // This thread is the other participant.
+  barrier.AddParticipant();
+
+  SoftwareBackend::Options options;
+  options.barrier = &barrier;
+  SoftwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  OLA_ASSERT_EQ(0u, m_writer.WriteCount());
+
+  OLA_ASSERT_TRUE(barrier.Wait());
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED1, arraysize(EXPECTED1));
+
+  // With only one participant left Wait() returns straight away.
+  barrier.RemoveParticipant();
+  m_writer.ResetWrite();
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA2, arraysize(DATA2), m_total_size));
+  m_writer.WaitForWrite();
+  OLA_ASSERT_EQ(2u, m_writer.WriteCount());
+}
+
+/**
+ * Check a backend writes on its own if the others don't arrive in time.
+ */
+void SPIBackendTest::testBarrierTimeout() {
+  const ola::TimeInterval timeout(0, 20000);
+  FrameBarrier barrier(timeout);
+  barrier.AddParticipant();
+
+  HardwareBackend::Options options;
+  options.barrier = &barrier;
+  HardwareBackend backend(options, &m_writer, &m_export_map);
+  OLA_ASSERT(backend.Init());
+
+  ola::Clock clock;
+  ola::TimeStamp start, end;
+  clock.CurrentTime(&start);
+  OLA_ASSERT(SendSomeData(&backend, 0, DATA1, arraysize(DATA1), m_total_size));
+  m_writer.WaitForWrite();
+  clock.CurrentTime(&end);
+  OLA_ASSERT_EQ(1u, m_writer.WriteCount());
+  OLA_ASSERT_TRUE(end - start >= timeout);
+}
@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <algorithm>
 #include <set>
 #include <sstream>
 #include <string>
@@ -48,6 +49,9 @@ using std::vector;
 const char SPIDevice::SPI_DEVICE_NAME[] = "SPI Device";
 const char SPIDevice::HARDWARE_BACKEND[] = "hardware";
 const char SPIDevice::SOFTWARE_BACKEND[] = "software";
+const uint8_t SPIDevice::MAX_UNIVERSE_COUNT;
+const uint16_t SPIDevice::PIXELS_PER_UNIVERSE;
+const uint16_t SPIDevice::MAX_SINGLE_UNIVERSE_PIXELS;
 
 /*
  * Create a new device
@@ -56,10 +60,12 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
                      Preferences *prefs,
                      PluginAdaptor *plugin_adaptor,
                      const string &spi_device,
-                     ola::rdm::UIDAllocator *uid_allocator)
+                     ola::rdm::UIDAllocator *uid_allocator,
+                     FrameBarrier *barrier)
     : Device(owner, SPI_DEVICE_NAME),
       m_preferences(prefs),
       m_plugin_adaptor(plugin_adaptor),
+      m_barrier(barrier),
       m_spi_device_name(spi_device) {
   m_spi_device_name = ola::file::FilenameFromPathOrPath(m_spi_device_name);
 
@@ -110,9 +116,32 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
           m_preferences->GetValue(DeviceLabelKey(i));
     }
 
-    uint8_t pixel_count;
+    uint8_t universe_count;
+    if (StringToInt(m_preferences->GetValue(UniverseCountKey(i)),
+                    &universe_count)) {
+      if (universe_count == 0 || universe_count > MAX_UNIVERSE_COUNT) {
+        OLA_WARN << "Invalid value for " << UniverseCountKey(i) << ": "
+                 << static_cast<int>(universe_count);
+      } else {
+        spi_output_options.universe_count = universe_count;
+      }
+    }
+    spi_output_options.scheduler = plugin_adaptor;
+    PopulateCurveOptions(i, &spi_output_options.curve);
+
+    // A strip that spans several universes can be longer than 255 pixels.
+    const uint16_t max_pixels = std::max(
+        MAX_SINGLE_UNIVERSE_PIXELS,
+        static_cast<uint16_t>(spi_output_options.universe_count *
+                              PIXELS_PER_UNIVERSE));
+    uint16_t pixel_count;
     if (StringToInt(m_preferences->GetValue(PixelCountKey(i)), &pixel_count)) {
-      spi_output_options.pixel_count = pixel_count;
+      if (pixel_count > max_pixels) {
+        OLA_WARN << "Invalid value for " << PixelCountKey(i) << ": "
+                 << pixel_count << ", limit is " << max_pixels;
+      } else {
+        spi_output_options.pixel_count = pixel_count;
+      }
     }
 
     auto_ptr<UID> uid(uid_allocator->AllocateNext());
@@ -126,6 +155,15 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
         new SPIOutputPort(this, m_backend.get(), *uid.get(),
                           spi_output_options));
   }
+
+  // The additional universes for each output are numbered after the outputs.
+  unsigned int port_id = port_count;
+  SPIPorts::iterator iter = m_spi_ports.begin();
+  for (; iter != m_spi_ports.end(); ++iter) {
+    for (unsigned int i = 1; i < (*iter)->UniverseCount(); i++) {
+      m_segment_ports.push_back(new SPISegmentPort(this, port_id++, *iter, i));
+    }
+  }
 }
 
 
@@ -140,6 +178,7 @@ string SPIDevice::DeviceId() const {
 bool SPIDevice::StartHook() {
   if (!m_backend->Init()) {
     STLDeleteElements(&m_spi_ports);
+    STLDeleteElements(&m_segment_ports);
     return false;
   }
 
@@ -159,6 +198,11 @@ bool SPIDevice::StartHook() {
 
     AddPort(*iter);
   }
+
+  SegmentPorts::iterator segment_iter = m_segment_ports.begin();
+  for (; segment_iter != m_segment_ports.end(); ++segment_iter) {
+    AddPort(*segment_iter);
+  }
   return true;
 }
 
@@ -204,6 +248,10 @@ string SPIDevice::GPIOPinKey() const {
   return m_spi_device_name + "-gpio-pin";
 }
 
+string SPIDevice::RefreshRateKey() const {
+  return m_spi_device_name + "-refresh-rate";
+}
+
 string SPIDevice::DeviceLabelKey(uint8_t port) const {
   return GetPortKey("device-label", port);
 }
@@ -220,6 +268,22 @@ string SPIDevice::PixelCountKey(uint8_t port) const {
   return GetPortKey("pixel-count", port);
 }
 
+string SPIDevice::UniverseCountKey(uint8_t port) const {
+  return GetPortKey("universe-count", port);
+}
+
+string SPIDevice::GammaKey(uint8_t port) const {
+  return GetPortKey("gamma", port);
+}
+
+string SPIDevice::BrightnessKey(uint8_t port) const {
+  return GetPortKey("brightness", port);
+}
+
+string SPIDevice::DitherKey(uint8_t port) const {
+  return GetPortKey("dither", port);
+}
+
 string SPIDevice::GetPortKey(const string &suffix, uint8_t port) const {
   std::ostringstream str;
   str << m_spi_device_name << "-" << static_cast<int>(port) << "-" << suffix;
@@ -239,6 +303,8 @@ void SPIDevice::SetDefaults() {
   m_preferences->SetDefaultValue(SPICEKey(), BoolValidator(), false);
   m_preferences->SetDefaultValue(PortCountKey(), UIntValidator(1, 8), 1);
   m_preferences->SetDefaultValue(SyncPortKey(), IntValidator(-2, 8), 0);
+  m_preferences->SetDefaultValue(RefreshRateKey(),
+                                 UIntValidator(0, MAX_REFRESH_RATE), 0);
   m_preferences->Save();
 }
 
@@ -261,6 +327,12 @@ void SPIDevice::PopulateHardwareBackendOptions(
 
     options->gpio_pins.push_back(pin);
   }
+  options->barrier = m_barrier;
+
+  if (!StringToInt(m_preferences->GetValue(RefreshRateKey()),
+                   &options->refresh_rate)) {
+    OLA_WARN << "Invalid integer value for " << RefreshRateKey();
+  }
 }
 
 void SPIDevice::PopulateSoftwareBackendOptions(
@@ -277,6 +349,38 @@ void SPIDevice::PopulateSoftwareBackendOptions(
   if (options->sync_output == -2) {
     options->sync_output = options->outputs - 1;
   }
+  options->barrier = m_barrier;
+
+  if (!StringToInt(m_preferences->GetValue(RefreshRateKey()),
+                   &options->refresh_rate)) {
+    OLA_WARN << "Invalid integer value for " << RefreshRateKey();
+  }
+}
+
+void SPIDevice::PopulateCurveOptions(
+    uint8_t port,
+    ola::dmx::OutputCurve::Options *options) {
+  const string gamma = m_preferences->GetValue(GammaKey(port));
+  if (!gamma.empty() && !ola::dmx::OutputCurve::ParseGamma(gamma,
+                                                         &options->gamma)) {
+    OLA_WARN << "Invalid value for " << GammaKey(port) << ": " << gamma;
+  }
+
+  uint8_t brightness;
+  if (StringToInt(m_preferences->GetValue(BrightnessKey(port)),
+                  &brightness)) {
+    if (brightness > ola::dmx::OutputCurve::MAX_BRIGHTNESS) {
+      OLA_WARN << "Invalid value for " << BrightnessKey(port) << ": "
+               << static_cast<int>(brightness);
+    } else {
+      options->brightness = brightness;
+    }
+  }
+
+  bool dither;
+  if (StringToBool(m_preferences->GetValue(DitherKey(port)), &dither)) {
+    options->dither = dither;
+  }
 }
 
 void SPIDevice::PopulateWriterOptions(SPIWriter::Options *options) {
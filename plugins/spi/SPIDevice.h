@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "olad/Device.h"
+#include "ola/dmx/OutputCurve.h"
 #include "ola/io/SelectServer.h"
 #include "ola/rdm/UIDAllocator.h"
 #include "ola/rdm/UID.h"
@@ -43,7 +44,8 @@ class SPIDevice: public ola::Device {
             class Preferences *preferences,
             class PluginAdaptor *plugin_adaptor,
             const std::string &spi_device,
-            ola::rdm::UIDAllocator *uid_allocator);
+            ola::rdm::UIDAllocator *uid_allocator,
+            FrameBarrier *barrier);
 
   std::string DeviceId() const;
 
@@ -55,12 +57,15 @@ class SPIDevice: public ola::Device {
 
  private:
   typedef std::vector<class SPIOutputPort*> SPIPorts;
+  typedef std::vector<class SPISegmentPort*> SegmentPorts;
 
   std::auto_ptr<SPIWriterInterface> m_writer;
   std::auto_ptr<SPIBackendInterface> m_backend;
   class Preferences *m_preferences;
   class PluginAdaptor *m_plugin_adaptor;
+  FrameBarrier *m_barrier;
   SPIPorts m_spi_ports;
+  SegmentPorts m_segment_ports;
   std::string m_spi_device_name;
 
   // Per device options
@@ -70,11 +75,16 @@ class SPIDevice: public ola::Device {
   std::string PortCountKey() const;
   std::string SyncPortKey() const;
   std::string GPIOPinKey() const;
+  std::string RefreshRateKey() const;
 
   // Per port options
   std::string DeviceLabelKey(uint8_t port) const;
   std::string PersonalityKey(uint8_t port) const;
   std::string PixelCountKey(uint8_t port) const;
+  std::string UniverseCountKey(uint8_t port) const;
+  std::string GammaKey(uint8_t port) const;
+  std::string BrightnessKey(uint8_t port) const;
+  std::string DitherKey(uint8_t port) const;
   std::string StartAddressKey(uint8_t port) const;
   std::string GetPortKey(const std::string &suffix, uint8_t port) const;
 
@@ -82,11 +92,17 @@ class SPIDevice: public ola::Device {
   void PopulateHardwareBackendOptions(HardwareBackend::Options *options);
   void PopulateSoftwareBackendOptions(SoftwareBackend::Options *options);
   void PopulateWriterOptions(SPIWriter::Options *options);
+  void PopulateCurveOptions(uint8_t port,
+                            ola::dmx::OutputCurve::Options *options);
 
   static const char SPI_DEVICE_NAME[];
   static const char HARDWARE_BACKEND[];
   static const char SOFTWARE_BACKEND[];
   static const uint16_t MAX_GPIO_PIN = 1023;
+  static const uint8_t MAX_UNIVERSE_COUNT = 8;
+  static const uint16_t PIXELS_PER_UNIVERSE = 170;
+  static const uint16_t MAX_SINGLE_UNIVERSE_PIXELS = 255;
+  static const uint16_t MAX_REFRESH_RATE = 1000;
 };
 }  // namespace spi
 }  // namespace plugin
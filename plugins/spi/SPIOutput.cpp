@@ -46,6 +46,7 @@
 #include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
 
+#include "plugins/spi/PixelEncoders.h"
 #include "plugins/spi/SPIBackend.h"
 #include "plugins/spi/SPIOutput.h"
 
@@ -53,6 +54,7 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+using ola::dmx::PixelBuffer;
 using ola::file::FilenameFromPathOrPath;
 using ola::network::HostToNetwork;
 using ola::network::NetworkToHost;
@@ -176,7 +178,9 @@ SPIOutput::SPIOutput(const UID &uid, SPIBackendInterface *backend,
       m_pixel_count(options.pixel_count),
       m_device_label(options.device_label),
       m_start_address(1),
-      m_identify_mode(false) {
+      m_identify_mode(false),
+      m_curve(options.curve),
+      m_encoder(&BestPixelEncoder()) {
   m_spi_device_name = FilenameFromPathOrPath(m_backend->DevicePath());
 
   PersonalityCollection::PersonalityList personalities;
@@ -211,6 +215,12 @@ SPIOutput::SPIOutput(const UID &uid, SPIBackendInterface *backend,
 #endif  // HAVE_GETLOADAVG
 
   m_network_manager.reset(new ola::rdm::NetworkManager());
+
+  if (options.universe_count > 1) {
+    m_pixel_buffer.reset(new PixelBuffer(
+        options.scheduler, PixelBuffer::Options(options.universe_count),
+        NewCallback(this, &SPIOutput::FrameReady)));
+  }
 }
 
 SPIOutput::~SPIOutput() {
@@ -235,12 +245,29 @@ bool SPIOutput::SetPersonality(uint16_t personality) {
   return m_personality_manager->SetActivePersonality(personality);
 }
 
+unsigned int SPIOutput::FrameSize() const {
+  if (m_pixel_buffer.get()) {
+    return m_pixel_buffer->SegmentCount() * m_pixel_buffer->SlotsPerSegment();
+  }
+  return DMX_UNIVERSE_SIZE;
+}
+
 uint16_t SPIOutput::GetStartAddress() const {
   return m_start_address;
 }
 
 bool SPIOutput::SetStartAddress(uint16_t address) {
   uint16_t footprint = m_personality_manager->ActivePersonalityFootprint();
+  if (m_pixel_buffer.get()) {
+    // The start address is within the first universe, but the footprint may
+    // extend into the following ones.
+    if (address == 0 || address > DMX_UNIVERSE_SIZE || footprint == 0 ||
+        address - 1u + footprint > FrameSize()) {
+      return false;
+    }
+    m_start_address = address;
+    return true;
+  }
   uint16_t end_address = DMX_UNIVERSE_SIZE - footprint + 1;
   if (address == 0 || address > end_address || footprint == 0) {
     return false;
@@ -262,10 +289,17 @@ string SPIOutput::Description() const {
  * Send DMX data over SPI.
  */
 bool SPIOutput::WriteDMX(const DmxBuffer &buffer) {
+  return WriteSegment(0, buffer);
+}
+
+bool SPIOutput::WriteSegment(unsigned int segment, const DmxBuffer &buffer) {
   if (m_identify_mode) {
     return true;
   }
-  return InternalWriteDMX(buffer);
+  if (m_pixel_buffer.get()) {
+    return m_pixel_buffer->Update(segment, buffer);
+  }
+  return segment == 0 && InternalWriteDMX(buffer);
 }
 
 
@@ -291,30 +325,44 @@ void SPIOutput::SendRDMRequest(RDMRequest *request,
 }
 
 bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
+  return InternalWriteFrame(buffer.GetRaw(), buffer.Size());
+}
+
+void SPIOutput::FrameReady(const uint8_t *data, unsigned int size) {
+  InternalWriteFrame(data, size);
+}
+
+bool SPIOutput::InternalWriteFrame(const uint8_t *data, unsigned int size) {
+  if (!m_curve.IsIdentity() && size) {
+    m_curve_data.resize(size);
+    m_curve.Apply(data, &m_curve_data[0], size);
+    data = &m_curve_data[0];
+  }
+
   switch (m_personality_manager->ActivePersonalityNumber()) {
     case 1:
-      IndividualWS2801Control(buffer);
+      IndividualWS2801Control(data, size);
       break;
     case 2:
-      CombinedWS2801Control(buffer);
+      CombinedWS2801Control(data, size);
       break;
     case 3:
-      IndividualLPD8806Control(buffer);
+      IndividualLPD8806Control(data, size);
       break;
     case 4:
-      CombinedLPD8806Control(buffer);
+      CombinedLPD8806Control(data, size);
       break;
     case 5:
-      IndividualP9813Control(buffer);
+      IndividualP9813Control(data, size);
       break;
     case 6:
-      CombinedP9813Control(buffer);
+      CombinedP9813Control(data, size);
       break;
     case 7:
-      IndividualAPA102Control(buffer);
+      IndividualAPA102Control(data, size);
       break;
     case 8:
-      CombinedAPA102Control(buffer);
+      CombinedAPA102Control(data, size);
       break;
     default:
       break;
@@ -322,7 +370,8 @@ bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
   return true;
 }
 
-void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
+void SPIOutput::IndividualWS2801Control(const uint8_t *data,
+                                        unsigned int size) {
   // We always check out the entire string length, even if we only have data
   // for part of it
   const unsigned int output_length = m_pixel_count * WS2801_SLOTS_PER_PIXEL;
@@ -332,14 +381,15 @@ void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
   }
 
   unsigned int new_length = output_length;
-  buffer.GetRange(m_start_address - 1, output, &new_length);
+  GetRange(data, size, m_start_address - 1, output, &new_length);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
+void SPIOutput::CombinedWS2801Control(const uint8_t *data,
+                                      unsigned int size) {
   unsigned int pixel_data_length = WS2801_SLOTS_PER_PIXEL;
   uint8_t pixel_data[WS2801_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
+  GetRange(data, size, m_start_address - 1, pixel_data, &pixel_data_length);
   if (pixel_data_length != WS2801_SLOTS_PER_PIXEL) {
     OLA_INFO << "Insufficient DMX data, required " << WS2801_SLOTS_PER_PIXEL
              << ", got " << pixel_data_length;
@@ -352,17 +402,16 @@ void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(output + (i * WS2801_SLOTS_PER_PIXEL), pixel_data,
-           pixel_data_length);
-  }
+  memcpy(output, pixel_data, pixel_data_length);
+  RepeatPattern(output, WS2801_SLOTS_PER_PIXEL, m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
+void SPIOutput::IndividualLPD8806Control(const uint8_t *data,
+                                         unsigned int size) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < LPD8806_SLOTS_PER_PIXEL) {
+  if (first_slot + LPD8806_SLOTS_PER_PIXEL > size) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -376,27 +425,21 @@ void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
     return;
 
   const unsigned int length = std::min(m_pixel_count * LPD8806_SLOTS_PER_PIXEL,
-                                       buffer.Size() - first_slot);
-
-  for (unsigned int i = 0; i < length / LPD8806_SLOTS_PER_PIXEL; i++) {
-    // Convert RGB to GRB
-    unsigned int offset = first_slot + i * LPD8806_SLOTS_PER_PIXEL;
-    uint8_t r = buffer.Get(offset);
-    uint8_t g = buffer.Get(offset + 1);
-    uint8_t b = buffer.Get(offset + 2);
-    output[i * LPD8806_SLOTS_PER_PIXEL] = 0x80 | (g >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 1] = 0x80 | (r >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 2] = 0x80 | (b >> 1);
-  }
+                                       size - first_slot);
+
+  // Convert RGB to GRB
+  m_encoder->lpd8806(data + first_slot, output,
+                     length / LPD8806_SLOTS_PER_PIXEL);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
+void SPIOutput::CombinedLPD8806Control(const uint8_t *data,
+                                       unsigned int size) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
   unsigned int pixel_data_length = LPD8806_SLOTS_PER_PIXEL;
 
   uint8_t pixel_data[LPD8806_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
+  GetRange(data, size, m_start_address - 1, pixel_data, &pixel_data_length);
   if (pixel_data_length != LPD8806_SLOTS_PER_PIXEL) {
     OLA_INFO << "Insufficient DMX data, required " << LPD8806_SLOTS_PER_PIXEL
              << ", got " << pixel_data_length;
@@ -413,20 +456,20 @@ void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
   if (!output)
     return;
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    for (unsigned int j = 0; j < LPD8806_SLOTS_PER_PIXEL; j++) {
-      output[i * LPD8806_SLOTS_PER_PIXEL + j] = 0x80 | (pixel_data[j] >> 1);
-    }
+  for (unsigned int j = 0; j < LPD8806_SLOTS_PER_PIXEL; j++) {
+    output[j] = 0x80 | (pixel_data[j] >> 1);
   }
+  RepeatPattern(output, LPD8806_SLOTS_PER_PIXEL, m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
+void SPIOutput::IndividualP9813Control(const uint8_t *data,
+                                       unsigned int size) {
   // We need 4 bytes of zeros in the beginning and 8 bytes at
   // the end
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
+  if (first_slot + P9813_SLOTS_PER_PIXEL > size) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -441,42 +484,37 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to P9813 Pixel
-    unsigned int offset = first_slot + i * P9813_SLOTS_PER_PIXEL;
-    // We need to avoid the first 4 bytes of the buffer since that acts as a
-    // start of frame delimiter
+  // Convert RGB to P9813 Pixels. We need to avoid the first 4 bytes of the
+  // buffer since that acts as a start of frame delimiter
+  const unsigned int pixels = std::min(
+      m_pixel_count, (size - first_slot) / P9813_SLOTS_PER_PIXEL);
+  m_encoder->p9813(data + first_slot, output + P9813_SPI_BYTES_PER_PIXEL,
+                   pixels);
+
+  // Pixels without data are set to black
+  for (unsigned int i = pixels; i < m_pixel_count; i++) {
     unsigned int spi_offset = (i + 1) * P9813_SPI_BYTES_PER_PIXEL;
-    uint8_t r = 0;
-    uint8_t b = 0;
-    uint8_t g = 0;
-    if (buffer.Size() - offset >= P9813_SLOTS_PER_PIXEL) {
-      r = buffer.Get(offset);
-      g = buffer.Get(offset + 1);
-      b = buffer.Get(offset + 2);
-    }
-    output[spi_offset] = P9813CreateFlag(r, g, b);
-    output[spi_offset + 1] = b;
-    output[spi_offset + 2] = g;
-    output[spi_offset + 3] = r;
+    output[spi_offset] = P9813CreateFlag(0, 0, 0);
+    memset(output + spi_offset + 1, 0, P9813_SPI_BYTES_PER_PIXEL - 1);
   }
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
+void SPIOutput::CombinedP9813Control(const uint8_t *data,
+                                     unsigned int size) {
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
 
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
+  if (first_slot + P9813_SLOTS_PER_PIXEL > size) {
     OLA_INFO << "Insufficient DMX data, required " << P9813_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << (size > first_slot ? size - first_slot : 0);
     return;
   }
 
   uint8_t pixel_data[P9813_SPI_BYTES_PER_PIXEL];
-  pixel_data[3] = buffer.Get(first_slot);  // Get Red
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
+  pixel_data[3] = data[first_slot];  // Get Red
+  pixel_data[2] = data[first_slot + 1];  // Get Green
+  pixel_data[1] = data[first_slot + 2];  // Get Blue
   pixel_data[0] = P9813CreateFlag(pixel_data[3], pixel_data[2],
                                   pixel_data[1]);
 
@@ -486,27 +524,20 @@ void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    memcpy(&output[(i + 1) * P9813_SPI_BYTES_PER_PIXEL], pixel_data,
-           P9813_SPI_BYTES_PER_PIXEL);
-  }
+  memcpy(&output[P9813_SPI_BYTES_PER_PIXEL], pixel_data,
+         P9813_SPI_BYTES_PER_PIXEL);
+  RepeatPattern(&output[P9813_SPI_BYTES_PER_PIXEL], P9813_SPI_BYTES_PER_PIXEL,
+                m_pixel_count);
   m_backend->Commit(m_output_number);
 }
 
-/**
- * For more information please visit:
- * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
- */
 uint8_t SPIOutput::P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue) {
-  uint8_t flag = 0;
-  flag =  (red & 0xc0) >> 6;
-  flag |= (green & 0xc0) >> 4;
-  flag |= (blue & 0xc0) >> 2;
-  return ~flag;
+  return P9813Flag(red, green, blue);
 }
 
 
-void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
+void SPIOutput::IndividualAPA102Control(const uint8_t *data,
+                                        unsigned int size) {
   // some detailed information on the protocol:
   // https://cpldcpu.wordpress.com/2014/11/30/understanding-the-apa102-superled/
   // Data-Struct
@@ -518,15 +549,15 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   const unsigned int first_slot = m_start_address - 1;  // 0 offset
 
   // only do something if at least 1 pixel can be updated..
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
+  if (first_slot + APA102_SLOTS_PER_PIXEL > size) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << (size > first_slot ? size - first_slot : 0);
     return;
   }
 
   // We always check out the entire string length, even if we only have data
   // for part of it
-  uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
+  unsigned int output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
   // only add the APA102_START_FRAME_BYTES on the first port!!
   if (m_output_number == 0) {
     output_length += APA102_START_FRAME_BYTES;
@@ -547,54 +578,49 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
     memset(output, 0, APA102_START_FRAME_BYTES);
   }
 
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to APA102 Pixel
-    uint16_t offset = first_slot + (i * APA102_SLOTS_PER_PIXEL);
-
+  // only skip APA102_START_FRAME_BYTES on the first port!!
+  // We need to avoid the first 4 bytes of the buffer since that acts as a
+  // start of frame delimiter
+  uint8_t *pixel_output = output;
+  if (m_output_number == 0) {
+    pixel_output += APA102_START_FRAME_BYTES;
+  }
 
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    // only skip APA102_START_FRAME_BYTES on the first port!!
-    if (m_output_number == 0) {
-      // We need to avoid the first 4 bytes of the buffer since that acts as a
-      // start of frame delimiter
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    // set pixel data
-    // first Byte contains:
-    // 3 bits start mark (111) + 5 bits global brightness
-    // set global brightness fixed to 31 --> that reduces flickering
-    // that can be written as 0xE0 & 0x1F
-    output[spi_offset] = 0xFF;
-    // only write pixel data if buffer has complete data for this pixel:
-    if ((buffer.Size() - offset) >= APA102_SLOTS_PER_PIXEL) {
-      // Convert RGB to APA102 Pixel
-      // skip spi_offset + 0 (is already set)
-      output[spi_offset + 1] = buffer.Get(offset + 2);  // blue
-      output[spi_offset + 2] = buffer.Get(offset + 1);  // green
-      output[spi_offset + 3] = buffer.Get(offset);      // red
-    }
+  // Convert RGB to APA102 Pixels, only for pixels that have complete data.
+  // The first byte of each pixel contains:
+  // 3 bits start mark (111) + 5 bits global brightness
+  // set global brightness fixed to 31 --> that reduces flickering
+  // that can be written as 0xE0 & 0x1F
+  const unsigned int pixels = std::min(
+      m_pixel_count, (size - first_slot) / APA102_SLOTS_PER_PIXEL);
+  m_encoder->apa102(data + first_slot, pixel_output, pixels);
+
+  // The remaining pixels keep their old colour.
+  for (unsigned int i = pixels; i < m_pixel_count; i++) {
+    pixel_output[i * APA102_SPI_BYTES_PER_PIXEL] = 0xFF;
   }
 
   // write output back
   m_backend->Commit(m_output_number);
 }
 
-void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
+void SPIOutput::CombinedAPA102Control(const uint8_t *data,
+                                      unsigned int size) {
   // for Protocol details see IndividualAPA102Control
 
   // calculate DMX-start-address
-  const uint16_t first_slot = m_start_address - 1;  // 0 offset
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
 
   // check if enough data is there.
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
+  if (first_slot + APA102_SLOTS_PER_PIXEL > size) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << (size > first_slot ? size - first_slot : 0);
     return;
   }
 
   // We always check out the entire string length, even if we only have data
   // for part of it
-  uint16_t output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
+  unsigned int output_length = (m_pixel_count * APA102_SPI_BYTES_PER_PIXEL);
   // only add the APA102_START_FRAME_BYTES on the first port!!
   if (m_output_number == 0) {
     output_length += APA102_START_FRAME_BYTES;
@@ -618,19 +644,17 @@ void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
   // create Pixel Data
   uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
   pixel_data[0] = 0xFF;
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[3] = buffer.Get(first_slot);      // Get Red
+  pixel_data[1] = data[first_slot + 2];  // Get Blue
+  pixel_data[2] = data[first_slot + 1];  // Get Green
+  pixel_data[3] = data[first_slot];      // Get Red
 
   // set all pixel to same value
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    if (m_output_number == 0) {
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    memcpy(&output[spi_offset], pixel_data,
-           APA102_SPI_BYTES_PER_PIXEL);
+  uint8_t *pixel_output = output;
+  if (m_output_number == 0) {
+    pixel_output += APA102_START_FRAME_BYTES;
   }
+  memcpy(pixel_output, pixel_data, APA102_SPI_BYTES_PER_PIXEL);
+  RepeatPattern(pixel_output, APA102_SPI_BYTES_PER_PIXEL, m_pixel_count);
 
   // write output back...
   m_backend->Commit(m_output_number);
@@ -648,11 +672,25 @@ void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
  */
 uint8_t SPIOutput::CalculateAPA102LatchBytes(uint16_t pixel_count) {
   // round up so that we get definitely enough bits
-  const uint8_t latch_bits = (pixel_count + 1) / 2;
+  const uint16_t latch_bits = (pixel_count + 1) / 2;
   const uint8_t latch_bytes = (latch_bits + 7) / 8;
   return latch_bytes;
 }
 
+/**
+ * Copy a range of the frame, this matches DmxBuffer::GetRange().
+ */
+void SPIOutput::GetRange(const uint8_t *data, unsigned int size,
+                         unsigned int offset, uint8_t *output,
+                         unsigned int *length) {
+  if (offset >= size) {
+    *length = 0;
+    return;
+  }
+  *length = std::min(*length, size - offset);
+  memcpy(output, data + offset, *length);
+}
+
 
 RDMResponse *SPIOutput::GetDeviceInfo(const RDMRequest *request) {
   return ResponderHelper::GetDeviceInfo(
@@ -727,14 +765,11 @@ RDMResponse *SPIOutput::SetIdentify(const RDMRequest *request) {
   if (m_identify_mode != old_value) {
     OLA_INFO << "SPI " << m_spi_device_name << " identify mode " << (
         m_identify_mode ? "on" : "off");
-    DmxBuffer identify_buffer;
-    if (m_identify_mode) {
-      identify_buffer.SetRangeToValue(0, DMX_MAX_SLOT_VALUE,
-                                      DMX_UNIVERSE_SIZE);
-    } else {
-      identify_buffer.Blackout();
-    }
-    InternalWriteDMX(identify_buffer);
+    const vector<uint8_t> identify_frame(
+        FrameSize(),
+        static_cast<uint8_t>(
+            m_identify_mode ? DMX_MAX_SLOT_VALUE : DMX_MIN_SLOT_VALUE));
+    InternalWriteFrame(&identify_frame[0], identify_frame.size());
   }
   return response;
 }
@@ -23,8 +23,11 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "common/rdm/NetworkManager.h"
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/OutputCurve.h"
+#include "ola/dmx/PixelBuffer.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
@@ -40,13 +43,30 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
  public:
   struct Options {
     std::string device_label;
-    uint8_t pixel_count;
+    uint16_t pixel_count;
     uint8_t output_number;
+    /**
+     * The number of universes the strip spans. If this is more than 1, each
+     * universe provides 510 slots and the SPI data is written once all the
+     * universes have been updated.
+     */
+    uint8_t universe_count;
+    /**
+     * Used to send partial frames if some universes don't update, may be
+     * NULL.
+     */
+    ola::thread::SchedulerInterface *scheduler;
+    /**
+     * The gamma / dimming curve applied to the DMX data.
+     */
+    ola::dmx::OutputCurve::Options curve;
 
     explicit Options(uint8_t output_number, const std::string &spi_device_name)
         : device_label("SPI Device - " + spi_device_name),
           pixel_count(25),  // For the https://www.adafruit.com/products/738
-          output_number(output_number) {
+          output_number(output_number),
+          universe_count(1),
+          scheduler(NULL) {
     }
   };
 
@@ -62,10 +82,21 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   uint16_t GetStartAddress() const;
   bool SetStartAddress(uint16_t start_address);
   unsigned int PixelCount() const { return m_pixel_count; }
+  unsigned int UniverseCount() const {
+    return m_pixel_buffer.get() ? m_pixel_buffer->SegmentCount() : 1;
+  }
 
   std::string Description() const;
   bool WriteDMX(const DmxBuffer &buffer);
 
+  /**
+   * @brief Write the data for one of the universes the strip spans.
+   * @param segment the index of the universe, 0 is the universe which
+   *   WriteDMX() is called for.
+   * @param buffer the DMX data.
+   */
+  bool WriteSegment(unsigned int segment, const DmxBuffer &buffer);
+
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void SendRDMRequest(ola::rdm::RDMRequest *request,
@@ -101,18 +132,25 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   std::auto_ptr<ola::rdm::PersonalityManager> m_personality_manager;
   ola::rdm::Sensors m_sensors;
   std::auto_ptr<ola::rdm::NetworkManagerInterface> m_network_manager;
+  std::auto_ptr<ola::dmx::PixelBuffer> m_pixel_buffer;
+  ola::dmx::OutputCurve m_curve;
+  std::vector<uint8_t> m_curve_data;
+  const struct PixelEncoder *m_encoder;
 
   // DMX methods
   bool InternalWriteDMX(const DmxBuffer &buffer);
-
-  void IndividualWS2801Control(const DmxBuffer &buffer);
-  void CombinedWS2801Control(const DmxBuffer &buffer);
-  void IndividualLPD8806Control(const DmxBuffer &buffer);
-  void CombinedLPD8806Control(const DmxBuffer &buffer);
-  void IndividualP9813Control(const DmxBuffer &buffer);
-  void CombinedP9813Control(const DmxBuffer &buffer);
-  void IndividualAPA102Control(const DmxBuffer &buffer);
-  void CombinedAPA102Control(const DmxBuffer &buffer);
+  bool InternalWriteFrame(const uint8_t *data, unsigned int size);
+  void FrameReady(const uint8_t *data, unsigned int size);
+  unsigned int FrameSize() const;
+
+  void IndividualWS2801Control(const uint8_t *data, unsigned int size);
+  void CombinedWS2801Control(const uint8_t *data, unsigned int size);
+  void IndividualLPD8806Control(const uint8_t *data, unsigned int size);
+  void CombinedLPD8806Control(const uint8_t *data, unsigned int size);
+  void IndividualP9813Control(const uint8_t *data, unsigned int size);
+  void CombinedP9813Control(const uint8_t *data, unsigned int size);
+  void IndividualAPA102Control(const uint8_t *data, unsigned int size);
+  void CombinedAPA102Control(const uint8_t *data, unsigned int size);
 
   unsigned int LPD8806BufferSize() const;
   void WriteSPIData(const uint8_t *data, unsigned int length);
@@ -174,6 +212,9 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   // Helpers
   uint8_t P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue);
   static uint8_t CalculateAPA102LatchBytes(uint16_t pixel_count);
+  static void GetRange(const uint8_t *data, unsigned int size,
+                       unsigned int offset, uint8_t *output,
+                       unsigned int *length);
 
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
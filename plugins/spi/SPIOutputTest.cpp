@@ -19,22 +19,34 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 #include "ola/base/Array.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
+#include "plugins/spi/PixelEncoders.h"
 #include "plugins/spi/SPIBackend.h"
 #include "plugins/spi/SPIOutput.h"
 
+using ola::Clock;
 using ola::DmxBuffer;
+using ola::TimeStamp;
+using ola::plugin::spi::PixelEncoder;
+using ola::plugin::spi::RepeatPattern;
+using ola::plugin::spi::ScalarPixelEncoder;
+using ola::plugin::spi::SupportedPixelEncoders;
 using ola::plugin::spi::FakeSPIBackend;
 using ola::plugin::spi::SPIBackendInterface;
 using ola::plugin::spi::SPIOutput;
 using ola::rdm::UID;
 using std::string;
+using std::vector;
 
 class SPIOutputTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(SPIOutputTest);
@@ -47,6 +59,11 @@ class SPIOutputTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testCombinedP9813Control);
   CPPUNIT_TEST(testIndividualAPA102Control);
   CPPUNIT_TEST(testCombinedAPA102Control);
+  CPPUNIT_TEST(testMultipleUniverses);
+  CPPUNIT_TEST(testOutputCurve);
+  CPPUNIT_TEST(testPixelEncoders);
+  CPPUNIT_TEST(testRepeatPattern);
+  CPPUNIT_TEST(testEncoderBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +82,11 @@ class SPIOutputTest: public CppUnit::TestFixture {
   void testCombinedP9813Control();
   void testIndividualAPA102Control();
   void testCombinedAPA102Control();
+  void testMultipleUniverses();
+  void testOutputCurve();
+  void testPixelEncoders();
+  void testRepeatPattern();
+  void testEncoderBenchmark();
 
  private:
   UID m_uid;
@@ -738,3 +760,177 @@ void SPIOutputTest::testCombinedAPA102Control() {
   // check if the output writes are 1
   OLA_ASSERT_EQ(1u, backend.Writes(1));
 }
+
+
+/**
+ * Test a strip that spans more than one universe.
+ */
+void SPIOutputTest::testMultipleUniverses() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 200;
+  options.universe_count = 2;
+  SPIOutput output(m_uid, &backend, options);
+  OLA_ASSERT_EQ(2u, output.UniverseCount());
+  OLA_ASSERT_EQ(
+      string("Output 0, WS2801 Individual Control, 600 slots @ 1."
+             " (707a:00000000)"),
+      output.Description());
+
+  // The footprint has to fit within the two universes.
+  OLA_ASSERT_TRUE(output.SetStartAddress(421));
+  OLA_ASSERT_FALSE(output.SetStartAddress(422));
+  OLA_ASSERT_TRUE(output.SetStartAddress(1));
+
+  DmxBuffer buffer;
+  buffer.SetRangeToValue(0, 1, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(output.WriteSegment(1, buffer));
+  OLA_ASSERT_EQ(0u, backend.Writes(0));
+  OLA_ASSERT_FALSE(output.WriteSegment(2, buffer));
+
+  // Only 510 slots are taken from each universe.
+  buffer.SetRangeToValue(0, 2, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(output.WriteDMX(buffer));
+  OLA_ASSERT_EQ(1u, backend.Writes(0));
+
+  unsigned int length = 0;
+  const uint8_t *data = backend.GetData(0, &length);
+  OLA_ASSERT_EQ(600u, length);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), data[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), data[509]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), data[510]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), data[599]);
+}
+
+
+/**
+ * Check the output curve is applied before the data is encoded.
+ */
+void SPIOutputTest::testOutputCurve() {
+  FakeSPIBackend backend(1);
+  SPIOutput::Options options(0, "Test SPI Device");
+  options.pixel_count = 2;
+  options.curve.gamma = 2.0;
+  options.curve.brightness = 50;
+  SPIOutput output(m_uid, &backend, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("0,128,255,255,128,0");
+  output.WriteDMX(buffer);
+  unsigned int length = 0;
+  const uint8_t *data = backend.GetData(0, &length);
+  const uint8_t EXPECTED[] = { 0, 32, 128, 128, 32, 0 };
+  OLA_ASSERT_DATA_EQUALS(EXPECTED, arraysize(EXPECTED), data, length);
+}
+
+
+/**
+ * Check the vector encoders match the scalar one.
+ */
+void SPIOutputTest::testPixelEncoders() {
+  const unsigned int MAX_PIXELS = 67;
+  uint8_t rgb[MAX_PIXELS * 3];
+  for (unsigned int i = 0; i < arraysize(rgb); i++) {
+    rgb[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+
+  const PixelEncoder &scalar = ScalarPixelEncoder();
+  vector<const PixelEncoder*> encoders;
+  SupportedPixelEncoders(&encoders);
+  OLA_ASSERT_EQ(&scalar, encoders[0]);
+
+  // The scalar encoders match the old per-pixel code.
+  uint8_t output[MAX_PIXELS * 4 + 1];
+  scalar.lpd8806(rgb, output, 1);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x80 | (rgb[1] >> 1)), output[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x80 | (rgb[0] >> 1)), output[1]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x80 | (rgb[2] >> 1)), output[2]);
+  scalar.apa102(rgb, output, 1);
+  const uint8_t EXPECTED_APA102[] = {0xff, rgb[2], rgb[1], rgb[0]};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED_APA102, arraysize(EXPECTED_APA102),
+                         output, 4u);
+
+  for (unsigned int i = 1; i < encoders.size(); i++) {
+    const PixelEncoder &encoder = *encoders[i];
+    for (unsigned int pixels = 0; pixels <= MAX_PIXELS; pixels++) {
+      uint8_t expected[arraysize(output)];
+      uint8_t actual[arraysize(output)];
+      memset(expected, 0x55, arraysize(expected));
+      memset(actual, 0x55, arraysize(actual));
+
+      scalar.lpd8806(rgb, expected, pixels);
+      encoder.lpd8806(rgb, actual, pixels);
+      OLA_ASSERT_DATA_EQUALS(expected, arraysize(expected), actual,
+                             arraysize(actual));
+
+      scalar.p9813(rgb, expected, pixels);
+      encoder.p9813(rgb, actual, pixels);
+      OLA_ASSERT_DATA_EQUALS(expected, arraysize(expected), actual,
+                             arraysize(actual));
+
+      scalar.apa102(rgb, expected, pixels);
+      encoder.apa102(rgb, actual, pixels);
+      OLA_ASSERT_DATA_EQUALS(expected, arraysize(expected), actual,
+                             arraysize(actual));
+    }
+  }
+}
+
+
+/**
+ * Check RepeatPattern.
+ */
+void SPIOutputTest::testRepeatPattern() {
+  uint8_t output[] = {1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  RepeatPattern(output, 3, 0);
+  RepeatPattern(output, 3, 1);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), output[3]);
+
+  RepeatPattern(output, 3, 5);
+  const uint8_t EXPECTED[] = {1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3, 0};
+  OLA_ASSERT_DATA_EQUALS(EXPECTED, arraysize(EXPECTED), output,
+                         arraysize(output));
+}
+
+
+/**
+ * Time each of the encoders for a long strip. This only logs the results.
+ */
+void SPIOutputTest::testEncoderBenchmark() {
+  const unsigned int PIXELS = 1020;
+  const unsigned int ITERATIONS = 2000;
+  vector<uint8_t> rgb(PIXELS * 3);
+  vector<uint8_t> output(PIXELS * 4);
+  for (unsigned int i = 0; i < rgb.size(); i++) {
+    rgb[i] = static_cast<uint8_t>(i);
+  }
+
+  vector<const PixelEncoder*> encoders;
+  SupportedPixelEncoders(&encoders);
+  Clock clock;
+  for (unsigned int i = 0; i < encoders.size(); i++) {
+    const PixelEncoder &encoder = *encoders[i];
+    TimeStamp start, lpd8806, p9813, apa102;
+    clock.CurrentTime(&start);
+    for (unsigned int j = 0; j < ITERATIONS; j++) {
+      encoder.lpd8806(&rgb[0], &output[0], PIXELS);
+    }
+    clock.CurrentTime(&lpd8806);
+    for (unsigned int j = 0; j < ITERATIONS; j++) {
+      encoder.p9813(&rgb[0], &output[0], PIXELS);
+    }
+    clock.CurrentTime(&p9813);
+    for (unsigned int j = 0; j < ITERATIONS; j++) {
+      encoder.apa102(&rgb[0], &output[0], PIXELS);
+    }
+    clock.CurrentTime(&apa102);
+
+    // Report the time per frame in ns.
+    OLA_INFO << encoder.name << ": " << PIXELS << " pixels, lpd8806 "
+             << (lpd8806 - start).AsInt() * 1000 / ITERATIONS
+             << "ns, p9813 "
+             << (p9813 - lpd8806).AsInt() * 1000 / ITERATIONS
+             << "ns, apa102 "
+             << (apa102 - p9813).AsInt() * 1000 / ITERATIONS << "ns";
+  }
+}
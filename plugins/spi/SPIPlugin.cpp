@@ -28,6 +28,8 @@
 #include "ola/rdm/UIDAllocator.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
+#include "plugins/spi/SPIBackend.h"
 #include "plugins/spi/SPIDevice.h"
 #include "plugins/spi/SPIPlugin.h"
 #include "plugins/spi/SPIPluginDescription.h"
@@ -48,6 +50,16 @@ const char SPIPlugin::PLUGIN_NAME[] = "SPI";
 const char SPIPlugin::PLUGIN_PREFIX[] = "spi";
 const char SPIPlugin::SPI_BASE_UID_KEY[] = "base_uid";
 const char SPIPlugin::SPI_DEVICE_PREFIX_KEY[] = "device_prefix";
+const char SPIPlugin::SYNC_DEVICES_KEY[] = "sync_devices";
+const char SPIPlugin::SYNC_TIMEOUT_KEY[] = "sync_timeout_ms";
+const unsigned int SPIPlugin::DEFAULT_SYNC_TIMEOUT_MS;
+const unsigned int SPIPlugin::MAX_SYNC_TIMEOUT_MS;
+
+SPIPlugin::SPIPlugin(ola::PluginAdaptor *plugin_adaptor)
+    : Plugin(plugin_adaptor) {
+}
+
+SPIPlugin::~SPIPlugin() {}
 
 /*
  * Start the plugin
@@ -73,11 +85,20 @@ bool SPIPlugin::StartHook() {
     return false;
   }
 
+  if (m_preferences->GetValueAsBool(SYNC_DEVICES_KEY)) {
+    unsigned int timeout_ms;
+    if (!StringToInt(m_preferences->GetValue(SYNC_TIMEOUT_KEY), &timeout_ms)) {
+      timeout_ms = DEFAULT_SYNC_TIMEOUT_MS;
+    }
+    m_barrier.reset(new FrameBarrier(
+        TimeInterval(static_cast<int64_t>(timeout_ms) * ONE_THOUSAND)));
+  }
+
   ola::rdm::UIDAllocator uid_allocator(*base_uid);
   vector<string>::const_iterator iter = spi_files.begin();
   for (; iter != spi_files.end(); ++iter) {
     SPIDevice *device = new SPIDevice(this, m_preferences, m_plugin_adaptor,
-                                      *iter, &uid_allocator);
+                                      *iter, &uid_allocator, m_barrier.get());
 
     if (!device) {
       continue;
@@ -106,6 +127,9 @@ bool SPIPlugin::StopHook() {
     ok &= (*iter)->Stop();
     delete *iter;
   }
+  m_devices.clear();
+  // The backends have all left the barrier by now.
+  m_barrier.reset();
   return ok;
 }
 
@@ -134,6 +158,13 @@ bool SPIPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(SPI_BASE_UID_KEY,
                                          StringValidator(),
                                          DEFAULT_BASE_UID);
+  save |= m_preferences->SetDefaultValue(SYNC_DEVICES_KEY,
+                                         BoolValidator(),
+                                         false);
+  save |= m_preferences->SetDefaultValue(
+      SYNC_TIMEOUT_KEY,
+      UIntValidator(1, MAX_SYNC_TIMEOUT_MS),
+      DEFAULT_SYNC_TIMEOUT_MS);
   if (save) {
     m_preferences->Save();
   }
@@ -147,3 +178,5 @@ bool SPIPlugin::SetDefaultPreferences() {
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::spi::SPIPlugin)
@@ -21,6 +21,7 @@
 #ifndef PLUGINS_SPI_SPIPLUGIN_H_
 #define PLUGINS_SPI_SPIPLUGIN_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "olad/Plugin.h"
@@ -30,10 +31,12 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+class FrameBarrier;
+
 class SPIPlugin: public ola::Plugin {
  public:
-  explicit SPIPlugin(class ola::PluginAdaptor *plugin_adaptor)
-      : Plugin(plugin_adaptor) {}
+  explicit SPIPlugin(class ola::PluginAdaptor *plugin_adaptor);
+  ~SPIPlugin();
 
   std::string Name() const { return PLUGIN_NAME; }
   std::string Description() const;
@@ -42,6 +45,8 @@ class SPIPlugin: public ola::Plugin {
 
  private:
   std::vector<class SPIDevice*> m_devices;
+  // Shared by all the devices when sync_devices is true.
+  std::auto_ptr<FrameBarrier> m_barrier;
 
   bool StartHook();
   bool StopHook();
@@ -53,6 +58,10 @@ class SPIPlugin: public ola::Plugin {
   static const char PLUGIN_PREFIX[];
   static const char SPI_BASE_UID_KEY[];
   static const char SPI_DEVICE_PREFIX_KEY[];
+  static const char SYNC_DEVICES_KEY[];
+  static const char SYNC_TIMEOUT_KEY[];
+  static const unsigned int DEFAULT_SYNC_TIMEOUT_MS = 100;
+  static const unsigned int MAX_SYNC_TIMEOUT_MS = 1000;
 };
 }  // namespace spi
 }  // namespace plugin
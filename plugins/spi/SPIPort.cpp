@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <sstream>
 #include <string>
 #include "ola/Constants.h"
 #include "ola/rdm/RDMCommand.h"
@@ -72,6 +73,10 @@ unsigned int SPIOutputPort::PixelCount() const {
   return m_spi_output.PixelCount();
 }
 
+unsigned int SPIOutputPort::UniverseCount() const {
+  return m_spi_output.UniverseCount();
+}
+
 string SPIOutputPort::Description() const {
   return m_spi_output.Description();
 }
@@ -80,6 +85,11 @@ bool SPIOutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t) {
   return m_spi_output.WriteDMX(buffer);
 }
 
+bool SPIOutputPort::WriteSegment(unsigned int segment,
+                                 const DmxBuffer &buffer) {
+  return m_spi_output.WriteSegment(segment, buffer);
+}
+
 void SPIOutputPort::RunFullDiscovery(RDMDiscoveryCallback *callback) {
   return m_spi_output.RunFullDiscovery(callback);
 }
@@ -92,6 +102,26 @@ void SPIOutputPort::SendRDMRequest(ola::rdm::RDMRequest *request,
                                    ola::rdm::RDMCallback *callback) {
   return m_spi_output.SendRDMRequest(request, callback);
 }
+
+
+SPISegmentPort::SPISegmentPort(SPIDevice *parent, unsigned int port_id,
+                               SPIOutputPort *output_port,
+                               unsigned int segment)
+    : BasicOutputPort(parent, port_id),
+      m_output_port(output_port),
+      m_segment(segment) {
+}
+
+string SPISegmentPort::Description() const {
+  std::ostringstream str;
+  str << "Output " << m_output_port->PortId() << ", universe "
+      << m_segment + 1 << " of " << m_output_port->UniverseCount();
+  return str.str();
+}
+
+bool SPISegmentPort::WriteDMX(const DmxBuffer &buffer, uint8_t) {
+  return m_output_port->WriteSegment(m_segment, buffer);
+}
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
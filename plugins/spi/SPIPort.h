@@ -44,9 +44,11 @@ class SPIOutputPort: public BasicOutputPort {
   uint16_t GetStartAddress() const;
   bool SetStartAddress(uint16_t start_address);
   unsigned int PixelCount() const;
+  unsigned int UniverseCount() const;
 
   std::string Description() const;
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+  bool WriteSegment(unsigned int segment, const DmxBuffer &buffer);
 
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
@@ -56,6 +58,25 @@ class SPIOutputPort: public BasicOutputPort {
  private:
   SPIOutput m_spi_output;
 };
+
+
+/**
+ * @brief Provides one of the additional universes for a SPIOutputPort whose
+ *   strip spans more than one universe.
+ */
+class SPISegmentPort: public BasicOutputPort {
+ public:
+  SPISegmentPort(SPIDevice *parent, unsigned int port_id,
+                 SPIOutputPort *output_port, unsigned int segment);
+  ~SPISegmentPort() {}
+
+  std::string Description() const;
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+
+ private:
+  SPIOutputPort *m_output_port;
+  const unsigned int m_segment;
+};
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
@@ -29,6 +29,7 @@
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 #include "ola/io/IOUtils.h"
 #include "ola/Logging.h"
 #include "ola/network/SocketCloser.h"
@@ -40,6 +41,11 @@ namespace spi {
 
 using ola::thread::MutexLocker;
 using std::string;
+using std::vector;
+
+// SPI_IOC_MESSAGE() encodes the size of the transfer array in 14 bits.
+const unsigned int SPIWriter::MAX_TRANSFERS =
+    ((1 << _IOC_SIZEBITS) - 1) / sizeof(struct spi_ioc_transfer);
 
 const uint8_t SPIWriter::SPI_BITS_PER_WORD = 8;
 const uint8_t SPIWriter::SPI_MODE = 0;
@@ -104,17 +110,58 @@ bool SPIWriter::Init() {
   return true;
 }
 
+bool SPIWriterInterface::WriteSPISegments(const SPISegment *segments,
+                                          unsigned int count) {
+  if (count == 1) {
+    return WriteSPIData(segments[0].data, segments[0].length);
+  }
+
+  vector<uint8_t> data;
+  for (unsigned int i = 0; i < count; i++) {
+    data.insert(data.end(), segments[i].data,
+                segments[i].data + segments[i].length);
+  }
+  return WriteSPIData(data.empty() ? NULL : &data[0], data.size());
+}
+
 bool SPIWriter::WriteSPIData(const uint8_t *data, unsigned int length) {
-  struct spi_ioc_transfer spi;
-  memset(&spi, 0, sizeof(spi));
-  spi.tx_buf = reinterpret_cast<__u64>(data);
-  spi.len = length;
+  SPISegment segment = {data, length};
+  return WriteSPISegments(&segment, 1);
+}
+
+bool SPIWriter::WriteSPISegments(const SPISegment *segments,
+                                 unsigned int count) {
+  vector<struct spi_ioc_transfer> transfers;
+  transfers.reserve(count);
+  unsigned int length = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    if (!segments[i].length) {
+      continue;
+    }
+    struct spi_ioc_transfer spi;
+    memset(&spi, 0, sizeof(spi));
+    spi.tx_buf = reinterpret_cast<__u64>(segments[i].data);
+    spi.len = segments[i].length;
+    transfers.push_back(spi);
+    length += segments[i].length;
+  }
+
+  if (transfers.empty()) {
+    return true;
+  }
 
   if (m_write_map_var) {
     (*m_write_map_var)[m_device_path]++;
   }
 
-  int bytes_written = ioctl(m_fd, SPI_IOC_MESSAGE(1), &spi);
+  int bytes_written = -1;
+  if (transfers.size() <= MAX_TRANSFERS) {
+    bytes_written = ioctl(m_fd, SPI_IOC_MESSAGE(transfers.size()),
+                          &transfers[0]);
+  } else {
+    errno = EMSGSIZE;
+  }
+
   if (bytes_written != static_cast<int>(length)) {
     OLA_WARN << "Failed to write all the SPI data: " << strerror(errno);
     if (m_error_map_var) {
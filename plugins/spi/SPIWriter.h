@@ -30,6 +30,14 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+/**
+ * A block of data which forms part of a single SPI message.
+ */
+struct SPISegment {
+  const uint8_t *data;
+  unsigned int length;
+};
+
 /**
  * The interface for the SPI Writer
  */
@@ -40,6 +48,18 @@ class SPIWriterInterface {
   virtual std::string DevicePath() const = 0;
   virtual bool Init() = 0;
   virtual bool WriteSPIData(const uint8_t *data, unsigned int length) = 0;
+
+  /**
+   * @brief Write a number of segments as a single SPI message.
+   *
+   * The default implementation joins the segments and calls WriteSPIData(),
+   * writers which can do better should override this.
+   * @param segments the segments to write.
+   * @param count the number of segments.
+   * @returns true if all the data was written.
+   */
+  virtual bool WriteSPISegments(const SPISegment *segments,
+                                unsigned int count);
 };
 
 /**
@@ -71,6 +91,12 @@ class SPIWriter : public SPIWriterInterface {
 
   bool WriteSPIData(const uint8_t *data, unsigned int length);
 
+  /**
+   * Write the segments with a single SPI_IOC_MESSAGE ioctl, so the driver
+   * clocks them out back to back in one message.
+   */
+  bool WriteSPISegments(const SPISegment *segments, unsigned int count);
+
  private:
   const std::string m_device_path;
   const uint32_t m_spi_speed;
@@ -79,6 +105,7 @@ class SPIWriter : public SPIWriterInterface {
   UIntMap *m_error_map_var;
   UIntMap *m_write_map_var;
 
+  static const unsigned int MAX_TRANSFERS;
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
   static const char SPI_DEVICE_KEY[];
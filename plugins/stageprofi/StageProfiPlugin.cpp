@@ -31,6 +31,7 @@
 #include "ola/network/IPV4Address.h"
 #include "ola/network/TCPSocket.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/stageprofi/StageProfiDetector.h"
 #include "plugins/stageprofi/StageProfiDevice.h"
 #include "plugins/stageprofi/StageProfiPluginDescription.h"
@@ -156,3 +157,5 @@ void StageProfiPlugin::DeleteDevice(StageProfiDevice *device) {
 }  // namespace stageprofi
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::stageprofi::StageProfiPlugin)
@@ -59,7 +59,8 @@ StageProfiWidget::StageProfiWidget(io::SelectServerInterface *ss,
       m_widget_path(widget_path),
       m_disconnect_cb(disconnect_cb),
       m_timeout_id(INVALID_TIMEOUT),
-      m_got_response(false) {
+      m_got_response(false),
+      m_frames_since_full(FULL_FRAME_INTERVAL) {
   m_descriptor->SetOnData(
       NewCallback<StageProfiWidget>(this, &StageProfiWidget::SocketReady));
   m_ss->AddReadDescriptor(m_descriptor.get());
@@ -88,16 +89,47 @@ bool StageProfiWidget::SendDmx(const DmxBuffer &buffer) {
     return false;
   }
 
-  uint16_t index = 0;
-  while (index < buffer.Size()) {
-    unsigned int size = std::min((unsigned int) DMX_MSG_LEN,
-                                 buffer.Size() - index);
-    bool ok = Send255(index, buffer.GetRaw() + index, size);
-    if (!ok) {
-      OLA_INFO << "Failed to send StageProfi message, closing socket";
-      RunDisconnectHandler();
+  const bool full_frame = m_frames_since_full >= FULL_FRAME_INTERVAL;
+  m_frames_since_full = full_frame ? 0 : m_frames_since_full + 1;
+
+  const uint8_t *data = buffer.GetRaw();
+  const unsigned int size = buffer.Size();
+  const uint8_t *last = m_last_frame.GetRaw();
+  const unsigned int last_size = full_frame ? 0 : m_last_frame.Size();
+
+  unsigned int offset = 0;
+  unsigned int index = 0;
+  while (index < size) {
+    if (index < last_size && data[index] == last[index]) {
+      index++;
+      continue;
     }
-    index += size;
+
+    // Extend the message over the following changes. A run of unchanged
+    // slots shorter than a header is cheaper to resend than to skip.
+    unsigned int end = index + 1;
+    for (unsigned int i = end;
+         i < size && i - index < DMX_MSG_LEN &&
+         i - end < DMX_HEADER_SIZE;
+         i++) {
+      if (i >= last_size || data[i] != last[i]) {
+        end = i + 1;
+      }
+    }
+    offset = AddMessage(offset, index, data + index, end - index);
+    index = end;
+  }
+  m_last_frame.Set(buffer);
+
+  if (!offset) {
+    return true;
+  }
+
+  // This needs to be an int, as m_descriptor->Send() below returns an int
+  const int bytes_to_send = offset;
+  if (m_descriptor->Send(m_output, bytes_to_send) != bytes_to_send) {
+    OLA_INFO << "Failed to send StageProfi message, closing socket";
+    RunDisconnectHandler();
   }
   return true;
 }
@@ -128,25 +160,25 @@ void StageProfiWidget::DiscoveryTimeout() {
 }
 
 /*
- * @brief Send 255 channels worth of data
+ * @brief Add a message with up to 255 channels worth of data to m_output
+ * @param offset the offset in m_output to add the message at
  * @param start the start channel for the data
  * @param buf a pointer to the data
- * @param len the length of the data
+ * @param length the length of the data
+ * @returns the offset after the message
  */
-bool StageProfiWidget::Send255(uint16_t start,
-                               const uint8_t *buf,
-                               unsigned int length) const {
-  uint8_t msg[DMX_MSG_LEN + DMX_HEADER_SIZE];
+unsigned int StageProfiWidget::AddMessage(unsigned int offset,
+                                          uint16_t start,
+                                          const uint8_t *buf,
+                                          unsigned int length) {
+  uint8_t *msg = m_output + offset;
   unsigned int len = std::min((unsigned int) DMX_MSG_LEN, length);
 
   msg[0] = ID_SETDMX;
   ola::utils::SplitUInt16(start, &msg[2], &msg[1]);
   msg[3] = len;
   memcpy(msg + DMX_HEADER_SIZE, buf, len);
-
-  // This needs to be an int, as m_descriptor->Send() below returns an int
-  const int bytes_to_send = len + DMX_HEADER_SIZE;
-  return m_descriptor->Send(msg, bytes_to_send) == bytes_to_send;
+  return offset + len + DMX_HEADER_SIZE;
 }
 
 void StageProfiWidget::SendQueryPacket() {
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include <string>
+#include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Callback.h"
 #include "ola/io/Descriptor.h"
@@ -61,11 +62,23 @@ class StageProfiWidget {
    */
   std::string GetPath() const { return m_widget_path; }
 
+  /**
+   * @brief Send DMX data to the widget.
+   * @param buffer the DMX data.
+   * @returns true if the data was sent.
+   *
+   * Only the slots that changed since the last frame are sent, with a full
+   * frame every FULL_FRAME_INTERVAL frames in case a change was lost. The
+   * messages for a frame are written with a single Send().
+   */
   bool SendDmx(const DmxBuffer &buffer);
 
  private:
   enum { DMX_MSG_LEN = 255 };
   enum { DMX_HEADER_SIZE = 4};
+  enum { FULL_FRAME_INTERVAL = 40 };
+  // Enough for a message per changed slot, the worst case.
+  enum { OUTPUT_SIZE = DMX_UNIVERSE_SIZE * (DMX_HEADER_SIZE + 1) };
 
   ola::io::SelectServerInterface *m_ss;
   std::auto_ptr<ola::io::ConnectedDescriptor> m_descriptor;
@@ -73,10 +86,14 @@ class StageProfiWidget {
   DisconnectCallback *m_disconnect_cb;
   ola::thread::timeout_id m_timeout_id;
   bool m_got_response;
+  DmxBuffer m_last_frame;
+  unsigned int m_frames_since_full;
+  uint8_t m_output[OUTPUT_SIZE];
 
   void SocketReady();
   void DiscoveryTimeout();
-  bool Send255(uint16_t start, const uint8_t *buf, unsigned int len) const;
+  unsigned int AddMessage(unsigned int offset, uint16_t start,
+                          const uint8_t *buf, unsigned int len);
   void SendQueryPacket();
   void RunDisconnectHandler();
 };
@@ -34,6 +34,7 @@ using std::string;
 
 const char UartDmxDevice::K_MALF[] = "-malf";
 const char UartDmxDevice::K_BREAK[] = "-break";
+const char UartDmxDevice::K_REALTIME[] = "-realtime";
 const unsigned int UartDmxDevice::DEFAULT_BREAK = 100;
 const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
 
@@ -41,11 +42,15 @@ const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
 UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
                              class Preferences *preferences,
                              const string &name,
-                             const string &path)
+                             const string &path,
+                             ExportMap *export_map,
+                             ola::dmx::DmxOutputMultiplexer *multiplexer)
     : Device(owner, name),
       m_preferences(preferences),
       m_name(name),
-      m_path(path) {
+      m_path(path),
+      m_export_map(export_map),
+      m_multiplexer(multiplexer) {
   // set up some per-device default configuration if not already set
   SetDefaults();
   // now read per-device configuration
@@ -57,6 +62,7 @@ UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
   if (!StringToInt(m_preferences->GetValue(DeviceMalfKey()), &m_malft)) {
     m_malft = DEFAULT_MALF;
   }
+  m_realtime = m_preferences->GetValueAsBool(DeviceRealtimeKey());
   m_widget.reset(new UartWidget(path));
 }
 
@@ -67,7 +73,8 @@ UartDmxDevice::~UartDmxDevice() {
 }
 
 bool UartDmxDevice::StartHook() {
-  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft));
+  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft,
+                                m_realtime, m_export_map, m_multiplexer));
   return true;
 }
 
@@ -77,6 +84,9 @@ string UartDmxDevice::DeviceMalfKey() const {
 string UartDmxDevice::DeviceBreakKey() const {
   return m_path + K_BREAK;
 }
+string UartDmxDevice::DeviceRealtimeKey() const {
+  return m_path + K_REALTIME;
+}
 
 /**
  * Set the default preferences for this one Device
@@ -94,6 +104,9 @@ void UartDmxDevice::SetDefaults() {
   save |= m_preferences->SetDefaultValue(DeviceMalfKey(),
                                          UIntValidator(8, 1000000),
                                          DEFAULT_MALF);
+  save |= m_preferences->SetDefaultValue(DeviceRealtimeKey(),
+                                         BoolValidator(),
+                                         false);
   if (save) {
     m_preferences->Save();
   }
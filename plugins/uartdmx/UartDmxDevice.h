@@ -26,6 +26,8 @@
 #include <sstream>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartWidget.h"
@@ -39,7 +41,9 @@ class UartDmxDevice : public Device {
   UartDmxDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
                 const std::string &name,
-                const std::string &path);
+                const std::string &path,
+                ExportMap *export_map,
+                ola::dmx::DmxOutputMultiplexer *multiplexer = NULL);
   ~UartDmxDevice();
 
   std::string DeviceId() const { return m_path; }
@@ -52,6 +56,7 @@ class UartDmxDevice : public Device {
   // Per device options
   std::string DeviceBreakKey() const;
   std::string DeviceMalfKey() const;
+  std::string DeviceRealtimeKey() const;
   void SetDefaults();
 
   std::auto_ptr<UartWidget> m_widget;
@@ -60,11 +65,15 @@ class UartDmxDevice : public Device {
   const std::string m_path;
   unsigned int m_breakt;
   unsigned int m_malft;
+  bool m_realtime;
+  ExportMap *m_export_map;
+  ola::dmx::DmxOutputMultiplexer *m_multiplexer;
 
   static const unsigned int DEFAULT_MALF;
   static const char K_MALF[];
   static const unsigned int DEFAULT_BREAK;
   static const char K_BREAK[];
+  static const char K_REALTIME[];
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxDevice);
 };
@@ -22,6 +22,7 @@
 #include <fcntl.h>
 #include <errno.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "ola/io/IOUtils.h"
 #include "olad/Preferences.h"
 #include "olad/PluginAdaptor.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/uartdmx/UartDmxPlugin.h"
 #include "plugins/uartdmx/UartDmxPluginDescription.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
@@ -46,6 +48,9 @@ const char UartDmxPlugin::PLUGIN_NAME[] = "UART native DMX";
 const char UartDmxPlugin::PLUGIN_PREFIX[] = "uartdmx";
 const char UartDmxPlugin::K_DEVICE[] = "device";
 const char UartDmxPlugin::DEFAULT_DEVICE[] = "/dev/ttyACM0";
+const char UartDmxPlugin::K_REALTIME[] = "realtime";
+const char UartDmxPlugin::K_THREADS[] = "threads";
+const unsigned int UartDmxPlugin::MAX_THREADS;
 
 /*
  * Start the plug-in, using only the configured device(s) (we cannot sensibly
@@ -54,6 +59,25 @@ const char UartDmxPlugin::DEFAULT_DEVICE[] = "/dev/ttyACM0";
 bool UartDmxPlugin::StartHook() {
   vector<string> devices = m_preferences->GetMultipleValue(K_DEVICE);
   vector<string>::const_iterator iter;  // iterate over devices
+  ExportMap *export_map = m_plugin_adaptor->GetExportMap();
+
+  // If threads is set, the devices are shared between that many threads
+  // rather than each one getting its own.
+  unsigned int threads = std::min(
+      StringToIntOrDefault(m_preferences->GetValue(K_THREADS),
+                           DEFAULT_THREADS),
+      MAX_THREADS);
+  bool realtime = m_preferences->GetValueAsBool(K_REALTIME);
+  for (unsigned int i = 0; i < threads; i++) {
+    ola::dmx::DmxOutputMultiplexer *multiplexer =
+        new ola::dmx::DmxOutputMultiplexer(realtime, export_map);
+    if (multiplexer->Start()) {
+      m_multiplexers.push_back(multiplexer);
+    } else {
+      OLA_WARN << "Failed to start UART output thread";
+      delete multiplexer;
+    }
+  }
 
   // start counting device ids from 0
 
@@ -74,8 +98,10 @@ bool UartDmxPlugin::StartHook() {
 
     // can open device, so shut the temporary file descriptor
     close(fd);
+    ola::dmx::DmxOutputMultiplexer *multiplexer = m_multiplexers.empty() ?
+        NULL : m_multiplexers[m_devices.size() % m_multiplexers.size()];
     std::auto_ptr<UartDmxDevice> device(new UartDmxDevice(
-        this, m_preferences, PLUGIN_NAME, *iter));
+        this, m_preferences, PLUGIN_NAME, *iter, export_map, multiplexer));
 
     // got a device, now lets see if we can configure it before we announce
     // it to the world
@@ -108,6 +134,13 @@ bool UartDmxPlugin::StopHook() {
     delete *iter;
   }
   m_devices.clear();
+
+  // The ports have been removed, so the threads can be stopped.
+  MultiplexerVector::iterator multiplexer_iter = m_multiplexers.begin();
+  for (; multiplexer_iter != m_multiplexers.end(); ++multiplexer_iter) {
+    delete *multiplexer_iter;
+  }
+  m_multiplexers.clear();
   return true;
 }
 
@@ -131,6 +164,10 @@ bool UartDmxPlugin::SetDefaultPreferences() {
   // only insert default device name, no others at this stage
   bool save = m_preferences->SetDefaultValue(K_DEVICE, StringValidator(),
                                              DEFAULT_DEVICE);
+  save |= m_preferences->SetDefaultValue(K_REALTIME, BoolValidator(), false);
+  save |= m_preferences->SetDefaultValue(K_THREADS,
+                                         UIntValidator(0, MAX_THREADS),
+                                         DEFAULT_THREADS);
   if (save) {
     m_preferences->Save();
   }
@@ -144,3 +181,5 @@ bool UartDmxPlugin::SetDefaultPreferences() {
 }  // namespace uartdmx
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::uartdmx::UartDmxPlugin)
@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include "ola/dmx/DmxOutputMultiplexer.h"
 #include "olad/Plugin.h"
 #include "ola/plugin_id.h"
 
@@ -51,7 +52,9 @@ class UartDmxPlugin : public Plugin {
 
  private:
   typedef std::vector<UartDmxDevice*> UartDeviceVector;
+  typedef std::vector<ola::dmx::DmxOutputMultiplexer*> MultiplexerVector;
   UartDeviceVector m_devices;
+  MultiplexerVector m_multiplexers;
 
   void AddDevice(UartDmxDevice *device);
   bool StartHook();
@@ -64,6 +67,10 @@ class UartDmxPlugin : public Plugin {
   static const char PLUGIN_PREFIX[];
   static const char K_DEVICE[];
   static const char DEFAULT_DEVICE[];
+  static const char K_REALTIME[];
+  static const char K_THREADS[];
+  static const unsigned int DEFAULT_THREADS = 0;
+  static const unsigned int MAX_THREADS = 16;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxPlugin);
 };
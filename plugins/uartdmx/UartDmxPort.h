@@ -22,9 +22,12 @@
 #ifndef PLUGINS_UARTDMX_UARTDMXPORT_H_
 #define PLUGINS_UARTDMX_UARTDMXPORT_H_
 
+#include <memory>
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/DmxOutputMultiplexer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
@@ -37,27 +40,51 @@ namespace uartdmx {
 
 class UartDmxOutputPort : public ola::BasicOutputPort {
  public:
+  /*
+   * If a multiplexer is provided, the port is driven by the multiplexer's
+   * thread, otherwise it gets a thread of its own.
+   */
   UartDmxOutputPort(UartDmxDevice *parent,
                     unsigned int id,
                     UartWidget *widget,
                     unsigned int breakt,
-                    unsigned int malft)
+                    unsigned int malft,
+                    bool realtime,
+                    ExportMap *export_map,
+                    ola::dmx::DmxOutputMultiplexer *multiplexer)
       : BasicOutputPort(parent, id),
         m_widget(widget),
-        m_thread(widget, breakt, malft) {
-    m_thread.Start();
+        m_multiplexer(multiplexer) {
+    if (m_multiplexer) {
+      ola::dmx::DmxOutputMultiplexer::Timing timing;
+      timing.break_time = breakt;
+      timing.mark_after_frame = malft;
+      m_multiplexer->AddOutput(widget, timing);
+    } else {
+      m_thread.reset(
+          new UartDmxThread(widget, breakt, malft, realtime, export_map));
+      m_thread->Start();
+    }
+  }
+  ~UartDmxOutputPort() {
+    if (m_multiplexer) {
+      m_multiplexer->RemoveOutput(m_widget);
+    }
   }
-  ~UartDmxOutputPort() { m_thread.Stop(); }
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-    return m_thread.WriteDMX(buffer);
+    if (m_multiplexer) {
+      return m_multiplexer->WriteDMX(m_widget, buffer);
+    }
+    return m_thread->WriteDMX(buffer);
   }
 
   std::string Description() const { return m_widget->Description(); }
 
  private:
   UartWidget *m_widget;
-  UartDmxThread m_thread;
+  ola::dmx::DmxOutputMultiplexer *m_multiplexer;
+  std::auto_ptr<UartDmxThread> m_thread;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxOutputPort);
 };
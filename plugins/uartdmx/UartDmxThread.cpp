@@ -19,7 +19,6 @@
  * Copyright (C) 2014 Richard Ash
  */
 
-#include <math.h>
 #include <unistd.h>
 #include <string>
 #include "ola/Clock.h"
@@ -33,12 +32,16 @@ namespace plugin {
 namespace uartdmx {
 
 UartDmxThread::UartDmxThread(UartWidget *widget, unsigned int breakt,
-                             unsigned int malft)
-  : m_granularity(UNKNOWN),
+                             unsigned int malft, bool realtime,
+                             ExportMap *export_map)
+  : ola::thread::Thread(ola::thread::Thread::Options("uart-dmx")),
+    m_granularity(UNKNOWN),
     m_widget(widget),
     m_term(false),
     m_breakt(breakt),
-    m_malft(malft) {
+    m_malft(malft),
+    m_realtime(realtime),
+    m_timer(0, export_map, widget->Description()) {
 }
 
 UartDmxThread::~UartDmxThread() {
@@ -62,8 +65,12 @@ bool UartDmxThread::Stop() {
  * Copy a DMXBuffer to the output thread
  */
 bool UartDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  ola::thread::MutexLocker locker(&m_buffer_mutex);
-  m_buffer.Set(buffer);
+  // The output thread doesn't see the slot until it's published.
+  DmxBuffer *frame = m_frame.WriteSlot();
+  if (!frame->Set(buffer)) {
+    frame->Reset();
+  }
+  m_frame.Publish();
   return true;
 }
 
@@ -72,10 +79,12 @@ bool UartDmxThread::WriteDMX(const DmxBuffer &buffer) {
  * The method called by the thread
  */
 void *UartDmxThread::Run() {
-  TimeStamp ts1, ts2;
-  Clock clock;
   CheckTimeGranularity();
-  DmxBuffer buffer;
+
+  if (m_realtime && !ola::dmx::FrameTimer::UseRealtimeScheduling()) {
+    OLA_WARN << "Failed to enable real time scheduling for "
+             << m_widget->Description();
+  }
 
   // Setup the widget
   if (!m_widget->IsOpen())
@@ -88,29 +97,29 @@ void *UartDmxThread::Run() {
         break;
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    m_frame.Fetch();
+    const DmxBuffer &buffer = *m_frame.ReadSlot();
+
+    m_timer.StartFrame();
 
     if (!m_widget->SetBreak(true))
       goto framesleep;
 
     if (m_granularity == GOOD)
-      usleep(m_breakt);
+      m_timer.Delay(m_breakt);
 
     if (!m_widget->SetBreak(false))
       goto framesleep;
 
     if (m_granularity == GOOD)
-      usleep(DMX_MAB);
+      m_timer.Delay(DMX_MAB);
 
     if (!m_widget->Write(buffer))
       goto framesleep;
 
   framesleep:
     // Sleep for the remainder of the DMX frame time
-    usleep(m_malft);
+    m_timer.WaitForNextFrame(m_malft);
   }
   return NULL;
 }
@@ -23,7 +23,10 @@
 #define PLUGINS_UARTDMX_UARTDMXTHREAD_H_
 
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameTimer.h"
 #include "ola/thread/Thread.h"
+#include "ola/thread/TripleBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -31,7 +34,8 @@ namespace uartdmx {
 
 class UartDmxThread : public ola::thread::Thread {
  public:
-  UartDmxThread(UartWidget *widget, unsigned int breakt, unsigned int malft);
+  UartDmxThread(UartWidget *widget, unsigned int breakt, unsigned int malft,
+                bool realtime = false, ExportMap *export_map = NULL);
   ~UartDmxThread();
 
   bool Stop();
@@ -46,9 +50,10 @@ class UartDmxThread : public ola::thread::Thread {
   bool m_term;
   unsigned int m_breakt;
   unsigned int m_malft;
-  DmxBuffer m_buffer;
+  const bool m_realtime;
+  ola::dmx::FrameTimer m_timer;
+  ola::thread::TripleBuffer<DmxBuffer> m_frame;
   ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
 
   void CheckTimeGranularity();
 
@@ -116,6 +116,7 @@ bool AsyncPluginImpl::Start() {
   }
 
   m_usb_adaptor = agent->GetUSBAdaptor();
+  m_usb_adaptor->SetExportMap(m_plugin_adaptor->GetExportMap());
 
   // Setup the factories.
   m_widget_factories.push_back(new AnymauDMXFactory(m_usb_adaptor));
@@ -129,7 +130,7 @@ bool AsyncPluginImpl::Start() {
   m_widget_factories.push_back(
       new JaRuleFactory(m_plugin_adaptor, m_usb_adaptor));
   m_widget_factories.push_back(
-      new ScanlimeFadecandyFactory(m_usb_adaptor));
+      new ScanlimeFadecandyFactory(m_usb_adaptor, m_preferences));
   m_widget_factories.push_back(new SunliteFactory(m_usb_adaptor));
   m_widget_factories.push_back(new VellemanK8062Factory(m_usb_adaptor));
 
@@ -249,9 +250,8 @@ void AsyncPluginImpl::DeviceEvent(HotplugAgent::EventType event,
       return;
     }
 
-    // At some point we'll need to notify the factory here. For instance in the
-    // Sunlite plugin, if we make the f/w load async we'll need to let the
-    // factory cancel the load.
+    // If a Sunlite firmware load is in progress, the next transfer fails and
+    // the load stops, so the factory doesn't need to be told.
 
     // Unregister & delete the device in the main thread.
     if (state->ola_device) {
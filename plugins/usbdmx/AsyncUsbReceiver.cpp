@@ -30,8 +30,8 @@ AsyncUsbReceiver::AsyncUsbReceiver(ola::usb::LibUsbAdaptor *adaptor,
                                    libusb_device *usb_device,
                                    PluginAdaptor *plugin_adaptor)
     : AsyncUsbTransceiverBase(adaptor, usb_device),
-      m_plugin_adaptor(plugin_adaptor),
-      m_inited_with_handle(false) {
+      m_inited_with_handle(false),
+      m_mailbox(plugin_adaptor) {
 }
 
 AsyncUsbReceiver::~AsyncUsbReceiver() {
@@ -74,6 +74,8 @@ void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
   }
 
   ola::thread::MutexLocker locker(&m_mutex);
+  // The time spent waiting for data isn't useful as a latency.
+  TransferDone(transfer, false);
   m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
       DISCONNECTED : IDLE);
 
@@ -83,10 +85,7 @@ void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
 
   if (transfer->status != LIBUSB_TRANSFER_TIMED_OUT) {
     if (TransferCompleted(&m_rx_buffer, transfer->actual_length)) {
-      // Input changed
-      if (m_receive_callback.get()) {
-        m_plugin_adaptor->Execute(m_receive_callback.get());
-      }
+      m_mailbox.Update(&m_rx_buffer);
     }
   }
 
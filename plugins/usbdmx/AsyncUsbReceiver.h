@@ -31,6 +31,7 @@
 #include "ola/base/Macro.h"
 #include "ola/thread/Mutex.h"
 #include "olad/PluginAdaptor.h"
+#include "plugins/usbdmx/DmxInputMailbox.h"
 
 namespace ola {
 namespace plugin {
@@ -42,6 +43,9 @@ namespace usbdmx {
  *
  * This encapsulates much of the asynchronous libusb logic. Subclasses should
  * implement the SetupHandle() and PerformTransfer() methods.
+ *
+ * Received frames are passed to the main thread with a DmxInputMailbox, so
+ * unchanged frames don't wake the main loop.
  */
 class AsyncUsbReceiver: public AsyncUsbTransceiverBase {
  public:
@@ -84,16 +88,17 @@ class AsyncUsbReceiver: public AsyncUsbTransceiverBase {
    * @param callback The callback to call.
    */
   void SetReceiveCallback(Callback0<void> *callback) {
-    m_receive_callback.reset(callback);
+    m_mailbox.SetCallback(callback);
   }
 
   /**
    * @brief Get DMX Buffer
-   * @param buffer DmxBuffer that will get updated with the current input.
+   * @returns DmxBuffer with current input values.
+   *
+   * This must only be called from the main thread.
    */
-  void GetDmx(DmxBuffer *buffer) {
-    ola::thread::MutexLocker locker(&m_mutex);
-    buffer->Set(m_rx_buffer);
+  const DmxBuffer &GetDmxInBuffer() const {
+    return m_mailbox.Get();
   }
 
   /**
@@ -118,16 +123,16 @@ class AsyncUsbReceiver: public AsyncUsbTransceiverBase {
    * @brief Called when the transfer completes.
    * @param buffer the DmxBuffer to receive into
    * @param transferred_size the number of bytes actually transferred
-   * returns true if the buffer was updated
+   * returns true if the buffer was updated. Data which matches the buffer
+   *   isn't passed on, so this can return true for every transfer.
    */
   virtual bool TransferCompleted(DmxBuffer *buffer, int transferred_size) = 0;
 
  private:
-  PluginAdaptor* const m_plugin_adaptor;
   bool m_inited_with_handle;
 
   DmxBuffer m_rx_buffer;  // GUARDED_BY(m_mutex);
-  std::auto_ptr<Callback0<void> > m_receive_callback;
+  DmxInputMailbox m_mailbox;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbReceiver);
 };
@@ -30,8 +30,9 @@ namespace usbdmx {
 using ola::usb::LibUsbAdaptor;
 
 AsyncUsbSender::AsyncUsbSender(LibUsbAdaptor *adaptor,
-                               libusb_device *usb_device)
-    : AsyncUsbTransceiverBase(adaptor, usb_device),
+                               libusb_device *usb_device,
+                               unsigned int max_transfers)
+    : AsyncUsbTransceiverBase(adaptor, usb_device, max_transfers),
       m_pending_tx(false) {
 }
 
@@ -45,7 +46,8 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
     return false;
   }
   ola::thread::MutexLocker locker(&m_mutex);
-  if (m_transfer_state == IDLE) {
+  if (CanStartTransfer()) {
+    m_adaptor->RecordFrame(m_usb_device);
     PerformTransfer(buffer);
   } else {
     // Buffer incoming data so we can send it when the outstanding transfers
@@ -57,20 +59,20 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
 }
 
 void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
-  if (transfer != m_transfer) {
-    OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
-             << m_transfer;
-    return;
-  }
-
   if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
     OLA_WARN << "Transfer returned "
              << m_adaptor->ErrorCodeToString(transfer->status);
   }
 
   ola::thread::MutexLocker locker(&m_mutex);
-  m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
-      DISCONNECTED : IDLE);
+  if (!TransferDone(transfer)) {
+    return;
+  }
+  if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+    m_transfer_state = DISCONNECTED;
+  } else if (m_transfer_state != DISCONNECTED) {
+    m_transfer_state = TransfersInFlight() ? IN_PROGRESS : IDLE;
+  }
 
   if (m_suppress_continuation) {
     return;
@@ -78,11 +80,16 @@ void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
 
   PostTransferHook();
 
-  if ((m_transfer_state == IDLE) && m_pending_tx) {
+  if (m_pending_tx && CanStartTransfer()) {
     m_pending_tx = false;
+    m_adaptor->RecordFrame(m_usb_device);
     PerformTransfer(m_tx_buffer);
   }
 }
+
+bool AsyncUsbSender::CanStartTransfer() {
+  return m_transfer_state != DISCONNECTED && SelectFreeTransfer();
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
@@ -38,6 +38,12 @@ namespace usbdmx {
  *
  * This encapsulates much of the asynchronous libusb logic. Subclasses should
  * implement the SetupHandle() and PerformTransfer() methods.
+ *
+ * Subclasses that send each frame in a single transfer can allow more than one
+ * transfer in flight, so the next frame doesn't have to wait for the previous
+ * one to complete. Each in-flight frame needs its own buffer, see
+ * CurrentTransfer(). Once all transfers are in flight, only the latest frame
+ * is kept.
  */
 class AsyncUsbSender: public AsyncUsbTransceiverBase {
  public:
@@ -45,9 +51,11 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbSender.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_transfers the number of transfers that may be in flight.
    */
   AsyncUsbSender(ola::usb::LibUsbAdaptor* const adaptor,
-                 libusb_device *usb_device);
+                 libusb_device *usb_device,
+                 unsigned int max_transfers = 1);
 
   /**
    * @brief Destructor
@@ -76,7 +84,7 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    *
    * This method is implemented by the subclass. The subclass should call
    * FillControlTransfer() / FillBulkTransfer() as appropriate and then call
-   * SubmitTransfer().
+   * SubmitTransfer(). m_transfer has already been pointed at a free transfer.
    */
   virtual bool PerformTransfer(const DmxBuffer &buffer) = 0;
 
@@ -98,6 +106,8 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
   DmxBuffer m_tx_buffer;  // GUARDED_BY(m_mutex);
   bool m_pending_tx;  // GUARDED_BY(m_mutex);
 
+  bool CanStartTransfer();
+
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbSender);
 };
 }  // namespace usbdmx
@@ -20,8 +20,11 @@
 
 #include "plugins/usbdmx/AsyncUsbTransceiverBase.h"
 
+#include <stdint.h>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
+#include "ola/util/Trace.h"
 
 namespace ola {
 namespace plugin {
@@ -31,6 +34,8 @@ using ola::usb::LibUsbAdaptor;
 
 namespace {
 
+const char TRANSFER_TRACE_NAME[] = "usb.transfer";
+
 /*
  * Called by libusb when the transfer completes.
  */
@@ -38,6 +43,8 @@ namespace {
 __attribute__((__stdcall__))
 #endif  // _WIN32
 void AsyncCallback(struct libusb_transfer *transfer) {
+  ola::TraceAsyncEnd(TRANSFER_TRACE_NAME,
+                     reinterpret_cast<uintptr_t>(transfer));
   AsyncUsbTransceiverBase *widget = reinterpret_cast<AsyncUsbTransceiverBase*>(
     transfer->user_data);
   widget->TransferComplete(transfer);
@@ -45,20 +52,30 @@ void AsyncCallback(struct libusb_transfer *transfer) {
 }  // namespace
 
 AsyncUsbTransceiverBase::AsyncUsbTransceiverBase(LibUsbAdaptor *adaptor,
-                                                 libusb_device *usb_device)
+                                                 libusb_device *usb_device,
+                                                 unsigned int max_transfers)
     : m_adaptor(adaptor),
       m_usb_device(usb_device),
       m_usb_handle(NULL),
       m_suppress_continuation(false),
-      m_transfer_state(IDLE) {
-  m_transfer = m_adaptor->AllocTransfer(0);
+      m_transfer_state(IDLE),
+      m_current(0),
+      m_in_flight(0) {
+  m_slots.resize(max_transfers ? max_transfers : 1);
+  for (unsigned int i = 0; i < m_slots.size(); i++) {
+    m_slots[i].transfer = m_adaptor->AllocTransfer(0);
+    m_slots[i].in_flight = false;
+  }
+  m_transfer = m_slots[0].transfer;
   m_adaptor->RefDevice(usb_device);
 }
 
 AsyncUsbTransceiverBase::~AsyncUsbTransceiverBase() {
   CancelTransfer();
   m_adaptor->UnrefDevice(m_usb_device);
-  m_adaptor->FreeTransfer(m_transfer);
+  for (unsigned int i = 0; i < m_slots.size(); i++) {
+    m_adaptor->FreeTransfer(m_slots[i].transfer);
+  }
 }
 
 bool AsyncUsbTransceiverBase::Init() {
@@ -66,30 +83,74 @@ bool AsyncUsbTransceiverBase::Init() {
   return m_usb_handle != NULL;
 }
 
+bool AsyncUsbTransceiverBase::TransferDone(struct libusb_transfer *transfer,
+                                           bool record_latency) {
+  for (unsigned int i = 0; i < m_slots.size(); i++) {
+    TransferSlot &slot = m_slots[i];
+    if (slot.transfer != transfer) {
+      continue;
+    }
+    if (slot.in_flight) {
+      slot.in_flight = false;
+      m_in_flight--;
+    }
+    if (record_latency) {
+      TimeStamp now;
+      m_clock.CurrentTime(&now);
+      m_adaptor->RecordTransferLatency(m_usb_device, now - slot.submit_time);
+    }
+    return true;
+  }
+  OLA_WARN << "Mismatched libusb transfer: " << transfer;
+  return false;
+}
+
 void AsyncUsbTransceiverBase::CancelTransfer() {
   if (!m_transfer) {
     return;
   }
 
-  bool canceled = false;
+  std::vector<bool> canceled(m_slots.size(), false);
   while (1) {
     ola::thread::MutexLocker locker(&m_mutex);
-    if (m_transfer_state == IDLE || m_transfer_state == DISCONNECTED) {
+    if (m_transfer_state == IDLE ||
+        (m_transfer_state == DISCONNECTED && m_in_flight == 0)) {
       break;
     }
-    if (!canceled) {
-      m_suppress_continuation = true;
-      if (m_adaptor->CancelTransfer(m_transfer) == 0) {
-        canceled = true;
+    m_suppress_continuation = true;
+    bool failed = false;
+    for (unsigned int i = 0; i < m_slots.size(); i++) {
+      if (!m_slots[i].in_flight || canceled[i]) {
+        continue;
+      }
+      if (m_adaptor->CancelTransfer(m_slots[i].transfer) == 0) {
+        canceled[i] = true;
       } else {
-        break;
+        failed = true;
       }
     }
+    if (failed) {
+      break;
+    }
   }
 
   m_suppress_continuation = false;
 }
 
+bool AsyncUsbTransceiverBase::SelectFreeTransfer() {
+  for (unsigned int i = 0; i < m_slots.size(); i++) {
+    // Start from the current transfer, so with a single transfer this is a
+    // no-op.
+    unsigned int index = (m_current + i) % m_slots.size();
+    if (!m_slots[index].in_flight) {
+      m_current = index;
+      m_transfer = m_slots[index].transfer;
+      return true;
+    }
+  }
+  return false;
+}
+
 void AsyncUsbTransceiverBase::FillControlTransfer(unsigned char *buffer,
                                                   unsigned int timeout) {
   m_adaptor->FillControlTransfer(m_transfer, m_usb_handle, buffer,
@@ -113,14 +174,25 @@ void AsyncUsbTransceiverBase::FillInterruptTransfer(unsigned char endpoint,
 }
 
 int AsyncUsbTransceiverBase::SubmitTransfer() {
+  TransferSlot &slot = m_slots[m_current];
+  m_clock.CurrentTime(&slot.submit_time);
+  // The transfer may complete before SubmitTransfer() returns.
+  ola::TraceAsyncBegin(TRANSFER_TRACE_NAME,
+                       reinterpret_cast<uintptr_t>(m_transfer));
   int ret = m_adaptor->SubmitTransfer(m_transfer);
   if (ret) {
+    ola::TraceAsyncEnd(TRANSFER_TRACE_NAME,
+                       reinterpret_cast<uintptr_t>(m_transfer));
     OLA_WARN << "libusb_submit_transfer returned "
              << m_adaptor->ErrorCodeToString(ret);
     if (ret == LIBUSB_ERROR_NO_DEVICE) {
       m_transfer_state = DISCONNECTED;
     }
-    return false;
+    return ret;
+  }
+  if (!slot.in_flight) {
+    slot.in_flight = true;
+    m_in_flight++;
   }
   m_transfer_state = IN_PROGRESS;
   return ret;
@@ -22,8 +22,10 @@
 #define PLUGINS_USBDMX_ASYNCUSBTRANSCEIVERBASE_H_
 
 #include <libusb.h>
+#include <vector>
 
 #include "libs/usb/LibUsbAdaptor.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/Mutex.h"
@@ -35,6 +37,10 @@ namespace usbdmx {
 /**
  * @brief A base class that implements common functionality to send or receive
  * DMX asynchronously to a libusb_device.
+ *
+ * Up to max_transfers transfers can be in flight at once. m_transfer is the
+ * transfer the Fill*Transfer() and SubmitTransfer() methods act on, and
+ * SelectFreeTransfer() points it at one that isn't in flight.
  */
 class AsyncUsbTransceiverBase {
  public:
@@ -42,9 +48,11 @@ class AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbTransceiverBase.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_transfers the number of transfers that may be in flight.
    */
   AsyncUsbTransceiverBase(ola::usb::LibUsbAdaptor* const adaptor,
-                          libusb_device *usb_device);
+                          libusb_device *usb_device,
+                          unsigned int max_transfers = 1);
 
   /**
    * @brief Destructor
@@ -101,6 +109,42 @@ class AsyncUsbTransceiverBase {
    */
   void CancelTransfer();
 
+  /**
+   * @brief Mark a completed transfer as free.
+   * @param transfer the completed transfer.
+   * @param record_latency pass the time the transfer took to the
+   *   LibUsbAdaptor.
+   * @returns false if the transfer doesn't belong to this transceiver.
+   *
+   * This must be called with m_mutex held, from TransferComplete().
+   */
+  bool TransferDone(struct libusb_transfer *transfer,
+                    bool record_latency = true);
+
+  /**
+   * @brief Point m_transfer at a transfer that isn't in flight.
+   * @returns false if all the transfers are in flight.
+   */
+  bool SelectFreeTransfer();
+
+  /**
+   * @brief The index of m_transfer, between 0 and MaxTransfers() - 1.
+   *
+   * Subclasses that allow more than one transfer in flight use this to pick a
+   * buffer that isn't in use.
+   */
+  unsigned int CurrentTransfer() const { return m_current; }
+
+  /**
+   * @brief The number of transfers that may be in flight.
+   */
+  unsigned int MaxTransfers() const { return m_slots.size(); }
+
+  /**
+   * @brief The number of transfers in flight.
+   */
+  unsigned int TransfersInFlight() const { return m_in_flight; }
+
   /**
    * @brief Fill a control transfer.
    * @param buffer passed to libusb_fill_control_transfer.
@@ -140,6 +184,17 @@ class AsyncUsbTransceiverBase {
   ola::thread::Mutex m_mutex;
 
  private:
+  struct TransferSlot {
+    struct libusb_transfer *transfer;
+    ola::TimeStamp submit_time;
+    bool in_flight;
+  };
+
+  ola::Clock m_clock;
+  std::vector<TransferSlot> m_slots;  // GUARDED_BY(m_mutex);
+  unsigned int m_current;  // GUARDED_BY(m_mutex);
+  unsigned int m_in_flight;  // GUARDED_BY(m_mutex);
+
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbTransceiverBase);
 };
 }  // namespace usbdmx
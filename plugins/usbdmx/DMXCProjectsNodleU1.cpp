@@ -537,7 +537,7 @@ void AsynchronousDMXCProjectsNodleU1::SetDmxCallback(
 
 const DmxBuffer &AsynchronousDMXCProjectsNodleU1::GetDmxInBuffer() {
   if (m_receiver.get()) {
-    m_receiver->GetDmx(&m_buffer);
+    return m_receiver->GetDmxInBuffer();
   }
   return m_buffer;
 }
@@ -0,0 +1,64 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxInputMailbox.cpp
+ * Passes received DMX frames from a USB thread to the main thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "plugins/usbdmx/DmxInputMailbox.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+const TimeInterval DmxInputMailbox::REFRESH_INTERVAL(1, 0);
+
+DmxInputMailbox::DmxInputMailbox(PluginAdaptor *plugin_adaptor)
+    : m_plugin_adaptor(plugin_adaptor),
+      m_frame_callback(NewCallback(this, &DmxInputMailbox::NewFrame)) {
+}
+
+void DmxInputMailbox::Update(DmxBuffer *buffer) {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  if (!buffer->HasChanges() && m_last_update.IsSet() &&
+      now - m_last_update < REFRESH_INTERVAL) {
+    return;
+  }
+  buffer->ClearChanges();
+  m_last_update = now;
+
+  m_frames.WriteSlot()->Set(*buffer);
+  if (!m_frames.Publish()) {
+    // The main thread has fetched the previous frame, so it needs waking.
+    m_plugin_adaptor->Execute(m_frame_callback.get());
+  }
+}
+
+void DmxInputMailbox::NewFrame() {
+  if (!m_frames.Fetch()) {
+    return;
+  }
+  // The slot goes back to the receiving thread, so it can't be shared with
+  // the input port's DmxSource.
+  m_buffer.Set(*m_frames.ReadSlot());
+  if (m_callback.get()) {
+    m_callback->Run();
+  }
+}
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,103 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxInputMailbox.h
+ * Passes received DMX frames from a USB thread to the main thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_USBDMX_DMXINPUTMAILBOX_H_
+#define PLUGINS_USBDMX_DMXINPUTMAILBOX_H_
+
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/TripleBuffer.h"
+#include "olad/PluginAdaptor.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+/**
+ * @brief Passes the DMX frames received by a USB thread to the main thread.
+ *
+ * The receiving thread calls Update() with its working buffer each time a
+ * transfer completes. Frames that haven't changed are dropped in the
+ * receiving thread, apart from one every REFRESH_INTERVAL so the input
+ * source doesn't time out. Changed frames are copied into one of the
+ * preallocated slots of a TripleBuffer, so there's no lock and no allocation
+ * in the receiving thread.
+ *
+ * The main loop is only woken if it has fetched the previous frame, a burst
+ * of updates costs one wake up and the main thread only sees the latest
+ * frame.
+ */
+class DmxInputMailbox {
+ public:
+  /**
+   * @brief Create a new DmxInputMailbox
+   * @param plugin_adaptor the PluginAdaptor used to run the callback in the
+   *   main thread.
+   */
+  explicit DmxInputMailbox(PluginAdaptor *plugin_adaptor);
+
+  /**
+   * @brief Set the callback run in the main thread when a frame arrives.
+   * @param callback the callback to run, ownership is transferred.
+   */
+  void SetCallback(Callback0<void> *callback) {
+    m_callback.reset(callback);
+  }
+
+  /**
+   * @brief Pass a frame to the main thread, if it has changed.
+   * @param buffer the receiving thread's working buffer. The changes
+   *   recorded in the buffer are cleared.
+   *
+   * This must only be called from the receiving thread.
+   */
+  void Update(DmxBuffer *buffer);
+
+  /**
+   * @brief The latest frame. This must only be called from the main thread.
+   */
+  const DmxBuffer &Get() const { return m_buffer; }
+
+  /**
+   * @brief Unchanged frames are passed on this often, this is less than the
+   *   DmxSource timeout.
+   */
+  static const TimeInterval REFRESH_INTERVAL;
+
+ private:
+  PluginAdaptor* const m_plugin_adaptor;
+  ola::Clock m_clock;
+  ola::thread::TripleBuffer<DmxBuffer> m_frames;
+  TimeStamp m_last_update;  // owned by the receiving thread
+  DmxBuffer m_buffer;  // owned by the main thread
+  std::auto_ptr<Callback0<void> > m_frame_callback;
+  std::auto_ptr<Callback0<void> > m_callback;
+
+  void NewFrame();
+
+  DISALLOW_COPY_AND_ASSIGN(DmxInputMailbox);
+};
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBDMX_DMXINPUTMAILBOX_H_
@@ -33,6 +33,8 @@ plugins_usbdmx_libolausbdmxwidget_la_SOURCES = \
     plugins/usbdmx/DMXCreator512Basic.h \
     plugins/usbdmx/DMXCreator512BasicFactory.cpp \
     plugins/usbdmx/DMXCreator512BasicFactory.h \
+    plugins/usbdmx/DmxInputMailbox.cpp \
+    plugins/usbdmx/DmxInputMailbox.h \
     plugins/usbdmx/EurolitePro.cpp \
     plugins/usbdmx/EurolitePro.h \
     plugins/usbdmx/EuroliteProFactory.cpp \
@@ -22,9 +22,8 @@
 
 #include <string.h>
 #include <unistd.h>
-#include <algorithm>
-#include <limits>
 #include <string>
+#include <vector>
 
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/base/Array.h"
@@ -40,6 +39,7 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+using ola::dmx::OutputCurve;
 using ola::usb::LibUsbAdaptor;
 using std::string;
 
@@ -49,6 +49,7 @@ static const unsigned char ENDPOINT = 0x01;
 // 2s is a really long time. Can we reduce this?
 static const unsigned int URB_TIMEOUT_MS = 2000;
 static const int INTERFACE = 0;
+static const unsigned int CONFIG_PACKETS = 1;
 
 // A data frame.
 static const uint8_t TYPE_FRAMEBUFFER = 0x00;
@@ -71,6 +72,9 @@ static const unsigned int LUT_ROWS_PER_CHANNEL = 257;
 // Each 'packet' is 63 bytes, or 21 RGB pixels.
 enum { SLOTS_PER_PACKET = 63 };
 static const uint8_t PACKETS_PER_UPDATE = 25;
+// The number of packets a universe of DMX data covers.
+static const unsigned int DMX_PACKETS =
+    (DMX_UNIVERSE_SIZE + SLOTS_PER_PACKET - 1) / SLOTS_PER_PACKET;
 // Each LUT 'packet' is 31 LUT rows, 62 bytes, plus a padding byte
 static const uint8_t LUT_ROWS_PER_PACKET = 31;
 // The padding byte offset
@@ -92,45 +96,37 @@ struct fadecandy_packet {
 });
 
 bool InitializeWidget(LibUsbAdaptor *adaptor,
-                      libusb_device_handle *usb_handle) {
-  // Set the fadecandy configuration.
-  fadecandy_packet packet;
-  packet.control = TYPE_CONFIG;
-  packet.data[0] |= OPTION_NO_DITHERING;  // Default to no processing
-  packet.data[0] |= OPTION_NO_INTERPOLATION;
+                      libusb_device_handle *usb_handle,
+                      const FadecandyOptions &options) {
+  const OutputCurve curve(options.curve);
 
-  // packet.data[0] = OPTION_NO_ACTIVITY_LED;  // Manual control of LED
-  // packet.data[0] |= OPTION_LED_CONTROL;  // Manual LED state
+  // The config packet is followed by the color lookup table, we send them all
+  // in a single bulk transfer.
+  fadecandy_packet packets[CONFIG_PACKETS + PACKETS_PER_UPDATE];
 
-  int bytes_sent = 0;
-  int r = adaptor->BulkTransfer(usb_handle, ENDPOINT,
-                                reinterpret_cast<unsigned char*>(&packet),
-                                sizeof(packet), &bytes_sent, URB_TIMEOUT_MS);
-  if (r == 0) {
-    OLA_INFO << "Config transferred " << bytes_sent << " bytes";
-  } else {
-    OLA_WARN << "Config transfer failed with error "
-             << adaptor->ErrorCodeToString(r);
-    return false;
+  // Set the fadecandy configuration.
+  fadecandy_packet *config = &packets[0];
+  config->control = TYPE_CONFIG;
+  if (!options.curve.dither) {
+    config->data[0] |= OPTION_NO_DITHERING;
+  }
+  if (!options.interpolation) {
+    config->data[0] |= OPTION_NO_INTERPOLATION;
   }
 
+  // config->data[0] = OPTION_NO_ACTIVITY_LED;  // Manual control of LED
+  // config->data[0] |= OPTION_LED_CONTROL;  // Manual LED state
+
   // Build the Look Up Table
   uint16_t lut[NUM_CHANNELS * LUT_ROWS_PER_CHANNEL];
   memset(&lut, 0, sizeof(lut));
   for (unsigned int channel = 0; channel < NUM_CHANNELS; channel++) {
     for (unsigned int value = 0; value < LUT_ROWS_PER_CHANNEL; value++) {
-      // Fadecandy Python Example as C++
-      // lut[channel][value] = std::min(
-      //     static_cast<int>(std::numeric_limits<uint16_t>::max()),
-      //     int(pow(value / 256.0, 2.2) *
-      //         (std::numeric_limits<uint16_t>::max() + 1)));
-
-      // 1:1 for now
-      // TODO(Peter): Add support for more built in or custom LUTs
+      // Row N is the output for an input of N / 256, the device
+      // interpolates between the rows.
       unsigned int overall_lut_row = (channel * LUT_ROWS_PER_CHANNEL) + value;
-      lut[overall_lut_row] = std::min(
-          static_cast<unsigned int>(std::numeric_limits<uint16_t>::max()),
-          (value << 8));
+      lut[overall_lut_row] = curve.Evaluate(
+          value / static_cast<double>(LUT_ROWS_PER_CHANNEL - 1));
       OLA_DEBUG << "Generated LUT for channel " << channel << " value "
                 << value << " with val " << lut[overall_lut_row];
     }
@@ -138,12 +134,10 @@ bool InitializeWidget(LibUsbAdaptor *adaptor,
 
   OLA_DEBUG << "LUT size " << arraysize(lut);
 
-  fadecandy_packet lut_packets[PACKETS_PER_UPDATE];
+  fadecandy_packet *lut_packets = &packets[CONFIG_PACKETS];
 
   for (unsigned int packet_index = 0; packet_index < PACKETS_PER_UPDATE;
        packet_index++) {
-    lut_packets[packet_index].Reset();
-
     lut_packets[packet_index].control = TYPE_LUT | packet_index;
     if (packet_index == (PACKETS_PER_UPDATE - 1)) {
       lut_packets[packet_index].control |= FINAL;
@@ -152,6 +146,10 @@ bool InitializeWidget(LibUsbAdaptor *adaptor,
     unsigned int lut_offset = packet_index * LUT_ROWS_PER_PACKET;
 
     for (unsigned int row = 0; row < LUT_ROWS_PER_PACKET; row++) {
+      // The last packet is only partly used.
+      if (lut_offset + row >= arraysize(lut)) {
+        break;
+      }
       unsigned int row_data_offset = (row * 2) + LUT_DATA_OFFSET;
       ola::utils::SplitUInt16(
           lut[lut_offset + row],
@@ -160,19 +158,17 @@ bool InitializeWidget(LibUsbAdaptor *adaptor,
     }
   }
 
-  bytes_sent = 0;
-
-  // We do a single bulk transfer of the entire data, rather than one transfer
-  // for each 64 bytes.
-  r = adaptor->BulkTransfer(
+  int bytes_sent = 0;
+  int r = adaptor->BulkTransfer(
       usb_handle, ENDPOINT,
-      reinterpret_cast<unsigned char*>(&lut_packets),
-      sizeof(lut_packets), &bytes_sent,
+      reinterpret_cast<unsigned char*>(&packets),
+      sizeof(packets), &bytes_sent,
       URB_TIMEOUT_MS);
   if (r == 0) {
-    OLA_INFO << "Successfully transfer LUT of " << bytes_sent << " bytes";
+    OLA_INFO << "Successfully transferred config and LUT of " << bytes_sent
+             << " bytes";
   } else {
-    OLA_WARN << "Data transfer failed with error "
+    OLA_WARN << "Config transfer failed with error "
              << adaptor->ErrorCodeToString(r);
     return false;
   }
@@ -180,17 +176,18 @@ bool InitializeWidget(LibUsbAdaptor *adaptor,
   return true;
 }
 
-void UpdatePacketsWithDMX(fadecandy_packet packets[PACKETS_PER_UPDATE],
-                          const DmxBuffer &buffer) {
+/*
+ * Set the control bytes for a frame, this only needs to be done once.
+ */
+// One frame of packets.
+struct fadecandy_frame {
+  fadecandy_packet packets[PACKETS_PER_UPDATE];
+};
+
+void InitializePackets(fadecandy_packet packets[PACKETS_PER_UPDATE]) {
   for (unsigned int packet_index = 0; packet_index < PACKETS_PER_UPDATE;
        packet_index++) {
     packets[packet_index].Reset();
-
-    unsigned int dmx_offset = packet_index * SLOTS_PER_PACKET;
-    unsigned int slots_in_packet = SLOTS_PER_PACKET;
-    buffer.GetRange(dmx_offset, packets[packet_index].data,
-                    &slots_in_packet);
-
     packets[packet_index].control = TYPE_FRAMEBUFFER | packet_index;
     if (packet_index == (PACKETS_PER_UPDATE - 1)) {
       packets[packet_index].control |= FINAL;
@@ -198,6 +195,22 @@ void UpdatePacketsWithDMX(fadecandy_packet packets[PACKETS_PER_UPDATE],
   }
 }
 
+/*
+ * Copy the DMX data into the packets. A universe only covers the first
+ * DMX_PACKETS packets, the rest stay zeroed from InitializePackets().
+ */
+void UpdatePacketsWithDMX(fadecandy_packet packets[PACKETS_PER_UPDATE],
+                          const DmxBuffer &buffer) {
+  for (unsigned int packet_index = 0; packet_index < DMX_PACKETS;
+       packet_index++) {
+    unsigned int slots_in_packet = SLOTS_PER_PACKET;
+    buffer.GetRange(packet_index * SLOTS_PER_PACKET,
+                    packets[packet_index].data, &slots_in_packet);
+    memset(packets[packet_index].data + slots_in_packet, 0,
+           SLOTS_PER_PACKET - slots_in_packet);
+  }
+}
+
 }  // namespace
 
 // FadecandyThreadedSender
@@ -213,6 +226,7 @@ class FadecandyThreadedSender: public ThreadedUsbSender {
                           libusb_device_handle *handle)
       : ThreadedUsbSender(usb_device, handle),
         m_adaptor(adaptor) {
+    InitializePackets(m_data_packets);
   }
 
  private:
@@ -248,8 +262,9 @@ bool FadecandyThreadedSender::TransmitBuffer(libusb_device_handle *handle,
 SynchronousScanlimeFadecandy::SynchronousScanlimeFadecandy(
     LibUsbAdaptor *adaptor,
     libusb_device *usb_device,
-    const std::string &serial)
-    : ScanlimeFadecandy(adaptor, usb_device, serial) {
+    const std::string &serial,
+    const FadecandyOptions &options)
+    : ScanlimeFadecandy(adaptor, usb_device, serial, options) {
 }
 
 bool SynchronousScanlimeFadecandy::Init() {
@@ -261,7 +276,7 @@ bool SynchronousScanlimeFadecandy::Init() {
     return false;
   }
 
-  if (!InitializeWidget(m_adaptor, usb_handle)) {
+  if (!InitializeWidget(m_adaptor, usb_handle, m_options)) {
     m_adaptor->Close(usb_handle);
     return false;
   }
@@ -284,8 +299,18 @@ bool SynchronousScanlimeFadecandy::SendDMX(const DmxBuffer &buffer) {
 class FadecandyAsyncUsbSender : public AsyncUsbSender {
  public:
   FadecandyAsyncUsbSender(LibUsbAdaptor *adaptor,
-                          libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+                          libusb_device *usb_device,
+                          const FadecandyOptions &options)
+      : AsyncUsbSender(adaptor, usb_device, options.max_transfers),
+        m_options(options),
+        m_frames(MaxTransfers()) {
+    for (unsigned int i = 0; i < m_frames.size(); i++) {
+      InitializePackets(m_frames[i].packets);
+    }
+  }
+
+  ~FadecandyAsyncUsbSender() {
+    CancelTransfer();
   }
 
   libusb_device_handle* SetupHandle();
@@ -293,7 +318,9 @@ class FadecandyAsyncUsbSender : public AsyncUsbSender {
   bool PerformTransfer(const DmxBuffer &buffer);
 
  private:
-  fadecandy_packet m_data_packets[PACKETS_PER_UPDATE];
+  const FadecandyOptions m_options;
+  // A frame for each transfer, so we can have more than one in flight.
+  std::vector<fadecandy_frame> m_frames;
 
   DISALLOW_COPY_AND_ASSIGN(FadecandyAsyncUsbSender);
 };
@@ -305,7 +332,7 @@ libusb_device_handle* FadecandyAsyncUsbSender::SetupHandle() {
     return NULL;
   }
 
-  if (!InitializeWidget(m_adaptor, usb_handle)) {
+  if (!InitializeWidget(m_adaptor, usb_handle, m_options)) {
     m_adaptor->Close(usb_handle);
     return NULL;
   }
@@ -313,12 +340,13 @@ libusb_device_handle* FadecandyAsyncUsbSender::SetupHandle() {
 }
 
 bool FadecandyAsyncUsbSender::PerformTransfer(const DmxBuffer &buffer) {
-  UpdatePacketsWithDMX(m_data_packets, buffer);
+  fadecandy_frame *frame = &m_frames[CurrentTransfer()];
+  UpdatePacketsWithDMX(frame->packets, buffer);
   // We do a single bulk transfer of the entire data, rather than one transfer
   // for each 64 bytes.
   FillBulkTransfer(ENDPOINT,
-                   reinterpret_cast<unsigned char*>(&m_data_packets),
-                   sizeof(m_data_packets),
+                   reinterpret_cast<unsigned char*>(frame->packets),
+                   sizeof(frame->packets),
                    URB_TIMEOUT_MS);
   return (SubmitTransfer() == 0);
 }
@@ -329,9 +357,10 @@ bool FadecandyAsyncUsbSender::PerformTransfer(const DmxBuffer &buffer) {
 AsynchronousScanlimeFadecandy::AsynchronousScanlimeFadecandy(
     LibUsbAdaptor *adaptor,
     libusb_device *usb_device,
-    const std::string &serial)
-    : ScanlimeFadecandy(adaptor, usb_device, serial) {
-  m_sender.reset(new FadecandyAsyncUsbSender(m_adaptor, usb_device));
+    const std::string &serial,
+    const FadecandyOptions &options)
+    : ScanlimeFadecandy(adaptor, usb_device, serial, options) {
+  m_sender.reset(new FadecandyAsyncUsbSender(m_adaptor, usb_device, options));
 }
 
 bool AsynchronousScanlimeFadecandy::Init() {
@@ -28,6 +28,7 @@
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
+#include "ola/dmx/OutputCurve.h"
 #include "ola/thread/Mutex.h"
 #include "plugins/usbdmx/Widget.h"
 
@@ -35,6 +36,40 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+/**
+ * @brief The options for a Fadecandy widget.
+ */
+struct FadecandyOptions {
+  /**
+   * @brief The gamma / dimming curve to upload to the widget.
+   */
+  ola::dmx::OutputCurve::Options curve;
+
+  /**
+   * @brief Have the widget interpolate between frames.
+   *
+   * The device fades from one frame to the next over the time between the
+   * frames, which gives smooth output even at low DMX rates.
+   */
+  bool interpolation;
+
+  /**
+   * @brief The number of frames that may be in flight at once.
+   *
+   * This is only used by the asynchronous widget. More than one lets the next
+   * frame start before the previous one completes.
+   */
+  unsigned int max_transfers;
+
+  FadecandyOptions()
+      : interpolation(true),
+        max_transfers(DEFAULT_TRANSFERS) {
+  }
+
+  static const unsigned int DEFAULT_TRANSFERS = 2;
+  static const unsigned int MAX_TRANSFERS = 8;
+};
+
 /**
  * @brief The interface for the Fadecandy Widgets.
  *
@@ -43,6 +78,11 @@ namespace usbdmx {
  * introduces syncronization issues, since the underlying protocol models all 8
  * ports as a flat pixel array. For now we just expose the first 170 pixels.
  *
+ * The gamma / dimming curve is uploaded to the device as its color lookup
+ * table, so it's applied on the device at 16 bits, and dithering is done by the
+ * device too. The config and lookup table are sent as one batch of packets
+ * and each frame goes out as a single bulk transfer.
+ *
  * See https://github.com/scanlime/fadecandy/blob/master/README.md for more
  * information on Fadecandy devices.
  */
@@ -50,8 +90,10 @@ class ScanlimeFadecandy: public SimpleWidget {
  public:
   ScanlimeFadecandy(ola::usb::LibUsbAdaptor *adaptor,
                     libusb_device *usb_device,
-                    const std::string &serial)
+                    const std::string &serial,
+                    const FadecandyOptions &options)
       : SimpleWidget(adaptor, usb_device),
+        m_options(options),
         m_serial(serial) {
   }
 
@@ -63,6 +105,9 @@ class ScanlimeFadecandy: public SimpleWidget {
     return m_serial;
   }
 
+ protected:
+  const FadecandyOptions m_options;
+
  private:
   std::string m_serial;
 };
@@ -79,10 +124,12 @@ class SynchronousScanlimeFadecandy: public ScanlimeFadecandy {
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
    * @param serial the serial number of the widget.
+   * @param options the options for the widget.
    */
   SynchronousScanlimeFadecandy(ola::usb::LibUsbAdaptor *adaptor,
                                libusb_device *usb_device,
-                               const std::string &serial);
+                               const std::string &serial,
+                               const FadecandyOptions &options);
 
   bool Init();
 
@@ -104,10 +151,12 @@ class AsynchronousScanlimeFadecandy : public ScanlimeFadecandy {
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
    * @param serial the serial number of the widget.
+   * @param options the options for the widget.
    */
   AsynchronousScanlimeFadecandy(ola::usb::LibUsbAdaptor *adaptor,
                                 libusb_device *usb_device,
-                                const std::string &serial);
+                                const std::string &serial,
+                                const FadecandyOptions &options);
 
   bool Init();
 
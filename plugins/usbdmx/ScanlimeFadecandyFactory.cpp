@@ -20,8 +20,11 @@
 
 #include "plugins/usbdmx/ScanlimeFadecandyFactory.h"
 
+#include <string>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/base/Flags.h"
 #include "plugins/usbdmx/ScanlimeFadecandy.h"
 
@@ -31,7 +34,9 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+using ola::dmx::OutputCurve;
 using ola::usb::LibUsbAdaptor;
+using std::string;
 
 const char ScanlimeFadecandyFactory::EXPECTED_MANUFACTURER[] = "scanlime";
 const char ScanlimeFadecandyFactory::EXPECTED_PRODUCT[] = "Fadecandy";
@@ -77,16 +82,60 @@ bool ScanlimeFadecandyFactory::DeviceAdded(
     }
   }
 
+  FadecandyOptions options;
+  WidgetOptions(info.serial, &options);
+
   ScanlimeFadecandy *widget = NULL;
   if (FLAGS_use_async_libusb) {
     widget = new AsynchronousScanlimeFadecandy(m_adaptor, usb_device,
-                                               info.serial);
+                                               info.serial, options);
   } else {
     widget = new SynchronousScanlimeFadecandy(m_adaptor, usb_device,
-                                              info.serial);
+                                              info.serial, options);
   }
   return AddWidget(observer, widget);
 }
+
+void ScanlimeFadecandyFactory::WidgetOptions(const string &serial,
+                                             FadecandyOptions *options) {
+  const string prefix = "fadecandy-" + serial;
+  bool save = m_preferences->SetDefaultValue(
+      prefix + "-gamma", StringValidator(), "1.0");
+  save |= m_preferences->SetDefaultValue(
+      prefix + "-brightness", UIntValidator(0, OutputCurve::MAX_BRIGHTNESS),
+      static_cast<unsigned int>(OutputCurve::MAX_BRIGHTNESS));
+  save |= m_preferences->SetDefaultValue(
+      prefix + "-dither", BoolValidator(), false);
+  save |= m_preferences->SetDefaultValue(
+      prefix + "-interpolation", BoolValidator(), true);
+  save |= m_preferences->SetDefaultValue(
+      prefix + "-transfers",
+      UIntValidator(1, FadecandyOptions::MAX_TRANSFERS),
+      FadecandyOptions::DEFAULT_TRANSFERS);
+  if (save) {
+    m_preferences->Save();
+  }
+
+  const string gamma = m_preferences->GetValue(prefix + "-gamma");
+  if (!OutputCurve::ParseGamma(gamma, &options->curve.gamma)) {
+    OLA_WARN << "Invalid gamma for Fadecandy " << serial << ": " << gamma;
+  }
+
+  uint8_t brightness;
+  if (StringToInt(m_preferences->GetValue(prefix + "-brightness"),
+                  &brightness)) {
+    options->curve.brightness = brightness;
+  }
+  options->curve.dither = m_preferences->GetValueAsBool(prefix + "-dither");
+  options->interpolation = m_preferences->GetValueAsBool(
+      prefix + "-interpolation");
+
+  unsigned int max_transfers;
+  if (StringToInt(m_preferences->GetValue(prefix + "-transfers"),
+                  &max_transfers)) {
+    options->max_transfers = max_transfers;
+  }
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
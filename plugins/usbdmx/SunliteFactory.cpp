@@ -20,8 +20,11 @@
 
 #include "plugins/usbdmx/SunliteFactory.h"
 
+#include <vector>
+
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
+#include "ola/stl/STLUtils.h"
 #include "plugins/usbdmx/SunliteFirmwareLoader.h"
 
 DECLARE_bool(use_async_libusb);
@@ -34,16 +37,24 @@ const uint16_t SunliteFactory::EMPTY_PRODUCT_ID = 0x2000;
 const uint16_t SunliteFactory::FULL_PRODUCT_ID = 0x2001;
 const uint16_t SunliteFactory::VENDOR_ID = 0x0962;
 
+/*
+ * The libusb thread is still running at this point, so any loads in progress
+ * are cancelled as the loaders are deleted.
+ */
+SunliteFactory::~SunliteFactory() {
+  STLDeleteElements(&m_loaders);
+}
+
 bool SunliteFactory::DeviceAdded(
     WidgetObserver *observer,
     libusb_device *usb_device,
     const struct libusb_device_descriptor &descriptor) {
   if (descriptor.idVendor == VENDOR_ID &&
       descriptor.idProduct == EMPTY_PRODUCT_ID) {
+    // Widgets that already have the firmware use FULL_PRODUCT_ID, so we only
+    // get here if it needs to be loaded.
     OLA_INFO << "New empty SunliteDevice";
-    // TODO(simon): Make this async.
-    SunliteFirmwareLoader loader(usb_device);
-    loader.LoadFirmware();
+    LoadFirmware(usb_device);
     return true;
   } else if (descriptor.idVendor == VENDOR_ID &&
              descriptor.idProduct == FULL_PRODUCT_ID) {
@@ -58,6 +69,36 @@ bool SunliteFactory::DeviceAdded(
   }
   return false;
 }
+
+/*
+ * Once loaded, the device re-enumerates with FULL_PRODUCT_ID.
+ */
+void SunliteFactory::LoadFirmware(libusb_device *usb_device) {
+  if (!FLAGS_use_async_libusb) {
+    SunliteFirmwareLoader loader(usb_device);
+    loader.LoadFirmware();
+    return;
+  }
+
+  // Clean up the loads that have finished.
+  FirmwareLoaders::iterator iter = m_loaders.begin();
+  while (iter != m_loaders.end()) {
+    if ((*iter)->IsComplete()) {
+      delete *iter;
+      iter = m_loaders.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  AsyncSunliteFirmwareLoader *loader = new AsyncSunliteFirmwareLoader(
+      m_adaptor, usb_device);
+  if (loader->LoadFirmware()) {
+    m_loaders.push_back(loader);
+  } else {
+    delete loader;
+  }
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
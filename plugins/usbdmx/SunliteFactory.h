@@ -21,9 +21,12 @@
 #ifndef PLUGINS_USBDMX_SUNLITEFACTORY_H_
 #define PLUGINS_USBDMX_SUNLITEFACTORY_H_
 
+#include <vector>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/base/Macro.h"
 #include "plugins/usbdmx/Sunlite.h"
+#include "plugins/usbdmx/SunliteFirmwareLoader.h"
 #include "plugins/usbdmx/WidgetFactory.h"
 
 namespace ola {
@@ -38,6 +41,7 @@ class SunliteFactory : public BaseWidgetFactory<Sunlite> {
   explicit SunliteFactory(ola::usb::LibUsbAdaptor *adaptor)
       : BaseWidgetFactory<Sunlite>("SunliteFactory"),
         m_adaptor(adaptor) {}
+  ~SunliteFactory();
 
   bool DeviceAdded(
       WidgetObserver *observer,
@@ -45,7 +49,13 @@ class SunliteFactory : public BaseWidgetFactory<Sunlite> {
       const struct libusb_device_descriptor &descriptor);
 
  private:
+  typedef std::vector<AsyncSunliteFirmwareLoader*> FirmwareLoaders;
+
   ola::usb::LibUsbAdaptor* const m_adaptor;
+  // Loads that are in progress, when using the asynchronous libusb mode.
+  FirmwareLoaders m_loaders;
+
+  void LoadFirmware(libusb_device *usb_device);
 
   // The product ID for widgets that are missing their firmware.
   static const uint16_t EMPTY_PRODUCT_ID;
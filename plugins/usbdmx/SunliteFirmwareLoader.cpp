@@ -18,7 +18,11 @@
  * Copyright (C) 2010 Simon Newton
  */
 
+#include <string.h>
+
+#include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
+#include "ola/thread/Mutex.h"
 #include "plugins/usbdmx/SunliteFirmware.h"
 #include "plugins/usbdmx/SunliteFirmwareLoader.h"
 
@@ -27,6 +31,15 @@ namespace ola {
 namespace plugin {
 namespace usbdmx {
 
+using ola::usb::LibUsbAdaptor;
+
+namespace {
+const int INTERFACE_NUMBER = 0;  // the device only has 1 interface
+const uint8_t UPLOAD_REQUEST_TYPE = 0x40;
+const uint8_t UPLOAD_REQUEST = 0xa0;
+const unsigned int UPLOAD_TIMEOUT = 300;  // ms
+}  // namespace
+
 
 /*
  * Load the firmware
@@ -62,6 +75,7 @@ bool SunliteFirmwareLoader::LoadFirmware() {
         << ", ret value was " << ret;
       libusb_release_interface(handle, INTERFACE_NUMBER);
       libusb_close(handle);
+      return false;
     }
     record++;
   }
@@ -70,6 +84,103 @@ bool SunliteFirmwareLoader::LoadFirmware() {
   libusb_close(handle);
   return true;
 }
+
+
+AsyncSunliteFirmwareLoader::AsyncSunliteFirmwareLoader(
+    LibUsbAdaptor *adaptor,
+    libusb_device *usb_device)
+    : AsyncUsbTransceiverBase(adaptor, usb_device),
+      m_record(sunlite_firmware),
+      m_complete(false) {
+  m_control_setup_buffer =
+      new uint8_t[LIBUSB_CONTROL_SETUP_SIZE + MAX_RECORD_SIZE];
+}
+
+AsyncSunliteFirmwareLoader::~AsyncSunliteFirmwareLoader() {
+  CancelTransfer();
+  if (m_usb_handle) {
+    m_adaptor->Close(m_usb_handle);
+  }
+  delete[] m_control_setup_buffer;
+}
+
+bool AsyncSunliteFirmwareLoader::LoadFirmware() {
+  if (!Init()) {
+    OLA_WARN << "Failed to open sunlite device";
+    return false;
+  }
+
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (!SubmitRecord()) {
+    m_complete = true;
+    return false;
+  }
+  return true;
+}
+
+bool AsyncSunliteFirmwareLoader::IsComplete() {
+  ola::thread::MutexLocker locker(&m_mutex);
+  return m_complete;
+}
+
+void AsyncSunliteFirmwareLoader::TransferComplete(
+    struct libusb_transfer *transfer) {
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (!TransferDone(transfer, false)) {
+    return;
+  }
+  m_transfer_state = transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
+      DISCONNECTED : IDLE;
+
+  if (transfer->status != LIBUSB_TRANSFER_COMPLETED ||
+      transfer->actual_length != m_record->data_size) {
+    OLA_WARN << "Sunlite firmware load failed, address: "
+             << m_record->address << ", transfer returned "
+             << m_adaptor->ErrorCodeToString(transfer->status);
+    m_complete = true;
+    return;
+  }
+
+  m_record++;
+  if (m_record->address == SUNLITE_END_OF_FIRMWARE) {
+    OLA_INFO << "Sunlite firmware loaded";
+    m_complete = true;
+    return;
+  }
+
+  if (m_suppress_continuation || !SubmitRecord()) {
+    m_complete = true;
+  }
+}
+
+libusb_device_handle* AsyncSunliteFirmwareLoader::SetupHandle() {
+  libusb_device_handle *usb_handle;
+  bool ok = m_adaptor->OpenDeviceAndClaimInterface(
+      m_usb_device, INTERFACE_NUMBER, &usb_handle);
+  return ok ? usb_handle : NULL;
+}
+
+/*
+ * Send the current record, this must be called with m_mutex held.
+ */
+bool AsyncSunliteFirmwareLoader::SubmitRecord() {
+  if (m_record->data_size > MAX_RECORD_SIZE) {
+    OLA_WARN << "Sunlite firmware record at " << m_record->address
+             << " is too large";
+    return false;
+  }
+  m_adaptor->FillControlSetup(m_control_setup_buffer,
+                              UPLOAD_REQUEST_TYPE,
+                              UPLOAD_REQUEST,
+                              m_record->address,
+                              0,
+                              m_record->data_size);
+  memcpy(m_control_setup_buffer + LIBUSB_CONTROL_SETUP_SIZE, m_record->data,
+         m_record->data_size);
+  FillControlTransfer(m_control_setup_buffer,
+                      UPLOAD_TIMEOUT);
+  return SubmitTransfer() == 0;
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
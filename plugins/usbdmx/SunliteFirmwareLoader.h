@@ -25,9 +25,14 @@
 #define PLUGINS_USBDMX_SUNLITEFIRMWARELOADER_H_
 
 #include <libusb.h>
+#include <stdint.h>
+#include "libs/usb/LibUsbAdaptor.h"
 #include "ola/base/Macro.h"
+#include "plugins/usbdmx/AsyncUsbTransceiverBase.h"
 #include "plugins/usbdmx/FirmwareLoader.h"
 
+struct sunlite_hex_record;
+
 namespace ola {
 namespace plugin {
 namespace usbdmx {
@@ -43,13 +48,51 @@ class SunliteFirmwareLoader: public FirmwareLoader {
  private:
   libusb_device *m_device;
 
-  static const int INTERFACE_NUMBER = 0;  // the device only has 1 interface
-  static const uint8_t UPLOAD_REQUEST_TYPE = 0x40;
-  static const uint8_t UPLOAD_REQUEST = 0xa0;
-  static const unsigned int UPLOAD_TIMEOUT = 300;  // ms
-
   DISALLOW_COPY_AND_ASSIGN(SunliteFirmwareLoader);
 };
+
+/**
+ * @brief Loads the firmware using asynchronous transfers.
+ *
+ * LoadFirmware() returns once the first record has been submitted, the
+ * remaining records are sent from the libusb thread as each transfer
+ * completes. This means the firmware is loaded onto several devices at once,
+ * and the thread that found the device isn't blocked.
+ */
+class AsyncSunliteFirmwareLoader: public FirmwareLoader,
+                                  public AsyncUsbTransceiverBase {
+ public:
+  AsyncSunliteFirmwareLoader(ola::usb::LibUsbAdaptor *adaptor,
+                             libusb_device *usb_device);
+  ~AsyncSunliteFirmwareLoader();
+
+  /**
+   * @brief Start loading the firmware.
+   * @returns true if the load started, false if it failed.
+   */
+  bool LoadFirmware();
+
+  /**
+   * @brief Check if the load has finished, successfully or not.
+   */
+  bool IsComplete();
+
+  void TransferComplete(struct libusb_transfer *transfer);
+
+ protected:
+  libusb_device_handle* SetupHandle();
+
+ private:
+  uint8_t *m_control_setup_buffer;
+  const struct sunlite_hex_record *m_record;  // GUARDED_BY(m_mutex);
+  bool m_complete;  // GUARDED_BY(m_mutex);
+
+  bool SubmitRecord();
+
+  static const unsigned int MAX_RECORD_SIZE = 16;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncSunliteFirmwareLoader);
+};
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
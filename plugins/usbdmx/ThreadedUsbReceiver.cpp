@@ -31,12 +31,12 @@ ThreadedUsbReceiver::ThreadedUsbReceiver(libusb_device *usb_device,
                                          libusb_device_handle *usb_handle,
                                          PluginAdaptor *plugin_adaptor,
                                          int interface_number)
-    : m_term(false),
+    : ola::thread::Thread(ola::thread::Thread::Options("usb-receiver")),
+      m_term(false),
       m_usb_device(usb_device),
       m_usb_handle(usb_handle),
       m_interface_number(interface_number),
-      m_plugin_adaptor(plugin_adaptor),
-      m_receive_callback(NULL) {
+      m_mailbox(plugin_adaptor) {
   libusb_ref_device(usb_device);
 }
 
@@ -82,13 +82,7 @@ void *ThreadedUsbReceiver::Run() {
     }
 
     if (buffer_updated) {
-      {
-        ola::thread::MutexLocker locker(&m_data_mutex);
-        m_buffer.Set(buffer);
-      }
-      if (m_receive_callback.get()) {
-        m_plugin_adaptor->Execute(m_receive_callback.get());
-      }
+      m_mailbox.Update(&buffer);
     }
   }
   libusb_release_interface(m_usb_handle, m_interface_number);
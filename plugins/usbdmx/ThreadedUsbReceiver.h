@@ -28,6 +28,7 @@
 #include "ola/DmxBuffer.h"
 #include "ola/thread/Thread.h"
 #include "olad/PluginAdaptor.h"
+#include "plugins/usbdmx/DmxInputMailbox.h"
 
 namespace ola {
 namespace plugin {
@@ -45,6 +46,9 @@ namespace usbdmx {
  * actual transfer.
  *
  * ThreadedUsbReceiver can be used as a building block for synchronous widgets.
+ *
+ * Received frames are passed to the main thread with a DmxInputMailbox, so
+ * unchanged frames don't wake the main loop.
  */
 class ThreadedUsbReceiver: private ola::thread::Thread {
  public:
@@ -79,15 +83,17 @@ class ThreadedUsbReceiver: private ola::thread::Thread {
    * @param callback The callback to call.
    */
   void SetReceiveCallback(Callback0<void> *callback) {
-    m_receive_callback.reset(callback);
+    m_mailbox.SetCallback(callback);
   }
 
   /**
    * @brief Get DMX Buffer
    * @returns DmxBuffer with current input values.
+   *
+   * This must only be called from the main thread.
    */
   const DmxBuffer &GetDmxInBuffer() const {
-    return m_buffer;
+    return m_mailbox.Get();
   }
 
  protected:
@@ -96,7 +102,8 @@ class ThreadedUsbReceiver: private ola::thread::Thread {
    * @param handle the libusb_device_handle to use for the transfer.
    * @param buffer The DmxBuffer to be updated.
    * @param buffer_updated set to true when buffer was updated (=data
-       received)
+       received). Data which matches the buffer isn't passed on, so this can
+       be set for every transfer.
    * @returns true if the transfer was completed, false otherwise.
    *
    * This is called from the receiver thread.
@@ -110,10 +117,7 @@ class ThreadedUsbReceiver: private ola::thread::Thread {
   libusb_device* const m_usb_device;
   libusb_device_handle* const m_usb_handle;
   int const m_interface_number;
-  PluginAdaptor* const m_plugin_adaptor;
-  std::auto_ptr<Callback0<void> > m_receive_callback;
-  DmxBuffer m_buffer;
-  ola::thread::Mutex m_data_mutex;
+  DmxInputMailbox m_mailbox;
   ola::thread::Mutex m_term_mutex;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadedUsbReceiver);
@@ -30,7 +30,8 @@ namespace usbdmx {
 ThreadedUsbSender::ThreadedUsbSender(libusb_device *usb_device,
                                      libusb_device_handle *usb_handle,
                                      int interface_number)
-    : m_term(false),
+    : ola::thread::Thread(ola::thread::Thread::Options("usb-sender")),
+      m_term(false),
       m_usb_device(usb_device),
       m_usb_handle(usb_handle),
       m_interface_number(interface_number) {
@@ -58,7 +59,6 @@ bool ThreadedUsbSender::Start() {
 }
 
 void *ThreadedUsbSender::Run() {
-  DmxBuffer buffer;
   if (!m_usb_handle)
     return NULL;
 
@@ -69,11 +69,8 @@ void *ThreadedUsbSender::Run() {
         break;
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_data_mutex);
-      buffer.Set(m_buffer);
-    }
-
+    m_frame.Fetch();
+    const DmxBuffer &buffer = *m_frame.ReadSlot();
     if (buffer.Size()) {
       if (!TransmitBuffer(m_usb_handle, buffer)) {
         OLA_WARN << "Send failed, stopping thread...";
@@ -90,9 +87,12 @@ void *ThreadedUsbSender::Run() {
 }
 
 bool ThreadedUsbSender::SendDMX(const DmxBuffer &buffer) {
-  // Store the new data in the shared buffer.
-  ola::thread::MutexLocker locker(&m_data_mutex);
-  m_buffer.Set(buffer);
+  // The sender thread doesn't see the slot until it's published.
+  DmxBuffer *frame = m_frame.WriteSlot();
+  if (!frame->Set(buffer)) {
+    frame->Reset();
+  }
+  m_frame.Publish();
   return true;
 }
 }  // namespace usbdmx
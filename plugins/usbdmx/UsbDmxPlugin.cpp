@@ -25,6 +25,7 @@
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 #include "plugins/usbdmx/AsyncPluginImpl.h"
 #include "plugins/usbdmx/PluginImplInterface.h"
 #include "plugins/usbdmx/SyncPluginImpl.h"
@@ -110,3 +111,5 @@ bool UsbDmxPlugin::SetDefaultPreferences() {
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::usbdmx::UsbDmxPlugin)
@@ -44,11 +44,14 @@ using std::string;
 
 const unsigned int BaseUsbProWidget::HEADER_SIZE =
   sizeof(BaseUsbProWidget::message_header);
+const uint8_t BaseUsbProWidget::EOM;
 
 
 BaseUsbProWidget::BaseUsbProWidget(
     ola::io::ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
+      m_scheduler(NULL),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT),
       m_state(PRE_SOM),
       m_bytes_received(0) {
   memset(&m_header, 0, sizeof(m_header));
@@ -58,10 +61,19 @@ BaseUsbProWidget::BaseUsbProWidget(
 
 
 BaseUsbProWidget::~BaseUsbProWidget() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+  }
   m_descriptor->SetOnData(NULL);
 }
 
 
+void BaseUsbProWidget::EnableWriteCoalescing(
+    ola::thread::SchedulerInterface *scheduler) {
+  m_scheduler = scheduler;
+}
+
+
 /*
  * Read data from the widget
  */
@@ -97,30 +109,92 @@ bool BaseUsbProWidget::SendDMX(const DmxBuffer &buffer) {
  */
 bool BaseUsbProWidget::SendMessage(uint8_t label,
                                    const uint8_t *data,
-                                   unsigned int length) const {
+                                   unsigned int length) {
   if (length && !data)
     return false;
 
-  ssize_t frame_size = HEADER_SIZE + length + 1;
-  uint8_t frame[frame_size];
-  message_header *header = reinterpret_cast<message_header*>(frame);
-  header->som = SOM;
-  header->label = label;
-  header->len = length & 0xFF;
-  header->len_hi = (length & 0xFF00) >> 8;
+  // Don't queue anything if the widget has gone away.
+  if (!m_descriptor->ValidWriteDescriptor()) {
+    m_output.Clear();
+    return false;
+  }
+
+  unsigned int frame_size = HEADER_SIZE + length + 1;
+  if (m_output.Size() + frame_size > MAX_QUEUED_BYTES) {
+    // Try to make some room, before giving up on this message.
+    FlushOutput();
+    if (m_output.Size() + frame_size > MAX_QUEUED_BYTES) {
+      OLA_WARN << "USB Pro output queue full, dropping message with label "
+               << static_cast<int>(label);
+      return false;
+    }
+  }
 
-  memcpy(frame + sizeof(message_header), data, length);
-  frame[frame_size - 1] = EOM;
+  message_header header;
+  header.som = SOM;
+  header.label = label;
+  header.len = length & 0xFF;
+  header.len_hi = (length & 0xFF00) >> 8;
+
+  // The IOQueue uses pooled blocks, so the framing doesn't need a buffer of
+  // its own. Whole messages are always queued, so a partial write can't
+  // break the framing.
+  m_output.Write(reinterpret_cast<const uint8_t*>(&header), HEADER_SIZE);
+  if (length) {
+    m_output.Write(data, length);
+  }
+  m_output.Write(&EOM, sizeof(EOM));
 
-  ssize_t bytes_sent = m_descriptor->Send(frame, frame_size);
-  if (bytes_sent != frame_size)
-    // we've probably screwed framing at this point
-    return false;
+  if (m_scheduler) {
+    ScheduleFlush(0);
+    return true;
+  }
+  return FlushOutput();
+}
 
+
+/*
+ * Write as much of the queued data as the descriptor will take.
+ * @returns false if the descriptor failed, true otherwise.
+ */
+bool BaseUsbProWidget::FlushOutput() {
+  while (!m_output.Empty()) {
+    ssize_t bytes_sent = m_descriptor->Send(&m_output);
+    if (bytes_sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        // Keep the data and try again later.
+        if (m_scheduler) {
+          ScheduleFlush(WRITE_RETRY_MS);
+        }
+        return true;
+      }
+      m_output.Clear();
+      return false;
+    } else if (bytes_sent == 0) {
+      // The descriptor isn't valid.
+      m_output.Clear();
+      return false;
+    }
+  }
   return true;
 }
 
 
+void BaseUsbProWidget::ScheduleFlush(unsigned int delay_ms) {
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+        delay_ms,
+        NewSingleCallback(this, &BaseUsbProWidget::FlushTimeout));
+  }
+}
+
+
+void BaseUsbProWidget::FlushTimeout() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  FlushOutput();
+}
+
+
 /**
  * Open a path and apply the settings required for talking to widgets.
  */
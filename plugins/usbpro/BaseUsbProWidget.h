@@ -27,6 +27,8 @@
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
 
 namespace ola {
@@ -50,9 +52,24 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   // we locate the SendDMX in the base class since so many widgets share it.
   virtual bool SendDMX(const DmxBuffer &buffer);
 
+  /*
+   * Frame a message and queue it for sending. Unless write coalescing is
+   * enabled this is written straight away.
+   * @returns false if the message couldn't be queued, or the descriptor has
+   *   failed.
+   */
   bool SendMessage(uint8_t label,
                    const uint8_t *data,
-                   unsigned int length) const;
+                   unsigned int length);
+
+  /*
+   * Coalesce the messages sent during one iteration of the event loop, so
+   * that widgets which send several messages per frame, e.g. one per port,
+   * do a single write(). This also means a write that would block is retried
+   * shortly after, rather than waiting for the next message.
+   * @param scheduler the scheduler to use, ownership is not transferred.
+   */
+  void EnableWriteCoalescing(ola::thread::SchedulerInterface *scheduler);
 
   static ola::io::ConnectedDescriptor *OpenDevice(const std::string &path);
 
@@ -83,12 +100,18 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   } message_header;
 
   ola::io::ConnectedDescriptor *m_descriptor;
+  ola::io::IOQueue m_output;
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::thread::timeout_id m_flush_timeout;
   receive_state m_state;
   unsigned int m_bytes_received;
   message_header m_header;
   uint8_t m_recv_buffer[MAX_DATA_SIZE];
 
   void ReceiveMessage();
+  bool FlushOutput();
+  void ScheduleFlush(unsigned int delay_ms);
+  void FlushTimeout();
   virtual void HandleMessage(uint8_t label,
                              const uint8_t *data,
                              unsigned int length) = 0;
@@ -96,6 +119,10 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t EOM = 0xe7;
   static const uint8_t SOM = 0x7e;
   static const unsigned int HEADER_SIZE;
+  // The most data we'll queue if the descriptor isn't accepting writes.
+  static const unsigned int MAX_QUEUED_BYTES = 4096;
+  // How long to wait before retrying a write that would have blocked.
+  static const unsigned int WRITE_RETRY_MS = 2;
 };
 
 
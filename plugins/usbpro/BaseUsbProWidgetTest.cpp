@@ -42,6 +42,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST_SUITE(BaseUsbProWidgetTest);
   CPPUNIT_TEST(testSend);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testCoalescedSend);
   CPPUNIT_TEST(testReceive);
   CPPUNIT_TEST(testRemove);
   CPPUNIT_TEST_SUITE_END();
@@ -51,6 +52,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
 
     void testSend();
     void testSendDMX();
+    void testCoalescedSend();
     void testReceive();
     void testRemove();
 
@@ -205,6 +207,35 @@ void BaseUsbProWidgetTest::testSendDMX() {
 }
 
 
+/**
+ * Check that messages sent together are written together.
+ */
+void BaseUsbProWidgetTest::testCoalescedSend() {
+  m_widget->EnableWriteCoalescing(&m_ss);
+
+  uint8_t expected[] = {
+    0x7e, 0x0a, 0, 0, 0xe7,
+    0x7e, 0x0b, 4, 0, 0xde, 0xad, 0xbe, 0xef, 0xe7,
+  };
+  m_endpoint->AddExpectedData(
+      expected,
+      sizeof(expected),
+      ola::NewSingleCallback(this, &BaseUsbProWidgetTest::Terminate));
+
+  uint32_t data = ola::network::HostToNetwork(0xdeadbeef);
+  OLA_ASSERT(m_widget->SendMessage(10, NULL, 0));
+  OLA_ASSERT(m_widget->SendMessage(11,
+                                   reinterpret_cast<uint8_t*>(&data),
+                                   sizeof(data)));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  // Nothing is queued once the descriptor is closed.
+  m_descriptor.Close();
+  OLA_ASSERT_FALSE(m_widget->SendMessage(10, NULL, 0));
+}
+
+
 /*
  * Test receiving works.
  */
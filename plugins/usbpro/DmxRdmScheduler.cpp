@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxRdmScheduler.cpp
+ * Share a widget between DMX and RDM without starving the DMX output.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+#include <ostream>
+#include "plugins/usbpro/DmxRdmScheduler.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+
+const unsigned int DmxRdmScheduler::DEFAULT_MIN_DMX_RATE;
+
+DmxRdmScheduler::DmxRdmScheduler(unsigned int min_dmx_rate,
+                                 const ola::Clock *clock)
+    : m_clock(clock ? clock : &m_real_clock),
+      m_min_dmx_rate(min_dmx_rate) {
+}
+
+bool DmxRdmScheduler::DMXDue() const {
+  if (!m_min_dmx_rate || !m_last_dmx.IsSet()) {
+    return false;
+  }
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  return (now - m_last_dmx).InMilliSeconds() >= 1000 / m_min_dmx_rate;
+}
+
+void DmxRdmScheduler::DMXSent(bool refresh) {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  if (m_last_dmx.IsSet()) {
+    unsigned int gap = (now - m_last_dmx).InMilliSeconds();
+    m_stats.max_dmx_gap_ms = std::max(m_stats.max_dmx_gap_ms, gap);
+  }
+  m_last_dmx = now;
+  m_stats.dmx_frames++;
+  if (refresh) {
+    m_stats.dmx_refreshes++;
+  }
+}
+
+void DmxRdmScheduler::RDMQueued() {
+  m_clock->CurrentTime(&m_rdm_queued);
+}
+
+void DmxRdmScheduler::RDMSent() {
+  m_stats.rdm_requests++;
+  if (!m_rdm_queued.IsSet()) {
+    return;
+  }
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  unsigned int wait = (now - m_rdm_queued).InMilliSeconds();
+  m_stats.max_rdm_wait_ms = std::max(m_stats.max_rdm_wait_ms, wait);
+  m_stats.total_rdm_wait_ms += wait;
+  m_rdm_queued = TimeStamp();
+}
+
+std::ostream& operator<<(std::ostream &out,
+                         const DmxRdmScheduler::Stats &stats) {
+  out << stats.dmx_frames << " DMX frames (" << stats.dmx_refreshes
+      << " refreshes), max DMX gap " << stats.max_dmx_gap_ms << "ms, "
+      << stats.rdm_requests << " RDM requests, max RDM wait "
+      << stats.max_rdm_wait_ms << "ms";
+  if (stats.rdm_requests) {
+    out << ", mean RDM wait "
+        << stats.total_rdm_wait_ms / stats.rdm_requests << "ms";
+  }
+  return out;
+}
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxRdmScheduler.h
+ * Share a widget between DMX and RDM without starving the DMX output.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_USBPRO_DMXRDMSCHEDULER_H_
+#define PLUGINS_USBPRO_DMXRDMSCHEDULER_H_
+
+#include <stdint.h>
+#include <ostream>
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+/*
+ * Widgets that handle one transaction at a time can't send DMX while an RDM
+ * request is outstanding, and some stop the DMX output altogether until the
+ * next DMX frame arrives. During discovery, which is a long series of RDM
+ * requests, the fixtures may then see no DMX at all.
+ *
+ * This tracks when DMX was last sent, so the widget can put a DMX frame in
+ * between RDM transactions whenever the minimum refresh rate is due. It also
+ * keeps some stats on how long RDM requests wait for the widget.
+ */
+class DmxRdmScheduler {
+ public:
+  struct Stats {
+    Stats()
+        : dmx_frames(0),
+          dmx_refreshes(0),
+          rdm_requests(0),
+          max_dmx_gap_ms(0),
+          max_rdm_wait_ms(0),
+          total_rdm_wait_ms(0) {
+    }
+
+    unsigned int dmx_frames;  // all DMX frames sent, including refreshes
+    unsigned int dmx_refreshes;  // frames re-sent to keep the output alive
+    unsigned int rdm_requests;
+    unsigned int max_dmx_gap_ms;
+    unsigned int max_rdm_wait_ms;
+    uint64_t total_rdm_wait_ms;
+  };
+
+  /*
+   * @param min_dmx_rate the minimum DMX frames per second while there is
+   *   RDM traffic, 0 disables the refresh.
+   * @param clock the clock to use, ownership is not transferred. If NULL a
+   *   real clock is used.
+   */
+  explicit DmxRdmScheduler(unsigned int min_dmx_rate = DEFAULT_MIN_DMX_RATE,
+                           const ola::Clock *clock = NULL);
+
+  /*
+   * Returns true if a DMX frame should be sent before the next RDM request.
+   * This is false until the first DMX frame has been sent.
+   */
+  bool DMXDue() const;
+
+  /*
+   * Record that a DMX frame was sent.
+   * @param refresh true if this was a re-send of the last frame, rather than
+   *   new data.
+   */
+  void DMXSent(bool refresh = false);
+
+  /*
+   * Record that an RDM request is waiting for the widget.
+   */
+  void RDMQueued();
+
+  /*
+   * Record that an RDM request was sent to the widget.
+   */
+  void RDMSent();
+
+  unsigned int MinDMXRate() const { return m_min_dmx_rate; }
+  const Stats &GetStats() const { return m_stats; }
+
+  static const unsigned int DEFAULT_MIN_DMX_RATE = 20;
+
+ private:
+  ola::Clock m_real_clock;
+  const ola::Clock *m_clock;
+  const unsigned int m_min_dmx_rate;
+  ola::TimeStamp m_last_dmx;
+  ola::TimeStamp m_rdm_queued;
+  Stats m_stats;
+
+  DISALLOW_COPY_AND_ASSIGN(DmxRdmScheduler);
+};
+
+std::ostream& operator<<(std::ostream &out,
+                         const DmxRdmScheduler::Stats &stats);
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBPRO_DMXRDMSCHEDULER_H_
@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxRdmSchedulerTest.cpp
+ * Test fixture for the DmxRdmScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/Clock.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/usbpro/DmxRdmScheduler.h"
+
+using ola::MockClock;
+using ola::plugin::usbpro::DmxRdmScheduler;
+
+class DmxRdmSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxRdmSchedulerTest);
+  CPPUNIT_TEST(testDMXDue);
+  CPPUNIT_TEST(testDisabled);
+  CPPUNIT_TEST(testRDMWait);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testDMXDue();
+  void testDisabled();
+  void testRDMWait();
+
+ private:
+  MockClock m_clock;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxRdmSchedulerTest);
+
+/*
+ * Check a refresh is due once the budget has passed.
+ */
+void DmxRdmSchedulerTest::testDMXDue() {
+  DmxRdmScheduler scheduler(20, &m_clock);  // 50ms
+
+  // Nothing is due until we've sent DMX.
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+  m_clock.AdvanceTime(1, 0);
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+
+  scheduler.DMXSent();
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+  m_clock.AdvanceTime(0, 49000);
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+  m_clock.AdvanceTime(0, 1000);
+  OLA_ASSERT_TRUE(scheduler.DMXDue());
+
+  m_clock.AdvanceTime(0, 30000);
+  scheduler.DMXSent(true);
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+
+  const DmxRdmScheduler::Stats &stats = scheduler.GetStats();
+  OLA_ASSERT_EQ(2u, stats.dmx_frames);
+  OLA_ASSERT_EQ(1u, stats.dmx_refreshes);
+  OLA_ASSERT_EQ(80u, stats.max_dmx_gap_ms);
+}
+
+/*
+ * Check a rate of 0 disables the refresh.
+ */
+void DmxRdmSchedulerTest::testDisabled() {
+  DmxRdmScheduler scheduler(0, &m_clock);
+  scheduler.DMXSent();
+  m_clock.AdvanceTime(10, 0);
+  OLA_ASSERT_FALSE(scheduler.DMXDue());
+}
+
+/*
+ * Check the RDM queueing stats.
+ */
+void DmxRdmSchedulerTest::testRDMWait() {
+  DmxRdmScheduler scheduler(20, &m_clock);
+
+  scheduler.RDMQueued();
+  m_clock.AdvanceTime(0, 10000);
+  scheduler.RDMSent();
+
+  scheduler.RDMQueued();
+  m_clock.AdvanceTime(0, 30000);
+  scheduler.RDMSent();
+
+  // A request that wasn't queued doesn't count towards the wait.
+  m_clock.AdvanceTime(1, 0);
+  scheduler.RDMSent();
+
+  const DmxRdmScheduler::Stats &stats = scheduler.GetStats();
+  OLA_ASSERT_EQ(3u, stats.rdm_requests);
+  OLA_ASSERT_EQ(30u, stats.max_rdm_wait_ms);
+  OLA_ASSERT_EQ(static_cast<uint64_t>(40), stats.total_rdm_wait_ms);
+}
@@ -79,6 +79,7 @@ DmxTriWidgetImpl::DmxTriWidgetImpl(
       m_transaction_number(0),
       m_last_command(RESERVED_COMMAND_ID),
       m_expected_command(RESERVED_COMMAND_ID) {
+  EnableWriteCoalescing(m_scheduler);
 }
 
 
@@ -152,6 +153,7 @@ void DmxTriWidgetImpl::SendRDMRequest(RDMRequest *request_ptr,
   // store pointers
   m_pending_rdm_request.reset(request.release());
   m_rdm_request_callback = on_complete;
+  m_dmx_scheduler.RDMQueued();
   MaybeSendNextRequest();
 }
 
@@ -197,7 +199,9 @@ void DmxTriWidgetImpl::SendDMXBuffer() {
   unsigned int length = DMX_UNIVERSE_SIZE;
   m_outgoing_dmx.Get(send_buffer + 3, &length);
   m_outgoing_dmx.Reset();
-  SendCommandToTRI(EXTENDED_COMMAND_LABEL, send_buffer, length + 3);
+  if (SendCommandToTRI(EXTENDED_COMMAND_LABEL, send_buffer, length + 3)) {
+    m_dmx_scheduler.DMXSent();
+  }
 }
 
 
@@ -205,6 +209,7 @@ void DmxTriWidgetImpl::SendDMXBuffer() {
  * Send the queued up RDM command.
  */
 void DmxTriWidgetImpl::SendQueuedRDMCommand() {
+  m_dmx_scheduler.RDMSent();
   // If we can't find this UID, fail now.
   const UID &dest_uid = m_pending_rdm_request->DestinationUID();
   if (!dest_uid.IsBroadcast() && !STLContains(m_uid_index_map, dest_uid)) {
@@ -249,6 +254,7 @@ void DmxTriWidgetImpl::RunDiscoveryCallback(RDMDiscoveryCallback *callback) {
   for (; iter != m_uid_index_map.end(); ++iter) {
     uid_set.AddUID(iter->first);
   }
+  OLA_INFO << "DMX-TRI DMX / RDM stats: " << m_dmx_scheduler.GetStats();
   callback->Run(uid_set);
 }
 
@@ -31,6 +31,7 @@
 #include "ola/rdm/UIDSet.h"
 #include "ola/thread/SchedulerInterface.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
+#include "plugins/usbpro/DmxRdmScheduler.h"
 
 namespace ola {
 namespace plugin {
@@ -90,6 +91,7 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
 
     // State for sending DMX
     DmxBuffer m_outgoing_dmx;
+    DmxRdmScheduler m_dmx_scheduler;
 
     // State for handling RDM discovery
     ola::thread::timeout_id m_disc_stat_timeout_id;
@@ -19,6 +19,7 @@
  */
 
 #include <string.h>
+#include <algorithm>
 #include <deque>
 #include <iostream>
 #include <memory>
@@ -93,12 +94,15 @@ OperationLabels OperationLabels::Port2Operations() {
 }
 
 EnttecPortImpl::EnttecPortImpl(const OperationLabels &ops, const UID &uid,
-                               SendCallback *send_cb)
+                               SendCallback *send_cb,
+                               unsigned int min_dmx_rate)
     : m_send_cb(send_cb),
       m_ops(ops),
       m_active(true),
       m_watchdog(WATCHDOG_LIMIT,
                  NewCallback(this, &EnttecPortImpl::WatchdogFired)),
+      m_dmx_output(false),
+      m_dmx_scheduler(min_dmx_rate),
       m_discovery_agent(this),
       m_uid(uid),
       m_transaction_number(0),
@@ -132,6 +136,22 @@ void EnttecPortImpl::Stop() {
  * Send a DMX message
  */
 bool EnttecPortImpl::SendDMX(const DmxBuffer &buffer) {
+  if (m_dmx_scheduler.MinDMXRate()) {
+    m_output_buffer.Set(buffer);
+  }
+  m_dmx_output = true;
+  bool ok = SendDMXFrame(buffer);
+  if (ok) {
+    m_dmx_scheduler.DMXSent();
+  }
+  return ok;
+}
+
+
+/**
+ * Pack and send a DMX frame.
+ */
+bool EnttecPortImpl::SendDMXFrame(const DmxBuffer &buffer) {
   struct {
     uint8_t start_code;
     uint8_t dmx[DMX_UNIVERSE_SIZE];
@@ -161,6 +181,8 @@ bool EnttecPortImpl::ChangeToReceiveMode(bool change_only) {
     return false;
   }
 
+  // Don't switch the port back to output when we next send RDM.
+  m_dmx_output = false;
   uint8_t mode = change_only;
   bool status = m_send_cb->Run(m_ops.change_to_rx_mode, &mode, sizeof(mode));
   if (status && change_only) {
@@ -243,6 +265,7 @@ void EnttecPortImpl::SendRDMRequest(RDMRequest *request_ptr,
 
   m_pending_request.reset(request.release());
   m_rdm_request_callback = on_complete;
+  m_dmx_scheduler.RDMQueued();
 
   bool ok = PackAndSendRDMRequest(
       m_pending_request->IsDUB() ? m_ops.rdm_discovery : m_ops.send_rdm,
@@ -490,7 +513,11 @@ void EnttecPortImpl::HandleIncomingDataMessage(const uint8_t *data,
 
 
 /*
- * Handle the dmx change of state frame
+ * Handle the dmx change of state frame.
+ *
+ * This carries up to 40 slots, starting at slot start * 8. Bit n of the
+ * changed array is set if slot (start * 8 + n) changed, and the data holds
+ * the new values of the changed slots, in order. Slot 0 is the start code.
  */
 void EnttecPortImpl::HandleDMXDiff(const uint8_t *data, unsigned int length) {
   typedef struct {
@@ -499,38 +526,56 @@ void EnttecPortImpl::HandleDMXDiff(const uint8_t *data, unsigned int length) {
     uint8_t data[40];
   } widget_data_changed;
 
-  if (length < sizeof(widget_data_changed)) {
+  const widget_data_changed *widget_reply =
+      reinterpret_cast<const widget_data_changed*>(data);
+  // The data is only as long as the number of changed slots.
+  const unsigned int header_size = (sizeof(widget_reply->start) +
+                                    sizeof(widget_reply->changed));
+  if (length <= header_size) {
     OLA_WARN << "Change of state packet was too small: " << length;
     return;
   }
+  const unsigned int data_length = std::min(
+      length - header_size,
+      static_cast<unsigned int>(sizeof(widget_reply->data)));
 
-  const widget_data_changed *widget_reply =
-      reinterpret_cast<const widget_data_changed*>(data);
-
-  unsigned int start_channel = widget_reply->start * 8;
+  const unsigned int start_slot = widget_reply->start * 8;
   unsigned int offset = 0;
+  bool changed = false;
+  for (unsigned int i = 0; i < 40 && offset < data_length; i++) {
+    if (!(widget_reply->changed[i / 8] & (1 << (i % 8)))) {
+      continue;
+    }
 
-  // skip non-0 start codes, this code is pretty messed up because the USB Pro
-  // doesn't seem to provide a guarantee on the ordering of packets. Packets
-  // with non-0 start codes are almost certainly going to cause problems.
-  if (start_channel == 0 && (widget_reply->changed[0] & 0x01) &&
-      widget_reply->data[offset]) {
-    return;
-  }
-
-  for (int i = 0; i < 40; i++) {
-    if (start_channel + i > DMX_UNIVERSE_SIZE + 1 || offset + 6 >= length) {
+    const uint8_t value = widget_reply->data[offset++];
+    const unsigned int slot = start_slot + i;
+    if (slot == 0) {
+      // skip non-0 start codes, this code is pretty messed up because the USB
+      // Pro doesn't seem to provide a guarantee on the ordering of packets.
+      // Packets with non-0 start codes are almost certainly going to cause
+      // problems.
+      if (value) {
+        return;
+      }
+      continue;
+    }
+    if (slot > DMX_UNIVERSE_SIZE) {
       break;
     }
 
-    if (widget_reply->changed[i/8] & (1 << (i % 8)) && start_channel + i != 0) {
-      m_input_buffer.SetChannel(start_channel + i - 1,
-                                widget_reply->data[offset]);
-      offset++;
+    // Patch the buffer in place, the widget can report a slot as changed
+    // when it has gone back to the value we already hold. SetChannel() can
+    // only extend the buffer by one slot.
+    const unsigned int channel = slot - 1;
+    if (channel == m_input_buffer.Size() ||
+        (channel < m_input_buffer.Size() &&
+         m_input_buffer.Get(channel) != value)) {
+      m_input_buffer.SetChannel(channel, value);
+      changed = true;
     }
   }
 
-  if (m_dmx_callback.get()) {
+  if (changed && m_dmx_callback.get()) {
     m_dmx_callback->Run();
   }
 }
@@ -580,6 +625,7 @@ void EnttecPortImpl::DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *callback,
                                        bool,
                                        const UIDSet &uids) {
   OLA_DEBUG << "Enttec Pro discovery complete: " << uids;
+  OLA_INFO << "Enttec Pro DMX / RDM stats: " << m_dmx_scheduler.GetStats();
   if (callback) {
     callback->Run(uids);
   }
@@ -596,9 +642,17 @@ bool EnttecPortImpl::PackAndSendRDMRequest(uint8_t label,
     return false;
   }
 
+  // Each RDM request stops the DMX output, so if it's been too long since
+  // the last frame, slot one in before the request.
+  if (m_dmx_output && m_dmx_scheduler.DMXDue() &&
+      SendDMXFrame(m_output_buffer)) {
+    m_dmx_scheduler.DMXSent(true);
+  }
+
   bool ok = m_send_cb->Run(label, data.data(), data.size());
   if (ok) {
     m_watchdog.Enable();
+    m_dmx_scheduler.RDMSent();
   }
   return ok;
 }
@@ -703,6 +757,13 @@ void EnttecPort::RunIncrementalDiscovery(
 }
 
 
+void EnttecPort::SeedUIDs(const UIDSet &uids) {
+  if (m_enable_rdm) {
+    m_impl->SeedUIDs(uids);
+  }
+}
+
+
 // EnttecUsbProWidgetImpl
 // ----------------------------------------------------------------------------
 
@@ -733,6 +794,7 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
 
     ola::thread::SchedulerInterface *m_scheduler;
     ola::thread::timeout_id m_watchdog_timer_id;
+    const unsigned int m_min_dmx_rate;
 
     vector<EnttecPort*> m_ports;
     vector<EnttecPortImpl*> m_port_impls;
@@ -768,6 +830,7 @@ EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
     : BaseUsbProWidget(descriptor),
       m_scheduler(scheduler),
       m_watchdog_timer_id(ola::thread::INVALID_TIMEOUT),
+      m_min_dmx_rate(options.min_dmx_rate),
       m_send_cb(NewCallback(this, &EnttecUsbProWidgetImpl::SendCommand)),
       m_uid(options.esta_id ? options.esta_id :
                               EnttecUsbProWidget::ENTTEC_ESTA_ID,
@@ -779,6 +842,10 @@ EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
     AddPort(OperationLabels::Port2Operations(), options.queue_size,
             options.enable_rdm);
     EnableSecondPort();
+    // Both ports send a frame each tick, so write them together. This is
+    // enabled after the port assignment has been sent, since the constructor
+    // may not run in the scheduler's thread.
+    EnableWriteCoalescing(m_scheduler);
   }
   m_watchdog_timer_id = m_scheduler->RegisterRepeatingTimeout(
     TimeInterval(1, 0),
@@ -918,7 +985,8 @@ void EnttecUsbProWidgetImpl::HandlePortAssignment(const uint8_t *data,
 void EnttecUsbProWidgetImpl::AddPort(const OperationLabels &ops,
                                      unsigned int queue_size,
                                      bool enable_rdm) {
-  EnttecPortImpl *impl = new EnttecPortImpl(ops, m_uid, m_send_cb.get());
+  EnttecPortImpl *impl = new EnttecPortImpl(ops, m_uid, m_send_cb.get(),
+                                            m_min_dmx_rate);
   m_port_impls.push_back(impl);
   EnttecPort *port = new EnttecPort(impl, queue_size, enable_rdm);
   m_ports.push_back(port);
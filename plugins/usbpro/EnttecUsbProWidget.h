@@ -31,6 +31,7 @@
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/UIDSet.h"
+#include "plugins/usbpro/DmxRdmScheduler.h"
 #include "plugins/usbpro/GenericUsbProWidget.h"
 
 class EnttecUsbProWidgetTest;
@@ -66,6 +67,7 @@ class EnttecPort
 
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+    void SeedUIDs(const ola::rdm::UIDSet &uids);
 
     // the tests access the implementation directly.
     friend class ::EnttecUsbProWidgetTest;
@@ -97,13 +99,16 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
       bool dual_ports;
       unsigned int queue_size;
       bool enable_rdm;
+      // The minimum DMX refresh rate to keep up during RDM, 0 to disable.
+      unsigned int min_dmx_rate;
 
       EnttecUsbProWidgetOptions()
           : esta_id(0),
             serial(0),
             dual_ports(false),
             queue_size(20),
-            enable_rdm(false) {
+            enable_rdm(false),
+            min_dmx_rate(DmxRdmScheduler::DEFAULT_MIN_DMX_RATE) {
       }
 
       EnttecUsbProWidgetOptions(uint16_t esta_id, uint32_t serial)
@@ -111,7 +116,8 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
             serial(serial),
             dual_ports(false),
             queue_size(20),
-            enable_rdm(false) {
+            enable_rdm(false),
+            min_dmx_rate(DmxRdmScheduler::DEFAULT_MIN_DMX_RATE) {
       }
     };
 
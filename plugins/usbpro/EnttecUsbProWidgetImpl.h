@@ -29,6 +29,7 @@
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/util/Watchdog.h"
+#include "plugins/usbpro/DmxRdmScheduler.h"
 
 namespace ola {
 namespace plugin {
@@ -86,7 +87,9 @@ class EnttecPortImpl
       SendCallback;
 
     EnttecPortImpl(const OperationLabels &ops, const ola::rdm::UID &uid,
-                   SendCallback *send_cb);
+                   SendCallback *send_cb,
+                   unsigned int min_dmx_rate =
+                       DmxRdmScheduler::DEFAULT_MIN_DMX_RATE);
 
     void Stop();
 
@@ -103,6 +106,9 @@ class EnttecPortImpl
                         ola::rdm::RDMCallback *on_complete);
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+    void SeedUIDs(const ola::rdm::UIDSet &uids) {
+      m_discovery_agent.SetKnownUIDs(uids);
+    }
 
     // The following are the implementation of DiscoveryTargetInterface
     void MuteDevice(const ola::rdm::UID &target,
@@ -121,6 +127,10 @@ class EnttecPortImpl
     void ClockWatchdog();
     void WatchdogFired();
 
+    const DmxRdmScheduler::Stats &SchedulerStats() const {
+      return m_dmx_scheduler.GetStats();
+    }
+
  private:
   SendCallback *m_send_cb;
   OperationLabels m_ops;
@@ -131,6 +141,12 @@ class EnttecPortImpl
   DmxBuffer m_input_buffer;
   std::auto_ptr<ola::Callback0<void> > m_dmx_callback;
 
+  // TX DMX. The widget stops sending DMX after each RDM request, so the last
+  // frame is kept to be re-sent in between RDM requests.
+  DmxBuffer m_output_buffer;
+  bool m_dmx_output;
+  DmxRdmScheduler m_dmx_scheduler;
+
   // widget params
   std::deque<usb_pro_params_callback*> m_outstanding_param_callbacks;
 
@@ -155,6 +171,7 @@ class EnttecPortImpl
                          const ola::rdm::UIDSet &uids);
   bool PackAndSendRDMRequest(uint8_t label,
                              const ola::rdm::RDMRequest *request);
+  bool SendDMXFrame(const DmxBuffer &buffer);
   bool IsDUBRequest(const ola::rdm::RDMRequest *request);
 
   static const unsigned int PORT_ID = 1;
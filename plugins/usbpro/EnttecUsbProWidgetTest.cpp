@@ -434,6 +434,40 @@ void EnttecUsbProWidgetTest::testReceiveDMX() {
   m_ss.Run();
   m_endpoint->Verify();
   OLA_ASSERT(m_got_dmx);
+
+  // the data is only as long as the changed slots, and a 0 start code is
+  // allowed
+  buffer.SetFromString("1,10,22,93,144,7");
+  const uint8_t short_change_of_state_data[] = {
+    0, 0x41, 0, 0, 0, 0,
+    0, 7
+  };
+  m_got_dmx = false;
+  m_endpoint->SendUnsolicitedUsbProData(
+      CHANGE_OF_STATE_LABEL,
+      short_change_of_state_data,
+      sizeof(short_change_of_state_data));
+  m_ss.Run();
+  m_endpoint->Verify();
+  OLA_ASSERT(m_got_dmx);
+
+  // slots that are reported as changed, but hold the same value, don't run
+  // the callback
+  const uint8_t no_change_data[] = {
+    0, 0x18, 0, 0, 0, 0,
+    22, 93
+  };
+  m_got_dmx = false;
+  m_endpoint->SendUnsolicitedUsbProData(
+      CHANGE_OF_STATE_LABEL,
+      no_change_data,
+      sizeof(no_change_data));
+  m_ss.RegisterSingleTimeout(
+      100,
+      ola::NewSingleCallback(this, &EnttecUsbProWidgetTest::Terminate));
+  m_ss.Run();
+  m_endpoint->Verify();
+  OLA_ASSERT_FALSE(m_got_dmx);
 }
 
 
@@ -11,6 +11,8 @@ plugins_usbpro_libolausbprowidget_la_SOURCES = \
     plugins/usbpro/BaseRobeWidget.h \
     plugins/usbpro/BaseUsbProWidget.cpp \
     plugins/usbpro/BaseUsbProWidget.h \
+    plugins/usbpro/DmxRdmScheduler.cpp \
+    plugins/usbpro/DmxRdmScheduler.h \
     plugins/usbpro/DmxTriWidget.cpp \
     plugins/usbpro/DmxTriWidget.h \
     plugins/usbpro/DmxterWidget.cpp \
@@ -73,6 +75,7 @@ test_programs += \
     plugins/usbpro/ArduinoWidgetTester \
     plugins/usbpro/BaseRobeWidgetTester \
     plugins/usbpro/BaseUsbProWidgetTester \
+    plugins/usbpro/DmxRdmSchedulerTester \
     plugins/usbpro/DmxTriWidgetTester \
     plugins/usbpro/DmxterWidgetTester \
     plugins/usbpro/EnttecUsbProWidgetTester \
@@ -109,6 +112,11 @@ plugins_usbpro_BaseUsbProWidgetTester_SOURCES = \
 plugins_usbpro_BaseUsbProWidgetTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_usbpro_BaseUsbProWidgetTester_LDADD = $(COMMON_USBPRO_TEST_LDADD)
 
+plugins_usbpro_DmxRdmSchedulerTester_SOURCES = \
+    plugins/usbpro/DmxRdmSchedulerTest.cpp
+plugins_usbpro_DmxRdmSchedulerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_usbpro_DmxRdmSchedulerTester_LDADD = $(COMMON_USBPRO_TEST_LDADD)
+
 plugins_usbpro_DmxTriWidgetTester_SOURCES = \
     plugins/usbpro/DmxTriWidgetTest.cpp \
     $(common_test_sources)
@@ -106,6 +106,10 @@ class RobeOutputPort: public BasicOutputPort {
       m_widget->RunIncrementalDiscovery(callback);
     }
 
+    void SeedUIDs(const ola::rdm::UIDSet &uids) {
+      m_widget->SeedUIDs(uids);
+    }
+
  private:
     RobeWidget *m_widget;
 };
@@ -55,7 +55,8 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
                            EnttecUsbProWidget *widget,
                            uint32_t serial,
                            uint16_t firmware_version,
-                           unsigned int fps_limit)
+                           unsigned int fps_limit,
+                           bool dmx_on_change)
     : UsbSerialDevice(owner, name, widget),
       m_pro_widget(widget),
       m_serial(SerialToString(serial)) {
@@ -77,7 +78,8 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
     }
 
     UsbProInputPort *input_port = new UsbProInputPort(
-        this, enttec_port, i, plugin_adaptor, port_description.str());
+        this, enttec_port, i, plugin_adaptor, port_description.str(),
+        dmx_on_change);
     enttec_port->SetDMXCallback(
         NewCallback(static_cast<InputPort*>(input_port),
                     &InputPort::DmxChanged));
@@ -87,7 +89,8 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
         this, enttec_port, i, port_description.str(),
         plugin_adaptor->WakeUpTime(),
         5,  // allow up to 5 burst frames
-        fps_limit);  // 200 frames per second seems to be the limit
+        fps_limit,  // 200 frames per second seems to be the limit
+        dmx_on_change);
     AddPort(output_port);
 
     PortParams port_params = {false, 0, 0, 0};
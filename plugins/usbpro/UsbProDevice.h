@@ -47,7 +47,8 @@ class UsbProDevice: public UsbSerialDevice {
                EnttecUsbProWidget *widget,
                uint32_t serial,
                uint16_t firmware_version,
-               unsigned int fps_limit);
+               unsigned int fps_limit,
+               bool dmx_on_change);
 
   std::string DeviceId() const { return m_serial; }
 
@@ -115,24 +116,35 @@ class UsbProDevice: public UsbSerialDevice {
 class UsbProInputPort: public BasicInputPort {
  public:
   // The EnttecPort is owner by the caller.
+  // If dmx_on_change is true, the widget only sends the slots that change.
   UsbProInputPort(UsbProDevice *parent,
                   EnttecPort *port,
                   unsigned int id,
                   ola::PluginAdaptor *plugin_adaptor,
-                  const std::string &description = "")
+                  const std::string &description = "",
+                  bool dmx_on_change = false)
       : BasicInputPort(parent, id, plugin_adaptor),
         m_description(description),
-        m_port(port) {}
+        m_port(port),
+        m_dmx_on_change(dmx_on_change) {}
 
   const DmxBuffer &ReadDMX() const {
     return m_port->FetchDMX();
   }
 
+  void PostSetUniverse(Universe*, Universe *new_universe) {
+    // The widget sends every frame by default.
+    if (new_universe && m_dmx_on_change) {
+      m_port->ChangeToReceiveMode(true);
+    }
+  }
+
   std::string Description() const { return m_description; }
 
  private:
   const std::string m_description;
   EnttecPort *m_port;
+  const bool m_dmx_on_change;
 };
 
 
@@ -148,12 +160,14 @@ class UsbProOutputPort: public BasicOutputPort {
                    const std::string &description,
                    const TimeStamp *wake_time,
                    unsigned int max_burst,
-                   unsigned int rate)
+                   unsigned int rate,
+                   bool dmx_on_change)
       : BasicOutputPort(parent, id, port->SupportsRDM(), port->SupportsRDM()),
         m_description(description),
         m_port(port),
         m_bucket(max_burst, rate, max_burst, *wake_time),
-        m_wake_time(wake_time) {}
+        m_wake_time(wake_time),
+        m_dmx_on_change(dmx_on_change) {}
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t) {
     if (m_bucket.GetToken(*m_wake_time)) {
@@ -166,7 +180,7 @@ class UsbProOutputPort: public BasicOutputPort {
 
   void PostSetUniverse(Universe*, Universe *new_universe) {
     if (!new_universe) {
-      m_port->ChangeToReceiveMode(false);
+      m_port->ChangeToReceiveMode(m_dmx_on_change);
     }
   }
 
@@ -183,6 +197,10 @@ class UsbProOutputPort: public BasicOutputPort {
     m_port->RunIncrementalDiscovery(callback);
   }
 
+  void SeedUIDs(const ola::rdm::UIDSet &uids) {
+    m_port->SeedUIDs(uids);
+  }
+
   std::string Description() const { return m_description; }
 
  private:
@@ -190,6 +208,7 @@ class UsbProOutputPort: public BasicOutputPort {
   EnttecPort *m_port;
   TokenBucket m_bucket;
   const TimeStamp *m_wake_time;
+  const bool m_dmx_on_change;
 };
 }  // namespace usbpro
 }  // namespace plugin
@@ -21,14 +21,17 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/io/Serial.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
+#include "olad/plugin_api/PluginModule.h"
 
 #include "plugins/usbpro/ArduinoRGBDevice.h"
 #include "plugins/usbpro/DmxTriDevice.h"
@@ -54,8 +57,11 @@ using std::vector;
 const char UsbSerialPlugin::DEFAULT_DEVICE_DIR[] = "/dev";
 const char UsbSerialPlugin::DEVICE_DIR_KEY[] = "device_dir";
 const char UsbSerialPlugin::DEVICE_PREFIX_KEY[] = "device_prefix";
+const char UsbSerialPlugin::FTDI_LATENCY_TIMER_KEY[] = "ftdi_latency_timer_ms";
 const char UsbSerialPlugin::IGNORED_DEVICES_KEY[] = "ignore_device";
+const char UsbSerialPlugin::KNOWN_DEVICES_KEY[] = "known_device";
 const char UsbSerialPlugin::LINUX_DEVICE_PREFIX[] = "ttyUSB";
+const char UsbSerialPlugin::LOW_LATENCY_KEY[] = "low_latency";
 const char UsbSerialPlugin::BSD_DEVICE_PREFIX[] = "ttyU";
 const char UsbSerialPlugin::MAC_DEVICE_PREFIX[] = "cu.usbserial-";
 const char UsbSerialPlugin::PLUGIN_NAME[] = "Serial USB";
@@ -64,11 +70,13 @@ const char UsbSerialPlugin::ROBE_DEVICE_NAME[] = "Robe Universal Interface";
 const char UsbSerialPlugin::TRI_USE_RAW_RDM_KEY[] = "tri_use_raw_rdm";
 const char UsbSerialPlugin::USBPRO_DEVICE_NAME[] = "Enttec Usb Pro Device";
 const char UsbSerialPlugin::USB_PRO_FPS_LIMIT_KEY[] = "pro_fps_limit";
+const char UsbSerialPlugin::USB_PRO_DMX_ON_CHANGE_KEY[] = "pro_dmx_on_change";
 const char UsbSerialPlugin::ULTRA_FPS_LIMIT_KEY[] = "ultra_fps_limit";
 
 UsbSerialPlugin::UsbSerialPlugin(PluginAdaptor *plugin_adaptor)
     : Plugin(plugin_adaptor),
-      m_detector_thread(this, plugin_adaptor) {
+      m_detector_thread(this, plugin_adaptor, 200, 200,
+                        plugin_adaptor->GetExportMap()) {
 }
 
 
@@ -132,7 +140,9 @@ void UsbSerialPlugin::NewWidget(
 
   AddDevice(new UsbProDevice(m_plugin_adaptor, this, device_name, widget,
                              information.serial, information.firmware_version,
-                             GetProFrameLimit()));
+                             GetProFrameLimit(),
+                             m_preferences->GetValueAsBool(
+                                 USB_PRO_DMX_ON_CHANGE_KEY)));
 }
 
 
@@ -207,6 +217,7 @@ void UsbSerialPlugin::NewWidget(UltraDMXProWidget *widget,
  * @param device the new UsbSerialDevice
  */
 void UsbSerialPlugin::AddDevice(UsbSerialDevice *device) {
+  AddSerialSettingsToName(device);
   if (!device->Start()) {
     delete device;
     return;
@@ -217,6 +228,27 @@ void UsbSerialPlugin::AddDevice(UsbSerialDevice *device) {
                                         device));
   m_devices.push_back(device);
   m_plugin_adaptor->RegisterDevice(device);
+  SaveKnownDevices();
+}
+
+
+/*
+ * Show the latency settings the widget ended up with, since the FTDI latency
+ * timer can only be changed by root.
+ */
+void UsbSerialPlugin::AddSerialSettingsToName(UsbSerialDevice *device) {
+  const int fd = ola::io::ToFD(
+      device->GetWidget()->GetDescriptor()->ReadDescriptor());
+  std::ostringstream str;
+  str << device->Name();
+  unsigned int latency_timer;
+  if (ola::io::GetFtdiLatencyTimer(fd, &latency_timer)) {
+    str << ", latency timer " << latency_timer << "ms";
+  }
+  if (ola::io::IsLowLatency(fd)) {
+    str << ", low latency";
+  }
+  device->SetName(str.str());
 }
 
 
@@ -227,11 +259,20 @@ bool UsbSerialPlugin::StartHook() {
   const vector<string> ignored_devices =
       m_preferences->GetMultipleValue(IGNORED_DEVICES_KEY);
   m_detector_thread.SetIgnoredDevices(ignored_devices);
+  m_detector_thread.SetKnownDevices(
+      m_preferences->GetMultipleValue(KNOWN_DEVICES_KEY));
 
   m_detector_thread.SetDeviceDirectory(
       m_preferences->GetValue(DEVICE_DIR_KEY));
   m_detector_thread.SetDevicePrefixes(
       m_preferences->GetMultipleValue(DEVICE_PREFIX_KEY));
+  unsigned int latency_timer;
+  if (!StringToInt(m_preferences->GetValue(FTDI_LATENCY_TIMER_KEY),
+                   &latency_timer)) {
+    latency_timer = DEFAULT_FTDI_LATENCY_TIMER_MS;
+  }
+  m_detector_thread.SetSerialLatency(
+      m_preferences->GetValueAsBool(LOW_LATENCY_KEY), latency_timer);
   if (!m_detector_thread.Start()) {
     OLA_FATAL << "Failed to start the widget discovery thread";
     return false;
@@ -252,6 +293,7 @@ bool UsbSerialPlugin::StopHook() {
   }
   m_detector_thread.Join(NULL);
   m_devices.clear();
+  SaveKnownDevices();
   return true;
 }
 
@@ -282,6 +324,10 @@ bool UsbSerialPlugin::SetDefaultPreferences() {
                                          UIntValidator(0, MAX_PRO_FPS_LIMIT),
                                          DEFAULT_PRO_FPS_LIMIT);
 
+  save |= m_preferences->SetDefaultValue(USB_PRO_DMX_ON_CHANGE_KEY,
+                                         BoolValidator(),
+                                         false);
+
   save |= m_preferences->SetDefaultValue(ULTRA_FPS_LIMIT_KEY,
                                          UIntValidator(0, MAX_ULTRA_FPS_LIMIT),
                                          DEFAULT_ULTRA_FPS_LIMIT);
@@ -290,6 +336,15 @@ bool UsbSerialPlugin::SetDefaultPreferences() {
                                          BoolValidator(),
                                          false);
 
+  save |= m_preferences->SetDefaultValue(LOW_LATENCY_KEY,
+                                         BoolValidator(),
+                                         true);
+
+  save |= m_preferences->SetDefaultValue(
+      FTDI_LATENCY_TIMER_KEY,
+      UIntValidator(0, MAX_FTDI_LATENCY_TIMER_MS),
+      DEFAULT_FTDI_LATENCY_TIMER_MS);
+
   if (save) {
     m_preferences->Save();
   }
@@ -311,6 +366,25 @@ void UsbSerialPlugin::DeleteDevice(UsbSerialDevice *device) {
 }
 
 
+/**
+ * Save the devices the detector thread has found, so the next time we start
+ * we can go straight to the right detector.
+ */
+void UsbSerialPlugin::SaveKnownDevices() {
+  const vector<string> devices = m_detector_thread.KnownDevices();
+  if (devices == m_preferences->GetMultipleValue(KNOWN_DEVICES_KEY)) {
+    return;
+  }
+
+  m_preferences->RemoveValue(KNOWN_DEVICES_KEY);
+  vector<string>::const_iterator iter = devices.begin();
+  for (; iter != devices.end(); ++iter) {
+    m_preferences->SetMultipleValue(KNOWN_DEVICES_KEY, *iter);
+  }
+  m_preferences->Save();
+}
+
+
 /**
  * Get a nicely formatted device name from the widget information.
  */
@@ -353,3 +427,5 @@ unsigned int UsbSerialPlugin::GetUltraDMXProFrameLimit() {
 }  // namespace usbpro
 }  // namespace plugin
 }  // namespace ola
+
+OLA_PLUGIN_MODULE(ola::plugin::usbpro::UsbSerialPlugin)
@@ -58,10 +58,12 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
 
  private:
     void AddDevice(UsbSerialDevice *device);
+    void AddSerialSettingsToName(UsbSerialDevice *device);
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
     void DeleteDevice(UsbSerialDevice *device);
+    void SaveKnownDevices();
     std::string GetDeviceName(const UsbProWidgetInformation &information);
     unsigned int GetProFrameLimit();
     unsigned int GetDmxTriFrameLimit();
@@ -73,8 +75,11 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     static const char DEFAULT_DEVICE_DIR[];
     static const char DEVICE_DIR_KEY[];
     static const char DEVICE_PREFIX_KEY[];
+    static const char FTDI_LATENCY_TIMER_KEY[];
     static const char IGNORED_DEVICES_KEY[];
+    static const char KNOWN_DEVICES_KEY[];
     static const char LINUX_DEVICE_PREFIX[];
+    static const char LOW_LATENCY_KEY[];
     static const char BSD_DEVICE_PREFIX[];
     static const char MAC_DEVICE_PREFIX[];
     static const char PLUGIN_NAME[];
@@ -83,12 +88,15 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     static const char TRI_USE_RAW_RDM_KEY[];
     static const char USBPRO_DEVICE_NAME[];
     static const char USB_PRO_FPS_LIMIT_KEY[];
+    static const char USB_PRO_DMX_ON_CHANGE_KEY[];
     static const char ULTRA_FPS_LIMIT_KEY[];
 
     static const uint8_t DEFAULT_PRO_FPS_LIMIT = 190;
     static const uint8_t DEFAULT_ULTRA_FPS_LIMIT = 40;
     static const unsigned int MAX_PRO_FPS_LIMIT = 1000;
     static const unsigned int MAX_ULTRA_FPS_LIMIT = 1000;
+    static const uint8_t DEFAULT_FTDI_LATENCY_TIMER_MS = 1;
+    static const unsigned int MAX_FTDI_LATENCY_TIMER_MS = 255;
 };
 }  // namespace usbpro
 }  // namespace plugin
@@ -48,9 +48,15 @@ namespace plugin {
 namespace usbpro {
 
 using ola::io::ConnectedDescriptor;
+using ola::thread::MutexLocker;
 using std::string;
 using std::vector;
 
+const char WidgetDetectorThread::DETECTION_TIME_VAR[] =
+    "usbserial-detection-time-ms";
+const char WidgetDetectorThread::ROBE_DETECTOR_NAME[] = "robe";
+const char WidgetDetectorThread::USB_PRO_DETECTOR_NAME[] = "usbpro";
+
 
 /**
  * Constructor
@@ -60,18 +66,26 @@ using std::vector;
  * you intend to use the Widgets with.
  * @param usb_pro_timeout the time in ms between each USB Pro discovery message.
  * @param robe_timeout the time in ms between each Robe discovery message.
+ * @param export_map the ExportMap to record the time the first scan took, may
+ * be NULL.
  */
 WidgetDetectorThread::WidgetDetectorThread(
   NewWidgetHandler *handler,
   ola::io::SelectServerInterface *ss,
   unsigned int usb_pro_timeout,
-  unsigned int robe_timeout)
-    : ola::thread::Thread(),
+  unsigned int robe_timeout,
+  ExportMap *export_map)
+    : ola::thread::Thread(ola::thread::Thread::Options("widget-detector")),
       m_other_ss(ss),
       m_handler(handler),
       m_is_running(false),
       m_usb_pro_timeout(usb_pro_timeout),
-      m_robe_timeout(robe_timeout) {
+      m_robe_timeout(robe_timeout),
+      m_export_map(export_map),
+      m_low_latency(false),
+      m_ftdi_latency_timer_ms(0),
+      m_first_scan_done(false),
+      m_in_discovery(0) {
   if (!m_handler)
     OLA_FATAL << "No new widget handler registered.";
 }
@@ -109,6 +123,63 @@ void WidgetDetectorThread::SetIgnoredDevices(const vector<string> &devices) {
   }
 }
 
+
+/**
+ * Set the devices we've found before. Discovery for these devices starts with
+ * the detector that found them last time, which avoids waiting for the other
+ * detectors to time out. This should be called before Run().
+ * @param devices a list of path=detector entries, as returned by
+ * KnownDevices().
+ */
+void WidgetDetectorThread::SetKnownDevices(const vector<string> &devices) {
+  MutexLocker locker(&m_known_mutex);
+  m_known_devices.clear();
+  vector<string>::const_iterator iter = devices.begin();
+  for (; iter != devices.end(); ++iter) {
+    string::size_type pos = iter->rfind('=');
+    if (pos == string::npos || pos == 0) {
+      OLA_WARN << "Invalid known device " << *iter;
+      continue;
+    }
+    const string path = iter->substr(0, pos);
+    const string detector = iter->substr(pos + 1);
+    if (detector == USB_PRO_DETECTOR_NAME) {
+      m_known_devices[path] = USB_PRO_DETECTOR;
+    } else if (detector == ROBE_DETECTOR_NAME) {
+      m_known_devices[path] = ROBE_DETECTOR;
+    } else {
+      OLA_WARN << "Unknown detector " << detector << " for " << path;
+    }
+  }
+}
+
+
+/**
+ * Set the serial port latency settings to apply to the devices we open.
+ */
+void WidgetDetectorThread::SetSerialLatency(
+    bool low_latency,
+    unsigned int ftdi_latency_timer_ms) {
+  m_low_latency = low_latency;
+  m_ftdi_latency_timer_ms = ftdi_latency_timer_ms;
+}
+
+
+/**
+ * Return the devices we've found, in the form accepted by SetKnownDevices().
+ */
+vector<string> WidgetDetectorThread::KnownDevices() {
+  vector<string> devices;
+  MutexLocker locker(&m_known_mutex);
+  KnownDeviceMap::const_iterator iter = m_known_devices.begin();
+  for (; iter != m_known_devices.end(); ++iter) {
+    devices.push_back(
+        iter->first + "=" + (iter->second == ROBE_DETECTOR ?
+                             ROBE_DETECTOR_NAME : USB_PRO_DETECTOR_NAME));
+  }
+  return devices;
+}
+
 /**
  * Run the discovery thread.
  */
@@ -127,7 +198,9 @@ void *WidgetDetectorThread::Run() {
         ola::NewCallback(this, &WidgetDetectorThread::DescriptorFailed),
         m_robe_timeout));
   }
+  m_clock.CurrentTime(&m_scan_start);
   RunScan();
+  MaybeCompleteFirstScan();
   m_ss.RegisterRepeatingTimeout(
       SCAN_INTERVAL_MS,
       ola::NewCallback(this, &WidgetDetectorThread::RunScan));
@@ -219,17 +292,47 @@ bool WidgetDetectorThread::RunScan() {
     }
 
     OLA_DEBUG << "New descriptor @ " << descriptor << " for " << *it;
+    ApplySerialLatency(*it, descriptor);
     PerformDiscovery(*it, descriptor);
   }
   return true;
 }
 
+/**
+ * Reduce the time the kernel and FTDI adaptors hold received data for, this
+ * puts a floor under RDM round trips.
+ */
+void WidgetDetectorThread::ApplySerialLatency(
+    const string &path,
+    ConnectedDescriptor *descriptor) {
+  const int fd = ola::io::ToFD(descriptor->ReadDescriptor());
+  if (m_low_latency && !ola::io::SetLowLatency(fd)) {
+    OLA_DEBUG << "Low latency mode isn't available for " << path;
+  }
+  if (m_ftdi_latency_timer_ms &&
+      ola::io::SetFtdiLatencyTimer(fd, m_ftdi_latency_timer_ms)) {
+    OLA_INFO << "Set the FTDI latency timer of " << path << " to "
+             << m_ftdi_latency_timer_ms << "ms";
+  }
+}
+
+
 /**
  * Start the discovery sequence for a widget.
  */
 void WidgetDetectorThread::PerformDiscovery(const string &path,
                                             ConnectedDescriptor *descriptor) {
-  m_active_descriptors[descriptor] = DescriptorInfo(path, -1);
+  DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
+  descriptor_info.path = path;
+  descriptor_info.in_discovery = true;
+  m_in_discovery++;
+  {
+    MutexLocker locker(&m_known_mutex);
+    KnownDeviceMap::const_iterator iter = m_known_devices.find(path);
+    if (iter != m_known_devices.end()) {
+      descriptor_info.first_detector = iter->second;
+    }
+  }
   m_active_paths.insert(path);
   PerformNextDiscoveryStep(descriptor);
 }
@@ -243,6 +346,7 @@ void WidgetDetectorThread::UsbProWidgetReady(
     const UsbProWidgetInformation *information) {
   // we're no longer interested in events from this widget
   m_ss.RemoveReadDescriptor(descriptor);
+  DiscoverySucceeded(descriptor, USB_PRO_DETECTOR);
 
   if (!m_handler) {
     OLA_WARN << "No callback defined for new Usb Pro Widgets.";
@@ -340,6 +444,7 @@ void WidgetDetectorThread::RobeWidgetReady(
     const RobeWidgetInformation *info) {
   // we're no longer interested in events from this descriptor
   m_ss.RemoveReadDescriptor(descriptor);
+  DiscoverySucceeded(descriptor, ROBE_DETECTOR);
   RobeWidget *widget = new RobeWidget(descriptor, info->uid);
 
   if (m_handler) {
@@ -374,17 +479,21 @@ void WidgetDetectorThread::PerformNextDiscoveryStep(
     ConnectedDescriptor *descriptor) {
 
   DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
-  descriptor_info.second++;
+  descriptor_info.stage++;
 
-  if (static_cast<unsigned int>(descriptor_info.second) ==
+  if (static_cast<unsigned int>(descriptor_info.stage) ==
       m_widget_detectors.size()) {
     OLA_INFO << "no more detectors to try for  " << descriptor;
+    ForgetDevice(descriptor_info.path);
     FreeDescriptor(descriptor);
   } else {
-    OLA_INFO << "trying stage " << descriptor_info.second << " for " <<
-      descriptor;
+    unsigned int detector = (descriptor_info.first_detector +
+                             descriptor_info.stage) %
+                            m_widget_detectors.size();
+    OLA_INFO << "trying stage " << descriptor_info.stage << " (detector "
+             << detector << ") for " << descriptor;
     m_ss.AddReadDescriptor(descriptor);
-    bool ok = m_widget_detectors[descriptor_info.second]->Discover(descriptor);
+    bool ok = m_widget_detectors[detector]->Discover(descriptor);
     if (!ok) {
       m_ss.RemoveReadDescriptor(descriptor);
       FreeDescriptor(descriptor);
@@ -413,11 +522,19 @@ void WidgetDetectorThread::InternalFreeWidget(SerialWidgetInterface *widget) {
  */
 void WidgetDetectorThread::FreeDescriptor(ConnectedDescriptor *descriptor) {
   DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
+  const bool in_discovery = descriptor_info.in_discovery;
+  if (in_discovery) {
+    m_in_discovery--;
+  }
 
-  m_active_paths.erase(descriptor_info.first);
-  io::ReleaseUUCPLock(descriptor_info.first);
+  m_active_paths.erase(descriptor_info.path);
+  io::ReleaseUUCPLock(descriptor_info.path);
   m_active_descriptors.erase(descriptor);
   delete descriptor;
+
+  if (in_discovery) {
+    MaybeCompleteFirstScan();
+  }
 }
 
 
@@ -464,6 +581,54 @@ void WidgetDetectorThread::MarkAsRunning() {
   m_mutex.Unlock();
   m_condition.Signal();
 }
+
+
+/**
+ * Called when a detector finds a widget.
+ */
+void WidgetDetectorThread::DiscoverySucceeded(ConnectedDescriptor *descriptor,
+                                              DetectorType detector) {
+  DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
+  {
+    MutexLocker locker(&m_known_mutex);
+    m_known_devices[descriptor_info.path] = detector;
+  }
+  if (descriptor_info.in_discovery) {
+    descriptor_info.in_discovery = false;
+    m_in_discovery--;
+    MaybeCompleteFirstScan();
+  }
+}
+
+
+/**
+ * Record how long it took to discover the widgets present at startup.
+ */
+void WidgetDetectorThread::MaybeCompleteFirstScan() {
+  if (m_first_scan_done || m_in_discovery) {
+    return;
+  }
+  m_first_scan_done = true;
+
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+  int64_t duration = (now - m_scan_start).InMilliSeconds();
+  OLA_INFO << "Initial USB serial widget scan took " << duration << "ms, "
+           << m_active_descriptors.size() << " widgets found";
+  if (m_export_map) {
+    m_export_map->GetIntegerVar(DETECTION_TIME_VAR)->Set(
+        static_cast<int>(duration));
+  }
+}
+
+
+/**
+ * Remove a device from the cache, because none of the detectors found it.
+ */
+void WidgetDetectorThread::ForgetDevice(const string &path) {
+  MutexLocker locker(&m_known_mutex);
+  m_known_devices.erase(path);
+}
 }  // namespace usbpro
 }  // namespace plugin
 }  // namespace ola
@@ -28,6 +28,8 @@
 #include <vector>
 #include <utility>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/SelectServer.h"
 #include "ola/thread/Thread.h"
@@ -76,7 +78,8 @@ class WidgetDetectorThread: public ola::thread::Thread {
     explicit WidgetDetectorThread(NewWidgetHandler *widget_handler,
                                   ola::io::SelectServerInterface *ss,
                                   unsigned int usb_pro_timeout = 200,
-                                  unsigned int robe_timeout = 200);
+                                  unsigned int robe_timeout = 200,
+                                  ExportMap *export_map = NULL);
     ~WidgetDetectorThread() {}
 
     // Must be called before Run()
@@ -85,6 +88,15 @@ class WidgetDetectorThread: public ola::thread::Thread {
     void SetDevicePrefixes(const std::vector<std::string> &prefixes);
     // Must be called before Run()
     void SetIgnoredDevices(const std::vector<std::string> &devices);
+    // Must be called before Run()
+    void SetKnownDevices(const std::vector<std::string> &devices);
+    // Must be called before Run(). A latency timer of 0 leaves FTDI
+    // adaptors as they are.
+    void SetSerialLatency(bool low_latency, unsigned int ftdi_latency_timer_ms);
+
+    // Returns the devices we've detected, in the form accepted by
+    // SetKnownDevices(). This can be called from any thread.
+    std::vector<std::string> KnownDevices();
 
     // Start the thread, this will call the SuccessHandler whenever a new
     // Widget is located.
@@ -116,13 +128,42 @@ class WidgetDetectorThread: public ola::thread::Thread {
     bool m_is_running;
     unsigned int m_usb_pro_timeout;
     unsigned int m_robe_timeout;
+    ExportMap *m_export_map;
+    bool m_low_latency;
+    unsigned int m_ftdi_latency_timer_ms;
     ola::thread::Mutex m_mutex;
     ola::thread::ConditionVariable m_condition;
 
+    // The order of m_widget_detectors.
+    typedef enum {
+      USB_PRO_DETECTOR,
+      ROBE_DETECTOR,
+    } DetectorType;
+
+    // Map of path to the detector that found a widget there, so we can try
+    // that one first next time. Protected by m_known_mutex.
+    typedef std::map<std::string, DetectorType> KnownDeviceMap;
+    KnownDeviceMap m_known_devices;
+    ola::thread::Mutex m_known_mutex;
+
+    // Used to time the first scan.
+    ola::Clock m_clock;
+    ola::TimeStamp m_scan_start;
+    bool m_first_scan_done;
+    unsigned int m_in_discovery;
+
     // those paths that are either in discovery, or in use
     std::set<std::string> m_active_paths;
-    // holds the path and current widget detector offset
-    typedef std::pair<std::string, int> DescriptorInfo;
+
+    // The state of a descriptor.
+    struct DescriptorInfo {
+      DescriptorInfo() : stage(-1), first_detector(0), in_discovery(false) {}
+
+      std::string path;
+      int stage;  // the number of detectors we've tried, less one
+      unsigned int first_detector;  // the detector to try first
+      bool in_discovery;
+    };
     // map of descriptor to DescriptorInfo
     typedef std::map<ola::io::ConnectedDescriptor*, DescriptorInfo>
       ActiveDescriptors;
@@ -148,7 +189,17 @@ class WidgetDetectorThread: public ola::thread::Thread {
     void SignalNewWidget(WidgetType *widget, const InfoType *information);
 
     void MarkAsRunning();
+    void ApplySerialLatency(const std::string &path,
+                            ola::io::ConnectedDescriptor *descriptor);
+
+    void DiscoverySucceeded(ola::io::ConnectedDescriptor *descriptor,
+                            DetectorType detector);
+    void MaybeCompleteFirstScan();
+    void ForgetDevice(const std::string &path);
 
+    static const char DETECTION_TIME_VAR[];
+    static const char ROBE_DETECTOR_NAME[];
+    static const char USB_PRO_DETECTOR_NAME[];
     static const unsigned int SCAN_INTERVAL_MS = 20000;
 
     // This is how device identification is done, see
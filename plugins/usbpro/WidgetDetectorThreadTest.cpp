@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ola/Callback.h"
 #include "ola/Logging.h"
@@ -56,6 +57,7 @@ using ola::plugin::usbpro::WidgetDetectorThread;
 using ola::rdm::UID;
 using std::auto_ptr;
 using std::string;
+using std::vector;
 
 
 /**
@@ -95,6 +97,7 @@ class WidgetDetectorThreadTest: public CppUnit::TestFixture,
   CPPUNIT_TEST(testUsbProMkIIWidget);
   CPPUNIT_TEST(testUsbProMkIIBWidget);
   CPPUNIT_TEST(testRobeWidget);
+  CPPUNIT_TEST(testKnownRobeWidget);
   CPPUNIT_TEST(testUltraDmxWidget);
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testClose);
@@ -111,6 +114,7 @@ class WidgetDetectorThreadTest: public CppUnit::TestFixture,
     void testUsbProMkIIWidget();
     void testUsbProMkIIBWidget();
     void testRobeWidget();
+    void testKnownRobeWidget();
     void testUltraDmxWidget();
     void testTimeout();
     void testClose();
@@ -486,6 +490,40 @@ void WidgetDetectorThreadTest::testRobeWidget() {
   m_thread->WaitUntilRunning();
   m_ss.Run();
   OLA_ASSERT_EQ(ROBE, m_received_widget_type);
+
+  vector<string> known_devices = m_thread->KnownDevices();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), known_devices.size());
+  OLA_ASSERT_EQ(string("/mock_device=robe"), known_devices[0]);
+}
+
+
+/**
+ * Check that a Robe widget we've seen before skips the USB Pro detector.
+ */
+void WidgetDetectorThreadTest::testKnownRobeWidget() {
+  vector<string> known_devices;
+  known_devices.push_back("/mock_device=robe");
+  known_devices.push_back("/other_device=foo");
+  known_devices.push_back("invalid");
+  m_thread->SetKnownDevices(known_devices);
+
+  uint8_t info_data[] = {1, 11, 3, 0, 0};
+  uint8_t uid_data[] = {0x52, 0x53, 2, 0, 0, 10};
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::INFO_REQUEST, NULL, 0,
+      BaseRobeWidget::INFO_RESPONSE, info_data, sizeof(info_data));
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::UID_REQUEST, NULL, 0,
+      BaseRobeWidget::UID_RESPONSE, uid_data, sizeof(uid_data));
+
+  m_thread->Start();
+  m_thread->WaitUntilRunning();
+  m_ss.Run();
+  OLA_ASSERT_EQ(ROBE, m_received_widget_type);
+
+  known_devices = m_thread->KnownDevices();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), known_devices.size());
+  OLA_ASSERT_EQ(string("/mock_device=robe"), known_devices[0]);
 }
 
 
@@ -536,6 +574,7 @@ void WidgetDetectorThreadTest::testTimeout() {
   m_thread->WaitUntilRunning();
   m_ss.Run();
   OLA_ASSERT_EQ(NONE, m_received_widget_type);
+  OLA_ASSERT_TRUE(m_thread->KnownDevices().empty());
 }
 
 
@@ -1,3 +1,4 @@
+include tools/benchmark/Makefile.mk
 include tools/ja-rule/Makefile.mk
 include tools/logic/Makefile.mk
 include tools/ola_trigger/Makefile.mk
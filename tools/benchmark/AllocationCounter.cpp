@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * AllocationCounter.cpp
+ * Count the calls to operator new.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+#include "tools/benchmark/AllocationCounter.h"
+
+namespace {
+uint64_t allocations = 0;  // atomic
+
+void *CountedAllocate(size_t size) {
+  __sync_fetch_and_add(&allocations, 1);
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}  // namespace
+
+namespace ola {
+namespace benchmark {
+
+uint64_t AllocationCount() {
+  return __sync_fetch_and_add(&allocations, 0);
+}
+}  // namespace benchmark
+}  // namespace ola
+
+#if __cplusplus >= 201103L
+#define THROWS_BAD_ALLOC
+#else
+#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+#endif  // __cplusplus >= 201103L
+
+void *operator new(size_t size) THROWS_BAD_ALLOC {
+  return CountedAllocate(size);
+}
+
+void *operator new[](size_t size) THROWS_BAD_ALLOC {
+  return CountedAllocate(size);
+}
+
+void operator delete(void *ptr) throw() {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+  free(ptr);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void *ptr, size_t) throw() {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) throw() {
+  free(ptr);
+}
+#endif  // __cpp_sized_deallocation
@@ -0,0 +1,39 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * AllocationCounter.h
+ * Count the calls to operator new.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_BENCHMARK_ALLOCATIONCOUNTER_H_
+#define TOOLS_BENCHMARK_ALLOCATIONCOUNTER_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace benchmark {
+
+/**
+ * @brief The number of times operator new or new[] has been called.
+ *
+ * AllocationCounter.cpp replaces the global operator new and delete, so
+ * this only works in programs which link it. It may be called from any
+ * thread.
+ */
+uint64_t AllocationCount();
+}  // namespace benchmark
+}  // namespace ola
+#endif  // TOOLS_BENCHMARK_ALLOCATIONCOUNTER_H_
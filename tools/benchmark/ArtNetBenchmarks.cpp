@@ -0,0 +1,143 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ArtNetBenchmarks.cpp
+ * Benchmarks for sending and receiving ArtDmx packets.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Interface.h"
+#include "ola/network/MACAddress.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "plugins/artnet/ArtNetNode.h"
+#include "tools/benchmark/Benchmark.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::network::IPV4Address;
+using ola::network::Interface;
+using ola::network::InterfaceBuilder;
+using ola::network::MACAddress;
+using ola::plugin::artnet::ArtNetNode;
+using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::testing::MockUDPSocket;
+
+namespace {
+
+const uint8_t PORT_ID = 1;
+const uint16_t ARTNET_PORT = 6454;
+
+Interface BenchmarkInterface() {
+  InterfaceBuilder builder;
+  builder.SetAddress("10.0.0.1");
+  builder.SetSubnetMask("255.0.0.0");
+  builder.SetBroadcast("10.255.255.255");
+  builder.SetHardwareAddress(MACAddress::FromStringOrDie("0a:0b:0c:12:34:56"));
+  return builder.Construct();
+}
+
+void FillBuffer(DmxBuffer *buffer) {
+  buffer->Blackout();
+  for (unsigned int i = 0; i < DMX_UNIVERSE_SIZE; i++) {
+    buffer->SetChannel(i, static_cast<uint8_t>(i));
+  }
+}
+
+void NewDmx() {}
+
+/*
+ * Send ArtDmx packets, the socket discards them.
+ */
+void ArtNetBuild(BenchmarkState *state) {
+  ola::io::SelectServer ss;
+  MockUDPSocket *socket = new MockUDPSocket();
+  socket->SetDiscardMode(true);
+  ArtNetNodeOptions options;
+  options.always_broadcast = true;
+  ArtNetNode node(BenchmarkInterface(), &ss, options, socket);
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetInputPortUniverse(PORT_ID, 3);
+  if (!node.Start()) {
+    state->SetError("Failed to start the ArtNet node");
+    return;
+  }
+
+  DmxBuffer buffer;
+  FillBuffer(&buffer);
+  while (state->KeepRunning()) {
+    node.SendDMX(PORT_ID, buffer);
+  }
+  node.Stop();
+}
+
+/*
+ * Receive ArtDmx packets for an output port.
+ */
+void ArtNetParse(BenchmarkState *state) {
+  ola::io::SelectServer ss;
+  MockUDPSocket *socket = new MockUDPSocket();
+  socket->SetDiscardMode(true);
+  ArtNetNodeOptions options;
+  ArtNetNode node(BenchmarkInterface(), &ss, options, socket);
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetOutputPortUniverse(PORT_ID, 3);
+  DmxBuffer output;
+  node.SetDMXHandler(PORT_ID, &output, NewCallback(NewDmx));
+  if (!node.Start()) {
+    state->SetError("Failed to start the ArtNet node");
+    return;
+  }
+
+  uint8_t packet[18 + DMX_UNIVERSE_SIZE] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0x02, 0x00,  // dmx length
+  };
+  for (unsigned int i = 0; i < DMX_UNIVERSE_SIZE; i++) {
+    packet[18 + i] = static_cast<uint8_t>(i);
+  }
+
+  IPV4Address peer;
+  IPV4Address::FromString("10.0.0.10", &peer);
+  while (state->KeepRunning()) {
+    socket->InjectData(packet, sizeof(packet), peer, ARTNET_PORT);
+  }
+  node.Stop();
+  if (output.Size() != DMX_UNIVERSE_SIZE) {
+    state->SetError("The ArtDmx packet wasn't received");
+  }
+}
+}  // namespace
+
+void RegisterArtNetBenchmarks(BenchmarkRunner *runner) {
+  runner->Add("ArtNet/Build", ArtNetBuild);
+  runner->Add("ArtNet/Parse", ArtNetParse);
+}
+}  // namespace benchmark
+}  // namespace ola
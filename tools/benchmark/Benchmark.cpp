@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Benchmark.cpp
+ * A minimal microbenchmark harness.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "tools/benchmark/Benchmark.h"
+
+#include <stdint.h>
+#include <time.h>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Version.h"
+#include "ola/strings/Format.h"
+#include "ola/web/JsonStreamWriter.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::web::JsonStreamWriter;
+using std::string;
+using std::vector;
+
+const unsigned int BenchmarkRunner::MAX_ITERATIONS;
+
+namespace {
+
+const void *volatile result_sink = NULL;
+
+/*
+ * How much to grow the iterations by if a run was too short. We aim a bit
+ * over the minimum time so we don't need another run.
+ */
+double Multiplier(const TimeInterval &elapsed, const TimeInterval &target) {
+  const double MAX_MULTIPLIER = 10.0;
+  if (elapsed.AsInt() <= 0) {
+    return MAX_MULTIPLIER;
+  }
+  double multiplier = 1.4 * target.AsInt() / elapsed.AsInt();
+  return multiplier > MAX_MULTIPLIER ? MAX_MULTIPLIER : multiplier;
+}
+
+string CurrentDate() {
+  time_t now = time(NULL);
+  struct tm now_tm;
+#ifdef _WIN32
+  localtime_s(&now_tm, &now);
+#else
+  localtime_r(&now, &now_tm);
+#endif  // _WIN32
+  char date[32];
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &now_tm);
+  return date;
+}
+}  // namespace
+
+void DoNotOptimize(const void *pointer) {
+  result_sink = pointer;
+}
+
+BenchmarkState::BenchmarkState(unsigned int iterations, unsigned int arg)
+    : m_iterations(iterations),
+      m_arg(arg),
+      m_remaining(iterations),
+      m_finished(false),
+      m_items(0),
+      m_start_cpu(0),
+      m_cpu_seconds(0) {
+}
+
+void BenchmarkState::Start() {
+  m_start_cpu = std::clock();
+  m_clock.CurrentTime(&m_start_time);
+}
+
+void BenchmarkState::Stop() {
+  if (m_finished) {
+    return;
+  }
+  TimeStamp end;
+  m_clock.CurrentTime(&end);
+  m_cpu_seconds = static_cast<double>(std::clock() - m_start_cpu) /
+                  CLOCKS_PER_SEC;
+  m_elapsed = end - m_start_time;
+  m_finished = true;
+}
+
+BenchmarkRunner::BenchmarkRunner(const TimeInterval &min_time,
+                                 const string &filter)
+    : m_min_time(min_time),
+      m_filter(filter) {
+}
+
+void BenchmarkRunner::Add(const string &name, BenchmarkFunction function) {
+  Benchmark benchmark = {name, function, 0};
+  m_benchmarks.push_back(benchmark);
+}
+
+void BenchmarkRunner::Add(const string &name, BenchmarkFunction function,
+                          unsigned int arg) {
+  Benchmark benchmark = {name + "/" + ola::strings::IntToString(arg),
+                         function, arg};
+  m_benchmarks.push_back(benchmark);
+}
+
+bool BenchmarkRunner::Run(string *json) {
+  JsonStreamWriter writer(json);
+  writer.StartObject();
+  writer.AddObject("context");
+  writer.Add("date", CurrentDate());
+  writer.Add("executable", "ola_benchmark");
+  writer.Add("ola_version", ola::base::Version::GetVersion());
+  writer.Add("min_time_usec", static_cast<unsigned int>(m_min_time.AsInt()));
+  writer.End();
+
+  bool ok = true;
+  writer.AddArray("benchmarks");
+  vector<Benchmark>::const_iterator iter = m_benchmarks.begin();
+  for (; iter != m_benchmarks.end(); ++iter) {
+    if (!Matches(*iter)) {
+      continue;
+    }
+
+    unsigned int iterations = 1;
+    string error;
+    TimeInterval elapsed;
+    double cpu_seconds = 0;
+    uint64_t items = 0;
+    while (true) {
+      BenchmarkState state(iterations, iter->arg);
+      iter->function(&state);
+      if (!state.Error().empty()) {
+        error = state.Error();
+        break;
+      }
+      if (!state.Finished()) {
+        error = "the KeepRunning() loop didn't complete";
+        break;
+      }
+
+      elapsed = state.ElapsedTime();
+      cpu_seconds = state.CPUSeconds();
+      items = state.ItemsProcessed();
+      if (elapsed >= m_min_time || iterations >= MAX_ITERATIONS) {
+        break;
+      }
+      double next = iterations * Multiplier(elapsed, m_min_time);
+      iterations = next >= MAX_ITERATIONS ? MAX_ITERATIONS :
+          (next > iterations ? static_cast<unsigned int>(next) :
+           iterations + 1);
+    }
+
+    writer.StartObject();
+    writer.Add("name", iter->name);
+    writer.Add("run_name", iter->name);
+    writer.Add("run_type", "iteration");
+    if (!error.empty()) {
+      ok = false;
+      writer.Add("error_occurred", true);
+      writer.Add("error_message", error);
+      std::cerr << std::left << std::setw(40) << iter->name << " FAILED: "
+                << error << std::endl;
+    } else {
+      const double seconds = elapsed.AsInt() / 1000000.0;
+      const double real_time = seconds * 1e9 / iterations;
+      writer.Add("iterations", iterations);
+      writer.Add("real_time", real_time);
+      writer.Add("cpu_time", cpu_seconds * 1e9 / iterations);
+      writer.Add("time_unit", "ns");
+      if (items && seconds > 0) {
+        writer.Add("items_per_second", items / seconds);
+      }
+      std::cerr << std::left << std::setw(40) << iter->name << std::right
+                << std::setw(14) << std::fixed << std::setprecision(1)
+                << real_time << " ns" << std::setw(12) << iterations
+                << std::endl;
+    }
+    writer.End();
+  }
+  writer.End();
+  writer.End();
+  return ok;
+}
+
+void BenchmarkRunner::Names(vector<string> *names) const {
+  vector<Benchmark>::const_iterator iter = m_benchmarks.begin();
+  for (; iter != m_benchmarks.end(); ++iter) {
+    if (Matches(*iter)) {
+      names->push_back(iter->name);
+    }
+  }
+}
+
+bool BenchmarkRunner::Matches(const Benchmark &benchmark) const {
+  return m_filter.empty() || benchmark.name.find(m_filter) != string::npos;
+}
+}  // namespace benchmark
+}  // namespace ola
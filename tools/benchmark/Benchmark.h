@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Benchmark.h
+ * A minimal microbenchmark harness.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_BENCHMARK_BENCHMARK_H_
+#define TOOLS_BENCHMARK_BENCHMARK_H_
+
+#include <stdint.h>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace benchmark {
+
+/**
+ * @brief The state passed to a benchmark function.
+ *
+ * A benchmark does its setup, then runs the code to be measured in a
+ * KeepRunning() loop:
+ * @code
+ *   void DmxBufferCopy(BenchmarkState *state) {
+ *     DmxBuffer source, destination;
+ *     source.Blackout();
+ *     while (state->KeepRunning()) {
+ *       destination = source;
+ *     }
+ *   }
+ * @endcode
+ * Only the time spent in the loop is measured.
+ */
+class BenchmarkState {
+ public:
+  BenchmarkState(unsigned int iterations, unsigned int arg);
+
+  /**
+   * @brief Check if another iteration should be run.
+   *
+   * The timer starts on the first call and stops once the iterations have
+   * been run.
+   */
+  bool KeepRunning() {
+    if (m_remaining == m_iterations) {
+      Start();
+    }
+    if (m_remaining) {
+      m_remaining--;
+      return true;
+    }
+    Stop();
+    return false;
+  }
+
+  /**
+   * @brief The argument the benchmark was registered with, e.g. the number of
+   *   sources to merge.
+   */
+  unsigned int Arg() const { return m_arg; }
+
+  unsigned int Iterations() const { return m_iterations; }
+
+  /**
+   * @brief Set the number of items processed, this is reported as
+   *   items_per_second.
+   */
+  void SetItemsProcessed(uint64_t items) { m_items = items; }
+
+  /**
+   * @brief Mark the benchmark as failed, e.g. if the setup didn't work.
+   */
+  void SetError(const std::string &error) { m_error = error; }
+
+  bool Finished() const { return m_finished; }
+  uint64_t ItemsProcessed() const { return m_items; }
+  const std::string &Error() const { return m_error; }
+  const TimeInterval &ElapsedTime() const { return m_elapsed; }
+  double CPUSeconds() const { return m_cpu_seconds; }
+
+ private:
+  const unsigned int m_iterations;
+  const unsigned int m_arg;
+  unsigned int m_remaining;
+  bool m_finished;
+  uint64_t m_items;
+  std::string m_error;
+  MonotonicClock m_clock;
+  TimeStamp m_start_time;
+  std::clock_t m_start_cpu;
+  TimeInterval m_elapsed;
+  double m_cpu_seconds;
+
+  void Start();
+  void Stop();
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkState);
+};
+
+/**
+ * @brief Stop the compiler optimizing away a result.
+ * @param pointer the result.
+ */
+void DoNotOptimize(const void *pointer);
+
+typedef void (*BenchmarkFunction)(BenchmarkState *state);
+
+/**
+ * @brief Runs the registered benchmarks and writes the results as JSON.
+ *
+ * Each benchmark is run with an increasing number of iterations until it takes
+ * at least the minimum time. The JSON matches the format written by Google
+ * Benchmark, so the same tools can be used to compare two runs.
+ */
+class BenchmarkRunner {
+ public:
+  /**
+   * @param min_time the minimum time to run each benchmark for.
+   * @param filter only run the benchmarks with this in their name, an empty
+   *   string runs them all.
+   */
+  BenchmarkRunner(const TimeInterval &min_time, const std::string &filter);
+
+  /**
+   * @brief Register a benchmark.
+   * @param name the name of the benchmark.
+   * @param function the function to run.
+   */
+  void Add(const std::string &name, BenchmarkFunction function);
+
+  /**
+   * @brief Register a benchmark with an argument.
+   * @param name the name of the benchmark, the argument is appended.
+   * @param function the function to run.
+   * @param arg the argument, available from BenchmarkState::Arg().
+   */
+  void Add(const std::string &name, BenchmarkFunction function,
+           unsigned int arg);
+
+  /**
+   * @brief Run the benchmarks.
+   * @param[out] json the results.
+   * @returns false if any of the benchmarks failed.
+   */
+  bool Run(std::string *json);
+
+  /**
+   * @brief The names of the benchmarks which match the filter.
+   */
+  void Names(std::vector<std::string> *names) const;
+
+  static const unsigned int MAX_ITERATIONS = 1000000000;
+
+ private:
+  struct Benchmark {
+    std::string name;
+    BenchmarkFunction function;
+    unsigned int arg;
+  };
+
+  const TimeInterval m_min_time;
+  const std::string m_filter;
+  std::vector<Benchmark> m_benchmarks;
+
+  bool Matches(const Benchmark &benchmark) const;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkRunner);
+};
+
+// Each file of benchmarks provides a function to register them.
+void RegisterDmxBenchmarks(BenchmarkRunner *runner);
+void RegisterProtocolBenchmarks(BenchmarkRunner *runner);
+void RegisterArtNetBenchmarks(BenchmarkRunner *runner);
+void RegisterRpcBenchmarks(BenchmarkRunner *runner);
+void RegisterUtilBenchmarks(BenchmarkRunner *runner);
+}  // namespace benchmark
+}  // namespace ola
+#endif  // TOOLS_BENCHMARK_BENCHMARK_H_
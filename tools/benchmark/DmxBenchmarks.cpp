@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxBenchmarks.cpp
+ * Benchmarks for DmxBuffer and the Universe merge.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Array.h"
+#include "ola/plugin_id.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/PortBroker.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "tools/benchmark/Benchmark.h"
+
+namespace ola {
+namespace benchmark {
+
+using std::vector;
+
+namespace {
+
+const unsigned int UNIVERSE_ID = 1;
+const unsigned int MAX_SOURCES = 64;
+
+/*
+ * Fill a buffer with a pattern which differs for each source.
+ */
+void FillBuffer(unsigned int source, DmxBuffer *buffer) {
+  buffer->Blackout();
+  for (unsigned int i = 0; i < DMX_UNIVERSE_SIZE; i++) {
+    buffer->SetChannel(i, static_cast<uint8_t>(i * (source + 1)));
+  }
+}
+
+void DmxBufferSet(BenchmarkState *state) {
+  DmxBuffer source;
+  FillBuffer(0, &source);
+  DmxBuffer buffer;
+  while (state->KeepRunning()) {
+    buffer.Set(source.GetRaw(), source.Size());
+  }
+  DoNotOptimize(&buffer);
+}
+
+void DmxBufferCopy(BenchmarkState *state) {
+  DmxBuffer source;
+  FillBuffer(0, &source);
+  DmxBuffer buffer;
+  while (state->KeepRunning()) {
+    buffer = source;
+  }
+  DoNotOptimize(&buffer);
+}
+
+void DmxBufferSetRange(BenchmarkState *state) {
+  DmxBuffer source;
+  FillBuffer(0, &source);
+  DmxBuffer buffer;
+  buffer.Blackout();
+  while (state->KeepRunning()) {
+    buffer.SetRange(100, source.GetRaw(), 100);
+  }
+  DoNotOptimize(&buffer);
+}
+
+void DmxBufferCompare(BenchmarkState *state) {
+  DmxBuffer buffer1, buffer2;
+  FillBuffer(0, &buffer1);
+  FillBuffer(0, &buffer2);
+  unsigned int equal = 0;
+  while (state->KeepRunning()) {
+    if (buffer1 == buffer2) {
+      equal++;
+    }
+  }
+  DoNotOptimize(&equal);
+}
+
+void DmxBufferHTPMerge(BenchmarkState *state) {
+  vector<DmxBuffer> sources(state->Arg());
+  for (unsigned int i = 0; i < sources.size(); i++) {
+    FillBuffer(i, &sources[i]);
+  }
+  DmxBuffer output;
+  while (state->KeepRunning()) {
+    output.Reset();
+    for (unsigned int i = 0; i < sources.size(); i++) {
+      output.HTPMerge(sources[i]);
+    }
+  }
+  DoNotOptimize(&output);
+  state->SetItemsProcessed(static_cast<uint64_t>(state->Iterations()) *
+                           sources.size());
+}
+
+void DmxBufferHTPMergeMany(BenchmarkState *state) {
+  vector<DmxBuffer> sources(state->Arg());
+  const DmxBuffer *source_ptrs[MAX_SOURCES];
+  for (unsigned int i = 0; i < sources.size(); i++) {
+    FillBuffer(i, &sources[i]);
+    source_ptrs[i] = &sources[i];
+  }
+  DmxBuffer output;
+  while (state->KeepRunning()) {
+    output.HTPMergeMany(source_ptrs, sources.size());
+  }
+  DoNotOptimize(&output);
+  state->SetItemsProcessed(static_cast<uint64_t>(state->Iterations()) *
+                           sources.size());
+}
+
+/*
+ * A Universe in HTP mode with Arg() input ports and one output port. Each
+ * iteration changes the data on one of the ports, which runs MergeAll() and
+ * writes the result to the output port.
+ */
+void UniverseMergeAll(BenchmarkState *state) {
+  MemoryPreferences preferences("benchmark");
+  UniverseStore store(&preferences, NULL);
+  PortBroker broker;
+  PortManager port_manager(&store, &broker);
+
+  Clock clock;
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  MockSelectServer ss(&now);
+  PluginAdaptor plugin_adaptor(NULL, &ss, NULL, NULL, NULL, NULL);
+  TestMockPlugin plugin(&plugin_adaptor, OLA_PLUGIN_DUMMY);
+
+  const unsigned int source_count = state->Arg();
+  vector<MockDevice*> devices;
+  vector<TestMockInputPort*> ports;
+  for (unsigned int i = 0; i < source_count; i++) {
+    devices.push_back(
+        new MockDevice(&plugin, "input-" + strings::IntToString(i)));
+    TestMockInputPort *port = new TestMockInputPort(devices.back(), 1,
+                                                    &plugin_adaptor);
+    ports.push_back(port);
+    port_manager.PatchPort(port, UNIVERSE_ID);
+  }
+  MockDevice output_device(&plugin, "output");
+  TestMockOutputPort output_port(&output_device, 1);
+  port_manager.PatchPort(&output_port, UNIVERSE_ID);
+
+  Universe *universe = store.GetUniverseOrCreate(UNIVERSE_ID);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  vector<DmxBuffer> frames(source_count);
+  for (unsigned int i = 0; i < source_count; i++) {
+    FillBuffer(i, &frames[i]);
+    ports[i]->WriteDMX(frames[i]);
+    ports[i]->DmxChanged();
+  }
+
+  unsigned int i = 0;
+  while (state->KeepRunning()) {
+    const unsigned int port = i % source_count;
+    // Change a slot, otherwise the universe skips the unchanged frame.
+    frames[port].SetChannel(0, static_cast<uint8_t>(i));
+    ports[port]->WriteDMX(frames[port]);
+    ports[port]->DmxChanged();
+    i++;
+  }
+  DoNotOptimize(&universe->GetDMX());
+
+  for (unsigned int i = 0; i < source_count; i++) {
+    port_manager.UnPatchPort(ports[i]);
+  }
+  port_manager.UnPatchPort(&output_port);
+  STLDeleteElements(&ports);
+  STLDeleteElements(&devices);
+}
+}  // namespace
+
+void RegisterDmxBenchmarks(BenchmarkRunner *runner) {
+  runner->Add("DmxBuffer/Set", DmxBufferSet);
+  runner->Add("DmxBuffer/Copy", DmxBufferCopy);
+  runner->Add("DmxBuffer/SetRange", DmxBufferSetRange);
+  runner->Add("DmxBuffer/Compare", DmxBufferCompare);
+
+  const unsigned int merge_sources[] = {2, 4, 16, MAX_SOURCES};
+  for (unsigned int i = 0; i < arraysize(merge_sources); i++) {
+    runner->Add("DmxBuffer/HTPMerge", DmxBufferHTPMerge, merge_sources[i]);
+    runner->Add("DmxBuffer/HTPMergeMany", DmxBufferHTPMergeMany,
+                merge_sources[i]);
+  }
+
+  const unsigned int universe_sources[] = {1, 2, 4, 16, MAX_SOURCES};
+  for (unsigned int i = 0; i < arraysize(universe_sources); i++) {
+    runner->Add("Universe/MergeAll", UniverseMergeAll, universe_sources[i]);
+  }
+}
+}  // namespace benchmark
+}  // namespace ola
@@ -0,0 +1,93 @@
+# PROGRAMS
+##################################################
+if BUILD_TESTS
+noinst_PROGRAMS += tools/benchmark/ola_benchmark
+
+tools_benchmark_ola_benchmark_SOURCES = \
+    tools/benchmark/Benchmark.cpp \
+    tools/benchmark/Benchmark.h \
+    tools/benchmark/DmxBenchmarks.cpp \
+    tools/benchmark/OlaBenchmark.cpp \
+    tools/benchmark/ProtocolBenchmarks.cpp \
+    tools/benchmark/RpcBenchmarks.cpp \
+    tools/benchmark/UtilBenchmarks.cpp
+nodist_tools_benchmark_ola_benchmark_SOURCES = \
+    common/rpc/TestService.pb.cc \
+    common/rpc/TestServiceService.pb.cpp
+tools_benchmark_ola_benchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS_ONLY_WARNINGS)
+tools_benchmark_ola_benchmark_LDADD = \
+    $(CPPUNIT_LIBS) \
+    $(libprotobuf_LIBS) \
+    common/testing/libolatesting.la \
+    olad/plugin_api/libolaserverplugininterface.la \
+    libs/acn/libolae131core.la \
+    common/web/libolaweb.la \
+    common/libolacommon.la
+
+if USE_ARTNET
+tools_benchmark_ola_benchmark_SOURCES += tools/benchmark/ArtNetBenchmarks.cpp
+tools_benchmark_ola_benchmark_LDADD += plugins/artnet/libolaartnetnode.la
+endif
+
+noinst_PROGRAMS += tools/benchmark/olad_benchmark
+
+tools_benchmark_olad_benchmark_SOURCES = \
+    tools/benchmark/OladBenchmark.cpp \
+    tools/benchmark/ThroughputPlugin.cpp \
+    tools/benchmark/ThroughputPlugin.h
+tools_benchmark_olad_benchmark_CXXFLAGS = $(COMMON_TESTING_FLAGS_ONLY_WARNINGS)
+tools_benchmark_olad_benchmark_LDADD = \
+    $(CPPUNIT_LIBS) \
+    common/testing/libolatesting.la \
+    olad/libolaserver.la \
+    olad/plugin_api/libolaserverplugininterface.la \
+    libs/acn/libolae131core.la \
+    ola/libola.la \
+    common/web/libolaweb.la \
+    common/libolacommon.la
+
+if USE_ARTNET
+tools_benchmark_olad_benchmark_LDADD += plugins/artnet/libolaartnetnode.la
+endif
+
+noinst_PROGRAMS += tools/benchmark/ola_pcap_replay
+
+tools_benchmark_ola_pcap_replay_SOURCES = \
+    tools/benchmark/AllocationCounter.cpp \
+    tools/benchmark/AllocationCounter.h \
+    tools/benchmark/PcapReader.cpp \
+    tools/benchmark/PcapReader.h \
+    tools/benchmark/PcapReplay.cpp
+tools_benchmark_ola_pcap_replay_CXXFLAGS = $(COMMON_TESTING_FLAGS_ONLY_WARNINGS)
+tools_benchmark_ola_pcap_replay_LDADD = \
+    common/testing/libolatesting.la \
+    libs/acn/libolae131core.la \
+    common/web/libolaweb.la \
+    common/libolacommon.la
+
+if USE_ARTNET
+tools_benchmark_ola_pcap_replay_LDADD += plugins/artnet/libolaartnetnode.la
+endif
+
+# Run the benchmarks and write the results to benchmark.json, e.g.
+#   make bench BENCHMARK_FLAGS="--filter=E131"
+bench: tools/benchmark/ola_benchmark$(EXEEXT)
+	$(builddir)/tools/benchmark/ola_benchmark$(EXEEXT) \
+	    --output=benchmark.json $(BENCHMARK_FLAGS)
+
+# Run the olad scenarios and write the results to olad_benchmark.json, e.g.
+#   make bench-olad OLAD_BENCHMARK_FLAGS="--scenarios=e131:256x2"
+bench-olad: tools/benchmark/olad_benchmark$(EXEEXT)
+	$(builddir)/tools/benchmark/olad_benchmark$(EXEEXT) \
+	    --output=olad_benchmark.json $(OLAD_BENCHMARK_FLAGS)
+
+# Replay a capture into the protocol nodes and write the results to
+# replay_benchmark.json, e.g.
+#   make bench-replay CAPTURE=show.pcap REPLAY_FLAGS="--speed=1"
+bench-replay: tools/benchmark/ola_pcap_replay$(EXEEXT)
+	$(builddir)/tools/benchmark/ola_pcap_replay$(EXEEXT) \
+	    --output=replay_benchmark.json $(REPLAY_FLAGS) $(CAPTURE)
+endif
+
+.PHONY: bench bench-olad bench-replay
+CLEANFILES += benchmark.json olad_benchmark.json replay_benchmark.json
@@ -0,0 +1,91 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OlaBenchmark.cpp
+ * Run the microbenchmarks for the core data paths.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
+#include "ola/math/Random.h"
+#include "tools/benchmark/Benchmark.h"
+
+using ola::TimeInterval;
+using ola::benchmark::BenchmarkRunner;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_string(filter, f, "",
+                "Only run the benchmarks with this in their name.");
+DEFINE_default_bool(list, false, "List the benchmarks and exit.");
+DEFINE_uint32(min_time_ms, 500,
+              "The minimum time in ms to run each benchmark for.");
+DEFINE_s_string(output, o, "",
+                "The file to write the JSON results to, defaults to stdout.");
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Run the OLA microbenchmarks and write the results as JSON.");
+  ola::math::InitRandom();
+
+  BenchmarkRunner runner(
+      TimeInterval(static_cast<int64_t>(FLAGS_min_time_ms) * 1000),
+      FLAGS_filter.str());
+  ola::benchmark::RegisterDmxBenchmarks(&runner);
+  ola::benchmark::RegisterProtocolBenchmarks(&runner);
+#ifdef USE_ARTNET
+  ola::benchmark::RegisterArtNetBenchmarks(&runner);
+#endif  // USE_ARTNET
+  ola::benchmark::RegisterRpcBenchmarks(&runner);
+  ola::benchmark::RegisterUtilBenchmarks(&runner);
+
+  if (FLAGS_list) {
+    vector<string> names;
+    runner.Names(&names);
+    vector<string>::const_iterator iter = names.begin();
+    for (; iter != names.end(); ++iter) {
+      cout << *iter << endl;
+    }
+    return ola::EXIT_OK;
+  }
+
+  string json;
+  bool ok = runner.Run(&json);
+  if (FLAGS_output.str().empty()) {
+    cout << json << endl;
+  } else {
+    std::ofstream output(FLAGS_output.str().c_str());
+    if (!output.is_open()) {
+      std::cerr << "Failed to open " << FLAGS_output.str() << endl;
+      return ola::EXIT_CANTCREAT;
+    }
+    output << json << endl;
+  }
+  return ok ? ola::EXIT_OK : ola::EXIT_SOFTWARE;
+}
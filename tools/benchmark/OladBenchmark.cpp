@@ -0,0 +1,514 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * OladBenchmark.cpp
+ * Run an in-process olad through a set of many-universe scenarios and report
+ * the frame rate, latency, CPU and memory use of each as JSON.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif  // _WIN32
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
+#include "ola/base/Version.h"
+#include "ola/client/StreamingClient.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/CallbackThread.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Thread.h"
+#include "ola/util/Trace.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonWriter.h"
+#include "olad/OlaServer.h"
+#include "olad/Preferences.h"
+#include "tools/benchmark/ThroughputPlugin.h"
+
+DECLARE_uint16(rpc_port);
+DECLARE_bool(register_with_dns_sd);
+
+DEFINE_s_string(scenarios, s,
+                "e131:1x1,e131:64x1,e131:64x4,artnet:64x1,artnet:64x2,"
+                "streaming:1x1,streaming:16x2",
+                "A comma separated list of scenarios to run, each of the form "
+                "protocol:UNIVERSESxSOURCES. The protocol is one of e131, "
+                "artnet or streaming.");
+DEFINE_s_uint32(fps, f, 40, "Frames per second per source [1 - 1000].");
+DEFINE_s_uint32(duration, d, 5,
+                "The number of seconds to measure each scenario for.");
+DEFINE_uint32(warmup, 1,
+              "The number of seconds to run each scenario before measuring.");
+DEFINE_default_bool(ltp, false, "Use LTP rather than HTP merging.");
+DEFINE_uint32(output_tick, 5,
+              "The tick in ms used to write to universes with a max frame "
+              "rate, 0 disables frame rate limiting. As for olad.");
+DEFINE_uint32(dmx_buffer_pool_size, 0,
+              "The number of released DMX buffers to keep for reuse. As for "
+              "olad.");
+DEFINE_s_string(output, o, "",
+                "The file to write the JSON results to, defaults to stdout.");
+
+using ola::DmxBuffer;
+using ola::OlaServer;
+using ola::TimeInterval;
+using ola::benchmark::FrameRecorder;
+using ola::benchmark::ThroughputOptions;
+using ola::benchmark::ThroughputPluginLoader;
+using ola::io::SelectServer;
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using ola::web::JsonUInt64;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+const unsigned int MAX_FPS = 1000;
+// How long to wait for the last frames once the window closes.
+const unsigned int DRAIN_TIME_MS = 500;
+// ArtNet only merges two sources.
+const unsigned int MAX_ARTNET_SOURCES = 2;
+
+struct Scenario {
+  string name;
+  ThroughputOptions options;
+};
+
+struct ResourceUsage {
+  ResourceUsage() : have_cpu_time(false), have_rss(false), rss_kb(0) {}
+
+  bool have_cpu_time;
+  TimeInterval cpu_time;
+  bool have_rss;
+  uint64_t rss_kb;
+};
+
+/**
+ * Get the user + system CPU time and the resident set size of this process.
+ */
+ResourceUsage GetResourceUsage() {
+  ResourceUsage usage;
+#ifndef _WIN32
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.cpu_time = TimeInterval(rusage.ru_utime.tv_sec,
+                                  rusage.ru_utime.tv_usec);
+    usage.cpu_time += TimeInterval(rusage.ru_stime.tv_sec,
+                                   rusage.ru_stime.tv_usec);
+    usage.have_cpu_time = true;
+  }
+
+  std::ifstream status_file("/proc/self/status");
+  string line;
+  while (std::getline(status_file, line)) {
+    if (ola::StripPrefix(&line, "VmRSS:")) {
+      // The value is in kB.
+      std::istringstream value(line);
+      usage.have_rss = !(value >> usage.rss_kb).fail();
+      break;
+    }
+  }
+#endif  // _WIN32
+  return usage;
+}
+
+/**
+ * Parse a scenario of the form protocol:UNIVERSESxSOURCES.
+ */
+bool ParseScenario(const string &input, Scenario *scenario) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ":");
+  if (tokens.size() != 2) {
+    return false;
+  }
+
+  ThroughputOptions *options = &scenario->options;
+  if (tokens[0] == "e131") {
+    options->protocol = ola::benchmark::SOURCE_E131;
+#ifdef USE_ARTNET
+  } else if (tokens[0] == "artnet") {
+    options->protocol = ola::benchmark::SOURCE_ARTNET;
+#endif  // USE_ARTNET
+  } else if (tokens[0] == "streaming") {
+    options->protocol = ola::benchmark::SOURCE_STREAMING;
+  } else {
+    return false;
+  }
+
+  vector<string> counts;
+  ola::StringSplit(tokens[1], &counts, "x");
+  if (counts.size() != 2 ||
+      !ola::StringToInt(counts[0], &options->universes) ||
+      !ola::StringToInt(counts[1], &options->sources) ||
+      options->universes == 0 || options->sources == 0) {
+    return false;
+  }
+
+  if (options->protocol == ola::benchmark::SOURCE_ARTNET &&
+      options->sources > MAX_ARTNET_SOURCES) {
+    OLA_WARN << "ArtNet only supports " << MAX_ARTNET_SOURCES
+             << " sources per universe";
+    return false;
+  }
+  scenario->name = input;
+  return true;
+}
+
+/**
+ * Sleep until the FrameRecorder's clock reaches a time.
+ */
+void SleepUntil(const FrameRecorder &recorder, uint32_t time) {
+  uint32_t now = recorder.Now();
+  while (now < time) {
+    usleep(time - now);
+    now = recorder.Now();
+  }
+}
+
+/**
+ * A source that sends every universe from a StreamingClient, until the
+ * measurement window closes.
+ */
+class StreamingSource : public ola::thread::Thread {
+ public:
+  StreamingSource(unsigned int source, uint16_t server_port,
+                  const ThroughputOptions &options,
+                  FrameRecorder *recorder)
+      : m_source(source),
+        m_universes(options.universes),
+        m_interval(ola::USEC_IN_SECONDS / options.fps),
+        m_recorder(recorder),
+        m_client(ClientOptions(server_port)),
+        m_failures(0) {
+  }
+
+  bool Setup() { return m_client.Setup(); }
+
+  unsigned int Failures() const { return m_failures; }
+
+ protected:
+  void *Run();
+
+ private:
+  const unsigned int m_source;
+  const unsigned int m_universes;
+  const uint32_t m_interval;
+  FrameRecorder *m_recorder;
+  ola::client::StreamingClient m_client;
+  unsigned int m_failures;
+
+  static ola::client::StreamingClient::Options ClientOptions(
+      uint16_t server_port) {
+    ola::client::StreamingClient::Options options;
+    options.auto_start = false;
+    options.server_port = server_port;
+    return options;
+  }
+};
+
+void *StreamingSource::Run() {
+  DmxBuffer frame;
+  FrameRecorder::InitFrame(m_source, &frame);
+
+  uint32_t next_frame = m_recorder->Now();
+  while (!m_recorder->WindowComplete()) {
+    for (unsigned int universe = 0; universe < m_universes; universe++) {
+      m_recorder->NextFrame(universe, m_source, &frame);
+      if (!m_client.SendDmx(universe + 1, frame)) {
+        m_failures++;
+      }
+    }
+
+    // If we fall behind, carry on from now rather than sending a burst.
+    next_frame += m_interval;
+    uint32_t now = m_recorder->Now();
+    if (next_frame > now) {
+      usleep(next_frame - now);
+    } else {
+      next_frame = now;
+    }
+  }
+  m_client.Stop();
+  return NULL;
+}
+
+void ServerStarted(ola::thread::Future<void> *future) {
+  future->Set();
+}
+
+/**
+ * Add the latency percentiles to a JSON object.
+ */
+void AddLatencies(const vector<uint32_t> &latencies, JsonObject *json) {
+  if (latencies.empty()) {
+    return;
+  }
+  uint64_t total = 0;
+  vector<uint32_t>::const_iterator iter = latencies.begin();
+  for (; iter != latencies.end(); ++iter) {
+    total += *iter;
+  }
+  size_t count = latencies.size();
+  json->Add("min", latencies.front());
+  json->Add("mean", static_cast<double>(total) / count);
+  json->Add("p50", latencies[count / 2]);
+  json->Add("p90", latencies[count * 9 / 10]);
+  json->Add("p99", latencies[count * 99 / 100]);
+  json->Add("max", latencies.back());
+}
+
+/**
+ * Run a scenario against a new OlaServer and add the results to a JSON
+ * object.
+ */
+bool RunScenario(const Scenario &scenario, JsonObject *json) {
+  const ThroughputOptions &options = scenario.options;
+  OLA_INFO << "Running " << scenario.name;
+
+  const ResourceUsage baseline = GetResourceUsage();
+
+  FrameRecorder recorder(options.universes);
+  // The warmup also covers the startup time.
+  const TimeInterval window_start(FLAGS_warmup, 0);
+  const TimeInterval window_end(FLAGS_warmup + FLAGS_duration, 0);
+  recorder.SetWindow(window_start, window_end);
+
+  ola::MemoryPreferencesFactory preferences_factory;
+  ThroughputPluginLoader plugin_loader(options, &recorder);
+  vector<ola::PluginLoader*> plugin_loaders;
+  plugin_loaders.push_back(&plugin_loader);
+
+  OlaServer::Options server_options;
+  server_options.http_enable = false;
+  server_options.http_localhost_only = false;
+  server_options.http_enable_quit = false;
+  server_options.http_port = 0;
+  server_options.http_data_dir = "";
+  server_options.load_pid_store = true;
+  server_options.trace_events = ola::DEFAULT_TRACE_EVENTS;
+  server_options.dmx_buffer_pool_size = FLAGS_dmx_buffer_pool_size;
+  server_options.output_tick_ms = FLAGS_output_tick;
+  server_options.loop_cpu = -1;
+  server_options.timecode_shared_memory = false;
+  server_options.timecode_freewheel_ms = 0;
+  server_options.dmx_snapshot_file = "";
+  server_options.universe_shared_memory_slots = 0;
+
+  SelectServer ss;
+  OlaServer server(plugin_loaders, &preferences_factory, &ss,
+                   server_options);
+  if (!server.Init()) {
+    OLA_WARN << "Failed to init the OlaServer";
+    return false;
+  }
+
+  // The plugins are loaded by the first callback run on the server thread,
+  // so once this one runs the universes are patched.
+  ola::thread::Future<void> started;
+  ss.Execute(ola::NewSingleCallback(ServerStarted, &started));
+  ola::thread::CallbackThread server_thread(
+      ola::NewSingleCallback(&ss, &SelectServer::Run));
+  server_thread.Start();
+  started.Get();
+
+  bool ok = true;
+  vector<StreamingSource*> streaming_sources;
+  if (options.protocol == ola::benchmark::SOURCE_STREAMING) {
+    uint16_t port = server.LocalRPCAddress().V4Addr().Port();
+    for (unsigned int i = 0; i < options.sources; i++) {
+      StreamingSource *source = new StreamingSource(i, port, options,
+                                                    &recorder);
+      streaming_sources.push_back(source);
+      if (!source->Setup()) {
+        OLA_WARN << "Failed to connect to the RPC port";
+        ok = false;
+        break;
+      }
+    }
+    if (ok) {
+      vector<StreamingSource*>::iterator iter = streaming_sources.begin();
+      for (; iter != streaming_sources.end(); ++iter) {
+        (*iter)->Start();
+      }
+    }
+  }
+
+  if (ok && recorder.Now() > static_cast<uint32_t>(window_start.AsInt())) {
+    OLA_WARN << "Startup took longer than the warmup, try a larger --warmup";
+  }
+
+  ResourceUsage start_usage, end_usage;
+  if (ok) {
+    SleepUntil(recorder, static_cast<uint32_t>(window_start.AsInt()));
+    start_usage = GetResourceUsage();
+    SleepUntil(recorder, static_cast<uint32_t>(window_end.AsInt()));
+    end_usage = GetResourceUsage();
+  }
+
+  unsigned int send_failures = 0;
+  vector<StreamingSource*>::iterator iter = streaming_sources.begin();
+  for (; iter != streaming_sources.end(); ++iter) {
+    if ((*iter)->IsRunning()) {
+      (*iter)->Join();
+    }
+    send_failures += (*iter)->Failures();
+  }
+  ola::STLDeleteElements(&streaming_sources);
+
+  usleep(DRAIN_TIME_MS * ola::ONE_THOUSAND);
+  ss.Terminate();
+  server_thread.Join();
+
+  if (!ok) {
+    return false;
+  }
+
+  const double duration = static_cast<double>(FLAGS_duration);
+  const uint64_t sent = recorder.FramesSent();
+  const uint64_t received = recorder.FramesReceived();
+  const uint64_t lost = sent > received ? sent - received : 0;
+
+  json->Add("name", scenario.name);
+  json->Add("universes", options.universes);
+  json->Add("sources", options.sources);
+  json->Add("target_fps", options.fps);
+  json->Add("merge_mode", options.ltp ? "LTP" : "HTP");
+  // The frames tagged by source 0, one per universe per frame.
+  json->AddValue("frames_sent", new JsonUInt64(sent));
+  json->AddValue("frames_received", new JsonUInt64(received));
+  json->AddValue("frames_lost", new JsonUInt64(lost));
+  json->Add("loss_percent",
+            sent ? static_cast<double>(lost) * 100 / sent : 0.0);
+  json->Add("sustained_fps",
+            static_cast<double>(received) / options.universes / duration);
+  // Every source update causes a write, unless the output tick limits it.
+  json->Add("output_writes_per_second",
+            static_cast<double>(recorder.OutputWrites()) / duration);
+  json->Add("send_failures", send_failures);
+
+  AddLatencies(recorder.Latencies(), json->AddObject("latency_us"));
+
+  if (start_usage.have_cpu_time && end_usage.have_cpu_time) {
+    double percent = static_cast<double>(
+        end_usage.cpu_time.AsInt() - start_usage.cpu_time.AsInt()) * 100 /
+        (duration * ola::USEC_IN_SECONDS);
+    JsonObject *cpu = json->AddObject("cpu");
+    cpu->Add("percent", percent);
+    cpu->Add("percent_per_universe", percent / options.universes);
+  }
+
+  if (end_usage.have_rss) {
+    JsonObject *memory = json->AddObject("memory");
+    memory->AddValue("rss_kb", new JsonUInt64(end_usage.rss_kb));
+    if (baseline.have_rss) {
+      int64_t delta = static_cast<int64_t>(end_usage.rss_kb) -
+                      static_cast<int64_t>(baseline.rss_kb);
+      memory->Add("rss_delta_kb", static_cast<int>(delta));
+    }
+  }
+  return true;
+}
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Run an in-process olad through a set of scenarios and write "
+               "the results as JSON.");
+
+  if (FLAGS_fps == 0 || FLAGS_fps > MAX_FPS || FLAGS_duration == 0) {
+    ola::DisplayUsageAndExit();
+  }
+
+  vector<Scenario> scenarios;
+  vector<string> inputs;
+  ola::StringSplit(FLAGS_scenarios.str(), &inputs, ",");
+  vector<string>::const_iterator input_iter = inputs.begin();
+  for (; input_iter != inputs.end(); ++input_iter) {
+    Scenario scenario;
+    scenario.options.fps = FLAGS_fps;
+    scenario.options.ltp = FLAGS_ltp;
+    if (!ParseScenario(*input_iter, &scenario)) {
+      std::cerr << "Invalid scenario " << *input_iter << endl;
+      return ola::EXIT_USAGE;
+    }
+    scenarios.push_back(scenario);
+  }
+
+  // Listen on an unused port and stay off the network.
+  FLAGS_rpc_port = 0;
+  FLAGS_register_with_dns_sd = false;
+
+  JsonObject json;
+  JsonObject *context = json.AddObject("context");
+  context->Add("ola_version", ola::base::Version::GetVersion());
+  context->Add("fps", FLAGS_fps);
+  context->Add("duration", FLAGS_duration);
+  context->Add("warmup", FLAGS_warmup);
+  context->Add("output_tick_ms", FLAGS_output_tick);
+  context->Add("dmx_buffer_pool_size", FLAGS_dmx_buffer_pool_size);
+  JsonArray *results = json.AddArray("scenarios");
+
+  bool ok = true;
+  vector<Scenario>::const_iterator iter = scenarios.begin();
+  for (; iter != scenarios.end(); ++iter) {
+    if (RunScenario(*iter, results->AppendObject())) {
+      std::cerr << iter->name << " complete" << endl;
+    } else {
+      std::cerr << iter->name << " failed" << endl;
+      ok = false;
+    }
+  }
+
+  if (FLAGS_output.str().empty()) {
+    ola::web::JsonWriter::Write(&cout, json);
+    cout << endl;
+  } else {
+    std::ofstream output(FLAGS_output.str().c_str());
+    if (!output.is_open()) {
+      std::cerr << "Failed to open " << FLAGS_output.str() << endl;
+      return ola::EXIT_CANTCREAT;
+    }
+    ola::web::JsonWriter::Write(&output, json);
+    output << endl;
+  }
+  return ok ? ola::EXIT_OK : ola::EXIT_SOFTWARE;
+}
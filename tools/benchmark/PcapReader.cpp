@@ -0,0 +1,290 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PcapReader.cpp
+ * Read the UDP datagrams from a packet capture.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#include "ola/network/IPV4Address.h"
+#include "tools/benchmark/PcapReader.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::network::IPV4Address;
+using std::string;
+
+namespace {
+
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+const uint32_t PCAP_MAGIC_SWAPPED = 0xd4c3b2a1;
+const uint32_t PCAP_NSEC_MAGIC = 0xa1b23c4d;
+const uint32_t PCAP_NSEC_MAGIC_SWAPPED = 0x4d3cb2a1;
+const uint32_t PCAPNG_MAGIC = 0x0a0d0d0a;
+
+const unsigned int FILE_HEADER_SIZE = 24;
+const unsigned int RECORD_HEADER_SIZE = 16;
+// Larger records are treated as a corrupt file.
+const uint32_t MAX_RECORD_SIZE = 262144;
+
+enum {
+  LINKTYPE_NULL = 0,
+  LINKTYPE_ETHERNET = 1,
+  LINKTYPE_RAW = 101,
+  LINKTYPE_LINUX_SLL = 113,
+  LINKTYPE_IPV4 = 228,
+  LINKTYPE_LINUX_SLL2 = 276,
+};
+
+const uint16_t ETHERTYPE_IPV4 = 0x0800;
+const uint16_t ETHERTYPE_VLAN = 0x8100;
+const unsigned int ETHERNET_HEADER_SIZE = 14;
+const unsigned int VLAN_TAG_SIZE = 4;
+const unsigned int SLL_HEADER_SIZE = 16;
+const unsigned int SLL2_HEADER_SIZE = 20;
+const unsigned int NULL_HEADER_SIZE = 4;
+const uint32_t NULL_AF_INET = 2;
+
+const unsigned int IPV4_MIN_HEADER_SIZE = 20;
+const uint8_t IPPROTO_UDP_NUMBER = 17;
+const uint16_t IPV4_MORE_FRAGMENTS = 0x2000;
+const uint16_t IPV4_OFFSET_MASK = 0x1fff;
+const unsigned int UDP_HEADER_SIZE = 8;
+
+uint16_t ReadUInt16(const uint8_t *data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t ReadLittleEndian(const uint8_t *data) {
+  return static_cast<uint32_t>(data[0]) |
+         (static_cast<uint32_t>(data[1]) << 8) |
+         (static_cast<uint32_t>(data[2]) << 16) |
+         (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint32_t ReadBigEndian(const uint8_t *data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) |
+         static_cast<uint32_t>(data[3]);
+}
+}  // namespace
+
+PcapReader::PcapReader()
+    : m_swapped(false),
+      m_nanoseconds(false),
+      m_link_type(LINKTYPE_ETHERNET),
+      m_records(0),
+      m_skipped(0) {
+}
+
+bool PcapReader::Open(const string &filename) {
+  m_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!m_file.is_open()) {
+    m_error = "Failed to open " + filename;
+    return false;
+  }
+
+  uint8_t header[FILE_HEADER_SIZE];
+  if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+    m_error = filename + " is too short to be a capture";
+    return false;
+  }
+
+  // The magic number is written in the byte order of the capturing host.
+  const uint32_t magic = ReadLittleEndian(header);
+  if (magic == PCAP_MAGIC || magic == PCAP_NSEC_MAGIC) {
+    m_swapped = false;
+  } else if (magic == PCAP_MAGIC_SWAPPED || magic == PCAP_NSEC_MAGIC_SWAPPED) {
+    m_swapped = true;
+  } else if (magic == PCAPNG_MAGIC) {
+    m_error = filename + " is a pcapng file, convert it with "
+              "'editcap -F pcap'";
+    return false;
+  } else {
+    m_error = filename + " isn't a pcap file";
+    return false;
+  }
+  m_nanoseconds = (magic == PCAP_NSEC_MAGIC ||
+                   magic == PCAP_NSEC_MAGIC_SWAPPED);
+
+  // The top bits of the link type may hold the FCS length.
+  m_link_type = HeaderToHost(header + 20) & 0xffff;
+  switch (m_link_type) {
+    case LINKTYPE_NULL:
+    case LINKTYPE_ETHERNET:
+    case LINKTYPE_RAW:
+    case LINKTYPE_LINUX_SLL:
+    case LINKTYPE_IPV4:
+    case LINKTYPE_LINUX_SLL2:
+      return true;
+    default:
+      m_error = filename + " has an unsupported link type";
+      return false;
+  }
+}
+
+bool PcapReader::Next(CapturedDatagram *datagram) {
+  while (m_file.good()) {
+    uint8_t header[RECORD_HEADER_SIZE];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+      if (m_file.gcount()) {
+        m_error = "Truncated record header";
+      }
+      return false;
+    }
+
+    const uint32_t seconds = HeaderToHost(header);
+    const uint32_t fraction = HeaderToHost(header + 4);
+    const uint32_t captured_length = HeaderToHost(header + 8);
+    if (captured_length > MAX_RECORD_SIZE) {
+      m_error = "Corrupt record length";
+      return false;
+    }
+
+    m_record.resize(captured_length);
+    if (captured_length &&
+        !m_file.read(reinterpret_cast<char*>(&m_record[0]),
+                     captured_length)) {
+      m_error = "Truncated record";
+      return false;
+    }
+    m_records++;
+
+    const uint64_t timestamp_us =
+        static_cast<uint64_t>(seconds) * 1000000 +
+        (m_nanoseconds ? fraction / 1000 : fraction);
+    if (ParseRecord(timestamp_us, datagram)) {
+      return true;
+    }
+    m_skipped++;
+  }
+  return false;
+}
+
+uint32_t PcapReader::HeaderToHost(const uint8_t *data) const {
+  return m_swapped ? ReadBigEndian(data) : ReadLittleEndian(data);
+}
+
+/*
+ * Strip the link layer header.
+ */
+bool PcapReader::ParseRecord(uint64_t timestamp_us,
+                             CapturedDatagram *datagram) {
+  const uint8_t *data = m_record.data();
+  unsigned int length = m_record.size();
+
+  switch (m_link_type) {
+    case LINKTYPE_NULL:
+      // The address family is in the byte order of the capturing host.
+      if (length < NULL_HEADER_SIZE ||
+          (ReadLittleEndian(data) != NULL_AF_INET &&
+           ReadBigEndian(data) != NULL_AF_INET)) {
+        return false;
+      }
+      data += NULL_HEADER_SIZE;
+      length -= NULL_HEADER_SIZE;
+      break;
+    case LINKTYPE_ETHERNET:
+      {
+        if (length < ETHERNET_HEADER_SIZE) {
+          return false;
+        }
+        uint16_t ethertype = ReadUInt16(data + ETHERNET_HEADER_SIZE - 2);
+        data += ETHERNET_HEADER_SIZE;
+        length -= ETHERNET_HEADER_SIZE;
+        if (ethertype == ETHERTYPE_VLAN) {
+          if (length < VLAN_TAG_SIZE) {
+            return false;
+          }
+          ethertype = ReadUInt16(data + 2);
+          data += VLAN_TAG_SIZE;
+          length -= VLAN_TAG_SIZE;
+        }
+        if (ethertype != ETHERTYPE_IPV4) {
+          return false;
+        }
+      }
+      break;
+    case LINKTYPE_LINUX_SLL:
+      if (length < SLL_HEADER_SIZE ||
+          ReadUInt16(data + SLL_HEADER_SIZE - 2) != ETHERTYPE_IPV4) {
+        return false;
+      }
+      data += SLL_HEADER_SIZE;
+      length -= SLL_HEADER_SIZE;
+      break;
+    case LINKTYPE_LINUX_SLL2:
+      if (length < SLL2_HEADER_SIZE || ReadUInt16(data) != ETHERTYPE_IPV4) {
+        return false;
+      }
+      data += SLL2_HEADER_SIZE;
+      length -= SLL2_HEADER_SIZE;
+      break;
+    default:
+      // Raw IP, ParseIPV4() checks the version.
+      break;
+  }
+
+  datagram->timestamp_us = timestamp_us;
+  return ParseIPV4(data, length, datagram);
+}
+
+bool PcapReader::ParseIPV4(const uint8_t *data, unsigned int length,
+                           CapturedDatagram *datagram) {
+  if (length < IPV4_MIN_HEADER_SIZE || (data[0] >> 4) != 4) {
+    return false;
+  }
+
+  const unsigned int header_size = (data[0] & 0x0f) * 4;
+  // Ethernet frames may be padded, so use the IP length where we can.
+  const unsigned int total_length = std::min(
+      static_cast<unsigned int>(ReadUInt16(data + 2)), length);
+  const uint16_t fragment = ReadUInt16(data + 6);
+  if (header_size < IPV4_MIN_HEADER_SIZE ||
+      total_length < header_size + UDP_HEADER_SIZE ||
+      data[9] != IPPROTO_UDP_NUMBER ||
+      (fragment & (IPV4_MORE_FRAGMENTS | IPV4_OFFSET_MASK))) {
+    return false;
+  }
+
+  // The addresses stay in network byte order.
+  uint32_t address;
+  memcpy(&address, data + 12, sizeof(address));
+  datagram->source = IPV4Address(address);
+  memcpy(&address, data + 16, sizeof(address));
+  datagram->destination = IPV4Address(address);
+
+  const uint8_t *udp = data + header_size;
+  datagram->source_port = ReadUInt16(udp);
+  datagram->destination_port = ReadUInt16(udp + 2);
+  const unsigned int udp_length = ReadUInt16(udp + 4);
+  const unsigned int available = total_length - header_size;
+  if (udp_length < UDP_HEADER_SIZE) {
+    return false;
+  }
+  // The capture may have been truncated by the snap length.
+  datagram->payload.assign(udp + UDP_HEADER_SIZE,
+                           std::min(udp_length, available) - UDP_HEADER_SIZE);
+  return true;
+}
+}  // namespace benchmark
+}  // namespace ola
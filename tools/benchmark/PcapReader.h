@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PcapReader.h
+ * Read the UDP datagrams from a packet capture.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_BENCHMARK_PCAPREADER_H_
+#define TOOLS_BENCHMARK_PCAPREADER_H_
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+
+#include "ola/base/Macro.h"
+#include "ola/io/ByteString.h"
+#include "ola/network/IPV4Address.h"
+
+namespace ola {
+namespace benchmark {
+
+/**
+ * @brief A UDP datagram from a capture.
+ */
+struct CapturedDatagram {
+  CapturedDatagram() : timestamp_us(0), source_port(0), destination_port(0) {}
+
+  uint64_t timestamp_us;  // the capture time
+  ola::network::IPV4Address source;
+  ola::network::IPV4Address destination;
+  uint16_t source_port;
+  uint16_t destination_port;
+  ola::io::ByteString payload;
+};
+
+/**
+ * @brief Reads the IPv4 UDP datagrams from a classic libpcap file.
+ *
+ * This reads the format written by tcpdump and, with `-F pcap`, by tshark
+ * and editcap, in either byte order and with micro or nanosecond
+ * timestamps. The link layer may be Ethernet, with or without a VLAN tag,
+ * Linux cooked (SLL and SLL2), raw IP or BSD loopback. Anything which isn't
+ * an unfragmented IPv4 UDP datagram is skipped and counted. pcapng files
+ * aren't supported.
+ */
+class PcapReader {
+ public:
+  PcapReader();
+
+  /**
+   * @brief Open a capture and read the file header.
+   * @returns false if the file couldn't be opened or isn't a supported
+   *   capture, Error() has the reason.
+   */
+  bool Open(const std::string &filename);
+
+  /**
+   * @brief Read the next UDP datagram.
+   * @returns false at the end of the file or if the file is truncated.
+   */
+  bool Next(CapturedDatagram *datagram);
+
+  /**
+   * @brief The reason Open() failed, or the file was truncated.
+   */
+  const std::string &Error() const { return m_error; }
+
+  /**
+   * @brief The number of records read, including those skipped.
+   */
+  uint64_t Records() const { return m_records; }
+
+  /**
+   * @brief The number of records which weren't unfragmented IPv4 UDP.
+   */
+  uint64_t Skipped() const { return m_skipped; }
+
+ private:
+  std::ifstream m_file;
+  std::string m_error;
+  bool m_swapped;
+  bool m_nanoseconds;
+  uint32_t m_link_type;
+  uint64_t m_records;
+  uint64_t m_skipped;
+  ola::io::ByteString m_record;
+
+  uint32_t HeaderToHost(const uint8_t *data) const;
+  bool ParseRecord(uint64_t timestamp_us, CapturedDatagram *datagram);
+  bool ParseIPV4(const uint8_t *data, unsigned int length,
+                 CapturedDatagram *datagram);
+
+  DISALLOW_COPY_AND_ASSIGN(PcapReader);
+};
+}  // namespace benchmark
+}  // namespace ola
+#endif  // TOOLS_BENCHMARK_PCAPREADER_H_
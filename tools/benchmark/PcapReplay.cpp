@@ -0,0 +1,663 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PcapReplay.cpp
+ * Replay the lighting control packets from a capture into the protocol
+ * nodes and report the parse rate, allocations and per universe frames as
+ * JSON.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif  // _WIN32
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/E131Inflator.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/TransportHeader.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/base/SysExits.h"
+#include "ola/base/Version.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonWriter.h"
+#include "tools/benchmark/AllocationCounter.h"
+#include "tools/benchmark/PcapReader.h"
+
+#ifdef USE_ARTNET
+#include "ola/network/Interface.h"
+#include "ola/network/MACAddress.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "plugins/artnet/ArtNetNode.h"
+#endif  // USE_ARTNET
+
+DEFINE_s_uint32(speed, s, 0,
+                "Replay at this multiple of the captured rate, 0 replays as "
+                "fast as possible.");
+DEFINE_uint32(loops, 1, "The number of times to replay the capture.");
+DEFINE_uint16(artnet_port, 6454, "The UDP port ArtNet is captured on.");
+DEFINE_uint16(e131_port, ola::acn::ACN_PORT,
+              "The UDP port E1.31 is captured on.");
+DEFINE_uint16(kinet_port, 6038, "The UDP port KiNet is captured on.");
+DEFINE_uint16(osc_port, 7770, "The UDP port OSC is captured on.");
+DEFINE_s_string(output, o, "",
+                "The file to write the JSON results to, defaults to stdout.");
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::benchmark::AllocationCount;
+using ola::benchmark::CapturedDatagram;
+using ola::benchmark::PcapReader;
+using ola::io::ByteString;
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using ola::web::JsonUInt64;
+using std::cout;
+using std::endl;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+typedef vector<const CapturedDatagram*> DatagramList;
+
+/**
+ * The frames a node delivered for a universe.
+ */
+struct UniverseStats {
+  UniverseStats() : priority(0), frames(0), changed_frames(0), last_size(0) {}
+
+  DmxBuffer buffer;  // written by the node
+  uint8_t priority;
+  uint64_t frames;
+  uint64_t changed_frames;
+  unsigned int last_size;
+  uint8_t last[ola::DMX_UNIVERSE_SIZE];
+};
+
+/*
+ * Called by the nodes when a universe has new data. This copies into a
+ * fixed array so recording the frame doesn't allocate.
+ */
+void RecordFrame(UniverseStats *stats) {
+  stats->frames++;
+  const unsigned int size = stats->buffer.Size();
+  if (size != stats->last_size ||
+      memcmp(stats->last, stats->buffer.GetRaw(), size)) {
+    stats->changed_frames++;
+    memcpy(stats->last, stats->buffer.GetRaw(), size);
+    stats->last_size = size;
+  }
+}
+
+uint64_t CPUTimeUs() {
+#ifndef _WIN32
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    TimeInterval cpu_time(rusage.ru_utime.tv_sec, rusage.ru_utime.tv_usec);
+    cpu_time += TimeInterval(rusage.ru_stime.tv_sec, rusage.ru_stime.tv_usec);
+    return cpu_time.AsInt();
+  }
+#endif  // _WIN32
+  return 0;
+}
+
+uint64_t MaxRSSKb() {
+#ifndef _WIN32
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    return rusage.ru_maxrss;
+  }
+#endif  // _WIN32
+  return 0;
+}
+
+/**
+ * The packets captured for one protocol. Subclasses which override Replay()
+ * pass each packet to the protocol's node.
+ */
+class ProtocolReplayer {
+ public:
+  ProtocolReplayer(const string &name, uint16_t port)
+      : m_name(name),
+        m_port(port),
+        m_bytes(0),
+        m_allocations(0),
+        m_busy_us(0),
+        m_cpu_us(0),
+        m_replayed(0) {
+  }
+  virtual ~ProtocolReplayer() {
+    ola::STLDeleteValues(&m_universes);
+  }
+
+  const string &Name() const { return m_name; }
+  uint16_t Port() const { return m_port; }
+
+  void AddDatagram(const CapturedDatagram *datagram) {
+    m_datagrams.push_back(datagram);
+    m_bytes += datagram->payload.size();
+  }
+
+  const DatagramList &Datagrams() const { return m_datagrams; }
+
+  /**
+   * @brief Create the nodes for the universes in the capture.
+   */
+  virtual bool Start() { return true; }
+
+  /**
+   * @brief Return true if Replay() passes the packets to a node.
+   */
+  virtual bool CanReplay() const { return false; }
+
+  virtual void Replay(const CapturedDatagram &datagram) {
+    (void) datagram;
+  }
+
+  void RecordPass(uint64_t replayed, uint64_t allocations, uint64_t busy_us,
+                  uint64_t cpu_us) {
+    m_replayed += replayed;
+    m_allocations += allocations;
+    m_busy_us += busy_us;
+    m_cpu_us += cpu_us;
+  }
+
+  void AddResults(JsonObject *json) const;
+
+ protected:
+  typedef map<unsigned int, UniverseStats*> UniverseMap;
+
+  UniverseMap m_universes;
+
+ private:
+  const string m_name;
+  const uint16_t m_port;
+  DatagramList m_datagrams;
+  uint64_t m_bytes;
+  uint64_t m_allocations;
+  uint64_t m_busy_us;
+  uint64_t m_cpu_us;
+  uint64_t m_replayed;
+};
+
+void ProtocolReplayer::AddResults(JsonObject *json) const {
+  json->Add("port", static_cast<unsigned int>(m_port));
+  json->AddValue("packets",
+                 new JsonUInt64(static_cast<uint64_t>(m_datagrams.size())));
+  json->AddValue("bytes", new JsonUInt64(m_bytes));
+  json->Add("replayed", CanReplay());
+  if (!CanReplay() || !m_replayed) {
+    return;
+  }
+
+  json->AddValue("packets_replayed", new JsonUInt64(m_replayed));
+  json->AddValue("busy_us", new JsonUInt64(m_busy_us));
+  json->AddValue("cpu_us", new JsonUInt64(m_cpu_us));
+  json->Add("packets_per_second",
+            m_busy_us ? static_cast<double>(m_replayed) * ola::USEC_IN_SECONDS /
+                        m_busy_us : 0.0);
+  json->Add("ns_per_packet",
+            static_cast<double>(m_busy_us) * 1000 / m_replayed);
+  json->AddValue("allocations", new JsonUInt64(m_allocations));
+  json->Add("allocations_per_packet",
+            static_cast<double>(m_allocations) / m_replayed);
+
+  uint64_t frames = 0;
+  JsonArray *universes = json->AddArray("universes");
+  UniverseMap::const_iterator iter = m_universes.begin();
+  for (; iter != m_universes.end(); ++iter) {
+    const UniverseStats *stats = iter->second;
+    JsonObject *universe = universes->AppendObject();
+    universe->Add("universe", iter->first);
+    universe->AddValue("frames", new JsonUInt64(stats->frames));
+    universe->AddValue("changed_frames",
+                       new JsonUInt64(stats->changed_frames));
+    universe->Add("slots", stats->last_size);
+    frames += stats->frames;
+  }
+  json->AddValue("frames", new JsonUInt64(frames));
+  // Packets which didn't produce a frame: other opcodes, merge losers and
+  // out of sequence packets.
+  json->AddValue("packets_without_frames",
+                 new JsonUInt64(m_replayed > frames ? m_replayed - frames : 0));
+}
+
+
+#ifdef USE_ARTNET
+using ola::plugin::artnet::ArtNetNode;
+using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::testing::MockUDPSocket;
+
+const uint8_t ARTNET_ID[] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+const uint16_t ARTNET_OPDMX = 0x5000;
+const unsigned int ARTDMX_HEADER_SIZE = 18;
+
+/*
+ * Get the 15 bit port address of an ArtDmx packet.
+ */
+bool ArtDmxUniverse(const ByteString &payload, uint16_t *universe) {
+  if (payload.size() < ARTDMX_HEADER_SIZE ||
+      memcmp(payload.data(), ARTNET_ID, sizeof(ARTNET_ID)) ||
+      (payload[8] | (payload[9] << 8)) != ARTNET_OPDMX) {
+    return false;
+  }
+  *universe = static_cast<uint16_t>(((payload[15] & 0x7f) << 8) |
+                                    payload[14]);
+  return true;
+}
+
+/**
+ * Replays the ArtNet packets into an ArtNetNode for each net and subnet,
+ * with an output port for each universe.
+ */
+class ArtNetReplayer: public ProtocolReplayer {
+ public:
+  explicit ArtNetReplayer(uint16_t port)
+      : ProtocolReplayer("artnet", port),
+        m_default_socket(NULL) {
+  }
+  ~ArtNetReplayer();
+
+  bool Start();
+  bool CanReplay() const { return true; }
+  void Replay(const CapturedDatagram &datagram);
+
+ private:
+  typedef map<uint16_t, MockUDPSocket*> SocketMap;
+
+  ola::io::SelectServer m_ss;
+  vector<ArtNetNode*> m_nodes;
+  SocketMap m_sockets;  // by universe
+  MockUDPSocket *m_default_socket;  // for packets other than ArtDmx
+
+  static ola::network::Interface ReplayInterface();
+};
+
+ArtNetReplayer::~ArtNetReplayer() {
+  vector<ArtNetNode*>::iterator iter = m_nodes.begin();
+  for (; iter != m_nodes.end(); ++iter) {
+    (*iter)->Stop();
+  }
+  ola::STLDeleteElements(&m_nodes);
+}
+
+bool ArtNetReplayer::Start() {
+  // Group the universes by net and subnet.
+  map<uint16_t, vector<uint16_t> > subnets;
+  DatagramList::const_iterator iter = Datagrams().begin();
+  for (; iter != Datagrams().end(); ++iter) {
+    uint16_t universe;
+    if (ArtDmxUniverse((*iter)->payload, &universe) &&
+        !ola::STLContains(m_universes, universe)) {
+      m_universes[universe] = new UniverseStats();
+      subnets[universe >> 4].push_back(universe);
+    }
+  }
+
+  map<uint16_t, vector<uint16_t> >::const_iterator subnet_iter =
+      subnets.begin();
+  for (; subnet_iter != subnets.end(); ++subnet_iter) {
+    const vector<uint16_t> &universes = subnet_iter->second;
+    ArtNetNodeOptions options;
+    options.input_port_count = 0;
+    options.output_port_count = static_cast<uint8_t>(universes.size());
+
+    // The node owns the socket.
+    MockUDPSocket *socket = new MockUDPSocket();
+    socket->SetDiscardMode(true);
+    ArtNetNode *node = new ArtNetNode(ReplayInterface(), &m_ss, options,
+                                      socket);
+    m_nodes.push_back(node);
+    node->EnterConfigurationMode();
+    node->SetNetAddress(subnet_iter->first >> 4);
+    node->SetSubnetAddress(subnet_iter->first & 0x0f);
+    for (uint8_t port = 0; port < universes.size(); port++) {
+      UniverseStats *stats = m_universes[universes[port]];
+      node->SetOutputPortUniverse(port, universes[port] & 0x0f);
+      node->SetDMXHandler(port, &stats->buffer,
+                          NewCallback(RecordFrame, stats));
+      m_sockets[universes[port]] = socket;
+    }
+    node->ExitConfigurationMode();
+    if (!node->Start()) {
+      OLA_WARN << "Failed to start the ArtNet node for net "
+               << (subnet_iter->first >> 4) << ", subnet "
+               << (subnet_iter->first & 0x0f);
+      return false;
+    }
+    if (!m_default_socket) {
+      m_default_socket = socket;
+    }
+  }
+  return true;
+}
+
+void ArtNetReplayer::Replay(const CapturedDatagram &datagram) {
+  uint16_t universe;
+  MockUDPSocket *socket = m_default_socket;
+  if (ArtDmxUniverse(datagram.payload, &universe)) {
+    socket = ola::STLFindOrNull(m_sockets, universe);
+  }
+  if (socket) {
+    socket->InjectData(datagram.payload.data(), datagram.payload.size(),
+                       datagram.source, datagram.source_port);
+  }
+}
+
+ola::network::Interface ArtNetReplayer::ReplayInterface() {
+  ola::network::InterfaceBuilder builder;
+  builder.SetAddress("10.0.0.1");
+  builder.SetSubnetMask("255.0.0.0");
+  builder.SetBroadcast("10.255.255.255");
+  builder.SetHardwareAddress(
+      ola::network::MACAddress::FromStringOrDie("0a:0b:0c:12:34:56"));
+  return builder.Construct();
+}
+#endif  // USE_ARTNET
+
+
+// The offsets in an E1.31 data packet, after the preamble.
+const unsigned int E131_ROOT_VECTOR_OFFSET = 2;
+const unsigned int E131_FRAMING_VECTOR_OFFSET = 24;
+const unsigned int E131_UNIVERSE_OFFSET = 97;
+
+uint32_t ReadVector(const uint8_t *data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) |
+         static_cast<uint32_t>(data[3]);
+}
+
+/**
+ * Replays the E1.31 packets through the inflators the E131Node uses, with a
+ * handler for each universe.
+ */
+class E131Replayer: public ProtocolReplayer {
+ public:
+  explicit E131Replayer(uint16_t port)
+      : ProtocolReplayer("e131", port),
+        m_dmp_inflator(false) {
+    m_root_inflator.AddInflator(&m_e131_inflator);
+    m_e131_inflator.AddInflator(&m_dmp_inflator);
+  }
+
+  bool Start();
+  bool CanReplay() const { return true; }
+  void Replay(const CapturedDatagram &datagram);
+
+ private:
+  ola::acn::RootInflator m_root_inflator;
+  ola::acn::E131Inflator m_e131_inflator;
+  ola::acn::DMPE131Inflator m_dmp_inflator;
+
+  static bool HasPreamble(const ByteString &payload);
+};
+
+bool E131Replayer::Start() {
+  DatagramList::const_iterator iter = Datagrams().begin();
+  for (; iter != Datagrams().end(); ++iter) {
+    const ByteString &payload = (*iter)->payload;
+    if (!HasPreamble(payload) ||
+        payload.size() < ola::acn::PreamblePacker::ACN_HEADER_SIZE +
+                         E131_UNIVERSE_OFFSET + 2) {
+      continue;
+    }
+    const uint8_t *data = payload.data() +
+        ola::acn::PreamblePacker::ACN_HEADER_SIZE;
+    if (ReadVector(data + E131_ROOT_VECTOR_OFFSET) !=
+            ola::acn::VECTOR_ROOT_E131 ||
+        ReadVector(data + E131_FRAMING_VECTOR_OFFSET) !=
+            ola::acn::VECTOR_E131_DATA) {
+      continue;
+    }
+    uint16_t universe = static_cast<uint16_t>(
+        (data[E131_UNIVERSE_OFFSET] << 8) | data[E131_UNIVERSE_OFFSET + 1]);
+    if (ola::STLContains(m_universes, universe)) {
+      continue;
+    }
+    UniverseStats *stats = new UniverseStats();
+    m_universes[universe] = stats;
+    m_dmp_inflator.SetHandler(universe, &stats->buffer, &stats->priority,
+                              NewCallback(RecordFrame, stats));
+  }
+  return true;
+}
+
+void E131Replayer::Replay(const CapturedDatagram &datagram) {
+  // As IncomingUDPTransport does.
+  const ByteString &payload = datagram.payload;
+  if (!HasPreamble(payload)) {
+    return;
+  }
+  const unsigned int header_size = ola::acn::PreamblePacker::ACN_HEADER_SIZE;
+  ola::acn::HeaderSet headers;
+  headers.SetTransportHeader(ola::acn::TransportHeader(
+      ola::network::IPV4SocketAddress(datagram.source, datagram.source_port),
+      ola::acn::TransportHeader::UDP));
+  m_root_inflator.InflatePDUBlock(&headers, payload.data() + header_size,
+                                  payload.size() - header_size);
+}
+
+bool E131Replayer::HasPreamble(const ByteString &payload) {
+  const unsigned int header_size = ola::acn::PreamblePacker::ACN_HEADER_SIZE;
+  return payload.size() >= header_size &&
+         !memcmp(payload.data(), ola::acn::PreamblePacker::ACN_HEADER,
+                 header_size);
+}
+
+
+bool CompareTimestamps(const CapturedDatagram &a, const CapturedDatagram &b) {
+  return a.timestamp_us < b.timestamp_us;
+}
+
+/*
+ * Replay one protocol's packets, --loops times. Only the time spent passing
+ * packets to the node is counted, not the time spent waiting for the next
+ * packet when --speed is set.
+ */
+void ReplayProtocol(ProtocolReplayer *replayer, uint64_t first_timestamp,
+                    uint64_t capture_duration) {
+  const DatagramList &datagrams = replayer->Datagrams();
+  const ola::MonotonicClock clock;
+
+  const uint64_t start_cpu = CPUTimeUs();
+  const uint64_t start_allocations = AllocationCount();
+  TimeStamp start, burst_start, now;
+  clock.CurrentTime(&start);
+  burst_start = start;
+  uint64_t busy_us = 0;
+
+  for (unsigned int loop = 0; loop < FLAGS_loops; loop++) {
+    DatagramList::const_iterator iter = datagrams.begin();
+    for (; iter != datagrams.end(); ++iter) {
+      if (FLAGS_speed) {
+        const uint64_t offset = loop * capture_duration +
+                                (*iter)->timestamp_us - first_timestamp;
+        const TimeStamp target = start + TimeInterval(
+            static_cast<int64_t>(offset / FLAGS_speed));
+        clock.CurrentTime(&now);
+        if (now < target) {
+          busy_us += (now - burst_start).AsInt();
+          usleep((target - now).AsInt());
+          clock.CurrentTime(&burst_start);
+        }
+      }
+      replayer->Replay(**iter);
+    }
+  }
+  clock.CurrentTime(&now);
+  busy_us += (now - burst_start).AsInt();
+
+  replayer->RecordPass(static_cast<uint64_t>(datagrams.size()) * FLAGS_loops,
+                       AllocationCount() - start_allocations, busy_us,
+                       CPUTimeUs() - start_cpu);
+}
+}  // namespace
+
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options] <capture.pcap>...",
+               "Replay the ArtNet, E1.31, KiNet and OSC packets from libpcap "
+               "captures into the protocol nodes and write the parse rate, "
+               "allocations and frames per universe as JSON.");
+
+  if (argc < 2 || FLAGS_loops == 0) {
+    ola::DisplayUsageAndExit();
+  }
+
+  // Read everything first, so the replay doesn't wait for the disk.
+  vector<CapturedDatagram> capture;
+  uint64_t records = 0;
+  uint64_t skipped = 0;
+  JsonObject json;
+  JsonObject *context = json.AddObject("context");
+  context->Add("ola_version", ola::base::Version::GetVersion());
+  context->Add("speed", FLAGS_speed);
+  context->Add("loops", FLAGS_loops);
+  JsonArray *captures = context->AddArray("captures");
+  for (int i = 1; i < argc; i++) {
+    PcapReader reader;
+    if (!reader.Open(argv[i])) {
+      std::cerr << reader.Error() << endl;
+      return ola::EXIT_NOINPUT;
+    }
+    CapturedDatagram datagram;
+    while (reader.Next(&datagram)) {
+      capture.push_back(datagram);
+    }
+    if (!reader.Error().empty()) {
+      OLA_WARN << argv[i] << ": " << reader.Error()
+               << ", replaying the packets before it";
+    }
+    records += reader.Records();
+    skipped += reader.Skipped();
+    captures->Append(string(argv[i]));
+  }
+
+  // Captures taken at the same time on different interfaces are merged.
+  std::stable_sort(capture.begin(), capture.end(), CompareTimestamps);
+
+  vector<ProtocolReplayer*> replayers;
+#ifdef USE_ARTNET
+  replayers.push_back(new ArtNetReplayer(FLAGS_artnet_port));
+#else
+  replayers.push_back(new ProtocolReplayer("artnet", FLAGS_artnet_port));
+#endif  // USE_ARTNET
+  replayers.push_back(new E131Replayer(FLAGS_e131_port));
+  // The KiNetNode doesn't receive DMX and the OSCNode reads from liblo's
+  // socket, so these are only counted.
+  replayers.push_back(new ProtocolReplayer("kinet", FLAGS_kinet_port));
+  replayers.push_back(new ProtocolReplayer("osc", FLAGS_osc_port));
+
+  map<uint16_t, ProtocolReplayer*> by_port;
+  vector<ProtocolReplayer*>::iterator iter = replayers.begin();
+  for (; iter != replayers.end(); ++iter) {
+    by_port[(*iter)->Port()] = *iter;
+  }
+
+  uint64_t unmatched = 0;
+  vector<CapturedDatagram>::const_iterator datagram_iter = capture.begin();
+  for (; datagram_iter != capture.end(); ++datagram_iter) {
+    ProtocolReplayer *replayer = ola::STLFindOrNull(
+        by_port, datagram_iter->destination_port);
+    if (replayer) {
+      replayer->AddDatagram(&(*datagram_iter));
+    } else {
+      unmatched++;
+    }
+  }
+
+  uint64_t first_timestamp = 0;
+  uint64_t duration = 0;
+  if (!capture.empty()) {
+    first_timestamp = capture.front().timestamp_us;
+    duration = capture.back().timestamp_us - first_timestamp;
+  }
+
+  JsonObject *capture_json = json.AddObject("capture");
+  capture_json->AddValue("records", new JsonUInt64(records));
+  capture_json->AddValue("skipped_records", new JsonUInt64(skipped));
+  capture_json->AddValue("udp_datagrams",
+                         new JsonUInt64(static_cast<uint64_t>(capture.size())));
+  capture_json->AddValue("other_udp_datagrams", new JsonUInt64(unmatched));
+  capture_json->AddValue("duration_us", new JsonUInt64(duration));
+
+  // Each protocol is replayed on its own, so its parse time can be measured.
+  bool ok = true;
+  JsonObject *protocols = json.AddObject("protocols");
+  for (iter = replayers.begin(); iter != replayers.end(); ++iter) {
+    ProtocolReplayer *replayer = *iter;
+    if (replayer->CanReplay() && !replayer->Datagrams().empty()) {
+      if (replayer->Start()) {
+        ReplayProtocol(replayer, first_timestamp, duration);
+        std::cerr << replayer->Name() << " complete" << endl;
+      } else {
+        std::cerr << replayer->Name() << " failed" << endl;
+        ok = false;
+      }
+    }
+    replayer->AddResults(protocols->AddObject(replayer->Name()));
+  }
+  ola::STLDeleteElements(&replayers);
+
+  JsonObject *memory = json.AddObject("memory");
+  memory->AddValue("max_rss_kb", new JsonUInt64(MaxRSSKb()));
+
+  if (FLAGS_output.str().empty()) {
+    ola::web::JsonWriter::Write(&cout, json);
+    cout << endl;
+  } else {
+    std::ofstream output(FLAGS_output.str().c_str());
+    if (!output.is_open()) {
+      std::cerr << "Failed to open " << FLAGS_output.str() << endl;
+      return ola::EXIT_CANTCREAT;
+    }
+    ola::web::JsonWriter::Write(&output, json);
+    output << endl;
+  }
+  return ok ? ola::EXIT_OK : ola::EXIT_SOFTWARE;
+}
@@ -0,0 +1,251 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ProtocolBenchmarks.cpp
+ * Benchmarks for building and parsing E1.31 and RDM messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/E131Inflator.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/E133HeaderTemplate.h"
+#include "libs/acn/E133PDU.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RDMPDU.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "ola/io/ByteString.h"
+#include "ola/io/IOStack.h"
+#include "ola/io/MemoryBlockPool.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMCommandSerializer.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMResponseCodes.h"
+#include "ola/rdm/UID.h"
+#include "tools/benchmark/Benchmark.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::acn::CID;
+using ola::acn::DMPE131Inflator;
+using ola::acn::E131Inflator;
+using ola::acn::E131PacketTemplate;
+using ola::acn::E133HeaderTemplate;
+using ola::acn::E133PDU;
+using ola::acn::HeaderSet;
+using ola::acn::PreamblePacker;
+using ola::acn::RDMPDU;
+using ola::acn::RootInflator;
+using ola::acn::RootPDU;
+using ola::io::ByteString;
+using ola::io::IOStack;
+using ola::io::MemoryBlockPool;
+using ola::rdm::RDMCommandSerializer;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::vector;
+
+namespace {
+
+const uint16_t E131_UNIVERSE = 1;
+
+void FillBuffer(DmxBuffer *buffer) {
+  buffer->Blackout();
+  for (unsigned int i = 0; i < DMX_UNIVERSE_SIZE; i++) {
+    buffer->SetChannel(i, static_cast<uint8_t>(i));
+  }
+}
+
+void NewDmx() {}
+
+/*
+ * Patch a packet template with a new frame, the work done for each packet
+ * sent.
+ */
+void E131Build(BenchmarkState *state) {
+  E131PacketTemplate packet;
+  if (!packet.Init(CID::Generate(), "benchmark", E131_UNIVERSE, false)) {
+    state->SetError("Failed to build the E1.31 packet");
+    return;
+  }
+  DmxBuffer buffer;
+  FillBuffer(&buffer);
+  uint8_t sequence = 0;
+  while (state->KeepRunning()) {
+    packet.Update(buffer, sequence++, 100, false);
+  }
+  DoNotOptimize(packet.Data());
+}
+
+/*
+ * Inflate a data packet through the same inflators as the E131Node.
+ */
+void E131Parse(BenchmarkState *state) {
+  RootInflator root_inflator;
+  E131Inflator e131_inflator;
+  DMPE131Inflator dmp_inflator(false);
+  root_inflator.AddInflator(&e131_inflator);
+  e131_inflator.AddInflator(&dmp_inflator);
+
+  DmxBuffer output;
+  uint8_t priority;
+  dmp_inflator.SetHandler(E131_UNIVERSE, &output, &priority,
+                          NewCallback(NewDmx));
+
+  // Packets with an old sequence number are dropped, so use a different
+  // packet for each sequence number.
+  E131PacketTemplate packet;
+  if (!packet.Init(CID::Generate(), "benchmark", E131_UNIVERSE, false)) {
+    state->SetError("Failed to build the E1.31 packet");
+    return;
+  }
+  DmxBuffer buffer;
+  FillBuffer(&buffer);
+  const unsigned int header_size = PreamblePacker::ACN_HEADER_SIZE;
+  vector<ByteString> packets;
+  for (unsigned int i = 0; i < 256; i++) {
+    packet.Update(buffer, static_cast<uint8_t>(i), 100, false);
+    packets.push_back(ByteString(packet.Data() + header_size,
+                                 packet.Size() - header_size));
+  }
+
+  unsigned int i = 0;
+  while (state->KeepRunning()) {
+    const ByteString &data = packets[i++ % packets.size()];
+    HeaderSet headers;
+    root_inflator.InflatePDUBlock(&headers, data.data(), data.size());
+  }
+  DoNotOptimize(&output);
+  if (output.Size() != DMX_UNIVERSE_SIZE) {
+    state->SetError("The E1.31 packet wasn't inflated");
+  }
+}
+
+RDMRequest *NewRequest() {
+  const uint8_t param_data[] = {0, 1, 2, 3};
+  return new RDMGetRequest(UID(OPEN_LIGHTING_ESTA_CODE, 1),
+                           UID(OPEN_LIGHTING_ESTA_CODE, 2),
+                           0, 1, 0, ola::rdm::PID_DEVICE_LABEL,
+                           param_data, sizeof(param_data));
+}
+
+void RDMSerializeRequest(BenchmarkState *state) {
+  auto_ptr<RDMRequest> request(NewRequest());
+  ByteString output;
+  while (state->KeepRunning()) {
+    output.clear();
+    RDMCommandSerializer::Pack(*request, &output);
+  }
+  DoNotOptimize(output.data());
+}
+
+void RDMInflateRequest(BenchmarkState *state) {
+  auto_ptr<RDMRequest> request(NewRequest());
+  ByteString data;
+  RDMCommandSerializer::Pack(*request, &data);
+  while (state->KeepRunning()) {
+    RDMRequest *inflated = RDMRequest::InflateFromData(data.data(),
+                                                       data.size());
+    DoNotOptimize(inflated);
+    delete inflated;
+  }
+}
+
+/*
+ * Build a TCP E1.33 RDM message one PDU at a time.
+ */
+void E133BuildRDMFromPDUs(BenchmarkState *state) {
+  auto_ptr<RDMRequest> request(NewRequest());
+  const CID cid = CID::Generate();
+  const std::string source = "benchmark";
+  MemoryBlockPool pool;
+  uint32_t sequence_number = 0;
+  unsigned int size = 0;
+  while (state->KeepRunning()) {
+    IOStack packet(&pool);
+    RDMCommandSerializer::Write(*request, &packet);
+    RDMPDU::PrependPDU(&packet);
+    E133PDU::PrependPDU(&packet, ola::acn::VECTOR_FRAMING_RDMNET, source,
+                        sequence_number++, 1);
+    RootPDU::PrependPDU(&packet, ola::acn::VECTOR_ROOT_E133, cid);
+    PreamblePacker::AddTCPPreamble(&packet);
+    size = packet.Size();
+  }
+  DoNotOptimize(&size);
+}
+
+/*
+ * Build the same message with the pre-built headers.
+ */
+void E133BuildRDM(BenchmarkState *state) {
+  auto_ptr<RDMRequest> request(NewRequest());
+  E133HeaderTemplate header_template(CID::Generate(), "benchmark");
+  MemoryBlockPool pool;
+  uint32_t sequence_number = 0;
+  unsigned int size = 0;
+  while (state->KeepRunning()) {
+    IOStack packet(&pool);
+    RDMCommandSerializer::Write(*request, &packet);
+    header_template.PrependRDM(&packet, E133HeaderTemplate::TCP_PREAMBLE,
+                               sequence_number++, 1);
+    size = packet.Size();
+  }
+  DoNotOptimize(&size);
+}
+
+void RDMInflateResponse(BenchmarkState *state) {
+  auto_ptr<RDMRequest> request(NewRequest());
+  const uint8_t label[] = "a device label";
+  auto_ptr<RDMResponse> response(ola::rdm::GetResponseFromData(
+      request.get(), label, sizeof(label)));
+  ByteString data;
+  RDMCommandSerializer::Pack(*response, &data);
+  while (state->KeepRunning()) {
+    ola::rdm::RDMStatusCode status_code;
+    RDMResponse *inflated = RDMResponse::InflateFromData(
+        data.data(), data.size(), &status_code, request.get());
+    DoNotOptimize(inflated);
+    delete inflated;
+  }
+}
+}  // namespace
+
+void RegisterProtocolBenchmarks(BenchmarkRunner *runner) {
+  runner->Add("E131/Build", E131Build);
+  runner->Add("E131/Parse", E131Parse);
+  runner->Add("E133/BuildRDMFromPDUs", E133BuildRDMFromPDUs);
+  runner->Add("E133/BuildRDM", E133BuildRDM);
+  runner->Add("RDM/SerializeRequest", RDMSerializeRequest);
+  runner->Add("RDM/InflateRequest", RDMInflateRequest);
+  runner->Add("RDM/InflateResponse", RDMInflateResponse);
+}
+}  // namespace benchmark
+}  // namespace ola
@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RpcBenchmarks.cpp
+ * Benchmarks for RpcChannel round trips.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <memory>
+#include <string>
+
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
+#include "common/rpc/TestServiceService.pb.h"
+#include "ola/Callback.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "tools/benchmark/Benchmark.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::io::SelectServer;
+using ola::io::UnixSocket;
+using ola::rpc::EchoReply;
+using ola::rpc::EchoRequest;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using ola::rpc::STREAMING_NO_RESPONSE;
+using ola::rpc::TestService_Stub;
+using std::auto_ptr;
+using std::string;
+
+namespace {
+
+class EchoService : public ola::rpc::TestService {
+ public:
+  EchoService() : requests(0) {}
+
+  void Echo(RpcController*, const EchoRequest *request, EchoReply *response,
+            CompletionCallback *done) {
+    response->set_data(request->data());
+    done->Run();
+  }
+
+  void FailedEcho(RpcController *controller, const EchoRequest*, EchoReply*,
+                  CompletionCallback *done) {
+    controller->SetFailed("Error");
+    done->Run();
+  }
+
+  void Stream(RpcController*, const EchoRequest*, STREAMING_NO_RESPONSE*,
+              CompletionCallback*) {
+    requests++;
+  }
+
+  unsigned int requests;
+};
+
+void EchoComplete(bool *complete) {
+  *complete = true;
+}
+
+/*
+ * Send an Echo request with Arg() bytes of data and wait for the reply.
+ */
+void RpcEcho(BenchmarkState *state) {
+  SelectServer ss;
+  EchoService service;
+  UnixSocket client_socket;
+  if (!client_socket.Init()) {
+    state->SetError("Failed to create the socket pair");
+    return;
+  }
+  auto_ptr<UnixSocket> server_socket(client_socket.OppositeEnd());
+  RpcChannel client_channel(NULL, &client_socket);
+  RpcChannel server_channel(&service, server_socket.get());
+  TestService_Stub stub(&client_channel);
+  ss.AddReadDescriptor(&client_socket);
+  ss.AddReadDescriptor(server_socket.get());
+
+  EchoRequest request;
+  request.set_data(string(state->Arg(), 'x'));
+  EchoReply reply;
+  RpcController controller;
+  while (state->KeepRunning()) {
+    bool complete = false;
+    controller.Reset();
+    stub.Echo(&controller, &request, &reply,
+              NewSingleCallback(EchoComplete, &complete));
+    while (!complete) {
+      ss.RunOnce();
+    }
+  }
+
+  ss.RemoveReadDescriptor(&client_socket);
+  ss.RemoveReadDescriptor(server_socket.get());
+}
+
+/*
+ * Send a streaming request, like the DMX updates from a StreamingClient.
+ */
+void RpcStream(BenchmarkState *state) {
+  SelectServer ss;
+  EchoService service;
+  UnixSocket client_socket;
+  if (!client_socket.Init()) {
+    state->SetError("Failed to create the socket pair");
+    return;
+  }
+  auto_ptr<UnixSocket> server_socket(client_socket.OppositeEnd());
+  RpcChannel client_channel(NULL, &client_socket);
+  RpcChannel server_channel(&service, server_socket.get());
+  TestService_Stub stub(&client_channel);
+  ss.AddReadDescriptor(&client_socket);
+  ss.AddReadDescriptor(server_socket.get());
+
+  EchoRequest request;
+  request.set_data(string(state->Arg(), 'x'));
+  unsigned int sent = 0;
+  while (state->KeepRunning()) {
+    stub.Stream(NULL, &request, NULL, NULL);
+    sent++;
+    while (service.requests < sent) {
+      ss.RunOnce();
+    }
+  }
+
+  ss.RemoveReadDescriptor(&client_socket);
+  ss.RemoveReadDescriptor(server_socket.get());
+}
+}  // namespace
+
+void RegisterRpcBenchmarks(BenchmarkRunner *runner) {
+  runner->Add("RpcChannel/Echo", RpcEcho, 0);
+  runner->Add("RpcChannel/Echo", RpcEcho, 512);
+  runner->Add("RpcChannel/Stream", RpcStream, 512);
+}
+}  // namespace benchmark
+}  // namespace ola
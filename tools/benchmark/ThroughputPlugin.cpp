@@ -0,0 +1,649 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ThroughputPlugin.cpp
+ * A plugin that feeds and drains universes for the olad benchmark.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/E131Inflator.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootInflator.h"
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/acn/CID.h"
+#include "ola/dmx/SourcePriorities.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "olad/Device.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Port.h"
+#include "olad/Preferences.h"
+#include "tools/benchmark/ThroughputPlugin.h"
+
+#ifdef USE_ARTNET
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Interface.h"
+#include "ola/network/MACAddress.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "plugins/artnet/ArtNetNode.h"
+#endif  // USE_ARTNET
+
+namespace ola {
+namespace benchmark {
+
+using ola::acn::CID;
+using ola::acn::E131PacketTemplate;
+using ola::strings::IntToString;
+using std::string;
+using std::vector;
+
+const unsigned int FrameRecorder::TAG_SIZE;
+
+FrameRecorder::FrameRecorder(unsigned int universes)
+    : m_window_start(0),
+      m_window_end(0),
+      m_states(universes),
+      m_sorted(false) {
+  m_clock.CurrentTime(&m_start_time);
+}
+
+void FrameRecorder::SetWindow(const TimeInterval &start,
+                              const TimeInterval &end) {
+  m_window_start = static_cast<uint32_t>(start.AsInt());
+  m_window_end = static_cast<uint32_t>(end.AsInt());
+}
+
+uint32_t FrameRecorder::Now() const {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  return static_cast<uint32_t>((now - m_start_time).AsInt());
+}
+
+bool FrameRecorder::WindowComplete() const {
+  return Now() >= m_window_end;
+}
+
+void FrameRecorder::InitFrame(unsigned int source, DmxBuffer *buffer) {
+  buffer->Blackout();
+  for (unsigned int i = TAG_SIZE; i < DMX_UNIVERSE_SIZE; i++) {
+    buffer->SetChannel(i, static_cast<uint8_t>(i + source * 16));
+  }
+}
+
+void FrameRecorder::NextFrame(unsigned int universe, unsigned int source,
+                              DmxBuffer *buffer) {
+  if (source) {
+    // Change the frame without touching the tag.
+    buffer->SetChannel(TAG_SIZE, buffer->Get(TAG_SIZE) + 1);
+    return;
+  }
+
+  UniverseState *state = &m_states[universe];
+  uint32_t now = Now();
+  SetUInt32(buffer, 0, ++state->sequence);
+  SetUInt32(buffer, 4, now);
+  if (InWindow(now)) {
+    state->sent++;
+  }
+}
+
+void FrameRecorder::FrameWritten(unsigned int universe,
+                                 const DmxBuffer &buffer) {
+  if (universe >= m_states.size() || buffer.Size() < TAG_SIZE) {
+    return;
+  }
+
+  uint32_t now = Now();
+  UniverseState *state = &m_states[universe];
+  if (InWindow(now)) {
+    state->output_writes++;
+  }
+
+  // With more than one source, a frame from source 0 may be written more
+  // than once.
+  uint32_t sequence = GetUInt32(buffer, 0);
+  if (sequence <= state->last_sequence) {
+    return;
+  }
+  state->last_sequence = sequence;
+
+  uint32_t sent_time = GetUInt32(buffer, 4);
+  if (InWindow(sent_time)) {
+    state->received++;
+    m_latencies.push_back(now - sent_time);
+    m_sorted = false;
+  }
+}
+
+uint64_t FrameRecorder::FramesSent() const {
+  uint64_t total = 0;
+  vector<UniverseState>::const_iterator iter = m_states.begin();
+  for (; iter != m_states.end(); ++iter) {
+    total += iter->sent;
+  }
+  return total;
+}
+
+uint64_t FrameRecorder::FramesReceived() const {
+  uint64_t total = 0;
+  vector<UniverseState>::const_iterator iter = m_states.begin();
+  for (; iter != m_states.end(); ++iter) {
+    total += iter->received;
+  }
+  return total;
+}
+
+uint64_t FrameRecorder::OutputWrites() const {
+  uint64_t total = 0;
+  vector<UniverseState>::const_iterator iter = m_states.begin();
+  for (; iter != m_states.end(); ++iter) {
+    total += iter->output_writes;
+  }
+  return total;
+}
+
+const vector<uint32_t> &FrameRecorder::Latencies() {
+  if (!m_sorted) {
+    std::sort(m_latencies.begin(), m_latencies.end());
+    m_sorted = true;
+  }
+  return m_latencies;
+}
+
+void FrameRecorder::SetUInt32(DmxBuffer *buffer, unsigned int offset,
+                              uint32_t value) {
+  for (unsigned int i = 0; i < 4; i++) {
+    buffer->SetChannel(offset + i,
+                       static_cast<uint8_t>(value >> (24 - 8 * i)));
+  }
+}
+
+uint32_t FrameRecorder::GetUInt32(const DmxBuffer &buffer,
+                                  unsigned int offset) {
+  uint32_t value = 0;
+  for (unsigned int i = 0; i < 4; i++) {
+    value = (value << 8) | buffer.Get(offset + i);
+  }
+  return value;
+}
+
+
+namespace {
+
+/*
+ * An input port that's fed by a PacketSource.
+ */
+class ThroughputInputPort : public BasicInputPort {
+ public:
+  ThroughputInputPort(AbstractDevice *parent, unsigned int id,
+                      PluginAdaptor *plugin_adaptor)
+      : BasicInputPort(parent, id, plugin_adaptor),
+        m_priority(ola::dmx::SOURCE_PRIORITY_DEFAULT) {
+  }
+
+  string Description() const { return ""; }
+  const DmxBuffer &ReadDMX() const { return m_buffer; }
+
+  DmxBuffer *Buffer() { return &m_buffer; }
+  uint8_t *Priority() { return &m_priority; }
+
+ private:
+  DmxBuffer m_buffer;
+  uint8_t m_priority;
+};
+
+/*
+ * An output port that passes the frames to the FrameRecorder.
+ */
+class ThroughputOutputPort : public BasicOutputPort {
+ public:
+  ThroughputOutputPort(AbstractDevice *parent, unsigned int id,
+                       FrameRecorder *recorder)
+      : BasicOutputPort(parent, id),
+        m_recorder(recorder) {
+  }
+
+  string Description() const { return ""; }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t) {
+    m_recorder->FrameWritten(PortId(), buffer);
+    return true;
+  }
+
+ private:
+  FrameRecorder *m_recorder;
+};
+
+/*
+ * Turns frames into packets and runs them through a protocol's receive path.
+ */
+class PacketSource {
+ public:
+  virtual ~PacketSource() {}
+
+  /*
+   * Set up the receive path, ports[N] receives the frames for universe index
+   * N.
+   */
+  virtual bool Init(const vector<ThroughputInputPort*> &ports) = 0;
+
+  virtual void SendFrame(unsigned int universe, unsigned int source,
+                         const DmxBuffer &frame) = 0;
+};
+
+/*
+ * Builds E1.31 data packets and passes them through the inflators the
+ * E131Node uses. Each source has its own CID.
+ */
+class E131PacketSource : public PacketSource {
+ public:
+  explicit E131PacketSource(unsigned int sources)
+      : m_sources(sources),
+        m_dmp_inflator(false) {
+    m_root_inflator.AddInflator(&m_e131_inflator);
+    m_e131_inflator.AddInflator(&m_dmp_inflator);
+  }
+
+  ~E131PacketSource() {
+    ola::STLDeleteElements(&m_packets);
+  }
+
+  bool Init(const vector<ThroughputInputPort*> &ports);
+  void SendFrame(unsigned int universe, unsigned int source,
+                 const DmxBuffer &frame);
+
+ private:
+  struct Packet {
+    E131PacketTemplate packet;
+    uint8_t sequence;
+  };
+
+  const unsigned int m_sources;
+  ola::acn::RootInflator m_root_inflator;
+  ola::acn::E131Inflator m_e131_inflator;
+  ola::acn::DMPE131Inflator m_dmp_inflator;
+  // Indexed by universe * m_sources + source
+  vector<Packet*> m_packets;
+};
+
+bool E131PacketSource::Init(const vector<ThroughputInputPort*> &ports) {
+  vector<CID> cids;
+  for (unsigned int i = 0; i < m_sources; i++) {
+    cids.push_back(CID::Generate());
+  }
+
+  for (unsigned int universe = 0; universe < ports.size(); universe++) {
+    uint16_t universe_id = static_cast<uint16_t>(universe + 1);
+    BasicInputPort *port = ports[universe];
+    m_dmp_inflator.SetHandler(
+        universe_id, ports[universe]->Buffer(), ports[universe]->Priority(),
+        NewCallback(port, &BasicInputPort::DmxChanged));
+
+    for (unsigned int source = 0; source < m_sources; source++) {
+      Packet *packet = new Packet();
+      packet->sequence = 0;
+      m_packets.push_back(packet);
+      if (!packet->packet.Init(cids[source], "source " + IntToString(source),
+                               universe_id, false)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void E131PacketSource::SendFrame(unsigned int universe, unsigned int source,
+                                 const DmxBuffer &frame) {
+  Packet *packet = m_packets[universe * m_sources + source];
+  packet->packet.Update(frame, packet->sequence++,
+                        ola::dmx::SOURCE_PRIORITY_DEFAULT, false);
+
+  // The UDP transport strips the preamble before the root inflator.
+  const unsigned int header_size = ola::acn::PreamblePacker::ACN_HEADER_SIZE;
+  ola::acn::HeaderSet headers;
+  m_root_inflator.InflatePDUBlock(&headers,
+                                  packet->packet.Data() + header_size,
+                                  packet->packet.Size() - header_size);
+}
+
+#ifdef USE_ARTNET
+/*
+ * Builds ArtDmx packets and injects them into ArtNetNodes. Each node uses a
+ * separate subnet and takes care of 16 universes. Each source has its own IP
+ * address.
+ */
+class ArtNetPacketSource : public PacketSource {
+ public:
+  ArtNetPacketSource(ola::io::SelectServerInterface *ss, unsigned int sources)
+      : m_ss(ss),
+        m_sources(sources) {
+  }
+
+  ~ArtNetPacketSource();
+
+  bool Init(const vector<ThroughputInputPort*> &ports);
+  void SendFrame(unsigned int universe, unsigned int source,
+                 const DmxBuffer &frame);
+
+ private:
+  struct Node {
+    ola::plugin::artnet::ArtNetNode *node;
+    ola::testing::MockUDPSocket *socket;
+  };
+
+  static const unsigned int ARTDMX_HEADER_SIZE = 18;
+  static const uint16_t ARTNET_PORT = 6454;
+  static const unsigned int UNIVERSES_PER_SUBNET = 16;
+
+  ola::io::SelectServerInterface *m_ss;
+  const unsigned int m_sources;
+  vector<Node> m_nodes;
+  vector<ola::network::IPV4Address> m_source_addresses;
+  uint8_t m_packet[ARTDMX_HEADER_SIZE + DMX_UNIVERSE_SIZE];
+};
+
+const unsigned int ArtNetPacketSource::ARTDMX_HEADER_SIZE;
+const uint16_t ArtNetPacketSource::ARTNET_PORT;
+const unsigned int ArtNetPacketSource::UNIVERSES_PER_SUBNET;
+
+ArtNetPacketSource::~ArtNetPacketSource() {
+  vector<Node>::iterator iter = m_nodes.begin();
+  for (; iter != m_nodes.end(); ++iter) {
+    iter->node->Stop();
+    // The node owns the socket.
+    delete iter->node;
+  }
+}
+
+bool ArtNetPacketSource::Init(const vector<ThroughputInputPort*> &ports) {
+  using ola::network::IPV4Address;
+  using ola::network::InterfaceBuilder;
+  using ola::plugin::artnet::ArtNetNode;
+  using ola::plugin::artnet::ArtNetNodeOptions;
+
+  InterfaceBuilder builder;
+  builder.SetAddress("10.0.0.1");
+  builder.SetSubnetMask("255.0.0.0");
+  builder.SetBroadcast("10.255.255.255");
+  builder.SetHardwareAddress(
+      ola::network::MACAddress::FromStringOrDie("0a:0b:0c:12:34:56"));
+  const ola::network::Interface iface = builder.Construct();
+
+  for (unsigned int i = 0; i < m_sources; i++) {
+    m_source_addresses.push_back(IPV4Address(
+        ola::network::HostToNetwork(static_cast<uint32_t>(0x0a000100 + i))));
+  }
+
+  unsigned int node_count = (
+      (ports.size() + UNIVERSES_PER_SUBNET - 1) / UNIVERSES_PER_SUBNET);
+  for (unsigned int i = 0; i < node_count; i++) {
+    Node node;
+    node.socket = new ola::testing::MockUDPSocket();
+    node.socket->SetDiscardMode(true);
+    ArtNetNodeOptions options;
+    options.input_port_count = 0;
+    options.output_port_count = UNIVERSES_PER_SUBNET;
+    node.node = new ArtNetNode(iface, m_ss, options, node.socket);
+    m_nodes.push_back(node);
+
+    node.node->SetNetAddress(static_cast<uint8_t>(i / UNIVERSES_PER_SUBNET));
+    node.node->SetSubnetAddress(
+        static_cast<uint8_t>(i % UNIVERSES_PER_SUBNET));
+    for (unsigned int port_id = 0; port_id < UNIVERSES_PER_SUBNET;
+         port_id++) {
+      unsigned int universe = i * UNIVERSES_PER_SUBNET + port_id;
+      if (universe >= ports.size()) {
+        break;
+      }
+      BasicInputPort *port = ports[universe];
+      node.node->SetOutputPortUniverse(port_id, port_id);
+      node.node->SetDMXHandler(
+          port_id, ports[universe]->Buffer(),
+          NewCallback(port, &BasicInputPort::DmxChanged));
+    }
+    if (!node.node->Start()) {
+      return false;
+    }
+  }
+
+  const uint8_t header[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,  // OpDmx
+    0x0, 14,  // version
+    0,  // sequence
+    0,  // physical port
+    0, 0,  // universe & net
+    DMX_UNIVERSE_SIZE >> 8, DMX_UNIVERSE_SIZE & 0xff,
+  };
+  std::copy(header, header + sizeof(header), m_packet);
+  return true;
+}
+
+void ArtNetPacketSource::SendFrame(unsigned int universe,
+                                   unsigned int source,
+                                   const DmxBuffer &frame) {
+  const Node &node = m_nodes[universe / UNIVERSES_PER_SUBNET];
+  // Port N of node M has a port address of M * 16 + N.
+  m_packet[14] = static_cast<uint8_t>(universe & 0xff);
+  m_packet[15] = static_cast<uint8_t>(universe >> 8);
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  frame.Get(m_packet + ARTDMX_HEADER_SIZE, &length);
+  node.socket->InjectData(m_packet, ARTDMX_HEADER_SIZE + length,
+                          m_source_addresses[source], ARTNET_PORT);
+}
+#endif  // USE_ARTNET
+}  // namespace
+
+
+/*
+ * A device with an output port for each universe, and input ports if the
+ * frames come from a PacketSource.
+ */
+class ThroughputDevice : public Device {
+ public:
+  ThroughputDevice(AbstractPlugin *owner,
+                   PluginAdaptor *plugin_adaptor,
+                   const ThroughputOptions &options,
+                   FrameRecorder *recorder)
+      : Device(owner, "Throughput Device"),
+        m_plugin_adaptor(plugin_adaptor),
+        m_options(options),
+        m_recorder(recorder),
+        m_send_timeout(ola::thread::INVALID_TIMEOUT) {
+  }
+
+  string DeviceId() const { return "1"; }
+  bool AllowLooping() const { return true; }
+
+ protected:
+  bool StartHook();
+  void PrePortStop();
+
+ private:
+  PluginAdaptor *m_plugin_adaptor;
+  const ThroughputOptions m_options;
+  FrameRecorder *m_recorder;
+  std::auto_ptr<PacketSource> m_packet_source;
+  vector<DmxBuffer> m_frames;
+  ola::thread::timeout_id m_send_timeout;
+
+  bool SendFrames();
+};
+
+bool ThroughputDevice::StartHook() {
+  switch (m_options.protocol) {
+    case SOURCE_E131:
+      m_packet_source.reset(new E131PacketSource(m_options.sources));
+      break;
+#ifdef USE_ARTNET
+    case SOURCE_ARTNET:
+      m_packet_source.reset(
+          new ArtNetPacketSource(m_plugin_adaptor, m_options.sources));
+      break;
+#endif  // USE_ARTNET
+    case SOURCE_STREAMING:
+      break;
+    default:
+      OLA_WARN << "Unsupported source protocol";
+      return false;
+  }
+
+  vector<ThroughputInputPort*> input_ports;
+  for (unsigned int i = 0; i < m_options.universes; i++) {
+    AddPort(new ThroughputOutputPort(this, i, m_recorder));
+    if (m_packet_source.get()) {
+      ThroughputInputPort *port = new ThroughputInputPort(
+          this, i, m_plugin_adaptor);
+      input_ports.push_back(port);
+      AddPort(port);
+    }
+  }
+
+  if (!m_packet_source.get()) {
+    return true;
+  }
+
+  if (!m_packet_source->Init(input_ports)) {
+    return false;
+  }
+
+  m_frames.resize(m_options.sources);
+  for (unsigned int i = 0; i < m_frames.size(); i++) {
+    FrameRecorder::InitFrame(i, &m_frames[i]);
+  }
+
+  m_send_timeout = m_plugin_adaptor->RegisterRepeatingTimeout(
+      TimeInterval(USEC_IN_SECONDS / m_options.fps),
+      NewCallback(this, &ThroughputDevice::SendFrames));
+  return true;
+}
+
+void ThroughputDevice::PrePortStop() {
+  if (m_send_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_plugin_adaptor->RemoveTimeout(m_send_timeout);
+    m_send_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  m_packet_source.reset();
+}
+
+bool ThroughputDevice::SendFrames() {
+  for (unsigned int universe = 0; universe < m_options.universes;
+       universe++) {
+    for (unsigned int source = 0; source < m_frames.size(); source++) {
+      DmxBuffer *frame = &m_frames[source];
+      m_recorder->NextFrame(universe, source, frame);
+      m_packet_source->SendFrame(universe, source, *frame);
+    }
+  }
+  return true;
+}
+
+
+const char ThroughputPlugin::PLUGIN_NAME[] = "Throughput Benchmark";
+const char ThroughputPlugin::PLUGIN_PREFIX[] = "throughput";
+
+string ThroughputPlugin::Description() const {
+  return "Throughput Benchmark Plugin\n"
+         "----------------------------\n"
+         "\n"
+         "Feeds and drains universes for olad_benchmark.\n";
+}
+
+bool ThroughputPlugin::StartHook() {
+  std::auto_ptr<ThroughputDevice> device(new ThroughputDevice(
+      this, m_plugin_adaptor, m_options, m_recorder));
+  if (!device->Start()) {
+    return false;
+  }
+  SetPatchings(*device);
+  m_device = device.release();
+  m_plugin_adaptor->RegisterDevice(m_device);
+  return true;
+}
+
+bool ThroughputPlugin::StopHook() {
+  if (m_device) {
+    m_plugin_adaptor->UnregisterDevice(m_device);
+    bool ret = m_device->Stop();
+    delete m_device;
+    m_device = NULL;
+    return ret;
+  }
+  return true;
+}
+
+/*
+ * Store the patchings and merge modes in the preferences, the same as if
+ * olad was restarting, so they're applied when the device is registered.
+ */
+void ThroughputPlugin::SetPatchings(const ThroughputDevice &device) {
+  // These are the preferences used by the DeviceManager and UniverseStore.
+  Preferences *port_preferences = m_plugin_adaptor->NewPreference("port");
+  Preferences *universe_preferences = m_plugin_adaptor->NewPreference(
+      "universe");
+
+  vector<InputPort*> input_ports;
+  device.InputPorts(&input_ports);
+  vector<InputPort*>::const_iterator input_iter = input_ports.begin();
+  for (; input_iter != input_ports.end(); ++input_iter) {
+    port_preferences->SetValue((*input_iter)->UniqueId(),
+                               (*input_iter)->PortId() + 1);
+  }
+
+  vector<OutputPort*> output_ports;
+  device.OutputPorts(&output_ports);
+  vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
+  for (; output_iter != output_ports.end(); ++output_iter) {
+    unsigned int universe_id = (*output_iter)->PortId() + 1;
+    port_preferences->SetValue((*output_iter)->UniqueId(), universe_id);
+    universe_preferences->SetValue(
+        "uni_" + IntToString(universe_id) + "_merge",
+        m_options.ltp ? "LTP" : "HTP");
+  }
+}
+
+
+vector<AbstractPlugin*> ThroughputPluginLoader::LoadPlugins() {
+  vector<AbstractPlugin*> plugins;
+  if (!m_plugin) {
+    m_plugin = new ThroughputPlugin(m_plugin_adaptor, m_options,
+                                    m_recorder);
+  }
+  plugins.push_back(m_plugin);
+  return plugins;
+}
+
+void ThroughputPluginLoader::UnloadPlugins() {
+  delete m_plugin;
+  m_plugin = NULL;
+}
+}  // namespace benchmark
+}  // namespace ola
@@ -0,0 +1,235 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ThroughputPlugin.h
+ * A plugin that feeds and drains universes for the olad benchmark.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_BENCHMARK_THROUGHPUTPLUGIN_H_
+#define TOOLS_BENCHMARK_THROUGHPUTPLUGIN_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/plugin_id.h"
+#include "olad/Plugin.h"
+#include "olad/PluginLoader.h"
+
+namespace ola {
+namespace benchmark {
+
+/**
+ * @brief How the frames get into olad.
+ */
+typedef enum {
+  SOURCE_E131,  /**< E1.31 packets, parsed by the E1.31 inflators */
+  SOURCE_ARTNET,  /**< ArtDmx packets, parsed by an ArtNetNode */
+  SOURCE_STREAMING  /**< StreamingClients connected to the RPC port */
+} SourceProtocol;
+
+/**
+ * @brief Tags the frames sent to olad and records the ones it writes out.
+ *
+ * Source 0 of each universe puts a sequence number and the time the frame
+ * was sent in the first 8 slots. The other sources leave these slots at 0,
+ * so the tag makes it through both HTP and LTP merges.
+ *
+ * Only frames sent within the measurement window are counted. Each
+ * universe's frames must be tagged from a single thread, and FrameWritten()
+ * must be called from the olad thread.
+ */
+class FrameRecorder {
+ public:
+  explicit FrameRecorder(unsigned int universes);
+
+  /**
+   * @brief Set the measurement window, relative to when the recorder was
+   *   created.
+   */
+  void SetWindow(const TimeInterval &start, const TimeInterval &end);
+
+  /**
+   * @brief The time since the recorder was created, in microseconds.
+   */
+  uint32_t Now() const;
+
+  /**
+   * @brief Returns true once the measurement window has passed.
+   */
+  bool WindowComplete() const;
+
+  /**
+   * @brief Fill a buffer with the initial frame for a source.
+   */
+  static void InitFrame(unsigned int source, DmxBuffer *buffer);
+
+  /**
+   * @brief Update a buffer from InitFrame() with the next frame to send.
+   * @param universe the universe index, starting from 0.
+   * @param source the source index, starting from 0.
+   * @param buffer the frame to update.
+   */
+  void NextFrame(unsigned int universe, unsigned int source,
+                 DmxBuffer *buffer);
+
+  /**
+   * @brief Record a frame written to an output port.
+   * @param universe the universe index, starting from 0.
+   * @param buffer the frame written.
+   */
+  void FrameWritten(unsigned int universe, const DmxBuffer &buffer);
+
+  unsigned int Universes() const { return m_states.size(); }
+  uint64_t FramesSent() const;
+  uint64_t FramesReceived() const;
+  uint64_t OutputWrites() const;
+  /**
+   * @brief The latencies in microseconds, sorted.
+   */
+  const std::vector<uint32_t> &Latencies();
+
+  static const unsigned int TAG_SIZE = 8;
+
+ private:
+  struct UniverseState {
+    UniverseState()
+        : sequence(0),
+          sent(0),
+          received(0),
+          last_sequence(0),
+          output_writes(0) {
+    }
+
+    // Updated by the sender
+    uint32_t sequence;
+    uint32_t sent;
+    // Updated by olad
+    uint32_t received;
+    uint32_t last_sequence;
+    uint32_t output_writes;
+  };
+
+  MonotonicClock m_clock;
+  TimeStamp m_start_time;
+  uint32_t m_window_start;
+  uint32_t m_window_end;
+  std::vector<UniverseState> m_states;
+  std::vector<uint32_t> m_latencies;
+  bool m_sorted;
+
+  bool InWindow(uint32_t time) const {
+    return time >= m_window_start && time < m_window_end;
+  }
+
+  static void SetUInt32(DmxBuffer *buffer, unsigned int offset,
+                        uint32_t value);
+  static uint32_t GetUInt32(const DmxBuffer &buffer, unsigned int offset);
+
+  DISALLOW_COPY_AND_ASSIGN(FrameRecorder);
+};
+
+
+/**
+ * @brief The scenario the ThroughputPlugin sets up.
+ */
+struct ThroughputOptions {
+ public:
+  ThroughputOptions()
+      : protocol(SOURCE_STREAMING),
+        universes(1),
+        sources(1),
+        fps(40),
+        ltp(false) {
+  }
+
+  SourceProtocol protocol;
+  unsigned int universes;
+  unsigned int sources;
+  unsigned int fps;
+  bool ltp;
+};
+
+
+/**
+ * @brief A plugin with an output port for each universe, and for E1.31 and
+ * ArtNet, an input port for each universe.
+ *
+ * Universe index N is patched to universe N + 1. For E1.31 and ArtNet, the
+ * plugin generates the packets on the olad thread and passes them through
+ * the same parsing code the E1.31 and ArtNet plugins use.
+ */
+class ThroughputPlugin : public Plugin {
+ public:
+  ThroughputPlugin(PluginAdaptor *plugin_adaptor,
+                   const ThroughputOptions &options,
+                   FrameRecorder *recorder)
+      : Plugin(plugin_adaptor),
+        m_options(options),
+        m_recorder(recorder),
+        m_device(NULL) {
+  }
+
+  std::string Name() const { return PLUGIN_NAME; }
+  std::string Description() const;
+  ola_plugin_id Id() const { return OLA_PLUGIN_DUMMY; }
+  std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+
+ private:
+  const ThroughputOptions m_options;
+  FrameRecorder *m_recorder;
+  class ThroughputDevice *m_device;
+
+  bool StartHook();
+  bool StopHook();
+  void SetPatchings(const class ThroughputDevice &device);
+
+  static const char PLUGIN_NAME[];
+  static const char PLUGIN_PREFIX[];
+
+  DISALLOW_COPY_AND_ASSIGN(ThroughputPlugin);
+};
+
+
+/**
+ * @brief Loads a single ThroughputPlugin.
+ */
+class ThroughputPluginLoader : public PluginLoader {
+ public:
+  ThroughputPluginLoader(const ThroughputOptions &options,
+                         FrameRecorder *recorder)
+      : m_options(options),
+        m_recorder(recorder),
+        m_plugin(NULL) {
+  }
+  ~ThroughputPluginLoader() { UnloadPlugins(); }
+
+  std::vector<AbstractPlugin*> LoadPlugins();
+  void UnloadPlugins();
+
+ private:
+  const ThroughputOptions m_options;
+  FrameRecorder *m_recorder;
+  ThroughputPlugin *m_plugin;
+
+  DISALLOW_COPY_AND_ASSIGN(ThroughputPluginLoader);
+};
+}  // namespace benchmark
+}  // namespace ola
+#endif  // TOOLS_BENCHMARK_THROUGHPUTPLUGIN_H_
@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * UtilBenchmarks.cpp
+ * Benchmarks for the TimeoutManager and the JSON classes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <memory>
+#include <string>
+
+#include "common/io/TimeoutManager.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Array.h"
+#include "ola/math/Random.h"
+#include "ola/strings/Format.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonStreamWriter.h"
+#include "ola/web/JsonWriter.h"
+#include "tools/benchmark/Benchmark.h"
+
+namespace ola {
+namespace benchmark {
+
+using ola::io::TimeoutManager;
+using ola::thread::timeout_id;
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using ola::web::JsonParser;
+using ola::web::JsonStreamWriter;
+using ola::web::JsonValue;
+using ola::web::JsonWriter;
+using std::auto_ptr;
+using std::string;
+
+namespace {
+
+const unsigned int JSON_UNIVERSES = 64;
+
+void SingleEvent() {}
+
+bool RepeatingEvent() {
+  return true;
+}
+
+/*
+ * Register a timeout and cancel it, like a request timer that's cleared when
+ * the response arrives, with Arg() other timeouts registered.
+ */
+void TimeoutRegisterCancel(BenchmarkState *state, bool use_timing_wheel) {
+  MockClock clock;
+  TimeoutManager manager(NULL, &clock, use_timing_wheel);
+  // These don't fire during the benchmark.
+  for (unsigned int i = 0; i < state->Arg(); i++) {
+    manager.RegisterRepeatingTimeout(
+        TimeInterval(ola::math::Random(10, 100), 0),
+        NewCallback(RepeatingEvent));
+  }
+
+  const TimeInterval interval(0, 500000);
+  TimeStamp now;
+  unsigned int i = 0;
+  while (state->KeepRunning()) {
+    timeout_id id = manager.RegisterSingleTimeout(
+        interval, NewSingleCallback(SingleEvent));
+    manager.CancelTimeout(id);
+    // The heap removes cancelled timeouts lazily, so include the cleanup.
+    if (++i % 1024 == 0) {
+      clock.AdvanceTime(1, 0);
+      clock.CurrentTime(&now);
+      manager.ExecuteTimeouts(&now);
+    }
+  }
+}
+
+/*
+ * Run Arg() repeating timeouts, advancing the clock 1ms each iteration.
+ */
+void TimeoutExecute(BenchmarkState *state, bool use_timing_wheel) {
+  MockClock clock;
+  TimeoutManager manager(NULL, &clock, use_timing_wheel);
+  for (unsigned int i = 0; i < state->Arg(); i++) {
+    manager.RegisterRepeatingTimeout(
+        TimeInterval(ola::math::Random(1000, 100000)),
+        NewCallback(RepeatingEvent));
+  }
+
+  TimeStamp now;
+  while (state->KeepRunning()) {
+    clock.AdvanceTime(0, 1000);
+    clock.CurrentTime(&now);
+    manager.ExecuteTimeouts(&now);
+  }
+}
+
+void HeapRegisterCancel(BenchmarkState *state) {
+  TimeoutRegisterCancel(state, false);
+}
+
+void WheelRegisterCancel(BenchmarkState *state) {
+  TimeoutRegisterCancel(state, true);
+}
+
+void HeapExecute(BenchmarkState *state) {
+  TimeoutExecute(state, false);
+}
+
+void WheelExecute(BenchmarkState *state) {
+  TimeoutExecute(state, true);
+}
+
+/*
+ * A document like the one returned by /json/universe_plugin_list.
+ */
+JsonObject *BuildDocument() {
+  JsonObject *root = new JsonObject();
+  JsonArray *universes = root->AddArray("universes");
+  for (unsigned int i = 0; i < JSON_UNIVERSES; i++) {
+    JsonObject *universe = universes->AppendObject();
+    universe->Add("id", i);
+    universe->Add("input_ports", 1u);
+    universe->Add("name", "Universe " + ola::strings::IntToString(i));
+    universe->Add("output_ports", 2u);
+    universe->Add("rdm_devices", 12u);
+    universe->Add("active", true);
+  }
+  return root;
+}
+
+void JsonParse(BenchmarkState *state) {
+  auto_ptr<JsonObject> document(BuildDocument());
+  const string input = JsonWriter::AsString(*document);
+  while (state->KeepRunning()) {
+    string error;
+    JsonValue *value = JsonParser::Parse(input, &error);
+    DoNotOptimize(value);
+    delete value;
+  }
+  state->SetItemsProcessed(
+      static_cast<uint64_t>(state->Iterations()) * input.size());
+}
+
+void JsonWrite(BenchmarkState *state) {
+  auto_ptr<JsonObject> document(BuildDocument());
+  while (state->KeepRunning()) {
+    const string output = JsonWriter::AsString(*document);
+    DoNotOptimize(output.data());
+  }
+}
+
+void JsonStreamWrite(BenchmarkState *state) {
+  string output;
+  while (state->KeepRunning()) {
+    output.clear();
+    JsonStreamWriter writer(&output);
+    writer.StartObject();
+    writer.AddArray("universes");
+    for (unsigned int i = 0; i < JSON_UNIVERSES; i++) {
+      writer.StartObject();
+      writer.Add("id", i);
+      writer.Add("input_ports", 1u);
+      writer.Add("name", "Universe " + ola::strings::IntToString(i));
+      writer.Add("output_ports", 2u);
+      writer.Add("rdm_devices", 12u);
+      writer.Add("active", true);
+      writer.End();
+    }
+    writer.End();
+    writer.End();
+  }
+  DoNotOptimize(output.data());
+}
+}  // namespace
+
+void RegisterUtilBenchmarks(BenchmarkRunner *runner) {
+  const unsigned int timers[] = {10, 1000, 10000};
+  for (unsigned int i = 0; i < arraysize(timers); i++) {
+    runner->Add("TimeoutManager/Heap/RegisterCancel", HeapRegisterCancel,
+                timers[i]);
+    runner->Add("TimeoutManager/Wheel/RegisterCancel", WheelRegisterCancel,
+                timers[i]);
+    runner->Add("TimeoutManager/Heap/Execute", HeapExecute, timers[i]);
+    runner->Add("TimeoutManager/Wheel/Execute", WheelExecute, timers[i]);
+  }
+
+  runner->Add("Json/Parse", JsonParse);
+  runner->Add("Json/Write", JsonWrite);
+  runner->Add("Json/StreamWrite", JsonStreamWrite);
+}
+}  // namespace benchmark
+}  // namespace ola
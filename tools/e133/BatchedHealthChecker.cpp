@@ -0,0 +1,207 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BatchedHealthChecker.cpp
+ * Health checks many E1.33 TCP connections from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/io/IOStack.h>
+#include <ola/io/NonBlockingSender.h>
+
+#include <list>
+#include <vector>
+
+#include "tools/e133/BatchedHealthChecker.h"
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::IOStack;
+using ola::io::NonBlockingSender;
+using std::vector;
+
+/**
+ * The state for each connection.
+ */
+class BatchedHealthChecker::Connection {
+ public:
+    Connection(NonBlockingSender *message_queue,
+               ola::SingleUseCallback0<void> *on_timeout)
+        : message_queue(message_queue),
+          on_timeout(on_timeout),
+          timed_out(false) {
+    }
+
+    ~Connection() {
+      delete on_timeout;
+    }
+
+    NonBlockingSender *message_queue;
+    ola::SingleUseCallback0<void> *on_timeout;
+    TimeStamp next_heartbeat;
+    TimeStamp expiry;
+    bool timed_out;  // if true, this isn't in m_receive_list.
+    ConnectionList::iterator send_iter;
+    ConnectionList::iterator receive_iter;
+
+ private:
+    DISALLOW_COPY_AND_ASSIGN(Connection);
+};
+
+
+/**
+ * Create a new BatchedHealthChecker.
+ * @param ss the SelectServer to use for the timer.
+ * @param message_builder the MessageBuilder to use to create heartbeats.
+ * @param heartbeat_interval the TimeInterval between heartbeats.
+ */
+BatchedHealthChecker::BatchedHealthChecker(
+    ola::io::SelectServerInterface *ss,
+    ola::e133::MessageBuilder *message_builder,
+    const TimeInterval heartbeat_interval)
+    : m_ss(ss),
+      m_message_builder(message_builder),
+      m_heartbeat_interval(heartbeat_interval),
+      m_timeout_interval(static_cast<int64_t>(
+          2.5 * heartbeat_interval.AsInt())),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_connection_count(0),
+      m_heartbeats_sent(0),
+      m_timeouts(0) {
+  m_timeout_id = m_ss->RegisterRepeatingTimeout(
+      TimeInterval(heartbeat_interval.AsInt() / TICKS_PER_INTERVAL),
+      ola::NewCallback(this, &BatchedHealthChecker::RunTimer));
+}
+
+
+BatchedHealthChecker::~BatchedHealthChecker() {
+  m_ss->RemoveTimeout(m_timeout_id);
+  ConnectionList::iterator iter = m_send_list.begin();
+  for (; iter != m_send_list.end(); ++iter) {
+    delete *iter;
+  }
+}
+
+
+BatchedHealthChecker::Connection *BatchedHealthChecker::AddConnection(
+    NonBlockingSender *message_queue,
+    ola::SingleUseCallback0<void> *on_timeout) {
+  Connection *connection = new Connection(message_queue, on_timeout);
+  connection->expiry = Deadline(m_timeout_interval);
+  connection->send_iter = m_send_list.insert(m_send_list.end(), connection);
+  connection->receive_iter = m_receive_list.insert(m_receive_list.end(),
+                                                   connection);
+  m_connection_count++;
+  SendHeartbeat(connection, Deadline(m_heartbeat_interval));
+  return connection;
+}
+
+
+void BatchedHealthChecker::RemoveConnection(Connection *connection) {
+  m_send_list.erase(connection->send_iter);
+  if (!connection->timed_out) {
+    m_receive_list.erase(connection->receive_iter);
+  }
+  m_connection_count--;
+  delete connection;
+}
+
+
+void BatchedHealthChecker::HeartbeatReceived(Connection *connection) {
+  if (connection->timed_out) {
+    return;
+  }
+  connection->expiry = Deadline(m_timeout_interval);
+  m_receive_list.splice(m_receive_list.end(), m_receive_list,
+                        connection->receive_iter);
+}
+
+
+void BatchedHealthChecker::HeartbeatSent(Connection *connection) {
+  connection->next_heartbeat = Deadline(m_heartbeat_interval);
+  m_send_list.splice(m_send_list.end(), m_send_list, connection->send_iter);
+}
+
+
+/*
+ * Send the heartbeats that are due, and time out any connections we haven't
+ * heard from.
+ */
+bool BatchedHealthChecker::RunTimer() {
+  const TimeStamp now = *m_ss->WakeUpTime();
+  while (!m_send_list.empty() && m_send_list.front()->next_heartbeat <= now) {
+    SendHeartbeat(m_send_list.front(), now + m_heartbeat_interval);
+  }
+
+  // The callbacks may remove connections, so don't run them until we're done
+  // with the list.
+  vector<ola::SingleUseCallback0<void>*> callbacks;
+  while (!m_receive_list.empty() && m_receive_list.front()->expiry <= now) {
+    Connection *connection = m_receive_list.front();
+    if (!connection->expiry.IsSet()) {
+      // Added before the SelectServer was running, start the clock now.
+      connection->expiry = now + m_timeout_interval;
+      m_receive_list.splice(m_receive_list.end(), m_receive_list,
+                            connection->receive_iter);
+      continue;
+    }
+    m_receive_list.pop_front();
+    connection->timed_out = true;
+    m_timeouts++;
+    if (connection->on_timeout) {
+      callbacks.push_back(connection->on_timeout);
+      connection->on_timeout = NULL;
+    }
+  }
+
+  if (!callbacks.empty()) {
+    OLA_INFO << callbacks.size() << " TCP connection heartbeat timeouts";
+  }
+  vector<ola::SingleUseCallback0<void>*>::iterator iter = callbacks.begin();
+  for (; iter != callbacks.end(); ++iter) {
+    (*iter)->Run();
+  }
+  return true;
+}
+
+
+/*
+ * Return the time interval from now. The SelectServer doesn't know the time
+ * until it starts running, so until then this returns an unset TimeStamp,
+ * which RunTimer() treats as due.
+ */
+TimeStamp BatchedHealthChecker::Deadline(const TimeInterval &interval) const {
+  const TimeStamp *now = m_ss->WakeUpTime();
+  return now->IsSet() ? *now + interval : TimeStamp();
+}
+
+
+/*
+ * Send a heartbeat and move the connection to the back of the send list.
+ */
+void BatchedHealthChecker::SendHeartbeat(Connection *connection,
+                                         const TimeStamp &next_heartbeat) {
+  IOStack packet(m_message_builder->pool());
+  m_message_builder->BuildNullTCPPacket(&packet);
+  connection->message_queue->SendMessage(
+      &packet, ola::io::NonBlockingSender::PRIORITY_HIGH);
+  m_heartbeats_sent++;
+
+  connection->next_heartbeat = next_heartbeat;
+  m_send_list.splice(m_send_list.end(), m_send_list, connection->send_iter);
+}
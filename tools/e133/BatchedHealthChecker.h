@@ -0,0 +1,124 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BatchedHealthChecker.h
+ * Health checks many E1.33 TCP connections from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_E133_BATCHEDHEALTHCHECKER_H_
+#define TOOLS_E133_BATCHEDHEALTHCHECKER_H_
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/e133/MessageBuilder.h>
+#include <ola/io/NonBlockingSender.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/thread/SchedulerInterface.h>
+
+#include <list>
+
+/**
+ * Health checks a set of TCP connections, using the same heartbeat logic as
+ * the E133HealthCheckedConnection.
+ *
+ * E133HealthCheckedConnection uses two timers per connection, and the receive
+ * timer is removed and registered again for every message received. With
+ * thousands of connections that's a lot of timer churn. Since every
+ * connection uses the same heartbeat interval, the deadlines are always now
+ * plus a constant, so keeping the connections in a list ordered by deadline
+ * only needs the updated connection moved to the back. A single repeating
+ * timer then sends the heartbeats and times out connections from the front of
+ * the lists.
+ *
+ * Heartbeats and timeouts may be up to HeartbeatInterval() / TICKS_PER_INTERVAL
+ * late.
+ */
+class BatchedHealthChecker {
+ public:
+    class Connection;
+
+    BatchedHealthChecker(
+        ola::io::SelectServerInterface *ss,
+        ola::e133::MessageBuilder *message_builder,
+        const ola::TimeInterval heartbeat_interval =
+          ola::TimeInterval(E133_TCP_HEARTBEAT_INTERVAL, 0));
+    ~BatchedHealthChecker();
+
+    /**
+     * @brief Start health checking a connection. This sends a heartbeat.
+     * @param message_queue the NonBlockingSender to send heartbeats on.
+     * @param on_timeout the callback to run if the heartbeats don't arrive,
+     *   ownership is transferred.
+     * @returns A handle for the connection, which is valid until
+     *   RemoveConnection() is called.
+     */
+    Connection *AddConnection(ola::io::NonBlockingSender *message_queue,
+                              ola::SingleUseCallback0<void> *on_timeout);
+
+    /**
+     * @brief Stop health checking a connection.
+     * @param connection the connection returned by AddConnection().
+     */
+    void RemoveConnection(Connection *connection);
+
+    /**
+     * @brief Call this every time a message is received on the connection.
+     */
+    void HeartbeatReceived(Connection *connection);
+
+    /**
+     * @brief Call this when a heartbeat is piggybacked on another message.
+     */
+    void HeartbeatSent(Connection *connection);
+
+    ola::TimeInterval HeartbeatInterval() const { return m_heartbeat_interval; }
+    unsigned int ConnectionCount() const { return m_connection_count; }
+    unsigned int HeartbeatsSent() const { return m_heartbeats_sent; }
+    unsigned int Timeouts() const { return m_timeouts; }
+
+    // How often the timer runs.
+    enum { TICKS_PER_INTERVAL = 10 };
+
+ private:
+    typedef std::list<Connection*> ConnectionList;
+
+    ola::io::SelectServerInterface *m_ss;
+    ola::e133::MessageBuilder *m_message_builder;
+    const ola::TimeInterval m_heartbeat_interval;
+    const ola::TimeInterval m_timeout_interval;
+    ola::thread::timeout_id m_timeout_id;
+
+    // Ordered by the time the next heartbeat is due.
+    ConnectionList m_send_list;
+    // Ordered by the time the connection times out.
+    ConnectionList m_receive_list;
+
+    unsigned int m_connection_count;
+    unsigned int m_heartbeats_sent;
+    unsigned int m_timeouts;
+
+    bool RunTimer();
+    void SendHeartbeat(Connection *connection,
+                       const ola::TimeStamp &next_heartbeat);
+    ola::TimeStamp Deadline(const ola::TimeInterval &interval) const;
+
+    // The default interval in seconds for sending heartbeat messages.
+    static const unsigned int E133_TCP_HEARTBEAT_INTERVAL = 5;
+
+    DISALLOW_COPY_AND_ASSIGN(BatchedHealthChecker);
+};
+#endif  // TOOLS_E133_BATCHEDHEALTHCHECKER_H_
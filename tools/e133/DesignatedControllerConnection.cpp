@@ -30,10 +30,8 @@
 #include "ola/network/IPV4Address.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/rdm/RDMCommand.h"
-#include "ola/rdm/RDMCommandSerializer.h"
 #include "libs/acn/E133Header.h"
 #include "libs/acn/E133StatusInflator.h"
-#include "libs/acn/RDMPDU.h"
 #include "tools/e133/DesignatedControllerConnection.h"
 #include "tools/e133/E133HealthCheckedConnection.h"
 #include "tools/e133/TCPConnectionStats.h"
@@ -121,7 +119,9 @@ DesignatedControllerConnection::~DesignatedControllerConnection() {
   m_ss->RemoveReadDescriptor(&m_listening_tcp_socket);
   m_listening_tcp_socket.Close();
 
-  TCPConnectionClosed();
+  if (m_tcp_socket) {
+    TCPConnectionClosed();
+  }
 }
 
 
@@ -346,11 +346,8 @@ bool DesignatedControllerConnection::SendRDMCommand(
     return false;
 
   IOStack packet(m_message_builder->pool());
-  ola::rdm::RDMCommandSerializer::Write(*rdm_response, &packet);
-  ola::acn::RDMPDU::PrependPDU(&packet);
-  m_message_builder->BuildTCPRootE133(
-      &packet, ola::acn::VECTOR_FRAMING_RDMNET, sequence_number,
-      endpoint);
+  m_message_builder->BuildTCPRDMCommand(&packet, *rdm_response,
+                                        sequence_number, endpoint);
 
   return m_message_queue->SendMessage(&packet);
 }
@@ -41,7 +41,6 @@
 
 #include "tools/e133/DeviceManagerImpl.h"
 #include "tools/e133/E133Endpoint.h"
-#include "tools/e133/E133HealthCheckedConnection.h"
 
 namespace ola {
 namespace e133 {
@@ -71,7 +70,7 @@ class DeviceState {
     DeviceState()
       : socket(NULL),
         message_queue(NULL),
-        health_checked_connection(NULL),
+        health_check(NULL),
         in_transport(NULL),
         am_designated_controller(false) {
     }
@@ -80,8 +79,8 @@ class DeviceState {
     // The socket connected to the E1.33 device
     auto_ptr<TCPSocket> socket;
     auto_ptr<NonBlockingSender> message_queue;
-    // The Health Checked connection
-    auto_ptr<E133HealthCheckedConnection> health_checked_connection;
+    // The health check for the connection, owned by the BatchedHealthChecker
+    BatchedHealthChecker::Connection *health_check;
     auto_ptr<IncomingTCPTransport> in_transport;
 
     // True if we're the designated controller.
@@ -113,6 +112,7 @@ DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
       m_connector(m_ss, &m_tcp_socket_factory, TCP_CONNECT_TIMEOUT),
       m_backoff_policy(INITIAL_TCP_RETRY_DELAY, MAX_TCP_RETRY_DELAY),
       m_message_builder(message_builder),
+      m_health_checker(ss, message_builder),
       m_root_inflator(NewCallback(this, &DeviceManagerImpl::RLPDataReceived)) {
   m_root_inflator.AddInflator(&m_e133_inflator);
   m_e133_inflator.AddInflator(&m_rdm_inflator);
@@ -307,7 +307,10 @@ void DeviceManagerImpl::SocketClosed(IPV4Address ip_address) {
         IPV4SocketAddress(ip_address, ola::acn::E133_PORT), true);
   }
 
-  device_state->health_checked_connection.reset();
+  if (device_state->health_check) {
+    m_health_checker.RemoveConnection(device_state->health_check);
+    device_state->health_check = NULL;
+  }
   device_state->message_queue.reset();
   device_state->in_transport.reset();
   m_ss->RemoveReadDescriptor(device_state->socket.get());
@@ -335,7 +338,7 @@ void DeviceManagerImpl::RLPDataReceived(
   // If we're already the designated controller, we just need to notify the
   // HealthChecker.
   if (device_state->am_designated_controller) {
-    device_state->health_checked_connection->HeartbeatReceived();
+    m_health_checker.HeartbeatReceived(device_state->health_check);
     return;
   }
 
@@ -351,22 +354,13 @@ void DeviceManagerImpl::RLPDataReceived(
       new NonBlockingSender(device_state->socket.get(), m_ss,
                             m_message_builder->pool()));
 
-  E133HealthCheckedConnection *health_checked_connection =
-      new E133HealthCheckedConnection(
-          m_message_builder,
-          device_state->message_queue.get(),
-          NewSingleCallback(this, &DeviceManagerImpl::SocketUnhealthy, src_ip),
-          m_ss);
-
-  if (!health_checked_connection->Setup()) {
-    OLA_WARN << "Failed to setup heartbeat controller for " << src_ip;
-    SocketClosed(src_ip);
-    return;
+  if (device_state->health_check) {
+    OLA_WARN << "pre-existing health check for " << src_ip;
+    m_health_checker.RemoveConnection(device_state->health_check);
   }
-
-  if (device_state->health_checked_connection.get())
-    OLA_WARN << "pre-existing health_checked_connection for " << src_ip;
-  device_state->health_checked_connection.reset(health_checked_connection);
+  device_state->health_check = m_health_checker.AddConnection(
+      device_state->message_queue.get(),
+      NewSingleCallback(this, &DeviceManagerImpl::SocketUnhealthy, src_ip));
 }
 
 
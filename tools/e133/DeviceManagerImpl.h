@@ -45,6 +45,7 @@
 #include "libs/acn/E133Inflator.h"
 #include "libs/acn/RootInflator.h"
 #include "libs/acn/TCPTransport.h"
+#include "tools/e133/BatchedHealthChecker.h"
 
 namespace ola {
 namespace e133 {
@@ -92,6 +93,10 @@ class DeviceManagerImpl {
     void RemoveDeviceIfNotConnected(const IPV4Address &ip_address);
     void ListManagedDevices(vector<IPV4Address> *devices) const;
 
+    const BatchedHealthChecker &HealthChecker() const {
+      return m_health_checker;
+    }
+
  private:
     // hash_map of IPs to DeviceState
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint32_t, class DeviceState*>
@@ -109,6 +114,7 @@ class DeviceManagerImpl {
     ola::LinearBackoffPolicy m_backoff_policy;
 
     ola::e133::MessageBuilder *m_message_builder;
+    BatchedHealthChecker m_health_checker;
 
     // inflators
     ola::acn::RootInflator m_root_inflator;
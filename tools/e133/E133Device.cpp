@@ -25,7 +25,6 @@
 #include <ola/network/HealthCheckedConnection.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/SocketAddress.h>
-#include <ola/rdm/RDMCommandSerializer.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/RDMHelper.h>
 
@@ -35,7 +34,6 @@
 
 #include "libs/acn/E133Header.h"
 #include "libs/acn/E133PDU.h"
-#include "libs/acn/RDMPDU.h"
 #include "libs/acn/RDMInflator.h"
 #include "libs/acn/E133StatusInflator.h"
 #include "libs/acn/UDPTransport.h"
@@ -51,7 +49,6 @@ using ola::io::IOStack;
 using ola::network::HealthCheckedConnection;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
-using ola::acn::RDMPDU;
 using std::auto_ptr;
 using std::string;
 using std::vector;
@@ -265,11 +262,8 @@ void E133Device::EndpointRequestComplete(
   }
 
   IOStack packet(m_message_builder.pool());
-  ola::rdm::RDMCommandSerializer::Write(*reply->Response(), &packet);
-  RDMPDU::PrependPDU(&packet);
-  m_message_builder.BuildUDPRootE133(
-      &packet, ola::acn::VECTOR_FRAMING_RDMNET, sequence_number,
-      endpoint_id);
+  m_message_builder.BuildUDPRDMCommand(&packet, *reply->Response(),
+                                       sequence_number, endpoint_id);
 
   if (!m_udp_socket.SendTo(&packet, target)) {
     OLA_WARN << "Failed to send E1.33 response to " << target;
@@ -54,7 +54,8 @@ E133HealthCheckedConnection::E133HealthCheckedConnection(
 void E133HealthCheckedConnection::SendHeartbeat() {
   IOStack packet(m_message_builder->pool());
   m_message_builder->BuildNullTCPPacket(&packet);
-  m_message_queue->SendMessage(&packet);
+  m_message_queue->SendMessage(&packet,
+                               ola::io::NonBlockingSender::PRIORITY_HIGH);
 }
 
 
@@ -22,6 +22,8 @@ endif
 # libolae133common
 # Code required by both the controller and device.
 tools_e133_libolae133common_la_SOURCES = \
+    tools/e133/BatchedHealthChecker.cpp \
+    tools/e133/BatchedHealthChecker.h \
     tools/e133/E133HealthCheckedConnection.cpp \
     tools/e133/E133HealthCheckedConnection.h \
     tools/e133/E133Receiver.cpp \
@@ -34,7 +36,9 @@ tools_e133_libolae133common_la_LIBADD = libs/acn/libolae131core.la
 tools_e133_libolae133controller_la_SOURCES = \
     tools/e133/DeviceManager.cpp \
     tools/e133/DeviceManagerImpl.cpp \
-    tools/e133/DeviceManagerImpl.h
+    tools/e133/DeviceManagerImpl.h \
+    tools/e133/ShardedDeviceManager.cpp \
+    tools/e133/ShardedDeviceManager.h
 tools_e133_libolae133controller_la_LIBADD = \
     common/libolacommon.la \
     libs/acn/libolae131core.la \
@@ -69,6 +73,7 @@ noinst_PROGRAMS += \
     tools/e133/basic_controller \
     tools/e133/basic_device \
     tools/e133/e133_controller \
+    tools/e133/e133_loadtest \
     tools/e133/e133_monitor \
     tools/e133/e133_receiver
 
@@ -88,6 +93,13 @@ tools_e133_e133_monitor_LDADD = common/libolacommon.la \
                                 tools/e133/libolae133common.la \
                                 tools/e133/libolae133controller.la
 
+tools_e133_e133_loadtest_SOURCES = tools/e133/e133-loadtest.cpp
+tools_e133_e133_loadtest_LDADD = common/libolacommon.la \
+                                 libs/acn/libolae131core.la \
+                                 tools/e133/libolae133common.la \
+                                 tools/e133/libolae133controller.la \
+                                 tools/e133/libolae133device.la
+
 tools_e133_e133_controller_SOURCES = tools/e133/e133-controller.cpp
 # required for PID_DATA_FILE
 tools_e133_e133_controller_LDADD = common/libolacommon.la \
@@ -24,8 +24,9 @@
 #include "ola/acn/CID.h"
 #include "ola/e133/MessageBuilder.h"
 #include "ola/io/IOStack.h"
+#include "ola/rdm/RDMCommandSerializer.h"
 
-#include "libs/acn/E133PDU.h"
+#include "libs/acn/E133HeaderTemplate.h"
 #include "libs/acn/RDMPDU.h"
 #include "libs/acn/RootPDU.h"
 #include "libs/acn/E133StatusPDU.h"
@@ -36,20 +37,23 @@ namespace e133 {
 
 using ola::acn::CID;
 using ola::io::IOStack;
-using ola::acn::E133PDU;
+using ola::acn::E133HeaderTemplate;
 using ola::acn::PreamblePacker;
 using ola::acn::RootPDU;
 
 
 MessageBuilder::MessageBuilder(const CID &cid, const string &source_name)
     : m_cid(cid),
-      m_source_name(source_name),
       // The Max sized RDM packet is 256 bytes, E1.33 adds 118 bytes of
       // headers.
-      m_memory_pool(400) {
+      m_memory_pool(400),
+      m_header_template(new E133HeaderTemplate(cid, source_name)) {
 }
 
 
+MessageBuilder::~MessageBuilder() {}
+
+
 /**
  * Append a RDM PDU Header onto this packet
  */
@@ -107,10 +111,8 @@ void MessageBuilder::BuildTCPRootE133(IOStack *packet,
                                       uint32_t vector,
                                       uint32_t sequence_number,
                                       uint16_t endpoint_id) {
-  E133PDU::PrependPDU(packet, vector, m_source_name, sequence_number,
-                      endpoint_id);
-  RootPDU::PrependPDU(packet, ola::acn::VECTOR_ROOT_E133, m_cid);
-  PreamblePacker::AddTCPPreamble(packet);
+  m_header_template->Prepend(packet, E133HeaderTemplate::TCP_PREAMBLE, vector,
+                             sequence_number, endpoint_id);
 }
 
 
@@ -121,10 +123,34 @@ void MessageBuilder::BuildUDPRootE133(IOStack *packet,
                                       uint32_t vector,
                                       uint32_t sequence_number,
                                       uint16_t endpoint_id) {
-  E133PDU::PrependPDU(packet, vector, m_source_name, sequence_number,
-                      endpoint_id);
-  RootPDU::PrependPDU(packet, ola::acn::VECTOR_ROOT_E133, m_cid);
-  PreamblePacker::AddUDPPreamble(packet);
+  m_header_template->Prepend(packet, E133HeaderTemplate::UDP_PREAMBLE, vector,
+                             sequence_number, endpoint_id);
+}
+
+
+/**
+ * Build a TCP E1.33 packet containing a RDM command.
+ */
+void MessageBuilder::BuildTCPRDMCommand(IOStack *packet,
+                                        const ola::rdm::RDMCommand &command,
+                                        uint32_t sequence_number,
+                                        uint16_t endpoint_id) {
+  ola::rdm::RDMCommandSerializer::Write(command, packet);
+  m_header_template->PrependRDM(packet, E133HeaderTemplate::TCP_PREAMBLE,
+                                sequence_number, endpoint_id);
+}
+
+
+/**
+ * Build a UDP E1.33 packet containing a RDM command.
+ */
+void MessageBuilder::BuildUDPRDMCommand(IOStack *packet,
+                                        const ola::rdm::RDMCommand &command,
+                                        uint32_t sequence_number,
+                                        uint16_t endpoint_id) {
+  ola::rdm::RDMCommandSerializer::Write(command, packet);
+  m_header_template->PrependRDM(packet, E133HeaderTemplate::UDP_PREAMBLE,
+                                sequence_number, endpoint_id);
 }
 }  // namespace e133
 }  // namespace ola
@@ -0,0 +1,288 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShardedDeviceManager.cpp
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/acn/CID.h>
+#include <ola/e133/MessageBuilder.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/NetworkUtils.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/CallbackThread.h>
+#include <ola/thread/Future.h>
+#include <ola/thread/Mutex.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tools/e133/DeviceManagerImpl.h"
+#include "tools/e133/ShardedDeviceManager.h"
+
+namespace ola {
+namespace e133 {
+
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::io::SelectServer;
+using ola::thread::CallbackThread;
+using ola::thread::Future;
+using ola::thread::MutexLocker;
+using std::auto_ptr;
+
+/**
+ * A shard runs a DeviceManagerImpl in its own thread. Apart from Start() and
+ * Stop(), all the methods are called in the shard's thread.
+ */
+class ShardedDeviceManager::Shard {
+ public:
+    Shard(const ola::acn::CID &cid, const string &source_name,
+          unsigned int index)
+        : m_message_builder(cid, source_name),
+          m_manager(&m_ss, &m_message_builder),
+          m_thread(NewSingleCallback(&m_ss, &SelectServer::Run),
+                   ola::thread::Thread::Options(ThreadName(index))) {
+    }
+
+    DeviceManagerImpl *Manager() { return &m_manager; }
+
+    bool Start() { return m_thread.Start(); }
+
+    void Stop() {
+      if (m_thread.IsRunning()) {
+        // Terminate() is a no-op if Run() hasn't started yet, so run it from
+        // the thread.
+        m_ss.Execute(NewSingleCallback(&m_ss, &SelectServer::Terminate));
+        m_thread.Join();
+      }
+    }
+
+    void Execute(ola::BaseCallback0<void> *callback) {
+      m_ss.Execute(callback);
+    }
+
+    void AddDevice(IPV4Address ip_address) {
+      m_manager.AddDevice(ip_address);
+    }
+
+    void RemoveDevice(IPV4Address ip_address) {
+      m_manager.RemoveDevice(ip_address);
+    }
+
+    void RemoveDeviceIfNotConnected(IPV4Address ip_address) {
+      m_manager.RemoveDeviceIfNotConnected(ip_address);
+    }
+
+    void GetStats(ShardStats *stats, Future<void> future) {
+      const BatchedHealthChecker &checker = m_manager.HealthChecker();
+      stats->connections = checker.ConnectionCount();
+      stats->heartbeats_sent = checker.HeartbeatsSent();
+      stats->timeouts = checker.Timeouts();
+      future.Set();
+    }
+
+ private:
+    SelectServer m_ss;
+    MessageBuilder m_message_builder;
+    DeviceManagerImpl m_manager;
+    CallbackThread m_thread;
+
+    static string ThreadName(unsigned int index) {
+      std::ostringstream str;
+      str << "e133-shard-" << index;
+      return str.str();
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(Shard);
+};
+
+
+ShardedDeviceManager::ShardedDeviceManager(ola::io::SelectServerInterface *ss,
+                                           const ola::acn::CID &cid,
+                                           const Options &options)
+    : m_ss(ss),
+      m_running(false) {
+  const unsigned int shards = std::max(1u, options.shards);
+  for (unsigned int i = 0; i < shards; i++) {
+    Shard *shard = new Shard(cid, options.source_name, i);
+    DeviceManagerImpl *manager = shard->Manager();
+    manager->SetRDMMessageCallback(
+        NewCallback(this, &ShardedDeviceManager::RDMMessage));
+    manager->SetAcquireDeviceCallback(
+        NewCallback(this, &ShardedDeviceManager::DeviceAcquired));
+    manager->SetReleaseDeviceCallback(
+        NewCallback(this, &ShardedDeviceManager::DeviceReleased));
+    m_shards.push_back(shard);
+  }
+}
+
+
+ShardedDeviceManager::~ShardedDeviceManager() {
+  Stop();
+  // Run any acquire / release callbacks the shards queued.
+  m_ss->DrainCallbacks();
+  ola::STLDeleteElements(&m_shards);
+}
+
+
+void ShardedDeviceManager::SetRDMMessageCallback(
+    RDMMesssageCallback *callback) {
+  m_rdm_callback.reset(callback);
+}
+
+
+void ShardedDeviceManager::SetAcquireDeviceCallback(
+    AcquireDeviceCallback *callback) {
+  m_acquire_device_cb.reset(callback);
+}
+
+
+void ShardedDeviceManager::SetReleaseDeviceCallback(
+    ReleaseDeviceCallback *callback) {
+  m_release_device_cb.reset(callback);
+}
+
+
+bool ShardedDeviceManager::Start() {
+  if (m_running) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    if (!m_shards[i]->Start()) {
+      OLA_WARN << "Failed to start shard " << i;
+      Stop();
+      return false;
+    }
+  }
+  m_running = true;
+  return true;
+}
+
+
+void ShardedDeviceManager::Stop() {
+  vector<Shard*>::iterator iter = m_shards.begin();
+  for (; iter != m_shards.end(); ++iter) {
+    (*iter)->Stop();
+  }
+  m_running = false;
+}
+
+
+void ShardedDeviceManager::AddDevice(const IPV4Address &ip_address) {
+  Shard *shard = m_shards[ShardForDevice(ip_address)];
+  shard->Execute(NewSingleCallback(shard, &Shard::AddDevice, ip_address));
+}
+
+
+void ShardedDeviceManager::RemoveDevice(const IPV4Address &ip_address) {
+  Shard *shard = m_shards[ShardForDevice(ip_address)];
+  shard->Execute(NewSingleCallback(shard, &Shard::RemoveDevice, ip_address));
+}
+
+
+void ShardedDeviceManager::RemoveDeviceIfNotConnected(
+    const IPV4Address &ip_address) {
+  Shard *shard = m_shards[ShardForDevice(ip_address)];
+  shard->Execute(NewSingleCallback(shard, &Shard::RemoveDeviceIfNotConnected,
+                                   ip_address));
+}
+
+
+void ShardedDeviceManager::ListManagedDevices(
+    vector<IPV4Address> *devices) const {
+  MutexLocker lock(&m_mutex);
+  devices->insert(devices->end(), m_managed_devices.begin(),
+                  m_managed_devices.end());
+}
+
+
+/**
+ * Devices on the same subnet usually only differ in the low bits, so use
+ * those to spread them across the shards.
+ */
+unsigned int ShardedDeviceManager::ShardForDevice(
+    const IPV4Address &ip_address) const {
+  return ola::network::NetworkToHost(ip_address.AsInt()) % m_shards.size();
+}
+
+
+void ShardedDeviceManager::GetStats(vector<ShardStats> *stats) const {
+  stats->assign(m_shards.size(), ShardStats());
+  if (!m_running) {
+    return;
+  }
+
+  vector<Future<void> > futures(m_shards.size());
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    m_shards[i]->Execute(NewSingleCallback(m_shards[i], &Shard::GetStats,
+                                           &(*stats)[i], futures[i]));
+  }
+  for (unsigned int i = 0; i < futures.size(); i++) {
+    futures[i].Get();
+  }
+}
+
+
+bool ShardedDeviceManager::RDMMessage(const IPV4Address &ip_address,
+                                      uint16_t endpoint,
+                                      const string &data) {
+  return m_rdm_callback.get() &&
+      m_rdm_callback->Run(ip_address, endpoint, data);
+}
+
+
+void ShardedDeviceManager::DeviceAcquired(const IPV4Address &ip_address) {
+  {
+    MutexLocker lock(&m_mutex);
+    m_managed_devices.insert(ip_address);
+  }
+  m_ss->Execute(NewSingleCallback(
+      this, &ShardedDeviceManager::RunAcquireCallback, ip_address));
+}
+
+
+void ShardedDeviceManager::DeviceReleased(const IPV4Address &ip_address) {
+  {
+    MutexLocker lock(&m_mutex);
+    m_managed_devices.erase(ip_address);
+  }
+  m_ss->Execute(NewSingleCallback(
+      this, &ShardedDeviceManager::RunReleaseCallback, ip_address));
+}
+
+
+void ShardedDeviceManager::RunAcquireCallback(IPV4Address ip_address) {
+  if (m_acquire_device_cb.get()) {
+    m_acquire_device_cb->Run(ip_address);
+  }
+}
+
+
+void ShardedDeviceManager::RunReleaseCallback(IPV4Address ip_address) {
+  if (m_release_device_cb.get()) {
+    m_release_device_cb->Run(ip_address);
+  }
+}
+}  // namespace e133
+}  // namespace ola
@@ -0,0 +1,160 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShardedDeviceManager.h
+ * Copyright (C) 2026 Simon Newton
+ * Spreads the connections to E1.33 devices across several threads.
+ */
+
+#ifndef TOOLS_E133_SHARDEDDEVICEMANAGER_H_
+#define TOOLS_E133_SHARDEDDEVICEMANAGER_H_
+
+#include <ola/Callback.h>
+#include <ola/acn/CID.h>
+#include <ola/base/Macro.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/thread/Mutex.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace e133 {
+
+using ola::network::IPV4Address;
+using std::string;
+using std::vector;
+
+/**
+ * A DeviceManager which splits the devices across a number of shards. Each
+ * shard has its own thread, SelectServer and DeviceManagerImpl, so the TCP
+ * connections (and their health checks) are handled in parallel. Devices are
+ * assigned to shards by IP address.
+ *
+ * All methods must be called from the thread running the SelectServer passed
+ * to the constructor. The acquire & release callbacks run in that thread, but
+ * since the RDMMesssageCallback has to return a value it's run in the shard's
+ * thread, and must be thread safe.
+ */
+class ShardedDeviceManager {
+ public:
+    typedef ola::Callback3<bool, const IPV4Address&, uint16_t,
+                           const string&> RDMMesssageCallback;
+    typedef ola::Callback1<void, const IPV4Address&> AcquireDeviceCallback;
+    typedef ola::Callback1<void, const IPV4Address&> ReleaseDeviceCallback;
+
+    struct Options {
+     public:
+      Options()
+          : shards(4),
+            source_name("OLA Controller") {
+      }
+
+      /**
+       * @brief The number of shards, 0 is treated as 1.
+       */
+      unsigned int shards;
+
+      /**
+       * @brief The source name to use in the E1.33 messages.
+       */
+      string source_name;
+    };
+
+    /**
+     * @brief Statistics for a shard.
+     */
+    struct ShardStats {
+     public:
+      ShardStats() : connections(0), heartbeats_sent(0), timeouts(0) {}
+
+      unsigned int connections;
+      unsigned int heartbeats_sent;
+      unsigned int timeouts;
+    };
+
+    ShardedDeviceManager(ola::io::SelectServerInterface *ss,
+                         const ola::acn::CID &cid,
+                         const Options &options = Options());
+
+    /**
+     * @brief Destructor, this calls Stop().
+     */
+    ~ShardedDeviceManager();
+
+    // Ownership of the callbacks is transferred. These should be set before
+    // Start() is called.
+    void SetRDMMessageCallback(RDMMesssageCallback *callback);
+    void SetAcquireDeviceCallback(AcquireDeviceCallback *callback);
+    void SetReleaseDeviceCallback(ReleaseDeviceCallback *callback);
+
+    /**
+     * @brief Start the shard threads.
+     * @returns true if all the threads started, false otherwise.
+     */
+    bool Start();
+
+    /**
+     * @brief Stop the shard threads. This closes the connections.
+     */
+    void Stop();
+
+    void AddDevice(const IPV4Address &ip_address);
+    void RemoveDevice(const IPV4Address &ip_address);
+    void RemoveDeviceIfNotConnected(const IPV4Address &ip_address);
+    void ListManagedDevices(vector<IPV4Address> *devices) const;
+
+    unsigned int ShardCount() const { return m_shards.size(); }
+    unsigned int ShardForDevice(const IPV4Address &ip_address) const;
+
+    /**
+     * @brief Fetch the statistics for each shard.
+     *
+     * This blocks until each shard has responded.
+     */
+    void GetStats(vector<ShardStats> *stats) const;
+
+ private:
+    class Shard;
+
+    ola::io::SelectServerInterface *m_ss;
+    vector<Shard*> m_shards;
+    bool m_running;
+
+    std::auto_ptr<RDMMesssageCallback> m_rdm_callback;
+    std::auto_ptr<AcquireDeviceCallback> m_acquire_device_cb;
+    std::auto_ptr<ReleaseDeviceCallback> m_release_device_cb;
+
+    mutable ola::thread::Mutex m_mutex;
+    std::set<IPV4Address> m_managed_devices;  // GUARDED_BY(m_mutex)
+
+    // Called in the shard threads.
+    bool RDMMessage(const IPV4Address &ip_address, uint16_t endpoint,
+                    const string &data);
+    void DeviceAcquired(const IPV4Address &ip_address);
+    void DeviceReleased(const IPV4Address &ip_address);
+
+    // Called in m_ss.
+    void RunAcquireCallback(IPV4Address ip_address);
+    void RunReleaseCallback(IPV4Address ip_address);
+
+    DISALLOW_COPY_AND_ASSIGN(ShardedDeviceManager);
+};
+}  // namespace e133
+}  // namespace ola
+#endif  // TOOLS_E133_SHARDEDDEVICEMANAGER_H_
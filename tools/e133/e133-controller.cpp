@@ -42,7 +42,6 @@
 #include <ola/rdm/CommandPrinter.h>
 #include <ola/rdm/PidStoreHelper.h>
 #include <ola/rdm/RDMCommand.h>
-#include <ola/rdm/RDMCommandSerializer.h>
 #include <ola/rdm/RDMEnums.h>
 #include <ola/rdm/UID.h>
 #include <ola/stl/STLUtils.h>
@@ -54,7 +53,6 @@
 #include <string>
 #include <vector>
 
-#include "libs/acn/RDMPDU.h"
 
 DEFINE_s_uint16(endpoint, e, 0, "The endpoint to use");
 DEFINE_s_string(target, t, "", "List of IPs to connect to");
@@ -71,9 +69,7 @@ using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
 using ola::network::UDPSocket;
 using ola::acn::E133_PORT;
-using ola::acn::RDMPDU;
 using ola::rdm::PidStoreHelper;
-using ola::rdm::RDMCommandSerializer;
 using ola::rdm::RDMRequest;
 using ola::rdm::RDMResponse;
 using ola::rdm::UID;
@@ -296,10 +292,7 @@ bool SimpleE133Controller::SendRequest(const UID &uid,
 
   // Build the E1.33 packet.
   IOStack packet(m_message_builder.pool());
-  RDMCommandSerializer::Write(*request, &packet);
-  RDMPDU::PrependPDU(&packet);
-  m_message_builder.BuildUDPRootE133(
-      &packet, ola::acn::VECTOR_FRAMING_RDMNET, 0, endpoint);
+  m_message_builder.BuildUDPRDMCommand(&packet, *request, 0, endpoint);
 
   // Send the packet
   m_udp_socket.SendTo(&packet, target);
@@ -0,0 +1,321 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * e133-loadtest.cpp
+ * Copyright (C) 2026 Simon Newton
+ *
+ * This simulates a number of E1.33 devices on the loopback interface, and
+ * runs a ShardedDeviceManager against them. It reports how long it takes to
+ * become the designated controller for all the devices, and the health check
+ * statistics once the test finishes.
+ *
+ * Each device listens on its own address, starting at --first-address. On
+ * Linux every address in 127.0.0.0/8 is local so this works without any
+ * setup; other platforms need the addresses added to the loopback interface.
+ */
+
+#include <sys/resource.h>
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/acn/CID.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/e133/MessageBuilder.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/NetworkUtils.h>
+#include <ola/rdm/RDMCommand.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/CallbackThread.h>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tools/e133/DesignatedControllerConnection.h"
+#include "tools/e133/ShardedDeviceManager.h"
+#include "tools/e133/TCPConnectionStats.h"
+
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::acn::CID;
+using ola::e133::MessageBuilder;
+using ola::e133::ShardedDeviceManager;
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(devices, d, 100, "The number of devices to simulate.");
+DEFINE_s_uint32(shards, s, 4,
+                "The number of controller threads to spread the devices "
+                "across.");
+DEFINE_uint32(device_threads, 2,
+              "The number of threads to run the simulated devices in.");
+DEFINE_uint32(duration, 30, "How long to run the test for, in seconds.");
+DEFINE_string(first_address, "127.1.0.1",
+              "The address of the first device, the rest follow on from "
+              "this.");
+
+/**
+ * Runs a set of simulated devices in their own thread.
+ */
+class DeviceThread {
+ public:
+    explicit DeviceThread(unsigned int index)
+        : m_message_builder(CID::Generate(), "OLA Load Test Device"),
+          m_thread(NewSingleCallback(&m_ss, &SelectServer::Run),
+                   ola::thread::Thread::Options(ThreadName(index))) {
+    }
+
+    ~DeviceThread() {
+      Stop();
+      ola::STLDeleteElements(&m_devices);
+      ola::STLDeleteElements(&m_stats);
+    }
+
+    /*
+     * Add a device, this must be called before Start().
+     */
+    bool AddDevice(const IPV4Address &ip_address) {
+      TCPConnectionStats *stats = new TCPConnectionStats();
+      DesignatedControllerConnection *device =
+          new DesignatedControllerConnection(&m_ss, ip_address,
+                                             &m_message_builder, stats);
+      m_stats.push_back(stats);
+      m_devices.push_back(device);
+      return device->Init();
+    }
+
+    bool Start() { return m_thread.Start(); }
+
+    void Stop() {
+      if (m_thread.IsRunning()) {
+        m_ss.Execute(NewSingleCallback(&m_ss, &SelectServer::Terminate));
+        m_thread.Join();
+      }
+    }
+
+    /*
+     * Only call this once the thread has stopped.
+     */
+    void AddStats(unsigned int *connections, unsigned int *unhealthy) const {
+      vector<TCPConnectionStats*>::const_iterator iter = m_stats.begin();
+      for (; iter != m_stats.end(); ++iter) {
+        *connections += (*iter)->connection_events;
+        *unhealthy += (*iter)->unhealthy_events;
+      }
+    }
+
+ private:
+    SelectServer m_ss;
+    MessageBuilder m_message_builder;
+    vector<DesignatedControllerConnection*> m_devices;
+    vector<TCPConnectionStats*> m_stats;
+    ola::thread::CallbackThread m_thread;
+
+    static string ThreadName(unsigned int index) {
+      std::ostringstream str;
+      str << "e133-device-" << index;
+      return str.str();
+    }
+};
+
+
+/**
+ * The controller side of the test.
+ */
+class LoadTest {
+ public:
+    LoadTest(unsigned int device_count, unsigned int shards)
+        : m_device_count(device_count),
+          m_acquired(0),
+          m_released(0),
+          m_manager(&m_ss, CID::Generate(), ManagerOptions(shards)) {
+      m_manager.SetAcquireDeviceCallback(
+          NewCallback(this, &LoadTest::DeviceAcquired));
+      m_manager.SetReleaseDeviceCallback(
+          NewCallback(this, &LoadTest::DeviceReleased));
+    }
+
+    bool Run(const vector<IPV4Address> &devices, unsigned int duration) {
+      if (!m_manager.Start()) {
+        return false;
+      }
+      m_clock.CurrentTime(&m_start);
+      vector<IPV4Address>::const_iterator iter = devices.begin();
+      for (; iter != devices.end(); ++iter) {
+        m_manager.AddDevice(*iter);
+      }
+
+      m_ss.RegisterRepeatingTimeout(
+          1000, NewCallback(this, &LoadTest::PrintProgress));
+      m_ss.RegisterSingleTimeout(
+          duration * 1000,
+          NewSingleCallback(&m_ss, &SelectServer::Terminate));
+      m_ss.Run();
+      PrintResults();
+      m_manager.Stop();
+      return true;
+    }
+
+ private:
+    const unsigned int m_device_count;
+    unsigned int m_acquired;
+    unsigned int m_released;
+    ola::MonotonicClock m_clock;
+    TimeStamp m_start;
+    TimeInterval m_all_acquired;
+    SelectServer m_ss;
+    ShardedDeviceManager m_manager;
+
+    void DeviceAcquired(const IPV4Address&) {
+      m_acquired++;
+      if (m_acquired == m_device_count && m_all_acquired.AsInt() == 0) {
+        TimeStamp now;
+        m_clock.CurrentTime(&now);
+        m_all_acquired = now - m_start;
+      }
+    }
+
+    void DeviceReleased(const IPV4Address&) {
+      m_released++;
+    }
+
+    bool PrintProgress() {
+      vector<IPV4Address> managed;
+      m_manager.ListManagedDevices(&managed);
+      cout << "Managing " << managed.size() << " / " << m_device_count
+           << " devices, " << m_released << " released" << endl;
+      return true;
+    }
+
+    void PrintResults() {
+      vector<ShardedDeviceManager::ShardStats> stats;
+      m_manager.GetStats(&stats);
+      ShardedDeviceManager::ShardStats total;
+      for (unsigned int i = 0; i < stats.size(); i++) {
+        cout << "Shard " << i << ": " << stats[i].connections
+             << " connections, " << stats[i].heartbeats_sent
+             << " heartbeats sent, " << stats[i].timeouts << " timeouts"
+             << endl;
+        total.connections += stats[i].connections;
+        total.heartbeats_sent += stats[i].heartbeats_sent;
+        total.timeouts += stats[i].timeouts;
+      }
+
+      cout << "Acquired " << m_acquired << " devices";
+      if (m_all_acquired.AsInt()) {
+        cout << ", all " << m_device_count << " in " << m_all_acquired << "s";
+      }
+      cout << endl;
+      cout << "Released " << m_released << " devices, "
+           << total.connections << " connections remain, "
+           << total.heartbeats_sent << " heartbeats sent, "
+           << total.timeouts << " timeouts" << endl;
+    }
+
+    static ShardedDeviceManager::Options ManagerOptions(unsigned int shards) {
+      ShardedDeviceManager::Options options;
+      options.shards = shards;
+      options.source_name = "OLA Load Test Controller";
+      return options;
+    }
+};
+
+
+/*
+ * Each device uses a listening socket & a connected socket, and the
+ * controller uses one more.
+ */
+void CheckFileLimit(unsigned int devices) {
+  const rlim_t required = 3 * devices + 64;
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit)) {
+    return;
+  }
+  if (limit.rlim_cur < required && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = std::min(required, limit.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  if (limit.rlim_cur < required) {
+    cerr << "The file descriptor limit of " << limit.rlim_cur
+         << " is too low for " << devices << " devices, try ulimit -n "
+         << required << endl;
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]", "Run the E1.33 controller load test.");
+
+  IPV4Address first_address;
+  if (!IPV4Address::FromString(FLAGS_first_address.str(), &first_address)) {
+    ola::DisplayUsageAndExit();
+  }
+  if (FLAGS_devices == 0 || FLAGS_device_threads == 0) {
+    ola::DisplayUsageAndExit();
+  }
+  CheckFileLimit(FLAGS_devices);
+
+  vector<DeviceThread*> device_threads;
+  for (unsigned int i = 0; i < FLAGS_device_threads; i++) {
+    device_threads.push_back(new DeviceThread(i));
+  }
+
+  vector<IPV4Address> devices;
+  const uint32_t first = ola::network::NetworkToHost(first_address.AsInt());
+  for (unsigned int i = 0; i < FLAGS_devices; i++) {
+    IPV4Address address(ola::network::HostToNetwork(first + i));
+    if (!device_threads[i % device_threads.size()]->AddDevice(address)) {
+      cerr << "Failed to listen on " << address << endl;
+      ola::STLDeleteElements(&device_threads);
+      return ola::EXIT_UNAVAILABLE;
+    }
+    devices.push_back(address);
+  }
+
+  for (unsigned int i = 0; i < device_threads.size(); i++) {
+    device_threads[i]->Start();
+  }
+
+  int ret = ola::EXIT_OK;
+  {
+    LoadTest load_test(FLAGS_devices, FLAGS_shards);
+    if (!load_test.Run(devices, FLAGS_duration)) {
+      ret = ola::EXIT_SOFTWARE;
+    }
+  }
+
+  unsigned int connections = 0, unhealthy = 0;
+  for (unsigned int i = 0; i < device_threads.size(); i++) {
+    device_threads[i]->Stop();
+    device_threads[i]->AddStats(&connections, &unhealthy);
+  }
+  cout << "Devices saw " << connections << " connections and " << unhealthy
+       << " unhealthy events" << endl;
+  ola::STLDeleteElements(&device_threads);
+  return ret;
+}
@@ -151,9 +151,11 @@ int main(int argc, char *argv[]) {
   // Setup E1.31 if required.
   auto_ptr<ola::acn::E131Node> e131_node;
   if (FLAGS_e131) {
+    ola::acn::E131Node::Options e131_options;
+    e131_options.select_server = node.SelectServer();
     e131_node.reset(new ola::acn::E131Node(
                     node.SelectServer(), FLAGS_listen_ip,
-                    ola::acn::E131Node::Options(), cid));
+                    e131_options, cid));
     if (!e131_node->Start()) {
       OLA_WARN << "Failed to start E1.31 node";
       exit(ola::EXIT_UNAVAILABLE);
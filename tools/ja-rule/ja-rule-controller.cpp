@@ -18,7 +18,10 @@
  * Copyright (C) 2015 Simon Newton
  */
 
+#include <string.h>
+
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/Logging.h>
 #include <ola/base/Array.h>
@@ -26,6 +29,7 @@
 #include <ola/base/Flags.h>
 #include <ola/base/SysExits.h>
 #include <ola/rdm/RDMCommand.h>
+#include <ola/io/ByteString.h>
 #include <ola/io/SelectServer.h>
 #include <ola/io/StdinHandler.h>
 #include <ola/rdm/UID.h>
@@ -36,19 +40,25 @@
 #include <memory>
 #include <string>
 
+#include "libs/usb/JaRuleConstants.h"
 #include "libs/usb/JaRuleWidget.h"
 #include "libs/usb/JaRulePortHandle.h"
 #include "tools/ja-rule/USBDeviceManager.h"
 
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::ByteString;
 using ola::io::SelectServer;
 using ola::io::StdinHandler;
 using ola::rdm::RDMSetRequest;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
+using ola::usb::JaRuleReturnCode;
 using ola::usb::JaRuleWidget;
 using ola::usb::JaRulePortHandle;
+using ola::usb::USBCommandResult;
 using std::auto_ptr;
 using std::cerr;
 using std::cout;
@@ -68,7 +78,10 @@ class Controller {
         m_stdin_handler(
             new StdinHandler(ss, ola::NewCallback(this, &Controller::Input))),
         m_mode(NORMAL),
-        m_selected_uid(0, 0) {
+        m_selected_uid(0, 0),
+        m_benchmark_sent(0),
+        m_benchmark_completed(0),
+        m_benchmark_failed(0) {
   }
 
   ~Controller() {
@@ -113,6 +126,9 @@ class Controller {
     }
 
     switch (c) {
+      case 'b':
+        RunBenchmark();
+        break;
       case 'i':
         SetIdentify(true);
         break;
@@ -149,6 +165,7 @@ class Controller {
 
   void PrintCommands() {
     cout << "Commands:" << endl;
+    cout << " b - Benchmark the command rate" << endl;
     cout << " i - Identify On" << endl;
     cout << " I - Identify Off" << endl;
     cout << " d - Run Full Discovery" << endl;
@@ -173,6 +190,12 @@ class Controller {
   Mode m_mode;
   UID m_selected_uid;
 
+  ola::Clock m_clock;
+  TimeStamp m_benchmark_start;
+  unsigned int m_benchmark_sent;
+  unsigned int m_benchmark_completed;
+  unsigned int m_benchmark_failed;
+
   void SetIdentify(bool identify_on) {
     if (!m_widget) {
       return;
@@ -223,6 +246,72 @@ class Controller {
     cout << "-------------------------" << endl;
   }
 
+  /*
+   * Send BENCHMARK_COMMANDS echo commands, keeping BENCHMARK_WINDOW of them
+   * outstanding, and report the sustained command rate.
+   */
+  void RunBenchmark() {
+    if (!m_widget) {
+      return;
+    }
+    if (m_benchmark_sent != m_benchmark_completed) {
+      cout << "Benchmark already running" << endl;
+      return;
+    }
+
+    m_benchmark_sent = 0;
+    m_benchmark_completed = 0;
+    m_benchmark_failed = 0;
+    m_clock.CurrentTime(&m_benchmark_start);
+    while (m_benchmark_sent < BENCHMARK_WINDOW) {
+      SendEcho();
+    }
+  }
+
+  void SendEcho() {
+    uint8_t payload[BENCHMARK_PAYLOAD_SIZE];
+    memset(payload, m_benchmark_sent & 0xff, sizeof(payload));
+    m_benchmark_sent++;
+    m_widget->SendCommand(
+        0, ola::usb::JARULE_CMD_ECHO, payload, sizeof(payload),
+        NewSingleCallback(this, &Controller::EchoComplete));
+  }
+
+  void EchoComplete(USBCommandResult result, JaRuleReturnCode,
+                    uint8_t, const ByteString &) {
+    m_benchmark_completed++;
+    if (result != ola::usb::COMMAND_RESULT_OK) {
+      m_benchmark_failed++;
+    }
+
+    if (m_benchmark_sent < BENCHMARK_COMMANDS) {
+      if (m_widget) {
+        SendEcho();
+      }
+      return;
+    }
+
+    if (m_benchmark_completed != m_benchmark_sent) {
+      return;
+    }
+
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    const TimeInterval duration = now - m_benchmark_start;
+    cout << m_benchmark_completed << " commands in " << duration << "s, "
+         << m_benchmark_failed << " failed";
+    if (duration.InMilliSeconds()) {
+      cout << ", " << (m_benchmark_completed * 1000 /
+                       duration.InMilliSeconds())
+           << " commands/s";
+    }
+    cout << endl;
+  }
+
+  static const unsigned int BENCHMARK_COMMANDS = 1000;
+  static const unsigned int BENCHMARK_PAYLOAD_SIZE = 32;
+  static const unsigned int BENCHMARK_WINDOW = 8;
+
   DISALLOW_COPY_AND_ASSIGN(Controller);
 };
 
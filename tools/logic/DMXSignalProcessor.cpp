@@ -39,9 +39,17 @@
  *  36.72 (9 * 4.08) useconds passes and there was no rising edge it's a break.
  *
  * The implementation is based on a state machine, with a couple of tweaks.
+ *
+ * At 4MHz each bit is 16 samples, and the marks can be hundreds of thousands
+ * of samples, so rather than stepping the state machine for every sample we
+ * find runs of identical samples a word at a time and only step it at the
+ * edges, and when a state would time out partway through a run.
  */
 
 #include <ola/Logging.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 
 #include "tools/logic/DMXSignalProcessor.h"
@@ -56,6 +64,48 @@ const double DMXSignalProcessor::MAX_BIT_TIME = 4.08;
 const double DMXSignalProcessor::MIN_LAST_BIT_TIME = 2.64;
 const double DMXSignalProcessor::MAX_MARK_BETWEEN_SLOTS = 1000000.0;
 
+namespace {
+
+// 0x0101010101010101 and 0x8080808080808080
+const uint64_t LOW_BITS = ~static_cast<uint64_t>(0) / 0xff;
+const uint64_t HIGH_BITS = LOW_BITS * 0x80;
+
+/*
+ * Returns true if any of the bytes in word are 0.
+ */
+inline bool HasZeroByte(uint64_t word) {
+  return (word - LOW_BITS) & ~word & HIGH_BITS;
+}
+
+/*
+ * Find the end of a run of samples that are all high, or all low.
+ * @param ptr the samples
+ * @param start the index to start looking from
+ * @param size the number of samples
+ * @param mask the mask passed to Process()
+ * @param bit the value of the samples in the run
+ * @returns the index of the first sample that's not part of the run, or size.
+ */
+unsigned int FindRunEnd(const uint8_t *ptr, unsigned int start,
+                        unsigned int size, uint8_t mask, bool bit) {
+  const uint64_t word_mask = LOW_BITS * mask;
+  unsigned int i = start;
+  while (i + sizeof(uint64_t) <= size) {
+    uint64_t word;
+    memcpy(&word, ptr + i, sizeof(word));
+    word &= word_mask;
+    if (bit ? HasZeroByte(word) : word != 0) {
+      break;
+    }
+    i += sizeof(word);
+  }
+  while (i < size && static_cast<bool>(ptr[i] & mask) == bit) {
+    i++;
+  }
+  return i;
+}
+}  // namespace
+
 /**
  * Create a new DMXSignalProcessor which runs the specified callback when a new
  * frame is received.
@@ -65,6 +115,10 @@ DMXSignalProcessor::DMXSignalProcessor(DataCallback *callback,
     : m_callback(callback),
       m_sample_rate(sample_rate),
       m_microseconds_per_tick(1000000.0 / sample_rate),
+      m_max_mab_ticks(MicroSecondsAsTicks(MAX_MAB_TIME)),
+      m_max_bit_ticks(MicroSecondsAsTicks(MAX_BIT_TIME)),
+      m_stop_bits_ticks(MicroSecondsAsTicks(2 * MIN_BIT_TIME)),
+      m_max_mark_ticks(MicroSecondsAsTicks(MAX_MARK_BETWEEN_SLOTS)),
       m_state(IDLE),
       m_ticks(0),
       m_may_be_in_break(false),
@@ -85,9 +139,94 @@ DMXSignalProcessor::DMXSignalProcessor(DataCallback *callback,
  */
 void DMXSignalProcessor::Process(uint8_t *ptr, unsigned int size,
                                  uint8_t mask) {
-  for (unsigned int i = 0 ; i < size; i++) {
-    ProcessSample(ptr[i] & mask);
+  unsigned int i = 0;
+  while (i < size) {
+    const bool bit = ptr[i] & mask;
+    const unsigned int end = FindRunEnd(ptr, i + 1, size, mask, bit);
+    ProcessRun(bit, end - i);
+    i = end;
+  }
+}
+
+/**
+ * Process a run of samples with the same value. This has the same result as
+ * calling ProcessSample() count times.
+ */
+void DMXSignalProcessor::ProcessRun(bool bit, unsigned int count) {
+  while (count) {
+    const State state = m_state;
+    ProcessSample(bit);
+    count--;
+    if (count && m_state == state) {
+      count -= SkipSamples(bit, count);
+    }
+  }
+}
+
+/**
+ * Skip over samples which wouldn't change the state. This must only be called
+ * after ProcessSample(bit) has left the state unchanged.
+ * @returns the number of samples skipped, which may be 0.
+ */
+unsigned int DMXSignalProcessor::SkipSamples(bool bit, unsigned int count) {
+  unsigned int skip = 0;
+  switch (m_state) {
+    case UNDEFINED:
+      // Low samples don't count towards anything.
+      skip = count;
+      break;
+    case IDLE:
+    case BREAK:
+      skip = count;
+      m_ticks += skip;
+      break;
+    case MAB:
+      skip = SamplesBefore(m_max_mab_ticks, count);
+      m_ticks += skip;
+      break;
+    case START_BIT:
+    case BIT_1:
+    case BIT_2:
+    case BIT_3:
+    case BIT_4:
+    case BIT_5:
+    case BIT_6:
+    case BIT_7:
+    case BIT_8:
+      // The state didn't change so the sample matched the value of the bit,
+      // as will the rest of the run.
+      skip = SamplesBefore(m_max_bit_ticks, count);
+      m_ticks += skip;
+      break;
+    case STOP_BITS:
+      skip = SamplesBefore(m_stop_bits_ticks, count);
+      m_ticks += skip;
+      break;
+    case MARK_BETWEEN_SLOTS:
+      skip = SamplesBefore(m_max_mark_ticks, count);
+      m_ticks += skip;
+      break;
+    default:
+      break;
+  }
+
+  if (m_may_be_in_break && !bit) {
+    m_ticks_in_break += skip;
+  }
+  return skip;
+}
+
+/**
+ * Return how many more samples, up to count, can be added to m_ticks before
+ * reaching limit. The sample that reaches the limit is left for
+ * ProcessSample().
+ */
+unsigned int DMXSignalProcessor::SamplesBefore(unsigned int limit,
+                                               unsigned int count) const {
+  if (m_ticks + 1 >= limit) {
+    return 0;
   }
+  return std::min(count, limit - 1 - m_ticks);
 }
 
 /**
@@ -312,3 +451,21 @@ bool DMXSignalProcessor::DurationExceeds(double micro_seconds) {
 double DMXSignalProcessor::TicksAsMicroSeconds() {
   return m_ticks * m_microseconds_per_tick;
 }
+
+/*
+ * Return the smallest number of ticks for which DurationExceeds(micro_seconds)
+ * is true.
+ */
+unsigned int DMXSignalProcessor::MicroSecondsAsTicks(
+    double micro_seconds) const {
+  unsigned int ticks = static_cast<unsigned int>(
+      micro_seconds / m_microseconds_per_tick);
+  // Correct for any rounding so this matches DurationExceeds() exactly.
+  while (ticks && (ticks - 1) * m_microseconds_per_tick >= micro_seconds) {
+    ticks--;
+  }
+  while (ticks * m_microseconds_per_tick < micro_seconds) {
+    ticks++;
+  }
+  return ticks;
+}
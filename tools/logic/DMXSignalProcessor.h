@@ -44,6 +44,9 @@ class DMXSignalProcessor {
     // Process more data.
     void Process(uint8_t *ptr, unsigned int size, uint8_t mask = 0xff);
 
+    // Process count samples which all have the same value
+    void ProcessRun(bool bit, unsigned int count);
+
  private:
     enum State {
       UNDEFINED,  // when the signal is low and we have no idea where we are.
@@ -67,6 +70,11 @@ class DMXSignalProcessor {
     DataCallback* const m_callback;
     const unsigned int m_sample_rate;
     const double m_microseconds_per_tick;
+    // The timing limits converted to ticks, see DurationExceeds().
+    const unsigned int m_max_mab_ticks;
+    const unsigned int m_max_bit_ticks;
+    const unsigned int m_stop_bits_ticks;
+    const unsigned int m_max_mark_ticks;
 
     // our current state.
     State m_state;
@@ -85,6 +93,8 @@ class DMXSignalProcessor {
     std::vector<uint8_t> m_dmx_data;
 
     void ProcessSample(bool bit);
+    unsigned int SkipSamples(bool bit, unsigned int count);
+    unsigned int SamplesBefore(unsigned int limit, unsigned int count) const;
     void ProcessBit(bool bit);
     bool SetBitIfNotDefined(bool bit);
     void AppendDataByte();
@@ -93,6 +103,7 @@ class DMXSignalProcessor {
     void SetState(State state, unsigned int ticks = 1);
     bool DurationExceeds(double micro_seconds);
     double TicksAsMicroSeconds();
+    unsigned int MicroSecondsAsTicks(double micro_seconds) const;
 
     static const unsigned int DMX_BITRATE = 250000;
     // These are all in microseconds and are the receiver side limits.
@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXSignalProcessorTest.cpp
+ * Test fixture for the DMXSignalProcessor class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+#include "tools/logic/DMXSignalProcessor.h"
+
+using std::vector;
+
+class DMXSignalProcessorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DMXSignalProcessorTest);
+  CPPUNIT_TEST(testFrame);
+  CPPUNIT_TEST(testChunks);
+  CPPUNIT_TEST(testShortBreak);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testFrame();
+  void testChunks();
+  void testShortBreak();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_STDERR);
+    m_frames.clear();
+    m_signal.clear();
+  }
+
+ private:
+  vector<vector<uint8_t> > m_frames;
+  vector<uint8_t> m_signal;
+
+  void FrameReceived(const uint8_t *data, unsigned int length) {
+    m_frames.push_back(vector<uint8_t>(data, data + length));
+  }
+
+  DMXSignalProcessor::DataCallback *NewFrameCallback() {
+    return ola::NewCallback(this, &DMXSignalProcessorTest::FrameReceived);
+  }
+
+  void AddSamples(bool high, unsigned int micro_seconds);
+  void AddFrame(const uint8_t *data, unsigned int length,
+                unsigned int break_time = 100);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DMXSignalProcessorTest);
+
+namespace {
+// 4 samples per us.
+const unsigned int SAMPLE_RATE = 4000000;
+const uint8_t FRAME[] = {0, 1, 0x55, 0xaa, 0xff, 0x80};
+}  // namespace
+
+/*
+ * Add samples to the signal. The high samples use bit 2 and set some of the
+ * other bits to check the mask is applied.
+ */
+void DMXSignalProcessorTest::AddSamples(bool high,
+                                        unsigned int micro_seconds) {
+  m_signal.insert(m_signal.end(), micro_seconds * SAMPLE_RATE / 1000000,
+                  high ? 0x05 : 0x01);
+}
+
+void DMXSignalProcessorTest::AddFrame(const uint8_t *data,
+                                      unsigned int length,
+                                      unsigned int break_time) {
+  AddSamples(false, break_time);
+  AddSamples(true, 12);
+  for (unsigned int i = 0; i < length; i++) {
+    AddSamples(false, 4);
+    for (unsigned int bit = 0; bit < 8; bit++) {
+      AddSamples(data[i] & (1 << bit), 4);
+    }
+    AddSamples(true, 8);
+    // a mark between slots
+    AddSamples(true, i % 3 ? 0 : 20);
+  }
+  AddSamples(true, 50);
+}
+
+
+/*
+ * Check frames are decoded.
+ */
+void DMXSignalProcessorTest::testFrame() {
+  DMXSignalProcessor::DataCallback *callback = NewFrameCallback();
+  DMXSignalProcessor processor(callback, SAMPLE_RATE);
+
+  AddSamples(true, 200);
+  AddFrame(FRAME, sizeof(FRAME));
+  AddFrame(FRAME + 1, sizeof(FRAME) - 1);
+  AddFrame(FRAME, 1);
+  processor.Process(&m_signal[0], m_signal.size(), 0x04);
+
+  // The last frame isn't complete until the next break.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(FRAME, sizeof(FRAME), &m_frames[0][0],
+                         m_frames[0].size());
+  OLA_ASSERT_DATA_EQUALS(FRAME + 1, sizeof(FRAME) - 1, &m_frames[1][0],
+                         m_frames[1].size());
+  delete callback;
+}
+
+
+/*
+ * Check the result doesn't depend on how the samples are split up.
+ */
+void DMXSignalProcessorTest::testChunks() {
+  for (unsigned int i = 0; i < 20; i++) {
+    AddFrame(FRAME, sizeof(FRAME));
+  }
+  AddSamples(false, 100);
+
+  const unsigned int chunk_sizes[] = {1, 3, 7, 8, 13, 64, 1000};
+  for (unsigned int i = 0; i < sizeof(chunk_sizes) / sizeof(unsigned int);
+       i++) {
+    m_frames.clear();
+    DMXSignalProcessor::DataCallback *callback = NewFrameCallback();
+    DMXSignalProcessor processor(callback, SAMPLE_RATE);
+    for (unsigned int offset = 0; offset < m_signal.size();
+         offset += chunk_sizes[i]) {
+      unsigned int size = std::min(
+          chunk_sizes[i], static_cast<unsigned int>(m_signal.size()) - offset);
+      processor.Process(&m_signal[offset], size, 0x04);
+    }
+
+    OLA_ASSERT_EQ(static_cast<size_t>(20), m_frames.size());
+    for (unsigned int j = 0; j < m_frames.size(); j++) {
+      OLA_ASSERT_DATA_EQUALS(FRAME, sizeof(FRAME), &m_frames[j][0],
+                             m_frames[j].size());
+    }
+    delete callback;
+  }
+}
+
+
+/*
+ * Check a short break is ignored.
+ */
+void DMXSignalProcessorTest::testShortBreak() {
+  DMXSignalProcessor::DataCallback *callback = NewFrameCallback();
+  DMXSignalProcessor processor(callback, SAMPLE_RATE);
+
+  AddSamples(true, 200);
+  AddFrame(FRAME, sizeof(FRAME), 50);
+  AddFrame(FRAME, 2);
+  AddSamples(false, 100);
+  processor.Process(&m_signal[0], m_signal.size(), 0x04);
+
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  OLA_ASSERT_DATA_EQUALS(FRAME, 2, &m_frames[0][0], m_frames[0].size());
+  delete callback;
+}
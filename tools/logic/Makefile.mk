@@ -10,3 +10,14 @@ tools_logic_logic_rdm_sniffer_LDADD = common/libolacommon.la \
                                       $(libSaleaeDevice_LIBS)
 
 EXTRA_DIST += tools/logic/README.md
+
+# TESTS
+##################################################
+test_programs += tools/logic/DMXSignalProcessorTester
+
+tools_logic_DMXSignalProcessorTester_SOURCES = \
+    tools/logic/DMXSignalProcessor.cpp \
+    tools/logic/DMXSignalProcessor.h \
+    tools/logic/DMXSignalProcessorTest.cpp
+tools_logic_DMXSignalProcessorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+tools_logic_DMXSignalProcessorTester_LDADD = $(COMMON_TESTING_LIBS)
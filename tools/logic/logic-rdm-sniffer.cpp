@@ -46,6 +46,7 @@
 #include <ola/rdm/RDMHelper.h>
 #include <ola/rdm/RDMResponseCodes.h>
 #include <ola/rdm/UID.h>
+#include <ola/thread/ExecutorThread.h>
 
 #include <iostream>
 #include <fstream>
@@ -71,6 +72,7 @@ using ola::rdm::RDMCommand;
 using ola::rdm::UID;
 
 
+using ola::thread::ExecutorThread;
 using ola::thread::Mutex;
 using ola::thread::MutexLocker;
 using ola::NewSingleCallback;
@@ -87,6 +89,9 @@ DEFINE_uint16(dmx_slot_limit, ola::DMX_UNIVERSE_SIZE,
 DEFINE_uint32(sample_rate, 4000000, "Sample rate in HZ.");
 DEFINE_string(pid_location, "",
               "The directory containing the PID definitions.");
+DEFINE_uint32(max_queued_captures, 64,
+              "The number of captures that can be waiting to be decoded, "
+              "later captures are dropped.");
 
 void OnReadData(U64 device_id, U8 *data, uint32_t data_length,
                 void *user_data);
@@ -100,11 +105,16 @@ class LogicReader {
         m_device_id(0),
         m_logic(NULL),
         m_ss(ss),
+        m_decoder(ola::thread::Thread::Options("logic-decoder")),
+        m_queued_captures(0),
+        m_dropped_captures(0),
+        m_gap(false),
         m_signal_processor(ola::NewCallback(this, &LogicReader::FrameReceived),
                            sample_rate),
         m_pid_helper(FLAGS_pid_location.str(), 4),
         m_command_printer(&cout, &m_pid_helper) {
       m_pid_helper.Init();
+      m_decoder.Start();
     }
     ~LogicReader();
 
@@ -115,6 +125,10 @@ class LogicReader {
 
     void Stop();
 
+    unsigned int DroppedCaptures() {
+      return __sync_fetch_and_add(&m_dropped_captures, 0);
+    }
+
     bool IsConnected() const {
       MutexLocker lock(&m_mu);
       return m_logic != NULL;
@@ -126,13 +140,22 @@ class LogicReader {
     LogicInterface *m_logic;  // GUARDED_BY(mu_);
     mutable Mutex m_mu;
     SelectServer *m_ss;
-    DMXSignalProcessor m_signal_processor;
+    // Decoding runs in its own thread, so that it doesn't hold up the capture
+    // thread or the display of frames.
+    ExecutorThread m_decoder;
+    // These are updated with the atomic builtins.
+    unsigned int m_queued_captures;
+    unsigned int m_dropped_captures;
+    // Set if captures were dropped, only used in the capture thread.
+    bool m_gap;
+    DMXSignalProcessor m_signal_processor;  // only used in m_decoder
     PidStoreHelper m_pid_helper;
     CommandPrinter m_command_printer;
     Mutex m_data_mu;
     std::queue<U8*> m_free_data;
 
-    void ProcessData(U8 *data, uint32_t data_length);
+    void ProcessData(U8 *data, uint32_t data_length, bool after_gap);
+    void DisplayFrame(string frame);
     void DisplayDMXFrame(const uint8_t *data, unsigned int length);
     void DisplayRDMFrame(const uint8_t *data, unsigned int length);
     void DisplayAlternateFrame(const uint8_t *data, unsigned int length);
@@ -140,6 +163,7 @@ class LogicReader {
 };
 
 LogicReader::~LogicReader() {
+  m_decoder.Stop();
   m_ss->DrainCallbacks();
 }
 
@@ -199,8 +223,22 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
       return;
     }
   }
-  m_ss->Execute(
-      NewSingleCallback(this, &LogicReader::ProcessData, data, data_length));
+
+  if (__sync_add_and_fetch(&m_queued_captures, 1) >
+      FLAGS_max_queued_captures) {
+    // The decoder can't keep up, drop this capture rather than falling
+    // further behind.
+    __sync_fetch_and_sub(&m_queued_captures, 1);
+    if (__sync_fetch_and_add(&m_dropped_captures, 1) == 0) {
+      OLA_WARN << "Decoding can't keep up, dropping captures";
+    }
+    m_gap = true;
+    DevicesManagerInterface::DeleteU8ArrayPtr(data);
+  } else {
+    m_decoder.Execute(NewSingleCallback(this, &LogicReader::ProcessData,
+                                        data, data_length, m_gap));
+    m_gap = false;
+  }
 
   {
     MutexLocker lock(&m_data_mu);
@@ -213,11 +251,25 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
 }
 
 
+/**
+ * Called in the decoder thread when a frame is complete. The frame is
+ * displayed by the main thread.
+ */
 void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
   if (!length) {
     return;
   }
+  m_ss->Execute(NewSingleCallback(
+      this, &LogicReader::DisplayFrame,
+      string(reinterpret_cast<const char*>(data), length)));
+}
 
+/**
+ * Called in the main thread.
+ */
+void LogicReader::DisplayFrame(string frame) {
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(frame.data());
+  const unsigned int length = frame.size();
   switch (data[0]) {
     case 0:
       DisplayDMXFrame(data + 1, length - 1);
@@ -242,14 +294,21 @@ void LogicReader::Stop() {
 
 
 /**
- * Called in the main thread.
+ * Called in the decoder thread.
  * @param data pointer to the data, ownership is transferred, use
  *   DeleteU8ArrayPtr to free.
  * @param data_length the size of the data
+ * @param after_gap true if captures were dropped before this one.
  */
-void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
+void LogicReader::ProcessData(U8 *data, uint32_t data_length,
+                              bool after_gap) {
+  if (after_gap) {
+    // Some samples are missing, so start again from the next break.
+    m_signal_processor.Reset();
+  }
   m_signal_processor.Process(data, data_length, 0x01);
   DevicesManagerInterface::DeleteU8ArrayPtr(data);
+  __sync_fetch_and_sub(&m_queued_captures, 1);
 
   /*
    * This is commented out until we get clarification on if DeleteU8ArrayPtr is
@@ -370,5 +429,8 @@ int main(int argc, char *argv[]) {
   ss.RegisterSingleTimeout(3000, NewSingleCallback(DisplayReminder, &reader));
   ss.Run();
   reader.Stop();
+  if (reader.DroppedCaptures()) {
+    cerr << reader.DroppedCaptures() << " captures were dropped" << endl;
+  }
   return ola::EXIT_OK;
 }
@@ -19,19 +19,13 @@
 
 #include <ola/Logging.h>
 #include <string.h>
-#include <unistd.h>
 #include <algorithm>
 #include <string>
 #include <vector>
 
-#ifdef _WIN32
-#define VC_EXTRALEAN
-#include <ola/win/CleanWindows.h>
-#include <tchar.h>
-#endif  // _WIN32
-
 #include <ola/stl/STLUtils.h>
 #include "tools/ola_trigger/Action.h"
+#include "tools/ola_trigger/CommandRunner.h"
 #include "tools/ola_trigger/VariableInterpolator.h"
 
 using std::string;
@@ -62,6 +56,10 @@ void VariableAssignmentAction::Execute(Context *context, uint8_t) {
  */
 void CommandAction::Execute(Context *context, uint8_t) {
   char **args = BuildArgList(context);
+  if (!args) {
+    OLA_WARN << "Failed to expand the arguments for " << m_command;
+    return;
+  }
 
   if (ola::LogLevel() >= ola::OLA_LOG_INFO) {
     std::ostringstream str;
@@ -78,64 +76,18 @@ void CommandAction::Execute(Context *context, uint8_t) {
     OLA_INFO << str.str();
   }
 
-#ifdef _WIN32
-  std::ostringstream command_line_builder;
-  char** arg = args;
-  // Escape argv[0] if needed
-  if ((m_command.find(" ") != string::npos) &&
-      (m_command.find("\"") != 0)) {
-      command_line_builder << "\"" << m_command << "\" ";
-  } else {
-    command_line_builder << m_command << " ";
-  }
-  ++arg;
-  while (*arg) {
-    command_line_builder << " " << *arg++;
-  }
-
-  STARTUPINFO startup_info;
-  PROCESS_INFORMATION process_information;
-
-  memset(&startup_info, 0, sizeof(startup_info));
-  startup_info.cb = sizeof(startup_info);
-  memset(&process_information, 0, sizeof(process_information));
-
-  LPTSTR cmd_line = _strdup(command_line_builder.str().c_str());
-
-  if (!CreateProcessA(NULL,
-                     cmd_line,
-                     NULL,
-                     NULL,
-                     FALSE,
-                     CREATE_NEW_CONSOLE,
-                     NULL,
-                     NULL,
-                     &startup_info,
-                     &process_information)) {
-    OLA_WARN << "Could not launch " << args[0] << ": " << GetLastError();
-    FreeArgList(args);
+  if (m_runner) {
+    vector<string> arg_list;
+    for (char **ptr = args; *ptr; ptr++) {
+      arg_list.push_back(*ptr);
+    }
+    if (!m_runner->Run(this, arg_list)) {
+      OLA_WARN << "Too many commands waiting to run, dropped " << m_command;
+    }
   } else {
-    // Don't leak the handles
-    CloseHandle(process_information.hProcess);
-    CloseHandle(process_information.hThread);
+    SpawnCommand(args, false);
   }
-
-  free(cmd_line);
-#else
-  pid_t pid;
-  if ((pid = fork()) < 0) {
-    OLA_FATAL << "Could not fork to exec " << m_command;
-    FreeArgList(args);
-    return;
-  } else if (pid) {
-    // parent
-    OLA_DEBUG << "Child for " << m_command << " is " << pid;
-    FreeArgList(args);
-    return;
-  }
-
-  execvp(m_command.c_str(), args);
-#endif  // _WIN32
+  FreeArgList(args);
 }
 
 
@@ -232,6 +184,29 @@ Slot::~Slot() {
 }
 
 
+/**
+ * @brief Create a copy of this Slot, with the same intervals and actions.
+ *
+ * The copy doesn't have a previous value, so the next value it's passed is
+ * a rising edge.
+ */
+Slot *Slot::Clone() const {
+  Slot *slot = new Slot(m_slot_offset);
+  ActionVector::const_iterator iter = m_actions.begin();
+  for (; iter != m_actions.end(); ++iter) {
+    slot->AddAction(*iter->interval, iter->rising_action,
+                    iter->falling_action);
+  }
+  if (m_default_rising_action) {
+    slot->SetDefaultRisingAction(m_default_rising_action);
+  }
+  if (m_default_falling_action) {
+    slot->SetDefaultFallingAction(m_default_falling_action);
+  }
+  return slot;
+}
+
+
 /**
  * @brief Attempt to associated an Action with a interval
  * @param lower_value the lower bound of the interval
@@ -243,6 +218,7 @@ Slot::~Slot() {
 bool Slot::AddAction(const ValueInterval &interval_arg,
                      Action *rising_action,
                      Action *falling_action) {
+  m_action_table_valid = false;
   ActionInterval action_interval(
       new ValueInterval(interval_arg),
       rising_action,
@@ -395,17 +371,6 @@ string Slot::IntervalsAsString() const {
 }
 
 
-/**
- * @brief Given two interval iterators, first and last, return true if the value is
- *   contained within the lower and upper bounds of the intervals.
- */
-bool Slot::ValueWithinIntervals(uint8_t value,
-                                const ValueInterval &lower_interval,
-                                const ValueInterval &upper_interval) {
-  return lower_interval.Lower() <= value && value <= upper_interval.Upper();
-}
-
-
 /**
  * @brief Check if two ValueIntervals intersect.
  */
@@ -426,53 +391,33 @@ bool Slot::IntervalsIntersect(const ValueInterval *a1,
  * @returns the Action matching the value,  or NULL if there isn't one.
  */
 Action *Slot::LocateMatchingAction(uint8_t value, bool rising) {
-  if (m_actions.empty()) {
-    return NULL;
+  if (!m_action_table_valid) {
+    BuildActionTable();
   }
 
-  ActionVector::iterator lower = m_actions.begin();
-  ActionVector::iterator upper = m_actions.end();
-  upper--;
-  if (!ValueWithinIntervals(value, *(lower->interval), *(upper->interval))) {
+  const uint16_t index = m_action_table[value];
+  if (!index) {
     return NULL;
   }
+  const ActionInterval &action_interval = m_actions[index - 1];
+  return rising ? action_interval.rising_action :
+      action_interval.falling_action;
+}
 
-  // ok, we know the value lies between the intervals we have, first exclude
-  // the endpoints
-  if (lower->interval->Contains(value)) {
-    return rising ? lower->rising_action : lower->falling_action;
-  }
-
-  if (upper->interval->Contains(value)) {
-    return rising ? upper->rising_action : upper->falling_action;
-  }
-
-  // value isn't at the lower or upper interval, but lies somewhere between
-  // the two.
-  // @pre lower != upper
-  // @pre !lower.Contains(value) && !upper.Contains(value)
-  while (true) {
-    unsigned int difference = upper - lower;
-    ActionVector::iterator mid = lower + difference / 2;
-
-    if (mid == lower) {
-      // lower doesn't contain the value, so we don't have it
-      return NULL;
-    }
 
-    if (mid->interval->Contains(value)) {
-      return rising ? mid->rising_action : mid->falling_action;
-    } else if (value <= mid->interval->Lower()) {
-      upper = mid;
-    } else if (value >= mid->interval->Upper()) {
-      lower = mid;
-    } else {
-      OLA_WARN << "Inconsistent intervals detected when looking for: "
-               << static_cast<int>(value) << ", intervals: "
-               << IntervalsAsString(lower, upper);
-      return NULL;
+/**
+ * @brief Build the table which maps each value to its ActionInterval.
+ */
+void Slot::BuildActionTable() {
+  memset(m_action_table, 0, sizeof(m_action_table));
+  for (unsigned int i = 0; i < m_actions.size(); i++) {
+    const ValueInterval *interval = m_actions[i].interval;
+    for (unsigned int value = interval->Lower(); value <= interval->Upper();
+         value++) {
+      m_action_table[value] = i + 1;
     }
   }
+  m_action_table_valid = true;
 }
 
 
@@ -80,13 +80,19 @@ class VariableAssignmentAction: public Action {
 
 /**
  * @brief Command Action. This action executes a command.
+ *
+ * The arguments are expanded when the action runs. If there's a
+ * CommandRunner the command is run from its worker threads, otherwise it's
+ * started straight away.
  */
 class CommandAction: public Action {
  public:
   CommandAction(const std::string &command,
-                const std::vector<std::string> &arguments)
+                const std::vector<std::string> &arguments,
+                class CommandRunner *runner = NULL)
       : m_command(command),
-        m_arguments(arguments) {
+        m_arguments(arguments),
+        m_runner(runner) {
   }
   virtual ~CommandAction() {}
 
@@ -95,6 +101,7 @@ class CommandAction: public Action {
  protected:
   const std::string m_command;
   std::vector<std::string> m_arguments;
+  class CommandRunner *m_runner;
 
   char **BuildArgList(const Context *context);
   void FreeArgList(char **args);
@@ -148,10 +155,13 @@ class Slot {
       m_default_falling_action(NULL),
       m_slot_offset(slot_offset),
       m_old_value(0),
-      m_old_value_defined(false) {
+      m_old_value_defined(false),
+      m_action_table_valid(false) {
   }
   ~Slot();
 
+  Slot *Clone() const;
+
   void SetSlotOffset(uint16_t offset) { m_slot_offset = offset; }
   uint16_t SlotOffset() const { return m_slot_offset; }
 
@@ -174,6 +184,10 @@ class Slot {
   uint16_t m_slot_offset;
   uint8_t m_old_value;
   bool m_old_value_defined;
+  bool m_action_table_valid;
+  // The index + 1 of the ActionInterval for each value, 0 if there isn't one.
+  // This is rebuilt the first time it's needed after AddAction().
+  uint16_t m_action_table[256];
 
   class ActionInterval {
    public:
@@ -243,12 +257,10 @@ class Slot {
   typedef std::vector<ActionInterval> ActionVector;
   ActionVector m_actions;
 
-  bool ValueWithinIntervals(uint8_t value,
-                            const ValueInterval &lower_interval,
-                            const ValueInterval &upper_interval);
   bool IntervalsIntersect(const ValueInterval *a1,
                           const ValueInterval *a2);
   Action *LocateMatchingAction(uint8_t value, bool rising);
+  void BuildActionTable();
   std::string IntervalsAsString(const ActionVector::const_iterator &start,
                                 const ActionVector::const_iterator &end) const;
   bool SetDefaultAction(Action **action_to_set, Action *new_action);
@@ -0,0 +1,271 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunner.cpp
+ * Runs the commands from CommandActions on a pool of worker threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef _WIN32
+#define VC_EXTRALEAN
+#include <ola/win/CleanWindows.h>
+#include <tchar.h>
+#else
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif  // _WIN32
+
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/stl/STLUtils.h>
+#include <ola/thread/Thread.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tools/ola_trigger/CommandRunner.h"
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::thread::CallbackThread;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+
+bool SpawnCommand(char **args, bool wait) {
+#ifdef _WIN32
+  std::ostringstream command_line_builder;
+  const string command = args[0];
+  char** arg = args;
+  // Escape argv[0] if needed
+  if ((command.find(" ") != string::npos) &&
+      (command.find("\"") != 0)) {
+      command_line_builder << "\"" << command << "\" ";
+  } else {
+    command_line_builder << command << " ";
+  }
+  ++arg;
+  while (*arg) {
+    command_line_builder << " " << *arg++;
+  }
+
+  STARTUPINFO startup_info;
+  PROCESS_INFORMATION process_information;
+
+  memset(&startup_info, 0, sizeof(startup_info));
+  startup_info.cb = sizeof(startup_info);
+  memset(&process_information, 0, sizeof(process_information));
+
+  LPTSTR cmd_line = _strdup(command_line_builder.str().c_str());
+
+  bool ok = CreateProcessA(NULL,
+                           cmd_line,
+                           NULL,
+                           NULL,
+                           FALSE,
+                           CREATE_NEW_CONSOLE,
+                           NULL,
+                           NULL,
+                           &startup_info,
+                           &process_information);
+  if (ok) {
+    if (wait) {
+      WaitForSingleObject(process_information.hProcess, INFINITE);
+    }
+    // Don't leak the handles
+    CloseHandle(process_information.hProcess);
+    CloseHandle(process_information.hThread);
+  } else {
+    OLA_WARN << "Could not launch " << args[0] << ": " << GetLastError();
+  }
+
+  free(cmd_line);
+  return ok;
+#else
+  pid_t pid;
+  if ((pid = fork()) < 0) {
+    OLA_FATAL << "Could not fork to exec " << args[0];
+    return false;
+  } else if (pid == 0) {
+    // child
+    execvp(args[0], args);
+    _exit(127);
+  }
+
+  OLA_DEBUG << "Child for " << args[0] << " is " << pid;
+  if (wait) {
+    // The SIGCHLD handler may reap the child first, which gives ECHILD.
+    while (waitpid(pid, NULL, 0) < 0 && errno == EINTR) {}
+  }
+  return true;
+#endif  // _WIN32
+}
+
+
+CommandRunner::CommandRunner(const Options &options)
+    : m_options(options),
+      m_stop(false),
+      m_coalesced(0),
+      m_dropped(0) {
+}
+
+
+CommandRunner::~CommandRunner() {
+  Stop();
+}
+
+
+bool CommandRunner::Start() {
+  if (!m_workers.empty()) {
+    return false;
+  }
+
+  m_stop = false;
+  for (unsigned int i = 0; i < m_options.workers; i++) {
+    CallbackThread *worker = new CallbackThread(
+        ola::NewSingleCallback(this, &CommandRunner::WorkerLoop),
+        ola::thread::Thread::Options("trigger-command"));
+    if (!worker->Start()) {
+      OLA_WARN << "Failed to start command worker " << i;
+      delete worker;
+      Stop();
+      return false;
+    }
+    m_workers.push_back(worker);
+  }
+  return true;
+}
+
+
+void CommandRunner::Stop() {
+  {
+    MutexLocker lock(&m_mutex);
+    m_stop = true;
+    m_pending.clear();
+    m_pending_order.clear();
+    m_condition.Broadcast();
+  }
+
+  vector<CallbackThread*>::iterator iter = m_workers.begin();
+  for (; iter != m_workers.end(); ++iter) {
+    (*iter)->Join();
+  }
+  ola::STLDeleteElements(&m_workers);
+}
+
+
+bool CommandRunner::Run(const void *key, const vector<string> &args) {
+  MutexLocker lock(&m_mutex);
+  PendingMap::iterator iter = m_pending.find(key);
+  if (iter != m_pending.end()) {
+    iter->second = args;
+    m_coalesced++;
+    return true;
+  }
+
+  if (m_pending.size() >= m_options.max_pending) {
+    m_dropped++;
+    return false;
+  }
+
+  m_pending[key] = args;
+  m_pending_order.push_back(key);
+  m_condition.Signal();
+  return true;
+}
+
+
+void CommandRunner::Execute(const vector<string> &args) {
+  vector<char*> argv;
+  vector<string>::const_iterator iter = args.begin();
+  for (; iter != args.end(); ++iter) {
+    argv.push_back(const_cast<char*>(iter->c_str()));
+  }
+  argv.push_back(NULL);
+  SpawnCommand(&argv[0], true);
+}
+
+
+void CommandRunner::WorkerLoop() {
+  m_mutex.Lock();
+  while (!m_stop) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+
+    const void *key;
+    vector<string> args;
+    TimeStamp wake_up;
+    if (TakeCommand(now, &key, &args, &wake_up)) {
+      m_mutex.Unlock();
+      Execute(args);
+      m_mutex.Lock();
+      m_running.erase(key);
+      // Another command with this key may be waiting.
+      m_condition.Broadcast();
+    } else if (wake_up.IsSet()) {
+      m_condition.TimedWait(&m_mutex, wake_up);
+    } else {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+  m_mutex.Unlock();
+}
+
+
+/*
+ * Find the oldest command that can run now. If there's a command which is
+ * waiting for the rate limit, wake_up is set to the time it can run.
+ * This must be called with m_mutex held.
+ */
+bool CommandRunner::TakeCommand(const TimeStamp &now,
+                                const void **key,
+                                vector<string> *args,
+                                TimeStamp *wake_up) {
+  const TimeInterval min_interval(
+      static_cast<int64_t>(m_options.min_interval_ms) * ola::ONE_THOUSAND);
+
+  std::deque<const void*>::iterator iter = m_pending_order.begin();
+  for (; iter != m_pending_order.end(); ++iter) {
+    if (ola::STLContains(m_running, *iter)) {
+      continue;
+    }
+
+    LastRunMap::const_iterator last_run = m_last_run.find(*iter);
+    if (last_run != m_last_run.end()) {
+      TimeStamp next_run = last_run->second + min_interval;
+      if (now < next_run) {
+        if (!wake_up->IsSet() || next_run < *wake_up) {
+          *wake_up = next_run;
+        }
+        continue;
+      }
+    }
+
+    *key = *iter;
+    PendingMap::iterator pending = m_pending.find(*key);
+    args->swap(pending->second);
+    m_pending.erase(pending);
+    m_pending_order.erase(iter);
+    m_running.insert(*key);
+    m_last_run[*key] = now;
+    return true;
+  }
+  return false;
+}
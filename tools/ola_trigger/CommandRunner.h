@@ -0,0 +1,143 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunner.h
+ * Runs the commands from CommandActions on a pool of worker threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
+#define TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
+
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/CallbackThread.h>
+#include <ola/thread/Mutex.h>
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Start a command.
+ * @param args the NULL terminated argument list, args[0] is the command.
+ * @param wait true to wait for the command to exit.
+ * @returns true if the command was started.
+ */
+bool SpawnCommand(char **args, bool wait);
+
+
+/**
+ * @brief Runs commands on a pool of worker threads, so slow commands don't
+ * hold up the DMX processing.
+ *
+ * Each command is queued with a key, usually the Action it came from.
+ * - If a command with the same key is already queued, it's replaced with
+ *   the new one, since only the latest values matter.
+ * - Only one command with a key runs at a time.
+ * - A command doesn't start until Options::min_interval_ms after the last
+ *   command with the same key started.
+ * - Once Options::max_pending keys are queued, new commands are dropped.
+ */
+class CommandRunner {
+ public:
+  struct Options {
+    Options()
+        : workers(4),
+          max_pending(64),
+          min_interval_ms(0) {
+    }
+
+    /** @brief The number of commands that can run at once. */
+    unsigned int workers;
+    /** @brief The maximum number of commands waiting to run. */
+    unsigned int max_pending;
+    /** @brief The minimum time between starting commands with the same key */
+    unsigned int min_interval_ms;
+  };
+
+  explicit CommandRunner(const Options &options);
+
+  /**
+   * @brief Destructor, this calls Stop().
+   */
+  virtual ~CommandRunner();
+
+  /**
+   * @brief Start the worker threads.
+   * @returns true if the workers started.
+   */
+  bool Start();
+
+  /**
+   * @brief Discard the queued commands, and wait for the running commands to
+   *   complete.
+   */
+  void Stop();
+
+  /**
+   * @brief Queue a command.
+   * @param key identifies the source of the command.
+   * @param args the command followed by its arguments.
+   * @returns true if the command was queued, false if it was dropped.
+   */
+  bool Run(const void *key, const std::vector<std::string> &args);
+
+  /**
+   * @brief The number of commands replaced by a newer one with the same key.
+   */
+  unsigned int Coalesced() const { return m_coalesced; }
+
+  /**
+   * @brief The number of commands dropped because the queue was full.
+   */
+  unsigned int Dropped() const { return m_dropped; }
+
+ protected:
+  /**
+   * @brief Run a command and wait for it to complete. This is called from
+   *   the worker threads.
+   */
+  virtual void Execute(const std::vector<std::string> &args);
+
+ private:
+  typedef std::map<const void*, std::vector<std::string> > PendingMap;
+  typedef std::map<const void*, ola::TimeStamp> LastRunMap;
+
+  const Options m_options;
+  ola::Clock m_clock;
+  std::vector<ola::thread::CallbackThread*> m_workers;
+
+  ola::thread::Mutex m_mutex;  // protects everything below
+  ola::thread::ConditionVariable m_condition;
+  bool m_stop;
+  PendingMap m_pending;
+  std::deque<const void*> m_pending_order;
+  std::set<const void*> m_running;
+  LastRunMap m_last_run;
+  unsigned int m_coalesced;
+  unsigned int m_dropped;
+
+  void WorkerLoop();
+  bool TakeCommand(const ola::TimeStamp &now,
+                   const void **key,
+                   std::vector<std::string> *args,
+                   ola::TimeStamp *wake_up);
+
+  DISALLOW_COPY_AND_ASSIGN(CommandRunner);
+};
+#endif  // TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
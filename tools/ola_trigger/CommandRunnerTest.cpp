@@ -0,0 +1,213 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunnerTest.cpp
+ * Test fixture for the CommandRunner class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/thread/Mutex.h>
+#include <string>
+#include <vector>
+
+#include "tools/ola_trigger/CommandRunner.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::thread::ConditionVariable;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+
+/**
+ * A CommandRunner which records the commands rather than running them.
+ * Commands block until Release() is called, if Hold() was called.
+ */
+class MockCommandRunner: public CommandRunner {
+ public:
+  explicit MockCommandRunner(const Options &options)
+      : CommandRunner(options),
+        m_hold(false) {
+  }
+
+  ~MockCommandRunner() { Stop(); }
+
+  void Hold() {
+    MutexLocker lock(&m_mutex);
+    m_hold = true;
+  }
+
+  void Release() {
+    MutexLocker lock(&m_mutex);
+    m_hold = false;
+    m_condition.Broadcast();
+  }
+
+  /*
+   * Wait until count commands have started, returns false if it takes more
+   * than a second.
+   */
+  bool WaitForCommands(unsigned int count) {
+    TimeStamp deadline;
+    m_clock.CurrentTime(&deadline);
+    deadline += TimeInterval(1, 0);
+    MutexLocker lock(&m_mutex);
+    while (commands.size() < count) {
+      if (!m_condition.TimedWait(&m_mutex, deadline)) {
+        return commands.size() >= count;
+      }
+    }
+    return true;
+  }
+
+  vector<string> commands;
+  vector<TimeStamp> start_times;
+
+ protected:
+  void Execute(const vector<string> &args) {
+    TimeStamp now;
+    m_clock.CurrentTime(&now);
+    MutexLocker lock(&m_mutex);
+    commands.push_back(args[0]);
+    start_times.push_back(now);
+    m_condition.Broadcast();
+    while (m_hold) {
+      m_condition.Wait(&m_mutex);
+    }
+  }
+
+ private:
+  Clock m_clock;
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  bool m_hold;
+};
+
+
+class CommandRunnerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(CommandRunnerTest);
+  CPPUNIT_TEST(testCoalescing);
+  CPPUNIT_TEST(testMaxPending);
+  CPPUNIT_TEST(testRateLimit);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testCoalescing();
+  void testMaxPending();
+  void testRateLimit();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CommandRunnerTest);
+
+namespace {
+vector<string> Command(const string &command) {
+  return vector<string>(1, command);
+}
+
+const int KEY1 = 1;
+const int KEY2 = 2;
+const int KEY3 = 3;
+}  // namespace
+
+
+/**
+ * Check commands queued while another with the same key is waiting replace
+ * it.
+ */
+void CommandRunnerTest::testCoalescing() {
+  CommandRunner::Options options;
+  options.workers = 1;
+  MockCommandRunner runner(options);
+  OLA_ASSERT_TRUE(runner.Start());
+
+  runner.Hold();
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("a")));
+  OLA_ASSERT_TRUE(runner.WaitForCommands(1));
+
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("b")));
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("c")));
+  OLA_ASSERT_TRUE(runner.Run(&KEY2, Command("d")));
+  OLA_ASSERT_EQ(1u, runner.Coalesced());
+  runner.Release();
+
+  OLA_ASSERT_TRUE(runner.WaitForCommands(3));
+  OLA_ASSERT_EQ(string("a"), runner.commands[0]);
+  OLA_ASSERT_EQ(string("c"), runner.commands[1]);
+  OLA_ASSERT_EQ(string("d"), runner.commands[2]);
+  runner.Stop();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), runner.commands.size());
+}
+
+
+/**
+ * Check commands are dropped once the queue is full.
+ */
+void CommandRunnerTest::testMaxPending() {
+  CommandRunner::Options options;
+  options.workers = 1;
+  options.max_pending = 1;
+  MockCommandRunner runner(options);
+  OLA_ASSERT_TRUE(runner.Start());
+
+  runner.Hold();
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("a")));
+  OLA_ASSERT_TRUE(runner.WaitForCommands(1));
+
+  OLA_ASSERT_TRUE(runner.Run(&KEY2, Command("b")));
+  OLA_ASSERT_FALSE(runner.Run(&KEY3, Command("c")));
+  OLA_ASSERT_EQ(1u, runner.Dropped());
+  // replacing a queued command doesn't need any more space
+  OLA_ASSERT_TRUE(runner.Run(&KEY2, Command("d")));
+  runner.Release();
+
+  OLA_ASSERT_TRUE(runner.WaitForCommands(2));
+  OLA_ASSERT_EQ(string("d"), runner.commands[1]);
+}
+
+
+/**
+ * Check commands with the same key are spaced out by min_interval_ms.
+ */
+void CommandRunnerTest::testRateLimit() {
+  CommandRunner::Options options;
+  options.workers = 2;
+  options.min_interval_ms = 50;
+  MockCommandRunner runner(options);
+  OLA_ASSERT_TRUE(runner.Start());
+
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("a")));
+  OLA_ASSERT_TRUE(runner.WaitForCommands(1));
+  OLA_ASSERT_TRUE(runner.Run(&KEY1, Command("b")));
+  OLA_ASSERT_TRUE(runner.Run(&KEY2, Command("c")));
+
+  OLA_ASSERT_TRUE(runner.WaitForCommands(3));
+  // c isn't held up by the rate limit on KEY1
+  OLA_ASSERT_EQ(string("c"), runner.commands[1]);
+  OLA_ASSERT_EQ(string("b"), runner.commands[2]);
+  OLA_ASSERT_TRUE(runner.start_times[2] - runner.start_times[0] >=
+                  TimeInterval(0, 50000));
+}
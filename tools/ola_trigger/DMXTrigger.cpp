@@ -17,8 +17,11 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <stdint.h>
+#include <string.h>
 #include <algorithm>
 #include <vector>
 
@@ -26,6 +29,35 @@
 
 using ola::DmxBuffer;
 
+namespace {
+bool SlotOffsetLessThan(const Slot *a, const Slot *b) {
+  return a->SlotOffset() < b->SlotOffset();
+}
+
+/*
+ * Return the first offset in [start, end) where the two arrays differ, or
+ * end if they're the same. This compares a word at a time, since most slots
+ * are the same from one frame to the next.
+ */
+unsigned int FindChange(const uint8_t *a, const uint8_t *b,
+                        unsigned int start, unsigned int end) {
+  while (start + sizeof(uint64_t) <= end) {
+    uint64_t a_word, b_word;
+    // memcpy since the data may not be aligned.
+    memcpy(&a_word, a + start, sizeof(a_word));
+    memcpy(&b_word, b + start, sizeof(b_word));
+    if (a_word != b_word) {
+      break;
+    }
+    start += sizeof(uint64_t);
+  }
+  while (start < end && a[start] == b[start]) {
+    start++;
+  }
+  return start;
+}
+}  // namespace
+
 
 /**
  * @brief Create a new trigger
@@ -33,8 +65,18 @@ using ola::DmxBuffer;
 DMXTrigger::DMXTrigger(Context *context,
                        const SlotVector &actions)
     : m_context(context),
-      m_slots(actions) {
-  sort(m_slots.begin(), m_slots.end());
+      m_slots(actions),
+      m_have_frame(false) {
+  std::stable_sort(m_slots.begin(), m_slots.end(), SlotOffsetLessThan);
+
+  m_slot_index.reserve(ola::DMX_UNIVERSE_SIZE + 1);
+  SlotVector::const_iterator iter = m_slots.begin();
+  for (unsigned int offset = 0; offset <= ola::DMX_UNIVERSE_SIZE; offset++) {
+    while (iter != m_slots.end() && (*iter)->SlotOffset() < offset) {
+      ++iter;
+    }
+    m_slot_index.push_back(iter - m_slots.begin());
+  }
 }
 
 
@@ -42,13 +84,45 @@ DMXTrigger::DMXTrigger(Context *context,
  * @brief Called when new DMX arrives.
  */
 void DMXTrigger::NewDMX(const DmxBuffer &data) {
-  SlotVector::iterator iter = m_slots.begin();
-  for (; iter != m_slots.end(); iter++) {
-    uint16_t slot_number = (*iter)->SlotOffset();
-    if (slot_number >= data.Size()) {
-      // the DMX frame was too small
-      break;
+  const unsigned int size = data.Size();
+  if (!m_have_frame) {
+    TakeActions(data, 0, size);
+  } else {
+    const unsigned int common_size = std::min(size, m_last_frame.Size());
+    const uint8_t *new_data = data.GetRaw();
+    const uint8_t *old_data = m_last_frame.GetRaw();
+    unsigned int offset = FindChange(new_data, old_data, 0, common_size);
+    while (offset < common_size) {
+      TakeAction(new_data[offset], offset);
+      offset = FindChange(new_data, old_data, offset + 1, common_size);
     }
-    (*iter)->TakeAction(m_context, data.Get(slot_number));
+    TakeActions(data, common_size, size);
+  }
+  m_last_frame = data;
+  m_have_frame = true;
+}
+
+
+/**
+ * @brief Run the Slots for every offset in [start, end).
+ */
+void DMXTrigger::TakeActions(const DmxBuffer &data, unsigned int start,
+                             unsigned int end) {
+  const uint8_t *raw = data.GetRaw();
+  // Skip straight over the offsets without any Slots.
+  for (unsigned int i = m_slot_index[start]; i < m_slot_index[end]; i++) {
+    Slot *slot = m_slots[i];
+    slot->TakeAction(m_context, raw[slot->SlotOffset()]);
+  }
+}
+
+
+/**
+ * @brief Run the Slots for an offset.
+ */
+void DMXTrigger::TakeAction(uint8_t value, unsigned int offset) {
+  for (unsigned int i = m_slot_index[offset]; i < m_slot_index[offset + 1];
+       i++) {
+    m_slots[i]->TakeAction(m_context, value);
   }
 }
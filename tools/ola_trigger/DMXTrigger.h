@@ -22,12 +22,17 @@
 #define TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
 
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
 
 /*
  * @brief The class which manages the triggering.
+ *
+ * Each frame is compared with the previous one, and only the slots which
+ * changed are passed to their Slot. Slots beyond the end of the previous
+ * frame count as changed.
  */
 class DMXTrigger {
  public:
@@ -40,6 +45,14 @@ class DMXTrigger {
 
  private:
   Context *m_context;
-  SlotVector m_slots;  // kept sorted
+  SlotVector m_slots;  // sorted by slot offset
+  // The Slots for offset o are m_slots[m_slot_index[o], m_slot_index[o + 1])
+  std::vector<unsigned int> m_slot_index;
+  ola::DmxBuffer m_last_frame;
+  bool m_have_frame;
+
+  void TakeActions(const ola::DmxBuffer &data, unsigned int start,
+                   unsigned int end);
+  void TakeAction(uint8_t value, unsigned int offset);
 };
 #endif  // TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
@@ -37,11 +37,13 @@ class DMXTriggerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DMXTriggerTest);
   CPPUNIT_TEST(testRisingEdgeTrigger);
   CPPUNIT_TEST(testFallingEdgeTrigger);
+  CPPUNIT_TEST(testMultipleSlots);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testRisingEdgeTrigger();
   void testFallingEdgeTrigger();
+  void testMultipleSlots();
 
   void setUp() {
     ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -159,3 +161,59 @@ void DMXTriggerTest::testFallingEdgeTrigger() {
   rising_action->CheckForValue(OLA_SOURCELINE(), 20);
   OLA_ASSERT(falling_action->NoCalls());
 }
+
+
+/**
+ * Check that only the slots which changed are triggered, regardless of the
+ * order the slots were passed in.
+ */
+void DMXTriggerTest::testMultipleSlots() {
+  vector<Slot*> slots;
+  Slot slot1(13);
+  Slot slot2(1);
+  Slot slot3(1);
+  MockAction *action1 = new MockAction();
+  MockAction *action2 = new MockAction();
+  MockAction *action3 = new MockAction();
+  ValueInterval interval(10, 20);
+  slot1.AddAction(interval, action1, action1);
+  slot2.AddAction(interval, action2, action2);
+  slot3.AddAction(ValueInterval(5, 5), action3, action3);
+  slots.push_back(&slot1);
+  slots.push_back(&slot2);
+  slots.push_back(&slot3);
+
+  Context context;
+  DMXTrigger trigger(&context, slots);
+  DmxBuffer buffer;
+
+  buffer.SetFromString("0,10,0,0,0,0,0,0,0,0,0,0,0,15");
+  trigger.NewDMX(buffer);
+  action1->CheckForValue(OLA_SOURCELINE(), 15);
+  action2->CheckForValue(OLA_SOURCELINE(), 10);
+  OLA_ASSERT(action3->NoCalls());
+
+  // only slot 13 changes
+  buffer.SetChannel(13, 16);
+  buffer.SetChannel(12, 1);
+  trigger.NewDMX(buffer);
+  action1->CheckForValue(OLA_SOURCELINE(), 16);
+  OLA_ASSERT(action2->NoCalls());
+  OLA_ASSERT(action3->NoCalls());
+
+  // both slots at offset 1 see the change
+  buffer.SetChannel(1, 5);
+  trigger.NewDMX(buffer);
+  OLA_ASSERT(action1->NoCalls());
+  OLA_ASSERT(action2->NoCalls());
+  action3->CheckForValue(OLA_SOURCELINE(), 5);
+
+  // shorten the frame, then bring slot 13 back with a new value
+  buffer.SetFromString("0,5");
+  trigger.NewDMX(buffer);
+  buffer.SetFromString("0,5,0,0,0,0,0,0,0,0,0,0,1,17");
+  trigger.NewDMX(buffer);
+  action1->CheckForValue(OLA_SOURCELINE(), 17);
+  OLA_ASSERT(action2->NoCalls());
+  OLA_ASSERT(action3->NoCalls());
+}
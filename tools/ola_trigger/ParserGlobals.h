@@ -28,6 +28,9 @@
 // The context object
 extern class Context *global_context;
 
+// The CommandRunner passed to new CommandActions, may be NULL
+extern class CommandRunner *global_command_runner;
+
 // A map of slot offsets to SlotAction objects
 typedef std::map<uint16_t, class Slot*> SlotActionMap;
 extern SlotActionMap global_slots;
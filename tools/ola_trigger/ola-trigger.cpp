@@ -34,14 +34,17 @@
 #include <ola/base/Init.h>
 #include <ola/base/SysExits.h>
 #include <ola/io/SelectServer.h>
+#include <ola/StringUtils.h>
 #include <ola/stl/STLUtils.h>
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
+#include "tools/ola_trigger/CommandRunner.h"
 #include "tools/ola_trigger/Context.h"
 #include "tools/ola_trigger/DMXTrigger.h"
 #include "tools/ola_trigger/ParserGlobals.h"
@@ -56,21 +59,33 @@ using std::vector;
 DEFINE_s_uint16(offset, o, 0,
                 "Apply an offset to the slot numbers. Valid offsets are 0 to "
                 "512, default is 0.");
-DEFINE_s_uint32(universe, u, 0, "The universe to use, defaults to 0.");
+DEFINE_s_string(universe, u, "0",
+                "The universes to use as a comma separated list, each "
+                "universe triggers the same actions. Defaults to 0.");
 DEFINE_default_bool(validate, false,
                     "Validate the config file, rather than running it.");
+DEFINE_uint32(command_workers, CommandRunner::Options().workers,
+              "The number of commands that can run at once, 0 starts each "
+              "command straight away.");
+DEFINE_uint32(max_queued_commands, CommandRunner::Options().max_pending,
+              "The maximum number of commands waiting to run, later "
+              "commands are dropped.");
+DEFINE_uint32(command_interval, 0,
+              "The minimum time in ms between runs of the same command.");
 
 // prototype of bison-generated parser function
 int yyparse();
 
 // globals modified by the config parser
 Context *global_context;
+CommandRunner *global_command_runner = NULL;
 SlotActionMap global_slots;
 
 // The SelectServer to kill when we catch SIGINT
 ola::io::SelectServer *ss = NULL;
 
 typedef vector<Slot*> SlotList;
+typedef map<unsigned int, DMXTrigger*> TriggerMap;
 
 #ifndef _WIN32
 /*
@@ -117,18 +132,40 @@ bool InstallSignals() {
 
 
 /**
- * @brief The DMX Handler, this calls the trigger if the universes match.
+ * @brief The DMX Handler, this calls the trigger for the universe.
  */
-void NewDmx(unsigned int our_universe,
-            DMXTrigger *trigger,
+void NewDmx(TriggerMap *triggers,
             unsigned int universe,
             const DmxBuffer &data,
-            OLA_UNUSED const string &error) {
-  if (universe == our_universe && error.empty()) {
+            const string &error) {
+  if (!error.empty()) {
+    return;
+  }
+  DMXTrigger *trigger = ola::STLFindOrNull(*triggers, universe);
+  if (trigger) {
+    global_context->SetUniverse(universe);
     trigger->NewDMX(data);
   }
 }
 
+
+/**
+ * @brief Parse the list of universes from the --universe flag.
+ */
+bool ParseUniverses(const string &input, vector<unsigned int> *universes) {
+  vector<string> tokens;
+  ola::StringSplit(input, &tokens, ",");
+  vector<string>::const_iterator iter = tokens.begin();
+  for (; iter != tokens.end(); ++iter) {
+    unsigned int universe;
+    if (!ola::StringToInt(*iter, &universe, true)) {
+      return false;
+    }
+    universes->push_back(universe);
+  }
+  return !universes->empty();
+}
+
 /**
  * @brief Build a vector of Slot from the global_slots map with the
  * offset applied.
@@ -182,6 +219,24 @@ int main(int argc, char *argv[]) {
 
   string config_file = argv[1];
 
+  vector<unsigned int> universes;
+  if (!ParseUniverses(FLAGS_universe.str(), &universes)) {
+    std::cerr << "Invalid universe list: " << FLAGS_universe.str()
+              << std::endl;
+    exit(ola::EXIT_USAGE);
+  }
+
+  // The actions are created by the parser, so this needs to exist first.
+  CommandRunner::Options runner_options;
+  runner_options.workers = FLAGS_command_workers;
+  runner_options.max_pending = FLAGS_max_queued_commands;
+  runner_options.min_interval_ms = FLAGS_command_interval;
+  std::auto_ptr<CommandRunner> command_runner;
+  if (FLAGS_command_workers && !FLAGS_validate) {
+    command_runner.reset(new CommandRunner(runner_options));
+    global_command_runner = command_runner.get();
+  }
+
   // setup the default context
   global_context = new Context();
   OLA_INFO << "Loading config from " << config_file;
@@ -198,7 +253,7 @@ int main(int argc, char *argv[]) {
   if (global_context) {
     global_context->SetConfigFile(config_file);
     global_context->SetOverallOffset(FLAGS_offset);
-    global_context->SetUniverse(FLAGS_universe);
+    global_context->SetUniverse(universes[0]);
   }
 
   if (FLAGS_validate) {
@@ -222,24 +277,49 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_OSERR);
   }
 
+  if (command_runner.get() && !command_runner->Start()) {
+    exit(ola::EXIT_OSERR);
+  }
+
   // create the vector of Slot
   SlotList slots;
+  SlotList all_slots;
+  TriggerMap triggers;
   if (ApplyOffset(FLAGS_offset, &slots)) {
-    // setup the trigger
-    DMXTrigger trigger(global_context, slots);
-
-    // register for DMX
     ola::OlaCallbackClient *client = wrapper.GetClient();
-    client->SetDmxCallback(
-        ola::NewCallback(&NewDmx,
-                         static_cast<unsigned int>(FLAGS_universe),
-                         &trigger));
-    client->RegisterUniverse(FLAGS_universe, ola::REGISTER, NULL);
+
+    // Each universe gets its own copy of the slots, since they track the
+    // last value.
+    vector<unsigned int>::const_iterator iter = universes.begin();
+    for (; iter != universes.end(); ++iter) {
+      if (ola::STLContains(triggers, *iter)) {
+        continue;
+      }
+      SlotList universe_slots;
+      if (triggers.empty()) {
+        universe_slots = slots;
+      } else {
+        SlotList::const_iterator slot_iter = slots.begin();
+        for (; slot_iter != slots.end(); ++slot_iter) {
+          universe_slots.push_back((*slot_iter)->Clone());
+        }
+      }
+      all_slots.insert(all_slots.end(), universe_slots.begin(),
+                       universe_slots.end());
+      triggers[*iter] = new DMXTrigger(global_context, universe_slots);
+      client->RegisterUniverse(*iter, ola::REGISTER, NULL);
+    }
+
+    client->SetDmxCallback(ola::NewCallback(&NewDmx, &triggers));
 
     // start the client
     wrapper.GetSelectServer()->Run();
   }
 
   // cleanup
-  STLDeleteElements(&slots);
+  if (command_runner.get()) {
+    command_runner->Stop();
+  }
+  STLDeleteValues(&triggers);
+  STLDeleteElements(&all_slots);
 }